@@ -45,12 +45,19 @@ QTPLUGIN += qsvg
 
 QT += xml
 QT += svg
+QT += sql
 QT += core
 QT += quick
 QT += widgets
 QT += location
+QT += network
+QT += multimedia
+QT += opengl
 QT += bluetooth
+QT += serialbus
 QT += serialport
+QT += websockets
+QT += concurrent
 QT += positioning
 QT += printsupport
 
@@ -80,6 +87,31 @@ CONFIG(release, debug|release) {
 #DEFINES += DISABLE_QS # If enabled, QSimpleUpdater shall not be used by the app
                        # This is the default behaviour for MinGW.
 
+# Build with "qmake CONFIG+=wasm" to support WebAssembly frame parsers, which
+# requires the wasmtime C API (set WASMTIME_DIR if it is not installed in a
+# system-wide location).
+wasm {
+    DEFINES += ENABLE_WASM_PARSER
+    !isEmpty(WASMTIME_DIR) {
+        INCLUDEPATH += $$WASMTIME_DIR/include
+        LIBS += -L$$WASMTIME_DIR/lib
+    }
+    LIBS += -lwasmtime
+}
+
+# Build with "qmake CONFIG+=libusb" to support USB bulk devices, which requires
+# libusb 1.0 (set LIBUSB_DIR if it is not installed in a system-wide location).
+libusb {
+    DEFINES += ENABLE_LIBUSB_DRIVER
+    !isEmpty(LIBUSB_DIR) {
+        INCLUDEPATH += $$LIBUSB_DIR/include/libusb-1.0
+        LIBS += -L$$LIBUSB_DIR/lib
+    } else:unix {
+        INCLUDEPATH += /usr/include/libusb-1.0 /usr/local/include/libusb-1.0
+    }
+    LIBS += -lusb-1.0
+}
+
 #-------------------------------------------------------------------------------
 # Libraries
 #-------------------------------------------------------------------------------
@@ -100,6 +132,7 @@ win32* {
     TARGET = SerialStudio
     RC_FILE = deploy/windows/resources/info.rc
     OTHER_FILES += deploy/windows/nsis/setup.nsi
+    LIBS += -lpsapi
 }
 
 macx* {
@@ -108,10 +141,12 @@ macx* {
     RC_FILE = deploy/macOS/icon.icns
     QMAKE_INFO_PLIST = deploy/macOS/info.plist
     CONFIG += sdk_no_version_check
+    LIBS += -framework IOKit -framework CoreFoundation
 }
 
 linux:!android {
     PKGCONFIG += libssl
+    LIBS += -lrt
     target.path = $$PREFIX/bin
     icon.path = $$PREFIX/share/pixmaps
     desktop.path = $$PREFIX/share/applications
@@ -136,32 +171,134 @@ INCLUDEPATH += src
 
 HEADERS += \
     src/AppInfo.h \
+    src/CSV/ArrowWriter.h \
+    src/CSV/BinaryFormat.h \
+    src/CSV/BinaryReader.h \
+    src/CSV/BinaryWriter.h \
+    src/CSV/Converter.h \
+    src/CSV/CsvReader.h \
     src/CSV/Export.h \
+    src/CSV/Gzip.h \
+    src/CSV/MarkerIndex.h \
+    src/CSV/Overview.h \
     src/CSV/Player.h \
+    src/CSV/RecordingSchema.h \
+    src/CSV/Reference.h \
+    src/CSV/SessionStore.h \
     src/DataTypes.h \
+    src/IO/BurstRecorder.h \
     src/IO/Checksum.h \
+    src/IO/CircularBuffer.h \
+    src/IO/CommandScheduler.h \
     src/IO/Console.h \
+    src/IO/ConsoleLog.h \
+    src/IO/Decompressor.h \
+    src/IO/Decompressors/Heatshrink.h \
+    src/IO/Decompressors/LZ4.h \
+    src/IO/DelimiterScanner.h \
+    src/IO/Device.h \
+    src/IO/Drivers/Audio.h \
     src/IO/Drivers/BluetoothLE.h \
+    src/IO/Drivers/CANBus.h \
+    src/IO/Drivers/Modbus.h \
+    src/IO/Drivers/NativeSerial.h \
     src/IO/Drivers/Network.h \
+    src/IO/Drivers/PortWatcher.h \
+    src/IO/Drivers/Replay.h \
     src/IO/Drivers/Serial.h \
+    src/IO/Drivers/Stream.h \
+    src/IO/Drivers/USB.h \
+    src/IO/FileTransfer.h \
+    src/IO/Framer.h \
+    src/IO/Framers/COBS.h \
+    src/IO/Framers/LengthPrefix.h \
+    src/IO/Framers/SLIP.h \
+    src/IO/FrameQueue.h \
+    src/IO/FrameReader.h \
     src/IO/HAL_Driver.h \
+    src/IO/HostCache.h \
+    src/IO/LatencyProbe.h \
+    src/IO/LineStore.h \
     src/IO/Manager.h \
+    src/IO/ModbusScheduler.h \
+    src/IO/RawCapture.h \
+    src/IO/RawCaptureFile.h \
+    src/IO/ReconnectManager.h \
+    src/IO/WriteQueue.h \
+    src/InfluxDB/Client.h \
+    src/JSON/AlarmEngine.h \
+    src/JSON/BinaryDecoder.h \
+    src/JSON/BinaryFrameDecoder.h \
+    src/JSON/Calibration.h \
     src/JSON/Dataset.h \
+    src/JSON/Decimator.h \
+    src/JSON/Expression.h \
+    src/JSON/FieldSplitter.h \
     src/JSON/Frame.h \
+    src/JSON/FramePool.h \
+    src/JSON/FrameSnapshot.h \
+    src/JSON/FrameRouter.h \
     src/JSON/Generator.h \
     src/JSON/Group.h \
+    src/JSON/JsonScanner.h \
+    src/JSON/NmeaDecoder.h \
+    src/JSON/NumberParser.h \
+    src/JSON/ParserPool.h \
+    src/JSON/SequenceTracker.h \
+    src/JSON/SinkGraph.h \
+    src/JSON/ProjectCache.h \
+    src/JSON/Resampler.h \
+    src/JSON/StringTable.h \
+    src/JSON/WasmDecoder.h \
     src/MQTT/Client.h \
+    src/MQTT/Spool.h \
+    src/Misc/AlarmLog.h \
+    src/Misc/Benchmark.h \
+    src/Misc/Diagnostics.h \
     src/Misc/ModuleManager.h \
+    src/Misc/Renderer.h \
+    src/Misc/Settings.h \
+    src/Misc/SoakMonitor.h \
     src/Misc/ThemeManager.h \
+    src/Misc/ThreadScheduler.h \
     src/Misc/TimerEvents.h \
+    src/Misc/Tracer.h \
     src/Misc/Translator.h \
     src/Misc/Utilities.h \
+    src/Plugins/Aggregator.h \
     src/Plugins/Server.h \
+    src/Plugins/SharedMemory.h \
+    src/Plugins/UdpForwarder.h \
+    src/Plugins/WebSocketServer.h \
+    src/Plugins/ZmqPublisher.h \
     src/Project/CodeEditor.h \
+    src/Project/DbcImporter.h \
+    src/Project/FrameParser.h \
     src/Project/Model.h \
+    src/Project/ParserWatchdog.h \
+    src/UI/BatchFFT.h \
+    src/UI/Capture.h \
+    src/UI/Colormap.h \
     src/UI/Dashboard.h \
+    src/UI/DashboardExporter.h \
     src/UI/DashboardWidget.h \
     src/UI/DeclarativeWidget.h \
+    src/UI/FFTEngine.h \
+    src/UI/GpsTrack.h \
+    src/UI/GpsTrackItem.h \
+    src/UI/HeatmapItem.h \
+    src/UI/Histogram.h \
+    src/UI/PlotBuffer.h \
+    src/UI/PlotHistory.h \
+    src/UI/PlotItem.h \
+    src/UI/PointCloud.h \
+    src/UI/RenderBenchmark.h \
+    src/UI/Statistics.h \
+    src/UI/TerminalView.h \
+    src/UI/ValueModel.h \
+    src/UI/WaterfallItem.h \
+    src/UI/WidgetModel.h \
+    src/UI/XYPlotItem.h \
     src/UI/Widgets/Accelerometer.h \
     src/UI/Widgets/Bar.h \
     src/UI/Widgets/Common/AnalogGauge.h \
@@ -169,42 +306,145 @@ HEADERS += \
     src/UI/Widgets/Common/BaseWidget.h \
     src/UI/Widgets/Common/ElidedLabel.h \
     src/UI/Widgets/Common/KLed.h \
+    src/UI/Widgets/Common/PlotSeries.h \
     src/UI/Widgets/Compass.h \
     src/UI/Widgets/DataGroup.h \
     src/UI/Widgets/FFTPlot.h \
     src/UI/Widgets/GPS.h \
     src/UI/Widgets/Gauge.h \
     src/UI/Widgets/Gyroscope.h \
+    src/UI/Widgets/Histogram.h \
     src/UI/Widgets/LEDPanel.h \
     src/UI/Widgets/MultiPlot.h \
     src/UI/Widgets/Plot.h \
+    src/UI/Widgets/Statistics.h \
     src/UI/Widgets/Terminal.h
 
 SOURCES += \
+    src/CSV/ArrowWriter.cpp \
+    src/CSV/BinaryReader.cpp \
+    src/CSV/BinaryWriter.cpp \
+    src/CSV/Converter.cpp \
+    src/CSV/CsvReader.cpp \
     src/CSV/Export.cpp \
+    src/CSV/Gzip.cpp \
+    src/CSV/MarkerIndex.cpp \
+    src/CSV/Overview.cpp \
     src/CSV/Player.cpp \
+    src/CSV/RecordingSchema.cpp \
+    src/CSV/Reference.cpp \
+    src/CSV/SessionStore.cpp \
+    src/IO/BurstRecorder.cpp \
     src/IO/Checksum.cpp \
+    src/IO/CircularBuffer.cpp \
+    src/IO/CommandScheduler.cpp \
     src/IO/Console.cpp \
+    src/IO/ConsoleLog.cpp \
+    src/IO/Decompressor.cpp \
+    src/IO/Decompressors/Heatshrink.cpp \
+    src/IO/Decompressors/LZ4.cpp \
+    src/IO/DelimiterScanner.cpp \
+    src/IO/Device.cpp \
+    src/IO/Drivers/Audio.cpp \
     src/IO/Drivers/BluetoothLE.cpp \
+    src/IO/Drivers/CANBus.cpp \
+    src/IO/Drivers/Modbus.cpp \
+    src/IO/Drivers/NativeSerial.cpp \
     src/IO/Drivers/Network.cpp \
+    src/IO/Drivers/PortWatcher.cpp \
+    src/IO/Drivers/Replay.cpp \
     src/IO/Drivers/Serial.cpp \
+    src/IO/Drivers/Stream.cpp \
+    src/IO/Drivers/USB.cpp \
+    src/IO/FileTransfer.cpp \
+    src/IO/Framers/COBS.cpp \
+    src/IO/Framers/LengthPrefix.cpp \
+    src/IO/Framers/SLIP.cpp \
+    src/IO/FrameQueue.cpp \
+    src/IO/FrameReader.cpp \
+    src/IO/HostCache.cpp \
+    src/IO/LatencyProbe.cpp \
+    src/IO/LineStore.cpp \
     src/IO/Manager.cpp \
+    src/IO/ModbusScheduler.cpp \
+    src/IO/RawCapture.cpp \
+    src/IO/RawCaptureFile.cpp \
+    src/IO/ReconnectManager.cpp \
+    src/IO/WriteQueue.cpp \
+    src/InfluxDB/Client.cpp \
+    src/JSON/AlarmEngine.cpp \
+    src/JSON/BinaryDecoder.cpp \
+    src/JSON/BinaryFrameDecoder.cpp \
+    src/JSON/Calibration.cpp \
     src/JSON/Dataset.cpp \
+    src/JSON/Decimator.cpp \
+    src/JSON/Expression.cpp \
+    src/JSON/FieldSplitter.cpp \
     src/JSON/Frame.cpp \
+    src/JSON/FramePool.cpp \
+    src/JSON/FrameSnapshot.cpp \
+    src/JSON/FrameRouter.cpp \
     src/JSON/Generator.cpp \
     src/JSON/Group.cpp \
+    src/JSON/JsonScanner.cpp \
+    src/JSON/NmeaDecoder.cpp \
+    src/JSON/NumberParser.cpp \
+    src/JSON/ParserPool.cpp \
+    src/JSON/SequenceTracker.cpp \
+    src/JSON/SinkGraph.cpp \
+    src/JSON/ProjectCache.cpp \
+    src/JSON/Resampler.cpp \
+    src/JSON/StringTable.cpp \
+    src/JSON/WasmDecoder.cpp \
     src/MQTT/Client.cpp \
+    src/MQTT/Spool.cpp \
+    src/Misc/AlarmLog.cpp \
+    src/Misc/Benchmark.cpp \
+    src/Misc/Diagnostics.cpp \
     src/Misc/ModuleManager.cpp \
+    src/Misc/Renderer.cpp \
+    src/Misc/Settings.cpp \
+    src/Misc/SoakMonitor.cpp \
     src/Misc/ThemeManager.cpp \
+    src/Misc/ThreadScheduler.cpp \
     src/Misc/TimerEvents.cpp \
+    src/Misc/Tracer.cpp \
     src/Misc/Translator.cpp \
     src/Misc/Utilities.cpp \
+    src/Plugins/Aggregator.cpp \
     src/Plugins/Server.cpp \
+    src/Plugins/SharedMemory.cpp \
+    src/Plugins/UdpForwarder.cpp \
+    src/Plugins/WebSocketServer.cpp \
+    src/Plugins/ZmqPublisher.cpp \
     src/Project/CodeEditor.cpp \
+    src/Project/DbcImporter.cpp \
+    src/Project/FrameParser.cpp \
     src/Project/Model.cpp \
+    src/Project/ParserWatchdog.cpp \
+    src/UI/BatchFFT.cpp \
+    src/UI/Capture.cpp \
+    src/UI/Colormap.cpp \
     src/UI/Dashboard.cpp \
+    src/UI/DashboardExporter.cpp \
     src/UI/DashboardWidget.cpp \
     src/UI/DeclarativeWidget.cpp \
+    src/UI/FFTEngine.cpp \
+    src/UI/GpsTrack.cpp \
+    src/UI/GpsTrackItem.cpp \
+    src/UI/HeatmapItem.cpp \
+    src/UI/Histogram.cpp \
+    src/UI/PlotBuffer.cpp \
+    src/UI/PlotHistory.cpp \
+    src/UI/PlotItem.cpp \
+    src/UI/PointCloud.cpp \
+    src/UI/RenderBenchmark.cpp \
+    src/UI/Statistics.cpp \
+    src/UI/TerminalView.cpp \
+    src/UI/ValueModel.cpp \
+    src/UI/WaterfallItem.cpp \
+    src/UI/WidgetModel.cpp \
+    src/UI/XYPlotItem.cpp \
     src/UI/Widgets/Accelerometer.cpp \
     src/UI/Widgets/Bar.cpp \
     src/UI/Widgets/Common/AnalogGauge.cpp \
@@ -212,15 +452,18 @@ SOURCES += \
     src/UI/Widgets/Common/BaseWidget.cpp \
     src/UI/Widgets/Common/ElidedLabel.cpp \
     src/UI/Widgets/Common/KLed.cpp \
+    src/UI/Widgets/Common/PlotSeries.cpp \
     src/UI/Widgets/Compass.cpp \
     src/UI/Widgets/DataGroup.cpp \
     src/UI/Widgets/FFTPlot.cpp \
     src/UI/Widgets/GPS.cpp \
     src/UI/Widgets/Gauge.cpp \
     src/UI/Widgets/Gyroscope.cpp \
+    src/UI/Widgets/Histogram.cpp \
     src/UI/Widgets/LEDPanel.cpp \
     src/UI/Widgets/MultiPlot.cpp \
     src/UI/Widgets/Plot.cpp \
+    src/UI/Widgets/Statistics.cpp \
     src/UI/Widgets/Terminal.cpp \
     src/main.cpp
 
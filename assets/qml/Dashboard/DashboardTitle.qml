@@ -26,6 +26,7 @@ import QtQuick.Layouts
 import QtQuick.Controls
 
 import "../Widgets" as Widgets
+import "../Windows" as Windows
 
 Rectangle {
   id: root
@@ -33,6 +34,23 @@ Rectangle {
 
   property alias consoleChecked: consoleBt.checked
 
+  //
+  // Secondary dashboard windows, each one displays a subset of the widgets
+  // with its own refresh rate, using the data stored by the dashboard
+  //
+  property int windowCount: 0
+  Component {
+    id: dashboardWindow
+    Windows.DashboardWindow {}
+  }
+  function openWindow() {
+    root.windowCount += 1
+    var window = dashboardWindow.createObject(null, {
+                                                "number": root.windowCount
+                                              })
+    window.showNormal()
+  }
+
   Settings {
     property alias consoleVisible: root.consoleChecked
   }
@@ -79,6 +97,54 @@ Rectangle {
       Layout.fillWidth: true
     }
 
+    //
+    // Session timeline, pausing the view keeps receiving & recording data
+    //
+    Label {
+      font.family: app.monoFont
+      color: palette.brightText
+      Layout.alignment: Qt.AlignVCenter
+      text: Cpp_UI_Dashboard.viewPaused ?
+              "-" + Cpp_UI_Dashboard.viewOffset.toFixed(1) + " s" :
+              qsTr("LIVE")
+    }
+
+    Slider {
+      id: _timeline
+      to: 0
+      stepSize: 0.1
+      Layout.preferredWidth: 240
+      Layout.alignment: Qt.AlignVCenter
+      from: -Math.max(0.1, Cpp_UI_Dashboard.viewHistory)
+      value: -Cpp_UI_Dashboard.viewOffset
+      onMoved: Cpp_UI_Dashboard.viewOffset = -value
+    }
+
+    Button {
+      flat: true
+      Layout.alignment: Qt.AlignVCenter
+      icon.color: Cpp_ThemeManager.menubarText
+      palette.buttonText: Cpp_ThemeManager.menubarText
+      palette.button: Cpp_ThemeManager.windowGradient1
+      palette.window: Cpp_ThemeManager.windowGradient1
+      onClicked: Cpp_UI_Dashboard.viewPaused = !Cpp_UI_Dashboard.viewPaused
+      text: Cpp_UI_Dashboard.viewPaused ? qsTr("Live") : qsTr("Pause")
+      icon.source: Cpp_UI_Dashboard.viewPaused ? "qrc:/icons/media-play.svg" :
+                                                 "qrc:/icons/media-pause.svg"
+    }
+
+    Button {
+      flat: true
+      text: qsTr("New Window")
+      onClicked: root.openWindow()
+      Layout.alignment: Qt.AlignVCenter
+      icon.source: "qrc:/icons/new.svg"
+      icon.color: Cpp_ThemeManager.menubarText
+      palette.buttonText: Cpp_ThemeManager.menubarText
+      palette.button: Cpp_ThemeManager.windowGradient1
+      palette.window: Cpp_ThemeManager.windowGradient1
+    }
+
     Button {
       flat: true
       id: consoleBt
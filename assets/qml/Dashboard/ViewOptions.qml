@@ -52,7 +52,7 @@ Widgets.Window {
     var minp = 0
     var maxp = 100
     var minv = Math.log(10)
-    var maxv = Math.log(10000)
+    var maxv = Math.log(100000)
     var scale = (maxv - minv) / (maxp - minp);
     return Math.exp(minv + scale * (position - minp)).toFixed(0);
   }
@@ -65,7 +65,7 @@ Widgets.Window {
     var minp = 0
     var maxp = 100
     var minv = Math.log(10)
-    var maxv = Math.log(10000)
+    var maxv = Math.log(100000)
     var scale = (maxv - minv) / (maxp - minp)
     var result = (Math.log(value) - minv) / scale + minp;
     return result.toFixed(0)
@@ -170,6 +170,50 @@ Widgets.Window {
           visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
         }
 
+        //
+        // Time window of the plots
+        //
+        Label {
+          text: qsTr("Time window:")
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+        } ComboBox {
+          id: timeWindow
+          Layout.fillWidth: true
+          readonly property var windows: [0, 1, 5, 10, 30, 60, 300]
+          visible: Cpp_UI_Dashboard.plotCount > 0 || Cpp_UI_Dashboard.multiPlotCount > 0
+          currentIndex: Math.max(0, windows.indexOf(Cpp_UI_Dashboard.timeWindow))
+          onActivated: Cpp_UI_Dashboard.timeWindow = windows[index]
+          model: [
+            qsTr("Samples"),
+            qsTr("1 second"),
+            qsTr("5 seconds"),
+            qsTr("10 seconds"),
+            qsTr("30 seconds"),
+            qsTr("1 minute"),
+            qsTr("5 minutes")
+          ]
+        } Item {
+          visible: timeWindow.visible
+        }
+
+        //
+        // Number of points retained by the XY plots
+        //
+        Label {
+          text: qsTr("XY points:")
+          visible: Cpp_UI_Dashboard.xyPlotCount > 0
+        } ComboBox {
+          id: xyPoints
+          Layout.fillWidth: true
+          visible: Cpp_UI_Dashboard.xyPlotCount > 0
+          readonly property var points: [1000, 10000, 100000, 1000000]
+          currentIndex: Math.max(0, points.indexOf(Cpp_UI_Dashboard.xyPoints))
+          onActivated: Cpp_UI_Dashboard.xyPoints = points[index]
+          model: ["1K", "10K", "100K", "1M"]
+        } Item {
+          visible: xyPoints.visible
+        }
+
         //
         // Number of decimal places
         //
@@ -231,6 +275,28 @@ Widgets.Window {
         onCheckedChanged: Cpp_UI_Dashboard.setMultiplotVisible(index, checked)
       }
 
+      //
+      // XY plots
+      //
+      ViewOptionsDelegate {
+        title: qsTr("XY plots")
+        icon: "qrc:/icons/xy.svg"
+        count: Cpp_UI_Dashboard.xyPlotCount
+        titles: Cpp_UI_Dashboard.xyPlotTitles
+        onCheckedChanged: Cpp_UI_Dashboard.setXYPlotVisible(index, checked)
+      }
+
+      //
+      // Heatmaps
+      //
+      ViewOptionsDelegate {
+        title: qsTr("Heatmaps")
+        icon: "qrc:/icons/heatmap.svg"
+        count: Cpp_UI_Dashboard.heatmapCount
+        titles: Cpp_UI_Dashboard.heatmapTitles
+        onCheckedChanged: Cpp_UI_Dashboard.setHeatmapVisible(index, checked)
+      }
+
       //
       // LEDs
       //
@@ -253,6 +319,17 @@ Widgets.Window {
         onCheckedChanged: Cpp_UI_Dashboard.setFFTVisible(index, checked)
       }
 
+      //
+      // Waterfalls
+      //
+      ViewOptionsDelegate {
+        title: qsTr("Waterfalls")
+        icon: "qrc:/icons/waterfall.svg"
+        count: Cpp_UI_Dashboard.waterfallCount
+        titles: Cpp_UI_Dashboard.waterfallTitles
+        onCheckedChanged: Cpp_UI_Dashboard.setWaterfallVisible(index, checked)
+      }
+
       //
       // Plots
       //
@@ -297,6 +374,17 @@ Widgets.Window {
         onCheckedChanged: Cpp_UI_Dashboard.setCompassVisible(index, checked)
       }
 
+      //
+      // Histograms
+      //
+      ViewOptionsDelegate {
+        title: qsTr("Histograms")
+        icon: "qrc:/icons/histogram.svg"
+        count: Cpp_UI_Dashboard.histogramCount
+        titles: Cpp_UI_Dashboard.histogramTitles
+        onCheckedChanged: Cpp_UI_Dashboard.setHistogramVisible(index, checked)
+      }
+
       //
       // Gyroscopes
       //
@@ -319,6 +407,17 @@ Widgets.Window {
         onCheckedChanged: Cpp_UI_Dashboard.setAccelerometerVisible(index, checked)
       }
 
+      //
+      // Statistics
+      //
+      ViewOptionsDelegate {
+        title: qsTr("Statistics")
+        icon: "qrc:/icons/graphs.svg"
+        count: Cpp_UI_Dashboard.statisticsCount
+        titles: Cpp_UI_Dashboard.statisticsTitles
+        onCheckedChanged: Cpp_UI_Dashboard.setStatisticsVisible(index, checked)
+      }
+
       //
       // Maps
       //
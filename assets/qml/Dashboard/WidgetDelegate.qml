@@ -68,11 +68,87 @@ Item {
         active: widget.isGpsMap
         visible: widget.isGpsMap && status == Loader.Ready
         sourceComponent: Widgets.GpsMap {
+          index: widget.relativeIndex
           altitude: widget.gpsAltitude
           latitude: widget.gpsLatitude
           longitude: widget.gpsLongitude
         }
       }
+
+      //
+      // Plots drawn directly by the scene graph
+      //
+      Loader {
+        anchors.fill: parent
+        active: widget.isNativePlot
+        visible: widget.isNativePlot && status == Loader.Ready
+        sourceComponent: Widgets.NativePlot {
+          index: widget.relativeIndex
+          multiPlot: widget.isMultiPlot
+        }
+      }
+
+      //
+      // Spectrograms drawn by the scene graph
+      //
+      Loader {
+        anchors.fill: parent
+        active: widget.isWaterfall
+        visible: widget.isWaterfall && status == Loader.Ready
+        sourceComponent: Widgets.Waterfall {
+          index: widget.relativeIndex
+        }
+      }
+
+      //
+      // XY plots drawn by the scene graph
+      //
+      Loader {
+        anchors.fill: parent
+        active: widget.isXYPlot
+        visible: widget.isXYPlot && status == Loader.Ready
+        sourceComponent: Widgets.XYPlot {
+          index: widget.relativeIndex
+        }
+      }
+
+      //
+      // Heatmaps drawn by the scene graph
+      //
+      Loader {
+        anchors.fill: parent
+        active: widget.isHeatmap
+        visible: widget.isHeatmap && status == Loader.Ready
+        sourceComponent: Widgets.Heatmap {
+          index: widget.relativeIndex
+        }
+      }
+
+      //
+      // Time spent updating, grabbing & painting the widget
+      //
+      Rectangle {
+        radius: 2
+        opacity: 0.8
+        width: _renderCost.implicitWidth + 8
+        height: _renderCost.implicitHeight + 4
+        color: Cpp_ThemeManager.widgetWindowBackground
+        visible: Cpp_UI_Dashboard.renderCostOverlay
+        anchors {
+          top: parent.top
+          right: parent.right
+          margins: 4
+        }
+
+        Label {
+          id: _renderCost
+          anchors.centerIn: parent
+          text: widget.renderCost
+          font.family: app.monoFont
+          font.pixelSize: 10
+          color: Cpp_ThemeManager.text
+        }
+      }
     }
   }
 
@@ -136,11 +212,49 @@ Item {
             active: externalWidget.isGpsMap
             visible: externalWidget.isGpsMap && status == Loader.Ready
             sourceComponent: Widgets.GpsMap {
+              index: externalWidget.relativeIndex
               altitude: externalWidget.gpsAltitude
               latitude: externalWidget.gpsLatitude
               longitude: externalWidget.gpsLongitude
             }
           }
+
+          Loader {
+            anchors.fill: parent
+            active: externalWidget.isNativePlot
+            visible: externalWidget.isNativePlot && status == Loader.Ready
+            sourceComponent: Widgets.NativePlot {
+              index: externalWidget.relativeIndex
+              multiPlot: externalWidget.isMultiPlot
+            }
+          }
+
+          Loader {
+            anchors.fill: parent
+            active: externalWidget.isWaterfall
+            visible: externalWidget.isWaterfall && status == Loader.Ready
+            sourceComponent: Widgets.Waterfall {
+              index: externalWidget.relativeIndex
+            }
+          }
+
+          Loader {
+            anchors.fill: parent
+            active: externalWidget.isXYPlot
+            visible: externalWidget.isXYPlot && status == Loader.Ready
+            sourceComponent: Widgets.XYPlot {
+              index: externalWidget.relativeIndex
+            }
+          }
+
+          Loader {
+            anchors.fill: parent
+            active: externalWidget.isHeatmap
+            visible: externalWidget.isHeatmap && status == Loader.Ready
+            sourceComponent: Widgets.Heatmap {
+              index: externalWidget.relativeIndex
+            }
+          }
         }
       }
 
@@ -54,6 +54,7 @@ Widgets.Window {
     anchors.fill: parent
 
     Flickable {
+      id: flickable
       contentWidth: width
       contentHeight: grid.height
 
@@ -104,7 +105,9 @@ Widgets.Window {
           id: model
           cellWidth: root.cellWidth
           cellHeight: root.cellHeight
-          model: Cpp_UI_Dashboard.totalWidgetCount
+          model: Cpp_UI_WidgetModel
+          viewportY: flickable.contentY
+          viewportHeight: flickable.height
         }
       }
     }
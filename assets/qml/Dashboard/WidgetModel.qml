@@ -21,28 +21,74 @@
  */
 
 import QtQuick
+import QtQuick.Controls
 
 Repeater {
   id: root
 
   property real cellWidth: 0
   property real cellHeight: 0
+  property real viewportY: 0
+  property real viewportHeight: 0
 
-  delegate: Loader {
-    id: loader
-    asynchronous: true
+  delegate: Item {
+    id: cell
     width: root.cellWidth
     height: root.cellHeight
 
-    sourceComponent: WidgetDelegate {
-      widgetIndex: index
+    //
+    // Widgets are only loaded once they are scrolled into view (or are about
+    // to be), loaded widgets are kept when they are scrolled out of view
+    //
+    property bool activated: false
+    readonly property bool inViewport: y + height >= root.viewportY - root.cellHeight &&
+                                       y <= root.viewportY + root.viewportHeight + root.cellHeight
+    onInViewportChanged: {
+      if (inViewport)
+        activated = true
+    }
+    Component.onCompleted: {
+      if (inViewport)
+        activated = true
+    }
+
+    //
+    // Lightweight placeholder displayed until the widget is loaded
+    //
+    Rectangle {
+      anchors.fill: parent
+      radius: 5
+      border.width: 1
+      visible: loader.status !== Loader.Ready
+      color: Cpp_ThemeManager.widgetWindowBackground
+      border.color: Cpp_ThemeManager.widgetWindowBorder
+
+      Label {
+        elide: Label.ElideRight
+        text: widgetTitle
+        opacity: 0.8
+        anchors.centerIn: parent
+        width: Math.min(implicitWidth, parent.width - 16)
+        horizontalAlignment: Label.AlignHCenter
+      }
+    }
+
+    Loader {
+      id: loader
+      anchors.fill: parent
+      asynchronous: true
+      active: cell.activated
+
+      sourceComponent: WidgetDelegate {
+        widgetIndex: index
+      }
     }
 
     Connections {
       target: Cpp_UI_Dashboard
 
       function onWidgetVisibilityChanged() {
-        loader.visible = Cpp_UI_Dashboard.widgetVisible(index)
+        cell.visible = Cpp_UI_Dashboard.widgetVisible(index)
       }
     }
   }
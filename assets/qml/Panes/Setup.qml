@@ -95,8 +95,10 @@ Item {
   Connections {
     target: Cpp_JSON_Generator
     function onOperationModeChanged() {
-      commAuto.checked = (Cpp_JSON_Generator.operationMode === 1)
+      commAuto.checked = (Cpp_JSON_Generator.operationMode !== 0)
       commManual.checked = (Cpp_JSON_Generator.operationMode === 0)
+      if (Cpp_JSON_Generator.operationMode !== 0)
+        encoding.currentIndex = Cpp_JSON_Generator.operationMode - 1
     }
   }
 
@@ -135,10 +137,21 @@ Item {
         text: qsTr("No parsing (device sends JSON data)")
         onCheckedChanged: {
           if (checked)
-            Cpp_JSON_Generator.setOperationMode(1)
+            Cpp_JSON_Generator.setOperationMode(encoding.currentIndex + 1)
           else
             Cpp_JSON_Generator.setOperationMode(0)
         }
+      } ComboBox {
+        id: encoding
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: commAuto.checked
+        Layout.maximumWidth: root.maxItemWidth
+        model: ["JSON", "CBOR", "MessagePack"]
+        onCurrentIndexChanged: {
+          if (commAuto.checked)
+            Cpp_JSON_Generator.setOperationMode(currentIndex + 1)
+        }
       } RadioButton {
         id: commManual
         checked: false
@@ -148,7 +161,7 @@ Item {
           if (checked)
             Cpp_JSON_Generator.setOperationMode(0)
           else
-            Cpp_JSON_Generator.setOperationMode(1)
+            Cpp_JSON_Generator.setOperationMode(encoding.currentIndex + 1)
         }
       }
 
@@ -165,6 +178,21 @@ Item {
                                                            qsTr("Select project file") + "...")
       }
 
+      //
+      // Recently used project files, switching between them reuses their
+      // compiled data & keeps the device connected
+      //
+      ComboBox {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: commManual.checked
+        Layout.maximumWidth: root.maxItemWidth
+        model: Cpp_JSON_Generator.recentProjects
+        visible: Cpp_JSON_Generator.recentProjects.length > 1
+        displayText: qsTr("Switch to a recent project") + "..."
+        onActivated: Cpp_JSON_Generator.loadJsonMap(Cpp_JSON_Generator.recentProjects[index])
+      }
+
       //
       // Spacer
       //
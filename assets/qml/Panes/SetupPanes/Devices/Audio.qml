@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+Control {
+  id: root
+
+  //
+  // Layout
+  //
+  ColumnLayout {
+    id: layout
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    GridLayout {
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Input selector
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Input") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } ComboBox {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        model: Cpp_IO_Audio.deviceList
+        currentIndex: Cpp_IO_Audio.deviceIndex
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_IO_Audio.deviceIndex)
+            Cpp_IO_Audio.deviceIndex = currentIndex
+        }
+      }
+
+      //
+      // Sample rate
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Sample rate (Hz)") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } ComboBox {
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        model: Cpp_IO_Audio.sampleRateList
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        validator: IntValidator {
+          bottom: 1000
+          top: 768000
+        }
+
+        Component.onCompleted: {
+          var index = find(Cpp_IO_Audio.sampleRate.toString())
+          if (index >= 0)
+            currentIndex = index
+          else
+            editText = Cpp_IO_Audio.sampleRate
+        }
+
+        onAccepted: Cpp_IO_Audio.sampleRate = parseInt(editText)
+        onCurrentTextChanged: {
+          if (currentText.length > 0)
+            Cpp_IO_Audio.sampleRate = parseInt(currentText)
+        }
+      }
+
+      //
+      // Channel count
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Channels") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } SpinBox {
+        from: 1
+        to: 32
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        value: Cpp_IO_Audio.channelCount
+        onValueModified: Cpp_IO_Audio.channelCount = value
+      }
+    }
+
+    //
+    // Binary layout hint
+    //
+    Label {
+      opacity: 0.8
+      Layout.fillWidth: true
+      wrapMode: Label.WordWrap
+      text: qsTr("Each sample is published as a frame with one float32 " +
+                 "value per channel. Use a binary layout in the project " +
+                 "to map the channels to datasets.")
+    }
+
+    //
+    // Spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
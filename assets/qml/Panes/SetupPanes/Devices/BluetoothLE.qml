@@ -112,6 +112,21 @@ Control {
       }
     }
 
+    //
+    // Link information
+    //
+    Label {
+      Layout.fillWidth: true
+      opacity: 0.8
+      visible: Cpp_IO_Bluetooth_LE.characteristicCount > 0
+      text: Cpp_IO_Bluetooth_LE.mtu > 0 ?
+              qsTr("%1 characteristics, MTU: %2 bytes").arg(
+                Cpp_IO_Bluetooth_LE.characteristicCount).arg(
+                Cpp_IO_Bluetooth_LE.mtu) :
+              qsTr("%1 characteristics").arg(
+                Cpp_IO_Bluetooth_LE.characteristicCount)
+    }
+
     //
     // Scanning indicator
     //
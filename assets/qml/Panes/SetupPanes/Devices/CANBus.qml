@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+Control {
+  id: root
+
+  //
+  // Layout
+  //
+  ColumnLayout {
+    id: layout
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    GridLayout {
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Plugin selector
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Plugin") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } ComboBox {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        model: Cpp_IO_CANBus.pluginList
+        currentIndex: Cpp_IO_CANBus.pluginIndex
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_IO_CANBus.pluginIndex)
+            Cpp_IO_CANBus.pluginIndex = currentIndex
+        }
+      }
+
+      //
+      // Interface selector
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Interface") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        ComboBox {
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: !Cpp_IO_Manager.connected
+          model: Cpp_IO_CANBus.interfaceList
+          currentIndex: Cpp_IO_CANBus.interfaceIndex
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+          onCurrentIndexChanged: {
+            if (currentIndex !== Cpp_IO_CANBus.interfaceIndex)
+              Cpp_IO_CANBus.interfaceIndex = currentIndex
+          }
+        }
+
+        Button {
+          width: 24
+          height: 24
+          icon.width: 16
+          icon.height: 16
+          opacity: enabled ? 1 : 0.5
+          icon.color: Cpp_ThemeManager.text
+          enabled: !Cpp_IO_Manager.connected
+          icon.source: "qrc:/icons/refresh.svg"
+          onClicked: Cpp_IO_CANBus.refreshInterfaces()
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+        }
+      }
+
+      //
+      // Bitrate selector
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Bitrate") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } ComboBox {
+        id: _bitrate
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        model: Cpp_IO_CANBus.bitrateList
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        Component.onCompleted: editText = Cpp_IO_CANBus.bitrate
+
+        validator: IntValidator {
+          bottom: 1
+        }
+
+        onEditTextChanged: {
+          var value = parseInt(editText)
+          if (value > 0 && value !== Cpp_IO_CANBus.bitrate)
+            Cpp_IO_CANBus.bitrate = value
+        }
+      }
+
+      //
+      // Identifier filter
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("ID filter") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } TextField {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        text: Cpp_IO_CANBus.filter
+        placeholderText: qsTr("All frames (e.g. 123,200:7F0)")
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onTextChanged: {
+          if (Cpp_IO_CANBus.filter !== text)
+            Cpp_IO_CANBus.filter = text
+        }
+      }
+    }
+
+    //
+    // CAN FD option
+    //
+    CheckBox {
+      text: qsTr("Enable CAN FD frames")
+      checked: Cpp_IO_CANBus.canFd
+      enabled: !Cpp_IO_Manager.connected
+      onCheckedChanged: {
+        if (Cpp_IO_CANBus.canFd !== checked)
+          Cpp_IO_CANBus.canFd = checked
+      }
+    }
+
+    //
+    // Spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
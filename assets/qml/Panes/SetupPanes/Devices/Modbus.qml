@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+Control {
+  id: root
+
+  //
+  // Layout
+  //
+  ColumnLayout {
+    id: layout
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    GridLayout {
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Protocol selector
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Protocol") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } ComboBox {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        model: Cpp_IO_Modbus.protocolList
+        currentIndex: Cpp_IO_Modbus.protocol
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_IO_Modbus.protocol)
+            Cpp_IO_Modbus.protocol = currentIndex
+        }
+      }
+
+      //
+      // Serial port (RTU)
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("COM Port") + ":"
+        enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Modbus.protocol === 0
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+        visible: Cpp_IO_Modbus.protocol === 0
+
+        ComboBox {
+          editable: true
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: !Cpp_IO_Manager.connected
+          model: Cpp_IO_Modbus.serialPortList
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+          Component.onCompleted: editText = Cpp_IO_Modbus.serialPort
+          onEditTextChanged: {
+            if (Cpp_IO_Modbus.serialPort !== editText)
+              Cpp_IO_Modbus.serialPort = editText
+          }
+        }
+
+        Button {
+          width: 24
+          height: 24
+          icon.width: 16
+          icon.height: 16
+          opacity: enabled ? 1 : 0.5
+          icon.color: Cpp_ThemeManager.text
+          enabled: !Cpp_IO_Manager.connected
+          icon.source: "qrc:/icons/refresh.svg"
+          onClicked: Cpp_IO_Modbus.refreshSerialPorts()
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+        }
+      }
+
+      //
+      // Baud rate (RTU)
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Baud Rate") + ":"
+        enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Modbus.protocol === 0
+      } TextField {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Modbus.protocol === 0
+        text: Cpp_IO_Modbus.baudRate
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        validator: IntValidator {
+          bottom: 1
+        }
+        onTextChanged: {
+          if (text.length > 0 && Cpp_IO_Modbus.baudRate !== parseInt(text))
+            Cpp_IO_Modbus.baudRate = parseInt(text)
+        }
+      }
+
+      //
+      // Parity (RTU)
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Parity") + ":"
+        enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Modbus.protocol === 0
+      } ComboBox {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Modbus.protocol === 0
+        model: Cpp_IO_Modbus.parityList
+        currentIndex: Cpp_IO_Modbus.parity
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_IO_Modbus.parity)
+            Cpp_IO_Modbus.parity = currentIndex
+        }
+      }
+
+      //
+      // Server address (TCP)
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Server") + ":"
+        enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Modbus.protocol === 1
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+        visible: Cpp_IO_Modbus.protocol === 1
+
+        TextField {
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: !Cpp_IO_Manager.connected
+          text: Cpp_IO_Modbus.host
+          placeholderText: "127.0.0.1"
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+          onTextChanged: {
+            if (Cpp_IO_Modbus.host !== text)
+              Cpp_IO_Modbus.host = text
+          }
+        }
+
+        TextField {
+          Layout.maximumWidth: 64
+          opacity: enabled ? 1 : 0.5
+          enabled: !Cpp_IO_Manager.connected
+          text: Cpp_IO_Modbus.port
+          placeholderText: "502"
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+          validator: IntValidator {
+            bottom: 1
+            top: 65535
+          }
+          onTextChanged: {
+            if (text.length > 0 && Cpp_IO_Modbus.port !== parseInt(text))
+              Cpp_IO_Modbus.port = parseInt(text)
+          }
+        }
+      }
+
+      //
+      // Poll interval
+      //
+      Label {
+        text: qsTr("Poll interval (ms)") + ":"
+      } SpinBox {
+        from: 1
+        to: 60000
+        editable: true
+        Layout.fillWidth: true
+        value: Cpp_IO_Modbus.pollInterval
+        onValueModified: Cpp_IO_Modbus.pollInterval = value
+      }
+
+      //
+      // Reply timeout
+      //
+      Label {
+        text: qsTr("Timeout (ms)") + ":"
+      } SpinBox {
+        from: 1
+        to: 10000
+        editable: true
+        Layout.fillWidth: true
+        value: Cpp_IO_Modbus.timeout
+        onValueModified: Cpp_IO_Modbus.timeout = value
+      }
+
+      //
+      // Request coalescing
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Max. register gap") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } SpinBox {
+        from: 0
+        to: 124
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        value: Cpp_IO_Modbus.maxGap
+        enabled: !Cpp_IO_Manager.connected
+        onValueModified: Cpp_IO_Modbus.maxGap = value
+      }
+
+      //
+      // Pipeline depth (TCP)
+      //
+      Label {
+        text: qsTr("Pipelined requests") + ":"
+        visible: Cpp_IO_Modbus.protocol === 1
+      } SpinBox {
+        from: 1
+        to: 32
+        editable: true
+        Layout.fillWidth: true
+        visible: Cpp_IO_Modbus.protocol === 1
+        value: Cpp_IO_Modbus.pipelineDepth
+        onValueModified: Cpp_IO_Modbus.pipelineDepth = value
+      }
+    }
+
+    //
+    // Poll statistics
+    //
+    Label {
+      opacity: 0.8
+      Layout.fillWidth: true
+      wrapMode: Label.WordWrap
+      visible: Cpp_IO_Manager.connected
+      text: qsTr("%1 registers in %2 requests per cycle, %3 overruns")
+            .arg(Cpp_IO_Modbus.registerCount)
+            .arg(Cpp_IO_Modbus.requestCount)
+            .arg(Cpp_IO_Modbus.overruns)
+    }
+
+    //
+    // Spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
@@ -103,11 +103,13 @@ Control {
         opacity: enabled ? 1 : 0.5
         enabled: !Cpp_IO_Manager.connected
         text: qsTr("Remote address") + ":"
+        visible: Cpp_IO_Network.socketTypeIndex !== 2
       } TextField {
         id: _address
         Layout.fillWidth: true
         opacity: enabled ? 1 : 0.5
         enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Network.socketTypeIndex !== 2
         placeholderText: Cpp_IO_Network.defaultAddress
         palette.base: Cpp_ThemeManager.setupPanelBackground
         Component.onCompleted: text = Cpp_IO_Network.remoteAddress
@@ -127,7 +129,7 @@ Control {
         text: qsTr("Port") + ":"
         opacity: enabled ? 1 : 0.5
         enabled: !Cpp_IO_Manager.connected
-        visible: Cpp_IO_Network.socketTypeIndex === 0
+        visible: Cpp_IO_Network.socketTypeIndex !== 1
       } TextField {
         id: _tcpPort
         Layout.fillWidth: true
@@ -150,10 +152,24 @@ Control {
         }
 
 
-        visible: Cpp_IO_Network.socketTypeIndex === 0
+        visible: Cpp_IO_Network.socketTypeIndex !== 1
       }
 
 
+      //
+      // TCP server clients
+      //
+      Label {
+        text: qsTr("Clients") + ":"
+        visible: Cpp_IO_Network.tcpServer
+      } Label {
+        Layout.fillWidth: true
+        visible: Cpp_IO_Network.tcpServer
+        text: Cpp_IO_Manager.connected ?
+                  qsTr("%1 connected").arg(Cpp_IO_Network.clientCount) :
+                  qsTr("Not listening")
+      }
+
       //
       // TCP port
       //
@@ -241,6 +257,42 @@ Control {
         }
       }
 
+      //
+      // UDP multicast groups
+      //
+      Label {
+        text: qsTr("Groups") + ":"
+        opacity: _udpGroups.enabled ? 1 : 0.5
+        visible: Cpp_IO_Network.socketTypeIndex === 1 && udpMulticastEnabled
+      } TextField {
+        id: _udpGroups
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        placeholderText: qsTr("e.g. 239.0.0.1:5000, 239.0.0.2:5001")
+        visible: Cpp_IO_Network.socketTypeIndex === 1 && udpMulticastEnabled
+        Component.onCompleted:
+          text = Cpp_IO_Network.udpMulticastGroups.join(", ")
+        onTextChanged: {
+          var groups = text.split(",")
+          if (groups.join(",") !== Cpp_IO_Network.udpMulticastGroups.join(","))
+            Cpp_IO_Network.udpMulticastGroups = groups
+        }
+      }
+
+      //
+      // UDP multicast sources
+      //
+      Label {
+        text: qsTr("Sources") + ":"
+        visible: _udpGroups.visible && _udpGroups.text.length > 0
+      } Label {
+        Layout.fillWidth: true
+        text: Cpp_IO_Network.udpSourceCount
+        visible: _udpGroups.visible && _udpGroups.text.length > 0
+      }
+
       //
       // UDP multicast checkbox
       //
@@ -263,6 +315,29 @@ Control {
             Cpp_IO_Network.udpIgnoreFrameSequences = checked
         }
       }
+
+      //
+      // UDP socket receive buffer size
+      //
+      Label {
+        text: qsTr("Receive buffer") + ":"
+        opacity: _udpReceiveBuffer.enabled ? 1 : 0.5
+        visible: Cpp_IO_Network.socketTypeIndex === 1
+      } ComboBox {
+        id: _udpReceiveBuffer
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        visible: Cpp_IO_Network.socketTypeIndex === 1
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        readonly property var sizes: [0, 1048576, 4194304, 16777216, 67108864]
+        model: [qsTr("System default"), "1 MB", "4 MB", "16 MB", "64 MB"]
+        currentIndex: Math.max(0, sizes.indexOf(
+                                 Cpp_IO_Network.udpReceiveBufferSize))
+        onCurrentIndexChanged: {
+          if (sizes[currentIndex] !== Cpp_IO_Network.udpReceiveBufferSize)
+            Cpp_IO_Network.udpReceiveBufferSize = sizes[currentIndex]
+        }
+      }
     }
 
     //
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+Control {
+  id: root
+
+  //
+  // Layout
+  //
+  ColumnLayout {
+    id: layout
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    GridLayout {
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Capture file selector
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Capture file") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        TextField {
+          readOnly: true
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: !Cpp_IO_Manager.connected
+          text: Cpp_IO_Replay.fileName
+          placeholderText: qsTr("No file selected")
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+        }
+
+        Button {
+          width: 24
+          height: 24
+          icon.width: 16
+          icon.height: 16
+          opacity: enabled ? 1 : 0.5
+          icon.color: Cpp_ThemeManager.text
+          enabled: !Cpp_IO_Manager.connected
+          icon.source: "qrc:/icons/open.svg"
+          onClicked: Cpp_IO_Replay.openFile()
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+        }
+      }
+
+      //
+      // Replay speed
+      //
+      Label {
+        text: qsTr("Timing") + ":"
+      } ComboBox {
+        Layout.fillWidth: true
+        currentIndex: Cpp_IO_Replay.realTime ? 0 : 1
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        model: [qsTr("Original timing"), qsTr("Maximum speed")]
+        onCurrentIndexChanged: {
+          const realTime = (currentIndex === 0)
+          if (Cpp_IO_Replay.realTime !== realTime)
+            Cpp_IO_Replay.realTime = realTime
+        }
+      }
+    }
+
+    //
+    // Capture information
+    //
+    Label {
+      opacity: 0.8
+      Layout.fillWidth: true
+      wrapMode: Label.WordWrap
+      visible: Cpp_IO_Replay.chunkCount > 0
+      text: qsTr("%1 chunks, %2 KB, %3 s").arg(
+              Cpp_IO_Replay.chunkCount).arg(
+              (Cpp_IO_Replay.totalBytes / 1024).toFixed(1)).arg(
+              (Cpp_IO_Replay.duration / 1000).toFixed(1))
+    }
+
+    //
+    // Replay progress
+    //
+    ProgressBar {
+      Layout.fillWidth: true
+      value: Cpp_IO_Replay.progress
+      visible: Cpp_IO_Replay.chunkCount > 0
+    }
+
+    //
+    // Spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
@@ -139,6 +139,41 @@ Control {
         }
       }
 
+      //
+      // Low-latency mode
+      //
+      Label {
+        text: qsTr("Low latency") + ":"
+      } CheckBox {
+        id: _lowLatency
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        checked: Cpp_IO_Serial.lowLatency
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCheckedChanged: {
+          if (Cpp_IO_Serial.lowLatency !== checked)
+            Cpp_IO_Serial.lowLatency = checked
+        }
+      }
+
+      //
+      // Native serial backend
+      //
+      Label {
+        text: qsTr("Native backend") + ":"
+      } CheckBox {
+        id: _nativeBackend
+        Layout.alignment: Qt.AlignLeft
+        Layout.leftMargin: -app.spacing
+        checked: Cpp_IO_Serial.nativeBackend
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        enabled: !Cpp_IO_Manager.connected
+        onCheckedChanged: {
+          if (Cpp_IO_Serial.nativeBackend !== checked)
+            Cpp_IO_Serial.nativeBackend = checked
+        }
+      }
+
       //
       // Spacer
       //
@@ -219,6 +254,89 @@ Control {
       }
     }
 
+    //
+    // Additional devices title
+    //
+    Label {
+      font.bold: true
+      Layout.fillWidth: true
+      Layout.topMargin: app.spacing
+      text: qsTr("Additional devices")
+    }
+
+    //
+    // List of additional devices
+    //
+    Repeater {
+      model: Cpp_IO_Manager.devices
+      delegate: RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Label {
+          Layout.fillWidth: true
+          elide: Label.ElideRight
+          opacity: modelData.connected ? 1 : 0.5
+          text: qsTr("%1: %2 @ %3 baud, datasets from #%4")
+                .arg(modelData.tag).arg(modelData.portName)
+                .arg(modelData.baudRate).arg(modelData.fieldOffset + 1)
+        }
+
+        Button {
+          icon.color: palette.buttonText
+          Layout.maximumWidth: height
+          enabled: !Cpp_IO_Manager.connected
+          icon.source: "qrc:/icons/delete.svg"
+          onClicked: Cpp_IO_Manager.removeDevice(modelData.id)
+        }
+      }
+    }
+
+    //
+    // Add a new device with the baud rate selected above
+    //
+    RowLayout {
+      spacing: app.spacing
+      Layout.fillWidth: true
+
+      ComboBox {
+        id: _devicePort
+        Layout.fillWidth: true
+        model: Cpp_IO_Serial.portList
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+      }
+
+      TextField {
+        id: _deviceTag
+        Layout.fillWidth: true
+        placeholderText: qsTr("Tag")
+      }
+
+      SpinBox {
+        id: _deviceOffset
+        from: 0
+        to: 9999
+        editable: true
+        ToolTip.visible: hovered
+        ToolTip.text: qsTr("Number of project datasets that precede the " +
+                           "datasets of this device")
+      }
+
+      Button {
+        icon.color: palette.buttonText
+        Layout.maximumWidth: height
+        icon.source: "qrc:/icons/add.svg"
+        enabled: _devicePort.currentIndex > 0
+        onClicked: {
+          Cpp_IO_Manager.addDevice(_devicePort.currentText,
+                                   Cpp_IO_Serial.baudRate,
+                                   _deviceTag.text,
+                                   _deviceOffset.value)
+          _deviceTag.text = ""
+        }
+      }
+    }
+
     //
     // Vertical spacer
     //
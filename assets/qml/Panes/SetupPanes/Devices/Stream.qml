@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+Control {
+  id: root
+
+  //
+  // Layout
+  //
+  ColumnLayout {
+    id: layout
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    GridLayout {
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+
+      //
+      // Source type
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Source") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } ComboBox {
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        model: Cpp_IO_Stream.sourceTypes
+        currentIndex: Cpp_IO_Stream.sourceType
+        palette.base: Cpp_ThemeManager.setupPanelBackground
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_IO_Stream.sourceType)
+            Cpp_IO_Stream.sourceType = currentIndex
+        }
+      }
+
+      //
+      // Path of the file, pipe or socket
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Path") + ":"
+        enabled: !Cpp_IO_Manager.connected
+        visible: Cpp_IO_Stream.sourceType !== 3
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+        visible: Cpp_IO_Stream.sourceType !== 3
+
+        TextField {
+          id: _path
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: !Cpp_IO_Manager.connected
+          placeholderText: qsTr("File, pipe or socket path")
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+          Component.onCompleted: text = Cpp_IO_Stream.path
+          onTextChanged: {
+            if (Cpp_IO_Stream.path !== text)
+              Cpp_IO_Stream.path = text
+          }
+
+          Connections {
+            target: Cpp_IO_Stream
+            function onPathChanged() {
+              if (_path.text !== Cpp_IO_Stream.path)
+                _path.text = Cpp_IO_Stream.path
+            }
+          }
+        }
+
+        Button {
+          width: 24
+          height: 24
+          icon.width: 16
+          icon.height: 16
+          opacity: enabled ? 1 : 0.5
+          icon.color: Cpp_ThemeManager.text
+          enabled: !Cpp_IO_Manager.connected
+          icon.source: "qrc:/icons/open.svg"
+          onClicked: Cpp_IO_Stream.selectFile()
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+        }
+      }
+    }
+
+    //
+    // Follow file option
+    //
+    CheckBox {
+      text: qsTr("Keep reading as the file grows")
+      checked: Cpp_IO_Stream.follow
+      visible: Cpp_IO_Stream.sourceType === 0
+      onCheckedChanged: {
+        if (Cpp_IO_Stream.follow !== checked)
+          Cpp_IO_Stream.follow = checked
+      }
+    }
+
+    //
+    // Spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
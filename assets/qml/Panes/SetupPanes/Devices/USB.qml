@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+Control {
+  id: root
+
+  //
+  // Layout
+  //
+  ColumnLayout {
+    id: layout
+    anchors.fill: parent
+    anchors.margins: app.spacing
+
+    GridLayout {
+      columns: 2
+      Layout.fillWidth: true
+      rowSpacing: app.spacing
+      columnSpacing: app.spacing
+      enabled: Cpp_IO_USB.supported
+
+      //
+      // Device selector
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Device") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        ComboBox {
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: !Cpp_IO_Manager.connected
+          model: Cpp_IO_USB.deviceList
+          currentIndex: Cpp_IO_USB.deviceIndex
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+          onCurrentIndexChanged: {
+            if (currentIndex !== Cpp_IO_USB.deviceIndex)
+              Cpp_IO_USB.deviceIndex = currentIndex
+          }
+        }
+
+        Button {
+          width: 24
+          height: 24
+          icon.width: 16
+          icon.height: 16
+          opacity: enabled ? 1 : 0.5
+          icon.color: Cpp_ThemeManager.text
+          enabled: !Cpp_IO_Manager.connected
+          icon.source: "qrc:/icons/refresh.svg"
+          onClicked: Cpp_IO_USB.refreshDevices()
+          palette.base: Cpp_ThemeManager.setupPanelBackground
+        }
+      }
+
+      //
+      // Interface number
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Interface") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } SpinBox {
+        from: 0
+        to: 255
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        value: Cpp_IO_USB.interfaceNumber
+        onValueModified: Cpp_IO_USB.interfaceNumber = value
+      }
+
+      //
+      // Bulk IN endpoint
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("IN endpoint") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } SpinBox {
+        from: 1
+        to: 15
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        value: Cpp_IO_USB.inEndpoint
+        onValueModified: Cpp_IO_USB.inEndpoint = value
+      }
+
+      //
+      // Bulk OUT endpoint
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("OUT endpoint") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } SpinBox {
+        from: 0
+        to: 15
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        value: Cpp_IO_USB.outEndpoint
+        onValueModified: Cpp_IO_USB.outEndpoint = value
+      }
+
+      //
+      // Transfer size
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Transfer size (KB)") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } SpinBox {
+        from: 1
+        to: 4096
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        value: Math.ceil(Cpp_IO_USB.transferSize / 1024)
+        onValueModified: Cpp_IO_USB.transferSize = value * 1024
+      }
+
+      //
+      // Queue depth
+      //
+      Label {
+        opacity: enabled ? 1 : 0.5
+        text: qsTr("Queued transfers") + ":"
+        enabled: !Cpp_IO_Manager.connected
+      } SpinBox {
+        from: 1
+        to: 64
+        editable: true
+        Layout.fillWidth: true
+        opacity: enabled ? 1 : 0.5
+        enabled: !Cpp_IO_Manager.connected
+        value: Cpp_IO_USB.queueDepth
+        onValueModified: Cpp_IO_USB.queueDepth = value
+      }
+    }
+
+    //
+    // libusb not available
+    //
+    Label {
+      opacity: 0.8
+      Layout.fillWidth: true
+      wrapMode: Label.WordWrap
+      visible: !Cpp_IO_USB.supported
+      text: qsTr("This build does not include libusb support.")
+    }
+
+    //
+    // Spacer
+    //
+    Item {
+      Layout.fillHeight: true
+    }
+  }
+}
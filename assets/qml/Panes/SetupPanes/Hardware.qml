@@ -113,6 +113,60 @@ Control {
           enabled: false
         }
       }
+
+      Devices.Replay {
+        id: replay
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
+
+      Devices.Stream {
+        id: stream
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
+
+      Devices.CANBus {
+        id: canBus
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
+
+      Devices.Modbus {
+        id: modbus
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
+
+      Devices.USB {
+        id: usb
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
+
+      Devices.Audio {
+        id: audio
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        background: TextField {
+          enabled: false
+        }
+      }
     }
   }
 }
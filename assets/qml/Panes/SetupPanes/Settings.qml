@@ -83,6 +83,22 @@ Control {
         }
       }
 
+      //
+      // Console enabled, disable it for dashboard-only setups
+      //
+      Label {
+        text: qsTr("Console") + ": "
+      } Switch {
+        id: _console
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_IO_Console.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_IO_Console.enabled)
+            Cpp_IO_Console.enabled = checked
+        }
+      }
+
       //
       // Plugins enabled
       //
@@ -99,6 +115,249 @@ Control {
         }
       }
 
+      //
+      // WebSocket endpoint for remote dashboards
+      //
+      Label {
+        text: qsTr("Remote dashboard (WebSocket)") + ": "
+      } Switch {
+        id: _webSocket
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_Bridge.webSocketEnabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_Bridge.webSocketEnabled)
+            Cpp_Plugins_Bridge.webSocketEnabled = checked
+        }
+      }
+
+      //
+      // Shared memory transport for local plugins
+      //
+      Label {
+        text: qsTr("Shared memory frames") + ": "
+      } Switch {
+        id: _sharedMemory
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_SharedMemory.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_SharedMemory.enabled)
+            Cpp_Plugins_SharedMemory.enabled = checked
+        }
+      }
+
+      //
+      // Capacity of the shared memory ring
+      //
+      Label {
+        text: qsTr("Shared memory size") + ": "
+      } ComboBox {
+        id: _sharedMemorySize
+        Layout.fillWidth: true
+        readonly property var sizes: [4, 16, 64, 256]
+        model: ["4 MB", "16 MB", "64 MB", "256 MB"]
+        currentIndex: Math.max(0, sizes.indexOf(
+                                 Cpp_Plugins_SharedMemory.ringSize))
+        onCurrentIndexChanged: {
+          if (sizes[currentIndex] !== Cpp_Plugins_SharedMemory.ringSize)
+            Cpp_Plugins_SharedMemory.ringSize = sizes[currentIndex]
+        }
+      }
+
+      //
+      // ZeroMQ PUB endpoint for low-latency subscribers
+      //
+      Label {
+        text: qsTr("ZeroMQ publisher") + ": "
+      } Switch {
+        id: _zmqPublisher
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_ZmqPublisher.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_ZmqPublisher.enabled)
+            Cpp_Plugins_ZmqPublisher.enabled = checked
+        }
+      }
+
+      //
+      // Publish raw data through ZeroMQ
+      //
+      Label {
+        text: qsTr("ZeroMQ raw data") + ": "
+      } Switch {
+        id: _zmqRawData
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_ZmqPublisher.rawData
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_ZmqPublisher.rawData)
+            Cpp_Plugins_ZmqPublisher.rawData = checked
+        }
+      }
+
+      //
+      // Prefix of the ZeroMQ topics
+      //
+      Label {
+        text: qsTr("ZeroMQ topic prefix") + ": "
+      } TextField {
+        id: _zmqTopicPrefix
+        Layout.fillWidth: true
+        text: Cpp_Plugins_ZmqPublisher.topicPrefix
+        onEditingFinished: {
+          if (text !== Cpp_Plugins_ZmqPublisher.topicPrefix)
+            Cpp_Plugins_ZmqPublisher.topicPrefix = text
+        }
+      }
+
+      //
+      // ZeroMQ RADIO datagrams for DISH subscribers
+      //
+      Label {
+        text: qsTr("ZeroMQ RADIO (UDP)") + ": "
+      } Switch {
+        id: _zmqRadio
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_ZmqPublisher.radioEnabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_ZmqPublisher.radioEnabled)
+            Cpp_Plugins_ZmqPublisher.radioEnabled = checked
+        }
+      }
+
+      //
+      // Destination of the ZeroMQ RADIO datagrams
+      //
+      Label {
+        text: qsTr("ZeroMQ RADIO address") + ": "
+      } TextField {
+        id: _zmqRadioAddress
+        Layout.fillWidth: true
+        enabled: Cpp_Plugins_ZmqPublisher.radioEnabled
+        text: Cpp_Plugins_ZmqPublisher.radioAddress
+        onEditingFinished: {
+          if (text !== Cpp_Plugins_ZmqPublisher.radioAddress)
+            Cpp_Plugins_ZmqPublisher.radioAddress = text
+        }
+      }
+
+      //
+      // UDP forwarding of parsed frames
+      //
+      Label {
+        text: qsTr("UDP forwarding") + ": "
+      } Switch {
+        id: _udpForwarder
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Plugins_UdpForwarder.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Plugins_UdpForwarder.enabled)
+            Cpp_Plugins_UdpForwarder.enabled = checked
+        }
+      }
+
+      //
+      // UDP destinations
+      //
+      Label {
+        text: qsTr("UDP destinations") + ": "
+      } TextField {
+        id: _udpDestinations
+        Layout.fillWidth: true
+        placeholderText: "127.0.0.1:9000, 239.0.0.1:9001"
+        text: Cpp_Plugins_UdpForwarder.destinations
+        onEditingFinished: {
+          if (text !== Cpp_Plugins_UdpForwarder.destinations)
+            Cpp_Plugins_UdpForwarder.destinations = text
+        }
+      }
+
+      //
+      // Datasets forwarded through UDP
+      //
+      Label {
+        text: qsTr("UDP datasets") + ": "
+      } TextField {
+        id: _udpDatasets
+        Layout.fillWidth: true
+        placeholderText: qsTr("All datasets (e.g. 1, 2, 5-8)")
+        text: Cpp_Plugins_UdpForwarder.datasets
+        onEditingFinished: {
+          if (text !== Cpp_Plugins_UdpForwarder.datasets)
+            Cpp_Plugins_UdpForwarder.datasets = text
+        }
+      }
+
+      //
+      // Encoding of the UDP records
+      //
+      Label {
+        text: qsTr("UDP format") + ": "
+      } ComboBox {
+        id: _udpFormat
+        Layout.fillWidth: true
+        model: Cpp_Plugins_UdpForwarder.availableFormats
+        currentIndex: Cpp_Plugins_UdpForwarder.format
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Plugins_UdpForwarder.format)
+            Cpp_Plugins_UdpForwarder.format = currentIndex
+        }
+      }
+
+      //
+      // Datagram mode of the UDP forwarder
+      //
+      Label {
+        text: qsTr("UDP datagrams") + ": "
+      } ComboBox {
+        id: _udpMode
+        Layout.fillWidth: true
+        model: Cpp_Plugins_UdpForwarder.availableModes
+        currentIndex: Cpp_Plugins_UdpForwarder.mode
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Plugins_UdpForwarder.mode)
+            Cpp_Plugins_UdpForwarder.mode = currentIndex
+        }
+      }
+
+      //
+      // Maximum amount of data queued for each plugin
+      //
+      Label {
+        text: qsTr("Plugin queue limit") + ": "
+      } ComboBox {
+        id: _queueLimit
+        Layout.fillWidth: true
+        readonly property var limits: [1, 4, 16, 64]
+        model: ["1 MB", "4 MB", "16 MB", "64 MB"]
+        currentIndex: Math.max(0, limits.indexOf(
+                                 Cpp_Plugins_Bridge.queueLimit))
+        onCurrentIndexChanged: {
+          if (limits[currentIndex] !== Cpp_Plugins_Bridge.queueLimit)
+            Cpp_Plugins_Bridge.queueLimit = limits[currentIndex]
+        }
+      }
+
+      //
+      // Action taken when a plugin exceeds its queue limit
+      //
+      Label {
+        text: qsTr("Plugin overflow policy") + ": "
+      } ComboBox {
+        id: _overflowPolicy
+        Layout.fillWidth: true
+        model: Cpp_Plugins_Bridge.availableOverflowPolicies
+        currentIndex: Cpp_Plugins_Bridge.overflowPolicy
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Plugins_Bridge.overflowPolicy)
+            Cpp_Plugins_Bridge.overflowPolicy = currentIndex
+        }
+      }
+
       //
       // Custom window decorations
       //
@@ -114,19 +373,803 @@ Control {
             Cpp_ThemeManager.customWindowDecorations = checked
         }
       }
-    }
 
-    //
-    // Plugins label
-    //
-    Label {
-      opacity: 0.8
-      font.pixelSize: 12
-      Layout.fillWidth: true
-      wrapMode: Label.WrapAtWordBoundaryOrAnywhere
-      color: Cpp_ThemeManager.highlightedTextAlternative
-      text: qsTr("Applications/plugins can interact with %1 by " +
-                 "establishing a TCP connection on port 7777.").arg(Cpp_AppName)
+      //
+      // Maximum number of bytes handed over to the driver at once
+      //
+      Label {
+        text: qsTr("Write window") + ": "
+      } ComboBox {
+        id: _writeMaxInFlight
+        Layout.fillWidth: true
+        readonly property var sizes: [0, 64, 256, 1024, 4096, 16384, 65536]
+        model: [qsTr("Unlimited"), "64 B", "256 B", "1 KB", "4 KB", "16 KB",
+                "64 KB"]
+        currentIndex: Math.max(0, sizes.indexOf(
+                                 Cpp_IO_Manager.writeMaxInFlight))
+        onCurrentIndexChanged: {
+          if (sizes[currentIndex] !== Cpp_IO_Manager.writeMaxInFlight)
+            Cpp_IO_Manager.writeMaxInFlight = sizes[currentIndex]
+        }
+      }
+
+      //
+      // Maximum rate at which data is written to the device
+      //
+      Label {
+        text: qsTr("Write pacing") + ": "
+      } ComboBox {
+        id: _writePacingRate
+        Layout.fillWidth: true
+        readonly property var rates: [0, 960, 1920, 11520, 102400, 1048576]
+        model: [qsTr("Unlimited"), "960 B/s", "1.9 KB/s", "11.5 KB/s",
+                "100 KB/s", "1 MB/s"]
+        currentIndex: Math.max(0, rates.indexOf(
+                                 Cpp_IO_Manager.writePacingRate))
+        onCurrentIndexChanged: {
+          if (rates[currentIndex] !== Cpp_IO_Manager.writePacingRate)
+            Cpp_IO_Manager.writePacingRate = rates[currentIndex]
+        }
+      }
+
+      //
+      // Pause transmission when the device sends XOFF
+      //
+      Label {
+        text: qsTr("Honor XON/XOFF") + ": "
+      } Switch {
+        id: _writeXonXoff
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_IO_Manager.writeXonXoff
+        onCheckedChanged: {
+          if (checked !== Cpp_IO_Manager.writeXonXoff)
+            Cpp_IO_Manager.writeXonXoff = checked
+        }
+      }
+
+      //
+      // Frame extraction in a worker thread
+      //
+      Label {
+        text: qsTr("Threaded frame extraction") + ": "
+      } Switch {
+        id: _threadedFrameExtraction
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_IO_Manager.threadedFrameExtraction
+        onCheckedChanged: {
+          if (checked !== Cpp_IO_Manager.threadedFrameExtraction)
+            Cpp_IO_Manager.threadedFrameExtraction = checked
+        }
+      }
+
+      //
+      // Real-time scheduling of the frame extraction thread
+      //
+      Label {
+        text: qsTr("Real-time I/O thread") + ": "
+        enabled: Cpp_IO_Manager.threadedFrameExtraction
+      } Switch {
+        id: _realtimeIoThread
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        enabled: Cpp_IO_Manager.threadedFrameExtraction
+        checked: Cpp_IO_Manager.realtimeIoThread
+        onCheckedChanged: {
+          if (checked !== Cpp_IO_Manager.realtimeIoThread)
+            Cpp_IO_Manager.realtimeIoThread = checked
+        }
+      }
+
+      //
+      // CPU core of the frame extraction thread
+      //
+      Label {
+        text: qsTr("I/O thread CPU") + ": "
+        enabled: Cpp_IO_Manager.threadedFrameExtraction
+      } ComboBox {
+        id: _ioThreadCpu
+        Layout.fillWidth: true
+        enabled: Cpp_IO_Manager.threadedFrameExtraction
+        model: Cpp_Misc_Renderer.cpuNames()
+        currentIndex: Cpp_IO_Manager.ioThreadCpu + 1
+        onCurrentIndexChanged: {
+          if (currentIndex - 1 !== Cpp_IO_Manager.ioThreadCpu)
+            Cpp_IO_Manager.ioThreadCpu = currentIndex - 1
+        }
+      }
+
+      //
+      // Restore lost connections automatically
+      //
+      Label {
+        text: qsTr("Reconnect automatically") + ": "
+      } Switch {
+        id: _autoReconnect
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_IO_Manager.autoReconnect
+        onCheckedChanged: {
+          if (checked !== Cpp_IO_Manager.autoReconnect)
+            Cpp_IO_Manager.autoReconnect = checked
+        }
+      }
+
+      //
+      // Frame parser scripts in a pool of worker threads
+      //
+      Label {
+        text: qsTr("Parallel frame parsing") + ": "
+      } Switch {
+        id: _parallelParsing
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_JSON_Generator.parallelParsing
+        onCheckedChanged: {
+          if (checked !== Cpp_JSON_Generator.parallelParsing)
+            Cpp_JSON_Generator.parallelParsing = checked
+        }
+      }
+
+      //
+      // Generation of frames in a worker thread
+      //
+      Label {
+        text: qsTr("Threaded frame processing") + ": "
+      } Switch {
+        id: _threadedProcessing
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_JSON_Generator.threadedProcessing
+        onCheckedChanged: {
+          if (checked !== Cpp_JSON_Generator.threadedProcessing)
+            Cpp_JSON_Generator.threadedProcessing = checked
+        }
+      }
+
+      //
+      // Handling of frames when the user interface falls behind
+      //
+      Label {
+        text: qsTr("Backpressure policy") + ": "
+      } ComboBox {
+        id: _backpressurePolicy
+        Layout.fillWidth: true
+        model: Cpp_JSON_Generator.availableBackpressurePolicies()
+        currentIndex: Cpp_JSON_Generator.backpressurePolicy
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_JSON_Generator.backpressurePolicy)
+            Cpp_JSON_Generator.backpressurePolicy = currentIndex
+        }
+      }
+
+      //
+      // Alignment of the frames of different devices on a common time base
+      //
+      Label {
+        text: qsTr("Resampling") + ": "
+      } ComboBox {
+        id: _resamplingMode
+        Layout.fillWidth: true
+        model: Cpp_JSON_Generator.availableResamplingModes()
+        currentIndex: Cpp_JSON_Generator.resamplingMode
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_JSON_Generator.resamplingMode)
+            Cpp_JSON_Generator.resamplingMode = currentIndex
+        }
+      }
+
+      //
+      // Interval between resampled frames
+      //
+      Label {
+        text: qsTr("Resampling interval") + ": "
+      } ComboBox {
+        id: _resamplingInterval
+        Layout.fillWidth: true
+        enabled: Cpp_JSON_Generator.resamplingMode > 0
+        readonly property var intervals: [1, 5, 10, 20, 50, 100]
+        model: ["1 ms", "5 ms", "10 ms", "20 ms", "50 ms", "100 ms"]
+        currentIndex: Math.max(0, intervals.indexOf(
+                                 Cpp_JSON_Generator.resamplingInterval))
+        onCurrentIndexChanged: {
+          if (intervals[currentIndex] !==
+              Cpp_JSON_Generator.resamplingInterval)
+            Cpp_JSON_Generator.resamplingInterval = intervals[currentIndex]
+        }
+      }
+
+      //
+      // Draw plots directly with the Qt Quick scene graph
+      //
+      Label {
+        text: qsTr("Native plot rendering") + ": "
+      } Switch {
+        id: _nativeRendering
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_UI_Dashboard.nativeRendering
+        onCheckedChanged: {
+          if (checked !== Cpp_UI_Dashboard.nativeRendering)
+            Cpp_UI_Dashboard.nativeRendering = checked
+        }
+      }
+
+      //
+      // Render the plot widgets with a pool of worker threads
+      //
+      Label {
+        text: qsTr("Parallel rendering") + ": "
+      } Switch {
+        id: _parallelRendering
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_UI_Dashboard.parallelRendering
+        onCheckedChanged: {
+          if (checked !== Cpp_UI_Dashboard.parallelRendering)
+            Cpp_UI_Dashboard.parallelRendering = checked
+        }
+      }
+
+      //
+      // Paint the plot widgets with OpenGL (only with the OpenGL backend)
+      //
+      Label {
+        text: qsTr("OpenGL plot rendering") + ": "
+      } Switch {
+        id: _openGLRendering
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_UI_Dashboard.openGLRendering
+        onCheckedChanged: {
+          if (checked !== Cpp_UI_Dashboard.openGLRendering)
+            Cpp_UI_Dashboard.openGLRendering = checked
+        }
+      }
+
+      //
+      // Display the render cost of each widget on top of it
+      //
+      Label {
+        text: qsTr("Render cost overlay") + ": "
+      } Switch {
+        id: _renderCostOverlay
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_UI_Dashboard.renderCostOverlay
+        onCheckedChanged: {
+          if (checked !== Cpp_UI_Dashboard.renderCostOverlay)
+            Cpp_UI_Dashboard.renderCostOverlay = checked
+        }
+      }
+
+      //
+      // Maximum repaint rate of the dashboard widgets
+      //
+      Label {
+        text: qsTr("Render rate") + ": "
+      } ComboBox {
+        id: _renderRate
+        Layout.fillWidth: true
+        readonly property var rates: [0, 120, 60, 30, 20, 10]
+        model: [qsTr("Display refresh rate"), "120 Hz", "60 Hz", "30 Hz",
+          "20 Hz", "10 Hz"]
+        currentIndex: Math.max(0, rates.indexOf(
+                                 Cpp_Misc_TimerEvents.renderRate))
+        onCurrentIndexChanged: {
+          if (rates[currentIndex] !== Cpp_Misc_TimerEvents.renderRate)
+            Cpp_Misc_TimerEvents.renderRate = rates[currentIndex]
+        }
+      }
+
+      //
+      // Lower the render rate automatically when the UI falls behind
+      //
+      Label {
+        text: qsTr("Adaptive rendering") + ": "
+      } Switch {
+        id: _adaptiveRendering
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Misc_TimerEvents.adaptiveRendering
+        onCheckedChanged: {
+          if (checked !== Cpp_Misc_TimerEvents.adaptiveRendering)
+            Cpp_Misc_TimerEvents.adaptiveRendering = checked
+        }
+      }
+
+      //
+      // Stop the timers while no device is connected
+      //
+      Label {
+        text: qsTr("Idle when disconnected") + ": "
+      } Switch {
+        id: _idleMode
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Misc_TimerEvents.idleMode
+        onCheckedChanged: {
+          if (checked !== Cpp_Misc_TimerEvents.idleMode)
+            Cpp_Misc_TimerEvents.idleMode = checked
+        }
+      }
+
+      //
+      // Scene graph render loop
+      //
+      Label {
+        text: qsTr("Render loop") + ": "
+      } ComboBox {
+        id: _renderLoop
+        Layout.fillWidth: true
+        model: Cpp_Misc_Renderer.renderLoops()
+        currentIndex: Cpp_Misc_Renderer.renderLoop
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Misc_Renderer.renderLoop)
+            Cpp_Misc_Renderer.renderLoop = currentIndex
+        }
+      }
+
+      //
+      // Graphics API used by the scene graph
+      //
+      Label {
+        text: qsTr("Graphics backend") + ": "
+      } ComboBox {
+        id: _graphicsBackend
+        Layout.fillWidth: true
+        model: Cpp_Misc_Renderer.graphicsBackends()
+        currentIndex: Cpp_Misc_Renderer.graphicsBackend
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Misc_Renderer.graphicsBackend)
+            Cpp_Misc_Renderer.graphicsBackend = currentIndex
+        }
+      }
+
+      //
+      // Synchronize the frames with the display refresh
+      //
+      Label {
+        text: qsTr("Vertical sync") + ": "
+      } Switch {
+        id: _vsync
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Misc_Renderer.vsync
+        onCheckedChanged: {
+          if (checked !== Cpp_Misc_Renderer.vsync)
+            Cpp_Misc_Renderer.vsync = checked
+        }
+      }
+
+      //
+      // CPU core of the render thread
+      //
+      Label {
+        text: qsTr("Render thread CPU") + ": "
+      } ComboBox {
+        id: _renderThreadCpu
+        Layout.fillWidth: true
+        model: Cpp_Misc_Renderer.cpuNames()
+        currentIndex: Cpp_Misc_Renderer.renderThreadCpu + 1
+        onCurrentIndexChanged: {
+          if (currentIndex - 1 !== Cpp_Misc_Renderer.renderThreadCpu)
+            Cpp_Misc_Renderer.renderThreadCpu = currentIndex - 1
+        }
+      }
+
+      //
+      // Show the render statistics on top of the user interface
+      //
+      Label {
+        text: qsTr("Performance overlay") + ": "
+      } Switch {
+        id: _performanceOverlay
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_Misc_Renderer.overlayEnabled
+        onCheckedChanged: {
+          if (checked !== Cpp_Misc_Renderer.overlayEnabled)
+            Cpp_Misc_Renderer.overlayEnabled = checked
+        }
+      }
+
+      //
+      // Render options are applied when the application starts
+      //
+      Label {
+        opacity: 0.8
+        font.italic: true
+        Layout.columnSpan: 2
+        Layout.fillWidth: true
+        wrapMode: Label.WordWrap
+        visible: Cpp_Misc_Renderer.restartRequired
+        text: qsTr("Restart %1 to apply the render settings.").arg(
+                Cpp_AppName)
+      }
+
+      //
+      // Rate at which CSV rows are handed to the writer thread
+      //
+      Label {
+        text: qsTr("CSV export rate") + ": "
+      } ComboBox {
+        id: _csvExportRate
+        Layout.fillWidth: true
+        readonly property var rates: [1, 2, 5, 10, 20, 50]
+        model: ["1 Hz", "2 Hz", "5 Hz", "10 Hz", "20 Hz", "50 Hz"]
+        currentIndex: Math.max(0, rates.indexOf(
+                                 Cpp_Misc_TimerEvents.csvExportRate))
+        onCurrentIndexChanged: {
+          if (rates[currentIndex] !== Cpp_Misc_TimerEvents.csvExportRate)
+            Cpp_Misc_TimerEvents.csvExportRate = rates[currentIndex]
+        }
+      }
+
+      //
+      // Rate at which processed frames are sent to plugins
+      //
+      Label {
+        text: qsTr("Plugin update rate") + ": "
+      } ComboBox {
+        id: _pluginsRate
+        Layout.fillWidth: true
+        readonly property var rates: [1, 2, 5, 10, 20, 50]
+        model: ["1 Hz", "2 Hz", "5 Hz", "10 Hz", "20 Hz", "50 Hz"]
+        currentIndex: Math.max(0, rates.indexOf(
+                                 Cpp_Misc_TimerEvents.pluginsRate))
+        onCurrentIndexChanged: {
+          if (rates[currentIndex] !== Cpp_Misc_TimerEvents.pluginsRate)
+            Cpp_Misc_TimerEvents.pluginsRate = rates[currentIndex]
+        }
+      }
+
+      //
+      // Window function applied before calculating FFTs
+      //
+      Label {
+        text: qsTr("FFT window") + ": "
+      } ComboBox {
+        id: _fftWindow
+        Layout.fillWidth: true
+        model: Cpp_UI_FFTEngine.availableWindows
+        currentIndex: Cpp_UI_FFTEngine.window
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_UI_FFTEngine.window)
+            Cpp_UI_FFTEngine.window = currentIndex
+        }
+      }
+
+      //
+      // Overlap between consecutive FFT blocks
+      //
+      Label {
+        text: qsTr("FFT overlap") + ": "
+      } ComboBox {
+        id: _fftOverlap
+        Layout.fillWidth: true
+        readonly property var overlaps: [0, 25, 50, 75, 90]
+        model: ["0%", "25%", "50%", "75%", "90%"]
+        currentIndex: Math.max(0, overlaps.indexOf(Cpp_UI_FFTEngine.overlap))
+        onCurrentIndexChanged: {
+          if (overlaps[currentIndex] !== Cpp_UI_FFTEngine.overlap)
+            Cpp_UI_FFTEngine.overlap = overlaps[currentIndex]
+        }
+      }
+
+      //
+      // Number of averaged spectra
+      //
+      Label {
+        text: qsTr("FFT averaging") + ": "
+      } ComboBox {
+        id: _fftAveraging
+        Layout.fillWidth: true
+        readonly property var counts: [1, 2, 4, 8, 16]
+        model: [qsTr("None"), "2", "4", "8", "16"]
+        currentIndex: Math.max(0, counts.indexOf(Cpp_UI_FFTEngine.averaging))
+        onCurrentIndexChanged: {
+          if (counts[currentIndex] !== Cpp_UI_FFTEngine.averaging)
+            Cpp_UI_FFTEngine.averaging = counts[currentIndex]
+        }
+      }
+
+      //
+      // File format used to record received frames
+      //
+      Label {
+        text: qsTr("Recording format") + ": "
+      } ComboBox {
+        id: _exportFormat
+        Layout.fillWidth: true
+        model: Cpp_CSV_Export.availableExportFormats
+        currentIndex: Cpp_CSV_Export.exportFormat
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_CSV_Export.exportFormat)
+            Cpp_CSV_Export.exportFormat = currentIndex
+        }
+      }
+
+      //
+      // Interval at which recorded data is written to disk
+      //
+      Label {
+        text: qsTr("Recording flush interval") + ": "
+      } ComboBox {
+        id: _flushInterval
+        Layout.fillWidth: true
+        readonly property var intervals: [1, 5, 10, 30, 60]
+        model: ["1 s", "5 s", "10 s", "30 s", "60 s"]
+        currentIndex: Math.max(0, intervals.indexOf(
+                                 Cpp_CSV_Export.flushInterval))
+        onCurrentIndexChanged: {
+          if (intervals[currentIndex] !== Cpp_CSV_Export.flushInterval)
+            Cpp_CSV_Export.flushInterval = intervals[currentIndex]
+        }
+      }
+
+      //
+      // Synchronize recordings with the storage device after each flush
+      //
+      Label {
+        text: qsTr("Sync recordings to disk") + ": "
+      } Switch {
+        id: _syncToDisk
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_CSV_Export.syncToDisk
+        onCheckedChanged: {
+          if (checked !== Cpp_CSV_Export.syncToDisk)
+            Cpp_CSV_Export.syncToDisk = checked
+        }
+      }
+
+      //
+      // Start a new recording once the current file reaches a given size
+      //
+      Label {
+        text: qsTr("Rotate recordings by size") + ": "
+      } ComboBox {
+        id: _rotationSize
+        Layout.fillWidth: true
+        readonly property var sizes: [0, 64, 256, 1024, 4096]
+        model: [qsTr("Never"), "64 MB", "256 MB", "1 GB", "4 GB"]
+        currentIndex: Math.max(0, sizes.indexOf(
+                                 Cpp_CSV_Export.rotationSize))
+        onCurrentIndexChanged: {
+          if (sizes[currentIndex] !== Cpp_CSV_Export.rotationSize)
+            Cpp_CSV_Export.rotationSize = sizes[currentIndex]
+        }
+      }
+
+      //
+      // Start a new recording periodically
+      //
+      Label {
+        text: qsTr("Rotate recordings by time") + ": "
+      } ComboBox {
+        id: _rotationInterval
+        Layout.fillWidth: true
+        readonly property var intervals: [0, 15, 60, 360, 1440]
+        model: [qsTr("Never"), "15 min", "1 h", "6 h", "24 h"]
+        currentIndex: Math.max(0, intervals.indexOf(
+                                 Cpp_CSV_Export.rotationInterval))
+        onCurrentIndexChanged: {
+          if (intervals[currentIndex] !== Cpp_CSV_Export.rotationInterval)
+            Cpp_CSV_Export.rotationInterval = intervals[currentIndex]
+        }
+      }
+
+      //
+      // Compress CSV files while they are written
+      //
+      Label {
+        text: qsTr("Compress CSV files (gzip)") + ": "
+      } Switch {
+        id: _compressCsv
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_CSV_Export.compressCsv
+        onCheckedChanged: {
+          if (checked !== Cpp_CSV_Export.compressCsv)
+            Cpp_CSV_Export.compressCsv = checked
+        }
+      }
+
+      //
+      // Store typed samples, alarms & markers in a session database
+      //
+      Label {
+        text: qsTr("Session database") + ": "
+      } Switch {
+        id: _sessionStore
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_CSV_SessionStore.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_CSV_SessionStore.enabled)
+            Cpp_CSV_SessionStore.enabled = checked
+        }
+      }
+
+      //
+      // Write frames to an InfluxDB server
+      //
+      Label {
+        text: qsTr("InfluxDB export") + ": "
+      } Switch {
+        id: _influxEnabled
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_InfluxDB_Client.enabled
+        onCheckedChanged: {
+          if (checked !== Cpp_InfluxDB_Client.enabled)
+            Cpp_InfluxDB_Client.enabled = checked
+        }
+      }
+
+      //
+      // InfluxDB server URL
+      //
+      Label {
+        text: qsTr("InfluxDB URL") + ": "
+      } TextField {
+        id: _influxUrl
+        Layout.fillWidth: true
+        placeholderText: "http://localhost:8086"
+        Component.onCompleted: text = Cpp_InfluxDB_Client.url
+        onTextChanged: {
+          if (Cpp_InfluxDB_Client.url !== text)
+            Cpp_InfluxDB_Client.url = text
+        }
+      }
+
+      //
+      // InfluxDB organization
+      //
+      Label {
+        text: qsTr("InfluxDB organization") + ": "
+      } TextField {
+        id: _influxOrganization
+        Layout.fillWidth: true
+        Component.onCompleted: text = Cpp_InfluxDB_Client.organization
+        onTextChanged: {
+          if (Cpp_InfluxDB_Client.organization !== text)
+            Cpp_InfluxDB_Client.organization = text
+        }
+      }
+
+      //
+      // InfluxDB bucket
+      //
+      Label {
+        text: qsTr("InfluxDB bucket") + ": "
+      } TextField {
+        id: _influxBucket
+        Layout.fillWidth: true
+        Component.onCompleted: text = Cpp_InfluxDB_Client.bucket
+        onTextChanged: {
+          if (Cpp_InfluxDB_Client.bucket !== text)
+            Cpp_InfluxDB_Client.bucket = text
+        }
+      }
+
+      //
+      // InfluxDB API token
+      //
+      Label {
+        text: qsTr("InfluxDB token") + ": "
+      } TextField {
+        id: _influxToken
+        Layout.fillWidth: true
+        echoMode: TextInput.Password
+        Component.onCompleted: text = Cpp_InfluxDB_Client.token
+        onTextChanged: {
+          if (Cpp_InfluxDB_Client.token !== text)
+            Cpp_InfluxDB_Client.token = text
+        }
+      }
+
+      //
+      // Compress the batches written to InfluxDB
+      //
+      Label {
+        text: qsTr("InfluxDB gzip compression") + ": "
+      } Switch {
+        id: _influxGzip
+        Layout.leftMargin: -app.spacing
+        Layout.alignment: Qt.AlignLeft
+        checked: Cpp_InfluxDB_Client.gzipEnabled
+        onCheckedChanged: {
+          if (checked !== Cpp_InfluxDB_Client.gzipEnabled)
+            Cpp_InfluxDB_Client.gzipEnabled = checked
+        }
+      }
+    }
+
+    //
+    // State of the InfluxDB spool
+    //
+    Label {
+      opacity: 0.8
+      font.pixelSize: 12
+      Layout.fillWidth: true
+      visible: Cpp_InfluxDB_Client.enabled
+      wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+      color: Cpp_ThemeManager.highlightedTextAlternative
+      text: qsTr("InfluxDB: %1 KB pending, %2 batches dropped")
+            .arg((Cpp_InfluxDB_Client.spooledBytes / 1024).toFixed(1))
+            .arg(Cpp_InfluxDB_Client.droppedBatches) +
+            (Cpp_InfluxDB_Client.lastError.length > 0 ?
+               " (" + Cpp_InfluxDB_Client.lastError + ")" : "")
+    }
+
+    //
+    // Plugins label
+    //
+    Label {
+      opacity: 0.8
+      font.pixelSize: 12
+      Layout.fillWidth: true
+      wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+      color: Cpp_ThemeManager.highlightedTextAlternative
+      text: qsTr("Applications/plugins can interact with %1 by " +
+                 "establishing a TCP connection on port 7777. Remote " +
+                 "dashboards can receive live data through a WebSocket " +
+                 "connection on port 7778. Local plugins can also read " +
+                 "frames from the %2 shared memory segment.")
+            .arg(Cpp_AppName).arg(Cpp_Plugins_SharedMemory.segmentName)
+    }
+
+    //
+    // UDP forwarder errors
+    //
+    Label {
+      opacity: 0.8
+      font.pixelSize: 12
+      Layout.fillWidth: true
+      visible: Cpp_Plugins_UdpForwarder.enabled &&
+               Cpp_Plugins_UdpForwarder.lastError.length > 0
+      wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+      color: Cpp_ThemeManager.highlightedTextAlternative
+      text: qsTr("UDP forwarding: %1").arg(
+              Cpp_Plugins_UdpForwarder.lastError)
+    }
+
+    //
+    // ZeroMQ publisher state
+    //
+    Label {
+      opacity: 0.8
+      font.pixelSize: 12
+      Layout.fillWidth: true
+      visible: Cpp_Plugins_ZmqPublisher.enabled
+      wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+      color: Cpp_ThemeManager.highlightedTextAlternative
+      text: qsTr("ZeroMQ: SUB sockets can connect to tcp://<host>:5556, " +
+                 "%1 subscribers connected").arg(
+              Cpp_Plugins_ZmqPublisher.subscribers) +
+            (Cpp_Plugins_ZmqPublisher.lastError.length > 0 ?
+               " (" + Cpp_Plugins_ZmqPublisher.lastError + ")" : "")
+    }
+
+    //
+    // Queue state of each connected plugin
+    //
+    Repeater {
+      model: Cpp_Plugins_Bridge.clients
+      delegate: Label {
+        opacity: 0.8
+        font.pixelSize: 12
+        Layout.fillWidth: true
+        elide: Label.ElideRight
+        color: Cpp_ThemeManager.highlightedTextAlternative
+        text: qsTr("%1 (%2): %3 KB queued, %4 messages dropped")
+              .arg(modelData.address).arg(modelData.protocol)
+              .arg((modelData.queuedBytes / 1024).toFixed(1))
+              .arg(modelData.dropped)
+      }
     }
 
     //
@@ -144,6 +144,7 @@ Control {
       icon.height: 24
       Layout.fillHeight: true
       enabled: dashboardBt.enabled
+      visible: Cpp_IO_Console.enabled
       onClicked: root.consoleClicked()
       icon.source: "qrc:/icons/code.svg"
       text: qsTr("Console") + _btSpacer
@@ -276,7 +277,7 @@ Control {
       //
       // Connection-dependent
       //
-      checked: Cpp_IO_Manager.connected
+      checked: Cpp_IO_Manager.connected || Cpp_IO_Manager.reconnecting
       text: (checked ? qsTr("Disconnect") :
                        qsTr("Connect")) + _btSpacer
       icon.source: checked ? "qrc:/icons/disconnect.svg" :
@@ -292,7 +293,7 @@ Control {
       // Only enable button if it can be clicked
       //
       opacity: enabled ? 1 : 0.5
-      enabled: Cpp_IO_Manager.configurationOk
+      enabled: Cpp_IO_Manager.configurationOk || Cpp_IO_Manager.reconnecting
 
       //
       // Connect/disconnect device when button is clicked
@@ -71,6 +71,13 @@ MenuBar {
         text: qsTr("Show CSV in explorer")
         onTriggered: Cpp_CSV_Export.openCurrentCsv()
       }
+
+      DecentMenuItem {
+        sequence: "ctrl+m"
+        enabled: Cpp_CSV_Export.isOpen
+        text: qsTr("Add marker")
+        onTriggered: Cpp_CSV_Export.addMarker("")
+      }
     }
 
     DecentMenuItem {
@@ -80,6 +87,27 @@ MenuBar {
       enabled: Cpp_JSON_Generator.operationMode === 0
     }
 
+    Menu {
+      title: qsTr("Reference recording")
+
+      DecentMenuItem {
+        text: qsTr("Open reference") + "..."
+        onTriggered: Cpp_CSV_Reference.openFile()
+      }
+
+      DecentMenuItem {
+        text: qsTr("Restart reference")
+        enabled: Cpp_CSV_Reference.isOpen
+        onTriggered: Cpp_CSV_Reference.restart()
+      }
+
+      DecentMenuItem {
+        text: qsTr("Close reference")
+        enabled: Cpp_CSV_Reference.isOpen
+        onTriggered: Cpp_CSV_Reference.closeFile()
+      }
+    }
+
     MenuSeparator {}
 
     DecentMenuItem {
@@ -141,6 +169,20 @@ MenuBar {
         onTriggered: Cpp_JSON_Generator.operationMode = checked ? 1 : 0
       }
 
+      DecentMenuItem {
+        checkable: true
+        text: qsTr("Device sends CBOR")
+        checked: Cpp_JSON_Generator.operationMode === 2
+        onTriggered: Cpp_JSON_Generator.operationMode = checked ? 2 : 0
+      }
+
+      DecentMenuItem {
+        checkable: true
+        text: qsTr("Device sends MessagePack")
+        checked: Cpp_JSON_Generator.operationMode === 3
+        onTriggered: Cpp_JSON_Generator.operationMode = checked ? 3 : 0
+      }
+
       DecentMenuItem {
         checkable: true
         text: qsTr("Load JSON from computer")
@@ -225,7 +267,7 @@ MenuBar {
       checkable: true
       checked: mainWindow.vt100emulation
       text: qsTr("VT-100 emulation")
-      onTriggered: mainWindow.vt100emulation = checked
+      onTriggered: mainWindow.setVt100emulation(checked)
     }
 
     DecentMenuItem {
@@ -340,6 +382,26 @@ MenuBar {
 
     MenuSeparator{}
 
+    DecentMenuItem {
+      text: qsTr("Burst recording") + "..."
+      onTriggered: app.burstDialog.show()
+    }
+
+    DecentMenuItem {
+      text: qsTr("Triggered capture") + "..."
+      onTriggered: app.captureDialog.show()
+    }
+
+    DecentMenuItem {
+      text: qsTr("Pipeline diagnostics") + "..."
+      onTriggered: app.diagnosticsDialog.show()
+    }
+
+    DecentMenuItem {
+      text: qsTr("File transfer") + "..."
+      onTriggered: app.fileTransferDialog.show()
+    }
+
     DecentMenuItem {
       text: qsTr("Report bug") + "..."
       onTriggered: Qt.openUrlExternally("https://github.com/Serial-Studio/Serial-Studio/issues")
@@ -54,6 +54,13 @@ MenuBar {
         text: qsTr("Show CSV in explorer")
         onTriggered: Cpp_CSV_Export.openCurrentCsv()
       }
+
+      MenuItem {
+        shortcut: "ctrl+m"
+        enabled: Cpp_CSV_Export.isOpen
+        text: qsTr("Add marker")
+        onTriggered: Cpp_CSV_Export.addMarker("")
+      }
     }
 
     MenuItem {
@@ -63,6 +70,27 @@ MenuBar {
       enabled: Cpp_JSON_Generator.operationMode === 0
     }
 
+    Menu {
+      title: qsTr("Reference recording")
+
+      MenuItem {
+        text: qsTr("Open reference") + "..."
+        onTriggered: Cpp_CSV_Reference.openFile()
+      }
+
+      MenuItem {
+        text: qsTr("Restart reference")
+        enabled: Cpp_CSV_Reference.isOpen
+        onTriggered: Cpp_CSV_Reference.restart()
+      }
+
+      MenuItem {
+        text: qsTr("Close reference")
+        enabled: Cpp_CSV_Reference.isOpen
+        onTriggered: Cpp_CSV_Reference.closeFile()
+      }
+    }
+
     MenuSeparator {}
 
     MenuItem {
@@ -124,6 +152,20 @@ MenuBar {
         onTriggered: Cpp_JSON_Generator.operationMode = checked ? 1 : 0
       }
 
+      MenuItem {
+        checkable: true
+        text: qsTr("Device sends CBOR")
+        checked: Cpp_JSON_Generator.operationMode === 2
+        onTriggered: Cpp_JSON_Generator.operationMode = checked ? 2 : 0
+      }
+
+      MenuItem {
+        checkable: true
+        text: qsTr("Device sends MessagePack")
+        checked: Cpp_JSON_Generator.operationMode === 3
+        onTriggered: Cpp_JSON_Generator.operationMode = checked ? 3 : 0
+      }
+
       MenuItem {
         checkable: true
         text: qsTr("Load JSON from computer")
@@ -207,7 +249,7 @@ MenuBar {
       checkable: true
       checked: mainWindow.vt100emulation
       text: qsTr("VT-100 emulation")
-      onTriggered: mainWindow.vt100emulation = checked
+      onTriggered: mainWindow.setVt100emulation(checked)
     }
 
     MenuItem {
@@ -322,6 +364,26 @@ MenuBar {
 
     MenuSeparator{}
 
+    MenuItem {
+      text: qsTr("Burst recording") + "..."
+      onTriggered: app.burstDialog.show()
+    }
+
+    MenuItem {
+      text: qsTr("Triggered capture") + "..."
+      onTriggered: app.captureDialog.show()
+    }
+
+    MenuItem {
+      text: qsTr("Pipeline diagnostics") + "..."
+      onTriggered: app.diagnosticsDialog.show()
+    }
+
+    MenuItem {
+      text: qsTr("File transfer") + "..."
+      onTriggered: app.fileTransferDialog.show()
+    }
+
     MenuItem {
       text: qsTr("Report bug") + "..."
       onTriggered: Qt.openUrlExternally("https://github.com/Serial-Studio/Serial-Studio/issues")
@@ -140,6 +140,18 @@ Rectangle {
       text: qsTr("Open existing project...") + _btSpacer
     }
 
+    Button {
+      icon.width: 24
+      icon.height: 24
+      icon.source: "qrc:/icons/device-hub.svg"
+      icon.color: Cpp_ThemeManager.menubarText
+      onClicked: Cpp_Project_Model.importDbcFile()
+      palette.buttonText: Cpp_ThemeManager.menubarText
+      palette.button: Cpp_ThemeManager.toolbarGradient1
+      palette.window: Cpp_ThemeManager.toolbarGradient1
+      text: qsTr("Import DBC file...") + _btSpacer
+    }
+
     Button {
       icon.width: 24
       icon.height: 24
@@ -184,6 +184,133 @@ Rectangle {
         }
       }
     }
+
+    //
+    // Framing mode
+    //
+    RowLayout {
+      spacing: app.spacing
+      Layout.fillWidth: true
+      Layout.columnSpan: 2
+
+      Label {
+        color: Cpp_ThemeManager.menubarText
+        text: qsTr("Frame detection:")
+      }
+
+      ComboBox {
+        Layout.fillWidth: true
+        Layout.maximumHeight: 24
+        Layout.minimumHeight: 24
+        model: Cpp_Project_Model.availableFramingModes()
+        currentIndex: Cpp_Project_Model.framingMode
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Project_Model.framingMode)
+            Cpp_Project_Model.setFramingMode(currentIndex)
+        }
+      }
+
+      Label {
+        color: Cpp_ThemeManager.menubarText
+        text: qsTr("Checksum:")
+      }
+
+      ComboBox {
+        Layout.fillWidth: true
+        Layout.maximumHeight: 24
+        Layout.minimumHeight: 24
+        model: Cpp_Project_Model.availableChecksumAlgorithms()
+        currentIndex: Cpp_Project_Model.checksumAlgorithm
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Project_Model.checksumAlgorithm)
+            Cpp_Project_Model.setChecksumAlgorithm(currentIndex)
+        }
+      }
+
+      ComboBox {
+        Layout.fillWidth: true
+        Layout.maximumHeight: 24
+        Layout.minimumHeight: 24
+        enabled: Cpp_Project_Model.checksumAlgorithm > 0
+        model: Cpp_Project_Model.availableChecksumPlacements()
+        currentIndex: Cpp_Project_Model.checksumPlacement
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Project_Model.checksumPlacement)
+            Cpp_Project_Model.setChecksumPlacement(currentIndex)
+        }
+      }
+
+      ComboBox {
+        Layout.fillWidth: true
+        Layout.maximumHeight: 24
+        Layout.minimumHeight: 24
+        enabled: Cpp_Project_Model.checksumAlgorithm > 0
+        model: Cpp_Project_Model.availableChecksumEncodings()
+        currentIndex: Cpp_Project_Model.checksumEncoding
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Project_Model.checksumEncoding)
+            Cpp_Project_Model.setChecksumEncoding(currentIndex)
+        }
+      }
+    }
+
+    //
+    // Compression mode
+    //
+    RowLayout {
+      spacing: app.spacing
+      Layout.fillWidth: true
+      Layout.columnSpan: 2
+
+      Label {
+        color: Cpp_ThemeManager.menubarText
+        text: qsTr("Compression:")
+      }
+
+      ComboBox {
+        Layout.fillWidth: true
+        Layout.maximumHeight: 24
+        Layout.minimumHeight: 24
+        model: Cpp_Project_Model.availableCompressionModes()
+        currentIndex: Cpp_Project_Model.compression
+        onCurrentIndexChanged: {
+          if (currentIndex !== Cpp_Project_Model.compression)
+            Cpp_Project_Model.setCompression(currentIndex)
+        }
+      }
+
+      Label {
+        enabled: Cpp_Project_Model.compression >= 3
+        color: Cpp_ThemeManager.menubarText
+        text: qsTr("Window bits:")
+      }
+
+      SpinBox {
+        from: 4
+        to: 15
+        Layout.maximumHeight: 24
+        Layout.minimumHeight: 24
+        enabled: Cpp_Project_Model.compression >= 3
+        value: Cpp_Project_Model.heatshrinkWindow
+        onValueModified: Cpp_Project_Model.setHeatshrinkWindow(value)
+      }
+
+      Label {
+        enabled: Cpp_Project_Model.compression >= 3
+        color: Cpp_ThemeManager.menubarText
+        text: qsTr("Lookahead bits:")
+      }
+
+      SpinBox {
+        from: 3
+        to: Cpp_Project_Model.heatshrinkWindow - 1
+        Layout.maximumHeight: 24
+        Layout.minimumHeight: 24
+        enabled: Cpp_Project_Model.compression >= 3
+        value: Cpp_Project_Model.heatshrinkLookahead
+        onValueModified: Cpp_Project_Model.setHeatshrinkLookahead(value)
+      }
+    }
   }
 
   anchors {
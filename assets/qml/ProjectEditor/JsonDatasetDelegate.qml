@@ -50,19 +50,23 @@ Widgets.Window {
   //
   property int group
   property int dataset
+  property bool xyGroup
   property bool multiplotGroup
   property bool showGroupWidget
 
   //
   // Convenience variables
   //
-  readonly property bool fftSamplesVisible: fftCheck.checked
+  readonly property bool fftSamplesVisible: fftCheck.checked ||
+                                            widget.currentIndex === 4
   readonly property bool alarmVisible: widget.currentIndex === 2
   readonly property bool minMaxVisible: widget.currentIndex === 1 ||
                                         widget.currentIndex === 2 ||
+                                        widget.currentIndex === 5 ||
                                         logPlot.checked ||
                                         linearPlot.checked ||
-                                        root.multiplotGroup
+                                        root.multiplotGroup ||
+                                        root.xyGroup
 
   //
   // User interface
@@ -112,11 +116,23 @@ Widgets.Window {
       text: Cpp_Project_Model.datasetIndex(group, dataset)
       onTextChanged: Cpp_Project_Model.setDatasetIndex(group, dataset, text)
       validator: IntValidator {
-        bottom: 1
+        bottom: 0
         top: 100
       }
     }
 
+    //
+    // Expression of computed datasets
+    //
+    Label {
+      text: qsTr("Expression:")
+    } TextField {
+      Layout.fillWidth: true
+      text: Cpp_Project_Model.datasetExpression(group, dataset)
+      placeholderText: qsTr("Optional, e.g. sqrt($1^2 + $2^2) or avg([Title], 10)")
+      onTextChanged: Cpp_Project_Model.setDatasetExpression(group, dataset, text)
+    }
+
     //
     // Dataset LED
     //
@@ -160,6 +176,28 @@ Widgets.Window {
       onCheckedChanged: Cpp_Project_Model.setDatasetLogPlot(group, dataset, checked)
     }
 
+    //
+    // Plot points (empty to use the number of points of the dashboard)
+    //
+    Label {
+      text: qsTr("Plot points:")
+      visible: linearPlot.checked || root.multiplotGroup
+    } TextField {
+      id: points
+      Layout.fillWidth: true
+      placeholderText: qsTr("Default")
+      visible: linearPlot.checked || root.multiplotGroup
+      onTextChanged: Cpp_Project_Model.setDatasetPoints(group, dataset, text)
+      text: {
+        const value = Cpp_Project_Model.datasetPoints(group, dataset)
+        return parseInt(value) > 0 ? value : ""
+      }
+      validator: IntValidator {
+        bottom: 0
+        top: 1000 * 1000
+      }
+    }
+
     //
     // FFT plot
     //
@@ -172,6 +210,26 @@ Widgets.Window {
       onCheckedChanged: Cpp_Project_Model.setDatasetFftPlot(group, dataset, checked)
     }
 
+    //
+    // Sequence counter width (empty if the dataset is not a frame counter)
+    //
+    Label {
+      text: qsTr("Sequence counter bits:")
+    } TextField {
+      id: sequenceBits
+      Layout.fillWidth: true
+      placeholderText: qsTr("None")
+      onTextChanged: Cpp_Project_Model.setDatasetSequenceBits(group, dataset, text)
+      text: {
+        const value = Cpp_Project_Model.datasetSequenceBits(group, dataset)
+        return parseInt(value) > 0 ? value : ""
+      }
+      validator: IntValidator {
+        bottom: 0
+        top: 64
+      }
+    }
+
     //
     // Dataset widget (user selectable or group-level constant)
     //
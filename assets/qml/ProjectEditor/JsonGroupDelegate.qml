@@ -204,6 +204,131 @@ Page {
       }
     }
 
+    //
+    // Heatmap matrix, the datasets of the group are generated from it
+    //
+    RowLayout {
+      id: matrix
+      spacing: app.spacing
+      Layout.fillWidth: true
+      visible: widget.currentIndex === 7
+
+      function apply() {
+        Cpp_Project_Model.setGroupMatrix(group, rows.value, columns.value,
+                                         frameIndex.value)
+      }
+
+      Label {
+        text: qsTr("Rows") + ":"
+        Layout.alignment: Qt.AlignVCenter
+      } SpinBox {
+        id: rows
+        from: 1
+        to: 256
+        editable: true
+        Layout.alignment: Qt.AlignVCenter
+        value: Math.max(1, Cpp_Project_Model.groupRows(group))
+        onValueModified: matrix.apply()
+      }
+
+      Label {
+        text: qsTr("Columns") + ":"
+        Layout.alignment: Qt.AlignVCenter
+      } SpinBox {
+        id: columns
+        from: 1
+        to: 256
+        editable: true
+        Layout.alignment: Qt.AlignVCenter
+        value: Math.max(1, Cpp_Project_Model.groupColumns(group))
+        onValueModified: matrix.apply()
+      }
+
+      Label {
+        text: qsTr("First frame index") + ":"
+        Layout.alignment: Qt.AlignVCenter
+      } SpinBox {
+        id: frameIndex
+        from: 1
+        to: 1000000
+        editable: true
+        Layout.alignment: Qt.AlignVCenter
+        value: Math.max(1, Cpp_Project_Model.datasetIndex(group, 0))
+        onValueModified: matrix.apply()
+      }
+
+      Item {
+        Layout.fillWidth: true
+      }
+
+      Label {
+        text: qsTr("Min value") + ":"
+        Layout.alignment: Qt.AlignVCenter
+      } TextField {
+        Layout.maximumWidth: 96
+        Layout.alignment: Qt.AlignVCenter
+        text: Cpp_Project_Model.datasetWidgetMin(group, 0)
+        validator: DoubleValidator {}
+        onTextChanged: Cpp_Project_Model.setDatasetWidgetMin(group, 0, text)
+      }
+
+      Label {
+        text: qsTr("Max value") + ":"
+        Layout.alignment: Qt.AlignVCenter
+      } TextField {
+        Layout.maximumWidth: 96
+        Layout.alignment: Qt.AlignVCenter
+        text: Cpp_Project_Model.datasetWidgetMax(group, 0)
+        validator: DoubleValidator {}
+        onTextChanged: Cpp_Project_Model.setDatasetWidgetMax(group, 0, text)
+      }
+    }
+
+    //
+    // Heatmap summary, the cells are not listed individually
+    //
+    Item {
+      Layout.fillWidth: true
+      Layout.fillHeight: true
+      visible: widget.currentIndex === 7
+
+      TextField {
+        enabled: false
+        anchors.fill: parent
+      }
+
+      ColumnLayout {
+        spacing: app.spacing
+        anchors.centerIn: parent
+
+        Widgets.Icon {
+          width: 128
+          height: 128
+          color: Cpp_ThemeManager.text
+          source: "qrc:/icons/heatmap.svg"
+          Layout.alignment: Qt.AlignHCenter
+        }
+
+        Label {
+          font.bold: true
+          font.pixelSize: 24
+          Layout.alignment: Qt.AlignHCenter
+          text: qsTr("%1 × %2 matrix").arg(rows.value).arg(columns.value)
+        }
+
+        Label {
+          opacity: 0.8
+          font.pixelSize: 18
+          Layout.alignment: Qt.AlignHCenter
+          wrapMode: Label.WrapAtWordBoundaryOrAnywhere
+          Layout.maximumWidth: parent.parent.width - 8 * app.spacing
+          text: qsTr("Frame fields %1 to %2 are displayed row by row")
+                  .arg(frameIndex.value)
+                  .arg(frameIndex.value + rows.value * columns.value - 1)
+        }
+      }
+    }
+
     //
     // Datasets
     //
@@ -211,6 +336,7 @@ Page {
       clip: true
       Layout.fillWidth: true
       Layout.fillHeight: true
+      visible: widget.currentIndex !== 7
 
       //
       // Background
@@ -282,8 +408,10 @@ Page {
             sourceComponent: JsonDatasetDelegate {
               dataset: index
               group: root.group
+              xyGroup: widget.currentIndex === 6
               multiplotGroup: widget.currentIndex === 4
-              showGroupWidget: widget.currentIndex > 0 && widget.currentIndex !== 4
+              showGroupWidget: (widget.currentIndex > 0 && widget.currentIndex < 4) ||
+                               widget.currentIndex === 6
             }
           }
         }
@@ -303,7 +431,8 @@ Page {
       palette.buttonText: Cpp_ThemeManager.menubarText
       palette.button: Cpp_ThemeManager.toolbarGradient1
       palette.window: Cpp_ThemeManager.toolbarGradient1
-      visible: widget.currentIndex === 0 || widget.currentIndex === 4
+      visible: widget.currentIndex === 0 || widget.currentIndex === 4 ||
+               widget.currentIndex === 5
       onClicked: {
         Cpp_Project_Model.addDataset(group)
         grid.positionViewAtIndex(grid.count - 1, GridView.Beginning)
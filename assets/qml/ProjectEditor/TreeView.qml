@@ -44,21 +44,27 @@ Widgets.Window {
     target: Cpp_Project_Model
 
     function onGroupCountChanged() {
-      view.model = 0
-      view.model = Cpp_Project_Model.groupCount
+      Qt.callLater(root.reload)
     }
 
     function onGroupOrderChanged() {
-      view.model = 0
-      view.model = Cpp_Project_Model.groupCount
+      Qt.callLater(root.reload)
     }
 
     function onDatasetChanged() {
-      view.model = 0
-      view.model = Cpp_Project_Model.groupCount
+      Qt.callLater(root.reload)
     }
   }
 
+  //
+  // Rebuilds the tree, calls are coalesced with Qt.callLater() so that the
+  // tree is only rebuilt once when many datasets change at the same time
+  //
+  function reload() {
+    view.model = 0
+    view.model = Cpp_Project_Model.groupCount
+  }
+
   //
   // List view
   //
@@ -27,12 +27,15 @@ import QtPositioning
 import QtQuick.Layouts
 import QtQuick.Controls
 
+import SerialStudio
+
 Item {
   id: root
 
   //
   // Custom properties to control the map from other QML files
   //
+  property int index: -1
   property real latitude: 0
   property real longitude: 0
   property real altitude: 0 // Not used yet :(
@@ -53,11 +56,23 @@ Item {
     map.center = QtPositioning.coordinate(root.latitude, root.longitude)
   }
 
+  //
+  // Calculates the size of the whole map in pixels at the current zoom level,
+  // used to project the track with the same scale as the map tiles
+  //
+  function updateTrackScale() {
+    var c = map.center
+    var p1 = map.fromCoordinate(c, false)
+    var p2 = map.fromCoordinate(QtPositioning.coordinate(c.latitude, c.longitude + 0.01), false)
+    if (!isNaN(p1.x) && !isNaN(p2.x) && p2.x > p1.x)
+      track.worldSize = (p2.x - p1.x) * 36000
+  }
+
   //
   // Save settings accross runs
   //
   Settings {
-    property alias mapTilt: tiltSlider.value
+    property alias mapTrack: showTrack.checked
     property alias mapZoom: zoomSlider.value
     property alias mapCenter: autoCenter.checked
     property alias mapVariant: mapType.currentIndex
@@ -93,6 +108,14 @@ Item {
     // Center map + zoom slider
     //
     RowLayout {
+      CheckBox {
+        id: showTrack
+        checked: true
+        checkable: true
+        text: qsTr("Track")
+        Layout.alignment: Qt.AlignHCenter
+      }
+
       CheckBox {
         id: autoCenter
         checked: true
@@ -125,27 +148,13 @@ Item {
     //
     RowLayout {
       //
-      // Tilt slider
-      //
-      Slider {
-        id: tiltSlider
-        orientation: Qt.Vertical
-        Layout.fillHeight: true
-        from: map.minimumTilt
-        to: map.maximumTilt
-        value: map.tilt
-        onValueChanged: {
-          if (map.tilt != value)
-            map.tilt = value
-        }
-      }
-
-      //
-      // Map
+      // Map, the view is not tilted so that the track can be projected with
+      // the same (orthographic) Web Mercator projection as the map tiles
       //
       Rectangle {
         id: mapRect
         clip: true
+        color: "#283e51"
         Layout.fillWidth: true
         Layout.fillHeight: true
 
@@ -154,20 +163,6 @@ Item {
           color: Cpp_ThemeManager.border
         }
 
-        gradient: Gradient {
-          GradientStop {
-            color: "#6ba9d1"
-            position: Math.max(0.4,
-                               (map.maximumTilt - map.tilt) /
-                               map.maximumTilt)
-          }
-
-          GradientStop {
-            position: 0
-            color: "#283e51"
-          }
-        }
-
         Map {
           id: map
           smooth: true
@@ -177,8 +172,26 @@ Item {
           copyrightsVisible: false
           anchors.margins: parent.border.width
 
-          tilt: 27
+          tilt: 0
           zoomLevel: 16
+          onCenterChanged: root.updateTrackScale()
+          onWidthChanged: root.updateTrackScale()
+          onZoomLevelChanged: root.updateTrackScale()
+          Component.onCompleted: root.updateTrackScale()
+
+          //
+          // Track history, drawn by the scene graph as a single line strip
+          //
+          GpsTrackItem {
+            id: track
+            clip: true
+            color: "#ff0000"
+            anchors.fill: parent
+            index: root.index
+            visible: showTrack.checked
+            centerLatitude: map.center.latitude
+            centerLongitude: map.center.longitude
+          }
 
           MapQuickItem {
             anchorPoint: Qt.point(sourceItem.width / 2,
@@ -205,43 +218,31 @@ Item {
               name: "osm.mapping.highdpi_tiles"
               value: true
             }
-          }
-        }
 
-        Rectangle {
-          id: smog
-          height: 32
-          opacity: 0.5
-
-          Connections {
-            target: map
-            function onTiltChanged() {
-              var x = map.tilt / map.maximumTilt
-              smog.y = (1.666 * x - 1.416) * mapRect.height
+            //
+            // Keep downloaded tiles between runs & prefetch the tiles that
+            // surround the visible area (and the neighbour zoom levels)
+            //
+            PluginParameter {
+              name: "osm.mapping.cache.directory"
+              value: track.tileCachePath
             }
-          }
 
-          gradient: Gradient {
-            GradientStop {
-              position: 0
-              color: "transparent"
+            PluginParameter {
+              name: "osm.mapping.cache.disk.cost_strategy"
+              value: "bytesize"
             }
 
-            GradientStop {
-              position: 0.5
-              color: "#dedede"
+            PluginParameter {
+              name: "osm.mapping.cache.disk.size"
+              value: 512 * 1024 * 1024
             }
 
-            GradientStop {
-              position: 1
-              color: "transparent"
+            PluginParameter {
+              name: "osm.mapping.prefetching_style"
+              value: "TwoNeighbourLayers"
             }
           }
-
-          anchors {
-            left: parent.left
-            right: parent.right
-          }
         }
       }
     }
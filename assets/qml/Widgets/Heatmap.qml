@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import SerialStudio
+
+Rectangle {
+  id: root
+  color: Cpp_ThemeManager.base
+
+  //
+  // Custom properties to select the displayed heatmap from other QML files
+  //
+  property int index: -1
+
+  //
+  // Matrix drawn by the scene graph, cells keep their aspect ratio
+  //
+  HeatmapItem {
+    id: heatmap
+    index: root.index
+    smooth: interpolate.checked
+    anchors.centerIn: area
+    width: heatmap.columns > 0 && heatmap.rows > 0 ?
+             Math.min(area.width, area.height * heatmap.columns / heatmap.rows) : 0
+    height: heatmap.columns > 0 ? width * heatmap.rows / heatmap.columns : 0
+  }
+
+  //
+  // Space available for the matrix
+  //
+  Item {
+    id: area
+    anchors {
+      fill: parent
+      margins: 24
+      topMargin: 24 + interpolate.implicitHeight
+      bottomMargin: 24 + rangeLabel.implicitHeight + app.spacing / 2
+    }
+  }
+
+  //
+  // Interpolation toggle & matrix size
+  //
+  CheckBox {
+    id: interpolate
+    checked: false
+    text: qsTr("Interpolate")
+    anchors.left: area.left
+    anchors.bottom: area.top
+    anchors.leftMargin: -8
+  }
+
+  Label {
+    font.family: app.monoFont
+    anchors.right: area.right
+    anchors.verticalCenter: interpolate.verticalCenter
+    color: Cpp_ThemeManager.widgetIndicator
+    text: qsTr("%1 × %2").arg(heatmap.rows).arg(heatmap.columns)
+  }
+
+  //
+  // Range of the colormap
+  //
+  Label {
+    id: rangeLabel
+    font.family: app.monoFont
+    anchors.top: heatmap.bottom
+    anchors.topMargin: app.spacing / 2
+    anchors.horizontalCenter: heatmap.horizontalCenter
+    color: Cpp_ThemeManager.widgetIndicator
+    text: qsTr("%1 to %2").arg(heatmap.minValue.toFixed(Cpp_UI_Dashboard.precision))
+                          .arg(heatmap.maxValue.toFixed(Cpp_UI_Dashboard.precision))
+  }
+
+  //
+  // Matrix frame
+  //
+  Rectangle {
+    border.width: 1
+    color: "transparent"
+    anchors.fill: heatmap
+    border.color: Cpp_ThemeManager.widgetIndicator
+  }
+}
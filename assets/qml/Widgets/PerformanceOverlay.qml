@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+//
+// Render statistics of the main window (see Misc::Renderer), shown on top of
+// the user interface while the performance overlay is enabled
+//
+Rectangle {
+  id: root
+
+  radius: 4
+  opacity: 0.85
+  color: "#d0000000"
+  width: layout.implicitWidth + 2 * app.spacing
+  height: layout.implicitHeight + 2 * app.spacing
+
+  readonly property var labels: Cpp_Misc_Renderer.histogramLabels()
+  readonly property var histogram: Cpp_Misc_Renderer.histogram
+  readonly property real maximum: Math.max(1, Math.max.apply(null, histogram))
+
+  ColumnLayout {
+    id: layout
+    spacing: 2
+    anchors.centerIn: parent
+
+    Label {
+      color: "#ffffff"
+      font.bold: true
+      font.family: app.monoFont
+      text: qsTr("%1 FPS").arg(Cpp_Misc_Renderer.fps.toFixed(1)) + " · " +
+            Cpp_Misc_Renderer.activeBackend
+    }
+
+    Label {
+      color: "#ffffff"
+      font.pixelSize: 10
+      font.family: app.monoFont
+      text: qsTr("Frame: %1 ms").arg(Cpp_Misc_Renderer.frameTime.toFixed(2))
+    }
+
+    Label {
+      color: "#ffffff"
+      font.pixelSize: 10
+      font.family: app.monoFont
+      text: qsTr("Sync/upload: %1 ms").arg(
+              Cpp_Misc_Renderer.syncTime.toFixed(2))
+    }
+
+    Label {
+      color: "#ffffff"
+      font.pixelSize: 10
+      font.family: app.monoFont
+      text: qsTr("Render: %1 ms").arg(Cpp_Misc_Renderer.renderTime.toFixed(2))
+    }
+
+    //
+    // Frame time histogram of the last second
+    //
+    Repeater {
+      model: root.histogram.length
+      delegate: RowLayout {
+        spacing: 4
+
+        Label {
+          color: "#ffffff"
+          font.pixelSize: 10
+          font.family: app.monoFont
+          Layout.minimumWidth: 72
+          text: root.labels[index]
+        }
+
+        Rectangle {
+          height: 8
+          color: index < 2 ? "#2ecc71" : (index < 4 ? "#f1c40f" : "#e74c3c")
+          Layout.preferredWidth: 2 + 96 * root.histogram[index] / root.maximum
+        }
+
+        Label {
+          color: "#ffffff"
+          font.pixelSize: 10
+          font.family: app.monoFont
+          text: root.histogram[index]
+        }
+      }
+    }
+  }
+}
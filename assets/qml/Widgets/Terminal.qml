@@ -75,6 +75,32 @@ Item {
     textEdit.selectAll()
   }
 
+  //
+  // Shows the search bar & focuses the search field
+  //
+  function showSearch() {
+    searchBar.visible = true
+    searchField.forceActiveFocus()
+    searchField.selectAll()
+  }
+
+  //
+  // Hides the search bar & returns the focus to the console
+  //
+  function hideSearch() {
+    searchBar.visible = false
+    textEdit.forceActiveFocus()
+  }
+
+  //
+  // Search shortcut
+  //
+  Shortcut {
+    sequences: [StandardKey.Find]
+    enabled: root.visible && root.widgetEnabled
+    onActivated: root.showSearch()
+  }
+
   //
   // Right-click context menu
   //
@@ -96,6 +122,13 @@ Item {
       onTriggered: textEdit.selectAll()
     }
 
+    MenuItem {
+      text: qsTr("Find") + "..."
+      enabled: !textEdit.empty
+      opacity: enabled ? 1 : 0.5
+      onTriggered: root.showSearch()
+    }
+
     MenuItem {
       text: qsTr("Clear")
       opacity: enabled ? 1 : 0.5
@@ -118,6 +151,16 @@ Item {
       onTriggered: Cpp_IO_Console.save()
       enabled: Cpp_IO_Console.saveAvailable
     }
+
+    MenuItem {
+      text: qsTr("Open log folder")
+      onTriggered: Cpp_IO_ConsoleLog.openDirectory()
+    }
+
+    MenuItem {
+      text: qsTr("Open raw capture folder")
+      onTriggered: Cpp_IO_RawCapture.openDirectory()
+    }
   }
 
   //
@@ -128,24 +171,82 @@ Item {
     spacing: app.spacing
     anchors.margins: app.spacing * 1.5
 
+    //
+    // Search bar, matches are found with the index of the console history
+    //
+    RowLayout {
+      id: searchBar
+      visible: false
+      Layout.fillWidth: true
+
+      TextField {
+        id: searchField
+        height: 24
+        font: textEdit.font
+        Layout.fillWidth: true
+        palette.base: Cpp_ThemeManager.consoleBase
+        placeholderText: qsTr("Search console history") + "..."
+        palette.text: text.length > 0 && !textEdit.searchFound ?
+                        "#e74c3c" : Cpp_ThemeManager.consoleText
+        onTextChanged: textEdit.searchText = text
+        Keys.onEscapePressed: root.hideSearch()
+        Keys.onReturnPressed: (event) => {
+                                if (event.modifiers & Qt.ShiftModifier)
+                                  textEdit.findPrevious()
+                                else
+                                  textEdit.findNext()
+                              }
+        Component.onCompleted: {
+          if (Cpp_Qt6)
+            placeholderTextColor = Cpp_ThemeManager.consolePlaceholderText
+        }
+      }
+
+      Button {
+        height: 24
+        Layout.maximumWidth: 32
+        icon.color: palette.text
+        opacity: enabled ? 1 : 0.5
+        icon.source: "qrc:/icons/up.svg"
+        onClicked: textEdit.findPrevious()
+        enabled: searchField.text.length > 0
+      }
+
+      Button {
+        height: 24
+        Layout.maximumWidth: 32
+        icon.color: palette.text
+        opacity: enabled ? 1 : 0.5
+        icon.source: "qrc:/icons/down.svg"
+        onClicked: textEdit.findNext()
+        enabled: searchField.text.length > 0
+      }
+
+      Button {
+        height: 24
+        Layout.maximumWidth: 32
+        icon.color: palette.text
+        icon.source: "qrc:/icons/close.svg"
+        onClicked: {
+          searchField.clear()
+          root.hideSearch()
+        }
+      }
+    }
+
     //
     // Console display
     //
-    SerialStudio.Terminal {
+    SerialStudio.TerminalView {
       id: textEdit
       focus: true
-      readOnly: true
-      font.pixelSize: 12
+      clip: true
       vt100emulation: true
-      centerOnScroll: false
-      undoRedoEnabled: false
       Layout.fillWidth: true
       Layout.fillHeight: true
-      maximumBlockCount: 12000
+      font.pixelSize: 12
       font.family: app.monoFont
       autoscroll: Cpp_IO_Console.autoscroll
-      renderTarget: PaintedItem.FramebufferObject
-      wordWrapMode: Text.WrapAtWordBoundaryOrAnywhere
       placeholderText: qsTr("No data received so far") + "..."
 
       MouseArea {
@@ -154,7 +255,7 @@ Item {
         cursorShape: Qt.IBeamCursor
         propagateComposedEvents: true
         acceptedButtons: Qt.RightButton
-        anchors.rightMargin: textEdit.scrollbarWidth
+        anchors.rightMargin: scrollBar.visible ? scrollBar.width : 0
 
         onClicked: (mouse) => {
                      if (mouse.button === Qt.RightButton) {
@@ -163,6 +264,26 @@ Item {
                      }
                    }
       }
+
+      //
+      // Vertical scrollbar, only the first visible line is changed
+      //
+      ScrollBar {
+        id: scrollBar
+        orientation: Qt.Vertical
+        anchors.top: parent.top
+        anchors.right: parent.right
+        anchors.bottom: parent.bottom
+        visible: size < 1
+        size: textEdit.lineCount > 0 ?
+                Math.min(1, textEdit.visibleLines / textEdit.lineCount) : 1
+        position: textEdit.lineCount > 0 ?
+                    textEdit.firstLine / textEdit.lineCount : 0
+        onPositionChanged: {
+          if (pressed)
+            textEdit.firstLine = Math.round(position * textEdit.lineCount)
+        }
+      }
     }
 
     //
@@ -273,6 +394,36 @@ Item {
         }
       }
 
+      CheckBox {
+        id: logCheck
+        text: qsTr("Log to file")
+        Layout.alignment: Qt.AlignVCenter
+        checked: Cpp_IO_ConsoleLog.enabled
+        onCheckedChanged: {
+          if (Cpp_IO_ConsoleLog.enabled !== checked)
+            Cpp_IO_ConsoleLog.enabled = checked
+        }
+
+        ToolTip.delay: 500
+        ToolTip.visible: hovered && Cpp_IO_ConsoleLog.currentFile !== ""
+        ToolTip.text: Cpp_IO_ConsoleLog.currentFile
+      }
+
+      CheckBox {
+        id: rawCaptureCheck
+        text: qsTr("Raw capture")
+        Layout.alignment: Qt.AlignVCenter
+        checked: Cpp_IO_RawCapture.enabled
+        onCheckedChanged: {
+          if (Cpp_IO_RawCapture.enabled !== checked)
+            Cpp_IO_RawCapture.enabled = checked
+        }
+
+        ToolTip.delay: 500
+        ToolTip.visible: hovered && Cpp_IO_RawCapture.currentFile !== ""
+        ToolTip.text: Cpp_IO_RawCapture.currentFile
+      }
+
       Item {
         Layout.fillWidth: true
       }
@@ -309,6 +460,16 @@ Item {
         enabled: Cpp_IO_Console.saveAvailable
       }
 
+      Button {
+        height: 24
+        Layout.maximumWidth: 32
+        icon.color: palette.text
+        opacity: enabled ? 1 : 0.5
+        enabled: !textEdit.empty
+        onClicked: root.showSearch()
+        icon.source: "qrc:/icons/search.svg"
+      }
+
       Button {
         height: 24
         Layout.maximumWidth: 32
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import SerialStudio
+
+Rectangle {
+  id: root
+  color: Cpp_ThemeManager.base
+
+  //
+  // Custom properties to select the displayed waterfall from other QML files
+  //
+  property int index: -1
+
+  //
+  // Spectrogram drawn by the scene graph
+  //
+  WaterfallItem {
+    id: waterfall
+    index: root.index
+    anchors {
+      fill: parent
+      topMargin: 24
+      leftMargin: 24
+      rightMargin: 24
+      bottomMargin: 24 + minLabel.implicitHeight + app.spacing / 2
+    }
+  }
+
+  //
+  // Frequency axis labels
+  //
+  Label {
+    id: minLabel
+    text: "0"
+    font.family: app.monoFont
+    anchors.left: waterfall.left
+    anchors.top: waterfall.bottom
+    anchors.topMargin: app.spacing / 2
+    color: Cpp_ThemeManager.widgetIndicator
+  }
+
+  Label {
+    font.family: app.monoFont
+    anchors.top: waterfall.bottom
+    anchors.right: waterfall.right
+    anchors.topMargin: app.spacing / 2
+    color: Cpp_ThemeManager.widgetIndicator
+    text: qsTr("Bin %1").arg(waterfall.bins)
+  }
+
+  Label {
+    font.family: app.monoFont
+    anchors.top: waterfall.bottom
+    anchors.topMargin: app.spacing / 2
+    anchors.horizontalCenter: waterfall.horizontalCenter
+    color: Cpp_ThemeManager.widgetIndicator
+    text: qsTr("Frequency bin")
+  }
+
+  //
+  // Waterfall frame
+  //
+  Rectangle {
+    border.width: 1
+    color: "transparent"
+    anchors.fill: waterfall
+    border.color: Cpp_ThemeManager.widgetIndicator
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+
+//
+// Loader for windows & dialogs that are only created the first time that they
+// are shown, so that they do not slow down the startup of the application
+//
+Loader {
+  id: root
+  active: false
+  asynchronous: true
+
+  //
+  // Set to true when the window shall be shown as soon as it is loaded
+  //
+  property bool showOnLoad: false
+
+  //
+  // Creates the window (if required) & shows it
+  //
+  function show() {
+    if (root.status === Loader.Ready) {
+      root.item.show()
+      root.item.raise()
+      root.item.requestActivate()
+    }
+
+    else {
+      root.showOnLoad = true
+      root.active = true
+    }
+  }
+
+  //
+  // Show the window once it has been created
+  //
+  onLoaded: {
+    if (root.showOnLoad) {
+      root.showOnLoad = false
+      root.show()
+    }
+  }
+}
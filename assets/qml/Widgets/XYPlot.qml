@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import SerialStudio
+
+Rectangle {
+  id: root
+  color: Cpp_ThemeManager.base
+
+  //
+  // Custom properties to select the displayed XY plot from other QML files
+  //
+  property int index: -1
+
+  //
+  // Point cloud drawn by the scene graph
+  //
+  XYPlotItem {
+    id: plot
+    clip: true
+    index: root.index
+    persistence: persistence.checked
+    anchors {
+      fill: parent
+      topMargin: 24 + persistence.implicitHeight
+      rightMargin: 24
+      bottomMargin: 24 + minXLabel.implicitHeight + app.spacing / 2
+      leftMargin: 24 + Math.max(maxYLabel.implicitWidth, minYLabel.implicitWidth)
+    }
+  }
+
+  //
+  // Persistence toggle & number of points
+  //
+  CheckBox {
+    id: persistence
+    checked: true
+    text: qsTr("Persistence")
+    anchors.left: plot.left
+    anchors.bottom: plot.top
+    anchors.leftMargin: -8
+  }
+
+  Label {
+    font.family: app.monoFont
+    anchors.right: plot.right
+    anchors.verticalCenter: persistence.verticalCenter
+    color: Cpp_ThemeManager.widgetIndicator
+    text: qsTr("%1 points").arg(plot.count)
+  }
+
+  //
+  // Vertical axis labels
+  //
+  Label {
+    id: maxYLabel
+    font.family: app.monoFont
+    anchors.top: plot.top
+    anchors.right: plot.left
+    anchors.rightMargin: app.spacing / 2
+    color: Cpp_ThemeManager.widgetIndicator
+    text: plot.maxY.toFixed(Cpp_UI_Dashboard.precision)
+  }
+
+  Label {
+    id: minYLabel
+    font.family: app.monoFont
+    anchors.bottom: plot.bottom
+    anchors.right: plot.left
+    anchors.rightMargin: app.spacing / 2
+    color: Cpp_ThemeManager.widgetIndicator
+    text: plot.minY.toFixed(Cpp_UI_Dashboard.precision)
+  }
+
+  //
+  // Horizontal axis labels
+  //
+  Label {
+    id: minXLabel
+    font.family: app.monoFont
+    anchors.left: plot.left
+    anchors.top: plot.bottom
+    anchors.topMargin: app.spacing / 2
+    color: Cpp_ThemeManager.widgetIndicator
+    text: plot.minX.toFixed(Cpp_UI_Dashboard.precision)
+  }
+
+  Label {
+    font.family: app.monoFont
+    anchors.top: plot.bottom
+    anchors.right: plot.right
+    anchors.topMargin: app.spacing / 2
+    color: Cpp_ThemeManager.widgetIndicator
+    text: plot.maxX.toFixed(Cpp_UI_Dashboard.precision)
+  }
+
+  //
+  // Plot frame
+  //
+  Rectangle {
+    border.width: 1
+    color: "transparent"
+    anchors.fill: plot
+    border.color: Cpp_ThemeManager.widgetIndicator
+  }
+}
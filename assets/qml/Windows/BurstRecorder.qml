@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Window
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import "../FramelessWindow" as FramelessWindow
+
+FramelessWindow.CustomWindow {
+  id: root
+
+  //
+  // Window options
+  //
+  width: minimumWidth
+  height: minimumHeight
+  minimizeEnabled: false
+  maximizeEnabled: false
+  title: qsTr("Burst Recording")
+  titlebarText: Cpp_ThemeManager.text
+  x: (Screen.desktopAvailableWidth - width) / 2
+  y: (Screen.desktopAvailableHeight - height) / 2
+  titlebarColor: Cpp_ThemeManager.dialogBackground
+  backgroundColor: Cpp_ThemeManager.dialogBackground
+  minimumWidth: column.implicitWidth + 4 * app.spacing + 2 * root.shadowMargin
+  maximumWidth: column.implicitWidth + 4 * app.spacing + 2 * root.shadowMargin
+  extraFlags: Qt.Dialog | Qt.WindowCloseButtonHint | Qt.WindowTitleHint
+  minimumHeight: column.implicitHeight + 4 * app.spacing + titlebar.height + 2 * root.shadowMargin
+  maximumHeight: column.implicitHeight + 4 * app.spacing + titlebar.height + 2 * root.shadowMargin
+
+  //
+  // Returns the name of the current recorder state
+  //
+  function stateName() {
+    switch (Cpp_IO_BurstRecorder.state) {
+    case 1:
+      return qsTr("Recording")
+    case 2:
+      return qsTr("Processing burst")
+    case 3:
+      return qsTr("Reviewing burst, live data paused")
+    }
+
+    return qsTr("Idle")
+  }
+
+  //
+  // Use page item to set application palette
+  //
+  Page {
+    anchors {
+      fill: parent
+      margins: root.shadowMargin
+      topMargin: titlebar.height + root.shadowMargin
+    }
+
+    palette.alternateBase: Cpp_ThemeManager.base
+    palette.base: Cpp_ThemeManager.base
+    palette.brightText: Cpp_ThemeManager.brightText
+    palette.button: Cpp_ThemeManager.button
+    palette.buttonText: Cpp_ThemeManager.buttonText
+    palette.highlight: Cpp_ThemeManager.highlight
+    palette.highlightedText: Cpp_ThemeManager.highlightedText
+    palette.link: Cpp_ThemeManager.link
+    palette.placeholderText: Cpp_ThemeManager.placeholderText
+    palette.text: Cpp_ThemeManager.text
+    palette.toolTipBase: Cpp_ThemeManager.tooltipBase
+    palette.toolTipText: Cpp_ThemeManager.tooltipText
+    palette.window: Cpp_ThemeManager.window
+    palette.windowText: Cpp_ThemeManager.windowText
+
+    background: Rectangle {
+      radius: root.radius
+      color: root.backgroundColor
+
+      Rectangle {
+        height: root.radius
+        color: root.backgroundColor
+
+        anchors {
+          top: parent.top
+          left: parent.left
+          right: parent.right
+        }
+      }
+    }
+
+    //
+    // Window controls
+    //
+    ColumnLayout {
+      id: column
+      anchors.centerIn: parent
+      spacing: app.spacing * 2
+
+      //
+      // Recording limits
+      //
+      GridLayout {
+        columns: 2
+        rowSpacing: app.spacing
+        columnSpacing: app.spacing
+        enabled: Cpp_IO_BurstRecorder.state === 0 ||
+                 Cpp_IO_BurstRecorder.state === 3
+
+        Label {
+          text: qsTr("Maximum frames") + ":"
+        } SpinBox {
+          from: 1
+          to: 10000000
+          editable: true
+          stepSize: 10000
+          Layout.minimumWidth: 192
+          value: Cpp_IO_BurstRecorder.frameLimit
+          onValueChanged: {
+            if (Cpp_IO_BurstRecorder.frameLimit !== value)
+              Cpp_IO_BurstRecorder.frameLimit = value
+          }
+        }
+
+        Label {
+          text: qsTr("Maximum duration (ms)") + ":"
+        } SpinBox {
+          from: 0
+          to: 3600000
+          editable: true
+          stepSize: 1000
+          Layout.fillWidth: true
+          value: Cpp_IO_BurstRecorder.duration
+          onValueChanged: {
+            if (Cpp_IO_BurstRecorder.duration !== value)
+              Cpp_IO_BurstRecorder.duration = value
+          }
+        }
+
+        Label {
+          text: qsTr("Memory arena (MB)") + ":"
+        } SpinBox {
+          from: 1
+          to: 1024
+          editable: true
+          stepSize: 16
+          Layout.fillWidth: true
+          value: Cpp_IO_BurstRecorder.arenaSize
+          onValueChanged: {
+            if (Cpp_IO_BurstRecorder.arenaSize !== value)
+              Cpp_IO_BurstRecorder.arenaSize = value
+          }
+        }
+      }
+
+      //
+      // Recording status
+      //
+      GridLayout {
+        columns: 2
+        rowSpacing: app.spacing / 2
+        columnSpacing: app.spacing * 2
+
+        Label {
+          text: qsTr("State") + ":"
+        } Label {
+          font.bold: true
+          text: root.stateName()
+        }
+
+        Label {
+          text: qsTr("Recorded frames") + ":"
+        } Label {
+          font.family: app.monoFont
+          text: Cpp_IO_BurstRecorder.recordedFrames + " (" +
+                (Cpp_IO_BurstRecorder.recordedBytes / 1048576).toFixed(2) +
+                " MB)"
+        }
+
+        Label {
+          text: qsTr("Dropped frames") + ":"
+        } Label {
+          font.family: app.monoFont
+          text: Cpp_IO_BurstRecorder.droppedFrames
+        }
+      }
+
+      ProgressBar {
+        from: 0
+        to: 1
+        Layout.fillWidth: true
+        value: Cpp_IO_BurstRecorder.progress
+      }
+
+      //
+      // Buttons
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Button {
+          Layout.fillWidth: true
+          enabled: Cpp_IO_BurstRecorder.state !== 2
+          text: Cpp_IO_BurstRecorder.state === 1 ? qsTr("Stop") :
+                                                   qsTr("Record burst")
+          onClicked: {
+            if (Cpp_IO_BurstRecorder.state === 1)
+              Cpp_IO_BurstRecorder.stop()
+            else
+              Cpp_IO_BurstRecorder.start()
+          }
+        }
+
+        Button {
+          Layout.fillWidth: true
+          text: qsTr("Resume live data")
+          enabled: Cpp_IO_BurstRecorder.state === 3
+          onClicked: Cpp_IO_BurstRecorder.resume()
+        }
+      }
+    }
+  }
+}
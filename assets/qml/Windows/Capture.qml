@@ -0,0 +1,395 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Window
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import "../FramelessWindow" as FramelessWindow
+
+FramelessWindow.CustomWindow {
+  id: root
+
+  //
+  // Window options
+  //
+  width: 860
+  height: 480
+  minimumWidth: 720
+  minimumHeight: 420
+  minimizeEnabled: false
+  maximizeEnabled: false
+  title: qsTr("Triggered Capture")
+  titlebarText: Cpp_ThemeManager.text
+  x: (Screen.desktopAvailableWidth - width) / 2
+  y: (Screen.desktopAvailableHeight - height) / 2
+  titlebarColor: Cpp_ThemeManager.dialogBackground
+  backgroundColor: Cpp_ThemeManager.dialogBackground
+  extraFlags: Qt.Dialog | Qt.WindowCloseButtonHint | Qt.WindowTitleHint
+
+  //
+  // Captured data displayed by the plot
+  //
+  property var times: []
+  property var values: []
+
+  //
+  // Reads the captured window of the selected dataset
+  //
+  function updateData() {
+    root.times = Cpp_UI_Capture.capturedTimes()
+    root.values = Cpp_UI_Capture.capturedValues(_display.currentIndex)
+    _canvas.requestPaint()
+  }
+
+  //
+  // Returns the name of the current trigger state
+  //
+  function stateName() {
+    if (Cpp_UI_Capture.frozen)
+      return qsTr("Frozen")
+
+    switch (Cpp_UI_Capture.state) {
+    case 1:
+      return qsTr("Filling pre-trigger buffer")
+    case 2:
+      return qsTr("Armed")
+    case 3:
+      return qsTr("Triggered")
+    }
+
+    return qsTr("Stopped")
+  }
+
+  //
+  // Redraw the plot when a new window is captured
+  //
+  Connections {
+    target: Cpp_UI_Capture
+
+    function onCaptured() {
+      if (root.visible)
+        root.updateData()
+    }
+  }
+
+  //
+  // Use page item to set application palette
+  //
+  Page {
+    anchors {
+      fill: parent
+      margins: root.shadowMargin
+      topMargin: titlebar.height + root.shadowMargin
+    }
+
+    palette.alternateBase: Cpp_ThemeManager.base
+    palette.base: Cpp_ThemeManager.base
+    palette.brightText: Cpp_ThemeManager.brightText
+    palette.button: Cpp_ThemeManager.button
+    palette.buttonText: Cpp_ThemeManager.buttonText
+    palette.highlight: Cpp_ThemeManager.highlight
+    palette.highlightedText: Cpp_ThemeManager.highlightedText
+    palette.link: Cpp_ThemeManager.link
+    palette.placeholderText: Cpp_ThemeManager.placeholderText
+    palette.text: Cpp_ThemeManager.text
+    palette.toolTipBase: Cpp_ThemeManager.tooltipBase
+    palette.toolTipText: Cpp_ThemeManager.tooltipText
+    palette.window: Cpp_ThemeManager.window
+    palette.windowText: Cpp_ThemeManager.windowText
+
+    background: Rectangle {
+      radius: root.radius
+      color: root.backgroundColor
+
+      Rectangle {
+        height: root.radius
+        color: root.backgroundColor
+
+        anchors {
+          top: parent.top
+          left: parent.left
+          right: parent.right
+        }
+      }
+    }
+
+    //
+    // Window controls
+    //
+    RowLayout {
+      spacing: app.spacing * 2
+      anchors.fill: parent
+      anchors.margins: app.spacing * 2
+
+      //
+      // Trigger configuration
+      //
+      GridLayout {
+        columns: 2
+        rowSpacing: app.spacing
+        columnSpacing: app.spacing
+        Layout.alignment: Qt.AlignTop
+
+        Label {
+          text: qsTr("Source") + ":"
+        } ComboBox {
+          Layout.fillWidth: true
+          Layout.minimumWidth: 192
+          model: Cpp_UI_Capture.availableSources
+          currentIndex: Cpp_UI_Capture.source
+          onCurrentIndexChanged: {
+            if (Cpp_UI_Capture.source !== currentIndex)
+              Cpp_UI_Capture.source = currentIndex
+          }
+        }
+
+        Label {
+          text: qsTr("Condition") + ":"
+        } ComboBox {
+          id: _condition
+          Layout.fillWidth: true
+          model: Cpp_UI_Capture.availableConditions
+          currentIndex: Cpp_UI_Capture.condition
+          onCurrentIndexChanged: {
+            if (Cpp_UI_Capture.condition !== currentIndex)
+              Cpp_UI_Capture.condition = currentIndex
+          }
+        }
+
+        Label {
+          text: _condition.currentIndex >= 5 ? qsTr("Lower level") + ":" :
+                                               qsTr("Level") + ":"
+        } TextField {
+          Layout.fillWidth: true
+          Component.onCompleted: text = Cpp_UI_Capture.level
+          onTextChanged: {
+            const value = text.length > 0 ? parseFloat(text) : 0
+            if (!isNaN(value) && Cpp_UI_Capture.level !== value)
+              Cpp_UI_Capture.level = value
+          }
+
+          validator: DoubleValidator {}
+        }
+
+        Label {
+          text: qsTr("Upper level") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _condition.currentIndex >= 5
+        } TextField {
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: _condition.currentIndex >= 5
+          Component.onCompleted: text = Cpp_UI_Capture.upperLevel
+          onTextChanged: {
+            const value = text.length > 0 ? parseFloat(text) : 0
+            if (!isNaN(value) && Cpp_UI_Capture.upperLevel !== value)
+              Cpp_UI_Capture.upperLevel = value
+          }
+
+          validator: DoubleValidator {}
+        }
+
+        Label {
+          text: qsTr("Mode") + ":"
+        } ComboBox {
+          Layout.fillWidth: true
+          model: Cpp_UI_Capture.availableModes
+          currentIndex: Cpp_UI_Capture.mode
+          onCurrentIndexChanged: {
+            if (Cpp_UI_Capture.mode !== currentIndex)
+              Cpp_UI_Capture.mode = currentIndex
+          }
+        }
+
+        Label {
+          text: qsTr("Window (frames)") + ":"
+        } SpinBox {
+          from: 2
+          to: 1000000
+          editable: true
+          stepSize: 100
+          Layout.fillWidth: true
+          value: Cpp_UI_Capture.length
+          onValueChanged: {
+            if (Cpp_UI_Capture.length !== value)
+              Cpp_UI_Capture.length = value
+          }
+        }
+
+        Label {
+          text: qsTr("Pre-trigger (%)") + ":"
+        } SpinBox {
+          from: 0
+          to: 100
+          stepSize: 5
+          editable: true
+          Layout.fillWidth: true
+          value: Cpp_UI_Capture.preTrigger
+          onValueChanged: {
+            if (Cpp_UI_Capture.preTrigger !== value)
+              Cpp_UI_Capture.preTrigger = value
+          }
+        }
+
+        Label {
+          text: qsTr("State") + ":"
+        } Label {
+          font.bold: true
+          text: root.stateName()
+        }
+
+        Label {
+          text: qsTr("Captures") + ":"
+        } Label {
+          font.family: app.monoFont
+          text: Cpp_UI_Capture.captureCount +
+                (Cpp_UI_Capture.autoTriggered ? " " + qsTr("(auto)") : "")
+        }
+
+        RowLayout {
+          spacing: app.spacing
+          Layout.columnSpan: 2
+          Layout.fillWidth: true
+
+          Button {
+            Layout.fillWidth: true
+            text: Cpp_UI_Capture.state === 0 ? qsTr("Arm") : qsTr("Stop")
+            onClicked: {
+              if (Cpp_UI_Capture.state === 0)
+                Cpp_UI_Capture.arm()
+              else
+                Cpp_UI_Capture.stop()
+            }
+          }
+
+          Button {
+            checkable: true
+            Layout.fillWidth: true
+            text: qsTr("Freeze")
+            checked: Cpp_UI_Capture.frozen
+            onClicked: Cpp_UI_Capture.frozen = checked
+          }
+        }
+      }
+
+      //
+      // Captured window
+      //
+      ColumnLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+
+        ComboBox {
+          id: _display
+          Layout.fillWidth: true
+          model: Cpp_UI_Capture.availableSources
+          onCurrentIndexChanged: root.updateData()
+        }
+
+        Rectangle {
+          Layout.fillWidth: true
+          Layout.fillHeight: true
+          color: Cpp_ThemeManager.widgetWindowBackground
+          border.width: 1
+          border.color: Cpp_ThemeManager.widgetWindowBorder
+
+          Canvas {
+            id: _canvas
+            anchors.fill: parent
+            anchors.margins: app.spacing
+
+            onPaint: {
+              var ctx = getContext("2d")
+              ctx.reset()
+
+              const count = root.values.length
+              if (count < 2)
+                return
+
+              // Obtain the vertical range of the window
+              var min = Number.POSITIVE_INFINITY
+              var max = Number.NEGATIVE_INFINITY
+              for (var i = 0; i < count; ++i) {
+                if (isFinite(root.values[i])) {
+                  min = Math.min(min, root.values[i])
+                  max = Math.max(max, root.values[i])
+                }
+              }
+
+              if (!isFinite(min))
+                return
+
+              if (min === max) {
+                min -= 1
+                max += 1
+              }
+
+              // Draw the trigger position
+              const trigger = width * Cpp_UI_Capture.triggerIndex / (count - 1)
+              ctx.strokeStyle = Cpp_ThemeManager.highlight
+              ctx.lineWidth = 1
+              ctx.beginPath()
+              ctx.moveTo(trigger, 0)
+              ctx.lineTo(trigger, height)
+              ctx.stroke()
+
+              // Draw the captured values
+              ctx.strokeStyle = Cpp_ThemeManager.text
+              ctx.beginPath()
+              for (var j = 0; j < count; ++j) {
+                const x = width * j / (count - 1)
+                const y = height * (max - root.values[j]) / (max - min)
+                if (j === 0)
+                  ctx.moveTo(x, y)
+                else
+                  ctx.lineTo(x, y)
+              }
+
+              ctx.stroke()
+            }
+          }
+        }
+
+        Label {
+          font.family: app.monoFont
+          Layout.alignment: Qt.AlignRight
+          visible: root.times.length > 1
+          text: root.times.length > 1 ?
+                  qsTr("%1 ms … %2 ms").arg(root.times[0].toFixed(1))
+                                     .arg(root.times[root.times.length - 1]
+                                     .toFixed(1)) : ""
+        }
+      }
+    }
+  }
+
+  //
+  // Read the captured window when the window is shown
+  //
+  onVisibleChanged: {
+    if (visible)
+      root.updateData()
+  }
+}
@@ -53,21 +53,34 @@ FramelessWindow.CustomWindow {
   // Close CSV file when window is closed
   //
   onVisibleChanged: {
-    if (!visible && Cpp_CSV_Player.isOpen)
+    if (!visible && (Cpp_CSV_Player.isOpen || Cpp_CSV_Player.isLoading))
       Cpp_CSV_Player.closeFile()
   }
 
+  //
+  // Display the window if the CSV file was opened before it was created
+  //
+  Component.onCompleted: {
+    if (Cpp_CSV_Player.isOpen || Cpp_CSV_Player.isLoading)
+      root.visible = true
+  }
+
   //
   // Automatically display the window when the CSV file is opened
   //
   Connections {
     target: Cpp_CSV_Player
     function onOpenChanged() {
-      if (Cpp_CSV_Player.isOpen)
+      if (Cpp_CSV_Player.isOpen || Cpp_CSV_Player.isLoading)
         root.visible = true
       else
         root.visible = false
     }
+
+    function onLoadingChanged() {
+      if (Cpp_CSV_Player.isLoading)
+        root.visible = true
+    }
   }
 
   //
@@ -128,11 +141,22 @@ FramelessWindow.CustomWindow {
         Layout.alignment: Qt.AlignLeft
       }
 
+      //
+      // Indexing progress display
+      //
+      ProgressBar {
+        Layout.fillWidth: true
+        visible: Cpp_CSV_Player.isLoading
+        value: Cpp_CSV_Player.loadingProgress
+      }
+
       //
       // Progress display
       //
       Slider {
+        id: _slider
         Layout.fillWidth: true
+        enabled: Cpp_CSV_Player.isOpen
         value: Cpp_CSV_Player.progress
         onValueChanged: {
           if (value !== Cpp_CSV_Player.progress)
@@ -140,6 +164,104 @@ FramelessWindow.CustomWindow {
         }
       }
 
+      //
+      // Timeline overview, each dataset is drawn as a min/max band normalized
+      // to its own range, clicking on the strip jumps to that position
+      //
+      Canvas {
+        id: _overview
+        implicitHeight: 48
+        Layout.fillWidth: true
+        Layout.leftMargin: _slider.leftPadding
+        Layout.rightMargin: _slider.rightPadding
+        visible: Cpp_CSV_Player.overviewAvailable
+
+        onPaint: {
+          var ctx = getContext("2d")
+          ctx.reset()
+          ctx.fillStyle = Cpp_ThemeManager.base
+          ctx.fillRect(0, 0, width, height)
+
+          // Draw the band of each dataset
+          var colors = Cpp_ThemeManager.widgetColors
+          var count = Cpp_CSV_Player.overviewTitles.length
+          for (var c = 0; c < count; ++c) {
+            var samples = Cpp_CSV_Player.overview(c)
+            var bins = samples.length / 2
+            if (bins <= 0)
+              continue
+
+            ctx.globalAlpha = 0.6
+            ctx.lineCap = "square"
+            ctx.strokeStyle = colors[c % colors.length]
+            ctx.lineWidth = Math.max(1, width / bins)
+            ctx.beginPath()
+            for (var i = 0; i < bins; ++i) {
+              var min = samples[i * 2]
+              var max = samples[i * 2 + 1]
+              if (isNaN(min) || isNaN(max))
+                continue
+
+              var x = (i + 0.5) * width / bins
+              ctx.moveTo(x, (1 - min) * (height - 2) + 1)
+              ctx.lineTo(x, (1 - max) * (height - 2) + 1)
+            }
+            ctx.stroke()
+          }
+        }
+
+        onWidthChanged: requestPaint()
+
+        Connections {
+          target: Cpp_CSV_Player
+          function onOverviewChanged() {
+            _overview.requestPaint()
+          }
+        }
+
+        //
+        // Event markers, clicking on a marker jumps to it
+        //
+        Repeater {
+          model: Cpp_CSV_Player.markerCount > 0 ? Cpp_CSV_Player.markers() : []
+          delegate: Rectangle {
+            z: 1
+            width: 3
+            height: parent.height
+            color: Cpp_ThemeManager.alternativeHighlight
+            x: modelData["position"] * (parent.width - width)
+
+            ToolTip.delay: 500
+            ToolTip.text: modelData["label"]
+            ToolTip.visible: _markerArea.containsMouse
+
+            MouseArea {
+              id: _markerArea
+              hoverEnabled: true
+              anchors.fill: parent
+              anchors.margins: -2
+              cursorShape: Qt.PointingHandCursor
+              onClicked: Cpp_CSV_Player.jumpToMarker(index)
+            }
+          }
+        }
+
+        Rectangle {
+          width: 2
+          height: parent.height
+          color: Cpp_ThemeManager.highlight
+          x: Cpp_CSV_Player.progress * (parent.width - width)
+        }
+
+        MouseArea {
+          anchors.fill: parent
+          cursorShape: Qt.PointingHandCursor
+          onClicked: (mouse) => {
+            Cpp_CSV_Player.setProgress(mouse.x / width)
+          }
+        }
+      }
+
       //
       // Play/pause buttons
       //
@@ -161,6 +283,7 @@ FramelessWindow.CustomWindow {
         Button {
           icon.width: 32
           icon.height: 32
+          enabled: Cpp_CSV_Player.isOpen
           icon.color: Cpp_ThemeManager.text
           onClicked: Cpp_CSV_Player.toggle()
           Layout.alignment: Qt.AlignVCenter
@@ -177,6 +300,57 @@ FramelessWindow.CustomWindow {
           enabled: Cpp_CSV_Player.progress < 1 && !Cpp_CSV_Player.isPlaying
         }
       }
+
+      //
+      // Event marker navigation
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+        visible: Cpp_CSV_Player.markerCount > 0
+
+        Button {
+          Layout.fillWidth: true
+          text: qsTr("Previous marker")
+          enabled: !Cpp_CSV_Player.isPlaying
+          onClicked: Cpp_CSV_Player.previousMarker()
+        }
+
+        Button {
+          Layout.fillWidth: true
+          text: qsTr("Next marker")
+          enabled: !Cpp_CSV_Player.isPlaying
+          onClicked: Cpp_CSV_Player.nextMarker()
+        }
+      }
+
+      //
+      // Playback speed selector
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Label {
+          text: qsTr("Speed") + ":"
+          Layout.alignment: Qt.AlignVCenter
+        }
+
+        ComboBox {
+          id: _speed
+          Layout.fillWidth: true
+          enabled: Cpp_CSV_Player.isOpen
+          readonly property var speeds: [0.1, 0.25, 0.5, 1, 2, 5, 10, 25, 50,
+            100, 0]
+          model: ["0.1×", "0.25×", "0.5×", "1×", "2×", "5×", "10×", "25×",
+            "50×", "100×", qsTr("As fast as possible")]
+          currentIndex: Math.max(0, speeds.indexOf(Cpp_CSV_Player.speed))
+          onCurrentIndexChanged: {
+            if (speeds[currentIndex] !== Cpp_CSV_Player.speed)
+              Cpp_CSV_Player.speed = speeds[currentIndex]
+          }
+        }
+      }
     }
   }
 }
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2021-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import SerialStudio
+
+import "../Widgets" as Widgets
+import "../FramelessWindow" as FramelessWindow
+
+FramelessWindow.CustomWindow {
+  id: root
+  width: 960
+  height: 640
+  minimumWidth: 640 + shadowMargin
+  minimumHeight: 480 + shadowMargin
+  title: qsTr("Dashboard %1").arg(number)
+  titlebarText: Cpp_ThemeManager.text
+  titlebarColor: Cpp_ThemeManager.widgetWindowBackground
+  backgroundColor: Cpp_ThemeManager.widgetWindowBackground
+  borderColor: isMaximized ? backgroundColor : Cpp_ThemeManager.highlight
+
+  //
+  // Window number & maximum refresh rate of the widgets (0 = render rate)
+  //
+  property int number: 1
+  property int refreshRate: 10
+
+  //
+  // Global indexes of the widgets displayed by this window
+  //
+  property var selection: []
+  function toggleWidget(index) {
+    var list = selection.slice()
+    var pos = list.indexOf(index)
+    if (pos >= 0)
+      list.splice(pos, 1)
+    else
+      list.push(index)
+
+    selection = list
+  }
+
+  //
+  // Destroy the window when it is closed, or when the dashboard is closed
+  //
+  onClosing: Qt.callLater(root.destroy)
+  Connections {
+    target: Cpp_UI_Dashboard
+    function onWidgetCountChanged() {
+      if (!Cpp_UI_Dashboard.available)
+        root.close()
+      else
+        root.selection = []
+    }
+  }
+
+  //
+  // Window contents
+  //
+  Rectangle {
+    clip: true
+    anchors.fill: parent
+    radius: root.radius
+    anchors.margins: root.shadowMargin
+    color: Cpp_ThemeManager.widgetWindowBackground
+    anchors.topMargin: root.titlebar.height + root.shadowMargin
+
+    ColumnLayout {
+      spacing: app.spacing
+      anchors.fill: parent
+      anchors.margins: app.spacing
+
+      //
+      // Window options
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Button {
+          icon.source: "qrc:/icons/widget.svg"
+          text: qsTr("Widgets")
+          onClicked: widgetMenu.popup()
+
+          Menu {
+            id: widgetMenu
+
+            Instantiator {
+              model: Cpp_UI_WidgetModel
+              onObjectAdded: (index, object) => widgetMenu.insertItem(index, object)
+              onObjectRemoved: (index, object) => widgetMenu.removeItem(object)
+              delegate: MenuItem {
+                checkable: true
+                text: widgetTitle
+                checked: root.selection.indexOf(widgetIndex) >= 0
+                onTriggered: root.toggleWidget(widgetIndex)
+              }
+            }
+          }
+        }
+
+        Item {
+          Layout.fillWidth: true
+        }
+
+        Label {
+          text: qsTr("Refresh rate:")
+          Layout.alignment: Qt.AlignVCenter
+        }
+
+        ComboBox {
+          id: _rate
+          textRole: "text"
+          valueRole: "value"
+          Layout.alignment: Qt.AlignVCenter
+          model: [
+            { text: qsTr("Render rate"), value: 0 },
+            { text: qsTr("30 Hz"), value: 30 },
+            { text: qsTr("10 Hz"), value: 10 },
+            { text: qsTr("5 Hz"), value: 5 },
+            { text: qsTr("1 Hz"), value: 1 }
+          ]
+          Component.onCompleted: currentIndex = indexOfValue(root.refreshRate)
+          onActivated: root.refreshRate = currentValue
+        }
+      }
+
+      //
+      // Selected widgets
+      //
+      GridLayout {
+        id: grid
+        Layout.fillWidth: true
+        Layout.fillHeight: true
+        rowSpacing: app.spacing
+        columnSpacing: app.spacing
+        columns: Math.max(1, Math.ceil(Math.sqrt(root.selection.length)))
+
+        Repeater {
+          model: root.selection
+          delegate: Widgets.Window {
+            id: window
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            title: widget.widgetTitle
+            icon.source: widget.widgetIcon
+            borderColor: Cpp_ThemeManager.widgetWindowBorder
+
+            DashboardWidget {
+              id: widget
+              isExternalWindow: true
+              widgetIndex: modelData
+              refreshRate: root.refreshRate
+              widgetVisible: root.visible && !root.isMinimized
+              anchors {
+                fill: parent
+                leftMargin: window.borderWidth
+                rightMargin: window.borderWidth
+                bottomMargin: window.borderWidth
+              }
+
+              Loader {
+                anchors.fill: parent
+                asynchronous: true
+                active: widget.isGpsMap
+                visible: widget.isGpsMap && status == Loader.Ready
+                sourceComponent: Widgets.GpsMap {
+                  index: widget.relativeIndex
+                  altitude: widget.gpsAltitude
+                  latitude: widget.gpsLatitude
+                  longitude: widget.gpsLongitude
+                }
+              }
+
+              Loader {
+                anchors.fill: parent
+                active: widget.isNativePlot
+                visible: widget.isNativePlot && status == Loader.Ready
+                sourceComponent: Widgets.NativePlot {
+                  index: widget.relativeIndex
+                  multiPlot: widget.isMultiPlot
+                }
+              }
+
+              Loader {
+                anchors.fill: parent
+                active: widget.isWaterfall
+                visible: widget.isWaterfall && status == Loader.Ready
+                sourceComponent: Widgets.Waterfall {
+                  index: widget.relativeIndex
+                }
+              }
+            }
+          }
+        }
+
+        Label {
+          opacity: 0.8
+          Layout.fillWidth: true
+          Layout.fillHeight: true
+          visible: root.selection.length === 0
+          horizontalAlignment: Label.AlignHCenter
+          verticalAlignment: Label.AlignVCenter
+          text: qsTr("Use the \"Widgets\" menu to select the widgets to display")
+        }
+      }
+    }
+  }
+
+  FramelessWindow.ResizeHandles {
+    window: root
+    anchors.fill: parent
+    handleSize: root.handleSize
+  }
+}
@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Window
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import "../FramelessWindow" as FramelessWindow
+
+FramelessWindow.CustomWindow {
+  id: root
+
+  //
+  // Window options
+  //
+  width: minimumWidth
+  height: minimumHeight
+  minimizeEnabled: false
+  maximizeEnabled: false
+  title: qsTr("Pipeline Diagnostics")
+  titlebarText: Cpp_ThemeManager.text
+  x: (Screen.desktopAvailableWidth - width) / 2
+  y: (Screen.desktopAvailableHeight - height) / 2
+  titlebarColor: Cpp_ThemeManager.dialogBackground
+  backgroundColor: Cpp_ThemeManager.dialogBackground
+  minimumWidth: column.implicitWidth + 4 * app.spacing + 2 * root.shadowMargin
+  maximumWidth: column.implicitWidth + 4 * app.spacing + 2 * root.shadowMargin
+  extraFlags: Qt.Dialog | Qt.WindowCloseButtonHint | Qt.WindowTitleHint
+  minimumHeight: column.implicitHeight + 4 * app.spacing + titlebar.height + 2 * root.shadowMargin
+  maximumHeight: column.implicitHeight + 4 * app.spacing + titlebar.height + 2 * root.shadowMargin
+
+  //
+  // Formats the given duration (in microseconds)
+  //
+  function formatTime(usecs) {
+    if (usecs < 1000)
+      return usecs.toFixed(1) + " µs"
+
+    return (usecs / 1000).toFixed(2) + " ms"
+  }
+
+  //
+  // Formats the given number of bytes
+  //
+  function formatBytes(bytes) {
+    if (bytes < 1024)
+      return bytes + " B"
+    if (bytes < 1024 * 1024)
+      return (bytes / 1024).toFixed(1) + " KB"
+
+    return (bytes / (1024 * 1024)).toFixed(1) + " MB"
+  }
+
+  //
+  // Returns the largest bucket of the given histogram
+  //
+  function maxBucket(histogram) {
+    var max = 1
+    for (var i = 0; i < histogram.length; ++i)
+      max = Math.max(max, histogram[i])
+
+    return max
+  }
+
+  //
+  // Use page item to set application palette
+  //
+  Page {
+    anchors {
+      fill: parent
+      margins: root.shadowMargin
+      topMargin: titlebar.height + root.shadowMargin
+    }
+
+    palette.alternateBase: Cpp_ThemeManager.base
+    palette.base: Cpp_ThemeManager.base
+    palette.brightText: Cpp_ThemeManager.brightText
+    palette.button: Cpp_ThemeManager.button
+    palette.buttonText: Cpp_ThemeManager.buttonText
+    palette.highlight: Cpp_ThemeManager.highlight
+    palette.highlightedText: Cpp_ThemeManager.highlightedText
+    palette.link: Cpp_ThemeManager.link
+    palette.placeholderText: Cpp_ThemeManager.placeholderText
+    palette.text: Cpp_ThemeManager.text
+    palette.toolTipBase: Cpp_ThemeManager.tooltipBase
+    palette.toolTipText: Cpp_ThemeManager.tooltipText
+    palette.window: Cpp_ThemeManager.window
+    palette.windowText: Cpp_ThemeManager.windowText
+
+    background: Rectangle {
+      radius: root.radius
+      color: root.backgroundColor
+
+      Rectangle {
+        height: root.radius
+        color: root.backgroundColor
+
+        anchors {
+          top: parent.top
+          left: parent.left
+          right: parent.right
+        }
+      }
+    }
+
+    //
+    // Window controls
+    //
+    ColumnLayout {
+      id: column
+      anchors.centerIn: parent
+      spacing: app.spacing * 2
+
+      //
+      // Stage statistics
+      //
+      Label {
+        font.bold: true
+        text: qsTr("Pipeline stages")
+      } GridLayout {
+        columns: 8
+        rowSpacing: app.spacing / 2
+        columnSpacing: app.spacing * 2
+
+        Label { text: qsTr("Stage"); font.bold: true }
+        Label { text: qsTr("Rate"); font.bold: true }
+        Label { text: qsTr("Mean"); font.bold: true }
+        Label { text: qsTr("p50"); font.bold: true }
+        Label { text: qsTr("p95"); font.bold: true }
+        Label { text: qsTr("p99"); font.bold: true }
+        Label { text: qsTr("Max"); font.bold: true }
+        Label { text: qsTr("Histogram"); font.bold: true }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 0
+            text: modelData["name"]
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 1
+            font.family: app.monoFont
+            text: modelData["rate"].toFixed(1) + " Hz"
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 2
+            font.family: app.monoFont
+            text: root.formatTime(modelData["mean"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 3
+            font.family: app.monoFont
+            text: root.formatTime(modelData["p50"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 4
+            font.family: app.monoFont
+            text: root.formatTime(modelData["p95"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 5
+            font.family: app.monoFont
+            text: root.formatTime(modelData["p99"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 6
+            font.family: app.monoFont
+            text: root.formatTime(modelData["max"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.stages
+          delegate: Row {
+            id: histogram
+            spacing: 1
+            Layout.row: index + 1
+            Layout.column: 7
+            Layout.alignment: Qt.AlignVCenter
+            readonly property var buckets: modelData["histogram"]
+            readonly property real max: root.maxBucket(buckets)
+
+            Repeater {
+              model: histogram.buckets
+              delegate: Rectangle {
+                width: 4
+                height: 16
+                color: "transparent"
+
+                Rectangle {
+                  width: parent.width
+                  anchors.bottom: parent.bottom
+                  color: Cpp_ThemeManager.highlight
+                  height: Math.max(modelData > 0 ? 1 : 0,
+                                   parent.height * modelData / histogram.max)
+                }
+              }
+            }
+          }
+        }
+      }
+
+      //
+      // Queue depths & drop counts
+      //
+      Label {
+        font.bold: true
+        text: qsTr("Queues")
+      } GridLayout {
+        columns: 3
+        rowSpacing: app.spacing / 2
+        columnSpacing: app.spacing * 2
+
+        Label { text: qsTr("Queue"); font.bold: true }
+        Label { text: qsTr("Depth"); font.bold: true }
+        Label { text: qsTr("Dropped"); font.bold: true }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.queues
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 0
+            text: modelData["name"]
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.queues
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 1
+            font.family: app.monoFont
+            text: modelData["depth"] + " " + modelData["unit"]
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.queues
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 2
+            font.family: app.monoFont
+            text: modelData["dropped"]
+          }
+        }
+      }
+
+      //
+      // Event counters
+      //
+      Label {
+        font.bold: true
+        text: qsTr("Counters")
+      } GridLayout {
+        columns: 2
+        rowSpacing: app.spacing / 2
+        columnSpacing: app.spacing * 2
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.counters
+          delegate: Label {
+            Layout.row: index
+            Layout.column: 0
+            text: modelData["name"] + ":"
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.counters
+          delegate: Label {
+            Layout.row: index
+            Layout.column: 1
+            font.family: app.monoFont
+            text: modelData["value"]
+          }
+        }
+      }
+
+      //
+      // Memory held by each subsystem
+      //
+      Label {
+        font.bold: true
+        text: qsTr("Memory")
+      } GridLayout {
+        columns: 2
+        rowSpacing: app.spacing / 2
+        columnSpacing: app.spacing * 2
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.memory
+          delegate: Label {
+            Layout.row: index
+            Layout.column: 0
+            text: modelData["name"] + ":"
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.memory
+          delegate: Label {
+            Layout.row: index
+            Layout.column: 1
+            font.family: app.monoFont
+            text: root.formatBytes(modelData["bytes"])
+          }
+        }
+      }
+
+      //
+      // Render cost of the most expensive dashboard widgets
+      //
+      Label {
+        font.bold: true
+        text: qsTr("Widget render cost")
+        visible: Cpp_Misc_Diagnostics.widgets.length > 0
+      } GridLayout {
+        columns: 5
+        rowSpacing: app.spacing / 2
+        columnSpacing: app.spacing * 2
+        visible: Cpp_Misc_Diagnostics.widgets.length > 0
+
+        Label { text: qsTr("Widget"); font.bold: true }
+        Label { text: qsTr("Update"); font.bold: true }
+        Label { text: qsTr("Grab"); font.bold: true }
+        Label { text: qsTr("Paint"); font.bold: true }
+        Label { text: qsTr("Total"); font.bold: true }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.widgets
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 0
+            elide: Label.ElideRight
+            Layout.maximumWidth: 200
+            text: modelData["name"]
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.widgets
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 1
+            font.family: app.monoFont
+            text: root.formatTime(modelData["update"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.widgets
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 2
+            font.family: app.monoFont
+            text: root.formatTime(modelData["grab"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.widgets
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 3
+            font.family: app.monoFont
+            text: root.formatTime(modelData["paint"])
+          }
+        }
+
+        Repeater {
+          model: Cpp_Misc_Diagnostics.widgets
+          delegate: Label {
+            Layout.row: index + 1
+            Layout.column: 4
+            font.family: app.monoFont
+            text: root.formatTime(modelData["total"])
+          }
+        }
+      }
+
+      //
+      // Round-trip latency probe
+      //
+      Label {
+        font.bold: true
+        text: qsTr("Latency probe")
+      } RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        CheckBox {
+          text: qsTr("Send pings every")
+          checked: Cpp_IO_LatencyProbe.enabled
+          onCheckedChanged: {
+            if (Cpp_IO_LatencyProbe.enabled !== checked)
+              Cpp_IO_LatencyProbe.enabled = checked
+          }
+        }
+
+        SpinBox {
+          from: 100
+          to: 60000
+          stepSize: 100
+          editable: true
+          value: Cpp_IO_LatencyProbe.interval
+          onValueModified: Cpp_IO_LatencyProbe.interval = value
+        }
+
+        Label {
+          text: qsTr("ms")
+        }
+
+        Item {
+          Layout.fillWidth: true
+        }
+
+        Label {
+          font.family: app.monoFont
+          text: qsTr("%1 sent, %2 echoed, %3 lost")
+                .arg(Cpp_IO_LatencyProbe.sent)
+                .arg(Cpp_IO_LatencyProbe.echoes)
+                .arg(Cpp_IO_LatencyProbe.lost)
+        }
+      }
+
+      //
+      // Buttons
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Button {
+          checkable: true
+          checked: Cpp_Misc_Tracer.tracing
+          text: Cpp_Misc_Tracer.tracing ? qsTr("Stop & save trace") + "..." :
+                                          qsTr("Record trace")
+          onClicked: {
+            if (Cpp_Misc_Tracer.tracing)
+              Cpp_Misc_Tracer.stopTracing()
+            else
+              Cpp_Misc_Tracer.startTracing()
+          }
+        }
+
+        Item {
+          Layout.fillWidth: true
+        }
+
+        Button {
+          text: qsTr("Copy as JSON")
+          onClicked: Cpp_Misc_Diagnostics.copySnapshot()
+        }
+
+        Button {
+          text: qsTr("Reset")
+          onClicked: {
+            Cpp_Misc_Diagnostics.reset()
+            Cpp_IO_LatencyProbe.clearStatistics()
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2020-2024 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+import QtQuick
+import QtQuick.Window
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import "../FramelessWindow" as FramelessWindow
+
+FramelessWindow.CustomWindow {
+  id: root
+
+  //
+  // Window options
+  //
+  width: minimumWidth
+  height: minimumHeight
+  minimizeEnabled: false
+  maximizeEnabled: false
+  title: qsTr("File Transfer")
+  titlebarText: Cpp_ThemeManager.text
+  x: (Screen.desktopAvailableWidth - width) / 2
+  y: (Screen.desktopAvailableHeight - height) / 2
+  titlebarColor: Cpp_ThemeManager.dialogBackground
+  backgroundColor: Cpp_ThemeManager.dialogBackground
+  minimumWidth: column.implicitWidth + 4 * app.spacing + 2 * root.shadowMargin
+  maximumWidth: column.implicitWidth + 4 * app.spacing + 2 * root.shadowMargin
+  extraFlags: Qt.Dialog | Qt.WindowCloseButtonHint | Qt.WindowTitleHint
+  minimumHeight: column.implicitHeight + 4 * app.spacing + titlebar.height + 2 * root.shadowMargin
+  maximumHeight: column.implicitHeight + 4 * app.spacing + titlebar.height + 2 * root.shadowMargin
+
+  //
+  // Use page item to set application palette
+  //
+  Page {
+    anchors {
+      fill: parent
+      margins: root.shadowMargin
+      topMargin: titlebar.height + root.shadowMargin
+    }
+
+    palette.alternateBase: Cpp_ThemeManager.base
+    palette.base: Cpp_ThemeManager.base
+    palette.brightText: Cpp_ThemeManager.brightText
+    palette.button: Cpp_ThemeManager.button
+    palette.buttonText: Cpp_ThemeManager.buttonText
+    palette.highlight: Cpp_ThemeManager.highlight
+    palette.highlightedText: Cpp_ThemeManager.highlightedText
+    palette.link: Cpp_ThemeManager.link
+    palette.placeholderText: Cpp_ThemeManager.placeholderText
+    palette.text: Cpp_ThemeManager.text
+    palette.toolTipBase: Cpp_ThemeManager.tooltipBase
+    palette.toolTipText: Cpp_ThemeManager.tooltipText
+    palette.window: Cpp_ThemeManager.window
+    palette.windowText: Cpp_ThemeManager.windowText
+
+    background: Rectangle {
+      radius: root.radius
+      color: root.backgroundColor
+
+      Rectangle {
+        height: root.radius
+        color: root.backgroundColor
+
+        anchors {
+          top: parent.top
+          left: parent.left
+          right: parent.right
+        }
+      }
+    }
+
+    //
+    // Window controls
+    //
+    ColumnLayout {
+      id: column
+      anchors.centerIn: parent
+      spacing: app.spacing * 2
+
+      //
+      // Transfer options
+      //
+      GridLayout {
+        columns: 2
+        rowSpacing: app.spacing
+        columnSpacing: app.spacing
+        enabled: !Cpp_IO_FileTransfer.active
+
+        Label {
+          text: qsTr("File") + ":"
+        } RowLayout {
+          spacing: app.spacing
+          Layout.fillWidth: true
+
+          TextField {
+            readOnly: true
+            Layout.fillWidth: true
+            Layout.minimumWidth: 256
+            text: Cpp_IO_FileTransfer.fileName
+            placeholderText: qsTr("No file selected")
+          }
+
+          Button {
+            text: qsTr("Browse...")
+            onClicked: Cpp_IO_FileTransfer.selectFile()
+          }
+        }
+
+        Label {
+          text: qsTr("Protocol") + ":"
+        } ComboBox {
+          Layout.fillWidth: true
+          model: Cpp_IO_FileTransfer.availableProtocols
+          currentIndex: Cpp_IO_FileTransfer.protocol
+          onCurrentIndexChanged: {
+            if (Cpp_IO_FileTransfer.protocol !== currentIndex)
+              Cpp_IO_FileTransfer.protocol = currentIndex
+          }
+        }
+
+        Label {
+          text: qsTr("Window (blocks)") + ":"
+        } SpinBox {
+          from: 1
+          to: 32
+          editable: true
+          Layout.fillWidth: true
+          enabled: Cpp_IO_FileTransfer.protocol !== 0
+          value: Cpp_IO_FileTransfer.window
+          onValueChanged: {
+            if (Cpp_IO_FileTransfer.window !== value)
+              Cpp_IO_FileTransfer.window = value
+          }
+        }
+      }
+
+      //
+      // Transfer status
+      //
+      GridLayout {
+        columns: 2
+        rowSpacing: app.spacing / 2
+        columnSpacing: app.spacing * 2
+
+        Label {
+          text: qsTr("Status") + ":"
+        } Label {
+          font.bold: true
+          text: Cpp_IO_FileTransfer.status.length > 0 ?
+                  Cpp_IO_FileTransfer.status : qsTr("Idle")
+        }
+
+        Label {
+          text: qsTr("Transferred") + ":"
+        } Label {
+          font.family: app.monoFont
+          text: (Cpp_IO_FileTransfer.transferredBytes / 1024).toFixed(1) +
+                " / " + (Cpp_IO_FileTransfer.fileSize / 1024).toFixed(1) +
+                " KB"
+        }
+
+        Label {
+          text: qsTr("Throughput") + ":"
+        } Label {
+          font.family: app.monoFont
+          text: (Cpp_IO_FileTransfer.throughput / 1024).toFixed(1) + " KB/s"
+        }
+      }
+
+      ProgressBar {
+        from: 0
+        to: 1
+        Layout.fillWidth: true
+        value: Cpp_IO_FileTransfer.progress
+      }
+
+      //
+      // Buttons
+      //
+      RowLayout {
+        spacing: app.spacing
+        Layout.fillWidth: true
+
+        Button {
+          Layout.fillWidth: true
+          text: Cpp_IO_FileTransfer.active ? qsTr("Cancel") : qsTr("Upload")
+          enabled: Cpp_IO_FileTransfer.active ||
+                   (Cpp_IO_FileTransfer.fileSize > 0 && Cpp_IO_Manager.connected)
+          onClicked: {
+            if (Cpp_IO_FileTransfer.active)
+              Cpp_IO_FileTransfer.cancel()
+            else
+              Cpp_IO_FileTransfer.start()
+          }
+        }
+      }
+    }
+  }
+}
@@ -71,6 +71,15 @@ FramelessWindow.CustomWindow {
     property alias keepAlive: _keepAlive.text
     property alias topic: _topic.text
     property alias retain: _retain.checked
+    property alias publishing: _publishing.currentIndex
+    property alias encoding: _encoding.currentIndex
+    property alias deadband: _deadband.text
+    property alias spool: _spool.checked
+    property alias spoolLimit: _spoolLimit.text
+    property alias drainRate: _drainRate.text
+    property alias maxLatency: _maxLatency.text
+    property alias maxBatchBytes: _maxBatchBytes.text
+    property alias maxBatchFrames: _maxBatchFrames.text
     property alias user: _user.text
     property alias password: _password.text
     property alias ssl: _ssl.checked
@@ -370,6 +379,283 @@ FramelessWindow.CustomWindow {
           height: app.spacing
         }
 
+        //
+        // Publishing mode & latency labels
+        //
+        Label {
+          text: qsTr("Publishing") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0
+        } Label {
+          text: qsTr("Max. latency (ms)") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _publishing.currentIndex === 0
+        }
+
+        //
+        // Publishing mode
+        //
+        ComboBox {
+          id: _publishing
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0
+          model: [qsTr("Batched frames"), qsTr("One message per frame")]
+          currentIndex: Cpp_MQTT_Client.perFramePublishing ? 1 : 0
+          onCurrentIndexChanged: {
+            if (Cpp_MQTT_Client.perFramePublishing !== (currentIndex === 1))
+              Cpp_MQTT_Client.perFramePublishing = (currentIndex === 1)
+          }
+        }
+
+        //
+        // Maximum latency
+        //
+        TextField {
+          id: _maxLatency
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          placeholderText: "1000"
+          enabled: _mode.currentIndex === 0 && _publishing.currentIndex === 0
+          Component.onCompleted: text = Cpp_MQTT_Client.maxLatency
+
+          onTextChanged: {
+            if (text.length > 0 && Cpp_MQTT_Client.maxLatency !== parseInt(text))
+              Cpp_MQTT_Client.maxLatency = parseInt(text)
+          }
+
+          validator: IntValidator {
+            bottom: 1
+            top: 60000
+          }
+        }
+
+        //
+        // Spacers
+        //
+        Item {
+          height: app.spacing
+        } Item {
+          height: app.spacing
+        }
+
+        //
+        // Payload encoding
+        //
+        Label {
+          Layout.columnSpan: 2
+          text: qsTr("Payload encoding") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0
+        } ComboBox {
+          id: _encoding
+          Layout.columnSpan: 2
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0
+          model: Cpp_MQTT_Client.payloadEncodings
+          currentIndex: Cpp_MQTT_Client.payloadEncoding
+          onCurrentIndexChanged: {
+            if (Cpp_MQTT_Client.payloadEncoding !== currentIndex)
+              Cpp_MQTT_Client.payloadEncoding = currentIndex
+          }
+        }
+
+        //
+        // Deadband used when publishing one topic per dataset
+        //
+        Label {
+          Layout.columnSpan: 2
+          text: qsTr("Numeric deadband") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _encoding.currentIndex === 3
+        } TextField {
+          id: _deadband
+          Layout.columnSpan: 2
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          placeholderText: qsTr("0 = publish every change")
+          enabled: _mode.currentIndex === 0 && _encoding.currentIndex === 3
+          Component.onCompleted: text = Cpp_MQTT_Client.deadband
+
+          onTextChanged: {
+            const value = text.length > 0 ? parseFloat(text) : 0
+            if (Cpp_MQTT_Client.deadband !== value)
+              Cpp_MQTT_Client.deadband = value
+          }
+
+          validator: DoubleValidator {
+            bottom: 0
+          }
+        }
+
+        //
+        // Spacers
+        //
+        Item {
+          height: app.spacing
+        } Item {
+          height: app.spacing
+        }
+
+        //
+        // Batch limit labels
+        //
+        Label {
+          text: qsTr("Max. batch size (bytes)") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _publishing.currentIndex === 0
+        } Label {
+          text: qsTr("Max. frames per batch") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _publishing.currentIndex === 0
+        }
+
+        //
+        // Maximum batch size
+        //
+        TextField {
+          id: _maxBatchBytes
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          placeholderText: qsTr("0 = no limit")
+          enabled: _mode.currentIndex === 0 && _publishing.currentIndex === 0
+          Component.onCompleted: text = Cpp_MQTT_Client.maxBatchBytes
+
+          onTextChanged: {
+            const value = text.length > 0 ? parseInt(text) : 0
+            if (Cpp_MQTT_Client.maxBatchBytes !== value)
+              Cpp_MQTT_Client.maxBatchBytes = value
+          }
+
+          validator: IntValidator {
+            bottom: 0
+          }
+        }
+
+        //
+        // Maximum frames per batch
+        //
+        TextField {
+          id: _maxBatchFrames
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          placeholderText: qsTr("0 = no limit")
+          enabled: _mode.currentIndex === 0 && _publishing.currentIndex === 0
+          Component.onCompleted: text = Cpp_MQTT_Client.maxBatchFrames
+
+          onTextChanged: {
+            const value = text.length > 0 ? parseInt(text) : 0
+            if (Cpp_MQTT_Client.maxBatchFrames !== value)
+              Cpp_MQTT_Client.maxBatchFrames = value
+          }
+
+          validator: IntValidator {
+            bottom: 0
+          }
+        }
+
+        //
+        // Spacers
+        //
+        Item {
+          height: app.spacing
+        } Item {
+          height: app.spacing
+        }
+
+        //
+        // Offline spool checkbox & status
+        //
+        CheckBox {
+          id: _spool
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          Layout.leftMargin: -app.spacing
+          checked: Cpp_MQTT_Client.spoolEnabled
+          enabled: _mode.currentIndex === 0
+          text: qsTr("Store messages while offline")
+
+          onCheckedChanged: {
+            if (Cpp_MQTT_Client.spoolEnabled !== checked)
+              Cpp_MQTT_Client.spoolEnabled = checked
+          }
+        } Label {
+          Layout.fillWidth: true
+          elide: Label.ElideRight
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _spool.checked
+          text: qsTr("%1 KiB pending, %2 dropped").arg(
+                  Math.ceil(Cpp_MQTT_Client.spooledBytes / 1024)).arg(
+                  Cpp_MQTT_Client.droppedMessages)
+        }
+
+        //
+        // Spool limit labels
+        //
+        Label {
+          text: qsTr("Spool size (MiB)") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _spool.checked
+        } Label {
+          text: qsTr("Drain rate (messages/s)") + ":"
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _spool.checked
+        }
+
+        //
+        // Spool size
+        //
+        TextField {
+          id: _spoolLimit
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _spool.checked
+          Component.onCompleted: text = Cpp_MQTT_Client.spoolLimit
+
+          onTextChanged: {
+            const value = text.length > 0 ? parseInt(text) : 1
+            if (Cpp_MQTT_Client.spoolLimit !== value)
+              Cpp_MQTT_Client.spoolLimit = value
+          }
+
+          validator: IntValidator {
+            bottom: 1
+            top: 4096
+          }
+        }
+
+        //
+        // Drain rate
+        //
+        TextField {
+          id: _drainRate
+          Layout.fillWidth: true
+          opacity: enabled ? 1 : 0.5
+          enabled: _mode.currentIndex === 0 && _spool.checked
+          Component.onCompleted: text = Cpp_MQTT_Client.drainRate
+
+          onTextChanged: {
+            const value = text.length > 0 ? parseInt(text) : 1
+            if (Cpp_MQTT_Client.drainRate !== value)
+              Cpp_MQTT_Client.drainRate = value
+          }
+
+          validator: IntValidator {
+            bottom: 1
+            top: 10000
+          }
+        }
+
+        //
+        // Spacers
+        //
+        Item {
+          height: app.spacing
+        } Item {
+          height: app.spacing
+        }
+
         //
         // Username & password titles
         //
@@ -61,7 +61,8 @@ FramelessWindow.CustomWindow {
   property int appLaunchCount: 0
   property bool firstValidFrame: false
   property bool automaticUpdates: false
-  property alias vt100emulation: terminal.vt100emulation
+  readonly property bool vt100emulation: terminal.item !== null &&
+                                         terminal.item.vt100emulation
 
   //
   // Toolbar functions aliases
@@ -83,9 +84,14 @@ FramelessWindow.CustomWindow {
   //
   // Console-related functions
   //
-  function consoleCopy()      { terminal.copy()      }
-  function consoleClear()     { terminal.clear()     }
-  function consoleSelectAll() { terminal.selectAll() }
+  function consoleCopy()      { if (terminal.item) terminal.item.copy()      }
+  function consoleClear()     { if (terminal.item) terminal.item.clear()     }
+  function consoleSelectAll() { if (terminal.item) terminal.item.selectAll() }
+
+  function setVt100emulation(enabled) {
+    if (terminal.item)
+      terminal.item.vt100emulation = enabled
+  }
 
   //
   // Window geometry
@@ -102,9 +108,6 @@ FramelessWindow.CustomWindow {
   // Startup code
   //
   Component.onCompleted: {
-    // Load welcome text
-    terminal.showWelcomeGuide()
-
     // Increment app launch count
     ++appLaunchCount
 
@@ -134,6 +137,15 @@ FramelessWindow.CustomWindow {
     if (root.appLaunchCount % 15 == 0 && !app.donateDialog.doNotShowAgain)
       app.donateDialog.showAutomatically()
 
+    // Check for updates if the updater has already been initialized
+    if (Cpp_ModuleManager.deferredModulesLoaded)
+      root.checkForUpdatesAtStartup()
+  }
+
+  //
+  // Update check, runs once the deferred modules have been initialized
+  //
+  function checkForUpdatesAtStartup() {
     // Ask user if he/she wants to enable automatic updates
     if (root.appLaunchCount == 2 && Cpp_UpdaterEnabled) {
       if (Cpp_Misc_Utilities.askAutomaticUpdates()) {
@@ -150,6 +162,28 @@ FramelessWindow.CustomWindow {
       Cpp_Updater.checkForUpdates(Cpp_AppUpdaterUrl)
   }
 
+  //
+  // Initialize the modules that are not needed to show the user interface
+  // once the first frame has been rendered
+  //
+  Connections {
+    target: root
+    enabled: !Cpp_ModuleManager.deferredModulesLoaded
+
+    function onFrameSwapped() {
+      Cpp_ModuleManager.initializeDeferredModules()
+    }
+  }
+
+  Connections {
+    target: Cpp_ModuleManager
+
+    function onDeferredModulesLoadedChanged() {
+      if (Cpp_ModuleManager.deferredModulesLoaded)
+        root.checkForUpdatesAtStartup()
+    }
+  }
+
   //
   // Hide console & device manager when we receive first valid frame
   //
@@ -342,11 +376,15 @@ FramelessWindow.CustomWindow {
           Layout.fillWidth: true
           Layout.fillHeight: true
           data: [
-            Console {
+            Loader {
               id: terminal
               visible: false
+              asynchronous: true
               width: parent.width
               height: parent.height
+              active: Cpp_IO_Console.enabled
+              sourceComponent: Console {}
+              onLoaded: item.showWelcomeGuide()
             },
 
             Dashboard {
@@ -377,6 +415,18 @@ FramelessWindow.CustomWindow {
     enabled: !Cpp_IO_Manager.connected
   }
 
+  //
+  // Render statistics
+  //
+  Loader {
+    z: 1000
+    active: Cpp_Misc_Renderer.overlayEnabled
+    anchors.right: parent.right
+    anchors.bottom: parent.bottom
+    anchors.margins: root.shadowMargin + app.spacing * 2
+    sourceComponent: PerformanceOverlay {}
+  }
+
   //
   // Resize handler
   //
@@ -25,6 +25,7 @@ import QtQuick.Window
 import QtQuick.Controls
 
 import "Windows" as Windows
+import "Widgets" as Widgets
 
 Item {
   id: app
@@ -36,14 +37,18 @@ Item {
   readonly property string monoFont: "Roboto Mono"
 
   //
-  // Access to dialogs & windows
+  // Access to dialogs & windows, windows that are not needed at startup are
+  // created the first time that they are shown
   //
-  property Window aboutDialog: null
   property Window donateDialog: null
   property Window mainWindow: null
-  property Window csvPlayerDialog: null
-  property Window projectEditorWindow: null
-  property Window acknowledgementsDialog: null
+  property alias aboutDialog: aboutLoader
+  property alias burstDialog: burstLoader
+  property alias captureDialog: captureLoader
+  property alias diagnosticsDialog: diagnosticsLoader
+  property alias fileTransferDialog: fileTransferLoader
+  property alias projectEditorWindow: projectEditorLoader
+  property alias acknowledgementsDialog: acknowledgementsLoader
 
   //
   // Check for updates (non-silent mode)
@@ -62,6 +67,7 @@ Item {
       Component.onCompleted: {
         app.forceActiveFocus()
         app.mainWindow = this
+        Cpp_Misc_Renderer.attachWindow(this)
       }
     }
   }
@@ -69,31 +75,72 @@ Item {
   //
   // About window
   //
-  Loader {
-    asynchronous: true
-    sourceComponent: Windows.About {
-      Component.onCompleted: app.aboutDialog = this
-    }
+  Widgets.WindowLoader {
+    id: aboutLoader
+    sourceComponent: Windows.About {}
   }
 
   //
-  // CSV player window
+  // CSV player window, created when a CSV file is opened for the first time
   //
   Loader {
+    id: csvPlayerLoader
+    active: false
     asynchronous: true
-    sourceComponent: Windows.CsvPlayer {
-      Component.onCompleted: app.csvPlayerDialog = this
+    sourceComponent: Windows.CsvPlayer {}
+  }
+
+  Connections {
+    target: Cpp_CSV_Player
+    enabled: !csvPlayerLoader.active
+
+    function onOpenChanged() {
+      csvPlayerLoader.active = true
+    }
+
+    function onLoadingChanged() {
+      csvPlayerLoader.active = true
     }
   }
 
+  //
+  // Burst recording window
+  //
+  Widgets.WindowLoader {
+    id: burstLoader
+    sourceComponent: Windows.BurstRecorder {}
+  }
+
+  //
+  // Triggered capture window
+  //
+  Widgets.WindowLoader {
+    id: captureLoader
+    sourceComponent: Windows.Capture {}
+  }
+
+  //
+  // Pipeline diagnostics window
+  //
+  Widgets.WindowLoader {
+    id: diagnosticsLoader
+    sourceComponent: Windows.Diagnostics {}
+  }
+
+  //
+  // File transfer window
+  //
+  Widgets.WindowLoader {
+    id: fileTransferLoader
+    sourceComponent: Windows.FileTransfer {}
+  }
+
   //
   // Project editor dialog
   //
-  Loader {
-    asynchronous: true
-    sourceComponent: Windows.ProjectEditor {
-      Component.onCompleted: app.projectEditorWindow = this
-    }
+  Widgets.WindowLoader {
+    id: projectEditorLoader
+    sourceComponent: Windows.ProjectEditor {}
   }
 
   //
@@ -109,10 +156,8 @@ Item {
   //
   // Acknowledgements dialog
   //
-  Loader {
-    asynchronous: true
-    sourceComponent: Windows.Acknowledgements {
-      Component.onCompleted: app.acknowledgementsDialog = this
-    }
+  Widgets.WindowLoader {
+    id: acknowledgementsLoader
+    sourceComponent: Windows.Acknowledgements {}
   }
 }
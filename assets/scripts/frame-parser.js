@@ -14,6 +14,12 @@
  *
  * @note             you can safely declare global variables outside the
  *                   @c parse() function.
+ *
+ * @note             optionally, you can also declare a
+ *                   @c parseBatch(frames, separator) function, which receives
+ *                   an array with several frames and must return an array
+ *                   with the fields of each frame. Serial Studio uses it to
+ *                   parse all the frames received at once in a single call.
  */
 function parse(frame, separator) {
     return frame.split(separator);
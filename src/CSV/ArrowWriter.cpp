@@ -0,0 +1,576 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <QtEndian>
+
+#include <CSV/ArrowWriter.h>
+
+/**
+ * Maximum number of rows stored in a single record batch
+ */
+static const int MAX_BATCH_ROWS = 16384;
+
+/**
+ * Constants of the Arrow IPC format (see @c Message.fbs & @c Schema.fbs in
+ * the Arrow source tree).
+ */
+static const quint32 ARROW_CONTINUATION = 0xFFFFFFFF;
+static const int ARROW_METADATA_V5 = 4;
+static const int ARROW_HEADER_SCHEMA = 1;
+static const int ARROW_HEADER_RECORD_BATCH = 3;
+static const int ARROW_TYPE_FLOATING_POINT = 3;
+static const int ARROW_TYPE_UTF8 = 5;
+static const int ARROW_TYPE_TIMESTAMP = 10;
+static const int ARROW_PRECISION_DOUBLE = 2;
+static const int ARROW_UNIT_MILLISECOND = 1;
+
+/**
+ * Appends the given @a value to the @a buffer in little-endian order
+ */
+template<typename T>
+static void WRITE_LE(QByteArray &buffer, const T value)
+{
+  const T le = qToLittleEndian(value);
+  buffer.append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+/**
+ * Appends zeros to the @a buffer until its size is a multiple of 8 bytes
+ */
+static void PAD(QByteArray &buffer)
+{
+  while (buffer.size() % 8 != 0)
+    buffer.append('\0');
+}
+
+/**
+ * Minimal flatbuffer encoder for the metadata of Arrow IPC messages.
+ *
+ * Tables, strings & vectors are declared first & serialized by @c finish().
+ * Unlike the official builder, objects are laid out front to back: each
+ * table is preceded by its vtable & followed by the objects that it refers
+ * to, so that every offset points forward as required by the format. Table
+ * fields are sorted by size, so that every scalar is naturally aligned.
+ */
+class FlatBuilder
+{
+public:
+  int table() { return add(Node(TableNode)); }
+
+  int string(const QByteArray &bytes)
+  {
+    Node node(StringNode);
+    node.bytes = bytes;
+    return add(node);
+  }
+
+  int vector(const QVector<int> &tables)
+  {
+    Node node(VectorNode);
+    node.children = tables;
+    return add(node);
+  }
+
+  int structs(const QByteArray &data, const int count)
+  {
+    Node node(StructNode);
+    node.bytes = data;
+    node.count = count;
+    return add(node);
+  }
+
+  void scalar(const int table, const int id, const int size,
+              const quint64 value)
+  {
+    const Slot slot = {id, size, value, -1};
+    m_nodes[table].slots.append(slot);
+  }
+
+  void offset(const int table, const int id, const int child)
+  {
+    const Slot slot = {id, 4, 0, child};
+    m_nodes[table].slots.append(slot);
+  }
+
+  QByteArray finish(const int root)
+  {
+    m_data = QByteArray(4, '\0');
+    link(0, write(root));
+    PAD(m_data);
+    return m_data;
+  }
+
+private:
+  enum Kind
+  {
+    TableNode,
+    StringNode,
+    VectorNode,
+    StructNode
+  };
+
+  struct Slot
+  {
+    int id;
+    int size;
+    quint64 value;
+    int child;
+  };
+
+  struct Node
+  {
+    explicit Node(const Kind k = TableNode)
+      : kind(k)
+      , count(0)
+    {
+    }
+
+    Kind kind;
+    int count;
+    QByteArray bytes;
+    QVector<int> children;
+    QVector<Slot> slots;
+  };
+
+  int add(const Node &node)
+  {
+    m_nodes.append(node);
+    return m_nodes.count() - 1;
+  }
+
+  void pad(const int alignment, const int remainder)
+  {
+    while (m_data.size() % alignment != remainder)
+      m_data.append('\0');
+  }
+
+  void link(const int position, const int target)
+  {
+    const quint32 le = qToLittleEndian<quint32>(target - position);
+    memcpy(m_data.data() + position, &le, sizeof(le));
+  }
+
+  int write(const int index)
+  {
+    const Node node = m_nodes.at(index);
+    switch (node.kind)
+    {
+      case StringNode:
+        return writeString(node);
+      case VectorNode:
+        return writeVector(node);
+      case StructNode:
+        return writeStructs(node);
+      default:
+        return writeTable(node);
+    }
+  }
+
+  int writeString(const Node &node)
+  {
+    pad(4, 0);
+    const int position = m_data.size();
+    WRITE_LE<quint32>(m_data, static_cast<quint32>(node.bytes.size()));
+    m_data.append(node.bytes);
+    m_data.append('\0');
+    return position;
+  }
+
+  int writeStructs(const Node &node)
+  {
+    pad(8, 4);
+    const int position = m_data.size();
+    WRITE_LE<quint32>(m_data, static_cast<quint32>(node.count));
+    m_data.append(node.bytes);
+    return position;
+  }
+
+  int writeVector(const Node &node)
+  {
+    pad(4, 0);
+    const int count = node.children.count();
+    const int position = m_data.size();
+    WRITE_LE<quint32>(m_data, static_cast<quint32>(count));
+    m_data.append(QByteArray(4 * count, '\0'));
+    for (int i = 0; i < count; ++i)
+      link(position + 4 + 4 * i, write(node.children.at(i)));
+
+    return position;
+  }
+
+  int writeTable(const Node &node)
+  {
+    // Sort fields by size, largest first
+    auto slots = node.slots;
+    std::stable_sort(slots.begin(), slots.end(),
+                     [](const Slot &a, const Slot &b) {
+                       return a.size > b.size;
+                     });
+
+    // Reserve the vtable
+    int fieldCount = 0;
+    for (int i = 0; i < slots.count(); ++i)
+      fieldCount = qMax(fieldCount, slots.at(i).id + 1);
+
+    pad(4, 0);
+    const int vtable = m_data.size();
+    const int vtableSize = 4 + 2 * fieldCount;
+    m_data.append(QByteArray(vtableSize, '\0'));
+
+    // Write the table, the first field is placed at an 8-byte boundary
+    pad(8, 4);
+    const int table = m_data.size();
+    WRITE_LE<qint32>(m_data, table - vtable);
+    QVector<int> positions;
+    for (int i = 0; i < slots.count(); ++i)
+    {
+      const auto &slot = slots.at(i);
+      positions.append(m_data.size());
+      if (slot.size == 1)
+        m_data.append(static_cast<char>(slot.value));
+      else if (slot.size == 2)
+        WRITE_LE<quint16>(m_data, static_cast<quint16>(slot.value));
+      else if (slot.size == 4)
+        WRITE_LE<quint32>(m_data, static_cast<quint32>(slot.value));
+      else
+        WRITE_LE<quint64>(m_data, slot.value);
+    }
+
+    // Fill the vtable
+    QByteArray entries;
+    WRITE_LE<quint16>(entries, static_cast<quint16>(vtableSize));
+    WRITE_LE<quint16>(entries, static_cast<quint16>(m_data.size() - table));
+    entries.append(QByteArray(2 * fieldCount, '\0'));
+    for (int i = 0; i < slots.count(); ++i)
+    {
+      const auto le = qToLittleEndian<quint16>(positions.at(i) - table);
+      memcpy(entries.data() + 4 + 2 * slots.at(i).id, &le, sizeof(le));
+    }
+
+    memcpy(m_data.data() + vtable, entries.constData(), vtableSize);
+
+    // Write the objects referenced by the table
+    for (int i = 0; i < slots.count(); ++i)
+    {
+      if (slots.at(i).child >= 0)
+        link(positions.at(i), write(slots.at(i).child));
+    }
+
+    return table;
+  }
+
+private:
+  QByteArray m_data;
+  QVector<Node> m_nodes;
+};
+
+/**
+ * Declares a schema field with the given @a name & data type, the type is
+ * given as the @a type identifier of the @c Type union & its @a typeTable.
+ */
+static int ARROW_FIELD(FlatBuilder &fb, const QString &name, const int type,
+                       const int typeTable)
+{
+  const int field = fb.table();
+  fb.offset(field, 0, fb.string(name.toUtf8()));
+  fb.scalar(field, 1, 1, 1);
+  fb.scalar(field, 2, 1, static_cast<quint64>(type));
+  fb.offset(field, 3, typeTable);
+  fb.offset(field, 5, fb.vector(QVector<int>()));
+  return field;
+}
+
+/**
+ * Generates the metadata of a message with the given @a header union type &
+ * @a header table, followed by a body of @a bodyLength bytes.
+ */
+static QByteArray ARROW_MESSAGE(FlatBuilder &fb, const int headerType,
+                                const int header, const qint64 bodyLength)
+{
+  const int message = fb.table();
+  fb.scalar(message, 0, 2, ARROW_METADATA_V5);
+  fb.scalar(message, 1, 1, static_cast<quint64>(headerType));
+  fb.offset(message, 2, header);
+  fb.scalar(message, 3, 8, static_cast<quint64>(bodyLength));
+  return fb.finish(message);
+}
+
+/**
+ * Constructor function
+ */
+CSV::ArrowWriter::ArrowWriter() {}
+
+/**
+ * Destructor function, writes pending rows & the end-of-stream marker
+ */
+CSV::ArrowWriter::~ArrowWriter()
+{
+  close();
+}
+
+/**
+ * Returns the native file handle of the stream, or -1 if it is not open
+ */
+int CSV::ArrowWriter::handle() const
+{
+  return m_file.handle();
+}
+
+/**
+ * Returns @c true if the stream is open for writing
+ */
+bool CSV::ArrowWriter::isOpen() const
+{
+  return m_file.isOpen();
+}
+
+/**
+ * Returns the path of the stream
+ */
+QString CSV::ArrowWriter::fileName() const
+{
+  return m_file.fileName();
+}
+
+/**
+ * Creates a stream at the given @a path & writes its schema message, the
+ * project @a title is stored in the metadata of the schema.
+ *
+ * The type of each column is obtained from the values of the first frame
+ * (@a sample): columns with numeric values are stored as doubles, all other
+ * columns are stored as text.
+ */
+bool CSV::ArrowWriter::open(const QString &path, const QString &title,
+                            const QStringList &titles,
+                            const QStringList &sample)
+{
+  // Close previous stream
+  close();
+
+  // Open file
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly))
+    return false;
+
+  // Declare the timestamp column
+  FlatBuilder fb;
+  QVector<int> fields;
+  const int timestamp = fb.table();
+  fb.scalar(timestamp, 0, 2, ARROW_UNIT_MILLISECOND);
+  fb.offset(timestamp, 1, fb.string("UTC"));
+  fields.append(
+      ARROW_FIELD(fb, "RX Date/Time", ARROW_TYPE_TIMESTAMP, timestamp));
+
+  // Declare the dataset columns
+  for (int i = 0; i < titles.count(); ++i)
+  {
+    bool numeric = false;
+    if (i < sample.count())
+      sample.at(i).toDouble(&numeric);
+
+    m_types.append(numeric ? BinaryColumnType::Float64
+                           : BinaryColumnType::Text);
+
+    const int type = fb.table();
+    if (numeric)
+      fb.scalar(type, 0, 2, ARROW_PRECISION_DOUBLE);
+
+    fields.append(ARROW_FIELD(
+        fb, titles.at(i),
+        numeric ? ARROW_TYPE_FLOATING_POINT : ARROW_TYPE_UTF8, type));
+  }
+
+  // Store the project title in the schema metadata
+  const int keyValue = fb.table();
+  fb.offset(keyValue, 0, fb.string("title"));
+  fb.offset(keyValue, 1, fb.string(title.toUtf8()));
+
+  // Write the schema message
+  const int schema = fb.table();
+  fb.scalar(schema, 0, 2, 0);
+  fb.offset(schema, 1, fb.vector(fields));
+  fb.offset(schema, 2, fb.vector(QVector<int>{keyValue}));
+  writeMessage(ARROW_MESSAGE(fb, ARROW_HEADER_SCHEMA, schema, 0),
+               QByteArray());
+
+  return m_file.error() == QFileDevice::NoError;
+}
+
+/**
+ * Registers a new row with the given reception @a timestamp (in milliseconds
+ * since epoch) & @a fields.
+ */
+void CSV::ArrowWriter::append(const qint64 timestamp,
+                              const QStringList &fields)
+{
+  if (!isOpen())
+    return;
+
+  m_pending.append(fields);
+  m_timestamps.append(timestamp);
+  if (m_pending.count() >= MAX_BATCH_ROWS)
+    flush();
+}
+
+/**
+ * Writes all the pending rows to the stream as a new record batch
+ */
+void CSV::ArrowWriter::flush()
+{
+  // Nothing to write
+  if (!isOpen() || m_pending.isEmpty())
+    return;
+
+  // Initialize parameters
+  QByteArray body;
+  QByteArray nodes;
+  QByteArray buffers;
+  const int rows = m_pending.count();
+  auto addNode = [&](const qint64 nullCount) {
+    WRITE_LE<qint64>(nodes, rows);
+    WRITE_LE<qint64>(nodes, nullCount);
+  };
+  auto addBuffer = [&](const QByteArray &data) {
+    WRITE_LE<qint64>(buffers, body.size());
+    WRITE_LE<qint64>(buffers, data.size());
+    body.append(data);
+    PAD(body);
+  };
+
+  // Write timestamp column
+  QByteArray values;
+  values.reserve(rows * 8);
+  for (int r = 0; r < rows; ++r)
+    WRITE_LE<qint64>(values, m_timestamps.at(r));
+
+  addNode(0);
+  addBuffer(QByteArray());
+  addBuffer(values);
+
+  // Write value columns
+  for (int c = 0; c < m_types.count(); ++c)
+  {
+    // Floating point column, values that are not numbers are stored as nulls
+    if (m_types.at(c) == BinaryColumnType::Float64)
+    {
+      qint64 nulls = 0;
+      values.resize(0);
+      QByteArray validity((rows + 7) / 8, '\0');
+      for (int r = 0; r < rows; ++r)
+      {
+        bool ok = false;
+        double value = 0;
+        const auto &fields = m_pending.at(r);
+        if (c < fields.count())
+          value = fields.at(c).toDouble(&ok);
+
+        if (ok)
+          validity[r / 8] = static_cast<char>(validity.at(r / 8) | (1 << r % 8));
+        else
+          ++nulls;
+
+        quint64 bits;
+        value = ok ? value : 0;
+        memcpy(&bits, &value, sizeof(bits));
+        WRITE_LE<quint64>(values, bits);
+      }
+
+      addNode(nulls);
+      addBuffer(nulls > 0 ? validity : QByteArray());
+      addBuffer(values);
+    }
+
+    // Text column, strings are stored in a single data buffer
+    else
+    {
+      QByteArray data;
+      QByteArray offsets;
+      WRITE_LE<qint32>(offsets, 0);
+      for (int r = 0; r < rows; ++r)
+      {
+        const auto &fields = m_pending.at(r);
+        if (c < fields.count())
+          data.append(fields.at(c).toUtf8());
+
+        WRITE_LE<qint32>(offsets, data.size());
+      }
+
+      addNode(0);
+      addBuffer(QByteArray());
+      addBuffer(offsets);
+      addBuffer(data);
+    }
+  }
+
+  // Write the record batch message
+  FlatBuilder fb;
+  const int batch = fb.table();
+  fb.scalar(batch, 0, 8, static_cast<quint64>(rows));
+  fb.offset(batch, 1, fb.structs(nodes, m_types.count() + 1));
+  fb.offset(batch, 2, fb.structs(buffers, buffers.size() / 16));
+  writeMessage(
+      ARROW_MESSAGE(fb, ARROW_HEADER_RECORD_BATCH, batch, body.size()),
+      body);
+  m_file.flush();
+
+  // Reset buffers
+  m_pending.clear();
+  m_timestamps.clear();
+}
+
+/**
+ * Writes the pending rows & the end-of-stream marker, and closes the file
+ */
+void CSV::ArrowWriter::close()
+{
+  if (isOpen())
+  {
+    flush();
+
+    QByteArray marker;
+    WRITE_LE<quint32>(marker, ARROW_CONTINUATION);
+    WRITE_LE<quint32>(marker, 0);
+    m_file.write(marker);
+    m_file.close();
+  }
+
+  m_types.clear();
+  m_pending.clear();
+  m_timestamps.clear();
+}
+
+/**
+ * Writes an encapsulated message with the given flatbuffer @a metadata
+ * (padded to 8 bytes) & @a body to the stream.
+ */
+void CSV::ArrowWriter::writeMessage(const QByteArray &metadata,
+                                    const QByteArray &body)
+{
+  QByteArray prefix;
+  WRITE_LE<quint32>(prefix, ARROW_CONTINUATION);
+  WRITE_LE<qint32>(prefix, metadata.size());
+  m_file.write(prefix);
+  m_file.write(metadata);
+  m_file.write(body);
+}
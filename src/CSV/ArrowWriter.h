@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QVector>
+#include <QStringList>
+
+#include <CSV/BinaryFormat.h>
+
+namespace CSV
+{
+/**
+ * @brief The ArrowWriter class
+ *
+ * Writes frames to an Apache Arrow IPC stream (@c *.arrows file), which can
+ * be loaded with @c pyarrow.ipc.open_stream() & converted to a data frame or
+ * to a Parquet file without parsing text.
+ *
+ * The stream starts with a schema message that declares a
+ * @c timestamp[ms, UTC] column with the reception time of each row, followed
+ * by one column per dataset. The type of each dataset column is obtained from
+ * the values of the first frame: numeric columns are stored as nullable
+ * @c float64 values (values that cannot be converted are stored as nulls),
+ * all other columns are stored as @c utf8 strings.
+ *
+ * Rows are buffered in memory & written as a record batch when @c flush() is
+ * called or when the maximum number of rows per batch is reached. The
+ * end-of-stream marker is written by @c close(), streams that were not closed
+ * properly can still be read up to the last record batch.
+ *
+ * The flatbuffer metadata of the messages is generated by a minimal encoder,
+ * so no Arrow library is required.
+ */
+class ArrowWriter
+{
+public:
+  ArrowWriter();
+  ~ArrowWriter();
+
+  int handle() const;
+  bool isOpen() const;
+  QString fileName() const;
+
+  bool open(const QString &path, const QString &title,
+            const QStringList &titles, const QStringList &sample);
+  void append(const qint64 timestamp, const QStringList &fields);
+  void flush();
+  void close();
+
+private:
+  void writeMessage(const QByteArray &metadata, const QByteArray &body);
+
+private:
+  QFile m_file;
+  QVector<qint64> m_timestamps;
+  QVector<QStringList> m_pending;
+  QVector<BinaryColumnType> m_types;
+};
+} // namespace CSV
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+namespace CSV
+{
+/**
+ * @brief Binary recording format
+ *
+ * Serial Studio recordings (@c *.ssrec files) store the frames received from
+ * the device in a columnar layout that can be memory-mapped by the player.
+ * All integers & floating point values are stored in little-endian order.
+ *
+ * The file starts with a header:
+ * - 8 bytes:  @c BINARY_MAGIC
+ * - uint32:   format version (@c BINARY_VERSION)
+ * - uint32:   length of the schema in bytes
+ * - schema:   UTF-8 JSON object with the project title, the frame separator
+ *             and the title & type of each column
+ *
+ * The header is followed by any number of chunks, each chunk has a header:
+ * - uint32:   @c BINARY_CHUNK_MAGIC
+ * - uint32:   number of rows in the chunk (R)
+ * - uint32:   number of value columns (C)
+ * - uint32:   size of the text heap in bytes (H)
+ * - uint64:   total size of the chunk, including the header
+ *
+ * And a body:
+ * - R x int64: reception time of each row (milliseconds since epoch, UTC)
+ * - C x R x 8 bytes: values of each column, stored one column after the other.
+ *   @c Float64 columns store doubles, @c Text columns store an uint32 offset
+ *   and an uint32 length that point to the text heap of the chunk
+ * - H bytes:  text heap
+ *
+ * When the recording is closed, a chunk index is appended to the file:
+ * - N x (uint64 chunk offset, uint64 first row of the chunk)
+ * - uint32:   @c BINARY_INDEX_MAGIC
+ * - uint32:   number of chunks (N)
+ * - uint64:   offset of the index
+ * - uint64:   total number of rows
+ *
+ * Recordings that were not closed properly have no index, in that case the
+ * index is rebuilt by jumping from one chunk header to the next one.
+ */
+static const char BINARY_MAGIC[8] = {'S', 'S', 'R', 'E', 'C', 'O', 'R', 'D'};
+static const quint32 BINARY_VERSION = 1;
+static const quint32 BINARY_CHUNK_MAGIC = 0x4B4E4843;
+static const quint32 BINARY_INDEX_MAGIC = 0x58444E49;
+static const int BINARY_HEADER_SIZE = 16;
+static const int BINARY_CHUNK_HEADER_SIZE = 24;
+static const int BINARY_INDEX_ENTRY_SIZE = 16;
+static const int BINARY_TRAILER_SIZE = 24;
+
+/**
+ * Data type of a value column of a binary recording
+ */
+enum class BinaryColumnType
+{
+  Float64,
+  Text
+};
+} // namespace CSV
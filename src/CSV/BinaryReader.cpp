@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QLocale>
+#include <QtEndian>
+#include <QtNumeric>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <CSV/BinaryReader.h>
+
+/**
+ * Reads a little-endian value of type @c T from the given memory location
+ */
+template<typename T>
+static T READ_LE(const uchar *data)
+{
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return qFromLittleEndian(value);
+}
+
+/**
+ * Reads a little-endian double from the given memory location
+ */
+static double READ_DOUBLE(const uchar *data)
+{
+  double value;
+  const auto bits = READ_LE<quint64>(data);
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/**
+ * Constructor function
+ */
+CSV::BinaryReader::BinaryReader()
+  : m_rows(0)
+  , m_size(0)
+  , m_map(Q_NULLPTR)
+  , m_dataOffset(0)
+{
+}
+
+/**
+ * Destructor function, unmaps the file
+ */
+CSV::BinaryReader::~BinaryReader()
+{
+  close();
+}
+
+/**
+ * Returns @c true if a recording is open for reading
+ */
+bool CSV::BinaryReader::isOpen() const
+{
+  return m_map != Q_NULLPTR;
+}
+
+/**
+ * Returns the number of rows stored in the recording
+ */
+int CSV::BinaryReader::rowCount() const
+{
+  return m_rows;
+}
+
+/**
+ * Returns the number of value columns (without the timestamp column)
+ */
+int CSV::BinaryReader::columnCount() const
+{
+  return m_types.count();
+}
+
+/**
+ * Returns the project title stored in the schema
+ */
+QString CSV::BinaryReader::title() const
+{
+  return m_title;
+}
+
+/**
+ * Returns the path of the recording
+ */
+QString CSV::BinaryReader::fileName() const
+{
+  return m_file.fileName();
+}
+
+/**
+ * Returns the frame separator stored in the schema
+ */
+QString CSV::BinaryReader::separator() const
+{
+  return m_separator;
+}
+
+/**
+ * Returns the titles of the value columns
+ */
+QStringList CSV::BinaryReader::titles() const
+{
+  return m_titles;
+}
+
+/**
+ * Returns the reception time (in milliseconds since epoch) of the given
+ * @a row, or -1 if the row does not exist.
+ */
+qint64 CSV::BinaryReader::timestamp(const int row) const
+{
+  const int index = chunkAt(row);
+  if (index < 0)
+    return -1;
+
+  const auto &chunk = m_chunks.at(index);
+  const int local = row - chunk.firstRow;
+  const auto data = chunk.data + BINARY_CHUNK_HEADER_SIZE;
+  return READ_LE<qint64>(data + 8ull * local);
+}
+
+/**
+ * Returns the value stored at the given @a row & @a column as a string, or an
+ * empty string if the cell does not exist.
+ */
+QString CSV::BinaryReader::value(const int row, const int column) const
+{
+  // Validate arguments
+  const int index = chunkAt(row);
+  if (index < 0 || column < 0 || column >= m_types.count())
+    return QString();
+
+  // Column not present in chunk
+  const auto &chunk = m_chunks.at(index);
+  if (static_cast<quint32>(column) >= chunk.columns)
+    return QString();
+
+  // Get location of the cell
+  const quint64 rows = chunk.rows;
+  const quint64 local = row - chunk.firstRow;
+  const auto body = chunk.data + BINARY_CHUNK_HEADER_SIZE;
+  const auto cell = body + 8ull * rows + 8ull * (column * rows + local);
+
+  // Decode number
+  if (m_types.at(column) == BinaryColumnType::Float64)
+  {
+    const auto value = READ_DOUBLE(cell);
+    if (qIsNaN(value))
+      return QString();
+
+    return QString::number(value, 'g', QLocale::FloatingPointShortest);
+  }
+
+  // Decode text
+  const auto heap = body + 8ull * rows * (chunk.columns + 1);
+  const auto offset = READ_LE<quint32>(cell);
+  const auto length = READ_LE<quint32>(cell + 4);
+  if (static_cast<quint64>(offset) + length > chunk.heapSize)
+    return QString();
+
+  return QString::fromUtf8(reinterpret_cast<const char *>(heap + offset),
+                           static_cast<int>(length));
+}
+
+/**
+ * Returns all the values stored at the given @a row
+ */
+QStringList CSV::BinaryReader::values(const int row) const
+{
+  QStringList list;
+  for (int i = 0; i < columnCount(); ++i)
+    list.append(value(row, i));
+
+  return list;
+}
+
+/**
+ * Opens & memory-maps the recording at the given @a path
+ */
+bool CSV::BinaryReader::open(const QString &path)
+{
+  // Close previous recording
+  close();
+
+  // Open & map the file
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly))
+    return false;
+
+  m_size = static_cast<quint64>(m_file.size());
+  if (m_size >= BINARY_HEADER_SIZE)
+    m_map = m_file.map(0, m_file.size());
+
+  // Read schema & chunk index
+  if (m_map && readSchema())
+  {
+    if (!readIndex())
+      scanChunks();
+
+    return true;
+  }
+
+  // Invalid file
+  close();
+  return false;
+}
+
+/**
+ * Unmaps the file & resets the internal state of the reader
+ */
+void CSV::BinaryReader::close()
+{
+  if (m_map)
+    m_file.unmap(m_map);
+
+  m_file.close();
+
+  m_rows = 0;
+  m_size = 0;
+  m_dataOffset = 0;
+  m_map = Q_NULLPTR;
+
+  m_title.clear();
+  m_types.clear();
+  m_titles.clear();
+  m_chunks.clear();
+  m_separator.clear();
+}
+
+/**
+ * Validates the file header & reads the schema of the recording
+ */
+bool CSV::BinaryReader::readSchema()
+{
+  // Validate magic & version
+  if (memcmp(m_map, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+    return false;
+  if (READ_LE<quint32>(m_map + 8) != BINARY_VERSION)
+    return false;
+
+  // Validate schema length
+  const quint64 length = READ_LE<quint32>(m_map + 12);
+  if (BINARY_HEADER_SIZE + length > m_size)
+    return false;
+
+  // Parse schema
+  QJsonParseError error;
+  const auto json = QByteArray::fromRawData(
+      reinterpret_cast<const char *>(m_map + BINARY_HEADER_SIZE),
+      static_cast<int>(length));
+  const auto document = QJsonDocument::fromJson(json, &error);
+  if (error.error != QJsonParseError::NoError)
+    return false;
+
+  // Read project information
+  const auto schema = document.object();
+  m_title = schema.value("title").toString();
+  m_separator = schema.value("separator").toString();
+
+  // Read columns
+  const auto columns = schema.value("columns").toArray();
+  for (int i = 0; i < columns.count(); ++i)
+  {
+    const auto column = columns.at(i).toObject();
+    m_titles.append(column.value("title").toString());
+    if (column.value("type").toString() == "float64")
+      m_types.append(BinaryColumnType::Float64);
+    else
+      m_types.append(BinaryColumnType::Text);
+  }
+
+  // Chunks start after the schema
+  m_dataOffset = BINARY_HEADER_SIZE + length;
+  return true;
+}
+
+/**
+ * Reads the chunk index written at the end of the file. Returns @c false if
+ * the index is missing or invalid.
+ */
+bool CSV::BinaryReader::readIndex()
+{
+  // Check that the trailer fits in the file
+  if (m_size < m_dataOffset + BINARY_TRAILER_SIZE)
+    return false;
+
+  // Read trailer
+  const auto trailer = m_map + m_size - BINARY_TRAILER_SIZE;
+  if (READ_LE<quint32>(trailer) != BINARY_INDEX_MAGIC)
+    return false;
+
+  const quint64 count = READ_LE<quint32>(trailer + 4);
+  const auto offset = READ_LE<quint64>(trailer + 8);
+  const auto rows = READ_LE<quint64>(trailer + 16);
+
+  // Validate index location
+  const auto end = m_size - BINARY_TRAILER_SIZE;
+  if (offset < m_dataOffset || offset + count * BINARY_INDEX_ENTRY_SIZE != end)
+    return false;
+
+  // Register chunks
+  for (quint64 i = 0; i < count; ++i)
+  {
+    const auto entry = m_map + offset + i * BINARY_INDEX_ENTRY_SIZE;
+    if (!addChunk(READ_LE<quint64>(entry)))
+    {
+      m_rows = 0;
+      m_chunks.clear();
+      return false;
+    }
+  }
+
+  // Validate row count
+  if (static_cast<quint64>(m_rows) != rows)
+  {
+    m_rows = 0;
+    m_chunks.clear();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Rebuilds the chunk index by jumping from one chunk header to the next one,
+ * this is used for recordings that were not closed properly.
+ */
+void CSV::BinaryReader::scanChunks()
+{
+  m_rows = 0;
+  m_chunks.clear();
+
+  quint64 offset = m_dataOffset;
+  while (addChunk(offset))
+    offset += READ_LE<quint64>(m_map + offset + 16);
+}
+
+/**
+ * Validates the chunk located at the given @a offset & registers it. Returns
+ * @c false if the chunk is invalid or truncated.
+ */
+bool CSV::BinaryReader::addChunk(const quint64 offset)
+{
+  // Check that the chunk header fits in the file
+  if (offset < m_dataOffset || offset + BINARY_CHUNK_HEADER_SIZE > m_size)
+    return false;
+
+  // Read chunk header
+  Chunk chunk;
+  chunk.data = m_map + offset;
+  if (READ_LE<quint32>(chunk.data) != BINARY_CHUNK_MAGIC)
+    return false;
+
+  chunk.firstRow = m_rows;
+  chunk.rows = READ_LE<quint32>(chunk.data + 4);
+  chunk.columns = READ_LE<quint32>(chunk.data + 8);
+  chunk.heapSize = READ_LE<quint32>(chunk.data + 12);
+  const auto size = READ_LE<quint64>(chunk.data + 16);
+
+  // Validate chunk size
+  const quint64 body = 8ull * chunk.rows * (chunk.columns + 1ull);
+  if (chunk.rows == 0 || size < BINARY_CHUNK_HEADER_SIZE + body + chunk.heapSize
+      || offset + size > m_size)
+    return false;
+
+  // Register chunk
+  m_rows += chunk.rows;
+  m_chunks.append(chunk);
+  return true;
+}
+
+/**
+ * Returns the index of the chunk that contains the given @a row, or -1 if the
+ * row does not exist.
+ */
+int CSV::BinaryReader::chunkAt(const int row) const
+{
+  if (row < 0 || row >= m_rows)
+    return -1;
+
+  // Binary search over the first row of each chunk
+  int low = 0;
+  int high = m_chunks.count() - 1;
+  while (low < high)
+  {
+    const int mid = (low + high + 1) / 2;
+    if (m_chunks.at(mid).firstRow <= row)
+      low = mid;
+    else
+      high = mid - 1;
+  }
+
+  return low;
+}
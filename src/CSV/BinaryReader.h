@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QVector>
+#include <QStringList>
+
+#include <CSV/BinaryFormat.h>
+
+namespace CSV
+{
+/**
+ * @brief The BinaryReader class
+ *
+ * Provides random access to the rows of a binary recording (see
+ * @c CSV/BinaryFormat.h).
+ *
+ * The file is memory-mapped & only the chunk index is loaded when the
+ * recording is opened, values are decoded directly from the mapped memory
+ * when they are requested.
+ */
+class BinaryReader
+{
+public:
+  BinaryReader();
+  ~BinaryReader();
+
+  bool isOpen() const;
+  int rowCount() const;
+  int columnCount() const;
+  QString title() const;
+  QString fileName() const;
+  QString separator() const;
+  QStringList titles() const;
+
+  qint64 timestamp(const int row) const;
+  QString value(const int row, const int column) const;
+  QStringList values(const int row) const;
+
+  bool open(const QString &path);
+  void close();
+
+private:
+  bool readSchema();
+  bool readIndex();
+  void scanChunks();
+  bool addChunk(const quint64 offset);
+  int chunkAt(const int row) const;
+
+private:
+  struct Chunk
+  {
+    const uchar *data;
+    int firstRow;
+    quint32 rows;
+    quint32 columns;
+    quint32 heapSize;
+  };
+
+  QFile m_file;
+  int m_rows;
+  quint64 m_size;
+  uchar *m_map;
+  quint64 m_dataOffset;
+
+  QString m_title;
+  QString m_separator;
+  QStringList m_titles;
+  QVector<Chunk> m_chunks;
+  QVector<BinaryColumnType> m_types;
+};
+} // namespace CSV
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QtEndian>
+#include <QtNumeric>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <CSV/BinaryWriter.h>
+
+/**
+ * Maximum number of rows stored in a single chunk
+ */
+static const int MAX_CHUNK_ROWS = 4096;
+
+/**
+ * Appends the given @a value to the @a buffer in little-endian order
+ */
+template<typename T>
+static void WRITE_LE(QByteArray &buffer, const T value)
+{
+  const T le = qToLittleEndian(value);
+  buffer.append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+/**
+ * Appends the given double @a value to the @a buffer in little-endian order
+ */
+static void WRITE_DOUBLE(QByteArray &buffer, const double value)
+{
+  quint64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  WRITE_LE<quint64>(buffer, bits);
+}
+
+/**
+ * Constructor function
+ */
+CSV::BinaryWriter::BinaryWriter()
+  : m_rows(0)
+{
+}
+
+/**
+ * Destructor function, writes pending rows & the chunk index
+ */
+CSV::BinaryWriter::~BinaryWriter()
+{
+  close();
+}
+
+/**
+ * Returns the native file handle of the recording, or -1 if it is not open
+ */
+int CSV::BinaryWriter::handle() const
+{
+  return m_file.handle();
+}
+
+/**
+ * Returns @c true if the recording is open for writing
+ */
+bool CSV::BinaryWriter::isOpen() const
+{
+  return m_file.isOpen();
+}
+
+/**
+ * Returns the path of the recording
+ */
+QString CSV::BinaryWriter::fileName() const
+{
+  return m_file.fileName();
+}
+
+/**
+ * Creates a recording at the given @a path & writes its header.
+ *
+ * The type of each column is obtained from the values of the first frame
+ * (@a sample): columns with numeric values are stored as doubles, all other
+ * columns are stored as text.
+ */
+bool CSV::BinaryWriter::open(const QString &path, const QString &title,
+                             const QString &separator,
+                             const QStringList &titles,
+                             const QStringList &sample)
+{
+  // Close previous recording
+  close();
+
+  // Open file
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::WriteOnly))
+    return false;
+
+  // Obtain column types
+  QJsonArray columns;
+  for (int i = 0; i < titles.count(); ++i)
+  {
+    bool numeric = false;
+    if (i < sample.count())
+      sample.at(i).toDouble(&numeric);
+
+    m_types.append(numeric ? BinaryColumnType::Float64
+                           : BinaryColumnType::Text);
+
+    QJsonObject column;
+    column.insert("title", titles.at(i));
+    column.insert("type", numeric ? "float64" : "text");
+    columns.append(column);
+  }
+
+  // Generate schema
+  QJsonObject schema;
+  schema.insert("title", title);
+  schema.insert("columns", columns);
+  schema.insert("separator", separator);
+  auto json = QJsonDocument(schema).toJson(QJsonDocument::Compact);
+
+  // Write header
+  QByteArray header;
+  header.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  WRITE_LE<quint32>(header, BINARY_VERSION);
+  WRITE_LE<quint32>(header, static_cast<quint32>(json.size()));
+  header.append(json);
+  return m_file.write(header) == header.size();
+}
+
+/**
+ * Registers a new row with the given reception @a timestamp (in milliseconds
+ * since epoch) & @a fields.
+ */
+void CSV::BinaryWriter::append(const qint64 timestamp,
+                               const QStringList &fields)
+{
+  if (!isOpen())
+    return;
+
+  m_pending.append(fields);
+  m_timestamps.append(timestamp);
+  if (m_pending.count() >= MAX_CHUNK_ROWS)
+    flush();
+}
+
+/**
+ * Writes all the pending rows to the file as a new chunk
+ */
+void CSV::BinaryWriter::flush()
+{
+  // Nothing to write
+  if (!isOpen() || m_pending.isEmpty())
+    return;
+
+  // Get chunk parameters
+  const int rows = m_pending.count();
+  const int columns = m_types.count();
+  const quint64 bodySize = 8ull * rows * (columns + 1);
+
+  // Write timestamp column
+  QByteArray heap;
+  QByteArray body;
+  body.reserve(static_cast<int>(bodySize));
+  for (int r = 0; r < rows; ++r)
+    WRITE_LE<qint64>(body, m_timestamps.at(r));
+
+  // Write value columns
+  for (int c = 0; c < columns; ++c)
+  {
+    const auto type = m_types.at(c);
+    for (int r = 0; r < rows; ++r)
+    {
+      const auto &fields = m_pending.at(r);
+      const auto field = c < fields.count() ? fields.at(c) : QString();
+
+      if (type == BinaryColumnType::Float64)
+      {
+        bool ok;
+        const auto value = field.toDouble(&ok);
+        WRITE_DOUBLE(body, ok ? value : qQNaN());
+      }
+
+      else
+      {
+        const auto utf8 = field.toUtf8();
+        WRITE_LE<quint32>(body, static_cast<quint32>(heap.size()));
+        WRITE_LE<quint32>(body, static_cast<quint32>(utf8.size()));
+        heap.append(utf8);
+      }
+    }
+  }
+
+  // Write chunk header
+  QByteArray header;
+  WRITE_LE<quint32>(header, BINARY_CHUNK_MAGIC);
+  WRITE_LE<quint32>(header, static_cast<quint32>(rows));
+  WRITE_LE<quint32>(header, static_cast<quint32>(columns));
+  WRITE_LE<quint32>(header, static_cast<quint32>(heap.size()));
+  WRITE_LE<quint64>(header, BINARY_CHUNK_HEADER_SIZE + bodySize + heap.size());
+
+  // Register chunk in the index & write it
+  m_chunkRows.append(m_rows);
+  m_chunkOffsets.append(static_cast<quint64>(m_file.pos()));
+  m_file.write(header);
+  m_file.write(body);
+  m_file.write(heap);
+  m_file.flush();
+
+  // Reset buffers
+  m_rows += rows;
+  m_pending.clear();
+  m_timestamps.clear();
+}
+
+/**
+ * Writes the pending rows & the chunk index, and closes the file
+ */
+void CSV::BinaryWriter::close()
+{
+  if (isOpen())
+  {
+    // Write pending rows
+    flush();
+
+    // Write chunk index
+    QByteArray index;
+    const auto offset = static_cast<quint64>(m_file.pos());
+    for (int i = 0; i < m_chunkOffsets.count(); ++i)
+    {
+      WRITE_LE<quint64>(index, m_chunkOffsets.at(i));
+      WRITE_LE<quint64>(index, m_chunkRows.at(i));
+    }
+
+    // Write trailer
+    WRITE_LE<quint32>(index, BINARY_INDEX_MAGIC);
+    WRITE_LE<quint32>(index, static_cast<quint32>(m_chunkOffsets.count()));
+    WRITE_LE<quint64>(index, offset);
+    WRITE_LE<quint64>(index, m_rows);
+    m_file.write(index);
+    m_file.close();
+  }
+
+  // Reset state
+  m_rows = 0;
+  m_types.clear();
+  m_pending.clear();
+  m_chunkRows.clear();
+  m_timestamps.clear();
+  m_chunkOffsets.clear();
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QVector>
+#include <QStringList>
+
+#include <CSV/BinaryFormat.h>
+
+namespace CSV
+{
+/**
+ * @brief The BinaryWriter class
+ *
+ * Writes frames to a binary recording (see @c CSV/BinaryFormat.h).
+ *
+ * Rows are buffered in memory & written as a chunk when @c flush() is called
+ * or when the maximum number of rows per chunk is reached. The chunk index is
+ * written by @c close().
+ */
+class BinaryWriter
+{
+public:
+  BinaryWriter();
+  ~BinaryWriter();
+
+  int handle() const;
+  bool isOpen() const;
+  QString fileName() const;
+
+  bool open(const QString &path, const QString &title,
+            const QString &separator, const QStringList &titles,
+            const QStringList &sample);
+  void append(const qint64 timestamp, const QStringList &fields);
+  void flush();
+  void close();
+
+private:
+  QFile m_file;
+  quint64 m_rows;
+  QVector<qint64> m_timestamps;
+  QVector<QStringList> m_pending;
+  QVector<BinaryColumnType> m_types;
+  QVector<quint64> m_chunkRows;
+  QVector<quint64> m_chunkOffsets;
+};
+} // namespace CSV
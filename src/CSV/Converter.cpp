@@ -0,0 +1,622 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QCoreApplication>
+#include <QRegularExpression>
+
+#include <CSV/Export.h>
+#include <CSV/Converter.h>
+#include <CSV/CsvReader.h>
+#include <CSV/Gzip.h>
+#include <CSV/MarkerIndex.h>
+#include <CSV/RecordingSchema.h>
+#include <CSV/BinaryReader.h>
+#include <IO/Manager.h>
+#include <IO/FrameReader.h>
+#include <IO/RawCaptureFile.h>
+#include <JSON/Frame.h>
+#include <JSON/Generator.h>
+#include <JSON/FrameRouter.h>
+#include <JSON/FieldSplitter.h>
+#include <Misc/Utilities.h>
+#include <Misc/Diagnostics.h>
+#include <Project/Model.h>
+#include <Project/FrameParser.h>
+
+/**
+ * Number of rows handed to the export worker at once
+ */
+static const int BATCH_SIZE = 4096;
+
+/**
+ * Constructor function
+ */
+CSV::Converter::Converter(const ConverterOptions &options)
+  : m_failed(0)
+  , m_finished(0)
+  , m_rows(0)
+  , m_options(options)
+{
+  m_settings.format = Export::CsvFormat;
+  m_settings.compress = false;
+}
+
+/**
+ * Validates the options, loads the project (if any) & starts converting the
+ * input files in the thread pool. Returns @c false if the conversion cannot
+ * be started.
+ */
+bool CSV::Converter::start()
+{
+  // Print messages to the console
+  Misc::Utilities::setHeadless(true);
+
+  // Validate inputs
+  if (m_options.inputs.isEmpty())
+  {
+    qCritical() << "No input files specified for conversion";
+    return false;
+  }
+
+  // Get output format
+  const auto format = m_options.format.toLower();
+  m_settings.suffix = format;
+  if (format == QStringLiteral("csv"))
+    m_settings.format = Export::CsvFormat;
+  else if (format == QStringLiteral("csv.gz"))
+  {
+    m_settings.compress = true;
+    m_settings.format = Export::CsvFormat;
+  }
+  else if (format == QStringLiteral("ssrec"))
+    m_settings.format = Export::BinaryFormat;
+  else if (format == QStringLiteral("arrows"))
+    m_settings.format = Export::ArrowFormat;
+  else
+  {
+    qCritical() << "Unsupported output format" << m_options.format
+                << "(use csv, csv.gz, ssrec or arrows)";
+    return false;
+  }
+
+  // Create the output directory
+  if (!m_options.outputPath.isEmpty() && !QDir().mkpath(m_options.outputPath))
+  {
+    qCritical() << "Cannot create output directory" << m_options.outputPath;
+    return false;
+  }
+
+  // Load the project used to re-process raw captures
+  if (!m_options.project.isEmpty() && !loadProject())
+    return false;
+
+  // Create the diagnostics counters from the main thread, the frame readers
+  // of the jobs report their timings to them
+  (void)Misc::Diagnostics::instance();
+
+  // Configure thread pool
+  const int jobs = m_options.jobs > 0 ? m_options.jobs
+                                      : qMax(1, QThread::idealThreadCount());
+  m_pool.setMaxThreadCount(jobs);
+  qInfo().noquote() << QString("Converting %1 files with %2 jobs")
+                           .arg(m_options.inputs.count())
+                           .arg(jobs);
+
+  // Queue a job for each input file
+  m_clock.start();
+  const auto settings = m_settings;
+  Q_FOREACH (const auto &input, m_options.inputs)
+  {
+    const auto output = outputFile(input);
+    const auto hasProject = !m_options.project.isEmpty();
+    m_pool.start([this, input, output, settings, hasProject] {
+      qint64 rows = -1;
+      QString error;
+      const auto suffix = QFileInfo(input).suffix().toLower();
+      if (suffix == QStringLiteral("ssraw"))
+      {
+        if (hasProject)
+          rows = convertCapture(input, output, settings, &error);
+        else
+          error = QStringLiteral("a project file is required for raw captures");
+      }
+
+      else
+        rows = convertRecording(input, output, settings, &error);
+
+      // Copy the marker index & the schema of the recording
+      if (rows >= 0)
+      {
+        const auto markers = MarkerIndex::indexPath(input);
+        if (QFile::exists(markers))
+        {
+          QFile::remove(MarkerIndex::indexPath(output));
+          QFile::copy(markers, MarkerIndex::indexPath(output));
+        }
+
+        const auto schema = RecordingSchema::schemaPath(input);
+        if (QFile::exists(schema))
+        {
+          QFile::remove(RecordingSchema::schemaPath(output));
+          QFile::copy(schema, RecordingSchema::schemaPath(output));
+        }
+      }
+
+      QMetaObject::invokeMethod(
+          this, [=] { onJobFinished(input, output, rows, error); },
+          Qt::QueuedConnection);
+    });
+  }
+
+  return true;
+}
+
+/**
+ * Prints the result of the conversion of the given @a input file, and quits
+ * the application once all the jobs finished.
+ */
+void CSV::Converter::onJobFinished(const QString &input, const QString &output,
+                                   const qint64 rows, const QString &error)
+{
+  // Print job result
+  ++m_finished;
+  const auto total = m_options.inputs.count();
+  if (rows < 0)
+  {
+    ++m_failed;
+    qCritical().noquote() << QString("[%1/%2] %3: %4")
+                                 .arg(m_finished)
+                                 .arg(total)
+                                 .arg(input, error);
+  }
+
+  else
+  {
+    m_rows += rows;
+    qInfo().noquote() << QString("[%1/%2] %3 -> %4 (%5 rows)")
+                             .arg(m_finished)
+                             .arg(total)
+                             .arg(input, output)
+                             .arg(rows);
+  }
+
+  // Wait for the remaining jobs
+  if (m_finished < total)
+    return;
+
+  // Print summary & quit the application
+  const auto seconds = qMax<qint64>(1, m_clock.elapsed()) / 1000.0;
+  qInfo().noquote() << QString("Converted %1 of %2 files (%3 rows) in %4 s")
+                           .arg(total - m_failed)
+                           .arg(total)
+                           .arg(m_rows)
+                           .arg(seconds, 0, 'f', 2);
+
+  QCoreApplication::exit(m_failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/**
+ * Loads the project file & obtains its framing settings, its parser code & the
+ * columns of the converted files. Projects whose frames are not parsed by the
+ * frame parser script are rejected.
+ *
+ * As in the CSV export, there is one column per dataset, sorted by field, and
+ * datasets that display the same field of the frame are only exported once
+ * (see @c RecordingSchema).
+ */
+bool CSV::Converter::loadProject()
+{
+  // Load the project
+  auto &model = Project::Model::instance();
+  model.openJsonFile(m_options.project);
+  JSON::Frame frame;
+  if (model.jsonFilePath() != m_options.project
+      || !frame.read(JSON::Generator::instance().json()) || !frame.isValid())
+  {
+    qCritical() << "Cannot load project file" << m_options.project;
+    return false;
+  }
+
+  // Projects decoded natively cannot be parsed by the frame parser
+  if (!model.binaryLayout().isEmpty())
+  {
+    qCritical() << "Raw captures of projects with a binary layout cannot be "
+                   "re-processed";
+    return false;
+  }
+
+  // Projects decoded by NMEA or WebAssembly decoders
+  const auto nmea = model.nmea();
+  const auto wasm = model.wasm();
+  if (!nmea.isUndefined() && !nmea.isNull())
+  {
+    qCritical() << "Raw captures of projects that decode NMEA sentences cannot "
+                   "be re-processed";
+    return false;
+  }
+
+  if (!wasm.isUndefined() && !wasm.isNull())
+  {
+    qCritical() << "Raw captures of projects that use a WebAssembly frame "
+                   "parser cannot be re-processed";
+    return false;
+  }
+
+  // Projects that route frame types to different datasets
+  JSON::FrameRouter router;
+  router.compile(frame, model.frameRouting());
+  if (router.isEnabled())
+  {
+    qCritical() << "Raw captures of projects with frame routing cannot be "
+                   "re-processed";
+    return false;
+  }
+
+  // Devices that send JSON, CBOR or MessagePack frames
+  if (JSON::Generator::instance().operationMode() != JSON::Generator::kManual)
+  {
+    qCritical() << "Raw captures can only be re-processed with the frame "
+                   "parser of a project";
+    return false;
+  }
+
+  // Validate the frame parser
+  Project::FrameParser parser;
+  if (parser.load(model.frameParserCode())
+      != Project::FrameParser::LoadStatus::Ok)
+  {
+    qCritical() << "Cannot load the frame parser of the project";
+    return false;
+  }
+
+  // Get columns & titles
+  RecordingSchema schema;
+  schema.build(frame, true);
+  m_settings.schema = schema.toJson();
+  m_settings.titles = schema.titles();
+  for (const auto &column : schema.columns())
+  {
+    const auto &index = column.first();
+    const auto &dataset = frame.getGroup(index.first).getDataset(index.second);
+    m_settings.fields.append(dataset.index() - 1);
+  }
+
+  // Get parser parameters
+  m_settings.title = frame.title();
+  m_settings.code = model.frameParserCode();
+  m_settings.separator = model.separator();
+
+  // Get the framing settings of the project
+  auto &framing = m_settings.framing;
+  framing = IO::Manager::instance().framingSettings();
+  framing.framingMode
+      = static_cast<IO::Manager::FramingMode>(model.framingMode());
+  framing.compression
+      = static_cast<IO::Manager::Compression>(model.compression());
+  framing.heatshrinkWindowBits = model.heatshrinkWindow();
+  framing.heatshrinkLookaheadBits = model.heatshrinkLookahead();
+  framing.checksumAlgorithm
+      = static_cast<IO::ChecksumAlgorithm>(model.checksumAlgorithm());
+  framing.checksumPlacement
+      = static_cast<IO::ChecksumPlacement>(model.checksumPlacement());
+  framing.checksumEncoding
+      = static_cast<IO::ChecksumEncoding>(model.checksumEncoding());
+  framing.startSequence = model.frameStartSequence().toUtf8();
+  framing.finishSequence = model.frameEndSequence().toUtf8();
+  return true;
+}
+
+/**
+ * Returns the path of the file in which the given @a input file is converted,
+ * the input file is never overwritten.
+ */
+QString CSV::Converter::outputFile(const QString &input) const
+{
+  const QFileInfo info(input);
+  const auto dir = m_options.outputPath.isEmpty() ? info.absolutePath()
+                                                  : m_options.outputPath;
+
+  const auto base = baseName(input);
+  auto path = QDir(dir).filePath(base + "." + m_settings.suffix);
+  if (QFileInfo(path).absoluteFilePath() == info.absoluteFilePath())
+    path = QDir(dir).filePath(base + "_converted." + m_settings.suffix);
+
+  return path;
+}
+
+/**
+ * Returns the name of the given file without its directory & without the
+ * suffix of the recording format (e.g. @c csv.gz).
+ */
+QString CSV::Converter::baseName(const QString &path)
+{
+  static const QRegularExpression suffix(
+      QStringLiteral("\\.(csv\\.gz|csv|ssrec|ssraw|arrows)$"),
+      QRegularExpression::CaseInsensitiveOption);
+
+  auto name = QFileInfo(path).fileName();
+  name.remove(suffix);
+  return name;
+}
+
+/**
+ * Converts a CSV file or a binary recording to the output format, returns
+ * the number of written rows or -1 on failure.
+ */
+qint64 CSV::Converter::convertRecording(const QString &input,
+                                        const QString &output,
+                                        const Settings &settings,
+                                        QString *error)
+{
+  // Open binary recordings directly
+  CsvReader csv;
+  BinaryReader binary;
+  int firstRow = 0;
+  QString title = baseName(input);
+  QString separator = QStringLiteral(",");
+  QStringList titles;
+  if (QFileInfo(input).suffix().toLower() == QStringLiteral("ssrec"))
+  {
+    if (!binary.open(input))
+    {
+      *error = QStringLiteral("cannot read binary recording");
+      return -1;
+    }
+
+    title = binary.title();
+    titles = binary.titles();
+    separator = binary.separator();
+  }
+
+  // Wait until the rows of CSV files are indexed
+  else
+  {
+    QEventLoop loop;
+    QObject::connect(&csv, &CsvReader::indexed, &loop, &QEventLoop::quit);
+    if (Gzip::isCompressed(input) && !Gzip::isSupported(input))
+    {
+      *error = QStringLiteral("unsupported gzip stream (decompress the file "
+                              "with a gzip tool first)");
+      return -1;
+    }
+
+    if (!csv.open(input))
+    {
+      *error = QStringLiteral("cannot read CSV file");
+      return -1;
+    }
+
+    if (csv.isIndexing())
+      loop.exec();
+
+    // Remove the reception time column & the field numbers of the titles
+    static const QRegularExpression field(QStringLiteral("\\(field \\d+\\)$"));
+    firstRow = 1;
+    titles = csv.row(0);
+    if (!titles.isEmpty())
+      titles.removeFirst();
+    for (int i = 0; i < titles.count(); ++i)
+      titles[i].remove(field);
+  }
+
+  // Nothing to convert
+  const int rows = binary.isOpen() ? binary.rowCount() : csv.rowCount() - 1;
+  if (rows <= 0 || titles.isEmpty())
+  {
+    *error = QStringLiteral("the recording does not contain any frames");
+    return -1;
+  }
+
+  // Create output file
+  bool failed = false;
+  ExportWorker worker;
+  QObject::connect(&worker, &ExportWorker::openFailed,
+                   [&failed] { failed = true; });
+  worker.open(output, settings.format, title, separator, titles,
+              settings.compress);
+
+  // Copy the rows in batches
+  QVector<ExportFrame> frames;
+  frames.reserve(BATCH_SIZE);
+  for (int i = 0; i < rows && !failed; ++i)
+  {
+    ExportFrame frame;
+    if (binary.isOpen())
+    {
+      frame.values = binary.values(i);
+      frame.rxDateTime = QDateTime::fromMSecsSinceEpoch(binary.timestamp(i));
+    }
+
+    else
+    {
+      frame.values = csv.row(i + firstRow);
+      frame.rxDateTime
+          = QDateTime::fromMSecsSinceEpoch(csv.timestamp(i + firstRow));
+      if (!frame.values.isEmpty())
+        frame.values.removeFirst();
+    }
+
+    frames.append(frame);
+    if (frames.count() >= BATCH_SIZE)
+    {
+      worker.write(frames);
+      frames.clear();
+    }
+  }
+
+  // Write the remaining rows
+  if (!frames.isEmpty())
+    worker.write(frames);
+
+  worker.close();
+  if (failed)
+  {
+    *error = QStringLiteral("cannot write output file");
+    return -1;
+  }
+
+  return rows;
+}
+
+/**
+ * Re-processes a raw capture with the framing settings & the frame parser of
+ * the project, returns the number of written rows or -1 on failure.
+ */
+qint64 CSV::Converter::convertCapture(const QString &input,
+                                      const QString &output,
+                                      const Settings &settings, QString *error)
+{
+  // Open raw capture
+  IO::RawCaptureFile capture;
+  if (!capture.open(input, error))
+    return -1;
+
+  if (capture.chunkCount() <= 0)
+  {
+    *error = QStringLiteral("the capture does not contain any data");
+    return -1;
+  }
+
+  // Load the frame parser in this thread
+  Project::FrameParser parser;
+  if (parser.load(settings.code) != Project::FrameParser::LoadStatus::Ok)
+  {
+    *error = QStringLiteral("cannot load the frame parser");
+    return -1;
+  }
+
+  // Get the time at which the capture started from its file name, or from
+  // the modification time of the file if it was renamed
+  auto start = QDateTime::fromString(baseName(input).left(23),
+                                     "yyyy-MM-dd_HH-mm-ss-zzz");
+  if (!start.isValid())
+    start = QFileInfo(input).lastModified().addMSecs(-capture.duration()
+                                                     / 1000);
+
+  // Create a frame reader with the framing settings of the project
+  IO::FrameQueue queue;
+  IO::FrameReader reader(&queue);
+  const int consumer = queue.registerConsumer(QStringLiteral("Converter"));
+  IO::Manager::configureFrameReader(&reader, settings.framing);
+
+  // Split frames natively if the project uses the default frame parser
+  QVector<JSON::FieldSpan> spans;
+  JSON::FieldSplitter splitter(settings.separator.toUtf8());
+  const bool nativeSplit
+      = parser.nativeSplit() && !settings.separator.isEmpty();
+
+  // Create output file
+  bool failed = false;
+  ExportWorker worker;
+  QObject::connect(&worker, &ExportWorker::openFailed,
+                   [&failed] { failed = true; });
+  worker.open(output, settings.format, settings.title, settings.separator,
+              settings.titles, settings.compress);
+  worker.writeSchema(settings.schema);
+
+  // Feed the chunks of the capture to the frame reader
+  qint64 rows = 0;
+  QByteArray data;
+  QVector<QByteArray> frames;
+  QVector<IO::FrameInfo> info;
+  QVector<ExportFrame> batch;
+  const auto origin = capture.timestamp(0);
+  for (int i = 0; i <= capture.chunkCount() && !failed; ++i)
+  {
+    // Publish the frame held by the frame reader after the last chunk
+    if (i == capture.chunkCount())
+      reader.flush();
+
+    // Feed the next chunk to the frame reader
+    else if (capture.read(i, data))
+      reader.processData(data, capture.timestamp(i));
+
+    else
+      continue;
+
+    frames.clear();
+    info.clear();
+    queue.popBatch(consumer, frames, info);
+
+    // Parse the extracted frames
+    for (int j = 0; j < frames.count(); ++j)
+    {
+      QStringList fields;
+      const auto &raw = frames.at(j);
+      if (nativeSplit)
+      {
+        const int count = splitter.split(raw, spans);
+        for (int k = 0; k < count; ++k)
+          fields.append(QString::fromUtf8(raw.constData() + spans.at(k).offset,
+                                          spans.at(k).length));
+      }
+
+      else
+        fields = parser.parse(QString::fromUtf8(raw), settings.separator);
+
+      if (fields.isEmpty())
+        continue;
+
+      ExportFrame frame;
+      frame.rxDateTime = start.addMSecs((info.at(j).timestamp - origin) / 1000);
+      frame.values.reserve(settings.fields.count());
+      for (const auto field : settings.fields)
+      {
+        if (field >= 0 && field < fields.count())
+          frame.values.append(fields.at(field));
+        else
+          frame.values.append(QString());
+      }
+
+      batch.append(frame);
+    }
+
+    // Write the parsed frames
+    if (batch.count() >= BATCH_SIZE)
+    {
+      rows += batch.count();
+      worker.write(batch);
+      batch.clear();
+    }
+  }
+
+  // Write the remaining frames
+  if (!batch.isEmpty())
+  {
+    rows += batch.count();
+    worker.write(batch);
+  }
+
+  worker.close();
+  if (failed)
+  {
+    *error = QStringLiteral("cannot write output file");
+    return -1;
+  }
+
+  return rows;
+}
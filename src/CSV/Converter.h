@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QThreadPool>
+#include <QStringList>
+#include <QElapsedTimer>
+
+#include <IO/Manager.h>
+
+namespace CSV
+{
+struct ConverterOptions
+{
+  QStringList inputs;
+  QString project;
+  QString outputPath;
+  QString format = QStringLiteral("csv");
+  int jobs = 0;
+};
+
+/**
+ * @brief The Converter class
+ *
+ * Converts batches of recordings between the export formats (CSV, gzipped
+ * CSV, binary @c *.ssrec recordings & Arrow IPC streams) and re-processes raw
+ * captures (@c *.ssraw) with the frame parser of a project, without user
+ * interface.
+ *
+ * Each input file is converted by an independent job, jobs run concurrently
+ * in a thread pool with one thread per core (or the number of jobs given by
+ * the user). Every job owns its readers, frame reader & frame parser, and
+ * writes its output with an @c ExportWorker, so that converted files are
+ * identical to the files recorded by the application:
+ *
+ * - CSV files & binary recordings are read with @c CsvReader &
+ *   @c BinaryReader, their columns & timestamps are copied as-is.
+ * - Raw captures are split into frames by an @c IO::FrameReader configured
+ *   with the framing settings of the project, and each frame is parsed by a
+ *   @c Project::FrameParser running the parser code of the project (or split
+ *   natively if the project uses the default frame parser). Projects that
+ *   are decoded by other means (binary layouts, NMEA 0183 sentences,
+ *   WebAssembly modules or frame routing) are rejected. The framing settings
+ *   & parser code are obtained from the project in the main thread, before
+ *   the jobs are started. Since
+ *   raw captures only store monotonic times, the reception time of each frame
+ *   is obtained from the start time encoded in the name of the capture.
+ *
+ * The marker index & the schema of each input file (see @c MarkerIndex &
+ * @c RecordingSchema) are copied next to its output file, converted raw
+ * captures are given the schema of the project.
+ */
+class Converter : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit Converter(const ConverterOptions &options);
+
+  bool start();
+
+private Q_SLOTS:
+  void onJobFinished(const QString &input, const QString &output,
+                     const qint64 rows, const QString &error);
+
+private:
+  struct Settings
+  {
+    int format;
+    bool compress;
+    QString title;
+    QString code;
+    QString suffix;
+    QString separator;
+    QStringList titles;
+    QVector<int> fields;
+    QByteArray schema;
+    IO::Manager::FramingSettings framing;
+  };
+
+  bool loadProject();
+  QString outputFile(const QString &input) const;
+
+  static QString baseName(const QString &path);
+  static qint64 convertRecording(const QString &input, const QString &output,
+                                 const Settings &settings, QString *error);
+  static qint64 convertCapture(const QString &input, const QString &output,
+                               const Settings &settings, QString *error);
+
+private:
+  int m_failed;
+  int m_finished;
+  qint64 m_rows;
+
+  Settings m_settings;
+  QThreadPool m_pool;
+  QElapsedTimer m_clock;
+  ConverterOptions m_options;
+};
+} // namespace CSV
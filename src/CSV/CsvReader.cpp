@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QDate>
+
+#include <CSV/Gzip.h>
+#include <CSV/CsvReader.h>
+
+/**
+ * Number of rows between two consecutive positions stored in the row index
+ */
+static const int CSV_INDEX_STRIDE = 64;
+
+/**
+ * Number of progress updates reported while a file is being indexed
+ */
+static const int PROGRESS_STEPS = 100;
+
+/**
+ * Returns the position of the row that follows the row that starts at the
+ * given @a offset. Line breaks inside quoted fields do not end the row.
+ */
+static quint64 NEXT_ROW(const char *data, const quint64 size,
+                        const quint64 offset)
+{
+  bool quoted = false;
+  quint64 pos = offset;
+  while (pos < size)
+  {
+    // Find the end of the current line
+    auto nl = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+    const quint64 end = nl ? static_cast<quint64>(nl - data) : size;
+
+    // Update quote state with the quotes found in the line
+    auto q = static_cast<const char *>(memchr(data + pos, '"', end - pos));
+    while (q)
+    {
+      quoted = !quoted;
+      const quint64 next = static_cast<quint64>(q - data) + 1;
+      q = static_cast<const char *>(memchr(data + next, '"', end - next));
+    }
+
+    // Line break is not quoted, row ends here
+    if (!quoted || !nl)
+      return nl ? end + 1 : size;
+
+    pos = end + 1;
+  }
+
+  return size;
+}
+
+/**
+ * Parses the number with the given number of @a digits stored at @a data,
+ * returns -1 if a non-digit character is found.
+ */
+static int PARSE_NUMBER(const char *data, const int digits)
+{
+  int value = 0;
+  for (int i = 0; i < digits; ++i)
+  {
+    if (data[i] < '0' || data[i] > '9')
+      return -1;
+
+    value = value * 10 + (data[i] - '0');
+  }
+
+  return value;
+}
+
+/**
+ * Parses the RX date/time stored at the beginning of the row that starts at
+ * @a data, with the format used by @c CSV::Export
+ * ("yyyy/MM/dd/ HH:mm:ss::zzz"). Returns the number of milliseconds elapsed
+ * since the epoch (without time zone conversion, since only the difference
+ * between two timestamps is needed), or -1 if the row has no valid timestamp.
+ */
+static qint64 PARSE_TIMESTAMP(const char *data, const quint64 length)
+{
+  // Validate length
+  if (length < 25)
+    return -1;
+
+  // Parse date/time fields
+  const int year = PARSE_NUMBER(data, 4);
+  const int month = PARSE_NUMBER(data + 5, 2);
+  const int day = PARSE_NUMBER(data + 8, 2);
+  const int hour = PARSE_NUMBER(data + 12, 2);
+  const int minute = PARSE_NUMBER(data + 15, 2);
+  const int second = PARSE_NUMBER(data + 18, 2);
+  const int msec = PARSE_NUMBER(data + 22, 3);
+  if (year < 0 || month < 0 || day < 0 || hour < 0 || minute < 0 || second < 0
+      || msec < 0)
+    return -1;
+
+  // Validate date
+  const QDate date(year, month, day);
+  if (!date.isValid())
+    return -1;
+
+  // Calculate milliseconds
+  const qint64 time = ((hour * 60 + minute) * 60 + second) * 1000 + msec;
+  return date.toJulianDay() * 86400000ll + time;
+}
+
+/**
+ * Splits the row stored in the given @a data block into fields
+ */
+static QStringList DECODE_ROW(const char *data, int length)
+{
+  // Remove line break
+  while (length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r'))
+    --length;
+
+  // Split fields, taking quotes into account
+  QStringList fields;
+  QByteArray field;
+  bool quoted = false;
+  for (int i = 0; i < length; ++i)
+  {
+    const char c = data[i];
+    if (quoted)
+    {
+      if (c == '"' && i + 1 < length && data[i + 1] == '"')
+      {
+        field.append('"');
+        ++i;
+      }
+
+      else if (c == '"')
+        quoted = false;
+
+      else
+        field.append(c);
+    }
+
+    else if (c == '"')
+      quoted = true;
+
+    else if (c == ',')
+    {
+      fields.append(QString::fromUtf8(field));
+      field.clear();
+    }
+
+    else
+      field.append(c);
+  }
+
+  // Add last field
+  fields.append(QString::fromUtf8(field));
+  return fields;
+}
+
+//----------------------------------------------------------------------------------------
+// Indexer implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+CSV::CsvIndexer::CsvIndexer() {}
+
+/**
+ * Finds the position of every @c CSV_INDEX_STRIDE-th row of the given
+ * memory-mapped file, parses the timestamp of every row & publishes the
+ * results to the @a reader. The scan is stopped as soon as @a abort is set
+ * by the reader.
+ *
+ * Timestamps are forced to be monotonic, rows without a valid timestamp (such
+ * as the title row) get the timestamp of the previous row.
+ */
+void CSV::CsvIndexer::scan(CSV::CsvReader *reader, const quint64 generation,
+                           const char *data, const quint64 size,
+                           const std::atomic<bool> *abort)
+{
+  // Initialize parameters
+  int rows = 0;
+  quint64 pos = 0;
+  qint64 last = -1;
+  QVector<quint64> index;
+  QVector<qint64> timestamps;
+  const quint64 step = qMax<quint64>(1, size / PROGRESS_STEPS);
+  quint64 nextReport = step;
+
+  // Skip UTF-8 byte order mark
+  if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+    pos = 3;
+
+  // Scan rows
+  while (pos < size)
+  {
+    if (rows % CSV_INDEX_STRIDE == 0)
+    {
+      if (abort->load())
+        return;
+
+      index.append(pos);
+    }
+
+    // Parse timestamp & find next row
+    const auto next = NEXT_ROW(data, size, pos);
+    const auto time = PARSE_TIMESTAMP(data + pos, next - pos);
+    last = qMax(last, time);
+    timestamps.append(last);
+    pos = next;
+    ++rows;
+
+    // Report progress
+    if (pos >= nextReport && pos < size)
+    {
+      nextReport = pos + step;
+      const qreal progress = static_cast<qreal>(pos) / size;
+      QMetaObject::invokeMethod(
+          reader, [=] { reader->onProgress(generation, progress); });
+    }
+  }
+
+  // Rows before the first valid timestamp get the first timestamp
+  for (int i = timestamps.count() - 1; i > 0; --i)
+  {
+    if (timestamps.at(i - 1) < 0)
+      timestamps[i - 1] = timestamps.at(i);
+  }
+
+  // Publish index
+  QMetaObject::invokeMethod(
+      reader, [=] { reader->onIndexed(generation, index, timestamps); });
+}
+
+//----------------------------------------------------------------------------------------
+// Reader implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, starts the indexer thread
+ */
+CSV::CsvReader::CsvReader()
+  : m_rows(0)
+  , m_indexed(false)
+  , m_progress(0)
+  , m_size(0)
+  , m_map(Q_NULLPTR)
+  , m_generation(0)
+  , m_abort(false)
+  , m_lastRow(-1)
+  , m_lastOffset(0)
+  , m_cachedRow(-1)
+  , m_indexer(new CsvIndexer())
+{
+  m_thread.setObjectName(QStringLiteral("CSV::CsvIndexer"));
+  m_indexer->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_indexer, &QObject::deleteLater);
+  m_thread.start();
+}
+
+/**
+ * Destructor function, stops the indexer thread & unmaps the file
+ */
+CSV::CsvReader::~CsvReader()
+{
+  close();
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns @c true if a file is open & its rows have been indexed
+ */
+bool CSV::CsvReader::isOpen() const
+{
+  return m_map != Q_NULLPTR && m_indexed;
+}
+
+/**
+ * Returns @c true if a file is open & its rows are being indexed
+ */
+bool CSV::CsvReader::isIndexing() const
+{
+  return m_map != Q_NULLPTR && !m_indexed;
+}
+
+/**
+ * Returns the number of rows of the file (including the title row)
+ */
+int CSV::CsvReader::rowCount() const
+{
+  return m_rows;
+}
+
+/**
+ * Returns the indexing progress in a range from 0.0 to 1.0
+ */
+qreal CSV::CsvReader::progress() const
+{
+  return m_progress;
+}
+
+/**
+ * Returns the path of the current file
+ */
+QString CSV::CsvReader::fileName() const
+{
+  return m_path;
+}
+
+/**
+ * Opens & memory-maps the file at the given @a path & starts indexing its
+ * rows in the background, the @c indexed() signal is emitted once the rows
+ * can be read.
+ *
+ * Compressed files are decompressed to a temporary file first, which is
+ * removed when the reader is closed.
+ */
+bool CSV::CsvReader::open(const QString &path)
+{
+  // Close previous file
+  close();
+
+  // Decompress the file if required
+  m_path = path;
+  auto mappedPath = path;
+  if (Gzip::isCompressed(path))
+  {
+    QFile compressed(path);
+    m_inflated.reset(new QTemporaryFile());
+    if (!compressed.open(QIODevice::ReadOnly) || !m_inflated->open()
+        || !Gzip::decompress(&compressed, m_inflated.data())
+        || !m_inflated->flush())
+    {
+      close();
+      return false;
+    }
+
+    mappedPath = m_inflated->fileName();
+  }
+
+  // Open & map the file
+  m_file.setFileName(mappedPath);
+  if (!m_file.open(QIODevice::ReadOnly) || m_file.size() <= 0)
+  {
+    close();
+    return false;
+  }
+
+  m_size = static_cast<quint64>(m_file.size());
+  m_map = m_file.map(0, m_file.size());
+  if (!m_map)
+  {
+    close();
+    return false;
+  }
+
+  // Index rows in the background
+  auto reader = this;
+  auto abort = &m_abort;
+  auto size = m_size;
+  auto indexer = m_indexer;
+  auto generation = m_generation;
+  auto data = reinterpret_cast<const char *>(m_map);
+  QMetaObject::invokeMethod(indexer, [=] {
+    indexer->scan(reader, generation, data, size, abort);
+  });
+
+  return true;
+}
+
+/**
+ * Stops the indexer, unmaps the file & resets the internal state of the
+ * reader.
+ */
+void CSV::CsvReader::close()
+{
+  // Stop indexing & wait until the indexer no longer uses the mapped memory
+  if (m_map && !m_indexed)
+  {
+    m_abort = true;
+    QMetaObject::invokeMethod(
+        m_indexer, [] {}, Qt::BlockingQueuedConnection);
+  }
+
+  // Unmap file
+  if (m_map)
+    m_file.unmap(m_map);
+
+  m_file.close();
+
+  // Reset state, results from previous scans are ignored
+  ++m_generation;
+  m_rows = 0;
+  m_size = 0;
+  m_progress = 0;
+  m_lastRow = -1;
+  m_cachedRow = -1;
+  m_lastOffset = 0;
+  m_abort = false;
+  m_indexed = false;
+  m_map = Q_NULLPTR;
+  m_path.clear();
+  m_inflated.reset();
+  m_index.clear();
+  m_timestamps.clear();
+  m_cachedFields.clear();
+}
+
+/**
+ * Returns the fields of the row with the given @a index, or an empty list if
+ * the row does not exist.
+ */
+QStringList CSV::CsvReader::row(const int index)
+{
+  // Validate arguments
+  if (!isOpen() || index < 0 || index >= m_rows)
+    return QStringList();
+
+  // Row was read previously
+  if (index == m_cachedRow)
+    return m_cachedFields;
+
+  // Decode row
+  const auto data = reinterpret_cast<const char *>(m_map);
+  const auto offset = rowOffset(index);
+  const auto end = NEXT_ROW(data, m_size, offset);
+  m_cachedRow = index;
+  m_cachedFields = DECODE_ROW(data + offset, static_cast<int>(end - offset));
+  return m_cachedFields;
+}
+
+/**
+ * Returns the timestamp (in milliseconds) of the row with the given @a index,
+ * or -1 if the row does not exist. Timestamps never decrease from one row to
+ * the next one.
+ */
+qint64 CSV::CsvReader::timestamp(const int index) const
+{
+  if (!isOpen() || index < 0 || index >= m_timestamps.count())
+    return -1;
+
+  return m_timestamps.at(index);
+}
+
+/**
+ * Updates the indexing progress of the file with the given @a generation
+ */
+void CSV::CsvReader::onProgress(const quint64 generation,
+                                const qreal progress)
+{
+  if (generation == m_generation && !m_indexed)
+  {
+    m_progress = progress;
+    Q_EMIT progressChanged();
+  }
+}
+
+/**
+ * Registers the row @a index & the row @a timestamps of the file with the
+ * given @a generation
+ */
+void CSV::CsvReader::onIndexed(const quint64 generation,
+                               const QVector<quint64> &index,
+                               const QVector<qint64> &timestamps)
+{
+  if (generation == m_generation && m_map)
+  {
+    m_index = index;
+    m_timestamps = timestamps;
+    m_rows = timestamps.count();
+    m_progress = 1;
+    m_indexed = true;
+
+    Q_EMIT progressChanged();
+    Q_EMIT indexed();
+  }
+}
+
+/**
+ * Returns the position of the row with the given @a index. The search starts
+ * at the previously read row if possible, otherwise at the nearest indexed
+ * row.
+ */
+quint64 CSV::CsvReader::rowOffset(const int index)
+{
+  // Get starting point
+  int row = (index / CSV_INDEX_STRIDE) * CSV_INDEX_STRIDE;
+  quint64 offset = m_index.at(index / CSV_INDEX_STRIDE);
+  if (m_lastRow >= row && m_lastRow <= index)
+  {
+    row = m_lastRow;
+    offset = m_lastOffset;
+  }
+
+  // Skip rows until we reach the requested row
+  const auto data = reinterpret_cast<const char *>(m_map);
+  for (; row < index; ++row)
+    offset = NEXT_ROW(data, m_size, offset);
+
+  // Update position of the last read row
+  m_lastRow = index;
+  m_lastOffset = offset;
+  return offset;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QFile>
+#include <QThread>
+#include <QObject>
+#include <QVector>
+#include <QScopedPointer>
+#include <QTemporaryFile>
+#include <QStringList>
+
+namespace CSV
+{
+class CsvReader;
+
+/**
+ * @brief The CsvIndexer class
+ *
+ * Worker object of the @c CsvReader, runs in its own thread and scans a
+ * memory-mapped CSV file to find the position of its rows & to parse the
+ * reception timestamp of each row.
+ */
+class CsvIndexer : public QObject
+{
+  Q_OBJECT
+
+public:
+  CsvIndexer();
+
+public Q_SLOTS:
+  void scan(CSV::CsvReader *reader, const quint64 generation,
+            const char *data, const quint64 size,
+            const std::atomic<bool> *abort);
+};
+
+/**
+ * @brief The CsvReader class
+ *
+ * Provides random access to the rows of a CSV file without loading the whole
+ * file into memory.
+ *
+ * The file is memory-mapped & scanned once in a background thread. Instead of
+ * storing the position of every row, the index stores the position of one row
+ * out of every @c CSV_INDEX_STRIDE rows, so the memory required by the index
+ * is small even for very large files. Reading a row requires skipping at most
+ * @c CSV_INDEX_STRIDE - 1 rows from the nearest indexed position, sequential
+ * reads continue from the previously read row.
+ *
+ * The timestamp stored in the first column of each row is parsed while the
+ * file is indexed, so that the player does not need to parse date/time
+ * strings during playback (see @c timestamp()).
+ *
+ * Quoted fields (including quoted separators, line breaks & escaped quotes)
+ * are supported.
+ *
+ * Compressed CSV files (see @c CSV::Gzip) are decompressed to a temporary
+ * file when they are opened, which is then memory-mapped like a regular
+ * file.
+ */
+class CsvReader : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void indexed();
+  void progressChanged();
+
+public:
+  CsvReader();
+  ~CsvReader();
+
+  bool isOpen() const;
+  bool isIndexing() const;
+  int rowCount() const;
+  qreal progress() const;
+  QString fileName() const;
+
+  bool open(const QString &path);
+  void close();
+
+  QStringList row(const int index);
+  qint64 timestamp(const int index) const;
+
+private:
+  friend class CsvIndexer;
+  void onProgress(const quint64 generation, const qreal progress);
+  void onIndexed(const quint64 generation, const QVector<quint64> &index,
+                 const QVector<qint64> &timestamps);
+
+  quint64 rowOffset(const int index);
+
+private:
+  int m_rows;
+  bool m_indexed;
+  qreal m_progress;
+  quint64 m_size;
+  uchar *m_map;
+  quint64 m_generation;
+  std::atomic<bool> m_abort;
+
+  int m_lastRow;
+  quint64 m_lastOffset;
+  int m_cachedRow;
+  QStringList m_cachedFields;
+
+  QFile m_file;
+  QString m_path;
+  QScopedPointer<QTemporaryFile> m_inflated;
+  QVector<quint64> m_index;
+  QVector<qint64> m_timestamps;
+
+  QThread m_thread;
+  CsvIndexer *m_indexer;
+};
+} // namespace CSV
@@ -24,30 +24,455 @@
 
 #include <QDir>
 #include <QUrl>
+#include <QDebug>
 #include <QFileInfo>
 #include <QApplication>
 #include <QDesktopServices>
 
 #include <AppInfo.h>
+#include <CSV/Gzip.h>
 #include <IO/Manager.h>
-#include <UI/Dashboard.h>
-#include <Project/Model.h>
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
+#include <CSV/SessionStore.h>
 #include <Misc/Utilities.h>
+#include <Misc/Diagnostics.h>
 #include <Misc/TimerEvents.h>
 
+#if defined(Q_OS_WIN)
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+/**
+ * Size of the memory buffer in which CSV rows are accumulated before they are
+ * written to the file.
+ */
+static const int BUFFER_SIZE = 4 * 1024 * 1024;
+
+/**
+ * Maximum amount of frame data (in bytes) that can be waiting to be written by
+ * the worker thread, new frames wait for the worker if this limit is reached.
+ */
+static const qint64 MAX_QUEUED_BYTES = 64 * 1024 * 1024;
+
+/**
+ * Synchronizes the file with the given @a handle with the storage device
+ */
+static void SYNC_FILE(const int handle)
+{
+  if (handle < 0)
+    return;
+
+#if defined(Q_OS_WIN)
+  _commit(handle);
+#else
+  fsync(handle);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, allocates the write buffer
+ */
+CSV::ExportWorker::ExportWorker()
+  : m_format(Export::CsvFormat)
+  , m_failed(false)
+  , m_compress(false)
+  , m_syncToDisk(false)
+  , m_flushInterval(1)
+  , m_rotationSize(0)
+  , m_rotationRequested(false)
+{
+  m_buffer.reserve(BUFFER_SIZE);
+}
+
+/**
+ * Destructor function, writes pending data & closes the output file
+ */
+CSV::ExportWorker::~ExportWorker()
+{
+  close();
+}
+
+/**
+ * Writes all the pending data & closes the output file
+ */
+void CSV::ExportWorker::close()
+{
+  flush(m_syncToDisk);
+
+  m_path.clear();
+  m_failed = false;
+  m_rotationRequested = false;
+  m_csvFile.close();
+  m_arrowWriter.close();
+  m_binaryWriter.close();
+}
+
+/**
+ * Appends the given marker @a line to the marker file of the output file
+ */
+void CSV::ExportWorker::writeMarker(const QByteArray &line)
+{
+  if (m_path.isEmpty() || m_failed)
+    return;
+
+  QFile file(MarkerIndex::indexPath(m_path));
+  if (!file.open(QFile::WriteOnly | QFile::Append))
+  {
+    qWarning() << "Cannot write marker file" << file.fileName();
+    return;
+  }
+
+  file.write(line);
+  file.close();
+}
+
+/**
+ * Writes the given recording @a schema next to the output file, the schema
+ * file of a previous recording with the same name is replaced.
+ */
+void CSV::ExportWorker::writeSchema(const QByteArray &schema)
+{
+  if (m_path.isEmpty() || m_failed)
+    return;
+
+  QFile file(RecordingSchema::schemaPath(m_path));
+  if (!file.open(QFile::WriteOnly | QFile::Truncate))
+  {
+    qWarning() << "Cannot write schema file" << file.fileName();
+    return;
+  }
+
+  file.write(schema);
+  file.close();
+}
+
+/**
+ * Writes the contents of the buffer to the output file. If @a sync is set to
+ * @c true, the function waits until the data is stored on the device.
+ */
+void CSV::ExportWorker::flush(const bool sync)
+{
+  // Write buffered CSV rows
+  if (m_csvFile.isOpen())
+  {
+    writeBuffer();
+    m_csvFile.flush();
+
+    if (sync)
+      SYNC_FILE(m_csvFile.handle());
+  }
+
+  // Write buffered binary rows
+  else if (m_binaryWriter.isOpen())
+  {
+    m_binaryWriter.flush();
+    if (sync)
+      SYNC_FILE(m_binaryWriter.handle());
+  }
+
+  // Write buffered Arrow rows
+  else if (m_arrowWriter.isOpen())
+  {
+    m_arrowWriter.flush();
+    if (sync)
+      SYNC_FILE(m_arrowWriter.handle());
+  }
+
+  // Restart flush timer
+  m_lastFlush.start();
+}
+
+/**
+ * Formats & writes the given @a frames to the output file, the buffer is
+ * flushed if the flush interval has expired.
+ *
+ * After each flush, the size of the file is compared with the rotation size,
+ * the @c rotationRequired() signal is emitted (once per file) if the file is
+ * too large.
+ */
+void CSV::ExportWorker::write(const QVector<CSV::ExportFrame> &frames)
+{
+  // File not open or open error
+  if (m_path.isEmpty() || m_failed)
+    return;
+
+  // Write frames
+  if (m_format == Export::BinaryFormat)
+    writeBinary(frames);
+  else if (m_format == Export::ArrowFormat)
+    writeArrow(frames);
+  else
+    writeCsv(frames);
+
+  // Flush data periodically
+  if (m_lastFlush.elapsed() >= m_flushInterval * 1000)
+  {
+    flush(m_syncToDisk);
+
+    // Request a new file if the current file is too large
+    if (m_rotationSize > 0 && !m_rotationRequested
+        && QFileInfo(m_path).size() >= m_rotationSize)
+    {
+      m_rotationRequested = true;
+      Q_EMIT rotationRequired();
+    }
+  }
+}
+
+/**
+ * Creates the output file at the given @a path, the file is written with the
+ * given @a format and contains the given column @a titles. If @a compress is
+ * set to @c true, CSV rows are written as gzip members.
+ *
+ * Binary recordings & Arrow streams are created when the first frame is
+ * received, because the type of each column is obtained from the first frame.
+ */
+void CSV::ExportWorker::open(const QString &path, const int format,
+                             const QString &title, const QString &separator,
+                             const QStringList &titles, const bool compress)
+{
+  // Close previous file
+  close();
+
+  // Update parameters
+  m_path = path;
+  m_title = title;
+  m_format = format;
+  m_titles = titles;
+  m_separator = separator;
+  m_compress = compress && format == Export::CsvFormat;
+  m_lastFlush.start();
+
+  // Binary & Arrow files are created later on
+  if (m_format == Export::BinaryFormat || m_format == Export::ArrowFormat)
+    return;
+
+  // Open CSV file, compressed files are written in binary mode
+  QIODevice::OpenMode mode = QIODevice::WriteOnly;
+  if (!m_compress)
+    mode |= QIODevice::Text;
+
+  m_csvFile.setFileName(path);
+  if (!m_csvFile.open(mode))
+  {
+    m_failed = true;
+    Q_EMIT openFailed();
+    return;
+  }
+
+  // Add UTF-8 byte order mark & table titles
+  m_buffer.append("\xEF\xBB\xBF");
+  m_buffer.append("RX Date/Time,");
+  for (int i = 0; i < m_titles.count(); ++i)
+  {
+    m_buffer.append(m_titles.at(i).toUtf8());
+    m_buffer.append("(field ");
+    m_buffer.append(QByteArray::number(i + 1));
+    m_buffer.append(")");
+
+    if (i < m_titles.count() - 1)
+      m_buffer.append(',');
+    else
+      m_buffer.append('\n');
+  }
+}
+
+/**
+ * Changes the interval (in seconds) at which data is written to the file &
+ * enables or disables synchronizing the file with the storage device.
+ */
+void CSV::ExportWorker::setFlushPolicy(const int interval, const bool sync)
+{
+  m_syncToDisk = sync;
+  m_flushInterval = interval;
+}
+
+/**
+ * Changes the size (in bytes) at which the worker requests a new file, a
+ * value of 0 disables size-based rotation.
+ */
+void CSV::ExportWorker::setRotationSize(const qint64 bytes)
+{
+  m_rotationSize = bytes;
+}
+
+/**
+ * Writes the contents of the CSV buffer to the file, compressing it if
+ * required, & clears the buffer.
+ */
+void CSV::ExportWorker::writeBuffer()
+{
+  if (m_buffer.isEmpty())
+    return;
+
+  if (m_compress)
+    m_csvFile.write(Gzip::compressBlock(m_buffer));
+  else
+    m_csvFile.write(m_buffer);
+
+  m_buffer.resize(0);
+}
+
+/**
+ * Appends the given @a frames to the CSV buffer, the buffer is written to the
+ * file when it is full.
+ */
+void CSV::ExportWorker::writeCsv(const QVector<CSV::ExportFrame> &frames)
+{
+  for (int i = 0; i < frames.count(); ++i)
+  {
+    const auto &frame = frames.at(i);
+
+    // Write RX date/time
+    const auto time = frame.rxDateTime.toString("yyyy/MM/dd/ HH:mm:ss::zzz");
+    m_buffer.append(time.toUtf8());
+
+    // Write dataset values
+    for (int j = 0; j < frame.values.count(); ++j)
+    {
+      m_buffer.append(',');
+      m_buffer.append(frame.values.at(j).toUtf8());
+    }
+
+    m_buffer.append('\n');
+
+    // Write buffer to the file when it is full
+    if (m_buffer.size() >= BUFFER_SIZE)
+      writeBuffer();
+  }
+}
+
+/**
+ * Appends the given @a frames to the binary recording, the recording is
+ * created when the first frame is received.
+ */
+void CSV::ExportWorker::writeBinary(const QVector<CSV::ExportFrame> &frames)
+{
+  for (int i = 0; i < frames.count(); ++i)
+  {
+    const auto &frame = frames.at(i);
+
+    // Create recording
+    if (!m_binaryWriter.isOpen())
+    {
+      if (!m_binaryWriter.open(m_path, m_title, m_separator, m_titles,
+                               frame.values))
+      {
+        m_failed = true;
+        Q_EMIT openFailed();
+        return;
+      }
+    }
+
+    // Register row
+    m_binaryWriter.append(frame.rxDateTime.toMSecsSinceEpoch(), frame.values);
+  }
+}
+
+/**
+ * Appends the given @a frames to the Arrow stream, the stream is created when
+ * the first frame is received.
+ */
+void CSV::ExportWorker::writeArrow(const QVector<CSV::ExportFrame> &frames)
+{
+  for (int i = 0; i < frames.count(); ++i)
+  {
+    const auto &frame = frames.at(i);
+
+    // Create stream
+    if (!m_arrowWriter.isOpen())
+    {
+      if (!m_arrowWriter.open(m_path, m_title, m_titles, frame.values))
+      {
+        m_failed = true;
+        Q_EMIT openFailed();
+        return;
+      }
+    }
+
+    // Register row
+    m_arrowWriter.append(frame.rxDateTime.toMSecsSinceEpoch(), frame.values);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// Export implementation
+//----------------------------------------------------------------------------------------
+
 /**
- * Connect JSON Parser & Serial Manager signals to begin registering JSON
- * dataframes into JSON list.
+ * Connect JSON Generator & Serial Manager signals to begin registering the
+ * generated frames, & starts the writer thread.
  */
 CSV::Export::Export()
-  : m_fieldCount(0)
+  : m_open(false)
+  , m_syncToDisk(false)
+  , m_compressCsv(false)
+  , m_exportFormat(CsvFormat)
+  , m_flushInterval(1)
+  , m_rotationSize(0)
+  , m_rotationInterval(0)
+  , m_rotationPending(false)
   , m_exportEnabled(true)
+  , m_overflowWarning(false)
+  , m_bufferedBytes(0)
+  , m_schemaHash(0)
+  , m_queuedBytes(0)
+  , m_worker(new ExportWorker())
 {
+  // Read settings
+  const auto format = m_settings.value("CSV_Export_Format", CsvFormat).toInt();
+  if (format >= CsvFormat && format <= ArrowFormat)
+    m_exportFormat = format;
+
+  m_syncToDisk = m_settings.value("CSV_Export_SyncToDisk", false).toBool();
+  m_flushInterval = m_settings.value("CSV_Export_FlushInterval", 1).toInt();
+  m_flushInterval = qBound(1, m_flushInterval, 60);
+  m_compressCsv = m_settings.value("CSV_Export_Compress", false).toBool();
+  m_rotationSize = m_settings.value("CSV_Export_RotationSize", 0).toInt();
+  m_rotationSize = qBound(0, m_rotationSize, 1024 * 1024);
+  m_rotationInterval
+      = m_settings.value("CSV_Export_RotationInterval", 0).toInt();
+  m_rotationInterval = qBound(0, m_rotationInterval, 7 * 24 * 60);
+
+  // Start worker thread
+  m_thread.setObjectName(QStringLiteral("CSV::ExportWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(m_worker, &ExportWorker::openFailed, this, &Export::onOpenFailed);
+  connect(m_worker, &ExportWorker::rotationRequired, this,
+          &Export::onRotationRequired);
+  m_thread.start();
+
+  // Configure worker
+  auto worker = m_worker;
+  auto sync = m_syncToDisk;
+  auto interval = m_flushInterval;
+  auto rotation = static_cast<qint64>(m_rotationSize) * 1024 * 1024;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->setFlushPolicy(interval, sync);
+    worker->setRotationSize(rotation);
+  });
+
+  // Connect signals
   auto io = &IO::Manager::instance();
+  auto ge = &JSON::Generator::instance();
   auto te = &Misc::TimerEvents::instance();
   connect(io, &IO::Manager::connectedChanged, this, &Export::closeFile);
-  connect(io, &IO::Manager::frameReceived, this, &Export::registerFrame);
-  connect(te, &Misc::TimerEvents::timeout1Hz, this, &Export::writeValues);
+  connect(te, &Misc::TimerEvents::timeoutCsvExport, this, &Export::writeValues);
+  connect(ge, &JSON::Generator::alarmsTriggered, this,
+          &Export::onAlarmsTriggered);
+  connect(ge, &JSON::Generator::sequenceErrorsDetected, this,
+          &Export::onSequenceErrors);
+
+  // Receive every generated frame
+  ge->sinks().addSink(this, JSON::SinkGraph::Port::Frames);
 }
 
 /**
@@ -56,6 +481,13 @@ CSV::Export::Export()
 CSV::Export::~Export()
 {
   closeFile();
+
+  // Wait until the worker has written all the pending data
+  QMetaObject::invokeMethod(
+      m_worker, [] {}, Qt::BlockingQueuedConnection);
+
+  m_thread.quit();
+  m_thread.wait();
 }
 
 /**
@@ -67,12 +499,83 @@ CSV::Export &CSV::Export::instance()
   return singleton;
 }
 
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString CSV::Export::sinkName() const
+{
+  return QStringLiteral("CSV::Export");
+}
+
+/**
+ * Appends the given batch of @a frames to the output file, see
+ * @c registerFrames()
+ */
+void CSV::Export::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  registerFrames(frames);
+}
+
 /**
  * Returns @c true if the CSV output file is open
  */
 bool CSV::Export::isOpen() const
 {
-  return m_csvFile.isOpen();
+  return m_open;
+}
+
+/**
+ * Returns @c true if the output file is synchronized with the storage device
+ * each time that data is written to it.
+ */
+bool CSV::Export::syncToDisk() const
+{
+  return m_syncToDisk;
+}
+
+/**
+ * Returns @c true if CSV files are compressed with gzip while they are
+ * written.
+ */
+bool CSV::Export::compressCsv() const
+{
+  return m_compressCsv;
+}
+
+/**
+ * Returns the index of the file format used to export the received frames,
+ * the list of formats is obtained with @c availableExportFormats().
+ */
+int CSV::Export::exportFormat() const
+{
+  return m_exportFormat;
+}
+
+/**
+ * Returns the interval (in seconds) at which buffered data is written to the
+ * output file.
+ */
+int CSV::Export::flushInterval() const
+{
+  return m_flushInterval;
+}
+
+/**
+ * Returns the size (in megabytes) at which a new output file is started, or
+ * 0 if files are not rotated by size.
+ */
+int CSV::Export::rotationSize() const
+{
+  return m_rotationSize;
+}
+
+/**
+ * Returns the time (in minutes) after which a new output file is started, or
+ * 0 if files are not rotated by time.
+ */
+int CSV::Export::rotationInterval() const
+{
+  return m_rotationInterval;
 }
 
 /**
@@ -83,18 +586,147 @@ bool CSV::Export::exportEnabled() const
   return m_exportEnabled;
 }
 
+/**
+ * Returns the number of bytes that are waiting to be written to the file,
+ * including the rows buffered in the main thread & the data queued in the
+ * writer thread.
+ */
+qint64 CSV::Export::queuedBytes() const
+{
+  return m_queuedBytes + m_bufferedBytes;
+}
+
+/**
+ * Returns the list of file formats that can be used to export frames
+ */
+QStringList CSV::Export::availableExportFormats() const
+{
+  return QStringList {tr("CSV"), tr("Binary"), tr("Arrow IPC")};
+}
+
 /**
  * Open the current CSV file in the Explorer/Finder window
  */
 void CSV::Export::openCurrentCsv()
 {
   if (isOpen())
-    Misc::Utilities::revealFile(m_csvFile.fileName());
+    Misc::Utilities::revealFile(m_fileName);
   else
     Misc::Utilities::showMessageBox(tr("CSV file not open"),
                                     tr("Cannot find CSV export file!"));
 }
 
+/**
+ * Enables or disables synchronizing the output file with the storage device
+ * each time that data is written to it. This ensures that no data is lost if
+ * the computer loses power, at the expense of a higher disk usage.
+ */
+void CSV::Export::setSyncToDisk(const bool sync)
+{
+  if (m_syncToDisk != sync)
+  {
+    m_syncToDisk = sync;
+    m_settings.setValue("CSV_Export_SyncToDisk", sync);
+
+    auto worker = m_worker;
+    auto interval = m_flushInterval;
+    QMetaObject::invokeMethod(worker,
+                              [=] { worker->setFlushPolicy(interval, sync); });
+
+    Q_EMIT flushPolicyChanged();
+  }
+}
+
+/**
+ * Enables or disables the gzip compression of CSV files. If a CSV file is
+ * open, it is closed so that the next frames are written to a new file.
+ */
+void CSV::Export::setCompressCsv(const bool compress)
+{
+  if (m_compressCsv != compress)
+  {
+    if (m_exportFormat == CsvFormat)
+      closeFile();
+
+    m_compressCsv = compress;
+    m_settings.setValue("CSV_Export_Compress", compress);
+    Q_EMIT compressCsvChanged();
+  }
+}
+
+/**
+ * Changes the size (in @a megabytes) at which a new output file is started,
+ * a value of 0 disables size-based rotation.
+ */
+void CSV::Export::setRotationSize(const int megabytes)
+{
+  const auto size = qBound(0, megabytes, 1024 * 1024);
+  if (m_rotationSize != size)
+  {
+    m_rotationSize = size;
+    m_settings.setValue("CSV_Export_RotationSize", size);
+
+    auto worker = m_worker;
+    auto bytes = static_cast<qint64>(size) * 1024 * 1024;
+    QMetaObject::invokeMethod(worker,
+                              [=] { worker->setRotationSize(bytes); });
+
+    Q_EMIT rotationPolicyChanged();
+  }
+}
+
+/**
+ * Changes the time (in @a minutes) after which a new output file is started,
+ * a value of 0 disables time-based rotation.
+ */
+void CSV::Export::setRotationInterval(const int minutes)
+{
+  const auto interval = qBound(0, minutes, 7 * 24 * 60);
+  if (m_rotationInterval != interval)
+  {
+    m_rotationInterval = interval;
+    m_settings.setValue("CSV_Export_RotationInterval", interval);
+    Q_EMIT rotationPolicyChanged();
+  }
+}
+
+/**
+ * Changes the file format used to export frames. The current file is closed,
+ * so that the next frames are written to a new file with the new format.
+ */
+void CSV::Export::setExportFormat(const int format)
+{
+  if (format != m_exportFormat
+      && (format >= CsvFormat && format <= ArrowFormat))
+  {
+    closeFile();
+    m_exportFormat = format;
+    m_settings.setValue("CSV_Export_Format", format);
+    Q_EMIT exportFormatChanged();
+  }
+}
+
+/**
+ * Changes the interval (in seconds) at which buffered data is written to the
+ * output file.
+ */
+void CSV::Export::setFlushInterval(const int seconds)
+{
+  const auto interval = qBound(1, seconds, 60);
+  if (m_flushInterval != interval)
+  {
+    m_flushInterval = interval;
+    m_settings.setValue("CSV_Export_FlushInterval", interval);
+
+    auto worker = m_worker;
+    auto sync = m_syncToDisk;
+    QMetaObject::invokeMethod(worker,
+                              [=] { worker->setFlushPolicy(interval, sync); });
+
+    Q_EMIT flushPolicyChanged();
+  }
+}
+
 /**
  * Enables or disables data export
  */
@@ -106,89 +738,242 @@ void CSV::Export::setExportEnabled(const bool enabled)
   if (!exportEnabled() && isOpen())
   {
     m_frames.clear();
+    m_bufferedBytes = 0;
     closeFile();
   }
 }
 
 /**
- * Write all remaining JSON frames & close the CSV file
+ * Adds a marker with the given @a label at the current time to the recording,
+ * manual & plugin markers are also registered in the session database.
+ */
+void CSV::Export::addMarker(const QString &label,
+                            const CSV::Marker::Source source)
+{
+  const auto text = label.simplified().isEmpty() ? tr("Marker") : label;
+  writeMarker(QDateTime::currentMSecsSinceEpoch(), source, text);
+  SessionStore::instance().addMarker(text);
+}
+
+/**
+ * Adds a marker with the given @a label, placed by the user, at the current
+ * time to the recording.
+ */
+void CSV::Export::addMarker(const QString &label)
+{
+  addMarker(label, Marker::Manual);
+}
+
+/**
+ * Write all remaining frames & close the CSV file, the file is closed by the
+ * worker thread once it has written all the pending data.
  */
 void CSV::Export::closeFile()
 {
   if (isOpen())
   {
-    while (!m_frames.isEmpty())
-      writeValues();
+    writeValues();
+
+    auto worker = m_worker;
+    QMetaObject::invokeMethod(worker, [=] { worker->close(); });
 
-    m_fieldCount = 0;
-    m_csvFile.close();
-    m_textStream.setDevice(Q_NULLPTR);
+    m_open = false;
+    m_schemaHash = 0;
+    m_schema.clear();
+    m_fileName.clear();
+    m_rotationPending = false;
+    m_overflowWarning = false;
 
     Q_EMIT openChanged();
   }
 }
 
 /**
- * Creates a CSV file based on the JSON frames contained in the JSON list.
- * @note This function is called periodically every 1 second.
+ * Hands the buffered frames over to the worker thread, which writes them to
+ * the output file.
+ *
+ * @note This function is called periodically every 100 milliseconds.
  */
 void CSV::Export::writeValues()
 {
-  // Get separator sequence
-  auto sep = IO::Manager::instance().separatorSequence();
+  // File not open, discard frames
+  if (!isOpen())
+  {
+    m_frames.clear();
+    m_bufferedBytes = 0;
+    return;
+  }
+
+  // Move frames to the worker queue, the worker is also called when there
+  // are no new frames, so that buffered data is flushed periodically
+  QVector<ExportFrame> frames;
+  frames.swap(m_frames);
+  const auto bytes = m_bufferedBytes;
+  auto queued = &m_queuedBytes;
+  auto worker = m_worker;
+  m_queuedBytes += bytes;
+  m_bufferedBytes = 0;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->write(frames);
+    *queued -= bytes;
+  });
+}
+
+/**
+ * Called when the worker thread fails to create the output file
+ */
+void CSV::Export::onOpenFailed()
+{
+  if (!isOpen())
+    return;
+
+  if (m_exportFormat != CsvFormat)
+    Misc::Utilities::showMessageBox(tr("Recording Error"),
+                                    tr("Cannot open recording for writing!"));
+  else
+    Misc::Utilities::showMessageBox(tr("CSV File Error"),
+                                    tr("Cannot open CSV file for writing!"));
+
+  m_frames.clear();
+  m_bufferedBytes = 0;
+  closeFile();
+}
+
+/**
+ * Called when the worker thread detects that the output file exceeds the
+ * rotation size, a new file is created when the next frame is received.
+ */
+void CSV::Export::onRotationRequired()
+{
+  if (isOpen())
+    m_rotationPending = true;
+}
 
-  // Write each frame
-  for (auto i = 0; i < m_frames.count(); ++i)
+/**
+ * Adds a marker to the recording for each alarm that is raised, markers are
+ * placed at the reception time of the frame that raised the alarm.
+ */
+void CSV::Export::onAlarmsTriggered(const QVector<JSON::AlarmEvent> &events)
+{
+  for (const auto &event : events)
   {
-    auto frame = m_frames.at(i);
-    auto fields = QString::fromUtf8(frame.data).split(sep);
+    if (!event.active)
+      continue;
 
-    // File not open, create it & add cell titles
-    if (!isOpen() && exportEnabled())
-      createCsvFile(frame);
+    const auto time = IO::FrameQueue::toMSecsSinceEpoch(event.timestamp);
+    const auto label = QStringLiteral("%1 %2").arg(event.title,
+                                                   event.kindName());
+    writeMarker(time, Marker::Alarm, label);
+  }
+}
 
-    // Write RX date/time
-    m_textStream << frame.rxDateTime.toString("yyyy/MM/dd/ HH:mm:ss::zzz")
-                 << ",";
+/**
+ * Adds a marker to the recording for the frames lost, duplicated or reordered
+ * according to the sequence counters of the project. The events of each
+ * counter are merged by kind, so that a lossy link adds a few markers per
+ * delivery instead of one per frame. Markers are placed at the reception
+ * time of the first frame of each kind.
+ */
+void CSV::Export::onSequenceErrors(const QVector<JSON::SequenceEvent> &events)
+{
+  // Nothing to record
+  if (!isOpen())
+    return;
 
-    // Write frame data
-    for (auto j = 0; j < fields.count(); ++j)
+  // Merge the events of each counter by kind
+  QVector<JSON::SequenceEvent> merged;
+  for (const auto &event : events)
+  {
+    bool found = false;
+    for (auto &item : merged)
     {
-      m_textStream << fields.at(j);
-      if (j < fields.count() - 1)
-        m_textStream << ",";
-
-      else
+      if (item.group == event.group && item.dataset == event.dataset
+          && item.kind == event.kind)
       {
-        auto d = m_fieldCount - fields.count();
-        if (d > 0)
-        {
-          for (auto k = 0; k < d - 1; ++k)
-            m_textStream << ",";
-        }
-
-        m_textStream << "\n";
+        item.count += event.count;
+        found = true;
+        break;
       }
     }
+
+    if (!found)
+      merged.append(event);
   }
 
-  // Clear frames
-  m_frames.clear();
+  // Write a marker for each counter & kind
+  for (const auto &event : merged)
+  {
+    const auto time = IO::FrameQueue::toMSecsSinceEpoch(event.timestamp);
+    const auto label = QStringLiteral("%1 %2 (%3 frames)")
+                           .arg(event.title, event.kindName())
+                           .arg(event.count);
+    writeMarker(time, Marker::Sequence, label);
+  }
 }
 
 /**
- * Creates a new CSV file corresponding to the current project title & field
- * count
+ * Obtains the columns of a new output file from the groups & datasets of the
+ * given @a frame, generates the path of the file from the project title & the
+ * reception @a dateTime, and lets the worker thread create the file.
+ *
+ * Columns are sorted by the field that feeds each dataset, in manual mode,
+ * datasets that share the same field index are only exported once (see
+ * @c CSV::RecordingSchema). The schema is written next to the file, so that
+ * the recording can be replayed without running the frame parser again.
  */
-void CSV::Export::createCsvFile(const CSV::RawFrame &frame)
-{ // Get project title
-  auto projectTitle = UI::Dashboard::instance().title();
+void CSV::Export::createFile(const JSON::Frame &frame,
+                             const QDateTime &dateTime)
+{
+  // Get columns & titles
+  const auto manual = JSON::Generator::instance().operationMode()
+                      == JSON::Generator::kManual;
+  m_schema.build(frame, manual);
+  const auto titles = m_schema.titles();
+  const auto schema = m_schema.toJson();
+
+  // Get file parameters
+  const auto format = m_exportFormat;
+  const auto title = frame.title();
+  const auto sep = IO::Manager::instance().separatorSequence();
+  const auto compress = m_compressCsv && format == CsvFormat;
+  QString suffix = compress ? QStringLiteral("csv.gz") : QStringLiteral("csv");
+  if (format == BinaryFormat)
+    suffix = QStringLiteral("ssrec");
+  else if (format == ArrowFormat)
+    suffix = QStringLiteral("arrows");
+  const auto path = outputFile(title, dateTime, suffix);
 
+  // Create file in the worker thread
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->open(path, format, title, sep, titles, compress);
+    worker->writeSchema(schema);
+  });
+
+  // Update UI
+  m_open = true;
+  m_fileName = path;
+  m_fileDateTime = dateTime;
+  m_rotationPending = false;
+  m_schemaHash = frame.schemaHash();
+  Q_EMIT openChanged();
+}
+
+/**
+ * Returns the path of the output file for a frame of the project with the
+ * given @a projectTitle received at the given @a dateTime. If a file with the
+ * same name already exists (e.g. when files are rotated quickly), a counter
+ * is appended to the file name.
+ */
+QString CSV::Export::outputFile(const QString &projectTitle,
+                                const QDateTime &dateTime,
+                                const QString &suffix)
+{
   // Get file name
-  const QString fileName = frame.rxDateTime.toString("HH-mm-ss") + ".csv";
+  const QString fileName = dateTime.toString("HH-mm-ss") + "." + suffix;
 
   // Get path
-  const QString format = frame.rxDateTime.toString("yyyy/MMM/dd/");
+  const QString format = dateTime.toString("yyyy/MMM/dd/");
   const QString path = QString("%1/Documents/%2/CSV/%3/%4")
                            .arg(QDir::homePath(), qApp->applicationName(),
                                 projectTitle, format);
@@ -198,79 +983,118 @@ void CSV::Export::createCsvFile(const CSV::RawFrame &frame)
   if (!dir.exists())
     dir.mkpath(".");
 
-  // Open file
-  m_csvFile.setFileName(dir.filePath(fileName));
-  if (!m_csvFile.open(QIODevice::WriteOnly | QIODevice::Text))
-  {
-    Misc::Utilities::showMessageBox(tr("CSV File Error"),
-                                    tr("Cannot open CSV file for writing!"));
-    closeFile();
-    return;
-  }
-
-  // Add cell titles & force UTF-8 codec
-  m_textStream.setDevice(&m_csvFile);
-  m_textStream.setGenerateByteOrderMark(true);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-  m_textStream.setCodec("UTF-8");
-#else
-  m_textStream.setEncoding(QStringConverter::Utf8);
-#endif
-
-  // Get number of fields by counting datasets with non-duplicated indexes
-  QVector<int> fields;
-  QVector<QString> titles;
-  for (int i = 0; i < Project::Model::instance().groupCount(); ++i)
+  // Avoid overwriting existing files
+  auto filePath = dir.filePath(fileName);
+  for (int i = 1; QFileInfo::exists(filePath); ++i)
   {
-    for (int j = 0; j < Project::Model::instance().datasetCount(i); ++j)
-    {
-      auto dataset = Project::Model::instance().getDataset(i, j);
-      if (!fields.contains(dataset.index()))
-      {
-        fields.append(dataset.index());
-        titles.append(dataset.title());
-      }
-    }
+    filePath = dir.filePath(QStringLiteral("%1-%2.%3").arg(
+        dateTime.toString("HH-mm-ss"), QString::number(i), suffix));
   }
 
-  // Add table titles
-  m_fieldCount = fields.count();
-  m_textStream << "RX Date/Time,";
-  for (auto i = 0; i < m_fieldCount; ++i)
-  {
-    m_textStream << titles.at(i) << "(field " << i + 1 << ")";
+  return filePath;
+}
 
-    if (i < m_fieldCount - 1)
-      m_textStream << ",";
-    else
-      m_textStream << "\n";
-  }
+/**
+ * Lets the worker thread append the given marker to the marker file of the
+ * current output file. Markers are discarded if no file is open.
+ */
+void CSV::Export::writeMarker(const qint64 timestamp,
+                              const CSV::Marker::Source source,
+                              const QString &label)
+{
+  if (!isOpen())
+    return;
 
-  // Update UI
-  Q_EMIT openChanged();
+  auto worker = m_worker;
+  const auto line = MarkerIndex::encode(timestamp, source, label);
+  QMetaObject::invokeMethod(worker, [=] { worker->writeMarker(line); });
 }
 
 /**
- * Appends the latest data from the device to the output buffer
+ * Obtains the dataset values of the latest batch of frames generated by the
+ * JSON generator & appends them to the output buffer. The reception time of
+ * each frame is obtained from its monotonic timestamp, so that the rows of
+ * different devices (or of resampled frames) keep their relative timing.
+ *
+ * A new output file is created when the first frame is received, when the
+ * structure of the frames changes or when the current file must be rotated
+ * (because of its size or age).
+ *
+ * If the worker thread cannot keep up with the incoming data, this function
+ * waits for it instead of letting the queue grow indefinitely, recorded data
+ * is never discarded. The stall propagates upstream (see the backpressure
+ * policy of the JSON generator).
  */
-void CSV::Export::registerFrame(const QByteArray &data)
+void CSV::Export::registerFrames(const QVector<JSON::Frame> &frames)
 {
   // Ignore if device is not connected (we don't want to generate a CSV file
   // when we are reading another CSV file don't we?)
   if (!IO::Manager::instance().connected())
     return;
 
-  // Ignore if current dashboard frame hasn't been loaded yet
-  if (!UI::Dashboard::instance().currentFrame().isValid())
-    return;
-
   // Ignore if CSV export is disabled
   if (!exportEnabled())
     return;
 
-  // Register raw frame to list
-  RawFrame frame;
-  frame.data = data;
-  frame.rxDateTime = QDateTime::currentDateTime();
-  m_frames.append(frame);
+  // Register frame values to list
+  ExportFrame row;
+  m_frames.reserve(m_frames.count() + frames.count());
+  for (int i = 0; i < frames.count(); ++i)
+  {
+    // Ignore invalid frames
+    const auto &frame = frames.at(i);
+    if (!frame.isValid())
+      continue;
+
+    // Convert the reception time of the frame to system time
+    row.rxDateTime = QDateTime::fromMSecsSinceEpoch(
+        IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp()));
+
+    // Frame structure changed or file must be rotated, start a new file
+    if (isOpen())
+    {
+      const auto expired
+          = m_rotationInterval > 0
+            && m_fileDateTime.msecsTo(row.rxDateTime)
+                   >= static_cast<qint64>(m_rotationInterval) * 60 * 1000;
+      if (m_rotationPending || expired || frame.schemaHash() != m_schemaHash)
+        closeFile();
+    }
+
+    // Create the output file if required
+    if (!isOpen())
+      createFile(frame, row.rxDateTime);
+
+    // Get dataset values
+    qint64 size = 0;
+    row.values.clear();
+    const auto &columns = m_schema.columns();
+    row.values.reserve(columns.count());
+    for (int j = 0; j < columns.count(); ++j)
+    {
+      const auto &column = columns.at(j).first();
+      const auto &group = frame.getGroup(column.first);
+      const auto value = group.getDataset(column.second).value();
+      size += value.size();
+      row.values.append(value);
+    }
+
+    // Queue is full, wait for the worker thread to write the queued data
+    if (m_queuedBytes + m_bufferedBytes + size > MAX_QUEUED_BYTES)
+    {
+      if (!m_overflowWarning)
+        qWarning() << "CSV::Export: write queue full, waiting for the disk";
+
+      m_overflowWarning = true;
+      Misc::Diagnostics::instance().increment(
+          Misc::Diagnostics::Counter::CsvWriteStalls);
+
+      writeValues();
+      while (m_queuedBytes > 0 && m_queuedBytes + size > MAX_QUEUED_BYTES)
+        QThread::msleep(1);
+    }
+
+    m_frames.append(row);
+    m_bufferedBytes += size;
+  }
 }
@@ -22,34 +22,140 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <QFile>
+#include <QThread>
 #include <QVector>
 #include <QObject>
 #include <QVariant>
 #include <QDateTime>
-#include <QTextStream>
 #include <QJsonObject>
+#include <QElapsedTimer>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <JSON/AlarmEngine.h>
+#include <JSON/SequenceTracker.h>
+#include <CSV/ArrowWriter.h>
+#include <CSV/MarkerIndex.h>
+#include <CSV/RecordingSchema.h>
+#include <CSV/BinaryWriter.h>
+#include <Misc/Settings.h>
 
 namespace CSV
 {
+typedef struct
+{
+  QStringList values;
+  QDateTime rxDateTime;
+} ExportFrame;
+
 /**
- * @brief The Export class
+ * @brief The ExportWorker class
+ *
+ * Worker object of the @c Export class, runs in its own thread and formats &
+ * writes the values of the frames received by the application to the output
+ * file.
  *
- * The CSV export class receives data from the @c IO::Manager class and
- * exports the received frames into a CSV file selected by the user.
+ * CSV rows are accumulated in a large memory buffer, which is written to the
+ * file when it is full or when the flush interval expires. Optionally, the
+ * file is synchronized with the storage device after each flush, so that no
+ * data is lost if the computer loses power.
  *
- * CSV-data is generated periodically each time the @c Misc::TimerEvents
- * low-frequency timer expires (e.g. every 1 second). The idea behind this
- * is to allow exporting data, but avoid freezing the application when serial
- * data is received continuously.
+ * CSV rows can be compressed before being written (see @c CSV::Gzip), each
+ * written block is stored as an independent gzip member. After each flush,
+ * the size of the file is compared with the rotation size & a new file is
+ * requested from the @c Export class if the limit is exceeded.
+ *
+ * Event markers are appended to a marker file next to the output file (see
+ * @c CSV::MarkerIndex), so that they follow the file through rotations. The
+ * schema of each file is also written next to it (see
+ * @c CSV::RecordingSchema).
  */
-typedef struct
+class ExportWorker : public QObject
 {
-  QByteArray data;
-  QDateTime rxDateTime;
-} RawFrame;
+  Q_OBJECT
+
+Q_SIGNALS:
+  void openFailed();
+  void rotationRequired();
+
+public:
+  ExportWorker();
+  ~ExportWorker();
+
+public Q_SLOTS:
+  void close();
+  void flush(const bool sync);
+  void write(const QVector<CSV::ExportFrame> &frames);
+  void open(const QString &path, const int format, const QString &title,
+            const QString &separator, const QStringList &titles,
+            const bool compress);
+  void setFlushPolicy(const int interval, const bool sync);
+  void setRotationSize(const qint64 bytes);
+  void writeMarker(const QByteArray &line);
+  void writeSchema(const QByteArray &schema);
+
+private:
+  void writeBuffer();
+  void writeCsv(const QVector<CSV::ExportFrame> &frames);
+  void writeArrow(const QVector<CSV::ExportFrame> &frames);
+  void writeBinary(const QVector<CSV::ExportFrame> &frames);
+
+private:
+  int m_format;
+  bool m_failed;
+  bool m_compress;
+  bool m_syncToDisk;
+  int m_flushInterval;
+  qint64 m_rotationSize;
+  bool m_rotationRequested;
 
-class Export : public QObject
+  QFile m_csvFile;
+  QString m_path;
+  QString m_title;
+  QString m_separator;
+  QStringList m_titles;
+  QByteArray m_buffer;
+  QElapsedTimer m_lastFlush;
+  ArrowWriter m_arrowWriter;
+  BinaryWriter m_binaryWriter;
+};
+
+/**
+ * @brief The Export class
+ *
+ * The CSV export class receives the frames generated by the
+ * @c JSON::Generator class and exports the value of each dataset into a CSV
+ * file, one column per dataset, sorted by the field that feeds each dataset
+ * (see @c CSV::RecordingSchema). Since the values are obtained after parsing,
+ * the exported data is also correct for projects that use a custom frame
+ * parser. The schema of each file is stored next to it, so that the
+ * @c CSV::Player can replay the values without parsing them again.
+ *
+ * Received frames are buffered & handed over to an @c ExportWorker, which
+ * formats them & writes them to disk in a background thread, so that the user
+ * interface never blocks on disk I/O. The amount of data waiting to be
+ * written is bounded, if the storage device cannot keep up with the incoming
+ * data, new frames are discarded until the worker catches up.
+ *
+ * Frames can also be exported to a columnar binary recording (see
+ * @c CSV::BinaryWriter), which is smaller & can be memory-mapped by the
+ * @c CSV::Player, or to an Apache Arrow IPC stream (see @c CSV::ArrowWriter)
+ * with typed columns that can be loaded by data analysis tools.
+ *
+ * For long unattended sessions, the output file can be rotated once it
+ * reaches a given size or after a given time, the next frames are written to
+ * a new file in the same directory. CSV files can also be gzip-compressed
+ * while they are written, the @c CSV::Player reads compressed files directly.
+ *
+ * Timestamped markers can be added to the recording by the user, by plugins
+ * & automatically when an alarm is raised or when frames are lost. Markers
+ * are stored in an index next to the output file, which the @c CSV::Player
+ * uses to jump to them.
+ */
+class Export : public QObject, public JSON::FrameSink
 {
   // clang-format off
     Q_OBJECT
@@ -60,11 +166,42 @@ class Export : public QObject
                READ exportEnabled
                WRITE setExportEnabled
                NOTIFY enabledChanged)
+    Q_PROPERTY(int exportFormat
+               READ exportFormat
+               WRITE setExportFormat
+               NOTIFY exportFormatChanged)
+    Q_PROPERTY(int flushInterval
+               READ flushInterval
+               WRITE setFlushInterval
+               NOTIFY flushPolicyChanged)
+    Q_PROPERTY(bool syncToDisk
+               READ syncToDisk
+               WRITE setSyncToDisk
+               NOTIFY flushPolicyChanged)
+    Q_PROPERTY(int rotationSize
+               READ rotationSize
+               WRITE setRotationSize
+               NOTIFY rotationPolicyChanged)
+    Q_PROPERTY(int rotationInterval
+               READ rotationInterval
+               WRITE setRotationInterval
+               NOTIFY rotationPolicyChanged)
+    Q_PROPERTY(bool compressCsv
+               READ compressCsv
+               WRITE setCompressCsv
+               NOTIFY compressCsvChanged)
+    Q_PROPERTY(QStringList availableExportFormats
+               READ availableExportFormats
+               CONSTANT)
   // clang-format on
 
 Q_SIGNALS:
   void openChanged();
   void enabledChanged();
+  void flushPolicyChanged();
+  void compressCsvChanged();
+  void exportFormatChanged();
+  void rotationPolicyChanged();
 
 private:
   explicit Export();
@@ -78,24 +215,78 @@ private:
 public:
   static Export &instance();
 
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  enum ExportFormat
+  {
+    CsvFormat = 0,
+    BinaryFormat = 1,
+    ArrowFormat = 2,
+  };
+
   bool isOpen() const;
+  bool syncToDisk() const;
+  bool compressCsv() const;
+  int exportFormat() const;
+  int rotationSize() const;
+  int rotationInterval() const;
+  int flushInterval() const;
   bool exportEnabled() const;
+  qint64 queuedBytes() const;
+  QStringList availableExportFormats() const;
+
+  void addMarker(const QString &label, const CSV::Marker::Source source);
 
 public Q_SLOTS:
   void closeFile();
+  void addMarker(const QString &label);
   void openCurrentCsv();
+  void setSyncToDisk(const bool sync);
+  void setCompressCsv(const bool compress);
+  void setRotationSize(const int megabytes);
+  void setRotationInterval(const int minutes);
+  void setExportFormat(const int format);
+  void setFlushInterval(const int seconds);
   void setExportEnabled(const bool enabled);
 
 private Q_SLOTS:
   void writeValues();
-  void registerFrame(const QByteArray &data);
-  void createCsvFile(const CSV::RawFrame &frame);
+  void onOpenFailed();
+  void onRotationRequired();
+  void onAlarmsTriggered(const QVector<JSON::AlarmEvent> &events);
+  void onSequenceErrors(const QVector<JSON::SequenceEvent> &events);
+  void registerFrames(const QVector<JSON::Frame> &frames);
 
 private:
-  QFile m_csvFile;
-  int m_fieldCount;
+  void createFile(const JSON::Frame &frame, const QDateTime &dateTime);
+  QString outputFile(const QString &projectTitle, const QDateTime &dateTime,
+                     const QString &suffix);
+  void writeMarker(const qint64 timestamp, const CSV::Marker::Source source,
+                   const QString &label);
+
+private:
+  bool m_open;
+  bool m_syncToDisk;
+  bool m_compressCsv;
+  int m_exportFormat;
+  int m_flushInterval;
+  int m_rotationSize;
+  int m_rotationInterval;
+  bool m_rotationPending;
   bool m_exportEnabled;
-  QTextStream m_textStream;
-  QVector<RawFrame> m_frames;
+  bool m_overflowWarning;
+  qint64 m_bufferedBytes;
+
+  quint64 m_schemaHash;
+  QString m_fileName;
+  QDateTime m_fileDateTime;
+  Misc::Settings m_settings;
+  RecordingSchema m_schema;
+  QVector<ExportFrame> m_frames;
+  std::atomic<qint64> m_queuedBytes;
+
+  QThread m_thread;
+  ExportWorker *m_worker;
 };
 } // namespace CSV
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QtEndian>
+#include <QFileInfo>
+
+#include <CSV/Gzip.h>
+#include <IO/Checksum.h>
+
+/**
+ * Size of the fixed gzip member header, of the extra field written by
+ * @c compressBlock() & of the member trailer (CRC-32 & size)
+ */
+static const int HEADER_SIZE = 10;
+static const int EXTRA_SIZE = 14;
+static const int TRAILER_SIZE = 8;
+
+/**
+ * Compresses the given @a data as a single gzip member.
+ *
+ * The deflate stream is generated with @c qCompress(), which prepends the
+ * uncompressed size (4 bytes) & a zlib header (2 bytes) & appends the Adler-32
+ * checksum of the data (4 bytes). The size of the deflate stream & the
+ * checksum are stored in the extra field, so that @c decompress() can rebuild
+ * the zlib stream.
+ */
+QByteArray CSV::Gzip::compressBlock(const QByteArray &data)
+{
+  // Compress the data
+  const auto zlib = qCompress(data, 6);
+  if (zlib.size() < 10)
+    return QByteArray();
+
+  const char *deflate = zlib.constData() + 6;
+  const quint32 deflateSize = static_cast<quint32>(zlib.size() - 10);
+
+  // Write the member header, with the FEXTRA flag set
+  static const char header[] = {'\x1f', '\x8b', '\x08', '\x04', 0, 0, 0, 0,
+                                0,      '\xff', 12,     0,      'S', 'S',
+                                8,      0};
+  QByteArray member;
+  member.reserve(zlib.size() + HEADER_SIZE + EXTRA_SIZE + TRAILER_SIZE);
+  member.append(header, sizeof(header));
+
+  // Write the deflate stream size & the Adler-32 checksum (big endian, as
+  // stored by zlib)
+  char extra[4];
+  qToLittleEndian<quint32>(deflateSize, extra);
+  member.append(extra, sizeof(extra));
+  member.append(deflate + deflateSize, 4);
+
+  // Write the deflate stream
+  member.append(deflate, deflateSize);
+
+  // Write the CRC-32 & the uncompressed size
+  char trailer[TRAILER_SIZE];
+  qToLittleEndian<quint32>(IO::crc32(data.constData(), data.size()), trailer);
+  qToLittleEndian<quint32>(static_cast<quint32>(data.size()), trailer + 4);
+  member.append(trailer, sizeof(trailer));
+  return member;
+}
+
+/**
+ * Returns @c true if the given gzip member @a header (fixed header & extra
+ * field) was written by @c compressBlock()
+ */
+static bool validHeader(const QByteArray &header)
+{
+  if (header.size() < HEADER_SIZE + EXTRA_SIZE)
+    return false;
+
+  const auto *h = reinterpret_cast<const uchar *>(header.constData());
+  return h[0] == 0x1f && h[1] == 0x8b && h[2] == 8 && h[3] == 0x04
+         && qFromLittleEndian<quint16>(h + 10) == 12 && h[12] == 'S'
+         && h[13] == 'S' && qFromLittleEndian<quint16>(h + 14) == 8;
+}
+
+/**
+ * Decompresses the gzip members written by @c compressBlock() from the
+ * @a input device & writes the decompressed data to the @a output device.
+ *
+ * Returns @c false if the input is not a valid file, if it was not written
+ * by @c compressBlock() or if a member is damaged. A truncated last member
+ * (e.g. if the application was closed unexpectedly) is ignored.
+ */
+bool CSV::Gzip::decompress(QIODevice *input, QIODevice *output)
+{
+  // Validate arguments
+  if (!input || !output)
+    return false;
+
+  // Read each member
+  bool valid = false;
+  while (!input->atEnd())
+  {
+    // Read & validate the member header
+    const auto header = input->read(HEADER_SIZE + EXTRA_SIZE);
+    if (header.size() < HEADER_SIZE + EXTRA_SIZE)
+      return valid;
+
+    if (!validHeader(header))
+      return false;
+
+    // Read the deflate stream & the trailer
+    const auto *h = reinterpret_cast<const uchar *>(header.constData());
+    const auto size = qFromLittleEndian<quint32>(h + 16);
+    const auto deflate = input->read(size);
+    const auto trailer = input->read(TRAILER_SIZE);
+    if (deflate.size() != static_cast<int>(size)
+        || trailer.size() != TRAILER_SIZE)
+      return valid;
+
+    // Rebuild the zlib stream expected by qUncompress()
+    const auto *t = reinterpret_cast<const uchar *>(trailer.constData());
+    const auto length = qFromLittleEndian<quint32>(t + 4);
+    QByteArray zlib;
+    zlib.reserve(static_cast<int>(size) + 10);
+    char prefix[6];
+    qToBigEndian<quint32>(length, prefix);
+    prefix[4] = '\x78';
+    prefix[5] = '\x9c';
+    zlib.append(prefix, sizeof(prefix));
+    zlib.append(deflate);
+    zlib.append(header.constData() + 20, 4);
+
+    // Decompress & verify the member
+    const auto data = qUncompress(zlib);
+    if (static_cast<quint32>(data.size()) != length
+        || IO::crc32(data.constData(), data.size())
+               != qFromLittleEndian<quint32>(t))
+      return false;
+
+    // Write the decompressed data
+    if (output->write(data) != data.size())
+      return false;
+
+    valid = true;
+  }
+
+  return valid;
+}
+
+/**
+ * Returns @c true if the file at the given @a path is a compressed recording
+ */
+bool CSV::Gzip::isCompressed(const QString &path)
+{
+  return QFileInfo(path).suffix().toLower() == QStringLiteral("gz");
+}
+
+/**
+ * Returns @c true if the compressed file at the given @a path was written by
+ * @c compressBlock() & can be read by @c decompress().
+ *
+ * Ordinary gzip streams (e.g. files compressed with the @c gzip tool) do not
+ * store the size of their deflate streams, which cannot be read back without
+ * a streaming inflater, such files must be decompressed before opening them.
+ */
+bool CSV::Gzip::isSupported(const QString &path)
+{
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  return validHeader(file.read(HEADER_SIZE + EXTRA_SIZE));
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QIODevice>
+#include <QByteArray>
+
+namespace CSV
+{
+/**
+ * Functions used to write & read compressed recordings.
+ *
+ * Compressed recordings are standard gzip files (RFC 1952) made of multiple
+ * members, one member per block of data written by the export worker, so
+ * that they can be decompressed by any gzip tool & data is never lost if the
+ * application stops before the file is closed.
+ *
+ * Since Qt only exposes the zlib format through @c qCompress() &
+ * @c qUncompress(), each member stores the size of its deflate stream & the
+ * Adler-32 checksum of its data in an extra header field (subfield ID "SS"),
+ * which allows reading it back without a streaming inflater. Standard gzip
+ * tools ignore this field, but files compressed by other tools cannot be
+ * read back (see @c isSupported()).
+ */
+namespace Gzip
+{
+QByteArray compressBlock(const QByteArray &data);
+bool decompress(QIODevice *input, QIODevice *output);
+bool isCompressed(const QString &path);
+bool isSupported(const QString &path);
+} // namespace Gzip
+} // namespace CSV
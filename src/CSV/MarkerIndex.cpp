@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "MarkerIndex.h"
+
+#include <QFile>
+#include <algorithm>
+
+/**
+ * Names of the marker sources, in the same order as @c Marker::Source
+ */
+static const char *SOURCE_NAMES[] = {"manual", "alarm", "plugin", "sequence"};
+
+/**
+ * Constructor function
+ */
+CSV::MarkerIndex::MarkerIndex() {}
+
+/**
+ * Returns the path of the marker file of the given @a recording
+ */
+QString CSV::MarkerIndex::indexPath(const QString &recording)
+{
+  return recording + QStringLiteral(".markers");
+}
+
+/**
+ * Returns the line that represents the given marker in the marker file, tabs
+ * & line breaks in the @a label are replaced with spaces.
+ */
+QByteArray CSV::MarkerIndex::encode(const qint64 timestamp,
+                                    const Marker::Source source,
+                                    const QString &label)
+{
+  auto text = label.simplified().toUtf8();
+  text.replace('\t', ' ');
+
+  QByteArray line = QByteArray::number(timestamp);
+  line.append('\t');
+  line.append(SOURCE_NAMES[source]);
+  line.append('\t');
+  line.append(text);
+  line.append('\n');
+  return line;
+}
+
+/**
+ * Reads the markers of the given @a recording, returns @c false if the
+ * recording has no marker file. Invalid lines are ignored.
+ */
+bool CSV::MarkerIndex::load(const QString &recording)
+{
+  // Remove previous markers
+  clear();
+
+  // Open the marker file
+  QFile file(indexPath(recording));
+  if (!file.open(QFile::ReadOnly))
+    return false;
+
+  // Parse each line
+  while (!file.atEnd())
+  {
+    const auto fields = file.readLine().trimmed().split('\t');
+    if (fields.count() < 2)
+      continue;
+
+    bool ok = false;
+    Marker marker;
+    marker.timestamp = fields.at(0).toLongLong(&ok);
+    if (!ok)
+      continue;
+
+    marker.source = Marker::Manual;
+    for (int i = 0; i <= Marker::Sequence; ++i)
+    {
+      if (fields.at(1) == SOURCE_NAMES[i])
+        marker.source = static_cast<Marker::Source>(i);
+    }
+
+    if (fields.count() > 2)
+      marker.label = QString::fromUtf8(fields.at(2));
+
+    m_markers.append(marker);
+  }
+
+  // Markers can be written out of order (e.g. alarms are registered with
+  // the reception time of their frame), sort them by time
+  std::stable_sort(m_markers.begin(), m_markers.end(),
+                   [](const Marker &a, const Marker &b) {
+                     return a.timestamp < b.timestamp;
+                   });
+
+  // Index the position of each label
+  for (int i = 0; i < m_markers.count(); ++i)
+    m_labels[m_markers.at(i).label].append(i);
+
+  return true;
+}
+
+/**
+ * Removes all the markers from the index
+ */
+void CSV::MarkerIndex::clear()
+{
+  m_markers.clear();
+  m_labels.clear();
+}
+
+/**
+ * Returns the number of markers in the index
+ */
+int CSV::MarkerIndex::count() const
+{
+  return m_markers.count();
+}
+
+/**
+ * Returns the marker at the given @a index, markers are sorted by time
+ */
+const CSV::Marker &CSV::MarkerIndex::at(const int index) const
+{
+  return m_markers.at(index);
+}
+
+/**
+ * Returns the index of the given @a occurrence (starting at 0) of the marker
+ * with the given @a label, or -1 if there is no such marker.
+ */
+int CSV::MarkerIndex::find(const QString &label, const int occurrence) const
+{
+  const auto it = m_labels.constFind(label);
+  if (it == m_labels.constEnd() || occurrence < 0
+      || occurrence >= it.value().count())
+    return -1;
+
+  return it.value().at(occurrence);
+}
+
+/**
+ * Returns the index of the first marker placed after the given @a timestamp,
+ * or -1 if there are no markers after it.
+ */
+int CSV::MarkerIndex::next(const qint64 timestamp) const
+{
+  const auto it = std::upper_bound(
+      m_markers.cbegin(), m_markers.cend(), timestamp,
+      [](const qint64 time, const Marker &m) { return time < m.timestamp; });
+
+  if (it == m_markers.cend())
+    return -1;
+
+  return static_cast<int>(it - m_markers.cbegin());
+}
+
+/**
+ * Returns the index of the last marker placed before the given @a timestamp,
+ * or -1 if there are no markers before it.
+ */
+int CSV::MarkerIndex::previous(const qint64 timestamp) const
+{
+  const auto it = std::lower_bound(
+      m_markers.cbegin(), m_markers.cend(), timestamp,
+      [](const Marker &m, const qint64 time) { return m.timestamp < time; });
+
+  return static_cast<int>(it - m_markers.cbegin()) - 1;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+
+namespace CSV
+{
+/**
+ * @brief The Marker struct
+ *
+ * Event marker of a recording, the @a timestamp is the time (in milliseconds
+ * since epoch) at which the event happened, which is on the same clock as the
+ * RX date/time of the recorded rows.
+ */
+struct Marker
+{
+  enum Source
+  {
+    Manual,
+    Alarm,
+    Plugin,
+    Sequence
+  };
+
+  qint64 timestamp;
+  Source source;
+  QString label;
+};
+
+/**
+ * @brief The MarkerIndex class
+ *
+ * Markers are stored in a small text file next to the recording (the path of
+ * the recording with the @c .markers suffix), one marker per line with the
+ * timestamp, source & label separated by tabs. Since the recording itself is
+ * never modified, markers can be added to any output format & the file can
+ * be edited by hand.
+ *
+ * When a recording is opened by the @c CSV::Player, its markers are loaded &
+ * sorted by time, and the position of each marker is indexed by label, so
+ * that looking up the n-th occurrence of a label takes constant time & the
+ * previous/next marker of any point in time is found with a binary search.
+ */
+class MarkerIndex
+{
+public:
+  MarkerIndex();
+
+  static QString indexPath(const QString &recording);
+  static QByteArray encode(const qint64 timestamp, const Marker::Source source,
+                           const QString &label);
+
+  bool load(const QString &recording);
+  void clear();
+
+  int count() const;
+  const Marker &at(const int index) const;
+
+  int find(const QString &label, const int occurrence) const;
+  int next(const qint64 timestamp) const;
+  int previous(const qint64 timestamp) const;
+
+private:
+  QVector<Marker> m_markers;
+  QHash<QString, QVector<int>> m_labels;
+};
+} // namespace CSV
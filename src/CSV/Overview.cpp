@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include <QFile>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+
+#include <CSV/Overview.h>
+#include <CSV/CsvReader.h>
+#include <CSV/BinaryReader.h>
+
+/**
+ * Maximum number of segments in which the rows of a recording are split, this
+ * is roughly the width (in pixels) of the timeline of the CSV player
+ */
+static const int OVERVIEW_BINS = 512;
+
+/**
+ * Identifier & version of the overview cache files
+ */
+static const quint32 CACHE_MAGIC = 0x53534f56;
+static const quint32 CACHE_VERSION = 1;
+
+/**
+ * Returns the path of the overview cache file of the given recording
+ */
+static QString CACHE_PATH(const QString &path)
+{
+  return path + QStringLiteral(".overview");
+}
+
+/**
+ * Reads the overview of the recording located at the given @a path from its
+ * cache file, the cache is only valid if the size & modification time of the
+ * recording match the ones stored in the cache.
+ */
+static bool READ_CACHE(const QString &path, CSV::OverviewData &data)
+{
+  // Open the cache file
+  QFile file(CACHE_PATH(path));
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  // Validate the header
+  quint32 magic, version;
+  qint64 size, modified;
+  QDataStream stream(&file);
+  stream >> magic >> version >> size >> modified;
+  const QFileInfo info(path);
+  if (magic != CACHE_MAGIC || version != CACHE_VERSION || size != info.size()
+      || modified != info.lastModified().toMSecsSinceEpoch())
+    return false;
+
+  // Read the overview
+  qint32 bins;
+  QStringList titles;
+  stream >> bins >> titles >> data.min >> data.max;
+  const int values = bins * titles.count();
+  if (stream.status() != QDataStream::Ok || bins <= 0
+      || data.min.count() != values || data.max.count() != values)
+    return false;
+
+  data.bins = bins;
+  data.titles = titles;
+  return true;
+}
+
+/**
+ * Writes the overview of the recording located at the given @a path to its
+ * cache file. Errors are ignored (e.g. if the folder of the recording is read
+ * only), the overview is simply calculated again the next time.
+ */
+static void WRITE_CACHE(const QString &path, const CSV::OverviewData &data)
+{
+  QSaveFile file(CACHE_PATH(path));
+  if (!file.open(QIODevice::WriteOnly))
+    return;
+
+  const QFileInfo info(path);
+  QDataStream stream(&file);
+  stream << CACHE_MAGIC << CACHE_VERSION << qint64(info.size())
+         << qint64(info.lastModified().toMSecsSinceEpoch())
+         << qint32(data.bins) << QStringList(data.titles) << data.min
+         << data.max;
+
+  if (stream.status() == QDataStream::Ok)
+    file.commit();
+  else
+    file.cancelWriting();
+}
+
+/**
+ * Calculates the overview of a recording with the given number of @a rows and
+ * the given column @a titles. The @a reader function is called for each row
+ * and must return its values (NaN for cells that are not numeric).
+ *
+ * Returns @c false if the calculation was aborted.
+ */
+template<typename Reader>
+static bool SCAN(const int rows, const QStringList &titles, Reader reader,
+                 const std::atomic<bool> *abort, CSV::OverviewData &data)
+{
+  // Initialize the overview
+  const int columns = titles.count();
+  const int bins = qMin(rows, OVERVIEW_BINS);
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  data.bins = bins;
+  data.titles = titles;
+  data.min.fill(nan, bins * columns);
+  data.max.fill(nan, bins * columns);
+  if (bins <= 0 || columns <= 0)
+    return true;
+
+  // Update the extremes of the segment of each row
+  QVector<double> values(columns);
+  for (int row = 0; row < rows; ++row)
+  {
+    if (*abort)
+      return false;
+
+    reader(row, values);
+    const int bin = static_cast<int>(qint64(row) * bins / rows);
+    for (int column = 0; column < columns; ++column)
+    {
+      const auto value = static_cast<float>(values.at(column));
+      if (std::isnan(value))
+        continue;
+
+      auto &min = data.min[column * bins + bin];
+      auto &max = data.max[column * bins + bin];
+      if (std::isnan(min) || value < min)
+        min = value;
+      if (std::isnan(max) || value > max)
+        max = value;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Converts the given cell @a text to a number, NaN if it is not numeric
+ */
+static double NUMBER(const QString &text)
+{
+  bool ok = false;
+  const auto value = text.toDouble(&ok);
+  return ok ? value : std::numeric_limits<double>::quiet_NaN();
+}
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+CSV::OverviewWorker::OverviewWorker()
+  : m_generation(0)
+  , m_overview(Q_NULLPTR)
+  , m_abort(Q_NULLPTR)
+{
+}
+
+/**
+ * Destructor function, closes the CSV reader (if any)
+ */
+CSV::OverviewWorker::~OverviewWorker()
+{
+  cancel();
+}
+
+/**
+ * Stops processing the current recording, the CSV reader (if any) is closed
+ * so that the file is no longer indexed.
+ */
+void CSV::OverviewWorker::cancel()
+{
+  m_csv.reset();
+  m_path.clear();
+}
+
+/**
+ * Calculates the overview of the recording located at the given @a path and
+ * publishes it to the given @a overview. The cache file of the recording is
+ * used if it is valid.
+ *
+ * CSV files are opened with a reader owned by the worker thread, the rows are
+ * read once the file has been indexed (see @c onCsvIndexed()).
+ */
+void CSV::OverviewWorker::process(CSV::Overview *overview,
+                                  const quint64 generation,
+                                  const QString &path,
+                                  const std::atomic<bool> *abort)
+{
+  // Stop processing the previous recording
+  cancel();
+  m_path = path;
+  m_abort = abort;
+  m_overview = overview;
+  m_generation = generation;
+
+  // Use the cached overview
+  OverviewData data;
+  if (READ_CACHE(path, data))
+  {
+    publish(data, false);
+    return;
+  }
+
+  // Read the rows of a binary recording
+  if (QFileInfo(path).suffix().toLower() == "ssrec")
+  {
+    BinaryReader binary;
+    if (!binary.open(path))
+      return;
+
+    auto reader = [&](const int row, QVector<double> &values) {
+      for (int i = 0; i < values.count(); ++i)
+        values[i] = NUMBER(binary.value(row, i));
+    };
+
+    if (SCAN(binary.rowCount(), binary.titles(), reader, abort, data))
+      publish(data, true);
+
+    return;
+  }
+
+  // Index the CSV file
+  m_csv.reset(new CsvReader());
+  connect(m_csv.data(), &CsvReader::indexed, this,
+          &OverviewWorker::onCsvIndexed);
+  if (!m_csv->open(path))
+    m_csv.reset();
+}
+
+/**
+ * Reads the rows of the CSV file once it has been indexed
+ */
+void CSV::OverviewWorker::onCsvIndexed()
+{
+  // Validate reader
+  if (!m_csv || !m_csv->isOpen() || m_csv->rowCount() <= 0)
+    return;
+
+  // Get column titles, the first column is the reception date/time
+  auto titles = m_csv->row(0);
+  if (!titles.isEmpty())
+    titles.removeFirst();
+
+  // Read the values of each row
+  auto csv = m_csv.data();
+  auto reader = [=](const int row, QVector<double> &values) {
+    const auto list = csv->row(row + 1);
+    for (int i = 0; i < values.count(); ++i)
+      values[i] = NUMBER(list.value(i + 1));
+  };
+
+  // Publish the overview & release the file
+  OverviewData data;
+  if (SCAN(m_csv->rowCount() - 1, titles, reader, m_abort, data))
+    publish(data, true);
+
+  // The reader emitted the signal that called this function, delete it later
+  m_csv.take()->deleteLater();
+}
+
+/**
+ * Sends the given overview @a data to the overview object, and writes it to
+ * the cache file of the recording if @a store is @c true.
+ */
+void CSV::OverviewWorker::publish(const OverviewData &data, const bool store)
+{
+  if (store)
+    WRITE_CACHE(m_path, data);
+
+  auto overview = m_overview;
+  auto generation = m_generation;
+  QMetaObject::invokeMethod(
+      overview, [=] { overview->onFinished(generation, data); });
+}
+
+//----------------------------------------------------------------------------------------
+// Overview implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, starts the worker thread
+ */
+CSV::Overview::Overview()
+  : m_generation(0)
+  , m_abort(false)
+  , m_worker(new OverviewWorker())
+{
+  m_thread.setObjectName(QStringLiteral("CSV::OverviewWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  m_thread.start(QThread::LowPriority);
+}
+
+/**
+ * Destructor function, stops the worker thread
+ */
+CSV::Overview::~Overview()
+{
+  m_abort = true;
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns @c true if the overview of the current recording is available
+ */
+bool CSV::Overview::isAvailable() const
+{
+  return m_data.bins > 0 && !m_data.titles.isEmpty();
+}
+
+/**
+ * Returns the number of segments in which the rows were split
+ */
+int CSV::Overview::bins() const
+{
+  return m_data.bins;
+}
+
+/**
+ * Returns the titles of the columns of the overview
+ */
+StringList CSV::Overview::titles() const
+{
+  return m_data.titles;
+}
+
+/**
+ * Returns the minimum & maximum of each segment of the given @a column,
+ * interleaved (min0, max0, min1, max1...) & mapped from the range of the
+ * column to [0, 1]. Segments without numeric values are NaN.
+ */
+QVariantList CSV::Overview::samples(const int column) const
+{
+  // Validate column
+  QVariantList list;
+  if (column < 0 || column >= m_data.titles.count() || m_data.bins <= 0)
+    return list;
+
+  // Get the range of the column
+  const int bins = m_data.bins;
+  const int offset = column * bins;
+  float low = std::numeric_limits<float>::max();
+  float high = std::numeric_limits<float>::lowest();
+  for (int i = offset; i < offset + bins; ++i)
+  {
+    if (!std::isnan(m_data.min.at(i)))
+      low = qMin(low, m_data.min.at(i));
+    if (!std::isnan(m_data.max.at(i)))
+      high = qMax(high, m_data.max.at(i));
+  }
+
+  // Normalize the extremes of each segment
+  const double range = high > low ? high - low : 1;
+  list.reserve(bins * 2);
+  for (int i = offset; i < offset + bins; ++i)
+  {
+    list.append((m_data.min.at(i) - low) / range);
+    list.append((m_data.max.at(i) - low) / range);
+  }
+
+  return list;
+}
+
+/**
+ * Calculates the overview of the recording located at the given @a path in
+ * the background, @c changed() is emitted when it is available.
+ */
+void CSV::Overview::open(const QString &path)
+{
+  // Discard the previous overview
+  close();
+  if (path.isEmpty())
+    return;
+
+  // Process the recording in the worker thread
+  auto abort = &m_abort;
+  auto overview = this;
+  auto worker = m_worker;
+  auto generation = m_generation;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->process(overview, generation, path, abort);
+  });
+}
+
+/**
+ * Discards the overview & stops the calculation of the current one
+ */
+void CSV::Overview::close()
+{
+  // Stop the worker & wait until it no longer reads the recording
+  m_abort = true;
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(
+      worker, [=] { worker->cancel(); }, Qt::BlockingQueuedConnection);
+
+  // Reset state, results from previous calculations are ignored
+  ++m_generation;
+  m_abort = false;
+  const bool available = isAvailable();
+  m_data = OverviewData();
+  if (available)
+    Q_EMIT changed();
+}
+
+/**
+ * Registers the overview @a data calculated by the worker, unless it belongs
+ * to a recording that has been closed since.
+ */
+void CSV::Overview::onFinished(const quint64 generation,
+                               const OverviewData &data)
+{
+  if (generation != m_generation)
+    return;
+
+  m_data = data;
+  Q_EMIT changed();
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QThread>
+#include <QObject>
+#include <QVector>
+#include <QVariantList>
+#include <QScopedPointer>
+
+#include <DataTypes.h>
+
+namespace CSV
+{
+class CsvReader;
+class Overview;
+
+/**
+ * @brief The OverviewData struct
+ *
+ * Minimum & maximum value of each column of a recording, for each of the
+ * @c bins segments in which its rows are split. Values are stored column by
+ * column, bins without numeric values are NaN.
+ */
+struct OverviewData
+{
+  int bins = 0;
+  StringList titles;
+  QVector<float> min;
+  QVector<float> max;
+};
+
+/**
+ * @brief The OverviewWorker class
+ *
+ * Worker object of the @c Overview, runs in its own thread and reads the rows
+ * of a recording (with its own @c CsvReader or @c BinaryReader) to calculate
+ * the overview of each column. The overview is stored in a cache file next to
+ * the recording, which is read instead of the recording the next time that it
+ * is opened.
+ */
+class OverviewWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  OverviewWorker();
+  ~OverviewWorker();
+
+  void cancel();
+  void process(CSV::Overview *overview, const quint64 generation,
+               const QString &path, const std::atomic<bool> *abort);
+
+private Q_SLOTS:
+  void onCsvIndexed();
+
+private:
+  void publish(const OverviewData &data, const bool store);
+
+private:
+  QString m_path;
+  quint64 m_generation;
+  CSV::Overview *m_overview;
+  const std::atomic<bool> *m_abort;
+  QScopedPointer<CsvReader> m_csv;
+};
+
+/**
+ * @brief The Overview class
+ *
+ * Timeline overview of a recording, displayed by the CSV player under its
+ * progress slider so that the user can see where the interesting parts of a
+ * long recording are & jump directly to them.
+ *
+ * The rows of the recording are split in (at most) @c OVERVIEW_BINS segments
+ * of the same number of rows & the minimum/maximum of each column is
+ * calculated for each segment by a worker thread (see @c OverviewWorker),
+ * so opening a recording is never delayed by the overview.
+ */
+class Overview : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void changed();
+
+public:
+  Overview();
+  ~Overview();
+
+  bool isAvailable() const;
+  int bins() const;
+  StringList titles() const;
+  QVariantList samples(const int column) const;
+
+  void open(const QString &path);
+  void close();
+
+private:
+  friend class OverviewWorker;
+  void onFinished(const quint64 generation, const OverviewData &data);
+
+private:
+  quint64 m_generation;
+  std::atomic<bool> m_abort;
+  OverviewData m_data;
+
+  QThread m_thread;
+  OverviewWorker *m_worker;
+};
+} // namespace CSV
@@ -24,23 +24,42 @@
 
 #include <QtMath>
 #include <QFileDialog>
+#include <QDebug>
 #include <QApplication>
 
-#include <qtcsv/stringdata.h>
-#include <qtcsv/reader.h>
-
+#include <CSV/Gzip.h>
 #include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
 #include <Misc/Utilities.h>
 
+/**
+ * Interval (in milliseconds) at which the playback scheduler is executed
+ */
+static const int TICK_INTERVAL = 5;
+
+/**
+ * Maximum time (in milliseconds) spent sending frames on each scheduler tick,
+ * so that the user interface remains responsive in "as fast as possible" mode
+ */
+static const int TICK_BUDGET = 8;
+
 /**
  * Constructor function
  */
 CSV::Player::Player()
   : m_framePos(0)
   , m_playing(false)
+  , m_speed(1)
+  , m_clockOrigin(0)
   , m_timestamp("")
 {
-  connect(this, SIGNAL(playerStateChanged()), this, SLOT(updateData()));
+  m_timer.setInterval(TICK_INTERVAL);
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this, &Player::onTick);
+  connect(&m_csv, &CsvReader::indexed, this, &Player::onCsvIndexed);
+  connect(&m_csv, &CsvReader::progressChanged, this, &Player::loadingChanged);
+  connect(&m_overview, &Overview::changed, this, &Player::overviewChanged);
 }
 
 /**
@@ -57,7 +76,24 @@ CSV::Player &CSV::Player::instance()
  */
 bool CSV::Player::isOpen() const
 {
-  return m_csvFile.isOpen();
+  return m_csv.isOpen() || m_binary.isOpen();
+}
+
+/**
+ * Returns @c true if a CSV file is being indexed before it can be played
+ */
+bool CSV::Player::isLoading() const
+{
+  return m_csv.isIndexing();
+}
+
+/**
+ * Returns the playback speed multiplier, a value of 0 means that frames are
+ * played as fast as possible.
+ */
+qreal CSV::Player::speed() const
+{
+  return m_speed;
 }
 
 /**
@@ -68,6 +104,14 @@ qreal CSV::Player::progress() const
   return ((qreal)framePosition()) / frameCount();
 }
 
+/**
+ * Returns the indexing progress of the CSV file in a range from 0.0 to 1.0
+ */
+qreal CSV::Player::loadingProgress() const
+{
+  return m_csv.progress();
+}
+
 /**
  * Returns @c true if the user is currently re-playing the CSV file at real-time
  * speed.
@@ -82,9 +126,12 @@ bool CSV::Player::isPlaying() const
  */
 QString CSV::Player::filename() const
 {
+  if (m_binary.isOpen())
+    return QFileInfo(m_binary.fileName()).fileName();
+
   if (isOpen())
   {
-    auto fileInfo = QFileInfo(m_csvFile.fileName());
+    auto fileInfo = QFileInfo(m_csv.fileName());
     return fileInfo.fileName();
   }
 
@@ -98,7 +145,10 @@ QString CSV::Player::filename() const
  */
 int CSV::Player::frameCount() const
 {
-  return m_csvData.count() - 1;
+  if (m_binary.isOpen())
+    return m_binary.rowCount() - 1;
+
+  return m_csv.rowCount() - 1;
 }
 
 /**
@@ -135,13 +185,87 @@ QString CSV::Player::csvFilesPath() const
   return path;
 }
 
+/**
+ * Returns @c true if the timeline overview of the current file is available
+ */
+bool CSV::Player::overviewAvailable() const
+{
+  return m_overview.isAvailable();
+}
+
+/**
+ * Returns the titles of the columns displayed by the timeline overview
+ */
+StringList CSV::Player::overviewTitles() const
+{
+  return m_overview.titles();
+}
+
+/**
+ * Returns the normalized minimum & maximum of each segment of the timeline
+ * overview for the given @a column (see @c CSV::Overview::samples())
+ */
+QVariantList CSV::Player::overview(const int column) const
+{
+  return m_overview.samples(column);
+}
+
+/**
+ * Returns the number of event markers of the recording
+ */
+int CSV::Player::markerCount() const
+{
+  return m_markers.count();
+}
+
+/**
+ * Returns the label, source & relative position (from 0.0 to 1.0) in the
+ * recording of each event marker, sorted by time.
+ */
+QVariantList CSV::Player::markers() const
+{
+  QVariantList list;
+  if (!isOpen() || frameCount() <= 0)
+    return list;
+
+  const auto first = frameTime(0);
+  const auto span = qMax<qint64>(1, frameTime(frameCount() - 1) - first);
+  for (int i = 0; i < m_markers.count(); ++i)
+  {
+    const auto &marker = m_markers.at(i);
+    const auto position = qreal(marker.timestamp - first) / span;
+
+    QVariantMap map;
+    map.insert("label", marker.label);
+    map.insert("source", static_cast<int>(marker.source));
+    map.insert("position", qBound<qreal>(0, position, 1));
+    list.append(map);
+  }
+
+  return list;
+}
+
+/**
+ * Returns the index of the given @a occurrence (starting at 0) of the event
+ * marker with the given @a label, or -1 if the recording has no such marker.
+ */
+int CSV::Player::findMarker(const QString &label, const int occurrence) const
+{
+  return m_markers.find(label, occurrence);
+}
+
 /**
  * Enables CSV playback at 'live' speed (as it happened when CSV file was
  * saved to the computer).
  */
 void CSV::Player::play()
 {
+  if (!isOpen() || framePosition() >= frameCount())
+    return;
+
   m_playing = true;
+  restartClock();
+  m_timer.start();
   Q_EMIT playerStateChanged();
 }
 
@@ -152,6 +276,7 @@ void CSV::Player::play()
 void CSV::Player::pause()
 {
   m_playing = false;
+  m_timer.stop();
   Q_EMIT playerStateChanged();
 }
 
@@ -160,8 +285,10 @@ void CSV::Player::pause()
  */
 void CSV::Player::toggle()
 {
-  m_playing = !m_playing;
-  Q_EMIT playerStateChanged();
+  if (isPlaying())
+    pause();
+  else
+    play();
 }
 
 /**
@@ -176,7 +303,10 @@ void CSV::Player::openFile()
                 Q_NULLPTR,
                 tr("Select CSV file"),
                 csvFilesPath(),
-                tr("CSV files") + " (*.csv)");
+                tr("Recordings") + " (*.csv *.csv.gz *.ssrec);;" +
+                tr("CSV files") + " (*.csv);;" +
+                tr("Compressed CSV recordings") + " (*.csv.gz);;" +
+                tr("Binary recordings") + " (*.ssrec)");
 
     // Open CSV file
     if (!file.isEmpty())
@@ -192,12 +322,19 @@ void CSV::Player::openFile()
 void CSV::Player::closeFile()
 {
   m_framePos = 0;
-  m_csvFile.close();
-  m_csvData.clear();
+  m_timer.stop();
+  m_csv.close();
+  m_binary.close();
+  m_overview.close();
+  m_markers.clear();
+  m_schema.clear();
+  m_frame.clear();
   m_playing = false;
   m_timestamp = "--.--";
 
   Q_EMIT openChanged();
+  Q_EMIT loadingChanged();
+  Q_EMIT markersChanged();
   Q_EMIT timestampChanged();
   Q_EMIT playerStateChanged();
 }
@@ -214,6 +351,15 @@ void CSV::Player::nextFrame()
   }
 }
 
+/**
+ * Jumps to the first event marker placed after the current frame
+ */
+void CSV::Player::nextMarker()
+{
+  if (isOpen())
+    jumpToMarker(m_markers.next(frameTime(framePosition())));
+}
+
 /**
  * Reads & processes the previous CSV row (until we get to the first row)
  */
@@ -227,9 +373,50 @@ void CSV::Player::previousFrame()
 }
 
 /**
- * Opens a CSV file and valitates it by comparing every data row with the title
- * row. If one of the data rows does not correspond to the title row, the CSV
- * is considered to be invalid.
+ * Jumps to the last event marker placed before the current frame, markers
+ * that lead to the current frame are skipped.
+ */
+void CSV::Player::previousMarker()
+{
+  if (isOpen() && framePosition() > 0)
+    jumpToMarker(m_markers.previous(frameTime(framePosition() - 1) + 1));
+}
+
+/**
+ * Pauses the player & shows the first frame received at (or after) the time
+ * of the event marker with the given @a index.
+ */
+void CSV::Player::jumpToMarker(const int index)
+{
+  if (!isOpen() || index < 0 || index >= m_markers.count())
+    return;
+
+  if (isPlaying())
+    pause();
+
+  m_framePos = frameAt(m_markers.at(index).timestamp);
+  updateData();
+}
+
+/**
+ * Changes the playback @a speed multiplier (between 0.1x and 100x), a value
+ * of 0 plays the frames as fast as possible.
+ */
+void CSV::Player::setSpeed(const qreal speed)
+{
+  const auto value = speed <= 0 ? 0 : qBound<qreal>(0.1, speed, 100);
+  if (!qFuzzyCompare(value + 1, m_speed + 1))
+  {
+    m_speed = value;
+    restartClock();
+    Q_EMIT speedChanged();
+  }
+}
+
+/**
+ * Opens a CSV file or a binary recording. CSV files are indexed in the
+ * background, the player is opened once all the rows have been indexed (see
+ * @c onCsvIndexed()).
  */
 void CSV::Player::openFile(const QString &filePath)
 {
@@ -254,37 +441,47 @@ void CSV::Player::openFile(const QString &filePath)
       return;
   }
 
-  // Try to open the current file
-  m_csvFile.setFileName(filePath);
-  if (m_csvFile.open(QIODevice::ReadOnly))
+  // Try to open the file as a binary recording
+  if (QFileInfo(filePath).suffix().toLower() == "ssrec")
   {
-    // Read CSV file into string matrix
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    QVector<QString> row;
-    auto csv = QtCSV::Reader::readToList(m_csvFile);
-    for (int i = 0; i < csv.count(); ++i)
+    if (m_binary.open(filePath))
     {
-      row.clear();
-      for (int j = 0; j < csv.at(i).count(); ++j)
-        row.append(csv[i][j]);
+      updateData();
+      Q_EMIT openChanged();
+      m_overview.open(filePath);
+      m_markers.load(filePath);
+      loadSchema(filePath);
+      Q_EMIT markersChanged();
+      nextFrame();
+    }
 
-      m_csvData.append(row);
+    else
+    {
+      Misc::Utilities::showMessageBox(
+          tr("Cannot read binary recording"),
+          tr("The file is damaged or was not created by %1").arg(qAppName()));
+      closeFile();
     }
-#else
-    m_csvData = QtCSV::Reader::readToList(m_csvFile);
-#endif
 
-    // Read first data & Q_EMIT UI signals
-    updateData();
-    Q_EMIT openChanged();
+    return;
+  }
 
-    // Play next frame (to force UI to generate groups, graphs & widgets)
-    // Note: nextFrame() MUST BE CALLED AFTER emiting the openChanged() signal
-    // in
-    //       order for this monstrosity to work
-    nextFrame();
+  // Reject gzip streams that were not written by Serial Studio
+  if (Gzip::isCompressed(filePath) && !Gzip::isSupported(filePath))
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Unsupported gzip stream"),
+        tr("The file was not compressed by %1, decompress it with a gzip "
+           "tool & open the resulting CSV file instead")
+            .arg(qAppName()));
+    closeFile();
+    return;
   }
 
+  // Map the CSV file & index its rows in the background
+  if (m_csv.open(filePath))
+    Q_EMIT loadingChanged();
+
   // Open error
   else
   {
@@ -295,6 +492,28 @@ void CSV::Player::openFile(const QString &filePath)
   }
 }
 
+/**
+ * Called when the rows of the CSV file have been indexed, reads the first
+ * frame & notifies the user interface.
+ */
+void CSV::Player::onCsvIndexed()
+{
+  // Read first data & Q_EMIT UI signals
+  updateData();
+  Q_EMIT openChanged();
+  Q_EMIT loadingChanged();
+  m_overview.open(m_csv.fileName());
+  m_markers.load(m_csv.fileName());
+  loadSchema(m_csv.fileName());
+  Q_EMIT markersChanged();
+
+  // Play next frame (to force UI to generate groups, graphs & widgets)
+  // Note: nextFrame() MUST BE CALLED AFTER emiting the openChanged() signal
+  // in
+  //       order for this monstrosity to work
+  nextFrame();
+}
+
 /**
  * Reads a specific row from the @a progress range (which can have a value
  * ranging from 0.0 to 1.0).
@@ -326,10 +545,6 @@ void CSV::Player::setProgress(const qreal &progress)
 /**
  * Generates a JSON data frame by combining the values of the current CSV
  * row & the structure of the JSON map file loaded in the @c JsonParser class.
- *
- * If playback is enabled, this function calculates the difference in
- * milliseconds between the current row and the next row & schedules a re-call
- * of this function using a timer.
  */
 void CSV::Player::updateData()
 {
@@ -346,48 +561,166 @@ void CSV::Player::updateData()
     Q_EMIT timestampChanged();
   }
 
-  // Construct frame from CSV and send it to the IO manager
-  IO::Manager::instance().processPayload(getFrame(framePosition() + 1));
+  // Send the frame of the current row
+  sendFrame(framePosition() + 1);
+}
 
-  // If the user wants to 'play' the CSV, get time difference between this
-  // frame and the next frame & schedule an automated update
-  if (isPlaying())
+/**
+ * Playback scheduler, sends all the frames that are due according to the
+ * playback clock to the I/O manager. The timestamp string is only updated
+ * once per tick.
+ */
+void CSV::Player::onTick()
+{
+  // Player not active
+  if (!isOpen() || !isPlaying())
+    return;
+
+  // Get playback time
+  QElapsedTimer budget;
+  budget.start();
+  const bool fast = m_speed <= 0;
+  const auto now = m_clockOrigin + qint64(m_clock.elapsed() * m_speed);
+
+  // Send all the frames that are due
+  bool released = false;
+  while (framePosition() < frameCount())
   {
-    // Get first frame
-    if (framePosition() < frameCount())
-    {
-      bool error = true;
-      auto currTime = getCellValue(framePosition() + 1, 0, error);
-      auto nextTime = getCellValue(framePosition() + 2, 0, error);
-
-      // No error, calculate difference & schedule update
-      if (!error)
-      {
-        auto format = "yyyy/MM/dd/ HH:mm:ss::zzz"; // Same as in Export.cpp
-        auto currDateTime = QDateTime::fromString(currTime, format);
-        auto nextDateTime = QDateTime::fromString(nextTime, format);
-        auto msecsToNextF = currDateTime.msecsTo(nextDateTime);
-
-        // clang-format off
-                QTimer::singleShot(msecsToNextF,
-                                   Qt::PreciseTimer,
-                                   this,
-                                   SLOT(nextFrame()));
-        // clang-format on
-      }
-
-      // Error - pause playback
-      else
-      {
-        pause();
-        qWarning() << "Error getting timestamp difference";
-      }
-    }
+    if (!fast && frameTime(framePosition() + 1) > now)
+      break;
+
+    ++m_framePos;
+    released = true;
+    sendFrame(framePosition() + 1);
+
+    if (budget.elapsed() >= TICK_BUDGET)
+      break;
+  }
+
+  // Update timestamp string
+  if (released)
+  {
+    bool error = true;
+    auto timestamp = getCellValue(framePosition() + 1, 0, error);
+    if (!error)
+      m_timestamp = timestamp;
+
+    Q_EMIT timestampChanged();
+  }
+
+  // Pause at end of file
+  if (framePosition() >= frameCount())
+    pause();
+}
+
+/**
+ * Synchronizes the playback clock with the timestamp of the current frame
+ */
+void CSV::Player::restartClock()
+{
+  m_clock.start();
+  m_clockOrigin = frameTime(framePosition());
+}
+
+/**
+ * Returns the reception time (in milliseconds) of the given @a frame, the
+ * timestamps are obtained when the file is opened.
+ */
+qint64 CSV::Player::frameTime(const int frame) const
+{
+  if (m_binary.isOpen())
+    return m_binary.timestamp(frame);
+
+  return m_csv.timestamp(frame + 1);
+}
 
-    // Pause at end of CSV
+/**
+ * Returns the first frame received at (or after) the given @a timestamp,
+ * since the timestamps of the rows are monotonic, the frame is found with a
+ * binary search.
+ */
+int CSV::Player::frameAt(const qint64 timestamp) const
+{
+  int first = 0;
+  int last = qMax(0, frameCount() - 1);
+  while (first < last)
+  {
+    const int middle = first + (last - first) / 2;
+    if (frameTime(middle) < timestamp)
+      first = middle + 1;
     else
-      pause();
+      last = middle;
+  }
+
+  return first;
+}
+
+/**
+ * Sends the frame at the given @a row to the rest of the application. If the
+ * recording has a schema, the recorded values are applied to the datasets of
+ * the recorded frame, which is published by the JSON generator. Otherwise,
+ * the row is sent to the I/O manager & parsed by the project.
+ */
+void CSV::Player::sendFrame(const int row)
+{
+  // Recording without schema, parse the values with the project
+  if (!m_schema.isValid())
+  {
+    IO::Manager::instance().processPayload(getFrame(row));
+    return;
+  }
+
+  // Get the values of the row, without the reception time
+  QStringList values;
+  if (m_binary.isOpen())
+  {
+    if (row <= 0 || row > m_binary.rowCount())
+      return;
+
+    values = m_binary.values(row - 1);
+  }
+
+  else
+  {
+    if (row <= 0 || m_csv.rowCount() <= row)
+      return;
+
+    values = m_csv.row(row);
+    if (!values.isEmpty())
+      values.removeFirst();
   }
+
+  // Update the recorded frame & publish it
+  m_schema.apply(m_frame, values);
+  m_frame.setTimestamp(IO::FrameQueue::timestamp());
+  JSON::Generator::instance().publishRecordedFrame(m_frame);
+}
+
+/**
+ * Reads the schema of the recording at the given @a filePath, the schema is
+ * only used if it has the same number of columns as the recording.
+ */
+void CSV::Player::loadSchema(const QString &filePath)
+{
+  m_frame.clear();
+  if (!m_schema.load(filePath))
+    return;
+
+  int columns = 0;
+  if (m_binary.isOpen())
+    columns = m_binary.columnCount();
+  else if (m_csv.rowCount() > 0)
+    columns = m_csv.row(0).count() - 1;
+
+  if (columns != m_schema.columnCount())
+  {
+    qWarning() << "Ignoring the schema of" << filePath
+               << "since its columns do not match the recording";
+    m_schema.clear();
+    return;
+  }
+
+  m_frame = m_schema.frame();
 }
 
 /**
@@ -400,9 +733,21 @@ QByteArray CSV::Player::getFrame(const int row)
   QByteArray frame;
   auto sep = IO::Manager::instance().separatorSequence();
 
-  if (m_csvData.count() > row)
+  // Decode the row from the binary recording (without the title row)
+  if (m_binary.isOpen())
+  {
+    if (row > 0 && row <= m_binary.rowCount())
+    {
+      frame = m_binary.values(row - 1).join(sep).toUtf8();
+      frame.append('\n');
+    }
+
+    return frame;
+  }
+
+  if (m_csv.rowCount() > row)
   {
-    auto list = m_csvData.at(row);
+    auto list = m_csv.row(row);
     for (int i = 1; i < list.count(); ++i)
     {
       frame.append(list.at(i).toUtf8());
@@ -423,9 +768,25 @@ QByteArray CSV::Player::getFrame(const int row)
  */
 QString CSV::Player::getCellValue(const int row, const int column, bool &error)
 {
-  if (m_csvData.count() > row)
+  // Binary recordings store the timestamp as milliseconds since epoch
+  if (m_binary.isOpen())
+  {
+    error = row <= 0 || row > m_binary.rowCount() || column < 0
+            || column > m_binary.columnCount();
+    if (error)
+      return "";
+
+    if (column > 0)
+      return m_binary.value(row - 1, column - 1);
+
+    auto msecs = m_binary.timestamp(row - 1);
+    auto dateTime = QDateTime::fromMSecsSinceEpoch(msecs);
+    return dateTime.toString("yyyy/MM/dd/ HH:mm:ss::zzz");
+  }
+
+  if (m_csv.rowCount() > row)
   {
-    auto list = m_csvData.at(row);
+    auto list = m_csv.row(row);
     if (list.count() > column)
     {
       error = false;
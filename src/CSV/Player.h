@@ -24,7 +24,15 @@
 
 #include <QFile>
 #include <QObject>
+#include <QTimer>
 #include <QVector>
+#include <QElapsedTimer>
+
+#include <CSV/Overview.h>
+#include <CSV/CsvReader.h>
+#include <CSV/MarkerIndex.h>
+#include <CSV/BinaryReader.h>
+#include <CSV/RecordingSchema.h>
 
 namespace CSV
 {
@@ -33,6 +41,34 @@ namespace CSV
  *
  * The CSV player class allows users to select a CSV file and "re-play" it
  * with Serial Studio.
+ *
+ * Files are never loaded into memory: CSV files are memory-mapped & indexed
+ * in the background by a @c CSV::CsvReader, binary recordings (@c *.ssrec
+ * files) are memory-mapped by a @c CSV::BinaryReader. In both cases, rows are
+ * decoded on demand.
+ *
+ * A timeline overview of the recording (the minimum & maximum of each column
+ * in a fixed number of segments, see @c CSV::Overview) is calculated in the
+ * background when the file is opened, and displayed under the progress
+ * slider of the player.
+ *
+ * Event markers stored next to the recording (see @c CSV::MarkerIndex) are
+ * loaded with the file. Jumping to a marker looks up the first frame received
+ * at (or after) the time of the marker with a binary search over the row
+ * timestamps, so that any marker can be reached instantly.
+ *
+ * Recordings store the values of the datasets after parsing, so if the
+ * recording has a schema (see @c CSV::RecordingSchema), the values of each
+ * row are applied directly to the recorded frame structure & published by the
+ * JSON generator, without running the frame parser again. Recordings without
+ * a schema (made by older versions) are joined with the separator sequence &
+ * sent to the I/O manager, as before.
+ *
+ * Playback is driven by a periodic timer: on every tick, all the frames whose
+ * timestamp is due (according to the playback clock, which can be sped up or
+ * slowed down with @c setSpeed()) are sent to the I/O manager in a single
+ * batch. Since the clock is never restarted between frames, timing errors do
+ * not accumulate during playback.
  */
 class Player : public QObject
 {
@@ -50,10 +86,33 @@ class Player : public QObject
   Q_PROPERTY(QString timestamp
              READ timestamp
              NOTIFY timestampChanged)
+  Q_PROPERTY(bool isLoading
+             READ isLoading
+             NOTIFY loadingChanged)
+  Q_PROPERTY(qreal loadingProgress
+             READ loadingProgress
+             NOTIFY loadingChanged)
+  Q_PROPERTY(qreal speed
+             READ speed
+             WRITE setSpeed
+             NOTIFY speedChanged)
+  Q_PROPERTY(bool overviewAvailable
+             READ overviewAvailable
+             NOTIFY overviewChanged)
+  Q_PROPERTY(StringList overviewTitles
+             READ overviewTitles
+             NOTIFY overviewChanged)
+  Q_PROPERTY(int markerCount
+             READ markerCount
+             NOTIFY markersChanged)
   // clang-format on
 
 Q_SIGNALS:
   void openChanged();
+  void speedChanged();
+  void loadingChanged();
+  void markersChanged();
+  void overviewChanged();
   void timestampChanged();
   void playerStateChanged();
 
@@ -68,13 +127,23 @@ public:
   static Player &instance();
 
   bool isOpen() const;
+  bool isLoading() const;
+  qreal speed() const;
   qreal progress() const;
+  qreal loadingProgress() const;
   bool isPlaying() const;
   int frameCount() const;
   QString filename() const;
   int framePosition() const;
   QString timestamp() const;
   QString csvFilesPath() const;
+  bool overviewAvailable() const;
+  StringList overviewTitles() const;
+  Q_INVOKABLE QVariantList overview(const int column) const;
+
+  int markerCount() const;
+  Q_INVOKABLE QVariantList markers() const;
+  Q_INVOKABLE int findMarker(const QString &label, const int occurrence) const;
 
 public Q_SLOTS:
   void play();
@@ -83,22 +152,41 @@ public Q_SLOTS:
   void openFile();
   void closeFile();
   void nextFrame();
+  void nextMarker();
   void previousFrame();
+  void previousMarker();
+  void jumpToMarker(const int index);
+  void setSpeed(const qreal speed);
   void openFile(const QString &filePath);
   void setProgress(const qreal &progress);
 
 private Q_SLOTS:
+  void onTick();
   void updateData();
+  void onCsvIndexed();
 
 private:
+  void restartClock();
+  qint64 frameTime(const int frame) const;
+  int frameAt(const qint64 timestamp) const;
+  void sendFrame(const int row);
+  void loadSchema(const QString &filePath);
   QByteArray getFrame(const int row);
   QString getCellValue(const int row, const int column, bool &error);
 
 private:
   int m_framePos;
   bool m_playing;
-  QFile m_csvFile;
+  qreal m_speed;
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+  qint64 m_clockOrigin;
+  CsvReader m_csv;
+  Overview m_overview;
   QString m_timestamp;
-  QVector<QVector<QString>> m_csvData;
+  MarkerIndex m_markers;
+  BinaryReader m_binary;
+  JSON::Frame m_frame;
+  RecordingSchema m_schema;
 };
 } // namespace CSV
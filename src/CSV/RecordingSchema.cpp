@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <climits>
+#include <algorithm>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <CSV/RecordingSchema.h>
+
+/**
+ * Constructor function
+ */
+CSV::RecordingSchema::RecordingSchema() {}
+
+/**
+ * Returns the path of the schema file of the given @a recording
+ */
+QString CSV::RecordingSchema::schemaPath(const QString &recording)
+{
+  return recording + QStringLiteral(".schema");
+}
+
+/**
+ * Removes the frame structure & the columns of the schema
+ */
+void CSV::RecordingSchema::clear()
+{
+  m_frame.clear();
+  m_columns.clear();
+}
+
+/**
+ * Returns @c true if the schema describes a valid frame with at least one
+ * column.
+ */
+bool CSV::RecordingSchema::isValid() const
+{
+  return m_frame.isValid() && !m_columns.isEmpty();
+}
+
+/**
+ * Returns the number of value columns of the recording (without the
+ * reception time column).
+ */
+int CSV::RecordingSchema::columnCount() const
+{
+  return m_columns.count();
+}
+
+/**
+ * Returns the title of each column, which is the title of the first dataset
+ * fed by the column.
+ */
+QStringList CSV::RecordingSchema::titles() const
+{
+  QStringList list;
+  for (const auto &column : m_columns)
+  {
+    const auto &index = column.first();
+    list.append(m_frame.getGroup(index.first).getDataset(index.second).title());
+  }
+
+  return list;
+}
+
+/**
+ * Returns the structure of the recorded frames
+ */
+const JSON::Frame &CSV::RecordingSchema::frame() const
+{
+  return m_frame;
+}
+
+/**
+ * Returns the datasets fed by each column, the value of a column is read
+ * from its first dataset.
+ */
+const QVector<CSV::RecordingSchema::Column> &
+CSV::RecordingSchema::columns() const
+{
+  return m_columns;
+}
+
+/**
+ * Obtains the columns of a recording of the given @a frame. Columns are
+ * sorted by the field that feeds their datasets, datasets without a field are
+ * placed after the others (in group order). If @a manual is @c true, the
+ * datasets that display the same field share a single column.
+ */
+void CSV::RecordingSchema::build(const JSON::Frame &frame, const bool manual)
+{
+  // Register the structure of the frame
+  clear();
+  m_frame = frame;
+
+  // Obtain the field of each dataset
+  QVector<QPair<int, DatasetIndex>> datasets;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const int field = group.getDataset(j).index();
+      datasets.append(qMakePair(field > 0 ? field : INT_MAX, DatasetIndex(i, j)));
+    }
+  }
+
+  // Sort datasets by field, keeping the group order of equal fields
+  std::stable_sort(datasets.begin(), datasets.end(),
+                   [](const QPair<int, DatasetIndex> &a,
+                      const QPair<int, DatasetIndex> &b) {
+                     return a.first < b.first;
+                   });
+
+  // Build the columns, merging the datasets of the same field
+  for (int i = 0; i < datasets.count(); ++i)
+  {
+    const auto &dataset = datasets.at(i);
+    if (manual && dataset.first != INT_MAX && i > 0
+        && datasets.at(i - 1).first == dataset.first)
+      m_columns.last().append(dataset.second);
+    else
+      m_columns.append(Column{dataset.second});
+  }
+}
+
+/**
+ * Reads the schema file of the given @a recording, returns @c false if the
+ * recording has no schema file or if the file is not valid.
+ */
+bool CSV::RecordingSchema::load(const QString &recording)
+{
+  // Remove previous schema
+  clear();
+
+  // Read the schema file
+  QFile file(schemaPath(recording));
+  if (!file.open(QFile::ReadOnly))
+    return false;
+
+  const auto object = QJsonDocument::fromJson(file.readAll()).object();
+  if (!m_frame.read(object.value("frame").toObject()))
+    return false;
+
+  // Read the datasets of each column
+  const auto columns = object.value("columns").toArray();
+  for (const auto &value : columns)
+  {
+    Column column;
+    for (const auto &item : value.toArray())
+    {
+      const auto pair = item.toArray();
+      const int group = pair.at(0).toInt(-1);
+      const int dataset = pair.at(1).toInt(-1);
+      if (m_frame.valueIndex(group, dataset) < 0)
+      {
+        clear();
+        return false;
+      }
+
+      column.append(DatasetIndex(group, dataset));
+    }
+
+    if (column.isEmpty())
+    {
+      clear();
+      return false;
+    }
+
+    m_columns.append(column);
+  }
+
+  return isValid();
+}
+
+/**
+ * Returns the contents of the schema file
+ */
+QByteArray CSV::RecordingSchema::toJson() const
+{
+  QJsonArray columns;
+  for (const auto &column : m_columns)
+  {
+    QJsonArray datasets;
+    for (const auto &index : column)
+      datasets.append(QJsonArray{index.first, index.second});
+
+    columns.append(datasets);
+  }
+
+  QJsonObject object;
+  object.insert("frame", m_frame.jsonData());
+  object.insert("columns", columns);
+  return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+/**
+ * Updates the datasets of the given @a frame, which must have the structure
+ * of the schema, with the @a values of a row of the recording.
+ */
+void CSV::RecordingSchema::apply(JSON::Frame &frame,
+                                 const QStringList &values) const
+{
+  const int count = qMin(values.count(), m_columns.count());
+  for (int i = 0; i < count; ++i)
+  {
+    const auto &value = values.at(i);
+    for (const auto &index : m_columns.at(i))
+      frame.setDatasetValue(index.first, index.second, value);
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QStringList>
+
+#include <JSON/Frame.h>
+
+namespace CSV
+{
+/**
+ * @brief The RecordingSchema class
+ *
+ * Describes the columns of a recording: the structure of the frames that were
+ * recorded & the datasets whose value is stored in each column.
+ *
+ * Recordings store the values produced by the JSON generator (after the frame
+ * parser, calibrations & computed datasets), with one column per dataset in
+ * the order of the field that feeds it, as shown by the project editor.
+ * Datasets that are not fed by a field (e.g. computed datasets) are placed
+ * after the others. In manual mode, datasets that display the same field are
+ * only exported once, and the column lists every dataset that it feeds.
+ *
+ * The schema is stored in a small JSON file next to the recording (the path
+ * of the recording with the @c .schema suffix), so that the @c CSV::Player
+ * can rebuild the recorded frames directly from the values of each row,
+ * without running the frame parser again.
+ */
+class RecordingSchema
+{
+public:
+  typedef QPair<int, int> DatasetIndex;
+  typedef QVector<DatasetIndex> Column;
+
+  RecordingSchema();
+
+  static QString schemaPath(const QString &recording);
+
+  void clear();
+  bool isValid() const;
+  int columnCount() const;
+  QStringList titles() const;
+  const JSON::Frame &frame() const;
+  const QVector<Column> &columns() const;
+
+  void build(const JSON::Frame &frame, const bool manual);
+  bool load(const QString &recording);
+  QByteArray toJson() const;
+
+  void apply(JSON::Frame &frame, const QStringList &values) const;
+
+private:
+  JSON::Frame m_frame;
+  QVector<Column> m_columns;
+};
+} // namespace CSV
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QHash>
+#include <QFileInfo>
+#include <QFileDialog>
+#include <QApplication>
+
+#include <CSV/Gzip.h>
+#include <CSV/Player.h>
+#include <CSV/Reference.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Constructor function
+ */
+CSV::Reference::Reference()
+{
+  connect(&m_csv, &CsvReader::indexed, this, &Reference::onCsvIndexed);
+  connect(&m_csv, &CsvReader::progressChanged, this,
+          &Reference::loadingChanged);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+CSV::Reference &CSV::Reference::instance()
+{
+  static Reference singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if a reference recording is open
+ */
+bool CSV::Reference::isOpen() const
+{
+  return m_csv.isOpen() || m_binary.isOpen();
+}
+
+/**
+ * Returns @c true if a CSV file is being indexed before it can be used as a
+ * reference
+ */
+bool CSV::Reference::isLoading() const
+{
+  return m_csv.isIndexing();
+}
+
+/**
+ * Returns the number of data rows of the recording (the title row is not
+ * counted)
+ */
+int CSV::Reference::rowCount() const
+{
+  if (m_binary.isOpen())
+    return m_binary.rowCount();
+
+  if (m_csv.isOpen())
+    return qMax(0, m_csv.rowCount() - 1);
+
+  return 0;
+}
+
+/**
+ * Returns the short filename of the reference recording
+ */
+QString CSV::Reference::filename() const
+{
+  if (m_binary.isOpen())
+    return QFileInfo(m_binary.fileName()).fileName();
+
+  if (m_csv.isOpen())
+    return QFileInfo(m_csv.fileName()).fileName();
+
+  return "";
+}
+
+/**
+ * Returns the titles of the value columns of the recording (the reception
+ * date/time column is not included)
+ */
+QStringList CSV::Reference::titles()
+{
+  if (m_binary.isOpen())
+    return m_binary.titles();
+
+  if (m_csv.isOpen() && m_csv.rowCount() > 0)
+  {
+    auto list = m_csv.row(0);
+    if (!list.isEmpty())
+      list.removeFirst();
+
+    return list;
+  }
+
+  return QStringList();
+}
+
+/**
+ * Returns the reception time (in milliseconds) of the given data @a row
+ */
+qint64 CSV::Reference::timestamp(const int row) const
+{
+  if (m_binary.isOpen())
+    return m_binary.timestamp(row);
+
+  return m_csv.timestamp(row + 1);
+}
+
+/**
+ * Returns the numeric value stored at the given data @a row & value
+ * @a column, cells that are not numeric are read as 0.
+ */
+double CSV::Reference::value(const int row, const int column)
+{
+  if (row < 0 || row >= rowCount() || column < 0)
+    return 0;
+
+  if (m_binary.isOpen())
+    return m_binary.value(row, column).toDouble();
+
+  const auto list = m_csv.row(row + 1);
+  if (column + 1 < list.count())
+    return list.at(column + 1).toDouble();
+
+  return 0;
+}
+
+/**
+ * Returns the value column of the recording that corresponds to each of the
+ * given @a datasets (group & dataset indexes) of the live @a frame, or -1 for
+ * the datasets that are not part of the recording.
+ *
+ * Columns are matched by title. Exported files may contain several columns
+ * with the same title (e.g. the "X" dataset of two accelerometers), so the
+ * n-th dataset of the frame with a given title is matched with the n-th column
+ * of the recording with the same title.
+ */
+QVector<int> CSV::Reference::columns(const JSON::Frame &frame,
+                                     const QVector<QPair<int, int>> &datasets)
+{
+  // Get the position of each title in the recording
+  const auto names = titles();
+  QHash<QString, QVector<int>> positions;
+  for (int i = 0; i < names.count(); ++i)
+    positions[names.at(i)].append(i);
+
+  // Get the occurrence of the title of each dataset of the frame
+  QHash<QString, int> seen;
+  QHash<QPair<int, int>, int> occurrences;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+      occurrences.insert(qMakePair(i, j), seen[group.getDataset(j).title()]++);
+  }
+
+  // Match each dataset with a column of the recording
+  QVector<int> columns;
+  columns.reserve(datasets.count());
+  for (const auto &index : datasets)
+  {
+    int column = -1;
+    if (index.first >= 0 && index.first < frame.groupCount())
+    {
+      const auto &group = frame.getGroup(index.first);
+      if (index.second >= 0 && index.second < group.datasetCount())
+      {
+        const auto title = group.getDataset(index.second).title();
+        const auto &list = positions.value(title);
+        if (!list.isEmpty())
+          column = list.at(qMin(occurrences.value(index), list.count() - 1));
+      }
+    }
+
+    columns.append(column);
+  }
+
+  return columns;
+}
+
+/**
+ * Aligns the first row of the recording with the next live frame
+ */
+void CSV::Reference::restart()
+{
+  if (isOpen())
+    Q_EMIT restarted();
+}
+
+/**
+ * Lets the user select a recording
+ */
+void CSV::Reference::openFile()
+{
+  // clang-format off
+
+    // Get file name
+    auto file = QFileDialog::getOpenFileName(
+                Q_NULLPTR,
+                tr("Select reference recording"),
+                Player::instance().csvFilesPath(),
+                tr("Recordings") + " (*.csv *.csv.gz *.ssrec);;" +
+                tr("CSV files") + " (*.csv);;" +
+                tr("Compressed CSV recordings") + " (*.csv.gz);;" +
+                tr("Binary recordings") + " (*.ssrec)");
+
+    // Open file
+    if (!file.isEmpty())
+        openFile(file);
+
+  // clang-format on
+}
+
+/**
+ * Closes the reference recording & removes the ghost curves
+ */
+void CSV::Reference::closeFile()
+{
+  m_csv.close();
+  m_binary.close();
+
+  Q_EMIT openChanged();
+  Q_EMIT loadingChanged();
+}
+
+/**
+ * Opens the given recording as a reference, the connection with the device
+ * (if any) is not modified. CSV files are indexed in the background before
+ * they can be used (see @c onCsvIndexed()).
+ */
+void CSV::Reference::openFile(const QString &filePath)
+{
+  // File name empty, abort
+  if (filePath.isEmpty())
+    return;
+
+  // Close previous file
+  closeFile();
+
+  // Open binary recordings directly
+  if (QFileInfo(filePath).suffix().toLower() == "ssrec")
+  {
+    if (m_binary.open(filePath))
+      Q_EMIT openChanged();
+
+    else
+    {
+      Misc::Utilities::showMessageBox(
+          tr("Cannot read binary recording"),
+          tr("The file is damaged or was not created by %1").arg(qAppName()));
+      closeFile();
+    }
+
+    return;
+  }
+
+  // Reject gzip streams that were not written by Serial Studio
+  if (Gzip::isCompressed(filePath) && !Gzip::isSupported(filePath))
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Unsupported gzip stream"),
+        tr("The file was not compressed by %1, decompress it with a gzip "
+           "tool & open the resulting CSV file instead")
+            .arg(qAppName()));
+    closeFile();
+    return;
+  }
+
+  // Map the CSV file & index its rows in the background
+  if (m_csv.open(filePath))
+    Q_EMIT loadingChanged();
+
+  // Open error
+  else
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Cannot read CSV file"),
+        tr("Please check file permissions & location"));
+    closeFile();
+  }
+}
+
+/**
+ * Called when the rows of the CSV file have been indexed
+ */
+void CSV::Reference::onCsvIndexed()
+{
+  Q_EMIT openChanged();
+  Q_EMIT loadingChanged();
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QStringList>
+
+#include <JSON/Frame.h>
+#include <CSV/CsvReader.h>
+#include <CSV/BinaryReader.h>
+
+namespace CSV
+{
+/**
+ * @brief The Reference class
+ *
+ * Opens a recording (a CSV file or a binary @c *.ssrec recording) as a
+ * reference, whose values are displayed as "ghost" curves on top of the live
+ * data of the plot widgets, so that a live run can be compared against a known
+ * good run while the device remains connected.
+ *
+ * Unlike the @c CSV::Player, the reference does not send its frames to the
+ * I/O manager: the dashboard reads the rows of the recording directly from the
+ * memory-mapped file (see @c CSV::CsvReader and @c CSV::BinaryReader) as they
+ * become due & appends the values to its reference history, which is drawn by
+ * the same @c Widgets::PlotSeries adapters as the live history.
+ *
+ * The first row of the recording is aligned with the first live frame that
+ * is received after the reference is opened (or after @c restart() is called),
+ * the rest of the rows follow the timestamps stored in the recording.
+ */
+class Reference : public QObject
+{
+  // clang-format off
+  Q_OBJECT
+  Q_PROPERTY(bool isOpen
+             READ isOpen
+             NOTIFY openChanged)
+  Q_PROPERTY(bool isLoading
+             READ isLoading
+             NOTIFY loadingChanged)
+  Q_PROPERTY(QString filename
+             READ filename
+             NOTIFY openChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void restarted();
+  void openChanged();
+  void loadingChanged();
+
+private:
+  explicit Reference();
+  Reference(Reference &&) = delete;
+  Reference(const Reference &) = delete;
+  Reference &operator=(Reference &&) = delete;
+  Reference &operator=(const Reference &) = delete;
+
+public:
+  static Reference &instance();
+
+  bool isOpen() const;
+  bool isLoading() const;
+  int rowCount() const;
+  QString filename() const;
+  QStringList titles();
+
+  qint64 timestamp(const int row) const;
+  double value(const int row, const int column);
+  QVector<int> columns(const JSON::Frame &frame,
+                       const QVector<QPair<int, int>> &datasets);
+
+public Q_SLOTS:
+  void restart();
+  void openFile();
+  void closeFile();
+  void openFile(const QString &filePath);
+
+private Q_SLOTS:
+  void onCsvIndexed();
+
+private:
+  CsvReader m_csv;
+  BinaryReader m_binary;
+};
+} // namespace CSV
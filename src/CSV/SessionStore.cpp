@@ -0,0 +1,697 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QDebug>
+#include <QDateTime>
+#include <QSqlError>
+#include <QApplication>
+#include <QSqlDatabase>
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
+#include <CSV/SessionStore.h>
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+
+/**
+ * Maximum number of rows inserted in a single transaction, the transaction
+ * is committed earlier if the commit timer expires.
+ */
+static const int MAX_TRANSACTION_ROWS = 250000;
+
+/**
+ * Maximum number of frames that can be waiting to be written by the worker
+ * thread, new frames wait for the worker if this limit is reached.
+ */
+static const int MAX_QUEUED_FRAMES = 65536;
+
+/**
+ * Tables, indexes & views of the session database
+ */
+static const char *SCHEMA[] = {
+    "CREATE TABLE IF NOT EXISTS sessions ("
+    "id INTEGER PRIMARY KEY, project TEXT NOT NULL, "
+    "started INTEGER NOT NULL, finished INTEGER)",
+
+    "CREATE TABLE IF NOT EXISTS channels ("
+    "id INTEGER PRIMARY KEY, session INTEGER NOT NULL REFERENCES sessions(id), "
+    "grp TEXT NOT NULL, title TEXT NOT NULL, units TEXT, "
+    "UNIQUE(session, grp, title))",
+
+    "CREATE TABLE IF NOT EXISTS samples ("
+    "channel INTEGER NOT NULL REFERENCES channels(id), t INTEGER NOT NULL, "
+    "value REAL, text TEXT)",
+
+    "CREATE INDEX IF NOT EXISTS samples_by_time ON samples(channel, t)",
+
+    "CREATE TABLE IF NOT EXISTS alarms ("
+    "session INTEGER NOT NULL REFERENCES sessions(id), t INTEGER NOT NULL, "
+    "channel INTEGER REFERENCES channels(id), kind TEXT NOT NULL, "
+    "active INTEGER NOT NULL, value REAL, threshold REAL, title TEXT)",
+
+    "CREATE INDEX IF NOT EXISTS alarms_by_time ON alarms(session, t)",
+
+    "CREATE TABLE IF NOT EXISTS markers ("
+    "session INTEGER NOT NULL REFERENCES sessions(id), t INTEGER NOT NULL, "
+    "label TEXT)",
+
+    "CREATE INDEX IF NOT EXISTS markers_by_time ON markers(session, t)",
+
+    "CREATE VIEW IF NOT EXISTS sample_view AS "
+    "SELECT c.session, s.t, c.grp, c.title, c.units, s.value, s.text "
+    "FROM samples s JOIN channels c ON c.id = s.channel",
+};
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, generates the name of the database connection
+ */
+CSV::SessionStoreWorker::SessionStoreWorker()
+  : m_session(-1)
+  , m_pendingRows(0)
+  , m_transaction(false)
+  , m_schemaHash(0)
+{
+  m_connection = QStringLiteral("CSV::SessionStore::%1")
+                     .arg(reinterpret_cast<quintptr>(this), 0, 16);
+}
+
+/**
+ * Destructor function, ends the current session & closes the database
+ */
+CSV::SessionStoreWorker::~SessionStoreWorker()
+{
+  close();
+}
+
+/**
+ * Commits the pending samples, registers the end time of the current session
+ * & closes the database.
+ */
+void CSV::SessionStoreWorker::close()
+{
+  // Nothing to do
+  if (!QSqlDatabase::contains(m_connection))
+    return;
+
+  // End the session
+  commit();
+  if (m_session >= 0)
+  {
+    QSqlQuery query(QSqlDatabase::database(m_connection));
+    query.prepare("UPDATE sessions SET finished = ? WHERE id = ?");
+    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
+    query.addBindValue(m_session);
+    query.exec();
+  }
+
+  // Release the prepared statements before closing the connection
+  m_sampleQuery.reset();
+  m_alarmQuery.reset();
+  m_markerQuery.reset();
+  m_channels.clear();
+  m_schemaHash = 0;
+  m_session = -1;
+
+  // Close the connection
+  QSqlDatabase::database(m_connection).close();
+  QSqlDatabase::removeDatabase(m_connection);
+}
+
+/**
+ * Commits the current transaction, if any
+ */
+void CSV::SessionStoreWorker::commit()
+{
+  if (!m_transaction)
+    return;
+
+  auto db = QSqlDatabase::database(m_connection);
+  if (!db.commit())
+    qWarning() << "CSV::SessionStore:" << db.lastError().text();
+
+  m_transaction = false;
+  m_pendingRows = 0;
+}
+
+/**
+ * Opens (or creates) the database at the given @a path, configures it in WAL
+ * mode & starts a new session for the given @a project.
+ */
+void CSV::SessionStoreWorker::open(const QString &path,
+                                   const QString &project)
+{
+  // Close previous database
+  close();
+
+  // Open the database
+  auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_connection);
+  db.setDatabaseName(path);
+  if (!db.open())
+  {
+    const auto error = db.lastError().text();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connection);
+    Q_EMIT openFailed(error);
+    return;
+  }
+
+  // WAL mode allows readers to query the database while it is written,
+  // a power loss can only lose the last committed transactions
+  exec(QStringLiteral("PRAGMA journal_mode = WAL"));
+  exec(QStringLiteral("PRAGMA synchronous = NORMAL"));
+  if (!createSchema())
+  {
+    const auto error = db.lastError().text();
+    db = QSqlDatabase();
+    close();
+    Q_EMIT openFailed(error);
+    return;
+  }
+
+  // Register the session
+  QSqlQuery query(db);
+  query.prepare("INSERT INTO sessions (project, started) VALUES (?, ?)");
+  query.addBindValue(project);
+  query.addBindValue(QDateTime::currentMSecsSinceEpoch());
+  if (!query.exec())
+  {
+    const auto error = query.lastError().text();
+    db = QSqlDatabase();
+    close();
+    Q_EMIT openFailed(error);
+    return;
+  }
+
+  m_session = query.lastInsertId().toLongLong();
+
+  // Prepare the insert statements
+  m_sampleQuery.reset(new QSqlQuery(db));
+  m_sampleQuery->prepare(
+      "INSERT INTO samples (channel, t, value, text) VALUES (?, ?, ?, ?)");
+  m_alarmQuery.reset(new QSqlQuery(db));
+  m_alarmQuery->prepare(
+      "INSERT INTO alarms (session, t, channel, kind, active, value, "
+      "threshold, title) VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+  m_markerQuery.reset(new QSqlQuery(db));
+  m_markerQuery->prepare(
+      "INSERT INTO markers (session, t, label) VALUES (?, ?, ?)");
+}
+
+/**
+ * Inserts the values of the given @a frames in the current transaction, the
+ * channels of the session are registered when the frame structure changes.
+ */
+void CSV::SessionStoreWorker::write(const QVector<JSON::Frame> &frames)
+{
+  // Database not open
+  if (m_session < 0 || !m_sampleQuery)
+    return;
+
+  auto db = QSqlDatabase::database(m_connection);
+  for (const auto &frame : frames)
+  {
+    // Start a new transaction if required
+    if (!m_transaction)
+      m_transaction = db.transaction();
+
+    // Register channels
+    if (frame.schemaHash() != m_schemaHash)
+      registerChannels(frame);
+
+    // Insert samples
+    const auto time = IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp());
+    for (int g = 0; g < frame.groupCount() && g < m_channels.count(); ++g)
+    {
+      const auto &group = frame.getGroup(g);
+      const auto &channels = m_channels.at(g);
+      for (int d = 0; d < group.datasetCount() && d < channels.count(); ++d)
+      {
+        const auto &dataset = group.getDataset(d);
+        m_sampleQuery->addBindValue(channels.at(d));
+        m_sampleQuery->addBindValue(time);
+        if (dataset.isNumeric())
+        {
+          m_sampleQuery->addBindValue(dataset.numericValue());
+          m_sampleQuery->addBindValue(QVariant());
+        }
+
+        else
+        {
+          m_sampleQuery->addBindValue(QVariant());
+          m_sampleQuery->addBindValue(dataset.value());
+        }
+
+        m_sampleQuery->exec();
+        ++m_pendingRows;
+      }
+    }
+
+    // Transaction is too large, commit it
+    if (m_pendingRows >= MAX_TRANSACTION_ROWS)
+      commit();
+  }
+}
+
+/**
+ * Inserts the given alarm @a events in the current transaction
+ */
+void CSV::SessionStoreWorker::writeAlarms(
+    const QVector<JSON::AlarmEvent> &events)
+{
+  // Database not open
+  if (m_session < 0 || !m_alarmQuery)
+    return;
+
+  // Start a new transaction if required
+  if (!m_transaction)
+    m_transaction = QSqlDatabase::database(m_connection).transaction();
+
+  // Insert alarm events
+  for (const auto &event : events)
+  {
+    QVariant channel;
+    if (event.group >= 0 && event.group < m_channels.count()
+        && event.dataset >= 0
+        && event.dataset < m_channels.at(event.group).count())
+      channel = m_channels.at(event.group).at(event.dataset);
+
+    m_alarmQuery->addBindValue(m_session);
+    m_alarmQuery->addBindValue(
+        IO::FrameQueue::toMSecsSinceEpoch(event.timestamp));
+    m_alarmQuery->addBindValue(channel);
+    m_alarmQuery->addBindValue(event.kindName());
+    m_alarmQuery->addBindValue(event.active ? 1 : 0);
+    m_alarmQuery->addBindValue(event.value);
+    m_alarmQuery->addBindValue(event.limit);
+    m_alarmQuery->addBindValue(event.title);
+    m_alarmQuery->exec();
+  }
+}
+
+/**
+ * Inserts a marker with the given @a label at the given @a timestamp (in
+ * milliseconds since the epoch) & commits it immediately.
+ */
+void CSV::SessionStoreWorker::writeMarker(const qint64 timestamp,
+                                          const QString &label)
+{
+  // Database not open
+  if (m_session < 0 || !m_markerQuery)
+    return;
+
+  // Insert marker
+  m_markerQuery->addBindValue(m_session);
+  m_markerQuery->addBindValue(timestamp);
+  m_markerQuery->addBindValue(label);
+  m_markerQuery->exec();
+  commit();
+}
+
+/**
+ * Creates the tables, indexes & views of the database if they do not exist
+ */
+bool CSV::SessionStoreWorker::createSchema()
+{
+  for (const auto *statement : SCHEMA)
+  {
+    if (!exec(QString::fromLatin1(statement)))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Executes the given @a sql statement, returns @c false on failure
+ */
+bool CSV::SessionStoreWorker::exec(const QString &sql)
+{
+  QSqlQuery query(QSqlDatabase::database(m_connection));
+  if (query.exec(sql))
+    return true;
+
+  qWarning() << "CSV::SessionStore:" << query.lastError().text();
+  return false;
+}
+
+/**
+ * Registers the datasets of the given @a frame as channels of the current
+ * session & obtains the ID of each channel.
+ */
+void CSV::SessionStoreWorker::registerChannels(const JSON::Frame &frame)
+{
+  // Prepare queries
+  auto db = QSqlDatabase::database(m_connection);
+  QSqlQuery insert(db);
+  QSqlQuery select(db);
+  insert.prepare("INSERT OR IGNORE INTO channels (session, grp, title, units) "
+                 "VALUES (?, ?, ?, ?)");
+  select.prepare(
+      "SELECT id FROM channels WHERE session = ? AND grp = ? AND title = ?");
+
+  // Register each dataset
+  m_channels.clear();
+  m_channels.resize(frame.groupCount());
+  for (int g = 0; g < frame.groupCount(); ++g)
+  {
+    const auto &group = frame.getGroup(g);
+    for (int d = 0; d < group.datasetCount(); ++d)
+    {
+      const auto &dataset = group.getDataset(d);
+      insert.addBindValue(m_session);
+      insert.addBindValue(group.title());
+      insert.addBindValue(dataset.title());
+      insert.addBindValue(dataset.units());
+      insert.exec();
+
+      select.addBindValue(m_session);
+      select.addBindValue(group.title());
+      select.addBindValue(dataset.title());
+      qint64 id = -1;
+      if (select.exec() && select.next())
+        id = select.value(0).toLongLong();
+
+      m_channels[g].append(id);
+    }
+  }
+
+  m_schemaHash = frame.schemaHash();
+}
+
+//----------------------------------------------------------------------------------------
+// Session store implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, reads the settings, starts the worker thread &
+ * registers the store in the sink graph of the JSON generator.
+ */
+CSV::SessionStore::SessionStore()
+  : m_open(false)
+  , m_queuedFrames(0)
+  , m_worker(new SessionStoreWorker())
+{
+  // Read settings
+  m_enabled = m_settings.value("CSV_SessionStore_Enabled", false).toBool();
+
+  // Start worker thread
+  m_thread.setObjectName(QStringLiteral("CSV::SessionStoreWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(m_worker, &SessionStoreWorker::openFailed, this,
+          &SessionStore::onOpenFailed);
+  m_thread.start();
+
+  // Connect signals
+  auto io = &IO::Manager::instance();
+  auto ge = &JSON::Generator::instance();
+  auto te = &Misc::TimerEvents::instance();
+  connect(io, &IO::Manager::connectedChanged, this,
+          &SessionStore::closeDatabase);
+  connect(ge, &JSON::Generator::alarmsTriggered, this,
+          &SessionStore::onAlarmsTriggered);
+  connect(te, &Misc::TimerEvents::timeout1Hz, this, &SessionStore::commit);
+
+  // Receive every generated frame
+  ge->sinks().addSink(this, JSON::SinkGraph::Port::Frames);
+}
+
+/**
+ * Ends the current session & stops the worker thread
+ */
+CSV::SessionStore::~SessionStore()
+{
+  closeDatabase();
+
+  // Wait until the worker has written all the pending data
+  QMetaObject::invokeMethod(
+      m_worker, [] {}, Qt::BlockingQueuedConnection);
+
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns a pointer to the only instance of this class
+ */
+CSV::SessionStore &CSV::SessionStore::instance()
+{
+  static SessionStore singleton;
+  return singleton;
+}
+
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString CSV::SessionStore::sinkName() const
+{
+  return QStringLiteral("CSV::SessionStore");
+}
+
+/**
+ * Hands the given @a frames over to the worker thread, the database is
+ * opened when the first frame of a connection is received.
+ *
+ * If the worker thread cannot keep up with the incoming data, this function
+ * waits for it instead of letting the queue grow indefinitely.
+ */
+void CSV::SessionStore::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  // Only store frames received from a device
+  if (!m_enabled || !IO::Manager::instance().connected() || frames.isEmpty())
+    return;
+
+  // Open the database & start a new session
+  if (!m_open)
+  {
+    const auto &frame = frames.first();
+    if (!frame.isValid())
+      return;
+
+    auto worker = m_worker;
+    const auto title = frame.title();
+    const auto path = databasePath(title);
+    QMetaObject::invokeMethod(worker, [=] { worker->open(path, title); });
+
+    m_open = true;
+    m_fileName = path;
+    Q_EMIT openChanged();
+  }
+
+  // Queue is full, wait for the worker thread
+  while (m_queuedFrames > MAX_QUEUED_FRAMES)
+    QThread::msleep(1);
+
+  // Write frames in the worker thread
+  auto worker = m_worker;
+  auto queued = &m_queuedFrames;
+  const int count = frames.count();
+  m_queuedFrames += count;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->write(frames);
+    *queued -= count;
+  });
+}
+
+/**
+ * Returns @c true if a session is being recorded
+ */
+bool CSV::SessionStore::isOpen() const
+{
+  return m_open;
+}
+
+/**
+ * Returns @c true if frames are stored in the session database
+ */
+bool CSV::SessionStore::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the path of the current session database
+ */
+QString CSV::SessionStore::fileName() const
+{
+  return m_fileName;
+}
+
+/**
+ * Returns the numeric samples of the given @a group & @a dataset stored in
+ * the database at the given @a path between the @a from & @a to timestamps
+ * (in milliseconds since the epoch, inclusive). The x coordinate of each
+ * point is the timestamp & the y coordinate is the value.
+ *
+ * The query is resolved with the @c samples_by_time index, so its cost
+ * depends on the number of returned samples & not on the size of the
+ * database. A separate read-only connection is used, so this function can be
+ * called from any thread while the database is being written.
+ */
+QVector<QPointF> CSV::SessionStore::samples(const QString &path,
+                                            const QString &group,
+                                            const QString &dataset,
+                                            const qint64 from,
+                                            const qint64 to)
+{
+  QVector<QPointF> points;
+  const auto name = QStringLiteral("CSV::SessionStore::Query::%1")
+                        .arg(reinterpret_cast<quintptr>(&points), 0, 16);
+
+  {
+    auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
+    db.setDatabaseName(path);
+    db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+    if (db.open())
+    {
+      QSqlQuery query(db);
+      query.setForwardOnly(true);
+      query.prepare("SELECT s.t, s.value FROM channels c "
+                    "JOIN samples s ON s.channel = c.id "
+                    "WHERE c.grp = ? AND c.title = ? AND s.t BETWEEN ? AND ? "
+                    "AND s.value IS NOT NULL ORDER BY s.t");
+      query.addBindValue(group);
+      query.addBindValue(dataset);
+      query.addBindValue(from);
+      query.addBindValue(to);
+      if (query.exec())
+      {
+        while (query.next())
+          points.append(QPointF(query.value(0).toDouble(),
+                                query.value(1).toDouble()));
+      }
+
+      db.close();
+    }
+  }
+
+  QSqlDatabase::removeDatabase(name);
+  return points;
+}
+
+/**
+ * Commits the pending samples & ends the current session
+ */
+void CSV::SessionStore::closeDatabase()
+{
+  if (!m_open)
+    return;
+
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->close(); });
+
+  m_open = false;
+  m_fileName.clear();
+  Q_EMIT openChanged();
+}
+
+/**
+ * Enables or disables storing frames in the session database
+ */
+void CSV::SessionStore::setEnabled(const bool enabled)
+{
+  if (m_enabled != enabled)
+  {
+    if (!enabled)
+      closeDatabase();
+
+    m_enabled = enabled;
+    m_settings.setValue("CSV_SessionStore_Enabled", enabled);
+    Q_EMIT enabledChanged();
+  }
+}
+
+/**
+ * Adds a marker with the given @a label at the current time, markers can be
+ * used to annotate events of a test run (e.g. the start of a test step).
+ */
+void CSV::SessionStore::addMarker(const QString &label)
+{
+  if (!m_open)
+    return;
+
+  auto worker = m_worker;
+  const auto time = QDateTime::currentMSecsSinceEpoch();
+  QMetaObject::invokeMethod(worker,
+                            [=] { worker->writeMarker(time, label); });
+}
+
+/**
+ * Lets the worker commit the samples received during the last second
+ */
+void CSV::SessionStore::commit()
+{
+  if (!m_open)
+    return;
+
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->commit(); });
+}
+
+/**
+ * Called when the worker thread fails to open the database
+ */
+void CSV::SessionStore::onOpenFailed(const QString &error)
+{
+  if (!m_open)
+    return;
+
+  Misc::Utilities::showMessageBox(tr("Session Database Error"),
+                                  tr("Cannot open session database: %1")
+                                      .arg(error));
+  setEnabled(false);
+}
+
+/**
+ * Stores the alarm events raised & cleared by the JSON generator
+ */
+void CSV::SessionStore::onAlarmsTriggered(
+    const QVector<JSON::AlarmEvent> &events)
+{
+  if (!m_open)
+    return;
+
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->writeAlarms(events); });
+}
+
+/**
+ * Returns the path of the session database of the project with the given
+ * @a projectTitle, the directory is created if required.
+ */
+QString CSV::SessionStore::databasePath(const QString &projectTitle) const
+{
+  const QString path = QString("%1/Documents/%2/Sessions")
+                           .arg(QDir::homePath(), qApp->applicationName());
+
+  QDir dir(path);
+  if (!dir.exists())
+    dir.mkpath(".");
+
+  return dir.filePath(projectTitle + QStringLiteral(".sqlite"));
+}
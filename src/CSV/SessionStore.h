@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QPointF>
+#include <QThread>
+#include <QObject>
+#include <QVector>
+#include <QSqlQuery>
+#include <QScopedPointer>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <JSON/AlarmEngine.h>
+#include <Misc/Settings.h>
+
+namespace CSV
+{
+/**
+ * @brief The SessionStoreWorker class
+ *
+ * Worker object of the @c SessionStore class, runs in its own thread & owns
+ * the SQLite connection of the session database.
+ *
+ * Samples are inserted in large transactions, which are committed every
+ * second (see @c commit()) or when they hold too many rows, so that the cost
+ * of each transaction is shared by thousands of samples.
+ */
+class SessionStoreWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void openFailed(const QString &error);
+
+public:
+  SessionStoreWorker();
+  ~SessionStoreWorker();
+
+public Q_SLOTS:
+  void close();
+  void commit();
+  void open(const QString &path, const QString &project);
+  void write(const QVector<JSON::Frame> &frames);
+  void writeAlarms(const QVector<JSON::AlarmEvent> &events);
+  void writeMarker(const qint64 timestamp, const QString &label);
+
+private:
+  bool createSchema();
+  bool exec(const QString &sql);
+  void registerChannels(const JSON::Frame &frame);
+
+private:
+  qint64 m_session;
+  int m_pendingRows;
+  bool m_transaction;
+  quint64 m_schemaHash;
+  QString m_connection;
+  QVector<QVector<qint64>> m_channels;
+
+  QScopedPointer<QSqlQuery> m_sampleQuery;
+  QScopedPointer<QSqlQuery> m_alarmQuery;
+  QScopedPointer<QSqlQuery> m_markerQuery;
+};
+
+/**
+ * @brief The SessionStore class
+ *
+ * Stores the typed values of the generated frames, the alarm events & the
+ * user markers in a SQLite database (one database per project, in WAL mode),
+ * so that the player & external tools can run indexed range queries (e.g.
+ * "dataset X between t1 and t2") instead of scanning whole recordings.
+ *
+ * Each connection to a device creates a new row in the @c sessions table.
+ * Datasets are stored in the @c channels table, samples in the @c samples
+ * table (indexed by channel & timestamp), alarms & markers in the @c alarms
+ * & @c markers tables (indexed by session & timestamp). All timestamps are
+ * stored in milliseconds since the epoch. The @c sample_view view joins the
+ * samples with the titles of their channels.
+ *
+ * The database is written by a @c SessionStoreWorker that runs in its own
+ * thread, the amount of data waiting to be written is bounded, recorded data
+ * is never discarded.
+ */
+class SessionStore : public QObject, public JSON::FrameSink
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(bool isOpen
+               READ isOpen
+               NOTIFY openChanged)
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY openChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void openChanged();
+  void enabledChanged();
+
+private:
+  explicit SessionStore();
+  SessionStore(SessionStore &&) = delete;
+  SessionStore(const SessionStore &) = delete;
+  SessionStore &operator=(SessionStore &&) = delete;
+  SessionStore &operator=(const SessionStore &) = delete;
+
+  ~SessionStore();
+
+public:
+  static SessionStore &instance();
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  bool isOpen() const;
+  bool enabled() const;
+  QString fileName() const;
+
+  static QVector<QPointF> samples(const QString &path, const QString &group,
+                                  const QString &dataset, const qint64 from,
+                                  const qint64 to);
+
+public Q_SLOTS:
+  void closeDatabase();
+  void setEnabled(const bool enabled);
+  void addMarker(const QString &label);
+
+private Q_SLOTS:
+  void commit();
+  void onOpenFailed(const QString &error);
+  void onAlarmsTriggered(const QVector<JSON::AlarmEvent> &events);
+
+private:
+  QString databasePath(const QString &projectTitle) const;
+
+private:
+  bool m_open;
+  bool m_enabled;
+  QString m_fileName;
+  Misc::Settings m_settings;
+  std::atomic<int> m_queuedFrames;
+
+  QThread m_thread;
+  SessionStoreWorker *m_worker;
+};
+} // namespace CSV
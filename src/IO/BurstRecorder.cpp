@@ -0,0 +1,531 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QTimer>
+
+#include <IO/Manager.h>
+#include <IO/BurstRecorder.h>
+#include <JSON/Generator.h>
+#include <UI/Dashboard.h>
+
+/**
+ * Number of recorded frames that are processed by the JSON generator in each
+ * iteration of the event loop when the burst is displayed
+ */
+static const int REPLAY_CHUNK = 4096;
+
+/**
+ * Minimum interval (in microseconds) between progress reports of the worker
+ */
+static const qint64 REPORT_INTERVAL = 100000;
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, registers the worker as a consumer of the frame queue
+ */
+IO::BurstRecorderWorker::BurstRecorderWorker()
+  : m_recording(false)
+  , m_used(0)
+  , m_frameLimit(0)
+  , m_duration(0)
+  , m_lastReport(0)
+  , m_dropped(0)
+{
+  auto &queue = IO::Manager::instance().frameQueue();
+  m_consumer = queue.registerConsumer("IO::BurstRecorder");
+}
+
+/**
+ * Stops the current recording & hands the recorded frames to the recorder
+ */
+void IO::BurstRecorderWorker::stop()
+{
+  if (m_recording)
+    finish();
+}
+
+/**
+ * Copies the frames available in the frame queue to the arena. Frames are
+ * discarded without being copied if no burst is being recorded.
+ */
+void IO::BurstRecorderWorker::readFrames()
+{
+  // Not recording, discard the available frames
+  auto &queue = IO::Manager::instance().frameQueue();
+  if (!m_recording)
+  {
+    queue.skip(m_consumer);
+    return;
+  }
+
+  // Copy frames to the arena until a limit is reached
+  FrameInfo info;
+  while (m_recording && queue.pop(m_consumer, m_frame, &info))
+  {
+    // Stop when the duration of the burst is reached
+    if (m_duration > 0 && !m_info.isEmpty()
+        && info.timestamp - m_info.first().timestamp >= m_duration)
+    {
+      finish();
+      break;
+    }
+
+    // Stop when the arena is full
+    const int length = m_frame.size();
+    if (length > m_arena.size() - m_used)
+    {
+      finish();
+      break;
+    }
+
+    // Register the frame
+    memcpy(m_arena.data() + m_used, m_frame.constData(), length);
+    m_offsets.append(m_used);
+    m_info.append(info);
+    m_used += length;
+
+    // Stop when the number of frames is reached
+    if (m_info.count() >= m_frameLimit)
+      finish();
+  }
+
+  // Report progress periodically
+  const auto now = FrameQueue::timestamp();
+  if (m_recording && now - m_lastReport >= REPORT_INTERVAL)
+  {
+    m_lastReport = now;
+    const int frames = m_info.count();
+    const int bytes = m_used;
+    const quint64 dropped = queue.dropped(m_consumer) - m_dropped;
+    const qint64 elapsed = frames > 0 ? m_info.last().timestamp
+                                            - m_info.first().timestamp
+                                      : 0;
+
+    auto recorder = &BurstRecorder::instance();
+    QMetaObject::invokeMethod(recorder, [=] {
+      recorder->onProgress(frames, bytes, elapsed, dropped);
+    });
+  }
+}
+
+/**
+ * Allocates an arena of @a arenaSize bytes & an index for @a frameLimit
+ * frames and starts recording the frames published after this call. The
+ * recording stops automatically after @a duration microseconds (if
+ * positive).
+ */
+void IO::BurstRecorderWorker::start(const int arenaSize, const int frameLimit,
+                                    const qint64 duration)
+{
+  // Allocate the arena & the frame index
+  m_used = 0;
+  m_arena = QByteArray(arenaSize, Qt::Uninitialized);
+  m_offsets.clear();
+  m_offsets.reserve(frameLimit + 1);
+  m_info.clear();
+  m_info.reserve(frameLimit);
+
+  // Record frames published from now on
+  auto &queue = IO::Manager::instance().frameQueue();
+  queue.skip(m_consumer);
+  m_dropped = queue.dropped(m_consumer);
+  m_frameLimit = qMax(1, frameLimit);
+  m_duration = duration;
+  m_lastReport = 0;
+  m_recording = true;
+}
+
+/**
+ * Stops recording & hands the arena & the frame index over to the recorder.
+ * The index has one more offset than frames, so that the length of each frame
+ * can be calculated from the offset of the next one.
+ */
+void IO::BurstRecorderWorker::finish()
+{
+  // Stop recording
+  m_recording = false;
+  m_offsets.append(m_used);
+
+  // Hand the recorded data to the main thread
+  auto &queue = IO::Manager::instance().frameQueue();
+  const quint64 dropped = queue.dropped(m_consumer) - m_dropped;
+  const auto arena = m_arena;
+  const auto offsets = m_offsets;
+  const auto info = m_info;
+  auto recorder = &BurstRecorder::instance();
+  QMetaObject::invokeMethod(recorder, [=] {
+    recorder->onFinished(arena, offsets, info, dropped);
+  });
+
+  // Release the references of the worker
+  m_arena.clear();
+  m_offsets.clear();
+  m_info.clear();
+  m_used = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Recorder implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, reads the recording limits & starts the thread of
+ * the worker.
+ */
+IO::BurstRecorder::BurstRecorder()
+  : m_state(Idle)
+  , m_recordedFrames(0)
+  , m_recordedBytes(0)
+  , m_elapsed(0)
+  , m_droppedFrames(0)
+  , m_replayed(0)
+  , m_worker(new BurstRecorderWorker())
+{
+  // Read settings
+  m_arenaSize = m_settings.value("IO_BurstRecorder_ArenaSize", 64).toInt();
+  m_frameLimit = m_settings.value("IO_BurstRecorder_Frames", 500000).toInt();
+  m_duration = m_settings.value("IO_BurstRecorder_Duration", 10000).toInt();
+  m_arenaSize = qBound(1, m_arenaSize, 1024);
+  m_frameLimit = qBound(1, m_frameLimit, 10000000);
+  m_duration = qMax(0, m_duration);
+
+  // Start worker thread
+  m_thread.setObjectName(QStringLiteral("IO::BurstRecorderWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(&IO::Manager::instance(), &IO::Manager::framesAvailable, m_worker,
+          &BurstRecorderWorker::readFrames);
+  m_thread.start();
+}
+
+/**
+ * Stops the thread of the worker
+ */
+IO::BurstRecorder::~BurstRecorder()
+{
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::BurstRecorder &IO::BurstRecorder::instance()
+{
+  static BurstRecorder singleton;
+  return singleton;
+}
+
+/**
+ * Returns the current state of the recorder (see @c State)
+ */
+int IO::BurstRecorder::state() const
+{
+  return m_state;
+}
+
+/**
+ * Returns the size (in MB) of the arena in which bursts are recorded
+ */
+int IO::BurstRecorder::arenaSize() const
+{
+  return m_arenaSize;
+}
+
+/**
+ * Returns the maximum number of frames of a burst
+ */
+int IO::BurstRecorder::frameLimit() const
+{
+  return m_frameLimit;
+}
+
+/**
+ * Returns the maximum duration (in milliseconds) of a burst, zero means that
+ * the duration is not limited
+ */
+int IO::BurstRecorder::duration() const
+{
+  return m_duration;
+}
+
+/**
+ * Returns the number of frames recorded in the current burst
+ */
+int IO::BurstRecorder::recordedFrames() const
+{
+  return m_recordedFrames;
+}
+
+/**
+ * Returns the number of bytes recorded in the current burst
+ */
+int IO::BurstRecorder::recordedBytes() const
+{
+  return m_recordedBytes;
+}
+
+/**
+ * Returns the number of frames that were published while recording but could
+ * not be copied to the arena in time
+ */
+quint64 IO::BurstRecorder::droppedFrames() const
+{
+  return m_droppedFrames;
+}
+
+/**
+ * Returns the progress (from 0 to 1) of the recording or of the display of
+ * the recorded burst
+ */
+qreal IO::BurstRecorder::progress() const
+{
+  switch (m_state)
+  {
+    case Recording: {
+      const qreal frames = qreal(m_recordedFrames) / m_frameLimit;
+      const qreal bytes = qreal(m_recordedBytes) / (m_arenaSize * 1048576.0);
+      qreal time = 0;
+      if (m_duration > 0)
+        time = m_elapsed / (m_duration * 1000.0);
+
+      return qBound<qreal>(0, qMax(frames, qMax(bytes, time)), 1);
+    }
+    case Replaying:
+      if (m_recordedFrames > 0)
+        return qreal(m_replayed) / m_recordedFrames;
+      return 0;
+    case Reviewing:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Starts recording a new burst. Live frames are no longer processed by the
+ * JSON generator and the dashboard widgets are not redrawn until the burst
+ * has been recorded & processed.
+ */
+void IO::BurstRecorder::start()
+{
+  // Recording already in progress
+  if (m_state == Recording || m_state == Replaying)
+    return;
+
+  // Reset recording statistics
+  m_elapsed = 0;
+  m_replayed = 0;
+  m_recordedFrames = 0;
+  m_recordedBytes = 0;
+  m_droppedFrames = 0;
+  Q_EMIT progressChanged();
+
+  // Suspend the processing & display of live data
+  JSON::Generator::instance().setInputSuspended(true);
+  UI::Dashboard::instance().setRenderingSuspended(true);
+
+  // Start recording
+  auto worker = m_worker;
+  const int arena = m_arenaSize * 1024 * 1024;
+  const int frames = m_frameLimit;
+  const qint64 duration = m_duration * 1000;
+  QMetaObject::invokeMethod(worker,
+                            [=] { worker->start(arena, frames, duration); });
+  setState(Recording);
+}
+
+/**
+ * Stops recording the current burst, the frames recorded so far are
+ * displayed by the dashboard.
+ */
+void IO::BurstRecorder::stop()
+{
+  if (m_state == Recording)
+  {
+    auto worker = m_worker;
+    QMetaObject::invokeMethod(worker, [=] { worker->stop(); });
+  }
+}
+
+/**
+ * Resumes the processing & display of live data once the user has finished
+ * inspecting the recorded burst.
+ */
+void IO::BurstRecorder::resume()
+{
+  if (m_state == Reviewing)
+  {
+    JSON::Generator::instance().setInputSuspended(false);
+    setState(Idle);
+  }
+}
+
+/**
+ * Changes the size (in MB) of the arena in which bursts are recorded
+ */
+void IO::BurstRecorder::setArenaSize(const int megabytes)
+{
+  const auto value = qBound(1, megabytes, 1024);
+  if (m_arenaSize != value)
+  {
+    m_arenaSize = value;
+    m_settings.setValue("IO_BurstRecorder_ArenaSize", value);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the maximum number of frames of a burst
+ */
+void IO::BurstRecorder::setFrameLimit(const int frames)
+{
+  const auto value = qBound(1, frames, 10000000);
+  if (m_frameLimit != value)
+  {
+    m_frameLimit = value;
+    m_settings.setValue("IO_BurstRecorder_Frames", value);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the maximum duration (in milliseconds) of a burst, zero disables the
+ * duration limit
+ */
+void IO::BurstRecorder::setDuration(const int milliseconds)
+{
+  const auto value = qMax(0, milliseconds);
+  if (m_duration != value)
+  {
+    m_duration = value;
+    m_settings.setValue("IO_BurstRecorder_Duration", value);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Hands the next chunk of recorded frames to the JSON generator, the next
+ * chunk is processed during the next iteration of the event loop so that the
+ * user interface remains responsive. The dashboard is redrawn once all the
+ * frames have been processed.
+ */
+void IO::BurstRecorder::replayFrames()
+{
+  // Build the next chunk of frames
+  const int count = qMin(REPLAY_CHUNK, m_info.count() - m_replayed);
+  QVector<QByteArray> frames;
+  frames.reserve(count);
+  for (int i = m_replayed; i < m_replayed + count; ++i)
+  {
+    const int offset = m_offsets.at(i);
+    const int length = m_offsets.at(i + 1) - offset;
+    frames.append(QByteArray(m_arena.constData() + offset, length));
+  }
+
+  // Generate & publish the frames with their original timestamps
+  JSON::Generator::instance().processFrames(frames,
+                                            m_info.mid(m_replayed, count));
+  m_replayed += count;
+  Q_EMIT progressChanged();
+
+  // Process the next chunk
+  if (m_replayed < m_info.count())
+  {
+    QTimer::singleShot(0, this, &IO::BurstRecorder::replayFrames);
+    return;
+  }
+
+  // Release the arena & display the burst
+  m_arena.clear();
+  m_offsets.clear();
+  m_info.clear();
+  UI::Dashboard::instance().setRenderingSuspended(false);
+  setState(Reviewing);
+}
+
+/**
+ * Changes the state of the recorder & notifies the user interface
+ */
+void IO::BurstRecorder::setState(const State state)
+{
+  if (m_state != state)
+  {
+    m_state = state;
+    Q_EMIT stateChanged();
+    Q_EMIT progressChanged();
+  }
+}
+
+/**
+ * Updates the recording statistics reported by the worker
+ */
+void IO::BurstRecorder::onProgress(const int frames, const int bytes,
+                                   const qint64 elapsed,
+                                   const quint64 dropped)
+{
+  if (m_state != Recording)
+    return;
+
+  m_recordedFrames = frames;
+  m_recordedBytes = bytes;
+  m_elapsed = elapsed;
+  m_droppedFrames = dropped;
+  Q_EMIT progressChanged();
+}
+
+/**
+ * Receives the recorded burst from the worker & starts processing it
+ */
+void IO::BurstRecorder::onFinished(const QByteArray &arena,
+                                   const QVector<int> &offsets,
+                                   const QVector<FrameInfo> &info,
+                                   const quint64 dropped)
+{
+  // Register the recorded burst
+  m_arena = arena;
+  m_offsets = offsets;
+  m_info = info;
+  m_replayed = 0;
+  m_droppedFrames = dropped;
+  m_recordedFrames = info.count();
+  m_recordedBytes = offsets.isEmpty() ? 0 : offsets.last();
+  if (!info.isEmpty())
+    m_elapsed = info.last().timestamp - info.first().timestamp;
+
+  // Nothing was recorded, display live data again
+  if (m_info.isEmpty())
+  {
+    UI::Dashboard::instance().setRenderingSuspended(false);
+    setState(Reviewing);
+    return;
+  }
+
+  // Process the recorded frames
+  setState(Replaying);
+  QTimer::singleShot(0, this, &IO::BurstRecorder::replayFrames);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QThread>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+
+#include <IO/FrameQueue.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+/**
+ * @brief The BurstRecorderWorker class
+ *
+ * Worker object of the @c BurstRecorder class, runs in its own thread and
+ * copies the frames published to the frame queue into a pre-allocated arena
+ * while a burst is being recorded.
+ *
+ * The arena & the frame index are allocated before the recording starts, so
+ * no memory is allocated while frames are recorded. When the recording is
+ * finished, the arena & the index are handed over to the @c BurstRecorder.
+ */
+class BurstRecorderWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  BurstRecorderWorker();
+
+public Q_SLOTS:
+  void stop();
+  void readFrames();
+  void start(const int arenaSize, const int frameLimit,
+             const qint64 duration);
+
+private:
+  void finish();
+
+private:
+  bool m_recording;
+  int m_consumer;
+  int m_used;
+  int m_frameLimit;
+  qint64 m_duration;
+  qint64 m_lastReport;
+  quint64 m_dropped;
+
+  QByteArray m_frame;
+  QByteArray m_arena;
+  QVector<int> m_offsets;
+  QVector<FrameInfo> m_info;
+};
+
+/**
+ * @brief The BurstRecorder class
+ *
+ * Records short, high-rate bursts of frames at full resolution. While a burst
+ * is recorded, the JSON generator discards the frames received from the
+ * device and the dashboard is not redrawn, so that the only work done for
+ * each frame is copying it into a pre-allocated memory arena (see
+ * @c BurstRecorderWorker).
+ *
+ * The recording stops when the configured number of frames or duration is
+ * reached, when the arena is full or when the user stops it. The recorded
+ * frames are then processed by the JSON generator with their original
+ * timestamps, in chunks so that the user interface remains responsive, and
+ * the dashboard displays the burst. The plots keep the whole burst in their
+ * history, so it can be inspected with zoom & scroll.
+ *
+ * Live data is not displayed until the user resumes it with @c resume(), so
+ * that the burst is not scrolled away by new frames.
+ */
+class BurstRecorder : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int state
+               READ state
+               NOTIFY stateChanged)
+    Q_PROPERTY(int arenaSize
+               READ arenaSize
+               WRITE setArenaSize
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int frameLimit
+               READ frameLimit
+               WRITE setFrameLimit
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int duration
+               READ duration
+               WRITE setDuration
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int recordedFrames
+               READ recordedFrames
+               NOTIFY progressChanged)
+    Q_PROPERTY(int recordedBytes
+               READ recordedBytes
+               NOTIFY progressChanged)
+    Q_PROPERTY(quint64 droppedFrames
+               READ droppedFrames
+               NOTIFY progressChanged)
+    Q_PROPERTY(qreal progress
+               READ progress
+               NOTIFY progressChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void stateChanged();
+  void progressChanged();
+  void configurationChanged();
+
+private:
+  explicit BurstRecorder();
+  BurstRecorder(BurstRecorder &&) = delete;
+  BurstRecorder(const BurstRecorder &) = delete;
+  BurstRecorder &operator=(BurstRecorder &&) = delete;
+  BurstRecorder &operator=(const BurstRecorder &) = delete;
+
+  ~BurstRecorder();
+
+public:
+  enum State
+  {
+    Idle,
+    Recording,
+    Replaying,
+    Reviewing
+  };
+  Q_ENUM(State)
+
+  static BurstRecorder &instance();
+
+  int state() const;
+  int arenaSize() const;
+  int frameLimit() const;
+  int duration() const;
+  int recordedFrames() const;
+  int recordedBytes() const;
+  quint64 droppedFrames() const;
+  qreal progress() const;
+
+public Q_SLOTS:
+  void start();
+  void stop();
+  void resume();
+  void setArenaSize(const int megabytes);
+  void setFrameLimit(const int frames);
+  void setDuration(const int milliseconds);
+
+private Q_SLOTS:
+  void replayFrames();
+
+private:
+  void setState(const State state);
+  void onProgress(const int frames, const int bytes, const qint64 elapsed,
+                  const quint64 dropped);
+  void onFinished(const QByteArray &arena, const QVector<int> &offsets,
+                  const QVector<FrameInfo> &info, const quint64 dropped);
+
+private:
+  State m_state;
+  int m_arenaSize;
+  int m_frameLimit;
+  int m_duration;
+  int m_recordedFrames;
+  int m_recordedBytes;
+  qint64 m_elapsed;
+  quint64 m_droppedFrames;
+
+  int m_replayed;
+  QByteArray m_arena;
+  QVector<int> m_offsets;
+  QVector<FrameInfo> m_info;
+
+  QThread m_thread;
+  Misc::Settings m_settings;
+  BurstRecorderWorker *m_worker;
+
+  friend class BurstRecorderWorker;
+};
+} // namespace IO
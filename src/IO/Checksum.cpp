@@ -20,55 +20,435 @@
  * THE SOFTWARE.
  */
 
+#include <cstring>
 #include <IO/Checksum.h>
 
-uint8_t IO::crc8(const char *data, const int length)
+#if defined(__SSE4_2__)
+#  define CHECKSUM_SSE42
+#  include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#  define CHECKSUM_ARMV8
+#  include <arm_acle.h>
+#endif
+
+//----------------------------------------------------------------------------------------
+// Lookup tables
+//----------------------------------------------------------------------------------------
+
+/**
+ * Lookup table for MSB-first (non-reflected) 8-bit CRCs
+ */
+struct Crc8Table
+{
+  explicit Crc8Table(const uint8_t poly)
+  {
+    for (int i = 0; i < 256; ++i)
+    {
+      uint8_t crc = static_cast<uint8_t>(i);
+      for (int j = 0; j < 8; ++j)
+        crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ poly)
+                           : static_cast<uint8_t>(crc << 1);
+
+      table[i] = crc;
+    }
+  }
+
+  uint8_t table[256];
+};
+
+/**
+ * Lookup table for 16-bit CRCs, either MSB-first or reflected (LSB-first)
+ */
+struct Crc16Table
 {
-  uint8_t crc = 0xff;
-  for (int i = 0; i < length; i++)
+  explicit Crc16Table(const uint16_t poly, const bool reflected)
   {
-    crc ^= data[i];
-    for (int j = 0; j < 8; j++)
+    for (int i = 0; i < 256; ++i)
     {
-      if ((crc & 0x80) != 0)
-        crc = (uint8_t)((crc << 1) ^ 0x31);
+      uint16_t crc;
+      if (reflected)
+      {
+        crc = static_cast<uint16_t>(i);
+        for (int j = 0; j < 8; ++j)
+          crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ poly)
+                          : static_cast<uint16_t>(crc >> 1);
+      }
+
       else
-        crc <<= 1;
+      {
+        crc = static_cast<uint16_t>(i << 8);
+        for (int j = 0; j < 8; ++j)
+          crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ poly)
+                               : static_cast<uint16_t>(crc << 1);
+      }
+
+      table[i] = crc;
     }
   }
 
+  uint16_t table[256];
+};
+
+/**
+ * Slicing-by-8 lookup tables for reflected 32-bit CRCs, each table allows
+ * processing one of the eight bytes of a block in parallel.
+ */
+struct Crc32Tables
+{
+  explicit Crc32Tables(const uint32_t poly)
+  {
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; ++j)
+        crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+
+      table[0][i] = crc;
+    }
+
+    for (int i = 0; i < 256; ++i)
+    {
+      for (int k = 1; k < 8; ++k)
+      {
+        const uint32_t prev = table[k - 1][i];
+        table[k][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+      }
+    }
+  }
+
+  uint32_t table[8][256];
+};
+
+/**
+ * Updates the given reflected 32-bit @a crc register with the given @a data,
+ * processing eight bytes per iteration.
+ */
+static uint32_t SLICE_BY_8(const Crc32Tables &tables, uint32_t crc,
+                           const uint8_t *data, int length)
+{
+  const auto &t = tables.table;
+  while (length >= 8)
+  {
+    crc ^= static_cast<uint32_t>(data[0])
+           | static_cast<uint32_t>(data[1]) << 8
+           | static_cast<uint32_t>(data[2]) << 16
+           | static_cast<uint32_t>(data[3]) << 24;
+
+    crc = t[7][crc & 0xFF] ^ t[6][(crc >> 8) & 0xFF]
+          ^ t[5][(crc >> 16) & 0xFF] ^ t[4][crc >> 24] ^ t[3][data[4]]
+          ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+
+    data += 8;
+    length -= 8;
+  }
+
+  while (length-- > 0)
+    crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+
   return crc;
 }
 
+//----------------------------------------------------------------------------------------
+// CRC implementations
+//----------------------------------------------------------------------------------------
+
+/**
+ * Calculates the CRC-8 (polynomial 0x31, initial value 0xFF) of the given
+ * @a data.
+ */
+uint8_t IO::crc8(const char *data, const int length)
+{
+  static const Crc8Table table(0x31);
+
+  uint8_t crc = 0xFF;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+  for (int i = 0; i < length; ++i)
+    crc = table.table[crc ^ bytes[i]];
+
+  return crc;
+}
+
+/**
+ * Calculates the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value
+ * 0xFFFF) of the given @a data.
+ */
 uint16_t IO::crc16(const char *data, const int length)
 {
-  uint8_t x;
-  uint16_t crc = 0xFFFF;
+  static const Crc16Table table(0x1021, false);
 
+  uint16_t crc = 0xFFFF;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
   for (int i = 0; i < length; ++i)
-  {
-    x = crc >> 8 ^ data[i];
-    x ^= x >> 4;
-    crc = (crc << 8) ^ ((uint16_t)(x << 12)) ^ ((uint16_t)(x << 5))
-          ^ ((uint16_t)x);
-  }
+    crc = static_cast<uint16_t>(crc << 8)
+          ^ table.table[((crc >> 8) ^ bytes[i]) & 0xFF];
 
   return crc;
 }
 
+/**
+ * Calculates the standard CRC-32 (reflected polynomial 0xEDB88320) of the
+ * given @a data using the slicing-by-8 algorithm.
+ */
 uint32_t IO::crc32(const char *data, const int length)
 {
-  uint32_t mask;
+  static const Crc32Tables tables(0xEDB88320);
+
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+  return ~SLICE_BY_8(tables, 0xFFFFFFFF, bytes, length);
+}
+
+/**
+ * Calculates the CRC-32C/Castagnoli (reflected polynomial 0x82F63B78) of the
+ * given @a data.
+ *
+ * The SSE4.2 or ARMv8 CRC instructions are used if the compiler targets them,
+ * otherwise the slicing-by-8 algorithm is used.
+ */
+uint32_t IO::crc32c(const char *data, const int length)
+{
   uint32_t crc = 0xFFFFFFFF;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+
+#if defined(CHECKSUM_SSE42)
+  int i = 0;
+#  if defined(__x86_64__) || defined(_M_X64)
+  uint64_t crc64 = crc;
+  for (; i + 8 <= length; i += 8)
+  {
+    uint64_t block;
+    memcpy(&block, bytes + i, sizeof(block));
+    crc64 = _mm_crc32_u64(crc64, block);
+  }
+  crc = static_cast<uint32_t>(crc64);
+#  endif
+  for (; i < length; ++i)
+    crc = _mm_crc32_u8(crc, bytes[i]);
+
+  return ~crc;
+#elif defined(CHECKSUM_ARMV8)
+  int i = 0;
+  for (; i + 8 <= length; i += 8)
+  {
+    uint64_t block;
+    memcpy(&block, bytes + i, sizeof(block));
+    crc = __crc32cd(crc, block);
+  }
+  for (; i < length; ++i)
+    crc = __crc32cb(crc, bytes[i]);
+
+  return ~crc;
+#else
+  static const Crc32Tables tables(0x82F63B78);
+  return ~SLICE_BY_8(tables, crc, bytes, length);
+#endif
+}
+
+/**
+ * Calculates the CRC-16/MODBUS (reflected polynomial 0xA001, initial value
+ * 0xFFFF) of the given @a data.
+ */
+uint16_t IO::crc16Modbus(const char *data, const int length)
+{
+  static const Crc16Table table(0xA001, true);
+
+  uint16_t crc = 0xFFFF;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+  for (int i = 0; i < length; ++i)
+    crc = (crc >> 8) ^ table.table[(crc ^ bytes[i]) & 0xFF];
+
+  return crc;
+}
+
+/**
+ * Calculates the CRC-16/XMODEM (polynomial 0x1021, initial value 0x0000) of
+ * the given @a data, used by the XMODEM & YMODEM file transfer protocols.
+ */
+uint16_t IO::crc16Xmodem(const char *data, const int length)
+{
+  static const Crc16Table table(0x1021, false);
+
+  uint16_t crc = 0x0000;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+  for (int i = 0; i < length; ++i)
+    crc = static_cast<uint16_t>(crc << 8)
+          ^ table.table[((crc >> 8) ^ bytes[i]) & 0xFF];
+
+  return crc;
+}
+
+/**
+ * Calculates the CRC-16/CCITT, also known as CRC-16/KERMIT (reflected
+ * polynomial 0x8408, initial value 0x0000) of the given @a data.
+ */
+uint16_t IO::crc16Ccitt(const char *data, const int length)
+{
+  static const Crc16Table table(0x8408, true);
+
+  uint16_t crc = 0x0000;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
   for (int i = 0; i < length; ++i)
+    crc = (crc >> 8) ^ table.table[(crc ^ bytes[i]) & 0xFF];
+
+  return crc;
+}
+
+//----------------------------------------------------------------------------------------
+// Simple checksums
+//----------------------------------------------------------------------------------------
+
+/**
+ * Calculates the Fletcher-16 checksum of the given @a data. The modulo is
+ * only applied every 5802 bytes, which is the largest block for which the
+ * 32-bit sums cannot overflow.
+ */
+uint16_t IO::fletcher16(const char *data, const int length)
+{
+  uint32_t sum1 = 0;
+  uint32_t sum2 = 0;
+  int remaining = length;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+  while (remaining > 0)
   {
-    crc = crc ^ data[i];
-    for (int j = 8; j >= 0; j--)
+    int block = remaining < 5802 ? remaining : 5802;
+    remaining -= block;
+    while (block-- > 0)
     {
-      mask = -(crc & 1);
-      crc = (crc >> 1) ^ (0xEDB88320 & mask);
+      sum1 += *bytes++;
+      sum2 += sum1;
     }
+
+    sum1 %= 255;
+    sum2 %= 255;
   }
 
-  return ~crc;
+  return static_cast<uint16_t>((sum2 << 8) | sum1);
+}
+
+/**
+ * Calculates the XOR of all the bytes of the given @a data.
+ */
+uint8_t IO::xor8(const char *data, const int length)
+{
+  uint8_t value = 0;
+  auto bytes = reinterpret_cast<const uint8_t *>(data);
+  for (int i = 0; i < length; ++i)
+    value ^= bytes[i];
+
+  return value;
+}
+
+//----------------------------------------------------------------------------------------
+// Checksum selection
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the number of bytes used to transmit the given checksum
+ * @a algorithm.
+ */
+int IO::checksumLength(const ChecksumAlgorithm algorithm)
+{
+  switch (algorithm)
+  {
+    case ChecksumAlgorithm::CRC8:
+    case ChecksumAlgorithm::XOR8:
+      return 1;
+    case ChecksumAlgorithm::CRC16:
+    case ChecksumAlgorithm::CRC16_MODBUS:
+    case ChecksumAlgorithm::CRC16_CCITT:
+    case ChecksumAlgorithm::Fletcher16:
+      return 2;
+    case ChecksumAlgorithm::CRC32:
+    case ChecksumAlgorithm::CRC32C:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Returns the number of characters used to transmit the given checksum
+ * @a algorithm with the given @a encoding.
+ */
+int IO::checksumLength(const ChecksumAlgorithm algorithm,
+                       const ChecksumEncoding encoding)
+{
+  if (encoding == ChecksumEncoding::Hex)
+    return checksumLength(algorithm) * 2;
+
+  return checksumLength(algorithm);
+}
+
+/**
+ * Reads a received checksum of @a length characters from the given @a data
+ * with the given @a encoding.
+ *
+ * @returns @c false if the data is not a valid checksum (e.g. it contains
+ *          non-hexadecimal characters).
+ */
+bool IO::readChecksum(const char *data, const int length,
+                      const ChecksumEncoding encoding, uint32_t *value)
+{
+  // Validate arguments
+  if (!data || !value || length <= 0)
+    return false;
+
+  // Read big endian bytes
+  uint32_t received = 0;
+  if (encoding == ChecksumEncoding::Raw)
+  {
+    for (int i = 0; i < length; ++i)
+      received = (received << 8) | static_cast<uint8_t>(data[i]);
+
+    *value = received;
+    return true;
+  }
+
+  // Read ASCII hexadecimal digits (upper or lower case)
+  for (int i = 0; i < length; ++i)
+  {
+    const char c = data[i];
+    uint32_t nibble = 0;
+    if (c >= '0' && c <= '9')
+      nibble = c - '0';
+    else if (c >= 'A' && c <= 'F')
+      nibble = c - 'A' + 10;
+    else if (c >= 'a' && c <= 'f')
+      nibble = c - 'a' + 10;
+    else
+      return false;
+
+    received = (received << 4) | nibble;
+  }
+
+  *value = received;
+  return true;
+}
+
+/**
+ * Calculates the checksum of the given @a data with the given @a algorithm.
+ */
+uint32_t IO::checksum(const ChecksumAlgorithm algorithm, const char *data,
+                      const int length)
+{
+  switch (algorithm)
+  {
+    case ChecksumAlgorithm::CRC8:
+      return crc8(data, length);
+    case ChecksumAlgorithm::CRC16:
+      return crc16(data, length);
+    case ChecksumAlgorithm::CRC16_MODBUS:
+      return crc16Modbus(data, length);
+    case ChecksumAlgorithm::CRC16_CCITT:
+      return crc16Ccitt(data, length);
+    case ChecksumAlgorithm::CRC32:
+      return crc32(data, length);
+    case ChecksumAlgorithm::CRC32C:
+      return crc32c(data, length);
+    case ChecksumAlgorithm::Fletcher16:
+      return fletcher16(data, length);
+    case ChecksumAlgorithm::XOR8:
+      return xor8(data, length);
+    default:
+      return 0;
+  }
 }
@@ -27,7 +27,61 @@
 
 namespace IO
 {
+/**
+ * Checksum algorithms that can be appended to each frame, selectable per
+ * project. Checksums are always transmitted in big endian byte order.
+ */
+enum class ChecksumAlgorithm
+{
+  None,
+  CRC8,
+  CRC16,
+  CRC16_MODBUS,
+  CRC16_CCITT,
+  CRC32,
+  CRC32C,
+  Fletcher16,
+  XOR8
+};
+
+/**
+ * Location of the checksum relative to the finish sequence of a frame. The
+ * checksum either precedes the finish sequence (and is therefore part of the
+ * frame data) or follows it as a fixed-length trailer.
+ */
+enum class ChecksumPlacement
+{
+  BeforeFinish,
+  AfterFinish
+};
+
+/**
+ * Encoding used to transmit the checksum, either as raw big endian bytes or
+ * as ASCII hexadecimal digits (two characters per byte, e.g. "*4F" style
+ * NMEA/Modbus ASCII trailers).
+ */
+enum class ChecksumEncoding
+{
+  Raw,
+  Hex
+};
+
 uint8_t crc8(const char *data, const int length);
 uint16_t crc16(const char *data, const int length);
 uint32_t crc32(const char *data, const int length);
+
+uint32_t crc32c(const char *data, const int length);
+uint16_t crc16Modbus(const char *data, const int length);
+uint16_t crc16Ccitt(const char *data, const int length);
+uint16_t crc16Xmodem(const char *data, const int length);
+uint16_t fletcher16(const char *data, const int length);
+uint8_t xor8(const char *data, const int length);
+
+int checksumLength(const ChecksumAlgorithm algorithm);
+int checksumLength(const ChecksumAlgorithm algorithm,
+                   const ChecksumEncoding encoding);
+bool readChecksum(const char *data, const int length,
+                  const ChecksumEncoding encoding, uint32_t *value);
+uint32_t checksum(const ChecksumAlgorithm algorithm, const char *data,
+                  const int length);
 } // namespace IO
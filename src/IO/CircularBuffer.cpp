@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QtGlobal>
+#include <IO/CircularBuffer.h>
+#include <IO/DelimiterScanner.h>
+
+/**
+ * Constructor function, allocates @a capacity bytes for the ring storage
+ */
+IO::CircularBuffer::CircularBuffer(const int capacity)
+  : m_head(0)
+  , m_size(0)
+{
+  setCapacity(capacity);
+}
+
+/**
+ * Returns the number of bytes currently stored in the buffer
+ */
+int IO::CircularBuffer::size() const
+{
+  return m_size;
+}
+
+/**
+ * Returns the maximum number of bytes that the buffer can hold
+ */
+int IO::CircularBuffer::capacity() const
+{
+  return m_data.size();
+}
+
+/**
+ * Returns the number of bytes that can be appended before the oldest data
+ * starts being overwritten.
+ */
+int IO::CircularBuffer::freeSpace() const
+{
+  return capacity() - m_size;
+}
+
+/**
+ * Returns @c true if the buffer holds no data
+ */
+bool IO::CircularBuffer::isEmpty() const
+{
+  return m_size == 0;
+}
+
+/**
+ * Returns the byte located at the given @a offset from the read position.
+ *
+ * @warning no bounds checking is performed, @a offset must be smaller than
+ *          @c size().
+ */
+char IO::CircularBuffer::at(const int offset) const
+{
+  return m_data.at((m_head + offset) % m_data.size());
+}
+
+/**
+ * Returns @c true if the given @a sequence is stored at the given @a offset,
+ * taking into account that the sequence may wrap around the end of the ring.
+ */
+bool IO::CircularBuffer::matches(const int offset,
+                                 const QByteArray &sequence) const
+{
+  // Check that the sequence fits in the stored data
+  const int length = sequence.length();
+  if (offset < 0 || length <= 0 || offset + length > m_size)
+    return false;
+
+  // Get physical position & size of the first contiguous segment
+  const int cap = m_data.size();
+  const int pos = (m_head + offset) % cap;
+  const int span = qMin(length, cap - pos);
+
+  // Compare both segments
+  const char *data = m_data.constData();
+  if (memcmp(data + pos, sequence.constData(), span) != 0)
+    return false;
+  if (span < length)
+    return memcmp(data, sequence.constData() + span, length - span) == 0;
+
+  return true;
+}
+
+/**
+ * Returns the offset of the first occurrence of @a sequence, starting the
+ * search at the given @a from offset. Returns -1 if the sequence is not found.
+ *
+ * Each contiguous segment of the ring is searched with the
+ * @c DelimiterScanner, positions in which the sequence would wrap around the
+ * end of the ring are checked individually.
+ */
+int IO::CircularBuffer::indexOf(const QByteArray &sequence,
+                                const int from) const
+{
+  // Validate arguments
+  const int length = sequence.length();
+  if (length <= 0 || from < 0 || m_size - from < length)
+    return -1;
+
+  // Initialize parameters
+  const int cap = m_data.size();
+  const char *data = m_data.constData();
+  const int pos = (m_head + from) % cap;
+  const int available = m_size - from;
+  const int span = qMin(available, cap - pos);
+
+  // Search the first contiguous segment
+  auto index = DelimiterScanner::find(data + pos, span, sequence.constData(),
+                                      length);
+  if (index >= 0)
+    return from + index;
+
+  // Data does not wrap around, sequence not found
+  if (span == available)
+    return -1;
+
+  // Check the positions in which the sequence wraps around the ring
+  for (int i = qMax(0, span - length + 1); i < span; ++i)
+  {
+    if (matches(from + i, sequence))
+      return from + i;
+  }
+
+  // Search the second contiguous segment
+  index = DelimiterScanner::find(data, available - span, sequence.constData(),
+                                 length);
+  if (index >= 0)
+    return from + span + index;
+
+  // Sequence not found
+  return -1;
+}
+
+/**
+ * Returns @a length bytes starting at the given @a offset.
+ *
+ * If the requested region is stored contiguously, the returned byte array is
+ * a view created with @c QByteArray::fromRawData(), which is only valid until
+ * the buffer is modified. Use @c read() to obtain a deep copy.
+ */
+QByteArray IO::CircularBuffer::peek(const int offset, const int length) const
+{
+  // Validate arguments
+  if (offset < 0 || length <= 0 || offset + length > m_size)
+    return QByteArray();
+
+  // Region is contiguous, return a view over the ring storage
+  const int pos = (m_head + offset) % m_data.size();
+  if (pos + length <= m_data.size())
+    return QByteArray::fromRawData(m_data.constData() + pos, length);
+
+  // Region wraps around, copy it
+  return read(offset, length);
+}
+
+/**
+ * Returns a deep copy of @a length bytes starting at the given @a offset.
+ */
+QByteArray IO::CircularBuffer::read(const int offset, const int length) const
+{
+  // Validate arguments
+  if (offset < 0 || length <= 0 || offset + length > m_size)
+    return QByteArray();
+
+  // Get physical position & size of the first contiguous segment
+  const int cap = m_data.size();
+  const int pos = (m_head + offset) % cap;
+  const int span = qMin(length, cap - pos);
+
+  // Copy both segments
+  QByteArray copy(length, Qt::Uninitialized);
+  memcpy(copy.data(), m_data.constData() + pos, span);
+  if (span < length)
+    memcpy(copy.data() + span, m_data.constData(), length - span);
+
+  return copy;
+}
+
+/**
+ * Removes all the data stored in the buffer, the capacity is not modified.
+ */
+void IO::CircularBuffer::clear()
+{
+  m_head = 0;
+  m_size = 0;
+}
+
+/**
+ * Discards the given number of @a bytes from the front of the buffer. This
+ * only moves the read position, no data is copied. The write position is not
+ * reset when the buffer becomes empty, so that consumed data can still be
+ * referenced by @c appendMatch().
+ */
+void IO::CircularBuffer::consume(const int bytes)
+{
+  if (bytes <= 0)
+    return;
+
+  const int count = qMin(bytes, m_size);
+  m_head = (m_head + count) % m_data.size();
+  m_size -= count;
+}
+
+/**
+ * Appends the given @a data to the buffer. If there is not enough free space,
+ * the oldest bytes are discarded to make room for the new data.
+ */
+void IO::CircularBuffer::append(const QByteArray &data)
+{
+  append(data.constData(), data.size());
+}
+
+/**
+ * Appends @a length bytes from the given @a data pointer to the buffer. If
+ * there is not enough free space, the oldest bytes are discarded to make room
+ * for the new data.
+ */
+void IO::CircularBuffer::append(const char *data, const int length)
+{
+  // Nothing to append
+  const int cap = m_data.size();
+  if (!data || length <= 0)
+    return;
+
+  // Data is larger than the buffer, keep only the most recent bytes
+  if (length >= cap)
+  {
+    memcpy(m_data.data(), data + length - cap, cap);
+    m_head = 0;
+    m_size = cap;
+    return;
+  }
+
+  // Drop the oldest data if required
+  if (length > freeSpace())
+    consume(length - freeSpace());
+
+  // Write data at the tail of the ring, wrapping around if needed
+  const int tail = (m_head + m_size) % cap;
+  const int span = qMin(length, cap - tail);
+  memcpy(m_data.data() + tail, data, span);
+  if (span < length)
+    memcpy(m_data.data(), data + span, length - span);
+
+  // Update size
+  m_size += length;
+}
+
+/**
+ * Appends @a length bytes copied from @a distance bytes before the end of the
+ * written data, as required by LZ77 back-references. The source & destination
+ * regions may overlap (e.g. a distance of 1 repeats the last byte), so the
+ * bytes are copied one by one in that case.
+ *
+ * Bytes that were already consumed are still valid sources, since the ring
+ * is only overwritten after wrapping around.
+ *
+ * @warning no bounds checking is performed, @a distance must not exceed the
+ *          number of bytes written since the buffer was cleared (nor the
+ *          capacity), and @a length must not exceed @c freeSpace().
+ */
+void IO::CircularBuffer::appendMatch(const int distance, const int length)
+{
+  const int cap = m_data.size();
+  const int tail = (m_head + m_size) % cap;
+  int src = (tail - distance + cap) % cap;
+  char *data = m_data.data();
+
+  // Non-overlapping copy that does not wrap around, use memcpy()
+  if (distance >= length && src + length <= cap && tail + length <= cap)
+    memcpy(data + tail, data + src, length);
+
+  // Copy byte by byte
+  else
+  {
+    int dst = tail;
+    for (int i = 0; i < length; ++i)
+    {
+      data[dst] = data[src];
+      dst = dst + 1 == cap ? 0 : dst + 1;
+      src = src + 1 == cap ? 0 : src + 1;
+    }
+  }
+
+  m_size += length;
+}
+
+/**
+ * Removes the given number of @a bytes from the end of the buffer, which is
+ * used to roll back data that was partially appended.
+ */
+void IO::CircularBuffer::chop(const int bytes)
+{
+  if (bytes > 0)
+    m_size = qMax(0, m_size - bytes);
+}
+
+/**
+ * Changes the capacity of the buffer, stored data is discarded.
+ */
+void IO::CircularBuffer::setCapacity(const int capacity)
+{
+  m_data = QByteArray(qMax(1, capacity), Qt::Uninitialized);
+  clear();
+}
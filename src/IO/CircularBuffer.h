@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QByteArray>
+
+namespace IO
+{
+/**
+ * @brief The CircularBuffer class
+ *
+ * Fixed-capacity byte ring used by the I/O manager to store incoming data
+ * until complete frames can be extracted from it.
+ *
+ * Unlike a plain @c QByteArray, consuming bytes from the front of the buffer
+ * is an O(1) operation (the read position is simply moved forward), so the
+ * backlog is never shifted or copied while frames are being extracted.
+ *
+ * All offsets used by this class are relative to the current read position,
+ * offset 0 being the oldest byte stored in the buffer.
+ */
+class CircularBuffer
+{
+public:
+  explicit CircularBuffer(const int capacity = 1024 * 1024);
+
+  int size() const;
+  int capacity() const;
+  int freeSpace() const;
+  bool isEmpty() const;
+
+  char at(const int offset) const;
+  bool matches(const int offset, const QByteArray &sequence) const;
+  int indexOf(const QByteArray &sequence, const int from = 0) const;
+
+  QByteArray peek(const int offset, const int length) const;
+  QByteArray read(const int offset, const int length) const;
+
+  void clear();
+  void consume(const int bytes);
+  void chop(const int bytes);
+  void append(const QByteArray &data);
+  void append(const char *data, const int length);
+  void appendMatch(const int distance, const int length);
+  void setCapacity(const int capacity);
+
+private:
+  int m_head;
+  int m_size;
+  QByteArray m_data;
+};
+} // namespace IO
@@ -0,0 +1,569 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QThread>
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/CommandScheduler.h>
+#include <Misc/TimerEvents.h>
+
+/**
+ * Time (in microseconds) before a deadline in which the scheduler waits
+ * actively instead of arming the timer again
+ */
+static const qint64 SPIN_THRESHOLD = 250;
+
+/**
+ * Minimum interval (in milliseconds) between two transmissions of a command
+ */
+static const int MIN_INTERVAL = 1;
+
+/**
+ * Maximum number of bytes received after a command that are kept while
+ * looking for its expected response
+ */
+static const int MAX_RESPONSE_BUFFER = 4096;
+
+/**
+ * Constructor function, loads the configured commands & starts sending them
+ * when a device is connected.
+ */
+IO::CommandScheduler::CommandScheduler()
+  : m_statsChanged(false)
+{
+  // Configure the timer
+  m_timer.setSingleShot(true);
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this,
+          &IO::CommandScheduler::processCommands);
+
+  // Load commands
+  readSettings();
+
+  // React to device events
+  auto &manager = IO::Manager::instance();
+  connect(&manager, &IO::Manager::connectedChanged, this,
+          &IO::CommandScheduler::onConnectedChanged);
+  connect(&manager, &IO::Manager::deviceDataReceived, this,
+          &IO::CommandScheduler::onDataReceived);
+
+  // Update statistics in the user interface periodically
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz, this,
+          [=] {
+            if (m_statsChanged)
+            {
+              m_statsChanged = false;
+              Q_EMIT statisticsChanged();
+            }
+          });
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::CommandScheduler &IO::CommandScheduler::instance()
+{
+  static CommandScheduler singleton;
+  return singleton;
+}
+
+/**
+ * Returns the number of configured commands
+ */
+int IO::CommandScheduler::count() const
+{
+  return m_commands.count();
+}
+
+/**
+ * Returns the number of commands that are waiting for a response
+ */
+int IO::CommandScheduler::pendingResponses() const
+{
+  int pending = 0;
+  for (const auto &command : m_commands)
+  {
+    if (command.pending)
+      ++pending;
+  }
+
+  return pending;
+}
+
+/**
+ * Returns the total number of responses that did not arrive in time
+ */
+quint64 IO::CommandScheduler::timeouts() const
+{
+  quint64 timeouts = 0;
+  for (const auto &command : m_commands)
+    timeouts += command.timeouts;
+
+  return timeouts;
+}
+
+/**
+ * Returns the configuration of each command, as a list of maps with the
+ * name, payload, hex, enabled, interval (ms), timeout (ms) & response keys.
+ */
+QVariantList IO::CommandScheduler::commands() const
+{
+  QVariantList list;
+  for (const auto &command : m_commands)
+  {
+    QVariantMap map;
+    map.insert("name", command.name);
+    map.insert("payload", command.text);
+    map.insert("hex", command.hex);
+    map.insert("enabled", command.enabled);
+    map.insert("interval", command.interval / 1000);
+    map.insert("timeout", command.timeout / 1000);
+    map.insert("response", command.responseText);
+    list.append(map);
+  }
+
+  return list;
+}
+
+/**
+ * Returns the statistics of each command, as a list of maps with the name,
+ * sent, responses, timeouts & skipped counters, and the last & average
+ * response latency and the maximum transmission lateness (in microseconds).
+ */
+QVariantList IO::CommandScheduler::statistics() const
+{
+  QVariantList list;
+  for (const auto &command : m_commands)
+  {
+    qint64 average = 0;
+    if (command.responses > 0)
+      average = command.totalLatency / qint64(command.responses);
+
+    QVariantMap map;
+    map.insert("name", command.name);
+    map.insert("sent", command.sent);
+    map.insert("responses", command.responses);
+    map.insert("timeouts", command.timeouts);
+    map.insert("skipped", command.skipped);
+    map.insert("lastLatency", command.lastLatency);
+    map.insert("averageLatency", average);
+    map.insert("maxLateness", command.maxLateness);
+    list.append(map);
+  }
+
+  return list;
+}
+
+/**
+ * Registers a new command with the given @a name, which sends the given
+ * @a payload (in hexadecimal format if @a hex is @c true) every @a interval
+ * milliseconds.
+ *
+ * If @a timeout is greater than zero, the scheduler waits for a response
+ * after each transmission, which must contain the given @a response (or any
+ * data if @a response is empty) & be received within @a timeout
+ * milliseconds.
+ *
+ * @returns the index of the new command, or -1 if the payload is empty.
+ */
+int IO::CommandScheduler::addCommand(const QString &name,
+                                     const QString &payload, const bool hex,
+                                     const int interval, const int timeout,
+                                     const QString &response)
+{
+  // Validate payload
+  Command command;
+  command.payload = encode(payload, hex);
+  if (command.payload.isEmpty())
+    return -1;
+
+  // Register command
+  command.name = name;
+  command.text = payload;
+  command.hex = hex;
+  command.interval = qMax(MIN_INTERVAL, interval) * 1000LL;
+  command.timeout = qMax(0, timeout) * 1000LL;
+  command.responseText = response;
+  command.response = encode(response, hex);
+  m_commands.append(command);
+
+  // Update settings & schedule the command
+  writeSettings();
+  Q_EMIT commandsChanged();
+  Q_EMIT statisticsChanged();
+  start();
+
+  return m_commands.count() - 1;
+}
+
+/**
+ * Resets the counters & latency measurements of all commands
+ */
+void IO::CommandScheduler::clearStatistics()
+{
+  for (auto &command : m_commands)
+  {
+    command.sent = 0;
+    command.responses = 0;
+    command.timeouts = 0;
+    command.skipped = 0;
+    command.lastLatency = 0;
+    command.totalLatency = 0;
+    command.maxLateness = 0;
+  }
+
+  m_statsChanged = false;
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Removes the command at the given @a index
+ */
+void IO::CommandScheduler::removeCommand(const int index)
+{
+  if (index < 0 || index >= m_commands.count())
+    return;
+
+  m_commands.remove(index);
+  writeSettings();
+  schedule();
+
+  Q_EMIT commandsChanged();
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Enables or disables the transmission of the command at the given @a index
+ */
+void IO::CommandScheduler::setCommandEnabled(const int index,
+                                             const bool enabled)
+{
+  if (index < 0 || index >= m_commands.count())
+    return;
+
+  auto &command = m_commands[index];
+  if (command.enabled != enabled)
+  {
+    command.enabled = enabled;
+    command.pending = false;
+    command.deadline = 0;
+    writeSettings();
+    start();
+
+    Q_EMIT commandsChanged();
+  }
+}
+
+/**
+ * Changes the transmission @a interval (in milliseconds) of the command at
+ * the given @a index, the new interval is applied after the next
+ * transmission.
+ */
+void IO::CommandScheduler::setCommandInterval(const int index,
+                                              const int interval)
+{
+  if (index < 0 || index >= m_commands.count())
+    return;
+
+  auto &command = m_commands[index];
+  const qint64 value = qMax(MIN_INTERVAL, interval) * 1000LL;
+  if (command.interval != value)
+  {
+    command.interval = value;
+    writeSettings();
+
+    Q_EMIT commandsChanged();
+  }
+}
+
+/**
+ * Schedules the first transmission of the enabled commands that have not
+ * been scheduled yet, commands are sent as soon as the device is connected.
+ */
+void IO::CommandScheduler::start()
+{
+  if (!IO::Manager::instance().connected())
+    return;
+
+  const auto now = FrameQueue::timestamp();
+  for (auto &command : m_commands)
+  {
+    if (command.enabled && command.deadline == 0)
+      command.deadline = now;
+  }
+
+  processCommands();
+}
+
+/**
+ * Arms the timer so that it expires just before the earliest deadline of
+ * the enabled commands, the timer is stopped if there is nothing to send or
+ * no response to wait for.
+ */
+void IO::CommandScheduler::schedule()
+{
+  // Find the earliest deadline or response timeout
+  qint64 next = 0;
+  for (const auto &command : m_commands)
+  {
+    if (!command.enabled || command.deadline == 0)
+      continue;
+
+    if (next == 0 || command.deadline < next)
+      next = command.deadline;
+
+    const auto expiry = command.sentAt + command.timeout;
+    if (command.pending && command.timeout > 0 && expiry < next)
+      next = expiry;
+  }
+
+  // Nothing to do
+  if (next == 0)
+  {
+    m_timer.stop();
+    return;
+  }
+
+  // Arm the timer, rounding down so that it never expires late
+  const auto remaining = next - FrameQueue::timestamp() - SPIN_THRESHOLD;
+  m_timer.start(static_cast<int>(qMax<qint64>(0, remaining / 1000)));
+}
+
+/**
+ * Sends the commands whose deadline has been reached, checks the response
+ * timeouts & arms the timer for the next deadline.
+ */
+void IO::CommandScheduler::processCommands()
+{
+  // Device disconnected, stop sending commands
+  if (!IO::Manager::instance().connected())
+  {
+    m_timer.stop();
+    return;
+  }
+
+  // Wait actively for deadlines that are about to be reached
+  auto now = FrameQueue::timestamp();
+  qint64 earliest = 0;
+  for (const auto &command : m_commands)
+  {
+    if (command.enabled && command.deadline > 0
+        && (earliest == 0 || command.deadline < earliest))
+      earliest = command.deadline;
+  }
+
+  if (earliest > now && earliest - now <= SPIN_THRESHOLD)
+  {
+    while (now < earliest)
+    {
+      QThread::yieldCurrentThread();
+      now = FrameQueue::timestamp();
+    }
+  }
+
+  // Process each command
+  for (auto &command : m_commands)
+  {
+    if (!command.enabled || command.deadline == 0)
+      continue;
+
+    // Response did not arrive in time
+    if (command.pending && command.timeout > 0
+        && now - command.sentAt >= command.timeout)
+    {
+      command.pending = false;
+      command.received.clear();
+      ++command.timeouts;
+      m_statsChanged = true;
+      Q_EMIT responseTimeout(command.name);
+    }
+
+    // Deadline not reached yet
+    if (now < command.deadline)
+      continue;
+
+    // Skip the transmissions that were missed by more than one period
+    const auto late = now - command.deadline;
+    if (late >= command.interval)
+    {
+      const auto missed = late / command.interval;
+      command.skipped += quint64(missed);
+      command.deadline += missed * command.interval;
+    }
+
+    // Send the command & schedule the next transmission
+    command.maxLateness = qMax(command.maxLateness, now - command.deadline);
+    command.deadline += command.interval;
+    send(command, now);
+  }
+
+  // Arm the timer for the next deadline
+  schedule();
+}
+
+/**
+ * Resets the schedule of the commands when the device is connected or
+ * disconnected.
+ */
+void IO::CommandScheduler::onConnectedChanged()
+{
+  for (auto &command : m_commands)
+  {
+    command.deadline = 0;
+    command.pending = false;
+    command.received.clear();
+  }
+
+  m_timer.stop();
+  start();
+}
+
+/**
+ * Looks for the expected response of the commands that are waiting for one
+ * in the given @a data, which was received from the device at the given
+ * @a timestamp.
+ */
+void IO::CommandScheduler::onDataReceived(const int stream,
+                                          const QByteArray &data,
+                                          const qint64 timestamp)
+{
+  (void)stream;
+
+  for (auto &command : m_commands)
+  {
+    if (!command.pending)
+      continue;
+
+    // Look for the expected response, it may be split in several chunks
+    bool matched = command.response.isEmpty();
+    if (!matched)
+    {
+      command.received.append(data);
+      matched = command.received.contains(command.response);
+      if (command.received.size() > MAX_RESPONSE_BUFFER)
+        command.received.remove(0, command.received.size()
+                                       - MAX_RESPONSE_BUFFER);
+    }
+
+    // Register the response
+    if (matched)
+    {
+      command.pending = false;
+      command.received.clear();
+      command.lastLatency = qMax<qint64>(0, timestamp - command.sentAt);
+      command.totalLatency += command.lastLatency;
+      ++command.responses;
+      m_statsChanged = true;
+    }
+  }
+}
+
+/**
+ * Loads the configured commands from the application settings
+ */
+void IO::CommandScheduler::readSettings()
+{
+  const auto list = m_settings.value("IO_CommandScheduler_Commands")
+                        .toList();
+  for (const auto &item : list)
+  {
+    const auto map = item.toMap();
+    const bool hex = map.value("hex").toBool();
+
+    Command command;
+    command.name = map.value("name").toString();
+    command.text = map.value("payload").toString();
+    command.hex = hex;
+    command.enabled = map.value("enabled", true).toBool();
+    command.interval = qMax(MIN_INTERVAL, map.value("interval").toInt())
+                       * 1000LL;
+    command.timeout = qMax(0, map.value("timeout").toInt()) * 1000LL;
+    command.responseText = map.value("response").toString();
+    command.payload = encode(command.text, hex);
+    command.response = encode(command.responseText, hex);
+
+    if (!command.payload.isEmpty())
+      m_commands.append(command);
+  }
+}
+
+/**
+ * Saves the configured commands to the application settings
+ */
+void IO::CommandScheduler::writeSettings()
+{
+  m_settings.setValue("IO_CommandScheduler_Commands", commands());
+}
+
+/**
+ * Writes the payload of the given @a command to the device at the given
+ * @a now timestamp. The payload is handed directly to the outgoing queue of
+ * the I/O manager, which writes it immediately unless the write window or
+ * the flow control of the device hold it back.
+ */
+void IO::CommandScheduler::send(Command &command, const qint64 now)
+{
+  // A response is still pending, it will never match this transmission
+  if (command.pending)
+  {
+    ++command.timeouts;
+    Q_EMIT responseTimeout(command.name);
+  }
+
+  // Write the payload
+  if (IO::Manager::instance().writeData(command.payload) < 0)
+  {
+    command.pending = false;
+    ++command.skipped;
+    m_statsChanged = true;
+    return;
+  }
+
+  // Wait for the response
+  ++command.sent;
+  command.sentAt = now;
+  command.pending = command.timeout > 0;
+  command.received.clear();
+  m_statsChanged = true;
+}
+
+/**
+ * Converts the given @a text to the bytes sent to the device. In hexadecimal
+ * mode, whitespace is ignored; otherwise the text is encoded in UTF-8 &
+ * the \\r, \\n & \\t escape sequences are replaced by their characters.
+ */
+QByteArray IO::CommandScheduler::encode(const QString &text, const bool hex)
+{
+  if (hex)
+  {
+    QString digits = text.simplified();
+    digits.remove(' ');
+    return QByteArray::fromHex(digits.toLatin1());
+  }
+
+  QString unescaped = text;
+  unescaped.replace("\\r", "\r");
+  unescaped.replace("\\n", "\n");
+  unescaped.replace("\\t", "\t");
+  return unescaped.toUtf8();
+}
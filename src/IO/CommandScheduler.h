@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QVariantList>
+
+#include <Misc/Settings.h>
+
+namespace IO
+{
+/**
+ * @brief The CommandScheduler class
+ *
+ * Sends user-configured commands to the connected device at fixed rates,
+ * which is needed by polling-style devices that only report data when they
+ * are asked to.
+ *
+ * Commands are scheduled against absolute deadlines obtained from the steady
+ * clock used by the frame queue (see @c FrameQueue::timestamp()), so the
+ * timing error of one transmission never accumulates into the next one. The
+ * timer is armed slightly before the earliest deadline & the last few
+ * hundred microseconds are waited actively, which removes the millisecond
+ * granularity of the event loop timers from the sampling period. If a
+ * deadline is missed by more than a whole period (e.g. the event loop was
+ * blocked), the missed transmissions are skipped & counted instead of being
+ * sent in a burst.
+ *
+ * Commands may optionally expect a response: after a command is sent, the
+ * data received from the device is searched for the expected response (or
+ * any data if no response is configured). The round-trip latency is measured
+ * for each response & a timeout is counted if no response arrives in time.
+ */
+class CommandScheduler : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int count
+               READ count
+               NOTIFY commandsChanged)
+    Q_PROPERTY(QVariantList commands
+               READ commands
+               NOTIFY commandsChanged)
+    Q_PROPERTY(QVariantList statistics
+               READ statistics
+               NOTIFY statisticsChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void commandsChanged();
+  void statisticsChanged();
+  void responseTimeout(const QString &name);
+
+private:
+  explicit CommandScheduler();
+  CommandScheduler(CommandScheduler &&) = delete;
+  CommandScheduler(const CommandScheduler &) = delete;
+  CommandScheduler &operator=(CommandScheduler &&) = delete;
+  CommandScheduler &operator=(const CommandScheduler &) = delete;
+
+public:
+  static CommandScheduler &instance();
+
+  int count() const;
+  int pendingResponses() const;
+  quint64 timeouts() const;
+  QVariantList commands() const;
+  QVariantList statistics() const;
+
+  Q_INVOKABLE int addCommand(const QString &name, const QString &payload,
+                             const bool hex, const int interval,
+                             const int timeout = 0,
+                             const QString &response = QString());
+
+public Q_SLOTS:
+  void clearStatistics();
+  void removeCommand(const int index);
+  void setCommandEnabled(const int index, const bool enabled);
+  void setCommandInterval(const int index, const int interval);
+
+private Q_SLOTS:
+  void start();
+  void schedule();
+  void processCommands();
+  void onConnectedChanged();
+  void onDataReceived(const int stream, const QByteArray &data,
+                      const qint64 timestamp);
+
+private:
+  struct Command
+  {
+    QString name;
+    QString text;
+    bool hex = false;
+    bool enabled = true;
+    qint64 interval = 0;
+    qint64 timeout = 0;
+    QString responseText;
+
+    QByteArray payload;
+    QByteArray response;
+
+    qint64 deadline = 0;
+    qint64 sentAt = 0;
+    bool pending = false;
+    QByteArray received;
+
+    quint64 sent = 0;
+    quint64 responses = 0;
+    quint64 timeouts = 0;
+    quint64 skipped = 0;
+    qint64 lastLatency = 0;
+    qint64 totalLatency = 0;
+    qint64 maxLateness = 0;
+  };
+
+  void readSettings();
+  void writeSettings();
+  void send(Command &command, const qint64 now);
+  static QByteArray encode(const QString &text, const bool hex);
+
+private:
+  bool m_statsChanged;
+  QTimer m_timer;
+  Misc::Settings m_settings;
+  QVector<Command> m_commands;
+};
+} // namespace IO
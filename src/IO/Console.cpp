@@ -20,6 +20,8 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
+
 #include <QFile>
 #include <QPrinter>
 #include <QDateTime>
@@ -27,51 +29,86 @@
 #include <QPrintDialog>
 #include <QTextDocument>
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#  include <QStringDecoder>
+#else
+#  include <QTextCodec>
+#endif
+
 #include <IO/Manager.h>
 #include <IO/Console.h>
+#include <IO/FileTransfer.h>
 #include <Misc/Utilities.h>
 #include <Misc/TimerEvents.h>
 
 /**
- * Generates a hexdump of the given data
+ * Layout of a line of the hexdump: two columns of eight bytes ("XX " each,
+ * separated by an extra space), followed by the ASCII representation of the
+ * bytes, e.g.:
+ *
+ * 48 65 6C 6C 6F 2C 20 77  6F 72 6C 64 21 0D 0A 00  |  Hello, world!... \n
  */
-static QString HexDump(const char *data, const size_t size)
+static const int HEXDUMP_BYTES_PER_LINE = 16;
+static const int HEXDUMP_HEX_COLUMNS = 50;
+static const int HEXDUMP_LINE_OVERHEAD = HEXDUMP_HEX_COLUMNS + 5;
+
+/**
+ * Returns the number of characters required to generate the hexdump of
+ * @a size bytes.
+ */
+static int HexDumpLength(const int size)
 {
-  char str[4096] = "";
-  char ascii[17];
+  const int lines = size / HEXDUMP_BYTES_PER_LINE;
+  const int remainder = size % HEXDUMP_BYTES_PER_LINE;
 
-  size_t i, j;
-  ascii[16] = '\0';
-  for (i = 0; i < size; ++i)
-  {
-    sprintf(str + strlen(str), "%02X ", static_cast<quint8>(data[i]));
+  int length = lines * (HEXDUMP_LINE_OVERHEAD + HEXDUMP_BYTES_PER_LINE);
+  if (remainder > 0)
+    length += HEXDUMP_LINE_OVERHEAD + remainder;
 
-    if (data[i] >= ' ' && data[i] <= '~')
-      ascii[i % 16] = data[i];
-    else
-      ascii[i % 16] = '.';
+  return length;
+}
 
-    if ((i + 1) % 8 == 0 || i + 1 == size)
-    {
-      sprintf(str + strlen(str), " ");
-      if ((i + 1) % 16 == 0)
-        sprintf(str + strlen(str), "|  %s \n", ascii);
+/**
+ * Writes the hexdump of the given data to @a out, which must have room for
+ * at least @c HexDumpLength(size) characters.
+ *
+ * Hex digits are obtained from a lookup table and written directly at their
+ * final column, so no intermediate strings are created.
+ */
+static void HexDump(const char *data, const int size, QChar *out)
+{
+  static const char digits[] = "0123456789ABCDEF";
 
-      else if (i + 1 == size)
-      {
-        ascii[(i + 1) % 16] = '\0';
+  for (int offset = 0; offset < size; offset += HEXDUMP_BYTES_PER_LINE)
+  {
+    // Get bytes of the current line
+    const int count = qMin(HEXDUMP_BYTES_PER_LINE, size - offset);
+    const auto line = reinterpret_cast<const quint8 *>(data + offset);
 
-        if ((i + 1) % 16 <= 8)
-          sprintf(str + strlen(str), " ");
-        for (j = (i + 1) % 16; j < 16; ++j)
-          sprintf(str + strlen(str), "   ");
+    // Write the hex columns, padded with spaces for incomplete lines
+    std::fill(out, out + HEXDUMP_HEX_COLUMNS, QLatin1Char(' '));
+    for (int i = 0; i < count; ++i)
+    {
+      QChar *cell = out + i * 3 + (i >= 8 ? 1 : 0);
+      cell[0] = QLatin1Char(digits[line[i] >> 4]);
+      cell[1] = QLatin1Char(digits[line[i] & 0x0F]);
+    }
 
-        sprintf(str + strlen(str), "|  %s \n", ascii);
-      }
+    // Write the ASCII representation of the line
+    out += HEXDUMP_HEX_COLUMNS;
+    *out++ = QLatin1Char('|');
+    *out++ = QLatin1Char(' ');
+    *out++ = QLatin1Char(' ');
+    for (int i = 0; i < count; ++i)
+    {
+      const auto c = line[i];
+      *out++ = QLatin1Char((c >= ' ' && c <= '~') ? static_cast<char>(c) : '.');
     }
-  }
 
-  return QString(str);
+    // End the line
+    *out++ = QLatin1Char(' ');
+    *out++ = QLatin1Char('\n');
+  }
 }
 
 /**
@@ -83,11 +120,20 @@ IO::Console::Console()
   , m_displayMode(DisplayMode::DisplayPlainText)
   , m_historyItem(0)
   , m_echo(false)
+  , m_enabled(true)
   , m_autoscroll(true)
   , m_showTimestamp(false)
   , m_isStartingLine(true)
+  , m_timestampTime(-1)
 {
-  // Clear buffer & reserve memory
+  // Read history limits
+  const auto lines = m_settings.value("Console_MaxLines", 100000).toInt();
+  const qint64 size = m_settings.value("Console_MaxSize", 8).toInt();
+  m_textBuffer.setMaxLines(qBound(100, lines, 10000000));
+  m_textBuffer.setMaxSize(qBound<qint64>(1, size, 1024) * 1024 * 1024);
+  m_enabled = m_settings.value("Console_Enabled", true).toBool();
+
+  // Clear buffer
   clear();
 
   // Read received data automatically
@@ -114,6 +160,15 @@ bool IO::Console::echo() const
   return m_echo;
 }
 
+/**
+ * Returns @c true if the console stores the data exchanged with the device &
+ * the user interface shall display the console pane.
+ */
+bool IO::Console::enabled() const
+{
+  return m_enabled;
+}
+
 /**
  * Returns @c true if the vertical position of the console display shall be
  * automatically moved to show latest data.
@@ -128,7 +183,41 @@ bool IO::Console::autoscroll() const
  */
 bool IO::Console::saveAvailable() const
 {
-  return m_textBuffer.length() > 0;
+  return !m_textBuffer.isEmpty();
+}
+
+/**
+ * Returns the maximum number of lines kept in the console history
+ */
+int IO::Console::maxLines() const
+{
+  return m_textBuffer.maxLines();
+}
+
+/**
+ * Returns the maximum size of the console history in megabytes (millions of
+ * characters)
+ */
+int IO::Console::maxSize() const
+{
+  return static_cast<int>(m_textBuffer.maxSize() / (1024 * 1024));
+}
+
+/**
+ * Returns a copy of the console history
+ */
+QString IO::Console::text() const
+{
+  return m_textBuffer.text();
+}
+
+/**
+ * Returns the line store that holds the console history, views can use it to
+ * read only the lines that they need to display.
+ */
+const IO::LineStore &IO::Console::lineStore() const
+{
+  return m_textBuffer;
 }
 
 /**
@@ -281,7 +370,7 @@ void IO::Console::save()
     QFile file(path);
     if (file.open(QFile::WriteOnly))
     {
-      file.write(m_textBuffer.toUtf8());
+      m_textBuffer.write(&file);
       file.close();
       Misc::Utilities::revealFile(path);
     }
@@ -298,7 +387,6 @@ void IO::Console::save()
 void IO::Console::clear()
 {
   m_textBuffer.clear();
-  m_textBuffer.reserve(10 * 1000);
   m_isStartingLine = true;
   Q_EMIT dataReceived();
 }
@@ -389,6 +477,23 @@ void IO::Console::setEcho(const bool enabled)
   Q_EMIT echoChanged();
 }
 
+/**
+ * Enables or disables the console, the history is cleared when the console
+ * is disabled so that its memory is released.
+ */
+void IO::Console::setEnabled(const bool enabled)
+{
+  if (m_enabled != enabled)
+  {
+    m_enabled = enabled;
+    m_settings.setValue("Console_Enabled", enabled);
+    if (!enabled)
+      clear();
+
+    Q_EMIT enabledChanged();
+  }
+}
+
 /**
  * Creates a text document with current console output & prints it using native
  * system libraries/toolkits.
@@ -405,7 +510,7 @@ void IO::Console::print(const QString &fontFamily)
   // Create text document
   QTextDocument document;
   document.setDefaultFont(font);
-  document.setPlainText(m_textBuffer);
+  document.setPlainText(m_textBuffer.text());
 
   // Create printer object
   QPrinter printer(QPrinter::PrinterResolution);
@@ -433,6 +538,38 @@ void IO::Console::setShowTimestamp(const bool enabled)
   }
 }
 
+/**
+ * Changes the maximum number of @a lines kept in the console history, the
+ * oldest text is discarded if the history holds more lines.
+ */
+void IO::Console::setMaxLines(const int lines)
+{
+  const auto value = qBound(100, lines, 10000000);
+  if (maxLines() != value)
+  {
+    m_textBuffer.setMaxLines(value);
+    m_settings.setValue("Console_MaxLines", value);
+    Q_EMIT limitsChanged();
+    Q_EMIT dataReceived();
+  }
+}
+
+/**
+ * Changes the maximum size of the console history in @a megabytes, the
+ * oldest text is discarded if the history is larger.
+ */
+void IO::Console::setMaxSize(const int megabytes)
+{
+  const auto value = qBound(1, megabytes, 1024);
+  if (maxSize() != value)
+  {
+    m_textBuffer.setMaxSize(static_cast<qint64>(value) * 1024 * 1024);
+    m_settings.setValue("Console_MaxSize", value);
+    Q_EMIT limitsChanged();
+    Q_EMIT dataReceived();
+  }
+}
+
 /**
  * Enables/disables autoscrolling of the console text.
  */
@@ -478,60 +615,57 @@ void IO::Console::setDisplayMode(const IO::Console::DisplayMode &mode)
 /**
  * Inserts the given @a string into the list of lines of the console, if @a
  * addTimestamp is set to @c true, an timestamp is added for each line.
+ *
+ * The optional @a time parameter is the monotonic reception time of the data
+ * (see @c IO::FrameQueue::timestamp()), if not set the current time is used.
  */
-void IO::Console::append(const QString &string, const bool addTimestamp)
+void IO::Console::append(const QString &string, const bool addTimestamp,
+                         const qint64 time)
 {
   // Abort on empty strings
   if (string.isEmpty())
     return;
 
-  // Only use \n as line separator
-  auto data = string;
-  data = data.replace("\r\n", "\n");
-  data = data.replace("\r", "\n");
-
-  // Get timestamp
-  QString timestamp;
-  if (addTimestamp)
-  {
-    QDateTime dateTime = QDateTime::currentDateTime();
-    timestamp = dateTime.toString("HH:mm:ss.zzz -> ");
-  }
+  // Get timestamp prefix
+  static const QString noTimestamp;
+  const auto &timestamp = addTimestamp ? timestampPrefix(time) : noTimestamp;
 
-  // Initialize final string
+  // Initialize final string, reserve space for a few timestamps
   QString processedString;
-  processedString.reserve(data.length() + timestamp.length());
+  processedString.reserve(string.length() + timestamp.length() * 4);
 
-  // Create list with lines (keep separators)
-  StringList tokens;
-  QString currentToken;
-  for (int i = 0; i < data.length(); ++i)
+  // Scan the string once, treating \r\n and \r as a single \n
+  int start = 0;
+  const int length = string.length();
+  const QChar *data = string.constData();
+  for (int i = 0; i < length; ++i)
   {
-    if (data.at(i) == '\n')
-    {
-      tokens.append(currentToken);
-      tokens.append("\n");
-      currentToken.clear();
-    }
+    // Not a line separator, keep scanning
+    const auto c = data[i].unicode();
+    if (c != '\n' && c != '\r')
+      continue;
 
-    else
-      currentToken += data.at(i);
-  }
+    // Add line (with its timestamp) and the separator
+    if (m_isStartingLine)
+      processedString.append(timestamp);
+    processedString.append(data + start, i - start);
+    processedString.append(QLatin1Char('\n'));
+    m_isStartingLine = true;
 
-  // Add last item to list
-  if (!currentToken.isEmpty())
-    tokens.append(currentToken);
+    // Skip \n in \r\n sequences
+    if (c == '\r' && i + 1 < length && data[i + 1] == QLatin1Char('\n'))
+      ++i;
 
-  // Process lines
-  while (!tokens.isEmpty())
+    start = i + 1;
+  }
+
+  // Add incomplete line at the end of the string
+  if (start < length)
   {
     if (m_isStartingLine)
       processedString.append(timestamp);
-
-    auto token = tokens.first();
-    processedString.append(token);
-    m_isStartingLine = (token == "\n");
-    tokens.removeFirst();
+    processedString.append(data + start, length - start);
+    m_isStartingLine = false;
   }
 
   // Add data to saved text buffer
@@ -542,23 +676,50 @@ void IO::Console::append(const QString &string, const bool addTimestamp)
   Q_EMIT stringReceived(processedString);
 }
 
+/**
+ * Returns the timestamp that is added before each line of the console for
+ * data received at the given monotonic @a timestamp. The string is only
+ * formatted again when the millisecond changes, which avoids calling
+ * @c QDateTime::toString() for each received packet.
+ */
+const QString &IO::Console::timestampPrefix(const qint64 timestamp)
+{
+  const auto ms = FrameQueue::toMSecsSinceEpoch(timestamp);
+  if (ms != m_timestampTime || m_timestamp.isEmpty())
+  {
+    m_timestampTime = ms;
+    auto dateTime = QDateTime::fromMSecsSinceEpoch(ms);
+    m_timestamp = dateTime.toString("HH:mm:ss.zzz -> ");
+  }
+
+  return m_timestamp;
+}
+
 /**
  * Displays the given @a data in the console. @c QByteArray to ~@c QString
  * conversion is done by the @c dataToString() function, which displays incoming
  * data either in UTF-8 or in hexadecimal mode.
+ *
+ * Data written by file transfers is not echoed, since it would flood the
+ * console with the contents of the uploaded file.
  */
 void IO::Console::onDataSent(const QByteArray &data)
 {
-  if (echo())
+  if (IO::FileTransfer::instance().active())
+    return;
+
+  if (enabled() && echo())
     append(dataToString(data) + "\n", showTimestamp());
 }
 
 /**
  * Displays the given @a data in the console
  */
-void IO::Console::onDataReceived(const QByteArray &data)
+void IO::Console::onDataReceived(const QByteArray &data,
+                                 const qint64 timestamp)
 {
-  append(dataToString(data), showTimestamp());
+  if (enabled())
+    append(dataToString(data), showTimestamp(), timestamp);
 }
 
 /**
@@ -621,9 +782,20 @@ QString IO::Console::dataToString(const QByteArray &data)
  */
 QString IO::Console::plainTextStr(const QByteArray &data)
 {
-  QString str = QString::fromUtf8(data);
-
-  if (str.toUtf8() != data)
+  // Decode the data once, invalid sequences are reported by the decoder
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  QStringDecoder decoder(QStringDecoder::Utf8);
+  QString str = decoder.decode(data);
+  const bool invalid = decoder.hasError();
+#else
+  QTextCodec::ConverterState state;
+  auto codec = QTextCodec::codecForName("UTF-8");
+  QString str = codec->toUnicode(data.constData(), data.size(), &state);
+  const bool invalid = state.invalidChars > 0;
+#endif
+
+  // Data is not valid UTF-8, fall back to Latin-1
+  if (invalid)
     str = QString::fromLatin1(data);
 
   return str;
@@ -634,22 +806,7 @@ QString IO::Console::plainTextStr(const QByteArray &data)
  */
 QString IO::Console::hexadecimalStr(const QByteArray &data)
 {
-  // Remove line breaks from data
-  QByteArray copy = data;
-
-  // Convert data to string with dump every ~80 chars
-  QString str;
-  const int characters = 80;
-  for (int i = 0; i < copy.length(); ++i)
-  {
-    QByteArray line;
-    for (int j = 0; j < qMin(characters, copy.length() - i); ++j)
-      line.append(copy.at(i + j));
-
-    i += characters;
-    str.append(HexDump(line.data(), line.size()));
-  }
-
-  // Return string
+  QString str(HexDumpLength(data.size()), Qt::Uninitialized);
+  HexDump(data.constData(), data.size(), str.data());
   return str;
 }
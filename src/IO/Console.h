@@ -24,6 +24,8 @@
 
 #include <QObject>
 #include <DataTypes.h>
+#include <IO/LineStore.h>
+#include <Misc/Settings.h>
 
 namespace IO
 {
@@ -36,11 +38,23 @@ namespace IO
  * The class also controls various UI-related factors, such as the display
  * format of the data (e.g. ASCII or HEX), history of sent commands and
  * exporting of the RX data.
+ *
+ * The console history is kept in a bounded @c LineStore, the oldest text is
+ * discarded once the history holds more than @c maxLines() lines or more
+ * than @c maxSize() megabytes of text.
+ *
+ * The console can be disabled entirely (e.g. for dashboard-only setups), in
+ * which case received & sent data is no longer stored and the user interface
+ * does not create the console pane.
  */
 class Console : public QObject
 {
   // clang-format off
     Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
     Q_PROPERTY(bool echo
                READ echo
                WRITE setEcho
@@ -68,6 +82,14 @@ class Console : public QObject
                READ displayMode
                WRITE setDisplayMode
                NOTIFY displayModeChanged)
+    Q_PROPERTY(int maxLines
+               READ maxLines
+               WRITE setMaxLines
+               NOTIFY limitsChanged)
+    Q_PROPERTY(int maxSize
+               READ maxSize
+               WRITE setMaxSize
+               NOTIFY limitsChanged)
     Q_PROPERTY(QString currentHistoryString
                READ currentHistoryString
                NOTIFY historyItemChanged)
@@ -75,6 +97,8 @@ class Console : public QObject
 
 Q_SIGNALS:
   void echoChanged();
+  void enabledChanged();
+  void limitsChanged();
   void dataReceived();
   void dataModeChanged();
   void autoscrollChanged();
@@ -119,10 +143,16 @@ public:
   static Console &instance();
 
   bool echo() const;
+  bool enabled() const;
   bool autoscroll() const;
   bool saveAvailable() const;
   bool showTimestamp() const;
 
+  int maxLines() const;
+  int maxSize() const;
+  QString text() const;
+  const LineStore &lineStore() const;
+
   DataMode dataMode() const;
   LineEnding lineEnding() const;
   DisplayMode displayMode() const;
@@ -140,24 +170,29 @@ public Q_SLOTS:
   void historyDown();
   void send(const QString &data);
   void setEcho(const bool enabled);
+  void setEnabled(const bool enabled);
   void print(const QString &fontFamily);
   void setAutoscroll(const bool enabled);
   void setShowTimestamp(const bool enabled);
+  void setMaxLines(const int lines);
+  void setMaxSize(const int megabytes);
   void setDataMode(const IO::Console::DataMode &mode);
   void setLineEnding(const IO::Console::LineEnding &mode);
   void setDisplayMode(const IO::Console::DisplayMode &mode);
-  void append(const QString &str, const bool addTimestamp = false);
+  void append(const QString &str, const bool addTimestamp = false,
+              const qint64 timestamp = 0);
 
 private Q_SLOTS:
   void onDataSent(const QByteArray &data);
   void addToHistory(const QString &command);
-  void onDataReceived(const QByteArray &data);
+  void onDataReceived(const QByteArray &data, const qint64 timestamp);
 
 private:
   QByteArray hexToBytes(const QString &data);
   QString dataToString(const QByteArray &data);
   QString plainTextStr(const QByteArray &data);
   QString hexadecimalStr(const QByteArray &data);
+  const QString &timestampPrefix(const qint64 timestamp);
 
 private:
   DataMode m_dataMode;
@@ -167,14 +202,18 @@ private:
   int m_historyItem;
 
   bool m_echo;
+  bool m_enabled;
   bool m_autoscroll;
   bool m_showTimestamp;
   bool m_isStartingLine;
 
-  StringList m_lines;
+  qint64 m_timestampTime;
+  QString m_timestamp;
+
   StringList m_historyItems;
 
   QString m_printFont;
-  QString m_textBuffer;
+  Misc::Settings m_settings;
+  LineStore m_textBuffer;
 };
 } // namespace IO
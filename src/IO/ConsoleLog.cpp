@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QDir>
+#include <QUrl>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QApplication>
+#include <QDesktopServices>
+
+#include <IO/Manager.h>
+#include <IO/ConsoleLog.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Size of the memory buffer in which formatted data is accumulated before it
+ * is written to the log file.
+ */
+static const int BUFFER_SIZE = 256 * 1024;
+
+/**
+ * Interval (in milliseconds) at which buffered data is written to the file
+ */
+static const int FLUSH_INTERVAL = 1000;
+
+/**
+ * Maximum amount of data (in bytes) that can be waiting to be written by the
+ * worker thread, new data is discarded if this limit is reached.
+ */
+static const qint64 MAX_QUEUED_BYTES = 32 * 1024 * 1024;
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, allocates the write buffer & the flush timer
+ */
+IO::ConsoleLogWorker::ConsoleLogWorker()
+  : m_format(ConsoleLog::PlainText)
+  , m_fileCount(10)
+  , m_failed(false)
+  , m_timestamps(true)
+  , m_startingLine(true)
+  , m_fileSize(16 * 1024 * 1024)
+  , m_written(0)
+  , m_timestampTime(-1)
+  , m_flushTimer(new QTimer(this))
+{
+  m_buffer.reserve(BUFFER_SIZE);
+  m_flushTimer->setInterval(FLUSH_INTERVAL);
+  connect(m_flushTimer, &QTimer::timeout, this, &ConsoleLogWorker::flush);
+}
+
+/**
+ * Destructor function, writes pending data & closes the log file
+ */
+IO::ConsoleLogWorker::~ConsoleLogWorker()
+{
+  close();
+}
+
+/**
+ * Writes all the pending data & closes the log file, the next received data
+ * is written to a new file.
+ */
+void IO::ConsoleLogWorker::close()
+{
+  flush();
+
+  m_failed = false;
+  m_startingLine = true;
+
+  if (m_file.isOpen())
+  {
+    m_file.close();
+    Q_EMIT fileChanged(QString());
+  }
+}
+
+/**
+ * Writes the contents of the buffer to the log file
+ */
+void IO::ConsoleLogWorker::flush()
+{
+  if (m_file.isOpen() && !m_buffer.isEmpty())
+  {
+    m_file.write(m_buffer);
+    m_file.flush();
+  }
+
+  m_buffer.resize(0);
+}
+
+/**
+ * Formats & writes the given @a data, which was received at the given
+ * @a timestamp (in milliseconds since epoch). A new file is created when the
+ * current one reaches the configured size.
+ */
+void IO::ConsoleLogWorker::write(const QByteArray &data, const qint64 timestamp)
+{
+  // Nothing to write or open error
+  if (data.isEmpty() || m_failed)
+    return;
+
+  // Create a new file if required
+  if (!m_file.isOpen() && !openFile())
+    return;
+
+  // Get timestamp prefix
+  static const QByteArray noTimestamp;
+  const auto &prefix = m_timestamps ? timestampPrefix(timestamp) : noTimestamp;
+
+  // Format data
+  const auto size = m_buffer.size();
+  if (m_format == ConsoleLog::Hexadecimal)
+    writeHex(data, prefix);
+  else
+    writeText(data, prefix);
+
+  // Rotate the file when it is full, or write the buffer when it is full
+  m_written += m_buffer.size() - size;
+  if (m_written >= m_fileSize)
+  {
+    flush();
+    m_file.close();
+  }
+  else if (m_buffer.size() >= BUFFER_SIZE)
+    flush();
+}
+
+/**
+ * Changes the log @a directory, the data @a format, the maximum size of each
+ * file (in bytes) and the maximum number of files kept in the directory. The
+ * current file is closed if the directory or the format change.
+ */
+void IO::ConsoleLogWorker::configure(const QString &directory,
+                                     const int format, const bool timestamps,
+                                     const qint64 fileSize,
+                                     const int fileCount)
+{
+  // Start a new file if the output changes
+  if (directory != m_directory || format != m_format)
+    close();
+
+  // Update parameters
+  m_format = format;
+  m_fileSize = fileSize;
+  m_fileCount = fileCount;
+  m_directory = directory;
+  m_timestamps = timestamps;
+
+  // Start the flush timer (must be done from the worker thread)
+  if (!m_flushTimer->isActive())
+    m_flushTimer->start();
+}
+
+/**
+ * Creates a new log file in the log directory, the file name is obtained from
+ * the current date/time so that files are sorted chronologically.
+ */
+bool IO::ConsoleLogWorker::openFile()
+{
+  // Get file path
+  QDir dir(m_directory);
+  const auto time = QDateTime::currentDateTime();
+  const auto name = time.toString("yyyy-MM-dd_HH-mm-ss-zzz") + ".log";
+  const auto path = dir.absoluteFilePath(name);
+
+  // Create the file
+  m_file.setFileName(path);
+  if (!dir.mkpath(".") || !m_file.open(QIODevice::WriteOnly))
+  {
+    m_failed = true;
+    Q_EMIT openFailed(path);
+    return false;
+  }
+
+  // Delete old files & update UI
+  m_written = 0;
+  removeOldFiles();
+  Q_EMIT fileChanged(path);
+  return true;
+}
+
+/**
+ * Deletes the oldest log files until the log directory does not hold more
+ * than the configured number of files.
+ */
+void IO::ConsoleLogWorker::removeOldFiles()
+{
+  QDir dir(m_directory);
+  auto files = dir.entryInfoList({"*.log"}, QDir::Files, QDir::Name);
+  while (files.count() > m_fileCount)
+    QFile::remove(files.takeFirst().absoluteFilePath());
+}
+
+/**
+ * Appends the given @a data to the buffer as-is, adding the given
+ * @a timestamp at the beginning of each line.
+ */
+void IO::ConsoleLogWorker::writeText(const QByteArray &data,
+                                     const QByteArray &timestamp)
+{
+  // No timestamps, copy data directly
+  if (timestamp.isEmpty())
+  {
+    m_buffer.append(data);
+    m_startingLine = data.endsWith('\n');
+    return;
+  }
+
+  // Copy data line by line
+  const char *ptr = data.constData();
+  const char *end = ptr + data.size();
+  while (ptr < end)
+  {
+    if (m_startingLine)
+      m_buffer.append(timestamp);
+
+    auto lf = static_cast<const char *>(memchr(ptr, '\n', end - ptr));
+    const char *next = lf ? lf + 1 : end;
+    m_buffer.append(ptr, static_cast<int>(next - ptr));
+    m_startingLine = (lf != Q_NULLPTR);
+    ptr = next;
+  }
+}
+
+/**
+ * Appends the given @a data to the buffer as hexadecimal bytes, 16 bytes per
+ * line, adding the given @a timestamp at the beginning of each line.
+ */
+void IO::ConsoleLogWorker::writeHex(const QByteArray &data,
+                                    const QByteArray &timestamp)
+{
+  static const char digits[] = "0123456789ABCDEF";
+
+  const int size = data.size();
+  const auto bytes = reinterpret_cast<const quint8 *>(data.constData());
+  for (int offset = 0; offset < size; offset += 16)
+  {
+    m_buffer.append(timestamp);
+
+    const int count = qMin(16, size - offset);
+    for (int i = 0; i < count; ++i)
+    {
+      const auto byte = bytes[offset + i];
+      m_buffer.append(digits[byte >> 4]);
+      m_buffer.append(digits[byte & 0x0F]);
+      m_buffer.append(i < count - 1 ? ' ' : '\n');
+    }
+  }
+}
+
+/**
+ * Returns the timestamp added to each line for data received at the given
+ * @a timestamp, the string is only formatted when the millisecond changes.
+ */
+const QByteArray &IO::ConsoleLogWorker::timestampPrefix(const qint64 timestamp)
+{
+  if (timestamp != m_timestampTime)
+  {
+    m_timestampTime = timestamp;
+    const auto time = QDateTime::fromMSecsSinceEpoch(timestamp);
+    m_timestamp = time.toString("yyyy/MM/dd HH:mm:ss.zzz -> ").toUtf8();
+  }
+
+  return m_timestamp;
+}
+
+//----------------------------------------------------------------------------------------
+// Console log implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, reads the log settings & starts the writer thread
+ */
+IO::ConsoleLog::ConsoleLog()
+  : m_enabled(false)
+  , m_format(PlainText)
+  , m_timestamps(true)
+  , m_fileSize(16)
+  , m_fileCount(10)
+  , m_queuedBytes(0)
+  , m_worker(new ConsoleLogWorker())
+{
+  // Read settings
+  const auto format = m_settings.value("ConsoleLog_Format", 0).toInt();
+  if (format == PlainText || format == Hexadecimal)
+    m_format = format;
+
+  m_enabled = m_settings.value("ConsoleLog_Enabled", false).toBool();
+  m_timestamps = m_settings.value("ConsoleLog_Timestamps", true).toBool();
+  m_fileSize = m_settings.value("ConsoleLog_FileSize", 16).toInt();
+  m_fileCount = m_settings.value("ConsoleLog_FileCount", 10).toInt();
+  m_fileSize = qBound(1, m_fileSize, 1024);
+  m_fileCount = qBound(1, m_fileCount, 1000);
+
+  // Start worker thread
+  m_thread.setObjectName(QStringLiteral("IO::ConsoleLogWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(m_worker, &ConsoleLogWorker::openFailed, this,
+          &ConsoleLog::onOpenFailed);
+  connect(m_worker, &ConsoleLogWorker::fileChanged, this,
+          &ConsoleLog::onFileChanged);
+  m_thread.start();
+  configureWorker();
+
+  // Log the received data, start a new file for each connection
+  auto io = &IO::Manager::instance();
+  connect(io, &IO::Manager::dataReceived, this, &ConsoleLog::onDataReceived);
+  connect(io, &IO::Manager::connectedChanged, this, &ConsoleLog::closeFile);
+}
+
+/**
+ * Writes the pending data & stops the writer thread
+ */
+IO::ConsoleLog::~ConsoleLog()
+{
+  closeFile();
+
+  // Wait until the worker has written all the pending data
+  QMetaObject::invokeMethod(
+      m_worker, [] {}, Qt::BlockingQueuedConnection);
+
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::ConsoleLog &IO::ConsoleLog::instance()
+{
+  static ConsoleLog singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if received data is written to the log files
+ */
+bool IO::ConsoleLog::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the format used to write the received data, the list of formats is
+ * obtained with @c availableFormats().
+ */
+int IO::ConsoleLog::format() const
+{
+  return m_format;
+}
+
+/**
+ * Returns @c true if a timestamp is added at the beginning of each line
+ */
+bool IO::ConsoleLog::timestamps() const
+{
+  return m_timestamps;
+}
+
+/**
+ * Returns the size (in MB) after which a new log file is created
+ */
+int IO::ConsoleLog::fileSize() const
+{
+  return m_fileSize;
+}
+
+/**
+ * Returns the maximum number of log files kept in the log directory
+ */
+int IO::ConsoleLog::fileCount() const
+{
+  return m_fileCount;
+}
+
+/**
+ * Returns the directory in which the log files are created
+ */
+QString IO::ConsoleLog::directory() const
+{
+  return QString("%1/Documents/%2/Console Logs")
+      .arg(QDir::homePath(), qApp->applicationName());
+}
+
+/**
+ * Returns the path of the file that is currently being written, or an empty
+ * string if no file is open.
+ */
+QString IO::ConsoleLog::currentFile() const
+{
+  return m_currentFile;
+}
+
+/**
+ * Returns the list of formats that can be used to log the received data
+ */
+QStringList IO::ConsoleLog::availableFormats() const
+{
+  return QStringList {tr("Plain text"), tr("Hexadecimal")};
+}
+
+/**
+ * Writes the pending data & closes the current log file, the file is closed
+ * by the worker thread once it has written all the pending data.
+ */
+void IO::ConsoleLog::closeFile()
+{
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->close(); });
+}
+
+/**
+ * Opens the log directory in the Explorer/Finder window
+ */
+void IO::ConsoleLog::openDirectory()
+{
+  QDir().mkpath(directory());
+  QDesktopServices::openUrl(QUrl::fromLocalFile(directory()));
+}
+
+/**
+ * Changes the format used to write the received data, the current file is
+ * closed so that the next data is written to a new file.
+ */
+void IO::ConsoleLog::setFormat(const int format)
+{
+  if (format != m_format && (format == PlainText || format == Hexadecimal))
+  {
+    m_format = format;
+    m_settings.setValue("ConsoleLog_Format", format);
+    configureWorker();
+
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Enables or disables logging of the received data
+ */
+void IO::ConsoleLog::setEnabled(const bool enabled)
+{
+  if (m_enabled != enabled)
+  {
+    m_enabled = enabled;
+    m_settings.setValue("ConsoleLog_Enabled", enabled);
+    if (!enabled)
+      closeFile();
+
+    Q_EMIT enabledChanged();
+  }
+}
+
+/**
+ * Changes the size (in MB) after which a new log file is created
+ */
+void IO::ConsoleLog::setFileSize(const int megabytes)
+{
+  const auto size = qBound(1, megabytes, 1024);
+  if (m_fileSize != size)
+  {
+    m_fileSize = size;
+    m_settings.setValue("ConsoleLog_FileSize", size);
+    configureWorker();
+
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the maximum number of log files kept in the log directory, the
+ * oldest files are deleted when a new file is created.
+ */
+void IO::ConsoleLog::setFileCount(const int count)
+{
+  const auto files = qBound(1, count, 1000);
+  if (m_fileCount != files)
+  {
+    m_fileCount = files;
+    m_settings.setValue("ConsoleLog_FileCount", files);
+    configureWorker();
+
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Enables or disables adding a timestamp at the beginning of each line
+ */
+void IO::ConsoleLog::setTimestamps(const bool enabled)
+{
+  if (m_timestamps != enabled)
+  {
+    m_timestamps = enabled;
+    m_settings.setValue("ConsoleLog_Timestamps", enabled);
+    configureWorker();
+
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Sends the current configuration to the worker thread
+ */
+void IO::ConsoleLog::configureWorker()
+{
+  auto worker = m_worker;
+  auto format = m_format;
+  auto fileCount = m_fileCount;
+  auto directory = this->directory();
+  auto timestamps = m_timestamps;
+  auto fileSize = static_cast<qint64>(m_fileSize) * 1024 * 1024;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->configure(directory, format, timestamps, fileSize, fileCount);
+  });
+}
+
+/**
+ * Disables logging & notifies the user if a log file cannot be created
+ */
+void IO::ConsoleLog::onOpenFailed(const QString &path)
+{
+  setEnabled(false);
+  Misc::Utilities::showMessageBox(tr("Cannot create console log file"),
+                                  tr("Check the permissions of \"%1\"")
+                                      .arg(QFileInfo(path).absolutePath()));
+}
+
+/**
+ * Updates the path of the log file that is currently being written
+ */
+void IO::ConsoleLog::onFileChanged(const QString &path)
+{
+  m_currentFile = path;
+  Q_EMIT currentFileChanged();
+}
+
+/**
+ * Hands the received @a data over to the worker thread, together with the
+ * time at which it was received. Data is discarded if the worker cannot keep
+ * up with the incoming data.
+ */
+void IO::ConsoleLog::onDataReceived(const QByteArray &data,
+                                    const qint64 timestamp)
+{
+  // Logging disabled
+  if (!m_enabled || data.isEmpty())
+    return;
+
+  // Storage device cannot keep up with the incoming data
+  if (m_queuedBytes + data.size() > MAX_QUEUED_BYTES)
+    return;
+
+  // Write data from the worker thread
+  auto worker = m_worker;
+  auto queued = &m_queuedBytes;
+  const auto time = FrameQueue::toMSecsSinceEpoch(timestamp);
+  *queued += data.size();
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->write(data, time);
+    *queued -= data.size();
+  });
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QFile>
+#include <QTimer>
+#include <QThread>
+#include <QObject>
+
+#include <Misc/Settings.h>
+
+namespace IO
+{
+/**
+ * @brief The ConsoleLogWorker class
+ *
+ * Worker object of the @c ConsoleLog class, runs in its own thread and
+ * formats & writes the received data to the log files.
+ *
+ * Formatted data is accumulated in a memory buffer that is written to the
+ * current file once per second or when it is full. When the current file
+ * reaches the configured size, a new file is created and the oldest files
+ * are deleted, so that the log directory never holds more than the configured
+ * number of files.
+ */
+class ConsoleLogWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void openFailed(const QString &path);
+  void fileChanged(const QString &path);
+
+public:
+  ConsoleLogWorker();
+  ~ConsoleLogWorker();
+
+public Q_SLOTS:
+  void close();
+  void flush();
+  void write(const QByteArray &data, const qint64 timestamp);
+  void configure(const QString &directory, const int format,
+                 const bool timestamps, const qint64 fileSize,
+                 const int fileCount);
+
+private:
+  bool openFile();
+  void removeOldFiles();
+  void writeText(const QByteArray &data, const QByteArray &timestamp);
+  void writeHex(const QByteArray &data, const QByteArray &timestamp);
+  const QByteArray &timestampPrefix(const qint64 timestamp);
+
+private:
+  int m_format;
+  int m_fileCount;
+  bool m_failed;
+  bool m_timestamps;
+  bool m_startingLine;
+
+  qint64 m_fileSize;
+  qint64 m_written;
+  qint64 m_timestampTime;
+
+  QFile m_file;
+  QString m_directory;
+  QByteArray m_buffer;
+  QByteArray m_timestamp;
+  QTimer *m_flushTimer;
+};
+
+/**
+ * @brief The ConsoleLog class
+ *
+ * Streams the data received from the device to rotating log files as it
+ * arrives, independently of the console history that is kept in memory, so
+ * that long sessions can be captured completely with constant memory usage.
+ *
+ * Data can be logged as plain text or as a hexadecimal dump, optionally with
+ * a timestamp at the beginning of each line. Formatting & disk I/O are done
+ * by a @c ConsoleLogWorker in a background thread.
+ */
+class ConsoleLog : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int format
+               READ format
+               WRITE setFormat
+               NOTIFY configurationChanged)
+    Q_PROPERTY(bool timestamps
+               READ timestamps
+               WRITE setTimestamps
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int fileSize
+               READ fileSize
+               WRITE setFileSize
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int fileCount
+               READ fileCount
+               WRITE setFileCount
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString currentFile
+               READ currentFile
+               NOTIFY currentFileChanged)
+    Q_PROPERTY(QString directory
+               READ directory
+               CONSTANT)
+    Q_PROPERTY(QStringList availableFormats
+               READ availableFormats
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void currentFileChanged();
+  void configurationChanged();
+
+private:
+  explicit ConsoleLog();
+  ConsoleLog(ConsoleLog &&) = delete;
+  ConsoleLog(const ConsoleLog &) = delete;
+  ConsoleLog &operator=(ConsoleLog &&) = delete;
+  ConsoleLog &operator=(const ConsoleLog &) = delete;
+
+  ~ConsoleLog();
+
+public:
+  static ConsoleLog &instance();
+
+  enum LogFormat
+  {
+    PlainText = 0,
+    Hexadecimal = 1,
+  };
+
+  bool enabled() const;
+  int format() const;
+  bool timestamps() const;
+  int fileSize() const;
+  int fileCount() const;
+  QString directory() const;
+  QString currentFile() const;
+  QStringList availableFormats() const;
+
+public Q_SLOTS:
+  void closeFile();
+  void openDirectory();
+  void setFormat(const int format);
+  void setEnabled(const bool enabled);
+  void setFileSize(const int megabytes);
+  void setFileCount(const int count);
+  void setTimestamps(const bool enabled);
+
+private Q_SLOTS:
+  void configureWorker();
+  void onOpenFailed(const QString &path);
+  void onFileChanged(const QString &path);
+  void onDataReceived(const QByteArray &data, const qint64 timestamp);
+
+private:
+  bool m_enabled;
+  int m_format;
+  bool m_timestamps;
+  int m_fileSize;
+  int m_fileCount;
+  QString m_currentFile;
+  Misc::Settings m_settings;
+  std::atomic<qint64> m_queuedBytes;
+
+  QThread m_thread;
+  ConsoleLogWorker *m_worker;
+};
+} // namespace IO
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Decompressor.h>
+
+/**
+ * Largest compressed block accepted, longer length prefixes are considered
+ * corrupted so that a bad prefix does not stall the stream forever.
+ */
+static const int MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+/**
+ * Constructor function, @a prefixSize is the number of bytes (0, 2 or 4)
+ * used to encode the length of each compressed block.
+ */
+IO::Decompressor::Decompressor(const int prefixSize)
+  : m_offset(0)
+  , m_prefixSize(0)
+{
+  if (prefixSize == 2 || prefixSize == 4)
+    m_prefixSize = prefixSize;
+}
+
+/**
+ * Returns the number of bytes used to encode the length of each compressed
+ * block, or 0 if the compressed data forms a continuous stream.
+ */
+int IO::Decompressor::prefixSize() const
+{
+  return m_prefixSize;
+}
+
+/**
+ * Queues the given compressed @a data, which is decompressed by the next
+ * calls to @c decompress().
+ */
+void IO::Decompressor::feed(const QByteArray &data)
+{
+  // Drop the data that was already decompressed before growing the queue
+  if (m_offset > 0 && m_offset >= m_input.size() / 2)
+  {
+    m_input.remove(0, m_offset);
+    m_offset = 0;
+  }
+
+  m_input.append(data);
+}
+
+/**
+ * Discards the queued data, subclasses must also reset their decoding state.
+ */
+void IO::Decompressor::reset()
+{
+  m_offset = 0;
+  m_input.clear();
+}
+
+/**
+ * Called when the ring buffer is cleared, decompressors that resolve
+ * back-references across blocks must forget the data written before.
+ */
+void IO::Decompressor::clearHistory() {}
+
+/**
+ * Returns the number of queued bytes that were not decompressed yet
+ */
+int IO::Decompressor::pending() const
+{
+  return m_input.size() - m_offset;
+}
+
+/**
+ * Returns a pointer to the first queued byte that was not decompressed yet
+ */
+const char *IO::Decompressor::input() const
+{
+  return m_input.constData() + m_offset;
+}
+
+/**
+ * Removes the given number of @a bytes from the front of the queue
+ */
+void IO::Decompressor::discard(const int bytes)
+{
+  m_offset = qMin(m_input.size(), m_offset + qMax(0, bytes));
+  if (m_offset == m_input.size())
+  {
+    m_offset = 0;
+    m_input.clear();
+  }
+}
+
+/**
+ * Points @a block to the payload of the next complete length-prefixed block
+ * & returns its length, the caller must @c discard() the prefix & the
+ * payload once the block is processed. Returns 0 if the block is not
+ * complete yet, or -1 if its length prefix is invalid (the prefix is
+ * discarded in that case).
+ */
+int IO::Decompressor::nextBlock(const char **block)
+{
+  // Wait for the length prefix
+  if (pending() < m_prefixSize)
+    return 0;
+
+  // Read the length of the block
+  quint32 length = 0;
+  const auto *data = reinterpret_cast<const quint8 *>(input());
+  for (int i = 0; i < m_prefixSize; ++i)
+    length |= quint32(data[i]) << (8 * i);
+
+  // Validate the length
+  if (length == 0 || length > quint32(MAX_BLOCK_SIZE))
+  {
+    discard(m_prefixSize);
+    return -1;
+  }
+
+  // Wait for the complete block
+  if (pending() < m_prefixSize + int(length))
+    return 0;
+
+  *block = input() + m_prefixSize;
+  return int(length);
+}
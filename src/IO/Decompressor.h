@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <IO/CircularBuffer.h>
+
+namespace IO
+{
+/**
+ * @brief The Decompressor class
+ *
+ * Abstract class for the decompression stage that sits between the driver &
+ * the framer of a frame reader, used by devices that compress their data to
+ * fit the bandwidth of the link (e.g. LZ4 or heatshrink).
+ *
+ * Compressed data is queued with @c feed() & decompressed directly into the
+ * ring buffer of the frame reader with @c decompress(), back-references are
+ * resolved against the data already stored in the ring, so no intermediate
+ * output buffer is used.
+ *
+ * Compressed blocks can either be preceded by their length as a 16-bit or
+ * 32-bit little endian integer (each block is decompressed independently),
+ * or form a continuous stream if the prefix size is 0 (only supported by
+ * compression formats that do not need to know where a block ends).
+ */
+class Decompressor
+{
+public:
+  enum class Result
+  {
+    Idle,
+    Data,
+    Overflow,
+    Corrupt
+  };
+
+  explicit Decompressor(const int prefixSize);
+  virtual ~Decompressor() {}
+
+  int prefixSize() const;
+  void feed(const QByteArray &data);
+
+  virtual void reset();
+  virtual void clearHistory();
+  virtual Result decompress(CircularBuffer &buffer) = 0;
+
+protected:
+  int pending() const;
+  const char *input() const;
+  void discard(const int bytes);
+  int nextBlock(const char **block);
+
+private:
+  int m_offset;
+  int m_prefixSize;
+  QByteArray m_input;
+};
+} // namespace IO
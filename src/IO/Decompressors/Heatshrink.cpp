@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Decompressors/Heatshrink.h>
+
+/**
+ * Constructor function, @a windowBits sets the size of the back-reference
+ * window (4 to 15 bits) & @a lookaheadBits sets the maximum match length
+ * (3 bits up to the window size minus one).
+ */
+IO::Decompressors::Heatshrink::Heatshrink(const int windowBits,
+                                          const int lookaheadBits,
+                                          const int prefixSize)
+  : Decompressor(prefixSize)
+  , m_windowBits(qBound(4, windowBits, 15))
+  , m_lookaheadBits(qBound(3, lookaheadBits, m_windowBits - 1))
+{
+  resetState();
+}
+
+/**
+ * Discards the queued input & restarts the decoder.
+ */
+void IO::Decompressors::Heatshrink::reset()
+{
+  Decompressor::reset();
+  resetState();
+}
+
+/**
+ * Forgets the decompressed data, so that back-references to data that is no
+ * longer in the ring buffer are reported as corrupted.
+ */
+void IO::Decompressors::Heatshrink::clearHistory()
+{
+  m_history = 0;
+  m_matchRemaining = 0;
+}
+
+/**
+ * Decompresses as much queued data as fits in the free space of the given
+ * @a buffer. @c Result::Overflow is only returned when no progress can be
+ * made until the buffer is cleared.
+ */
+IO::Decompressor::Result
+IO::Decompressors::Heatshrink::decompress(CircularBuffer &buffer)
+{
+  bool progress = false;
+
+  // Stream mode, decode everything that has been received so far
+  if (prefixSize() == 0)
+  {
+    int offset = 0;
+    const auto *data = reinterpret_cast<const quint8 *>(input());
+    const auto result = decode(data, pending(), &offset, buffer, &progress);
+    discard(offset);
+
+    if (result == Result::Corrupt)
+    {
+      resetState();
+      return Result::Corrupt;
+    }
+
+    if (progress)
+      return Result::Data;
+
+    return result;
+  }
+
+  // Block mode, get the next block
+  const char *block = Q_NULLPTR;
+  const int length = nextBlock(&block);
+  if (length == 0)
+    return Result::Idle;
+  if (length < 0)
+    return Result::Corrupt;
+
+  // Decode the block from a clean state, rolling back the output if it fails
+  int offset = 0;
+  resetState();
+  const int start = buffer.size();
+  const auto *data = reinterpret_cast<const quint8 *>(block);
+  auto result = decode(data, length, &offset, buffer, &progress);
+  if (result == Result::Idle && m_state == State::Tag)
+    result = Result::Data;
+  else if (result == Result::Idle)
+    result = Result::Corrupt;
+
+  resetState();
+  if (result != Result::Data)
+  {
+    buffer.chop(buffer.size() - start);
+    if (result == Result::Overflow && start > 0)
+      return Result::Overflow;
+  }
+
+  // Remove the block from the queue
+  discard(prefixSize() + length);
+  return result == Result::Data ? Result::Data : Result::Corrupt;
+}
+
+/**
+ * Restarts the bit reader & the decoder state machine.
+ */
+void IO::Decompressors::Heatshrink::resetState()
+{
+  m_history = 0;
+  m_bitCount = 0;
+  m_bitBuffer = 0;
+  m_state = State::Tag;
+  m_matchDistance = 0;
+  m_matchRemaining = 0;
+}
+
+/**
+ * Reads @a count bits (MSB first) from the bit buffer, refilling it from
+ * @a data as needed. Returns @c false if more input is required, in which
+ * case the bits read so far are kept for the next call.
+ */
+bool IO::Decompressors::Heatshrink::readBits(const int count, quint32 *value,
+                                             const quint8 *data,
+                                             const int length, int *offset)
+{
+  while (m_bitCount < count && *offset < length)
+  {
+    m_bitBuffer = (m_bitBuffer << 8) | data[(*offset)++];
+    m_bitCount += 8;
+  }
+
+  if (m_bitCount < count)
+    return false;
+
+  m_bitCount -= count;
+  *value = (m_bitBuffer >> m_bitCount) & ((1u << count) - 1);
+  m_bitBuffer &= (1u << m_bitCount) - 1;
+  return true;
+}
+
+/**
+ * Runs the decoder state machine over the given @a data, writing literals &
+ * back-references to the @a buffer until the input is exhausted (returns
+ * @c Result::Idle), the buffer is full (@c Result::Overflow) or an invalid
+ * back-reference is found (@c Result::Corrupt).
+ */
+IO::Decompressor::Result IO::Decompressors::Heatshrink::decode(
+    const quint8 *data, const int length, int *offset, CircularBuffer &buffer,
+    bool *progress)
+{
+  quint32 value = 0;
+  while (true)
+  {
+    // Finish copying the current back-reference
+    if (m_matchRemaining > 0)
+    {
+      const int bytes = qMin(m_matchRemaining, buffer.freeSpace());
+      if (bytes <= 0)
+        return Result::Overflow;
+
+      buffer.appendMatch(m_matchDistance, bytes);
+      m_history = qMin(m_history + bytes, buffer.capacity());
+      m_matchRemaining -= bytes;
+      *progress = true;
+      continue;
+    }
+
+    switch (m_state)
+    {
+      // Tag bit, 1 for a literal & 0 for a back-reference
+      case State::Tag:
+        if (!readBits(1, &value, data, length, offset))
+          return Result::Idle;
+
+        m_state = value ? State::Literal : State::Index;
+        break;
+
+      // Literal byte
+      case State::Literal: {
+        if (buffer.freeSpace() < 1)
+          return Result::Overflow;
+        if (!readBits(8, &value, data, length, offset))
+          return Result::Idle;
+
+        const char byte = static_cast<char>(value);
+        buffer.append(&byte, 1);
+        m_history = qMin(m_history + 1, buffer.capacity());
+        m_state = State::Tag;
+        *progress = true;
+        break;
+      }
+
+      // Back-reference distance
+      case State::Index:
+        if (!readBits(m_windowBits, &value, data, length, offset))
+          return Result::Idle;
+
+        m_matchDistance = static_cast<int>(value) + 1;
+        m_state = State::Count;
+        break;
+
+      // Back-reference length
+      case State::Count:
+        if (!readBits(m_lookaheadBits, &value, data, length, offset))
+          return Result::Idle;
+
+        m_state = State::Tag;
+        if (m_matchDistance > m_history)
+          return Result::Corrupt;
+
+        m_matchRemaining = static_cast<int>(value) + 1;
+        break;
+    }
+  }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <IO/Decompressor.h>
+
+namespace IO
+{
+namespace Decompressors
+{
+/**
+ * @brief The Heatshrink class
+ *
+ * Decompresses data encoded with the heatshrink LZSS format, which is common
+ * on small microcontrollers because the encoder only needs a few hundred
+ * bytes of RAM. The window & lookahead sizes (in bits) must match the ones
+ * used by the encoder of the device.
+ *
+ * Heatshrink data can be decoded as a continuous stream, in which case
+ * back-references may reach any data written to the ring buffer since the
+ * last time that it was cleared, or as length-prefixed blocks, which are
+ * decoded independently (the padding bits at the end of a block are ignored).
+ */
+class Heatshrink : public Decompressor
+{
+public:
+  Heatshrink(const int windowBits = 8, const int lookaheadBits = 4,
+             const int prefixSize = 0);
+
+  void reset() override;
+  void clearHistory() override;
+  Result decompress(CircularBuffer &buffer) override;
+
+private:
+  enum class State
+  {
+    Tag,
+    Literal,
+    Index,
+    Count
+  };
+
+  void resetState();
+  bool readBits(const int count, quint32 *value, const quint8 *data,
+                const int length, int *offset);
+  Result decode(const quint8 *data, const int length, int *offset,
+                CircularBuffer &buffer, bool *progress);
+
+private:
+  int m_windowBits;
+  int m_lookaheadBits;
+
+  State m_state;
+  int m_history;
+  int m_bitCount;
+  quint32 m_bitBuffer;
+  int m_matchDistance;
+  int m_matchRemaining;
+};
+} // namespace Decompressors
+} // namespace IO
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Decompressors/LZ4.h>
+
+/**
+ * Minimum length of an LZ4 match, the match length stored in the sequence
+ * token is relative to this value.
+ */
+static const int MIN_MATCH = 4;
+
+/**
+ * Reads the extension bytes of a literal or match length (a run of 255 bytes
+ * terminated by a smaller one) & adds them to @a value. Returns @c false if
+ * the block ends before the terminating byte or if the length exceeds the
+ * given @a limit.
+ */
+static bool READ_LENGTH(const quint8 *&ip, const quint8 *end, int &value,
+                        const int limit)
+{
+  quint8 byte = 255;
+  while (byte == 255)
+  {
+    if (ip >= end)
+      return false;
+
+    byte = *ip++;
+    value += byte;
+    if (value > limit)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Constructor function, @a prefixSize is the size (2 or 4 bytes) of the
+ * little endian length that precedes each compressed block.
+ */
+IO::Decompressors::LZ4::LZ4(const int prefixSize)
+  : Decompressor(prefixSize == 4 ? 4 : 2)
+{
+}
+
+/**
+ * Decompresses the next complete block into the given @a buffer.
+ *
+ * Blocks that are corrupted, or that could never fit in the buffer, are
+ * discarded. If the block only needs the space occupied by data that was not
+ * processed yet, @c Result::Overflow is returned & the block is kept, so that
+ * it is decompressed again after the buffer is cleared.
+ */
+IO::Decompressor::Result
+IO::Decompressors::LZ4::decompress(CircularBuffer &buffer)
+{
+  // Get next block
+  const char *block = Q_NULLPTR;
+  const int length = nextBlock(&block);
+  if (length == 0)
+    return Result::Idle;
+  if (length < 0)
+    return Result::Corrupt;
+
+  // Decompress the block, rolling back the output if it fails
+  const int start = buffer.size();
+  const auto result = decodeBlock(block, length, buffer);
+  if (result != Result::Data)
+  {
+    buffer.chop(buffer.size() - start);
+    if (result == Result::Overflow && start > 0)
+      return Result::Overflow;
+  }
+
+  // Remove the block from the queue
+  discard(prefixSize() + length);
+  return result == Result::Data ? Result::Data : Result::Corrupt;
+}
+
+/**
+ * Decodes the LZ4 sequences of the given @a block into the @a buffer, each
+ * sequence is made of a literal run followed by a back-reference, except for
+ * the last one, which only has literals.
+ */
+IO::Decompressor::Result
+IO::Decompressors::LZ4::decodeBlock(const char *block, const int length,
+                                    CircularBuffer &buffer) const
+{
+  int produced = 0;
+  const auto *ip = reinterpret_cast<const quint8 *>(block);
+  const auto *end = ip + length;
+  while (ip < end)
+  {
+    // Read the literal length
+    const int token = *ip++;
+    int literals = token >> 4;
+    if (literals == 15 && !READ_LENGTH(ip, end, literals, length))
+      return Result::Corrupt;
+
+    // Copy the literals
+    if (literals > end - ip)
+      return Result::Corrupt;
+    if (literals > buffer.freeSpace())
+      return Result::Overflow;
+
+    buffer.append(reinterpret_cast<const char *>(ip), literals);
+    produced += literals;
+    ip += literals;
+
+    // The last sequence of the block only contains literals
+    if (ip == end)
+      return Result::Data;
+
+    // Read the offset of the match
+    if (end - ip < 2)
+      return Result::Corrupt;
+
+    const int offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > produced)
+      return Result::Corrupt;
+
+    // Read the match length
+    int match = token & 15;
+    if (match == 15 && !READ_LENGTH(ip, end, match, buffer.capacity()))
+      return Result::Corrupt;
+
+    // Copy the match
+    match += MIN_MATCH;
+    if (match > buffer.freeSpace())
+      return Result::Overflow;
+
+    buffer.appendMatch(offset, match);
+    produced += match;
+  }
+
+  return Result::Corrupt;
+}
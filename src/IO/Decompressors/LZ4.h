@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <IO/Decompressor.h>
+
+namespace IO
+{
+namespace Decompressors
+{
+/**
+ * @brief The LZ4 class
+ *
+ * Decompresses blocks encoded with the LZ4 block format (not the LZ4 frame
+ * format), each block must be preceded by its compressed length since the
+ * block format does not mark where a block ends. Blocks are independent, so
+ * back-references never reach data decompressed from a previous block.
+ *
+ * If a block does not fit in the free space of the ring buffer, the output
+ * written so far is rolled back & the block is decompressed again once the
+ * frame reader makes room for it.
+ */
+class LZ4 : public Decompressor
+{
+public:
+  explicit LZ4(const int prefixSize = 2);
+
+  Result decompress(CircularBuffer &buffer) override;
+
+private:
+  Result decodeBlock(const char *block, const int length,
+                     CircularBuffer &buffer) const;
+};
+} // namespace Decompressors
+} // namespace IO
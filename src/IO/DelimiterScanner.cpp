@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <cstdint>
+#include <IO/DelimiterScanner.h>
+
+#if defined(__AVX2__)
+#  define SCANNER_AVX2
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)                                     \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SCANNER_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define SCANNER_NEON
+#  include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+/**
+ * Returns the index of the least significant bit set in the given @a mask,
+ * the mask must not be zero.
+ */
+static inline int LOWEST_BIT(const uint64_t mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+#  if defined(_M_X64) || defined(_M_ARM64)
+  _BitScanForward64(&index, mask);
+#  else
+  if (static_cast<uint32_t>(mask))
+    _BitScanForward(&index, static_cast<uint32_t>(mask));
+  else
+  {
+    _BitScanForward(&index, static_cast<uint32_t>(mask >> 32));
+    index += 32;
+  }
+#  endif
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(mask);
+#endif
+}
+
+/**
+ * Constructor function, configures the scanner to look for @a sequence
+ */
+IO::DelimiterScanner::DelimiterScanner(const QByteArray &sequence)
+  : m_sequence(sequence)
+{
+}
+
+/**
+ * Returns the sequence that the scanner looks for
+ */
+const QByteArray &IO::DelimiterScanner::sequence() const
+{
+  return m_sequence;
+}
+
+/**
+ * Changes the sequence that the scanner looks for
+ */
+void IO::DelimiterScanner::setSequence(const QByteArray &sequence)
+{
+  m_sequence = sequence;
+}
+
+/**
+ * Returns the index of the first occurrence of the configured sequence in the
+ * given @a data block, or -1 if the sequence is not found.
+ */
+int IO::DelimiterScanner::find(const char *data, const int length) const
+{
+  return find(data, length, m_sequence.constData(), m_sequence.length());
+}
+
+/**
+ * Returns the index of the first occurrence of the configured sequence in the
+ * given @a data, starting at the given @a from index.
+ */
+int IO::DelimiterScanner::find(const QByteArray &data, const int from) const
+{
+  if (from < 0 || from >= data.length())
+    return -1;
+
+  auto index = find(data.constData() + from, data.length() - from);
+  if (index >= 0)
+    return index + from;
+
+  return -1;
+}
+
+/**
+ * Returns the name of the instruction set used by the scanner, this is useful
+ * for diagnostics and benchmarks.
+ */
+const char *IO::DelimiterScanner::instructionSet()
+{
+#if defined(SCANNER_AVX2)
+  return "AVX2";
+#elif defined(SCANNER_SSE2)
+  return "SSE2";
+#elif defined(SCANNER_NEON)
+  return "NEON";
+#else
+  return "Scalar";
+#endif
+}
+
+/**
+ * Returns the index of the first occurrence of @a sequence in the given
+ * @a data block, or -1 if the sequence is not found.
+ *
+ * Candidate positions are obtained by comparing the first and last bytes of
+ * the sequence with a block of data in parallel, the bytes in between are only
+ * compared for positions in which both ends match.
+ */
+int IO::DelimiterScanner::find(const char *data, const int length,
+                               const char *sequence, const int sequenceLength)
+{
+  // Validate arguments
+  if (!data || !sequence || sequenceLength <= 0 || length < sequenceLength)
+    return -1;
+
+  // Single-byte sequences are handled by the C library
+  if (sequenceLength == 1)
+  {
+    auto hit = static_cast<const char *>(memchr(data, sequence[0], length));
+    return hit ? static_cast<int>(hit - data) : -1;
+  }
+
+  // Initialize parameters
+  int i = 0;
+  const int end = length - sequenceLength;
+  const char *last = data + sequenceLength - 1;
+  const char *middle = sequence + 1;
+  const int middleLength = sequenceLength - 2;
+
+  // Compare 32 positions at a time
+#if defined(SCANNER_AVX2)
+  const __m256i vf = _mm256_set1_epi8(sequence[0]);
+  const __m256i vl = _mm256_set1_epi8(sequence[sequenceLength - 1]);
+  for (; i + 32 <= end + 1; i += 32)
+  {
+    auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(last + i));
+    auto eq = _mm256_and_si256(_mm256_cmpeq_epi8(a, vf),
+                               _mm256_cmpeq_epi8(b, vl));
+
+    auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+    while (mask)
+    {
+      const int bit = LOWEST_BIT(mask);
+      if (memcmp(data + i + bit + 1, middle, middleLength) == 0)
+        return i + bit;
+
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  // Compare 16 positions at a time
+#if defined(SCANNER_SSE2) || defined(SCANNER_AVX2)
+  const __m128i sf = _mm_set1_epi8(sequence[0]);
+  const __m128i sl = _mm_set1_epi8(sequence[sequenceLength - 1]);
+  for (; i + 16 <= end + 1; i += 16)
+  {
+    auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(last + i));
+    auto eq = _mm_and_si128(_mm_cmpeq_epi8(a, sf), _mm_cmpeq_epi8(b, sl));
+
+    auto mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+    while (mask)
+    {
+      const int bit = LOWEST_BIT(mask);
+      if (memcmp(data + i + bit + 1, middle, middleLength) == 0)
+        return i + bit;
+
+      mask &= mask - 1;
+    }
+  }
+#elif defined(SCANNER_NEON)
+  const uint8x16_t nf = vdupq_n_u8(static_cast<uint8_t>(sequence[0]));
+  const uint8x16_t nl
+      = vdupq_n_u8(static_cast<uint8_t>(sequence[sequenceLength - 1]));
+  for (; i + 16 <= end + 1; i += 16)
+  {
+    auto a = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+    auto b = vld1q_u8(reinterpret_cast<const uint8_t *>(last + i));
+    auto eq = vandq_u8(vceqq_u8(a, nf), vceqq_u8(b, nl));
+
+    // Narrow the comparison result to a 64-bit mask (4 bits per byte)
+    auto nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    auto mask = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+    while (mask)
+    {
+      const int bit = LOWEST_BIT(mask) >> 2;
+      if (memcmp(data + i + bit + 1, middle, middleLength) == 0)
+        return i + bit;
+
+      mask &= ~(UINT64_C(0xF) << (bit * 4));
+    }
+  }
+#endif
+
+  // Scalar comparison for the remaining positions
+  const char first = sequence[0];
+  const char tail = sequence[sequenceLength - 1];
+  for (; i <= end; ++i)
+  {
+    if (data[i] == first && last[i] == tail
+        && memcmp(data + i + 1, middle, middleLength) == 0)
+      return i;
+  }
+
+  // Sequence not found
+  return -1;
+}
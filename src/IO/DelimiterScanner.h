@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QByteArray>
+
+namespace IO
+{
+/**
+ * @brief The DelimiterScanner class
+ *
+ * Searches for a multi-byte delimiter sequence (e.g. the start or finish
+ * sequence of a frame) in a contiguous block of memory.
+ *
+ * The search compares the first and the last byte of the sequence against
+ * 16 or 32 bytes at a time using SIMD instructions (AVX2, SSE2 or NEON,
+ * depending on the target) and only runs a full comparison for the
+ * positions that match both bytes. A scalar implementation is used for the
+ * remaining bytes and for targets without SIMD support.
+ */
+class DelimiterScanner
+{
+public:
+  explicit DelimiterScanner(const QByteArray &sequence = QByteArray());
+
+  const QByteArray &sequence() const;
+  void setSequence(const QByteArray &sequence);
+
+  int find(const char *data, const int length) const;
+  int find(const QByteArray &data, const int from = 0) const;
+
+  static const char *instructionSet();
+  static int find(const char *data, const int length, const char *sequence,
+                  const int sequenceLength);
+
+private:
+  QByteArray m_sequence;
+};
+} // namespace IO
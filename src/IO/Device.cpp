@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Device.h>
+#include <IO/Drivers/Serial.h>
+
+/**
+ * Constructor function, frames extracted from the received data are handed
+ * to the given frame @a reader, which is owned by the device from now on.
+ */
+IO::Device::Device(const int id, FrameReader *reader, QObject *parent)
+  : QObject(parent)
+  , m_id(id)
+  , m_fieldOffset(0)
+  , m_baudRate(9600)
+  , m_port(Q_NULLPTR)
+  , m_frameReader(reader)
+{
+}
+
+/**
+ * Destructor function, closes the serial port & deletes the frame reader in
+ * the thread in which it lives.
+ */
+IO::Device::~Device()
+{
+  close();
+
+  if (m_frameReader)
+    m_frameReader->deleteLater();
+}
+
+/**
+ * Returns the identifier used to tag the frames of this device
+ */
+int IO::Device::id() const
+{
+  return m_id;
+}
+
+/**
+ * Returns @c true if the serial port is open
+ */
+bool IO::Device::isOpen() const
+{
+  return m_port && m_port->isOpen();
+}
+
+/**
+ * Returns the user-defined name of the device
+ */
+QString IO::Device::tag() const
+{
+  return m_tag;
+}
+
+/**
+ * Returns the name of the serial port (e.g. "ttyUSB1" or "COM4")
+ */
+QString IO::Device::portName() const
+{
+  return m_portName;
+}
+
+/**
+ * Returns the baud rate used to open the serial port
+ */
+qint32 IO::Device::baudRate() const
+{
+  return m_baudRate;
+}
+
+/**
+ * Returns the number of project fields that precede the fields of this
+ * device, see the class documentation for more information.
+ */
+int IO::Device::fieldOffset() const
+{
+  return m_fieldOffset;
+}
+
+/**
+ * Returns the frame reader that extracts the frames of this device
+ */
+IO::FrameReader *IO::Device::frameReader() const
+{
+  return m_frameReader;
+}
+
+/**
+ * Opens the serial port with the given @a mode. The data bits, parity, stop
+ * bits & flow control are taken from the serial port setup pane, so that all
+ * devices share the same line configuration.
+ */
+bool IO::Device::open(const QIODevice::OpenMode mode)
+{
+  // Close previous connection
+  close();
+
+  // Create serial port handler
+  auto &serial = Drivers::Serial::instance();
+  m_port = new QSerialPort(m_portName, this);
+  m_port->setBaudRate(m_baudRate);
+  m_port->setParity(serial.parity());
+  m_port->setDataBits(serial.dataBits());
+  m_port->setStopBits(serial.stopBits());
+  m_port->setFlowControl(serial.flowControl());
+  m_port->setReadBufferSize(serial.readBufferSize());
+
+  // Open serial port
+  if (!m_port->open(mode))
+  {
+    close();
+    return false;
+  }
+
+  // clang-format off
+    connect(m_port, &QSerialPort::readyRead,
+            this, &IO::Device::onReadyRead);
+    connect(m_port, &QSerialPort::errorOccurred,
+            this, &IO::Device::onErrorOccurred);
+  // clang-format on
+
+  // Update UI
+  Q_EMIT connectedChanged();
+  return true;
+}
+
+/**
+ * Closes the serial port & discards the data buffered by the frame reader
+ */
+void IO::Device::close()
+{
+  if (m_port)
+  {
+    const bool wasOpen = m_port->isOpen();
+    disconnect(m_port, Q_NULLPTR, this, Q_NULLPTR);
+    m_port->close();
+    m_port->deleteLater();
+    m_port = Q_NULLPTR;
+
+    if (wasOpen)
+      Q_EMIT connectedChanged();
+  }
+
+  auto reader = m_frameReader;
+  if (reader)
+    QMetaObject::invokeMethod(reader, [=] { reader->reset(); });
+}
+
+/**
+ * Changes the user-defined name of the device
+ */
+void IO::Device::setTag(const QString &tag)
+{
+  m_tag = tag;
+}
+
+/**
+ * Changes the serial port name, the change is applied the next time that the
+ * device is opened.
+ */
+void IO::Device::setPortName(const QString &name)
+{
+  m_portName = name;
+}
+
+/**
+ * Changes the baud rate, the change is applied the next time that the device
+ * is opened.
+ */
+void IO::Device::setBaudRate(const qint32 rate)
+{
+  m_baudRate = qMax(1, rate);
+}
+
+/**
+ * Changes the number of project fields that precede the fields of this
+ * device.
+ */
+void IO::Device::setFieldOffset(const int offset)
+{
+  m_fieldOffset = qMax(0, offset);
+}
+
+/**
+ * Hands the received data to the frame reader (in the frame extraction thread
+ * if enabled) & notifies the I/O manager.
+ */
+void IO::Device::onReadyRead()
+{
+  if (!isOpen())
+    return;
+
+  const auto data = m_port->readAll();
+  if (data.isEmpty())
+    return;
+
+  auto reader = m_frameReader;
+  const auto time = FrameQueue::timestamp();
+  QMetaObject::invokeMethod(reader, [=] { reader->processData(data, time); });
+
+  Q_EMIT dataReceived(data, time);
+}
+
+/**
+ * Closes the device when the serial port reports an error (e.g. the device
+ * was unplugged), the rest of the devices are not affected.
+ */
+void IO::Device::onErrorOccurred(QSerialPort::SerialPortError error)
+{
+  if (error != QSerialPort::NoError)
+    close();
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QSerialPort>
+
+#include <IO/FrameReader.h>
+
+namespace IO
+{
+/**
+ * @brief The Device class
+ *
+ * Additional serial port that is opened together with the device selected in
+ * the setup pane, so that several devices can be monitored with a single
+ * dashboard.
+ *
+ * Each device has its own frame pipeline: received data is handed to a
+ * dedicated @c FrameReader (which keeps its own buffer & framing state), and
+ * the extracted frames are published to the shared frame queue tagged with
+ * the identifier of the device.
+ *
+ * The fields of each frame are mapped to the datasets of the loaded project
+ * starting at the given field offset, e.g. a device with an offset of 8 feeds
+ * the datasets with indexes 9, 10, 11 and so on. The user-defined tag is used
+ * to identify the device in the user interface.
+ */
+class Device : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void connectedChanged();
+  void dataReceived(const QByteArray &data, const qint64 timestamp);
+
+public:
+  Device(const int id, FrameReader *reader, QObject *parent = Q_NULLPTR);
+  ~Device();
+
+  int id() const;
+  bool isOpen() const;
+  QString tag() const;
+  QString portName() const;
+  qint32 baudRate() const;
+  int fieldOffset() const;
+  FrameReader *frameReader() const;
+
+  bool open(const QIODevice::OpenMode mode);
+  void close();
+
+  void setTag(const QString &tag);
+  void setPortName(const QString &name);
+  void setBaudRate(const qint32 rate);
+  void setFieldOffset(const int offset);
+
+private Q_SLOTS:
+  void onReadyRead();
+  void onErrorOccurred(QSerialPort::SerialPortError error);
+
+private:
+  int m_id;
+  int m_fieldOffset;
+  qint32 m_baudRate;
+  QString m_tag;
+  QString m_portName;
+
+  QSerialPort *m_port;
+  FrameReader *m_frameReader;
+};
+} // namespace IO
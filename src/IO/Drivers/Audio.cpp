@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QtEndian>
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/Drivers/Audio.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Limits of the configurable parameters
+ */
+static const int MIN_SAMPLE_RATE = 1000;
+static const int MAX_SAMPLE_RATE = 768000;
+static const int MAX_CHANNELS = 32;
+
+/**
+ * Sample formats requested to the audio device, in order of preference
+ */
+static const QAudioFormat::SampleFormat SAMPLE_FORMATS[]
+    = {QAudioFormat::Float, QAudioFormat::Int32, QAudioFormat::Int16,
+       QAudioFormat::UInt8};
+
+//----------------------------------------------------------------------------------------
+// Reader implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::AudioReader::AudioReader()
+  : m_device(Q_NULLPTR)
+  , m_source(Q_NULLPTR)
+{
+}
+
+/**
+ * Starts capturing the given audio input @a device with the given @a format,
+ * returns @c false if the device cannot be opened.
+ */
+bool IO::Drivers::AudioReader::start(const QAudioDevice &device,
+                                     const QAudioFormat &format)
+{
+  // Stop current capture
+  stop();
+
+  // Create the audio source
+  m_format = format;
+  m_source = new QAudioSource(device, format, this);
+  connect(m_source, &QAudioSource::stateChanged, this,
+          &AudioReader::onStateChanged);
+
+  // Start capturing
+  m_device = m_source->start();
+  if (!m_device)
+  {
+    stop();
+    return false;
+  }
+
+  connect(m_device, &QIODevice::readyRead, this, &AudioReader::onReadyRead);
+  return true;
+}
+
+/**
+ * Stops capturing & discards partially received sample instants
+ */
+void IO::Drivers::AudioReader::stop()
+{
+  if (m_source)
+  {
+    m_source->disconnect(this);
+    m_source->stop();
+    m_source->deleteLater();
+  }
+
+  m_buffer.clear();
+  m_device = Q_NULLPTR;
+  m_source = Q_NULLPTR;
+}
+
+/**
+ * Converts the captured samples into frames of 32-bit floats & hands them
+ * over to the driver as a single block.
+ */
+void IO::Drivers::AudioReader::onReadyRead()
+{
+  // Obtain the complete sample instants
+  m_buffer.append(m_device->readAll());
+  const int frameSize = m_format.bytesPerFrame();
+  const int sampleSize = m_format.bytesPerSample();
+  const int count = frameSize > 0 ? m_buffer.size() / frameSize : 0;
+  if (count <= 0)
+    return;
+
+  // The block is tagged with the capture time of its first sample
+  const qint64 duration = qint64(count) * 1000000 / m_format.sampleRate();
+  const qint64 timestamp = IO::FrameQueue::timestamp() - duration;
+
+  // Build one frame per sample instant
+  const int channels = m_format.channelCount();
+  const bool isFloat = m_format.sampleFormat() == QAudioFormat::Float;
+  QVector<QByteArray> frames;
+  frames.reserve(count);
+  for (int i = 0; i < count; ++i)
+  {
+    const char *samples = m_buffer.constData() + i * frameSize;
+    QByteArray frame(channels * int(sizeof(float)), Qt::Uninitialized);
+    for (int c = 0; c < channels; ++c)
+    {
+      float value;
+      if (isFloat)
+        std::memcpy(&value, samples + c * sampleSize, sizeof(float));
+      else
+        value = m_format.normalizedSampleValue(samples + c * sampleSize);
+
+      qToLittleEndian(value, frame.data() + c * sizeof(float));
+    }
+
+    frames.append(frame);
+  }
+
+  // Publish the block & keep the incomplete sample instant (if any)
+  const auto data = m_buffer.left(count * frameSize);
+  m_buffer.remove(0, count * frameSize);
+  Q_EMIT framesReady(data, frames, timestamp);
+}
+
+/**
+ * Notifies the driver if the capture stops because of an error (e.g. the
+ * device was unplugged)
+ */
+void IO::Drivers::AudioReader::onStateChanged(QAudio::State state)
+{
+  if (state == QAudio::StoppedState && m_source
+      && m_source->error() != QAudio::NoError)
+    Q_EMIT finished();
+}
+
+//----------------------------------------------------------------------------------------
+// Driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, restores the last configuration & starts the reader
+ * thread
+ */
+IO::Drivers::Audio::Audio()
+  : m_open(false)
+  , m_deviceIndex(0)
+  , m_sampleRate(48000)
+  , m_channelCount(2)
+  , m_reader(new AudioReader())
+{
+  // Read settings
+  m_lastDevice = m_settings.value("IO_Audio_Device", "").toByteArray();
+  m_sampleRate = qBound(MIN_SAMPLE_RATE,
+                        m_settings.value("IO_Audio_SampleRate", 48000).toInt(),
+                        MAX_SAMPLE_RATE);
+  m_channelCount = qBound(1, m_settings.value("IO_Audio_Channels", 2).toInt(),
+                          MAX_CHANNELS);
+
+  // Start reader thread
+  m_thread.setObjectName(QStringLiteral("IO::Drivers::AudioReader"));
+  m_reader->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_reader, &QObject::deleteLater);
+  connect(m_reader, &AudioReader::framesReady, this, &Audio::onFramesReady);
+  connect(m_reader, &AudioReader::finished, this, &Audio::onFinished);
+  m_thread.start(QThread::HighPriority);
+
+  // Update the device list when audio inputs are plugged or unplugged
+  connect(&m_mediaDevices, &QMediaDevices::audioInputsChanged, this,
+          &Audio::refreshDevices);
+  refreshDevices();
+}
+
+/**
+ * Stops capturing & stops the reader thread
+ */
+IO::Drivers::Audio::~Audio()
+{
+  close();
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::Audio &IO::Drivers::Audio::instance()
+{
+  static Audio singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Stops capturing the audio input
+ */
+void IO::Drivers::Audio::close()
+{
+  if (!m_open)
+    return;
+
+  auto reader = m_reader;
+  QMetaObject::invokeMethod(
+      reader, [=] { reader->stop(); }, Qt::BlockingQueuedConnection);
+
+  m_open = false;
+}
+
+/**
+ * Returns @c true if the audio input is being captured
+ */
+bool IO::Drivers::Audio::isOpen() const
+{
+  return m_open;
+}
+
+/**
+ * Returns @c true if the audio input is being captured
+ */
+bool IO::Drivers::Audio::isReadable() const
+{
+  return isOpen();
+}
+
+/**
+ * Audio inputs cannot be written to
+ */
+bool IO::Drivers::Audio::isWritable() const
+{
+  return false;
+}
+
+/**
+ * Returns @c true if an audio input is selected
+ */
+bool IO::Drivers::Audio::configurationOk() const
+{
+  return m_deviceIndex > 0;
+}
+
+/**
+ * Data written from the console is discarded, see @c isWritable()
+ */
+quint64 IO::Drivers::Audio::write(const QByteArray &data)
+{
+  (void)data;
+  return 0;
+}
+
+/**
+ * Negotiates a sample format supported by the selected input for the
+ * configured sample rate & channel count, and starts capturing it.
+ */
+bool IO::Drivers::Audio::open(const QIODevice::OpenMode mode)
+{
+  (void)mode;
+
+  // Stop current capture
+  close();
+  if (!configurationOk())
+    return false;
+
+  // Select the first supported sample format
+  bool supported = false;
+  QAudioFormat format;
+  format.setSampleRate(m_sampleRate);
+  format.setChannelCount(m_channelCount);
+  const auto device = m_devices.at(m_deviceIndex - 1);
+  for (const auto sampleFormat : SAMPLE_FORMATS)
+  {
+    format.setSampleFormat(sampleFormat);
+    if (device.isFormatSupported(format))
+    {
+      supported = true;
+      break;
+    }
+  }
+
+  if (!supported)
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Unsupported audio format"),
+        tr("\"%1\" cannot capture %2 channels at %3 Hz")
+            .arg(device.description())
+            .arg(m_channelCount)
+            .arg(m_sampleRate));
+    return false;
+  }
+
+  // Start capturing from the reader thread
+  bool ok = false;
+  auto reader = m_reader;
+  QMetaObject::invokeMethod(
+      reader, [&] { ok = reader->start(device, format); },
+      Qt::BlockingQueuedConnection);
+
+  if (!ok)
+  {
+    Misc::Utilities::showMessageBox(tr("Cannot open audio input"),
+                                    device.description());
+    return false;
+  }
+
+  m_open = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the index of the selected input in @c deviceList(), zero means
+ * that no input is selected.
+ */
+int IO::Drivers::Audio::deviceIndex() const
+{
+  return m_deviceIndex;
+}
+
+/**
+ * Returns the sample rate (in Hz) requested to the audio input
+ */
+int IO::Drivers::Audio::sampleRate() const
+{
+  return m_sampleRate;
+}
+
+/**
+ * Returns the number of channels requested to the audio input
+ */
+int IO::Drivers::Audio::channelCount() const
+{
+  return m_channelCount;
+}
+
+/**
+ * Returns the list of audio inputs, the first item is a placeholder that is
+ * selected when no input is selected.
+ */
+StringList IO::Drivers::Audio::deviceList() const
+{
+  StringList list;
+  list.append(tr("Select input"));
+  for (const auto &device : m_devices)
+    list.append(device.description());
+
+  return list;
+}
+
+/**
+ * Returns a list with common sample rates, to be used with an editable
+ * combo-box.
+ */
+StringList IO::Drivers::Audio::sampleRateList() const
+{
+  return StringList{"8000",  "11025", "16000",  "22050",  "44100",
+                    "48000", "88200", "96000", "176400", "192000"};
+}
+
+/**
+ * Rebuilds the list of audio inputs & selects the last used input if it is
+ * available, or the default input of the system otherwise.
+ */
+void IO::Drivers::Audio::refreshDevices()
+{
+  m_devices = QMediaDevices::audioInputs();
+
+  // Select the last used input, or the default input
+  m_deviceIndex = 0;
+  const auto fallback = QMediaDevices::defaultAudioInput().id();
+  for (int i = 0; i < m_devices.count(); ++i)
+  {
+    const auto id = m_devices.at(i).id();
+    if (id == m_lastDevice)
+    {
+      m_deviceIndex = i + 1;
+      break;
+    }
+
+    if (id == fallback && m_deviceIndex == 0)
+      m_deviceIndex = i + 1;
+  }
+
+  Q_EMIT deviceListChanged();
+  Q_EMIT deviceIndexChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Selects the input at the given @a index of @c deviceList()
+ */
+void IO::Drivers::Audio::setDeviceIndex(const int index)
+{
+  const auto value = qBound(0, index, static_cast<int>(m_devices.count()));
+  if (m_deviceIndex != value)
+  {
+    m_deviceIndex = value;
+    if (value > 0)
+    {
+      m_lastDevice = m_devices.at(value - 1).id();
+      m_settings.setValue("IO_Audio_Device", m_lastDevice);
+    }
+
+    Q_EMIT deviceIndexChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the sample @a rate (in Hz) requested to the audio input
+ */
+void IO::Drivers::Audio::setSampleRate(const int rate)
+{
+  const auto value = qBound(MIN_SAMPLE_RATE, rate, MAX_SAMPLE_RATE);
+  if (m_sampleRate != value)
+  {
+    m_sampleRate = value;
+    m_settings.setValue("IO_Audio_SampleRate", value);
+    Q_EMIT sampleRateChanged();
+  }
+}
+
+/**
+ * Changes the number of @a channels requested to the audio input
+ */
+void IO::Drivers::Audio::setChannelCount(const int channels)
+{
+  const auto value = qBound(1, channels, MAX_CHANNELS);
+  if (m_channelCount != value)
+  {
+    m_channelCount = value;
+    m_settings.setValue("IO_Audio_Channels", value);
+    Q_EMIT channelCountChanged();
+  }
+}
+
+/**
+ * Closes the connection when the capture stops because of an error
+ */
+void IO::Drivers::Audio::onFinished()
+{
+  if (m_open)
+    Manager::instance().connectionLost();
+}
+
+/**
+ * Publishes a block of captured @a frames through the I/O manager
+ */
+void IO::Drivers::Audio::onFramesReady(const QByteArray &data,
+                                       const QVector<QByteArray> &frames,
+                                       const qint64 timestamp)
+{
+  if (m_open)
+    Manager::instance().processFrames(data, frames, timestamp);
+}
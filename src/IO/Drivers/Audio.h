@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QThread>
+#include <QVector>
+#include <QAudioDevice>
+#include <QAudioFormat>
+#include <QAudioSource>
+#include <QMediaDevices>
+
+#include <DataTypes.h>
+#include <IO/HAL_Driver.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The AudioReader class
+ *
+ * Worker object of the @c Audio driver, captures an audio input from its own
+ * thread & converts each captured buffer into a block of frames, one frame
+ * per sample instant with the value of every channel stored as a native
+ * 32-bit float (i.e. @c channels * 4 bytes per frame).
+ *
+ * Conversion happens in the worker thread, so that the main thread only has
+ * to forward one block per captured buffer to the I/O manager.
+ */
+class AudioReader : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void finished();
+  void framesReady(const QByteArray &data, const QVector<QByteArray> &frames,
+                   const qint64 timestamp);
+
+public:
+  AudioReader();
+
+public Q_SLOTS:
+  bool start(const QAudioDevice &device, const QAudioFormat &format);
+  void stop();
+
+private Q_SLOTS:
+  void onReadyRead();
+  void onStateChanged(QAudio::State state);
+
+private:
+  QByteArray m_buffer;
+  QAudioFormat m_format;
+  QIODevice *m_device;
+  QAudioSource *m_source;
+};
+
+/**
+ * @brief The Audio class
+ *
+ * Serial Studio driver class that captures an audio input (e.g. a multi-
+ * channel sound card used as a high-rate ADC) with a configurable sample
+ * rate & number of channels.
+ *
+ * Captured samples bypass the text framing of the I/O manager: each sample
+ * instant is published as a binary frame with one 32-bit float per channel,
+ * normalized to the range [-1, 1]. The frames of each captured buffer are
+ * published as a single block (see @c IO::Manager::processFrames()), tagged
+ * with the time at which the first sample of the buffer was captured.
+ *
+ * Projects map the channels to datasets with a binary layout that contains
+ * one little-endian @c float32 field per channel (offsets 0, 4, 8...), which
+ * is decoded with the specialized loop of @c JSON::BinaryDecoder.
+ */
+class Audio : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int deviceIndex
+               READ deviceIndex
+               WRITE setDeviceIndex
+               NOTIFY deviceIndexChanged)
+    Q_PROPERTY(int sampleRate
+               READ sampleRate
+               WRITE setSampleRate
+               NOTIFY sampleRateChanged)
+    Q_PROPERTY(int channelCount
+               READ channelCount
+               WRITE setChannelCount
+               NOTIFY channelCountChanged)
+    Q_PROPERTY(StringList deviceList
+               READ deviceList
+               NOTIFY deviceListChanged)
+    Q_PROPERTY(StringList sampleRateList
+               READ sampleRateList
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void deviceListChanged();
+  void sampleRateChanged();
+  void deviceIndexChanged();
+  void channelCountChanged();
+
+private:
+  explicit Audio();
+  Audio(Audio &&) = delete;
+  Audio(const Audio &) = delete;
+  Audio &operator=(Audio &&) = delete;
+  Audio &operator=(const Audio &) = delete;
+
+  ~Audio();
+
+public:
+  static Audio &instance();
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  int deviceIndex() const;
+  int sampleRate() const;
+  int channelCount() const;
+  StringList deviceList() const;
+  StringList sampleRateList() const;
+
+public Q_SLOTS:
+  void refreshDevices();
+  void setDeviceIndex(const int index);
+  void setSampleRate(const int rate);
+  void setChannelCount(const int channels);
+
+private Q_SLOTS:
+  void onFinished();
+  void onFramesReady(const QByteArray &data, const QVector<QByteArray> &frames,
+                     const qint64 timestamp);
+
+private:
+  bool m_open;
+  int m_deviceIndex;
+  int m_sampleRate;
+  int m_channelCount;
+  QByteArray m_lastDevice;
+  Misc::Settings m_settings;
+
+  QMediaDevices m_mediaDevices;
+  QList<QAudioDevice> m_devices;
+
+  QThread m_thread;
+  AudioReader *m_reader;
+};
+} // namespace Drivers
+} // namespace IO
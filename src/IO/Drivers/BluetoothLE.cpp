@@ -21,10 +21,23 @@
  */
 
 #include <QOperatingSystemVersion>
+#include <QLowEnergyConnectionParameters>
 
 #include <IO/Manager.h>
 #include <IO/Drivers/BluetoothLE.h>
 
+/**
+ * Maximum time (in milliseconds) that received notifications are kept before
+ * being handed to the frame pipeline.
+ */
+static const int BLE_BATCH_INTERVAL = 5;
+
+/**
+ * Number of buffered bytes that triggers the delivery of the received
+ * notifications before the batch interval expires.
+ */
+static const int BLE_BATCH_SIZE = 16 * 1024;
+
 //----------------------------------------------------------------------------------------
 // Constructor & singleton access functions
 //----------------------------------------------------------------------------------------
@@ -35,9 +48,17 @@
 IO::Drivers::BluetoothLE::BluetoothLE()
   : m_deviceIndex(-1)
   , m_deviceConnected(false)
+  , m_pendingBytes(0)
   , m_service(Q_NULLPTR)
   , m_controller(Q_NULLPTR)
 {
+  // Configure the notification batching timer
+  m_batchTimer.setSingleShot(true);
+  m_batchTimer.setInterval(BLE_BATCH_INTERVAL);
+  m_batchTimer.setTimerType(Qt::PreciseTimer);
+  connect(&m_batchTimer, &QTimer::timeout, this,
+          &IO::Drivers::BluetoothLE::flushNotifications);
+
   // clang-format off
 
     // Update connect button status when a BLE device is selected by the user
@@ -88,6 +109,9 @@ void IO::Drivers::BluetoothLE::close()
   m_serviceNames.clear();
   m_deviceConnected = false;
 
+  // Discard pending notifications & characteristic streams
+  closeStreams();
+
   // Delete previous service
   if (m_service)
   {
@@ -164,12 +188,14 @@ bool IO::Drivers::BluetoothLE::open(const QIODevice::OpenMode mode)
   // React to connection event with BLE device
   connect(m_controller, &QLowEnergyController::connected, this, [this]() {
     m_deviceConnected = true;
+    requestConnectionUpdate();
     m_controller->discoverServices();
     Q_EMIT deviceConnectedChanged();
   });
 
   // React to disconnection event with BLE device
   connect(m_controller, &QLowEnergyController::disconnected, this, [this]() {
+    closeStreams();
     if (m_service)
     {
       disconnect(m_service);
@@ -199,6 +225,23 @@ bool IO::Drivers::BluetoothLE::open(const QIODevice::OpenMode mode)
 // Driver specifics
 //----------------------------------------------------------------------------------------
 
+/**
+ * @return The ATT MTU negotiated with the BLE device, or 0 if it is unknown.
+ *
+ * @note The MTU exchange is started by the Bluetooth stack of the operating
+ *       system when the connection is established, Qt does not allow
+ *       applications to request a specific value.
+ */
+int IO::Drivers::BluetoothLE::mtu() const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+  if (m_controller && m_deviceConnected)
+    return qMax(0, m_controller->mtu());
+#endif
+
+  return 0;
+}
+
 /**
  * @return The total number of discovered devices.
  */
@@ -237,6 +280,17 @@ QStringList IO::Drivers::BluetoothLE::serviceNames() const
   return list;
 }
 
+/**
+ * @return The number of characteristics that are streaming data.
+ */
+int IO::Drivers::BluetoothLE::characteristicCount() const
+{
+  if (m_primaryCharacteristic.isNull())
+    return 0;
+
+  return m_streams.count() + 1;
+}
+
 /**
  * Returns @c false on macOS Monterey, for more info, please check this link:
  * https://forum.qt.io/topic/132285/mac-os-sdk12-not-working-with-qt-bluetooth
@@ -315,6 +369,7 @@ void IO::Drivers::BluetoothLE::selectService(const int index)
     return;
 
   // Delete previous service
+  closeStreams();
   if (m_service)
   {
     disconnect(m_service);
@@ -353,9 +408,48 @@ void IO::Drivers::BluetoothLE::selectService(const int index)
   }
 }
 
+/**
+ * Hands the notifications received since the last call to the frame pipeline
+ * of their characteristics, the data of each characteristic is delivered at
+ * once.
+ */
+void IO::Drivers::BluetoothLE::flushNotifications()
+{
+  // Stop the batching timer
+  m_batchTimer.stop();
+  if (m_pendingOrder.isEmpty())
+    return;
+
+  // Take the pending data, so that new notifications start a new batch
+  auto order = m_pendingOrder;
+  auto pending = m_pending;
+  auto times = m_pendingTimestamps;
+  m_pendingOrder.clear();
+  m_pending.clear();
+  m_pendingTimestamps.clear();
+  m_pendingBytes = 0;
+
+  // Deliver the data of each characteristic, values that do not belong to a
+  // stream (e.g. characteristic reads) are handled by the driver's reader
+  Q_FOREACH (const auto &uuid, order)
+  {
+    const auto time = times.value(uuid);
+    if (m_streams.contains(uuid))
+      Manager::instance().processStreamData(m_streams.value(uuid),
+                                            pending.value(uuid), time);
+    else
+      Q_EMIT dataReceived(pending.value(uuid), time);
+  }
+}
+
 /**
  * Sets the interaction options between each characteristic of the BLE device
  * and the BLE module.
+ *
+ * Notifications (or indications, if the characteristic does not support
+ * notifications) are enabled for every characteristic that supports them,
+ * the first one feeds the frame reader of the driver & the rest of them get
+ * their own frame stream.
  */
 void IO::Drivers::BluetoothLE::configureCharacteristics()
 {
@@ -363,6 +457,9 @@ void IO::Drivers::BluetoothLE::configureCharacteristics()
   if (!m_service)
     return;
 
+  // Remove previous streams
+  closeStreams();
+
   // Test & validate all service characteristics
   foreach (QLowEnergyCharacteristic c, m_service->characteristics())
   {
@@ -372,9 +469,68 @@ void IO::Drivers::BluetoothLE::configureCharacteristics()
 
     // Set client/descriptor connection properties
     auto descriptor = c.clientCharacteristicConfiguration();
-    if (descriptor.isValid())
+    if (!descriptor.isValid())
+      continue;
+
+    // Enable notifications or indications
+    if (c.properties() & QLowEnergyCharacteristic::Notify)
       m_service->writeDescriptor(descriptor, QByteArray::fromHex("0100"));
+    else if (c.properties() & QLowEnergyCharacteristic::Indicate)
+      m_service->writeDescriptor(descriptor, QByteArray::fromHex("0200"));
+    else
+      continue;
+
+    // Register the stream of the characteristic
+    if (m_primaryCharacteristic.isNull())
+      m_primaryCharacteristic = c.uuid();
+    else if (!m_streams.contains(c.uuid()))
+      m_streams.insert(c.uuid(),
+                       Manager::instance().openStream(c.uuid().toString()));
   }
+
+  // Update UI
+  Q_EMIT linkChanged();
+}
+
+/**
+ * Requests the shortest connection interval allowed by the Bluetooth
+ * specification (7.5 ms), so that the peripheral can send more notifications
+ * per second. The peripheral or the operating system may choose a different
+ * interval, and some platforms (e.g. macOS & iOS) ignore the request.
+ */
+void IO::Drivers::BluetoothLE::requestConnectionUpdate()
+{
+  if (!m_controller)
+    return;
+
+  QLowEnergyConnectionParameters params;
+  params.setIntervalRange(7.5, 15);
+  params.setLatency(0);
+  params.setSupervisionTimeout(4000);
+  m_controller->requestConnectionUpdate(params);
+}
+
+/**
+ * Discards the pending notifications & closes the frame streams of the
+ * additional characteristics.
+ */
+void IO::Drivers::BluetoothLE::closeStreams()
+{
+  // Discard pending notifications
+  m_batchTimer.stop();
+  m_pending.clear();
+  m_pendingOrder.clear();
+  m_pendingTimestamps.clear();
+  m_pendingBytes = 0;
+
+  // Close the frame streams
+  Q_FOREACH (const auto stream, m_streams)
+    Manager::instance().closeStream(stream);
+
+  // Reset characteristics
+  m_streams.clear();
+  m_primaryCharacteristic = QBluetoothUuid();
+  Q_EMIT linkChanged();
 }
 
 /**
@@ -393,6 +549,7 @@ void IO::Drivers::BluetoothLE::onServiceDiscoveryFinished()
     m_serviceNames.append(m_controller->services().at(i).toString());
 
   // Update UI
+  Q_EMIT linkChanged();
   Q_EMIT servicesChanged();
 }
 
@@ -493,11 +650,30 @@ void IO::Drivers::BluetoothLE::onServiceStateChanged(
 }
 
 /**
- * Reads the transmitted data from the BLE service.
+ * Registers the transmitted data from the BLE service, the data is delivered
+ * when the batch interval expires or when enough data has been received.
  */
 void IO::Drivers::BluetoothLE::onCharacteristicChanged(
     const QLowEnergyCharacteristic &info, const QByteArray &value)
 {
-  (void)info;
-  Q_EMIT dataReceived(value);
+  // Validate value
+  if (value.isEmpty())
+    return;
+
+  // Register value, each batch keeps the reception time of its first value
+  const auto uuid = info.uuid();
+  if (!m_pending.contains(uuid))
+  {
+    m_pendingOrder.append(uuid);
+    m_pendingTimestamps.insert(uuid, FrameQueue::timestamp());
+  }
+
+  m_pending[uuid].append(value);
+  m_pendingBytes += value.size();
+
+  // Deliver the batch or schedule its delivery
+  if (m_pendingBytes >= BLE_BATCH_SIZE)
+    flushNotifications();
+  else if (!m_batchTimer.isActive())
+    m_batchTimer.start();
 }
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include <QHash>
 #include <QTimer>
 #include <QObject>
+#include <QBluetoothUuid>
 #include <QLowEnergyController>
 #include <QBluetoothDeviceDiscoveryAgent>
 
@@ -37,6 +39,16 @@ namespace Drivers
 /**
  * @brief The BluetoothLE class
  * Serial Studio driver class to interact with Bluetooth Low Energy devices.
+ *
+ * Every notify/indicate characteristic of the selected service is subscribed.
+ * The first characteristic feeds the frame reader of the driver, the rest of
+ * them get their own frame stream (see @c IO::Manager::openStream()), so that
+ * the partial frames of different characteristics are never mixed.
+ *
+ * Notifications are not delivered one by one, the values received from each
+ * characteristic are accumulated & handed to the frame pipeline in batches.
+ * After connecting, a short connection interval is requested to the
+ * peripheral, so that more notifications can be sent per second.
  */
 class BluetoothLE : public HAL_Driver
 {
@@ -61,9 +73,16 @@ class BluetoothLE : public HAL_Driver
     Q_PROPERTY(bool operatingSystemSupported
                READ operatingSystemSupported
                CONSTANT)
+    Q_PROPERTY(int mtu
+               READ mtu
+               NOTIFY linkChanged)
+    Q_PROPERTY(int characteristicCount
+               READ characteristicCount
+               NOTIFY linkChanged)
   // clang-format on
 
 Q_SIGNALS:
+  void linkChanged();
   void devicesChanged();
   void servicesChanged();
   void deviceIndexChanged();
@@ -91,10 +110,12 @@ public:
   quint64 write(const QByteArray &data) override;
   bool open(const QIODevice::OpenMode mode) override;
 
+  int mtu() const;
   int deviceCount() const;
   int deviceIndex() const;
   StringList deviceNames() const;
   StringList serviceNames() const;
+  int characteristicCount() const;
   bool operatingSystemSupported() const;
 
 public Q_SLOTS:
@@ -103,7 +124,9 @@ public Q_SLOTS:
   void selectService(const int index);
 
 private Q_SLOTS:
+  void flushNotifications();
   void configureCharacteristics();
+  void requestConnectionUpdate();
   void onServiceDiscoveryFinished();
   void onDeviceDiscovered(const QBluetoothDeviceInfo &device);
   void onServiceError(QLowEnergyService::ServiceError serviceError);
@@ -112,13 +135,24 @@ private Q_SLOTS:
   void onCharacteristicChanged(const QLowEnergyCharacteristic &info,
                                const QByteArray &value);
 
+private:
+  void closeStreams();
+
 private:
   int m_deviceIndex;
   bool m_deviceConnected;
+  int m_pendingBytes;
 
   QLowEnergyService *m_service;
   QLowEnergyController *m_controller;
 
+  QTimer m_batchTimer;
+  QBluetoothUuid m_primaryCharacteristic;
+  QList<QBluetoothUuid> m_pendingOrder;
+  QHash<QBluetoothUuid, int> m_streams;
+  QHash<QBluetoothUuid, QByteArray> m_pending;
+  QHash<QBluetoothUuid, qint64> m_pendingTimestamps;
+
   StringList m_deviceNames;
   StringList m_serviceNames;
   QList<QBluetoothDeviceInfo> m_devices;
@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QCanBus>
+#include <QTimer>
+#include <QtEndian>
+#include <QCanBusFrame>
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/Drivers/CANBus.h>
+#include <JSON/BinaryDecoder.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Nominal bitrates offered to the user (in bits per second)
+ */
+static const int BITRATES[] = {10000,  20000,  50000,  100000, 125000,
+                               250000, 500000, 800000, 1000000};
+static const int BITRATE_COUNT = sizeof(BITRATES) / sizeof(BITRATES[0]);
+
+/**
+ * Largest CAN identifier (29-bit extended frame format)
+ */
+static const quint32 MAX_CAN_ID = 0x1FFFFFFF;
+
+/**
+ * Converts the given CAN @a frame to a record that can be decoded by the
+ * binary decoder (see @c CAN_RECORD_HEADER_SIZE).
+ */
+static QByteArray CAN_RECORD(const QCanBusFrame &frame)
+{
+  // Get flags
+  quint8 flags = 0;
+  if (frame.hasExtendedFrameFormat())
+    flags |= IO::Drivers::CANBus::ExtendedFrame;
+  if (frame.hasFlexibleDataRateFormat())
+    flags |= IO::Drivers::CANBus::FlexibleDataRate;
+  if (frame.hasBitrateSwitch())
+    flags |= IO::Drivers::CANBus::BitrateSwitch;
+
+  // Write header & payload
+  const auto payload = frame.payload();
+  const int length = qMin(payload.size(), 255);
+  QByteArray record(CAN_RECORD_HEADER_SIZE + length, Qt::Uninitialized);
+  qToLittleEndian<quint32>(frame.frameId(), record.data());
+  record[4] = static_cast<char>(flags);
+  record[5] = static_cast<char>(length);
+  memcpy(record.data() + CAN_RECORD_HEADER_SIZE, payload.constData(), length);
+  return record;
+}
+
+/**
+ * Constructor function, restores the last configuration & lists the
+ * available CAN plugins.
+ */
+IO::Drivers::CANBus::CANBus()
+  : m_bitrate(500000)
+  , m_canFd(false)
+  , m_pluginIndex(0)
+  , m_interfaceIndex(0)
+  , m_device(Q_NULLPTR)
+{
+  // Get available plugins
+  const auto plugins = QCanBus::instance()->plugins();
+  for (const auto &plugin : plugins)
+    m_plugins.append(plugin);
+
+  // Read settings, SocketCAN is used by default if available
+  const auto plugin = m_settings.value("IO_CANBus_Plugin", "socketcan");
+  m_pluginIndex = qMax(0, m_plugins.indexOf(plugin.toString()));
+  m_bitrate = m_settings.value("IO_CANBus_Bitrate", 500000).toInt();
+  m_canFd = m_settings.value("IO_CANBus_CanFd", false).toBool();
+  m_filter = m_settings.value("IO_CANBus_Filter", "").toString();
+
+  // List the interfaces of the selected plugin
+  refreshInterfaces();
+  const auto device = m_settings.value("IO_CANBus_Interface", "").toString();
+  m_interfaceIndex = qMax(0, m_interfaces.indexOf(device));
+}
+
+/**
+ * Closes the CAN device
+ */
+IO::Drivers::CANBus::~CANBus()
+{
+  close();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::CANBus &IO::Drivers::CANBus::instance()
+{
+  static CANBus singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Disconnects from the CAN interface
+ */
+void IO::Drivers::CANBus::close()
+{
+  if (m_device)
+  {
+    disconnect(m_device);
+    m_device->disconnectDevice();
+    m_device->deleteLater();
+    m_device = Q_NULLPTR;
+  }
+}
+
+/**
+ * Returns @c true if the driver is connected to a CAN interface
+ */
+bool IO::Drivers::CANBus::isOpen() const
+{
+  return m_device && m_device->state() == QCanBusDevice::ConnectedState;
+}
+
+/**
+ * Returns @c true if frames can be received from the CAN interface
+ */
+bool IO::Drivers::CANBus::isReadable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if frames can be sent to the CAN interface
+ */
+bool IO::Drivers::CANBus::isWritable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if a plugin & an interface are selected
+ */
+bool IO::Drivers::CANBus::configurationOk() const
+{
+  return !pluginName().isEmpty() && m_interfaceIndex >= 0
+         && m_interfaceIndex < m_interfaces.count();
+}
+
+/**
+ * Sends a CAN frame described by the given @a data with the @c cansend
+ * syntax: the identifier (3 hex digits for standard frames, 8 for extended
+ * frames) followed by @c # and the payload in hexadecimal.
+ */
+quint64 IO::Drivers::CANBus::write(const QByteArray &data)
+{
+  // Device not connected
+  if (!isWritable())
+    return 0;
+
+  // Parse identifier & payload
+  const auto text = data.trimmed();
+  const int separator = text.indexOf('#');
+  if (separator <= 0)
+    return 0;
+
+  bool ok;
+  const auto idText = text.left(separator);
+  const auto id = idText.toUInt(&ok, 16);
+  if (!ok || id > MAX_CAN_ID)
+    return 0;
+
+  // Build the frame
+  const auto payload = QByteArray::fromHex(text.mid(separator + 1));
+  QCanBusFrame frame(id, payload);
+  frame.setExtendedFrameFormat(idText.size() > 3 || id > 0x7FF);
+  frame.setFlexibleDataRateFormat(m_canFd && payload.size() > 8);
+
+  // Send the frame
+  if (!m_device->writeFrame(frame))
+    return 0;
+
+  Q_EMIT dataSent(data);
+  return static_cast<quint64>(data.size());
+}
+
+/**
+ * Connects to the selected CAN interface with the configured bitrate, CAN FD
+ * mode & identifier filter.
+ */
+bool IO::Drivers::CANBus::open(const QIODevice::OpenMode mode)
+{
+  (void)mode;
+
+  // Close current device
+  close();
+  if (!configurationOk())
+    return false;
+
+  // Create the device
+  QString error;
+  const auto plugin = pluginName();
+  const auto name = m_interfaces.at(m_interfaceIndex);
+  m_device = QCanBus::instance()->createDevice(plugin, name, &error);
+  if (!m_device)
+  {
+    if (!Manager::instance().reconnecting())
+      Misc::Utilities::showMessageBox(
+          tr("Cannot create CAN device \"%1\"").arg(name), error);
+    return false;
+  }
+
+  // Configure the device
+  m_device->setConfigurationParameter(QCanBusDevice::BitRateKey, m_bitrate);
+  m_device->setConfigurationParameter(QCanBusDevice::CanFdKey, m_canFd);
+  const auto list = filters();
+  if (!list.isEmpty())
+    m_device->setConfigurationParameter(QCanBusDevice::RawFilterKey,
+                                        QVariant::fromValue(list));
+
+  // clang-format off
+  connect(m_device, &QCanBusDevice::framesReceived,
+          this, &IO::Drivers::CANBus::onFramesReceived);
+  connect(m_device, &QCanBusDevice::errorOccurred,
+          this, &IO::Drivers::CANBus::onErrorOccurred);
+  // clang-format on
+
+  // Connect to the bus
+  if (!m_device->connectDevice())
+  {
+    if (!Manager::instance().reconnecting())
+      Misc::Utilities::showMessageBox(
+          tr("Cannot connect to \"%1\"").arg(name),
+          m_device->errorString());
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the index of the selected Qt SerialBus plugin
+ */
+int IO::Drivers::CANBus::pluginIndex() const
+{
+  return m_pluginIndex;
+}
+
+/**
+ * Returns the index of the selected CAN interface
+ */
+int IO::Drivers::CANBus::interfaceIndex() const
+{
+  return m_interfaceIndex;
+}
+
+/**
+ * Returns the nominal bitrate of the bus (in bits per second)
+ */
+int IO::Drivers::CANBus::bitrate() const
+{
+  return m_bitrate;
+}
+
+/**
+ * Returns @c true if CAN FD frames are enabled
+ */
+bool IO::Drivers::CANBus::canFd() const
+{
+  return m_canFd;
+}
+
+/**
+ * Returns the identifier filter, a comma-separated list of hexadecimal
+ * identifiers, optionally followed by a mask (e.g. @c 123,200:7F0). An empty
+ * filter accepts every frame.
+ */
+QString IO::Drivers::CANBus::filter() const
+{
+  return m_filter;
+}
+
+/**
+ * Returns the list of Qt SerialBus plugins installed in the system
+ */
+StringList IO::Drivers::CANBus::pluginList() const
+{
+  return m_plugins;
+}
+
+/**
+ * Returns the list of interfaces found by the selected plugin
+ */
+StringList IO::Drivers::CANBus::interfaceList() const
+{
+  return m_interfaces;
+}
+
+/**
+ * Returns the list of nominal bitrates offered to the user
+ */
+StringList IO::Drivers::CANBus::bitrateList() const
+{
+  StringList list;
+  for (int i = 0; i < BITRATE_COUNT; ++i)
+    list.append(QString::number(BITRATES[i]));
+
+  return list;
+}
+
+/**
+ * Queries the selected plugin for the available CAN interfaces
+ */
+void IO::Drivers::CANBus::refreshInterfaces()
+{
+  m_interfaces.clear();
+  const auto plugin = pluginName();
+  if (!plugin.isEmpty())
+  {
+    const auto devices = QCanBus::instance()->availableDevices(plugin);
+    for (const auto &device : devices)
+      m_interfaces.append(device.name());
+  }
+
+  const int last = qMax(0, m_interfaces.count() - 1);
+  m_interfaceIndex = qBound(0, m_interfaceIndex, last);
+  Q_EMIT interfaceListChanged();
+  Q_EMIT interfaceIndexChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Enables or disables CAN FD frames
+ */
+void IO::Drivers::CANBus::setCanFd(const bool enabled)
+{
+  if (m_canFd != enabled)
+  {
+    m_canFd = enabled;
+    m_settings.setValue("IO_CANBus_CanFd", enabled);
+    Q_EMIT canFdChanged();
+  }
+}
+
+/**
+ * Changes the nominal bitrate of the bus (in bits per second)
+ */
+void IO::Drivers::CANBus::setBitrate(const int bitrate)
+{
+  if (m_bitrate != bitrate && bitrate > 0)
+  {
+    m_bitrate = bitrate;
+    m_settings.setValue("IO_CANBus_Bitrate", bitrate);
+    Q_EMIT bitrateChanged();
+  }
+}
+
+/**
+ * Changes the Qt SerialBus plugin & lists its interfaces
+ */
+void IO::Drivers::CANBus::setPluginIndex(const int index)
+{
+  if (m_pluginIndex != index && index >= 0 && index < m_plugins.count())
+  {
+    m_pluginIndex = index;
+    m_settings.setValue("IO_CANBus_Plugin", pluginName());
+    Q_EMIT pluginIndexChanged();
+    refreshInterfaces();
+  }
+}
+
+/**
+ * Changes the identifier filter, see @c filter()
+ */
+void IO::Drivers::CANBus::setFilter(const QString &filter)
+{
+  if (m_filter != filter)
+  {
+    m_filter = filter;
+    m_settings.setValue("IO_CANBus_Filter", filter);
+    Q_EMIT filterChanged();
+  }
+}
+
+/**
+ * Changes the selected CAN interface
+ */
+void IO::Drivers::CANBus::setInterfaceIndex(const int index)
+{
+  if (m_interfaceIndex != index && index >= 0
+      && index < m_interfaces.count())
+  {
+    m_interfaceIndex = index;
+    m_settings.setValue("IO_CANBus_Interface", m_interfaces.at(index));
+    Q_EMIT interfaceIndexChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Converts all the frames pending in the device to binary records & hands
+ * them to the I/O manager in a single batch. Error & remote request frames
+ * carry no signals and are discarded.
+ */
+void IO::Drivers::CANBus::onFramesReceived()
+{
+  // Device was closed
+  if (!m_device)
+    return;
+
+  // Convert frames to records
+  QByteArray data;
+  QVector<QByteArray> records;
+  const auto frames = m_device->readAllFrames();
+  records.reserve(frames.count());
+  for (const auto &frame : frames)
+  {
+    if (!frame.isValid() || frame.frameType() != QCanBusFrame::DataFrame)
+      continue;
+
+    records.append(CAN_RECORD(frame));
+    data.append(records.last());
+  }
+
+  // Register the records
+  if (!records.isEmpty())
+    Manager::instance().processFrames(data, records, FrameQueue::timestamp());
+}
+
+/**
+ * Notifies the user about bus errors, the connection is closed if the
+ * error prevents receiving more frames.
+ */
+void IO::Drivers::CANBus::onErrorOccurred(QCanBusDevice::CanBusError error)
+{
+  // Transient errors, keep the connection open
+  if (error == QCanBusDevice::NoError
+      || error == QCanBusDevice::WriteError
+      || error == QCanBusDevice::TimeoutError)
+    return;
+
+  // Close the connection
+  const auto title = tr("CAN bus error");
+  const auto message = m_device ? m_device->errorString() : QString();
+  QTimer::singleShot(0, &Manager::instance(), [=] {
+    Manager::instance().connectionLost(title, message);
+  });
+}
+
+/**
+ * Returns the name of the selected Qt SerialBus plugin
+ */
+QString IO::Drivers::CANBus::pluginName() const
+{
+  if (m_pluginIndex >= 0 && m_pluginIndex < m_plugins.count())
+    return m_plugins.at(m_pluginIndex);
+
+  return QString();
+}
+
+/**
+ * Converts the identifier filter to the list of hardware/kernel filters that
+ * is given to the CAN device, invalid entries are ignored.
+ */
+QList<QCanBusDevice::Filter> IO::Drivers::CANBus::filters() const
+{
+  QList<QCanBusDevice::Filter> list;
+  const auto entries = m_filter.split(',', Qt::SkipEmptyParts);
+  for (const auto &entry : entries)
+  {
+    // Parse identifier & optional mask
+    bool idOk, maskOk = true;
+    const auto parts = entry.trimmed().split(':');
+    const auto id = parts.first().toUInt(&idOk, 16);
+    auto mask = MAX_CAN_ID;
+    if (parts.count() > 1)
+      mask = parts.at(1).toUInt(&maskOk, 16);
+
+    if (!idOk || !maskOk || id > MAX_CAN_ID)
+      continue;
+
+    // Register filter
+    QCanBusDevice::Filter filter;
+    filter.frameId = id;
+    filter.frameIdMask = mask & MAX_CAN_ID;
+    filter.type = QCanBusFrame::DataFrame;
+    filter.format = QCanBusDevice::Filter::MatchBaseAndExtendedFormat;
+    if (id > 0x7FF)
+      filter.format = QCanBusDevice::Filter::MatchExtendedFormat;
+    list.append(filter);
+  }
+
+  return list;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QCanBusDevice>
+
+#include <DataTypes.h>
+#include <IO/HAL_Driver.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The CANBus class
+ *
+ * Serial Studio "driver" class that receives frames from a CAN bus interface
+ * through the Qt SerialBus plugins (SocketCAN on Linux, PEAK-System, Vector,
+ * SysTec, TinyCAN, PassThru & virtual CAN interfaces), including CAN FD.
+ *
+ * CAN frames are already delimited by the bus, so they skip the frame reader
+ * and are handed to the I/O manager as frames. Each CAN frame is converted to
+ * a binary record with the following format:
+ *
+ * @code
+ * u32 identifier (little-endian) | u8 flags | u8 length | payload
+ * @endcode
+ *
+ * The records are meant to be decoded by a binary layout in which the fields
+ * declare the CAN identifier of their message (see @c JSON::BinaryDecoder),
+ * which can be generated by importing a DBC file in the project editor. No
+ * text conversion takes place, which allows handling several thousand frames
+ * per second on each bus.
+ *
+ * Data sent from the console is interpreted with the @c cansend syntax
+ * (e.g. @c 123#DEADBEEF or @c 1F334455#1122).
+ */
+class CANBus : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int pluginIndex
+               READ pluginIndex
+               WRITE setPluginIndex
+               NOTIFY pluginIndexChanged)
+    Q_PROPERTY(int interfaceIndex
+               READ interfaceIndex
+               WRITE setInterfaceIndex
+               NOTIFY interfaceIndexChanged)
+    Q_PROPERTY(int bitrate
+               READ bitrate
+               WRITE setBitrate
+               NOTIFY bitrateChanged)
+    Q_PROPERTY(bool canFd
+               READ canFd
+               WRITE setCanFd
+               NOTIFY canFdChanged)
+    Q_PROPERTY(QString filter
+               READ filter
+               WRITE setFilter
+               NOTIFY filterChanged)
+    Q_PROPERTY(StringList pluginList
+               READ pluginList
+               CONSTANT)
+    Q_PROPERTY(StringList interfaceList
+               READ interfaceList
+               NOTIFY interfaceListChanged)
+    Q_PROPERTY(StringList bitrateList
+               READ bitrateList
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void canFdChanged();
+  void filterChanged();
+  void bitrateChanged();
+  void pluginIndexChanged();
+  void interfaceListChanged();
+  void interfaceIndexChanged();
+
+private:
+  explicit CANBus();
+  CANBus(CANBus &&) = delete;
+  CANBus(const CANBus &) = delete;
+  CANBus &operator=(CANBus &&) = delete;
+  CANBus &operator=(const CANBus &) = delete;
+
+  ~CANBus();
+
+public:
+  static CANBus &instance();
+
+  enum RecordFlags
+  {
+    ExtendedFrame = 0x01,
+    FlexibleDataRate = 0x02,
+    BitrateSwitch = 0x04
+  };
+  Q_ENUM(RecordFlags)
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  int pluginIndex() const;
+  int interfaceIndex() const;
+  int bitrate() const;
+  bool canFd() const;
+  QString filter() const;
+
+  StringList pluginList() const;
+  StringList interfaceList() const;
+  StringList bitrateList() const;
+
+public Q_SLOTS:
+  void refreshInterfaces();
+  void setCanFd(const bool enabled);
+  void setBitrate(const int bitrate);
+  void setPluginIndex(const int index);
+  void setFilter(const QString &filter);
+  void setInterfaceIndex(const int index);
+
+private Q_SLOTS:
+  void onFramesReceived();
+  void onErrorOccurred(QCanBusDevice::CanBusError error);
+
+private:
+  QString pluginName() const;
+  QList<QCanBusDevice::Filter> filters() const;
+
+private:
+  int m_bitrate;
+  bool m_canFd;
+  int m_pluginIndex;
+  int m_interfaceIndex;
+  QString m_filter;
+  Misc::Settings m_settings;
+
+  QCanBusDevice *m_device;
+  StringList m_plugins;
+  StringList m_interfaces;
+};
+} // namespace Drivers
+} // namespace IO
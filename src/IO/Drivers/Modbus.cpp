@@ -0,0 +1,728 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtNumeric>
+#include <QSerialPort>
+#include <QSerialPortInfo>
+#include <QModbusReply>
+#include <QModbusTcpClient>
+#include <QModbusRtuSerialClient>
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/Drivers/Modbus.h>
+#include <JSON/Generator.h>
+#include <JSON/ProjectCache.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Parity settings offered to the user, the order matches @c parityList()
+ */
+static const QSerialPort::Parity PARITIES[]
+    = {QSerialPort::NoParity, QSerialPort::EvenParity, QSerialPort::OddParity};
+
+/**
+ * Limits of the configurable parameters
+ */
+static const int MIN_POLL_INTERVAL = 1;
+static const int MAX_PIPELINE_DEPTH = 32;
+
+/**
+ * Constructor function, restores the last configuration
+ */
+IO::Drivers::Modbus::Modbus()
+  : m_protocol(RTU)
+  , m_baudRate(9600)
+  , m_parity(0)
+  , m_port(502)
+  , m_pollInterval(100)
+  , m_timeout(200)
+  , m_maxGap(8)
+  , m_pipelineDepth(4)
+  , m_client(Q_NULLPTR)
+  , m_cycleActive(false)
+  , m_nextBlock(0)
+  , m_pendingReplies(0)
+  , m_overruns(0)
+  , m_cycleTimestamp(0)
+{
+  // Read settings
+  m_protocol = qBound(0, m_settings.value("IO_Modbus_Protocol", 0).toInt(),
+                      static_cast<int>(TCP));
+  m_serialPort = m_settings.value("IO_Modbus_SerialPort", "").toString();
+  m_baudRate = m_settings.value("IO_Modbus_BaudRate", 9600).toInt();
+  m_parity = qBound(0, m_settings.value("IO_Modbus_Parity", 0).toInt(), 2);
+  m_host = m_settings.value("IO_Modbus_Host", "127.0.0.1").toString();
+  m_port = m_settings.value("IO_Modbus_Port", 502).toInt();
+  m_pollInterval = m_settings.value("IO_Modbus_PollInterval", 100).toInt();
+  m_timeout = m_settings.value("IO_Modbus_Timeout", 200).toInt();
+  m_maxGap = m_settings.value("IO_Modbus_MaxGap", 8).toInt();
+  m_pipelineDepth = m_settings.value("IO_Modbus_PipelineDepth", 4).toInt();
+
+  // Configure poll timer
+  m_pollTimer.setTimerType(Qt::PreciseTimer);
+  connect(&m_pollTimer, &QTimer::timeout, this, &IO::Drivers::Modbus::poll);
+
+  // Get available serial ports
+  refreshSerialPorts();
+}
+
+/**
+ * Disconnects from the Modbus server
+ */
+IO::Drivers::Modbus::~Modbus()
+{
+  close();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::Modbus &IO::Drivers::Modbus::instance()
+{
+  static Modbus singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Stops polling & disconnects from the Modbus server. Pending replies are
+ * deleted together with the client.
+ */
+void IO::Drivers::Modbus::close()
+{
+  // Stop polling
+  m_pollTimer.stop();
+  m_cycleActive = false;
+  m_pendingReplies = 0;
+
+  // Delete the client
+  if (m_client)
+  {
+    disconnect(m_client);
+    m_client->disconnectDevice();
+    m_client->deleteLater();
+    m_client = Q_NULLPTR;
+  }
+}
+
+/**
+ * Returns @c true if the driver is connected (or connecting) to the server
+ */
+bool IO::Drivers::Modbus::isOpen() const
+{
+  return m_client && m_client->state() != QModbusDevice::UnconnectedState;
+}
+
+/**
+ * Returns @c true if the driver is connected to the server
+ */
+bool IO::Drivers::Modbus::isReadable() const
+{
+  return m_client && m_client->state() == QModbusDevice::ConnectedState;
+}
+
+/**
+ * Data cannot be written from the console, the driver only polls registers
+ */
+bool IO::Drivers::Modbus::isWritable() const
+{
+  return false;
+}
+
+/**
+ * Returns @c true if the serial port or the server address are set
+ */
+bool IO::Drivers::Modbus::configurationOk() const
+{
+  if (m_protocol == TCP)
+    return !m_host.isEmpty() && m_port > 0;
+
+  return !m_serialPort.isEmpty() && m_baudRate > 0;
+}
+
+/**
+ * Data written from the console is discarded, see @c isWritable()
+ */
+quint64 IO::Drivers::Modbus::write(const QByteArray &data)
+{
+  (void)data;
+  return 0;
+}
+
+/**
+ * Builds the poll plan from the current project & connects to the server,
+ * polling starts as soon as the connection is established.
+ */
+bool IO::Drivers::Modbus::open(const QIODevice::OpenMode mode)
+{
+  (void)mode;
+
+  // Close current connection
+  close();
+  if (!configurationOk())
+    return false;
+
+  // Build the poll plan from the current project
+  QString error;
+  const auto path = JSON::Generator::instance().jsonMapFilepath();
+  const auto project = JSON::ProjectCache::instance().load(path);
+  if (project && !m_scheduler.compile(project->frame, m_maxGap, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid Modbus register"), error);
+    return false;
+  }
+
+  // Nothing to poll
+  if (!project || m_scheduler.isEmpty())
+  {
+    Misc::Utilities::showMessageBox(
+        tr("No Modbus registers to poll"),
+        tr("Load a project in which the datasets define a Modbus register."));
+    return false;
+  }
+
+  // Create a serial line client
+  if (m_protocol == RTU)
+  {
+    m_client = new QModbusRtuSerialClient(this);
+    m_client->setConnectionParameter(QModbusDevice::SerialPortNameParameter,
+                                     m_serialPort);
+    m_client->setConnectionParameter(QModbusDevice::SerialBaudRateParameter,
+                                     m_baudRate);
+    m_client->setConnectionParameter(QModbusDevice::SerialParityParameter,
+                                     PARITIES[m_parity]);
+    m_client->setConnectionParameter(QModbusDevice::SerialDataBitsParameter,
+                                     QSerialPort::Data8);
+    m_client->setConnectionParameter(QModbusDevice::SerialStopBitsParameter,
+                                     QSerialPort::OneStop);
+  }
+
+  // Create a TCP client
+  else
+  {
+    m_client = new QModbusTcpClient(this);
+    m_client->setConnectionParameter(QModbusDevice::NetworkAddressParameter,
+                                     m_host);
+    m_client->setConnectionParameter(QModbusDevice::NetworkPortParameter,
+                                     m_port);
+  }
+
+  // Configure the client
+  m_client->setTimeout(m_timeout);
+  m_client->setNumberOfRetries(1);
+
+  // clang-format off
+  connect(m_client, &QModbusDevice::stateChanged,
+          this, &IO::Drivers::Modbus::onStateChanged);
+  connect(m_client, &QModbusDevice::errorOccurred,
+          this, &IO::Drivers::Modbus::onErrorOccurred);
+  // clang-format on
+
+  // Connect to the server
+  if (!m_client->connectDevice())
+  {
+    if (!Manager::instance().reconnecting())
+      Misc::Utilities::showMessageBox(tr("Cannot connect to Modbus server"),
+                                      m_client->errorString());
+    close();
+    return false;
+  }
+
+  // Update statistics
+  m_overruns = 0;
+  Q_EMIT statisticsChanged();
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the selected protocol, see @c protocolList()
+ */
+int IO::Drivers::Modbus::protocol() const
+{
+  return m_protocol;
+}
+
+/**
+ * Returns the name of the serial port used by Modbus RTU
+ */
+QString IO::Drivers::Modbus::serialPort() const
+{
+  return m_serialPort;
+}
+
+/**
+ * Returns the baud rate of the Modbus RTU line
+ */
+int IO::Drivers::Modbus::baudRate() const
+{
+  return m_baudRate;
+}
+
+/**
+ * Returns the parity of the Modbus RTU line, see @c parityList()
+ */
+int IO::Drivers::Modbus::parity() const
+{
+  return m_parity;
+}
+
+/**
+ * Returns the address of the Modbus TCP server
+ */
+QString IO::Drivers::Modbus::host() const
+{
+  return m_host;
+}
+
+/**
+ * Returns the TCP port of the Modbus TCP server
+ */
+int IO::Drivers::Modbus::port() const
+{
+  return m_port;
+}
+
+/**
+ * Returns the time between poll cycles (in milliseconds)
+ */
+int IO::Drivers::Modbus::pollInterval() const
+{
+  return m_pollInterval;
+}
+
+/**
+ * Returns the time (in milliseconds) that the driver waits for each reply
+ */
+int IO::Drivers::Modbus::timeout() const
+{
+  return m_timeout;
+}
+
+/**
+ * Returns the maximum number of unused registers that are read to merge two
+ * neighbouring registers into the same request.
+ */
+int IO::Drivers::Modbus::maxGap() const
+{
+  return m_maxGap;
+}
+
+/**
+ * Returns the maximum number of outstanding Modbus TCP requests
+ */
+int IO::Drivers::Modbus::pipelineDepth() const
+{
+  return m_pipelineDepth;
+}
+
+/**
+ * Returns the number of requests sent in each poll cycle
+ */
+int IO::Drivers::Modbus::requestCount() const
+{
+  return m_scheduler.blockCount();
+}
+
+/**
+ * Returns the number of registers polled in each cycle
+ */
+int IO::Drivers::Modbus::registerCount() const
+{
+  return m_scheduler.registerCount();
+}
+
+/**
+ * Returns the number of poll cycles skipped because the previous cycle had
+ * not finished, which means that the poll interval is too short for the
+ * number of requests & the speed of the link.
+ */
+int IO::Drivers::Modbus::overruns() const
+{
+  return m_overruns;
+}
+
+/**
+ * Returns the list of supported protocols
+ */
+StringList IO::Drivers::Modbus::protocolList() const
+{
+  StringList list;
+  list.append(tr("Modbus RTU (serial line)"));
+  list.append(tr("Modbus TCP"));
+  return list;
+}
+
+/**
+ * Returns the list of parity settings for Modbus RTU lines
+ */
+StringList IO::Drivers::Modbus::parityList() const
+{
+  StringList list;
+  list.append(tr("None"));
+  list.append(tr("Even"));
+  list.append(tr("Odd"));
+  return list;
+}
+
+/**
+ * Returns the names of the serial ports found in the system
+ */
+StringList IO::Drivers::Modbus::serialPortList() const
+{
+  return m_serialPorts;
+}
+
+/**
+ * Updates the list of serial ports found in the system
+ */
+void IO::Drivers::Modbus::refreshSerialPorts()
+{
+  StringList ports;
+  const auto infos = QSerialPortInfo::availablePorts();
+  for (const auto &info : infos)
+    ports.append(info.portName());
+
+  if (ports != m_serialPorts)
+  {
+    m_serialPorts = ports;
+    Q_EMIT serialPortListChanged();
+  }
+}
+
+/**
+ * Changes the TCP port of the Modbus TCP server
+ */
+void IO::Drivers::Modbus::setPort(const int port)
+{
+  if (m_port != port && port > 0 && port <= 65535)
+  {
+    m_port = port;
+    m_settings.setValue("IO_Modbus_Port", port);
+    Q_EMIT portChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the parity of the Modbus RTU line, see @c parityList()
+ */
+void IO::Drivers::Modbus::setParity(const int parity)
+{
+  const auto value = qBound(0, parity, 2);
+  if (m_parity != value)
+  {
+    m_parity = value;
+    m_settings.setValue("IO_Modbus_Parity", value);
+    Q_EMIT parityChanged();
+  }
+}
+
+/**
+ * Changes the maximum number of unused registers read to merge requests
+ */
+void IO::Drivers::Modbus::setMaxGap(const int registers)
+{
+  const auto value = qMax(0, registers);
+  if (m_maxGap != value)
+  {
+    m_maxGap = value;
+    m_settings.setValue("IO_Modbus_MaxGap", value);
+    Q_EMIT maxGapChanged();
+  }
+}
+
+/**
+ * Changes the time (in milliseconds) that the driver waits for each reply
+ */
+void IO::Drivers::Modbus::setTimeout(const int timeout)
+{
+  const auto value = qMax(1, timeout);
+  if (m_timeout != value)
+  {
+    m_timeout = value;
+    m_settings.setValue("IO_Modbus_Timeout", value);
+    if (m_client)
+      m_client->setTimeout(value);
+
+    Q_EMIT timeoutChanged();
+  }
+}
+
+/**
+ * Changes the baud rate of the Modbus RTU line
+ */
+void IO::Drivers::Modbus::setBaudRate(const int baudRate)
+{
+  if (m_baudRate != baudRate && baudRate > 0)
+  {
+    m_baudRate = baudRate;
+    m_settings.setValue("IO_Modbus_BaudRate", baudRate);
+    Q_EMIT baudRateChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the protocol used to reach the server, see @c protocolList()
+ */
+void IO::Drivers::Modbus::setProtocol(const int protocol)
+{
+  const auto value = qBound(0, protocol, static_cast<int>(TCP));
+  if (m_protocol != value)
+  {
+    m_protocol = value;
+    m_settings.setValue("IO_Modbus_Protocol", value);
+    Q_EMIT protocolChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the address of the Modbus TCP server
+ */
+void IO::Drivers::Modbus::setHost(const QString &host)
+{
+  if (m_host != host)
+  {
+    m_host = host;
+    m_settings.setValue("IO_Modbus_Host", host);
+    Q_EMIT hostChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the serial port used by Modbus RTU
+ */
+void IO::Drivers::Modbus::setSerialPort(const QString &name)
+{
+  if (m_serialPort != name)
+  {
+    m_serialPort = name;
+    m_settings.setValue("IO_Modbus_SerialPort", name);
+    Q_EMIT serialPortChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the time between poll cycles (in milliseconds)
+ */
+void IO::Drivers::Modbus::setPollInterval(const int interval)
+{
+  const auto value = qMax(MIN_POLL_INTERVAL, interval);
+  if (m_pollInterval != value)
+  {
+    m_pollInterval = value;
+    m_settings.setValue("IO_Modbus_PollInterval", value);
+    if (m_pollTimer.isActive())
+      m_pollTimer.start(value);
+
+    Q_EMIT pollIntervalChanged();
+  }
+}
+
+/**
+ * Changes the maximum number of outstanding Modbus TCP requests
+ */
+void IO::Drivers::Modbus::setPipelineDepth(const int depth)
+{
+  const auto value = qBound(1, depth, MAX_PIPELINE_DEPTH);
+  if (m_pipelineDepth != value)
+  {
+    m_pipelineDepth = value;
+    m_settings.setValue("IO_Modbus_PipelineDepth", value);
+    Q_EMIT pipelineDepthChanged();
+  }
+}
+
+/**
+ * Starts a poll cycle, unless the previous cycle is still running
+ */
+void IO::Drivers::Modbus::poll()
+{
+  // Connection not ready
+  if (!isReadable())
+    return;
+
+  // Previous cycle still running, skip this one
+  if (m_cycleActive)
+  {
+    ++m_overruns;
+    Q_EMIT statisticsChanged();
+    return;
+  }
+
+  // Start a new cycle
+  m_nextBlock = 0;
+  m_cycleActive = true;
+  m_pendingReplies = 0;
+  m_cycleTimestamp = FrameQueue::timestamp();
+  m_values.fill(qQNaN(), m_scheduler.fieldCount());
+  sendRequests();
+}
+
+/**
+ * Starts polling when the connection is established & closes the driver
+ * when the connection is lost.
+ */
+void IO::Drivers::Modbus::onStateChanged(QModbusDevice::State state)
+{
+  if (state == QModbusDevice::ConnectedState)
+  {
+    m_pollTimer.start(m_pollInterval);
+    poll();
+  }
+
+  else if (state == QModbusDevice::UnconnectedState)
+    QTimer::singleShot(0, &Manager::instance(),
+                       [] { Manager::instance().connectionLost(); });
+}
+
+/**
+ * Notifies the user about connection errors, errors of individual requests
+ * (e.g. timeouts or exception replies) only invalidate the affected values.
+ */
+void IO::Drivers::Modbus::onErrorOccurred(QModbusDevice::Error error)
+{
+  if (error != QModbusDevice::ConnectionError
+      && error != QModbusDevice::ConfigurationError)
+    return;
+
+  const auto title = tr("Modbus error");
+  const auto message = m_client ? m_client->errorString() : QString();
+  QTimer::singleShot(0, &Manager::instance(), [=] {
+    Manager::instance().connectionLost(title, message);
+  });
+}
+
+/**
+ * Sends the next requests of the current cycle, keeping up to
+ * @c pipelineDepth() requests in flight on TCP & a single request on RTU.
+ */
+void IO::Drivers::Modbus::sendRequests()
+{
+  const int depth = m_protocol == TCP ? m_pipelineDepth : 1;
+  while (m_client && m_pendingReplies < depth
+         && m_nextBlock < m_scheduler.blockCount())
+  {
+    // Get the Modbus table of the block
+    const int index = m_nextBlock++;
+    const auto &block = m_scheduler.block(index);
+    auto table = QModbusDataUnit::HoldingRegisters;
+    switch (block.table)
+    {
+      case ModbusScheduler::Table::Coils:
+        table = QModbusDataUnit::Coils;
+        break;
+      case ModbusScheduler::Table::DiscreteInputs:
+        table = QModbusDataUnit::DiscreteInputs;
+        break;
+      case ModbusScheduler::Table::InputRegisters:
+        table = QModbusDataUnit::InputRegisters;
+        break;
+      case ModbusScheduler::Table::HoldingRegisters:
+        table = QModbusDataUnit::HoldingRegisters;
+        break;
+    }
+
+    // Send the request, values of failed requests stay invalid
+    const QModbusDataUnit unit(table, block.address, block.count);
+    auto reply = m_client->sendReadRequest(unit, block.unit);
+    if (!reply)
+      continue;
+
+    // Broadcast requests finish immediately
+    if (reply->isFinished())
+    {
+      reply->deleteLater();
+      continue;
+    }
+
+    // Wait for the reply
+    ++m_pendingReplies;
+    connect(reply, &QModbusReply::finished, this,
+            [=] { onReplyFinished(reply, index); });
+  }
+
+  // All the requests of the cycle have been answered
+  if (m_cycleActive && m_pendingReplies == 0
+      && m_nextBlock >= m_scheduler.blockCount())
+    publishCycle();
+}
+
+/**
+ * Joins the values obtained in the current cycle into a frame & hands it to
+ * the I/O manager. Registers that could not be read produce empty fields, so
+ * that the datasets show their default value.
+ */
+void IO::Drivers::Modbus::publishCycle()
+{
+  // Build the frame
+  QByteArray frame;
+  const auto separator = Manager::instance().separatorSequence().toUtf8();
+  for (int i = 0; i < m_values.count(); ++i)
+  {
+    if (i > 0)
+      frame.append(separator);
+
+    const auto value = m_values.at(i);
+    if (!qIsNaN(value))
+      frame.append(QByteArray::number(value, 'g', 10));
+  }
+
+  // Publish the frame, data shown in the console is separated by new lines
+  m_cycleActive = false;
+  QVector<QByteArray> frames;
+  frames.append(frame);
+  Manager::instance().processFrames(frame + '\n', frames, m_cycleTimestamp);
+}
+
+/**
+ * Decodes the values of the given @a reply & continues the current cycle
+ */
+void IO::Drivers::Modbus::onReplyFinished(QModbusReply *reply, const int block)
+{
+  // Reply belongs to a previous connection
+  reply->deleteLater();
+  if (!m_client || reply->parent() != m_client)
+    return;
+
+  // Decode the registers of the block
+  if (reply->error() == QModbusDevice::NoError)
+    m_scheduler.decode(block, reply->result().values(), m_values);
+
+  // Continue the cycle
+  if (m_pendingReplies > 0)
+  {
+    --m_pendingReplies;
+    sendRequests();
+  }
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QModbusClient>
+
+#include <DataTypes.h>
+#include <IO/HAL_Driver.h>
+#include <IO/ModbusScheduler.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The Modbus class
+ *
+ * Serial Studio "driver" class that polls Modbus RTU (serial line) or Modbus
+ * TCP servers through the Qt SerialBus module.
+ *
+ * The registers to poll are obtained from the @c modbus key of the datasets
+ * of the current project (see @c IO::ModbusScheduler), which coalesces them
+ * into as few read requests as possible. Each poll cycle reads every block &
+ * produces a frame in which the value of each register is stored in the
+ * field of its dataset, separated with the separator sequence of the
+ * project, so that the frame is handled by the native frame splitter.
+ *
+ * RTU lines can only carry one request at a time, while TCP requests are
+ * pipelined: up to @c pipelineDepth() requests are sent before waiting for
+ * the first reply. If a poll cycle has not finished when the next one is
+ * due, the next cycle is skipped & counted as an overrun.
+ */
+class Modbus : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int protocol
+               READ protocol
+               WRITE setProtocol
+               NOTIFY protocolChanged)
+    Q_PROPERTY(QString serialPort
+               READ serialPort
+               WRITE setSerialPort
+               NOTIFY serialPortChanged)
+    Q_PROPERTY(int baudRate
+               READ baudRate
+               WRITE setBaudRate
+               NOTIFY baudRateChanged)
+    Q_PROPERTY(int parity
+               READ parity
+               WRITE setParity
+               NOTIFY parityChanged)
+    Q_PROPERTY(QString host
+               READ host
+               WRITE setHost
+               NOTIFY hostChanged)
+    Q_PROPERTY(int port
+               READ port
+               WRITE setPort
+               NOTIFY portChanged)
+    Q_PROPERTY(int pollInterval
+               READ pollInterval
+               WRITE setPollInterval
+               NOTIFY pollIntervalChanged)
+    Q_PROPERTY(int timeout
+               READ timeout
+               WRITE setTimeout
+               NOTIFY timeoutChanged)
+    Q_PROPERTY(int maxGap
+               READ maxGap
+               WRITE setMaxGap
+               NOTIFY maxGapChanged)
+    Q_PROPERTY(int pipelineDepth
+               READ pipelineDepth
+               WRITE setPipelineDepth
+               NOTIFY pipelineDepthChanged)
+    Q_PROPERTY(int requestCount
+               READ requestCount
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(int registerCount
+               READ registerCount
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(int overruns
+               READ overruns
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(StringList protocolList
+               READ protocolList
+               CONSTANT)
+    Q_PROPERTY(StringList parityList
+               READ parityList
+               CONSTANT)
+    Q_PROPERTY(StringList serialPortList
+               READ serialPortList
+               NOTIFY serialPortListChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void portChanged();
+  void hostChanged();
+  void parityChanged();
+  void maxGapChanged();
+  void timeoutChanged();
+  void baudRateChanged();
+  void protocolChanged();
+  void serialPortChanged();
+  void statisticsChanged();
+  void pollIntervalChanged();
+  void pipelineDepthChanged();
+  void serialPortListChanged();
+
+private:
+  explicit Modbus();
+  Modbus(Modbus &&) = delete;
+  Modbus(const Modbus &) = delete;
+  Modbus &operator=(Modbus &&) = delete;
+  Modbus &operator=(const Modbus &) = delete;
+
+  ~Modbus();
+
+public:
+  static Modbus &instance();
+
+  enum Protocol
+  {
+    RTU = 0,
+    TCP = 1
+  };
+  Q_ENUM(Protocol)
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  int protocol() const;
+  QString serialPort() const;
+  int baudRate() const;
+  int parity() const;
+  QString host() const;
+  int port() const;
+  int pollInterval() const;
+  int timeout() const;
+  int maxGap() const;
+  int pipelineDepth() const;
+
+  int requestCount() const;
+  int registerCount() const;
+  int overruns() const;
+
+  StringList protocolList() const;
+  StringList parityList() const;
+  StringList serialPortList() const;
+
+public Q_SLOTS:
+  void refreshSerialPorts();
+  void setPort(const int port);
+  void setParity(const int parity);
+  void setMaxGap(const int registers);
+  void setTimeout(const int timeout);
+  void setBaudRate(const int baudRate);
+  void setProtocol(const int protocol);
+  void setHost(const QString &host);
+  void setSerialPort(const QString &name);
+  void setPollInterval(const int interval);
+  void setPipelineDepth(const int depth);
+
+private Q_SLOTS:
+  void poll();
+  void onStateChanged(QModbusDevice::State state);
+  void onErrorOccurred(QModbusDevice::Error error);
+
+private:
+  void sendRequests();
+  void publishCycle();
+  void onReplyFinished(QModbusReply *reply, const int block);
+
+private:
+  int m_protocol;
+  QString m_serialPort;
+  int m_baudRate;
+  int m_parity;
+  QString m_host;
+  int m_port;
+  int m_pollInterval;
+  int m_timeout;
+  int m_maxGap;
+  int m_pipelineDepth;
+  Misc::Settings m_settings;
+
+  QTimer m_pollTimer;
+  QModbusClient *m_client;
+  ModbusScheduler m_scheduler;
+  StringList m_serialPorts;
+
+  bool m_cycleActive;
+  int m_nextBlock;
+  int m_pendingReplies;
+  int m_overruns;
+  qint64 m_cycleTimestamp;
+  QVector<double> m_values;
+};
+} // namespace Drivers
+} // namespace IO
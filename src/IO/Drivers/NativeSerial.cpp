@@ -0,0 +1,701 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cerrno>
+
+#include <IO/FrameQueue.h>
+#include <IO/Drivers/NativeSerial.h>
+
+#if defined(Q_OS_WIN)
+#  include <windows.h>
+#else
+#  include <poll.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <termios.h>
+#  include <sys/ioctl.h>
+#endif
+
+#if defined(Q_OS_MACOS)
+#  include <IOKit/serial/ioss.h>
+#endif
+
+/**
+ * Maximum number of bytes obtained with a single read, large enough to hold
+ * more than 100 ms of data at 12 Mbaud
+ */
+static const int READ_SIZE = 2 * 1024 * 1024;
+
+/**
+ * Time (in milliseconds) that the reader waits for data before checking if it
+ * must stop, also the maximum time that a write waits for the device.
+ */
+static const int POLL_INTERVAL = 100;
+
+#if defined(Q_OS_LINUX)
+/**
+ * Kernel version of the termios structure, which stores arbitrary baud rates
+ * (the C library only supports the predefined @c Bxxx rates). The ioctl
+ * numbers & the @c BOTHER flag are the ones used by x86, ARM & RISC-V.
+ */
+struct KernelTermios
+{
+  tcflag_t c_iflag;
+  tcflag_t c_oflag;
+  tcflag_t c_cflag;
+  tcflag_t c_lflag;
+  cc_t c_line;
+  cc_t c_cc[19];
+  speed_t c_ispeed;
+  speed_t c_ospeed;
+};
+
+static const unsigned long TCGETS_KERNEL = _IOR('T', 0x2A, KernelTermios);
+static const unsigned long TCSETS_KERNEL = _IOW('T', 0x2B, KernelTermios);
+static const tcflag_t BAUD_OTHER = 0010000;
+#endif
+
+#if !defined(Q_OS_WIN)
+/**
+ * Returns the predefined termios constant for the given baud @a rate, or
+ * @c B0 if the rate is not one of the standard rates.
+ */
+static speed_t STANDARD_SPEED(const qint32 rate)
+{
+  switch (rate)
+  {
+    case 1200:
+      return B1200;
+    case 2400:
+      return B2400;
+    case 4800:
+      return B4800;
+    case 9600:
+      return B9600;
+    case 19200:
+      return B19200;
+    case 38400:
+      return B38400;
+    case 57600:
+      return B57600;
+    case 115200:
+      return B115200;
+    case 230400:
+      return B230400;
+    default:
+      return B0;
+  }
+}
+#endif
+
+//----------------------------------------------------------------------------------------
+// Reader implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::NativeSerialReader::NativeSerialReader()
+  : m_running(false)
+{
+}
+
+/**
+ * Arms the read loop, called by the backend before queueing @c run(), so
+ * that a @c stop() issued before the loop starts is not lost.
+ */
+void IO::Drivers::NativeSerialReader::start()
+{
+  m_running = true;
+}
+
+/**
+ * Stops the read loop, this function can be called from any thread
+ */
+void IO::Drivers::NativeSerialReader::stop()
+{
+  m_running = false;
+}
+
+/**
+ * Reads the serial port with the given native @a handle until @c stop() is
+ * called or the device reports an error (e.g. it was unplugged).
+ *
+ * Data is read into a single buffer that is allocated once & never emitted,
+ * each chunk is copied into a byte array of its exact size, so that queued
+ * chunks do not keep the capacity of the read buffer alive.
+ */
+void IO::Drivers::NativeSerialReader::run(const qintptr handle)
+{
+  QByteArray buffer(READ_SIZE, Qt::Uninitialized);
+
+#if defined(Q_OS_WIN)
+  // Create the event signaled when each overlapped read completes
+  OVERLAPPED overlapped;
+  ZeroMemory(&overlapped, sizeof(overlapped));
+  overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+  auto port = reinterpret_cast<HANDLE>(handle);
+
+  while (m_running)
+  {
+    // Start the read, it completes as soon as any byte is received or when
+    // the read timeout of the port expires
+    DWORD bytes = 0;
+    ResetEvent(overlapped.hEvent);
+    if (!ReadFile(port, buffer.data(), READ_SIZE, &bytes, &overlapped))
+    {
+      if (GetLastError() != ERROR_IO_PENDING
+          || !GetOverlappedResult(port, &overlapped, &bytes, TRUE))
+        break;
+    }
+
+    // Hand over received data
+    if (bytes > 0)
+    {
+      const QByteArray data(buffer.constData(), static_cast<int>(bytes));
+      Q_EMIT dataReceived(data, IO::FrameQueue::timestamp());
+    }
+  }
+
+  CloseHandle(overlapped.hEvent);
+#else
+  const int fd = static_cast<int>(handle);
+  while (m_running)
+  {
+    // Wait for data
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    const int ready = poll(&pfd, 1, POLL_INTERVAL);
+    if (ready == 0 || (ready < 0 && errno == EINTR))
+      continue;
+
+    // Device removed or closed
+    if (ready < 0 || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)))
+      break;
+
+    // Read as much data as possible
+    const auto bytes = ::read(fd, buffer.data(), READ_SIZE);
+    if (bytes > 0)
+    {
+      const QByteArray data(buffer.constData(), static_cast<int>(bytes));
+      Q_EMIT dataReceived(data, IO::FrameQueue::timestamp());
+      continue;
+    }
+
+    // Interrupted or no data available yet
+    if (bytes < 0 && (errno == EINTR || errno == EAGAIN))
+      continue;
+
+    // The device was readable but returned no data, it was disconnected
+    break;
+  }
+#endif
+
+  // Notify the backend if the read loop ended because of an error
+  if (m_running)
+  {
+    m_running = false;
+    Q_EMIT finished();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// Backend implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, starts the reader thread
+ */
+IO::Drivers::NativeSerial::NativeSerial()
+  : m_handle(-1)
+  , m_mode(QIODevice::NotOpen)
+  , m_baudRate(9600)
+  , m_parity(QSerialPort::NoParity)
+  , m_dataBits(QSerialPort::Data8)
+  , m_stopBits(QSerialPort::OneStop)
+  , m_flowControl(QSerialPort::NoFlowControl)
+  , m_reader(new NativeSerialReader())
+{
+  m_thread.setObjectName(QStringLiteral("IO::Drivers::NativeSerialReader"));
+  m_reader->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_reader, &QObject::deleteLater);
+  connect(m_reader, &NativeSerialReader::dataReceived, this,
+          &NativeSerial::dataReceived);
+  connect(m_reader, &NativeSerialReader::finished, this,
+          &NativeSerial::onFinished);
+  m_thread.start(QThread::TimeCriticalPriority);
+}
+
+/**
+ * Closes the port & stops the reader thread
+ */
+IO::Drivers::NativeSerial::~NativeSerial()
+{
+  close();
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns @c true if the serial port is open
+ */
+bool IO::Drivers::NativeSerial::isOpen() const
+{
+  return m_handle != -1;
+}
+
+/**
+ * Returns @c true if the serial port was opened with read access
+ */
+bool IO::Drivers::NativeSerial::isReadable() const
+{
+  return isOpen() && (m_mode & QIODevice::ReadOnly);
+}
+
+/**
+ * Returns @c true if the serial port was opened with write access
+ */
+bool IO::Drivers::NativeSerial::isWritable() const
+{
+  return isOpen() && (m_mode & QIODevice::WriteOnly);
+}
+
+/**
+ * Returns the native handle of the serial port (a file descriptor on Unix,
+ * a @c HANDLE on Windows), or -1 if the port is not open.
+ */
+qintptr IO::Drivers::NativeSerial::handle() const
+{
+  return m_handle;
+}
+
+/**
+ * Returns the name of the open serial port
+ */
+QString IO::Drivers::NativeSerial::portName() const
+{
+  return m_portName;
+}
+
+/**
+ * Returns the number of bytes in the output queue of the serial driver
+ */
+qint64 IO::Drivers::NativeSerial::bytesToWrite() const
+{
+  if (!isOpen())
+    return 0;
+
+#if defined(Q_OS_WIN)
+  COMSTAT status;
+  DWORD errors = 0;
+  if (ClearCommError(reinterpret_cast<HANDLE>(m_handle), &errors, &status))
+    return status.cbOutQue;
+#else
+  int bytes = 0;
+  if (ioctl(static_cast<int>(m_handle), TIOCOUTQ, &bytes) == 0)
+    return bytes;
+#endif
+
+  return 0;
+}
+
+/**
+ * Returns @c false if hardware flow control is enabled & the device has
+ * de-asserted the CTS line
+ */
+bool IO::Drivers::NativeSerial::clearToSend() const
+{
+  if (!isOpen() || m_flowControl != QSerialPort::HardwareControl)
+    return true;
+
+#if defined(Q_OS_WIN)
+  DWORD status = 0;
+  if (GetCommModemStatus(reinterpret_cast<HANDLE>(m_handle), &status))
+    return status & MS_CTS_ON;
+#else
+  int status = 0;
+  if (ioctl(static_cast<int>(m_handle), TIOCMGET, &status) == 0)
+    return status & TIOCM_CTS;
+#endif
+
+  return true;
+}
+
+/**
+ * Opens the serial port described by @a info with the given @a mode, applies
+ * the line configuration set with @c configure() & starts reading the port.
+ * Returns @c false if the port cannot be opened or configured.
+ */
+bool IO::Drivers::NativeSerial::open(const QSerialPortInfo &info,
+                                     const QIODevice::OpenMode mode)
+{
+  // Close previous port
+  close();
+
+  // Open the device
+  const auto path = info.systemLocation();
+#if defined(Q_OS_WIN)
+  DWORD access = 0;
+  if (mode & QIODevice::ReadOnly)
+    access |= GENERIC_READ;
+  if (mode & QIODevice::WriteOnly)
+    access |= GENERIC_WRITE;
+
+  auto port = CreateFileW(reinterpret_cast<const wchar_t *>(path.utf16()),
+                          access, 0, NULL, OPEN_EXISTING,
+                          FILE_FLAG_OVERLAPPED, NULL);
+  if (port == INVALID_HANDLE_VALUE)
+    return false;
+
+  m_handle = reinterpret_cast<qintptr>(port);
+#else
+  int flags = O_NOCTTY | O_NONBLOCK;
+  if ((mode & QIODevice::ReadWrite) == QIODevice::ReadWrite)
+    flags |= O_RDWR;
+  else if (mode & QIODevice::WriteOnly)
+    flags |= O_WRONLY;
+  else
+    flags |= O_RDONLY;
+
+  const int fd = ::open(path.toLocal8Bit().constData(), flags);
+  if (fd < 0)
+    return false;
+
+  // Prevent other processes from opening the port
+  ioctl(fd, TIOCEXCL);
+  m_handle = fd;
+#endif
+
+  // Configure the port
+  m_mode = mode;
+  m_portName = info.portName();
+  if (!applyConfiguration())
+  {
+    close();
+    return false;
+  }
+
+  // Start reading
+  if (mode & QIODevice::ReadOnly)
+  {
+    auto reader = m_reader;
+    const auto handle = m_handle;
+    reader->start();
+    QMetaObject::invokeMethod(reader, [=] { reader->run(handle); });
+  }
+
+  return true;
+}
+
+/**
+ * Stops reading & closes the serial port. The reader thread is given the
+ * chance to finish its current read before the port is closed.
+ */
+void IO::Drivers::NativeSerial::close()
+{
+  if (!isOpen())
+    return;
+
+  // Wait until the reader leaves the read loop
+  auto reader = m_reader;
+  reader->stop();
+#if defined(Q_OS_WIN)
+  CancelIoEx(reinterpret_cast<HANDLE>(m_handle), NULL);
+#endif
+  QMetaObject::invokeMethod(
+      reader, [] {}, Qt::BlockingQueuedConnection);
+
+  // Close the port
+#if defined(Q_OS_WIN)
+  CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+#else
+  ioctl(static_cast<int>(m_handle), TIOCNXCL);
+  ::close(static_cast<int>(m_handle));
+#endif
+
+  m_handle = -1;
+  m_portName.clear();
+  m_mode = QIODevice::NotOpen;
+}
+
+/**
+ * Writes the given @a data to the serial port, waiting until the serial
+ * driver accepts it. Returns the number of written bytes or -1 on error.
+ */
+qint64 IO::Drivers::NativeSerial::write(const QByteArray &data)
+{
+  if (!isWritable())
+    return -1;
+
+#if defined(Q_OS_WIN)
+  // Start the write & wait until it completes
+  OVERLAPPED overlapped;
+  ZeroMemory(&overlapped, sizeof(overlapped));
+  overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+  DWORD bytes = 0;
+  auto port = reinterpret_cast<HANDLE>(m_handle);
+  if (!WriteFile(port, data.constData(), static_cast<DWORD>(data.size()),
+                 &bytes, &overlapped))
+  {
+    if (GetLastError() != ERROR_IO_PENDING
+        || !GetOverlappedResult(port, &overlapped, &bytes, TRUE))
+    {
+      CloseHandle(overlapped.hEvent);
+      return -1;
+    }
+  }
+
+  CloseHandle(overlapped.hEvent);
+  return bytes;
+#else
+  // Write the data, waiting for the driver when its buffer is full
+  qint64 written = 0;
+  const int fd = static_cast<int>(m_handle);
+  while (written < data.size())
+  {
+    const auto bytes = ::write(fd, data.constData() + written,
+                               static_cast<size_t>(data.size() - written));
+    if (bytes > 0)
+    {
+      written += bytes;
+      continue;
+    }
+
+    // Give up if the device does not accept more data
+    if (bytes < 0 && (errno == EAGAIN || errno == EINTR))
+    {
+      struct pollfd pfd;
+      pfd.fd = fd;
+      pfd.events = POLLOUT;
+      pfd.revents = 0;
+      if (poll(&pfd, 1, POLL_INTERVAL) > 0)
+        continue;
+    }
+
+    break;
+  }
+
+  return written > 0 ? written : -1;
+#endif
+}
+
+/**
+ * Changes the line configuration of the serial port, the configuration is
+ * applied immediately if the port is open. Returns @c false if the serial
+ * driver rejects the configuration.
+ */
+bool IO::Drivers::NativeSerial::configure(
+    const qint32 baudRate, const QSerialPort::DataBits dataBits,
+    const QSerialPort::Parity parity, const QSerialPort::StopBits stopBits,
+    const QSerialPort::FlowControl flowControl)
+{
+  m_parity = parity;
+  m_baudRate = baudRate;
+  m_dataBits = dataBits;
+  m_stopBits = stopBits;
+  m_flowControl = flowControl;
+
+  if (isOpen())
+    return applyConfiguration();
+
+  return true;
+}
+
+/**
+ * Notifies the driver that the port was closed by the device
+ */
+void IO::Drivers::NativeSerial::onFinished()
+{
+  if (isOpen())
+    Q_EMIT errorOccurred();
+}
+
+/**
+ * Applies the line configuration to the open serial port. The port is set to
+ * raw mode, reads return as soon as any byte is available.
+ */
+bool IO::Drivers::NativeSerial::applyConfiguration()
+{
+#if defined(Q_OS_WIN)
+  auto port = reinterpret_cast<HANDLE>(m_handle);
+
+  // Use large driver buffers
+  SetupComm(port, READ_SIZE, READ_SIZE);
+
+  // Configure the line
+  DCB dcb;
+  ZeroMemory(&dcb, sizeof(dcb));
+  dcb.DCBlength = sizeof(dcb);
+  if (!GetCommState(port, &dcb))
+    return false;
+
+  dcb.fBinary = TRUE;
+  dcb.fNull = FALSE;
+  dcb.fAbortOnError = FALSE;
+  dcb.BaudRate = static_cast<DWORD>(m_baudRate);
+  dcb.ByteSize = static_cast<BYTE>(m_dataBits);
+  dcb.fDtrControl = DTR_CONTROL_ENABLE;
+
+  switch (m_parity)
+  {
+    case QSerialPort::EvenParity:
+      dcb.Parity = EVENPARITY;
+      break;
+    case QSerialPort::OddParity:
+      dcb.Parity = ODDPARITY;
+      break;
+    case QSerialPort::SpaceParity:
+      dcb.Parity = SPACEPARITY;
+      break;
+    case QSerialPort::MarkParity:
+      dcb.Parity = MARKPARITY;
+      break;
+    default:
+      dcb.Parity = NOPARITY;
+      break;
+  }
+
+  dcb.fParity = dcb.Parity != NOPARITY;
+
+  switch (m_stopBits)
+  {
+    case QSerialPort::OneAndHalfStop:
+      dcb.StopBits = ONE5STOPBITS;
+      break;
+    case QSerialPort::TwoStop:
+      dcb.StopBits = TWOSTOPBITS;
+      break;
+    default:
+      dcb.StopBits = ONESTOPBIT;
+      break;
+  }
+
+  const bool hardware = m_flowControl == QSerialPort::HardwareControl;
+  const bool software = m_flowControl == QSerialPort::SoftwareControl;
+  dcb.fOutxCtsFlow = hardware;
+  dcb.fRtsControl = hardware ? RTS_CONTROL_HANDSHAKE : RTS_CONTROL_ENABLE;
+  dcb.fOutX = software;
+  dcb.fInX = software;
+  if (!SetCommState(port, &dcb))
+    return false;
+
+  // Return from reads as soon as any byte is received, or after the poll
+  // interval if no data arrives
+  COMMTIMEOUTS timeouts;
+  ZeroMemory(&timeouts, sizeof(timeouts));
+  timeouts.ReadIntervalTimeout = MAXDWORD;
+  timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+  timeouts.ReadTotalTimeoutConstant = POLL_INTERVAL;
+  return SetCommTimeouts(port, &timeouts);
+#else
+  const int fd = static_cast<int>(m_handle);
+
+  // Configure raw mode
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0)
+    return false;
+
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+
+  // Data bits
+  tio.c_cflag &= ~CSIZE;
+  switch (m_dataBits)
+  {
+    case QSerialPort::Data5:
+      tio.c_cflag |= CS5;
+      break;
+    case QSerialPort::Data6:
+      tio.c_cflag |= CS6;
+      break;
+    case QSerialPort::Data7:
+      tio.c_cflag |= CS7;
+      break;
+    default:
+      tio.c_cflag |= CS8;
+      break;
+  }
+
+  // Parity (mark & space parity are not supported by termios)
+  tio.c_cflag &= ~(PARENB | PARODD);
+  if (m_parity == QSerialPort::EvenParity)
+    tio.c_cflag |= PARENB;
+  else if (m_parity == QSerialPort::OddParity)
+    tio.c_cflag |= PARENB | PARODD;
+
+  // Stop bits
+  if (m_stopBits == QSerialPort::TwoStop)
+    tio.c_cflag |= CSTOPB;
+  else
+    tio.c_cflag &= ~CSTOPB;
+
+  // Flow control
+  tio.c_cflag &= ~CRTSCTS;
+  tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+  if (m_flowControl == QSerialPort::HardwareControl)
+    tio.c_cflag |= CRTSCTS;
+  else if (m_flowControl == QSerialPort::SoftwareControl)
+    tio.c_iflag |= IXON | IXOFF;
+
+  // Standard baud rates
+  const auto speed = STANDARD_SPEED(m_baudRate);
+  if (speed != B0)
+  {
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+  }
+
+  if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    return false;
+
+  // Arbitrary baud rates
+  if (speed == B0)
+  {
+#  if defined(Q_OS_LINUX)
+    KernelTermios ktio;
+    if (ioctl(fd, TCGETS_KERNEL, &ktio) != 0)
+      return false;
+
+    ktio.c_cflag &= ~CBAUD;
+    ktio.c_cflag |= BAUD_OTHER;
+    ktio.c_ispeed = static_cast<speed_t>(m_baudRate);
+    ktio.c_ospeed = static_cast<speed_t>(m_baudRate);
+    if (ioctl(fd, TCSETS_KERNEL, &ktio) != 0)
+      return false;
+#  elif defined(Q_OS_MACOS)
+    speed_t rate = static_cast<speed_t>(m_baudRate);
+    if (ioctl(fd, IOSSIOSPEED, &rate) != 0)
+      return false;
+#  else
+    return false;
+#  endif
+  }
+
+  tcflush(fd, TCIOFLUSH);
+  return true;
+#endif
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QThread>
+#include <QObject>
+#include <QtSerialPort>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The NativeSerialReader class
+ *
+ * Worker object of the @c NativeSerial backend, reads the serial port from
+ * its own thread with large blocking reads (@c poll() & @c read() on Unix,
+ * overlapped @c ReadFile() on Windows), so that data is delivered in as few
+ * chunks as possible & no event loop notification is needed for each read.
+ *
+ * Each read waits at most for a short timeout, so that the thread can be
+ * stopped at any time.
+ */
+class NativeSerialReader : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void finished();
+  void dataReceived(const QByteArray &data, const qint64 timestamp);
+
+public:
+  NativeSerialReader();
+
+  void start();
+  void stop();
+
+public Q_SLOTS:
+  void run(const qintptr handle);
+
+private:
+  std::atomic<bool> m_running;
+};
+
+/**
+ * @brief The NativeSerial class
+ *
+ * Optional serial port backend of the @c Serial driver for high baud rates
+ * (e.g. 12 Mbaud USB-UART bridges), where the readiness notifications &
+ * buffer copies of @c QSerialPort cost too much latency & CPU time.
+ *
+ * The port is opened & configured with the native API of the operating
+ * system (termios on Unix, with arbitrary baud rates on Linux & macOS, and
+ * the DCB & COMMTIMEOUTS structures on Windows) and is read by a
+ * @c NativeSerialReader in a dedicated thread. Data is written synchronously
+ * by the thread that calls @c write().
+ */
+class NativeSerial : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void errorOccurred();
+  void dataReceived(const QByteArray &data, const qint64 timestamp);
+
+public:
+  NativeSerial();
+  ~NativeSerial();
+
+  bool isOpen() const;
+  bool isReadable() const;
+  bool isWritable() const;
+  qintptr handle() const;
+  QString portName() const;
+
+  qint64 bytesToWrite() const;
+  bool clearToSend() const;
+
+  bool open(const QSerialPortInfo &info, const QIODevice::OpenMode mode);
+  void close();
+  qint64 write(const QByteArray &data);
+
+  bool configure(const qint32 baudRate, const QSerialPort::DataBits dataBits,
+                 const QSerialPort::Parity parity,
+                 const QSerialPort::StopBits stopBits,
+                 const QSerialPort::FlowControl flowControl);
+
+private Q_SLOTS:
+  void onFinished();
+
+private:
+  bool applyConfiguration();
+
+private:
+  qintptr m_handle;
+  QString m_portName;
+  QIODevice::OpenMode m_mode;
+
+  qint32 m_baudRate;
+  QSerialPort::Parity m_parity;
+  QSerialPort::DataBits m_dataBits;
+  QSerialPort::StopBits m_stopBits;
+  QSerialPort::FlowControl m_flowControl;
+
+  QThread m_thread;
+  NativeSerialReader *m_reader;
+};
+} // namespace Drivers
+} // namespace IO
@@ -21,10 +21,75 @@
  */
 
 #include <IO/Manager.h>
+#include <IO/HostCache.h>
 #include <IO/Drivers/Network.h>
 
 #include <Misc/Utilities.h>
 
+#include <QNetworkDatagram>
+
+#if defined(Q_OS_LINUX)
+#  include <cstring>
+#  include <sys/uio.h>
+#  include <sys/socket.h>
+#endif
+
+/**
+ * Largest possible UDP datagram, each slot of the datagram buffer can hold
+ * one datagram of this size.
+ */
+static const int UDP_MAX_DATAGRAM_SIZE = 65536;
+
+/**
+ * Maximum number of bytes read during a single socket notification, so that
+ * a flood of datagrams does not block the event loop.
+ */
+static const int UDP_MAX_READ_SIZE = 4 * 1024 * 1024;
+
+/**
+ * Number of datagrams read with a single system call
+ */
+#if defined(Q_OS_LINUX)
+static const int UDP_BATCH_SIZE = 32;
+#else
+static const int UDP_BATCH_SIZE = 1;
+#endif
+
+/**
+ * Obtains the multicast group address & port from the given @a entry, which
+ * can be written as "address:port", "[IPv6 address]:port" or "address" (in
+ * which case the @a defaultPort is used).
+ *
+ * @returns @c true if the entry is a valid multicast group & port
+ */
+static bool PARSE_GROUP(const QString &entry, const quint16 defaultPort,
+                        QHostAddress *address, quint16 *port)
+{
+  // Initialize parameters
+  auto text = entry.trimmed();
+  auto host = text;
+  auto portText = QString();
+
+  // Split address & port
+  if (text.startsWith('['))
+  {
+    const int close = text.indexOf(']');
+    host = text.mid(1, close - 1);
+    if (close > 0 && text.mid(close + 1).startsWith(':'))
+      portText = text.mid(close + 2);
+  }
+  else if (text.count(':') == 1)
+  {
+    host = text.section(':', 0, 0);
+    portText = text.section(':', 1, 1);
+  }
+
+  // Validate the results
+  *port = portText.isEmpty() ? defaultPort : portText.toUShort();
+  address->setAddress(host);
+  return address->isMulticast() && *port > 0;
+}
+
 //----------------------------------------------------------------------------------------
 // Constructor & singleton access functions
 //----------------------------------------------------------------------------------------
@@ -35,8 +100,10 @@
 IO::Drivers::Network::Network()
   : m_hostExists(false)
   , m_udpMulticast(false)
+  , m_tcpServer(false)
   , m_lookupActive(false)
   , m_udpIgnoreFrameSequences(false)
+  , m_udpReceiveBufferSize(0)
 {
   // Set initial configuration
   setRemoteAddress("");
@@ -44,6 +111,13 @@ IO::Drivers::Network::Network()
   setUdpLocalPort(defaultUdpLocalPort());
   setUdpRemotePort(defaultUdpRemotePort());
   setSocketType(QAbstractSocket::TcpSocket);
+  setUdpReceiveBufferSize(
+      m_settings.value("IO_DataSource_Network__UdpReceiveBuffer",
+                       4 * 1024 * 1024)
+          .toInt());
+  setUdpMulticastGroups(
+      m_settings.value("IO_DataSource_Network__UdpMulticastGroups")
+          .toStringList());
 
   // clang-format off
 
@@ -55,6 +129,10 @@ IO::Drivers::Network::Network()
     connect(this, &IO::Drivers::Network::portChanged,
             this, &IO::Drivers::Network::configurationChanged);
 
+    // Accept incoming connections in TCP server mode
+    connect(&m_server, &QTcpServer::newConnection,
+            this, &IO::Drivers::Network::onNewConnection);
+
     // Report socket errors
 #if QT_VERSION < QT_VERSION_CHECK(5, 12, 0)
     connect(&m_tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)),
@@ -90,6 +168,13 @@ IO::Drivers::Network &IO::Drivers::Network::instance()
  */
 void IO::Drivers::Network::close()
 {
+  // Stop the TCP server & drop its clients
+  m_server.close();
+  closeClients();
+
+  // Leave the multicast groups
+  closeGroups();
+
   // Abort network connections
   m_tcpSocket.abort();
   m_udpSocket.abort();
@@ -110,8 +195,10 @@ void IO::Drivers::Network::close()
  */
 bool IO::Drivers::Network::isOpen() const
 {
-  if (socketType() == QAbstractSocket::UdpSocket)
-    return m_udpSocket.isOpen();
+  if (tcpServer())
+    return m_server.isListening();
+  else if (socketType() == QAbstractSocket::UdpSocket)
+    return m_udpSocket.isOpen() || !m_groupSockets.isEmpty();
   else if (socketType() == QAbstractSocket::TcpSocket)
     return m_tcpSocket.isOpen();
 
@@ -123,8 +210,10 @@ bool IO::Drivers::Network::isOpen() const
  */
 bool IO::Drivers::Network::isReadable() const
 {
-  if (socketType() == QAbstractSocket::UdpSocket)
-    return m_udpSocket.isReadable();
+  if (tcpServer())
+    return m_server.isListening();
+  else if (socketType() == QAbstractSocket::UdpSocket)
+    return m_udpSocket.isReadable() || !m_groupSockets.isEmpty();
   else if (socketType() == QAbstractSocket::TcpSocket)
     return m_tcpSocket.isReadable();
 
@@ -136,8 +225,10 @@ bool IO::Drivers::Network::isReadable() const
  */
 bool IO::Drivers::Network::isWritable() const
 {
-  if (socketType() == QAbstractSocket::UdpSocket)
-    return m_udpSocket.isWritable();
+  if (tcpServer())
+    return m_server.isListening();
+  else if (socketType() == QAbstractSocket::UdpSocket)
+    return m_udpSocket.isWritable() || !m_groupSockets.isEmpty();
   else if (socketType() == QAbstractSocket::TcpSocket)
     return m_tcpSocket.isWritable();
 
@@ -145,22 +236,46 @@ bool IO::Drivers::Network::isWritable() const
 }
 
 /**
- * Returns @c true if the port is greater than 0 and the host address is valid.
+ * Returns @c true if the port is greater than 0 and the host address is valid,
+ * the host address is not used in TCP server mode.
  */
 bool IO::Drivers::Network::configurationOk() const
 {
-  return tcpPort() > 0 && m_hostExists;
+  return tcpPort() > 0 && (m_hostExists || tcpServer());
 }
 
 /**
  * Writes the given @a data to the network device and returns the number of
- * bytes written
+ * bytes written. In TCP server mode, the data is sent to every client, and
+ * when subscribed to several multicast groups, it is sent to every group.
  */
 quint64 IO::Drivers::Network::write(const QByteArray &data)
 {
   if (isWritable())
   {
-    if (socketType() == QAbstractSocket::UdpSocket)
+    if (tcpServer())
+    {
+      qint64 bytes = -1;
+      Q_FOREACH (auto client, m_clients.keys())
+        bytes = qMax(bytes, client->write(data));
+
+      return bytes;
+    }
+    else if (!m_groupSockets.isEmpty())
+    {
+      qint64 bytes = -1;
+      QHostAddress address;
+      quint16 port;
+      auto socket = m_groupSockets.first();
+      Q_FOREACH (const auto &group, m_udpMulticastGroups)
+      {
+        if (PARSE_GROUP(group, udpLocalPort(), &address, &port))
+          bytes = qMax(bytes, socket->writeDatagram(data, address, port));
+      }
+
+      return bytes;
+    }
+    else if (socketType() == QAbstractSocket::UdpSocket)
       return m_udpSocket.write(data);
     else if (socketType() == QAbstractSocket::TcpSocket)
       return m_tcpSocket.write(data);
@@ -169,6 +284,28 @@ quint64 IO::Drivers::Network::write(const QByteArray &data)
   return -1;
 }
 
+/**
+ * Returns the number of bytes written to the network device that have not
+ * been transmitted yet. In TCP server mode, the largest backlog of the
+ * connected clients is returned.
+ */
+qint64 IO::Drivers::Network::bytesToWrite() const
+{
+  if (tcpServer())
+  {
+    qint64 bytes = 0;
+    Q_FOREACH (auto client, m_clients.keys())
+      bytes = qMax(bytes, client->bytesToWrite());
+
+    return bytes;
+  }
+
+  if (socketType() == QAbstractSocket::TcpSocket)
+    return m_tcpSocket.bytesToWrite();
+
+  return 0;
+}
+
 /**
  * Attempts to make a connection to the given host, port and TCP/UDP socket
  * type. Returns @c true on success, @c false on failure
@@ -186,11 +323,35 @@ bool IO::Drivers::Network::open(const QIODevice::OpenMode mode)
   // Init socket pointer
   QIODevice *socket = Q_NULLPTR;
 
-  // TCP connection, assign socket pointer & connect to host
+  // TCP server, listen for incoming connections on every interface
+  if (tcpServer())
+  {
+    if (m_server.listen(QHostAddress::Any, tcpPort()))
+      return true;
+
+    Misc::Utilities::showMessageBox(tr("Network socket error"),
+                                    m_server.errorString());
+    return false;
+  }
+
+  // TCP connection, assign socket pointer & connect to host, using the
+  // cached address of the host to skip the DNS lookup when reconnecting
   if (socketType() == QAbstractSocket::TcpSocket)
   {
     socket = static_cast<QIODevice *>(&m_tcpSocket);
-    m_tcpSocket.connectToHost(hostAddr, tcpPort());
+    const auto cached = HostCache::instance().address(hostAddr);
+    if (!cached.isNull())
+      m_tcpSocket.connectToHost(cached, tcpPort());
+    else
+      m_tcpSocket.connectToHost(hostAddr, tcpPort());
+  }
+
+  // UDP connection, subscribe to several multicast groups
+  else if (socketType() == QAbstractSocket::UdpSocket && udpMulticast()
+           && !udpMulticastGroups().isEmpty())
+  {
+    if (openGroups(mode))
+      return true;
   }
 
   // UDP connection, assign socket pointer & bind to host
@@ -207,6 +368,10 @@ bool IO::Drivers::Network::open(const QIODevice::OpenMode mode)
     if (udpMulticast())
       m_udpSocket.joinMulticastGroup(QHostAddress(m_address));
 
+    // Enlarge the kernel buffer, so that bursts of datagrams are not dropped
+    // while the event loop is busy
+    applyUdpReceiveBufferSize();
+
     // Set socket pointer
     socket = static_cast<QIODevice *>(&m_udpSocket);
   }
@@ -263,6 +428,23 @@ quint16 IO::Drivers::Network::udpRemotePort() const
   return m_udpRemotePort;
 }
 
+/**
+ * Returns @c true if the driver accepts incoming TCP connections instead of
+ * connecting to a remote host.
+ */
+bool IO::Drivers::Network::tcpServer() const
+{
+  return m_tcpServer;
+}
+
+/**
+ * Returns the number of clients connected to the TCP server
+ */
+int IO::Drivers::Network::clientCount() const
+{
+  return m_clients.count();
+}
+
 /**
  * Returns @c true if the UDP socket is managing a multicasted
  * connection.
@@ -289,7 +471,7 @@ int IO::Drivers::Network::socketTypeIndex() const
   switch (socketType())
   {
     case QAbstractSocket::TcpSocket:
-      return 0;
+      return tcpServer() ? 2 : 0;
       break;
     case QAbstractSocket::UdpSocket:
       return 1;
@@ -305,7 +487,7 @@ int IO::Drivers::Network::socketTypeIndex() const
  */
 StringList IO::Drivers::Network::socketTypes() const
 {
-  return StringList{"TCP", "UDP"};
+  return StringList{"TCP", "UDP", tr("TCP Server")};
 }
 
 /**
@@ -317,6 +499,33 @@ bool IO::Drivers::Network::udpIgnoreFrameSequences() const
   return m_udpIgnoreFrameSequences;
 }
 
+/**
+ * Returns the number of multicast sources (group & sender pairs) from which
+ * datagrams have been received.
+ */
+int IO::Drivers::Network::udpSourceCount() const
+{
+  return m_udpSources.count();
+}
+
+/**
+ * Returns the list of multicast groups to subscribe to, each group is written
+ * as "address:port". If the port is omitted, the local port is used.
+ */
+QStringList IO::Drivers::Network::udpMulticastGroups() const
+{
+  return m_udpMulticastGroups;
+}
+
+/**
+ * Returns the size (in bytes) of the receive buffer requested for the UDP
+ * socket, zero means that the operating system default is used.
+ */
+int IO::Drivers::Network::udpReceiveBufferSize() const
+{
+  return m_udpReceiveBufferSize;
+}
+
 /**
  * Returns the socket type. Valid return values are:
  *
@@ -335,7 +544,12 @@ QAbstractSocket::SocketType IO::Drivers::Network::socketType() const
  */
 void IO::Drivers::Network::setTcpSocket()
 {
+  m_tcpServer = false;
   setSocketType(QAbstractSocket::TcpSocket);
+  setUdpReceiveBufferSize(
+      m_settings.value("IO_DataSource_Network__UdpReceiveBuffer",
+                       4 * 1024 * 1024)
+          .toInt());
 }
 
 /**
@@ -343,9 +557,19 @@ void IO::Drivers::Network::setTcpSocket()
  */
 void IO::Drivers::Network::setUdpSocket()
 {
+  m_tcpServer = false;
   setSocketType(QAbstractSocket::UdpSocket);
 }
 
+/**
+ * Instructs the module to accept incoming connections on the TCP port
+ */
+void IO::Drivers::Network::setTcpServer()
+{
+  m_tcpServer = true;
+  setSocketType(QAbstractSocket::TcpSocket);
+}
+
 /**
  * Changes the TCP socket's @c port number
  */
@@ -407,6 +631,44 @@ void IO::Drivers::Network::setUdpIgnoreFrameSequences(const bool ignore)
   Q_EMIT udpIgnoreFrameSequencesChanged();
 }
 
+/**
+ * Changes the size (in bytes) of the receive buffer requested for the UDP
+ * socket, the change is applied immediately if the socket is open.
+ *
+ * @note the operating system may limit the buffer size (e.g. Linux caps it to
+ *       the value of @c net.core.rmem_max).
+ */
+void IO::Drivers::Network::setUdpReceiveBufferSize(const int bytes)
+{
+  m_udpReceiveBufferSize = qBound(0, bytes, 256 * 1024 * 1024);
+  m_settings.setValue("IO_DataSource_Network__UdpReceiveBuffer",
+                      m_udpReceiveBufferSize);
+
+  if (m_udpSocket.state() == QAbstractSocket::BoundState
+      || !m_groupSockets.isEmpty())
+    applyUdpReceiveBufferSize();
+
+  Q_EMIT udpReceiveBufferSizeChanged();
+}
+
+/**
+ * Changes the list of multicast groups to subscribe to when multicast is
+ * enabled, the change is applied the next time that the socket is opened.
+ */
+void IO::Drivers::Network::setUdpMulticastGroups(const QStringList &groups)
+{
+  QStringList list;
+  Q_FOREACH (const auto &group, groups)
+  {
+    if (!group.trimmed().isEmpty())
+      list.append(group.trimmed());
+  }
+
+  m_udpMulticastGroups = list;
+  m_settings.setValue("IO_DataSource_Network__UdpMulticastGroups", list);
+  Q_EMIT udpMulticastGroupsChanged();
+}
+
 /**
  * Performs a DNS lookup for the given @a host name
  */
@@ -441,6 +703,9 @@ void IO::Drivers::Network::setSocketTypeIndex(const int index)
     case 1:
       setUdpSocket();
       break;
+    case 2:
+      setTcpServer();
+      break;
     default:
       break;
   }
@@ -464,29 +729,28 @@ void IO::Drivers::Network::setSocketType(const QAbstractSocket::SocketType type)
  */
 void IO::Drivers::Network::onReadyRead()
 {
-  // Initialize byte array
+  // Initialize byte array & register the reception time
   QByteArray data;
+  const auto time = FrameQueue::timestamp();
 
   // Check if we need to use UDP socket functions
   if (socketType() == QAbstractSocket::UdpSocket)
   {
-    while (udpSocket()->hasPendingDatagrams())
+    // Ignore start/end sequences, each datagram is a frame
+    if (udpIgnoreFrameSequences())
     {
-      // Read datagram data
-      QByteArray datagram;
-      datagram.resize(int(udpSocket()->pendingDatagramSize()));
-      udpSocket()->readDatagram(datagram.data(), datagram.size());
-
-      // Add datagram to data buffer
-      if (!udpIgnoreFrameSequences())
-      {
-        data.append(datagram);
-        Q_EMIT dataReceived(data);
-      }
+      QVector<QByteArray> datagrams;
+      readDatagrams(data, &datagrams);
+      if (!datagrams.isEmpty())
+        IO::Manager::instance().processFrames(data, datagrams, time);
+    }
 
-      // Ingore start/end sequences & process frame directly
-      else
-        IO::Manager::instance().processPayload(datagram);
+    // Hand the contents of all the datagrams to the frame reader
+    else
+    {
+      readDatagrams(data, Q_NULLPTR);
+      if (!data.isEmpty())
+        Q_EMIT dataReceived(data, time);
     }
   }
 
@@ -494,10 +758,325 @@ void IO::Drivers::Network::onReadyRead()
   else if (socketType() == QAbstractSocket::TcpSocket)
   {
     data = tcpSocket()->readAll();
-    Q_EMIT dataReceived(data);
+    Q_EMIT dataReceived(data, time);
+  }
+}
+
+/**
+ * Accepts the pending connections of the TCP server & creates a frame
+ * pipeline for each client, identified by its address & port.
+ */
+void IO::Drivers::Network::onNewConnection()
+{
+  while (m_server.hasPendingConnections())
+  {
+    auto client = m_server.nextPendingConnection();
+    if (!client)
+      break;
+
+    // Register the frame pipeline of the client
+    const auto address = client->peerAddress().toString();
+    const auto peer = QStringLiteral("%1:%2").arg(address).arg(
+        client->peerPort());
+    m_clients.insert(client, Manager::instance().openStream(peer));
+
+    // clang-format off
+      client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+      connect(client, &QTcpSocket::readyRead,
+              this, &IO::Drivers::Network::onClientReadyRead);
+      connect(client, &QTcpSocket::disconnected,
+              this, &IO::Drivers::Network::onClientDisconnected);
+    // clang-format on
+  }
+
+  Q_EMIT clientsChanged();
+}
+
+/**
+ * Hands the data received from a TCP client to its frame pipeline
+ */
+void IO::Drivers::Network::onClientReadyRead()
+{
+  const auto time = FrameQueue::timestamp();
+  auto client = qobject_cast<QTcpSocket *>(sender());
+  if (client && m_clients.contains(client))
+    Manager::instance().processStreamData(m_clients.value(client),
+                                          client->readAll(), time);
+}
+
+/**
+ * Removes a TCP client & its frame pipeline once the connection is closed,
+ * the rest of the clients are not affected.
+ */
+void IO::Drivers::Network::onClientDisconnected()
+{
+  auto client = qobject_cast<QTcpSocket *>(sender());
+  if (client && m_clients.contains(client))
+  {
+    Manager::instance().closeStream(m_clients.take(client));
+    client->deleteLater();
+    Q_EMIT clientsChanged();
+  }
+}
+
+/**
+ * Reads the pending datagrams of a multicast group socket & hands them to the
+ * frame stream of their source. A new stream is created for each combination
+ * of group & sender, and the data of each source is delivered at once.
+ */
+void IO::Drivers::Network::onGroupReadyRead()
+{
+  // Get socket
+  auto socket = qobject_cast<QUdpSocket *>(sender());
+  if (!socket)
+    return;
+
+  // Read the pending datagrams & sort them by source
+  int bytes = 0;
+  const auto time = FrameQueue::timestamp();
+  QVector<int> order;
+  QHash<int, QByteArray> data;
+  QHash<int, QVector<QByteArray>> frames;
+  while (socket->hasPendingDatagrams() && bytes < UDP_MAX_READ_SIZE)
+  {
+    // Read datagram
+    const auto datagram = socket->receiveDatagram();
+    if (!datagram.isValid())
+      break;
+
+    // Get the stream of the group & sender
+    const auto payload = datagram.data();
+    const auto key = QStringLiteral("%1:%2 (%3)")
+                         .arg(datagram.destinationAddress().toString())
+                         .arg(socket->localPort())
+                         .arg(datagram.senderAddress().toString());
+    int stream = m_udpSources.value(key, -1);
+    if (stream < 0)
+    {
+      stream = Manager::instance().openStream(key);
+      m_udpSources.insert(key, stream);
+      Q_EMIT udpSourcesChanged();
+    }
+
+    // Register the datagram
+    if (!data.contains(stream))
+      order.append(stream);
+
+    data[stream].append(payload);
+    if (udpIgnoreFrameSequences())
+      frames[stream].append(payload);
+
+    bytes += payload.size();
+  }
+
+  // Deliver the data of each source
+  auto &manager = Manager::instance();
+  Q_FOREACH (const auto stream, order)
+  {
+    if (udpIgnoreFrameSequences())
+      manager.processStreamFrames(stream, data[stream], frames[stream], time);
+    else
+      manager.processStreamData(stream, data[stream], time);
   }
 }
 
+/**
+ * Binds one socket for each port of the multicast group list & joins the
+ * groups of each port.
+ *
+ * @returns @c true if at least one group could be joined
+ */
+bool IO::Drivers::Network::openGroups(const QIODevice::OpenMode mode)
+{
+  // Sort the groups by port
+  quint16 port;
+  QHostAddress address;
+  QMap<quint16, QVector<QHostAddress>> ports;
+  Q_FOREACH (const auto &group, m_udpMulticastGroups)
+  {
+    if (PARSE_GROUP(group, udpLocalPort(), &address, &port))
+      ports[port].append(address);
+  }
+
+  // Bind a socket for each port
+  for (auto i = ports.constBegin(); i != ports.constEnd(); ++i)
+  {
+    // Listen on IPv6 interfaces only if required
+    auto any = QHostAddress(QHostAddress::AnyIPv4);
+    Q_FOREACH (const auto &group, i.value())
+    {
+      if (group.protocol() == QAbstractSocket::IPv6Protocol)
+        any = QHostAddress(QHostAddress::Any);
+    }
+
+    // Bind the socket
+    auto socket = new QUdpSocket(this);
+    // clang-format off
+      const bool bound = socket->bind(any, i.key(),
+                                      QAbstractSocket::ShareAddress |
+                                      QAbstractSocket::ReuseAddressHint);
+    // clang-format on
+
+    // Join the groups
+    bool joined = false;
+    if (bound)
+    {
+      Q_FOREACH (const auto &group, i.value())
+        joined |= socket->joinMulticastGroup(group);
+    }
+
+    // Discard the socket if it is not subscribed to any group
+    if (!joined || !socket->open(mode))
+    {
+      delete socket;
+      continue;
+    }
+
+    // Register the socket
+    connect(socket, &QUdpSocket::readyRead, this,
+            &IO::Drivers::Network::onGroupReadyRead);
+    m_groupSockets.append(socket);
+  }
+
+  // Enlarge the kernel buffers of the sockets
+  applyUdpReceiveBufferSize();
+
+  // Report errors
+  if (m_groupSockets.isEmpty())
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Network socket error"),
+        tr("Cannot subscribe to any of the multicast groups"));
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Closes the sockets of the multicast groups & the frame streams of their
+ * sources.
+ */
+void IO::Drivers::Network::closeGroups()
+{
+  Q_FOREACH (auto socket, m_groupSockets)
+  {
+    disconnect(socket, Q_NULLPTR, this, Q_NULLPTR);
+    socket->close();
+    socket->deleteLater();
+  }
+
+  Q_FOREACH (const auto stream, m_udpSources)
+    Manager::instance().closeStream(stream);
+
+  const bool notify = !m_udpSources.isEmpty();
+  m_groupSockets.clear();
+  m_udpSources.clear();
+  if (notify)
+    Q_EMIT udpSourcesChanged();
+}
+
+/**
+ * Closes the connections with all the TCP clients & their frame pipelines
+ */
+void IO::Drivers::Network::closeClients()
+{
+  if (m_clients.isEmpty())
+    return;
+
+  auto clients = m_clients;
+  m_clients.clear();
+  for (auto i = clients.constBegin(); i != clients.constEnd(); ++i)
+  {
+    disconnect(i.key(), Q_NULLPTR, this, Q_NULLPTR);
+    i.key()->abort();
+    i.key()->deleteLater();
+    Manager::instance().closeStream(i.value());
+  }
+
+  Q_EMIT clientsChanged();
+}
+
+/**
+ * Applies the configured receive buffer size to the UDP sockets
+ */
+void IO::Drivers::Network::applyUdpReceiveBufferSize()
+{
+  if (m_udpReceiveBufferSize <= 0)
+    return;
+
+  const auto option = QAbstractSocket::ReceiveBufferSizeSocketOption;
+  m_udpSocket.setSocketOption(option, m_udpReceiveBufferSize);
+  Q_FOREACH (auto socket, m_groupSockets)
+    socket->setSocketOption(option, m_udpReceiveBufferSize);
+}
+
+/**
+ * Reads the pending datagrams of the UDP socket & appends their contents to
+ * @a data. If @a datagrams is not null, a copy of each datagram is appended
+ * to it as well.
+ *
+ * On Linux, datagrams are read in batches with @c recvmmsg(). The last read
+ * is always done through the @c QUdpSocket, since Qt disables the read
+ * notifications of the socket until a datagram is read through its API.
+ */
+void IO::Drivers::Network::readDatagrams(QByteArray &data,
+                                         QVector<QByteArray> *datagrams)
+{
+  // Allocate the datagram buffer once
+  const int capacity = UDP_BATCH_SIZE * UDP_MAX_DATAGRAM_SIZE;
+  if (m_datagramBuffer.size() != capacity)
+    m_datagramBuffer.resize(capacity);
+
+  // Initialize parameters
+  char *buffer = m_datagramBuffer.data();
+  auto append = [&](const char *datagram, const int length) {
+    data.append(datagram, length);
+    if (datagrams)
+      datagrams->append(QByteArray(datagram, length));
+  };
+
+#if defined(Q_OS_LINUX)
+  // Read batches of datagrams until the socket has no more pending data
+  const auto fd = static_cast<int>(m_udpSocket.socketDescriptor());
+  if (fd != -1)
+  {
+    struct iovec vectors[UDP_BATCH_SIZE];
+    struct mmsghdr messages[UDP_BATCH_SIZE];
+    memset(messages, 0, sizeof(messages));
+    for (int i = 0; i < UDP_BATCH_SIZE; ++i)
+    {
+      vectors[i].iov_base = buffer + i * UDP_MAX_DATAGRAM_SIZE;
+      vectors[i].iov_len = UDP_MAX_DATAGRAM_SIZE;
+      messages[i].msg_hdr.msg_iov = &vectors[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count = 0;
+    do
+    {
+      count = recvmmsg(fd, messages, UDP_BATCH_SIZE, MSG_DONTWAIT, Q_NULLPTR);
+      for (int i = 0; i < count; ++i)
+      {
+        const int length = static_cast<int>(messages[i].msg_len);
+        append(buffer + i * UDP_MAX_DATAGRAM_SIZE, length);
+      }
+    } while (count == UDP_BATCH_SIZE && data.size() < UDP_MAX_READ_SIZE);
+  }
+#endif
+
+  // Read the remaining datagrams through the socket
+  do
+  {
+    const auto bytes = m_udpSocket.readDatagram(buffer, UDP_MAX_DATAGRAM_SIZE);
+    if (bytes < 0)
+      break;
+
+    append(buffer, static_cast<int>(bytes));
+  } while (m_udpSocket.hasPendingDatagrams()
+           && data.size() < UDP_MAX_READ_SIZE);
+}
+
 /**
  * Sets the host IP address when the lookup finishes.
  * If the lookup fails, the error code/string shall be shown to the user in a
@@ -513,6 +1092,7 @@ void IO::Drivers::Network::lookupFinished(const QHostInfo &info)
     if (addresses.count() >= 1)
     {
       m_hostExists = true;
+      HostCache::instance().insert(info.hostName(), addresses);
       Q_EMIT addressChanged();
       return;
     }
@@ -523,7 +1103,8 @@ void IO::Drivers::Network::lookupFinished(const QHostInfo &info)
 
 /**
  * This function is called whenever a socket error occurs, it disconnects the
- * socket from the host and displays the error in a message box.
+ * socket from the host and displays the error in a message box (unless the
+ * connection is restored automatically).
  */
 void IO::Drivers::Network::onErrorOccurred(
     const QAbstractSocket::SocketError socketError)
@@ -536,7 +1117,6 @@ void IO::Drivers::Network::onErrorOccurred(
   else
     error = QString::number(socketError);
 
-  Manager::instance().disconnectDriver();
-  Misc::Utilities::showMessageBox(tr("Network socket error"), error);
+  Manager::instance().connectionLost(tr("Network socket error"), error);
 }
 
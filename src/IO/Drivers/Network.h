@@ -24,12 +24,17 @@
 
 #include <DataTypes.h>
 #include <IO/HAL_Driver.h>
+#include <Misc/Settings.h>
 
+#include <QMap>
+#include <QHash>
 #include <QHostInfo>
+#include <QTcpServer>
 #include <QTcpSocket>
 #include <QUdpSocket>
 #include <QByteArray>
 #include <QHostAddress>
+#include <QStringList>
 #include <QAbstractSocket>
 
 namespace IO
@@ -40,6 +45,20 @@ namespace Drivers
  * @brief The Network class
  *
  * Serial Studio "driver" class to interact with UDP/TCP network ports.
+ *
+ * Pending UDP datagrams are read in batches (with @c recvmmsg() on Linux) into
+ * a pre-allocated buffer, and the data of all the datagrams read during a
+ * single socket notification is delivered to the I/O manager at once.
+ *
+ * In TCP server mode, the driver listens on the TCP port & accepts any number
+ * of concurrent client connections. Each client gets its own frame pipeline
+ * (see @c IO::Manager::openStream()), so that its frames are extracted
+ * independently & tagged with the identifier of the client. Data written to
+ * the driver is sent to all the connected clients.
+ *
+ * In UDP multicast mode, a list of groups (in "address:port" format) can be
+ * subscribed at once. One socket is bound for each port, and the datagrams
+ * of each group & sender are demultiplexed into separate frame streams.
  */
 class Network : public HAL_Driver
 {
@@ -95,14 +114,35 @@ class Network : public HAL_Driver
                READ udpIgnoreFrameSequences
                WRITE setUdpIgnoreFrameSequences
                NOTIFY udpIgnoreFrameSequencesChanged)
+    Q_PROPERTY(int udpReceiveBufferSize
+               READ udpReceiveBufferSize
+               WRITE setUdpReceiveBufferSize
+               NOTIFY udpReceiveBufferSizeChanged)
+    Q_PROPERTY(QStringList udpMulticastGroups
+               READ udpMulticastGroups
+               WRITE setUdpMulticastGroups
+               NOTIFY udpMulticastGroupsChanged)
+    Q_PROPERTY(int udpSourceCount
+               READ udpSourceCount
+               NOTIFY udpSourcesChanged)
+    Q_PROPERTY(bool tcpServer
+               READ tcpServer
+               NOTIFY socketTypeChanged)
+    Q_PROPERTY(int clientCount
+               READ clientCount
+               NOTIFY clientsChanged)
   // clang-format on
 
 Q_SIGNALS:
   void portChanged();
   void addressChanged();
+  void clientsChanged();
   void socketTypeChanged();
   void udpMulticastChanged();
   void lookupActiveChanged();
+  void udpSourcesChanged();
+  void udpMulticastGroupsChanged();
+  void udpReceiveBufferSizeChanged();
   void udpIgnoreFrameSequencesChanged();
 
 private:
@@ -125,6 +165,7 @@ public:
   bool configurationOk() const override;
   quint64 write(const QByteArray &data) override;
   bool open(const QIODevice::OpenMode mode) override;
+  qint64 bytesToWrite() const override;
 
   QString remoteAddress() const;
 
@@ -132,10 +173,15 @@ public:
   quint16 udpLocalPort() const;
   quint16 udpRemotePort() const;
 
+  bool tcpServer() const;
+  int clientCount() const;
   bool udpMulticast() const;
   bool lookupActive() const;
   int socketTypeIndex() const;
   StringList socketTypes() const;
+  int udpSourceCount() const;
+  int udpReceiveBufferSize() const;
+  QStringList udpMulticastGroups() const;
   bool udpIgnoreFrameSequences() const;
   QAbstractSocket::SocketType socketType() const;
 
@@ -150,6 +196,7 @@ public:
 public Q_SLOTS:
   void setTcpSocket();
   void setUdpSocket();
+  void setTcpServer();
   void lookup(const QString &host);
   void setTcpPort(const quint16 port);
   void setUdpLocalPort(const quint16 port);
@@ -157,27 +204,49 @@ public Q_SLOTS:
   void setSocketTypeIndex(const int index);
   void setUdpRemotePort(const quint16 port);
   void setRemoteAddress(const QString &address);
+  void setUdpReceiveBufferSize(const int bytes);
+  void setUdpMulticastGroups(const QStringList &groups);
   void setUdpIgnoreFrameSequences(const bool ignore);
   void setSocketType(const QAbstractSocket::SocketType type);
 
 private Q_SLOTS:
   void onReadyRead();
+  void onNewConnection();
+  void onClientReadyRead();
+  void onClientDisconnected();
+  void onGroupReadyRead();
   void lookupFinished(const QHostInfo &info);
   void onErrorOccurred(const QAbstractSocket::SocketError socketError);
 
+private:
+  void closeGroups();
+  void closeClients();
+  bool openGroups(const QIODevice::OpenMode mode);
+  void applyUdpReceiveBufferSize();
+  void readDatagrams(QByteArray &data, QVector<QByteArray> *datagrams);
+
 private:
   QString m_address;
   quint16 m_tcpPort;
   bool m_hostExists;
   bool m_udpMulticast;
+  bool m_tcpServer;
   bool m_lookupActive;
   quint16 m_udpLocalPort;
   quint16 m_udpRemotePort;
   bool m_udpIgnoreFrameSequences;
+  int m_udpReceiveBufferSize;
+  QStringList m_udpMulticastGroups;
   QAbstractSocket::SocketType m_socketType;
 
+  Misc::Settings m_settings;
   QTcpSocket m_tcpSocket;
   QUdpSocket m_udpSocket;
+  QTcpServer m_server;
+  QByteArray m_datagramBuffer;
+  QMap<QTcpSocket *, int> m_clients;
+  QHash<QString, int> m_udpSources;
+  QVector<QUdpSocket *> m_groupSockets;
 };
 } // namespace Drivers
 } // namespace IO
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Drivers/PortWatcher.h>
+
+#include <QSocketNotifier>
+#include <QCoreApplication>
+
+#if defined(Q_OS_LINUX)
+#  include <cstring>
+#  include <unistd.h>
+#  include <sys/socket.h>
+#  include <linux/netlink.h>
+#elif defined(Q_OS_WIN)
+#  include <windows.h>
+#  include <dbt.h>
+#elif defined(Q_OS_MACOS)
+#  include <IOKit/IOKitLib.h>
+#  include <IOKit/serial/IOSerialKeys.h>
+#  include <CoreFoundation/CoreFoundation.h>
+#endif
+
+/**
+ * Time (in milliseconds) to wait after a hotplug notification before
+ * enumerating the serial ports, so that the bursts of notifications generated
+ * when a device is plugged only trigger a single enumeration.
+ */
+static const int HOTPLUG_DEBOUNCE_INTERVAL = 100;
+
+/**
+ * Interval (in milliseconds) at which the serial ports are enumerated when
+ * hotplug notifications are available, only used as a safety net for drivers
+ * that do not notify the operating system about new ports.
+ */
+static const int HOTPLUG_POLL_INTERVAL = 10000;
+
+/**
+ * Interval (in milliseconds) at which the serial ports are enumerated when
+ * hotplug notifications are not available.
+ */
+static const int FALLBACK_POLL_INTERVAL = 1000;
+
+/**
+ * Returns a list with all the valid serial ports of the computer
+ */
+static QVector<QSerialPortInfo> ENUMERATE_PORTS()
+{
+  QVector<QSerialPortInfo> ports;
+  Q_FOREACH (QSerialPortInfo info, QSerialPortInfo::availablePorts())
+  {
+    if (!info.isNull())
+    {
+      // Only accept *.cu devices on macOS (remove *.tty)
+      // https://stackoverflow.com/a/37688347
+#ifdef Q_OS_MACOS
+      if (info.portName().toLower().startsWith("tty."))
+        continue;
+#endif
+      // Append port to list
+      ports.append(info);
+    }
+  }
+
+  return ports;
+}
+
+/**
+ * Returns @c true if both port lists contain the same devices
+ */
+static bool SAME_PORTS(const QVector<QSerialPortInfo> &a,
+                       const QVector<QSerialPortInfo> &b)
+{
+  if (a.count() != b.count())
+    return false;
+
+  for (int i = 0; i < a.count(); ++i)
+  {
+    if (a.at(i).portName() != b.at(i).portName()
+        || a.at(i).description() != b.at(i).description()
+        || a.at(i).serialNumber() != b.at(i).serialNumber())
+      return false;
+  }
+
+  return true;
+}
+
+#if defined(Q_OS_MACOS)
+/**
+ * Called by IOKit when a serial BSD service is published or terminated. The
+ * iterator must be drained so that IOKit keeps sending notifications.
+ */
+static void IOKIT_CALLBACK(void *context, io_iterator_t iterator)
+{
+  io_object_t object;
+  while ((object = IOIteratorNext(iterator)))
+    IOObjectRelease(object);
+
+  if (context)
+    static_cast<IO::Drivers::PortWatcher *>(context)->refresh();
+}
+#endif
+
+/**
+ * Constructor function, starts the enumeration thread, registers the hotplug
+ * notifications & enumerates the serial ports for the first time.
+ */
+IO::Drivers::PortWatcher::PortWatcher(QObject *parent)
+  : QObject(parent)
+  , m_hotplug(false)
+  , m_rescan(false)
+  , m_scanning(false)
+  , m_ueventSocket(-1)
+  , m_ueventNotifier(Q_NULLPTR)
+  , m_notificationPort(Q_NULLPTR)
+  , m_addedIterator(0)
+  , m_removedIterator(0)
+{
+  // Start the enumeration thread
+  m_worker.moveToThread(&m_thread);
+  m_thread.setObjectName("IO::PortWatcher");
+  m_thread.start(QThread::LowPriority);
+
+  // Configure timers
+  m_debounceTimer.setSingleShot(true);
+  m_debounceTimer.setInterval(HOTPLUG_DEBOUNCE_INTERVAL);
+  connect(&m_debounceTimer, &QTimer::timeout, this,
+          &IO::Drivers::PortWatcher::startScan);
+  connect(&m_pollTimer, &QTimer::timeout, this,
+          &IO::Drivers::PortWatcher::startScan);
+
+  // Register hotplug notifications & select the polling interval
+  startHotplug();
+  m_pollTimer.start(m_hotplug ? HOTPLUG_POLL_INTERVAL : FALLBACK_POLL_INTERVAL);
+
+  // Enumerate the serial ports
+  startScan();
+}
+
+/**
+ * Destructor function, unregisters the hotplug notifications & stops the
+ * enumeration thread.
+ */
+IO::Drivers::PortWatcher::~PortWatcher()
+{
+  stopHotplug();
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns @c true if the operating system notifies us when a serial device is
+ * plugged or unplugged.
+ */
+bool IO::Drivers::PortWatcher::hotplugSupported() const
+{
+  return m_hotplug;
+}
+
+/**
+ * Returns the serial ports found during the last enumeration
+ */
+QVector<QSerialPortInfo> IO::Drivers::PortWatcher::ports() const
+{
+  return m_ports;
+}
+
+/**
+ * Intercepts the @c WM_DEVICECHANGE messages received by the windows of the
+ * application on Windows, the messages are not filtered out.
+ */
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+bool IO::Drivers::PortWatcher::nativeEventFilter(const QByteArray &eventType,
+                                                 void *message,
+                                                 qintptr *result)
+#else
+bool IO::Drivers::PortWatcher::nativeEventFilter(const QByteArray &eventType,
+                                                 void *message, long *result)
+#endif
+{
+  (void)result;
+
+#if defined(Q_OS_WIN)
+  if (eventType == "windows_generic_MSG" && message)
+  {
+    auto msg = static_cast<MSG *>(message);
+    if (msg->message == WM_DEVICECHANGE)
+    {
+      switch (msg->wParam)
+      {
+        case DBT_DEVICEARRIVAL:
+        case DBT_DEVICEREMOVECOMPLETE:
+        case DBT_DEVNODES_CHANGED:
+          refresh();
+          break;
+        default:
+          break;
+      }
+    }
+  }
+#else
+  (void)eventType;
+  (void)message;
+#endif
+
+  return false;
+}
+
+/**
+ * Schedules an enumeration of the serial ports, calls received within the
+ * debounce interval are merged into a single enumeration.
+ */
+void IO::Drivers::PortWatcher::refresh()
+{
+  if (!m_debounceTimer.isActive())
+    m_debounceTimer.start();
+}
+
+/**
+ * Enumerates the serial ports in the background thread. If an enumeration is
+ * already running, a new one is started when it finishes.
+ */
+void IO::Drivers::PortWatcher::startScan()
+{
+  // Enumeration in progress, repeat it when it finishes
+  if (m_scanning)
+  {
+    m_rescan = true;
+    return;
+  }
+
+  // Enumerate the ports & hand the results back to this thread
+  m_scanning = true;
+  QMetaObject::invokeMethod(&m_worker, [=] {
+    const auto ports = ENUMERATE_PORTS();
+    QMetaObject::invokeMethod(this, [=] { onScanFinished(ports); });
+  });
+}
+
+/**
+ * Reads the pending kernel uevents (Linux only) & schedules an enumeration
+ * of the serial ports if a "tty" device was added or removed.
+ */
+void IO::Drivers::PortWatcher::onUevent()
+{
+#if defined(Q_OS_LINUX)
+  char buffer[4096];
+  bool ttyEvent = false;
+  ssize_t bytes;
+  while ((bytes = recv(m_ueventSocket, buffer, sizeof(buffer), 0)) > 0)
+  {
+    const auto event = QByteArray::fromRawData(buffer, bytes);
+    if (event.contains(QByteArrayLiteral("SUBSYSTEM=tty")))
+      ttyEvent = true;
+  }
+
+  if (ttyEvent)
+    refresh();
+#endif
+}
+
+/**
+ * Registers the hotplug notifications of the current operating system
+ */
+void IO::Drivers::PortWatcher::startHotplug()
+{
+#if defined(Q_OS_LINUX)
+  // Open a netlink socket subscribed to the kernel uevents
+  m_ueventSocket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                          NETLINK_KOBJECT_UEVENT);
+  if (m_ueventSocket < 0)
+    return;
+
+  struct sockaddr_nl addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = 1;
+  if (bind(m_ueventSocket, reinterpret_cast<struct sockaddr *>(&addr),
+           sizeof(addr))
+      != 0)
+  {
+    ::close(m_ueventSocket);
+    m_ueventSocket = -1;
+    return;
+  }
+
+  // Read the uevents from the event loop
+  m_ueventNotifier
+      = new QSocketNotifier(m_ueventSocket, QSocketNotifier::Read, this);
+  connect(m_ueventNotifier, &QSocketNotifier::activated, this,
+          &IO::Drivers::PortWatcher::onUevent);
+  m_hotplug = true;
+#elif defined(Q_OS_WIN)
+  // Intercept the device change messages of the application windows
+  if (QCoreApplication::instance())
+  {
+    QCoreApplication::instance()->installNativeEventFilter(this);
+    m_hotplug = true;
+  }
+#elif defined(Q_OS_MACOS)
+  // Create a notification port & attach it to the main run loop
+  auto port = IONotificationPortCreate(MACH_PORT_NULL);
+  if (!port)
+    return;
+
+  m_notificationPort = port;
+  auto source = IONotificationPortGetRunLoopSource(port);
+  CFRunLoopAddSource(CFRunLoopGetMain(), source, kCFRunLoopCommonModes);
+
+  // Get notified when a serial service is published or terminated, the
+  // iterators are drained once to arm the notifications
+  io_iterator_t added = 0;
+  io_iterator_t removed = 0;
+  IOServiceAddMatchingNotification(
+      port, kIOFirstMatchNotification,
+      IOServiceMatching(kIOSerialBSDServiceValue), IOKIT_CALLBACK, this,
+      &added);
+  IOServiceAddMatchingNotification(
+      port, kIOTerminatedNotification,
+      IOServiceMatching(kIOSerialBSDServiceValue), IOKIT_CALLBACK, this,
+      &removed);
+  IOKIT_CALLBACK(Q_NULLPTR, added);
+  IOKIT_CALLBACK(Q_NULLPTR, removed);
+  m_addedIterator = added;
+  m_removedIterator = removed;
+  m_hotplug = true;
+#endif
+}
+
+/**
+ * Unregisters the hotplug notifications of the current operating system
+ */
+void IO::Drivers::PortWatcher::stopHotplug()
+{
+#if defined(Q_OS_LINUX)
+  if (m_ueventNotifier)
+  {
+    m_ueventNotifier->setEnabled(false);
+    delete m_ueventNotifier;
+    m_ueventNotifier = Q_NULLPTR;
+  }
+
+  if (m_ueventSocket >= 0)
+  {
+    ::close(m_ueventSocket);
+    m_ueventSocket = -1;
+  }
+#elif defined(Q_OS_WIN)
+  if (m_hotplug && QCoreApplication::instance())
+    QCoreApplication::instance()->removeNativeEventFilter(this);
+#elif defined(Q_OS_MACOS)
+  if (m_addedIterator)
+    IOObjectRelease(m_addedIterator);
+  if (m_removedIterator)
+    IOObjectRelease(m_removedIterator);
+  if (m_notificationPort)
+    IONotificationPortDestroy(
+        static_cast<IONotificationPortRef>(m_notificationPort));
+
+  m_addedIterator = 0;
+  m_removedIterator = 0;
+  m_notificationPort = Q_NULLPTR;
+#endif
+
+  m_hotplug = false;
+}
+
+/**
+ * Registers the results of an enumeration & notifies the serial driver if
+ * the list of ports has changed.
+ */
+void IO::Drivers::PortWatcher::onScanFinished(
+    const QVector<QSerialPortInfo> &ports)
+{
+  // Update the port list
+  m_scanning = false;
+  if (!SAME_PORTS(m_ports, ports))
+  {
+    m_ports = ports;
+    Q_EMIT portsChanged();
+  }
+
+  // Repeat the enumeration if it was requested while scanning
+  if (m_rescan)
+  {
+    m_rescan = false;
+    startScan();
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QSerialPortInfo>
+#include <QAbstractNativeEventFilter>
+
+class QSocketNotifier;
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The PortWatcher class
+ *
+ * Keeps an updated list of the serial ports available in the computer.
+ *
+ * Enumerating the serial ports can take tens of milliseconds on systems with
+ * many (virtual) ports, so the ports are enumerated in a background thread,
+ * and only when the operating system reports that a device has been plugged
+ * or unplugged:
+ * - On Linux, kernel uevents for the "tty" subsystem are received through a
+ *   netlink socket.
+ * - On Windows, the @c WM_DEVICECHANGE messages received by the application
+ *   windows are intercepted with a native event filter.
+ * - On macOS, IOKit notifications for serial BSD services are registered in
+ *   the main run loop.
+ *
+ * The ports are also enumerated periodically, more often when hotplug
+ * notifications are not available on the current platform.
+ */
+class PortWatcher : public QObject, public QAbstractNativeEventFilter
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void portsChanged();
+
+public:
+  explicit PortWatcher(QObject *parent = Q_NULLPTR);
+  ~PortWatcher();
+
+  bool hotplugSupported() const;
+  QVector<QSerialPortInfo> ports() const;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  bool nativeEventFilter(const QByteArray &eventType, void *message,
+                         qintptr *result) override;
+#else
+  bool nativeEventFilter(const QByteArray &eventType, void *message,
+                         long *result) override;
+#endif
+
+public Q_SLOTS:
+  void refresh();
+
+private Q_SLOTS:
+  void startScan();
+  void onUevent();
+
+private:
+  void startHotplug();
+  void stopHotplug();
+  void onScanFinished(const QVector<QSerialPortInfo> &ports);
+
+private:
+  bool m_hotplug;
+  bool m_rescan;
+  bool m_scanning;
+
+  QObject m_worker;
+  QThread m_thread;
+  QTimer m_pollTimer;
+  QTimer m_debounceTimer;
+  QVector<QSerialPortInfo> m_ports;
+
+  int m_ueventSocket;
+  QSocketNotifier *m_ueventNotifier;
+
+  void *m_notificationPort;
+  unsigned int m_addedIterator;
+  unsigned int m_removedIterator;
+};
+} // namespace Drivers
+} // namespace IO
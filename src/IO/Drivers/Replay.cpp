@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFileInfo>
+#include <QFileDialog>
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/RawCapture.h>
+#include <IO/Drivers/Replay.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Maximum number of bytes delivered during a single event loop iteration when
+ * replaying a capture at full speed, so that the user interface stays
+ * responsive.
+ */
+static const qint64 MAX_BATCH_BYTES = 256 * 1024;
+
+/**
+ * Constructor function, restores the last capture file used by the driver
+ */
+IO::Drivers::Replay::Replay()
+  : m_open(false)
+  , m_realTime(true)
+  , m_chunk(0)
+  , m_startTime(0)
+{
+  // Configure the replay timer
+  m_timer.setSingleShot(true);
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this, &Replay::replayChunks);
+
+  // Read settings
+  m_realTime = m_settings.value("IO_Replay_RealTime", true).toBool();
+  const auto path = m_settings.value("IO_Replay_File", "").toString();
+  if (!path.isEmpty() && QFileInfo::exists(path))
+    m_capture.open(path);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::Replay &IO::Drivers::Replay::instance()
+{
+  static Replay singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Stops replaying the capture file, the next connection starts from the
+ * first chunk of the capture.
+ */
+void IO::Drivers::Replay::close()
+{
+  m_timer.stop();
+  m_open = false;
+}
+
+/**
+ * Returns @c true if the capture file is being replayed
+ */
+bool IO::Drivers::Replay::isOpen() const
+{
+  return m_open;
+}
+
+/**
+ * Returns @c true if the capture file is being replayed
+ */
+bool IO::Drivers::Replay::isReadable() const
+{
+  return m_open;
+}
+
+/**
+ * Captures cannot be written to, data sent to the driver is discarded
+ */
+bool IO::Drivers::Replay::isWritable() const
+{
+  return false;
+}
+
+/**
+ * Returns @c true if a capture file with at least one chunk is selected
+ */
+bool IO::Drivers::Replay::configurationOk() const
+{
+  return m_capture.chunkCount() > 0;
+}
+
+/**
+ * Discards the given @a data, replayed devices do not receive commands
+ */
+quint64 IO::Drivers::Replay::write(const QByteArray &data)
+{
+  Q_UNUSED(data);
+  return 0;
+}
+
+/**
+ * Starts replaying the selected capture file from its first chunk
+ */
+bool IO::Drivers::Replay::open(const QIODevice::OpenMode mode)
+{
+  Q_UNUSED(mode);
+
+  // Stop current replay
+  close();
+  if (!configurationOk())
+    return false;
+
+  // Start replaying chunks from the event loop
+  m_chunk = 0;
+  m_open = true;
+  m_startTime = FrameQueue::timestamp();
+  m_timer.start(0);
+
+  Q_EMIT progressChanged();
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the path of the selected capture file
+ */
+QString IO::Drivers::Replay::fileName() const
+{
+  return m_capture.fileName();
+}
+
+/**
+ * Returns the number of chunks stored in the selected capture file
+ */
+int IO::Drivers::Replay::chunkCount() const
+{
+  return m_capture.chunkCount();
+}
+
+/**
+ * Returns the number of data bytes stored in the selected capture file
+ */
+qint64 IO::Drivers::Replay::totalBytes() const
+{
+  return m_capture.totalBytes();
+}
+
+/**
+ * Returns the duration (in milliseconds) of the selected capture file
+ */
+qint64 IO::Drivers::Replay::duration() const
+{
+  return m_capture.duration() / 1000;
+}
+
+/**
+ * Returns @c true if chunks are delivered with their original timing, or
+ * @c false if the capture is replayed as fast as possible.
+ */
+bool IO::Drivers::Replay::realTime() const
+{
+  return m_realTime;
+}
+
+/**
+ * Returns the fraction (0 to 1) of the capture that has been replayed
+ */
+double IO::Drivers::Replay::progress() const
+{
+  if (m_capture.chunkCount() <= 0)
+    return 0;
+
+  return static_cast<double>(m_chunk) / m_capture.chunkCount();
+}
+
+/**
+ * Lets the user select the capture file to replay
+ */
+void IO::Drivers::Replay::openFile()
+{
+  // clang-format off
+
+    // Get file name
+    auto file = QFileDialog::getOpenFileName(
+                Q_NULLPTR,
+                tr("Select raw capture file"),
+                IO::RawCapture::instance().directory(),
+                tr("Raw captures") + " (*.ssraw)");
+
+    // Open capture file
+    if (!file.isEmpty())
+        openFile(file);
+
+  // clang-format on
+}
+
+/**
+ * Selects the capture file at the given @a path, the file is validated &
+ * indexed immediately so that its information can be shown to the user.
+ */
+void IO::Drivers::Replay::openFile(const QString &path)
+{
+  // Stop replaying the current file
+  if (m_open)
+    IO::Manager::instance().disconnectDriver();
+
+  m_chunk = 0;
+  // Open & index the capture
+  QString error;
+  if (!m_capture.open(path, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Cannot open raw capture file"),
+                                    error);
+  }
+
+  // Remember the file for the next session
+  else
+    m_settings.setValue("IO_Replay_File", path);
+
+  // Update UI
+  Q_EMIT fileChanged();
+  Q_EMIT progressChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Selects whether chunks are delivered with their original timing or as fast
+ * as possible. The change is applied to the replay in progress.
+ */
+void IO::Drivers::Replay::setRealTime(const bool realTime)
+{
+  if (m_realTime != realTime)
+  {
+    m_realTime = realTime;
+    m_settings.setValue("IO_Replay_RealTime", realTime);
+
+    // Continue the real-time replay from the current chunk
+    if (m_open && realTime && m_chunk < m_capture.chunkCount())
+    {
+      const auto offset = m_capture.timestamp(m_chunk)
+                          - m_capture.timestamp(0);
+      m_startTime = FrameQueue::timestamp() - offset;
+    }
+
+    Q_EMIT realTimeChanged();
+  }
+}
+
+/**
+ * Delivers the chunks that are due to the I/O manager & schedules the next
+ * call. In real-time mode, chunks are timestamped with the time at which they
+ * are due, so that the intervals of the original traffic are preserved even
+ * if the timer fires late.
+ */
+void IO::Drivers::Replay::replayChunks()
+{
+  // Replay stopped
+  if (!m_open)
+    return;
+
+  // Deliver pending chunks
+  qint64 bytes = 0;
+  const auto now = FrameQueue::timestamp();
+  const auto count = m_capture.chunkCount();
+  const auto first = m_capture.timestamp(0);
+  while (m_chunk < count)
+  {
+    // Stop when the next chunk is not due yet or a batch is completed
+    const auto due = m_startTime + m_capture.timestamp(m_chunk) - first;
+    if (m_realTime && due > now)
+      break;
+    if (!m_realTime && bytes >= MAX_BATCH_BYTES)
+      break;
+
+    // Read the chunk, a read error ends the replay
+    if (!m_capture.read(m_chunk, m_chunkData))
+    {
+      m_chunk = count;
+      break;
+    }
+
+    // Hand the chunk to the I/O manager
+    ++m_chunk;
+    bytes += m_chunkData.size();
+    Q_EMIT dataReceived(m_chunkData, m_realTime ? due : now);
+  }
+
+  // Update UI
+  Q_EMIT progressChanged();
+
+  // End of the capture, close the connection
+  if (m_chunk >= count)
+  {
+    QTimer::singleShot(0, &IO::Manager::instance(),
+                       &IO::Manager::disconnectDriver);
+    return;
+  }
+
+  // Schedule the next chunk
+  if (m_realTime)
+  {
+    const auto due = m_startTime + m_capture.timestamp(m_chunk) - first;
+    const auto delay = (due - FrameQueue::timestamp()) / 1000;
+    m_timer.start(static_cast<int>(qBound<qint64>(0, delay, 1000)));
+  }
+
+  else
+    m_timer.start(0);
+}
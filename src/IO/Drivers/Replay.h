@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+
+#include <IO/HAL_Driver.h>
+#include <IO/RawCaptureFile.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The Replay class
+ *
+ * Serial Studio "driver" class that feeds a raw capture file (see
+ * @c IO::RawCapture) back into the I/O manager, so that the recorded traffic
+ * goes through the complete frame pipeline again (framing, checksums, frame
+ * parser, dashboard, exporters...).
+ *
+ * Chunks are delivered either with the timing at which they were originally
+ * received (real-time mode), or as fast as the event loop allows, which turns
+ * a capture into a repeatable performance test. The connection is closed
+ * automatically when the end of the capture is reached.
+ */
+class Replay : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY fileChanged)
+    Q_PROPERTY(int chunkCount
+               READ chunkCount
+               NOTIFY fileChanged)
+    Q_PROPERTY(qint64 totalBytes
+               READ totalBytes
+               NOTIFY fileChanged)
+    Q_PROPERTY(qint64 duration
+               READ duration
+               NOTIFY fileChanged)
+    Q_PROPERTY(bool realTime
+               READ realTime
+               WRITE setRealTime
+               NOTIFY realTimeChanged)
+    Q_PROPERTY(double progress
+               READ progress
+               NOTIFY progressChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void fileChanged();
+  void realTimeChanged();
+  void progressChanged();
+
+private:
+  explicit Replay();
+  Replay(Replay &&) = delete;
+  Replay(const Replay &) = delete;
+  Replay &operator=(Replay &&) = delete;
+  Replay &operator=(const Replay &) = delete;
+
+public:
+  static Replay &instance();
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  QString fileName() const;
+  int chunkCount() const;
+  qint64 totalBytes() const;
+  qint64 duration() const;
+  bool realTime() const;
+  double progress() const;
+
+public Q_SLOTS:
+  void openFile();
+  void openFile(const QString &path);
+  void setRealTime(const bool realTime);
+
+private Q_SLOTS:
+  void replayChunks();
+
+private:
+  bool m_open;
+  bool m_realTime;
+  int m_chunk;
+  qint64 m_startTime;
+
+  QTimer m_timer;
+  Misc::Settings m_settings;
+  QByteArray m_chunkData;
+  RawCaptureFile m_capture;
+};
+} // namespace Drivers
+} // namespace IO
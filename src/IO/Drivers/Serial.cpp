@@ -20,11 +20,93 @@
  * THE SOFTWARE.
  */
 
+#include <QFile>
+#include <QThread>
+
 #include <IO/Manager.h>
+#include <IO/FrameQueue.h>
 #include <IO/Drivers/Serial.h>
 
 #include <Misc/Utilities.h>
-#include <Misc/TimerEvents.h>
+
+#if defined(Q_OS_LINUX)
+#  include <sys/ioctl.h>
+#  include <linux/serial.h>
+#elif defined(Q_OS_MACOS)
+#  include <sys/ioctl.h>
+#  include <IOKit/serial/ioss.h>
+#endif
+
+/**
+ * Interval (in milliseconds) at which the CTS line of a serial port that is
+ * read by the worker thread is polled, matches the write queue interval
+ */
+static const int CTS_POLL_INTERVAL = 5;
+
+/**
+ * Configures the driver of the serial port with the given native @a handle &
+ * @a portName to hand over received
+ * data to the application as soon as possible:
+ *
+ * - On Linux, the @c ASYNC_LOW_LATENCY flag of the serial driver is set and,
+ *   for FTDI adapters, the latency timer of the USB device is reduced from
+ *   16 ms to 1 ms (this requires write access to sysfs).
+ * - On macOS, the receive latency of the IOKit serial driver is set to 1 us.
+ * - On Windows, @c QSerialPort already uses overlapped reads that complete
+ *   as soon as any byte is received (@c ReadIntervalTimeout = @c MAXDWORD),
+ *   the latency timer of FTDI adapters must be set in the device settings.
+ */
+static void SET_LOW_LATENCY(const qintptr handle, const QString &portName,
+                            const bool enabled)
+{
+#if defined(Q_OS_LINUX)
+  // Set the low-latency flag of the serial driver
+  const int fd = static_cast<int>(handle);
+  struct serial_struct serial;
+  if (ioctl(fd, TIOCGSERIAL, &serial) == 0)
+  {
+    if (enabled)
+      serial.flags |= ASYNC_LOW_LATENCY;
+    else
+      serial.flags &= ~ASYNC_LOW_LATENCY;
+
+    ioctl(fd, TIOCSSERIAL, &serial);
+  }
+
+  // Change the latency timer of FTDI adapters
+  const auto path = QStringLiteral("/sys/bus/usb-serial/devices/%1/%2");
+  QFile timer(path.arg(portName, "latency_timer"));
+  if (timer.exists() && timer.open(QIODevice::WriteOnly))
+    timer.write(enabled ? "1" : "16");
+#elif defined(Q_OS_MACOS)
+  // Change the receive latency (in microseconds) of the serial driver
+  Q_UNUSED(portName);
+  const int fd = static_cast<int>(handle);
+  unsigned long latency = enabled ? 1 : 0;
+  ioctl(fd, IOSSDATALAT, &latency);
+#else
+  Q_UNUSED(handle);
+  Q_UNUSED(portName);
+  Q_UNUSED(enabled);
+#endif
+}
+
+/**
+ * Calls the given @a function in the thread of the serial @a port: directly if
+ * the port lives in the current thread (or if its thread is not running), or
+ * through the event loop of the port's thread with the given connection
+ * @a type otherwise.
+ */
+template<typename Function>
+static void RUN_IN_PORT_THREAD(QSerialPort *port, Function function,
+                               const Qt::ConnectionType type)
+{
+  auto thread = port->thread();
+  if (thread == QThread::currentThread() || !thread->isRunning())
+    function();
+  else
+    QMetaObject::invokeMethod(port, function, type);
+}
 
 //----------------------------------------------------------------------------------------
 // Constructor/destructor & singleton access functions
@@ -35,13 +117,32 @@
  */
 IO::Drivers::Serial::Serial()
   : m_port(Q_NULLPTR)
+  , m_ctsTimer(Q_NULLPTR)
+  , m_clearToSend(true)
+  , m_bytesToWrite(0)
   , m_autoReconnect(false)
   , m_lastSerialDeviceIndex(0)
+  , m_lowLatency(false)
+  , m_nativeBackend(false)
+  , m_readBufferSize(0)
+  , m_minChunkSize(0)
+  , m_maxChunkDelay(5)
+  , m_chunkTimestamp(0)
   , m_portIndex(0)
 {
   // Read settings
   readSettings();
 
+  // Allow serial port errors to be reported from the worker thread
+  qRegisterMetaType<QSerialPort::SerialPortError>(
+      "QSerialPort::SerialPortError");
+
+  // Configure read chunking timer
+  m_chunkTimer.setSingleShot(true);
+  m_chunkTimer.setTimerType(Qt::PreciseTimer);
+  connect(&m_chunkTimer, &QTimer::timeout, this,
+          &IO::Drivers::Serial::flushChunk);
+
   // Init serial port configuration variables
   setBaudRate(9600);
   disconnectDevice();
@@ -52,14 +153,20 @@ IO::Drivers::Serial::Serial()
 
   // clang-format off
 
-    // Build serial devices list and refresh it every second
-    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+    // Rebuild serial devices list when a device is plugged or unplugged
+    connect(&m_portWatcher, &IO::Drivers::PortWatcher::portsChanged,
             this, &IO::Drivers::Serial::refreshSerialDevices);
 
     // Update connect button status when user selects a serial device
     connect(this, &IO::Drivers::Serial::portIndexChanged,
             this, &IO::Drivers::Serial::configurationChanged);
 
+    // Process data & errors of the native backend
+    connect(&m_native, &IO::Drivers::NativeSerial::dataReceived,
+            this, &IO::Drivers::Serial::processData);
+    connect(&m_native, &IO::Drivers::NativeSerial::errorOccurred,
+            this, [] { Manager::instance().connectionLost(); });
+
   // clang-format on
 }
 
@@ -71,7 +178,7 @@ IO::Drivers::Serial::~Serial()
 {
   writeSettings();
 
-  if (port())
+  if (port() || m_native.isOpen())
     disconnectDevice();
 }
 
@@ -93,8 +200,11 @@ IO::Drivers::Serial &IO::Drivers::Serial::instance()
  */
 void IO::Drivers::Serial::close()
 {
-  if (isOpen())
-    port()->close();
+  if (m_native.isOpen())
+    m_native.close();
+
+  else if (isOpen())
+    closePort();
 }
 
 /**
@@ -102,6 +212,9 @@ void IO::Drivers::Serial::close()
  */
 bool IO::Drivers::Serial::isOpen() const
 {
+  if (m_native.isOpen())
+    return true;
+
   if (port())
     return port()->isOpen();
 
@@ -113,6 +226,9 @@ bool IO::Drivers::Serial::isOpen() const
  */
 bool IO::Drivers::Serial::isReadable() const
 {
+  if (m_native.isOpen())
+    return m_native.isReadable();
+
   if (isOpen())
     return port()->isReadable();
 
@@ -124,6 +240,9 @@ bool IO::Drivers::Serial::isReadable() const
  */
 bool IO::Drivers::Serial::isWritable() const
 {
+  if (m_native.isOpen())
+    return m_native.isWritable();
+
   if (isOpen())
     return port()->isWritable();
 
@@ -145,12 +264,70 @@ bool IO::Drivers::Serial::configurationOk() const
  */
 quint64 IO::Drivers::Serial::write(const QByteArray &data)
 {
+  if (m_native.isWritable())
+    return m_native.write(data);
+
   if (isWritable())
-    return port()->write(data);
+  {
+    // Write directly to a port that lives in the current thread
+    auto device = m_port;
+    if (device->thread() == thread())
+      return device->write(data);
+
+    // Queue the data for the worker thread that owns the port
+    m_bytesToWrite += data.size();
+    QMetaObject::invokeMethod(
+        device,
+        [=] {
+          if (device->write(data) < 0)
+            m_bytesToWrite -= data.size();
+        },
+        Qt::QueuedConnection);
+
+    return data.size();
+  }
 
   return -1;
 }
 
+/**
+ * Returns the number of bytes written to the serial port that have not been
+ * transmitted yet
+ */
+qint64 IO::Drivers::Serial::bytesToWrite() const
+{
+  if (m_native.isOpen())
+    return m_native.bytesToWrite();
+
+  if (port())
+  {
+    if (port()->thread() != thread())
+      return m_bytesToWrite;
+
+    return port()->bytesToWrite();
+  }
+
+  return 0;
+}
+
+/**
+ * Returns @c false if hardware flow control is enabled & the device has
+ * de-asserted the CTS line
+ */
+bool IO::Drivers::Serial::clearToSend() const
+{
+  if (m_native.isOpen())
+    return m_native.clearToSend();
+
+  if (!port() || flowControl() != QSerialPort::HardwareControl)
+    return true;
+
+  if (port()->thread() != thread())
+    return m_clearToSend;
+
+  return port()->pinoutSignals().testFlag(QSerialPort::ClearToSendSignal);
+}
+
 /**
  * Connects to the currently selected serial port device, returns @c true on
  * success
@@ -168,25 +345,81 @@ bool IO::Drivers::Serial::open(const QIODevice::OpenMode mode)
     m_lastSerialDeviceIndex = m_portIndex;
     Q_EMIT portIndexChanged();
 
+    // Open the device with the native backend
+    if (nativeBackend())
+    {
+      updateNativeConfiguration();
+      if (m_native.open(ports.at(portId), mode))
+      {
+        if (lowLatency())
+          SET_LOW_LATENCY(m_native.handle(), m_native.portName(), true);
+
+        Q_EMIT portChanged();
+        return true;
+      }
+
+      disconnectDevice();
+      return false;
+    }
+
     // Create new serial port handler
     m_port = new QSerialPort(ports.at(portId));
 
     // Configure serial port
-    port()->setParity(parity());
-    port()->setBaudRate(baudRate());
-    port()->setDataBits(dataBits());
-    port()->setStopBits(stopBits());
-    port()->setFlowControl(flowControl());
+    updatePortConfiguration();
+    port()->setReadBufferSize(readBufferSize());
 
     // Connect signals/slots
     connect(port(), SIGNAL(errorOccurred(QSerialPort::SerialPortError)), this,
             SLOT(handleError(QSerialPort::SerialPortError)));
 
-    // Open device
-    if (port()->open(mode))
+    // Read the port in the worker thread of the I/O manager (if enabled)
+    auto device = m_port;
+    auto worker = Manager::instance().workerThread();
+    if (worker)
     {
+      m_bytesToWrite = 0;
+      m_clearToSend = true;
+      m_ctsTimer = new QTimer(device);
+      m_ctsTimer->setInterval(CTS_POLL_INTERVAL);
+      device->moveToThread(worker);
+      connect(device, &QIODevice::readyRead, device, [=] {
+        const auto time = FrameQueue::timestamp();
+        Manager::instance().processWorkerData(device->readAll(), time);
+      });
+      connect(device, &QIODevice::bytesWritten, device,
+              [=](const qint64 bytes) { m_bytesToWrite -= bytes; });
+      connect(m_ctsTimer, &QTimer::timeout, device, [=] {
+        if (device->flowControl() == QSerialPort::HardwareControl)
+        {
+          const auto pins = device->pinoutSignals();
+          m_clearToSend = pins.testFlag(QSerialPort::ClearToSendSignal);
+        }
+      });
+    }
+
+    // Read the port in the main thread
+    else
       connect(port(), &QIODevice::readyRead, this,
               &IO::Drivers::Serial::onReadyRead);
+
+    // Open device
+    bool opened = false;
+    auto ctsTimer = m_ctsTimer;
+    RUN_IN_PORT_THREAD(
+        device,
+        [&] {
+          opened = device->open(mode);
+          if (opened && ctsTimer)
+            ctsTimer->start();
+        },
+        Qt::BlockingQueuedConnection);
+
+    if (opened)
+    {
+      if (lowLatency())
+        SET_LOW_LATENCY(port()->handle(), port()->portName(), true);
+
       return true;
     }
   }
@@ -205,6 +438,9 @@ bool IO::Drivers::Serial::open(const QIODevice::OpenMode mode)
  */
 QString IO::Drivers::Serial::portName() const
 {
+  if (m_native.isOpen())
+    return m_native.portName();
+
   if (port())
     return port()->portName();
 
@@ -227,6 +463,51 @@ bool IO::Drivers::Serial::autoReconnect() const
   return m_autoReconnect;
 }
 
+/**
+ * Returns @c true if the serial driver is configured to deliver received data
+ * with the lowest possible latency.
+ */
+bool IO::Drivers::Serial::lowLatency() const
+{
+  return m_lowLatency;
+}
+
+/**
+ * Returns @c true if serial ports are opened with the @c NativeSerial backend
+ * instead of @c QSerialPort.
+ */
+bool IO::Drivers::Serial::nativeBackend() const
+{
+  return m_nativeBackend;
+}
+
+/**
+ * Returns the size (in bytes) of the internal read buffer of the serial port,
+ * zero means that the buffer size is not limited.
+ */
+int IO::Drivers::Serial::readBufferSize() const
+{
+  return m_readBufferSize;
+}
+
+/**
+ * Returns the minimum number of bytes that are accumulated before received
+ * data is handed over to the I/O manager, zero disables accumulation.
+ */
+int IO::Drivers::Serial::minChunkSize() const
+{
+  return m_minChunkSize;
+}
+
+/**
+ * Returns the maximum time (in milliseconds) that received data is held while
+ * waiting for the minimum chunk size to be reached.
+ */
+int IO::Drivers::Serial::maxChunkDelay() const
+{
+  return m_maxChunkDelay;
+}
+
 /**
  * Returns the index of the current serial device selected by the program.
  */
@@ -389,15 +670,27 @@ QSerialPort::FlowControl IO::Drivers::Serial::flowControl() const
  */
 void IO::Drivers::Serial::disconnectDevice()
 {
+  // Close the native backend
+  if (m_native.isOpen())
+  {
+    m_chunk.clear();
+    m_chunkTimer.stop();
+    m_native.close();
+  }
+
   // Check if serial port pointer is valid
   if (port() != Q_NULLPTR)
   {
+    // Discard accumulated data
+    m_chunk.clear();
+    m_chunkTimer.stop();
+
     // Disconnect signals/slots
     port()->disconnect(this, SLOT(onReadyRead()));
     port()->disconnect(this, SLOT(handleError(QSerialPort::SerialPortError)));
 
     // Close & delete serial port handler
-    port()->close();
+    closePort();
     port()->deleteLater();
   }
 
@@ -420,7 +713,9 @@ void IO::Drivers::Serial::setBaudRate(const qint32 rate)
 
   // Update serial port config
   if (port())
-    port()->setBaudRate(baudRate());
+    updatePortConfiguration();
+  else if (m_native.isOpen())
+    updateNativeConfiguration();
 
   // Update user interface
   Q_EMIT baudRateChanged();
@@ -475,7 +770,9 @@ void IO::Drivers::Serial::setParity(const quint8 parityIndex)
 
   // Update serial port config.
   if (port())
-    port()->setParity(parity());
+    updatePortConfiguration();
+  else if (m_native.isOpen())
+    updateNativeConfiguration();
 
   // Notify user interface
   Q_EMIT parityChanged();
@@ -530,7 +827,9 @@ void IO::Drivers::Serial::setDataBits(const quint8 dataBitsIndex)
 
   // Update serial port configuration
   if (port())
-    port()->setDataBits(dataBits());
+    updatePortConfiguration();
+  else if (m_native.isOpen())
+    updateNativeConfiguration();
 
   // Update user interface
   Q_EMIT dataBitsChanged();
@@ -566,7 +865,9 @@ void IO::Drivers::Serial::setStopBits(const quint8 stopBitsIndex)
 
   // Update serial port configuration
   if (port())
-    port()->setStopBits(stopBits());
+    updatePortConfiguration();
+  else if (m_native.isOpen())
+    updateNativeConfiguration();
 
   // Update user interface
   Q_EMIT stopBitsChanged();
@@ -581,6 +882,86 @@ void IO::Drivers::Serial::setAutoReconnect(const bool autoreconnect)
   Q_EMIT autoReconnectChanged();
 }
 
+/**
+ * Enables or disables the low-latency mode of the serial driver, the change
+ * is applied immediately if a device is connected.
+ */
+void IO::Drivers::Serial::setLowLatency(const bool enabled)
+{
+  if (m_lowLatency != enabled)
+  {
+    m_lowLatency = enabled;
+    m_settings.setValue("IO_DataSource_Serial__LowLatency", enabled);
+
+    if (m_native.isOpen())
+      SET_LOW_LATENCY(m_native.handle(), m_native.portName(), enabled);
+    else if (port() && port()->isOpen())
+      SET_LOW_LATENCY(port()->handle(), port()->portName(), enabled);
+
+    Q_EMIT lowLatencyChanged();
+  }
+}
+
+/**
+ * Enables or disables the @c NativeSerial backend, the change is applied the
+ * next time that a device is connected.
+ */
+void IO::Drivers::Serial::setNativeBackend(const bool enabled)
+{
+  if (m_nativeBackend != enabled)
+  {
+    m_nativeBackend = enabled;
+    m_settings.setValue("IO_DataSource_Serial__NativeBackend", enabled);
+    Q_EMIT nativeBackendChanged();
+  }
+}
+
+/**
+ * Changes the size (in bytes) of the internal read buffer of the serial port,
+ * zero means that the buffer size is not limited.
+ */
+void IO::Drivers::Serial::setReadBufferSize(const int bytes)
+{
+  m_readBufferSize = qBound(0, bytes, 16 * 1024 * 1024);
+  m_settings.setValue("IO_DataSource_Serial__ReadBufferSize", m_readBufferSize);
+
+  if (port())
+  {
+    auto device = m_port;
+    const auto size = m_readBufferSize;
+    RUN_IN_PORT_THREAD(
+        device, [=] { device->setReadBufferSize(size); }, Qt::QueuedConnection);
+  }
+
+  Q_EMIT readChunkingChanged();
+}
+
+/**
+ * Changes the minimum number of bytes that are accumulated before received
+ * data is handed over to the I/O manager, zero disables accumulation.
+ */
+void IO::Drivers::Serial::setMinChunkSize(const int bytes)
+{
+  m_minChunkSize = qBound(0, bytes, 64 * 1024);
+  m_settings.setValue("IO_DataSource_Serial__MinChunkSize", m_minChunkSize);
+
+  if (m_minChunkSize == 0)
+    flushChunk();
+
+  Q_EMIT readChunkingChanged();
+}
+
+/**
+ * Changes the maximum time (in milliseconds) that received data is held while
+ * waiting for the minimum chunk size to be reached.
+ */
+void IO::Drivers::Serial::setMaxChunkDelay(const int milliseconds)
+{
+  m_maxChunkDelay = qBound(1, milliseconds, 1000);
+  m_settings.setValue("IO_DataSource_Serial__MaxChunkDelay", m_maxChunkDelay);
+  Q_EMIT readChunkingChanged();
+}
+
 /**
  * Changes the flow control option of the serial port.
  *
@@ -611,7 +992,9 @@ void IO::Drivers::Serial::setFlowControl(const quint8 flowControlIndex)
 
   // Update serial port configuration
   if (port())
-    port()->setFlowControl(flowControl());
+    updatePortConfiguration();
+  else if (m_native.isOpen())
+    updateNativeConfiguration();
 
   // Update user interface
   Q_EMIT flowControlChanged();
@@ -646,9 +1029,9 @@ void IO::Drivers::Serial::refreshSerialDevices()
     m_portList = ports;
 
     // Update current port index
-    if (port())
+    if (port() || m_native.isOpen())
     {
-      auto name = port()->portName();
+      auto name = portName();
       for (int i = 0; i < validPortList.count(); ++i)
       {
         auto info = validPortList.at(i);
@@ -685,7 +1068,7 @@ void IO::Drivers::Serial::refreshSerialDevices()
 void IO::Drivers::Serial::handleError(QSerialPort::SerialPortError error)
 {
   if (error != QSerialPort::NoError)
-    Manager::instance().disconnectDriver();
+    Manager::instance().connectionLost();
 }
 
 /**
@@ -694,8 +1077,51 @@ void IO::Drivers::Serial::handleError(QSerialPort::SerialPortError error)
  */
 void IO::Drivers::Serial::onReadyRead()
 {
-  if (isOpen())
-    Q_EMIT dataReceived(port()->readAll());
+  // Device not open
+  if (!isOpen())
+    return;
+
+  processData(port()->readAll(), FrameQueue::timestamp());
+}
+
+/**
+ * Hands over the received @a data to the @c IO::Manager class, or accumulates
+ * it until the minimum chunk size is reached.
+ */
+void IO::Drivers::Serial::processData(const QByteArray &data,
+                                      const qint64 timestamp)
+{
+  // Hand over received data immediately
+  if (m_minChunkSize <= 0)
+  {
+    Q_EMIT dataReceived(data, timestamp);
+    return;
+  }
+
+  // Accumulate data until the minimum chunk size or the maximum delay is met,
+  // the chunk keeps the reception time of its first byte
+  if (m_chunk.isEmpty())
+    m_chunkTimestamp = timestamp;
+
+  m_chunk.append(data);
+  if (m_chunk.size() >= m_minChunkSize)
+    flushChunk();
+  else if (!m_chunkTimer.isActive())
+    m_chunkTimer.start(m_maxChunkDelay);
+}
+
+/**
+ * Sends the accumulated data to the @c IO::Manager class
+ */
+void IO::Drivers::Serial::flushChunk()
+{
+  m_chunkTimer.stop();
+  if (m_chunk.isEmpty())
+    return;
+
+  const auto data = m_chunk;
+  m_chunk.clear();
+  Q_EMIT dataReceived(data, m_chunkTimestamp);
 }
 
 /**
@@ -733,6 +1159,18 @@ void IO::Drivers::Serial::readSettings()
   }
 #endif
 
+  // Read low-latency & read chunking options
+  auto lowLatency = m_settings.value("IO_DataSource_Serial__LowLatency", false);
+  auto native = m_settings.value("IO_DataSource_Serial__NativeBackend", false);
+  auto bufferSize = m_settings.value("IO_DataSource_Serial__ReadBufferSize", 0);
+  auto chunkSize = m_settings.value("IO_DataSource_Serial__MinChunkSize", 0);
+  auto chunkDelay = m_settings.value("IO_DataSource_Serial__MaxChunkDelay", 5);
+  m_lowLatency = lowLatency.toBool();
+  m_nativeBackend = native.toBool();
+  m_readBufferSize = qBound(0, bufferSize.toInt(), 16 * 1024 * 1024);
+  m_minChunkSize = qBound(0, chunkSize.toInt(), 64 * 1024);
+  m_maxChunkDelay = qBound(1, chunkDelay.toInt(), 1000);
+
   // Notify UI
   Q_EMIT baudRateListChanged();
 }
@@ -769,27 +1207,67 @@ void IO::Drivers::Serial::writeSettings()
 }
 
 /**
- * Returns a list with all the valid serial port objects
+ * Returns a list with all the valid serial port objects, the list is updated
+ * in the background by the port watcher.
  */
 QVector<QSerialPortInfo> IO::Drivers::Serial::validPorts() const
 {
-  // Search for available ports and add them to the list
-  QVector<QSerialPortInfo> ports;
-  Q_FOREACH (QSerialPortInfo info, QSerialPortInfo::availablePorts())
-  {
-    if (!info.isNull())
-    {
-      // Only accept *.cu devices on macOS (remove *.tty)
-      // https://stackoverflow.com/a/37688347
-#ifdef Q_OS_MACOS
-      if (info.portName().toLower().startsWith("tty."))
-        continue;
-#endif
-      // Append port to list
-      ports.append(info);
-    }
-  }
+  return m_portWatcher.ports();
+}
+
+/**
+ * Applies the current line configuration to the native backend
+ */
+void IO::Drivers::Serial::updateNativeConfiguration()
+{
+  m_native.configure(baudRate(), dataBits(), parity(), stopBits(),
+                     flowControl());
+}
 
-  // Return list
-  return ports;
+/**
+ * Applies the current line configuration to the serial port handler, the
+ * configuration is applied in the thread that owns the port.
+ */
+void IO::Drivers::Serial::updatePortConfiguration()
+{
+  auto device = m_port;
+  const auto rate = baudRate();
+  const auto bits = dataBits();
+  const auto parityMode = parity();
+  const auto stop = stopBits();
+  const auto flow = flowControl();
+  RUN_IN_PORT_THREAD(
+      device,
+      [=] {
+        device->setParity(parityMode);
+        device->setBaudRate(rate);
+        device->setDataBits(bits);
+        device->setStopBits(stop);
+        device->setFlowControl(flow);
+      },
+      Qt::QueuedConnection);
+}
+
+/**
+ * Closes the serial port handler. If the port is read by the worker thread of
+ * the I/O manager, it is closed there & moved back to the main thread, so that
+ * it can be deleted safely.
+ */
+void IO::Drivers::Serial::closePort()
+{
+  auto device = m_port;
+  auto ctsTimer = m_ctsTimer;
+  auto mainThread = thread();
+  RUN_IN_PORT_THREAD(
+      device,
+      [=] {
+        delete ctsTimer;
+        device->close();
+        device->moveToThread(mainThread);
+      },
+      Qt::BlockingQueuedConnection);
+
+  m_ctsTimer = Q_NULLPTR;
+  m_clearToSend = true;
+  m_bytesToWrite = 0;
 }
@@ -24,10 +24,15 @@
 
 #include <DataTypes.h>
 #include <IO/HAL_Driver.h>
+#include <IO/Drivers/PortWatcher.h>
+#include <IO/Drivers/NativeSerial.h>
+#include <Misc/Settings.h>
 
+#include <atomic>
+
+#include <QTimer>
 #include <QObject>
 #include <QString>
-#include <QSettings>
 #include <QByteArray>
 #include <QtSerialPort>
 #include <QTextCursor>
@@ -40,6 +45,15 @@ namespace Drivers
 /**
  * @brief The Serial class
  * Serial Studio driver class to interact with serial port devices.
+ *
+ * If threaded frame extraction is enabled in the @c IO::Manager, the
+ * @c QSerialPort handler is opened & read in the worker thread of the manager,
+ * and the received data is handed directly to the frame reader, so that the
+ * port is drained & framed even while the user interface is busy (read
+ * chunking is not used in this case). Configuration changes & written data
+ * are handed to the port through queued calls, and the state of the CTS line
+ * is polled in the worker thread, so that @c clearToSend() never waits for
+ * it.
  */
 class Serial : public HAL_Driver
 {
@@ -52,6 +66,26 @@ class Serial : public HAL_Driver
                READ autoReconnect
                WRITE setAutoReconnect
                NOTIFY autoReconnectChanged)
+    Q_PROPERTY(bool lowLatency
+               READ lowLatency
+               WRITE setLowLatency
+               NOTIFY lowLatencyChanged)
+    Q_PROPERTY(bool nativeBackend
+               READ nativeBackend
+               WRITE setNativeBackend
+               NOTIFY nativeBackendChanged)
+    Q_PROPERTY(int readBufferSize
+               READ readBufferSize
+               WRITE setReadBufferSize
+               NOTIFY readChunkingChanged)
+    Q_PROPERTY(int minChunkSize
+               READ minChunkSize
+               WRITE setMinChunkSize
+               NOTIFY readChunkingChanged)
+    Q_PROPERTY(int maxChunkDelay
+               READ maxChunkDelay
+               WRITE setMaxChunkDelay
+               NOTIFY readChunkingChanged)
     Q_PROPERTY(quint8 portIndex
                READ portIndex
                WRITE setPortIndex
@@ -103,7 +137,10 @@ Q_SIGNALS:
   void dataBitsChanged();
   void stopBitsChanged();
   void portIndexChanged();
+  void lowLatencyChanged();
   void flowControlChanged();
+  void nativeBackendChanged();
+  void readChunkingChanged();
   void baudRateListChanged();
   void autoReconnectChanged();
   void baudRateIndexChanged();
@@ -132,10 +169,17 @@ public:
   bool configurationOk() const override;
   quint64 write(const QByteArray &data) override;
   bool open(const QIODevice::OpenMode mode) override;
+  qint64 bytesToWrite() const override;
+  bool clearToSend() const override;
 
   QString portName() const;
   QSerialPort *port() const;
   bool autoReconnect() const;
+  bool lowLatency() const;
+  bool nativeBackend() const;
+  int readBufferSize() const;
+  int minChunkSize() const;
+  int maxChunkDelay() const;
 
   quint8 portIndex() const;
   quint8 parityIndex() const;
@@ -166,10 +210,17 @@ public Q_SLOTS:
   void setDataBits(const quint8 dataBitsIndex);
   void setStopBits(const quint8 stopBitsIndex);
   void setAutoReconnect(const bool autoreconnect);
+  void setLowLatency(const bool enabled);
+  void setNativeBackend(const bool enabled);
+  void setReadBufferSize(const int bytes);
+  void setMinChunkSize(const int bytes);
+  void setMaxChunkDelay(const int milliseconds);
   void setFlowControl(const quint8 flowControlIndex);
 
 private Q_SLOTS:
   void onReadyRead();
+  void flushChunk();
+  void processData(const QByteArray &data, const qint64 timestamp);
   void readSettings();
   void writeSettings();
   void refreshSerialDevices();
@@ -177,15 +228,31 @@ private Q_SLOTS:
 
 private:
   QVector<QSerialPortInfo> validPorts() const;
+  void updateNativeConfiguration();
+  void updatePortConfiguration();
+  void closePort();
 
 private:
   QSerialPort *m_port;
+  QTimer *m_ctsTimer;
+  std::atomic<bool> m_clearToSend;
+  std::atomic<qint64> m_bytesToWrite;
 
   bool m_autoReconnect;
   int m_lastSerialDeviceIndex;
 
+  bool m_lowLatency;
+  bool m_nativeBackend;
+  NativeSerial m_native;
+  int m_readBufferSize;
+  int m_minChunkSize;
+  int m_maxChunkDelay;
+  QTimer m_chunkTimer;
+  QByteArray m_chunk;
+  qint64 m_chunkTimestamp;
+
   qint32 m_baudRate;
-  QSettings m_settings;
+  Misc::Settings m_settings;
   QSerialPort::Parity m_parity;
   QSerialPort::DataBits m_dataBits;
   QSerialPort::StopBits m_stopBits;
@@ -199,6 +266,7 @@ private:
 
   StringList m_portList;
   StringList m_baudRateList;
+  PortWatcher m_portWatcher;
 };
 } // namespace Drivers
 } // namespace IO
@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include <QTimer>
+#include <QFileInfo>
+#include <QFileDialog>
+
+#if defined(Q_OS_WIN)
+#  include <io.h>
+#  include <fcntl.h>
+#  include <windows.h>
+#else
+#  include <poll.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/stat.h>
+#endif
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/Drivers/Stream.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Maximum number of bytes obtained with a single read
+ */
+static const int READ_SIZE = 1024 * 1024;
+
+/**
+ * Time (in milliseconds) that the reader waits for data before checking if it
+ * must stop, also used as the polling interval for files that are followed.
+ */
+static const int POLL_INTERVAL = 100;
+
+/**
+ * File descriptor of the standard input
+ */
+static const int STDIN_FD = 0;
+
+/**
+ * Waits up to @a timeout milliseconds until the given file descriptor can be
+ * read without blocking, returns @c true if data (or the end of the stream)
+ * is available.
+ */
+static bool WAIT_READABLE(const int fd, const int timeout)
+{
+#if defined(Q_OS_WIN)
+  auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  switch (GetFileType(handle))
+  {
+    case FILE_TYPE_PIPE: {
+      DWORD available = 0;
+      if (!PeekNamedPipe(handle, NULL, 0, NULL, &available, NULL))
+        return true;
+      if (available > 0)
+        return true;
+
+      Sleep(qMin(timeout, 10));
+      return false;
+    }
+    case FILE_TYPE_CHAR:
+      return WaitForSingleObject(handle, timeout) == WAIT_OBJECT_0;
+    default:
+      return true;
+  }
+#else
+  struct pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return poll(&pfd, 1, timeout) > 0;
+#endif
+}
+
+/**
+ * Reads up to @a size bytes from the given file descriptor into @a buffer
+ */
+static qint64 READ(const int fd, char *buffer, const int size)
+{
+#if defined(Q_OS_WIN)
+  return _read(fd, buffer, static_cast<unsigned int>(size));
+#else
+  return ::read(fd, buffer, static_cast<size_t>(size));
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// Reader implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::StreamReader::StreamReader()
+  : m_running(false)
+{
+}
+
+/**
+ * Stops the read loop, this function can be called from any thread
+ */
+void IO::Drivers::StreamReader::stop()
+{
+  m_running = false;
+}
+
+/**
+ * Reads the given file descriptor until @c stop() is called or the end of
+ * the stream is reached. If @a follow is @c true, the reader waits for new
+ * data at the end of the stream (e.g. a log file that is still growing).
+ */
+void IO::Drivers::StreamReader::run(const int fd, const bool follow)
+{
+  QByteArray buffer;
+  m_running = true;
+  while (m_running)
+  {
+    // Wait for data
+    if (!WAIT_READABLE(fd, POLL_INTERVAL))
+      continue;
+
+    // Read as much data as possible
+    buffer.resize(READ_SIZE);
+    const auto bytes = READ(fd, buffer.data(), READ_SIZE);
+    if (bytes > 0)
+    {
+      buffer.resize(static_cast<int>(bytes));
+      Q_EMIT dataReceived(buffer, IO::FrameQueue::timestamp());
+      continue;
+    }
+
+    // Interrupted or no data available yet
+    if (bytes < 0 && (errno == EINTR || errno == EAGAIN))
+      continue;
+
+    // End of a followed file, wait for more data
+    if (bytes == 0 && follow)
+    {
+      QThread::msleep(POLL_INTERVAL);
+      continue;
+    }
+
+    // End of the stream or read error
+    break;
+  }
+
+  // Notify the driver if the stream ended by itself
+  if (m_running)
+  {
+    m_running = false;
+    Q_EMIT finished();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// Driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, restores the last source & starts the reader thread
+ */
+IO::Drivers::Stream::Stream()
+  : m_fd(-1)
+  , m_sourceType(File)
+  , m_follow(false)
+  , m_reader(new StreamReader())
+{
+  // Read settings
+  m_path = m_settings.value("IO_Stream_Path", "").toString();
+  m_follow = m_settings.value("IO_Stream_Follow", false).toBool();
+  m_sourceType = qBound(0, m_settings.value("IO_Stream_Type", 0).toInt(),
+                        static_cast<int>(StandardInput));
+
+  // Start reader thread
+  m_thread.setObjectName(QStringLiteral("IO::Drivers::StreamReader"));
+  m_reader->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_reader, &QObject::deleteLater);
+  connect(m_reader, &StreamReader::dataReceived, this,
+          &Stream::dataReceived);
+  connect(m_reader, &StreamReader::finished, this, &Stream::onFinished);
+  m_thread.start();
+
+  // Configure local socket
+  connect(&m_socket, &QLocalSocket::readyRead, this,
+          &Stream::onSocketReadyRead);
+  connect(&m_socket, &QLocalSocket::errorOccurred, this,
+          &Stream::onSocketError);
+}
+
+/**
+ * Stops the reader thread
+ */
+IO::Drivers::Stream::~Stream()
+{
+  m_reader->stop();
+  m_thread.quit();
+  m_thread.wait();
+
+  if (m_fd >= 0 && m_fd != STDIN_FD)
+  {
+#if defined(Q_OS_WIN)
+    _close(m_fd);
+#else
+    ::close(m_fd);
+#endif
+  }
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::Stream &IO::Drivers::Stream::instance()
+{
+  static Stream singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Stops reading the current source. The reader thread is given the chance to
+ * finish its current read before the file descriptor is closed.
+ */
+void IO::Drivers::Stream::close()
+{
+  // Disconnect local socket
+  m_socket.abort();
+
+  // Nothing else to close
+  if (m_fd < 0)
+    return;
+
+  // Wait until the reader leaves the read loop
+  auto reader = m_reader;
+  reader->stop();
+  QMetaObject::invokeMethod(
+      reader, [] {}, Qt::BlockingQueuedConnection);
+
+  // Close the file descriptor (the standard input is kept open)
+  if (m_fd != STDIN_FD)
+  {
+#if defined(Q_OS_WIN)
+    _close(m_fd);
+#else
+    ::close(m_fd);
+#endif
+  }
+
+  m_fd = -1;
+}
+
+/**
+ * Returns @c true if the selected source is being read
+ */
+bool IO::Drivers::Stream::isOpen() const
+{
+  return m_fd >= 0 || m_socket.state() == QLocalSocket::ConnectedState;
+}
+
+/**
+ * Returns @c true if the selected source is being read
+ */
+bool IO::Drivers::Stream::isReadable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if data can be sent to the source, which is only possible
+ * with local sockets.
+ */
+bool IO::Drivers::Stream::isWritable() const
+{
+  return m_socket.state() == QLocalSocket::ConnectedState
+         && m_socket.isWritable();
+}
+
+/**
+ * Returns @c true if the source can be opened, every source except the
+ * standard input requires a path.
+ */
+bool IO::Drivers::Stream::configurationOk() const
+{
+  return m_sourceType == StandardInput || !m_path.isEmpty();
+}
+
+/**
+ * Sends the given @a data to the local socket, data written to other sources
+ * is discarded.
+ */
+quint64 IO::Drivers::Stream::write(const QByteArray &data)
+{
+  if (!isWritable())
+    return 0;
+
+  const auto bytes = m_socket.write(data);
+  if (bytes > 0)
+    Q_EMIT dataSent(data.left(static_cast<int>(bytes)));
+
+  return bytes > 0 ? static_cast<quint64>(bytes) : 0;
+}
+
+/**
+ * Opens the selected source & starts reading it
+ */
+bool IO::Drivers::Stream::open(const QIODevice::OpenMode mode)
+{
+  // Close current source
+  close();
+  if (!configurationOk())
+    return false;
+
+  // Connect to the local socket
+  if (m_sourceType == LocalSocket)
+  {
+    m_socket.connectToServer(m_path, mode);
+    return m_socket.waitForConnected(1000);
+  }
+
+  // Open the file, pipe or standard input
+  if (!openDescriptor())
+  {
+    Misc::Utilities::showMessageBox(tr("Cannot open \"%1\"").arg(m_path),
+                                    QString::fromLocal8Bit(strerror(errno)));
+    return false;
+  }
+
+  // Start reading from the reader thread
+  auto fd = m_fd;
+  auto reader = m_reader;
+  auto follow = m_follow && m_sourceType == File;
+  QMetaObject::invokeMethod(reader, [=] { reader->run(fd, follow); });
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns the type of the selected source, see @c sourceTypes()
+ */
+int IO::Drivers::Stream::sourceType() const
+{
+  return m_sourceType;
+}
+
+/**
+ * Returns the path of the file, pipe or local socket to read
+ */
+QString IO::Drivers::Stream::path() const
+{
+  return m_path;
+}
+
+/**
+ * Returns @c true if regular files are followed as they grow, instead of
+ * closing the connection when the end of the file is reached.
+ */
+bool IO::Drivers::Stream::follow() const
+{
+  return m_follow;
+}
+
+/**
+ * Returns the list of sources, the order matches the @c SourceType enum
+ */
+StringList IO::Drivers::Stream::sourceTypes() const
+{
+  return StringList{tr("File"), tr("Named pipe (FIFO)"), tr("Local socket"),
+                    tr("Standard input")};
+}
+
+/**
+ * Returns the type of the source at the given @a path, "-" stands for the
+ * standard input.
+ */
+IO::Drivers::Stream::SourceType
+IO::Drivers::Stream::detectSourceType(const QString &path)
+{
+  if (path == QStringLiteral("-"))
+    return StandardInput;
+
+#if defined(Q_OS_WIN)
+  if (path.startsWith(QStringLiteral("\\\\.\\pipe\\")))
+    return LocalSocket;
+#else
+  struct stat info;
+  const auto name = QFile::encodeName(path);
+  if (stat(name.constData(), &info) == 0)
+  {
+    if (S_ISFIFO(info.st_mode))
+      return Pipe;
+    if (S_ISSOCK(info.st_mode))
+      return LocalSocket;
+  }
+#endif
+
+  return File;
+}
+
+/**
+ * Lets the user select the file, pipe or socket to read
+ */
+void IO::Drivers::Stream::selectFile()
+{
+  auto file = QFileDialog::getOpenFileName(Q_NULLPTR, tr("Select input file"),
+                                           QFileInfo(m_path).absolutePath());
+  if (!file.isEmpty())
+  {
+    setPath(file);
+    setSourceType(detectSourceType(file));
+  }
+}
+
+/**
+ * Enables or disables following regular files as they grow
+ */
+void IO::Drivers::Stream::setFollow(const bool follow)
+{
+  if (m_follow != follow)
+  {
+    m_follow = follow;
+    m_settings.setValue("IO_Stream_Follow", follow);
+    Q_EMIT followChanged();
+  }
+}
+
+/**
+ * Changes the path of the file, pipe or local socket to read
+ */
+void IO::Drivers::Stream::setPath(const QString &path)
+{
+  if (m_path != path)
+  {
+    m_path = path;
+    m_settings.setValue("IO_Stream_Path", path);
+    Q_EMIT pathChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the type of the source, see @c sourceTypes()
+ */
+void IO::Drivers::Stream::setSourceType(const int type)
+{
+  const auto value = qBound(0, type, static_cast<int>(StandardInput));
+  if (m_sourceType != value)
+  {
+    m_sourceType = value;
+    m_settings.setValue("IO_Stream_Type", value);
+    Q_EMIT sourceTypeChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Closes the connection when the end of the stream is reached
+ */
+void IO::Drivers::Stream::onFinished()
+{
+  if (m_fd >= 0)
+    Manager::instance().disconnectDriver();
+}
+
+/**
+ * Hands all the data pending in the local socket to the I/O manager
+ */
+void IO::Drivers::Stream::onSocketReadyRead()
+{
+  const auto data = m_socket.readAll();
+  if (!data.isEmpty())
+    Q_EMIT dataReceived(data, IO::FrameQueue::timestamp());
+}
+
+/**
+ * Closes the connection when the local socket is closed by its peer or an
+ * error occurs, the user is only notified about actual errors.
+ */
+void IO::Drivers::Stream::onSocketError(QLocalSocket::LocalSocketError error)
+{
+  const auto message = m_socket.errorString();
+  QTimer::singleShot(0, &Manager::instance(), &Manager::disconnectDriver);
+  if (error != QLocalSocket::PeerClosedError)
+    Misc::Utilities::showMessageBox(tr("Local socket error"), message);
+}
+
+/**
+ * Opens the file descriptor of the selected file, pipe or standard input.
+ * Pipes are opened without blocking, otherwise the user interface would
+ * freeze until another process opens the pipe for writing.
+ */
+bool IO::Drivers::Stream::openDescriptor()
+{
+  // Use the standard input
+  if (m_sourceType == StandardInput)
+  {
+#if defined(Q_OS_WIN)
+    _setmode(STDIN_FD, _O_BINARY);
+#endif
+    m_fd = STDIN_FD;
+    return true;
+  }
+
+  // Open the file or pipe
+  const auto name = QFile::encodeName(m_path);
+#if defined(Q_OS_WIN)
+  m_fd = _open(name.constData(), _O_RDONLY | _O_BINARY);
+#else
+  m_fd = ::open(name.constData(), O_RDONLY | O_NONBLOCK);
+  if (m_fd >= 0)
+    fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) & ~O_NONBLOCK);
+#endif
+
+  return m_fd >= 0;
+}
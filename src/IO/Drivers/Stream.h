@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QThread>
+#include <QLocalSocket>
+
+#include <DataTypes.h>
+#include <IO/HAL_Driver.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The StreamReader class
+ *
+ * Worker object of the @c Stream driver, reads a file descriptor (a regular
+ * file, a named pipe or the standard input) from its own thread with large
+ * blocking reads, so that data is delivered in as few chunks as possible.
+ *
+ * Before each read, the reader waits (with a short timeout) until the
+ * descriptor is readable, so that the thread can be stopped at any time
+ * without waiting for the writer of a pipe.
+ */
+class StreamReader : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void finished();
+  void dataReceived(const QByteArray &data, const qint64 timestamp);
+
+public:
+  StreamReader();
+
+  void stop();
+
+public Q_SLOTS:
+  void run(const int fd, const bool follow);
+
+private:
+  std::atomic<bool> m_running;
+};
+
+/**
+ * @brief The Stream class
+ *
+ * Serial Studio "driver" class that reads data from local sources: regular
+ * files, named pipes (FIFOs), local sockets (Unix domain sockets or Windows
+ * named pipes) and the standard input of the application.
+ *
+ * This allows piping the output of other tools directly into Serial Studio,
+ * and provides a transport for high-rate simulations on the same computer
+ * without the overhead of the network stack.
+ *
+ * Files, pipes & the standard input are read by a @c StreamReader in a
+ * background thread. Local sockets are handled in the main thread with
+ * @c QLocalSocket, and are the only sources that can be written to. When the
+ * end of the data is reached (e.g. the writer of a pipe exits), the
+ * connection is closed, unless a regular file is followed as it grows.
+ */
+class Stream : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int sourceType
+               READ sourceType
+               WRITE setSourceType
+               NOTIFY sourceTypeChanged)
+    Q_PROPERTY(QString path
+               READ path
+               WRITE setPath
+               NOTIFY pathChanged)
+    Q_PROPERTY(bool follow
+               READ follow
+               WRITE setFollow
+               NOTIFY followChanged)
+    Q_PROPERTY(StringList sourceTypes
+               READ sourceTypes
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void pathChanged();
+  void followChanged();
+  void sourceTypeChanged();
+
+private:
+  explicit Stream();
+  Stream(Stream &&) = delete;
+  Stream(const Stream &) = delete;
+  Stream &operator=(Stream &&) = delete;
+  Stream &operator=(const Stream &) = delete;
+
+  ~Stream();
+
+public:
+  static Stream &instance();
+
+  enum SourceType
+  {
+    File = 0,
+    Pipe = 1,
+    LocalSocket = 2,
+    StandardInput = 3
+  };
+  Q_ENUM(SourceType)
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  int sourceType() const;
+  QString path() const;
+  bool follow() const;
+  StringList sourceTypes() const;
+
+  static SourceType detectSourceType(const QString &path);
+
+public Q_SLOTS:
+  void selectFile();
+  void setFollow(const bool follow);
+  void setPath(const QString &path);
+  void setSourceType(const int type);
+
+private Q_SLOTS:
+  void onFinished();
+  void onSocketReadyRead();
+  void onSocketError(QLocalSocket::LocalSocketError error);
+
+private:
+  bool openDescriptor();
+
+private:
+  int m_fd;
+  int m_sourceType;
+  bool m_follow;
+  QString m_path;
+  Misc::Settings m_settings;
+
+  QThread m_thread;
+  StreamReader *m_reader;
+  QLocalSocket m_socket;
+};
+} // namespace Drivers
+} // namespace IO
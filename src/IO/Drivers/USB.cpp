@@ -0,0 +1,672 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/Drivers/USB.h>
+#include <Misc/Utilities.h>
+
+#ifdef ENABLE_LIBUSB_DRIVER
+#  include <libusb.h>
+#endif
+
+/**
+ * Limits of the configurable parameters
+ */
+static const int MIN_TRANSFER_SIZE = 512;
+static const int MAX_TRANSFER_SIZE = 4 * 1024 * 1024;
+static const int MAX_QUEUE_DEPTH = 64;
+
+/**
+ * Time (in milliseconds) that the reader waits for libusb events before
+ * checking if it must stop, also the timeout of bulk OUT transfers.
+ */
+static const int POLL_INTERVAL = 100;
+static const int WRITE_TIMEOUT = 1000;
+
+#ifdef ENABLE_LIBUSB_DRIVER
+/**
+ * Completion callback of the bulk IN transfers, called by libusb from the
+ * thread that handles events (i.e. the reader thread).
+ */
+static void LIBUSB_CALL TRANSFER_CALLBACK(libusb_transfer *transfer)
+{
+  auto *reader = static_cast<IO::Drivers::USBReader *>(transfer->user_data);
+  reader->onTransferCompleted(transfer);
+}
+
+/**
+ * Returns the libusb description of the given @a error code
+ */
+static QString ERROR_STRING(const int error)
+{
+  return QString::fromUtf8(libusb_strerror(static_cast<libusb_error>(error)));
+}
+#endif
+
+//----------------------------------------------------------------------------------------
+// Reader implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+IO::Drivers::USBReader::USBReader()
+  : m_pending(0)
+  , m_failed(false)
+  , m_running(false)
+{
+}
+
+/**
+ * Arms the transfer loop, called by the driver before queueing @c run(), so
+ * that a @c stop() issued before the loop starts is not lost.
+ */
+void IO::Drivers::USBReader::start()
+{
+  m_running = true;
+}
+
+/**
+ * Stops the transfer loop, this function can be called from any thread
+ */
+void IO::Drivers::USBReader::stop()
+{
+  m_running = false;
+}
+
+/**
+ * Hands over the data of a completed @a transfer & submits it again. The
+ * transfer loop is stopped if the transfer failed (e.g. the device was
+ * unplugged or the endpoint stalled).
+ */
+void IO::Drivers::USBReader::onTransferCompleted(libusb_transfer *transfer)
+{
+#ifdef ENABLE_LIBUSB_DRIVER
+  --m_pending;
+  switch (transfer->status)
+  {
+    case LIBUSB_TRANSFER_COMPLETED:
+      if (transfer->actual_length > 0)
+      {
+        const auto *data = reinterpret_cast<const char *>(transfer->buffer);
+        Q_EMIT dataReceived(QByteArray(data, transfer->actual_length),
+                            IO::FrameQueue::timestamp());
+      }
+      break;
+    case LIBUSB_TRANSFER_CANCELLED:
+      return;
+    default:
+      m_failed = true;
+      return;
+  }
+
+  // Give the buffer back to the device
+  if (m_running && libusb_submit_transfer(transfer) == 0)
+    ++m_pending;
+  else if (m_running)
+    m_failed = true;
+#else
+  Q_UNUSED(transfer);
+#endif
+}
+
+/**
+ * Submits @a queueDepth bulk transfers of @a transferSize bytes to the given
+ * IN @a endpoint & handles their completion until @c stop() is called or a
+ * transfer fails. Outstanding transfers are cancelled before returning.
+ */
+void IO::Drivers::USBReader::run(libusb_context *context,
+                                 libusb_device_handle *handle,
+                                 const int endpoint, const int transferSize,
+                                 const int queueDepth)
+{
+#ifdef ENABLE_LIBUSB_DRIVER
+  m_pending = 0;
+  m_failed = false;
+
+  // Allocate & submit the transfers
+  QVector<libusb_transfer *> transfers;
+  for (int i = 0; i < queueDepth && !m_failed; ++i)
+  {
+    auto *transfer = libusb_alloc_transfer(0);
+    auto *buffer = new unsigned char[transferSize];
+    libusb_fill_bulk_transfer(transfer, handle,
+                              static_cast<unsigned char>(endpoint), buffer,
+                              transferSize, TRANSFER_CALLBACK, this, 0);
+    transfers.append(transfer);
+
+    if (libusb_submit_transfer(transfer) == 0)
+      ++m_pending;
+    else
+      m_failed = true;
+  }
+
+  // Handle completed transfers
+  struct timeval timeout = {0, POLL_INTERVAL * 1000};
+  while (m_running && !m_failed)
+  {
+    const int rc = libusb_handle_events_timeout_completed(context, &timeout,
+                                                          Q_NULLPTR);
+    if (rc != 0 && rc != LIBUSB_ERROR_INTERRUPTED)
+      m_failed = true;
+  }
+
+  // Cancel outstanding transfers & wait for their callbacks
+  const bool failed = m_failed;
+  const bool running = m_running;
+  m_running = false;
+  for (auto *transfer : transfers)
+    libusb_cancel_transfer(transfer);
+
+  while (m_pending > 0)
+  {
+    const int rc = libusb_handle_events_timeout_completed(context, &timeout,
+                                                          Q_NULLPTR);
+    if (rc != 0 && rc != LIBUSB_ERROR_INTERRUPTED)
+      break;
+  }
+
+  // Release the transfers
+  for (auto *transfer : transfers)
+  {
+    delete[] transfer->buffer;
+    libusb_free_transfer(transfer);
+  }
+
+  // Notify the driver if the transfers stopped because of an error
+  if (running && failed)
+    Q_EMIT finished();
+#else
+  Q_UNUSED(context);
+  Q_UNUSED(handle);
+  Q_UNUSED(endpoint);
+  Q_UNUSED(transferSize);
+  Q_UNUSED(queueDepth);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// Driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, restores the last configuration, initializes libusb
+ * & starts the reader thread
+ */
+IO::Drivers::USB::USB()
+  : m_deviceIndex(0)
+  , m_interfaceNumber(0)
+  , m_inEndpoint(1)
+  , m_outEndpoint(1)
+  , m_transferSize(64 * 1024)
+  , m_queueDepth(8)
+  , m_context(Q_NULLPTR)
+  , m_handle(Q_NULLPTR)
+  , m_writable(false)
+  , m_reader(new USBReader())
+{
+  // Read settings
+  m_lastDevice = m_settings.value("IO_USB_Device", "").toString();
+  m_interfaceNumber = m_settings.value("IO_USB_Interface", 0).toInt();
+  m_inEndpoint = m_settings.value("IO_USB_InEndpoint", 1).toInt();
+  m_outEndpoint = m_settings.value("IO_USB_OutEndpoint", 1).toInt();
+  m_transferSize = m_settings.value("IO_USB_TransferSize", 64 * 1024).toInt();
+  m_queueDepth = m_settings.value("IO_USB_QueueDepth", 8).toInt();
+  m_transferSize = qBound(MIN_TRANSFER_SIZE, m_transferSize, MAX_TRANSFER_SIZE);
+  m_queueDepth = qBound(1, m_queueDepth, MAX_QUEUE_DEPTH);
+
+  // Initialize libusb
+#ifdef ENABLE_LIBUSB_DRIVER
+  if (libusb_init(&m_context) != 0)
+    m_context = Q_NULLPTR;
+#endif
+
+  // Start reader thread
+  m_thread.setObjectName(QStringLiteral("IO::Drivers::USBReader"));
+  m_reader->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_reader, &QObject::deleteLater);
+  connect(m_reader, &USBReader::dataReceived, this, &USB::dataReceived);
+  connect(m_reader, &USBReader::finished, this, &USB::onFinished);
+  m_thread.start();
+
+  // Get available devices
+  refreshDevices();
+}
+
+/**
+ * Closes the device, stops the reader thread & releases libusb
+ */
+IO::Drivers::USB::~USB()
+{
+  close();
+  m_thread.quit();
+  m_thread.wait();
+
+#ifdef ENABLE_LIBUSB_DRIVER
+  if (m_context)
+    libusb_exit(m_context);
+#endif
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::Drivers::USB &IO::Drivers::USB::instance()
+{
+  static USB singleton;
+  return singleton;
+}
+
+//----------------------------------------------------------------------------------------
+// HAL driver implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Cancels the outstanding transfers, releases the claimed interface & closes
+ * the device.
+ */
+void IO::Drivers::USB::close()
+{
+  if (!m_handle)
+    return;
+
+  // Wait until the reader cancels its transfers
+  auto reader = m_reader;
+  reader->stop();
+  QMetaObject::invokeMethod(
+      reader, [] {}, Qt::BlockingQueuedConnection);
+
+  // Close the device
+#ifdef ENABLE_LIBUSB_DRIVER
+  libusb_release_interface(m_handle, m_interfaceNumber);
+  libusb_close(m_handle);
+#endif
+
+  m_handle = Q_NULLPTR;
+  m_writable = false;
+}
+
+/**
+ * Returns @c true if a device is open
+ */
+bool IO::Drivers::USB::isOpen() const
+{
+  return m_handle != Q_NULLPTR;
+}
+
+/**
+ * Returns @c true if a device is open
+ */
+bool IO::Drivers::USB::isReadable() const
+{
+  return isOpen();
+}
+
+/**
+ * Returns @c true if the device was opened for writing & a bulk OUT endpoint
+ * is configured
+ */
+bool IO::Drivers::USB::isWritable() const
+{
+  return isOpen() && m_writable;
+}
+
+/**
+ * Returns @c true if a device & a bulk IN endpoint are selected
+ */
+bool IO::Drivers::USB::configurationOk() const
+{
+  return m_deviceIndex > 0 && m_inEndpoint > 0;
+}
+
+/**
+ * Sends the given @a data to the bulk OUT endpoint of the device, waiting
+ * until the transfer completes. Returns the number of bytes transferred.
+ */
+quint64 IO::Drivers::USB::write(const QByteArray &data)
+{
+  if (!isWritable())
+    return 0;
+
+#ifdef ENABLE_LIBUSB_DRIVER
+  int transferred = 0;
+  auto *buffer
+      = reinterpret_cast<unsigned char *>(const_cast<char *>(data.constData()));
+  libusb_bulk_transfer(m_handle,
+                       static_cast<unsigned char>(m_outEndpoint
+                                                  | LIBUSB_ENDPOINT_OUT),
+                       buffer, data.size(), &transferred, WRITE_TIMEOUT);
+  return transferred > 0 ? static_cast<quint64>(transferred) : 0;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Opens the selected device, claims the configured interface & starts the
+ * bulk IN transfers.
+ */
+bool IO::Drivers::USB::open(const QIODevice::OpenMode mode)
+{
+  // Close current device
+  close();
+  if (!configurationOk())
+    return false;
+
+#ifdef ENABLE_LIBUSB_DRIVER
+  // libusb not available
+  if (!m_context)
+  {
+    Misc::Utilities::showMessageBox(tr("Cannot open USB device"),
+                                    tr("libusb could not be initialized"));
+    return false;
+  }
+
+  // Find the selected device (index 0 is the "Select device" item)
+  const auto &info = m_devices.at(m_deviceIndex - 1);
+  libusb_device **list = Q_NULLPTR;
+  const auto count = libusb_get_device_list(m_context, &list);
+  int rc = LIBUSB_ERROR_NO_DEVICE;
+  for (ssize_t i = 0; i < count; ++i)
+  {
+    if (libusb_get_bus_number(list[i]) == info.bus
+        && libusb_get_device_address(list[i]) == info.address)
+    {
+      rc = libusb_open(list[i], &m_handle);
+      break;
+    }
+  }
+
+  if (list)
+    libusb_free_device_list(list, 1);
+
+  if (rc != 0)
+  {
+    m_handle = Q_NULLPTR;
+    Misc::Utilities::showMessageBox(tr("Cannot open USB device"),
+                                    ERROR_STRING(rc));
+    return false;
+  }
+
+  // Claim the interface, detaching the kernel driver if needed
+  libusb_set_auto_detach_kernel_driver(m_handle, 1);
+  rc = libusb_claim_interface(m_handle, m_interfaceNumber);
+  if (rc != 0)
+  {
+    libusb_close(m_handle);
+    m_handle = Q_NULLPTR;
+    Misc::Utilities::showMessageBox(
+        tr("Cannot claim interface %1").arg(m_interfaceNumber),
+        ERROR_STRING(rc));
+    return false;
+  }
+
+  // Start the transfers from the reader thread
+  m_writable = (mode & QIODevice::WriteOnly) && m_outEndpoint > 0;
+  auto reader = m_reader;
+  auto context = m_context;
+  auto handle = m_handle;
+  auto endpoint = m_inEndpoint | LIBUSB_ENDPOINT_IN;
+  auto size = m_transferSize;
+  auto depth = m_queueDepth;
+  reader->start();
+  QMetaObject::invokeMethod(reader, [=] {
+    reader->run(context, handle, endpoint, size, depth);
+  });
+  return true;
+#else
+  Q_UNUSED(mode);
+  Misc::Utilities::showMessageBox(
+      tr("USB devices are not supported"),
+      tr("This build does not include libusb support"));
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// Driver specifics
+//----------------------------------------------------------------------------------------
+
+/**
+ * Returns @c true if the application was built with libusb support
+ */
+bool IO::Drivers::USB::supported() const
+{
+#ifdef ENABLE_LIBUSB_DRIVER
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Returns the index of the selected device in @c deviceList(), zero means
+ * that no device is selected.
+ */
+int IO::Drivers::USB::deviceIndex() const
+{
+  return m_deviceIndex;
+}
+
+/**
+ * Returns the number of the interface that is claimed when connecting
+ */
+int IO::Drivers::USB::interfaceNumber() const
+{
+  return m_interfaceNumber;
+}
+
+/**
+ * Returns the number (1-15) of the bulk IN endpoint that is read
+ */
+int IO::Drivers::USB::inEndpoint() const
+{
+  return m_inEndpoint;
+}
+
+/**
+ * Returns the number (1-15) of the bulk OUT endpoint that data is written
+ * to, zero disables writing.
+ */
+int IO::Drivers::USB::outEndpoint() const
+{
+  return m_outEndpoint;
+}
+
+/**
+ * Returns the size (in bytes) of each bulk IN transfer
+ */
+int IO::Drivers::USB::transferSize() const
+{
+  return m_transferSize;
+}
+
+/**
+ * Returns the number of bulk IN transfers that are kept in flight
+ */
+int IO::Drivers::USB::queueDepth() const
+{
+  return m_queueDepth;
+}
+
+/**
+ * Returns the list of USB devices, the first item is a placeholder that is
+ * selected when no device is selected.
+ */
+StringList IO::Drivers::USB::deviceList() const
+{
+  StringList list;
+  list.append(tr("Select device"));
+  for (const auto &device : m_devices)
+  {
+    list.append(QStringLiteral("%1:%2  (bus %3, address %4)")
+                    .arg(device.vendorId, 4, 16, QLatin1Char('0'))
+                    .arg(device.productId, 4, 16, QLatin1Char('0'))
+                    .arg(device.bus)
+                    .arg(device.address));
+  }
+
+  return list;
+}
+
+/**
+ * Rebuilds the list of USB devices & selects the last used device (identified
+ * by its vendor & product IDs) if it is connected.
+ */
+void IO::Drivers::USB::refreshDevices()
+{
+  m_devices.clear();
+
+#ifdef ENABLE_LIBUSB_DRIVER
+  if (m_context)
+  {
+    libusb_device **list = Q_NULLPTR;
+    const auto count = libusb_get_device_list(m_context, &list);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+      // Skip hubs
+      libusb_device_descriptor desc;
+      if (libusb_get_device_descriptor(list[i], &desc) != 0
+          || desc.bDeviceClass == LIBUSB_CLASS_HUB)
+        continue;
+
+      DeviceInfo info;
+      info.vendorId = desc.idVendor;
+      info.productId = desc.idProduct;
+      info.bus = libusb_get_bus_number(list[i]);
+      info.address = libusb_get_device_address(list[i]);
+      m_devices.append(info);
+    }
+
+    if (list)
+      libusb_free_device_list(list, 1);
+  }
+#endif
+
+  // Select the last used device
+  m_deviceIndex = 0;
+  for (int i = 0; i < m_devices.count(); ++i)
+  {
+    const auto &device = m_devices.at(i);
+    const auto id = QStringLiteral("%1:%2")
+                        .arg(device.vendorId, 4, 16, QLatin1Char('0'))
+                        .arg(device.productId, 4, 16, QLatin1Char('0'));
+    if (id == m_lastDevice)
+    {
+      m_deviceIndex = i + 1;
+      break;
+    }
+  }
+
+  Q_EMIT deviceListChanged();
+  Q_EMIT deviceIndexChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Selects the device at the given @a index of @c deviceList()
+ */
+void IO::Drivers::USB::setDeviceIndex(const int index)
+{
+  const auto value = qBound(0, index, static_cast<int>(m_devices.count()));
+  if (m_deviceIndex != value)
+  {
+    m_deviceIndex = value;
+    if (value > 0)
+    {
+      const auto &device = m_devices.at(value - 1);
+      m_lastDevice = QStringLiteral("%1:%2")
+                         .arg(device.vendorId, 4, 16, QLatin1Char('0'))
+                         .arg(device.productId, 4, 16, QLatin1Char('0'));
+      m_settings.setValue("IO_USB_Device", m_lastDevice);
+    }
+
+    Q_EMIT deviceIndexChanged();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the number of the interface that is claimed when connecting
+ */
+void IO::Drivers::USB::setInterfaceNumber(const int number)
+{
+  m_interfaceNumber = qBound(0, number, 255);
+  m_settings.setValue("IO_USB_Interface", m_interfaceNumber);
+  Q_EMIT configChanged();
+}
+
+/**
+ * Changes the number (1-15) of the bulk IN endpoint that is read
+ */
+void IO::Drivers::USB::setInEndpoint(const int endpoint)
+{
+  m_inEndpoint = qBound(1, endpoint, 15);
+  m_settings.setValue("IO_USB_InEndpoint", m_inEndpoint);
+  Q_EMIT configChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the number (1-15) of the bulk OUT endpoint that data is written
+ * to, zero disables writing.
+ */
+void IO::Drivers::USB::setOutEndpoint(const int endpoint)
+{
+  m_outEndpoint = qBound(0, endpoint, 15);
+  m_settings.setValue("IO_USB_OutEndpoint", m_outEndpoint);
+  Q_EMIT configChanged();
+}
+
+/**
+ * Changes the size (in bytes) of each bulk IN transfer. The size is rounded
+ * up to a multiple of 512 bytes (the packet size of high-speed bulk
+ * endpoints), so that transfers never end with a partial packet.
+ */
+void IO::Drivers::USB::setTransferSize(const int bytes)
+{
+  const auto size = (bytes + MIN_TRANSFER_SIZE - 1) / MIN_TRANSFER_SIZE;
+  m_transferSize = qBound(MIN_TRANSFER_SIZE, size * MIN_TRANSFER_SIZE,
+                          MAX_TRANSFER_SIZE);
+  m_settings.setValue("IO_USB_TransferSize", m_transferSize);
+  Q_EMIT configChanged();
+}
+
+/**
+ * Changes the number of bulk IN transfers that are kept in flight
+ */
+void IO::Drivers::USB::setQueueDepth(const int transfers)
+{
+  m_queueDepth = qBound(1, transfers, MAX_QUEUE_DEPTH);
+  m_settings.setValue("IO_USB_QueueDepth", m_queueDepth);
+  Q_EMIT configChanged();
+}
+
+/**
+ * Closes the connection when the device is unplugged or a transfer fails
+ */
+void IO::Drivers::USB::onFinished()
+{
+  if (m_handle)
+    Manager::instance().connectionLost();
+}
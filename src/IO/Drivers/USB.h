@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QThread>
+#include <QVector>
+
+#include <DataTypes.h>
+#include <IO/HAL_Driver.h>
+#include <Misc/Settings.h>
+
+struct libusb_context;
+struct libusb_transfer;
+struct libusb_device_handle;
+
+namespace IO
+{
+namespace Drivers
+{
+/**
+ * @brief The USBReader class
+ *
+ * Worker object of the @c USB driver, keeps a queue of asynchronous bulk IN
+ * transfers submitted to libusb & handles their completion from its own
+ * thread. Each completed transfer is handed over to the driver & submitted
+ * again immediately, so that the device always has buffers to fill.
+ *
+ * libusb events are handled with a short timeout, so that the thread can be
+ * stopped at any time.
+ */
+class USBReader : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void finished();
+  void dataReceived(const QByteArray &data, const qint64 timestamp);
+
+public:
+  USBReader();
+
+  void start();
+  void stop();
+  void onTransferCompleted(libusb_transfer *transfer);
+
+public Q_SLOTS:
+  void run(libusb_context *context, libusb_device_handle *handle,
+           const int endpoint, const int transferSize, const int queueDepth);
+
+private:
+  int m_pending;
+  bool m_failed;
+  std::atomic<bool> m_running;
+};
+
+/**
+ * @brief The USB class
+ *
+ * Serial Studio driver class that reads raw USB bulk endpoints with libusb,
+ * for devices that stream data without implementing a serial (CDC) class.
+ *
+ * The selected interface of the device is claimed & its bulk IN endpoint is
+ * read by a @c USBReader with several transfers in flight, which is required
+ * to sustain the throughput of high-speed devices (tens of MB/s). The size
+ * of each transfer & the number of outstanding transfers can be configured.
+ * Data written from the console is sent synchronously to the bulk OUT
+ * endpoint.
+ *
+ * The driver is only functional when Serial Studio is built with libusb
+ * support (@c CONFIG+=libusb), see @c supported().
+ */
+class USB : public HAL_Driver
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool supported
+               READ supported
+               CONSTANT)
+    Q_PROPERTY(int deviceIndex
+               READ deviceIndex
+               WRITE setDeviceIndex
+               NOTIFY deviceIndexChanged)
+    Q_PROPERTY(int interfaceNumber
+               READ interfaceNumber
+               WRITE setInterfaceNumber
+               NOTIFY configChanged)
+    Q_PROPERTY(int inEndpoint
+               READ inEndpoint
+               WRITE setInEndpoint
+               NOTIFY configChanged)
+    Q_PROPERTY(int outEndpoint
+               READ outEndpoint
+               WRITE setOutEndpoint
+               NOTIFY configChanged)
+    Q_PROPERTY(int transferSize
+               READ transferSize
+               WRITE setTransferSize
+               NOTIFY configChanged)
+    Q_PROPERTY(int queueDepth
+               READ queueDepth
+               WRITE setQueueDepth
+               NOTIFY configChanged)
+    Q_PROPERTY(StringList deviceList
+               READ deviceList
+               NOTIFY deviceListChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void configChanged();
+  void deviceListChanged();
+  void deviceIndexChanged();
+
+private:
+  explicit USB();
+  USB(USB &&) = delete;
+  USB(const USB &) = delete;
+  USB &operator=(USB &&) = delete;
+  USB &operator=(const USB &) = delete;
+
+  ~USB();
+
+public:
+  static USB &instance();
+
+  //
+  // HAL functions
+  //
+  void close() override;
+  bool isOpen() const override;
+  bool isReadable() const override;
+  bool isWritable() const override;
+  bool configurationOk() const override;
+  quint64 write(const QByteArray &data) override;
+  bool open(const QIODevice::OpenMode mode) override;
+
+  bool supported() const;
+  int deviceIndex() const;
+  int interfaceNumber() const;
+  int inEndpoint() const;
+  int outEndpoint() const;
+  int transferSize() const;
+  int queueDepth() const;
+  StringList deviceList() const;
+
+public Q_SLOTS:
+  void refreshDevices();
+  void setDeviceIndex(const int index);
+  void setInterfaceNumber(const int number);
+  void setInEndpoint(const int endpoint);
+  void setOutEndpoint(const int endpoint);
+  void setTransferSize(const int bytes);
+  void setQueueDepth(const int transfers);
+
+private Q_SLOTS:
+  void onFinished();
+
+private:
+  struct DeviceInfo
+  {
+    quint16 vendorId;
+    quint16 productId;
+    quint8 bus;
+    quint8 address;
+  };
+
+  int m_deviceIndex;
+  int m_interfaceNumber;
+  int m_inEndpoint;
+  int m_outEndpoint;
+  int m_transferSize;
+  int m_queueDepth;
+  QString m_lastDevice;
+  Misc::Settings m_settings;
+
+  libusb_context *m_context;
+  libusb_device_handle *m_handle;
+  bool m_writable;
+  QVector<DeviceInfo> m_devices;
+
+  QThread m_thread;
+  USBReader *m_reader;
+};
+} // namespace Drivers
+} // namespace IO
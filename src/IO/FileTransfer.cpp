@@ -0,0 +1,740 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileDialog>
+
+#include <IO/Manager.h>
+#include <IO/Checksum.h>
+#include <IO/FileTransfer.h>
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+
+//
+// XMODEM/YMODEM control characters
+//
+static const char SOH = 0x01;
+static const char STX = 0x02;
+static const char EOT = 0x04;
+static const char ACK = 0x06;
+static const char NAK = 0x15;
+static const char CAN = 0x18;
+static const char CRC_MODE = 'C';
+static const char PADDING = 0x1A;
+
+/**
+ * Time (in milliseconds) to wait for a response of the receiver before the
+ * last packet is sent again
+ */
+static const int RESPONSE_TIMEOUT = 10000;
+
+/**
+ * Number of consecutive retransmissions after which the transfer fails
+ */
+static const int MAX_RETRIES = 10;
+
+/**
+ * Maximum number of blocks that can be sent ahead of the last acknowledged
+ * block
+ */
+static const int MAX_WINDOW = 32;
+
+/**
+ * Size of the chunks written to the outgoing queue by raw uploads & maximum
+ * number of bytes that raw uploads keep in the queue
+ */
+static const int RAW_CHUNK_SIZE = 4096;
+static const qint64 RAW_QUEUE_SIZE = 256 * 1024;
+
+/**
+ * Maximum size of the files that can be uploaded
+ */
+static const qint64 MAX_FILE_SIZE = 64 * 1024 * 1024;
+
+/**
+ * Constructor function
+ */
+IO::FileTransfer::FileTransfer()
+  : m_state(State::Idle)
+  , m_protocol(Protocol::XModem1K)
+  , m_crc(true)
+  , m_window(1)
+  , m_retries(0)
+  , m_cancels(0)
+  , m_nextBlock(0)
+  , m_ackedBlocks(0)
+  , m_offset(0)
+  , m_transferred(0)
+{
+  // Load settings
+  setProtocol(m_settings.value("FileTransfer_Protocol", 2).toInt());
+  setWindow(m_settings.value("FileTransfer_Window", 1).toInt());
+
+  // Configure the response timer
+  m_timer.setSingleShot(true);
+  connect(&m_timer, &QTimer::timeout, this, &IO::FileTransfer::onTimeout);
+
+  // React to device events
+  auto &manager = IO::Manager::instance();
+  connect(&manager, &IO::Manager::dataSent, this,
+          &IO::FileTransfer::onDataSent);
+  connect(&manager, &IO::Manager::connectedChanged, this,
+          &IO::FileTransfer::onConnectedChanged);
+  connect(&manager, &IO::Manager::deviceDataReceived, this,
+          &IO::FileTransfer::onDataReceived);
+
+  // Update the progress in the user interface periodically
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz, this,
+          [=] {
+            if (active())
+              Q_EMIT progressChanged();
+          });
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::FileTransfer &IO::FileTransfer::instance()
+{
+  static FileTransfer singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true while a file is being uploaded
+ */
+bool IO::FileTransfer::active() const
+{
+  return m_state != State::Idle;
+}
+
+/**
+ * Returns the name of the selected file
+ */
+QString IO::FileTransfer::fileName() const
+{
+  if (m_path.isEmpty())
+    return QString();
+
+  return QFileInfo(m_path).fileName();
+}
+
+/**
+ * Returns the size of the selected file in bytes
+ */
+qint64 IO::FileTransfer::fileSize() const
+{
+  return m_data.size();
+}
+
+/**
+ * Returns the selected protocol, the value corresponds to the
+ * @c FileTransfer::Protocol enum.
+ */
+int IO::FileTransfer::protocol() const
+{
+  return static_cast<int>(m_protocol);
+}
+
+/**
+ * Returns the number of XMODEM/YMODEM blocks that can be sent without
+ * waiting for their acknowledgement.
+ */
+int IO::FileTransfer::window() const
+{
+  return m_window;
+}
+
+/**
+ * Returns a human-readable description of the state of the transfer
+ */
+QString IO::FileTransfer::status() const
+{
+  return m_status;
+}
+
+/**
+ * Returns the fraction of the file (0 to 1) that has been transferred
+ */
+qreal IO::FileTransfer::progress() const
+{
+  if (m_data.isEmpty())
+    return 0;
+
+  return static_cast<qreal>(m_transferred) / m_data.size();
+}
+
+/**
+ * Returns the number of bytes that have been transmitted (raw uploads) or
+ * acknowledged by the receiver (XMODEM/YMODEM uploads).
+ */
+qint64 IO::FileTransfer::transferredBytes() const
+{
+  return m_transferred;
+}
+
+/**
+ * Returns the average throughput of the current or last transfer in bytes
+ * per second.
+ */
+qreal IO::FileTransfer::throughput() const
+{
+  if (!m_clock.isValid())
+    return 0;
+
+  const auto elapsed = m_clock.elapsed();
+  if (elapsed <= 0)
+    return 0;
+
+  return m_transferred * 1000.0 / elapsed;
+}
+
+/**
+ * Returns a list with the available protocols, the order of the list
+ * matches the @c FileTransfer::Protocol enum.
+ */
+StringList IO::FileTransfer::availableProtocols() const
+{
+  StringList list;
+  list.append(tr("Raw (paced)"));
+  list.append(tr("XMODEM (128-byte blocks)"));
+  list.append(tr("XMODEM-1K"));
+  list.append(tr("YMODEM"));
+  return list;
+}
+
+/**
+ * Starts uploading the selected file to the connected device. Raw uploads
+ * start immediately, XMODEM/YMODEM uploads start when the receiver requests
+ * the first block.
+ */
+void IO::FileTransfer::start()
+{
+  // Validate state
+  if (active() || m_data.isEmpty())
+    return;
+
+  // Device not connected
+  if (!IO::Manager::instance().connected())
+  {
+    setStatus(tr("Device not connected"));
+    return;
+  }
+
+  // Reset transfer state
+  m_retries = 0;
+  m_cancels = 0;
+  m_nextBlock = 0;
+  m_ackedBlocks = 0;
+  m_offset = 0;
+  m_transferred = 0;
+  m_clock.start();
+
+  // Raw upload, fill the outgoing queue
+  if (m_protocol == Protocol::Raw)
+  {
+    m_state = State::SendingData;
+    setStatus(tr("Uploading..."));
+    Q_EMIT activeChanged();
+    Q_EMIT progressChanged();
+
+    m_timer.start(RESPONSE_TIMEOUT);
+    fillQueue();
+    return;
+  }
+
+  // Wait for the receiver to request the first block
+  m_state = State::WaitingReceiver;
+  setStatus(tr("Waiting for receiver..."));
+  m_timer.start(RESPONSE_TIMEOUT);
+  Q_EMIT activeChanged();
+  Q_EMIT progressChanged();
+}
+
+/**
+ * Aborts the current transfer, XMODEM/YMODEM receivers are notified with a
+ * sequence of CAN characters.
+ */
+void IO::FileTransfer::cancel()
+{
+  if (!active())
+    return;
+
+  if (m_protocol != Protocol::Raw)
+    IO::Manager::instance().writeData(QByteArray(3, CAN));
+
+  finish(false, tr("Cancelled"));
+}
+
+/**
+ * Lets the user select the file to upload
+ */
+void IO::FileTransfer::selectFile()
+{
+  auto path = QFileDialog::getOpenFileName(
+      Q_NULLPTR, tr("Select file to upload"), QDir::homePath());
+
+  if (!path.isEmpty())
+    setFile(path);
+}
+
+/**
+ * Loads the file at the given @a path, files are read completely before the
+ * transfer starts.
+ */
+void IO::FileTransfer::setFile(const QString &path)
+{
+  // Do not replace the file during a transfer
+  if (active())
+    return;
+
+  // Open the file
+  QFile file(path);
+  if (!file.open(QFile::ReadOnly))
+  {
+    Misc::Utilities::showMessageBox(tr("Cannot open file"),
+                                    file.errorString());
+    return;
+  }
+
+  // Validate file size
+  if (file.size() <= 0 || file.size() > MAX_FILE_SIZE)
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Invalid file size"),
+        tr("Only files between 1 byte and %1 MB can be uploaded")
+            .arg(MAX_FILE_SIZE / (1024 * 1024)));
+    return;
+  }
+
+  // Read the file
+  m_path = path;
+  m_data = file.readAll();
+  m_transferred = 0;
+  setStatus(QString());
+
+  Q_EMIT fileChanged();
+  Q_EMIT progressChanged();
+}
+
+/**
+ * Changes the number of XMODEM/YMODEM blocks that can be sent without
+ * waiting for their acknowledgement, use 1 for standard receivers.
+ */
+void IO::FileTransfer::setWindow(const int blocks)
+{
+  const auto window = qBound(1, blocks, MAX_WINDOW);
+  if (m_window != window && !active())
+  {
+    m_window = window;
+    m_settings.setValue("FileTransfer_Window", window);
+    Q_EMIT windowChanged();
+  }
+}
+
+/**
+ * Changes the protocol used to upload files
+ */
+void IO::FileTransfer::setProtocol(const int protocol)
+{
+  const auto value = static_cast<Protocol>(protocol);
+  if (protocol < 0 || protocol > static_cast<int>(Protocol::YModem))
+    return;
+
+  if (m_protocol != value && !active())
+  {
+    m_protocol = value;
+    m_settings.setValue("FileTransfer_Protocol", protocol);
+    Q_EMIT protocolChanged();
+  }
+}
+
+/**
+ * Called when the receiver does not respond in time, or when a raw upload
+ * does not make progress.
+ */
+void IO::FileTransfer::onTimeout()
+{
+  if (!active())
+    return;
+
+  if (m_protocol == Protocol::Raw)
+    finish(false, tr("The device is not accepting data"));
+  else
+    retransmit();
+}
+
+/**
+ * Updates the progress of raw uploads as the driver transmits the queued
+ * data & refills the outgoing queue.
+ */
+void IO::FileTransfer::onDataSent()
+{
+  // Only raw uploads are driven by transmitted data
+  if (m_state != State::SendingData || m_protocol != Protocol::Raw)
+    return;
+
+  // Update progress
+  const auto queued = IO::Manager::instance().writeQueue().queuedBytes();
+  m_transferred = qBound<qint64>(0, m_offset - queued, m_data.size());
+  m_timer.start(RESPONSE_TIMEOUT);
+
+  // Finish the transfer or queue more data
+  if (m_offset >= m_data.size() && queued == 0)
+    finish(true, tr("Upload complete"));
+  else
+    fillQueue();
+}
+
+/**
+ * Aborts the transfer if the device is disconnected
+ */
+void IO::FileTransfer::onConnectedChanged()
+{
+  if (active() && !IO::Manager::instance().connected())
+    finish(false, tr("Device disconnected"));
+}
+
+/**
+ * Processes the responses of the XMODEM/YMODEM receiver
+ */
+void IO::FileTransfer::onDataReceived(const int stream, const QByteArray &data,
+                                      const qint64 timestamp)
+{
+  (void)stream;
+  (void)timestamp;
+
+  if (!active() || m_protocol == Protocol::Raw)
+    return;
+
+  for (int i = 0; i < data.size() && active(); ++i)
+    processByte(data.at(i));
+}
+
+/**
+ * Returns the size of the XMODEM/YMODEM data blocks
+ */
+int IO::FileTransfer::blockSize() const
+{
+  return m_protocol == Protocol::XModem ? 128 : 1024;
+}
+
+/**
+ * Returns the number of data blocks required to transfer the file
+ */
+int IO::FileTransfer::blockCount() const
+{
+  return (m_data.size() + blockSize() - 1) / blockSize();
+}
+
+/**
+ * Builds an XMODEM/YMODEM block with the given @a sequence number. The
+ * @a payload is padded to 128 or 1024 bytes & followed by a CRC-16 or an
+ * 8-bit sum, depending on the mode requested by the receiver.
+ */
+QByteArray IO::FileTransfer::block(const int sequence,
+                                   const QByteArray &payload) const
+{
+  // Build the block header
+  const int size = payload.size() <= 128 ? 128 : 1024;
+  QByteArray block;
+  block.reserve(size + 5);
+  block.append(size == 128 ? SOH : STX);
+  block.append(static_cast<char>(sequence & 0xFF));
+  block.append(static_cast<char>(0xFF - (sequence & 0xFF)));
+
+  // Append the padded payload
+  block.append(payload);
+  if (payload.size() < size)
+    block.append(QByteArray(size - payload.size(), PADDING));
+
+  // Append the checksum
+  const char *data = block.constData() + 3;
+  if (m_crc)
+  {
+    const auto crc = crc16Xmodem(data, size);
+    block.append(static_cast<char>(crc >> 8));
+    block.append(static_cast<char>(crc & 0xFF));
+  }
+  else
+  {
+    quint8 sum = 0;
+    for (int i = 0; i < size; ++i)
+      sum += static_cast<quint8>(data[i]);
+
+    block.append(static_cast<char>(sum));
+  }
+
+  return block;
+}
+
+/**
+ * Writes raw data to the outgoing queue until the queue holds
+ * @c RAW_QUEUE_SIZE bytes or the complete file has been queued.
+ */
+void IO::FileTransfer::fillQueue()
+{
+  auto &manager = IO::Manager::instance();
+  while (m_offset < m_data.size()
+         && manager.writeQueue().queuedBytes() < RAW_QUEUE_SIZE)
+  {
+    const auto chunk = m_data.mid(m_offset, RAW_CHUNK_SIZE);
+    if (manager.writeData(chunk) < 0)
+    {
+      finish(false, tr("Unable to write data to the device"));
+      return;
+    }
+
+    m_offset += chunk.size();
+  }
+}
+
+/**
+ * Sends the YMODEM header block, which contains the name & size of the file
+ */
+void IO::FileTransfer::sendHeader()
+{
+  QByteArray header = fileName().left(100).toUtf8();
+  header.append('\0');
+  header.append(QByteArray::number(m_data.size()));
+  header.append(QByteArray(128 - header.size(), '\0'));
+
+  m_state = State::SendingHeader;
+  m_timer.start(RESPONSE_TIMEOUT);
+  write(block(0, header));
+}
+
+/**
+ * Sends the data blocks that fit in the transmission window
+ */
+void IO::FileTransfer::sendWindow()
+{
+  m_state = State::SendingData;
+  m_timer.start(RESPONSE_TIMEOUT);
+
+  const int size = blockSize();
+  const int count = blockCount();
+  while (active() && m_nextBlock < count
+         && m_nextBlock - m_ackedBlocks < m_window)
+  {
+    const auto payload = m_data.mid(m_nextBlock * size, size);
+    ++m_nextBlock;
+    write(block(m_nextBlock, payload));
+  }
+}
+
+/**
+ * Sends the empty YMODEM header block that ends the batch
+ */
+void IO::FileTransfer::sendTrailer()
+{
+  m_state = State::SendingTrailer;
+  m_timer.start(RESPONSE_TIMEOUT);
+  write(block(0, QByteArray(128, '\0')));
+}
+
+/**
+ * Notifies the receiver that all the data blocks have been sent
+ */
+void IO::FileTransfer::sendEot()
+{
+  m_state = State::SendingEot;
+  m_timer.start(RESPONSE_TIMEOUT);
+  write(QByteArray(1, EOT));
+}
+
+/**
+ * Sends the last packet again after a negative acknowledgement or a
+ * timeout, data blocks are sent again starting from the first block that
+ * was not acknowledged.
+ */
+void IO::FileTransfer::retransmit()
+{
+  // Too many retries, abort
+  if (++m_retries > MAX_RETRIES)
+  {
+    if (m_protocol != Protocol::Raw)
+      IO::Manager::instance().writeData(QByteArray(3, CAN));
+
+    finish(false, tr("The receiver is not responding"));
+    return;
+  }
+
+  // Send the last packet again
+  switch (m_state)
+  {
+    case State::SendingHeader:
+      sendHeader();
+      break;
+    case State::SendingData:
+      m_nextBlock = m_ackedBlocks;
+      sendWindow();
+      break;
+    case State::SendingEot:
+      sendEot();
+      break;
+    case State::SendingTrailer:
+      sendTrailer();
+      break;
+    default:
+      m_timer.start(RESPONSE_TIMEOUT);
+      break;
+  }
+}
+
+/**
+ * Writes the given @a data to the device, the transfer is aborted if the
+ * data cannot be queued.
+ */
+void IO::FileTransfer::write(const QByteArray &data)
+{
+  if (IO::Manager::instance().writeData(data) < 0)
+    finish(false, tr("Unable to write data to the device"));
+}
+
+/**
+ * Updates the state of XMODEM/YMODEM transfers with the given response
+ * @a byte sent by the receiver.
+ */
+void IO::FileTransfer::processByte(const char byte)
+{
+  // Two consecutive CAN characters abort the transfer
+  if (byte == CAN)
+  {
+    if (++m_cancels >= 2)
+      finish(false, tr("Cancelled by the receiver"));
+
+    return;
+  }
+
+  // Update the transfer state
+  m_cancels = 0;
+  const bool request = byte == CRC_MODE || byte == NAK;
+  switch (m_state)
+  {
+    // Receiver requested the first block, select checksum mode
+    case State::WaitingReceiver:
+      if (request)
+      {
+        m_retries = 0;
+        m_crc = byte == CRC_MODE;
+        if (m_protocol == Protocol::YModem)
+          sendHeader();
+        else
+          sendWindow();
+      }
+      break;
+
+    // YMODEM header sent, the receiver requests the data after the ACK
+    case State::SendingHeader:
+      if (byte == ACK)
+      {
+        m_retries = 0;
+        m_state = State::WaitingData;
+        m_timer.start(RESPONSE_TIMEOUT);
+      }
+      else if (request)
+        retransmit();
+      break;
+    case State::WaitingData:
+      if (request)
+        sendWindow();
+      break;
+
+    // Data blocks sent, slide the window for each acknowledgement
+    case State::SendingData:
+      if (byte == ACK && m_ackedBlocks < m_nextBlock)
+      {
+        m_retries = 0;
+        ++m_ackedBlocks;
+        m_transferred = qMin<qint64>(
+            static_cast<qint64>(m_ackedBlocks) * blockSize(), m_data.size());
+
+        if (m_ackedBlocks >= blockCount())
+          sendEot();
+        else
+          sendWindow();
+      }
+      else if (request)
+        retransmit();
+      break;
+
+    // End of transmission acknowledged, YMODEM ends the batch
+    case State::SendingEot:
+      if (byte == ACK)
+      {
+        m_retries = 0;
+        if (m_protocol == Protocol::YModem)
+        {
+          m_state = State::WaitingTrailer;
+          m_timer.start(RESPONSE_TIMEOUT);
+        }
+        else
+          finish(true, tr("Upload complete"));
+      }
+      else if (byte == NAK)
+        retransmit();
+      break;
+    case State::WaitingTrailer:
+      if (request)
+        sendTrailer();
+      break;
+    case State::SendingTrailer:
+      if (byte == ACK)
+        finish(true, tr("Upload complete"));
+      else if (request)
+        retransmit();
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * Ends the current transfer & updates the user interface
+ */
+void IO::FileTransfer::finish(const bool success, const QString &status)
+{
+  m_timer.stop();
+  m_state = State::Idle;
+  if (success)
+    m_transferred = m_data.size();
+
+  setStatus(status);
+  Q_EMIT activeChanged();
+  Q_EMIT progressChanged();
+}
+
+/**
+ * Changes the status text shown in the user interface
+ */
+void IO::FileTransfer::setStatus(const QString &status)
+{
+  if (m_status != status)
+  {
+    m_status = status;
+    Q_EMIT statusChanged();
+  }
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+#include <DataTypes.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+/**
+ * @brief The FileTransfer class
+ *
+ * Uploads files (e.g. firmware images or configuration blobs) to the
+ * connected device. The following protocols are supported:
+ *
+ * - @c Raw: the file is written as-is, the throughput is only limited by the
+ *   pacing rate & flow control settings of the @c WriteQueue.
+ * - @c XModem & @c XModem1K: blocks of 128 or 1024 bytes protected by a
+ *   CRC-16 (or an 8-bit sum, if the receiver does not request CRC mode).
+ * - @c YModem: XMODEM-1K blocks preceded by a header block with the name &
+ *   size of the file.
+ *
+ * All the data is written through @c IO::Manager::writeData(), so uploads
+ * share the flow control of the outgoing queue & never block the user
+ * interface. Raw uploads keep a limited amount of data in the queue, which
+ * is refilled as the driver transmits it.
+ *
+ * XMODEM/YMODEM uploads are driven by the responses of the receiver, with an
+ * optional window of blocks that are sent ahead of the last acknowledged
+ * one. A window of one block is the standard stop-and-wait protocol, larger
+ * windows remove the round-trip latency for receivers that buffer incoming
+ * blocks; if a block is rejected, the transfer goes back to it.
+ */
+class FileTransfer : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool active
+               READ active
+               NOTIFY activeChanged)
+    Q_PROPERTY(QString fileName
+               READ fileName
+               NOTIFY fileChanged)
+    Q_PROPERTY(qint64 fileSize
+               READ fileSize
+               NOTIFY fileChanged)
+    Q_PROPERTY(int protocol
+               READ protocol
+               WRITE setProtocol
+               NOTIFY protocolChanged)
+    Q_PROPERTY(int window
+               READ window
+               WRITE setWindow
+               NOTIFY windowChanged)
+    Q_PROPERTY(QString status
+               READ status
+               NOTIFY statusChanged)
+    Q_PROPERTY(qreal progress
+               READ progress
+               NOTIFY progressChanged)
+    Q_PROPERTY(qint64 transferredBytes
+               READ transferredBytes
+               NOTIFY progressChanged)
+    Q_PROPERTY(qreal throughput
+               READ throughput
+               NOTIFY progressChanged)
+    Q_PROPERTY(StringList availableProtocols
+               READ availableProtocols
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void fileChanged();
+  void activeChanged();
+  void statusChanged();
+  void windowChanged();
+  void protocolChanged();
+  void progressChanged();
+
+private:
+  explicit FileTransfer();
+  FileTransfer(FileTransfer &&) = delete;
+  FileTransfer(const FileTransfer &) = delete;
+  FileTransfer &operator=(FileTransfer &&) = delete;
+  FileTransfer &operator=(const FileTransfer &) = delete;
+
+public:
+  static FileTransfer &instance();
+
+  enum class Protocol
+  {
+    Raw,
+    XModem,
+    XModem1K,
+    YModem
+  };
+  Q_ENUM(Protocol)
+
+  bool active() const;
+  QString fileName() const;
+  qint64 fileSize() const;
+  int protocol() const;
+  int window() const;
+  QString status() const;
+  qreal progress() const;
+  qint64 transferredBytes() const;
+  qreal throughput() const;
+  StringList availableProtocols() const;
+
+public Q_SLOTS:
+  void start();
+  void cancel();
+  void selectFile();
+  void setFile(const QString &path);
+  void setWindow(const int blocks);
+  void setProtocol(const int protocol);
+
+private Q_SLOTS:
+  void onTimeout();
+  void onDataSent();
+  void onConnectedChanged();
+  void onDataReceived(const int stream, const QByteArray &data,
+                      const qint64 timestamp);
+
+private:
+  enum class State
+  {
+    Idle,
+    WaitingReceiver,
+    SendingHeader,
+    WaitingData,
+    SendingData,
+    SendingEot,
+    WaitingTrailer,
+    SendingTrailer
+  };
+
+  int blockSize() const;
+  int blockCount() const;
+  QByteArray block(const int sequence, const QByteArray &payload) const;
+
+  void fillQueue();
+  void sendHeader();
+  void sendWindow();
+  void sendTrailer();
+  void sendEot();
+  void retransmit();
+  void write(const QByteArray &data);
+  void processByte(const char byte);
+  void finish(const bool success, const QString &status);
+  void setStatus(const QString &status);
+
+private:
+  State m_state;
+  Protocol m_protocol;
+
+  bool m_crc;
+  int m_window;
+  int m_retries;
+  int m_cancels;
+  int m_nextBlock;
+  int m_ackedBlocks;
+
+  qint64 m_offset;
+  qint64 m_transferred;
+
+  QString m_path;
+  QString m_status;
+  QByteArray m_data;
+
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+  Misc::Settings m_settings;
+};
+} // namespace IO
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <QtGlobal>
+#include <QDateTime>
+#include <IO/FrameQueue.h>
+
+/**
+ * Constructor function, pre-allocates @a capacity bytes for the frame data and
+ * @a slots entries for the frame index.
+ */
+IO::FrameQueue::FrameQueue(const int capacity, const int slots)
+  : m_capacity(qMax(1, capacity))
+  , m_slotCount(qMax(1, slots))
+  , m_writePosition(0)
+  , m_head(0)
+  , m_reserved(0)
+  , m_notificationPending(false)
+  , m_consumerCount(0)
+  , m_data(new char[m_capacity])
+  , m_slots(new Slot[m_slotCount])
+{
+  for (int i = 0; i < m_slotCount; ++i)
+  {
+    m_slots[i].sequence.store(0);
+    m_slots[i].position.store(0);
+    m_slots[i].length.store(0);
+    m_slots[i].device.store(0);
+    m_slots[i].timestamp.store(0);
+  }
+
+  for (int i = 0; i < MaxConsumers; ++i)
+  {
+    m_consumers[i].cursor.store(0);
+    m_consumers[i].dropped.store(0);
+  }
+}
+
+/**
+ * Returns the number of bytes reserved for frame data
+ */
+int IO::FrameQueue::capacity() const
+{
+  return m_capacity;
+}
+
+/**
+ * Returns the maximum number of frames that can be stored in the queue
+ */
+int IO::FrameQueue::slotCount() const
+{
+  return m_slotCount;
+}
+
+/**
+ * Returns the number of registered consumers
+ */
+int IO::FrameQueue::consumerCount() const
+{
+  return m_consumerCount.load(std::memory_order_acquire);
+}
+
+/**
+ * Returns the total number of frames pushed to the queue
+ */
+quint64 IO::FrameQueue::published() const
+{
+  return m_head.load(std::memory_order_acquire);
+}
+
+/**
+ * Returns the name given to the @a consumer when it was registered
+ */
+QString IO::FrameQueue::consumerName(const int consumer) const
+{
+  if (consumer < 0 || consumer >= consumerCount())
+    return QString();
+
+  return m_consumers[consumer].name;
+}
+
+/**
+ * Returns the number of frames that have been published but not yet read by
+ * the given @a consumer.
+ */
+quint64 IO::FrameQueue::lag(const int consumer) const
+{
+  if (consumer < 0 || consumer >= consumerCount())
+    return 0;
+
+  const auto &state = m_consumers[consumer];
+  const auto head = m_head.load(std::memory_order_acquire);
+  const auto cursor = state.cursor.load(std::memory_order_acquire);
+  return head > cursor ? head - cursor : 0;
+}
+
+/**
+ * Returns the number of frames that were overwritten before the given
+ * @a consumer could read them.
+ */
+quint64 IO::FrameQueue::dropped(const int consumer) const
+{
+  if (consumer < 0 || consumer >= consumerCount())
+    return 0;
+
+  return m_consumers[consumer].dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ * Registers a new consumer and returns its identifier, or -1 if the maximum
+ * number of consumers has been reached. The consumer will receive all frames
+ * published after this call.
+ *
+ * @note consumers should be registered before frames start flowing, this is
+ *       usually done in the constructor of each application module.
+ */
+int IO::FrameQueue::registerConsumer(const QString &name)
+{
+  const int id = m_consumerCount.load(std::memory_order_relaxed);
+  if (id >= MaxConsumers)
+    return -1;
+
+  m_consumers[id].name = name;
+  m_consumers[id].dropped.store(0, std::memory_order_relaxed);
+  m_consumers[id].cursor.store(m_head.load(std::memory_order_acquire),
+                               std::memory_order_relaxed);
+
+  m_consumerCount.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+/**
+ * Returns the current value (in microseconds) of the monotonic clock used to
+ * timestamp the received data. The clock is not affected by changes of the
+ * system time, so the difference between two timestamps is always valid.
+ */
+qint64 IO::FrameQueue::timestamp()
+{
+  using namespace std::chrono;
+  const auto now = steady_clock::now().time_since_epoch();
+  return duration_cast<microseconds>(now).count();
+}
+
+/**
+ * Converts the given monotonic @a timestamp (see @c timestamp()) to the
+ * system time, in milliseconds since the UNIX epoch. A @a timestamp of zero
+ * (e.g. a frame that was not received from a device) is converted to the
+ * current system time.
+ */
+qint64 IO::FrameQueue::toMSecsSinceEpoch(const qint64 timestamp)
+{
+  const auto now = QDateTime::currentMSecsSinceEpoch();
+  if (timestamp <= 0)
+    return now;
+
+  return now - (FrameQueue::timestamp() - timestamp) / 1000;
+}
+
+/**
+ * Copies the given @a frame into the queue, together with the device & time
+ * @a info of the frame, and makes it visible to all consumers. This function
+ * never blocks, if the queue is full the oldest frames are overwritten.
+ *
+ * @returns @c false if the frame is empty or larger than the queue capacity.
+ */
+bool IO::FrameQueue::push(const QByteArray &frame, const FrameInfo &info)
+{
+  // Validate frame length
+  const int length = frame.size();
+  if (length <= 0 || length > m_capacity)
+    return false;
+
+  // Announce the region that is about to be overwritten
+  const auto sequence = m_head.load(std::memory_order_relaxed);
+  const auto position = m_writePosition;
+  m_reserved.store(position + length, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  // Copy frame data, wrapping around the end of the ring if needed
+  const int offset = static_cast<int>(position % m_capacity);
+  const int span = qMin(length, m_capacity - offset);
+  memcpy(m_data.data() + offset, frame.constData(), span);
+  if (span < length)
+    memcpy(m_data.data(), frame.constData() + span, length - span);
+
+  // Update the index slot, readers ignore it while its sequence is zero
+  auto &slot = m_slots[static_cast<int>(sequence % m_slotCount)];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.position.store(position, std::memory_order_relaxed);
+  slot.length.store(length, std::memory_order_relaxed);
+  slot.device.store(info.device, std::memory_order_relaxed);
+  slot.timestamp.store(info.timestamp, std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_release);
+
+  // Publish the frame
+  m_writePosition = position + length;
+  m_head.store(sequence + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * Copies the next frame available for the given @a consumer into @a frame. If
+ * @a info is not null, it is set to the device & time information of the
+ * frame.
+ *
+ * Frames that are overwritten by the producer while (or before) they are
+ * copied are discarded and counted as dropped frames.
+ *
+ * @returns @c false if there are no more frames to read.
+ */
+bool IO::FrameQueue::pop(const int consumer, QByteArray &frame,
+                         FrameInfo *info)
+{
+  // Validate consumer
+  if (consumer < 0 || consumer >= consumerCount())
+    return false;
+
+  // Get consumer state
+  auto &state = m_consumers[consumer];
+  auto cursor = state.cursor.load(std::memory_order_relaxed);
+  quint64 lost = 0;
+
+  // Find the next frame that has not been overwritten
+  bool found = false;
+  while (!found)
+  {
+    // No more frames available
+    const auto head = m_head.load(std::memory_order_acquire);
+    if (cursor >= head)
+      break;
+
+    // Index slot of the cursor has been reused, skip to the oldest frame
+    if (head - cursor > static_cast<quint64>(m_slotCount))
+    {
+      lost += head - m_slotCount - cursor;
+      cursor = head - m_slotCount;
+    }
+
+    // Read frame position & length from the index slot
+    const auto &slot = m_slots[static_cast<int>(cursor % m_slotCount)];
+    const auto expected = cursor + 1;
+    if (slot.sequence.load(std::memory_order_acquire) != expected)
+    {
+      ++lost;
+      ++cursor;
+      continue;
+    }
+
+    const auto position = slot.position.load(std::memory_order_relaxed);
+    const auto length = slot.length.load(std::memory_order_relaxed);
+    const auto device = slot.device.load(std::memory_order_relaxed);
+    const auto time = slot.timestamp.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected
+        || m_reserved.load(std::memory_order_acquire) - position
+               > static_cast<quint64>(m_capacity))
+    {
+      ++lost;
+      ++cursor;
+      continue;
+    }
+
+    // Copy frame data
+    const int offset = static_cast<int>(position % m_capacity);
+    const int span = qMin(length, m_capacity - offset);
+    frame.resize(length);
+    memcpy(frame.data(), m_data.data() + offset, span);
+    if (span < length)
+      memcpy(frame.data() + span, m_data.data(), length - span);
+
+    // Discard the copy if the producer overwrote the data in the meantime
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_reserved.load(std::memory_order_relaxed) - position
+        > static_cast<quint64>(m_capacity))
+    {
+      ++lost;
+      ++cursor;
+      continue;
+    }
+
+    // Frame is valid
+    if (info)
+    {
+      info->device = device;
+      info->timestamp = time;
+    }
+
+    ++cursor;
+    found = true;
+  }
+
+  // Update consumer state
+  if (lost > 0)
+    state.dropped.fetch_add(lost, std::memory_order_relaxed);
+  state.cursor.store(cursor, std::memory_order_release);
+
+  return found;
+}
+
+/**
+ * Appends all the frames available for the given @a consumer to @a frames, or
+ * at most @a maxFrames frames if @a maxFrames is positive. This allows
+ * consumers to process all the frames extracted from a single read operation
+ * at once.
+ *
+ * @returns the number of frames appended to @a frames.
+ */
+int IO::FrameQueue::popBatch(const int consumer, QVector<QByteArray> &frames,
+                             const int maxFrames)
+{
+  int count = 0;
+  QByteArray frame;
+  while ((maxFrames <= 0 || count < maxFrames) && pop(consumer, frame))
+  {
+    frames.append(frame);
+    ++count;
+  }
+
+  return count;
+}
+
+/**
+ * Same as the function above, but also appends the device & time information
+ * of each frame to @a info.
+ */
+int IO::FrameQueue::popBatch(const int consumer, QVector<QByteArray> &frames,
+                             QVector<FrameInfo> &info, const int maxFrames)
+{
+  int count = 0;
+  FrameInfo tag;
+  QByteArray frame;
+  while ((maxFrames <= 0 || count < maxFrames) && pop(consumer, frame, &tag))
+  {
+    frames.append(frame);
+    info.append(tag);
+    ++count;
+  }
+
+  return count;
+}
+
+/**
+ * Moves the cursor of the given @a consumer to the newest frame, so that the
+ * frames that it has not read yet are discarded without being copied. The
+ * discarded frames are not counted as dropped frames.
+ *
+ * @returns the number of discarded frames.
+ */
+quint64 IO::FrameQueue::skip(const int consumer)
+{
+  if (consumer < 0 || consumer >= consumerCount())
+    return 0;
+
+  auto &state = m_consumers[consumer];
+  const auto head = m_head.load(std::memory_order_acquire);
+  const auto cursor = state.cursor.load(std::memory_order_relaxed);
+  state.cursor.store(head, std::memory_order_release);
+  return head > cursor ? head - cursor : 0;
+}
+
+/**
+ * Marks that consumers must be notified about new frames.
+ *
+ * @returns @c true if there was no pending notification, in which case the
+ *          caller is responsible for notifying the consumers. This avoids
+ *          flooding the event loop of the consumers with a notification for
+ *          each frame.
+ */
+bool IO::FrameQueue::requestNotification()
+{
+  return !m_notificationPending.exchange(true, std::memory_order_acq_rel);
+}
+
+/**
+ * Clears the pending notification flag, this must be done before consumers
+ * start reading frames, so that frames published while they read generate a
+ * new notification.
+ */
+void IO::FrameQueue::clearNotification()
+{
+  m_notificationPending.store(false, std::memory_order_release);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QScopedArrayPointer>
+
+namespace IO
+{
+/**
+ * Information attached to each frame published to the frame queue
+ */
+struct FrameInfo
+{
+  int device = 0;
+  qint64 timestamp = 0;
+};
+
+/**
+ * @brief The FrameQueue class
+ *
+ * Lock-free single-producer/multi-consumer queue that distributes the frames
+ * extracted by the I/O manager to the application modules (JSON generator,
+ * CSV export, MQTT client, etc).
+ *
+ * Frames are copied into a pre-allocated byte ring, and an index of
+ * pre-allocated slots stores the sequence number, position and length of each
+ * frame. Every consumer owns a cursor (the sequence number of the next frame
+ * that it will read), so consumers never interfere with each other and the
+ * producer never waits for them.
+ *
+ * When the ring is full the oldest frames are overwritten. A slow consumer
+ * detects this when it validates the frame that it just copied, discards it
+ * and jumps to the oldest frame that is still available. The number of frames
+ * lost this way is reported by @c dropped(), and the number of frames that a
+ * consumer has not read yet is reported by @c lag().
+ *
+ * Each frame is tagged with the identifier of the device that produced it and
+ * with the time at which its data was received (see @c timestamp()), so that
+ * consumers can tell apart and align the frames of simultaneously open
+ * devices.
+ *
+ * @note @c push() may only be called from a single thread, and @c pop() may
+ *       only be called by the thread that owns the given consumer.
+ */
+class FrameQueue
+{
+public:
+  explicit FrameQueue(const int capacity = 4 * 1024 * 1024,
+                      const int slots = 8192);
+
+  int capacity() const;
+  int slotCount() const;
+  int consumerCount() const;
+  quint64 published() const;
+
+  QString consumerName(const int consumer) const;
+  quint64 lag(const int consumer) const;
+  quint64 dropped(const int consumer) const;
+
+  int registerConsumer(const QString &name);
+
+  static qint64 timestamp();
+  static qint64 toMSecsSinceEpoch(const qint64 timestamp);
+
+  bool push(const QByteArray &frame, const FrameInfo &info = FrameInfo());
+  bool pop(const int consumer, QByteArray &frame, FrameInfo *info = Q_NULLPTR);
+  int popBatch(const int consumer, QVector<QByteArray> &frames,
+               const int maxFrames = -1);
+  int popBatch(const int consumer, QVector<QByteArray> &frames,
+               QVector<FrameInfo> &info, const int maxFrames = -1);
+  quint64 skip(const int consumer);
+
+  bool requestNotification();
+  void clearNotification();
+
+private:
+  struct Slot
+  {
+    std::atomic<quint64> sequence;
+    std::atomic<quint64> position;
+    std::atomic<int> length;
+    std::atomic<int> device;
+    std::atomic<qint64> timestamp;
+  };
+
+  struct Consumer
+  {
+    QString name;
+    std::atomic<quint64> cursor;
+    std::atomic<quint64> dropped;
+  };
+
+  enum
+  {
+    MaxConsumers = 16
+  };
+
+private:
+  const int m_capacity;
+  const int m_slotCount;
+
+  quint64 m_writePosition;
+  std::atomic<quint64> m_head;
+  std::atomic<quint64> m_reserved;
+  std::atomic<bool> m_notificationPending;
+
+  std::atomic<int> m_consumerCount;
+  Consumer m_consumers[MaxConsumers];
+
+  QScopedArrayPointer<char> m_data;
+  QScopedArrayPointer<Slot> m_slots;
+};
+} // namespace IO
@@ -0,0 +1,756 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QElapsedTimer>
+#include <IO/FrameReader.h>
+#include <Misc/Tracer.h>
+#include <Misc/Diagnostics.h>
+
+/**
+ * Maximum time (in milliseconds) that the line scanner waits for the rest of
+ * a possible checksum header when a data block ends with a finish byte
+ */
+static const int HOLD_TIMEOUT = 50;
+
+/**
+ * Constructor function, valid frames are published to the given @a queue and
+ * tagged with the given @a device identifier.
+ */
+IO::FrameReader::FrameReader(FrameQueue *queue, const int device)
+  : m_enableCrc(false)
+  , m_frameOpen(false)
+  , m_lineScanner(false)
+  , m_releaseFrame(false)
+  , m_scanOffset(0)
+  , m_device(device)
+  , m_timestamp(0)
+  , m_queue(queue)
+  , m_startSequence("/*")
+  , m_finishSequence("*/")
+  , m_dataBuffer(1024 * 1024)
+  , m_checksumAlgorithm(ChecksumAlgorithm::None)
+  , m_checksumPlacement(ChecksumPlacement::BeforeFinish)
+  , m_checksumEncoding(ChecksumEncoding::Raw)
+  , m_holdTimer(this)
+{
+  m_holdTimer.setSingleShot(true);
+  m_holdTimer.setInterval(HOLD_TIMEOUT);
+  connect(&m_holdTimer, &QTimer::timeout, this, &IO::FrameReader::flush);
+}
+
+/**
+ * Returns the identifier of the device whose frames are extracted by this
+ * frame reader.
+ */
+int IO::FrameReader::device() const
+{
+  return m_device;
+}
+
+/**
+ * Deletes the contents of the temporary buffer & resets the state of the
+ * frame scanner. This function is called when the device is disconnected or
+ * when the framing configuration changes.
+ */
+void IO::FrameReader::reset()
+{
+  m_enableCrc = false;
+  clearBuffer();
+  selectScanner();
+
+  if (m_decompressor)
+    m_decompressor->reset();
+}
+
+/**
+ * Deletes the contents of the temporary buffer, but keeps the checksum mode
+ * detected for the device. This function is called when a lost connection is
+ * restored automatically, so that the first frames received after the
+ * reconnection are verified like the frames received before it.
+ */
+void IO::FrameReader::resync()
+{
+  clearBuffer();
+
+  if (m_decompressor)
+    m_decompressor->reset();
+}
+
+/**
+ * Registers incoming data to the temporary buffer & extracts valid data
+ * frames from it. The frames that are completed by this data are tagged with
+ * the given @a timestamp (see @c FrameQueue::timestamp()), which should be
+ * obtained when the data is received from the device.
+ */
+void IO::FrameReader::processData(const QByteArray &data,
+                                  const qint64 timestamp)
+{
+  // Register reception time & time spent waiting to be processed
+  m_timestamp = timestamp;
+  auto &diagnostics = Misc::Diagnostics::instance();
+  diagnostics.recordLatency(Misc::Diagnostics::Stage::Reception, timestamp);
+
+  // Measure the time spent extracting frames
+  QElapsedTimer timer;
+  timer.start();
+
+  // Compressed data, frames are extracted after each decompressed chunk
+  if (m_decompressor)
+    decompressData(data);
+
+  // Raw data, obtain frames from data buffer
+  else
+  {
+    // Clear temp. buffer (e.g. device sends a lot of invalid data)
+    if (data.size() > m_dataBuffer.freeSpace())
+    {
+      clearBuffer();
+      diagnostics.increment(Misc::Diagnostics::Counter::BufferOverflows);
+    }
+
+    m_dataBuffer.append(data);
+    extractFrames();
+  }
+
+  // Register framing time
+  diagnostics.record(Misc::Diagnostics::Stage::Framing, timer.nsecsElapsed());
+}
+
+/**
+ * Pushes the given @a frame, received at the given @a timestamp, to the frame
+ * queue and notifies the application modules. Notifications are coalesced, so
+ * consumers are only notified once until they start reading the queue again.
+ */
+void IO::FrameReader::publishFrame(const QByteArray &frame,
+                                   const qint64 timestamp)
+{
+  Q_ASSERT(m_queue);
+
+  if (frame.isEmpty())
+    return;
+
+  FrameInfo info;
+  info.device = m_device;
+  info.timestamp = timestamp;
+  m_queue->push(frame, info);
+  if (m_queue->requestNotification())
+    Q_EMIT framesAvailable();
+
+  Q_EMIT frameReady(frame);
+}
+
+/**
+ * Pushes the given @a frames, received at the given @a timestamp, to the frame
+ * queue and notifies the application modules once for the whole batch.
+ */
+void IO::FrameReader::publishFrames(const QVector<QByteArray> &frames,
+                                    const qint64 timestamp)
+{
+  Q_ASSERT(m_queue);
+
+  FrameInfo info;
+  info.device = m_device;
+  info.timestamp = timestamp;
+
+  bool published = false;
+  Q_FOREACH (const auto &frame, frames)
+  {
+    if (!frame.isEmpty())
+    {
+      m_queue->push(frame, info);
+      published = true;
+    }
+  }
+
+  if (published && m_queue->requestNotification())
+    Q_EMIT framesAvailable();
+
+  Q_FOREACH (const auto &frame, frames)
+  {
+    if (!frame.isEmpty())
+      Q_EMIT frameReady(frame);
+  }
+}
+
+/**
+ * Changes the binary framer used to extract frames, the frame reader takes
+ * ownership of the given @a framer. If @a framer is @c Q_NULLPTR, frames are
+ * detected with the start/finish sequences.
+ */
+void IO::FrameReader::setFramer(IO::Framer *framer)
+{
+  m_framer.reset(framer);
+  reset();
+}
+
+/**
+ * Changes the decompressor applied to the incoming data, the frame reader
+ * takes ownership of the given @a decompressor. If @a decompressor is
+ * @c Q_NULLPTR, the incoming data is framed as-is.
+ */
+void IO::FrameReader::setDecompressor(IO::Decompressor *decompressor)
+{
+  m_decompressor.reset(decompressor);
+  reset();
+}
+
+/**
+ * Changes the capacity of the temporary buffer, stored data is discarded.
+ */
+void IO::FrameReader::setMaxBufferSize(const int maxBufferSize)
+{
+  m_dataBuffer.setCapacity(maxBufferSize);
+  reset();
+}
+
+/**
+ * Changes the sequence that indicates the start of a frame
+ */
+void IO::FrameReader::setStartSequence(const QByteArray &sequence)
+{
+  m_startSequence = sequence;
+  m_frameOpen = false;
+  m_scanOffset = 0;
+  selectScanner();
+}
+
+/**
+ * Changes the sequence that indicates the end of a frame
+ */
+void IO::FrameReader::setFinishSequence(const QByteArray &sequence)
+{
+  m_finishSequence = sequence;
+  m_scanOffset = 0;
+  selectScanner();
+}
+
+/**
+ * Changes the checksum algorithm used to validate each frame
+ */
+void IO::FrameReader::setChecksumAlgorithm(
+    const IO::ChecksumAlgorithm algorithm)
+{
+  m_checksumAlgorithm = algorithm;
+  selectScanner();
+}
+
+/**
+ * Changes the location of the checksum relative to the finish sequence, this
+ * setting is ignored when a binary framer is selected.
+ */
+void IO::FrameReader::setChecksumPlacement(
+    const IO::ChecksumPlacement placement)
+{
+  m_checksumPlacement = placement;
+  m_scanOffset = 0;
+}
+
+/**
+ * Changes the encoding used to transmit the checksum of each frame
+ */
+void IO::FrameReader::setChecksumEncoding(const IO::ChecksumEncoding encoding)
+{
+  m_checksumEncoding = encoding;
+}
+
+/**
+ * Deletes the contents of the temporary buffer. This function is called
+ * automatically when the temporary buffer does not have enough space to store
+ * the incoming data (e.g. the device is sending a lot of invalid data).
+ */
+void IO::FrameReader::clearBuffer()
+{
+  m_holdTimer.stop();
+  m_frameOpen = false;
+  m_scanOffset = 0;
+  m_dataBuffer.clear();
+
+  if (m_framer)
+    m_framer->reset();
+
+  if (m_decompressor)
+    m_decompressor->clearHistory();
+}
+
+/**
+ * Extracts the frames contained in the temporary buffer with the binary
+ * framer or the start/finish sequence scanner selected for the project.
+ */
+void IO::FrameReader::extractFrames()
+{
+  if (m_framer)
+    readBinaryFrames();
+  else if (m_lineScanner)
+    readLines();
+  else
+    readFrames();
+}
+
+/**
+ * Decompresses the given @a data into the temporary buffer & extracts frames
+ * every time that decompressed data is available, so that data larger than
+ * the buffer can be processed in several passes.
+ *
+ * If the decompressed data does not fit in the buffer, the unprocessed data
+ * is discarded (as with uncompressed data), while blocks that cannot be
+ * decompressed are counted as invalid frames.
+ */
+void IO::FrameReader::decompressData(const QByteArray &data)
+{
+  TRACE_SCOPE("IO::FrameReader::decompressData");
+
+  auto &diagnostics = Misc::Diagnostics::instance();
+  m_decompressor->feed(data);
+  while (true)
+  {
+    switch (m_decompressor->decompress(m_dataBuffer))
+    {
+      case Decompressor::Result::Idle:
+        return;
+      case Decompressor::Result::Data:
+        extractFrames();
+        break;
+      case Decompressor::Result::Overflow:
+        clearBuffer();
+        diagnostics.increment(Misc::Diagnostics::Counter::BufferOverflows);
+        break;
+      case Decompressor::Result::Corrupt:
+        diagnostics.increment(Misc::Diagnostics::Counter::InvalidFrames);
+        break;
+    }
+  }
+}
+
+/**
+ * Specialized version of @c readFrames() for frames that are terminated by a
+ * single byte & carry no checksum, which is the most common configuration.
+ *
+ * The finish byte is located with @c memchr() (see
+ * @c DelimiterScanner::find()), frames are copied out of the ring buffer once
+ * & all the frames of the data block are published as a single batch. If a
+ * checksum header (e.g. @c crc16:) follows a frame, the generic scanner takes
+ * over from that frame onwards.
+ *
+ * If the data block ends with a finish byte (or with the beginning of a
+ * checksum header), the last frame is held until more data arrives, so that
+ * a checksum header split across two blocks is still detected. If no data
+ * arrives within @c HOLD_TIMEOUT, the frame is published by @c flush().
+ */
+void IO::FrameReader::readLines()
+{
+  TRACE_SCOPE("IO::FrameReader::readLines");
+
+  // Read until start/finish combinations are not found
+  static const QByteArray crcHeader("crc");
+  const auto &start = m_startSequence;
+  const auto &finish = m_finishSequence;
+  QVector<QByteArray> frames;
+  m_holdTimer.stop();
+  while (!m_dataBuffer.isEmpty())
+  {
+    // Look for the start sequence & discard everything before it
+    if (!m_frameOpen)
+    {
+      auto sIndex = m_dataBuffer.indexOf(start);
+      if (sIndex < 0)
+      {
+        // Keep the tail, it may contain an incomplete start sequence
+        m_dataBuffer.consume(m_dataBuffer.size() - start.length() + 1);
+        break;
+      }
+
+      m_frameOpen = true;
+      m_scanOffset = 0;
+      m_dataBuffer.consume(sIndex + start.length());
+    }
+
+    // Look for the finish byte, resuming from the last scanned position
+    auto fIndex = m_dataBuffer.indexOf(finish, m_scanOffset);
+    if (fIndex < 0)
+    {
+      m_scanOffset = m_dataBuffer.size();
+      break;
+    }
+
+    // The bytes that follow the finish byte may be the beginning of a
+    // checksum header, wait for more data
+    const int tail = m_dataBuffer.size() - fIndex - 1;
+    if (!m_releaseFrame && tail < crcHeader.size()
+        && (tail == 0
+            || m_dataBuffer.matches(fIndex + 1, crcHeader.left(tail))))
+    {
+      m_scanOffset = fIndex;
+      m_holdTimer.start();
+      break;
+    }
+
+    // Checksum header found, let the generic scanner handle the stream
+    if (m_dataBuffer.matches(fIndex + 1, crcHeader))
+    {
+      m_scanOffset = fIndex;
+      m_lineScanner = false;
+      publishFrames(frames, m_timestamp);
+      readFrames();
+      return;
+    }
+
+    // Copy the frame & remove it from the buffer with its finish byte
+    if (fIndex > 0)
+      frames.append(m_dataBuffer.read(0, fIndex));
+
+    m_frameOpen = false;
+    m_dataBuffer.consume(fIndex + 1);
+  }
+
+  // Publish the frames of the data block
+  if (!frames.isEmpty())
+    publishFrames(frames, m_timestamp);
+}
+
+/**
+ * Publishes the frame held by the line scanner while it waits for a possible
+ * checksum header (see @c readLines()). This is called when no data arrives
+ * within @c HOLD_TIMEOUT, or when the end of the data is reached (e.g. when
+ * a raw capture is re-processed).
+ */
+void IO::FrameReader::flush()
+{
+  if (!m_lineScanner || m_framer)
+    return;
+
+  m_releaseFrame = true;
+  readLines();
+  m_releaseFrame = false;
+}
+
+/**
+ * Read frames from temporary buffer, every frame that contains the appropiate
+ * start/end sequence is removed from the buffer as soon as its read.
+ *
+ * The temporary buffer is a ring buffer, so removing data from it only moves
+ * its read position. The scanner is resumable: once the start sequence of a
+ * frame has been found, the position in which the search for the finish
+ * sequence stopped is stored in @c m_scanOffset, so that bytes that have
+ * already been inspected are not scanned again when more data arrives.
+ *
+ * Implemementation credits: @jpnorair and @alex-spataru
+ */
+void IO::FrameReader::readFrames()
+{
+  TRACE_SCOPE("IO::FrameReader::readFrames");
+
+  // Read until start/finish combinations are not found
+  const auto &start = m_startSequence;
+  const auto &finish = m_finishSequence;
+  while (!m_dataBuffer.isEmpty())
+  {
+    // Look for the start sequence & discard everything before it
+    if (!m_frameOpen)
+    {
+      auto sIndex = m_dataBuffer.indexOf(start);
+      if (sIndex < 0)
+      {
+        // Keep the tail, it may contain an incomplete start sequence
+        m_dataBuffer.consume(m_dataBuffer.size() - start.length() + 1);
+        break;
+      }
+
+      m_frameOpen = true;
+      m_scanOffset = 0;
+      m_dataBuffer.consume(sIndex + start.length());
+    }
+
+    // Look for the finish sequence, resuming from the last scanned position
+    auto fIndex = m_dataBuffer.indexOf(finish, m_scanOffset);
+    if (fIndex < 0)
+    {
+      m_scanOffset = qMax(0, m_dataBuffer.size() - finish.length() + 1);
+      break;
+    }
+
+    // Frame empty, discard it and wait for the next start sequence
+    if (fIndex == 0)
+    {
+      m_frameOpen = false;
+      m_dataBuffer.consume(finish.length());
+      continue;
+    }
+
+    // Checksum verification
+    int chop = 0;
+    auto frame = m_dataBuffer.peek(0, fIndex);
+    auto result = checksumTrailer() ? validateTrailer(frame, fIndex, &chop)
+                                    : integrityChecks(frame, fIndex, &chop);
+
+    // Checksum data incomplete, try next time...
+    if (result == ValidationStatus::ChecksumIncomplete)
+    {
+      m_scanOffset = fIndex;
+      break;
+    }
+
+    // Publish a detached copy of the frame, receivers may store it
+    if (result == ValidationStatus::FrameOk && checksumTrailer())
+      publishFrame(QByteArray(frame.constData(), fIndex), m_timestamp);
+    else if (result == ValidationStatus::FrameOk)
+    {
+      auto length = validatePayload(frame);
+      if (length > 0)
+        publishFrame(QByteArray(frame.constData(), length), m_timestamp);
+      else if (length < 0)
+        result = ValidationStatus::ChecksumError;
+    }
+
+    // Register invalid frames
+    if (result == ValidationStatus::ChecksumError)
+      Misc::Diagnostics::instance().increment(
+          Misc::Diagnostics::Counter::InvalidFrames);
+
+    // Remove the frame, finish sequence & checksum from the buffer
+    m_frameOpen = false;
+    m_dataBuffer.consume(fIndex + chop);
+  }
+}
+
+/**
+ * Extracts frames from the temporary buffer using the binary framer selected
+ * with @c setFramer() (e.g. length-prefixed, COBS or SLIP frames).
+ */
+void IO::FrameReader::readBinaryFrames()
+{
+  TRACE_SCOPE("IO::FrameReader::readBinaryFrames");
+
+  QByteArray frame;
+  while (m_framer->nextFrame(m_dataBuffer, frame))
+  {
+    auto length = validatePayload(frame);
+    if (length == frame.size())
+      publishFrame(frame, m_timestamp);
+    else if (length > 0)
+      publishFrame(frame.left(length), m_timestamp);
+    else if (length < 0)
+      Misc::Diagnostics::instance().increment(
+          Misc::Diagnostics::Counter::InvalidFrames);
+  }
+}
+
+/**
+ * Selects the specialized line scanner (see @c readLines()) if frames are
+ * terminated by a single byte, no checksum algorithm is selected & no
+ * checksum header has been detected in the stream.
+ */
+void IO::FrameReader::selectScanner()
+{
+  m_lineScanner = !m_framer && !m_enableCrc && m_finishSequence.length() == 1
+                  && !m_startSequence.isEmpty()
+                  && m_checksumAlgorithm == ChecksumAlgorithm::None;
+}
+
+/**
+ * Returns @c true if the project checksum is transmitted as a trailer that
+ * follows the finish sequence of each frame.
+ */
+bool IO::FrameReader::checksumTrailer() const
+{
+  return m_checksumPlacement == ChecksumPlacement::AfterFinish
+         && m_checksumAlgorithm != ChecksumAlgorithm::None;
+}
+
+/**
+ * Verifies the trailing checksum of the given @a frame with the checksum
+ * algorithm & encoding selected by the project.
+ *
+ * @returns the length of the frame payload (without the checksum bytes), or -1
+ *          if the checksum does not match. If no checksum algorithm is
+ *          selected, the length of the complete frame is returned.
+ */
+int IO::FrameReader::validatePayload(const QByteArray &frame) const
+{
+  // No checksum appended to the frame
+  const int bytes = checksumLength(m_checksumAlgorithm, m_checksumEncoding);
+  if (bytes == 0)
+    return frame.size();
+
+  // Frame does not contain data besides the checksum
+  const int length = frame.size() - bytes;
+  if (length <= 0)
+    return -1;
+
+  // Read received checksum
+  uint32_t received = 0;
+  const char *data = frame.constData() + length;
+  if (!readChecksum(data, bytes, m_checksumEncoding, &received))
+    return -1;
+
+  // Compare checksums
+  if (checksum(m_checksumAlgorithm, frame.constData(), length) == received)
+    return length;
+
+  return -1;
+}
+
+/**
+ * Verifies the checksum trailer that follows the finish sequence of the given
+ * @a frame. The trailer has a fixed length, so it is read directly at its
+ * offset in the temporary buffer.
+ *
+ * @param frame data protected by the checksum
+ * @param finishOffset offset of the finish sequence in the temporary buffer
+ * @param bytes pointer to the number of bytes that we need to chop from the
+ * master buffer
+ */
+IO::FrameReader::ValidationStatus
+IO::FrameReader::validateTrailer(const QByteArray &frame,
+                                 const int finishOffset, int *bytes)
+{
+  // Wait until the complete trailer has been received
+  const int length = checksumLength(m_checksumAlgorithm, m_checksumEncoding);
+  const int offset = finishOffset + m_finishSequence.length();
+  if (m_dataBuffer.size() < offset + length)
+    return ValidationStatus::ChecksumIncomplete;
+
+  // Remove the finish sequence & the trailer from the buffer
+  *bytes = m_finishSequence.length() + length;
+
+  // Read received checksum
+  uint32_t received = 0;
+  const auto trailer = m_dataBuffer.read(offset, length);
+  if (!readChecksum(trailer.constData(), length, m_checksumEncoding, &received))
+    return ValidationStatus::ChecksumError;
+
+  // Compare checksums
+  auto data = frame.constData();
+  if (checksum(m_checksumAlgorithm, data, frame.size()) == received)
+    return ValidationStatus::FrameOk;
+
+  return ValidationStatus::ChecksumError;
+}
+
+/**
+ * Checks if the temporary buffer has a checksum right after the finish
+ * sequence of the given @a frame. If so, the function shall calculate the
+ * appropiate checksum to for the @a frame and compare it with the received
+ * checksum to verify the integrity of received data.
+ *
+ * @param frame data in which we shall perform integrity checks
+ * @param finishOffset offset of the finish sequence in the temporary buffer
+ * @param bytes pointer to the number of bytes that we need to chop from the
+ * master buffer
+ */
+IO::FrameReader::ValidationStatus
+IO::FrameReader::integrityChecks(const QByteArray &frame, const int finishOffset,
+                             int *bytes)
+{
+  // Get finish sequence as byte array
+  const auto &finish = m_finishSequence;
+  auto crc8Header = finish + "crc8:";
+  auto crc16Header = finish + "crc16:";
+  auto crc32Header = finish + "crc32:";
+
+  // Check CRC-8
+  if (m_dataBuffer.matches(finishOffset, crc8Header))
+  {
+    // Enable the CRC flag
+    m_enableCrc = true;
+    auto offset = finishOffset + crc8Header.length();
+
+    // Check if we have enough data in the buffer
+    if (m_dataBuffer.size() >= offset + 1)
+    {
+      // Increment the number of bytes to remove from master buffer
+      *bytes += crc8Header.length() + 1;
+
+      // Get 8-bit checksum
+      const quint8 crc = m_dataBuffer.at(offset);
+
+      // Compare checksums
+      if (crc8(frame.data(), frame.length()) == crc)
+        return ValidationStatus::FrameOk;
+      else
+        return ValidationStatus::ChecksumError;
+    }
+  }
+
+  // Check CRC-16
+  else if (m_dataBuffer.matches(finishOffset, crc16Header))
+  {
+    // Enable the CRC flag
+    m_enableCrc = true;
+    auto offset = finishOffset + crc16Header.length();
+
+    // Check if we have enough data in the buffer
+    if (m_dataBuffer.size() >= offset + 2)
+    {
+      // Increment the number of bytes to remove from master buffer
+      *bytes += crc16Header.length() + 2;
+
+      // Get 16-bit checksum
+      const quint8 a = m_dataBuffer.at(offset + 0);
+      const quint8 b = m_dataBuffer.at(offset + 1);
+      const quint16 crc = (a << 8) | (b & 0xff);
+
+      // Compare checksums
+      if (crc16(frame.data(), frame.length()) == crc)
+        return ValidationStatus::FrameOk;
+      else
+        return ValidationStatus::ChecksumError;
+    }
+  }
+
+  // Check CRC-32
+  else if (m_dataBuffer.matches(finishOffset, crc32Header))
+  {
+    // Enable the CRC flag
+    m_enableCrc = true;
+    auto offset = finishOffset + crc32Header.length();
+
+    // Check if we have enough data in the buffer
+    if (m_dataBuffer.size() >= offset + 4)
+    {
+      // Increment the number of bytes to remove from master buffer
+      *bytes += crc32Header.length() + 4;
+
+      // Get 32-bit checksum
+      const quint8 a = m_dataBuffer.at(offset + 0);
+      const quint8 b = m_dataBuffer.at(offset + 1);
+      const quint8 c = m_dataBuffer.at(offset + 2);
+      const quint8 d = m_dataBuffer.at(offset + 3);
+      const quint32 crc = (a << 24) | (b << 16) | (c << 8) | (d & 0xff);
+
+      // Compare checksums
+      if (crc32(frame.data(), frame.length()) == crc)
+        return ValidationStatus::FrameOk;
+      else
+        return ValidationStatus::ChecksumError;
+    }
+  }
+
+  // Buffer does not contain CRC code
+  else if (!m_enableCrc)
+  {
+    *bytes += finish.length();
+    return ValidationStatus::FrameOk;
+  }
+
+  // Checksum data incomplete
+  return ValidationStatus::ChecksumIncomplete;
+}
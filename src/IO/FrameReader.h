@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QScopedPointer>
+
+#include <IO/Framer.h>
+#include <IO/Checksum.h>
+#include <IO/FrameQueue.h>
+#include <IO/Decompressor.h>
+#include <IO/CircularBuffer.h>
+
+namespace IO
+{
+/**
+ * @brief The FrameReader class
+ *
+ * Frame extraction stage of the I/O manager. The frame reader stores the raw
+ * data received from the device in a ring buffer, detects complete frames
+ * (using start/finish delimiters or a binary @c Framer), verifies their
+ * checksums and emits the @c frameReady() signal for each valid frame.
+ *
+ * Most devices terminate their frames with a single byte (e.g. a newline)
+ * and do not append a checksum. For this configuration, the frame reader
+ * uses a specialized scanner that looks for the finish byte with @c memchr()
+ * and publishes all the frames of a data block as a single batch, skipping
+ * the checksum header checks of the generic start/finish scanner. The
+ * generic scanner takes over if a checksum header is found in the stream.
+ *
+ * The checksum selected by the project may be transmitted as raw bytes or as
+ * ASCII hexadecimal digits, either before the finish sequence or as a
+ * fixed-length trailer right after it. In both cases, the location of the
+ * checksum is known in advance, so it is read directly at its offset instead
+ * of being searched for.
+ *
+ * Devices that compress their data can be handled with a @c Decompressor,
+ * which decompresses the incoming data directly into the ring buffer before
+ * frames are extracted from it.
+ *
+ * Each open device has its own frame reader, so that the data of one device
+ * never interferes with the framing state of another one.
+ *
+ * The class does not interact with any other module (besides reporting its
+ * timings to the lock-free @c Misc::Diagnostics counters), so the I/O manager
+ * can either call it directly or move it to a dedicated worker thread. In the
+ * latter case, all functions must be invoked through queued calls.
+ */
+class FrameReader : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void framesAvailable();
+  void frameReady(const QByteArray &frame);
+
+public:
+  enum class ValidationStatus
+  {
+    FrameOk,
+    ChecksumError,
+    ChecksumIncomplete
+  };
+
+  explicit FrameReader(FrameQueue *queue, const int device = 0);
+
+  int device() const;
+
+public Q_SLOTS:
+  void reset();
+  void resync();
+  void flush();
+  void processData(const QByteArray &data, const qint64 timestamp);
+  void publishFrame(const QByteArray &frame, const qint64 timestamp);
+  void publishFrames(const QVector<QByteArray> &frames,
+                     const qint64 timestamp);
+
+  void setFramer(IO::Framer *framer);
+  void setDecompressor(IO::Decompressor *decompressor);
+  void setMaxBufferSize(const int maxBufferSize);
+  void setStartSequence(const QByteArray &sequence);
+  void setFinishSequence(const QByteArray &sequence);
+  void setChecksumAlgorithm(const IO::ChecksumAlgorithm algorithm);
+  void setChecksumPlacement(const IO::ChecksumPlacement placement);
+  void setChecksumEncoding(const IO::ChecksumEncoding encoding);
+
+private:
+  void clearBuffer();
+  void extractFrames();
+  void decompressData(const QByteArray &data);
+  void readLines();
+  void readFrames();
+  void readBinaryFrames();
+  void selectScanner();
+  bool checksumTrailer() const;
+  int validatePayload(const QByteArray &frame) const;
+  ValidationStatus validateTrailer(const QByteArray &frame,
+                                   const int finishOffset, int *bytesToChop);
+  ValidationStatus integrityChecks(const QByteArray &frame,
+                                   const int finishOffset, int *bytesToChop);
+
+private:
+  bool m_enableCrc;
+  bool m_frameOpen;
+  bool m_lineScanner;
+  bool m_releaseFrame;
+  int m_scanOffset;
+  int m_device;
+  qint64 m_timestamp;
+
+  FrameQueue *m_queue;
+  QByteArray m_startSequence;
+  QByteArray m_finishSequence;
+  CircularBuffer m_dataBuffer;
+  QScopedPointer<Framer> m_framer;
+  QScopedPointer<Decompressor> m_decompressor;
+  ChecksumAlgorithm m_checksumAlgorithm;
+  ChecksumPlacement m_checksumPlacement;
+  ChecksumEncoding m_checksumEncoding;
+  QTimer m_holdTimer;
+};
+} // namespace IO
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <IO/CircularBuffer.h>
+
+namespace IO
+{
+/**
+ * @brief The Framer class
+ *
+ * Abstract class that defines how complete frames are extracted from the
+ * temporary buffer of the I/O manager for binary framing protocols (e.g.
+ * length-prefixed packets, COBS or SLIP).
+ *
+ * Framers are stateful: they may remember how far they already scanned the
+ * buffer, so @c reset() must be called whenever the buffer is cleared.
+ */
+class Framer
+{
+public:
+  virtual ~Framer() {}
+  virtual void reset() = 0;
+  virtual bool nextFrame(CircularBuffer &buffer, QByteArray &frame) = 0;
+};
+} // namespace IO
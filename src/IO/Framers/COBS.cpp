@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Framers/COBS.h>
+
+/**
+ * Constructor function
+ */
+IO::Framers::COBS::COBS()
+  : m_scanOffset(0)
+{
+}
+
+/**
+ * Resets the position from which the framer looks for the frame delimiter
+ */
+void IO::Framers::COBS::reset()
+{
+  m_scanOffset = 0;
+}
+
+/**
+ * Extracts the next frame from the given @a buffer and stores the decoded
+ * data in @a frame.
+ *
+ * @returns @c true if a frame was extracted
+ */
+bool IO::Framers::COBS::nextFrame(CircularBuffer &buffer, QByteArray &frame)
+{
+  static const QByteArray delimiter(1, '\0');
+
+  while (!buffer.isEmpty())
+  {
+    // Look for the frame delimiter, resuming from the last scanned position
+    auto index = buffer.indexOf(delimiter, m_scanOffset);
+    if (index < 0)
+    {
+      m_scanOffset = buffer.size();
+      return false;
+    }
+
+    // Decode the frame & remove it from the buffer
+    m_scanOffset = 0;
+    auto valid = decode(buffer.peek(0, index), frame);
+    buffer.consume(index + 1);
+
+    // Only report valid & non-empty frames
+    if (valid && !frame.isEmpty())
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * Decodes the given COBS-encoded @a data (without the trailing zero byte)
+ * and writes the result to @a frame.
+ *
+ * @returns @c false if the encoding is invalid
+ */
+bool IO::Framers::COBS::decode(const QByteArray &data, QByteArray &frame)
+{
+  // Initialize parameters
+  frame.clear();
+  frame.reserve(data.size());
+  const int length = data.size();
+  const char *bytes = data.constData();
+
+  // Decode each block
+  int i = 0;
+  while (i < length)
+  {
+    // Get block code & validate it
+    const int code = static_cast<quint8>(bytes[i]);
+    if (code == 0 || i + code > length)
+      return false;
+
+    // Copy block data
+    frame.append(bytes + i + 1, code - 1);
+    i += code;
+
+    // Blocks shorter than 255 bytes are followed by an implicit zero
+    if (code < 0xFF && i < length)
+      frame.append('\0');
+  }
+
+  return true;
+}
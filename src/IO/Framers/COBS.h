@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <IO/Framer.h>
+
+namespace IO
+{
+namespace Framers
+{
+/**
+ * @brief The COBS class
+ *
+ * Extracts frames encoded with Consistent Overhead Byte Stuffing (COBS).
+ * Each encoded frame is terminated by a zero byte, which never appears
+ * inside the encoded data. Frames with an invalid encoding are discarded.
+ */
+class COBS : public Framer
+{
+public:
+  explicit COBS();
+
+  void reset() override;
+  bool nextFrame(CircularBuffer &buffer, QByteArray &frame) override;
+
+  static bool decode(const QByteArray &data, QByteArray &frame);
+
+private:
+  int m_scanOffset;
+};
+} // namespace Framers
+} // namespace IO
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Framers/LengthPrefix.h>
+
+/**
+ * Constructor function
+ */
+IO::Framers::LengthPrefix::LengthPrefix(const int prefixSize,
+                                        const bool bigEndian)
+  : m_prefixSize(2)
+  , m_bigEndian(bigEndian)
+{
+  setPrefixSize(prefixSize);
+}
+
+/**
+ * Returns the number of bytes used to encode the payload length
+ */
+int IO::Framers::LengthPrefix::prefixSize() const
+{
+  return m_prefixSize;
+}
+
+/**
+ * Returns @c true if the length prefix is encoded in big endian byte order
+ */
+bool IO::Framers::LengthPrefix::bigEndian() const
+{
+  return m_bigEndian;
+}
+
+/**
+ * Changes the number of bytes used to encode the payload length, valid values
+ * are 1, 2 and 4.
+ */
+void IO::Framers::LengthPrefix::setPrefixSize(const int bytes)
+{
+  if (bytes == 1 || bytes == 2 || bytes == 4)
+    m_prefixSize = bytes;
+}
+
+/**
+ * Changes the byte order used to encode the payload length
+ */
+void IO::Framers::LengthPrefix::setBigEndian(const bool bigEndian)
+{
+  m_bigEndian = bigEndian;
+}
+
+/**
+ * The framer does not keep any scan state, so there is nothing to reset.
+ */
+void IO::Framers::LengthPrefix::reset() {}
+
+/**
+ * Extracts the next frame from the given @a buffer and stores it in @a frame.
+ *
+ * If the length prefix indicates a payload that could never fit in the
+ * buffer, the first byte is discarded so that the framer can synchronize
+ * with the stream again.
+ *
+ * @returns @c true if a frame was extracted
+ */
+bool IO::Framers::LengthPrefix::nextFrame(CircularBuffer &buffer,
+                                          QByteArray &frame)
+{
+  while (buffer.size() >= m_prefixSize)
+  {
+    // Read payload length
+    quint32 length = 0;
+    for (int i = 0; i < m_prefixSize; ++i)
+    {
+      const quint32 byte = static_cast<quint8>(buffer.at(i));
+      if (m_bigEndian)
+        length = (length << 8) | byte;
+      else
+        length |= byte << (8 * i);
+    }
+
+    // Invalid length, skip one byte and try again
+    if (length > static_cast<quint32>(buffer.capacity() - m_prefixSize))
+    {
+      buffer.consume(1);
+      continue;
+    }
+
+    // Empty frame, discard the prefix
+    if (length == 0)
+    {
+      buffer.consume(m_prefixSize);
+      continue;
+    }
+
+    // Wait until the complete payload is received
+    const int size = static_cast<int>(length);
+    if (buffer.size() < m_prefixSize + size)
+      return false;
+
+    // Obtain the frame & remove it from the buffer
+    frame = buffer.read(m_prefixSize, size);
+    buffer.consume(m_prefixSize + size);
+    return true;
+  }
+
+  return false;
+}
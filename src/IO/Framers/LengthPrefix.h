@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <IO/Framer.h>
+
+namespace IO
+{
+namespace Framers
+{
+/**
+ * @brief The LengthPrefix class
+ *
+ * Extracts frames that are preceded by an unsigned integer indicating the
+ * length of the payload, for example:
+ *
+ *   [0x00 0x05] [0x01 0x02 0x03 0x04 0x05]
+ *
+ * The length prefix can be 1, 2 or 4 bytes long and can be encoded either
+ * in big endian or little endian byte order. The prefix itself is not
+ * included in the emitted frame.
+ */
+class LengthPrefix : public Framer
+{
+public:
+  explicit LengthPrefix(const int prefixSize = 2, const bool bigEndian = true);
+
+  int prefixSize() const;
+  bool bigEndian() const;
+
+  void setPrefixSize(const int bytes);
+  void setBigEndian(const bool bigEndian);
+
+  void reset() override;
+  bool nextFrame(CircularBuffer &buffer, QByteArray &frame) override;
+
+private:
+  int m_prefixSize;
+  bool m_bigEndian;
+};
+} // namespace Framers
+} // namespace IO
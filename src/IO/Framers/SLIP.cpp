@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Framers/SLIP.h>
+
+/**
+ * SLIP special characters (RFC 1055)
+ */
+static const char SLIP_END = static_cast<char>(0xC0);
+static const char SLIP_ESC = static_cast<char>(0xDB);
+static const char SLIP_ESC_END = static_cast<char>(0xDC);
+static const char SLIP_ESC_ESC = static_cast<char>(0xDD);
+
+/**
+ * Constructor function
+ */
+IO::Framers::SLIP::SLIP()
+  : m_scanOffset(0)
+{
+}
+
+/**
+ * Resets the position from which the framer looks for the END byte
+ */
+void IO::Framers::SLIP::reset()
+{
+  m_scanOffset = 0;
+}
+
+/**
+ * Extracts the next frame from the given @a buffer and stores the decoded
+ * data in @a frame. Empty frames (e.g. produced by devices that send an END
+ * byte before each packet) are ignored.
+ *
+ * @returns @c true if a frame was extracted
+ */
+bool IO::Framers::SLIP::nextFrame(CircularBuffer &buffer, QByteArray &frame)
+{
+  static const QByteArray delimiter(1, SLIP_END);
+
+  while (!buffer.isEmpty())
+  {
+    // Look for the END byte, resuming from the last scanned position
+    auto index = buffer.indexOf(delimiter, m_scanOffset);
+    if (index < 0)
+    {
+      m_scanOffset = buffer.size();
+      return false;
+    }
+
+    // Decode the frame & remove it from the buffer
+    m_scanOffset = 0;
+    auto valid = decode(buffer.peek(0, index), frame);
+    buffer.consume(index + 1);
+
+    // Only report valid & non-empty frames
+    if (valid && !frame.isEmpty())
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * Decodes the given SLIP-encoded @a data (without the END byte) and writes
+ * the result to @a frame.
+ *
+ * @returns @c false if the data contains an invalid escape sequence
+ */
+bool IO::Framers::SLIP::decode(const QByteArray &data, QByteArray &frame)
+{
+  // Initialize parameters
+  frame.clear();
+  frame.reserve(data.size());
+  const int length = data.size();
+  const char *bytes = data.constData();
+
+  // Copy bytes & replace escape sequences
+  for (int i = 0; i < length; ++i)
+  {
+    if (bytes[i] != SLIP_ESC)
+    {
+      frame.append(bytes[i]);
+      continue;
+    }
+
+    // Escape sequence at the end of the frame
+    if (++i >= length)
+      return false;
+
+    // Decode escape sequence
+    if (bytes[i] == SLIP_ESC_END)
+      frame.append(SLIP_END);
+    else if (bytes[i] == SLIP_ESC_ESC)
+      frame.append(SLIP_ESC);
+    else
+      return false;
+  }
+
+  return true;
+}
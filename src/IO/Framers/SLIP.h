@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <IO/Framer.h>
+
+namespace IO
+{
+namespace Framers
+{
+/**
+ * @brief The SLIP class
+ *
+ * Extracts frames encoded with the Serial Line Internet Protocol framing
+ * (RFC 1055). Frames are terminated by an END byte (0xC0) and the END/ESC
+ * bytes that appear in the payload are escaped with ESC (0xDB) sequences.
+ * Frames with an invalid escape sequence are discarded.
+ */
+class SLIP : public Framer
+{
+public:
+  explicit SLIP();
+
+  void reset() override;
+  bool nextFrame(CircularBuffer &buffer, QByteArray &frame) override;
+
+  static bool decode(const QByteArray &data, QByteArray &frame);
+
+private:
+  int m_scanOffset;
+};
+} // namespace Framers
+} // namespace IO
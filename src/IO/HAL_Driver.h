@@ -37,6 +37,15 @@ namespace IO
  * This allows the rest of the I/O module to interact with a wide range of
  * devices and protocols without the need of understanding protocol-specific
  * implementation details.
+ *
+ * Drivers emit @c dataReceived() together with the time at which the data was
+ * read from the device (see @c IO::FrameQueue::timestamp()), so that the time
+ * spent queueing & parsing the data does not affect the frame timestamps.
+ *
+ * Drivers that buffer outgoing data can report the number of bytes that have
+ * not been transmitted yet (@c bytesToWrite()) & whether the device is ready
+ * to receive data (@c clearToSend()), which are used by the @c WriteQueue of
+ * the I/O manager to implement flow control.
  */
 class HAL_Driver : public QObject
 {
@@ -45,7 +54,7 @@ class HAL_Driver : public QObject
 Q_SIGNALS:
   void configurationChanged();
   void dataSent(const QByteArray &data);
-  void dataReceived(const QByteArray &data);
+  void dataReceived(const QByteArray &data, const qint64 timestamp);
 
 public:
   virtual void close() = 0;
@@ -55,5 +64,8 @@ public:
   virtual bool configurationOk() const = 0;
   virtual quint64 write(const QByteArray &data) = 0;
   virtual bool open(const QIODevice::OpenMode mode) = 0;
+
+  virtual qint64 bytesToWrite() const { return 0; }
+  virtual bool clearToSend() const { return true; }
 };
 } // namespace IO
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDateTime>
+
+#include <IO/HostCache.h>
+
+/**
+ * Time (in milliseconds) after which a cached address is refreshed
+ */
+static const qint64 ADDRESS_TTL = 10 * 60 * 1000;
+
+/**
+ * Returns the normalized form of the given @a host name
+ */
+static QString NORMALIZE(const QString &host)
+{
+  return host.simplified().toLower();
+}
+
+/**
+ * Constructor function
+ */
+IO::HostCache::HostCache()
+{
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::HostCache &IO::HostCache::instance()
+{
+  static HostCache singleton;
+  return singleton;
+}
+
+/**
+ * Returns the cached address of the given @a host, or a null address if the
+ * host was never resolved. If @a host is already an IP address, it is
+ * returned directly. Expired entries are refreshed in the background.
+ */
+QHostAddress IO::HostCache::address(const QString &host)
+{
+  // Host is an IP address
+  const QHostAddress literal(host.simplified());
+  if (!literal.isNull())
+    return literal;
+
+  // Get the cached address
+  QHostAddress address;
+  bool expired = false;
+  {
+    QMutexLocker locker(&m_mutex);
+    const auto entry = m_entries.constFind(NORMALIZE(host));
+    if (entry != m_entries.constEnd())
+    {
+      address = entry->address;
+      const auto now = QDateTime::currentMSecsSinceEpoch();
+      expired = now - entry->resolvedAt >= ADDRESS_TTL;
+    }
+  }
+
+  // Refresh the entry from the main thread
+  if (address.isNull() || expired)
+    QMetaObject::invokeMethod(this, "refresh", Qt::QueuedConnection,
+                              Q_ARG(QString, host));
+
+  return address;
+}
+
+/**
+ * Registers the given @a addresses of the given @a host, IPv4 addresses are
+ * preferred because they are reachable from more networks.
+ */
+void IO::HostCache::insert(const QString &host,
+                           const QList<QHostAddress> &addresses)
+{
+  if (addresses.isEmpty())
+    return;
+
+  Entry entry;
+  entry.address = addresses.first();
+  entry.resolvedAt = QDateTime::currentMSecsSinceEpoch();
+  for (const auto &address : addresses)
+  {
+    if (address.protocol() == QAbstractSocket::IPv4Protocol)
+    {
+      entry.address = address;
+      break;
+    }
+  }
+
+  QMutexLocker locker(&m_mutex);
+  m_entries.insert(NORMALIZE(host), entry);
+}
+
+/**
+ * Starts a background lookup of the given @a host, unless one is already
+ * running for the same host
+ */
+void IO::HostCache::refresh(const QString &host)
+{
+  const auto name = NORMALIZE(host);
+  if (name.isEmpty() || m_lookups.values().contains(name))
+    return;
+
+  const auto id = QHostInfo::lookupHost(name, this,
+                                        SLOT(onLookupFinished(QHostInfo)));
+  m_lookups.insert(id, name);
+}
+
+/**
+ * Updates the cache with the result of a background lookup
+ */
+void IO::HostCache::onLookupFinished(const QHostInfo &info)
+{
+  const auto host = m_lookups.take(info.lookupId());
+  if (info.error() == QHostInfo::NoError && !host.isEmpty())
+    insert(host, info.addresses());
+}
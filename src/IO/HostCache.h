@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QHostInfo>
+#include <QHostAddress>
+
+namespace IO
+{
+/**
+ * @brief The HostCache class
+ *
+ * Caches the addresses of the host names resolved by the network modules, so
+ * that reconnecting to a device or to a broker does not wait for a new DNS
+ * lookup.
+ *
+ * Cached addresses are returned even after they expire, so that a lost link
+ * can be restored immediately, but an expired entry schedules a lookup in the
+ * background & the cache is updated once the lookup succeeds. Failed lookups
+ * never remove cached addresses.
+ *
+ * All the functions are thread-safe, the background lookups are handled by
+ * the main thread.
+ */
+class HostCache : public QObject
+{
+  Q_OBJECT
+
+private:
+  explicit HostCache();
+  HostCache(HostCache &&) = delete;
+  HostCache(const HostCache &) = delete;
+  HostCache &operator=(HostCache &&) = delete;
+  HostCache &operator=(const HostCache &) = delete;
+
+public:
+  static HostCache &instance();
+
+  QHostAddress address(const QString &host);
+  void insert(const QString &host, const QList<QHostAddress> &addresses);
+
+public Q_SLOTS:
+  void refresh(const QString &host);
+
+private Q_SLOTS:
+  void onLookupFinished(const QHostInfo &info);
+
+private:
+  struct Entry
+  {
+    QHostAddress address;
+    qint64 resolvedAt = 0;
+  };
+
+  QMutex m_mutex;
+  QHash<QString, Entry> m_entries;
+  QHash<int, QString> m_lookups;
+};
+} // namespace IO
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <IO/LatencyProbe.h>
+#include <UI/Dashboard.h>
+#include <JSON/Generator.h>
+#include <Misc/Diagnostics.h>
+
+/**
+ * Minimum interval (in milliseconds) between two pings
+ */
+static const int MIN_INTERVAL = 100;
+
+/**
+ * Maximum number of bytes received after a ping that are kept while looking
+ * for its echo
+ */
+static const int MAX_ECHO_BUFFER = 4096;
+
+/**
+ * Constructor function
+ */
+IO::LatencyProbe::LatencyProbe()
+  : m_enabled(false)
+  , m_parsed(false)
+  , m_sentAt(0)
+  , m_arrival(0)
+  , m_sequence(0)
+  , m_sent(0)
+  , m_echoes(0)
+  , m_lost(0)
+{
+  // Configure the timer
+  m_timer.setInterval(1000);
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this, &IO::LatencyProbe::sendPing);
+
+  // Follow the echo through the pipeline, every signal is emitted by the
+  // main thread & the data that contains the echo is always received before
+  // the frames that are extracted from it are parsed
+  connect(&IO::Manager::instance(), &IO::Manager::deviceDataReceived, this,
+          &IO::LatencyProbe::onDataReceived);
+  connect(&JSON::Generator::instance(), &JSON::Generator::framesChanged, this,
+          &IO::LatencyProbe::onFramesChanged);
+  connect(&UI::Dashboard::instance(), &UI::Dashboard::updated, this,
+          &IO::LatencyProbe::onDashboardUpdated);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::LatencyProbe &IO::LatencyProbe::instance()
+{
+  static LatencyProbe singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if pings are being sent to the device
+ */
+bool IO::LatencyProbe::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the interval between two pings in milliseconds
+ */
+int IO::LatencyProbe::interval() const
+{
+  return m_timer.interval();
+}
+
+/**
+ * Returns the number of pings sent to the device
+ */
+quint64 IO::LatencyProbe::sent() const
+{
+  return m_sent;
+}
+
+/**
+ * Returns the number of pings echoed by the device
+ */
+quint64 IO::LatencyProbe::echoes() const
+{
+  return m_echoes;
+}
+
+/**
+ * Returns the number of pings that were not echoed in time
+ */
+quint64 IO::LatencyProbe::lost() const
+{
+  return m_lost;
+}
+
+/**
+ * Resets the ping counters, latency histograms are reset together with the
+ * rest of the diagnostics (see @c Misc::Diagnostics::reset()).
+ */
+void IO::LatencyProbe::clearStatistics()
+{
+  m_sent = 0;
+  m_echoes = 0;
+  m_lost = 0;
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Starts or stops sending pings to the connected device
+ */
+void IO::LatencyProbe::setEnabled(const bool enabled)
+{
+  if (m_enabled == enabled)
+    return;
+
+  m_enabled = enabled;
+  if (enabled)
+    m_timer.start();
+
+  else
+  {
+    m_timer.stop();
+    m_ping.clear();
+    m_received.clear();
+  }
+
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Changes the @a interval (in milliseconds) between two pings, which is also
+ * the time that the device has to echo each ping.
+ */
+void IO::LatencyProbe::setInterval(const int interval)
+{
+  const auto value = qMax(MIN_INTERVAL, interval);
+  if (m_timer.interval() != value)
+  {
+    m_timer.setInterval(value);
+    Q_EMIT intervalChanged();
+  }
+}
+
+/**
+ * Counts the previous ping as lost if it was not echoed & sends a new ping
+ * with the current sequence number & timestamp.
+ */
+void IO::LatencyProbe::sendPing()
+{
+  // Finish the previous ping
+  finishPing();
+
+  // Nothing to send to
+  auto &manager = IO::Manager::instance();
+  if (!manager.connected())
+    return;
+
+  // Build the ping
+  m_sentAt = FrameQueue::timestamp();
+  m_ping = "PING," + QByteArray::number(++m_sequence) + ","
+           + QByteArray::number(m_sentAt);
+
+  // Send the ping
+  if (manager.writeData(m_ping + "\n") <= 0)
+  {
+    m_ping.clear();
+    return;
+  }
+
+  ++m_sent;
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Registers the time in which the dashboard widgets were updated with the
+ * frame that carries the echo of the current ping.
+ */
+void IO::LatencyProbe::onDashboardUpdated()
+{
+  if (m_ping.isEmpty() || !m_parsed)
+    return;
+
+  if (UI::Dashboard::instance().currentFrame().timestamp() >= m_arrival)
+  {
+    const auto latency = FrameQueue::timestamp() - m_sentAt;
+    Misc::Diagnostics::instance().record(
+        Misc::Diagnostics::Stage::ProbeRendering, latency * 1000);
+
+    m_ping.clear();
+  }
+}
+
+/**
+ * Registers the time in which the frame that carries the echo of the current
+ * ping was parsed.
+ */
+void IO::LatencyProbe::onFramesChanged(const QVector<JSON::Frame> &frames)
+{
+  if (m_ping.isEmpty() || m_arrival <= 0 || m_parsed)
+    return;
+
+  for (const auto &frame : frames)
+  {
+    if (frame.timestamp() >= m_arrival)
+    {
+      const auto latency = FrameQueue::timestamp() - m_sentAt;
+      Misc::Diagnostics::instance().record(
+          Misc::Diagnostics::Stage::ProbeParsing, latency * 1000);
+
+      m_parsed = true;
+      break;
+    }
+  }
+}
+
+/**
+ * Looks for the echo of the current ping in the data received from the
+ * device & registers the time in which the driver received it.
+ */
+void IO::LatencyProbe::onDataReceived(const int stream, const QByteArray &data,
+                                      const qint64 timestamp)
+{
+  (void)stream;
+
+  // Nothing to look for
+  if (m_ping.isEmpty() || m_arrival > 0)
+    return;
+
+  // Look for the echo, keeping enough data to find it across two blocks
+  m_received.append(data);
+  if (!m_received.contains(m_ping))
+  {
+    if (m_received.size() > MAX_ECHO_BUFFER)
+      m_received = m_received.right(m_ping.size());
+
+    return;
+  }
+
+  // Register the arrival of the echo
+  m_arrival = qMax(timestamp, m_sentAt);
+  m_received.clear();
+  Misc::Diagnostics::instance().record(Misc::Diagnostics::Stage::ProbeArrival,
+                                       (m_arrival - m_sentAt) * 1000);
+
+  ++m_echoes;
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Counts the current ping as lost if its echo was not received & resets the
+ * state of the probe for the next ping.
+ */
+void IO::LatencyProbe::finishPing()
+{
+  if (!m_ping.isEmpty() && m_arrival <= 0)
+  {
+    ++m_lost;
+    Misc::Diagnostics::instance().increment(
+        Misc::Diagnostics::Counter::ProbesLost);
+    Q_EMIT statisticsChanged();
+  }
+
+  m_arrival = 0;
+  m_parsed = false;
+  m_ping.clear();
+  m_received.clear();
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+
+#include <JSON/Frame.h>
+
+namespace IO
+{
+/**
+ * @brief The LatencyProbe class
+ *
+ * Measures the end-to-end latency between the application & the connected
+ * device. When enabled, a timestamped ping (@c PING,<sequence>,<timestamp>)
+ * is sent periodically with @c IO::Manager::writeData(), and the device is
+ * expected to echo it back inside one of its frames.
+ *
+ * For each echo, three round-trip latencies are measured from the moment in
+ * which the ping was sent & registered in @c Misc::Diagnostics, which builds
+ * the percentile histograms shown in the diagnostics window:
+ *
+ * - @c ProbeArrival: the driver received the data that contains the echo.
+ * - @c ProbeParsing: the frame completed by that data was parsed.
+ * - @c ProbeRendering: the dashboard widgets were updated with that frame.
+ *
+ * Frames are matched with the echo through the reception timestamp that they
+ * carry (see @c FrameQueue::timestamp()), so the device may place the echo in
+ * any field of its frames. Pings that are not echoed before the next one is
+ * sent are counted as lost.
+ */
+class LatencyProbe : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int interval
+               READ interval
+               WRITE setInterval
+               NOTIFY intervalChanged)
+    Q_PROPERTY(quint64 sent
+               READ sent
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(quint64 echoes
+               READ echoes
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(quint64 lost
+               READ lost
+               NOTIFY statisticsChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void intervalChanged();
+  void statisticsChanged();
+
+private:
+  explicit LatencyProbe();
+  LatencyProbe(LatencyProbe &&) = delete;
+  LatencyProbe(const LatencyProbe &) = delete;
+  LatencyProbe &operator=(LatencyProbe &&) = delete;
+  LatencyProbe &operator=(const LatencyProbe &) = delete;
+
+public:
+  static LatencyProbe &instance();
+
+  bool enabled() const;
+  int interval() const;
+  quint64 sent() const;
+  quint64 echoes() const;
+  quint64 lost() const;
+
+public Q_SLOTS:
+  void clearStatistics();
+  void setEnabled(const bool enabled);
+  void setInterval(const int interval);
+
+private Q_SLOTS:
+  void sendPing();
+  void onDashboardUpdated();
+  void onFramesChanged(const QVector<JSON::Frame> &frames);
+  void onDataReceived(const int stream, const QByteArray &data,
+                      const qint64 timestamp);
+
+private:
+  void finishPing();
+
+private:
+  bool m_enabled;
+  bool m_parsed;
+  qint64 m_sentAt;
+  qint64 m_arrival;
+  quint64 m_sequence;
+
+  quint64 m_sent;
+  quint64 m_echoes;
+  quint64 m_lost;
+
+  QTimer m_timer;
+  QByteArray m_ping;
+  QByteArray m_received;
+};
+} // namespace IO
@@ -0,0 +1,526 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <iterator>
+#include <algorithm>
+#include <IO/LineStore.h>
+
+/**
+ * Number of bits of the trigram bitmap of each chunk
+ */
+static const int TRIGRAM_BITS = 64 * 1024;
+
+/**
+ * Returns the bit of the trigram bitmap that corresponds to the given
+ * characters, the characters are case folded so that the bitmap can be used
+ * for both case sensitive & insensitive searches.
+ */
+static quint32 TRIGRAM_HASH(const QChar a, const QChar b, const QChar c)
+{
+  const quint32 x = a.toCaseFolded().unicode();
+  const quint32 y = b.toCaseFolded().unicode();
+  const quint32 z = c.toCaseFolded().unicode();
+  const quint32 h = (x * 0x9e3779b1u) ^ (y * 0x85ebca77u) ^ (z * 0xc2b2ae3du);
+  return (h ^ (h >> 16)) & (TRIGRAM_BITS - 1);
+}
+
+/**
+ * Returns the offset (in @a current) of a match of @a text that starts in the
+ * [@a from, @a to) range of @a current & continues in the @a next chunk, or
+ * -1 if there is no such match. The first match is returned, or the last one
+ * if @a backward is set.
+ */
+static int STRADDLING_MATCH(const QString &current, const QString &next,
+                            const QString &text, const int from, const int to,
+                            const bool backward, const Qt::CaseSensitivity cs)
+{
+  // Only the last characters of the chunk can start a straddling match
+  const int length = text.length();
+  const int begin = qMax(from, static_cast<int>(current.length()) - length + 1);
+  if (begin >= to || next.isEmpty() || length < 2)
+    return -1;
+
+  // Search the end of the chunk together with the start of the next one
+  const auto window = current.mid(begin) + next.left(length - 1);
+  const auto index = backward ? window.lastIndexOf(text, to - begin - 1, cs)
+                              : window.indexOf(text, 0, cs);
+  if (index < 0 || begin + index >= to)
+    return -1;
+
+  return begin + index;
+}
+
+/**
+ * Constructor function, configures the maximum number of lines & characters
+ * that can be stored.
+ */
+IO::LineStore::LineStore(const int maxLines, const qint64 maxSize)
+  : m_size(0)
+  , m_lines(0)
+  , m_evictedLines(0)
+  , m_maxLines(qMax(1, maxLines))
+  , m_maxSize(qMax<qint64>(chunkSize(), maxSize))
+{
+}
+
+/**
+ * Returns the number of characters currently stored
+ */
+qint64 IO::LineStore::size() const
+{
+  return m_size;
+}
+
+/**
+ * Returns the number of bytes allocated by the chunks of the store, including
+ * the line break positions & the trigram bitmaps used to search the text.
+ */
+qint64 IO::LineStore::allocatedBytes() const
+{
+  qint64 bytes = 0;
+  for (const auto &chunk : m_chunks)
+  {
+    bytes += sizeof(Chunk);
+    bytes += qint64(chunk.text.capacity()) * sizeof(QChar);
+    bytes += qint64(chunk.breaks.capacity()) * sizeof(int);
+    bytes += qint64(chunk.trigrams.capacity()) * sizeof(quint64);
+  }
+
+  return bytes;
+}
+
+/**
+ * Returns @c true if no text is stored
+ */
+bool IO::LineStore::isEmpty() const
+{
+  return m_size == 0;
+}
+
+/**
+ * Returns the number of line breaks currently stored
+ */
+qint64 IO::LineStore::lineCount() const
+{
+  return m_lines;
+}
+
+/**
+ * Returns the absolute index of the oldest stored line, which is the number of
+ * lines that have been evicted since the store was last cleared. Views can use
+ * absolute indexes to keep their position while old text is evicted.
+ */
+qint64 IO::LineStore::firstLine() const
+{
+  return m_evictedLines;
+}
+
+/**
+ * Returns the maximum number of lines that are kept
+int IO::LineStore::maxLines() const
+{
+  return m_maxLines;
+}
+
+/**
+ * Returns the maximum number of characters that are kept
+ */
+qint64 IO::LineStore::maxSize() const
+{
+  return m_maxSize;
+}
+
+/**
+ * Returns the maximum number of characters stored in each chunk, which is
+ * also the granularity in which old text is evicted.
+ */
+int IO::LineStore::chunkSize()
+{
+  return 64 * 1024;
+}
+
+/**
+ * Returns a copy of all the stored text
+ */
+QString IO::LineStore::text() const
+{
+  QString text;
+  text.reserve(m_size);
+  Q_FOREACH (const auto &chunk, m_chunks)
+    text.append(chunk.text);
+
+  return text;
+}
+
+/**
+ * Returns the line with the given @a index (relative to the oldest stored
+ * line) without its line break. Valid indexes go from 0 to @c lineCount(), the
+ * last one being the (possibly empty) line that is still being written.
+ */
+QString IO::LineStore::line(const qint64 index) const
+{
+  // Validate arguments
+  if (index < 0 || index > m_lines || m_chunks.isEmpty())
+    return QString();
+
+  // Get the start of the line (just after the previous line break)
+  int firstChunk = 0;
+  int firstOffset = 0;
+  if (index > 0)
+  {
+    breakPosition(index - 1, &firstChunk, &firstOffset);
+    ++firstOffset;
+  }
+
+  // Get the end of the line (its line break or the end of the store)
+  int lastChunk = m_chunks.count() - 1;
+  auto lastOffset = static_cast<int>(m_chunks.last().text.length());
+  if (index < m_lines)
+    breakPosition(index, &lastChunk, &lastOffset);
+
+  // Line is stored in a single chunk
+  const auto &chunk = m_chunks.at(firstChunk);
+  if (firstChunk == lastChunk)
+    return chunk.text.mid(firstOffset, lastOffset - firstOffset);
+
+  // Line spans across several chunks
+  QString line = chunk.text.mid(firstOffset);
+  for (int i = firstChunk + 1; i < lastChunk; ++i)
+    line.append(m_chunks.at(i).text);
+  line.append(m_chunks.at(lastChunk).text.constData(), lastOffset);
+  return line;
+}
+
+/**
+ * Searches for the given @a text, starting at the given absolute @a line &
+ * @a column. If @a backward is set, the last match that starts before the
+ * given position is returned, otherwise the first match that starts at or
+ * after it. On success, @a line & @a column are set to the start of the match
+ * & @c true is returned.
+ *
+ * Chunks that cannot contain the text (according to their trigram bitmap) are
+ * skipped, matches that span two chunks are always checked.
+ */
+bool IO::LineStore::find(const QString &text, qint64 *line, int *column,
+                         const bool backward,
+                         const Qt::CaseSensitivity cs) const
+{
+  Q_ASSERT(line);
+  Q_ASSERT(column);
+
+  // Validate arguments
+  const int length = text.length();
+  if (length <= 0 || m_chunks.isEmpty())
+    return false;
+
+  // Obtain the trigrams of the searched text
+  QVector<quint32> hashes;
+  hashes.reserve(qMax(0, length - 2));
+  for (int i = 0; i + 2 < length; ++i)
+    hashes.append(TRIGRAM_HASH(text.at(i), text.at(i + 1), text.at(i + 2)));
+
+  // Get the position in which the search starts
+  int chunk = 0;
+  int offset = 0;
+  textPosition(*line, *column, &chunk, &offset);
+
+  // Search towards the end of the store
+  int matchChunk = -1;
+  int matchOffset = -1;
+  const int count = m_chunks.count();
+  for (int c = chunk; !backward && c < count && matchChunk < 0; ++c)
+  {
+    const auto &current = m_chunks.at(c);
+    const int from = (c == chunk) ? offset : 0;
+    const auto size = static_cast<int>(current.text.length());
+
+    // Matches inside the chunk
+    if (current.mayContain(hashes))
+      matchOffset = current.text.indexOf(text, from, cs);
+
+    // Matches that continue in the next chunk
+    if (matchOffset < 0 && c + 1 < count)
+      matchOffset = STRADDLING_MATCH(current.text, m_chunks.at(c + 1).text,
+                                     text, from, size, false, cs);
+
+    if (matchOffset >= 0)
+      matchChunk = c;
+  }
+
+  // Search towards the start of the store
+  for (int c = chunk; backward && c >= 0 && matchChunk < 0; --c)
+  {
+    const auto &current = m_chunks.at(c);
+    const auto size = static_cast<int>(current.text.length());
+    const int to = (c == chunk) ? offset : size;
+
+    // Matches that continue in the next chunk
+    if (c + 1 < count)
+      matchOffset = STRADDLING_MATCH(current.text, m_chunks.at(c + 1).text,
+                                     text, 0, to, true, cs);
+
+    // Matches inside the chunk
+    const int from = qMin(to - 1, size - length);
+    if (matchOffset < 0 && from >= 0 && current.mayContain(hashes))
+      matchOffset = current.text.lastIndexOf(text, from, cs);
+
+    if (matchOffset >= 0)
+      matchChunk = c;
+  }
+
+  // Text not found
+  if (matchChunk < 0)
+    return false;
+
+  // Obtain the line & column of the match
+  linePosition(matchChunk, matchOffset, line, column);
+  return true;
+}
+
+/**
+ * Writes the stored text to the given @a device encoded as UTF-8, one chunk
+ * at a time. Returns the number of bytes written, or -1 on error.
+ */
+qint64 IO::LineStore::write(QIODevice *device) const
+{
+  if (!device || !device->isWritable())
+    return -1;
+
+  qint64 bytes = 0;
+  Q_FOREACH (const auto &chunk, m_chunks)
+  {
+    const auto written = device->write(chunk.text.toUtf8());
+    if (written < 0)
+      return -1;
+
+    bytes += written;
+  }
+
+  return bytes;
+}
+
+/**
+ * Deletes all the stored text
+ */
+void IO::LineStore::clear()
+{
+  m_size = 0;
+  m_lines = 0;
+  m_evictedLines = 0;
+  m_chunks.clear();
+}
+
+/**
+ * Appends the given @a text at the end of the store, evicting the oldest
+ * chunks if the line or size limits are exceeded.
+ */
+void IO::LineStore::append(const QString &text)
+{
+  int offset = 0;
+  const int length = text.length();
+  while (offset < length)
+  {
+    // Start a new chunk when the last one is full
+    if (m_chunks.isEmpty() || m_chunks.last().text.length() >= chunkSize())
+    {
+      m_chunks.enqueue(Chunk());
+      m_chunks.last().text.reserve(chunkSize());
+      m_chunks.last().trigrams.fill(0, TRIGRAM_BITS / 64);
+      m_chunks.last().firstBreak = m_evictedLines + m_lines;
+    }
+
+    // Copy as much text as possible into the last chunk
+    auto &chunk = m_chunks.last();
+    const auto base = static_cast<int>(chunk.text.length());
+    const auto span = qMin(length - offset, chunkSize() - base);
+    const auto piece = text.constData() + offset;
+    chunk.text.append(piece, span);
+
+    // Register the position of the copied line breaks
+    const auto previousBreaks = chunk.breaks.count();
+    for (int i = 0; i < span; ++i)
+    {
+      if (piece[i] == QLatin1Char('\n'))
+        chunk.breaks.append(base + i);
+    }
+
+    // Register the trigrams of the copied text
+    chunk.index(base);
+
+    // Update counters
+    m_size += span;
+    m_lines += chunk.breaks.count() - previousBreaks;
+    offset += span;
+  }
+
+  evict();
+}
+
+/**
+ * Changes the maximum number of @a lines that are kept
+ */
+void IO::LineStore::setMaxLines(const int lines)
+{
+  m_maxLines = qMax(1, lines);
+  evict();
+}
+
+/**
+ * Changes the maximum number of @a characters that are kept, the limit can't
+ * be smaller than the size of a single chunk.
+ */
+void IO::LineStore::setMaxSize(const qint64 characters)
+{
+  m_maxSize = qMax<qint64>(chunkSize(), characters);
+  evict();
+}
+
+/**
+ * Removes the oldest chunks until the line & size limits are met, the chunk
+ * that is being written is never removed.
+ */
+void IO::LineStore::evict()
+{
+  while (m_chunks.count() > 1 && (m_lines > m_maxLines || m_size > m_maxSize))
+  {
+    const auto chunk = m_chunks.dequeue();
+    m_size -= chunk.text.length();
+    m_lines -= chunk.breaks.count();
+    m_evictedLines += chunk.breaks.count();
+  }
+}
+
+/**
+ * Obtains the @a chunk & @a offset of the line break with the given @a index
+ * (relative to the oldest stored line break), the index must be valid.
+ */
+void IO::LineStore::breakPosition(const qint64 index, int *chunk,
+                                  int *offset) const
+{
+  // Find the last chunk whose first line break is not after the given one
+  const auto absolute = m_evictedLines + index;
+  auto it = std::upper_bound(
+      m_chunks.cbegin(), m_chunks.cend(), absolute,
+      [](const qint64 value, const Chunk &c) { return value < c.firstBreak; });
+
+  // Obtain the position of the line break inside the chunk
+  *chunk = static_cast<int>(std::distance(m_chunks.cbegin(), it)) - 1;
+  const auto &c = m_chunks.at(*chunk);
+  *offset = c.breaks.at(static_cast<int>(absolute - c.firstBreak));
+}
+
+/**
+ * Obtains the @a chunk & @a offset of the character at the given @a column of
+ * the given absolute @a line, the position is limited to the stored text.
+ */
+void IO::LineStore::textPosition(const qint64 line, const int column,
+                                 int *chunk, int *offset) const
+{
+  // Get the start of the line (just after the previous line break)
+  int c = 0;
+  qint64 position = 0;
+  const auto index = qBound<qint64>(0, line - m_evictedLines, m_lines);
+  if (index > 0)
+  {
+    int breakOffset = 0;
+    breakPosition(index - 1, &c, &breakOffset);
+    position = breakOffset + 1;
+  }
+
+  // Move forward to the given column
+  position += qMax(0, column);
+  while (c < m_chunks.count() - 1 && position >= m_chunks.at(c).text.length())
+  {
+    position -= m_chunks.at(c).text.length();
+    ++c;
+  }
+
+  // Update output values
+  *chunk = c;
+  *offset = static_cast<int>(
+      qMin<qint64>(position, m_chunks.at(c).text.length()));
+}
+
+/**
+ * Obtains the absolute @a line & @a column of the character located at the
+ * given @a offset of the given @a chunk.
+ */
+void IO::LineStore::linePosition(const int chunk, const int offset,
+                                 qint64 *line, int *column) const
+{
+  // Count the line breaks of the chunk that precede the character
+  const auto &c = m_chunks.at(chunk);
+  const auto it = std::lower_bound(c.breaks.cbegin(), c.breaks.cend(), offset);
+  const auto before = std::distance(c.breaks.cbegin(), it);
+  *line = c.firstBreak + before;
+
+  // Line starts in the same chunk
+  if (before > 0)
+  {
+    *column = offset - *(it - 1) - 1;
+    return;
+  }
+
+  // Line starts in a previous chunk
+  *column = offset;
+  for (int i = chunk - 1; i >= 0; --i)
+  {
+    const auto &previous = m_chunks.at(i);
+    if (!previous.breaks.isEmpty())
+    {
+      *column += previous.text.length() - previous.breaks.last() - 1;
+      return;
+    }
+
+    *column += previous.text.length();
+  }
+}
+
+/**
+ * Registers the trigrams that start at or after the given @a from offset,
+ * including the ones that start in the two preceding characters.
+ */
+void IO::LineStore::Chunk::index(const int from)
+{
+  const QChar *data = text.constData();
+  const auto length = static_cast<int>(text.length());
+  for (int i = qMax(0, from - 2); i + 2 < length; ++i)
+  {
+    const auto hash = TRIGRAM_HASH(data[i], data[i + 1], data[i + 2]);
+    trigrams[hash >> 6] |= quint64(1) << (hash & 63);
+  }
+}
+
+/**
+ * Returns @c false if the chunk certainly does not contain a text with the
+ * given trigram @a hashes, @c true if it might.
+ */
+bool IO::LineStore::Chunk::mayContain(const QVector<quint32> &hashes) const
+{
+  Q_FOREACH (const auto hash, hashes)
+  {
+    if (!(trigrams.at(hash >> 6) & (quint64(1) << (hash & 63))))
+      return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QQueue>
+#include <QString>
+#include <QVector>
+#include <QIODevice>
+
+namespace IO
+{
+/**
+ * @brief The LineStore class
+ *
+ * Bounded text storage used by the console to keep the history of the data
+ * that was received from (or sent to) the device.
+ *
+ * Text is stored in a queue of chunks of up to @c chunkSize() characters.
+ * When the number of stored lines exceeds @c maxLines(), or the number of
+ * stored characters exceeds @c maxSize(), the oldest chunks are evicted, so
+ * appending text & enforcing the limits never moves the stored text around.
+ *
+ * Each chunk also keeps the position of its line breaks, so that individual
+ * lines can be obtained with a binary search over the chunks, this allows
+ * views to only read the lines that are actually visible.
+ *
+ * The store can also be searched with @c find(). Every chunk keeps a bitmap
+ * of the (case folded) character trigrams that it contains, which is updated
+ * as text is appended. Chunks whose bitmap does not contain every trigram of
+ * the searched text are skipped without reading their text, so most of the
+ * history is discarded with a few bit tests.
+ */
+class LineStore
+{
+public:
+  explicit LineStore(const int maxLines = 100000,
+                     const qint64 maxSize = 8 * 1024 * 1024);
+
+  qint64 size() const;
+  bool isEmpty() const;
+  qint64 lineCount() const;
+  qint64 firstLine() const;
+  qint64 allocatedBytes() const;
+
+  int maxLines() const;
+  qint64 maxSize() const;
+  static int chunkSize();
+
+  QString text() const;
+  QString line(const qint64 index) const;
+  bool find(const QString &text, qint64 *line, int *column,
+            const bool backward = false,
+            const Qt::CaseSensitivity cs = Qt::CaseInsensitive) const;
+  qint64 write(QIODevice *device) const;
+
+  void clear();
+  void append(const QString &text);
+  void setMaxLines(const int lines);
+  void setMaxSize(const qint64 characters);
+
+private:
+  void evict();
+  void breakPosition(const qint64 index, int *chunk, int *offset) const;
+  void textPosition(const qint64 line, const int column, int *chunk,
+                    int *offset) const;
+  void linePosition(const int chunk, const int offset, qint64 *line,
+                    int *column) const;
+
+private:
+  /**
+   * Block of stored text, position of the line breaks that it contains,
+   * absolute index of its first line break and bitmap of the trigrams that
+   * appear in its text.
+   */
+  struct Chunk
+  {
+    QString text;
+    qint64 firstBreak = 0;
+    QVector<int> breaks;
+    QVector<quint64> trigrams;
+
+    void index(const int from);
+    bool mayContain(const QVector<quint32> &hashes) const;
+  };
+
+  qint64 m_size;
+  qint64 m_lines;
+  qint64 m_evictedLines;
+  int m_maxLines;
+  qint64 m_maxSize;
+  QQueue<Chunk> m_chunks;
+};
+} // namespace IO
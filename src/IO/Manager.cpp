@@ -21,13 +21,29 @@
  * THE SOFTWARE.
  */
 
+#include <climits>
+#include <QDebug>
+
 #include <IO/Manager.h>
 #include <IO/Checksum.h>
+#include <IO/Framers/COBS.h>
+#include <IO/Framers/SLIP.h>
+#include <IO/Framers/LengthPrefix.h>
+#include <IO/Decompressors/LZ4.h>
+#include <IO/Decompressors/Heatshrink.h>
 #include <IO/Drivers/Serial.h>
 #include <IO/Drivers/Network.h>
 #include <IO/Drivers/BluetoothLE.h>
+#include <IO/Drivers/Replay.h>
+#include <IO/Drivers/Stream.h>
+#include <IO/Drivers/CANBus.h>
+#include <IO/Drivers/Modbus.h>
+#include <IO/Drivers/USB.h>
+#include <IO/Drivers/Audio.h>
 
 #include <MQTT/Client.h>
+#include <Misc/Utilities.h>
+#include <Misc/ThreadScheduler.h>
 
 /**
  * Adds support for C escape sequences to the given @a str.
@@ -50,22 +66,129 @@ static QString ADD_ESCAPE_SEQUENCES(const QString &str)
   return escapedStr;
 }
 
+/**
+ * Creates the binary framer that implements the given framing @a mode, returns
+ * @c Q_NULLPTR if frames are detected with the start/finish sequences.
+ */
+static IO::Framer *CREATE_FRAMER(const IO::Manager::FramingMode mode)
+{
+  switch (mode)
+  {
+    case IO::Manager::FramingMode::LengthPrefix8:
+      return new IO::Framers::LengthPrefix(1);
+    case IO::Manager::FramingMode::LengthPrefix16BE:
+      return new IO::Framers::LengthPrefix(2, true);
+    case IO::Manager::FramingMode::LengthPrefix16LE:
+      return new IO::Framers::LengthPrefix(2, false);
+    case IO::Manager::FramingMode::LengthPrefix32BE:
+      return new IO::Framers::LengthPrefix(4, true);
+    case IO::Manager::FramingMode::LengthPrefix32LE:
+      return new IO::Framers::LengthPrefix(4, false);
+    case IO::Manager::FramingMode::COBS:
+      return new IO::Framers::COBS();
+    case IO::Manager::FramingMode::SLIP:
+      return new IO::Framers::SLIP();
+    default:
+      return Q_NULLPTR;
+  }
+}
+
+/**
+ * Creates the decompressor that implements the given compression @a mode,
+ * returns @c Q_NULLPTR if the device does not compress its data.
+ */
+static IO::Decompressor *CREATE_DECOMPRESSOR(
+    const IO::Manager::Compression mode, const int windowBits,
+    const int lookaheadBits)
+{
+  switch (mode)
+  {
+    case IO::Manager::Compression::LZ4Blocks16LE:
+      return new IO::Decompressors::LZ4(2);
+    case IO::Manager::Compression::LZ4Blocks32LE:
+      return new IO::Decompressors::LZ4(4);
+    case IO::Manager::Compression::Heatshrink:
+      return new IO::Decompressors::Heatshrink(windowBits, lookaheadBits, 0);
+    case IO::Manager::Compression::HeatshrinkBlocks16LE:
+      return new IO::Decompressors::Heatshrink(windowBits, lookaheadBits, 2);
+    case IO::Manager::Compression::HeatshrinkBlocks32LE:
+      return new IO::Decompressors::Heatshrink(windowBits, lookaheadBits, 4);
+    default:
+      return Q_NULLPTR;
+  }
+}
+
 /**
  * Constructor function
  */
 IO::Manager::Manager()
-  : m_enableCrc(false)
-  , m_writeEnabled(true)
+  : m_writeEnabled(true)
+  , m_autoReconnect(false)
+  , m_threadedFrameExtraction(false)
+  , m_realtimeIoThread(false)
+  , m_ioThreadCpu(-1)
   , m_maxBufferSize(1024 * 1024)
   , m_driver(Q_NULLPTR)
+  , m_framingMode(FramingMode::Delimiters)
+  , m_compression(Compression::None)
+  , m_heatshrinkWindowBits(8)
+  , m_heatshrinkLookaheadBits(4)
+  , m_checksumAlgorithm(ChecksumAlgorithm::None)
+  , m_checksumPlacement(ChecksumPlacement::BeforeFinish)
+  , m_checksumEncoding(ChecksumEncoding::Raw)
   , m_receivedBytes(0)
   , m_startSequence("/*")
   , m_finishSequence("*/")
   , m_separatorSequence(",")
+  , m_selectedDriver(SelectedDriver::Serial)
+  , m_frameReader(Q_NULLPTR)
+  , m_pendingTimestamp(0)
+  , m_nextDeviceId(1)
 {
+  // Create frame reader & forward the frames that it extracts
+  m_frameReader = new FrameReader(&m_frameQueue);
+  connect(m_frameReader, &IO::FrameReader::frameReady, this,
+          &IO::Manager::frameReceived);
+  connect(m_frameReader, &IO::FrameReader::framesAvailable, this,
+          &IO::Manager::onFramesAvailable);
+
+  // Coalesce the notifications of data delivered in batches
+  m_notificationTimer.setSingleShot(true);
+  m_notificationTimer.setInterval(IO_NOTIFICATION_INTERVAL);
+  connect(&m_notificationTimer, &QTimer::timeout, this,
+          &IO::Manager::flushNotifications);
+
+  // Configure the outgoing queue & show the written data in the console
+  m_writeQueue.setMaxInFlight(
+      m_settings.value("IO_Manager_WriteMaxInFlight", 16 * 1024).toInt());
+  m_writeQueue.setPacingRate(
+      m_settings.value("IO_Manager_WritePacingRate", 0).toInt());
+  m_writeQueue.setSoftwareFlowControl(
+      m_settings.value("IO_Manager_WriteXonXoff", false).toBool());
+  connect(&m_writeQueue, &IO::WriteQueue::dataWritten, this,
+          &IO::Manager::dataSent);
+
+  // Restore lost connections automatically
+  m_autoReconnect
+      = m_settings.value("IO_Manager_AutoReconnect", false).toBool();
+  connect(&m_reconnect, &IO::ReconnectManager::reconnectRequested, this,
+          &IO::Manager::reconnect);
+  connect(&m_reconnect, &IO::ReconnectManager::activeChanged, this,
+          &IO::Manager::reconnectingChanged);
+
+  // Configure the scheduling of the frame extraction thread, the context
+  // object is used to run code in that thread
+  m_realtimeIoThread
+      = m_settings.value("IO_Manager_RealtimeIoThread", false).toBool();
+  m_ioThreadCpu = m_settings.value("IO_Manager_IoThreadCpu", -1).toInt();
+  m_workerContext.moveToThread(&m_workerThread);
+
   // Set initial settings
   setMaxBufferSize(1024 * 1024);
   setSelectedDriver(SelectedDriver::Serial);
+  setThreadedFrameExtraction(
+      m_settings.value("IO_Manager_ThreadedFrameExtraction", false).toBool());
+  readDevices();
 
   // clang-format off
 
@@ -76,6 +199,30 @@ IO::Manager::Manager()
   // clang-format on
 }
 
+/**
+ * Destructor function, closes the additional devices & stops the frame
+ * extraction thread
+ */
+IO::Manager::~Manager()
+{
+  Q_FOREACH (auto device, m_devices)
+  {
+    disconnect(device, Q_NULLPTR, this, Q_NULLPTR);
+    delete device;
+  }
+
+  Q_FOREACH (const auto &stream, m_streams)
+    stream.reader->deleteLater();
+
+  // Close the driver before stopping the worker thread, which may read it
+  if (m_threadedFrameExtraction && deviceAvailable())
+    driver()->close();
+
+  m_workerThread.quit();
+  m_workerThread.wait();
+  delete m_frameReader;
+}
+
 /**
  * Returns the only instance of the class
  */
@@ -133,6 +280,34 @@ bool IO::Manager::configurationOk()
   return false;
 }
 
+/**
+ * Returns @c true while the connection is lost & being restored
+ * automatically, check the @c autoReconnect() function for more information.
+ */
+bool IO::Manager::reconnecting() const
+{
+  return m_reconnect.active();
+}
+
+/**
+ * Returns @c true if lost connections are restored automatically. The
+ * connection is only restored if it was established before, i.e. a device
+ * that cannot be opened by the user is not retried.
+ */
+bool IO::Manager::autoReconnect() const
+{
+  return m_autoReconnect;
+}
+
+/**
+ * Returns the number of additional devices, the selected driver is not
+ * included in the count.
+ */
+int IO::Manager::deviceCount() const
+{
+  return m_devices.count();
+}
+
 /**
  * Returns the maximum size of the buffer. This is useful to avoid consuming to
  * much memory when a large block of invalid data is received (for example, when
@@ -144,521 +319,1433 @@ int IO::Manager::maxBufferSize() const
 }
 
 /**
- * Returns a pointer to the currently selected driver.
- *
- * @warning you need to check this pointer before using it, it can have a @c
- * Q_NULLPTR value during normal operations.
+ * Returns @c true if frames are extracted from the incoming data stream in a
+ * dedicated worker thread instead of the main (GUI) thread.
  */
-IO::HAL_Driver *IO::Manager::driver()
+bool IO::Manager::threadedFrameExtraction() const
 {
-  return m_driver;
+  return m_threadedFrameExtraction;
 }
 
 /**
- * Returns the currently selected data source, possible return values:
- * - @c DataSource::Serial  use a serial port as a data source
- * - @c DataSource::Network use a network port as a data source
+ * Returns @c true if the frame extraction thread is scheduled with a
+ * real-time priority by the operating system.
  */
-IO::Manager::SelectedDriver IO::Manager::selectedDriver() const
+bool IO::Manager::realtimeIoThread() const
 {
-  return m_selectedDriver;
+  return m_realtimeIoThread;
 }
 
 /**
- * Returns the start sequence string used by the application to know where to
- * consider that a frame begins. If the start sequence is empty, then the
- * application shall ignore incoming data. The only thing that wont ignore the
- * incoming data will be the console.
+ * Returns the index of the CPU core to which the frame extraction thread is
+ * pinned, or -1 if it can run on any core.
  */
-QString IO::Manager::startSequence() const
+int IO::Manager::ioThreadCpu() const
 {
-  return m_startSequence;
+  return m_ioThreadCpu;
 }
 
 /**
- * Returns the finish sequence string used by the application to know where to
- * consider that a frame ends. If the start sequence is empty, then the
- * application shall ignore incoming data. The only thing that wont ignore the
- * incoming data will be the console.
+ * Returns the maximum number of bytes that can be written to the driver
+ * without being transmitted yet, 0 means no limit.
  */
-QString IO::Manager::finishSequence() const
+int IO::Manager::writeMaxInFlight() const
 {
-  return m_finishSequence;
+  return m_writeQueue.maxInFlight();
 }
 
 /**
- * Returns the separator sequence string used by the application to know where
- * to consider that a data item ends.
+ * Returns the maximum rate (in bytes per second) at which data is written to
+ * the device, 0 means no limit.
  */
-QString IO::Manager::separatorSequence() const
+int IO::Manager::writePacingRate() const
 {
-  return m_separatorSequence;
+  return m_writeQueue.pacingRate();
 }
 
 /**
- * Returns a list with the possible data source options.
+ * Returns @c true if the XON/XOFF characters sent by the device pause &
+ * resume the transmission of queued data.
  */
-StringList IO::Manager::availableDrivers() const
+bool IO::Manager::writeXonXoff() const
 {
-  StringList list;
-  list.append(tr("Serial port"));
-  list.append(tr("Network port"));
-  list.append(tr("Bluetooth LE device"));
-  return list;
+  return m_writeQueue.softwareFlowControl();
 }
 
 /**
- * Tries to write the given @a data to the current device.
- *
- * @returns the number of bytes written to the target device
+ * Returns the outgoing queue, used to report its state in the diagnostics
  */
-qint64 IO::Manager::writeData(const QByteArray &data)
+const IO::WriteQueue &IO::Manager::writeQueue() const
 {
-  if (connected())
-  {
-    // Write data to device
-    auto bytes = driver()->write(data);
-
-    // Show sent data in console
-    if (bytes > 0)
-    {
-      auto writtenData = data;
-      writtenData.chop(data.length() - bytes);
-      Q_EMIT dataSent(writtenData);
-    }
+  return m_writeQueue;
+}
 
-    // Return number of bytes written
-    return bytes;
+/**
+ * Returns a list with the configuration & state of each additional device,
+ * used by the user interface to display the device list.
+ */
+QVariantList IO::Manager::devices() const
+{
+  QVariantList list;
+  Q_FOREACH (auto device, m_devices)
+  {
+    QVariantMap map;
+    map.insert("id", device->id());
+    map.insert("tag", device->tag());
+    map.insert("portName", device->portName());
+    map.insert("baudRate", device->baudRate());
+    map.insert("fieldOffset", device->fieldOffset());
+    map.insert("connected", device->isOpen());
+    list.append(map);
   }
 
-  return -1;
+  return list;
 }
 
 /**
- * Connects/disconnects the application from the currently selected device. This
- * function is used as a convenience for the connect/disconnect button.
+ * Returns the user-defined name of the given @a device
  */
-void IO::Manager::toggleConnection()
+QString IO::Manager::deviceTag(const int device) const
 {
-  if (connected())
-    disconnectDriver();
-  else
-    connectDevice();
+  Q_FOREACH (auto d, m_devices)
+  {
+    if (d->id() == device)
+      return d->tag();
+  }
+
+  if (m_streams.contains(device))
+    return m_streams.value(device).tag;
+
+  return tr("Primary device");
 }
 
 /**
- * Closes the currently selected device and tries to open & configure a new
- * connection. A data source must be selected before calling this function.
+ * Returns the identifier of the device that feeds the given project @a field,
+ * which is the device with the largest field offset that does not exceed the
+ * field index (see @c deviceFieldRange()).
  */
-void IO::Manager::connectDevice()
+int IO::Manager::fieldDevice(const int field) const
 {
-  // Reset driver
-  setSelectedDriver(selectedDriver());
-
-  // Configure current device
-  if (deviceAvailable())
+  int device = 0;
+  int offset = 0;
+  Q_FOREACH (auto d, m_devices)
   {
-    // Set open flag
-    QIODevice::OpenMode mode = QIODevice::ReadOnly;
-    if (m_writeEnabled)
-      mode = QIODevice::ReadWrite;
-
-    // Open device
-    if (driver()->open(mode))
+    if (d->fieldOffset() <= field && d->fieldOffset() > offset)
     {
-      connect(driver(), &IO::HAL_Driver::dataReceived, this,
-              &IO::Manager::onDataReceived);
+      device = d->id();
+      offset = d->fieldOffset();
     }
-
-    // Error opening the device
-    else
-      disconnectDriver();
-
-    // Update UI
-    Q_EMIT connectedChanged();
   }
+
+  return device;
 }
 
 /**
- * Disconnects from the current device and clears temp. data
+ * Obtains the range of field indexes of the project that are fed by the
+ * given @a device. The range starts at the field offset of the device and
+ * ends where the next device (sorted by field offset) starts, or extends to
+ * the last field if there is no such device.
+ *
+ * The selected driver always starts at the first field, so when no additional
+ * devices are configured, it feeds all the datasets of the project.
  */
-void IO::Manager::disconnectDriver()
+void IO::Manager::deviceFieldRange(const int device, int *begin,
+                                   int *end) const
 {
-  if (deviceAvailable())
-  {
-    // Disconnect device signals/slots
-    disconnect(driver(), &IO::HAL_Driver::dataReceived, this,
-               &IO::Manager::onDataReceived);
-    disconnect(driver(), &IO::HAL_Driver::configurationChanged, this,
-               &IO::Manager::configurationChanged);
+  Q_ASSERT(begin);
+  Q_ASSERT(end);
 
-    // Close driver device
-    driver()->close();
-
-    // Update device pointer
-    m_driver = Q_NULLPTR;
-    m_receivedBytes = 0;
-    m_dataBuffer.clear();
-    m_dataBuffer.reserve(maxBufferSize());
-
-    // Update UI
-    Q_EMIT driverChanged();
-    Q_EMIT connectedChanged();
+  // Get offset of the device
+  *begin = 0;
+  Q_FOREACH (auto d, m_devices)
+  {
+    if (d->id() == device)
+    {
+      *begin = d->fieldOffset();
+      break;
+    }
   }
 
-  // Disable CRC checking
-  m_enableCrc = false;
+  // Find the next device
+  *end = INT_MAX;
+  Q_FOREACH (auto d, m_devices)
+  {
+    if (d->fieldOffset() > *begin && d->fieldOffset() < *end)
+      *end = d->fieldOffset();
+  }
 }
 
 /**
- * Enables/disables RW mode
+ * Returns a pointer to the currently selected driver.
+ *
+ * @warning you need to check this pointer before using it, it can have a @c
+ * Q_NULLPTR value during normal operations.
  */
-void IO::Manager::setWriteEnabled(const bool enabled)
+IO::HAL_Driver *IO::Manager::driver()
 {
-  m_writeEnabled = enabled;
-  Q_EMIT writeEnabledChanged();
+  return m_driver;
 }
 
 /**
- * Reads the given payload and emits it as if it were received from a device.
- * This function is for convenience to interact with other application modules &
- * plugins.
+ * Returns the worker thread of the I/O module, or @c nullptr if threaded frame
+ * extraction is disabled. Drivers that support it move their device to this
+ * thread when they are opened, so that the device is read without waiting for
+ * the user interface.
  */
-void IO::Manager::processPayload(const QByteArray &payload)
+QThread *IO::Manager::workerThread()
 {
-  if (!payload.isEmpty())
-  {
-    // Update received bytes indicator
-    m_receivedBytes += payload.size();
-    if (m_receivedBytes >= UINT64_MAX)
-      m_receivedBytes = 0;
+  if (m_threadedFrameExtraction)
+    return &m_workerThread;
 
-    // Notify user interface & application modules
-    Q_EMIT dataReceived(payload);
-    Q_EMIT frameReceived(payload);
-    Q_EMIT receivedBytesChanged();
-  }
+  return Q_NULLPTR;
 }
 
 /**
- * Changes the maximum permited buffer size. Check the @c maxBufferSize()
- * function for more information.
+ * Returns the queue through which extracted frames are distributed to the
+ * application modules. Each module registers itself as a consumer of the
+ * queue, the per-consumer lag & dropped frame counters can be used for
+ * diagnostics.
  */
-void IO::Manager::setMaxBufferSize(const int maxBufferSize)
+IO::FrameQueue &IO::Manager::frameQueue()
 {
-  m_maxBufferSize = maxBufferSize;
-  Q_EMIT maxBufferSizeChanged();
-
-  m_dataBuffer.reserve(maxBufferSize);
+  return m_frameQueue;
 }
 
 /**
- * Changes the frame start sequence. Check the @c startSequence() function for
- * more information.
+ * Returns the method used to detect frames in the incoming data stream:
+ * - @c FramingMode::Delimiters frames are delimited by start/finish sequences
+ * - @c FramingMode::LengthPrefix* frames are preceded by their length
+ * - @c FramingMode::COBS frames are COBS-encoded & terminated by a zero byte
+ * - @c FramingMode::SLIP frames are SLIP-encoded & terminated by an END byte
  */
-void IO::Manager::setStartSequence(const QString &sequence)
+IO::Manager::FramingMode IO::Manager::framingMode() const
 {
-  m_startSequence = ADD_ESCAPE_SEQUENCES(sequence);
-  if (m_startSequence.isEmpty())
-    m_startSequence = "/*";
-
-  Q_EMIT startSequenceChanged();
+  return m_framingMode;
 }
 
 /**
- * Changes the frame end sequence. Check the @c finishSequence() function for
- * more information.
+ * Returns the compression applied by the device to its data, which is
+ * decompressed before frames are detected:
+ * - @c Compression::None data is not compressed
+ * - @c Compression::LZ4Blocks* LZ4 blocks preceded by their length
+ * - @c Compression::Heatshrink continuous heatshrink stream
+ * - @c Compression::HeatshrinkBlocks* heatshrink blocks preceded by their
+ *   length
  */
-void IO::Manager::setFinishSequence(const QString &sequence)
+IO::Manager::Compression IO::Manager::compression() const
 {
-  m_finishSequence = ADD_ESCAPE_SEQUENCES(sequence);
-  if (m_finishSequence.isEmpty())
-    m_finishSequence = "*/";
-
-  Q_EMIT finishSequenceChanged();
+  return m_compression;
 }
 
 /**
- * Changes the frame separator sequence. Check the @c separatorSequence()
- * function for more information.
+ * Returns the size (in bits) of the heatshrink back-reference window.
  */
-void IO::Manager::setSeparatorSequence(const QString &sequence)
+int IO::Manager::heatshrinkWindowBits() const
 {
-  m_separatorSequence = ADD_ESCAPE_SEQUENCES(sequence);
-  if (m_separatorSequence.isEmpty())
-    m_separatorSequence = ",";
-
-  Q_EMIT separatorSequenceChanged();
+  return m_heatshrinkWindowBits;
 }
 
 /**
- * Changes the data source type. Check the @c dataSource() funciton for more
- * information.
+ * Returns the size (in bits) of the heatshrink lookahead buffer.
  */
-void IO::Manager::setSelectedDriver(const IO::Manager::SelectedDriver &driver)
+int IO::Manager::heatshrinkLookaheadBits() const
 {
-  // Disconnect current driver
-  disconnectDriver();
-
-  // Change data source
-  m_selectedDriver = driver;
-
-  // Disconnect previous device (if any)
-  disconnectDriver();
-
-  // Try to open a serial port connection
-  if (selectedDriver() == SelectedDriver::Serial)
-    setDriver(&(Drivers::Serial::instance()));
-
-  // Try to open a network connection
-  else if (selectedDriver() == SelectedDriver::Network)
-    setDriver(&(Drivers::Network::instance()));
-
-  // Try to open a BLE connection
-  else if (selectedDriver() == SelectedDriver::BluetoothLE)
-    setDriver(&(Drivers::BluetoothLE::instance()));
-
-  // Invalid driver
-  else
-    setDriver(Q_NULLPTR);
-
-  // Update UI
-  Q_EMIT selectedDriverChanged();
+  return m_heatshrinkLookaheadBits;
 }
 
 /**
- * Read frames from temporary buffer, every frame that contains the appropiate
- * start/end sequence is removed from the buffer as soon as its read.
- *
- * This function also checks that the buffer size does not exceed specified size
- * limitations.
- *
- * Implemementation credits: @jpnorair and @alex-spataru
+ * Returns the checksum algorithm used to verify the integrity of each frame.
+ * If set to @c ChecksumAlgorithm::None, the checksum type is automatically
+ * detected from the "crc8:", "crc16:" or "crc32:" headers that may follow the
+ * finish sequence.
  */
-void IO::Manager::readFrames()
+IO::ChecksumAlgorithm IO::Manager::checksumAlgorithm() const
 {
-  // No device connected, abort
-  if (!connected())
-    return;
-
-  // Read until start/finish combinations are not found
-  auto bytes = 0;
-  auto prevBytes = 0;
-  auto cursor = m_dataBuffer;
-  auto start = startSequence().toUtf8();
-  auto finish = finishSequence().toUtf8();
-  while (cursor.contains(start) && cursor.contains(finish))
-  {
-    // Remove the part of the buffer prior to, and including, the start
-    // sequence.
-    auto sIndex = cursor.indexOf(start);
-    cursor = cursor.mid(sIndex + start.length(), -1);
-    bytes += sIndex + start.length();
-
-    // Copy a sub-buffer that goes until the finish sequence
-    auto fIndex = cursor.indexOf(finish);
-    auto frame = cursor.left(fIndex);
-
-    // Parse frame
-    if (!frame.isEmpty())
-    {
-      // Checksum verification & Q_EMIT RX frame
-      int chop = 0;
-      auto result = integrityChecks(frame, cursor, &chop);
-      if (result == ValidationStatus::FrameOk)
-        Q_EMIT frameReceived(frame);
-
-      // Checksum data incomplete, try next time...
-      else if (result == ValidationStatus::ChecksumIncomplete)
-      {
-        bytes = prevBytes;
-        break;
-      }
-
-      // Remove the data including the finish sequence from the master buffer
-      cursor = cursor.mid(fIndex + chop, -1);
-      bytes += fIndex + chop;
-
-      // Frame read successfully, save the number of bytes to chop.
-      // This is used to manage frames with incomplete checksums
-      prevBytes = bytes;
-    }
-
-    // Frame empty, wait for more data...
-    else
-      bytes = prevBytes;
-  }
-
-  // Remove parsed data from master buffer
-  m_dataBuffer.remove(0, bytes);
-
-  // Clear temp. buffer (e.g. device sends a lot of invalid data)
-  if (m_dataBuffer.size() > maxBufferSize())
-    clearTempBuffer();
+  return m_checksumAlgorithm;
 }
 
 /**
- * Deletes the contents of the temporary buffer. This function is called
- * automatically by the class when the temporary buffer size exceeds the limit
- * imposed by the
- * @c maxBufferSize() function.
+ * Returns the location of the checksum relative to the finish sequence
  */
-void IO::Manager::clearTempBuffer()
+IO::ChecksumPlacement IO::Manager::checksumPlacement() const
 {
-  m_dataBuffer.clear();
+  return m_checksumPlacement;
 }
 
 /**
- * Changes the target device pointer. Deletion should be handled by the
- * interface implementation, not by this class.
+ * Returns the encoding used to transmit the checksum (raw bytes or ASCII
+ * hexadecimal digits).
  */
-void IO::Manager::setDriver(HAL_Driver *driver)
+IO::ChecksumEncoding IO::Manager::checksumEncoding() const
 {
-  if (driver)
-    connect(driver, &IO::HAL_Driver::configurationChanged, this,
-            &IO::Manager::configurationChanged);
+  return m_checksumEncoding;
+}
 
-  m_driver = driver;
+/**
+ * Returns the currently selected data source, possible return values:
+ * - @c DataSource::Serial  use a serial port as a data source
+ * - @c DataSource::Network use a network port as a data source
+ */
+IO::Manager::SelectedDriver IO::Manager::selectedDriver() const
+{
+  return m_selectedDriver;
+}
 
-  Q_EMIT driverChanged();
-  Q_EMIT configurationChanged();
+/**
+ * Returns the start sequence string used by the application to know where to
+ * consider that a frame begins. If the start sequence is empty, then the
+ * application shall ignore incoming data. The only thing that wont ignore the
+ * incoming data will be the console.
+ */
+QString IO::Manager::startSequence() const
+{
+  return m_startSequence;
 }
 
 /**
- * Reads incoming data from the I/O device, updates the console object,
- * registers incoming data to temporary buffer & extracts valid data frames from
- * the buffer using the @c readFrame() function.
+ * Returns the finish sequence string used by the application to know where to
+ * consider that a frame ends. If the start sequence is empty, then the
+ * application shall ignore incoming data. The only thing that wont ignore the
+ * incoming data will be the console.
  */
-void IO::Manager::onDataReceived(const QByteArray &data)
+QString IO::Manager::finishSequence() const
 {
-  // Verify that device is still valid
-  if (!driver())
-    disconnectDriver();
+  return m_finishSequence;
+}
 
-  // Read data & append it to buffer
-  auto bytes = data.length();
+/**
+ * Returns the separator sequence string used by the application to know where
+ * to consider that a data item ends.
+ */
+QString IO::Manager::separatorSequence() const
+{
+  return m_separatorSequence;
+}
+
+/**
+ * Returns a list with the possible data source options.
+ */
+StringList IO::Manager::availableDrivers() const
+{
+  StringList list;
+  list.append(tr("Serial port"));
+  list.append(tr("Network port"));
+  list.append(tr("Bluetooth LE device"));
+  list.append(tr("Raw capture replay"));
+  list.append(tr("File, pipe or standard input"));
+  list.append(tr("CAN bus"));
+  list.append(tr("Modbus RTU/TCP"));
+  list.append(tr("USB bulk device"));
+  list.append(tr("Audio input"));
+  return list;
+}
+
+/**
+ * Returns a list with the available frame detection methods, the order of the
+ * list matches the @c FramingMode enum.
+ */
+StringList IO::Manager::availableFramingModes() const
+{
+  StringList list;
+  list.append(tr("Start/end delimiters"));
+  list.append(tr("Length prefix (8-bit)"));
+  list.append(tr("Length prefix (16-bit, big endian)"));
+  list.append(tr("Length prefix (16-bit, little endian)"));
+  list.append(tr("Length prefix (32-bit, big endian)"));
+  list.append(tr("Length prefix (32-bit, little endian)"));
+  list.append(tr("COBS"));
+  list.append(tr("SLIP"));
+  return list;
+}
+
+/**
+ * Returns a list with the available compression modes, the order of the list
+ * matches the @c Compression enum.
+ */
+StringList IO::Manager::availableCompressionModes() const
+{
+  StringList list;
+  list.append(tr("None"));
+  list.append(tr("LZ4 blocks (16-bit length, little endian)"));
+  list.append(tr("LZ4 blocks (32-bit length, little endian)"));
+  list.append(tr("Heatshrink stream"));
+  list.append(tr("Heatshrink blocks (16-bit length, little endian)"));
+  list.append(tr("Heatshrink blocks (32-bit length, little endian)"));
+  return list;
+}
+
+/**
+ * Returns a list with the available checksum algorithms, the order of the list
+ * matches the @c IO::ChecksumAlgorithm enum.
+ */
+StringList IO::Manager::availableChecksumAlgorithms() const
+{
+  StringList list;
+  list.append(tr("Automatic (crc8/crc16/crc32 header)"));
+  list.append(tr("CRC-8"));
+  list.append(tr("CRC-16/CCITT-FALSE"));
+  list.append(tr("CRC-16/MODBUS"));
+  list.append(tr("CRC-16/CCITT (Kermit)"));
+  list.append(tr("CRC-32"));
+  list.append(tr("CRC-32C (Castagnoli)"));
+  list.append(tr("Fletcher-16"));
+  list.append(tr("XOR-8"));
+  return list;
+}
+
+/**
+ * Returns a list with the available checksum placements, the order of the list
+ * matches the @c IO::ChecksumPlacement enum.
+ */
+StringList IO::Manager::availableChecksumPlacements() const
+{
+  StringList list;
+  list.append(tr("Before finish sequence"));
+  list.append(tr("After finish sequence"));
+  return list;
+}
+
+/**
+ * Returns a list with the available checksum encodings, the order of the list
+ * matches the @c IO::ChecksumEncoding enum.
+ */
+StringList IO::Manager::availableChecksumEncodings() const
+{
+  StringList list;
+  list.append(tr("Raw bytes"));
+  list.append(tr("ASCII hexadecimal"));
+  return list;
+}
+
+/**
+ * Appends the given @a data to the outgoing queue of the current device, the
+ * data is written asynchronously (see @c WriteQueue) & the @c dataSent()
+ * signal is emitted as each chunk is written.
+ *
+ * @returns the number of queued bytes, or -1 if the device is not connected
+ *          or the queue is full.
+ */
+qint64 IO::Manager::writeData(const QByteArray &data)
+{
+  if (connected())
+    return m_writeQueue.enqueue(data);
+
+  return -1;
+}
+
+/**
+ * Registers a new device that reads data from the serial port with the given
+ * @a portName & @a baudRate. Its frames feed the datasets of the project
+ * starting at the given @a fieldOffset, the @a tag is used to identify the
+ * device in the user interface.
+ *
+ * If the selected driver is connected, the new device is opened immediately.
+ *
+ * @returns the identifier of the device, which is used to tag its frames.
+ */
+int IO::Manager::addDevice(const QString &portName, const qint32 baudRate,
+                           const QString &tag, const int fieldOffset)
+{
+  // Create device & its frame pipeline
+  const int id = m_nextDeviceId++;
+  auto device = new Device(id, createFrameReader(id), this);
+  device->setTag(tag.isEmpty() ? portName : tag);
+  device->setPortName(portName);
+  device->setBaudRate(baudRate);
+  device->setFieldOffset(fieldOffset);
+  m_devices.append(device);
+
+  // Forward received data to the rest of the application
+  connect(device, &IO::Device::connectedChanged, this,
+          &IO::Manager::devicesChanged);
+  connect(device, &IO::Device::dataReceived, this,
+          [=](const QByteArray &data, const qint64 timestamp) {
+            m_receivedBytes += data.size();
+            if (m_receivedBytes >= UINT64_MAX)
+              m_receivedBytes = 0;
+
+            Q_EMIT receivedBytesChanged();
+            Q_EMIT deviceDataReceived(id, data, timestamp);
+          });
+
+  // Open the device if the selected driver is already connected
+  if (driver() && driver()->isOpen())
+  {
+    QIODevice::OpenMode mode = QIODevice::ReadOnly;
+    if (m_writeEnabled)
+      mode = QIODevice::ReadWrite;
+
+    device->open(mode);
+  }
+
+  // Save changes & update UI
+  writeDevices();
+  Q_EMIT devicesChanged();
+  return id;
+}
+
+/**
+ * Closes & removes the additional device with the given identifier
+ */
+void IO::Manager::removeDevice(const int device)
+{
+  for (int i = 0; i < m_devices.count(); ++i)
+  {
+    auto d = m_devices.at(i);
+    if (d->id() == device)
+    {
+      m_devices.removeAt(i);
+      disconnect(d, Q_NULLPTR, this, Q_NULLPTR);
+      delete d;
+
+      writeDevices();
+      Q_EMIT devicesChanged();
+      return;
+    }
+  }
+}
+
+/**
+ * Creates a frame pipeline for a data stream of the selected driver (e.g. a
+ * client connected to the TCP server), identified in the user interface with
+ * the given @a tag.
+ *
+ * @returns the identifier of the stream, which is used to tag its frames.
+ */
+int IO::Manager::openStream(const QString &tag)
+{
+  const int id = m_nextDeviceId++;
+  m_streams.insert(id, Stream{tag, createFrameReader(id)});
+  return id;
+}
 
-  // Obtain frames from data buffer
-  m_dataBuffer.append(data);
-  readFrames();
+/**
+ * Deletes the frame pipeline of the given @a stream, partial frames buffered
+ * by its frame reader are discarded.
+ */
+void IO::Manager::closeStream(const int stream)
+{
+  if (m_streams.contains(stream))
+    m_streams.take(stream).reader->deleteLater();
+}
+
+/**
+ * Hands the given @a data, received from the given @a stream at the given
+ * @a timestamp, to the frame reader of the stream (in the frame extraction
+ * thread if enabled). If no @a timestamp is given, the current time is used.
+ */
+void IO::Manager::processStreamData(const int stream, const QByteArray &data,
+                                    const qint64 timestamp)
+{
+  // Validate arguments
+  if (data.isEmpty() || !m_streams.contains(stream))
+    return;
+
+  // Obtain frames from the data
+  auto reader = m_streams.value(stream).reader;
+  const auto time = timestamp > 0 ? timestamp : FrameQueue::timestamp();
+  QMetaObject::invokeMethod(reader, [=] { reader->processData(data, time); });
+
+  // Let the outgoing queue react to XON/XOFF characters
+  m_writeQueue.processReceivedData(data);
 
   // Update received bytes indicator
-  m_receivedBytes += bytes;
+  m_receivedBytes += data.size();
   if (m_receivedBytes >= UINT64_MAX)
     m_receivedBytes = 0;
 
   // Notify user interface
   Q_EMIT receivedBytesChanged();
-  Q_EMIT dataReceived(data);
+  Q_EMIT deviceDataReceived(stream, data, time);
 }
 
 /**
- * Checks if the @c cursor has a checksum corresponding to the given @a frame.
- * If so, the function shall calculate the appropiate checksum to for the @a
- * frame and compare it with the received checksum to verify the integrity of
- * received data.
- *
- * @param frame data in which we shall perform integrity checks
- * @param cursor master buffer, should start with checksum type header
- * @param bytes pointer to the number of bytes that we need to chop from the
- * master buffer
- */
-IO::Manager::ValidationStatus
-IO::Manager::integrityChecks(const QByteArray &frame, const QByteArray &cursor,
-                             int *bytes)
-{
-  // Get finish sequence as byte array
-  auto finish = finishSequence().toUtf8();
-  auto crc8Header = finish + "crc8:";
-  auto crc16Header = finish + "crc16:";
-  auto crc32Header = finish + "crc32:";
-
-  // Check CRC-8
-  if (cursor.contains(crc8Header))
+ * Publishes the given @a frames of the given @a stream directly, without
+ * looking for frame delimiters in the received @a data (e.g. each UDP
+ * datagram is a frame).
+ */
+void IO::Manager::processStreamFrames(const int stream, const QByteArray &data,
+                                      const QVector<QByteArray> &frames,
+                                      const qint64 timestamp)
+{
+  // Validate arguments
+  if (frames.isEmpty() || !m_streams.contains(stream))
+    return;
+
+  // Publish the frames through the frame reader of the stream
+  auto reader = m_streams.value(stream).reader;
+  const auto time = timestamp > 0 ? timestamp : FrameQueue::timestamp();
+  QMetaObject::invokeMethod(reader,
+                            [=] { reader->publishFrames(frames, time); });
+
+  // Update received bytes indicator
+  m_receivedBytes += data.size();
+  if (m_receivedBytes >= UINT64_MAX)
+    m_receivedBytes = 0;
+
+  // Notify user interface
+  Q_EMIT receivedBytesChanged();
+  Q_EMIT deviceDataReceived(stream, data, time);
+}
+
+/**
+ * Connects/disconnects the application from the currently selected device. This
+ * function is used as a convenience for the connect/disconnect button.
+ */
+void IO::Manager::toggleConnection()
+{
+  if (connected() || reconnecting())
   {
-    // Enable the CRC flag
-    m_enableCrc = true;
-    auto offset = cursor.indexOf(crc8Header) + crc8Header.length() - 1;
+    m_reconnect.reset();
+    disconnectDriver();
+  }
+
+  else
+    connectDevice();
+}
+
+/**
+ * Closes the currently selected device and tries to open & configure a new
+ * connection. A data source must be selected before calling this function.
+ */
+void IO::Manager::connectDevice()
+{
+  // Reset driver
+  setSelectedDriver(selectedDriver());
+
+  // Configure current device
+  if (deviceAvailable())
+  {
+    // Set open flag
+    QIODevice::OpenMode mode = QIODevice::ReadOnly;
+    if (m_writeEnabled)
+      mode = QIODevice::ReadWrite;
 
-    // Check if we have enough data in the buffer
-    if (cursor.length() >= offset + 1)
+    // Open device
+    if (driver()->open(mode))
     {
-      // Increment the number of bytes to remove from master buffer
-      *bytes += crc8Header.length() + 1;
+      m_reconnect.linkUp();
+      m_writeQueue.setDriver(driver());
+      connect(driver(), &IO::HAL_Driver::dataReceived, this,
+              &IO::Manager::onDataReceived);
 
-      // Get 8-bit checksum
-      const quint8 crc = cursor.at(offset + 1);
+      // Open additional devices, a device that fails to open does not
+      // prevent the rest of them from being used
+      StringList failed;
+      Q_FOREACH (auto device, m_devices)
+      {
+        if (!device->open(mode))
+          failed.append(device->tag());
+      }
 
-      // Compare checksums
-      if (crc8(frame.data(), frame.length()) == crc)
-        return ValidationStatus::FrameOk;
-      else
-        return ValidationStatus::ChecksumError;
+      if (!failed.isEmpty())
+        Misc::Utilities::showMessageBox(
+            tr("Cannot open additional devices"),
+            tr("The following devices could not be opened: %1")
+                .arg(failed.join(", ")));
     }
+
+    // Error opening the device
+    else
+      disconnectDriver();
+
+    // Update UI
+    Q_EMIT connectedChanged();
   }
+}
 
-  // Check CRC-16
-  else if (cursor.contains(crc16Header))
+/**
+ * Disconnects from the current device and clears temp. data
+ */
+void IO::Manager::disconnectDriver()
+{
+  if (deviceAvailable())
   {
-    // Enable the CRC flag
-    m_enableCrc = true;
-    auto offset = cursor.indexOf(crc16Header) + crc16Header.length() - 1;
+    // Disconnect device signals/slots
+    disconnect(driver(), &IO::HAL_Driver::dataReceived, this,
+               &IO::Manager::onDataReceived);
+    disconnect(driver(), &IO::HAL_Driver::configurationChanged, this,
+               &IO::Manager::configurationChanged);
 
-    // Check if we have enough data in the buffer
-    if (cursor.length() >= offset + 2)
-    {
-      // Increment the number of bytes to remove from master buffer
-      *bytes += crc16Header.length() + 2;
-
-      // Get 16-bit checksum
-      const quint8 a = cursor.at(offset + 1);
-      const quint8 b = cursor.at(offset + 2);
-      const quint16 crc = (a << 8) | (b & 0xff);
-
-      // Compare checksums
-      if (crc16(frame.data(), frame.length()) == crc)
-        return ValidationStatus::FrameOk;
-      else
-        return ValidationStatus::ChecksumError;
-    }
+    // Discard queued data, close driver device & additional devices
+    m_writeQueue.setDriver(Q_NULLPTR);
+    driver()->close();
+    Q_FOREACH (auto device, m_devices)
+      device->close();
+
+    // Update device pointer
+    m_driver = Q_NULLPTR;
+    m_receivedBytes = 0;
+
+    // Update UI
+    Q_EMIT driverChanged();
+    Q_EMIT connectedChanged();
   }
 
-  // Check CRC-32
-  else if (cursor.contains(crc32Header))
+  // Clear temp. buffer, CRC checking is only disabled if the connection is
+  // not going to be restored automatically
+  auto reader = m_frameReader;
+  if (reconnecting())
+    QMetaObject::invokeMethod(reader, [=] { reader->resync(); });
+  else
+    QMetaObject::invokeMethod(reader, [=] { reader->reset(); });
+}
+
+/**
+ * Called by the drivers when the link with the device is lost. The driver is
+ * closed &, if automatic reconnection is enabled, a reconnection attempt is
+ * scheduled.
+ *
+ * If the connection is not going to be restored, the given @a title &
+ * @a message are shown to the user in a message box.
+ */
+void IO::Manager::connectionLost(const QString &title, const QString &message)
+{
+  // Schedule a reconnection attempt
+  if (m_autoReconnect)
+    m_reconnect.linkDown();
+
+  // Close the driver, keeping the framing state if the link is restored
+  disconnectDriver();
+
+  // Notify the user
+  if (!reconnecting() && !title.isEmpty())
+    Misc::Utilities::showMessageBox(title, message);
+}
+
+/**
+ * Enables or disables the automatic reconnection of lost links, disabling it
+ * cancels any pending reconnection attempt.
+ */
+void IO::Manager::setAutoReconnect(const bool enabled)
+{
+  if (m_autoReconnect != enabled)
   {
-    // Enable the CRC flag
-    m_enableCrc = true;
-    auto offset = cursor.indexOf(crc32Header) + crc32Header.length() - 1;
+    m_autoReconnect = enabled;
+    m_settings.setValue("IO_Manager_AutoReconnect", enabled);
 
-    // Check if we have enough data in the buffer
-    if (cursor.length() >= offset + 4)
+    if (!enabled && reconnecting())
     {
-      // Increment the number of bytes to remove from master buffer
-      *bytes += crc32Header.length() + 4;
-
-      // Get 32-bit checksum
-      const quint8 a = cursor.at(offset + 1);
-      const quint8 b = cursor.at(offset + 2);
-      const quint8 c = cursor.at(offset + 3);
-      const quint8 d = cursor.at(offset + 4);
-      const quint32 crc = (a << 24) | (b << 16) | (c << 8) | (d & 0xff);
-
-      // Compare checksums
-      if (crc32(frame.data(), frame.length()) == crc)
-        return ValidationStatus::FrameOk;
-      else
-        return ValidationStatus::ChecksumError;
+      m_reconnect.reset();
+      disconnectDriver();
     }
-  }
 
-  // Buffer does not contain CRC code
-  else if (!m_enableCrc)
-  {
-    *bytes += finish.length();
-    return ValidationStatus::FrameOk;
+    Q_EMIT autoReconnectChanged();
   }
+}
 
-  // Checksum data incomplete
-  return ValidationStatus::ChecksumIncomplete;
+/**
+ * Enables/disables RW mode
+ */
+void IO::Manager::setWriteEnabled(const bool enabled)
+{
+  m_writeEnabled = enabled;
+  Q_EMIT writeEnabledChanged();
 }
 
+/**
+ * Reads the given payload and emits it as if it were received from a device.
+ * This function is for convenience to interact with other application modules &
+ * plugins.
+ */
+void IO::Manager::processPayload(const QByteArray &payload)
+{
+  if (!payload.isEmpty())
+  {
+    // Update received bytes indicator
+    m_receivedBytes += payload.size();
+    if (m_receivedBytes >= UINT64_MAX)
+      m_receivedBytes = 0;
+
+    // Notify user interface
+    const auto time = FrameQueue::timestamp();
+    Q_EMIT dataReceived(payload, time);
+    Q_EMIT receivedBytesChanged();
+
+    // Publish the payload through the frame reader, which is the only
+    // producer allowed to write to the frame queue
+    auto reader = m_frameReader;
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->publishFrame(payload, time); });
+  }
+}
+
+/**
+ * Publishes a batch of already separated @a frames (e.g. frames received by
+ * the MQTT subscriber) with a single queued call to the frame reader.
+ *
+ * The raw @a data is shown in the console, but the console & received bytes
+ * notifications are emitted at most once every @c IO_NOTIFICATION_INTERVAL
+ * milliseconds, so that high-rate sources do not flood the user interface.
+ *
+ * The frames are tagged with the given reception @a timestamp, or with the
+ * current time if no timestamp is given.
+ */
+void IO::Manager::processFrames(const QByteArray &data,
+                                const QVector<QByteArray> &frames,
+                                const qint64 timestamp)
+{
+  // Update received bytes indicator
+  m_receivedBytes += data.size();
+  if (m_receivedBytes >= UINT64_MAX)
+    m_receivedBytes = 0;
+
+  // Publish the frames through the frame reader
+  const auto time = timestamp > 0 ? timestamp : FrameQueue::timestamp();
+  if (!frames.isEmpty())
+  {
+    auto reader = m_frameReader;
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->publishFrames(frames, time); });
+  }
+
+  // Register the data for the console, keeping only the most recent bytes
+  if (m_pendingData.isEmpty())
+    m_pendingTimestamp = time;
+
+  m_pendingData.append(data);
+  if (m_pendingData.size() > m_maxBufferSize)
+    m_pendingData.remove(0, m_pendingData.size() - m_maxBufferSize);
+
+  // Schedule the user interface notifications
+  if (!m_notificationTimer.isActive())
+    m_notificationTimer.start();
+}
+
+/**
+ * Changes the maximum permited buffer size. Check the @c maxBufferSize()
+ * function for more information.
+ */
+void IO::Manager::setMaxBufferSize(const int maxBufferSize)
+{
+  m_maxBufferSize = maxBufferSize;
+  Q_EMIT maxBufferSizeChanged();
+
+  Q_FOREACH (auto reader, frameReaders())
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->setMaxBufferSize(maxBufferSize); });
+}
+
+/**
+ * Changes the method used to detect frames in the incoming data stream. Check
+ * the @c framingMode() function for more information.
+ */
+void IO::Manager::setFramingMode(const IO::Manager::FramingMode mode)
+{
+  // Nothing to do, keep the data buffered by the frame readers (e.g. when
+  // switching between projects that use the same framing)
+  if (m_framingMode == mode)
+    return;
+
+  // Hand a new framer to each frame reader, data buffered with the previous
+  // framing mode is discarded
+  m_framingMode = mode;
+  Q_FOREACH (auto reader, frameReaders())
+  {
+    auto framer = CREATE_FRAMER(mode);
+    QMetaObject::invokeMethod(reader, [=] { reader->setFramer(framer); });
+  }
+
+  // Update UI
+  Q_EMIT framingModeChanged();
+}
+
+/**
+ * Changes the compression applied by the device to its data, @a windowBits &
+ * @a lookaheadBits must match the parameters of the heatshrink encoder & are
+ * ignored by the other compression modes.
+ */
+void IO::Manager::setCompression(const IO::Manager::Compression mode,
+                                 const int windowBits, const int lookaheadBits)
+{
+  // Nothing to do, keep the data buffered by the frame readers
+  const auto window = qBound(4, windowBits, 15);
+  const auto lookahead = qBound(3, lookaheadBits, window - 1);
+  if (m_compression == mode && m_heatshrinkWindowBits == window
+      && m_heatshrinkLookaheadBits == lookahead)
+    return;
+
+  // Hand a new decompressor to each frame reader, buffered data is discarded
+  m_compression = mode;
+  m_heatshrinkWindowBits = window;
+  m_heatshrinkLookaheadBits = lookahead;
+  Q_FOREACH (auto reader, frameReaders())
+  {
+    auto decompressor = CREATE_DECOMPRESSOR(mode, m_heatshrinkWindowBits,
+                                            m_heatshrinkLookaheadBits);
+    QMetaObject::invokeMethod(
+        reader, [=] { reader->setDecompressor(decompressor); });
+  }
+
+  // Update UI
+  Q_EMIT compressionChanged();
+}
+
+/**
+ * Changes the checksum algorithm used to verify the integrity of each frame.
+ * When an algorithm is selected, the last bytes of every frame are expected to
+ * contain the checksum of the preceding bytes in big endian byte order.
+ */
+void IO::Manager::setChecksumAlgorithm(const IO::ChecksumAlgorithm algorithm)
+{
+  m_checksumAlgorithm = algorithm;
+  Q_EMIT checksumAlgorithmChanged();
+
+  Q_FOREACH (auto reader, frameReaders())
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->setChecksumAlgorithm(algorithm); });
+}
+
+/**
+ * Changes the location of the checksum selected with
+ * @c setChecksumAlgorithm(). If set to @c ChecksumPlacement::AfterFinish, the
+ * checksum is expected right after the finish sequence of each frame.
+ */
+void IO::Manager::setChecksumPlacement(const IO::ChecksumPlacement placement)
+{
+  m_checksumPlacement = placement;
+  Q_EMIT checksumPlacementChanged();
+
+  Q_FOREACH (auto reader, frameReaders())
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->setChecksumPlacement(placement); });
+}
+
+/**
+ * Changes the encoding of the checksum selected with @c setChecksumAlgorithm(),
+ * ASCII hexadecimal checksums use two characters per checksum byte.
+ */
+void IO::Manager::setChecksumEncoding(const IO::ChecksumEncoding encoding)
+{
+  m_checksumEncoding = encoding;
+  Q_EMIT checksumEncodingChanged();
+
+  Q_FOREACH (auto reader, frameReaders())
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->setChecksumEncoding(encoding); });
+}
+
+/**
+ * Enables or disables frame extraction in a dedicated worker thread. When
+ * enabled, frame detection & checksum verification do not compete with the
+ * user interface for CPU time on the main thread, and extracted frames are
+ * delivered to the rest of the application through queued signals.
+ *
+ * The serial port driver (@c QSerialPort backend) also reads the device from
+ * the worker thread & hands the data directly to the frame reader (see
+ * @c processWorkerData()), so that the port is drained & framed even while
+ * the main thread is busy. An open serial port is re-opened when the option
+ * changes, so that the port can be moved to its new thread.
+ *
+ * @note The network & Bluetooth LE drivers still read their sockets from the
+ *       main thread, so a long stall of the user interface can still fill the
+ *       receive buffers of the operating system with these drivers.
+ */
+void IO::Manager::setThreadedFrameExtraction(const bool enabled)
+{
+  // Nothing to do
+  if (m_threadedFrameExtraction == enabled)
+    return;
+
+  // Close the serial port before its thread changes
+  const bool reopen = connected() && driver() == &Drivers::Serial::instance();
+  if (reopen)
+    disconnectDriver();
+
+  // Move the frame readers to the worker thread
+  if (enabled)
+  {
+    m_workerThread.setObjectName("IO::FrameReader");
+    m_workerThread.start(QThread::HighPriority);
+    Q_FOREACH (auto reader, frameReaders())
+      reader->moveToThread(&m_workerThread);
+
+    applyWorkerScheduling();
+  }
+
+  // Move the frame readers back to the main thread & stop the worker thread
+  else
+  {
+    auto mainThread = thread();
+    Q_FOREACH (auto reader, frameReaders())
+      QMetaObject::invokeMethod(
+          reader, [=] { reader->moveToThread(mainThread); },
+          Qt::BlockingQueuedConnection);
+
+    m_workerThread.quit();
+    m_workerThread.wait();
+  }
+
+  // Update settings
+  m_threadedFrameExtraction = enabled;
+  m_settings.setValue("IO_Manager_ThreadedFrameExtraction", enabled);
+  Q_EMIT threadedFrameExtractionChanged();
+
+  // Re-open the serial port in its new thread
+  if (reopen)
+    connectDevice();
+}
+
+/**
+ * Enables or disables real-time scheduling of the frame extraction thread,
+ * so that background processes cannot delay the processing of the incoming
+ * data. The option only has an effect while threaded frame extraction is
+ * enabled.
+ */
+void IO::Manager::setRealtimeIoThread(const bool enabled)
+{
+  if (m_realtimeIoThread != enabled)
+  {
+    m_realtimeIoThread = enabled;
+    m_settings.setValue("IO_Manager_RealtimeIoThread", enabled);
+    applyWorkerScheduling();
+    Q_EMIT ioSchedulingChanged();
+  }
+}
+
+/**
+ * Pins the frame extraction thread to the given @a cpu core, or lets it run
+ * on any core if @a cpu is negative. The option only has an effect while
+ * threaded frame extraction is enabled.
+ */
+void IO::Manager::setIoThreadCpu(const int cpu)
+{
+  const auto value = qBound(-1, cpu, Misc::ThreadScheduler::cpuCount() - 1);
+  if (m_ioThreadCpu != value)
+  {
+    m_ioThreadCpu = value;
+    m_settings.setValue("IO_Manager_IoThreadCpu", value);
+    applyWorkerScheduling();
+    Q_EMIT ioSchedulingChanged();
+  }
+}
+
+/**
+ * Changes the maximum number of @a bytes that can be written to the driver
+ * without being transmitted yet, 0 disables the limit.
+ */
+void IO::Manager::setWriteMaxInFlight(const int bytes)
+{
+  const auto value = qBound(0, bytes, 16 * 1024 * 1024);
+  if (m_writeQueue.maxInFlight() != value)
+  {
+    m_writeQueue.setMaxInFlight(value);
+    m_settings.setValue("IO_Manager_WriteMaxInFlight", value);
+    Q_EMIT writeQueueChanged();
+  }
+}
+
+/**
+ * Changes the maximum rate (in @a bytesPerSecond) at which data is written
+ * to the device, 0 disables pacing.
+ */
+void IO::Manager::setWritePacingRate(const int bytesPerSecond)
+{
+  const auto value = qMax(0, bytesPerSecond);
+  if (m_writeQueue.pacingRate() != value)
+  {
+    m_writeQueue.setPacingRate(value);
+    m_settings.setValue("IO_Manager_WritePacingRate", value);
+    Q_EMIT writeQueueChanged();
+  }
+}
+
+/**
+ * Enables or disables pausing the transmission of queued data when the
+ * device sends XOFF, until it sends XON.
+ */
+void IO::Manager::setWriteXonXoff(const bool enabled)
+{
+  if (m_writeQueue.softwareFlowControl() != enabled)
+  {
+    m_writeQueue.setSoftwareFlowControl(enabled);
+    m_settings.setValue("IO_Manager_WriteXonXoff", enabled);
+    Q_EMIT writeQueueChanged();
+  }
+}
+
+/**
+ * Changes the frame start sequence. Check the @c startSequence() function for
+ * more information.
+ */
+void IO::Manager::setStartSequence(const QString &sequence)
+{
+  m_startSequence = ADD_ESCAPE_SEQUENCES(sequence);
+  if (m_startSequence.isEmpty())
+    m_startSequence = "/*";
+
+  auto bytes = m_startSequence.toUtf8();
+  Q_FOREACH (auto reader, frameReaders())
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->setStartSequence(bytes); });
+
+  Q_EMIT startSequenceChanged();
+}
+
+/**
+ * Changes the frame end sequence. Check the @c finishSequence() function for
+ * more information.
+ */
+void IO::Manager::setFinishSequence(const QString &sequence)
+{
+  m_finishSequence = ADD_ESCAPE_SEQUENCES(sequence);
+  if (m_finishSequence.isEmpty())
+    m_finishSequence = "*/";
+
+  auto bytes = m_finishSequence.toUtf8();
+  Q_FOREACH (auto reader, frameReaders())
+    QMetaObject::invokeMethod(reader,
+                              [=] { reader->setFinishSequence(bytes); });
+
+  Q_EMIT finishSequenceChanged();
+}
+
+/**
+ * Changes the frame separator sequence. Check the @c separatorSequence()
+ * function for more information.
+ */
+void IO::Manager::setSeparatorSequence(const QString &sequence)
+{
+  m_separatorSequence = ADD_ESCAPE_SEQUENCES(sequence);
+  if (m_separatorSequence.isEmpty())
+    m_separatorSequence = ",";
+
+  Q_EMIT separatorSequenceChanged();
+}
+
+/**
+ * Changes the data source type. Check the @c dataSource() funciton for more
+ * information.
+ */
+void IO::Manager::setSelectedDriver(const IO::Manager::SelectedDriver &driver)
+{
+  // Forget the lost connection of the previous driver
+  if (driver != m_selectedDriver)
+    m_reconnect.reset();
+
+  // Disconnect current driver
+  disconnectDriver();
+
+  // Change data source
+  m_selectedDriver = driver;
+
+  // Disconnect previous device (if any)
+  disconnectDriver();
+
+  // Try to open a serial port connection
+  if (selectedDriver() == SelectedDriver::Serial)
+    setDriver(&(Drivers::Serial::instance()));
+
+  // Try to open a network connection
+  else if (selectedDriver() == SelectedDriver::Network)
+    setDriver(&(Drivers::Network::instance()));
+
+  // Try to open a BLE connection
+  else if (selectedDriver() == SelectedDriver::BluetoothLE)
+    setDriver(&(Drivers::BluetoothLE::instance()));
+
+  // Replay a raw capture file
+  else if (selectedDriver() == SelectedDriver::Replay)
+    setDriver(&(Drivers::Replay::instance()));
+
+  // Read from a file, pipe, local socket or the standard input
+  else if (selectedDriver() == SelectedDriver::Stream)
+    setDriver(&(Drivers::Stream::instance()));
+
+  // Receive frames from a CAN bus interface
+  else if (selectedDriver() == SelectedDriver::CANBus)
+    setDriver(&(Drivers::CANBus::instance()));
+
+  // Poll the registers of a Modbus server
+  else if (selectedDriver() == SelectedDriver::Modbus)
+    setDriver(&(Drivers::Modbus::instance()));
+
+  // Read the bulk endpoints of a USB device
+  else if (selectedDriver() == SelectedDriver::USB)
+    setDriver(&(Drivers::USB::instance()));
+
+  // Capture the samples of an audio input
+  else if (selectedDriver() == SelectedDriver::Audio)
+    setDriver(&(Drivers::Audio::instance()));
+
+  // Invalid driver
+  else
+    setDriver(Q_NULLPTR);
+
+  // Update UI
+  Q_EMIT selectedDriverChanged();
+}
+
+/**
+ * Makes a reconnection attempt scheduled by the @c ReconnectManager, the next
+ * attempt is scheduled if the driver cannot be opened.
+ */
+void IO::Manager::reconnect()
+{
+  if (connected())
+    return;
+
+  connectDevice();
+  if (!connected())
+    m_reconnect.linkDown();
+}
+
+/**
+ * Changes the target device pointer. Deletion should be handled by the
+ * interface implementation, not by this class.
+ */
+void IO::Manager::setDriver(HAL_Driver *driver)
+{
+  if (driver)
+    connect(driver, &IO::HAL_Driver::configurationChanged, this,
+            &IO::Manager::configurationChanged);
+
+  m_driver = driver;
+
+  Q_EMIT driverChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Restores the additional devices registered in a previous session
+ */
+void IO::Manager::readDevices()
+{
+  const int count = m_settings.beginReadArray("IO_Manager_Devices");
+  QVector<QVariantMap> devices;
+  for (int i = 0; i < count; ++i)
+  {
+    m_settings.setArrayIndex(i);
+
+    QVariantMap map;
+    map.insert("tag", m_settings.value("tag"));
+    map.insert("portName", m_settings.value("portName"));
+    map.insert("baudRate", m_settings.value("baudRate", 9600));
+    map.insert("fieldOffset", m_settings.value("fieldOffset", 0));
+    devices.append(map);
+  }
+  m_settings.endArray();
+
+  Q_FOREACH (const auto &map, devices)
+  {
+    addDevice(map.value("portName").toString(), map.value("baudRate").toInt(),
+              map.value("tag").toString(), map.value("fieldOffset").toInt());
+  }
+}
+
+/**
+ * Saves the configuration of the additional devices
+ */
+void IO::Manager::writeDevices()
+{
+  m_settings.beginWriteArray("IO_Manager_Devices", m_devices.count());
+  for (int i = 0; i < m_devices.count(); ++i)
+  {
+    auto device = m_devices.at(i);
+    m_settings.setArrayIndex(i);
+    m_settings.setValue("tag", device->tag());
+    m_settings.setValue("portName", device->portName());
+    m_settings.setValue("baudRate", device->baudRate());
+    m_settings.setValue("fieldOffset", device->fieldOffset());
+  }
+  m_settings.endArray();
+}
+
+/**
+ * Applies the selected priority & CPU affinity to the frame extraction
+ * thread. The scheduling functions of the operating system only operate on
+ * the calling thread, so they are invoked through an object that lives in
+ * the worker thread.
+ */
+void IO::Manager::applyWorkerScheduling()
+{
+  if (!m_workerThread.isRunning())
+    return;
+
+  const auto cpu = m_ioThreadCpu;
+  const auto realtime = m_realtimeIoThread;
+  QMetaObject::invokeMethod(&m_workerContext, [=] {
+    if (!Misc::ThreadScheduler::setRealtimePriority(realtime))
+      qWarning() << "Cannot change the priority of the I/O thread";
+
+    if (!Misc::ThreadScheduler::setAffinity(cpu))
+      qWarning() << "Cannot change the CPU affinity of the I/O thread";
+  });
+}
+
+/**
+ * Returns the frame readers of the selected driver, of every additional
+ * device & of every open stream, used to apply the framing configuration to
+ * all of them.
+ */
+QVector<IO::FrameReader *> IO::Manager::frameReaders() const
+{
+  QVector<FrameReader *> readers;
+  readers.reserve(m_devices.count() + m_streams.count() + 1);
+  readers.append(m_frameReader);
+  Q_FOREACH (auto device, m_devices)
+    readers.append(device->frameReader());
+  Q_FOREACH (const auto &stream, m_streams)
+    readers.append(stream.reader);
+
+  return readers;
+}
+
+/**
+ * Returns a copy of the current framing settings (framing mode, compression,
+ * checksum & delimiters), which can be handed to other threads.
+ */
+IO::Manager::FramingSettings IO::Manager::framingSettings() const
+{
+  FramingSettings settings;
+  settings.maxBufferSize = m_maxBufferSize;
+  settings.framingMode = m_framingMode;
+  settings.compression = m_compression;
+  settings.heatshrinkWindowBits = m_heatshrinkWindowBits;
+  settings.heatshrinkLookaheadBits = m_heatshrinkLookaheadBits;
+  settings.checksumAlgorithm = m_checksumAlgorithm;
+  settings.checksumPlacement = m_checksumPlacement;
+  settings.checksumEncoding = m_checksumEncoding;
+  settings.startSequence = m_startSequence.toUtf8();
+  settings.finishSequence = m_finishSequence.toUtf8();
+  return settings;
+}
+
+/**
+ * Applies the current framing settings to the given @a reader, which must not
+ * be used by another thread while it is being configured.
+ */
+void IO::Manager::configureFrameReader(FrameReader *reader) const
+{
+  configureFrameReader(reader, framingSettings());
+}
+
+/**
+ * Applies the given framing @a settings to the given @a reader. This does not
+ * read the state of the I/O manager, so it is also used to extract frames from
+ * recorded data in other threads (see @c CSV::Converter).
+ */
+void IO::Manager::configureFrameReader(FrameReader *reader,
+                                       const FramingSettings &settings)
+{
+  reader->setMaxBufferSize(settings.maxBufferSize);
+  reader->setFramer(CREATE_FRAMER(settings.framingMode));
+  reader->setDecompressor(CREATE_DECOMPRESSOR(
+      settings.compression, settings.heatshrinkWindowBits,
+      settings.heatshrinkLookaheadBits));
+  reader->setChecksumAlgorithm(settings.checksumAlgorithm);
+  reader->setChecksumPlacement(settings.checksumPlacement);
+  reader->setChecksumEncoding(settings.checksumEncoding);
+  reader->setStartSequence(settings.startSequence);
+  reader->setFinishSequence(settings.finishSequence);
+}
+
+/**
+ * Creates a frame reader that tags its frames with the given @a device
+ * identifier & configures it with the current framing settings. The reader
+ * lives in the same thread as the frame reader of the selected driver, so
+ * that the frame queue keeps having a single producer thread.
+ */
+IO::FrameReader *IO::Manager::createFrameReader(const int device)
+{
+  // Configure reader
+  auto reader = new FrameReader(&m_frameQueue, device);
+  configureFrameReader(reader);
+
+  // Notify the application modules when new frames are available
+  connect(reader, &IO::FrameReader::framesAvailable, this,
+          &IO::Manager::onFramesAvailable);
+
+  // Move reader to the frame extraction thread
+  if (m_threadedFrameExtraction)
+    reader->moveToThread(&m_workerThread);
+
+  return reader;
+}
+
+/**
+ * Notifies the application modules that new frames are available in the
+ * frame queue. The pending notification flag is cleared first, so that frames
+ * published while the modules read the queue trigger a new notification.
+ */
+void IO::Manager::onFramesAvailable()
+{
+  m_frameQueue.clearNotification();
+  Q_EMIT framesAvailable();
+}
+
+/**
+ * Emits the console & received bytes notifications for the data registered
+ * with @c processFrames() since the last call.
+ */
+void IO::Manager::flushNotifications()
+{
+  if (m_pendingData.isEmpty())
+    return;
+
+  const auto data = m_pendingData;
+  m_pendingData.clear();
+
+  Q_EMIT receivedBytesChanged();
+  Q_EMIT dataReceived(data, m_pendingTimestamp);
+}
+
+/**
+ * Hands the given @a data, read by a driver in the worker thread (see
+ * @c workerThread()), directly to the frame reader of the selected driver, so
+ * that frames are extracted without waiting for the main thread. The console
+ * & the received bytes indicator are updated in the main thread afterwards.
+ *
+ * @note This function must only be called from the worker thread.
+ */
+void IO::Manager::processWorkerData(const QByteArray &data,
+                                    const qint64 timestamp)
+{
+  Q_ASSERT(QThread::currentThread() == &m_workerThread);
+  m_frameReader->processData(data, timestamp);
+
+  QMetaObject::invokeMethod(
+      this,
+      [=] {
+        m_receivedBytes += data.length();
+        if (m_receivedBytes >= UINT64_MAX)
+          m_receivedBytes = 0;
+
+        Q_EMIT receivedBytesChanged();
+        Q_EMIT dataReceived(data, timestamp);
+      },
+      Qt::QueuedConnection);
+}
+
+/**
+ * Reads incoming data from the I/O device, updates the console object and
+ * hands the incoming data to the frame reader, which extracts valid data frames
+ * from it. The given @a timestamp is the time at which the driver read the
+ * data.
+ */
+void IO::Manager::onDataReceived(const QByteArray &data,
+                                 const qint64 timestamp)
+{
+  // Verify that device is still valid
+  if (!driver())
+    disconnectDriver();
+
+  // Read data & append it to buffer
+  auto bytes = data.length();
+
+  // Obtain frames from data buffer (in the worker thread if enabled), the
+  // reception time registered by the driver does not include the time spent
+  // in the queue of the worker thread
+  auto reader = m_frameReader;
+  const auto time = timestamp > 0 ? timestamp : FrameQueue::timestamp();
+  QMetaObject::invokeMethod(reader, [=] { reader->processData(data, time); });
+
+  // Update received bytes indicator
+  m_receivedBytes += bytes;
+  if (m_receivedBytes >= UINT64_MAX)
+    m_receivedBytes = 0;
+
+  // Notify user interface
+  Q_EMIT receivedBytesChanged();
+  Q_EMIT dataReceived(data, time);
+}
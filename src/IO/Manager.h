@@ -22,9 +22,26 @@
 
 #pragma once
 
+#include <QMap>
+#include <QTimer>
 #include <QObject>
+#include <QThread>
+#include <QVariantList>
 #include <DataTypes.h>
+#include <IO/Device.h>
+#include <IO/Checksum.h>
 #include <IO/HAL_Driver.h>
+#include <IO/FrameQueue.h>
+#include <IO/FrameReader.h>
+#include <IO/WriteQueue.h>
+#include <IO/ReconnectManager.h>
+#include <Misc/Settings.h>
+
+/**
+ * Minimum interval (in milliseconds) between the console & received bytes
+ * notifications emitted for data delivered with @c processFrames()
+ */
+#define IO_NOTIFICATION_INTERVAL 50
 
 namespace IO
 {
@@ -54,6 +71,32 @@ namespace IO
  * is ";". The data separator sequence is ",". Knowing this, Serial Studio
  * can process the frame and deduce that A,B,C,D,E,F and G are individual
  * dataset values.
+ *
+ * Additional serial ports (see the @c Device class) can be opened together
+ * with the selected driver. Each additional device has its own frame reader,
+ * and its frames are mapped to a different range of dataset indexes, so that
+ * the data of all devices is merged into a single dashboard. The selected
+ * driver always uses the device identifier 0.
+ *
+ * Received data is always handled together with the time at which the driver
+ * read it (see @c FrameQueue::timestamp()), the timestamp is carried by every
+ * frame until it reaches the generator, the exporters & the plugins.
+ *
+ * Drivers that receive data from several peers at once (e.g. the TCP server
+ * mode of the network driver) can open additional "streams" with
+ * @c openStream(). Each stream has its own frame reader, so that the partial
+ * frames of a peer are never mixed with the data of another peer, and its
+ * frames are tagged with the stream identifier. Streams feed the same
+ * datasets as the selected driver.
+ *
+ * Outgoing data is never written to the driver directly, @c writeData()
+ * appends it to a @c WriteQueue, which writes it in chunks according to the
+ * configured in-flight limit, pacing rate & flow control.
+ *
+ * If automatic reconnection is enabled, drivers report a lost link with
+ * @c connectionLost() & the connection is restored by the
+ * @c ReconnectManager. The checksum mode detected by the frame readers is
+ * kept between attempts, only the partial frames are discarded.
  */
 class Manager : public QObject
 {
@@ -83,18 +126,69 @@ class Manager : public QObject
                READ finishSequence
                WRITE setFinishSequence
                NOTIFY finishSequenceChanged)
+    Q_PROPERTY(IO::Manager::FramingMode framingMode
+               READ framingMode
+               WRITE setFramingMode
+               NOTIFY framingModeChanged)
+    Q_PROPERTY(IO::Manager::Compression compression
+               READ compression
+               NOTIFY compressionChanged)
     Q_PROPERTY(QString separatorSequence
                READ separatorSequence
                WRITE setSeparatorSequence
                NOTIFY separatorSequenceChanged)
+    Q_PROPERTY(bool threadedFrameExtraction
+               READ threadedFrameExtraction
+               WRITE setThreadedFrameExtraction
+               NOTIFY threadedFrameExtractionChanged)
+    Q_PROPERTY(bool realtimeIoThread
+               READ realtimeIoThread
+               WRITE setRealtimeIoThread
+               NOTIFY ioSchedulingChanged)
+    Q_PROPERTY(int ioThreadCpu
+               READ ioThreadCpu
+               WRITE setIoThreadCpu
+               NOTIFY ioSchedulingChanged)
+    Q_PROPERTY(int writeMaxInFlight
+               READ writeMaxInFlight
+               WRITE setWriteMaxInFlight
+               NOTIFY writeQueueChanged)
+    Q_PROPERTY(int writePacingRate
+               READ writePacingRate
+               WRITE setWritePacingRate
+               NOTIFY writeQueueChanged)
+    Q_PROPERTY(bool writeXonXoff
+               READ writeXonXoff
+               WRITE setWriteXonXoff
+               NOTIFY writeQueueChanged)
+    Q_PROPERTY(bool autoReconnect
+               READ autoReconnect
+               WRITE setAutoReconnect
+               NOTIFY autoReconnectChanged)
+    Q_PROPERTY(bool reconnecting
+               READ reconnecting
+               NOTIFY reconnectingChanged)
     Q_PROPERTY(bool configurationOk
                READ configurationOk
                NOTIFY configurationChanged)
+    Q_PROPERTY(int deviceCount
+               READ deviceCount
+               NOTIFY devicesChanged)
+    Q_PROPERTY(QVariantList devices
+               READ devices
+               NOTIFY devicesChanged)
   // clang-format on
 
 Q_SIGNALS:
   void driverChanged();
+  void devicesChanged();
+  void framesAvailable();
   void connectedChanged();
+  void framingModeChanged();
+  void compressionChanged();
+  void writeQueueChanged();
+  void reconnectingChanged();
+  void autoReconnectChanged();
   void writeEnabledChanged();
   void configurationChanged();
   void receivedBytesChanged();
@@ -102,11 +196,18 @@ Q_SIGNALS:
   void startSequenceChanged();
   void finishSequenceChanged();
   void selectedDriverChanged();
+  void checksumAlgorithmChanged();
+  void checksumPlacementChanged();
+  void checksumEncodingChanged();
   void separatorSequenceChanged();
   void frameValidationRegexChanged();
+  void threadedFrameExtractionChanged();
+  void ioSchedulingChanged();
   void dataSent(const QByteArray &data);
-  void dataReceived(const QByteArray &data);
+  void dataReceived(const QByteArray &data, const qint64 timestamp);
   void frameReceived(const QByteArray &frame);
+  void deviceDataReceived(const int device, const QByteArray &data,
+                          const qint64 timestamp);
 
 private:
   explicit Manager();
@@ -115,22 +216,60 @@ private:
   Manager &operator=(Manager &&) = delete;
   Manager &operator=(const Manager &) = delete;
 
+  ~Manager();
+
 public:
   enum class SelectedDriver
   {
     Serial,
     Network,
-    BluetoothLE
+    BluetoothLE,
+    Replay,
+    Stream,
+    CANBus,
+    Modbus,
+    USB,
+    Audio
   };
   Q_ENUM(SelectedDriver)
 
-  enum class ValidationStatus
+  enum class FramingMode
+  {
+    Delimiters,
+    LengthPrefix8,
+    LengthPrefix16BE,
+    LengthPrefix16LE,
+    LengthPrefix32BE,
+    LengthPrefix32LE,
+    COBS,
+    SLIP
+  };
+  Q_ENUM(FramingMode)
+
+  enum class Compression
+  {
+    None,
+    LZ4Blocks16LE,
+    LZ4Blocks32LE,
+    Heatshrink,
+    HeatshrinkBlocks16LE,
+    HeatshrinkBlocks32LE
+  };
+  Q_ENUM(Compression)
+
+  struct FramingSettings
   {
-    FrameOk,
-    ChecksumError,
-    ChecksumIncomplete
+    int maxBufferSize;
+    FramingMode framingMode;
+    Compression compression;
+    int heatshrinkWindowBits;
+    int heatshrinkLookaheadBits;
+    ChecksumAlgorithm checksumAlgorithm;
+    ChecksumPlacement checksumPlacement;
+    ChecksumEncoding checksumEncoding;
+    QByteArray startSequence;
+    QByteArray finishSequence;
   };
-  Q_ENUM(ValidationStatus)
 
   static Manager &instance();
 
@@ -139,52 +278,147 @@ public:
   bool connected();
   bool deviceAvailable();
   bool configurationOk();
+  bool reconnecting() const;
+  bool autoReconnect() const;
 
+  int deviceCount() const;
   int maxBufferSize() const;
+  bool threadedFrameExtraction() const;
+  bool realtimeIoThread() const;
+  int ioThreadCpu() const;
+  int writeMaxInFlight() const;
+  int writePacingRate() const;
+  bool writeXonXoff() const;
+  const WriteQueue &writeQueue() const;
+  QVariantList devices() const;
+  QString deviceTag(const int device) const;
+  int fieldDevice(const int field) const;
+  void deviceFieldRange(const int device, int *begin, int *end) const;
 
   HAL_Driver *driver();
+  QThread *workerThread();
+  FrameQueue &frameQueue();
+  FramingMode framingMode() const;
+  Compression compression() const;
+  int heatshrinkWindowBits() const;
+  int heatshrinkLookaheadBits() const;
+  ChecksumAlgorithm checksumAlgorithm() const;
+  ChecksumPlacement checksumPlacement() const;
+  ChecksumEncoding checksumEncoding() const;
   SelectedDriver selectedDriver() const;
 
   QString startSequence() const;
   QString finishSequence() const;
   QString separatorSequence() const;
 
+  FramingSettings framingSettings() const;
+  void configureFrameReader(FrameReader *reader) const;
+  void processWorkerData(const QByteArray &data, const qint64 timestamp);
+  static void configureFrameReader(FrameReader *reader,
+                                   const FramingSettings &settings);
+
   Q_INVOKABLE StringList availableDrivers() const;
+  Q_INVOKABLE StringList availableFramingModes() const;
+  Q_INVOKABLE StringList availableCompressionModes() const;
+  Q_INVOKABLE StringList availableChecksumAlgorithms() const;
+  Q_INVOKABLE StringList availableChecksumPlacements() const;
+  Q_INVOKABLE StringList availableChecksumEncodings() const;
   Q_INVOKABLE qint64 writeData(const QByteArray &data);
+  Q_INVOKABLE int addDevice(const QString &portName, const qint32 baudRate,
+                            const QString &tag, const int fieldOffset);
+  Q_INVOKABLE void removeDevice(const int device);
+
+  int openStream(const QString &tag);
+  void closeStream(const int stream);
+  void processStreamData(const int stream, const QByteArray &data,
+                         const qint64 timestamp = 0);
+  void processStreamFrames(const int stream, const QByteArray &data,
+                           const QVector<QByteArray> &frames,
+                           const qint64 timestamp = 0);
 
 public Q_SLOTS:
   void connectDevice();
   void toggleConnection();
   void disconnectDriver();
+  void connectionLost(const QString &title = QString(),
+                      const QString &message = QString());
+  void setAutoReconnect(const bool enabled);
   void setWriteEnabled(const bool enabled);
   void processPayload(const QByteArray &payload);
+  void processFrames(const QByteArray &data, const QVector<QByteArray> &frames,
+                     const qint64 timestamp = 0);
   void setMaxBufferSize(const int maxBufferSize);
+  void setFramingMode(const IO::Manager::FramingMode mode);
+  void setCompression(const IO::Manager::Compression mode,
+                      const int windowBits = 8, const int lookaheadBits = 4);
+  void setChecksumAlgorithm(const IO::ChecksumAlgorithm algorithm);
+  void setChecksumPlacement(const IO::ChecksumPlacement placement);
+  void setChecksumEncoding(const IO::ChecksumEncoding encoding);
+  void setThreadedFrameExtraction(const bool enabled);
+  void setRealtimeIoThread(const bool enabled);
+  void setIoThreadCpu(const int cpu);
+  void setWriteMaxInFlight(const int bytes);
+  void setWritePacingRate(const int bytesPerSecond);
+  void setWriteXonXoff(const bool enabled);
   void setStartSequence(const QString &sequence);
   void setFinishSequence(const QString &sequence);
   void setSeparatorSequence(const QString &sequence);
   void setSelectedDriver(const IO::Manager::SelectedDriver &driver);
 
+private:
+  void readDevices();
+  void writeDevices();
+  void applyWorkerScheduling();
+  QVector<FrameReader *> frameReaders() const;
+  FrameReader *createFrameReader(const int device);
+
 private Q_SLOTS:
-  void readFrames();
-  void clearTempBuffer();
+  void onFramesAvailable();
+  void reconnect();
+  void flushNotifications();
   void setDriver(HAL_Driver *driver);
-  void onDataReceived(const QByteArray &data);
+  void onDataReceived(const QByteArray &data, const qint64 timestamp);
 
 private:
-  ValidationStatus integrityChecks(const QByteArray &frame,
-                                   const QByteArray &masterBuffer,
-                                   int *bytesToChop);
-
-private:
-  bool m_enableCrc;
   bool m_writeEnabled;
+  bool m_autoReconnect;
+  bool m_threadedFrameExtraction;
+  bool m_realtimeIoThread;
+  int m_ioThreadCpu;
   int m_maxBufferSize;
   HAL_Driver *m_driver;
-  QByteArray m_dataBuffer;
+  FramingMode m_framingMode;
+  Compression m_compression;
+  int m_heatshrinkWindowBits;
+  int m_heatshrinkLookaheadBits;
+  ChecksumAlgorithm m_checksumAlgorithm;
+  ChecksumPlacement m_checksumPlacement;
+  ChecksumEncoding m_checksumEncoding;
   quint64 m_receivedBytes;
   QString m_startSequence;
   QString m_finishSequence;
   QString m_separatorSequence;
   SelectedDriver m_selectedDriver;
+
+  Misc::Settings m_settings;
+  QByteArray m_pendingData;
+  qint64 m_pendingTimestamp;
+  QTimer m_notificationTimer;
+  WriteQueue m_writeQueue;
+  ReconnectManager m_reconnect;
+  QThread m_workerThread;
+  QObject m_workerContext;
+  FrameQueue m_frameQueue;
+  FrameReader *m_frameReader;
+
+  int m_nextDeviceId;
+  QVector<Device *> m_devices;
+
+  struct Stream
+  {
+    QString tag;
+    FrameReader *reader;
+  };
+  QMap<int, Stream> m_streams;
 };
 } // namespace IO
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <QtNumeric>
+
+#include <JSON/Frame.h>
+#include <IO/ModbusScheduler.h>
+
+//
+// Identifiers used to store the tables & register types in the project file,
+// the order matches the Table & Type enums
+//
+static const char *TABLE_NAMES[] = {"coil", "discrete", "input", "holding"};
+static const char *TYPE_NAMES[]
+    = {"uint16", "int16", "uint32", "int32", "float32"};
+static const int TABLE_COUNT = sizeof(TABLE_NAMES) / sizeof(TABLE_NAMES[0]);
+static const int TYPE_COUNT = sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]);
+
+/**
+ * Limits of the Modbus protocol
+ */
+static const int MAX_ADDRESS = 65535;
+static const int MAX_UNIT = 247;
+static const int MAX_REGISTERS_PER_REQUEST = 125;
+static const int MAX_COILS_PER_REQUEST = 2000;
+
+/**
+ * Returns the index of the given @a name in the given table of @a names, or
+ * @a fallback if @a name is empty. Returns -1 if the name is not found.
+ */
+static int FIND(const QString &name, const char **names, const int count,
+                const int fallback)
+{
+  if (name.isEmpty())
+    return fallback;
+
+  for (int i = 0; i < count; ++i)
+  {
+    if (name == QLatin1String(names[i]))
+      return i;
+  }
+
+  return -1;
+}
+
+/**
+ * Constructor function
+ */
+IO::ModbusScheduler::ModbusScheduler()
+  : m_fieldCount(0)
+{
+}
+
+/**
+ * Returns @c true if no register is mapped to a dataset
+ */
+bool IO::ModbusScheduler::isEmpty() const
+{
+  return m_registers.isEmpty();
+}
+
+/**
+ * Returns the number of fields of the frames produced by each poll cycle
+ */
+int IO::ModbusScheduler::fieldCount() const
+{
+  return m_fieldCount;
+}
+
+/**
+ * Returns the number of requests needed to read all the mapped registers
+ */
+int IO::ModbusScheduler::blockCount() const
+{
+  return m_blocks.count();
+}
+
+/**
+ * Returns the number of registers mapped to datasets
+ */
+int IO::ModbusScheduler::registerCount() const
+{
+  return m_registers.count();
+}
+
+/**
+ * Returns the block (request) with the given @a index
+ */
+const IO::ModbusScheduler::Block &
+IO::ModbusScheduler::block(const int index) const
+{
+  return m_blocks.at(index);
+}
+
+/**
+ * Removes the compiled poll plan
+ */
+void IO::ModbusScheduler::clear()
+{
+  m_fieldCount = 0;
+  m_blocks.clear();
+  m_registers.clear();
+}
+
+/**
+ * Builds the poll plan from the Modbus mappings of the datasets of the given
+ * @a frame. Registers of the same server & table are merged into the same
+ * request if they are not separated by more than @a maxGap unused registers.
+ */
+bool IO::ModbusScheduler::compile(const JSON::Frame &frame, const int maxGap,
+                                  QString *error)
+{
+  // Remove previous plan
+  clear();
+
+  // Get the registers mapped to the datasets
+  QVector<Register> registers;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      if (dataset.modbus().isEmpty() || dataset.index() <= 0)
+        continue;
+
+      Register reg;
+      if (!parse(dataset.modbus(), reg, error))
+      {
+        if (error)
+          *error = QStringLiteral("%1: %2").arg(dataset.title(), *error);
+
+        return false;
+      }
+
+      reg.field = dataset.index() - 1;
+      registers.append(reg);
+      m_fieldCount = qMax(m_fieldCount, dataset.index());
+    }
+  }
+
+  // Sort registers by server, table & address
+  std::sort(registers.begin(), registers.end(),
+            [](const Register &a, const Register &b) {
+              if (a.unit != b.unit)
+                return a.unit < b.unit;
+              if (a.table != b.table)
+                return a.table < b.table;
+              return a.address < b.address;
+            });
+
+  // Coalesce neighbouring registers into blocks
+  const int gap = qMax(0, maxGap);
+  for (int i = 0; i < registers.count(); ++i)
+  {
+    const auto &reg = registers.at(i);
+    const int end = reg.address + reg.size;
+    if (!m_blocks.isEmpty())
+    {
+      auto &block = m_blocks.last();
+      const int blockEnd = block.address + block.count;
+      if (block.unit == reg.unit && block.table == reg.table
+          && reg.address <= blockEnd + gap
+          && qMax(end, blockEnd) - block.address <= maxBlockSize(reg.table))
+      {
+        block.count = qMax(end, blockEnd) - block.address;
+        block.last = i + 1;
+        continue;
+      }
+    }
+
+    Block block;
+    block.unit = reg.unit;
+    block.table = reg.table;
+    block.address = reg.address;
+    block.count = reg.size;
+    block.first = i;
+    block.last = i + 1;
+    m_blocks.append(block);
+  }
+
+  m_registers = registers;
+  return true;
+}
+
+/**
+ * Decodes the @a words read for the given @a block & writes the value of
+ * each register to its field in @a values. Registers that are not contained
+ * in the reply are set to NaN.
+ */
+void IO::ModbusScheduler::decode(const int block,
+                                 const QVector<quint16> &words,
+                                 QVector<double> &values) const
+{
+  // Validate arguments
+  if (block < 0 || block >= m_blocks.count())
+    return;
+
+  // Decode each register of the block
+  const auto &b = m_blocks.at(block);
+  for (int i = b.first; i < b.last; ++i)
+  {
+    const auto &reg = m_registers.at(i);
+    if (reg.field >= values.count())
+      continue;
+
+    // Register not contained in the reply
+    const int offset = reg.address - b.address;
+    if (offset + reg.size > words.count())
+    {
+      values[reg.field] = qQNaN();
+      continue;
+    }
+
+    // Get the 32-bit word of two-register values
+    quint32 word = words.at(offset);
+    if (reg.size == 2)
+    {
+      const quint32 high = reg.swapWords ? words.at(offset + 1) : word;
+      const quint32 low = reg.swapWords ? word : words.at(offset + 1);
+      word = (high << 16) | low;
+    }
+
+    // Convert the value
+    double value = 0;
+    switch (reg.type)
+    {
+      case Type::UInt16:
+        value = static_cast<quint16>(word);
+        break;
+      case Type::Int16:
+        value = static_cast<qint16>(word);
+        break;
+      case Type::UInt32:
+        value = word;
+        break;
+      case Type::Int32:
+        value = static_cast<qint32>(word);
+        break;
+      case Type::Float32: {
+        float number;
+        memcpy(&number, &word, sizeof(number));
+        value = number;
+        break;
+      }
+    }
+
+    values[reg.field] = value;
+  }
+}
+
+/**
+ * Returns @c true if the given Modbus @a mapping of a dataset is valid, an
+ * empty mapping means that the dataset is not polled.
+ */
+bool IO::ModbusScheduler::validate(const QJsonObject &mapping, QString *error)
+{
+  if (mapping.isEmpty())
+    return true;
+
+  Register reg;
+  return parse(mapping, reg, error);
+}
+
+/**
+ * Returns the maximum number of registers (or coils) that can be read from
+ * the given @a table with a single request.
+ */
+int IO::ModbusScheduler::maxBlockSize(const Table table)
+{
+  if (table == Table::Coils || table == Table::DiscreteInputs)
+    return MAX_COILS_PER_REQUEST;
+
+  return MAX_REGISTERS_PER_REQUEST;
+}
+
+/**
+ * Reads the given Modbus @a mapping into @a reg, returns @c false & sets
+ * @a error if the mapping is not valid.
+ */
+bool IO::ModbusScheduler::parse(const QJsonObject &mapping, Register &reg,
+                                QString *error)
+{
+  // Get table & register type
+  const auto tableName = mapping.value("table").toString().toLower();
+  const auto typeName = mapping.value("type").toString().toLower();
+  const auto order = mapping.value("wordOrder").toString().toLower();
+  const int table = FIND(tableName, TABLE_NAMES, TABLE_COUNT, 3);
+  const int type = FIND(typeName, TYPE_NAMES, TYPE_COUNT, 0);
+
+  // Register parameters
+  reg.unit = mapping.value("unit").toInt(1);
+  reg.address = mapping.value("address").toInt(-1);
+  reg.table = static_cast<Table>(qMax(0, table));
+  reg.type = static_cast<Type>(qMax(0, type));
+  reg.swapWords = (order == QStringLiteral("little"));
+  reg.size = 1;
+  reg.field = -1;
+
+  // Bits are always read as single values
+  const bool bits = table == 0 || table == 1;
+  if (!bits && reg.type != Type::UInt16 && reg.type != Type::Int16)
+    reg.size = 2;
+
+  // Validate parameters
+  QString message;
+  if (table < 0)
+    message = QStringLiteral("unknown Modbus table \"%1\"").arg(tableName);
+  else if (type < 0)
+    message = QStringLiteral("unknown register type \"%1\"").arg(typeName);
+  else if (!order.isEmpty() && order != "big" && order != "little")
+    message = QStringLiteral("invalid word order");
+  else if (reg.unit < 0 || reg.unit > MAX_UNIT)
+    message = QStringLiteral("invalid Modbus unit");
+  else if (reg.address < 0 || reg.address + reg.size - 1 > MAX_ADDRESS)
+    message = QStringLiteral("invalid register address");
+
+  // Report error
+  if (!message.isEmpty())
+  {
+    if (error)
+      *error = message;
+
+    return false;
+  }
+
+  return true;
+}
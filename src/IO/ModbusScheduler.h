@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+namespace JSON
+{
+class Frame;
+}
+
+namespace IO
+{
+/**
+ * @brief The ModbusScheduler class
+ *
+ * Builds the poll plan of the Modbus driver from the @c modbus key of the
+ * datasets of a project:
+ *
+ * @code
+ * "modbus": {
+ *   "unit": 1,             // Server (slave) address, 1 by default
+ *   "table": "holding",    // holding, input, coil or discrete
+ *   "address": 100,        // Zero-based register address
+ *   "type": "float32",     // uint16 (default), int16, uint32, int32, float32
+ *   "wordOrder": "big"     // Order of 32-bit registers, "big" by default
+ * }
+ * @endcode
+ *
+ * Registers are sorted by server, table & address and coalesced into blocks
+ * that are read with a single request. Neighbouring registers are merged
+ * even if there are unused registers between them, as long as the gap is not
+ * larger than the configured limit & the block does not exceed the maximum
+ * size of a Modbus request (125 registers or 2000 coils). Reading a few
+ * unused registers is much cheaper than the round-trip of another request,
+ * specially on RS-485 lines.
+ *
+ * Each decoded value is written to the frame field of its dataset (the
+ * dataset index minus one), so that a poll cycle produces a complete frame.
+ */
+class ModbusScheduler
+{
+public:
+  enum class Table
+  {
+    Coils,
+    DiscreteInputs,
+    InputRegisters,
+    HoldingRegisters
+  };
+
+  struct Block
+  {
+    int unit;
+    Table table;
+    int address;
+    int count;
+    int first;
+    int last;
+  };
+
+  ModbusScheduler();
+
+  bool isEmpty() const;
+  int fieldCount() const;
+  int blockCount() const;
+  int registerCount() const;
+  const Block &block(const int index) const;
+
+  void clear();
+  bool compile(const JSON::Frame &frame, const int maxGap,
+               QString *error = Q_NULLPTR);
+  void decode(const int block, const QVector<quint16> &words,
+              QVector<double> &values) const;
+
+  static bool validate(const QJsonObject &mapping, QString *error = Q_NULLPTR);
+
+private:
+  enum class Type
+  {
+    UInt16,
+    Int16,
+    UInt32,
+    Int32,
+    Float32
+  };
+
+  struct Register
+  {
+    int unit;
+    Table table;
+    int address;
+    int size;
+    Type type;
+    bool swapWords;
+    int field;
+  };
+
+  static int maxBlockSize(const Table table);
+  static bool parse(const QJsonObject &mapping, Register &reg,
+                    QString *error);
+
+private:
+  int m_fieldCount;
+  QVector<Block> m_blocks;
+  QVector<Register> m_registers;
+};
+} // namespace IO
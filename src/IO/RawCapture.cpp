@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QUrl>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QApplication>
+#include <QDesktopServices>
+
+#include <IO/Manager.h>
+#include <IO/RawCapture.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Size of the memory buffer in which chunks are accumulated before they are
+ * written to the capture file.
+ */
+static const int BUFFER_SIZE = 1024 * 1024;
+
+/**
+ * Interval (in milliseconds) at which buffered data is written to the file
+ */
+static const int FLUSH_INTERVAL = 1000;
+
+/**
+ * Maximum amount of data (in bytes) that can be waiting to be written by the
+ * worker thread, new data is discarded if this limit is reached.
+ */
+static const qint64 MAX_QUEUED_BYTES = 64 * 1024 * 1024;
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, allocates the write buffer & the flush timer
+ */
+IO::RawCaptureWorker::RawCaptureWorker()
+  : m_failed(false)
+  , m_offset(0)
+  , m_flushTimer(new QTimer(this))
+{
+  m_buffer.reserve(BUFFER_SIZE);
+  m_flushTimer->setInterval(FLUSH_INTERVAL);
+  connect(m_flushTimer, &QTimer::timeout, this, &RawCaptureWorker::flush);
+}
+
+/**
+ * Destructor function, writes pending data & closes the capture file
+ */
+IO::RawCaptureWorker::~RawCaptureWorker()
+{
+  close();
+}
+
+/**
+ * Writes the pending chunks & the index of the capture, and closes the file.
+ * The next received data is written to a new file.
+ */
+void IO::RawCaptureWorker::close()
+{
+  m_failed = false;
+  if (m_file.isOpen())
+  {
+    flush();
+    m_file.write(RawCaptureFile::trailer(m_index, m_offset));
+    m_file.close();
+    Q_EMIT fileChanged(QString());
+  }
+
+  m_index.clear();
+  m_buffer.resize(0);
+  m_offset = 0;
+}
+
+/**
+ * Writes the contents of the buffer to the capture file
+ */
+void IO::RawCaptureWorker::flush()
+{
+  if (m_file.isOpen() && !m_buffer.isEmpty())
+  {
+    m_file.write(m_buffer);
+    m_file.flush();
+  }
+
+  m_buffer.resize(0);
+}
+
+/**
+ * Changes the directory in which capture files are created
+ */
+void IO::RawCaptureWorker::setDirectory(const QString &directory)
+{
+  if (directory != m_directory)
+  {
+    close();
+    m_directory = directory;
+  }
+
+  // Start the flush timer (must be done from the worker thread)
+  if (!m_flushTimer->isActive())
+    m_flushTimer->start();
+}
+
+/**
+ * Appends the given @a data, which was received at the given monotonic
+ * @a timestamp, to the capture file.
+ */
+void IO::RawCaptureWorker::write(const QByteArray &data, const qint64 timestamp)
+{
+  // Nothing to write or open error
+  if (data.isEmpty() || m_failed)
+    return;
+
+  // Create a new file if required
+  if (!m_file.isOpen() && !openFile())
+    return;
+
+  // Register the chunk in the index
+  RawCaptureFile::Entry entry;
+  entry.offset = m_offset;
+  entry.timestamp = timestamp;
+  m_index.append(entry);
+
+  // Add the chunk to the buffer
+  const auto size = m_buffer.size();
+  RawCaptureFile::appendChunk(m_buffer, data, timestamp);
+  m_offset += m_buffer.size() - size;
+
+  // Write the buffer when it is full
+  if (m_buffer.size() >= BUFFER_SIZE)
+    flush();
+}
+
+/**
+ * Creates a new capture file in the capture directory, the file name is
+ * obtained from the current date/time so that files are sorted
+ * chronologically.
+ */
+bool IO::RawCaptureWorker::openFile()
+{
+  // Get file path
+  QDir dir(m_directory);
+  const auto time = QDateTime::currentDateTime();
+  const auto name = time.toString("yyyy-MM-dd_HH-mm-ss-zzz") + ".ssraw";
+  const auto path = dir.absoluteFilePath(name);
+
+  // Create the file
+  m_file.setFileName(path);
+  if (!dir.mkpath(".") || !m_file.open(QIODevice::WriteOnly))
+  {
+    m_failed = true;
+    Q_EMIT openFailed(path);
+    return false;
+  }
+
+  // Write the header
+  const auto header = RawCaptureFile::header();
+  m_file.write(header);
+  m_offset = header.size();
+  m_index.clear();
+
+  // Update UI
+  Q_EMIT fileChanged(path);
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Raw capture implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, reads the capture settings & starts the writer thread
+ */
+IO::RawCapture::RawCapture()
+  : m_enabled(false)
+  , m_queuedBytes(0)
+  , m_worker(new RawCaptureWorker())
+{
+  // Read settings
+  m_enabled = m_settings.value("RawCapture_Enabled", false).toBool();
+
+  // Start worker thread
+  m_thread.setObjectName(QStringLiteral("IO::RawCaptureWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(m_worker, &RawCaptureWorker::openFailed, this,
+          &RawCapture::onOpenFailed);
+  connect(m_worker, &RawCaptureWorker::fileChanged, this,
+          &RawCapture::onFileChanged);
+  m_thread.start();
+
+  // Configure the worker
+  auto worker = m_worker;
+  const auto path = directory();
+  QMetaObject::invokeMethod(worker, [=] { worker->setDirectory(path); });
+
+  // Capture the received data, start a new file for each connection
+  auto io = &IO::Manager::instance();
+  connect(io, &IO::Manager::dataReceived, this, &RawCapture::onDataReceived);
+  connect(io, &IO::Manager::connectedChanged, this, &RawCapture::closeFile);
+}
+
+/**
+ * Writes the pending data & stops the writer thread
+ */
+IO::RawCapture::~RawCapture()
+{
+  closeFile();
+
+  // Wait until the worker has written all the pending data
+  QMetaObject::invokeMethod(
+      m_worker, [] {}, Qt::BlockingQueuedConnection);
+
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+IO::RawCapture &IO::RawCapture::instance()
+{
+  static RawCapture singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if received data is written to capture files
+ */
+bool IO::RawCapture::enabled() const
+{
+  return m_enabled;
+}
+
+/**
+ * Returns the directory in which the capture files are created
+ */
+QString IO::RawCapture::directory() const
+{
+  return QString("%1/Documents/%2/Raw Captures")
+      .arg(QDir::homePath(), qApp->applicationName());
+}
+
+/**
+ * Returns the path of the file that is currently being written, or an empty
+ * string if no file is open.
+ */
+QString IO::RawCapture::currentFile() const
+{
+  return m_currentFile;
+}
+
+/**
+ * Writes the pending data & the index of the current capture file & closes
+ * it, the file is closed by the worker thread once it has written all the
+ * pending data.
+ */
+void IO::RawCapture::closeFile()
+{
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->close(); });
+}
+
+/**
+ * Opens the capture directory in the Explorer/Finder window
+ */
+void IO::RawCapture::openDirectory()
+{
+  QDir().mkpath(directory());
+  QDesktopServices::openUrl(QUrl::fromLocalFile(directory()));
+}
+
+/**
+ * Enables or disables capturing of the received data
+ */
+void IO::RawCapture::setEnabled(const bool enabled)
+{
+  if (m_enabled != enabled)
+  {
+    m_enabled = enabled;
+    m_settings.setValue("RawCapture_Enabled", enabled);
+    if (!enabled)
+      closeFile();
+
+    Q_EMIT enabledChanged();
+  }
+}
+
+/**
+ * Disables capturing & notifies the user if a capture file cannot be created
+ */
+void IO::RawCapture::onOpenFailed(const QString &path)
+{
+  setEnabled(false);
+  Misc::Utilities::showMessageBox(tr("Cannot create raw capture file"),
+                                  tr("Check the permissions of \"%1\"")
+                                      .arg(QFileInfo(path).absolutePath()));
+}
+
+/**
+ * Updates the path of the capture file that is currently being written
+ */
+void IO::RawCapture::onFileChanged(const QString &path)
+{
+  m_currentFile = path;
+  Q_EMIT currentFileChanged();
+}
+
+/**
+ * Hands the received @a data over to the worker thread, together with the
+ * monotonic time at which it was received. Data that is being replayed from
+ * a capture file is not captured again.
+ */
+void IO::RawCapture::onDataReceived(const QByteArray &data,
+                                    const qint64 timestamp)
+{
+  // Capture disabled
+  if (!m_enabled || data.isEmpty())
+    return;
+
+  // Do not capture replayed data
+  auto &io = IO::Manager::instance();
+  if (io.selectedDriver() == IO::Manager::SelectedDriver::Replay)
+    return;
+
+  // Storage device cannot keep up with the incoming data
+  if (m_queuedBytes + data.size() > MAX_QUEUED_BYTES)
+    return;
+
+  // Write data from the worker thread
+  auto worker = m_worker;
+  auto queued = &m_queuedBytes;
+  *queued += data.size();
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->write(data, timestamp);
+    *queued -= data.size();
+  });
+}
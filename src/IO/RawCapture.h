@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <QFile>
+#include <QTimer>
+#include <QThread>
+#include <QObject>
+#include <QVector>
+
+#include <IO/RawCaptureFile.h>
+#include <Misc/Settings.h>
+
+namespace IO
+{
+/**
+ * @brief The RawCaptureWorker class
+ *
+ * Worker object of the @c RawCapture class, runs in its own thread & writes
+ * the received chunks to the current capture file.
+ *
+ * Chunks are accumulated in a memory buffer that is written to the file once
+ * per second or when it is full. The index of the chunks is kept in memory &
+ * written at the end of the file when the capture is closed.
+ */
+class RawCaptureWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void openFailed(const QString &path);
+  void fileChanged(const QString &path);
+
+public:
+  RawCaptureWorker();
+  ~RawCaptureWorker();
+
+public Q_SLOTS:
+  void close();
+  void flush();
+  void setDirectory(const QString &directory);
+  void write(const QByteArray &data, const qint64 timestamp);
+
+private:
+  bool openFile();
+
+private:
+  bool m_failed;
+  qint64 m_offset;
+
+  QFile m_file;
+  QString m_directory;
+  QByteArray m_buffer;
+  QTimer *m_flushTimer;
+  QVector<RawCaptureFile::Entry> m_index;
+};
+
+/**
+ * @brief The RawCapture class
+ *
+ * Records the data received by the selected driver to raw capture files (see
+ * @c RawCaptureFile) exactly as it is delivered by the driver, before any
+ * framing, checksum or parsing takes place. A new file is created for each
+ * connection.
+ *
+ * Captures can be replayed later with the @c Drivers::Replay driver, which
+ * makes it possible to reproduce framing & parser bugs, and to measure the
+ * performance of the pipeline with real traffic. Disk I/O is done by a
+ * @c RawCaptureWorker in a background thread.
+ */
+class RawCapture : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(QString currentFile
+               READ currentFile
+               NOTIFY currentFileChanged)
+    Q_PROPERTY(QString directory
+               READ directory
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void currentFileChanged();
+
+private:
+  explicit RawCapture();
+  RawCapture(RawCapture &&) = delete;
+  RawCapture(const RawCapture &) = delete;
+  RawCapture &operator=(RawCapture &&) = delete;
+  RawCapture &operator=(const RawCapture &) = delete;
+
+  ~RawCapture();
+
+public:
+  static RawCapture &instance();
+
+  bool enabled() const;
+  QString directory() const;
+  QString currentFile() const;
+
+public Q_SLOTS:
+  void closeFile();
+  void openDirectory();
+  void setEnabled(const bool enabled);
+
+private Q_SLOTS:
+  void onOpenFailed(const QString &path);
+  void onFileChanged(const QString &path);
+  void onDataReceived(const QByteArray &data, const qint64 timestamp);
+
+private:
+  bool m_enabled;
+  QString m_currentFile;
+  Misc::Settings m_settings;
+  std::atomic<qint64> m_queuedBytes;
+
+  QThread m_thread;
+  RawCaptureWorker *m_worker;
+};
+} // namespace IO
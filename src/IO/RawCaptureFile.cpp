@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QtEndian>
+
+#include <IO/RawCaptureFile.h>
+
+/**
+ * Signatures & version of the raw capture format
+ */
+static const char HEADER_MAGIC[] = "SSRAWCAP";
+static const char TRAILER_MAGIC[] = "SSRAWIDX";
+static const quint32 FORMAT_VERSION = 1;
+
+/**
+ * Sizes (in bytes) of the fixed-size structures of the format
+ */
+static const int HEADER_SIZE = 16;
+static const int CHUNK_HEADER_SIZE = 12;
+static const int ENTRY_SIZE = 16;
+static const int TRAILER_SIZE = 24;
+
+/**
+ * Largest chunk accepted when the index of a capture is rebuilt, used to stop
+ * scanning when the end of a truncated file contains garbage.
+ */
+static const qint64 MAX_CHUNK_SIZE = 64 * 1024 * 1024;
+
+/**
+ * Appends the given @a value to @a buffer in little-endian byte order
+ */
+template<typename T>
+static void APPEND(QByteArray &buffer, const T value)
+{
+  char bytes[sizeof(T)];
+  qToLittleEndian<T>(value, bytes);
+  buffer.append(bytes, sizeof(T));
+}
+
+/**
+ * Reads a little-endian value of type @c T from the given @a data
+ */
+template<typename T>
+static T READ(const char *data)
+{
+  return qFromLittleEndian<T>(data);
+}
+
+/**
+ * Constructor function
+ */
+IO::RawCaptureFile::RawCaptureFile()
+  : m_totalBytes(0)
+{
+}
+
+/**
+ * Closes the capture file & clears its index
+ */
+void IO::RawCaptureFile::close()
+{
+  m_file.close();
+  m_index.clear();
+  m_totalBytes = 0;
+}
+
+/**
+ * Returns @c true if a capture file is open for reading
+ */
+bool IO::RawCaptureFile::isOpen() const
+{
+  return m_file.isOpen();
+}
+
+/**
+ * Returns the path of the capture file
+ */
+QString IO::RawCaptureFile::fileName() const
+{
+  return m_file.fileName();
+}
+
+/**
+ * Opens the capture file at the given @a path for reading & loads its index.
+ *
+ * @return @c false if the file cannot be read or is not a raw capture, the
+ *         reason is written to @a error (if not null).
+ */
+bool IO::RawCaptureFile::open(const QString &path, QString *error)
+{
+  // Open the file
+  close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly))
+  {
+    if (error)
+      *error = m_file.errorString();
+
+    return false;
+  }
+
+  // Validate the header
+  const auto header = m_file.read(HEADER_SIZE);
+  if (header.size() != HEADER_SIZE
+      || memcmp(header.constData(), HEADER_MAGIC, 8) != 0
+      || READ<quint32>(header.constData() + 8) != FORMAT_VERSION)
+  {
+    if (error)
+      *error = QStringLiteral("not a raw capture file");
+
+    close();
+    return false;
+  }
+
+  // Load the index, or rebuild it if the capture was not closed
+  if (!readIndex() && !rebuildIndex())
+  {
+    if (error)
+      *error = QStringLiteral("the capture file is corrupted");
+
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Returns the number of chunks stored in the capture
+ */
+int IO::RawCaptureFile::chunkCount() const
+{
+  return m_index.count();
+}
+
+/**
+ * Returns the time (in microseconds) between the first & the last chunk
+ */
+qint64 IO::RawCaptureFile::duration() const
+{
+  if (m_index.count() < 2)
+    return 0;
+
+  return m_index.last().timestamp - m_index.first().timestamp;
+}
+
+/**
+ * Returns the number of data bytes stored in the capture
+ */
+qint64 IO::RawCaptureFile::totalBytes() const
+{
+  return m_totalBytes;
+}
+
+/**
+ * Returns the reception time of the given @a chunk
+ */
+qint64 IO::RawCaptureFile::timestamp(const int chunk) const
+{
+  return m_index.at(chunk).timestamp;
+}
+
+/**
+ * Reads the contents of the given @a chunk into @a data
+ */
+bool IO::RawCaptureFile::read(const int chunk, QByteArray &data)
+{
+  // Validate arguments
+  if (chunk < 0 || chunk >= m_index.count())
+    return false;
+
+  // Read chunk header
+  if (!m_file.seek(m_index.at(chunk).offset))
+    return false;
+
+  char header[CHUNK_HEADER_SIZE];
+  if (m_file.read(header, CHUNK_HEADER_SIZE) != CHUNK_HEADER_SIZE)
+    return false;
+
+  // Read chunk data
+  const auto length = READ<quint32>(header + 8);
+  data.resize(static_cast<int>(length));
+  return m_file.read(data.data(), length) == static_cast<qint64>(length);
+}
+
+/**
+ * Returns the header written at the beginning of every capture file
+ */
+QByteArray IO::RawCaptureFile::header()
+{
+  QByteArray buffer(HEADER_MAGIC, 8);
+  APPEND<quint32>(buffer, FORMAT_VERSION);
+  APPEND<quint32>(buffer, 0);
+  return buffer;
+}
+
+/**
+ * Appends a chunk with the given @a data, received at the given @a timestamp
+ * to the @a buffer that is written to the capture file.
+ */
+void IO::RawCaptureFile::appendChunk(QByteArray &buffer, const QByteArray &data,
+                                     const qint64 timestamp)
+{
+  APPEND<qint64>(buffer, timestamp);
+  APPEND<quint32>(buffer, static_cast<quint32>(data.size()));
+  buffer.append(data);
+}
+
+/**
+ * Returns the @a index & trailer written at the end of a capture file, the
+ * index begins at the given @a indexOffset of the file.
+ */
+QByteArray IO::RawCaptureFile::trailer(const QVector<Entry> &index,
+                                       const qint64 indexOffset)
+{
+  QByteArray buffer;
+  buffer.reserve(index.count() * ENTRY_SIZE + TRAILER_SIZE);
+  for (int i = 0; i < index.count(); ++i)
+  {
+    APPEND<qint64>(buffer, index.at(i).timestamp);
+    APPEND<qint64>(buffer, index.at(i).offset);
+  }
+
+  APPEND<qint64>(buffer, indexOffset);
+  APPEND<qint64>(buffer, index.count());
+  buffer.append(TRAILER_MAGIC, 8);
+  return buffer;
+}
+
+/**
+ * Loads the index written at the end of the capture file
+ */
+bool IO::RawCaptureFile::readIndex()
+{
+  // Read the trailer
+  const auto size = m_file.size();
+  if (size < HEADER_SIZE + TRAILER_SIZE || !m_file.seek(size - TRAILER_SIZE))
+    return false;
+
+  const auto trailer = m_file.read(TRAILER_SIZE);
+  if (trailer.size() != TRAILER_SIZE
+      || memcmp(trailer.constData() + 16, TRAILER_MAGIC, 8) != 0)
+    return false;
+
+  // Validate the location of the index
+  const auto offset = READ<qint64>(trailer.constData());
+  const auto count = READ<qint64>(trailer.constData() + 8);
+  if (offset < HEADER_SIZE || count < 0
+      || offset + count * ENTRY_SIZE + TRAILER_SIZE != size)
+    return false;
+
+  // Read the index entries
+  if (!m_file.seek(offset))
+    return false;
+
+  const auto entries = m_file.read(count * ENTRY_SIZE);
+  if (entries.size() != count * ENTRY_SIZE)
+    return false;
+
+  m_index.resize(static_cast<int>(count));
+  for (int i = 0; i < m_index.count(); ++i)
+  {
+    const char *entry = entries.constData() + i * ENTRY_SIZE;
+    m_index[i].timestamp = READ<qint64>(entry);
+    m_index[i].offset = READ<qint64>(entry + 8);
+  }
+
+  // Obtain the number of data bytes
+  m_totalBytes = offset - HEADER_SIZE - count * CHUNK_HEADER_SIZE;
+  return true;
+}
+
+/**
+ * Builds the index of a capture that was not closed properly by reading the
+ * header of each chunk, an incomplete chunk at the end of the file is ignored.
+ */
+bool IO::RawCaptureFile::rebuildIndex()
+{
+  m_index.clear();
+  m_totalBytes = 0;
+
+  const auto size = m_file.size();
+  qint64 offset = HEADER_SIZE;
+  char header[CHUNK_HEADER_SIZE];
+  while (offset + CHUNK_HEADER_SIZE <= size)
+  {
+    // Read chunk header
+    if (!m_file.seek(offset)
+        || m_file.read(header, CHUNK_HEADER_SIZE) != CHUNK_HEADER_SIZE)
+      break;
+
+    // Stop at incomplete or invalid chunks
+    const qint64 length = READ<quint32>(header + 8);
+    if (length > MAX_CHUNK_SIZE
+        || offset + CHUNK_HEADER_SIZE + length > size)
+      break;
+
+    // Register the chunk
+    Entry entry;
+    entry.offset = offset;
+    entry.timestamp = READ<qint64>(header);
+    m_index.append(entry);
+    m_totalBytes += length;
+    offset += CHUNK_HEADER_SIZE + length;
+  }
+
+  return m_file.seek(HEADER_SIZE);
+}
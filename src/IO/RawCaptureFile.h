@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+
+namespace IO
+{
+/**
+ * @brief The RawCaptureFile class
+ *
+ * Reads & writes raw capture files, which store every chunk of data delivered
+ * by a driver exactly as it was received, together with the monotonic time
+ * at which it was read (see @c IO::FrameQueue::timestamp()). Unlike CSV files,
+ * raw captures can be replayed through the complete frame pipeline (framing,
+ * checksums & frame parser), see @c IO::Drivers::Replay.
+ *
+ * All integers are stored in little-endian byte order:
+ *
+ * @code
+ * header:  "SSRAWCAP" | version (u32) | reserved (u32)
+ * chunk:   timestamp (i64, us) | length (u32) | data
+ * index:   { timestamp (i64) | file offset (i64) } for each chunk
+ * trailer: index offset (i64) | chunk count (i64) | "SSRAWIDX"
+ * @endcode
+ *
+ * The index & trailer are written when the capture is closed. If a capture
+ * is not closed properly (e.g. the application crashed), the index is
+ * rebuilt by scanning the chunks when the file is opened.
+ */
+class RawCaptureFile
+{
+public:
+  struct Entry
+  {
+    qint64 timestamp;
+    qint64 offset;
+  };
+
+  RawCaptureFile();
+
+  void close();
+  bool isOpen() const;
+  QString fileName() const;
+  bool open(const QString &path, QString *error = Q_NULLPTR);
+
+  int chunkCount() const;
+  qint64 duration() const;
+  qint64 totalBytes() const;
+  qint64 timestamp(const int chunk) const;
+  bool read(const int chunk, QByteArray &data);
+
+  static QByteArray header();
+  static void appendChunk(QByteArray &buffer, const QByteArray &data,
+                          const qint64 timestamp);
+  static QByteArray trailer(const QVector<Entry> &index,
+                            const qint64 indexOffset);
+
+private:
+  bool readIndex();
+  bool rebuildIndex();
+
+private:
+  QFile m_file;
+  qint64 m_totalBytes;
+  QVector<Entry> m_index;
+};
+} // namespace IO
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QRandomGenerator>
+
+#include <IO/ReconnectManager.h>
+
+/**
+ * Delay (in milliseconds) of the second reconnection attempt, the first
+ * attempt is made immediately
+ */
+static const int BASE_DELAY = 250;
+
+/**
+ * Maximum delay (in milliseconds) between reconnection attempts
+ */
+static const int MAX_DELAY = 10 * 1000;
+
+/**
+ * Time (in milliseconds) that a link must stay up to reset the backoff
+ */
+static const qint64 STABLE_TIME = 5 * 1000;
+
+/**
+ * Constructor function
+ */
+IO::ReconnectManager::ReconnectManager(QObject *parent)
+  : QObject(parent)
+  , m_active(false)
+  , m_attempts(0)
+  , m_linkUp(false)
+  , m_established(false)
+{
+  m_timer.setSingleShot(true);
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this,
+          &IO::ReconnectManager::reconnectRequested);
+}
+
+/**
+ * Returns @c true while the link is down & a reconnection attempt is pending
+ * or in progress
+ */
+bool IO::ReconnectManager::active() const
+{
+  return m_active;
+}
+
+/**
+ * Returns the number of reconnection attempts made since the link was last
+ * stable
+ */
+int IO::ReconnectManager::attempts() const
+{
+  return m_attempts;
+}
+
+/**
+ * Returns @c true if the link was established since the last @c reset()
+ */
+bool IO::ReconnectManager::established() const
+{
+  return m_established;
+}
+
+/**
+ * Cancels the pending attempts & forgets the established link, this function
+ * is called when the user closes the connection or selects another device.
+ */
+void IO::ReconnectManager::reset()
+{
+  m_timer.stop();
+  m_attempts = 0;
+  m_linkUp = false;
+  m_established = false;
+  setActive(false);
+}
+
+/**
+ * Registers that the link is established, the backoff is reset once the
+ * link stays up for @c STABLE_TIME milliseconds.
+ */
+void IO::ReconnectManager::linkUp()
+{
+  m_timer.stop();
+  m_uptime.start();
+  m_linkUp = true;
+  m_established = true;
+  setActive(false);
+}
+
+/**
+ * Registers that the link is down & schedules the next reconnection attempt,
+ * unless an attempt is already scheduled or the link was never established.
+ */
+void IO::ReconnectManager::linkDown()
+{
+  // Nothing to restore or attempt already scheduled
+  if (!m_established || m_timer.isActive())
+    return;
+
+  // Reset the backoff if the link was stable
+  if (m_linkUp && m_uptime.elapsed() >= STABLE_TIME)
+    m_attempts = 0;
+
+  // Schedule the next attempt
+  m_linkUp = false;
+  m_timer.start(nextDelay());
+  ++m_attempts;
+  setActive(true);
+}
+
+/**
+ * Returns the delay (in milliseconds) of the next reconnection attempt
+ */
+int IO::ReconnectManager::nextDelay() const
+{
+  // First attempt is made immediately
+  if (m_attempts <= 0)
+    return 0;
+
+  // Exponential backoff, the shift is limited to avoid overflows
+  const int shift = qMin(m_attempts - 1, 16);
+  const int delay = qMin(MAX_DELAY, BASE_DELAY << shift);
+
+  // Add +/- 25% of jitter
+  const int jitter = delay / 4;
+  const int offset = QRandomGenerator::global()->bounded(2 * jitter + 1);
+  return qMax(0, delay - jitter + offset);
+}
+
+/**
+ * Changes the state reported by @c active()
+ */
+void IO::ReconnectManager::setActive(const bool active)
+{
+  if (m_active != active)
+  {
+    m_active = active;
+    Q_EMIT activeChanged();
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QElapsedTimer>
+
+namespace IO
+{
+/**
+ * @brief The ReconnectManager class
+ *
+ * Schedules the attempts to restore the connection of the I/O manager after
+ * the link with the device is lost (e.g. a TCP peer restarts or a USB cable
+ * is unplugged for a moment).
+ *
+ * The first attempt is made immediately, the following attempts are delayed
+ * with an exponential backoff (250 ms, 500 ms, 1 s... up to 10 s) with a
+ * random jitter of +/- 25%, so that many instances that lose the same server
+ * do not reconnect in lockstep. The attempt counter is only reset once the
+ * link stays up for a few seconds, which avoids hammering a device that
+ * accepts connections & drops them immediately.
+ *
+ * Attempts are only scheduled for links that were established at least once
+ * since the last call to @c reset(), a device that was never opened is not
+ * retried.
+ */
+class ReconnectManager : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void activeChanged();
+  void reconnectRequested();
+
+public:
+  explicit ReconnectManager(QObject *parent = Q_NULLPTR);
+
+  bool active() const;
+  int attempts() const;
+  bool established() const;
+
+public Q_SLOTS:
+  void reset();
+  void linkUp();
+  void linkDown();
+
+private:
+  int nextDelay() const;
+  void setActive(const bool active);
+
+private:
+  bool m_active;
+  int m_attempts;
+  bool m_linkUp;
+  bool m_established;
+
+  QTimer m_timer;
+  QElapsedTimer m_uptime;
+};
+} // namespace IO
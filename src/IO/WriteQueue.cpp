@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <IO/HAL_Driver.h>
+#include <IO/WriteQueue.h>
+
+/**
+ * Maximum number of bytes that can be waiting in the queue, data is rejected
+ * once this limit is reached.
+ */
+static const qint64 MAX_QUEUED_BYTES = 16 * 1024 * 1024;
+
+/**
+ * Interval (in milliseconds) at which queued data is written to the driver
+ */
+static const int WRITE_INTERVAL = 5;
+
+/**
+ * XON & XOFF control characters used by software flow control
+ */
+static const char XON = 0x11;
+static const char XOFF = 0x13;
+
+/**
+ * Constructor function, configures the write timer
+ */
+IO::WriteQueue::WriteQueue(QObject *parent)
+  : QObject(parent)
+  , m_driver(Q_NULLPTR)
+  , m_queuedBytes(0)
+  , m_rejectedBytes(0)
+  , m_xoff(false)
+  , m_maxInFlight(16 * 1024)
+  , m_pacingRate(0)
+  , m_softwareFlowControl(false)
+  , m_tokens(0)
+{
+  m_timer.setInterval(WRITE_INTERVAL);
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this, &IO::WriteQueue::writeChunks);
+}
+
+/**
+ * Returns @c true if the device has paused the transmission with XOFF
+ */
+bool IO::WriteQueue::paused() const
+{
+  return m_xoff;
+}
+
+/**
+ * Returns the number of bytes waiting to be written to the driver
+ */
+qint64 IO::WriteQueue::queuedBytes() const
+{
+  return m_queuedBytes;
+}
+
+/**
+ * Returns the number of bytes that were rejected because the queue was full
+ */
+quint64 IO::WriteQueue::rejectedBytes() const
+{
+  return m_rejectedBytes;
+}
+
+/**
+ * Returns the maximum number of bytes that can be in flight, 0 means that
+ * the number of bytes in flight is not limited.
+ */
+int IO::WriteQueue::maxInFlight() const
+{
+  return m_maxInFlight;
+}
+
+/**
+ * Returns the maximum average throughput in bytes per second, 0 means that
+ * data is not paced.
+ */
+int IO::WriteQueue::pacingRate() const
+{
+  return m_pacingRate;
+}
+
+/**
+ * Returns @c true if XON/XOFF characters received from the device pause &
+ * resume the transmission.
+ */
+bool IO::WriteQueue::softwareFlowControl() const
+{
+  return m_softwareFlowControl;
+}
+
+/**
+ * Appends the given @a data to the queue & writes as much of it as allowed
+ * by the flow control settings.
+ *
+ * @returns the number of queued bytes, or -1 if no driver is set or the queue
+ *          is full.
+ */
+qint64 IO::WriteQueue::enqueue(const QByteArray &data)
+{
+  // No device to write to
+  if (!m_driver)
+    return -1;
+
+  // Nothing to write
+  if (data.isEmpty())
+    return 0;
+
+  // Queue is full, reject data
+  if (m_queuedBytes + data.size() > MAX_QUEUED_BYTES)
+  {
+    m_rejectedBytes += data.size();
+    return -1;
+  }
+
+  // Queue data & write it
+  m_queue.enqueue(data);
+  m_queuedBytes += data.size();
+  writeChunks();
+  return data.size();
+}
+
+/**
+ * Scans the given @a data received from the device for XON/XOFF characters,
+ * the last character received determines if the transmission is paused.
+ */
+void IO::WriteQueue::processReceivedData(const QByteArray &data)
+{
+  if (!m_softwareFlowControl)
+    return;
+
+  // Find the last flow control character
+  for (int i = data.size() - 1; i >= 0; --i)
+  {
+    const char c = data.at(i);
+    if (c == XON || c == XOFF)
+    {
+      m_xoff = (c == XOFF);
+      break;
+    }
+  }
+
+  // Resume transmission
+  if (!m_xoff && !m_queue.isEmpty())
+    writeChunks();
+}
+
+/**
+ * Discards all the queued data & resets the flow control state
+ */
+void IO::WriteQueue::clear()
+{
+  m_timer.stop();
+  m_queue.clear();
+  m_queuedBytes = 0;
+  m_xoff = false;
+  m_tokens = 0;
+}
+
+/**
+ * Changes the @a driver to which data is written, queued data is discarded
+ */
+void IO::WriteQueue::setDriver(IO::HAL_Driver *driver)
+{
+  clear();
+  m_driver = driver;
+}
+
+/**
+ * Changes the maximum number of @a bytes that can be in flight
+ */
+void IO::WriteQueue::setMaxInFlight(const int bytes)
+{
+  m_maxInFlight = qMax(0, bytes);
+}
+
+/**
+ * Changes the maximum average throughput, in @a bytesPerSecond
+ */
+void IO::WriteQueue::setPacingRate(const int bytesPerSecond)
+{
+  m_pacingRate = qMax(0, bytesPerSecond);
+  m_tokens = 0;
+  m_clock.start();
+}
+
+/**
+ * Enables or disables pausing the transmission when XOFF is received
+ */
+void IO::WriteQueue::setSoftwareFlowControl(const bool enabled)
+{
+  m_softwareFlowControl = enabled;
+  if (!enabled)
+    m_xoff = false;
+}
+
+/**
+ * Writes queued data to the driver until the queue is empty or the write
+ * budget is exhausted, the timer is kept running while data is queued.
+ */
+void IO::WriteQueue::writeChunks()
+{
+  // Write chunks of queued data
+  auto budget = writeBudget();
+  while (budget > 0 && !m_queue.isEmpty())
+  {
+    // Write (part of) the oldest block
+    auto &head = m_queue.head();
+    const auto length = static_cast<int>(qMin<qint64>(budget, head.size()));
+    const auto chunk = length == head.size() ? head : head.left(length);
+    const auto written = static_cast<qint64>(m_driver->write(chunk));
+    if (written <= 0 || written > length)
+      break;
+
+    // Update the queue
+    if (written == head.size())
+      m_queue.dequeue();
+    else
+      head.remove(0, static_cast<int>(written));
+
+    m_queuedBytes -= written;
+    budget -= written;
+    if (m_pacingRate > 0)
+      m_tokens -= written;
+
+    // Notify the rest of the application
+    const auto size = static_cast<int>(written);
+    Q_EMIT dataWritten(size == chunk.size() ? chunk : chunk.left(size));
+  }
+
+  // Keep writing until the queue is empty
+  if (m_queue.isEmpty())
+    m_timer.stop();
+  else if (!m_timer.isActive())
+    m_timer.start();
+}
+
+/**
+ * Returns the number of bytes that can be written to the driver right now,
+ * according to the flow control state, the bytes in flight & the pacing
+ * rate.
+ */
+qint64 IO::WriteQueue::writeBudget()
+{
+  // Transmission paused
+  if (!m_driver || m_xoff || !m_driver->clearToSend())
+    return 0;
+
+  // Limit the number of bytes in flight
+  qint64 budget = m_queuedBytes;
+  if (m_maxInFlight > 0)
+    budget = qMin(budget, m_maxInFlight - m_driver->bytesToWrite());
+
+  // Refill the token bucket, at most 100 ms worth of data can be written
+  // in a single burst
+  if (m_pacingRate > 0)
+  {
+    if (!m_clock.isValid())
+      m_clock.start();
+
+    const double burst = qMax(1.0, m_pacingRate / 10.0);
+    m_tokens += m_pacingRate * (m_clock.restart() / 1000.0);
+    m_tokens = qMin(m_tokens, burst);
+    budget = qMin(budget, static_cast<qint64>(m_tokens));
+  }
+
+  return budget;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QQueue>
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+namespace IO
+{
+class HAL_Driver;
+
+/**
+ * @brief The WriteQueue class
+ *
+ * Outgoing queue of the I/O manager. Data written by the console, the
+ * plugins or any other module is appended to the queue & written to the
+ * driver in chunks by a timer, so that large blocks (e.g. configuration
+ * blobs sent by a plugin) never block the user interface or overrun the
+ * receive buffer of small devices.
+ *
+ * The amount of data handed over to the driver is limited by:
+ * - The maximum number of bytes in flight, i.e. written to the driver but
+ *   not yet transmitted by it (see @c HAL_Driver::bytesToWrite()).
+ * - The pacing rate, a token bucket that limits the average throughput to
+ *   the given number of bytes per second.
+ * - Flow control: nothing is written while the driver reports that the
+ *   device is not ready (e.g. CTS is de-asserted, see
+ *   @c HAL_Driver::clearToSend()) or, if software flow control is enabled,
+ *   after the device sends XOFF & until it sends XON.
+ *
+ * If the queue holds too much data, new data is rejected & counted, so that
+ * a misbehaving plugin cannot exhaust the memory of the application.
+ */
+class WriteQueue : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void dataWritten(const QByteArray &data);
+
+public:
+  explicit WriteQueue(QObject *parent = Q_NULLPTR);
+
+  bool paused() const;
+  qint64 queuedBytes() const;
+  quint64 rejectedBytes() const;
+
+  int maxInFlight() const;
+  int pacingRate() const;
+  bool softwareFlowControl() const;
+
+  qint64 enqueue(const QByteArray &data);
+  void processReceivedData(const QByteArray &data);
+
+public Q_SLOTS:
+  void clear();
+  void setDriver(IO::HAL_Driver *driver);
+  void setMaxInFlight(const int bytes);
+  void setPacingRate(const int bytesPerSecond);
+  void setSoftwareFlowControl(const bool enabled);
+
+private Q_SLOTS:
+  void writeChunks();
+
+private:
+  qint64 writeBudget();
+
+private:
+  HAL_Driver *m_driver;
+  QQueue<QByteArray> m_queue;
+  qint64 m_queuedBytes;
+  quint64 m_rejectedBytes;
+
+  bool m_xoff;
+  int m_maxInFlight;
+  int m_pacingRate;
+  bool m_softwareFlowControl;
+
+  double m_tokens;
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+};
+} // namespace IO
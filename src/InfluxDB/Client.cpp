@@ -0,0 +1,703 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QUrl>
+#include <QtEndian>
+#include <QtNumeric>
+#include <QUrlQuery>
+#include <QNetworkRequest>
+
+#include <IO/Checksum.h>
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
+#include <InfluxDB/Client.h>
+
+/**
+ * Minimum & maximum delay between two attempts to write a batch that could
+ * not be written because of a network or server error
+ */
+#define MIN_RETRY_DELAY_MS 500
+#define MAX_RETRY_DELAY_MS 30000
+
+/**
+ * Constructor function, reads the settings & registers the client in the
+ * sink graph of the JSON generator.
+ */
+InfluxDB::Client::Client()
+  : m_flushScheduled(false)
+  , m_spooledBytes(0)
+  , m_droppedBatches(0)
+  , m_retryDelay(0)
+  , m_reply(Q_NULLPTR)
+{
+  // Read settings
+  m_enabled = m_settings.value("InfluxDB_Enabled", false).toBool();
+  m_url = m_settings.value("InfluxDB_Url", "http://localhost:8086").toString();
+  m_organization = m_settings.value("InfluxDB_Organization").toString();
+  m_bucket = m_settings.value("InfluxDB_Bucket").toString();
+  m_token = m_settings.value("InfluxDB_Token").toString();
+  m_measurement = m_settings.value("InfluxDB_Measurement").toString();
+  m_gzipEnabled = m_settings.value("InfluxDB_Gzip", true).toBool();
+  m_maxLatency = m_settings.value("InfluxDB_MaxLatency", 1000).toInt();
+  m_maxBatchBytes = m_settings.value("InfluxDB_MaxBatch", 512 * 1024).toInt();
+  m_spoolLimit = m_settings.value("InfluxDB_SpoolLimit", 64).toInt();
+
+  // Configure timers
+  m_retryTimer.setSingleShot(true);
+  m_latencyTimer.setInterval(qMax(1, m_maxLatency));
+  m_latencyTimer.setTimerType(Qt::PreciseTimer);
+  connect(&m_retryTimer, &QTimer::timeout, this,
+          &InfluxDB::Client::sendNextBatch);
+  connect(&m_latencyTimer, &QTimer::timeout, this, &InfluxDB::Client::flush);
+  if (m_enabled)
+    m_latencyTimer.start();
+
+  // Lines are formatted in the worker pool of the sink graph
+  JSON::Generator::instance().sinks().addSink(
+      this, JSON::SinkGraph::Port::Frames,
+      JSON::SinkGraph::Affinity::WorkerPool);
+}
+
+/**
+ * Returns a pointer to the only instance of this class
+ */
+InfluxDB::Client &InfluxDB::Client::instance()
+{
+  static Client singleton;
+  return singleton;
+}
+
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString InfluxDB::Client::sinkName() const
+{
+  return QStringLiteral("InfluxDB::Client");
+}
+
+/**
+ * Converts the given @a frames to line protocol & appends them to the current
+ * batch. If the batch is full, it is sent from the main thread.
+ *
+ * @note This function is called by the worker pool of the sink graph.
+ */
+void InfluxDB::Client::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  QMutexLocker locker(&m_mutex);
+  if (!m_enabled)
+    return;
+
+  for (const auto &frame : frames)
+    appendFrame(frame);
+
+  if (m_batch.size() >= m_maxBatchBytes && !m_flushScheduled)
+  {
+    m_flushScheduled = true;
+    QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+  }
+}
+
+/**
+ * Returns @c true if frames are written to the database
+ */
+bool InfluxDB::Client::enabled() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_enabled;
+}
+
+/**
+ * Returns the base URL of the server (e.g. http://localhost:8086)
+ */
+QString InfluxDB::Client::url() const
+{
+  return m_url;
+}
+
+/**
+ * Returns the organization that owns the destination bucket
+ */
+QString InfluxDB::Client::organization() const
+{
+  return m_organization;
+}
+
+/**
+ * Returns the name of the bucket in which data is written
+ */
+QString InfluxDB::Client::bucket() const
+{
+  return m_bucket;
+}
+
+/**
+ * Returns the API token used to authenticate with the server
+ */
+QString InfluxDB::Client::token() const
+{
+  return m_token;
+}
+
+/**
+ * Returns the measurement name of the written lines, if empty, the title of
+ * the project is used.
+ */
+QString InfluxDB::Client::measurement() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_measurement;
+}
+
+/**
+ * Returns @c true if batches are compressed with gzip before being sent
+ */
+bool InfluxDB::Client::gzipEnabled() const
+{
+  return m_gzipEnabled;
+}
+
+/**
+ * Returns the interval (in milliseconds) at which pending lines are sent
+ */
+int InfluxDB::Client::maxLatency() const
+{
+  return m_maxLatency;
+}
+
+/**
+ * Returns the size (in bytes) at which a batch is sent without waiting for
+ * the latency timer.
+ */
+int InfluxDB::Client::maxBatchBytes() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_maxBatchBytes;
+}
+
+/**
+ * Returns the maximum size (in megabytes) of the batches that are waiting to
+ * be written.
+ */
+int InfluxDB::Client::spoolLimit() const
+{
+  return m_spoolLimit;
+}
+
+/**
+ * Returns the number of bytes waiting to be written to the server
+ */
+qint64 InfluxDB::Client::spooledBytes() const
+{
+  return m_spooledBytes;
+}
+
+/**
+ * Returns the number of batches that were discarded, either because the spool
+ * was full or because the server rejected them.
+ */
+quint64 InfluxDB::Client::droppedBatches() const
+{
+  return m_droppedBatches;
+}
+
+/**
+ * Returns a description of the last write error, or an empty string if the
+ * last batch was written successfully.
+ */
+QString InfluxDB::Client::lastError() const
+{
+  return m_lastError;
+}
+
+/**
+ * Moves the current batch to the spool & sends it if no other request is in
+ * progress.
+ */
+void InfluxDB::Client::flush()
+{
+  // Take the current batch
+  QByteArray batch;
+  {
+    QMutexLocker locker(&m_mutex);
+    m_flushScheduled = false;
+    batch.swap(m_batch);
+  }
+
+  // Spool the batch & write it to the server
+  if (!batch.isEmpty())
+  {
+    spoolBatch(batch);
+    sendNextBatch();
+  }
+}
+
+/**
+ * Enables or disables writing frames to the database. When disabled, the
+ * lines that have not been written yet are discarded.
+ */
+void InfluxDB::Client::setEnabled(const bool enabled)
+{
+  // Update the state
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_enabled == enabled)
+      return;
+
+    m_enabled = enabled;
+    m_batch.clear();
+  }
+
+  // Start writing data
+  if (enabled)
+    m_latencyTimer.start();
+
+  // Stop writing data & discard pending batches
+  else
+  {
+    m_latencyTimer.stop();
+    m_retryTimer.stop();
+    if (m_reply)
+      m_reply->abort();
+
+    m_spool.clear();
+    m_spooledBytes = 0;
+    m_retryDelay = 0;
+    setLastError(QString());
+  }
+
+  m_settings.setValue("InfluxDB_Enabled", enabled);
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Changes the base @a url of the server
+ */
+void InfluxDB::Client::setUrl(const QString &url)
+{
+  const auto value = url.simplified();
+  if (m_url != value)
+  {
+    m_url = value;
+    m_settings.setValue("InfluxDB_Url", value);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the @a organization that owns the destination bucket
+ */
+void InfluxDB::Client::setOrganization(const QString &organization)
+{
+  if (m_organization != organization)
+  {
+    m_organization = organization;
+    m_settings.setValue("InfluxDB_Organization", organization);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the name of the destination @a bucket
+ */
+void InfluxDB::Client::setBucket(const QString &bucket)
+{
+  if (m_bucket != bucket)
+  {
+    m_bucket = bucket;
+    m_settings.setValue("InfluxDB_Bucket", bucket);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the API @a token used to authenticate with the server
+ */
+void InfluxDB::Client::setToken(const QString &token)
+{
+  if (m_token != token)
+  {
+    m_token = token;
+    m_settings.setValue("InfluxDB_Token", token);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the @a measurement name of the written lines
+ */
+void InfluxDB::Client::setMeasurement(const QString &measurement)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_measurement == measurement)
+      return;
+
+    m_measurement = measurement;
+  }
+
+  m_settings.setValue("InfluxDB_Measurement", measurement);
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Enables or disables the gzip compression of the written batches
+ */
+void InfluxDB::Client::setGzipEnabled(const bool enabled)
+{
+  if (m_gzipEnabled != enabled)
+  {
+    m_gzipEnabled = enabled;
+    m_settings.setValue("InfluxDB_Gzip", enabled);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the interval (in @a milliseconds) at which pending lines are sent
+ */
+void InfluxDB::Client::setMaxLatency(const int milliseconds)
+{
+  const auto value = qBound(10, milliseconds, 60000);
+  if (m_maxLatency != value)
+  {
+    m_maxLatency = value;
+    m_latencyTimer.setInterval(value);
+    m_settings.setValue("InfluxDB_MaxLatency", value);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the size (in @a bytes) at which a batch is sent without waiting for
+ * the latency timer.
+ */
+void InfluxDB::Client::setMaxBatchBytes(const int bytes)
+{
+  const auto value = qBound(1024, bytes, 16 * 1024 * 1024);
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_maxBatchBytes == value)
+      return;
+
+    m_maxBatchBytes = value;
+  }
+
+  m_settings.setValue("InfluxDB_MaxBatch", value);
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the maximum size (in @a megabytes) of the batches that are waiting
+ * to be written.
+ */
+void InfluxDB::Client::setSpoolLimit(const int megabytes)
+{
+  const auto value = qBound(1, megabytes, 4096);
+  if (m_spoolLimit != value)
+  {
+    m_spoolLimit = value;
+    m_settings.setValue("InfluxDB_SpoolLimit", value);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Sends the oldest batch of the spool to the server, unless a request is
+ * already in progress or the client is waiting to retry a failed write.
+ */
+void InfluxDB::Client::sendNextBatch()
+{
+  // Nothing to do
+  if (m_reply || m_spool.isEmpty() || m_retryTimer.isActive())
+    return;
+
+  // Validate the configuration
+  QUrl url(m_url);
+  if (!url.isValid() || url.host().isEmpty() || m_bucket.isEmpty())
+  {
+    setLastError(tr("Invalid server URL or bucket"));
+    return;
+  }
+
+  // Build the URL of the write endpoint
+  QUrlQuery query;
+  query.addQueryItem(QStringLiteral("org"), m_organization);
+  query.addQueryItem(QStringLiteral("bucket"), m_bucket);
+  query.addQueryItem(QStringLiteral("precision"), QStringLiteral("ms"));
+  auto path = url.path();
+  while (path.endsWith(QLatin1Char('/')))
+    path.chop(1);
+
+  url.setPath(path + QStringLiteral("/api/v2/write"));
+  url.setQuery(query);
+
+  // Build the request
+  QNetworkRequest request(url);
+  request.setHeader(QNetworkRequest::ContentTypeHeader,
+                    QStringLiteral("text/plain; charset=utf-8"));
+  if (!m_token.isEmpty())
+    request.setRawHeader("Authorization", "Token " + m_token.toUtf8());
+
+  // Send the batch, compressing it if required
+  const auto &batch = m_spool.head();
+  if (m_gzipEnabled)
+  {
+    request.setRawHeader("Content-Encoding", "gzip");
+    m_reply = m_network.post(request, gzip(batch));
+  }
+  else
+    m_reply = m_network.post(request, batch);
+
+  connect(m_reply, &QNetworkReply::finished, this,
+          &InfluxDB::Client::onReplyFinished);
+}
+
+/**
+ * Removes the written batch from the spool, or schedules a new attempt to
+ * write it if the server could not process the request.
+ */
+void InfluxDB::Client::onReplyFinished()
+{
+  // Get the reply status
+  auto reply = m_reply;
+  m_reply = Q_NULLPTR;
+  reply->deleteLater();
+  const auto status
+      = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+  // Request was aborted, the spool has already been cleared
+  if (reply->error() == QNetworkReply::OperationCanceledError
+      || m_spool.isEmpty())
+    return;
+
+  // Batch written, continue with the next batch
+  if (status >= 200 && status < 300)
+  {
+    m_spooledBytes -= m_spool.dequeue().size();
+    m_retryDelay = 0;
+    setLastError(QString());
+    sendNextBatch();
+    return;
+  }
+
+  // Server unreachable, overloaded or failing, retry later
+  if (status == 0 || status == 429 || status >= 500)
+  {
+    m_retryDelay = qBound(MIN_RETRY_DELAY_MS, m_retryDelay * 2,
+                          MAX_RETRY_DELAY_MS);
+
+    bool ok;
+    const auto retryAfter = reply->rawHeader("Retry-After").toInt(&ok);
+    if (ok && retryAfter > 0)
+      m_retryDelay = qMin(retryAfter * 1000, MAX_RETRY_DELAY_MS);
+
+    setLastError(reply->errorString());
+    m_retryTimer.start(m_retryDelay);
+    return;
+  }
+
+  // Batch rejected by the server, retrying it would never succeed
+  const auto message = QString::fromUtf8(reply->readAll()).simplified();
+  m_spooledBytes -= m_spool.dequeue().size();
+  ++m_droppedBatches;
+  m_retryDelay = 0;
+  setLastError(tr("HTTP %1: %2").arg(status).arg(message));
+  sendNextBatch();
+}
+
+/**
+ * Appends the given @a batch to the spool, dropping the oldest batches that
+ * are not being written if the spool exceeds its size limit.
+ */
+void InfluxDB::Client::spoolBatch(const QByteArray &batch)
+{
+  m_spool.enqueue(batch);
+  m_spooledBytes += batch.size();
+
+  const qint64 limit = static_cast<qint64>(m_spoolLimit) * 1024 * 1024;
+  const int first = m_reply ? 1 : 0;
+  while (m_spooledBytes > limit && m_spool.size() > first + 1)
+  {
+    m_spooledBytes -= m_spool.at(first).size();
+    m_spool.removeAt(first);
+    ++m_droppedBatches;
+  }
+
+  Q_EMIT statusChanged();
+}
+
+/**
+ * Appends one line per group of the given @a frame to the current batch.
+ *
+ * @note The caller must hold the mutex of the client.
+ */
+void InfluxDB::Client::appendFrame(const JSON::Frame &frame)
+{
+  // Get measurement name & timestamp
+  auto name = m_measurement.isEmpty() ? frame.title() : m_measurement;
+  name.replace(QLatin1Char(','), QLatin1String("\\,"));
+  name.replace(QLatin1Char(' '), QLatin1String("\\ "));
+  name.replace(QLatin1Char('\n'), QLatin1Char(' '));
+  const auto measurement = name.toUtf8();
+  const auto time = QByteArray::number(
+      IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp()));
+
+  // Write one line per group
+  for (int g = 0; g < frame.groupCount(); ++g)
+  {
+    // Write measurement & tags
+    const auto &group = frame.getGroup(g);
+    const int start = m_batch.size();
+    m_batch.append(measurement);
+    if (!group.title().isEmpty())
+    {
+      m_batch.append(",group=");
+      m_batch.append(escapeKey(group.title()));
+    }
+
+    // Write fields
+    int fields = 0;
+    for (int d = 0; d < group.datasetCount(); ++d)
+    {
+      // Skip values that can not be represented as a field
+      const auto &dataset = group.getDataset(d);
+      if (dataset.isNumeric() && !qIsFinite(dataset.numericValue()))
+        continue;
+
+      // Write field key
+      m_batch.append(fields == 0 ? ' ' : ',');
+      if (dataset.title().isEmpty())
+        m_batch.append("dataset" + QByteArray::number(d + 1));
+      else
+        m_batch.append(escapeKey(dataset.title()));
+
+      // Write field value
+      m_batch.append('=');
+      if (dataset.isNumeric())
+        m_batch.append(QByteArray::number(dataset.numericValue(), 'g', 17));
+      else
+        m_batch.append(escapeString(dataset.value()));
+
+      ++fields;
+    }
+
+    // Lines without fields are not valid
+    if (fields == 0)
+    {
+      m_batch.truncate(start);
+      continue;
+    }
+
+    // Write timestamp
+    m_batch.append(' ');
+    m_batch.append(time);
+    m_batch.append('\n');
+  }
+}
+
+/**
+ * Updates the last write @a error & notifies the user interface, which also
+ * refreshes the spool status.
+ */
+void InfluxDB::Client::setLastError(const QString &error)
+{
+  m_lastError = error;
+  Q_EMIT statusChanged();
+}
+
+/**
+ * Compresses the given @a data in the gzip format (RFC 1952).
+ *
+ * The deflate stream is generated with @c qCompress(), which prepends the
+ * uncompressed size (4 bytes) & a zlib header (2 bytes) and appends an
+ * Adler-32 checksum (4 bytes). These are replaced by the gzip header & the
+ * CRC-32 & size trailer.
+ */
+QByteArray InfluxDB::Client::gzip(const QByteArray &data)
+{
+  // Compress the data
+  const auto zlib = qCompress(data, 6);
+  if (zlib.size() < 10)
+    return QByteArray();
+
+  // Write the gzip header
+  static const char header[] = {'\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0,
+                                '\xff'};
+  QByteArray output;
+  output.reserve(zlib.size() + 12);
+  output.append(header, sizeof(header));
+
+  // Write the deflate stream
+  output.append(zlib.constData() + 6, zlib.size() - 10);
+
+  // Write the CRC-32 & the uncompressed size (little endian)
+  char trailer[8];
+  qToLittleEndian<quint32>(IO::crc32(data.constData(), data.size()), trailer);
+  qToLittleEndian<quint32>(static_cast<quint32>(data.size()), trailer + 4);
+  output.append(trailer, sizeof(trailer));
+  return output;
+}
+
+/**
+ * Escapes the given tag or field @a key for the line protocol
+ */
+QByteArray InfluxDB::Client::escapeKey(const QString &key)
+{
+  QByteArray output;
+  const auto utf8 = key.toUtf8();
+  output.reserve(utf8.size() + 4);
+  for (const char c : utf8)
+  {
+    if (c == '\n' || c == '\r')
+      output.append(' ');
+    else if (c == ',' || c == '=' || c == ' ')
+    {
+      output.append('\\');
+      output.append(c);
+    }
+    else
+      output.append(c);
+  }
+
+  return output;
+}
+
+/**
+ * Returns the given @a value as a quoted line protocol string field
+ */
+QByteArray InfluxDB::Client::escapeString(const QString &value)
+{
+  QByteArray output;
+  const auto utf8 = value.toUtf8();
+  output.reserve(utf8.size() + 4);
+  output.append('"');
+  for (const char c : utf8)
+  {
+    if (c == '"' || c == '\\')
+      output.append('\\');
+
+    output.append(c);
+  }
+
+  output.append('"');
+  return output;
+}
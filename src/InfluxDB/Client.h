@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QQueue>
+#include <QTimer>
+#include <QObject>
+#include <QByteArray>
+#include <QNetworkReply>
+#include <QNetworkAccessManager>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <Misc/Settings.h>
+
+namespace InfluxDB
+{
+/**
+ * @brief The Client class
+ *
+ * Writes the generated frames directly to an InfluxDB server (or any other
+ * database that implements the InfluxDB v2 HTTP write API), so that data can
+ * be stored in a time-series database without running a MQTT broker &
+ * Telegraf in between.
+ *
+ * Each group of a frame is converted to a line of the InfluxDB line protocol,
+ * the measurement is the configured one (or the project title if empty), the
+ * group title is stored in the @c group tag & each dataset is stored as a
+ * field, using a float value if the dataset is numeric or a string value
+ * otherwise. The timestamp of the line is the reception time of the frame, in
+ * milliseconds since the epoch.
+ *
+ * Lines are accumulated in a batch that is sent in a single request as soon
+ * as it holds @c maxBatchBytes() bytes, pending lines are also sent every
+ * @c maxLatency() milliseconds. Batches can optionally be compressed with
+ * gzip before being sent.
+ *
+ * Batches that can not be written yet (because the server is unreachable or
+ * overloaded) are kept in a bounded in-memory spool & retried in order with
+ * an exponential backoff. If the spool grows beyond @c spoolLimit()
+ * megabytes, the oldest batches are dropped & counted. Batches rejected by
+ * the server (e.g. because of an invalid token or bucket) are dropped too,
+ * since retrying them would never succeed.
+ *
+ * The client is registered in the sink graph of the JSON generator & receives
+ * every generated frame. Lines are formatted in the worker pool of the graph,
+ * while the HTTP requests are sent from the main thread.
+ */
+class Client : public QObject, public JSON::FrameSink
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(QString url
+               READ url
+               WRITE setUrl
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString organization
+               READ organization
+               WRITE setOrganization
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString bucket
+               READ bucket
+               WRITE setBucket
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString token
+               READ token
+               WRITE setToken
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString measurement
+               READ measurement
+               WRITE setMeasurement
+               NOTIFY configurationChanged)
+    Q_PROPERTY(bool gzipEnabled
+               READ gzipEnabled
+               WRITE setGzipEnabled
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int maxLatency
+               READ maxLatency
+               WRITE setMaxLatency
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int maxBatchBytes
+               READ maxBatchBytes
+               WRITE setMaxBatchBytes
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int spoolLimit
+               READ spoolLimit
+               WRITE setSpoolLimit
+               NOTIFY configurationChanged)
+    Q_PROPERTY(qint64 spooledBytes
+               READ spooledBytes
+               NOTIFY statusChanged)
+    Q_PROPERTY(quint64 droppedBatches
+               READ droppedBatches
+               NOTIFY statusChanged)
+    Q_PROPERTY(QString lastError
+               READ lastError
+               NOTIFY statusChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void statusChanged();
+  void enabledChanged();
+  void configurationChanged();
+
+private:
+  explicit Client();
+  Client(Client &&) = delete;
+  Client(const Client &) = delete;
+  Client &operator=(Client &&) = delete;
+  Client &operator=(const Client &) = delete;
+
+public:
+  static Client &instance();
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  bool enabled() const;
+  QString url() const;
+  QString organization() const;
+  QString bucket() const;
+  QString token() const;
+  QString measurement() const;
+  bool gzipEnabled() const;
+  int maxLatency() const;
+  int maxBatchBytes() const;
+  int spoolLimit() const;
+  qint64 spooledBytes() const;
+  quint64 droppedBatches() const;
+  QString lastError() const;
+
+public Q_SLOTS:
+  void flush();
+  void setEnabled(const bool enabled);
+  void setUrl(const QString &url);
+  void setOrganization(const QString &organization);
+  void setBucket(const QString &bucket);
+  void setToken(const QString &token);
+  void setMeasurement(const QString &measurement);
+  void setGzipEnabled(const bool enabled);
+  void setMaxLatency(const int milliseconds);
+  void setMaxBatchBytes(const int bytes);
+  void setSpoolLimit(const int megabytes);
+
+private Q_SLOTS:
+  void sendNextBatch();
+  void onReplyFinished();
+
+private:
+  void spoolBatch(const QByteArray &batch);
+  void appendFrame(const JSON::Frame &frame);
+  void setLastError(const QString &error);
+
+  static QByteArray gzip(const QByteArray &data);
+  static QByteArray escapeKey(const QString &key);
+  static QByteArray escapeString(const QString &value);
+
+private:
+  bool m_enabled;
+  QString m_url;
+  QString m_organization;
+  QString m_bucket;
+  QString m_token;
+  QString m_measurement;
+  bool m_gzipEnabled;
+  int m_maxLatency;
+  int m_maxBatchBytes;
+  int m_spoolLimit;
+
+  mutable QMutex m_mutex;
+  QByteArray m_batch;
+  bool m_flushScheduled;
+
+  qint64 m_spooledBytes;
+  quint64 m_droppedBatches;
+  QString m_lastError;
+  QQueue<QByteArray> m_spool;
+
+  int m_retryDelay;
+  QTimer m_retryTimer;
+  QTimer m_latencyTimer;
+  Misc::Settings m_settings;
+  QNetworkReply *m_reply;
+  QNetworkAccessManager m_network;
+};
+} // namespace InfluxDB
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <QtNumeric>
+
+#include <JSON/Frame.h>
+#include <JSON/AlarmEngine.h>
+#include <IO/FrameQueue.h>
+
+/**
+ * Alarm rule read from the project file, before it is stored in the rule table
+ */
+struct AlarmRule
+{
+  int field;
+  int value;
+  int group;
+  int dataset;
+  JSON::AlarmEvent::Kind kind;
+  double limit;
+  double release;
+  qint64 debounce;
+};
+
+/**
+ * Registers the given @a message in @a error (if not null) & returns
+ * @c false, used to report alarm errors in a single line.
+ */
+static bool FAIL(QString *error, const QString &message)
+{
+  if (error)
+    *error = message;
+
+  return false;
+}
+
+/**
+ * Returns the name of the kind of the alarm rule, as used in the event log
+ */
+QString JSON::AlarmEvent::kindName() const
+{
+  switch (kind)
+  {
+    case High:
+      return QStringLiteral("high");
+    case Low:
+      return QStringLiteral("low");
+    case Rate:
+      return QStringLiteral("rate");
+  }
+
+  return QString();
+}
+
+/**
+ * Returns a JSON object with the data of the event, the reception time is
+ * converted to milliseconds since epoch.
+ */
+QJsonObject JSON::AlarmEvent::toJson() const
+{
+  QJsonObject object;
+  object.insert("time", static_cast<double>(
+                            IO::FrameQueue::toMSecsSinceEpoch(timestamp)));
+  object.insert("group", group);
+  object.insert("dataset", dataset);
+  object.insert("title", title);
+  object.insert("kind", kindName());
+  object.insert("active", active);
+  object.insert("value", value);
+  object.insert("limit", limit);
+  return object;
+}
+
+/**
+ * Constructor function
+ */
+JSON::AlarmEngine::AlarmEngine() {}
+
+/**
+ * Returns @c true if no dataset of the project has alarm rules
+ */
+bool JSON::AlarmEngine::isEmpty() const
+{
+  return m_fields.isEmpty();
+}
+
+/**
+ * Removes all the compiled alarm rules
+ */
+void JSON::AlarmEngine::clear()
+{
+  m_fields.clear();
+  m_values.clear();
+  m_groups.clear();
+  m_datasets.clear();
+  m_kinds.clear();
+  m_limits.clear();
+  m_releases.clear();
+  m_debounce.clear();
+
+  m_active.clear();
+  m_pending.clear();
+  m_lastValue.clear();
+  m_lastTime.clear();
+}
+
+/**
+ * Compiles the alarm rules of the datasets of the given @a frame. If a rule
+ * is not valid, no alarm is compiled, a description of the problem is written
+ * to @a error & @c false is returned.
+ */
+bool JSON::AlarmEngine::compile(const Frame &frame, QString *error)
+{
+  // Remove previous rules
+  clear();
+
+  // Read the rules of each dataset
+  QVector<AlarmRule> rules;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      const auto object = dataset.alarmRules();
+      if (object.isEmpty())
+        continue;
+
+      if (!validate(object, error))
+      {
+        if (error)
+          *error = QStringLiteral("%1: %2").arg(dataset.title(), *error);
+
+        return false;
+      }
+
+      // Read common parameters, computed datasets use field -1
+      AlarmRule rule;
+      rule.field = qMax(0, dataset.index()) - 1;
+      rule.value = frame.valueIndex(i, j);
+      rule.group = i;
+      rule.dataset = j;
+      rule.debounce = qRound64(object.value("debounce").toDouble(0) * 1000);
+      const double hysteresis = object.value("hysteresis").toDouble(0);
+
+      // Register a rule for each limit
+      if (object.contains("high"))
+      {
+        rule.kind = AlarmEvent::High;
+        rule.limit = object.value("high").toDouble();
+        rule.release = rule.limit - hysteresis;
+        rules.append(rule);
+      }
+      if (object.contains("low"))
+      {
+        rule.kind = AlarmEvent::Low;
+        rule.limit = object.value("low").toDouble();
+        rule.release = rule.limit + hysteresis;
+        rules.append(rule);
+      }
+      if (object.contains("rate"))
+      {
+        rule.kind = AlarmEvent::Rate;
+        rule.limit = object.value("rate").toDouble();
+        rule.release = rule.limit - hysteresis;
+        rules.append(rule);
+      }
+    }
+  }
+
+  // Sort rules by field
+  std::stable_sort(rules.begin(), rules.end(),
+                   [](const AlarmRule &a, const AlarmRule &b) {
+                     return a.field < b.field;
+                   });
+
+  // Build the rule table
+  for (int i = 0; i < rules.count(); ++i)
+  {
+    const auto &rule = rules.at(i);
+    m_fields.append(rule.field);
+    m_values.append(rule.value);
+    m_groups.append(rule.group);
+    m_datasets.append(rule.dataset);
+    m_kinds.append(rule.kind);
+    m_limits.append(rule.limit);
+    m_releases.append(rule.release);
+    m_debounce.append(rule.debounce);
+  }
+
+  // Initialize the state of each rule
+  m_active.fill(false, rules.count());
+  m_pending.fill(-1, rules.count());
+  m_lastValue.fill(qQNaN(), rules.count());
+  m_lastTime.fill(-1, rules.count());
+  return true;
+}
+
+/**
+ * Evaluates the rules of the datasets of the given @a frame that are fed by
+ * the fields within [@a beginField, @a endField) and the rules of the
+ * computed datasets. The transitions of the rules are appended to @a events.
+ */
+void JSON::AlarmEngine::evaluate(const Frame &frame, const int beginField,
+                                 const int endField,
+                                 QVector<AlarmEvent> &events)
+{
+  // Nothing to do
+  if (m_fields.isEmpty())
+    return;
+
+  // Get reception time of the frame
+  auto timestamp = frame.timestamp();
+  if (timestamp <= 0)
+    timestamp = IO::FrameQueue::timestamp();
+
+  // Evaluate the rules of the computed datasets
+  const auto begin = m_fields.constBegin();
+  const auto end = m_fields.constEnd();
+  const int computed = std::lower_bound(begin, end, 0) - begin;
+  if (beginField >= 0)
+    evaluate(frame, 0, computed, timestamp, events);
+
+  // Evaluate the rules of the given fields
+  const int first = std::lower_bound(begin, end, beginField) - begin;
+  const int last = std::lower_bound(begin, end, endField) - begin;
+  evaluate(frame, first, last, timestamp, events);
+}
+
+/**
+ * Checks that the given alarm rule @a definition is valid, if not, a
+ * description of the problem is written to @a error. Empty definitions are
+ * valid (the dataset has no alarm rules).
+ */
+bool JSON::AlarmEngine::validate(const QJsonObject &definition,
+                                 QString *error)
+{
+  // No alarm rules
+  if (definition.isEmpty())
+    return true;
+
+  // Check that limits are numbers
+  const QStringList keys = {"high", "low", "rate", "hysteresis", "debounce"};
+  Q_FOREACH (const auto &key, definition.keys())
+  {
+    if (!keys.contains(key))
+      return FAIL(error, QStringLiteral("unknown alarm key \"%1\"").arg(key));
+
+    if (!definition.value(key).isDouble())
+      return FAIL(error, QStringLiteral("\"%1\" must be a number").arg(key));
+  }
+
+  // Check that at least one limit is given
+  if (!definition.contains("high") && !definition.contains("low")
+      && !definition.contains("rate"))
+    return FAIL(error, QStringLiteral("no alarm limit given"));
+
+  // Validate limits
+  if (definition.contains("high") && definition.contains("low")
+      && definition.value("low").toDouble()
+             >= definition.value("high").toDouble())
+    return FAIL(error, QStringLiteral("low limit must be below high limit"));
+  if (definition.value("rate").toDouble(1) <= 0)
+    return FAIL(error, QStringLiteral("rate limit must be positive"));
+  if (definition.value("hysteresis").toDouble(0) < 0)
+    return FAIL(error, QStringLiteral("hysteresis cannot be negative"));
+  if (definition.value("debounce").toDouble(0) < 0)
+    return FAIL(error, QStringLiteral("debounce time cannot be negative"));
+
+  return true;
+}
+
+/**
+ * Evaluates the rules within [@a first, @a last) of the rule table with the
+ * values of the given @a frame, received at the given @a timestamp.
+ *
+ * A rule changes its state when the raise condition (or the release condition
+ * for active alarms) has held for the debounce time of the rule.
+ */
+void JSON::AlarmEngine::evaluate(const Frame &frame, const int first,
+                                 const int last, const qint64 timestamp,
+                                 QVector<AlarmEvent> &events)
+{
+  const auto values = frame.values().constData();
+  for (int i = first; i < last; ++i)
+  {
+    // Skip values that are not numbers
+    double value = values[m_values[i]];
+    if (!qIsFinite(value))
+      continue;
+
+    // Calculate the rate of change of the value (in units per second)
+    const auto kind = m_kinds[i];
+    if (kind == AlarmEvent::Rate)
+    {
+      const auto lastTime = m_lastTime[i];
+      if (lastTime >= 0 && timestamp <= lastTime)
+        continue;
+
+      const double lastValue = m_lastValue[i];
+      m_lastTime[i] = timestamp;
+      m_lastValue[i] = value;
+      if (lastTime < 0)
+        continue;
+
+      value = qAbs(value - lastValue) * 1e6 / (timestamp - lastTime);
+    }
+
+    // Check the raise or the release condition of the rule
+    bool condition;
+    const bool active = m_active[i];
+    if (kind == AlarmEvent::Low)
+      condition = active ? value >= m_releases[i] : value < m_limits[i];
+    else
+      condition = active ? value <= m_releases[i] : value > m_limits[i];
+
+    // Condition does not hold, restart the debounce timer
+    if (!condition)
+    {
+      m_pending[i] = -1;
+      continue;
+    }
+
+    // Wait until the condition has held for the debounce time
+    if (m_pending[i] < 0)
+      m_pending[i] = timestamp;
+    if (timestamp - m_pending[i] < m_debounce[i])
+      continue;
+
+    // Change the state of the rule & register the event
+    m_pending[i] = -1;
+    m_active[i] = !active;
+
+    AlarmEvent event;
+    event.timestamp = timestamp;
+    event.group = m_groups[i];
+    event.dataset = m_datasets[i];
+    event.kind = kind;
+    event.active = !active;
+    event.value = value;
+    event.limit = m_limits[i];
+    event.title = frame.getGroup(event.group).getDataset(event.dataset).title();
+    events.append(event);
+  }
+}
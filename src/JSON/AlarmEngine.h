@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+namespace JSON
+{
+class Frame;
+
+/**
+ * @brief The AlarmEvent struct
+ *
+ * Transition of an alarm rule, registered when the rule is raised (@c active
+ * is @c true) or cleared. The @a timestamp is the reception time of the frame
+ * that caused the transition (see @c IO::FrameQueue::timestamp()).
+ */
+struct AlarmEvent
+{
+  enum Kind
+  {
+    High,
+    Low,
+    Rate
+  };
+
+  qint64 timestamp;
+  int group;
+  int dataset;
+  Kind kind;
+  bool active;
+  double value;
+  double limit;
+  QString title;
+
+  QString kindName() const;
+  QJsonObject toJson() const;
+};
+
+/**
+ * @brief The AlarmEngine class
+ *
+ * Evaluates the alarm rules of the datasets with each generated frame, as
+ * described by the optional @c alarmRules object of each dataset in the
+ * project file:
+ *
+ * @code
+ * { "high": 80, "low": 10, "rate": 5, "hysteresis": 1, "debounce": 250 }
+ * @endcode
+ *
+ * - @c high & @c low raise an alarm when the value goes above/below the limit.
+ * - @c rate raises an alarm when the value changes faster than the given
+ *   number of units per second.
+ * - @c hysteresis is the distance that the value (or its rate of change) must
+ *   move back from the limit before the alarm is cleared.
+ * - @c debounce is the time (in milliseconds) that a condition must hold
+ *   before the alarm is raised or cleared.
+ *
+ * The rules are compiled when the project is loaded into a flat table sorted
+ * by frame field, so only the rules of the fields updated by a device are
+ * evaluated for each frame. Alarms are evaluated by the JSON generator, so
+ * they fire at the rate at which data is received, regardless of the state
+ * of the dashboard.
+ */
+class AlarmEngine
+{
+public:
+  AlarmEngine();
+
+  bool isEmpty() const;
+  void clear();
+
+  bool compile(const Frame &frame, QString *error = Q_NULLPTR);
+  void evaluate(const Frame &frame, const int beginField, const int endField,
+                QVector<AlarmEvent> &events);
+
+  static bool validate(const QJsonObject &definition,
+                       QString *error = Q_NULLPTR);
+
+private:
+  void evaluate(const Frame &frame, const int first, const int last,
+                const qint64 timestamp, QVector<AlarmEvent> &events);
+
+private:
+  QVector<int> m_fields;
+  QVector<int> m_values;
+  QVector<int> m_groups;
+  QVector<int> m_datasets;
+  QVector<AlarmEvent::Kind> m_kinds;
+  QVector<double> m_limits;
+  QVector<double> m_releases;
+  QVector<qint64> m_debounce;
+
+  QVector<bool> m_active;
+  QVector<qint64> m_pending;
+  QVector<double> m_lastValue;
+  QVector<qint64> m_lastTime;
+};
+} // namespace JSON
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QtEndian>
+#include <QtNumeric>
+#include <QJsonObject>
+#include <JSON/BinaryDecoder.h>
+
+//
+// Identifiers used to store the field types in the JSON project file, the
+// order matches the JSON::BinaryDecoder::Type enum
+//
+static const char *TYPE_NAMES[]
+    = {"int8",  "uint8",  "int16",   "uint16", "int32",
+       "uint32", "int64", "uint64", "float32", "float64"};
+static const int TYPE_SIZES[] = {1, 1, 2, 2, 4, 4, 8, 8, 4, 8};
+static const int TYPE_COUNT = sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]);
+
+/**
+ * Largest CAN identifier (29-bit extended frame format)
+ */
+static const qint64 MAX_CAN_ID = 0x1FFFFFFF;
+
+/**
+ * Maximum payload of a CAN record (CAN FD), payloads are copied to a buffer
+ * with a margin of 8 zeroed bytes, so that 64-bit fields that contain the
+ * signals of the last bytes of the payload can always be read.
+ */
+static const int MAX_CAN_PAYLOAD = 64;
+static const int CAN_BUFFER_SIZE = MAX_CAN_PAYLOAD + 8;
+
+/**
+ * Byte order of the host, used to detect layouts that can be decoded by
+ * simply copying each field
+ */
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+static const bool HOST_BIG_ENDIAN = true;
+#else
+static const bool HOST_BIG_ENDIAN = false;
+#endif
+
+/**
+ * Registers the given @a message in @a error (if not null) & returns
+ * @c false, used to report layout errors in a single line.
+ */
+static bool FAIL(QString *error, const int field, const QString &message)
+{
+  if (error)
+    *error = QStringLiteral("Binary layout field %1: %2")
+                 .arg(field)
+                 .arg(message);
+
+  return false;
+}
+
+/**
+ * Converts the given @a raw bits to a number with the given @a type. Signed
+ * values are sign-extended from the given number of @a bits.
+ */
+static double CONVERT(const JSON::BinaryDecoder::Type type, quint64 raw,
+                      const int bits)
+{
+  switch (type)
+  {
+    case JSON::BinaryDecoder::Type::Int8:
+    case JSON::BinaryDecoder::Type::Int16:
+    case JSON::BinaryDecoder::Type::Int32:
+    case JSON::BinaryDecoder::Type::Int64:
+      if (bits < 64 && ((raw >> (bits - 1)) & 1))
+        raw |= ~Q_UINT64_C(0) << bits;
+      return static_cast<double>(static_cast<qint64>(raw));
+    case JSON::BinaryDecoder::Type::Float32: {
+      float value;
+      const auto word = static_cast<quint32>(raw);
+      memcpy(&value, &word, sizeof(value));
+      return static_cast<double>(value);
+    }
+    case JSON::BinaryDecoder::Type::Float64: {
+      double value;
+      memcpy(&value, &raw, sizeof(value));
+      return value;
+    }
+    default:
+      return static_cast<double>(raw);
+  }
+}
+
+/**
+ * Constructor function, creates an empty decoder
+ */
+JSON::BinaryDecoder::BinaryDecoder()
+  : m_uniform(false)
+  , m_routed(false)
+  , m_frameSize(0)
+  , m_uniformType(Type::UInt8)
+{
+}
+
+/**
+ * Returns @c true if no binary layout has been compiled
+ */
+bool JSON::BinaryDecoder::isEmpty() const
+{
+  return m_instructions.isEmpty();
+}
+
+/**
+ * Returns @c true if the fields of the layout are routed by CAN identifier
+ */
+bool JSON::BinaryDecoder::isRouted() const
+{
+  return m_routed;
+}
+
+/**
+ * Returns the number of fields decoded from each frame
+ */
+int JSON::BinaryDecoder::fieldCount() const
+{
+  return m_instructions.count();
+}
+
+/**
+ * Returns the minimum number of bytes that a frame must contain so that all
+ * the fields of the layout can be decoded.
+ */
+int JSON::BinaryDecoder::frameSize() const
+{
+  return m_frameSize;
+}
+
+/**
+ * Removes the compiled layout
+ */
+void JSON::BinaryDecoder::clear()
+{
+  m_uniform = false;
+  m_routed = false;
+  m_frameSize = 0;
+  m_uniformType = Type::UInt8;
+  m_instructions.clear();
+  m_routes.clear();
+}
+
+/**
+ * Compiles the given binary @a layout into a list of decoding instructions.
+ * If the layout is not valid, the decoder is left empty, a description of
+ * the problem is written to @a error & @c false is returned.
+ */
+bool JSON::BinaryDecoder::compile(const QJsonArray &layout, QString *error)
+{
+  // Remove previous layout
+  clear();
+
+  // Compile each field
+  QVector<Instruction> instructions;
+  instructions.reserve(layout.count());
+  bool routedLayout = false;
+  QHash<quint32, QVector<int>> routes;
+  for (int i = 0; i < layout.count(); ++i)
+  {
+    const auto object = layout.at(i).toObject();
+
+    // Get field type
+    int type = -1;
+    const auto name = object.value("type").toString().toLower();
+    for (int t = 0; t < TYPE_COUNT && type < 0; ++t)
+    {
+      if (name == QLatin1String(TYPE_NAMES[t]))
+        type = t;
+    }
+
+    if (type < 0)
+      return FAIL(error, i, QStringLiteral("unknown type \"%1\"").arg(name));
+
+    // Get byte order
+    const auto endianness = object.value("endianness").toString().toLower();
+    if (!endianness.isEmpty() && endianness != "little" && endianness != "big")
+      return FAIL(error, i, QStringLiteral("invalid endianness"));
+
+    // Register field parameters
+    Instruction instruction;
+    instruction.type = static_cast<Type>(type);
+    instruction.size = TYPE_SIZES[type];
+    instruction.offset = object.value("offset").toInt(-1);
+    instruction.bigEndian = (endianness == "big");
+    instruction.bitOffset = object.value("bitOffset").toInt(0);
+    instruction.bitCount = object.value("bitCount").toInt(0);
+    instruction.scale = object.value("scale").toDouble(1);
+    instruction.bias = object.value("bias").toDouble(0);
+    instruction.canId = 0;
+
+    // Validate offset
+    if (instruction.offset < 0)
+      return FAIL(error, i, QStringLiteral("invalid offset"));
+
+    // Validate CAN identifier, either all fields or none of them are routed
+    const bool routed = object.contains("canId");
+    if (i > 0 && routed != routedLayout)
+      return FAIL(error, i, QStringLiteral("all fields need a CAN identifier"));
+    if (routed)
+    {
+      const auto id = static_cast<qint64>(object.value("canId").toDouble(-1));
+      if (id < 0 || id > MAX_CAN_ID)
+        return FAIL(error, i, QStringLiteral("invalid CAN identifier"));
+      if (instruction.offset + instruction.size > CAN_BUFFER_SIZE)
+        return FAIL(error, i, QStringLiteral("field exceeds the CAN payload"));
+
+      instruction.canId = static_cast<quint32>(id);
+    }
+
+    routedLayout = routed;
+
+    // Validate bitfield
+    if (instruction.bitCount != 0)
+    {
+      const int bits = instruction.size * 8;
+      const auto type = instruction.type;
+      if (type == Type::Float32 || type == Type::Float64)
+        return FAIL(error, i, QStringLiteral("bitfields need integer types"));
+
+      if (instruction.bitCount < 0 || instruction.bitOffset < 0
+          || instruction.bitOffset + instruction.bitCount > bits)
+        return FAIL(error, i, QStringLiteral("invalid bitfield"));
+    }
+
+    // Register instruction
+    if (routedLayout)
+      routes[instruction.canId].append(instructions.count());
+
+    instructions.append(instruction);
+    m_frameSize = qMax(m_frameSize, instruction.offset + instruction.size);
+  }
+
+  // Check if all fields can be decoded with the same specialized loop
+  m_uniform = !instructions.isEmpty() && !routedLayout;
+  for (int i = 0; i < instructions.count() && m_uniform; ++i)
+  {
+    const auto &instruction = instructions.at(i);
+    m_uniform = instruction.type == instructions.first().type
+                && instruction.bigEndian == HOST_BIG_ENDIAN
+                && instruction.bitCount == 0;
+  }
+
+  // Update instruction list
+  if (m_uniform)
+    m_uniformType = instructions.first().type;
+
+  m_routes = routes;
+  m_routed = routedLayout;
+  m_instructions = instructions;
+  return true;
+}
+
+/**
+ * Decodes the given binary @a frame & writes the value of each field of the
+ * layout to @a values. Fields that are not contained in the frame (e.g. if
+ * the frame is shorter than expected) are set to NaN.
+ *
+ * For routed layouts, @a frame must be a CAN record & only the fields that
+ * are routed to its identifier are decoded, the rest are set to NaN. In this
+ * case, @c false is returned if the record is invalid or if no field is
+ * routed to its identifier.
+ */
+bool JSON::BinaryDecoder::decode(const QByteArray &frame,
+                                 QVector<double> &values) const
+{
+  // Initialize parameters
+  values.resize(m_instructions.count());
+  const auto data = frame.constData();
+  const auto length = frame.size();
+
+  // Decode fields routed to the CAN identifier of the record
+  if (m_routed)
+    return decodeRouted(data, length, values);
+
+  // Decode fields with the specialized loop for the layout type
+  if (m_uniform)
+  {
+    switch (m_uniformType)
+    {
+      case Type::Int8:
+        decodeUniform<qint8>(data, length, values);
+        break;
+      case Type::UInt8:
+        decodeUniform<quint8>(data, length, values);
+        break;
+      case Type::Int16:
+        decodeUniform<qint16>(data, length, values);
+        break;
+      case Type::UInt16:
+        decodeUniform<quint16>(data, length, values);
+        break;
+      case Type::Int32:
+        decodeUniform<qint32>(data, length, values);
+        break;
+      case Type::UInt32:
+        decodeUniform<quint32>(data, length, values);
+        break;
+      case Type::Int64:
+        decodeUniform<qint64>(data, length, values);
+        break;
+      case Type::UInt64:
+        decodeUniform<quint64>(data, length, values);
+        break;
+      case Type::Float32:
+        decodeUniform<float>(data, length, values);
+        break;
+      case Type::Float64:
+        decodeUniform<double>(data, length, values);
+        break;
+    }
+  }
+
+  // Decode each field individually
+  else
+    decodeGeneric(data, length, values);
+
+  return true;
+}
+
+/**
+ * Decodes a layout in which all the fields are stored as @c T in the native
+ * byte order of the host, each value is simply copied & scaled.
+ */
+template<typename T>
+void JSON::BinaryDecoder::decodeUniform(const char *data, const int length,
+                                        QVector<double> &values) const
+{
+  const int size = static_cast<int>(sizeof(T));
+  const auto instructions = m_instructions.constData();
+  auto output = values.data();
+
+  for (int i = 0; i < m_instructions.count(); ++i)
+  {
+    const auto &instruction = instructions[i];
+    if (instruction.offset + size > length)
+    {
+      output[i] = qQNaN();
+      continue;
+    }
+
+    T raw;
+    memcpy(&raw, data + instruction.offset, sizeof(T));
+    output[i] = static_cast<double>(raw) * instruction.scale + instruction.bias;
+  }
+}
+
+/**
+ * Decodes each field of the layout with its own type, byte order & bitfield
+ */
+void JSON::BinaryDecoder::decodeGeneric(const char *data, const int length,
+                                        QVector<double> &values) const
+{
+  const auto instructions = m_instructions.constData();
+  auto output = values.data();
+
+  for (int i = 0; i < m_instructions.count(); ++i)
+    output[i] = decodeField(instructions[i], data, length);
+}
+
+/**
+ * Decodes the fields that are routed to the identifier of the given CAN
+ * record. The payload is copied to a zero-padded buffer, so that signals
+ * declared with a 64-bit container can be read from short payloads.
+ */
+bool JSON::BinaryDecoder::decodeRouted(const char *data, const int length,
+                                       QVector<double> &values) const
+{
+  // Set all fields as missing
+  values.fill(qQNaN());
+
+  // Validate record
+  if (length < CAN_RECORD_HEADER_SIZE)
+    return false;
+
+  // Find the fields routed to the CAN identifier
+  const auto id = qFromLittleEndian<quint32>(data) & MAX_CAN_ID;
+  const auto route = m_routes.constFind(id);
+  if (route == m_routes.constEnd())
+    return false;
+
+  // Copy payload to the padded buffer
+  char payload[CAN_BUFFER_SIZE];
+  memset(payload, 0, sizeof(payload));
+  const int declared = static_cast<quint8>(data[5]);
+  const int available = length - CAN_RECORD_HEADER_SIZE;
+  const int size = qMin(qMin(declared, available), MAX_CAN_PAYLOAD);
+  memcpy(payload, data + CAN_RECORD_HEADER_SIZE, size);
+
+  // Decode routed fields
+  auto output = values.data();
+  const auto instructions = m_instructions.constData();
+  for (const auto index : route.value())
+    output[index] = decodeField(instructions[index], payload, sizeof(payload));
+
+  return true;
+}
+
+/**
+ * Decodes a single field with its own type, byte order & bitfield. Returns
+ * NaN if the field is not contained in the given @a data.
+ */
+double JSON::BinaryDecoder::decodeField(const Instruction &instruction,
+                                        const char *data,
+                                        const int length) const
+{
+  // Field is not contained in the frame
+  if (instruction.offset + instruction.size > length)
+    return qQNaN();
+
+  // Read raw bits with the byte order of the field
+  quint64 raw;
+  const auto bytes = data + instruction.offset;
+  switch (instruction.size)
+  {
+    case 1:
+      raw = static_cast<quint8>(bytes[0]);
+      break;
+    case 2:
+      raw = instruction.bigEndian ? qFromBigEndian<quint16>(bytes)
+                                  : qFromLittleEndian<quint16>(bytes);
+      break;
+    case 4:
+      raw = instruction.bigEndian ? qFromBigEndian<quint32>(bytes)
+                                  : qFromLittleEndian<quint32>(bytes);
+      break;
+    default:
+      raw = instruction.bigEndian ? qFromBigEndian<quint64>(bytes)
+                                  : qFromLittleEndian<quint64>(bytes);
+      break;
+  }
+
+  // Extract bitfield
+  int bits = instruction.size * 8;
+  if (instruction.bitCount > 0)
+  {
+    bits = instruction.bitCount;
+    raw >>= instruction.bitOffset;
+    if (bits < 64)
+      raw &= (Q_UINT64_C(1) << bits) - 1;
+  }
+
+  // Convert & scale value
+  const auto value = CONVERT(instruction.type, raw, bits);
+  return value * instruction.scale + instruction.bias;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QJsonArray>
+#include <QByteArray>
+
+/**
+ * Size of the header that precedes the payload of the CAN records produced by
+ * the CAN bus driver: identifier (u32, little-endian), flags (u8) & payload
+ * length (u8).
+ */
+#define CAN_RECORD_HEADER_SIZE 6
+
+namespace JSON
+{
+/**
+ * @brief The BinaryDecoder class
+ *
+ * Native decoder for binary frames, built from the declarative binary layout
+ * of a project file (the optional @c binaryLayout array). Each element of the
+ * layout describes one field of the frame:
+ *
+ * @code
+ * {
+ *   "offset": 0,             // Byte offset of the field in the frame
+ *   "type": "uint16",        // int8, uint8, int16 ... uint64, float32, float64
+ *   "endianness": "little",  // "little" (default) or "big"
+ *   "bitOffset": 0,          // Optional bitfield (integer types only)
+ *   "bitCount": 0,           // Number of bits, 0 means the whole value
+ *   "scale": 1,              // value = raw * scale + bias
+ *   "bias": 0,
+ *   "canId": 291             // Optional CAN identifier, see below
+ * }
+ * @endcode
+ *
+ * The n-th element of the layout feeds the datasets with frame index n + 1,
+ * in the same way as the n-th field returned by a frame parser script.
+ *
+ * The layout is compiled once (when the project is loaded) into a flat list
+ * of instructions. Layouts in which every field has the same type & the
+ * native byte order, and no bitfields (e.g. an array of floats sent by the
+ * firmware), are decoded with a specialized loop for that type.
+ *
+ * Layouts in which the fields declare a @c canId are routed: each frame is a
+ * CAN record produced by @c IO::Drivers::CANBus (header + payload, see
+ * @c CAN_RECORD_HEADER_SIZE), the offsets of the fields are relative to the
+ * payload, and only the fields of the identifier of the record are decoded.
+ * The rest of the fields are set to NaN, so that the datasets fed by other
+ * messages keep their values. Identifiers are looked up in a hash table, so
+ * the cost of a record does not depend on the number of messages.
+ */
+class BinaryDecoder
+{
+public:
+  enum class Type
+  {
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Int64,
+    UInt64,
+    Float32,
+    Float64
+  };
+
+  BinaryDecoder();
+
+  bool isEmpty() const;
+  bool isRouted() const;
+  int fieldCount() const;
+  int frameSize() const;
+
+  void clear();
+  bool compile(const QJsonArray &layout, QString *error = Q_NULLPTR);
+  bool decode(const QByteArray &frame, QVector<double> &values) const;
+
+private:
+  struct Instruction
+  {
+    Type type;
+    int offset;
+    int size;
+    bool bigEndian;
+    int bitOffset;
+    int bitCount;
+    double scale;
+    double bias;
+    quint32 canId;
+  };
+
+  template<typename T>
+  void decodeUniform(const char *data, const int length,
+                     QVector<double> &values) const;
+  void decodeGeneric(const char *data, const int length,
+                     QVector<double> &values) const;
+  bool decodeRouted(const char *data, const int length,
+                    QVector<double> &values) const;
+  double decodeField(const Instruction &instruction, const char *data,
+                     const int length) const;
+
+private:
+  bool m_uniform;
+  bool m_routed;
+  int m_frameSize;
+  Type m_uniformType;
+  QVector<Instruction> m_instructions;
+  QHash<quint32, QVector<int>> m_routes;
+};
+} // namespace JSON
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QCborValue>
+#include <QCborMap>
+#include <JSON/BinaryFrameDecoder.h>
+
+/**
+ * Maximum nesting level of MessagePack arrays & maps, frames only use five
+ * levels (frame, groups, group, datasets & dataset)
+ */
+static const int MAX_DEPTH = 32;
+
+/**
+ * Minimal MessagePack reader that decodes a single value into a JSON value.
+ * Extension types & binary strings are not used by the frame schema, they
+ * are skipped and decoded as null values.
+ */
+class MessagePackReader
+{
+public:
+  MessagePackReader(const QByteArray &data)
+    : m_pos(0)
+    , m_error(false)
+    , m_size(data.size())
+    , m_data(reinterpret_cast<const uchar *>(data.constData()))
+  {
+  }
+
+  bool atEnd() const { return m_pos == m_size; }
+  bool hasError() const { return m_error; }
+
+  QJsonValue read(const int depth = 0)
+  {
+    // Too many nesting levels or no more data
+    if (depth > MAX_DEPTH || !available(1))
+      return fail();
+
+    // Positive & negative fixint, fixmap, fixarray & fixstr
+    const uchar type = m_data[m_pos++];
+    if (type <= 0x7f)
+      return static_cast<double>(type);
+    if (type >= 0xe0)
+      return static_cast<double>(static_cast<qint8>(type));
+    if ((type & 0xf0) == 0x80)
+      return readMap(type & 0x0f, depth);
+    if ((type & 0xf0) == 0x90)
+      return readArray(type & 0x0f, depth);
+    if ((type & 0xe0) == 0xa0)
+      return readString(type & 0x1f);
+
+    // Other types
+    switch (type)
+    {
+      case 0xc0:
+        return QJsonValue::Null;
+      case 0xc2:
+        return false;
+      case 0xc3:
+        return true;
+      case 0xc4:
+        return skip(readLength(1));
+      case 0xc5:
+        return skip(readLength(2));
+      case 0xc6:
+        return skip(readLength(4));
+      case 0xc7:
+        return skip(readLength(1) + 1);
+      case 0xc8:
+        return skip(readLength(2) + 1);
+      case 0xc9:
+        return skip(readLength(4) + 1);
+      case 0xca: {
+        quint32 bits = static_cast<quint32>(readUnsigned(4));
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return static_cast<double>(value);
+      }
+      case 0xcb: {
+        quint64 bits = readUnsigned(8);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+      }
+      case 0xcc:
+        return static_cast<double>(readUnsigned(1));
+      case 0xcd:
+        return static_cast<double>(readUnsigned(2));
+      case 0xce:
+        return static_cast<double>(readUnsigned(4));
+      case 0xcf:
+        return static_cast<double>(readUnsigned(8));
+      case 0xd0:
+        return static_cast<double>(static_cast<qint8>(readUnsigned(1)));
+      case 0xd1:
+        return static_cast<double>(static_cast<qint16>(readUnsigned(2)));
+      case 0xd2:
+        return static_cast<double>(static_cast<qint32>(readUnsigned(4)));
+      case 0xd3:
+        return static_cast<double>(static_cast<qint64>(readUnsigned(8)));
+      case 0xd4:
+        return skip(2);
+      case 0xd5:
+        return skip(3);
+      case 0xd6:
+        return skip(5);
+      case 0xd7:
+        return skip(9);
+      case 0xd8:
+        return skip(17);
+      case 0xd9:
+        return readString(readLength(1));
+      case 0xda:
+        return readString(readLength(2));
+      case 0xdb:
+        return readString(readLength(4));
+      case 0xdc:
+        return readArray(readLength(2), depth);
+      case 0xdd:
+        return readArray(readLength(4), depth);
+      case 0xde:
+        return readMap(readLength(2), depth);
+      case 0xdf:
+        return readMap(readLength(4), depth);
+      default:
+        return fail();
+    }
+  }
+
+private:
+  QJsonValue fail()
+  {
+    m_error = true;
+    return QJsonValue();
+  }
+
+  bool available(const qint64 bytes) const
+  {
+    return bytes >= 0 && bytes <= m_size - m_pos;
+  }
+
+  quint64 readUnsigned(const int bytes)
+  {
+    if (!available(bytes))
+    {
+      m_error = true;
+      return 0;
+    }
+
+    quint64 value = 0;
+    for (int i = 0; i < bytes; ++i)
+      value = (value << 8) | m_data[m_pos++];
+
+    return value;
+  }
+
+  qint64 readLength(const int bytes)
+  {
+    return static_cast<qint64>(readUnsigned(bytes));
+  }
+
+  QJsonValue skip(const qint64 bytes)
+  {
+    if (m_error || !available(bytes))
+      return fail();
+
+    m_pos += bytes;
+    return QJsonValue::Null;
+  }
+
+  QJsonValue readString(const qint64 length)
+  {
+    if (m_error || !available(length))
+      return fail();
+
+    const auto data = reinterpret_cast<const char *>(m_data + m_pos);
+    m_pos += length;
+    return QString::fromUtf8(data, static_cast<int>(length));
+  }
+
+  QJsonValue readArray(const qint64 count, const int depth)
+  {
+    // Each element uses at least one byte
+    if (m_error || !available(count))
+      return fail();
+
+    QJsonArray array;
+    for (qint64 i = 0; i < count && !m_error; ++i)
+      array.append(read(depth + 1));
+
+    return m_error ? fail() : QJsonValue(array);
+  }
+
+  QJsonValue readMap(const qint64 count, const int depth)
+  {
+    // Each key/value pair uses at least two bytes
+    if (m_error || !available(count * 2))
+      return fail();
+
+    QJsonObject object;
+    for (qint64 i = 0; i < count && !m_error; ++i)
+    {
+      const auto key = read(depth + 1);
+      const auto value = read(depth + 1);
+      if (key.isString())
+        object.insert(key.toString(), value);
+      else if (key.isDouble())
+        object.insert(QString::number(key.toDouble()), value);
+    }
+
+    return m_error ? fail() : QJsonValue(object);
+  }
+
+private:
+  qint64 m_pos;
+  bool m_error;
+  const qint64 m_size;
+  const uchar *m_data;
+};
+
+/**
+ * Decodes the given CBOR-encoded frame @a data into a JSON object. Integer map
+ * keys (commonly used to refer to dataset IDs in partial updates) are
+ * converted to strings.
+ *
+ * @a ok is set to @c false if the data is not a valid CBOR map.
+ */
+QJsonObject JSON::BinaryFrameDecoder::fromCbor(const QByteArray &data,
+                                               bool *ok)
+{
+  QCborParserError error;
+  const auto value = QCborValue::fromCbor(data, &error);
+  const bool valid = error.error == QCborError::NoError && value.isMap();
+  if (ok)
+    *ok = valid;
+
+  if (!valid)
+    return QJsonObject();
+
+  return value.toMap().toJsonObject();
+}
+
+/**
+ * Decodes the given MessagePack-encoded frame @a data into a JSON object.
+ * Integer map keys are converted to strings.
+ *
+ * @a ok is set to @c false if the data is not a valid MessagePack map.
+ */
+QJsonObject JSON::BinaryFrameDecoder::fromMessagePack(const QByteArray &data,
+                                                      bool *ok)
+{
+  MessagePackReader reader(data);
+  const auto value = reader.read();
+  const bool valid = !reader.hasError() && reader.atEnd() && value.isObject();
+  if (ok)
+    *ok = valid;
+
+  if (!valid)
+    return QJsonObject();
+
+  return value.toObject();
+}
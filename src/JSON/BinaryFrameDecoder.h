@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+
+namespace JSON
+{
+/**
+ * @brief The BinaryFrameDecoder class
+ *
+ * Decodes the frames sent by devices that encode the automatic-mode frame
+ * schema (title, groups & datasets, or partial value updates) with CBOR or
+ * MessagePack instead of JSON text. Both encodings are decoded into the same
+ * JSON object that @c JSON::Frame::read() expects, so that these devices can
+ * use every feature of the automatic mode.
+ *
+ * Binary encodings can contain any byte value, so these devices should use
+ * a binary framing mode of the I/O manager (e.g. COBS or length-prefixed
+ * packets) instead of start/end delimiters.
+ */
+class BinaryFrameDecoder
+{
+public:
+  static QJsonObject fromCbor(const QByteArray &data, bool *ok = Q_NULLPTR);
+  static QJsonObject fromMessagePack(const QByteArray &data,
+                                     bool *ok = Q_NULLPTR);
+};
+} // namespace JSON
@@ -0,0 +1,397 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <QJsonArray>
+
+#include <JSON/Frame.h>
+#include <JSON/Calibration.h>
+
+//
+// Calibration types, identified by the "type" key of the calibration object
+//
+enum CalibrationType
+{
+  kLinear,
+  kPolynomial,
+  kTable
+};
+
+/**
+ * Parameters of a calibration, read from the project file
+ */
+struct CalibrationDefinition
+{
+  CalibrationType type;
+  double gain;
+  double offset;
+  QVector<double> coefficients;
+  QVector<QPair<double, double>> table;
+};
+
+/**
+ * Registers the given @a message in @a error (if not null) & returns
+ * @c false, used to report calibration errors in a single line.
+ */
+static bool FAIL(QString *error, const QString &message)
+{
+  if (error)
+    *error = message;
+
+  return false;
+}
+
+/**
+ * Reads the calibration parameters from the given JSON @a object & writes
+ * them to @a definition.
+ */
+static bool PARSE(const QJsonObject &object, CalibrationDefinition &definition,
+                  QString *error)
+{
+  const auto type = object.value("type").toString().toLower();
+
+  // Linear calibration
+  if (type == "linear")
+  {
+    definition.type = kLinear;
+    definition.gain = object.value("gain").toDouble(1);
+    definition.offset = object.value("offset").toDouble(0);
+    return true;
+  }
+
+  // Polynomial calibration
+  if (type == "polynomial")
+  {
+    definition.type = kPolynomial;
+    const auto coefficients = object.value("coefficients").toArray();
+    for (int i = 0; i < coefficients.count(); ++i)
+      definition.coefficients.append(coefficients.at(i).toDouble());
+
+    if (definition.coefficients.isEmpty())
+      return FAIL(error, QStringLiteral("polynomial without coefficients"));
+
+    return true;
+  }
+
+  // Lookup table
+  if (type == "table")
+  {
+    definition.type = kTable;
+    const auto table = object.value("table").toArray();
+    for (int i = 0; i < table.count(); ++i)
+    {
+      const auto point = table.at(i).toArray();
+      if (point.count() != 2)
+        return FAIL(error, QStringLiteral("table points must be [raw, value]"));
+
+      definition.table.append(
+          qMakePair(point.at(0).toDouble(), point.at(1).toDouble()));
+    }
+
+    // Sort points by raw value & reject duplicated points
+    std::sort(definition.table.begin(), definition.table.end());
+    for (int i = 1; i < definition.table.count(); ++i)
+    {
+      if (definition.table.at(i).first == definition.table.at(i - 1).first)
+        return FAIL(error, QStringLiteral("duplicated table point"));
+    }
+
+    if (definition.table.count() < 2)
+      return FAIL(error, QStringLiteral("table needs at least two points"));
+
+    return true;
+  }
+
+  // Invalid calibration type
+  return FAIL(error, QStringLiteral("unknown calibration \"%1\"").arg(type));
+}
+
+/**
+ * Obtains the range of @a targets (sorted by field) whose field is within
+ * [@a beginField, @a endField).
+ */
+template<typename T>
+static void RANGE(const QVector<T> &targets, const int beginField,
+                  const int endField, int &first, int &last)
+{
+  auto compare = [](const T &target, const int field) {
+    return target.field < field;
+  };
+
+  const auto begin = targets.constBegin();
+  const auto end = targets.constEnd();
+  first = std::lower_bound(begin, end, beginField, compare) - begin;
+  last = std::lower_bound(begin, end, endField, compare) - begin;
+}
+
+/**
+ * Constructor function
+ */
+JSON::Calibration::Calibration() {}
+
+/**
+ * Returns @c true if no dataset of the project is calibrated
+ */
+bool JSON::Calibration::isEmpty() const
+{
+  return m_linearTargets.isEmpty() && m_polynomialTargets.isEmpty()
+         && m_tableTargets.isEmpty();
+}
+
+/**
+ * Removes all the compiled calibrations
+ */
+void JSON::Calibration::clear()
+{
+  m_linearTargets.clear();
+  m_gains.clear();
+  m_offsets.clear();
+
+  m_polynomialTargets.clear();
+  m_coefficientOffsets.clear();
+  m_coefficients.clear();
+
+  m_tableTargets.clear();
+  m_tableOffsets.clear();
+  m_tableX.clear();
+  m_tableY.clear();
+
+  m_input.clear();
+  m_output.clear();
+}
+
+/**
+ * Compiles the calibrations of the datasets of the given @a frame. If a
+ * calibration is not valid, no dataset is calibrated, a description of the
+ * problem is written to @a error & @c false is returned.
+ */
+bool JSON::Calibration::compile(const Frame &frame, QString *error)
+{
+  // Remove previous calibrations
+  clear();
+
+  // Read the calibration of each dataset fed by the frame
+  QVector<QPair<Target, CalibrationDefinition>> items;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      const auto object = dataset.calibration();
+      if (object.isEmpty() || dataset.index() < 1)
+        continue;
+
+      CalibrationDefinition definition;
+      if (!PARSE(object, definition, error))
+      {
+        if (error)
+          *error = QStringLiteral("%1: %2").arg(dataset.title(), *error);
+
+        return false;
+      }
+
+      Target target;
+      target.field = dataset.index() - 1;
+      target.value = frame.valueIndex(i, j);
+      target.group = i;
+      target.dataset = j;
+      items.append(qMakePair(target, definition));
+    }
+  }
+
+  // Sort calibrations by field
+  std::stable_sort(items.begin(), items.end(),
+                   [](const QPair<Target, CalibrationDefinition> &a,
+                      const QPair<Target, CalibrationDefinition> &b) {
+                     return a.first.field < b.first.field;
+                   });
+
+  // Register the parameters of each calibration in its block
+  for (int i = 0; i < items.count(); ++i)
+  {
+    const auto &target = items.at(i).first;
+    const auto &definition = items.at(i).second;
+    switch (definition.type)
+    {
+      case kLinear:
+        m_linearTargets.append(target);
+        m_gains.append(definition.gain);
+        m_offsets.append(definition.offset);
+        break;
+      case kPolynomial:
+        m_polynomialTargets.append(target);
+        m_coefficientOffsets.append(m_coefficients.count());
+        m_coefficients.append(definition.coefficients);
+        break;
+      case kTable:
+        m_tableTargets.append(target);
+        m_tableOffsets.append(m_tableX.count());
+        for (int p = 0; p < definition.table.count(); ++p)
+        {
+          m_tableX.append(definition.table.at(p).first);
+          m_tableY.append(definition.table.at(p).second);
+        }
+        break;
+    }
+  }
+
+  // Terminate offset arrays, so that the end of each entry is always known
+  m_coefficientOffsets.append(m_coefficients.count());
+  m_tableOffsets.append(m_tableX.count());
+
+  // Allocate scratch buffers
+  const int size = qMax(m_linearTargets.count(),
+                        qMax(m_polynomialTargets.count(),
+                             m_tableTargets.count()));
+  m_input.resize(size);
+  m_output.resize(size);
+  return true;
+}
+
+/**
+ * Calibrates the values of the datasets of the given @a frame that are fed
+ * by the fields within [@a beginField, @a endField), e.g. the fields of the
+ * device that produced the frame.
+ *
+ * @note this function must only be called once after the values of the
+ *       fields have been updated, since the calibration is applied in place.
+ */
+void JSON::Calibration::apply(Frame &frame, const int beginField,
+                              const int endField)
+{
+  int first, last;
+
+  // Linear calibrations, compiles to a vectorized multiply-add loop
+  RANGE(m_linearTargets, beginField, endField, first, last);
+  if (first < last)
+  {
+    const int count = last - first;
+    const auto gains = m_gains.constData() + first;
+    const auto offsets = m_offsets.constData() + first;
+    const auto input = m_input.constData();
+    auto output = m_output.data();
+
+    gather(frame, m_linearTargets, first, last);
+    for (int i = 0; i < count; ++i)
+      output[i] = input[i] * gains[i] + offsets[i];
+
+    scatter(frame, m_linearTargets, first, last);
+  }
+
+  // Polynomial calibrations, evaluated with Horner's method
+  RANGE(m_polynomialTargets, beginField, endField, first, last);
+  if (first < last)
+  {
+    const int count = last - first;
+    const auto offsets = m_coefficientOffsets.constData() + first;
+    const auto coefficients = m_coefficients.constData();
+    const auto input = m_input.constData();
+    auto output = m_output.data();
+
+    gather(frame, m_polynomialTargets, first, last);
+    for (int i = 0; i < count; ++i)
+    {
+      double y = 0;
+      const double x = input[i];
+      for (int c = offsets[i + 1] - 1; c >= offsets[i]; --c)
+        y = y * x + coefficients[c];
+
+      output[i] = y;
+    }
+
+    scatter(frame, m_polynomialTargets, first, last);
+  }
+
+  // Lookup tables, interpolated linearly between the nearest points
+  RANGE(m_tableTargets, beginField, endField, first, last);
+  if (first < last)
+  {
+    const int count = last - first;
+    const auto offsets = m_tableOffsets.constData() + first;
+    const auto tx = m_tableX.constData();
+    const auto ty = m_tableY.constData();
+    const auto input = m_input.constData();
+    auto output = m_output.data();
+
+    gather(frame, m_tableTargets, first, last);
+    for (int i = 0; i < count; ++i)
+    {
+      const double x = input[i];
+      const int begin = offsets[i];
+      const int end = offsets[i + 1];
+      if (x <= tx[begin])
+        output[i] = ty[begin];
+      else if (x >= tx[end - 1])
+        output[i] = ty[end - 1];
+      else
+      {
+        const int p = std::upper_bound(tx + begin, tx + end, x) - tx;
+        const double t = (x - tx[p - 1]) / (tx[p] - tx[p - 1]);
+        output[i] = ty[p - 1] + t * (ty[p] - ty[p - 1]);
+      }
+    }
+
+    scatter(frame, m_tableTargets, first, last);
+  }
+}
+
+/**
+ * Returns @c true if the given calibration @a definition is valid, otherwise
+ * the problem is described in @a error.
+ */
+bool JSON::Calibration::validate(const QJsonObject &definition, QString *error)
+{
+  CalibrationDefinition parsed;
+  return definition.isEmpty() || PARSE(definition, parsed, error);
+}
+
+/**
+ * Copies the raw values of the given range of @a targets from the value
+ * table of the @a frame into the contiguous input buffer.
+ */
+void JSON::Calibration::gather(const Frame &frame,
+                               const QVector<Target> &targets,
+                               const int first, const int last)
+{
+  const auto values = frame.values().constData();
+  auto input = m_input.data();
+  for (int i = first; i < last; ++i)
+    input[i - first] = values[targets.at(i).value];
+}
+
+/**
+ * Writes the calibrated values of the given range of @a targets back to the
+ * @a frame, datasets with non-numeric values are left untouched.
+ */
+void JSON::Calibration::scatter(Frame &frame, const QVector<Target> &targets,
+                                const int first, const int last) const
+{
+  const auto output = m_output.constData();
+  for (int i = first; i < last; ++i)
+  {
+    const auto &target = targets.at(i);
+    const auto &group = frame.getGroup(target.group);
+    if (group.getDataset(target.dataset).isNumeric())
+      frame.setDatasetValue(target.group, target.dataset, output[i - first]);
+  }
+}
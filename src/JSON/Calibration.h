@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+namespace JSON
+{
+class Frame;
+
+/**
+ * @brief The Calibration class
+ *
+ * Converts the raw values of the datasets (e.g. ADC counts) to engineering
+ * units, as described by the optional @c calibration object of each dataset
+ * in the project file:
+ *
+ * @code
+ * { "type": "linear", "gain": 0.0125, "offset": -40 }
+ * { "type": "polynomial", "coefficients": [c0, c1, c2, ...] }
+ * { "type": "table", "table": [[raw, value], [raw, value], ...] }
+ * @endcode
+ *
+ * Polynomials are evaluated as c0 + c1 * x + c2 * x^2..., lookup tables are
+ * interpolated linearly & clamped to the first/last points.
+ *
+ * The calibrations are compiled when the project is loaded into one block per
+ * calibration type, with the parameters stored in contiguous arrays sorted by
+ * frame field. This way, the datasets fed by a device are calibrated with a
+ * single gather/compute/scatter pass over a contiguous range of each block,
+ * instead of evaluating the calibration of each value individually.
+ */
+class Calibration
+{
+public:
+  Calibration();
+
+  bool isEmpty() const;
+  void clear();
+
+  bool compile(const Frame &frame, QString *error = Q_NULLPTR);
+  void apply(Frame &frame, const int beginField, const int endField);
+
+  static bool validate(const QJsonObject &definition,
+                       QString *error = Q_NULLPTR);
+
+private:
+  struct Target
+  {
+    int field;
+    int value;
+    int group;
+    int dataset;
+  };
+
+  void scatter(Frame &frame, const QVector<Target> &targets, const int first,
+               const int last) const;
+  void gather(const Frame &frame, const QVector<Target> &targets,
+              const int first, const int last);
+
+private:
+  QVector<Target> m_linearTargets;
+  QVector<double> m_gains;
+  QVector<double> m_offsets;
+
+  QVector<Target> m_polynomialTargets;
+  QVector<int> m_coefficientOffsets;
+  QVector<double> m_coefficients;
+
+  QVector<Target> m_tableTargets;
+  QVector<int> m_tableOffsets;
+  QVector<double> m_tableX;
+  QVector<double> m_tableY;
+
+  QVector<double> m_input;
+  QVector<double> m_output;
+};
+} // namespace JSON
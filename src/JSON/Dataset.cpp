@@ -22,12 +22,16 @@
 
 #include <JSON/Dataset.h>
 #include <JSON/Generator.h>
+#include <JSON/NumberParser.h>
+#include <JSON/StringTable.h>
 
 JSON::Dataset::Dataset()
   : m_fft(false)
   , m_led(false)
   , m_log(false)
   , m_graph(false)
+  , m_numeric(false)
+  , m_numericValue(0)
   , m_title("")
   , m_value("")
   , m_units("")
@@ -37,6 +41,8 @@ JSON::Dataset::Dataset()
   , m_min(0)
   , m_alarm(0)
   , m_fftSamples(1024)
+  , m_points(0)
+  , m_sequenceBits(0)
 {
 }
 
@@ -80,6 +86,14 @@ bool JSON::Dataset::graph() const
   return m_graph;
 }
 
+/**
+ * @return @c true if the current value of the dataset is a number
+ */
+bool JSON::Dataset::isNumeric() const
+{
+  return m_numeric;
+}
+
 /**
  * Returns the minimum value of the dataset
  */
@@ -104,6 +118,17 @@ double JSON::Dataset::alarm() const
   return m_alarm;
 }
 
+/**
+ * Returns the current value of the dataset converted to a number, the
+ * conversion is done once when the value is set, so widgets do not need to
+ * parse the value string for every frame. Returns 0 if the value is not
+ * numeric.
+ */
+double JSON::Dataset::numericValue() const
+{
+  return m_numericValue;
+}
+
 /**
  * @return The title/description of this dataset
  */
@@ -145,11 +170,79 @@ int JSON::Dataset::fftSamples() const
 }
 
 /**
- * Returns the JSON data that represents this widget
+ * @return The number of samples kept in the plot history of the dataset, zero
+ *         if the history uses the number of points selected in the dashboard.
+ */
+int JSON::Dataset::points() const
+{
+  return m_points;
+}
+
+/**
+ * @return The width (in bits) of the frame counter carried by the dataset,
+ *         zero if the dataset is not a sequence counter.
+ */
+int JSON::Dataset::sequenceBits() const
+{
+  return m_sequenceBits;
+}
+
+/**
+ * @return The calibration used to convert the raw value of the dataset to
+ *         engineering units (see @c JSON::Calibration), empty if the value
+ *         is not calibrated.
+ */
+QJsonObject JSON::Dataset::calibration() const
+{
+  return m_calibration;
+}
+
+/**
+ * @return The rules used to raise alarms with the value of the dataset (see
+ *         @c JSON::AlarmEngine), empty if the dataset has no alarms.
+ */
+QJsonObject JSON::Dataset::alarmRules() const
+{
+  return m_alarmRules;
+}
+
+/**
+ * @return The expression used to compute the value of the dataset from the
+ *         values of other datasets (see @c JSON::Expression), empty if the
+ *         dataset is fed by the received frames.
+ */
+QString JSON::Dataset::expression() const
+{
+  return m_expression;
+}
+
+/**
+ * @return The policy used to select the value of the dataset when frames are
+ *         decimated (see @c JSON::Decimator), empty for the default policy.
+ */
+QString JSON::Dataset::decimation() const
+{
+  return m_decimation;
+}
+
+/**
+ * @return The Modbus register polled to obtain the value of the dataset (see
+ *         @c IO::ModbusScheduler), empty if the dataset is not polled.
+ */
+QJsonObject JSON::Dataset::modbus() const
+{
+  return m_modbus;
+}
+
+/**
+ * Returns the JSON data that represents this widget, including the current
+ * value of the dataset.
  */
 QJsonObject JSON::Dataset::jsonData() const
 {
-  return m_jsonData;
+  auto object = m_jsonData;
+  object.insert("value", m_value);
+  return object;
 }
 
 /**
@@ -170,17 +263,69 @@ bool JSON::Dataset::read(const QJsonObject &object)
     m_index = object.value("index").toInt();
     m_alarm = object.value("alarm").toDouble();
     m_graph = object.value("graph").toBool();
-    m_title = object.value("title").toString();
-    m_value = object.value("value").toString();
-    m_units = object.value("units").toString();
-    m_widget = object.value("widget").toString();
+    m_title = StringTable::intern(object.value("title").toString());
+    m_value = object.value("value").toVariant().toString();
+    m_units = StringTable::intern(object.value("units").toString());
+    m_widget = StringTable::intern(object.value("widget").toString());
     m_fftSamples = object.value("fftSamples").toInt();
+    m_points = qMax(0, object.value("points").toInt());
+    m_sequenceBits = qBound(0, object.value("sequenceBits").toInt(), 64);
+    m_calibration = object.value("calibration").toObject();
+    m_alarmRules = object.value("alarmRules").toObject();
+    m_expression = object.value("expression").toString();
+    m_decimation = object.value("decimation").toString();
+    m_modbus = object.value("modbus").toObject();
 
     if (m_value.isEmpty())
       m_value = "--.--";
 
+    m_numeric = NumberParser::parse(m_value, &m_numericValue);
+    m_jsonData = object;
     return true;
   }
 
   return false;
 }
+
+/**
+ * Changes the current value of the dataset, this allows the JSON generator to
+ * update a pre-built frame without parsing any JSON data.
+ */
+void JSON::Dataset::setValue(const QString &value)
+{
+  if (value.isEmpty())
+    m_value = "--.--";
+  else
+    m_value = value;
+
+  m_numeric = NumberParser::parse(m_value, &m_numericValue);
+}
+
+/**
+ * Changes the current value of the dataset to the given UTF-8 @a data, the
+ * numeric value is obtained directly from the raw bytes.
+ */
+void JSON::Dataset::setValue(const char *data, const int length)
+{
+  if (length <= 0)
+  {
+    m_value = "--.--";
+    m_numeric = false;
+    m_numericValue = 0;
+    return;
+  }
+
+  m_value = QString::fromUtf8(data, length);
+  m_numeric = NumberParser::parse(data, length, &m_numericValue);
+}
+
+/**
+ * Changes the current value of the dataset to the given number, used by the
+ * native binary decoder to skip the conversion of the value from text.
+ */
+void JSON::Dataset::setValue(const double value)
+{
+  m_value = QString::number(value, 'g', 12);
+  m_numeric = true;
+  m_numericValue = value;
+}
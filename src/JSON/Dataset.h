@@ -63,6 +63,14 @@ namespace JSON
  * - Min: minimum value of the dataset, used for gauges & bars.
  * - Alarm: if the value exceeds the alarm level, bar widgets
  *          shall be rendered with a dark-red background.
+ * - Alarm rules: limits evaluated by the @c AlarmEngine with each
+ *                frame, the resulting events are logged & published.
+ * - Decimation: value kept when the frame rate of the live consumers is
+ *               reduced by the @c Decimator (last, mean, min or max).
+ * - Points: number of samples kept in the plot history of the dataset,
+ *           zero uses the number of points selected in the dashboard.
+ * - Sequence bits: width of the frame counter carried by the dataset, used
+ *                  to detect lost frames (zero if it is not a counter).
  *
  * @note All of the dataset fields are optional, except the "value"
  *       field and the "title" field.
@@ -77,17 +85,29 @@ public:
   bool log() const;
   int index() const;
   bool graph() const;
+  bool isNumeric() const;
   double min() const;
   double max() const;
   double alarm() const;
+  double numericValue() const;
   QString title() const;
   QString value() const;
   QString units() const;
   QString widget() const;
   int fftSamples() const;
+  int points() const;
+  int sequenceBits() const;
+  QJsonObject calibration() const;
+  QJsonObject alarmRules() const;
+  QString expression() const;
+  QString decimation() const;
+  QJsonObject modbus() const;
   QJsonObject jsonData() const;
 
   bool read(const QJsonObject &object);
+  void setValue(const QString &value);
+  void setValue(const double value);
+  void setValue(const char *data, const int length);
   void setTitle(const QString &title) { m_title = title; }
 
 private:
@@ -95,12 +115,19 @@ private:
   bool m_led;
   bool m_log;
   bool m_graph;
+  bool m_numeric;
+  double m_numericValue;
 
   QString m_title;
   QString m_value;
   QString m_units;
   QString m_widget;
   QJsonObject m_jsonData;
+  QJsonObject m_calibration;
+  QJsonObject m_alarmRules;
+  QString m_expression;
+  QString m_decimation;
+  QJsonObject m_modbus;
 
   // Editor-related variables
   int m_index;
@@ -108,7 +135,10 @@ private:
   double m_min;
   double m_alarm;
   int m_fftSamples;
+  int m_points;
+  int m_sequenceBits;
 
+  friend class Frame;
   friend class Project::Model;
 };
 } // namespace JSON
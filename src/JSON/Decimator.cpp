@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtNumeric>
+#include <QStringList>
+
+#include <JSON/Frame.h>
+#include <JSON/Decimator.h>
+
+/**
+ * Highest decimation factor accepted in the project file
+ */
+static const int MAX_FACTOR = 10000;
+
+/**
+ * Constructor function, frames are not decimated until a project is compiled
+ */
+JSON::Decimator::Decimator()
+  : m_factor(1)
+  , m_count(0)
+{
+}
+
+/**
+ * Returns the number of generated frames that are merged into each published
+ * frame, 1 if frames are not decimated.
+ */
+int JSON::Decimator::factor() const
+{
+  return m_factor;
+}
+
+/**
+ * Returns @c true if frames are published at the rate at which they are
+ * generated.
+ */
+bool JSON::Decimator::isEmpty() const
+{
+  return m_factor <= 1;
+}
+
+/**
+ * Disables decimation & removes the compiled dataset policies
+ */
+void JSON::Decimator::clear()
+{
+  m_factor = 1;
+  m_count = 0;
+  m_groups.clear();
+  m_values.clear();
+  m_datasets.clear();
+  m_policies.clear();
+  m_samples.clear();
+  m_results.clear();
+}
+
+/**
+ * Builds the policy table for the datasets of the given @a frame, which
+ * shall be decimated by the given @a factor.
+ *
+ * @return @c false if the factor or the policy of a dataset is not valid, in
+ *         which case frames are not decimated.
+ */
+bool JSON::Decimator::compile(const Frame &frame, const int factor,
+                              QString *error)
+{
+  // Remove previous configuration
+  clear();
+  if (!validate(factor, error))
+    return false;
+
+  // Decimation disabled
+  if (factor <= 1)
+    return true;
+
+  // Register the datasets that are not sampled at the end of the interval
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      if (!validate(dataset.decimation(), error))
+      {
+        if (error)
+          *error = QStringLiteral("%1: %2").arg(dataset.title(), *error);
+
+        clear();
+        return false;
+      }
+
+      const auto mode = policy(dataset.decimation());
+      if (mode == Policy::Last)
+        continue;
+
+      m_groups.append(i);
+      m_datasets.append(j);
+      m_policies.append(mode);
+      m_values.append(frame.valueIndex(i, j));
+    }
+  }
+
+  // Initialize accumulators
+  m_factor = factor;
+  m_samples.fill(0, m_policies.count());
+  m_results.fill(0, m_policies.count());
+  return true;
+}
+
+/**
+ * Accumulates the values of the @a input frames & appends a frame to
+ * @a output each time that a decimation interval is completed.
+ *
+ * Accumulators are kept between calls, so intervals may span several batches.
+ */
+void JSON::Decimator::process(const QVector<Frame> &input,
+                              QVector<Frame> &output)
+{
+  const int rules = m_policies.count();
+  for (int i = 0; i < input.count(); ++i)
+  {
+    // Accumulate the values of the frame, skipping non-numeric values
+    const auto &frame = input.at(i);
+    const auto &values = frame.values();
+    for (int r = 0; r < rules; ++r)
+    {
+      const int index = m_values.at(r);
+      if (index < 0 || index >= values.count())
+        continue;
+
+      const double value = values.at(index);
+      if (qIsNaN(value))
+        continue;
+
+      auto &result = m_results[r];
+      if (m_samples.at(r) == 0)
+        result = value;
+      else if (m_policies.at(r) == Policy::Mean)
+        result += value;
+      else if (m_policies.at(r) == Policy::Min)
+        result = qMin(result, value);
+      else if (m_policies.at(r) == Policy::Max)
+        result = qMax(result, value);
+
+      ++m_samples[r];
+    }
+
+    // Interval not completed yet
+    if (++m_count < m_factor)
+      continue;
+
+    // Publish the last frame of the interval with the accumulated values
+    auto decimated = frame;
+    for (int r = 0; r < rules; ++r)
+    {
+      const int samples = m_samples.at(r);
+      if (samples == 0 || m_values.at(r) >= values.count())
+        continue;
+
+      double result = m_results.at(r);
+      if (m_policies.at(r) == Policy::Mean)
+        result /= samples;
+
+      decimated.setDatasetValue(m_groups.at(r), m_datasets.at(r), result);
+      m_samples[r] = 0;
+    }
+
+    output.append(decimated);
+    m_count = 0;
+  }
+}
+
+/**
+ * Returns @c true if the given decimation @a factor can be used, 1 (or 0,
+ * the default of a project without the @c decimation key) disables
+ * decimation.
+ */
+bool JSON::Decimator::validate(const int factor, QString *error)
+{
+  if (factor >= 0 && factor <= MAX_FACTOR)
+    return true;
+
+  if (error)
+    *error = QStringLiteral("decimation factor must be between 1 and %1")
+                 .arg(MAX_FACTOR);
+
+  return false;
+}
+
+/**
+ * Returns @c true if the given dataset decimation @a policy is known, an
+ * empty policy is equivalent to @c last.
+ */
+bool JSON::Decimator::validate(const QString &policy, QString *error)
+{
+  static const QStringList policies = {"", "last", "mean", "min", "max"};
+  if (policies.contains(policy))
+    return true;
+
+  if (error)
+    *error = QStringLiteral("unknown decimation policy \"%1\"").arg(policy);
+
+  return false;
+}
+
+/**
+ * Returns the policy that corresponds to the given validated policy @a name
+ */
+JSON::Decimator::Policy JSON::Decimator::policy(const QString &name)
+{
+  if (name == QStringLiteral("mean"))
+    return Policy::Mean;
+  if (name == QStringLiteral("min"))
+    return Policy::Min;
+  if (name == QStringLiteral("max"))
+    return Policy::Max;
+
+  return Policy::Last;
+}
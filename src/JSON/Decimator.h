@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+namespace JSON
+{
+class Frame;
+
+/**
+ * @brief The Decimator class
+ *
+ * Reduces the rate of the frames published to the live consumers (dashboard,
+ * MQTT & plugins) by the decimation factor given by the @c decimation key of
+ * the project file. One frame is published for every N generated frames, the
+ * full-rate stream is still available to the CSV export & the other modules
+ * that record data.
+ *
+ * The value that each dataset takes in the published frame is selected by
+ * the @c decimation key of the dataset:
+ *
+ * - @c last: value of the last frame of the interval (default).
+ * - @c mean: average of the values received during the interval.
+ * - @c min & @c max: extreme values received during the interval, useful to
+ *   keep spikes visible in the decimated stream.
+ *
+ * Only the datasets with a policy other than @c last are accumulated, the
+ * rest of the published frame is a shared copy of the last generated frame.
+ */
+class Decimator
+{
+public:
+  enum class Policy
+  {
+    Last,
+    Mean,
+    Min,
+    Max
+  };
+
+  Decimator();
+
+  int factor() const;
+  bool isEmpty() const;
+  void clear();
+
+  bool compile(const Frame &frame, const int factor,
+               QString *error = Q_NULLPTR);
+  void process(const QVector<Frame> &input, QVector<Frame> &output);
+
+  static bool validate(const int factor, QString *error = Q_NULLPTR);
+  static bool validate(const QString &policy, QString *error = Q_NULLPTR);
+
+private:
+  static Policy policy(const QString &name);
+
+private:
+  int m_factor;
+  int m_count;
+
+  QVector<int> m_groups;
+  QVector<int> m_values;
+  QVector<int> m_datasets;
+  QVector<Policy> m_policies;
+
+  QVector<int> m_samples;
+  QVector<double> m_results;
+};
+} // namespace JSON
@@ -0,0 +1,690 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <QtMath>
+#include <QtNumeric>
+
+#include <JSON/Frame.h>
+#include <JSON/Expression.h>
+
+typedef JSON::Expression::OpCode OpCode;
+typedef JSON::Expression::Instruction Instruction;
+
+//
+// Functions with a single argument
+//
+static const struct
+{
+  const char *name;
+  double (*function)(double);
+} FUNCTIONS_1[] = {
+    {"sqrt", [](double x) { return std::sqrt(x); }},
+    {"abs", [](double x) { return std::fabs(x); }},
+    {"sin", [](double x) { return std::sin(x); }},
+    {"cos", [](double x) { return std::cos(x); }},
+    {"tan", [](double x) { return std::tan(x); }},
+    {"asin", [](double x) { return std::asin(x); }},
+    {"acos", [](double x) { return std::acos(x); }},
+    {"atan", [](double x) { return std::atan(x); }},
+    {"exp", [](double x) { return std::exp(x); }},
+    {"log", [](double x) { return std::log(x); }},
+    {"log10", [](double x) { return std::log10(x); }},
+    {"floor", [](double x) { return std::floor(x); }},
+    {"ceil", [](double x) { return std::ceil(x); }},
+    {"round", [](double x) { return std::round(x); }},
+};
+
+//
+// Functions with two arguments
+//
+static const struct
+{
+  const char *name;
+  double (*function)(double, double);
+} FUNCTIONS_2[] = {
+    {"atan2", [](double y, double x) { return std::atan2(y, x); }},
+    {"pow", [](double x, double y) { return std::pow(x, y); }},
+    {"min", [](double a, double b) { return qMin(a, b); }},
+    {"max", [](double a, double b) { return qMax(a, b); }},
+    {"hypot", [](double x, double y) { return std::hypot(x, y); }},
+};
+
+static const int FUNCTION_1_COUNT
+    = sizeof(FUNCTIONS_1) / sizeof(FUNCTIONS_1[0]);
+static const int FUNCTION_2_COUNT
+    = sizeof(FUNCTIONS_2) / sizeof(FUNCTIONS_2[0]);
+
+//
+// Maximum window of the moving average function
+//
+static const int MAX_AVERAGE_WINDOW = 100000;
+
+/**
+ * Recursive descent parser that translates the text of an expression into
+ * stack-based bytecode.
+ */
+class ExpressionParser
+{
+public:
+  ExpressionParser(const QString &text, const JSON::Frame &frame)
+    : m_text(text)
+    , m_frame(frame)
+    , m_pos(0)
+    , m_depth(0)
+    , m_maxDepth(0)
+    , m_stateSize(0)
+  {
+  }
+
+  /**
+   * Parses the whole expression, returns @c false on error
+   */
+  bool parse()
+  {
+    if (!expression())
+      return false;
+
+    skip();
+    if (m_pos < m_text.length())
+      return fail(QStringLiteral("unexpected \"%1\"").arg(m_text.at(m_pos)));
+
+    return true;
+  }
+
+  QString error() const { return m_error; }
+  int stackSize() const { return m_maxDepth; }
+  int stateSize() const { return m_stateSize; }
+  const QVector<Instruction> &code() const { return m_code; }
+
+private:
+  /**
+   * Registers the given error @a message (with the position at which the
+   * error was found) & returns @c false.
+   */
+  bool fail(const QString &message)
+  {
+    if (m_error.isEmpty())
+      m_error = QStringLiteral("%1 (column %2)").arg(message).arg(m_pos + 1);
+
+    return false;
+  }
+
+  /**
+   * Appends an instruction to the bytecode, @a delta is the change in the
+   * number of values stored in the stack after executing it.
+   */
+  void generate(const OpCode op, const int arg, const double constant,
+                const int delta)
+  {
+    Instruction instruction;
+    instruction.op = op;
+    instruction.arg = arg;
+    instruction.constant = constant;
+    m_code.append(instruction);
+
+    m_depth += delta;
+    m_maxDepth = qMax(m_maxDepth, m_depth);
+  }
+
+  /**
+   * Skips whitespace characters
+   */
+  void skip()
+  {
+    while (m_pos < m_text.length() && m_text.at(m_pos).isSpace())
+      ++m_pos;
+  }
+
+  /**
+   * Skips whitespace & consumes the given character if found
+   */
+  bool accept(const QChar c)
+  {
+    skip();
+    if (m_pos < m_text.length() && m_text.at(m_pos) == c)
+    {
+      ++m_pos;
+      return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * Consumes the given character or fails
+   */
+  bool expect(const QChar c)
+  {
+    if (accept(c))
+      return true;
+
+    return fail(QStringLiteral("expected \"%1\"").arg(c));
+  }
+
+  /**
+   * expression := term (('+' | '-') term)*
+   */
+  bool expression()
+  {
+    if (!term())
+      return false;
+
+    while (true)
+    {
+      if (accept('+'))
+      {
+        if (!term())
+          return false;
+
+        generate(OpCode::Add, 0, 0, -1);
+      }
+
+      else if (accept('-'))
+      {
+        if (!term())
+          return false;
+
+        generate(OpCode::Subtract, 0, 0, -1);
+      }
+
+      else
+        return true;
+    }
+  }
+
+  /**
+   * term := unary (('*' | '/' | '%') unary)*
+   */
+  bool term()
+  {
+    if (!unary())
+      return false;
+
+    while (true)
+    {
+      OpCode op;
+      if (accept('*'))
+        op = OpCode::Multiply;
+      else if (accept('/'))
+        op = OpCode::Divide;
+      else if (accept('%'))
+        op = OpCode::Modulo;
+      else
+        return true;
+
+      if (!unary())
+        return false;
+
+      generate(op, 0, 0, -1);
+    }
+  }
+
+  /**
+   * unary := ('-' | '+') unary | power
+   */
+  bool unary()
+  {
+    if (accept('-'))
+    {
+      if (!unary())
+        return false;
+
+      generate(OpCode::Negate, 0, 0, 0);
+      return true;
+    }
+
+    if (accept('+'))
+      return unary();
+
+    return power();
+  }
+
+  /**
+   * power := primary ('^' unary)?, the operator is right-associative
+   */
+  bool power()
+  {
+    if (!primary())
+      return false;
+
+    if (accept('^'))
+    {
+      if (!unary())
+        return false;
+
+      generate(OpCode::Power, 0, 0, -1);
+    }
+
+    return true;
+  }
+
+  /**
+   * primary := number | '$' index | '[' title ']' | '(' expression ')'
+   *          | function '(' arguments ')' | constant
+   */
+  bool primary()
+  {
+    skip();
+    if (m_pos >= m_text.length())
+      return fail(QStringLiteral("unexpected end of expression"));
+
+    // Sub-expression
+    const auto c = m_text.at(m_pos);
+    if (accept('('))
+      return expression() && expect(')');
+
+    // Number
+    if (c.isDigit() || c == '.')
+    {
+      double value;
+      if (!number(value))
+        return false;
+
+      generate(OpCode::Constant, 0, value, 1);
+      return true;
+    }
+
+    // Dataset referenced by frame index
+    if (accept('$'))
+    {
+      const int start = m_pos;
+      while (m_pos < m_text.length() && m_text.at(m_pos).isDigit())
+        ++m_pos;
+
+      const int index = m_text.mid(start, m_pos - start).toInt();
+      for (int i = 0; i < m_frame.groupCount(); ++i)
+      {
+        const auto &group = m_frame.getGroup(i);
+        for (int j = 0; j < group.datasetCount(); ++j)
+        {
+          if (index > 0 && group.getDataset(j).index() == index)
+            return reference(i, j);
+        }
+      }
+
+      return fail(QStringLiteral("no dataset with index %1").arg(index));
+    }
+
+    // Dataset referenced by title
+    if (accept('['))
+    {
+      const int end = m_text.indexOf(']', m_pos);
+      if (end < 0)
+        return fail(QStringLiteral("expected \"]\""));
+
+      const auto title = m_text.mid(m_pos, end - m_pos).trimmed();
+      m_pos = end + 1;
+      for (int i = 0; i < m_frame.groupCount(); ++i)
+      {
+        const auto &group = m_frame.getGroup(i);
+        for (int j = 0; j < group.datasetCount(); ++j)
+        {
+          if (group.getDataset(j).title() == title)
+            return reference(i, j);
+        }
+      }
+
+      return fail(QStringLiteral("no dataset named \"%1\"").arg(title));
+    }
+
+    // Function or constant
+    if (c.isLetter() || c == '_')
+    {
+      const int start = m_pos;
+      while (m_pos < m_text.length()
+             && (m_text.at(m_pos).isLetterOrNumber()
+                 || m_text.at(m_pos) == '_'))
+        ++m_pos;
+
+      const auto name = m_text.mid(start, m_pos - start);
+      if (accept('('))
+        return function(name);
+
+      if (name == "pi")
+      {
+        generate(OpCode::Constant, 0, M_PI, 1);
+        return true;
+      }
+
+      if (name == "e")
+      {
+        generate(OpCode::Constant, 0, M_E, 1);
+        return true;
+      }
+
+      return fail(QStringLiteral("unknown identifier \"%1\"").arg(name));
+    }
+
+    return fail(QStringLiteral("unexpected \"%1\"").arg(c));
+  }
+
+  /**
+   * Emits the instruction that reads the value of the given @a dataset
+   */
+  bool reference(const int group, const int dataset)
+  {
+    generate(OpCode::Value, m_frame.valueIndex(group, dataset), 0, 1);
+    return true;
+  }
+
+  /**
+   * Reads a number literal, including the optional exponent
+   */
+  bool number(double &value)
+  {
+    const int start = m_pos;
+    while (m_pos < m_text.length()
+           && (m_text.at(m_pos).isDigit() || m_text.at(m_pos) == '.'))
+      ++m_pos;
+
+    // Exponent
+    if (m_pos < m_text.length() && m_text.at(m_pos).toLower() == 'e')
+    {
+      int pos = m_pos + 1;
+      if (pos < m_text.length()
+          && (m_text.at(pos) == '+' || m_text.at(pos) == '-'))
+        ++pos;
+
+      if (pos < m_text.length() && m_text.at(pos).isDigit())
+      {
+        m_pos = pos;
+        while (m_pos < m_text.length() && m_text.at(m_pos).isDigit())
+          ++m_pos;
+      }
+    }
+
+    bool ok;
+    value = m_text.mid(start, m_pos - start).toDouble(&ok);
+    if (!ok)
+      return fail(QStringLiteral("invalid number"));
+
+    return true;
+  }
+
+  /**
+   * Parses the arguments of the given function (the opening parenthesis has
+   * already been consumed) & emits the corresponding instruction.
+   */
+  bool function(const QString &name)
+  {
+    // Moving average, the window must be a constant
+    if (name == "avg")
+    {
+      double window;
+      if (!expression() || !expect(','))
+        return false;
+
+      skip();
+      if (!number(window) || !expect(')'))
+        return false;
+
+      const int n = static_cast<int>(window);
+      if (n < 1 || n > MAX_AVERAGE_WINDOW)
+        return fail(QStringLiteral("invalid moving average window"));
+
+      generate(OpCode::Average, m_stateSize, n, 0);
+      m_stateSize += 3 + n;
+      return true;
+    }
+
+    // Derivative & integral
+    if (name == "deriv" || name == "integ")
+    {
+      if (!expression() || !expect(')'))
+        return false;
+
+      const auto op = name == "deriv" ? OpCode::Derivative : OpCode::Integral;
+      generate(op, m_stateSize, 0, 0);
+      m_stateSize += 4;
+      return true;
+    }
+
+    // Functions with a single argument
+    for (int i = 0; i < FUNCTION_1_COUNT; ++i)
+    {
+      if (name == QLatin1String(FUNCTIONS_1[i].name))
+      {
+        if (!expression() || !expect(')'))
+          return false;
+
+        generate(OpCode::Function1, i, 0, 0);
+        return true;
+      }
+    }
+
+    // Functions with two arguments
+    for (int i = 0; i < FUNCTION_2_COUNT; ++i)
+    {
+      if (name == QLatin1String(FUNCTIONS_2[i].name))
+      {
+        if (!expression() || !expect(',') || !expression() || !expect(')'))
+          return false;
+
+        generate(OpCode::Function2, i, 0, -1);
+        return true;
+      }
+    }
+
+    return fail(QStringLiteral("unknown function \"%1\"").arg(name));
+  }
+
+private:
+  const QString &m_text;
+  const JSON::Frame &m_frame;
+
+  int m_pos;
+  int m_depth;
+  int m_maxDepth;
+  int m_stateSize;
+  QString m_error;
+  QVector<Instruction> m_code;
+};
+
+/**
+ * Constructor function, creates an empty expression
+ */
+JSON::Expression::Expression() {}
+
+/**
+ * Returns @c true if no expression has been compiled
+ */
+bool JSON::Expression::isEmpty() const
+{
+  return m_code.isEmpty();
+}
+
+/**
+ * Resets the state of the stateful functions (moving averages, derivatives
+ * & integrals) of the expression.
+ */
+void JSON::Expression::reset()
+{
+  m_state.fill(0);
+}
+
+/**
+ * Compiles the given expression @a text, dataset references are resolved
+ * with the groups & datasets of the given @a frame. On failure, the
+ * expression is left empty & a description of the problem is written to
+ * @a error.
+ */
+bool JSON::Expression::compile(const QString &text, const Frame &frame,
+                               QString *error)
+{
+  // Remove previous expression
+  m_code.clear();
+  m_stack.clear();
+  m_state.clear();
+
+  // Parse the expression
+  ExpressionParser parser(text, frame);
+  if (!parser.parse())
+  {
+    if (error)
+      *error = parser.error();
+
+    return false;
+  }
+
+  // Register bytecode & allocate the stack and the state of the functions
+  m_code = parser.code();
+  m_stack.resize(qMax(1, parser.stackSize()));
+  m_state.fill(0, parser.stateSize());
+  return true;
+}
+
+/**
+ * Evaluates the expression with the given value table (see
+ * @c Frame::values()) & the given @a timestamp (in microseconds), which is
+ * used by the derivative & integral functions.
+ */
+double JSON::Expression::evaluate(const double *values, const qint64 timestamp)
+{
+  // Nothing to evaluate
+  if (m_code.isEmpty())
+    return qQNaN();
+
+  // Initialize parameters
+  int top = -1;
+  auto stack = m_stack.data();
+  auto state = m_state.data();
+  const auto code = m_code.constData();
+  const double time = static_cast<double>(timestamp) / 1e6;
+
+  // Execute each instruction
+  for (int i = 0; i < m_code.count(); ++i)
+  {
+    const auto &instruction = code[i];
+    switch (instruction.op)
+    {
+      case OpCode::Constant:
+        stack[++top] = instruction.constant;
+        break;
+      case OpCode::Value:
+        stack[++top] = values[instruction.arg];
+        break;
+      case OpCode::Add:
+        stack[top - 1] += stack[top];
+        --top;
+        break;
+      case OpCode::Subtract:
+        stack[top - 1] -= stack[top];
+        --top;
+        break;
+      case OpCode::Multiply:
+        stack[top - 1] *= stack[top];
+        --top;
+        break;
+      case OpCode::Divide:
+        stack[top - 1] /= stack[top];
+        --top;
+        break;
+      case OpCode::Modulo:
+        stack[top - 1] = std::fmod(stack[top - 1], stack[top]);
+        --top;
+        break;
+      case OpCode::Power:
+        stack[top - 1] = std::pow(stack[top - 1], stack[top]);
+        --top;
+        break;
+      case OpCode::Negate:
+        stack[top] = -stack[top];
+        break;
+      case OpCode::Function1:
+        stack[top] = FUNCTIONS_1[instruction.arg].function(stack[top]);
+        break;
+      case OpCode::Function2:
+        stack[top - 1] = FUNCTIONS_2[instruction.arg].function(stack[top - 1],
+                                                               stack[top]);
+        --top;
+        break;
+      case OpCode::Average: {
+        // State: running sum, sample count, ring position & ring buffer
+        auto s = state + instruction.arg;
+        auto ring = s + 3;
+        const double x = stack[top];
+        const int n = static_cast<int>(instruction.constant);
+        if (!qIsNaN(x))
+        {
+          const int head = static_cast<int>(s[2]);
+          if (s[1] >= n)
+            s[0] -= ring[head];
+          else
+            s[1] += 1;
+
+          ring[head] = x;
+          s[0] += x;
+          s[2] = (head + 1) % n;
+        }
+
+        stack[top] = s[1] > 0 ? s[0] / s[1] : qQNaN();
+        break;
+      }
+      case OpCode::Derivative: {
+        // State: initialized flag, last value, last time & last result
+        auto s = state + instruction.arg;
+        const double x = stack[top];
+        if (s[0] == 0)
+        {
+          s[0] = 1;
+          s[1] = x;
+          s[2] = time;
+          s[3] = 0;
+        }
+
+        else if (time > s[2])
+        {
+          s[3] = (x - s[1]) / (time - s[2]);
+          s[1] = x;
+          s[2] = time;
+        }
+
+        stack[top] = s[3];
+        break;
+      }
+      case OpCode::Integral: {
+        // State: initialized flag, last value, last time & accumulated value
+        auto s = state + instruction.arg;
+        const double x = stack[top];
+        if (s[0] == 0)
+        {
+          s[0] = 1;
+          s[1] = x;
+          s[2] = time;
+        }
+
+        else if (time > s[2])
+        {
+          s[3] += 0.5 * (x + s[1]) * (time - s[2]);
+          s[1] = x;
+          s[2] = time;
+        }
+
+        stack[top] = s[3];
+        break;
+      }
+    }
+  }
+
+  return stack[0];
+}
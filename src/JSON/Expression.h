@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+namespace JSON
+{
+class Frame;
+
+/**
+ * @brief The Expression class
+ *
+ * Compiled expression of a computed (virtual) dataset, e.g.
+ * @c sqrt($1^2 + $2^2 + $3^2) or @c avg([Temperature], 10).
+ *
+ * Expressions may reference the values of other datasets by frame index
+ * (@c $n) or by title (@c [title]), and support the usual arithmetic
+ * operators (@c + @c - @c * @c / @c % @c ^), the constants @c pi and @c e &
+ * the following functions:
+ *
+ * - @c sqrt, @c abs, @c sin, @c cos, @c tan, @c asin, @c acos, @c atan,
+ *   @c exp, @c log, @c log10, @c floor, @c ceil, @c round
+ * - @c atan2(y,x), @c pow(x,y), @c min(a,b), @c max(a,b), @c hypot(x,y)
+ * - @c avg(x,n): moving average of the last @a n values of @a x
+ * - @c deriv(x): derivative of @a x with respect to time (units/second)
+ * - @c integ(x): integral of @a x with respect to time (trapezoidal rule)
+ *
+ * The expression is parsed once into a compact stack-based bytecode, in
+ * which dataset references are resolved to positions in the value table of
+ * the frame (see @c Frame::values()). Stateful functions keep their state in
+ * the expression object & are updated incrementally with each frame.
+ */
+class Expression
+{
+public:
+  Expression();
+
+  bool isEmpty() const;
+  void reset();
+
+  bool compile(const QString &text, const Frame &frame,
+               QString *error = Q_NULLPTR);
+  double evaluate(const double *values, const qint64 timestamp);
+
+  enum class OpCode : quint8
+  {
+    Constant,
+    Value,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Power,
+    Negate,
+    Function1,
+    Function2,
+    Average,
+    Derivative,
+    Integral
+  };
+
+  struct Instruction
+  {
+    OpCode op;
+    int arg;
+    double constant;
+  };
+
+private:
+  QVector<Instruction> m_code;
+  QVector<double> m_stack;
+  QVector<double> m_state;
+};
+} // namespace JSON
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <JSON/FieldSplitter.h>
+
+/**
+ * Constructor function, configures the splitter to use the given @a separator
+ */
+JSON::FieldSplitter::FieldSplitter(const QByteArray &separator)
+  : m_scanner(separator)
+{
+}
+
+/**
+ * Returns the separator sequence used to split frames
+ */
+const QByteArray &JSON::FieldSplitter::separator() const
+{
+  return m_scanner.sequence();
+}
+
+/**
+ * Changes the separator sequence used to split frames
+ */
+void JSON::FieldSplitter::setSeparator(const QByteArray &separator)
+{
+  m_scanner.setSequence(separator);
+}
+
+/**
+ * Splits the given @a frame and writes the position of each field to
+ * @a fields. The vector is cleared first, but its memory is reused in order to
+ * avoid allocations when frames are processed in a loop.
+ *
+ * If the separator is empty, the complete frame is returned as a single field.
+ *
+ * @returns the number of fields found in the frame.
+ */
+int JSON::FieldSplitter::split(const QByteArray &frame,
+                               QVector<FieldSpan> &fields) const
+{
+  // Reset output
+  fields.resize(0);
+
+  // Initialize parameters
+  const char *data = frame.constData();
+  const int length = frame.length();
+  const int separatorLength = separator().length();
+
+  // Find each separator & register the field that precedes it
+  int offset = 0;
+  if (separatorLength > 0)
+  {
+    int index;
+    while ((index = m_scanner.find(data + offset, length - offset)) >= 0)
+    {
+      fields.append({offset, index});
+      offset += index + separatorLength;
+    }
+  }
+
+  // Register the last field
+  fields.append({offset, length - offset});
+  return fields.count();
+}
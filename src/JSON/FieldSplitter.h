@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QByteArray>
+#include <IO/DelimiterScanner.h>
+
+namespace JSON
+{
+/**
+ * Position and length of a field inside of a frame
+ */
+struct FieldSpan
+{
+  int offset;
+  int length;
+};
+
+/**
+ * @brief The FieldSplitter class
+ *
+ * Native implementation of the default frame parser (which splits the frame
+ * with the separator sequence of the project). Fields are obtained directly
+ * from the raw UTF-8 bytes of the frame and returned as spans, so that no
+ * data is copied or converted to @c QString, and the JavaScript engine is not
+ * involved at all.
+ *
+ * The output matches the result of the JavaScript @c String.split() function,
+ * e.g. splitting "a,b," with "," produces three fields, the last one empty.
+ */
+class FieldSplitter
+{
+public:
+  explicit FieldSplitter(const QByteArray &separator = ",");
+
+  const QByteArray &separator() const;
+  void setSeparator(const QByteArray &separator);
+
+  int split(const QByteArray &frame, QVector<FieldSpan> &fields) const;
+
+private:
+  IO::DelimiterScanner m_scanner;
+};
+} // namespace JSON
@@ -20,8 +20,87 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <JSON/Frame.h>
 
+/**
+ * Returns a hash of the given JSON @a value, only strings, numbers & booleans
+ * are hashed by content.
+ */
+static quint64 HASH_VALUE(const QJsonValue &value)
+{
+  switch (value.type())
+  {
+    case QJsonValue::String:
+      return qHash(value.toString());
+    case QJsonValue::Double:
+      return qHash(value.toDouble());
+    case QJsonValue::Bool:
+      return value.toBool() ? 1 : 2;
+    default:
+      return static_cast<quint64>(value.type()) << 8;
+  }
+}
+
+/**
+ * Combines the hash of the given @a key & @a value with the given @a hash
+ */
+static void HASH_COMBINE(quint64 &hash, const QString &key,
+                         const QJsonValue &value)
+{
+  hash = hash * 31 + qHash(key);
+  hash = hash * 31 + HASH_VALUE(value);
+}
+
+/**
+ * Returns a hash of the structure of a frame with the given @a title and
+ * @a groups, that is, every group and dataset property except the values of
+ * the datasets. Two frames with the same schema hash only differ in their
+ * dataset values.
+ */
+static quint64 SCHEMA_HASH(const QString &title, const QJsonArray &groups)
+{
+  quint64 hash = qHash(title);
+  for (auto i = 0; i < groups.count(); ++i)
+  {
+    const auto group = groups.at(i).toObject();
+    for (auto g = group.constBegin(); g != group.constEnd(); ++g)
+    {
+      // Group property
+      if (g.key() != QStringLiteral("datasets"))
+      {
+        HASH_COMBINE(hash, g.key(), g.value());
+        continue;
+      }
+
+      // Dataset properties, except for the value
+      const auto datasets = g.value().toArray();
+      hash = hash * 31 + static_cast<quint64>(datasets.count());
+      for (auto j = 0; j < datasets.count(); ++j)
+      {
+        const auto dataset = datasets.at(j).toObject();
+        hash = hash * 31 + static_cast<quint64>(dataset.count());
+        for (auto d = dataset.constBegin(); d != dataset.constEnd(); ++d)
+        {
+          if (d.key() != QStringLiteral("value"))
+            HASH_COMBINE(hash, d.key(), d.value());
+        }
+      }
+    }
+  }
+
+  return hash;
+}
+
+/**
+ * Constructor function
+ */
+JSON::Frame::Frame()
+  : m_schemaHash(0)
+  , m_timestamp(0)
+{
+}
+
 /**
  * Destructor function, free memory used by the @c Group objects before
  * destroying an instance of this class.
@@ -39,6 +118,13 @@ void JSON::Frame::clear()
 {
   m_title = "";
   m_groups.clear();
+  m_values.clear();
+  m_sources.clear();
+  m_groupOffsets.clear();
+  m_valueIds.clear();
+  m_jsonData = QJsonObject();
+  m_schemaHash = 0;
+  m_timestamp = 0;
 }
 
 /**
@@ -57,6 +143,42 @@ int JSON::Frame::groupCount() const
   return m_groups.count();
 }
 
+/**
+ * Returns a hash of the structure of the frame (groups, datasets and all their
+ * properties except the dataset values). Frames with the same schema hash only
+ * differ in their dataset values, modules that cache information about the
+ * layout of the frame can use this to know when the cache must be rebuilt.
+ */
+quint64 JSON::Frame::schemaHash() const
+{
+  return m_schemaHash;
+}
+
+/**
+ * Returns the monotonic time (in microseconds) at which the data of the frame
+ * was received, or 0 if unknown.
+ */
+qint64 JSON::Frame::timestamp() const
+{
+  return m_timestamp;
+}
+
+/**
+ * Returns the JSON data that represents this frame, including the current
+ * values of its datasets. The JSON object is generated on demand, modules that
+ * do not need JSON data can read the frame directly.
+ */
+QJsonObject JSON::Frame::jsonData() const
+{
+  QJsonArray groups;
+  for (int i = 0; i < m_groups.count(); ++i)
+    groups.append(m_groups.at(i).jsonData());
+
+  auto object = m_jsonData;
+  object.insert("groups", groups);
+  return object;
+}
+
 /**
  * Returns a vector of pointers to the @c Group objects associated to this
  * frame.
@@ -66,36 +188,201 @@ QVector<JSON::Group> &JSON::Frame::groups()
   return m_groups;
 }
 
+/**
+ * Returns the numeric values of all the datasets of the frame, ordered by
+ * group and then by dataset. Use @c valueIndex() to obtain the position of a
+ * specific dataset in the table.
+ */
+const QVector<double> &JSON::Frame::values() const
+{
+  return m_values;
+}
+
+/**
+ * Returns the position of the given @a dataset of the given @a group in the
+ * value table, or -1 if the indexes are not valid.
+ */
+int JSON::Frame::valueIndex(const int group, const int dataset) const
+{
+  if (group < 0 || group >= m_groupOffsets.count() || dataset < 0
+      || dataset >= m_groups.at(group).datasetCount())
+    return -1;
+
+  return m_groupOffsets.at(group) + dataset;
+}
+
+/**
+ * Returns a deep copy of the frame, which does not share the storage of its
+ * groups, datasets & value table with this frame.
+ */
+JSON::Frame JSON::Frame::clone() const
+{
+  Frame frame = *this;
+  frame.m_groups.detach();
+  for (auto i = frame.m_groups.begin(); i != frame.m_groups.end(); ++i)
+    i->m_datasets.detach();
+
+  frame.m_values.detach();
+  return frame;
+}
+
+/**
+ * Returns @c true if the storage of the groups or of the value table of the
+ * frame is shared with other copies of the frame.
+ */
+bool JSON::Frame::isShared() const
+{
+  return !m_groups.isDetached() || !m_values.isDetached();
+}
+
+/**
+ * Returns @c true if this frame & the given @a other frame are copies that
+ * share the storage of their groups.
+ */
+bool JSON::Frame::sharesData(const Frame &other) const
+{
+  return m_groups.constData() == other.m_groups.constData();
+}
+
+/**
+ * Copies the dataset values & the timestamp of the given @a other frame,
+ * which must have the same structure as this frame (see @c schemaHash()).
+ * The storage of the groups & datasets is reused, so this function does not
+ * allocate memory unless the frame is shared.
+ */
+void JSON::Frame::copyValues(const Frame &other)
+{
+  m_jsonData = other.m_jsonData;
+  m_timestamp = other.m_timestamp;
+  for (int i = 0; i < m_groups.count(); ++i)
+  {
+    auto &datasets = m_groups[i].m_datasets;
+    const auto &source = other.m_groups.at(i).m_datasets;
+    for (int j = 0; j < datasets.count(); ++j)
+    {
+      auto &dataset = datasets[j];
+      const auto &value = source.at(j);
+      dataset.m_value = value.m_value;
+      dataset.m_numeric = value.m_numeric;
+      dataset.m_numericValue = value.m_numericValue;
+    }
+  }
+
+  std::copy(other.m_values.constBegin(), other.m_values.constEnd(),
+            m_values.begin());
+}
+
+/**
+ * Updates the value of the given @a dataset of the given @a group, both in the
+ * dataset object and in the value table.
+ */
+void JSON::Frame::setDatasetValue(const int group, const int dataset,
+                                  const QString &value)
+{
+  auto &object = m_groups[group].m_datasets[dataset];
+  object.setValue(value);
+  m_values[m_groupOffsets.at(group) + dataset] = object.numericValue();
+}
+
+/**
+ * Updates the numeric value of the given @a dataset of the given @a group,
+ * both in the dataset object and in the value table.
+ */
+void JSON::Frame::setDatasetValue(const int group, const int dataset,
+                                  const double value)
+{
+  m_groups[group].m_datasets[dataset].setValue(value);
+  m_values[m_groupOffsets.at(group) + dataset] = value;
+}
+
+/**
+ * Updates the value of the given @a dataset of the given @a group with the
+ * given UTF-8 @a data, which is converted to a number only once.
+ */
+void JSON::Frame::setDatasetValue(const int group, const int dataset,
+                                  const char *data, const int length)
+{
+  auto &object = m_groups[group].m_datasets[dataset];
+  object.setValue(data, length);
+  m_values[m_groupOffsets.at(group) + dataset] = object.numericValue();
+}
+
+/**
+ * Changes the monotonic time (in microseconds) at which the data of the frame
+ * was received.
+ */
+void JSON::Frame::setTimestamp(const qint64 timestamp)
+{
+  m_timestamp = timestamp;
+}
+
 /**
  * Reads the frame information and all its asociated groups (and datatsets) from
  * the given JSON @c object.
  *
+ * If the structure of the JSON data is the same as the one used to build the
+ * frame (e.g. when a device sends the same JSON layout with every frame), only
+ * the values of the existing datasets are updated.
+ *
+ * Objects without a @c groups array and with a @c values member are partial
+ * updates, which are merged into the current frame. The @c values member can
+ * either be an object that maps dataset IDs (the @c index of the dataset, or
+ * its 1-based position in the frame if the dataset has no index) to values,
+ * e.g. <tt>{"values":{"1":23.5,"4":"OK"}}</tt>, or an array with the values
+ * of all the datasets in frame order, e.g. <tt>{"values":[23.5,0.1,2]}</tt>.
+ *
  * @return @c true on success, @c false on failure
  */
 bool JSON::Frame::read(const QJsonObject &object)
 {
-  // Rest frame data
-  clear();
+  // Partial update, the frame schema must have been received before
+  if (!object.contains("groups") && object.contains("values"))
+    return isValid() && mergeValues(object.value("values"));
 
   // Get title & groups array
   auto title = object.value("title").toString();
   auto groups = object.value("groups").toArray();
 
+  // Structure of the frame did not change, only update the dataset values
+  const auto hash = SCHEMA_HASH(title, groups);
+  if (isValid() && hash == m_schemaHash && updateValues(groups))
+  {
+    m_jsonData = object;
+    return true;
+  }
+
+  // Rest frame data
+  clear();
+
   // We need to have a project title and at least one group
   if (!title.isEmpty() && !groups.isEmpty())
   {
     // Update title
     m_title = title;
 
-    // Generate groups & datasets from data frame
+    // Generate groups & datasets from data frame, and register the position
+    // of each dataset in the JSON data for future in-place updates
     for (auto i = 0; i < groups.count(); ++i)
     {
       Group group;
-      if (group.read(groups.at(i).toObject()))
+      auto groupObject = groups.at(i).toObject();
+      if (group.read(groupObject))
+      {
         m_groups.append(group);
+
+        auto datasets = groupObject.value("datasets").toArray();
+        for (auto j = 0; j < datasets.count(); ++j)
+        {
+          if (!datasets.at(j).toObject().isEmpty())
+            m_sources.append(qMakePair(i, j));
+        }
+      }
     }
 
     // Return status
+    m_jsonData = object;
+    m_schemaHash = hash;
+    buildValueTable();
     return groupCount() > 0;
   }
 
@@ -104,6 +391,141 @@ bool JSON::Frame::read(const QJsonObject &object)
   return false;
 }
 
+/**
+ * Overwrites the values of the existing datasets with the values contained in
+ * the given JSON @a groups array, which must have the same structure as the
+ * one used to build the frame.
+ *
+ * @return @c false if the JSON data does not match the frame structure
+ */
+bool JSON::Frame::updateValues(const QJsonArray &groups)
+{
+  // Structure mismatch
+  if (m_sources.count() != m_values.count())
+    return false;
+
+  // Update each dataset
+  int group = 0;
+  int dataset = 0;
+  int sourceGroup = -1;
+  QJsonArray datasets;
+  for (int i = 0; i < m_sources.count(); ++i)
+  {
+    // Get JSON datasets array of the group
+    const auto &source = m_sources.at(i);
+    if (source.first != sourceGroup)
+    {
+      if (source.first >= groups.count())
+        return false;
+
+      sourceGroup = source.first;
+      datasets = groups.at(sourceGroup).toObject().value("datasets").toArray();
+    }
+
+    // Get position of the dataset in the frame
+    while (group < m_groups.count()
+           && dataset >= m_groups.at(group).datasetCount())
+    {
+      ++group;
+      dataset = 0;
+    }
+
+    // Structure mismatch
+    if (group >= m_groups.count() || source.second >= datasets.count())
+      return false;
+
+    // Update value
+    auto &object = m_groups[group].m_datasets[dataset];
+    auto json = datasets.at(source.second).toObject();
+    object.setValue(json.value("value").toVariant().toString());
+    m_values[i] = object.numericValue();
+    ++dataset;
+  }
+
+  return true;
+}
+
+/**
+ * Merges the given partial update @a values into the frame, see @c read() for
+ * the supported formats.
+ *
+ * @return @c false if the update does not refer to any dataset of the frame
+ */
+bool JSON::Frame::mergeValues(const QJsonValue &values)
+{
+  // Dense update, values are given in frame order
+  if (values.isArray())
+  {
+    int index = 0;
+    const auto array = values.toArray();
+    for (int i = 0; i < m_groups.count() && index < array.count(); ++i)
+    {
+      const int count = m_groups.at(i).datasetCount();
+      for (int j = 0; j < count && index < array.count(); ++j)
+        mergeValue(i, j, array.at(index++));
+    }
+
+    return index > 0;
+  }
+
+  // Sparse update, values are given by dataset ID
+  int updated = 0;
+  const auto object = values.toObject();
+  for (auto i = object.constBegin(); i != object.constEnd(); ++i)
+  {
+    const auto it = m_valueIds.constFind(i.key().toInt());
+    if (it != m_valueIds.constEnd())
+    {
+      mergeValue(it->first, it->second, i.value());
+      ++updated;
+    }
+  }
+
+  return updated > 0;
+}
+
+/**
+ * Updates the given @a dataset of the given @a group with a @a value received
+ * in a partial update, numbers are stored without string conversions.
+ */
+void JSON::Frame::mergeValue(const int group, const int dataset,
+                             const QJsonValue &value)
+{
+  if (value.isDouble())
+    setDatasetValue(group, dataset, value.toDouble());
+  else
+    setDatasetValue(group, dataset, value.toVariant().toString());
+}
+
+/**
+ * Generates the position of the first dataset of each group in the value
+ * table, copies the numeric value of every dataset to the table & registers
+ * the ID used to refer to each dataset in partial updates.
+ */
+void JSON::Frame::buildValueTable()
+{
+  m_values.clear();
+  m_valueIds.clear();
+  m_groupOffsets.clear();
+  m_groupOffsets.reserve(m_groups.count());
+
+  for (int i = 0; i < m_groups.count(); ++i)
+  {
+    m_groupOffsets.append(m_values.count());
+    const auto &datasets = m_groups.at(i).m_datasets;
+    for (int j = 0; j < datasets.count(); ++j)
+    {
+      const auto &dataset = datasets.at(j);
+      m_values.append(dataset.numericValue());
+
+      // Datasets without an index are identified by their position
+      const int id = dataset.index() > 0 ? dataset.index() : m_values.count();
+      if (!m_valueIds.contains(id))
+        m_valueIds.insert(id, qMakePair(i, j));
+    }
+  }
+}
+
 /**
  * @return The group at the given @a index
  */
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QVector>
 #include <QObject>
 #include <QVariant>
@@ -51,23 +52,69 @@ namespace JSON
  *    frame.
  * 9) UI dashboard updates the widgets with the C++ model provided by this
  * class.
+ *
+ * Besides the group & dataset objects, the frame keeps a contiguous table with
+ * the numeric value of every dataset (see @c values()), which is shared by all
+ * the copies of the frame until one of them is modified.
+ *
+ * Each frame also stores the monotonic time (in microseconds, see
+ * @c IO::FrameQueue::timestamp()) at which its data was received, which is
+ * used to align the frames of different devices.
+ *
+ * Devices that send JSON frames only need to send the complete frame (title,
+ * groups & dataset metadata) once. After that, they can send partial updates
+ * with the values of some or all the datasets, which are merged into the
+ * current frame (see @c read()).
  */
 class Frame
 {
 public:
+  Frame();
   ~Frame();
 
   void clear();
   QString title() const;
   int groupCount() const;
+  quint64 schemaHash() const;
+  qint64 timestamp() const;
+  QJsonObject jsonData() const;
   QVector<Group> &groups();
+  const QVector<double> &values() const;
+  int valueIndex(const int group, const int dataset) const;
+
+  Frame clone() const;
+  bool isShared() const;
+  bool sharesData(const Frame &other) const;
+  void copyValues(const Frame &other);
+
   bool read(const QJsonObject &object);
+  void setTimestamp(const qint64 timestamp);
+  void setDatasetValue(const int group, const int dataset,
+                       const QString &value);
+  void setDatasetValue(const int group, const int dataset,
+                       const double value);
+  void setDatasetValue(const int group, const int dataset, const char *data,
+                       const int length);
   Q_INVOKABLE const JSON::Group &getGroup(const int index) const;
 
   inline bool isValid() const { return !title().isEmpty() && groupCount() > 0; }
 
+private:
+  void buildValueTable();
+  bool updateValues(const QJsonArray &groups);
+  bool mergeValues(const QJsonValue &values);
+  void mergeValue(const int group, const int dataset, const QJsonValue &value);
+
 private:
   QString m_title;
+  QJsonObject m_jsonData;
   QVector<Group> m_groups;
+  QVector<double> m_values;
+  QVector<int> m_groupOffsets;
+  QHash<int, QPair<int, int>> m_valueIds;
+
+  quint64 m_schemaHash;
+  qint64 m_timestamp;
+  QVector<QPair<int, int>> m_sources;
 };
 } // namespace JSON
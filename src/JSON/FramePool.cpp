@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <JSON/FramePool.h>
+
+/**
+ * Constructor function, the pool holds up to @a capacity frames
+ */
+JSON::FramePool::FramePool(const int capacity)
+  : m_next(0)
+  , m_capacity(qMax(1, capacity))
+{
+}
+
+/**
+ * Releases every pooled frame, this should be called when the structure of
+ * the frames changes (e.g. when a new project is loaded).
+ */
+void JSON::FramePool::clear()
+{
+  m_next = 0;
+  m_frames.clear();
+}
+
+/**
+ * Returns the maximum number of frames held by the pool
+ */
+int JSON::FramePool::capacity() const
+{
+  return m_capacity;
+}
+
+/**
+ * Returns a frame with the same contents as the given @a frame, which uses
+ * the storage of a pooled frame that is not referenced outside of the pool.
+ */
+JSON::Frame JSON::FramePool::acquire(const Frame &frame)
+{
+  // Invalid frame, nothing to recycle
+  if (!frame.isValid())
+    return frame;
+
+  // Frame already uses the storage of a pooled frame
+  for (int i = 0; i < m_frames.count(); ++i)
+  {
+    if (m_frames.at(i).sharesData(frame))
+      return frame;
+  }
+
+  // Reuse a pooled frame that is no longer referenced
+  for (int i = 0; i < m_frames.count(); ++i)
+  {
+    const int index = (m_next + i) % m_frames.count();
+    auto &pooled = m_frames[index];
+    if (pooled.isShared())
+      continue;
+
+    if (pooled.schemaHash() == frame.schemaHash()
+        && pooled.values().count() == frame.values().count())
+      pooled.copyValues(frame);
+    else
+      pooled = frame.clone();
+
+    m_next = index + 1;
+    return pooled;
+  }
+
+  // Every frame is in use & the pool is full, share the given frame
+  if (m_frames.count() >= m_capacity)
+    return frame;
+
+  // Register a new frame
+  m_frames.append(frame.clone());
+  return m_frames.last();
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <JSON/Frame.h>
+
+namespace JSON
+{
+/**
+ * @brief The FramePool class
+ *
+ * Recycles the storage of the frames that the generator hands to the rest of
+ * the application.
+ *
+ * Frames are implicitly shared, so publishing a copy of the working frame of
+ * the generator & then updating the working frame with the next set of values
+ * forces a deep copy of every group & dataset (i.e. several heap allocations
+ * per frame). Instead, the values of the working frame are copied into a
+ * pooled frame that is no longer referenced by any module (e.g. because the
+ * dashboard already processed it), and that pooled frame is published. In the
+ * steady state, the storage of the groups & datasets is never reallocated.
+ *
+ * If every pooled frame is still in use & the pool is full, the working frame
+ * is shared with the caller as usual.
+ */
+class FramePool
+{
+public:
+  explicit FramePool(const int capacity = 128);
+
+  void clear();
+  int capacity() const;
+  Frame acquire(const Frame &frame);
+
+private:
+  int m_next;
+  int m_capacity;
+  QVector<Frame> m_frames;
+};
+} // namespace JSON
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include <JSON/Frame.h>
+#include <JSON/FrameRouter.h>
+
+/**
+ * Empty list of groups, returned for invalid routes
+ */
+static const QVector<int> NO_GROUPS;
+
+/**
+ * Constructor function
+ */
+JSON::FrameRouter::FrameRouter()
+  : m_mode(Mode::Disabled)
+  , m_offset(0)
+{
+}
+
+/**
+ * Returns the method used to obtain the identifier of each frame
+ */
+JSON::FrameRouter::Mode JSON::FrameRouter::mode() const
+{
+  return m_mode;
+}
+
+/**
+ * Returns @c true if frames are routed to the groups of their frame type
+ */
+bool JSON::FrameRouter::isEnabled() const
+{
+  return m_mode != Mode::Disabled;
+}
+
+/**
+ * Returns the number of frame types declared by the groups of the project
+ */
+int JSON::FrameRouter::routeCount() const
+{
+  return m_groups.count();
+}
+
+/**
+ * Returns the indexes of the groups fed by the given @a route
+ */
+const QVector<int> &JSON::FrameRouter::groups(const int route) const
+{
+  if (route >= 0 && route < m_groups.count())
+    return m_groups.at(route);
+
+  return NO_GROUPS;
+}
+
+/**
+ * Disables frame routing
+ */
+void JSON::FrameRouter::clear()
+{
+  m_mode = Mode::Disabled;
+  m_offset = 0;
+  m_prefixes.clear();
+  m_routes.clear();
+  m_groups.clear();
+}
+
+/**
+ * Registers a route for each frame identifier declared by the groups of the
+ * given @a frame, using the given @a routing configuration.
+ */
+bool JSON::FrameRouter::compile(const Frame &frame, const QJsonObject &routing,
+                                QString *error)
+{
+  // Remove previous routes
+  clear();
+
+  // Validate configuration
+  if (!validate(routing, error))
+    return false;
+
+  // Routing disabled
+  const auto selected = mode(routing.value("mode").toString().toLower());
+  if (selected == Mode::Disabled)
+    return true;
+
+  // Register the groups of each frame identifier
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    // Get the identifier, byte identifiers are stored as their value
+    auto id = frame.getGroup(i).frameId().toUtf8();
+    if (id.isEmpty())
+      continue;
+
+    if (selected == Mode::Byte)
+    {
+      bool ok;
+      const auto value = id.toInt(&ok, 0);
+      if (!ok || value < 0 || value > 255)
+      {
+        if (error)
+          *error = QStringLiteral("%1: invalid frame ID \"%2\"")
+                       .arg(frame.getGroup(i).title(), QString(id));
+
+        clear();
+        return false;
+      }
+
+      id = QByteArray::number(value);
+    }
+
+    // Register the route
+    auto route = m_routes.constFind(id);
+    if (route == m_routes.constEnd())
+    {
+      route = m_routes.insert(id, m_groups.count());
+      m_groups.append(QVector<int>());
+      m_prefixes.append(id);
+    }
+
+    m_groups[route.value()].append(i);
+  }
+
+  // Check the longest prefixes first, so that "AB" is not taken as "A"
+  std::sort(m_prefixes.begin(), m_prefixes.end(),
+            [](const QByteArray &a, const QByteArray &b) {
+              return a.size() > b.size();
+            });
+
+  // Update configuration
+  m_mode = selected;
+  m_offset = routing.value("offset").toInt(0);
+  return true;
+}
+
+/**
+ * Returns the route of the given raw @a frame in prefix & byte modes, or -1
+ * if the frame type is unknown. In prefix mode, the length of the prefix is
+ * written to @a skip, so that it can be removed before parsing the frame.
+ */
+int JSON::FrameRouter::route(const QByteArray &frame, int *skip) const
+{
+  if (skip)
+    *skip = 0;
+
+  // Identifier is the byte at the configured offset
+  if (m_mode == Mode::Byte)
+  {
+    if (m_offset >= frame.size())
+      return -1;
+
+    const auto value = static_cast<quint8>(frame.at(m_offset));
+    return m_routes.value(QByteArray::number(value), -1);
+  }
+
+  // Identifier is the beginning of the frame
+  if (m_mode == Mode::Prefix)
+  {
+    for (const auto &prefix : m_prefixes)
+    {
+      if (frame.startsWith(prefix))
+      {
+        if (skip)
+          *skip = prefix.size();
+
+        return m_routes.value(prefix, -1);
+      }
+    }
+  }
+
+  // Unknown frame type
+  return -1;
+}
+
+/**
+ * Returns the route of the given identifier (e.g. the first field of a frame
+ * in field mode), or -1 if the frame type is unknown.
+ */
+int JSON::FrameRouter::route(const char *id, const int length) const
+{
+  return m_routes.value(QByteArray::fromRawData(id, length).trimmed(), -1);
+}
+
+/**
+ * Returns the route of the given identifier, or -1 if it is unknown
+ */
+int JSON::FrameRouter::route(const QString &id) const
+{
+  return m_routes.value(id.trimmed().toUtf8(), -1);
+}
+
+/**
+ * Returns @c true if the given @a routing configuration is valid, an empty
+ * configuration disables frame routing.
+ */
+bool JSON::FrameRouter::validate(const QJsonObject &routing, QString *error)
+{
+  // Routing disabled
+  if (routing.isEmpty())
+    return true;
+
+  // Validate mode
+  const auto name = routing.value("mode").toString().toLower();
+  if (!name.isEmpty() && mode(name) == Mode::Disabled)
+  {
+    if (error)
+      *error = QStringLiteral("Unknown frame routing mode \"%1\"").arg(name);
+
+    return false;
+  }
+
+  // Validate identifier offset
+  if (routing.value("offset").toInt(0) < 0)
+  {
+    if (error)
+      *error = QStringLiteral("Invalid frame ID offset");
+
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Returns the routing mode with the given @a name
+ */
+JSON::FrameRouter::Mode JSON::FrameRouter::mode(const QString &name)
+{
+  if (name == QStringLiteral("field"))
+    return Mode::Field;
+  if (name == QStringLiteral("prefix"))
+    return Mode::Prefix;
+  if (name == QStringLiteral("byte"))
+    return Mode::Byte;
+
+  return Mode::Disabled;
+}
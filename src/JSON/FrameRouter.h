@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QJsonObject>
+
+namespace JSON
+{
+class Frame;
+
+/**
+ * @brief The FrameRouter class
+ *
+ * Allows a project to receive several frame types over the same link (e.g.
+ * fast IMU frames interleaved with slow status frames). Each group declares
+ * the identifier of the frame type that feeds it (the @c frameId key of the
+ * group), and the project selects how the identifier is obtained from each
+ * frame with the @c frameRouting key:
+ *
+ * @code
+ * "frameRouting": {
+ *   "mode": "field",   // field, prefix or byte
+ *   "offset": 0        // Byte offset of the identifier ("byte" mode only)
+ * }
+ * @endcode
+ *
+ * - @c field: the identifier is the first field of the frame, the rest of
+ *   the fields are numbered from 1 (e.g. @c IMU,0.1,0.2,9.8).
+ * - @c prefix: the frame starts with the identifier, which is removed before
+ *   the frame is parsed (e.g. @c $S12.5,3.3).
+ * - @c byte: the identifier is the value of the byte at the given offset of
+ *   a binary frame, which is parsed as a whole.
+ *
+ * Each frame only updates the datasets of the groups registered for its
+ * identifier, the rest of the datasets keep their last values. Frames with
+ * an unknown identifier are discarded.
+ */
+class FrameRouter
+{
+public:
+  enum class Mode
+  {
+    Disabled,
+    Field,
+    Prefix,
+    Byte
+  };
+
+  FrameRouter();
+
+  Mode mode() const;
+  bool isEnabled() const;
+  int routeCount() const;
+  const QVector<int> &groups(const int route) const;
+
+  void clear();
+  bool compile(const Frame &frame, const QJsonObject &routing,
+               QString *error = Q_NULLPTR);
+
+  int route(const QByteArray &frame, int *skip = Q_NULLPTR) const;
+  int route(const char *id, const int length) const;
+  int route(const QString &id) const;
+
+  static bool validate(const QJsonObject &routing, QString *error = Q_NULLPTR);
+
+private:
+  static Mode mode(const QString &name);
+
+private:
+  Mode m_mode;
+  int m_offset;
+  QVector<QByteArray> m_prefixes;
+  QHash<QByteArray, int> m_routes;
+  QVector<QVector<int>> m_groups;
+};
+} // namespace JSON
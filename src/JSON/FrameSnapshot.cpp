@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <JSON/FrameSnapshot.h>
+
+/**
+ * Flag set in the middle slot index when it holds a frame that has not been
+ * read by the consumer yet.
+ */
+static const int FRESH_FLAG = 0x4;
+
+/**
+ * Constructor function, the back, middle & front slots are initially the
+ * first, second & third frames.
+ */
+JSON::FrameSnapshot::FrameSnapshot()
+  : m_back(0)
+  , m_front(2)
+  , m_middle(1)
+  , m_sequence(0)
+{
+}
+
+/**
+ * Returns the number of frames published since the snapshot was created
+ */
+quint64 JSON::FrameSnapshot::sequence() const
+{
+  return m_sequence.load(std::memory_order_acquire);
+}
+
+/**
+ * Replaces the latest frame with @a frame, this function must only be called
+ * by the producer thread.
+ */
+void JSON::FrameSnapshot::publish(const Frame &frame)
+{
+  m_frames[m_back] = frame;
+  auto previous = m_middle.exchange(m_back | FRESH_FLAG,
+                                    std::memory_order_acq_rel);
+  m_back = previous & ~FRESH_FLAG;
+  m_sequence.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * Copies the latest frame to @a frame if a new frame was published since the
+ * last call, returns @c false (and leaves @a frame unchanged) otherwise.
+ *
+ * This function must only be called by the consumer thread.
+ */
+bool JSON::FrameSnapshot::read(Frame &frame)
+{
+  if (!(m_middle.load(std::memory_order_acquire) & FRESH_FLAG))
+    return false;
+
+  m_front = m_middle.exchange(m_front, std::memory_order_acq_rel)
+            & ~FRESH_FLAG;
+  frame = m_frames[m_front];
+  return true;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <JSON/Frame.h>
+
+namespace JSON
+{
+/**
+ * @brief The FrameSnapshot class
+ *
+ * Triple buffer that holds the latest frame generated by the JSON generator.
+ *
+ * The producer (the thread that generates frames) overwrites the snapshot
+ * with every new frame, and the consumer (e.g. the render timer of the
+ * dashboard) reads it once per refresh. Neither side ever waits for the
+ * other: the producer writes into a back slot & atomically swaps it with the
+ * middle slot, and the consumer swaps the middle slot with its front slot
+ * only if a newer frame was published since the last read.
+ *
+ * Intermediate frames are dropped, so the work done by the consumer does not
+ * depend on the rate at which frames are received.
+ *
+ * @note Calls to @c publish() must not run concurrently, and there must be a
+ *       single consumer thread.
+ */
+class FrameSnapshot
+{
+public:
+  FrameSnapshot();
+
+  quint64 sequence() const;
+  void publish(const Frame &frame);
+  bool read(Frame &frame);
+
+private:
+  int m_back;
+  int m_front;
+  Frame m_frames[3];
+  std::atomic<int> m_middle;
+  std::atomic<quint64> m_sequence;
+};
+} // namespace JSON
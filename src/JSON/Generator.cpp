@@ -22,8 +22,14 @@
 
 #include "Generator.h"
 
+#include <climits>
+
+#include <QDebug>
 #include <QFileInfo>
 #include <QFileDialog>
+#include <QMetaMethod>
+#include <QtNumeric>
+#include <QElapsedTimer>
 #include <QRegularExpression>
 
 #include <Project/Model.h>
@@ -32,20 +38,102 @@
 #include <CSV/Player.h>
 #include <IO/Manager.h>
 #include <MQTT/Client.h>
+#include <Misc/Tracer.h>
 #include <Misc/Utilities.h>
+#include <Misc/Diagnostics.h>
+
+/**
+ * Maximum number of frames waiting in the outbox to be delivered by the main
+ * thread, the worker thread stops generating frames while it is full.
+ */
+static const int MAX_OUTBOX_FRAMES = 65536;
+
+/**
+ * Maximum number of frames of each delivery that are published to the live
+ * consumers with the drop-oldest backpressure policy. This is larger than the
+ * number of points that a plot can display, so dropping older frames only
+ * affects the widgets when the main thread is far behind.
+ */
+static const int MAX_DISPLAY_FRAMES = 16384;
+
+/**
+ * Maximum number of project files listed by @c recentProjects(), which matches
+ * the number of compiled projects kept in memory by the project cache.
+ */
+static const int MAX_RECENT_PROJECTS = 8;
 
 /**
  * Initializes the JSON Parser class and connects appropiate SIGNALS/SLOTS
  */
 JSON::Generator::Generator()
   : m_opMode(kAutomatic)
+  , m_frameConsumer(-1)
+  , m_parallelParsing(false)
+  , m_inputSuspended(false)
+  , m_jsonSchemaHash(0)
+  , m_nativeSplit(false)
+  , m_batchParsing(false)
+  , m_worker(new QObject())
+  , m_threadedProcessing(false)
+  , m_deliveryPending(false)
+  , m_backpressurePolicy(kDropOldest)
 {
+  // Read frames from the I/O manager queue
+  auto io = &IO::Manager::instance();
+  m_frameConsumer = io->frameQueue().registerConsumer("JSON::Generator");
+
   // clang-format off
-    connect(&IO::Manager::instance(), &IO::Manager::frameReceived,
-            this, &JSON::Generator::readData);
+    connect(io, &IO::Manager::framesAvailable,
+            this, &JSON::Generator::readFrames);
+    connect(io, &IO::Manager::separatorSequenceChanged,
+            this, &JSON::Generator::updateSeparator);
+    connect(io, &IO::Manager::devicesChanged,
+            this, &JSON::Generator::updateDevices);
+    connect(io, &IO::Manager::connectedChanged,
+            this, &JSON::Generator::resetSequences);
+    connect(&m_parserPool, &JSON::ParserPool::framesParsed,
+            this, &JSON::Generator::onFramesParsed);
   // clang-format on
 
+  // Worker object, only receives events while threaded processing is enabled
+  m_thread.setObjectName(QStringLiteral("JSON::Generator"));
+  m_worker->moveToThread(&m_thread);
+
+  // Copy the frame parser options once the modules are initialized, since the
+  // code editor depends on the project model, which depends on this class
+  QMetaObject::invokeMethod(
+      this,
+      [=] {
+        connect(&Project::CodeEditor::instance(),
+                &Project::CodeEditor::parserChanged, this,
+                &JSON::Generator::updateParser);
+        updateParser();
+      },
+      Qt::QueuedConnection);
+
+  updateSeparator();
+  updateDevices();
   readSettings();
+  setParallelParsing(
+      m_settings.value("JSON_Generator_ParallelParsing", false).toBool());
+  setThreadedProcessing(
+      m_settings.value("JSON_Generator_ThreadedProcessing", false).toBool());
+  setBackpressurePolicy(
+      m_settings.value("JSON_Generator_BackpressurePolicy", 0).toInt());
+  setResamplingMode(
+      m_settings.value("JSON_Generator_ResamplingMode", 0).toInt());
+  setResamplingInterval(
+      m_settings.value("JSON_Generator_ResamplingInterval", 10).toInt());
+}
+
+/**
+ * Stops the worker thread (if running)
+ */
+JSON::Generator::~Generator()
+{
+  m_thread.quit();
+  m_thread.wait();
+  delete m_worker;
 }
 
 /**
@@ -93,6 +181,113 @@ QString JSON::Generator::jsonMapFilepath() const
   return "";
 }
 
+/**
+ * Returns the paths of the most recently loaded project files, the most recent
+ * one first. The compiled version of these projects is kept in memory by the
+ * @c ProjectCache, so switching between them does not parse them again.
+ */
+QStringList JSON::Generator::recentProjects() const
+{
+  return m_recentProjects;
+}
+
+/**
+ * Returns the schema hash (see @c JSON::Frame::schemaHash()) of the frame
+ * built from the loaded project, or 0 if no project is loaded.
+ */
+quint64 JSON::Generator::schemaHash()
+{
+  QMutexLocker locker(processingMutex());
+  return m_frame.schemaHash();
+}
+
+/**
+ * Returns @c true if custom frame parser scripts are executed in parallel by
+ * a pool of worker threads.
+ */
+bool JSON::Generator::parallelParsing() const
+{
+  return m_parallelParsing;
+}
+
+/**
+ * Returns @c true if frames are generated in a dedicated worker thread
+ */
+bool JSON::Generator::threadedProcessing() const
+{
+  return m_threadedProcessing;
+}
+
+/**
+ * Returns the policy applied when the main thread cannot keep up with the
+ * generated frames, the value matches the order of
+ * @c availableBackpressurePolicies().
+ */
+int JSON::Generator::backpressurePolicy() const
+{
+  return m_backpressurePolicy;
+}
+
+/**
+ * Returns the number of frames waiting to be delivered by the main thread
+ */
+int JSON::Generator::queuedFrames()
+{
+  QMutexLocker locker(&m_outboxMutex);
+  return m_outboxFrames.count();
+}
+
+/**
+ * Returns @c true if the frames received from the I/O manager are currently
+ * discarded (e.g. while the burst recorder captures data).
+ */
+bool JSON::Generator::inputSuspended() const
+{
+  return m_inputSuspended;
+}
+
+/**
+ * Returns the method used to place the generated frames on a common time
+ * base, the value matches the order of @c availableResamplingModes().
+ */
+int JSON::Generator::resamplingMode() const
+{
+  return static_cast<int>(m_resampler.mode());
+}
+
+/**
+ * Returns the interval (in milliseconds) between resampled frames
+ */
+int JSON::Generator::resamplingInterval() const
+{
+  return static_cast<int>(m_resampler.interval() / 1000);
+}
+
+/**
+ * Returns a list with the available resampling methods, the order of the list
+ * matches the @c Resampler::Mode enum.
+ */
+StringList JSON::Generator::availableResamplingModes() const
+{
+  StringList list;
+  list.append(tr("Disabled"));
+  list.append(tr("Sample & hold"));
+  list.append(tr("Linear interpolation"));
+  return list;
+}
+
+/**
+ * Returns a list with the available backpressure policies, the order of the
+ * list matches the @c BackpressurePolicy enum.
+ */
+StringList JSON::Generator::availableBackpressurePolicies() const
+{
+  StringList list;
+  list.append(tr("Drop oldest frames for display"));
+  list.append(tr("Block ingestion"));
+  return list;
+}
+
 /**
  * Returns the operation mode
  */
@@ -101,6 +296,29 @@ JSON::Generator::OperationMode JSON::Generator::operationMode() const
   return m_opMode;
 }
 
+/**
+ * Returns the snapshot that holds the latest generated frame, which is
+ * updated as soon as the frame is generated (i.e. before the frame is
+ * delivered with the @c framesChanged() signal).
+ *
+ * Widgets that only display the most recent values should read it once per
+ * refresh instead of processing every frame.
+ */
+JSON::FrameSnapshot &JSON::Generator::snapshot()
+{
+  return m_snapshot;
+}
+
+/**
+ * Returns the graph that delivers the generated frames to the registered
+ * sinks, modules register themselves in it to receive every frame (recorders)
+ * or the decimated frames (live consumers).
+ */
+JSON::SinkGraph &JSON::Generator::sinks()
+{
+  return m_sinks;
+}
+
 /**
  * Creates a file dialog & lets the user select the JSON file map
  */
@@ -119,6 +337,10 @@ void JSON::Generator::loadJsonMap()
 
 /**
  * Opens, validates & loads into memory the JSON file in the given @a path.
+ *
+ * The file is compiled by the @c ProjectCache class, which parses the file
+ * only if its contents have not been compiled before (e.g. when the project
+ * model has just opened the same file).
  */
 void JSON::Generator::loadJsonMap(const QString &path)
 {
@@ -126,43 +348,37 @@ void JSON::Generator::loadJsonMap(const QString &path)
   if (path.isEmpty())
     return;
 
-  // Close previous file (if open)
+  // Close previous file (if open), the compiled data is replaced below, so
+  // the modules only need to be notified once (e.g. the dashboard can keep
+  // its widgets if the new project has the same frame structure)
   if (m_jsonMap.isOpen())
   {
     m_jsonMap.close();
     m_json = QJsonObject();
-    Q_EMIT jsonFileMapChanged();
   }
 
   // Try to open the file (read only mode)
+  CompiledProjectPtr project;
   m_jsonMap.setFileName(path);
   if (m_jsonMap.open(QFile::ReadOnly))
   {
-    // Read data & validate JSON from file
-    QJsonParseError error;
-    auto data = m_jsonMap.readAll();
-    auto document = QJsonDocument::fromJson(data, &error);
-    if (error.error != QJsonParseError::NoError)
+    // Compile the project or obtain the cached version
+    QString error;
+    project = ProjectCache::instance().load(path, Q_NULLPTR, &error);
+    if (!project)
     {
       m_jsonMap.close();
       writeSettings("");
-      Misc::Utilities::showMessageBox(tr("JSON parse error"),
-                                      error.errorString());
+      Misc::Utilities::showMessageBox(tr("JSON parse error"), error);
     }
 
     // JSON contains no errors, load compacted JSON document & save settings
     else
     {
-      // Save settings
       writeSettings(path);
-
-      // Load compacted JSON document
-      document.object().remove("frameParser");
-      m_json = document.object();
+      m_json = project->json;
+      m_json.remove("frameParser");
     }
-
-    // Get rid of warnings
-    Q_UNUSED(document);
   }
 
   // Open error
@@ -175,6 +391,9 @@ void JSON::Generator::loadJsonMap(const QString &path)
     m_jsonMap.close();
   }
 
+  // Build frame & field table from JSON map
+  compileJsonMap(project);
+
   // Update UI
   Q_EMIT jsonFileMapChanged();
 }
@@ -190,20 +409,188 @@ void JSON::Generator::loadJsonMap(const QString &path)
  *            unit to the computer.
  *
  * @c kAutomatic serial data contains the JSON data frame, good for simple
- *               applications or for prototyping.
+ *               applications or for prototyping. The device can send the
+ *               complete frame once & then only send partial updates with
+ *               the values of the datasets (see @c JSON::Frame::read()).
+ *
+ * @c kCbor & @c kMessagePack serial data contains the same frames as in
+ *               automatic mode, encoded with CBOR or MessagePack so that the
+ *               device does not need to print numbers as text.
  */
 void JSON::Generator::setOperationMode(
     const JSON::Generator::OperationMode &mode)
 {
-  m_opMode = mode;
+  {
+    QMutexLocker locker(processingMutex());
+    m_opMode = mode;
+  }
+
   Q_EMIT operationModeChanged();
 }
 
+/**
+ * Suspends or resumes the processing of the frames received from the I/O
+ * manager. While the input is suspended, received frames are discarded
+ * without being parsed; frames can still be processed explicitly with
+ * @c processFrames().
+ */
+void JSON::Generator::setInputSuspended(const bool suspended)
+{
+  m_inputSuspended = suspended;
+}
+
+/**
+ * Enables or disables the parallel execution of the frame parser script. When
+ * enabled, a pool of worker threads (each one with its own JavaScript engine)
+ * parses the received frames concurrently, the results are delivered in the
+ * same order in which the frames were received.
+ *
+ * @warning frame parsers that keep state between frames (e.g. with global
+ *          variables) do not work correctly in this mode.
+ */
+void JSON::Generator::setParallelParsing(const bool enabled)
+{
+  // Nothing to do
+  if (m_parallelParsing == enabled && m_parserPool.isRunning() == enabled)
+    return;
+
+  // The frame parser script can only run in the worker pool when frames are
+  // generated in the worker thread
+  if (!enabled && m_threadedProcessing)
+    setThreadedProcessing(false);
+
+  // Start or stop the worker threads
+  {
+    QMutexLocker locker(processingMutex());
+    if (enabled)
+      m_parserPool.start(qMax(1, QThread::idealThreadCount() - 1));
+    else
+      m_parserPool.stop();
+
+    // Pending results are discarded when the pool is restarted or stopped
+    m_parsedFrames.clear();
+    m_parsedRoutes.clear();
+    m_parallelParsing = enabled;
+  }
+
+  // Update settings
+  m_settings.setValue("JSON_Generator_ParallelParsing", enabled);
+  Q_EMIT parallelParsingChanged();
+}
+
+/**
+ * Enables or disables the generation of frames in a dedicated worker thread,
+ * so that parsing does not compete with the user interface for CPU time. The
+ * generated frames are handed to the main thread in batches (see
+ * @c deliverFrames()), so the modules that consume them are not affected.
+ *
+ * The frame parser script engine of the project editor lives in the main
+ * thread, so custom frame parsers run in the parser worker pool while this
+ * option is enabled (parallel parsing is enabled automatically).
+ */
+void JSON::Generator::setThreadedProcessing(const bool enabled)
+{
+  // Nothing to do
+  if (m_threadedProcessing == enabled)
+    return;
+
+  // Custom frame parsers must run in the worker pool
+  if (enabled && !m_parallelParsing)
+    setParallelParsing(true);
+
+  // Start the worker thread & read frames from it
+  if (enabled)
+  {
+    m_thread.start();
+    m_workerConnection
+        = connect(&IO::Manager::instance(), &IO::Manager::framesAvailable,
+                  m_worker, [=] { readFrames(); });
+
+    m_threadedProcessing = true;
+  }
+
+  // Wait until the worker finishes the current batch & stop the thread
+  else
+  {
+    disconnect(m_workerConnection);
+    {
+      QMutexLocker locker(&m_mutex);
+      m_threadedProcessing = false;
+    }
+
+    m_outboxDrained.wakeAll();
+
+    m_thread.quit();
+    m_thread.wait();
+  }
+
+  // Update settings
+  m_settings.setValue("JSON_Generator_ThreadedProcessing", enabled);
+  Q_EMIT threadedProcessingChanged();
+}
+
+/**
+ * Changes the policy applied when the main thread cannot keep up with the
+ * generated frames:
+ *
+ * - @c kDropOldest: the live consumers (dashboard, MQTT & plugins) only
+ *   receive the most recent frames of each delivery, the dropped frames are
+ *   reported to the diagnostics module.
+ * - @c kBlockIngestion: every frame is delivered to the live consumers, so
+ *   frame generation waits for the main thread & the backlog stays in the
+ *   frame queue of the I/O manager.
+ *
+ * In both cases, every frame is delivered to the modules that record data.
+ */
+void JSON::Generator::setBackpressurePolicy(const int policy)
+{
+  const auto value = qBound(0, policy, 1);
+  m_backpressurePolicy = value;
+  m_settings.setValue("JSON_Generator_BackpressurePolicy", value);
+  Q_EMIT backpressurePolicyChanged();
+}
+
+/**
+ * Changes the method used to place the generated frames on a common time
+ * base. When resampling is enabled, the frames delivered to the dashboard &
+ * to the CSV export are spaced by the resampling interval, instead of
+ * following the reception time of each device.
+ */
+void JSON::Generator::setResamplingMode(const int mode)
+{
+  const auto value = qBound(0, mode, 2);
+  {
+    QMutexLocker locker(processingMutex());
+    m_resampler.setMode(static_cast<Resampler::Mode>(value));
+  }
+
+  m_settings.setValue("JSON_Generator_ResamplingMode", value);
+  Q_EMIT resamplingChanged();
+}
+
+/**
+ * Changes the @a interval (in milliseconds) between resampled frames
+ */
+void JSON::Generator::setResamplingInterval(const int interval)
+{
+  const auto value = qBound(1, interval, 10000);
+  {
+    QMutexLocker locker(processingMutex());
+    m_resampler.setInterval(static_cast<qint64>(value) * 1000);
+  }
+
+  m_settings.setValue("JSON_Generator_ResamplingInterval", value);
+  Q_EMIT resamplingChanged();
+}
+
 /**
  * Loads the last saved JSON map file (if any)
  */
 void JSON::Generator::readSettings()
 {
+  m_recentProjects
+      = m_settings.value("JSON_Generator_RecentProjects").toStringList();
+
   auto path = m_settings.value("json_map_location", "").toString();
   if (!path.isEmpty())
     loadJsonMap(path);
@@ -211,84 +598,1106 @@ void JSON::Generator::readSettings()
 
 /**
  * Saves the location of the last valid JSON map file that was opened (if any)
+ * & moves it to the top of the recent projects list.
  */
 void JSON::Generator::writeSettings(const QString &path)
 {
   m_settings.setValue("json_map_location", path);
+  if (path.isEmpty())
+    return;
+
+  const auto filePath = QFileInfo(path).absoluteFilePath();
+  m_recentProjects.removeAll(filePath);
+  m_recentProjects.prepend(filePath);
+  while (m_recentProjects.count() > MAX_RECENT_PROJECTS)
+    m_recentProjects.removeLast();
+
+  m_settings.setValue("JSON_Generator_RecentProjects", m_recentProjects);
+  Q_EMIT recentProjectsChanged();
 }
 
 /**
- * Tries to parse the given data as a JSON document according to the selected
- * operation mode.
+ * Reads all the frames that the I/O manager has published since the last call
+ * and parses them one by one.
  *
- * Possible operation modes:
- * - Auto:   serial data contains the JSON data frame
- * - Manual: serial data only contains the comma-separated values, and we need
- *           to use a JSON map file (given by the user) to know what each value
- *           means
+ * The @c framesChanged() signal is emitted once with all the frames of the
+ * batch, so that modules that only need to refresh their state once (e.g. the
+ * dashboard) can avoid doing it for every frame. The @c jsonChanged() signal
+ * is only emitted (and JSON data is only generated) if a module is connected
+ * to it.
+ */
+void JSON::Generator::readFrames()
+{
+  TRACE_SCOPE("JSON::Generator::readFrames");
+
+  // Frames are only read by the thread that generates them
+  const bool worker = QThread::currentThread() == &m_thread;
+  if (worker != m_threadedProcessing)
+    return;
+
+  // Wait until the main thread delivers the pending frames
+  if (worker && !waitForOutbox())
+    return;
+
+  // Threaded processing may have been disabled while waiting
+  QMutexLocker locker(processingMutex());
+  if (worker != m_threadedProcessing)
+    return;
+
+  // Discard live frames while the input is suspended
+  auto &queue = IO::Manager::instance().frameQueue();
+  if (m_inputSuspended)
+  {
+    queue.skip(m_frameConsumer);
+    return;
+  }
+
+  // Get all available frames & the device/time information of each of them
+  QVector<QByteArray> frames;
+  QVector<IO::FrameInfo> info;
+  if (queue.popBatch(m_frameConsumer, frames, info) <= 0)
+    return;
+
+  // Generate & publish frames
+  generateFrames(frames, info);
+}
+
+/**
+ * Generates a frame for each one of the given raw @a frames, using the
+ * device/time information given in @a info (one item per frame), and
+ * notifies the rest of the application.
  *
- * If JSON parsing is successfull, then the class shall notify the rest of the
- * application in order to process packet data.
+ * This function is used for frames that were recorded earlier (e.g. by the
+ * burst recorder), which are processed with their original timestamps.
  */
-void JSON::Generator::readData(const QByteArray &data)
+void JSON::Generator::processFrames(const QVector<QByteArray> &frames,
+                                    const QVector<IO::FrameInfo> &info)
 {
-  // Data empty, abort
-  if (data.isEmpty())
+  QMutexLocker locker(processingMutex());
+  generateFrames(frames, info);
+}
+
+/**
+ * Generates a frame for each one of the given raw @a frames & publishes them,
+ * the caller must hold the lock returned by @c processingMutex().
+ */
+void JSON::Generator::generateFrames(const QVector<QByteArray> &frames,
+                                     const QVector<IO::FrameInfo> &info)
+{
+  // Validate arguments
+  if (frames.isEmpty() || frames.count() != info.count())
     return;
 
-  // Serial device sends JSON (auto mode)
-  QJsonObject jsonData;
-  if (operationMode() == JSON::Generator::kAutomatic)
-    jsonData = QJsonDocument::fromJson(data).object();
+  // Initialize parameters
+  QVector<JSON::Frame> batch;
+  batch.reserve(frames.count());
+  updateResamplerOwners();
 
-  // Data is separated and parsed by Serial Studio (manual mode)
-  else
+  // Custom frame parser in parallel mode, hand frames to the worker pool
+  if (operationMode() == kManual && m_frame.isValid() && !useNativeSplit()
+      && !useBinaryDecoder() && !useNmeaDecoder() && !useWasmDecoder()
+      && parallelParsing())
   {
-    // Copy JSON map
-    jsonData = m_json;
+    QStringList strings;
+    QVector<int> routes;
+    QVector<IO::FrameInfo> accepted;
+    strings.reserve(frames.count());
+    for (int i = 0; i < frames.count(); ++i)
+    {
+      int route;
+      QByteArray payload;
+      if (!routeFrame(frames.at(i), payload, route))
+        continue;
 
-    // Get fields from frame parser function
-    auto fields = Project::CodeEditor::instance().parse(
-        QString::fromUtf8(data), IO::Manager::instance().separatorSequence());
+      routes.append(route);
+      accepted.append(info.at(i));
+      strings.append(QString::fromUtf8(payload));
+    }
+
+    if (strings.isEmpty())
+      return;
+
+    if (m_parserPool.code() != m_parserCode)
+      m_parserPool.setCode(m_parserCode);
+
+    m_parsedFrames.append(accepted);
+    m_parsedRoutes.append(routes);
+    m_parserPool.submit(strings, m_separator);
+    return;
+  }
+
+  // Measure the time spent parsing the frames in this thread
+  QElapsedTimer timer;
+  timer.start();
+
+  // Custom frame parser with batch support, parse all frames in a single call
+  if (operationMode() == kManual && m_frame.isValid() && !useNativeSplit()
+      && !useBinaryDecoder() && !useNmeaDecoder() && !useWasmDecoder()
+      && m_batchParsing)
+  {
+    QStringList strings;
+    QVector<int> routes;
+    QVector<IO::FrameInfo> accepted;
+    strings.reserve(frames.count());
+    for (int i = 0; i < frames.count(); ++i)
+    {
+      int route;
+      QByteArray payload;
+      if (!routeFrame(frames.at(i), payload, route))
+        continue;
+
+      routes.append(route);
+      accepted.append(info.at(i));
+      strings.append(QString::fromUtf8(payload));
+    }
 
-    // Replace data in JSON map
-    auto groups = jsonData.value("groups").toArray();
-    for (int i = 0; i < groups.count(); ++i)
+    auto results
+        = Project::CodeEditor::instance().parseBatch(strings, m_separator);
+    const int count = qMin(results.count(), accepted.count());
+    for (int i = 0; i < count; ++i)
     {
-      // Get group & list of datasets
-      auto group = groups.at(i).toObject();
-      auto datasets = group.value("datasets").toArray();
+      if (results.at(i).isEmpty())
+        continue;
+
+      const auto &frameInfo = accepted.at(i);
+      m_frame.setTimestamp(frameInfo.timestamp);
+      if (applyFields(results.at(i), frameInfo.device, routes.at(i)))
+        appendFrame(batch, m_frame, frameInfo.device);
+    }
+  }
 
-      // Evaluate each dataset
-      for (int j = 0; j < datasets.count(); ++j)
+  // Parse frames one by one
+  else
+  {
+    for (int i = 0; i < frames.count(); ++i)
+    {
+      m_frame.setTimestamp(info.at(i).timestamp);
+      if (readData(frames.at(i), m_lastFrame, info.at(i).device))
       {
-        auto dataset = datasets.at(j).toObject();
-        auto index = dataset.value("index").toInt();
-
-        if (index <= fields.count() && index >= 1)
-        {
-          dataset.remove("value");
-          dataset.insert("value", QJsonValue(fields.at(index - 1)));
-          datasets.removeAt(j);
-          datasets.insert(j, dataset);
-        }
+        m_lastFrame.setTimestamp(info.at(i).timestamp);
+        appendFrame(batch, m_lastFrame, info.at(i).device);
       }
+    }
+  }
+
+  // Register parsing time & update UI
+  Misc::Diagnostics::instance().record(Misc::Diagnostics::Stage::Parsing,
+                                       timer.nsecsElapsed());
+  publishFrames(batch);
+}
+
+/**
+ * Generates a frame for each list of @a fields returned by the parser worker
+ * pool (in the same order in which the frames were received) & notifies the
+ * rest of the application.
+ */
+void JSON::Generator::onFramesParsed(const QVector<QStringList> &fields)
+{
+  TRACE_SCOPE("JSON::Generator::onFramesParsed");
 
-      // Update datasets in group
-      group.remove("datasets");
-      group.insert("datasets", datasets);
+  // Get the device/time information of each frame
+  QMutexLocker locker(processingMutex());
+  const int count = qMin(fields.count(), m_parsedFrames.count());
+  const auto info = m_parsedFrames.mid(0, count);
+  const auto routes = m_parsedRoutes.mid(0, count);
+  m_parsedFrames.remove(0, count);
+  m_parsedRoutes.remove(0, count);
 
-      // Update group in groups array
-      groups.removeAt(i);
-      groups.insert(i, group);
+  // JSON map was unloaded while the frames were being parsed
+  if (operationMode() != kManual || !m_frame.isValid())
+    return;
 
-      // Update groups array in JSON frame
-      jsonData.remove("groups");
-      jsonData.insert("groups", groups);
-    }
+  // Generate frames
+  QVector<JSON::Frame> batch;
+  batch.reserve(count);
+  updateResamplerOwners();
+  for (int i = 0; i < count; ++i)
+  {
+    if (fields.at(i).isEmpty())
+      continue;
+
+    m_frame.setTimestamp(info.at(i).timestamp);
+    if (applyFields(fields.at(i), info.at(i).device, routes.at(i)))
+      appendFrame(batch, m_frame, info.at(i).device);
   }
 
   // Update UI
-  if (!jsonData.isEmpty())
-    Q_EMIT jsonChanged(jsonData);
+  publishFrames(batch);
+}
+
+/**
+ * Appends the given @a frame (produced by the given @a device) to the
+ * @a batch of frames that will be delivered to the rest of the application.
+ * If resampling is enabled, the frames generated by the resampler are
+ * appended instead.
+ */
+void JSON::Generator::appendFrame(QVector<JSON::Frame> &batch,
+                                  const JSON::Frame &frame, const int device)
+{
+  if (m_resampler.mode() == Resampler::Mode::Disabled)
+    batch.append(m_framePool.acquire(frame));
+  else
+    m_resampler.process(frame, device, batch);
+}
+
+/**
+ * Publishes a @a frame whose values were already generated (e.g. a row of a
+ * recording replayed by the @c CSV::Player), the frame parser, calibrations,
+ * computed datasets & alarm rules are not applied again.
+ */
+void JSON::Generator::publishRecordedFrame(const JSON::Frame &frame)
+{
+  QMutexLocker locker(processingMutex());
+
+  QVector<JSON::Frame> batch;
+  batch.append(frame);
+  publishFrames(batch);
+}
+
+/**
+ * Hands the given @a batch of frames & the alarm & sequence events registered
+ * while the batch was generated to the rest of the application.
+ *
+ * When frames are generated in the worker thread (or while threaded
+ * processing is enabled), the batch is appended to the outbox & delivered by
+ * the main thread with @c deliverFrames(), so that no signal is emitted while
+ * the processing lock is held.
+ */
+void JSON::Generator::publishFrames(const QVector<JSON::Frame> &batch)
+{
+  // Update the latest frame snapshot
+  if (!batch.isEmpty())
+    m_snapshot.publish(batch.last());
+
+  // Take the events registered while the batch was generated
+  QVector<AlarmEvent> events;
+  QVector<SequenceEvent> sequenceEvents;
+  events.swap(m_alarmEvents);
+  sequenceEvents.swap(m_sequenceEvents);
+
+  // Notify the modules directly
+  if (!m_threadedProcessing)
+  {
+    emitFrames(batch, events, sequenceEvents);
+    return;
+  }
+
+  // Nothing to deliver
+  if (batch.isEmpty() && events.isEmpty() && sequenceEvents.isEmpty())
+    return;
+
+  // Append the frames to the outbox & schedule a single delivery, the outbox
+  // may exceed its capacity by one batch, since waitForOutbox() is called
+  // before the batch is generated
+  QMutexLocker locker(&m_outboxMutex);
+  m_outboxFrames.append(batch);
+  m_outboxEvents.append(events);
+  m_outboxSequenceEvents.append(sequenceEvents);
+  if (!m_deliveryPending)
+  {
+    m_deliveryPending = true;
+    QMetaObject::invokeMethod(this, "deliverFrames", Qt::QueuedConnection);
+  }
+}
+
+/**
+ * Publishes all the frames, alarm & sequence events of the outbox, this
+ * function runs in the main thread.
+ */
+void JSON::Generator::deliverFrames()
+{
+  QVector<JSON::Frame> batch;
+  QVector<AlarmEvent> events;
+  QVector<SequenceEvent> sequenceEvents;
+  {
+    QMutexLocker locker(&m_outboxMutex);
+    batch.swap(m_outboxFrames);
+    events.swap(m_outboxEvents);
+    sequenceEvents.swap(m_outboxSequenceEvents);
+    m_deliveryPending = false;
+  }
+
+  m_outboxDrained.wakeAll();
+
+  emitFrames(batch, events, sequenceEvents);
+}
+
+/**
+ * Returns the lock that protects the state of the generator while frames are
+ * generated in the worker thread, or a null pointer if the generator only
+ * runs in the main thread (so that @c QMutexLocker does nothing).
+ */
+QMutex *JSON::Generator::processingMutex()
+{
+  return m_threadedProcessing ? &m_mutex : Q_NULLPTR;
+}
+
+/**
+ * Blocks the worker thread while the outbox is full, so that frames are not
+ * generated faster than the main thread can deliver them. Returns @c false
+ * if threaded processing was disabled while waiting.
+ *
+ * @note The processing lock must not be held while waiting, since the main
+ *       thread may need it before it can deliver the outbox.
+ */
+bool JSON::Generator::waitForOutbox()
+{
+  QMutexLocker locker(&m_outboxMutex);
+  while (m_outboxFrames.count() >= MAX_OUTBOX_FRAMES)
+  {
+    if (!m_threadedProcessing)
+      return false;
+
+    m_outboxDrained.wait(&m_outboxMutex, 50);
+  }
+
+  return m_threadedProcessing;
+}
+
+/**
+ * Notifies the rest of the application about the given @a batch of frames,
+ * alarm @a events & @a sequenceEvents, JSON data is only generated if a
+ * module is connected to the @c jsonChanged() signal.
+ */
+void JSON::Generator::emitFrames(const QVector<JSON::Frame> &batch,
+                                 const QVector<AlarmEvent> &events,
+                                 const QVector<SequenceEvent> &sequenceEvents)
+{
+  // Notify the events registered while the batch was generated
+  if (!events.isEmpty())
+    Q_EMIT alarmsTriggered(events);
+  if (!sequenceEvents.isEmpty())
+    Q_EMIT sequenceErrorsDetected(sequenceEvents);
+
+  // Nothing to publish
+  if (batch.isEmpty())
+    return;
+
+  // Generate JSON data for each frame
+  static const auto jsonSignal
+      = QMetaMethod::fromSignal(&JSON::Generator::jsonChanged);
+  if (isSignalConnected(jsonSignal))
+  {
+    for (int i = 0; i < batch.count(); ++i)
+      Q_EMIT jsonChanged(batch.at(i).jsonData());
+  }
+
+  // Register the latency of each frame
+  auto &diagnostics = Misc::Diagnostics::instance();
+  for (int i = 0; i < batch.count(); ++i)
+    diagnostics.recordLatency(Misc::Diagnostics::Stage::FrameLatency,
+                              batch.at(i).timestamp());
+
+  // Publish every frame to the modules that record data
+  Q_EMIT framesChanged(batch);
+  m_sinks.publish(SinkGraph::Port::Frames, batch);
+
+  // Only display the most recent frames if the main thread fell behind
+  auto display = batch;
+  if (m_backpressurePolicy == kDropOldest
+      && display.count() > MAX_DISPLAY_FRAMES)
+  {
+    const int dropped = display.count() - MAX_DISPLAY_FRAMES;
+    display.remove(0, dropped);
+    diagnostics.increment(Misc::Diagnostics::Counter::DisplayFramesDropped,
+                          dropped);
+  }
+
+  // Publish the decimated frames to the live consumers
+  if (m_decimator.isEmpty())
+  {
+    Q_EMIT decimatedFramesChanged(display);
+    m_sinks.publish(SinkGraph::Port::DecimatedFrames, display);
+  }
+  else
+  {
+    m_decimatedFrames.clear();
+    m_decimator.process(display, m_decimatedFrames);
+    if (!m_decimatedFrames.isEmpty())
+    {
+      Q_EMIT decimatedFramesChanged(m_decimatedFrames);
+      m_sinks.publish(SinkGraph::Port::DecimatedFrames, m_decimatedFrames);
+    }
+  }
+}
+
+/**
+ * Registers the device that feeds each dataset of the compiled JSON map in
+ * the resampler, so that the values that a frame holds for the datasets of
+ * other devices are not registered as new samples.
+ */
+void JSON::Generator::updateResamplerOwners()
+{
+  // Resampling disabled
+  if (m_resampler.mode() == Resampler::Mode::Disabled)
+    return;
+
+  // Frames contain the data of a single device in automatic mode
+  QVector<int> owners;
+  if (operationMode() == kManual && m_frame.isValid())
+  {
+    owners.fill(-1, m_frame.values().count());
+    for (int i = 0; i < m_fieldMap.count(); ++i)
+    {
+      const auto &mapping = m_fieldMap.at(i);
+      const auto index = m_frame.valueIndex(mapping.group, mapping.dataset);
+      if (index >= 0)
+        owners[index] = fieldDevice(mapping.field);
+    }
+  }
+
+  // Update resampler
+  m_resampler.setOwners(owners);
+}
+
+/**
+ * Updates the separator sequence used by the native frame splitter
+ */
+void JSON::Generator::updateSeparator()
+{
+  QMutexLocker locker(processingMutex());
+  m_separator = IO::Manager::instance().separatorSequence();
+  m_splitter.setSeparator(m_separator.toUtf8());
+}
+
+/**
+ * Copies the code & options of the frame parser loaded by the code editor,
+ * so that the worker thread does not read the state of the editor.
+ */
+void JSON::Generator::updateParser()
+{
+  auto &editor = Project::CodeEditor::instance();
+  QMutexLocker locker(processingMutex());
+  m_parserCode = editor.frameParserCode();
+  m_nativeSplit = editor.nativeSplit();
+  m_batchParsing = editor.batchParsing();
+}
+
+/**
+ * Copies the range of project fields fed by each device of the I/O manager,
+ * so that the worker thread does not iterate the device list of the manager
+ * while devices are added or removed.
+ */
+void JSON::Generator::updateDevices()
+{
+  auto &io = IO::Manager::instance();
+  QVector<DeviceRange> ranges;
+
+  DeviceRange primary;
+  primary.device = 0;
+  io.deviceFieldRange(0, &primary.begin, &primary.end);
+  ranges.append(primary);
+
+  Q_FOREACH (const auto &item, io.devices())
+  {
+    DeviceRange range;
+    range.device = item.toMap().value("id").toInt();
+    io.deviceFieldRange(range.device, &range.begin, &range.end);
+    ranges.append(range);
+  }
+
+  QMutexLocker locker(processingMutex());
+  m_deviceRanges = ranges;
+}
+
+/**
+ * Returns the identifier of the device that feeds the given project @a field,
+ * (see @c IO::Manager::fieldDevice()) from the copy made by
+ * @c updateDevices().
+ */
+int JSON::Generator::fieldDevice(const int field) const
+{
+  int device = 0;
+  int offset = 0;
+  for (const auto &range : m_deviceRanges)
+  {
+    if (range.begin <= field && range.begin > offset)
+    {
+      device = range.device;
+      offset = range.begin;
+    }
+  }
+
+  return device;
+}
+
+/**
+ * Obtains the range of project fields fed by the given @a device (see
+ * @c IO::Manager::deviceFieldRange()) from the copy made by
+ * @c updateDevices(). Unknown devices (e.g. the streams of the selected
+ * driver) use the range of the selected driver.
+ */
+void JSON::Generator::deviceFieldRange(const int device, int *begin,
+                                       int *end) const
+{
+  Q_ASSERT(begin);
+  Q_ASSERT(end);
+
+  *begin = 0;
+  *end = INT_MAX;
+  for (const auto &range : m_deviceRanges)
+  {
+    if (range.device == device)
+    {
+      *begin = range.begin;
+      *end = range.end;
+      return;
+    }
+  }
+
+  for (const auto &range : m_deviceRanges)
+  {
+    if (range.device == 0)
+    {
+      *begin = range.begin;
+      *end = range.end;
+      return;
+    }
+  }
+}
+
+/**
+ * Re-synchronizes the sequence counters with the device when a connection is
+ * opened or closed, so that reconnections are not reported as lost frames.
+ */
+void JSON::Generator::resetSequences()
+{
+  QMutexLocker locker(processingMutex());
+  m_sequences.reset();
+}
+
+/**
+ * Returns @c true if frames can be split with the native frame splitter
+ * instead of calling the frame parser script.
+ */
+bool JSON::Generator::useNativeSplit() const
+{
+  return m_nativeSplit && !m_splitter.separator().isEmpty();
+}
+
+/**
+ * Post-processes the values of the compiled frame after the fields within
+ * [@a begin, @a end) have been updated: calibrated datasets are converted to
+ * engineering units, the values of the computed datasets are evaluated (in
+ * project order, so a computed dataset can use the ones declared before it)
+ * and the alarm rules & sequence counters of the updated datasets are checked.
+ */
+void JSON::Generator::processValues(const int begin, const int end)
+{
+  m_calibration.apply(m_frame, begin, end);
+
+  const auto timestamp = m_frame.timestamp();
+  for (int i = 0; i < m_computedDatasets.count(); ++i)
+  {
+    auto &computed = m_computedDatasets[i];
+    const auto values = m_frame.values().constData();
+    const auto value = computed.expression.evaluate(values, timestamp);
+    m_frame.setDatasetValue(computed.group, computed.dataset, value);
+  }
+
+  m_alarms.evaluate(m_frame, begin, end, m_alarmEvents);
+  m_sequences.evaluate(m_frame, begin, end, m_sequenceEvents);
+}
+
+/**
+ * Returns @c true if the project declares a binary layout, in which case
+ * frames are decoded natively instead of calling the frame parser script.
+ */
+bool JSON::Generator::useBinaryDecoder() const
+{
+  return !m_decoder.isEmpty();
+}
+
+/**
+ * Returns @c true if the project decodes NMEA 0183 sentences natively instead
+ * of calling the frame parser script.
+ */
+bool JSON::Generator::useNmeaDecoder() const
+{
+  return !m_nmea.isEmpty();
+}
+
+/**
+ * Returns @c true if the project decodes its frames with a WebAssembly
+ * module instead of calling the frame parser script.
+ */
+bool JSON::Generator::useWasmDecoder() const
+{
+  return !m_wasm.isEmpty();
+}
+
+/**
+ * Updates the values of the compiled frame with the given list of @a fields
+ * returned by the frame parser script for a frame of the given @a device.
+ *
+ * Only the datasets within the field range of the device are updated, the
+ * rest of the datasets keep the last values received from other devices.
+ * If frames are routed, only the datasets of the frame type given by
+ * @a route (or by the first field in field mode) are updated, and @c false
+ * is returned if the frame type is unknown.
+ */
+bool JSON::Generator::applyFields(const QStringList &fields, const int device,
+                                  const int route)
+{
+  int begin, end;
+  deviceFieldRange(device, &begin, &end);
+
+  // Get the datasets of the frame type, in field mode the first field is
+  // the frame identifier
+  int skip = 0;
+  int type = route;
+  if (m_router.mode() == FrameRouter::Mode::Field)
+  {
+    skip = 1;
+    type = fields.isEmpty() ? -1 : m_router.route(fields.first());
+  }
+
+  if (m_router.isEnabled() && type < 0)
+    return false;
+
+  const auto &map = m_router.isEnabled() ? m_routedFieldMaps.at(type)
+                                         : m_fieldMap;
+
+  // Update the datasets
+  for (int i = 0; i < map.count(); ++i)
+  {
+    const auto &mapping = map.at(i);
+    if (mapping.field < begin || mapping.field >= end)
+      continue;
+
+    const int field = mapping.field - begin + skip;
+    if (field < fields.count())
+      m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                              fields.at(field));
+    else
+      m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                              mapping.defaultValue);
+  }
+
+  processValues(begin, end);
+  return true;
+}
+
+/**
+ * Obtains the @c Frame object built from the loaded JSON map & creates a table
+ * with the group, dataset and field index of each dataset that is fed by the
+ * received data. This is done once when the map is loaded, so that frames can
+ * be generated without modifying and re-parsing the JSON map for each received
+ * frame.
+ *
+ * If @a project is null, the compiled data is cleared.
+ */
+void JSON::Generator::compileJsonMap(const CompiledProjectPtr &project)
+{
+  // Reset compiled data
+  QMutexLocker locker(processingMutex());
+  m_fieldMap.clear();
+  m_framePool.clear();
+  m_router.clear();
+  m_routedFieldMaps.clear();
+  m_decoder.clear();
+  m_nmea.clear();
+  m_wasm.clear();
+  m_calibration.clear();
+  m_computedDatasets.clear();
+  m_alarmEvents.clear();
+  m_alarms.clear();
+  m_sequenceEvents.clear();
+  m_sequences.clear();
+  m_decimator.clear();
+  m_frame.clear();
+
+  // Use the frame & binary decoder built by the project cache
+  if (!project || !project->frame.isValid())
+    return;
+
+  m_frame = project->frame;
+  m_decoder = project->decoder;
+  m_nmea = project->nmea;
+  m_wasm = project->wasm;
+
+  // Read & compile the WebAssembly frame parser
+  QString error;
+  if (!m_wasm.load(&error))
+    qWarning() << "Cannot load WebAssembly module" << m_wasm.modulePath()
+               << error;
+
+  // Compile dataset calibrations
+  if (!m_calibration.compile(m_frame, &error))
+    qWarning() << "Invalid dataset calibration:" << error;
+
+  // Compile the expressions of computed datasets
+  for (int i = 0; i < m_frame.groupCount(); ++i)
+  {
+    const auto &group = m_frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      if (dataset.expression().isEmpty())
+        continue;
+
+      ComputedDataset computed;
+      computed.group = i;
+      computed.dataset = j;
+      if (computed.expression.compile(dataset.expression(), m_frame, &error))
+        m_computedDatasets.append(computed);
+      else
+        qWarning() << "Invalid expression for" << dataset.title() << error;
+    }
+  }
+
+  // Compile dataset alarm rules
+  if (!m_alarms.compile(m_frame, &error))
+    qWarning() << "Invalid alarm rules:" << error;
+
+  // Register the sequence counters of the datasets
+  m_sequences.compile(m_frame);
+
+  // Compile the decimation policies of the datasets
+  const auto factor = project->json.value("decimation").toInt(1);
+  if (!m_decimator.compile(m_frame, factor, &error))
+    qWarning() << "Invalid decimation:" << error;
+
+  // Register the field that feeds each dataset
+  auto &groups = m_frame.groups();
+  for (int i = 0; i < groups.count(); ++i)
+  {
+    auto &datasets = groups[i].datasets();
+    for (int j = 0; j < datasets.count(); ++j)
+    {
+      const auto index = datasets.at(j).index();
+      if (index >= 1)
+      {
+        FieldMapping mapping;
+        mapping.group = i;
+        mapping.dataset = j;
+        mapping.field = index - 1;
+        mapping.defaultValue = datasets.at(j).value();
+        m_fieldMap.append(mapping);
+      }
+    }
+  }
+
+  // Compile frame type routing, binary frames have no fields
+  const auto routing = project->json.value("frameRouting").toObject();
+  if (!m_router.compile(m_frame, routing, &error))
+    qWarning() << "Invalid frame routing:" << error;
+  else if (m_router.mode() == FrameRouter::Mode::Field && !m_decoder.isEmpty())
+  {
+    qWarning() << "Field frame routing cannot be used with binary frames";
+    m_router.clear();
+  }
+  else if (m_router.isEnabled() && m_router.mode() != FrameRouter::Mode::Field
+           && !m_nmea.isEmpty())
+  {
+    qWarning() << "NMEA sentences can only be routed in field mode";
+    m_router.clear();
+  }
+
+  // Register the datasets fed by each frame type
+  m_routedFieldMaps.resize(m_router.routeCount());
+  for (int route = 0; route < m_router.routeCount(); ++route)
+  {
+    const auto &routedGroups = m_router.groups(route);
+    for (int i = 0; i < m_fieldMap.count(); ++i)
+    {
+      if (routedGroups.contains(m_fieldMap.at(i).group))
+        m_routedFieldMaps[route].append(m_fieldMap.at(i));
+    }
+  }
+}
+
+/**
+ * Reads the JSON frame sent by a device in automatic mode into the given
+ * @a frame.
+ *
+ * If everything except the dataset values is identical to the last frame
+ * that was parsed, the values are copied directly from the raw @a data with
+ * the @c JsonScanner. Otherwise, the frame is parsed with @c QJsonDocument &
+ * its layout is registered for the following frames.
+ */
+bool JSON::Generator::readJson(const QByteArray &data, JSON::Frame &frame)
+{
+  // Same layout as the previous frame, skip the JSON document entirely
+  if (frame.isValid() && frame.schemaHash() == m_jsonSchemaHash
+      && m_jsonScanner.match(data))
+  {
+    int index = 0;
+    const auto &spans = m_jsonScanner.values();
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const int count = frame.getGroup(i).datasetCount();
+      for (int j = 0; j < count; ++j, ++index)
+      {
+        const auto &span = spans.at(index);
+        frame.setDatasetValue(i, j, data.constData() + span.offset,
+                              span.length);
+      }
+    }
+
+    return true;
+  }
+
+  // Parse the JSON document
+  const auto document = QJsonDocument::fromJson(data);
+  if (!frame.read(document.object()))
+    return false;
+
+  // Register the layout of complete frames
+  if (document.object().contains("groups"))
+  {
+    if (m_jsonScanner.learn(data, frame.values().count()))
+      m_jsonSchemaHash = frame.schemaHash();
+    else
+      m_jsonScanner.clear();
+  }
+
+  return true;
+}
+
+/**
+ * Obtains the frame type (@a route) of the given raw @a frame in prefix &
+ * byte routing modes, and writes the part of the frame that must be parsed
+ * to @a payload (without the identifier prefix). Returns @c false if the
+ * frame type is unknown & the frame must be discarded.
+ *
+ * In field mode (or if frames are not routed), the frame type is obtained
+ * after the frame is split & @a route is set to -1.
+ */
+bool JSON::Generator::routeFrame(const QByteArray &frame, QByteArray &payload,
+                                 int &route) const
+{
+  // Frame type is obtained from the fields
+  route = -1;
+  payload = frame;
+  const auto mode = m_router.mode();
+  if (mode != FrameRouter::Mode::Prefix && mode != FrameRouter::Mode::Byte)
+    return true;
+
+  // Get frame type & remove the identifier prefix
+  int skip = 0;
+  route = m_router.route(frame, &skip);
+  if (skip > 0)
+    payload = QByteArray::fromRawData(frame.constData() + skip,
+                                      frame.size() - skip);
+
+  return route >= 0;
+}
+
+/**
+ * Tries to parse the given data as a frame according to the selected
+ * operation mode, the result is written to the given @a frame.
+ *
+ * Possible operation modes:
+ * - Auto:   serial data contains the JSON data frame
+ * - Manual: serial data only contains the comma-separated values, and we need
+ *           to use a JSON map file (given by the user) to know what each value
+ *           means
+ *
+ * In manual mode, the fields of the frame are mapped to the datasets that are
+ * fed by the given @a device (see @c IO::Manager::deviceFieldRange()).
+ *
+ * @returns @c true if the frame was generated successfully.
+ */
+bool JSON::Generator::readData(const QByteArray &data, JSON::Frame &frame,
+                               const int device)
+{
+  TRACE_SCOPE("JSON::Generator::readData");
+
+  // Data empty, abort
+  if (data.isEmpty())
+    return false;
+
+  // Serial device sends JSON (auto mode)
+  if (operationMode() == JSON::Generator::kAutomatic)
+    return readJson(data, frame);
+
+  // Serial device sends CBOR or MessagePack frames, invalid frames are
+  // discarded without resetting the current frame
+  if (operationMode() == JSON::Generator::kCbor
+      || operationMode() == JSON::Generator::kMessagePack)
+  {
+    bool ok;
+    const auto object = operationMode() == JSON::Generator::kCbor
+                            ? BinaryFrameDecoder::fromCbor(data, &ok)
+                            : BinaryFrameDecoder::fromMessagePack(data, &ok);
+    return ok && frame.read(object);
+  }
+
+  // JSON map not loaded or not valid
+  if (!m_frame.isValid())
+    return false;
+
+  // Get the frame type & remove its identifier prefix
+  int route;
+  QByteArray payload;
+  if (!routeFrame(data, payload, route))
+    return false;
+
+  // NMEA sentence, decode the fields of the sentence natively. Sentences only
+  // carry some of the fields, the datasets of the rest keep their values
+  if (useNmeaDecoder())
+  {
+    int begin, end;
+    deviceFieldRange(device, &begin, &end);
+
+    // Invalid checksum or unsupported sentence
+    QByteArray type;
+    if (!m_nmea.decode(payload, m_decodedValues, &type))
+      return false;
+
+    // In field routing mode, the sentence type identifies the frame type
+    if (m_router.mode() == FrameRouter::Mode::Field)
+    {
+      route = m_router.route(type.constData(), type.size());
+      if (route < 0)
+        return false;
+    }
+
+    // Update the datasets of the frame type
+    const auto &map = route >= 0 ? m_routedFieldMaps.at(route) : m_fieldMap;
+    for (int i = 0; i < map.count(); ++i)
+    {
+      const auto &mapping = map.at(i);
+      if (mapping.field < begin || mapping.field >= end)
+        continue;
+
+      const int field = mapping.field - begin;
+      if (field < m_decodedValues.count()
+          && !qIsNaN(m_decodedValues.at(field)))
+        m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                                m_decodedValues.at(field));
+    }
+
+    processValues(begin, end);
+  }
+
+  // WebAssembly frame parser, NaN values keep the last value of the datasets
+  else if (useWasmDecoder())
+  {
+    int begin, end;
+    deviceFieldRange(device, &begin, &end);
+
+    // Module not loaded, trapped or discarded the frame
+    if (!m_wasm.decode(payload, m_decodedValues))
+      return false;
+
+    const auto &map = route >= 0 ? m_routedFieldMaps.at(route) : m_fieldMap;
+    for (int i = 0; i < map.count(); ++i)
+    {
+      const auto &mapping = map.at(i);
+      if (mapping.field < begin || mapping.field >= end)
+        continue;
+
+      const int field = mapping.field - begin;
+      if (field < m_decodedValues.count()
+          && !qIsNaN(m_decodedValues.at(field)))
+        m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                                m_decodedValues.at(field));
+    }
+
+    processValues(begin, end);
+  }
+
+  // Binary layout, decode the fields of the frame natively
+  else if (useBinaryDecoder())
+  {
+    int begin, end;
+    deviceFieldRange(device, &begin, &end);
+
+    // Invalid frame or CAN record not routed to any field
+    if (!m_decoder.decode(payload, m_decodedValues))
+      return false;
+
+    const bool routed = m_decoder.isRouted();
+    const auto &map = route >= 0 ? m_routedFieldMaps.at(route) : m_fieldMap;
+    for (int i = 0; i < map.count(); ++i)
+    {
+      const auto &mapping = map.at(i);
+      if (mapping.field < begin || mapping.field >= end)
+        continue;
+
+      const int field = mapping.field - begin;
+      if (field < m_decodedValues.count()
+          && !qIsNaN(m_decodedValues.at(field)))
+        m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                                m_decodedValues.at(field));
+
+      // Field belongs to another CAN message, keep its last value
+      else if (routed)
+        continue;
+
+      else
+        m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                                mapping.defaultValue);
+    }
+
+    processValues(begin, end);
+  }
+
+  // Default frame parser, split the frame natively & only convert the fields
+  // that feed a dataset to strings
+  else if (useNativeSplit())
+  {
+    int begin, end;
+    deviceFieldRange(device, &begin, &end);
+
+    const int count = m_splitter.split(payload, m_fieldSpans);
+
+    // In field routing mode, the first field identifies the frame type
+    int skip = 0;
+    if (m_router.mode() == FrameRouter::Mode::Field)
+    {
+      skip = 1;
+      if (count > 0)
+        route = m_router.route(payload.constData() + m_fieldSpans.at(0).offset,
+                               m_fieldSpans.at(0).length);
+      if (route < 0)
+        return false;
+    }
+
+    // Update the datasets of the frame type
+    const auto &map = route >= 0 ? m_routedFieldMaps.at(route) : m_fieldMap;
+    for (int i = 0; i < map.count(); ++i)
+    {
+      const auto &mapping = map.at(i);
+      if (mapping.field < begin || mapping.field >= end)
+        continue;
+
+      const int field = mapping.field - begin + skip;
+      if (field < count)
+      {
+        const auto &span = m_fieldSpans.at(field);
+        m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                                payload.constData() + span.offset,
+                                span.length);
+      }
+
+      else
+        m_frame.setDatasetValue(mapping.group, mapping.dataset,
+                                mapping.defaultValue);
+    }
+
+    processValues(begin, end);
+  }
+
+  // Get fields from the custom frame parser function
+  else
+  {
+    auto fields = Project::CodeEditor::instance().parse(
+        QString::fromUtf8(payload), m_separator);
+
+    // Frame was skipped by the parser (e.g. execution time budget exceeded)
+    if (fields.isEmpty())
+      return false;
+
+    // Frame type is unknown
+    if (!applyFields(fields, device, route))
+      return false;
+  }
+
+  // Copy the frame into a pooled frame, so that the storage of the working
+  // frame is not shared & does not need to be reallocated for the next frame
+  frame = m_framePool.acquire(m_frame);
+  return true;
 }
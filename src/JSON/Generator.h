@@ -22,15 +22,41 @@
 
 #pragma once
 
+#include <atomic>
 #include <QFile>
+#include <QMutex>
 #include <QObject>
-#include <QSettings>
+#include <QThread>
+#include <QWaitCondition>
+#include <QVector>
 #include <QJsonArray>
 #include <QJsonValue>
 #include <QJsonObject>
 #include <QJsonDocument>
 
+#include <DataTypes.h>
+#include <IO/FrameQueue.h>
+
 #include <JSON/Frame.h>
+#include <JSON/FramePool.h>
+#include <JSON/FrameSnapshot.h>
+#include <JSON/Resampler.h>
+#include <JSON/ProjectCache.h>
+#include <JSON/ParserPool.h>
+#include <JSON/SinkGraph.h>
+#include <JSON/Decimator.h>
+#include <JSON/Expression.h>
+#include <JSON/AlarmEngine.h>
+#include <JSON/Calibration.h>
+#include <JSON/SequenceTracker.h>
+#include <JSON/BinaryDecoder.h>
+#include <JSON/BinaryFrameDecoder.h>
+#include <JSON/FieldSplitter.h>
+#include <JSON/NmeaDecoder.h>
+#include <JSON/WasmDecoder.h>
+#include <JSON/FrameRouter.h>
+#include <JSON/JsonScanner.h>
+#include <Misc/Settings.h>
 
 namespace JSON
 {
@@ -56,6 +82,56 @@ namespace JSON
  *    the latest received frame.
  * 9) UI dashboard updates the widgets with the C++ model provided by this
  * class.
+ *
+ * In manual mode, the JSON map is compiled into a @c Frame object and a table
+ * that associates each field of the received data with a dataset when the map
+ * is loaded. Each received frame is generated by copying this frame and
+ * updating the values of its datasets, JSON data is only generated when a
+ * module needs it (see @c Frame::jsonData()). Projects that declare a binary
+ * layout are decoded natively with a @c BinaryDecoder instead of running the
+ * frame parser script, projects of NMEA 0183 instruments can decode their
+ * sentences natively with a @c NmeaDecoder, and complex protocols can be
+ * decoded by a WebAssembly module with a @c WasmDecoder. Calibrated datasets
+ * are converted to engineering units by a @c Calibration stage right after
+ * the fields are obtained, and the values of computed datasets are evaluated with
+ * their compiled @c Expression. Finally, the alarm rules of the datasets are
+ * evaluated by an @c AlarmEngine, the resulting events are emitted with
+ * @c alarmsTriggered() together with each batch of frames. The frame counters
+ * sent by the device (if any) are checked by a @c SequenceTracker, lost,
+ * duplicated & reordered frames are emitted with @c sequenceErrorsDetected()
+ * in the same way. Projects that
+ * multiplex several frame types on the same link use a @c FrameRouter, so
+ * that each frame only updates the datasets of the groups of its frame type.
+ *
+ * Optionally, the generated frames are placed on a common time base by a
+ * @c Resampler before they are delivered to the rest of the application, so
+ * that the data of devices with different sampling rates stays aligned.
+ *
+ * Every generated frame is emitted with @c framesChanged(), which is used by
+ * the modules that record data. Projects may also set a decimation factor,
+ * in which case the live consumers (dashboard, MQTT & plugins) receive the
+ * reduced stream emitted with @c decimatedFramesChanged(), built by a
+ * @c Decimator with the policy of each dataset. Both streams are also
+ * published to the ports of the @c SinkGraph (see @c sinks()), which is how
+ * the application modules consume them.
+ *
+ * Frames can optionally be generated in a dedicated worker thread (see
+ * @c setThreadedProcessing()). The state of other modules that is needed to
+ * generate frames (separator sequence, frame parser options & field ranges of
+ * the devices) is copied in the main thread when it changes, so that the
+ * worker thread never reads it directly. The generated frames, alarm &
+ * sequence events are appended to an outbox, which is handed to the main thread in a
+ * single queued call, so that the modules connected to the signals of this
+ * class keep running in the main thread.
+ *
+ * The outbox is bounded: while it is full, the worker thread stops reading
+ * the frame queue until the main thread catches up, so the frames that
+ * reach the generator are never discarded before they are recorded. The
+ * backpressure policy (see @c setBackpressurePolicy()) selects what happens
+ * when the main thread falls behind: either the live consumers only receive
+ * the most recent frames of each delivery (the rest are counted as dropped
+ * display frames), or they receive every frame & frame generation is slowed
+ * down instead.
  */
 class Generator : public QObject
 {
@@ -67,19 +143,52 @@ class Generator : public QObject
     Q_PROPERTY(QString jsonMapFilepath
                READ jsonMapFilepath
                NOTIFY jsonFileMapChanged)
+    Q_PROPERTY(QStringList recentProjects
+               READ recentProjects
+               NOTIFY recentProjectsChanged)
     Q_PROPERTY(OperationMode operationMode
                READ operationMode
                WRITE setOperationMode
                NOTIFY operationModeChanged)
+    Q_PROPERTY(bool parallelParsing
+               READ parallelParsing
+               WRITE setParallelParsing
+               NOTIFY parallelParsingChanged)
+    Q_PROPERTY(bool threadedProcessing
+               READ threadedProcessing
+               WRITE setThreadedProcessing
+               NOTIFY threadedProcessingChanged)
+    Q_PROPERTY(int backpressurePolicy
+               READ backpressurePolicy
+               WRITE setBackpressurePolicy
+               NOTIFY backpressurePolicyChanged)
+    Q_PROPERTY(int resamplingMode
+               READ resamplingMode
+               WRITE setResamplingMode
+               NOTIFY resamplingChanged)
+    Q_PROPERTY(int resamplingInterval
+               READ resamplingInterval
+               WRITE setResamplingInterval
+               NOTIFY resamplingChanged)
   // clang-format on
 
 Q_SIGNALS:
   void jsonFileMapChanged();
+  void recentProjectsChanged();
   void operationModeChanged();
+  void resamplingChanged();
+  void parallelParsingChanged();
+  void threadedProcessingChanged();
+  void backpressurePolicyChanged();
   void jsonChanged(const QJsonObject &json);
+  void framesChanged(const QVector<JSON::Frame> &frames);
+  void decimatedFramesChanged(const QVector<JSON::Frame> &frames);
+  void alarmsTriggered(const QVector<JSON::AlarmEvent> &events);
+  void sequenceErrorsDetected(const QVector<JSON::SequenceEvent> &events);
 
 private:
   explicit Generator();
+  ~Generator();
   Generator(Generator &&) = delete;
   Generator(const Generator &) = delete;
   Generator &operator=(Generator &&) = delete;
@@ -89,20 +198,53 @@ public:
   enum OperationMode
   {
     kManual = 0x00,
-    kAutomatic = 0x01
+    kAutomatic = 0x01,
+    kCbor = 0x02,
+    kMessagePack = 0x03
   };
   Q_ENUM(OperationMode)
 
+  enum BackpressurePolicy
+  {
+    kDropOldest = 0x00,
+    kBlockIngestion = 0x01
+  };
+  Q_ENUM(BackpressurePolicy)
+
   static Generator &instance();
 
   QJsonObject &json();
   QString jsonMapFilename() const;
   QString jsonMapFilepath() const;
+  QStringList recentProjects() const;
+  quint64 schemaHash();
+  bool parallelParsing() const;
+  bool threadedProcessing() const;
+  int backpressurePolicy() const;
+  int queuedFrames();
+  bool inputSuspended() const;
+  int resamplingMode() const;
+  int resamplingInterval() const;
   OperationMode operationMode() const;
+  JSON::FrameSnapshot &snapshot();
+  JSON::SinkGraph &sinks();
+
+  Q_INVOKABLE StringList availableResamplingModes() const;
+  Q_INVOKABLE StringList availableBackpressurePolicies() const;
+
+  void processFrames(const QVector<QByteArray> &frames,
+                     const QVector<IO::FrameInfo> &info);
+  void publishRecordedFrame(const JSON::Frame &frame);
 
 public Q_SLOTS:
   void loadJsonMap();
   void loadJsonMap(const QString &path);
+  void setParallelParsing(const bool enabled);
+  void setThreadedProcessing(const bool enabled);
+  void setBackpressurePolicy(const int policy);
+  void setInputSuspended(const bool suspended);
+  void setResamplingMode(const int mode);
+  void setResamplingInterval(const int interval);
   void setOperationMode(const JSON::Generator::OperationMode &mode);
 
 public Q_SLOTS:
@@ -110,13 +252,126 @@ public Q_SLOTS:
   void writeSettings(const QString &path);
 
 private Q_SLOTS:
-  void readData(const QByteArray &data);
+  void readFrames();
+  void deliverFrames();
+  void updateSeparator();
+  void updateParser();
+  void updateDevices();
+  void resetSequences();
+  void onFramesParsed(const QVector<QStringList> &fields);
+
+private:
+  QMutex *processingMutex();
+  bool waitForOutbox();
+  void generateFrames(const QVector<QByteArray> &frames,
+                      const QVector<IO::FrameInfo> &info);
+  void compileJsonMap(const CompiledProjectPtr &project);
+  int fieldDevice(const int field) const;
+  void deviceFieldRange(const int device, int *begin, int *end) const;
+  bool useNativeSplit() const;
+  bool useBinaryDecoder() const;
+  bool useNmeaDecoder() const;
+  bool useWasmDecoder() const;
+  void processValues(const int begin, const int end);
+  void updateResamplerOwners();
+  void publishFrames(const QVector<JSON::Frame> &batch);
+  void emitFrames(const QVector<JSON::Frame> &batch,
+                  const QVector<AlarmEvent> &events,
+                  const QVector<SequenceEvent> &sequenceEvents);
+  void appendFrame(QVector<JSON::Frame> &batch, const JSON::Frame &frame,
+                   const int device);
+  bool applyFields(const QStringList &fields, const int device,
+                   const int route);
+  bool readData(const QByteArray &data, JSON::Frame &frame,
+                const int device);
+  bool readJson(const QByteArray &data, JSON::Frame &frame);
+  bool routeFrame(const QByteArray &frame, QByteArray &payload,
+                  int &route) const;
+
+private:
+  struct FieldMapping
+  {
+    int group;
+    int dataset;
+    int field;
+    QString defaultValue;
+  };
+
+  struct ComputedDataset
+  {
+    int group;
+    int dataset;
+    Expression expression;
+  };
+
+  struct DeviceRange
+  {
+    int device;
+    int begin;
+    int end;
+  };
 
 private:
   QFile m_jsonMap;
   QJsonObject m_json;
-  QSettings m_settings;
+  QStringList m_recentProjects;
+  JSON::Frame m_frame;
+  JSON::Frame m_lastFrame;
+  JSON::FramePool m_framePool;
+  JSON::FrameSnapshot m_snapshot;
+  JSON::SinkGraph m_sinks;
+  Misc::Settings m_settings;
   OperationMode m_opMode;
+  int m_frameConsumer;
+  bool m_parallelParsing;
+  bool m_inputSuspended;
   QJsonParseError m_error;
+  QVector<FieldMapping> m_fieldMap;
+
+  FrameRouter m_router;
+  JsonScanner m_jsonScanner;
+  quint64 m_jsonSchemaHash;
+  QVector<QVector<FieldMapping>> m_routedFieldMaps;
+
+  FieldSplitter m_splitter;
+  QVector<FieldSpan> m_fieldSpans;
+
+  QString m_separator;
+  QString m_parserCode;
+  bool m_nativeSplit;
+  bool m_batchParsing;
+  QVector<DeviceRange> m_deviceRanges;
+
+  BinaryDecoder m_decoder;
+  NmeaDecoder m_nmea;
+  WasmDecoder m_wasm;
+  QVector<double> m_decodedValues;
+  Calibration m_calibration;
+  QVector<ComputedDataset> m_computedDatasets;
+  AlarmEngine m_alarms;
+  QVector<AlarmEvent> m_alarmEvents;
+  SequenceTracker m_sequences;
+  QVector<SequenceEvent> m_sequenceEvents;
+  Decimator m_decimator;
+  QVector<JSON::Frame> m_decimatedFrames;
+
+  Resampler m_resampler;
+  ParserPool m_parserPool;
+  QVector<IO::FrameInfo> m_parsedFrames;
+  QVector<int> m_parsedRoutes;
+
+  QMutex m_mutex;
+  QThread m_thread;
+  QObject *m_worker;
+  QMetaObject::Connection m_workerConnection;
+  std::atomic<bool> m_threadedProcessing;
+
+  QMutex m_outboxMutex;
+  bool m_deliveryPending;
+  QWaitCondition m_outboxDrained;
+  std::atomic<int> m_backpressurePolicy;
+  QVector<JSON::Frame> m_outboxFrames;
+  QVector<AlarmEvent> m_outboxEvents;
+  QVector<SequenceEvent> m_outboxSequenceEvents;
 };
 } // namespace JSON
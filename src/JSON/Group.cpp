@@ -22,9 +22,18 @@
 
 #include <QJsonArray>
 #include <JSON/Group.h>
+#include <JSON/StringTable.h>
 
 static JSON::Dataset EMPTY_DATASET;
 
+/**
+ * Constructor function
+ */
+JSON::Group::Group()
+  : m_columns(0)
+{
+}
+
 /**
  * Destructor function
  */
@@ -49,6 +58,24 @@ QString JSON::Group::widget() const
   return m_widget;
 }
 
+/**
+ * @return The identifier of the frame type that feeds this group, empty if
+ *         frames are not routed (see @c JSON::FrameRouter)
+ */
+QString JSON::Group::frameId() const
+{
+  return m_frameId;
+}
+
+/**
+ * @return The number of columns of the matrix displayed by a heatmap group,
+ *         or 0 if the group is not a heatmap
+ */
+int JSON::Group::columns() const
+{
+  return m_columns;
+}
+
 /**
  * @return The number of datasets inside this group
  */
@@ -57,6 +84,21 @@ int JSON::Group::datasetCount() const
   return m_datasets.count();
 }
 
+/**
+ * @return The JSON data that represents this group, including the current
+ *         values of its datasets
+ */
+QJsonObject JSON::Group::jsonData() const
+{
+  QJsonArray datasets;
+  for (int i = 0; i < m_datasets.count(); ++i)
+    datasets.append(m_datasets.at(i).jsonData());
+
+  auto object = m_jsonData;
+  object.insert("datasets", datasets);
+  return object;
+}
+
 /**
  * @return A list with all the dataset objects contained in this group
  */
@@ -93,8 +135,10 @@ bool JSON::Group::read(const QJsonObject &object)
 
     if (!title.isEmpty() && !array.isEmpty())
     {
-      m_title = title;
-      m_widget = widget;
+      m_title = StringTable::intern(title);
+      m_widget = StringTable::intern(widget);
+      m_frameId = StringTable::intern(object.value("frameId").toString());
+      m_columns = qMax(0, object.value("columns").toInt());
       m_datasets.clear();
 
       for (auto i = 0; i < array.count(); ++i)
@@ -108,6 +152,7 @@ bool JSON::Group::read(const QJsonObject &object)
         }
       }
 
+      m_jsonData = object;
       return datasetCount() > 0;
     }
   }
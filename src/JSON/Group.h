@@ -55,16 +55,24 @@ namespace JSON
  * A group contains the following properties:
  * - Title
  * - Widget
+ * - Frame ID, used to route multiplexed frame types (see
+ *   @c JSON::FrameRouter)
+ * - Number of columns, used by the heatmap widget to arrange the values of
+ *   the datasets in a matrix
  * - A vector of datasets
  */
 class Group
 {
 public:
+  Group();
   ~Group();
 
   QString title() const;
   QString widget() const;
+  QString frameId() const;
+  int columns() const;
   int datasetCount() const;
+  QJsonObject jsonData() const;
   QVector<JSON::Dataset> &datasets();
   bool read(const QJsonObject &object);
 
@@ -73,8 +81,12 @@ public:
 private:
   QString m_title;
   QString m_widget;
+  QString m_frameId;
+  int m_columns;
+  QJsonObject m_jsonData;
   QVector<JSON::Dataset> m_datasets;
 
+  friend class Frame;
   friend class UI::Dashboard;
   friend class Project::Model;
 };
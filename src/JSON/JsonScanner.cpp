@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QVarLengthArray>
+#include <JSON/JsonScanner.h>
+
+/**
+ * Containers of the JSON frame that are relevant to the scanner
+ */
+enum Context
+{
+  kRoot,
+  kGroups,
+  kGroup,
+  kDatasets,
+  kDataset,
+  kObject,
+  kArray
+};
+
+/**
+ * Returns @c true if the given @a key span of the @a data block equals the
+ * given null-terminated @a name.
+ */
+static inline bool KEY_IS(const char *data, const JSON::FieldSpan &key,
+                          const char *name)
+{
+  const auto length = static_cast<int>(strlen(name));
+  return key.length == length && memcmp(data + key.offset, name, length) == 0;
+}
+
+/**
+ * Returns @c true if the given character is JSON whitespace
+ */
+static inline bool IS_SPACE(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * Returns @c true if the given character marks the end of a JSON number or
+ * literal (@c true, @c false or @c null).
+ */
+static inline bool IS_DELIMITER(const char c)
+{
+  return c == ',' || c == '}' || c == ']' || IS_SPACE(c);
+}
+
+/**
+ * Constructor function
+ */
+JSON::JsonScanner::JsonScanner() {}
+
+/**
+ * Discards the frame layout registered with @c learn()
+ */
+void JSON::JsonScanner::clear()
+{
+  m_layout.clear();
+  m_values.clear();
+}
+
+/**
+ * Returns @c true if no frame layout has been registered
+ */
+bool JSON::JsonScanner::isEmpty() const
+{
+  return m_layout.isEmpty();
+}
+
+/**
+ * Returns the position of the dataset values of the last scanned frame, in
+ * frame order (group by group, dataset by dataset). String values do not
+ * include the quotes.
+ */
+const QVector<JSON::FieldSpan> &JSON::JsonScanner::values() const
+{
+  return m_values;
+}
+
+/**
+ * Scans the given @a frame & returns @c true if everything except the dataset
+ * values is byte-by-byte identical to the frame registered with @c learn().
+ * In that case, the dataset values can be obtained with @c values().
+ */
+bool JSON::JsonScanner::match(const QByteArray &frame)
+{
+  // No layout registered or invalid frame
+  if (m_layout.isEmpty() || !scan(frame))
+    return false;
+
+  // Compare the bytes between the values with the registered layout
+  int pos = 0;
+  int prev = 0;
+  const char *data = frame.constData();
+  const char *layout = m_layout.constData();
+  for (int i = 0; i <= m_values.count(); ++i)
+  {
+    const int end = i < m_values.count() ? m_values.at(i).offset : frame.size();
+    const int gap = end - prev;
+    if (pos + gap > m_layout.size()
+        || memcmp(layout + pos, data + prev, gap) != 0)
+      return false;
+
+    pos += gap;
+    if (i < m_values.count())
+      prev = end + m_values.at(i).length;
+  }
+
+  // Frame must contain the complete layout
+  return pos == m_layout.size();
+}
+
+/**
+ * Registers the layout of the given @a frame (which has already been parsed
+ * by the DOM), so that subsequent frames with the same layout can be matched.
+ * The layout is only registered if the frame contains @a valueCount values.
+ */
+bool JSON::JsonScanner::learn(const QByteArray &frame, const int valueCount)
+{
+  // Frame contains data that the scanner cannot handle
+  if (!scan(frame) || m_values.count() != valueCount || valueCount <= 0)
+    return false;
+
+  // Store every byte except for the dataset values
+  int prev = 0;
+  QByteArray layout;
+  layout.reserve(frame.size());
+  for (int i = 0; i < m_values.count(); ++i)
+  {
+    const auto &value = m_values.at(i);
+    layout.append(frame.constData() + prev, value.offset - prev);
+    prev = value.offset + value.length;
+  }
+
+  layout.append(frame.constData() + prev, frame.size() - prev);
+  m_layout = layout;
+  return true;
+}
+
+/**
+ * Walks the given @a frame & registers the position of each dataset value.
+ *
+ * @returns @c false if the frame is not a complete JSON object, or if a value
+ *          contains escape sequences (the DOM is used to decode them).
+ */
+bool JSON::JsonScanner::scan(const QByteArray &frame)
+{
+  // Initialize parameters
+  m_values.clear();
+  bool expectKey = false;
+  JSON::FieldSpan key = {0, 0};
+  const int size = frame.size();
+  const char *data = frame.constData();
+  QVarLengthArray<Context, 16> stack;
+
+  // Walk the frame
+  for (int i = 0; i < size; ++i)
+  {
+    const char c = data[i];
+    switch (c)
+    {
+      // Object, identify which part of the frame it represents
+      case '{': {
+        Context context = kObject;
+        if (stack.isEmpty())
+          context = kRoot;
+        else if (stack.last() == kGroups)
+          context = kGroup;
+        else if (stack.last() == kDatasets)
+          context = kDataset;
+
+        stack.append(context);
+        expectKey = true;
+        break;
+      }
+
+      // Array, identify which part of the frame it represents
+      case '[': {
+        if (stack.isEmpty())
+          return false;
+
+        Context context = kArray;
+        if (stack.last() == kRoot && KEY_IS(data, key, "groups"))
+          context = kGroups;
+        else if (stack.last() == kGroup && KEY_IS(data, key, "datasets"))
+          context = kDatasets;
+
+        stack.append(context);
+        expectKey = false;
+        break;
+      }
+
+      // End of object or array
+      case '}':
+      case ']':
+        if (stack.isEmpty())
+          return false;
+
+        stack.removeLast();
+        expectKey = false;
+        if (stack.isEmpty())
+        {
+          for (int j = i + 1; j < size; ++j)
+          {
+            if (!IS_SPACE(data[j]))
+              return false;
+          }
+
+          return true;
+        }
+
+        break;
+
+      // Next member of an object
+      case ',':
+        expectKey = !stack.isEmpty() && stack.last() != kGroups
+                    && stack.last() != kDatasets && stack.last() != kArray;
+        break;
+
+      // Whitespace & key separators
+      case ':':
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+        break;
+
+      // String, either a key or a value
+      case '"': {
+        if (stack.isEmpty())
+          return false;
+
+        bool escaped = false;
+        const int start = i + 1;
+        for (++i; i < size && data[i] != '"'; ++i)
+        {
+          if (data[i] == '\\')
+          {
+            escaped = true;
+            ++i;
+          }
+        }
+
+        if (i >= size)
+          return false;
+
+        const JSON::FieldSpan span = {start, i - start};
+        if (expectKey)
+        {
+          key = span;
+          expectKey = false;
+        }
+
+        else if (stack.last() == kDataset && KEY_IS(data, key, "value"))
+        {
+          if (escaped)
+            return false;
+
+          m_values.append(span);
+        }
+
+        break;
+      }
+
+      // Number or literal
+      default: {
+        if (stack.isEmpty())
+          return false;
+
+        const int start = i;
+        while (i + 1 < size && !IS_DELIMITER(data[i + 1]))
+          ++i;
+
+        if (stack.last() == kDataset && KEY_IS(data, key, "value"))
+          m_values.append({start, i - start + 1});
+
+        break;
+      }
+    }
+  }
+
+  // Frame is incomplete
+  return false;
+}
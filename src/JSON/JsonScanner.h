@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QByteArray>
+#include <JSON/FieldSplitter.h>
+
+namespace JSON
+{
+/**
+ * @brief The JsonScanner class
+ *
+ * Single-pass scanner used to read the JSON frames sent by devices in
+ * automatic mode without building a @c QJsonDocument.
+ *
+ * The scanner walks the raw UTF-8 bytes of a frame and obtains the position
+ * of the @c value member of every dataset (@c groups[i].datasets[j].value).
+ * The rest of the frame (title, groups & dataset metadata) is compared with
+ * the last frame that was parsed with the DOM (see @c learn()), if it is
+ * identical the dataset values can be copied directly into the typed frame
+ * model. Otherwise, the frame must be parsed with @c QJsonDocument.
+ */
+class JsonScanner
+{
+public:
+  JsonScanner();
+
+  void clear();
+  bool isEmpty() const;
+  const QVector<FieldSpan> &values() const;
+
+  bool match(const QByteArray &frame);
+  bool learn(const QByteArray &frame, const int valueCount);
+
+private:
+  bool scan(const QByteArray &frame);
+
+private:
+  QByteArray m_layout;
+  QVector<FieldSpan> m_values;
+};
+} // namespace JSON
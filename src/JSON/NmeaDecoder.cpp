@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <QtMath>
+#include <QtNumeric>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <JSON/NmeaDecoder.h>
+#include <JSON/NumberParser.h>
+
+//
+// Identifiers of the supported sentences, the order matches the
+// JSON::NmeaDecoder::Sentence enum
+//
+static const char *SENTENCE_NAMES[]
+    = {"GGA", "RMC", "VTG", "GLL", "GSA", "GSV"};
+static const int SENTENCE_COUNT
+    = static_cast<int>(JSON::NmeaDecoder::Sentence::SentenceCount);
+
+/**
+ * Maximum number of fields of a sentence (GSV sentences have 20 fields)
+ */
+static const int MAX_FIELDS = 32;
+
+/**
+ * Conversion factor from knots to kilometers per hour
+ */
+static const double KNOTS_TO_KMH = 1.852;
+
+/**
+ * Position & length of a field of a sentence
+ */
+struct NmeaField
+{
+  int offset;
+  int length;
+};
+
+/**
+ * Returns the value of the given hexadecimal digit, or -1 if @a c is not a
+ * hexadecimal digit
+ */
+static int HEX_DIGIT(const char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+
+  return -1;
+}
+
+/**
+ * Returns the numeric value of the given @a field, or NaN if the field is
+ * empty or is not a number
+ */
+static double NUMBER(const char *data, const NmeaField &field)
+{
+  double value;
+  if (field.length > 0
+      && JSON::NumberParser::parse(data + field.offset, field.length, &value))
+    return value;
+
+  return qQNaN();
+}
+
+/**
+ * Returns @c true if the given @a field only contains the character @a c
+ */
+static bool IS(const char *data, const NmeaField &field, const char c)
+{
+  return field.length == 1 && data[field.offset] == c;
+}
+
+/**
+ * Converts the given @a coordinate field (in the @c dddmm.mmmm format) and
+ * its @a hemisphere field (N, S, E or W) to signed decimal degrees.
+ */
+static double COORDINATE(const char *data, const NmeaField &coordinate,
+                         const NmeaField &hemisphere)
+{
+  const auto value = NUMBER(data, coordinate);
+  if (qIsNaN(value))
+    return value;
+
+  const auto degrees = qFloor(value / 100);
+  const auto result = degrees + (value - degrees * 100) / 60;
+  if (IS(data, hemisphere, 'S') || IS(data, hemisphere, 'W'))
+    return -result;
+
+  return result;
+}
+
+/**
+ * Converts the given @a time field (in the @c hhmmss.ss format) to seconds
+ * since midnight.
+ */
+static double TIME(const char *data, const NmeaField &time)
+{
+  const auto value = NUMBER(data, time);
+  if (qIsNaN(value))
+    return value;
+
+  const auto hours = qFloor(value / 10000);
+  const auto minutes = qFloor((value - hours * 10000) / 100);
+  return hours * 3600 + minutes * 60 + (value - hours * 10000 - minutes * 100);
+}
+
+/**
+ * Constructor function, creates a disabled decoder
+ */
+JSON::NmeaDecoder::NmeaDecoder()
+  : m_enabled(false)
+  , m_checksum(true)
+  , m_sentences(0)
+{
+}
+
+/**
+ * Returns @c true if the project does not decode NMEA sentences natively
+ */
+bool JSON::NmeaDecoder::isEmpty() const
+{
+  return !m_enabled;
+}
+
+/**
+ * Returns @c true if sentences without a checksum are rejected
+ */
+bool JSON::NmeaDecoder::checksumRequired() const
+{
+  return m_checksum;
+}
+
+/**
+ * Disables the decoder
+ */
+void JSON::NmeaDecoder::clear()
+{
+  m_enabled = false;
+  m_checksum = true;
+  m_sentences = 0;
+}
+
+/**
+ * Configures the decoder with the @c nmea value of a project file, which is
+ * either a boolean or an object with the optional @c sentences & @c checksum
+ * keys. An undefined, null or false value disables the decoder.
+ *
+ * @returns @c false if the configuration is invalid, in which case the
+ *          decoder is disabled & the reason is written to @a error.
+ */
+bool JSON::NmeaDecoder::compile(const QJsonValue &config, QString *error)
+{
+  // Decoder disabled
+  clear();
+  if (config.isUndefined() || config.isNull()
+      || (config.isBool() && !config.toBool()))
+    return true;
+
+  // Validate the type of the configuration
+  if (!config.isBool() && !config.isObject())
+  {
+    if (error)
+      *error = QStringLiteral("The NMEA configuration must be an object");
+
+    return false;
+  }
+
+  // Enable all sentences by default
+  quint32 sentences = (1u << SENTENCE_COUNT) - 1;
+  const auto object = config.toObject();
+  if (object.contains("sentences"))
+  {
+    sentences = 0;
+    const auto list = object.value("sentences").toArray();
+    for (const auto &item : list)
+    {
+      const auto name = item.toString().toUpper().toLatin1();
+      int index = -1;
+      for (int i = 0; i < SENTENCE_COUNT && index < 0; ++i)
+      {
+        if (name == SENTENCE_NAMES[i])
+          index = i;
+      }
+
+      if (index < 0)
+      {
+        if (error)
+          *error = QStringLiteral("Unknown NMEA sentence \"%1\"")
+                       .arg(item.toString());
+
+        return false;
+      }
+
+      sentences |= 1u << index;
+    }
+  }
+
+  // Register the configuration
+  m_enabled = true;
+  m_sentences = sentences;
+  m_checksum = object.value("checksum").toBool(true);
+  return true;
+}
+
+/**
+ * Decodes the given NMEA @a sentence & writes the value of each field (see
+ * the @c Field enum) to @a values, fields that are not carried by the
+ * sentence are set to NaN. The type of the sentence (e.g. @c GGA) is
+ * written to @a type, if not null.
+ *
+ * @returns @c false if the checksum does not match, or if the sentence is not
+ *          supported or not enabled by the project.
+ */
+bool JSON::NmeaDecoder::decode(const QByteArray &sentence,
+                               QVector<double> &values, QByteArray *type) const
+{
+  // Remove the start delimiter & the line ending
+  const char *data = sentence.constData();
+  int length = sentence.size();
+  if (length > 0 && (data[0] == '$' || data[0] == '!'))
+  {
+    ++data;
+    --length;
+  }
+
+  while (length > 0 && (data[length - 1] == '\r' || data[length - 1] == '\n'))
+    --length;
+
+  // Validate the checksum & remove it from the sentence
+  const auto asterisk = length >= 3 ? data + length - 3 : Q_NULLPTR;
+  if (asterisk && *asterisk == '*')
+  {
+    const int high = HEX_DIGIT(asterisk[1]);
+    const int low = HEX_DIGIT(asterisk[2]);
+    length -= 3;
+    if (high < 0 || low < 0 || checksum(data, length) != high * 16 + low)
+      return false;
+  }
+
+  else if (m_checksum)
+    return false;
+
+  // Split the sentence
+  int count = 0;
+  NmeaField fields[MAX_FIELDS];
+  int start = 0;
+  for (int i = 0; i <= length && count < MAX_FIELDS; ++i)
+  {
+    if (i == length || data[i] == ',')
+    {
+      fields[count].offset = start;
+      fields[count].length = i - start;
+      start = i + 1;
+      ++count;
+    }
+  }
+
+  // Unused fields are empty
+  for (int i = count; i < MAX_FIELDS; ++i)
+  {
+    fields[i].offset = length;
+    fields[i].length = 0;
+  }
+
+  // Get the sentence type from the address ([talker][type]), proprietary
+  // sentences (starting with P) are not supported
+  const auto &address = fields[0];
+  if (address.length < 5 || data[address.offset] == 'P')
+    return false;
+
+  int index = -1;
+  const char *name = data + address.offset + address.length - 3;
+  for (int i = 0; i < SENTENCE_COUNT && index < 0; ++i)
+  {
+    if (memcmp(name, SENTENCE_NAMES[i], 3) == 0)
+      index = i;
+  }
+
+  if (index < 0 || !(m_sentences & (1u << index)))
+    return false;
+
+  // Decode the fields of the sentence
+  values.fill(qQNaN(), FieldCount);
+  switch (static_cast<Sentence>(index))
+  {
+    case Sentence::GGA:
+      values[UtcTime] = TIME(data, fields[1]);
+      values[Latitude] = COORDINATE(data, fields[2], fields[3]);
+      values[Longitude] = COORDINATE(data, fields[4], fields[5]);
+      values[FixQuality] = NUMBER(data, fields[6]);
+      values[Satellites] = NUMBER(data, fields[7]);
+      values[Hdop] = NUMBER(data, fields[8]);
+      values[Altitude] = NUMBER(data, fields[9]);
+      values[GeoidSeparation] = NUMBER(data, fields[11]);
+      break;
+    case Sentence::RMC:
+      values[UtcTime] = TIME(data, fields[1]);
+      values[Valid] = IS(data, fields[2], 'A') ? 1 : 0;
+      values[Latitude] = COORDINATE(data, fields[3], fields[4]);
+      values[Longitude] = COORDINATE(data, fields[5], fields[6]);
+      values[SpeedKnots] = NUMBER(data, fields[7]);
+      values[SpeedKmh] = values[SpeedKnots] * KNOTS_TO_KMH;
+      values[Course] = NUMBER(data, fields[8]);
+      values[MagneticVariation] = NUMBER(data, fields[10]);
+      if (IS(data, fields[11], 'W'))
+        values[MagneticVariation] = -values[MagneticVariation];
+      break;
+    case Sentence::VTG:
+      // NMEA 2.0+ sentences carry a unit letter after each value
+      if (IS(data, fields[2], 'T'))
+      {
+        values[Course] = NUMBER(data, fields[1]);
+        values[MagneticCourse] = NUMBER(data, fields[3]);
+        values[SpeedKnots] = NUMBER(data, fields[5]);
+        values[SpeedKmh] = NUMBER(data, fields[7]);
+      }
+      else
+      {
+        values[Course] = NUMBER(data, fields[1]);
+        values[MagneticCourse] = NUMBER(data, fields[2]);
+        values[SpeedKnots] = NUMBER(data, fields[3]);
+        values[SpeedKmh] = NUMBER(data, fields[4]);
+      }
+      break;
+    case Sentence::GLL:
+      values[Latitude] = COORDINATE(data, fields[1], fields[2]);
+      values[Longitude] = COORDINATE(data, fields[3], fields[4]);
+      values[UtcTime] = TIME(data, fields[5]);
+      if (fields[6].length > 0)
+        values[Valid] = IS(data, fields[6], 'A') ? 1 : 0;
+      break;
+    case Sentence::GSA:
+      values[FixMode] = NUMBER(data, fields[2]);
+      values[Pdop] = NUMBER(data, fields[15]);
+      values[Hdop] = NUMBER(data, fields[16]);
+      values[Vdop] = NUMBER(data, fields[17]);
+      break;
+    case Sentence::GSV:
+      values[SatellitesInView] = NUMBER(data, fields[3]);
+      break;
+    default:
+      break;
+  }
+
+  // Register the sentence type
+  if (type)
+    *type = QByteArray(name, 3);
+
+  return true;
+}
+
+/**
+ * Returns the identifier of the given @a sentence type (e.g. @c GGA)
+ */
+const char *JSON::NmeaDecoder::sentenceName(const Sentence sentence)
+{
+  const int index = static_cast<int>(sentence);
+  if (index >= 0 && index < SENTENCE_COUNT)
+    return SENTENCE_NAMES[index];
+
+  return "";
+}
+
+/**
+ * Returns the NMEA checksum (XOR of every byte) of the given @a data, which
+ * must not contain the leading @c $ nor the @c * separator.
+ */
+int JSON::NmeaDecoder::checksum(const char *data, const int length)
+{
+  quint8 value = 0;
+  for (int i = 0; i < length; ++i)
+    value ^= static_cast<quint8>(data[i]);
+
+  return value;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QJsonValue>
+
+namespace JSON
+{
+/**
+ * @brief The NmeaDecoder class
+ *
+ * Native decoder for NMEA 0183 sentences, used by projects that declare the
+ * optional @c nmea key instead of decoding the sentences of GPS & marine
+ * instruments in the frame parser script:
+ *
+ * @code
+ * "nmea": {
+ *   "sentences": ["GGA", "RMC", "VTG"],  // Optional, all sentences by default
+ *   "checksum": true                     // Reject sentences without "*hh"
+ * }
+ * @endcode
+ *
+ * @c "nmea": true enables the decoder with the default settings. Sentences are
+ * expected to be framed with the @c $ start sequence & the @c \\n finish
+ * sequence, the decoder accepts sentences with or without the leading @c $
+ * and the trailing @c \\r.
+ *
+ * The XOR checksum of each sentence is validated & the sentence is routed by
+ * its type, regardless of the talker (e.g. @c GPGGA, @c GNGGA & @c GLGGA are
+ * all @c GGA sentences). Each supported sentence updates a fixed set of
+ * fields (see the @c Field enum), the n-th field feeds the datasets with
+ * frame index n + 1. Fields that are not carried by a sentence (or that are
+ * empty) are set to NaN, so that the datasets keep the last value received
+ * from another sentence. Latitudes & longitudes are converted to signed
+ * decimal degrees, and times to seconds since midnight (UTC).
+ *
+ * When the project uses field frame routing, the sentence type (e.g. @c GGA)
+ * is the frame identifier of the groups.
+ */
+class NmeaDecoder
+{
+public:
+  enum class Sentence
+  {
+    GGA,
+    RMC,
+    VTG,
+    GLL,
+    GSA,
+    GSV,
+    SentenceCount
+  };
+
+  enum Field
+  {
+    Latitude,
+    Longitude,
+    Altitude,
+    SpeedKnots,
+    SpeedKmh,
+    Course,
+    Satellites,
+    Hdop,
+    FixQuality,
+    UtcTime,
+    Valid,
+    GeoidSeparation,
+    MagneticVariation,
+    MagneticCourse,
+    Pdop,
+    Vdop,
+    FixMode,
+    SatellitesInView,
+    FieldCount
+  };
+
+  NmeaDecoder();
+
+  bool isEmpty() const;
+  bool checksumRequired() const;
+
+  void clear();
+  bool compile(const QJsonValue &config, QString *error = Q_NULLPTR);
+  bool decode(const QByteArray &sentence, QVector<double> &values,
+              QByteArray *type = Q_NULLPTR) const;
+
+  static const char *sentenceName(const Sentence sentence);
+  static int checksum(const char *data, const int length);
+
+private:
+  bool m_enabled;
+  bool m_checksum;
+  quint32 m_sentences;
+};
+} // namespace JSON
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QByteArray>
+#include <JSON/NumberParser.h>
+
+/**
+ * Powers of ten that can be represented exactly with a double
+ */
+static const double POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * Largest integer mantissa that can be represented exactly with a double
+ */
+static const quint64 MAX_EXACT_MANTISSA = Q_UINT64_C(1) << 53;
+
+/**
+ * Returns the Latin-1 code of the given character, or 0 for characters
+ * outside of the Latin-1 range.
+ */
+static inline char TO_CHAR(const char c)
+{
+  return c;
+}
+static inline char TO_CHAR(const QChar c)
+{
+  return c.unicode() < 0x80 ? static_cast<char>(c.unicode()) : 0;
+}
+
+/**
+ * Returns @c true if the given character is whitespace
+ */
+static inline bool IS_SPACE(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f'
+         || c == '\v';
+}
+
+/**
+ * Returns @c true if the given character is a decimal digit
+ */
+static inline bool IS_DIGIT(const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/**
+ * Converts the given text to a number with the C locale rules of Qt, used for
+ * the numbers that cannot be converted exactly by the fast path.
+ */
+static bool FALLBACK(const char *data, const int length, double *value)
+{
+  bool ok;
+  *value = QByteArray(data, length).toDouble(&ok);
+  return ok;
+}
+static bool FALLBACK(const QChar *data, const int length, double *value)
+{
+  bool ok;
+  *value = QString::fromRawData(data, length).toLatin1().toDouble(&ok);
+  return ok;
+}
+
+/**
+ * Converts the given characters to a number, see @c JSON::NumberParser
+ */
+template<typename Char>
+static bool PARSE(const Char *data, const int length, double *value)
+{
+  // Remove surrounding whitespace
+  int begin = 0;
+  int end = length;
+  while (begin < end && IS_SPACE(TO_CHAR(data[begin])))
+    ++begin;
+  while (end > begin && IS_SPACE(TO_CHAR(data[end - 1])))
+    --end;
+
+  // Empty text
+  if (begin == end)
+  {
+    *value = 0;
+    return false;
+  }
+
+  // Get sign
+  int i = begin;
+  bool negative = false;
+  if (TO_CHAR(data[i]) == '-' || TO_CHAR(data[i]) == '+')
+  {
+    negative = TO_CHAR(data[i]) == '-';
+    ++i;
+  }
+
+  // Hexadecimal & binary integers
+  if (end - i > 2 && TO_CHAR(data[i]) == '0')
+  {
+    const char prefix = TO_CHAR(data[i + 1]);
+    const int base = (prefix == 'x' || prefix == 'X')   ? 16
+                     : (prefix == 'b' || prefix == 'B') ? 2
+                                                        : 0;
+    if (base > 0)
+    {
+      double number = 0;
+      for (i += 2; i < end; ++i)
+      {
+        const char c = TO_CHAR(data[i]);
+        int digit = -1;
+        if (c >= '0' && c <= '9')
+          digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+          digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+          digit = c - 'A' + 10;
+
+        if (digit < 0 || digit >= base)
+        {
+          *value = 0;
+          return false;
+        }
+
+        number = number * base + digit;
+      }
+
+      *value = negative ? -number : number;
+      return true;
+    }
+  }
+
+  // Integer & fractional digits
+  int digits = 0;
+  int exponent = 0;
+  quint64 mantissa = 0;
+  bool hasDigits = false;
+  bool exact = true;
+  for (; i < end && IS_DIGIT(TO_CHAR(data[i])); ++i)
+  {
+    hasDigits = true;
+    const int digit = TO_CHAR(data[i]) - '0';
+    if (mantissa == 0 && digit == 0)
+      continue;
+
+    if (++digits > 15)
+      exact = false;
+    else
+      mantissa = mantissa * 10 + digit;
+  }
+
+  if (i < end && TO_CHAR(data[i]) == '.')
+  {
+    for (++i; i < end && IS_DIGIT(TO_CHAR(data[i])); ++i)
+    {
+      hasDigits = true;
+      const int digit = TO_CHAR(data[i]) - '0';
+      if (mantissa == 0 && digit == 0)
+      {
+        --exponent;
+        continue;
+      }
+
+      if (++digits > 15)
+        exact = false;
+      else
+      {
+        mantissa = mantissa * 10 + digit;
+        --exponent;
+      }
+    }
+  }
+
+  // Exponent
+  const char marker = i < end ? TO_CHAR(data[i]) : 0;
+  if (hasDigits && (marker == 'e' || marker == 'E'))
+  {
+    ++i;
+    bool negativeExponent = false;
+    if (i < end && (TO_CHAR(data[i]) == '-' || TO_CHAR(data[i]) == '+'))
+    {
+      negativeExponent = TO_CHAR(data[i]) == '-';
+      ++i;
+    }
+
+    int e = 0;
+    bool hasExponent = false;
+    for (; i < end && IS_DIGIT(TO_CHAR(data[i])); ++i)
+    {
+      hasExponent = true;
+      if (e < 10000)
+        e = e * 10 + (TO_CHAR(data[i]) - '0');
+    }
+
+    if (!hasExponent)
+      hasDigits = false;
+
+    exponent += negativeExponent ? -e : e;
+  }
+
+  // Text is not a plain decimal number (e.g. inf, nan or invalid data)
+  if (!hasDigits || i != end)
+    return FALLBACK(data + begin, end - begin, value);
+
+  // Exact conversion of the mantissa & the power of ten
+  if (exact && mantissa <= MAX_EXACT_MANTISSA && exponent >= -22
+      && exponent <= 22)
+  {
+    double number = static_cast<double>(mantissa);
+    if (exponent < 0)
+      number /= POWERS_OF_TEN[-exponent];
+    else
+      number *= POWERS_OF_TEN[exponent];
+
+    *value = negative ? -number : number;
+    return true;
+  }
+
+  // Too many digits or large exponent
+  return FALLBACK(data + begin, end - begin, value);
+}
+
+/**
+ * Converts the given UTF-8 @a data to a number, returns @c false (and sets
+ * @a value to 0) if the data does not represent a number.
+ */
+bool JSON::NumberParser::parse(const char *data, const int length,
+                               double *value)
+{
+  return PARSE(data, length, value);
+}
+
+/**
+ * Converts the given UTF-16 @a data to a number, returns @c false (and sets
+ * @a value to 0) if the data does not represent a number.
+ */
+bool JSON::NumberParser::parse(const QChar *data, const int length,
+                               double *value)
+{
+  return PARSE(data, length, value);
+}
+
+/**
+ * Converts the given @a text to a number, returns @c false (and sets
+ * @a value to 0) if the text does not represent a number.
+ */
+bool JSON::NumberParser::parse(const QString &text, double *value)
+{
+  return PARSE(text.constData(), text.length(), value);
+}
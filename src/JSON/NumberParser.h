@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+
+namespace JSON
+{
+/**
+ * @brief The NumberParser class
+ *
+ * Locale-independent conversion of field values to numbers, which works
+ * directly on the raw UTF-8 bytes of a field (or on the UTF-16 data of a
+ * string) without creating temporary strings.
+ *
+ * The following formats are accepted, surrounded by optional whitespace:
+ * - Decimal integers & floating point numbers, with an optional sign and
+ *   exponent (e.g. @c -12, @c 3.1416, @c .5, @c 1e-3)
+ * - Hexadecimal integers with the @c 0x prefix (e.g. @c 0x1F)
+ * - Binary integers with the @c 0b prefix (e.g. @c 0b1011)
+ *
+ * Decimal numbers with up to 15 significant digits & a small exponent are
+ * converted with exact floating point operations. Other numbers (and special
+ * values such as @c inf or @c nan) are converted with the C locale rules of
+ * Qt, so decimal numbers always give the same result as
+ * @c QByteArray::toDouble().
+ */
+class NumberParser
+{
+public:
+  static bool parse(const char *data, const int length, double *value);
+  static bool parse(const QChar *data, const int length, double *value);
+  static bool parse(const QString &text, double *value);
+};
+} // namespace JSON
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <JSON/ParserPool.h>
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, parsed frames are delivered to the given @a pool
+ */
+JSON::ParserWorker::ParserWorker(ParserPool *pool)
+  : m_pool(pool)
+{
+}
+
+/**
+ * Loads the given frame parser @a code, the frame parser (and its JavaScript
+ * engine) is created the first time that this function is called, so that it
+ * belongs to the worker thread.
+ */
+void JSON::ParserWorker::load(const QString &code)
+{
+  if (!m_parser)
+    m_parser.reset(new Project::FrameParser());
+
+  m_parser->load(code);
+}
+
+/**
+ * Parses the given @a frames and hands the results to the pool. An empty field
+ * list is returned for each frame if no frame parser has been loaded, so that
+ * the reorder buffer of the pool never stalls.
+ */
+void JSON::ParserWorker::parse(const quint64 sequence,
+                               const QStringList &frames,
+                               const QString &separator)
+{
+  QVector<QStringList> fields;
+  if (m_parser)
+    fields = m_parser->parseBatch(frames, separator);
+  else
+    fields.resize(frames.count());
+
+  auto pool = m_pool;
+  QMetaObject::invokeMethod(pool,
+                            [=] { pool->onChunkParsed(sequence, fields); });
+}
+
+//----------------------------------------------------------------------------------------
+// Pool implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+JSON::ParserPool::ParserPool(QObject *parent)
+  : QObject(parent)
+  , m_nextWorker(0)
+  , m_nextSequence(0)
+  , m_deliverSequence(0)
+{
+}
+
+/**
+ * Destructor function, stops all the worker threads
+ */
+JSON::ParserPool::~ParserPool()
+{
+  stop();
+}
+
+/**
+ * Returns @c true if the worker threads are running
+ */
+bool JSON::ParserPool::isRunning() const
+{
+  return !m_workers.isEmpty();
+}
+
+/**
+ * Returns the number of worker threads
+ */
+int JSON::ParserPool::workerCount() const
+{
+  return m_workers.count();
+}
+
+/**
+ * Returns the frame parser code loaded by the workers
+ */
+QString JSON::ParserPool::code() const
+{
+  return m_code;
+}
+
+/**
+ * Stops all the worker threads & discards the frames that have not been
+ * delivered yet.
+ */
+void JSON::ParserPool::stop()
+{
+  // Stop threads, workers are deleted when their thread finishes
+  for (int i = 0; i < m_threads.count(); ++i)
+  {
+    m_threads[i]->quit();
+    m_threads[i]->wait();
+    delete m_threads[i];
+  }
+
+  // Reset state, results that are still queued are ignored
+  m_threads.clear();
+  m_workers.clear();
+  m_reorderBuffer.clear();
+  m_deliverSequence = m_nextSequence;
+}
+
+/**
+ * Creates the given number of @a workers, each one running in its own thread
+ * and loaded with the current frame parser code.
+ */
+void JSON::ParserPool::start(const int workers)
+{
+  stop();
+
+  for (int i = 0; i < qMax(1, workers); ++i)
+  {
+    auto thread = new QThread();
+    auto worker = new ParserWorker(this);
+    thread->setObjectName(QStringLiteral("JSON::ParserWorker %1").arg(i));
+    worker->moveToThread(thread);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    thread->start();
+
+    m_threads.append(thread);
+    m_workers.append(worker);
+
+    if (!m_code.isEmpty())
+    {
+      auto code = m_code;
+      QMetaObject::invokeMethod(worker, [=] { worker->load(code); });
+    }
+  }
+}
+
+/**
+ * Loads the given frame parser @a code in all the workers
+ */
+void JSON::ParserPool::setCode(const QString &code)
+{
+  m_code = code;
+  for (int i = 0; i < m_workers.count(); ++i)
+  {
+    auto worker = m_workers.at(i);
+    QMetaObject::invokeMethod(worker, [=] { worker->load(code); });
+  }
+}
+
+/**
+ * Splits the given @a frames in chunks & hands each chunk to a different
+ * worker. The frames are parsed asynchronously, the results are delivered in
+ * order through the @c framesParsed() signal.
+ */
+void JSON::ParserPool::submit(const QStringList &frames,
+                              const QString &separator)
+{
+  // Nothing to do
+  if (frames.isEmpty() || m_workers.isEmpty())
+    return;
+
+  // Obtain chunk size
+  const int workers = m_workers.count();
+  const int chunk = (frames.count() + workers - 1) / workers;
+
+  // Hand each chunk to the next worker
+  for (int i = 0; i < frames.count(); i += chunk)
+  {
+    auto worker = m_workers.at(m_nextWorker);
+    auto sequence = m_nextSequence + static_cast<quint64>(i);
+    auto data = frames.mid(i, chunk);
+    QMetaObject::invokeMethod(
+        worker, [=] { worker->parse(sequence, data, separator); });
+
+    m_nextWorker = (m_nextWorker + 1) % workers;
+  }
+
+  // Update sequence number
+  m_nextSequence += static_cast<quint64>(frames.count());
+}
+
+/**
+ * Registers the @a fields of the chunk that starts at the given @a sequence
+ * number in the reorder buffer & delivers all the chunks that are ready, in
+ * order.
+ */
+void JSON::ParserPool::onChunkParsed(const quint64 sequence,
+                                     const QVector<QStringList> &fields)
+{
+  // Result of a chunk submitted before the pool was stopped
+  if (sequence < m_deliverSequence)
+    return;
+
+  // Register chunk
+  m_reorderBuffer.insert(sequence, fields);
+
+  // Collect all consecutive chunks
+  QVector<QStringList> output;
+  while (!m_reorderBuffer.isEmpty()
+         && m_reorderBuffer.firstKey() == m_deliverSequence)
+  {
+    auto chunk = m_reorderBuffer.take(m_deliverSequence);
+    m_deliverSequence += static_cast<quint64>(chunk.count());
+    output.append(chunk);
+  }
+
+  // Deliver parsed frames
+  if (!output.isEmpty())
+    Q_EMIT framesParsed(output);
+}
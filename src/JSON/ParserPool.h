@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QMap>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QStringList>
+#include <QScopedPointer>
+
+#include <Project/FrameParser.h>
+
+namespace JSON
+{
+class ParserPool;
+
+/**
+ * @brief The ParserWorker class
+ *
+ * Worker object of the @c ParserPool, runs in its own thread and owns a
+ * @c Project::FrameParser (and thus a JavaScript engine) created in that
+ * thread.
+ */
+class ParserWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit ParserWorker(ParserPool *pool);
+
+public Q_SLOTS:
+  void load(const QString &code);
+  void parse(const quint64 sequence, const QStringList &frames,
+             const QString &separator);
+
+private:
+  ParserPool *m_pool;
+  QScopedPointer<Project::FrameParser> m_parser;
+};
+
+/**
+ * @brief The ParserPool class
+ *
+ * Runs the JavaScript frame parser of the project in several threads, each
+ * one with its own JavaScript engine loaded with the same code.
+ *
+ * Each batch of frames submitted to the pool is split in chunks that are
+ * parsed concurrently by the workers. Every frame is identified with a
+ * sequence number, and the results are stored in a reorder buffer until all
+ * the preceding frames have been parsed, so the @c framesParsed() signal
+ * always delivers the fields in the same order in which the frames were
+ * received.
+ *
+ * @note frame parsers that keep state between calls (e.g. in global
+ *       variables) cannot be parallelized, since each worker has its own state.
+ */
+class ParserPool : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void framesParsed(const QVector<QStringList> &fields);
+
+public:
+  explicit ParserPool(QObject *parent = Q_NULLPTR);
+  ~ParserPool();
+
+  bool isRunning() const;
+  int workerCount() const;
+  QString code() const;
+
+public Q_SLOTS:
+  void stop();
+  void start(const int workers);
+  void setCode(const QString &code);
+  void submit(const QStringList &frames, const QString &separator);
+
+private:
+  void onChunkParsed(const quint64 sequence,
+                     const QVector<QStringList> &fields);
+
+private:
+  QString m_code;
+  int m_nextWorker;
+  quint64 m_nextSequence;
+  quint64 m_deliverSequence;
+
+  QVector<QThread *> m_threads;
+  QVector<ParserWorker *> m_workers;
+  QMap<quint64, QVector<QStringList>> m_reorderBuffer;
+
+  friend class ParserWorker;
+};
+} // namespace JSON
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QCborValue>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+
+#include <JSON/ProjectCache.h>
+
+/**
+ * Maximum number of compiled projects kept in memory
+ */
+static constexpr int MAX_MEMORY_ENTRIES = 8;
+
+/**
+ * Maximum number of compiled projects kept in the cache directory, the least
+ * recently written files are removed first.
+ */
+static constexpr int MAX_DISK_ENTRIES = 32;
+
+/**
+ * Version of the cache file format, cache files written by other versions are
+ * ignored.
+ */
+static constexpr int CACHE_VERSION = 1;
+
+/**
+ * Returns the name of the cache file used for the project with the given
+ * @a hash.
+ */
+static QString CACHE_FILE(const QByteArray &hash)
+{
+  return QStringLiteral("v%1-%2.cbor")
+      .arg(CACHE_VERSION)
+      .arg(QString::fromLatin1(hash.toHex()));
+}
+
+/**
+ * Constructor function
+ */
+JSON::ProjectCache::ProjectCache() {}
+
+/**
+ * Returns the only instance of the class
+ */
+JSON::ProjectCache &JSON::ProjectCache::instance()
+{
+  static ProjectCache singleton;
+  return singleton;
+}
+
+/**
+ * Removes all the compiled projects kept in memory, cache files are not
+ * removed.
+ */
+void JSON::ProjectCache::clear()
+{
+  m_recent.clear();
+  m_projects.clear();
+}
+
+/**
+ * Returns the directory in which compiled projects are stored
+ */
+QString JSON::ProjectCache::cachePath() const
+{
+  const auto root
+      = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return QStringLiteral("%1/Projects").arg(root);
+}
+
+/**
+ * Returns the compiled version of the project file at the given @a path,
+ * the project is only parsed if its contents have not been compiled before.
+ *
+ * If the file cannot be read or parsed, a null pointer is returned and the
+ * reason is written to @a status & @a error (if given).
+ */
+JSON::CompiledProjectPtr JSON::ProjectCache::load(const QString &path,
+                                                  Status *status,
+                                                  QString *error)
+{
+  // Read the file
+  QFile file(path);
+  if (!file.open(QFile::ReadOnly))
+  {
+    if (status)
+      *status = Status::OpenError;
+    if (error)
+      *error = file.errorString();
+
+    return CompiledProjectPtr();
+  }
+
+  // Obtain the hash of the file contents
+  const auto data = file.readAll();
+  const auto hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+  file.close();
+
+  // Set default status
+  if (status)
+    *status = Status::Loaded;
+
+  // Project already compiled, move it to the front of the recent list
+  auto cached = m_projects.value(hash);
+  if (cached)
+  {
+    m_recent.removeOne(hash);
+    m_recent.prepend(hash);
+    return cached;
+  }
+
+  // Read the JSON document from the cache directory or parse the file
+  QJsonObject json;
+  if (!readCache(hash, json))
+  {
+    QJsonParseError parseError;
+    auto document = QJsonDocument::fromJson(data, &parseError);
+    if (parseError.error != QJsonParseError::NoError)
+    {
+      if (status)
+        *status = Status::ParseError;
+      if (error)
+        *error = parseError.errorString();
+
+      return CompiledProjectPtr();
+    }
+
+    json = document.object();
+    writeCache(hash, json);
+  }
+
+  // Compile the project
+  auto project = new CompiledProject;
+  project->hash = hash;
+  project->json = json;
+  project->frame.read(json);
+
+  // Compile the binary layout
+  QString layoutError;
+  const auto layout = json.value("binaryLayout").toArray();
+  if (!project->decoder.compile(layout, &layoutError))
+    qWarning() << "Invalid binary layout:" << layoutError;
+
+  // Configure the NMEA decoder
+  QString nmeaError;
+  if (!project->nmea.compile(json.value("nmea"), &nmeaError))
+    qWarning() << "Invalid NMEA configuration:" << nmeaError;
+
+  // Configure the WebAssembly frame parser, the module is read by the JSON
+  // generator so that rebuilt modules are picked up when reloading
+  QString wasmError;
+  if (!project->wasm.compile(json.value("wasm"), path, &wasmError))
+    qWarning() << "Invalid WebAssembly configuration:" << wasmError;
+
+  // Register the project & remove the least recently used ones
+  cached = CompiledProjectPtr(project);
+  m_projects.insert(hash, cached);
+  m_recent.prepend(hash);
+  while (m_recent.count() > MAX_MEMORY_ENTRIES)
+    m_projects.remove(m_recent.takeLast());
+
+  return cached;
+}
+
+/**
+ * Reads the JSON document of the project with the given @a hash from the
+ * cache directory, returns @c false if the project is not cached.
+ */
+bool JSON::ProjectCache::readCache(const QByteArray &hash,
+                                   QJsonObject &json) const
+{
+  // Open the cache file
+  QFile file(QStringLiteral("%1/%2").arg(cachePath(), CACHE_FILE(hash)));
+  if (!file.open(QFile::ReadOnly))
+    return false;
+
+  // Decode the CBOR document
+  QCborParserError error;
+  const auto value = QCborValue::fromCbor(file.readAll(), &error);
+  if (error.error != QCborError::NoError || !value.isMap())
+    return false;
+
+  // Convert to JSON
+  json = value.toJsonValue().toObject();
+  return true;
+}
+
+/**
+ * Stores the JSON document of the project with the given @a hash in the cache
+ * directory & removes the oldest cache files.
+ */
+void JSON::ProjectCache::writeCache(const QByteArray &hash,
+                                    const QJsonObject &json) const
+{
+  // Create the cache directory
+  QDir dir(cachePath());
+  if (!dir.exists() && !dir.mkpath("."))
+    return;
+
+  // Write the CBOR document
+  QFile file(dir.filePath(CACHE_FILE(hash)));
+  if (!file.open(QFile::WriteOnly))
+    return;
+
+  file.write(QCborValue::fromJsonValue(json).toCbor());
+  file.close();
+
+  // Remove the oldest cache files
+  const auto files = dir.entryList({"*.cbor"}, QDir::Files, QDir::Time);
+  for (int i = MAX_DISK_ENTRIES; i < files.count(); ++i)
+    dir.remove(files.at(i));
+}
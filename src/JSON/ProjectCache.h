@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+#include <JSON/Frame.h>
+#include <JSON/BinaryDecoder.h>
+#include <JSON/NmeaDecoder.h>
+#include <JSON/WasmDecoder.h>
+
+namespace JSON
+{
+/**
+ * @brief Project file compiled by the @c ProjectCache class
+ *
+ * Contains the JSON document of a project, the frame built from it (groups,
+ * datasets & the dataset value table), the compiled binary layout, the NMEA
+ * decoder configuration & the WebAssembly parser configuration, so that the JSON generator and the project model do
+ * not need to parse the same file again.
+ */
+struct CompiledProject
+{
+  QByteArray hash;
+  QJsonObject json;
+  JSON::Frame frame;
+  JSON::BinaryDecoder decoder;
+  JSON::NmeaDecoder nmea;
+  JSON::WasmDecoder wasm;
+};
+
+typedef QSharedPointer<const CompiledProject> CompiledProjectPtr;
+
+/**
+ * @brief The ProjectCache class
+ *
+ * Compiles project files once & shares the result between the modules that
+ * read them (e.g. @c Project::Model::openJsonFile() and
+ * @c JSON::Generator::loadJsonMap()).
+ *
+ * Compiled projects are keyed by the hash of the file contents. The most
+ * recently used projects are kept in memory, and the JSON document of every
+ * compiled project is stored in the application cache directory in binary
+ * CBOR format, which is decoded much faster than the JSON text when the same
+ * project is opened again (e.g. after restarting the application).
+ *
+ * @note The frame parser script is stored as plain text, the JavaScript engine
+ *       does not provide a way to serialize compiled bytecode.
+ */
+class ProjectCache
+{
+public:
+  enum class Status
+  {
+    Loaded,
+    OpenError,
+    ParseError
+  };
+
+  static ProjectCache &instance();
+
+  void clear();
+  QString cachePath() const;
+  CompiledProjectPtr load(const QString &path, Status *status = Q_NULLPTR,
+                          QString *error = Q_NULLPTR);
+
+private:
+  ProjectCache();
+  ProjectCache(ProjectCache &&) = delete;
+  ProjectCache(const ProjectCache &) = delete;
+  ProjectCache &operator=(ProjectCache &&) = delete;
+  ProjectCache &operator=(const ProjectCache &) = delete;
+
+  bool readCache(const QByteArray &hash, QJsonObject &json) const;
+  void writeCache(const QByteArray &hash, const QJsonObject &json) const;
+
+private:
+  QList<QByteArray> m_recent;
+  QHash<QByteArray, CompiledProjectPtr> m_projects;
+};
+} // namespace JSON
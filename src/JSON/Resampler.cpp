@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <JSON/Resampler.h>
+
+/**
+ * Maximum number of frames generated to cover a gap in the received data,
+ * larger gaps (e.g. when a device stops sending data for a while) are skipped
+ * instead of flooding the rest of the application with repeated frames.
+ */
+static const qint64 MAX_TICKS_PER_FRAME = 1000;
+
+/**
+ * Constructor function, resampling is disabled by default and the time base
+ * interval is 10 milliseconds.
+ */
+JSON::Resampler::Resampler()
+  : m_mode(Mode::Disabled)
+  , m_interval(10000)
+  , m_nextTick(0)
+  , m_schemaHash(0)
+{
+}
+
+/**
+ * Returns the method used to obtain the values of the resampled frames
+ */
+JSON::Resampler::Mode JSON::Resampler::mode() const
+{
+  return m_mode;
+}
+
+/**
+ * Returns the interval (in microseconds) between consecutive resampled frames
+ */
+qint64 JSON::Resampler::interval() const
+{
+  return m_interval;
+}
+
+/**
+ * Discards the registered samples, the time base is restarted with the next
+ * frame.
+ */
+void JSON::Resampler::reset()
+{
+  m_nextTick = 0;
+  m_schemaHash = 0;
+  m_samples.clear();
+}
+
+/**
+ * Changes the method used to obtain the values of the resampled frames
+ */
+void JSON::Resampler::setMode(const Mode mode)
+{
+  m_mode = mode;
+  reset();
+}
+
+/**
+ * Changes the @a interval (in microseconds) between consecutive resampled
+ * frames.
+ */
+void JSON::Resampler::setInterval(const qint64 interval)
+{
+  m_interval = qMax<qint64>(1, interval);
+  reset();
+}
+
+/**
+ * Registers the identifier of the device that feeds each dataset, indexed by
+ * the position of the dataset in the value table of the frame. Datasets with
+ * a negative identifier (or without an entry) are fed by all devices.
+ */
+void JSON::Resampler::setOwners(const QVector<int> &owners)
+{
+  m_owners = owners;
+}
+
+/**
+ * Registers the samples contained in the given @a frame (produced by the
+ * given @a device) and appends the resampled frames for all the points of the
+ * time base up to the reception time of the frame to @a output.
+ */
+void JSON::Resampler::process(const Frame &frame, const int device,
+                              QVector<Frame> &output)
+{
+  // Initialize parameters
+  const auto time = frame.timestamp();
+  const auto &values = frame.values();
+
+  // Structure of the frames changed, restart the time base
+  if (frame.schemaHash() != m_schemaHash || m_samples.count() != values.count())
+  {
+    m_schemaHash = frame.schemaHash();
+    m_samples.fill(Sample{0, 0, 0, 0, false}, values.count());
+    m_nextTick = (time / m_interval + 1) * m_interval;
+  }
+
+  // Register the samples of the datasets fed by the device
+  for (int i = 0; i < values.count(); ++i)
+  {
+    const auto owner = i < m_owners.count() ? m_owners.at(i) : -1;
+    if (owner >= 0 && owner != device)
+      continue;
+
+    auto &sample = m_samples[i];
+    if (!sample.valid)
+    {
+      sample = Sample{time, time, values.at(i), values.at(i), true};
+      continue;
+    }
+
+    if (time > sample.t1)
+    {
+      sample.t0 = sample.t1;
+      sample.v0 = sample.v1;
+      sample.t1 = time;
+    }
+
+    sample.v1 = values.at(i);
+  }
+
+  // Skip large gaps in the received data
+  if ((time - m_nextTick) / m_interval > MAX_TICKS_PER_FRAME)
+    m_nextTick = (time / m_interval) * m_interval;
+
+  // Generate a frame for each point of the time base
+  while (m_nextTick <= time)
+  {
+    Frame resampled = frame;
+    resampled.setTimestamp(m_nextTick);
+    for (int g = 0; g < frame.groupCount(); ++g)
+    {
+      const auto &group = frame.getGroup(g);
+      for (int d = 0; d < group.datasetCount(); ++d)
+      {
+        if (!group.getDataset(d).isNumeric())
+          continue;
+
+        const auto index = frame.valueIndex(g, d);
+        const auto value = valueAt(index, m_nextTick);
+        if (value != values.at(index))
+          resampled.setDatasetValue(g, d, QString::number(value, 'g', 12));
+      }
+    }
+
+    output.append(resampled);
+    m_nextTick += m_interval;
+  }
+}
+
+/**
+ * Returns the value of the dataset at the given @a index of the value table
+ * at the given point of the time base.
+ */
+double JSON::Resampler::valueAt(const int index, const qint64 time) const
+{
+  const auto &sample = m_samples.at(index);
+  if (time >= sample.t1)
+    return sample.v1;
+
+  if (m_mode == Mode::Linear && sample.t1 > sample.t0)
+  {
+    const double k = double(time - sample.t0) / double(sample.t1 - sample.t0);
+    return sample.v0 + (sample.v1 - sample.v0) * k;
+  }
+
+  return sample.v0;
+}
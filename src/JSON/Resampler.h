@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <JSON/Frame.h>
+
+namespace JSON
+{
+/**
+ * @brief The Resampler class
+ *
+ * Converts the frames generated by the JSON generator, which arrive at the
+ * rate (and with the jitter) of each device, into frames placed on a common
+ * time base with a fixed interval between them. This keeps the datasets of
+ * different devices aligned in the plots & in the exported data.
+ *
+ * The resampler keeps the two most recent samples of every dataset. A sample
+ * is only registered when the dataset is fed by the device that produced the
+ * frame (see @c setOwners()), so the values that a frame holds for the
+ * datasets of other devices are not mistaken for new samples.
+ *
+ * The value of a numeric dataset at each point of the time base is obtained
+ * with one of the following methods:
+ * - @c Mode::Hold   the most recent sample received before that point
+ * - @c Mode::Linear linear interpolation between the samples received before
+ *                   and after that point; if the device has not delivered a
+ *                   newer sample yet, the most recent sample is held
+ *
+ * Non-numeric datasets always take the most recent value.
+ */
+class Resampler
+{
+public:
+  enum class Mode
+  {
+    Disabled,
+    Hold,
+    Linear
+  };
+
+  Resampler();
+
+  Mode mode() const;
+  qint64 interval() const;
+
+  void reset();
+  void setMode(const Mode mode);
+  void setInterval(const qint64 interval);
+  void setOwners(const QVector<int> &owners);
+  void process(const Frame &frame, const int device, QVector<Frame> &output);
+
+private:
+  double valueAt(const int index, const qint64 time) const;
+
+private:
+  struct Sample
+  {
+    qint64 t0;
+    qint64 t1;
+    double v0;
+    double v1;
+    bool valid;
+  };
+
+  Mode m_mode;
+  qint64 m_interval;
+  qint64 m_nextTick;
+  quint64 m_schemaHash;
+
+  QVector<int> m_owners;
+  QVector<Sample> m_samples;
+};
+} // namespace JSON
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <QtNumeric>
+
+#include <JSON/Frame.h>
+#include <JSON/SequenceTracker.h>
+#include <IO/FrameQueue.h>
+#include <Misc/Diagnostics.h>
+
+/**
+ * Maximum distance behind the expected value at which a received value is
+ * considered a reordered frame instead of a restart of the counter
+ */
+static const quint64 MAX_REORDER = 64;
+
+/**
+ * Sequence counter read from the project file, before it is stored in the
+ * counter table
+ */
+struct SequenceCounter
+{
+  int field;
+  int value;
+  int group;
+  int dataset;
+  quint64 mask;
+};
+
+/**
+ * Returns the name of the kind of the sequence event, as used in markers
+ */
+QString JSON::SequenceEvent::kindName() const
+{
+  switch (kind)
+  {
+    case Gap:
+      return QStringLiteral("gap");
+    case Duplicate:
+      return QStringLiteral("duplicate");
+    case Reorder:
+      return QStringLiteral("reorder");
+  }
+
+  return QString();
+}
+
+/**
+ * Constructor function
+ */
+JSON::SequenceTracker::SequenceTracker() {}
+
+/**
+ * Returns @c true if no dataset of the project is a sequence counter
+ */
+bool JSON::SequenceTracker::isEmpty() const
+{
+  return m_fields.isEmpty();
+}
+
+/**
+ * Removes all the compiled sequence counters
+ */
+void JSON::SequenceTracker::clear()
+{
+  m_fields.clear();
+  m_values.clear();
+  m_groups.clear();
+  m_datasets.clear();
+  m_masks.clear();
+
+  m_started.clear();
+  m_expected.clear();
+}
+
+/**
+ * Forgets the last value of each sequence counter, the next received values
+ * are used to synchronize the tracker with the device.
+ */
+void JSON::SequenceTracker::reset()
+{
+  m_started.fill(false, m_fields.count());
+  m_expected.fill(0, m_fields.count());
+}
+
+/**
+ * Registers the datasets of the given @a frame that are sequence counters
+ */
+void JSON::SequenceTracker::compile(const Frame &frame)
+{
+  // Remove previous counters
+  clear();
+
+  // Read the counter width of each dataset
+  QVector<SequenceCounter> counters;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      const int bits = dataset.sequenceBits();
+      if (bits <= 0)
+        continue;
+
+      // Computed datasets use field -1
+      SequenceCounter counter;
+      counter.field = qMax(0, dataset.index()) - 1;
+      counter.value = frame.valueIndex(i, j);
+      counter.group = i;
+      counter.dataset = j;
+      counter.mask = bits >= 64 ? ~quint64(0) : (quint64(1) << bits) - 1;
+      counters.append(counter);
+    }
+  }
+
+  // Sort counters by field
+  std::stable_sort(counters.begin(), counters.end(),
+                   [](const SequenceCounter &a, const SequenceCounter &b) {
+                     return a.field < b.field;
+                   });
+
+  // Build the counter table
+  for (int i = 0; i < counters.count(); ++i)
+  {
+    const auto &counter = counters.at(i);
+    m_fields.append(counter.field);
+    m_values.append(counter.value);
+    m_groups.append(counter.group);
+    m_datasets.append(counter.dataset);
+    m_masks.append(counter.mask);
+  }
+
+  // Initialize the state of each counter
+  reset();
+}
+
+/**
+ * Checks the sequence counters of the given @a frame that are fed by the
+ * fields within [@a beginField, @a endField) and the computed counters. The
+ * detected anomalies are appended to @a events & reported to the diagnostics
+ * module.
+ */
+void JSON::SequenceTracker::evaluate(const Frame &frame, const int beginField,
+                                     const int endField,
+                                     QVector<SequenceEvent> &events)
+{
+  // Nothing to do
+  if (m_fields.isEmpty())
+    return;
+
+  // Get reception time of the frame
+  auto timestamp = frame.timestamp();
+  if (timestamp <= 0)
+    timestamp = IO::FrameQueue::timestamp();
+
+  // Check the counters of the computed datasets
+  const auto begin = m_fields.constBegin();
+  const auto end = m_fields.constEnd();
+  const int computed = std::lower_bound(begin, end, 0) - begin;
+  if (beginField >= 0)
+    evaluate(frame, 0, computed, timestamp, events);
+
+  // Check the counters of the given fields
+  const int first = std::lower_bound(begin, end, beginField) - begin;
+  const int last = std::lower_bound(begin, end, endField) - begin;
+  evaluate(frame, first, last, timestamp, events);
+}
+
+/**
+ * Checks the counters within [@a first, @a last) of the counter table with
+ * the values of the given @a frame, received at the given @a timestamp.
+ */
+void JSON::SequenceTracker::evaluate(const Frame &frame, const int first,
+                                     const int last, const qint64 timestamp,
+                                     QVector<SequenceEvent> &events)
+{
+  auto &diagnostics = Misc::Diagnostics::instance();
+  const auto values = frame.values().constData();
+  for (int i = first; i < last; ++i)
+  {
+    // Skip values that cannot be counters
+    const double value = values[m_values[i]];
+    if (!qIsFinite(value) || value < 0 || value >= 18446744073709551616.0)
+      continue;
+
+    // Synchronize with the first received value
+    const auto mask = m_masks[i];
+    const auto received = static_cast<quint64>(value) & mask;
+    const auto expected = m_expected[i];
+    if (!m_started[i])
+    {
+      m_started[i] = true;
+      m_expected[i] = (received + 1) & mask;
+      continue;
+    }
+
+    // Frame received in order
+    if (received == expected)
+    {
+      m_expected[i] = (received + 1) & mask;
+      continue;
+    }
+
+    // Classify the anomaly
+    SequenceEvent event;
+    const auto ahead = (received - expected) & mask;
+    const auto behind = (expected - received) & mask;
+    if (ahead <= mask / 2)
+    {
+      event.kind = SequenceEvent::Gap;
+      event.count = ahead;
+      m_expected[i] = (received + 1) & mask;
+      diagnostics.increment(Misc::Diagnostics::Counter::FramesLost, ahead);
+    }
+    else if (behind == 1)
+    {
+      event.kind = SequenceEvent::Duplicate;
+      event.count = 1;
+      diagnostics.increment(Misc::Diagnostics::Counter::FramesDuplicated);
+    }
+    else if (behind <= MAX_REORDER)
+    {
+      event.kind = SequenceEvent::Reorder;
+      event.count = 1;
+      diagnostics.increment(Misc::Diagnostics::Counter::FramesReordered);
+    }
+
+    // Counter restarted, synchronize with it
+    else
+    {
+      m_expected[i] = (received + 1) & mask;
+      continue;
+    }
+
+    // Register the event
+    event.timestamp = timestamp;
+    event.group = m_groups[i];
+    event.dataset = m_datasets[i];
+    event.expected = expected;
+    event.received = received;
+    event.title = frame.getGroup(event.group).getDataset(event.dataset).title();
+    events.append(event);
+  }
+}
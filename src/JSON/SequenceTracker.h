@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+namespace JSON
+{
+class Frame;
+
+/**
+ * @brief The SequenceEvent struct
+ *
+ * Anomaly detected in the sequence counter of a dataset. The @a timestamp is
+ * the reception time of the frame that carried the counter (see
+ * @c IO::FrameQueue::timestamp()), @a expected & @a received are the expected
+ * & received values of the counter and @a count is the number of frames lost
+ * (for gaps), or 1 for duplicated & reordered frames.
+ */
+struct SequenceEvent
+{
+  enum Kind
+  {
+    Gap,
+    Duplicate,
+    Reorder
+  };
+
+  qint64 timestamp;
+  int group;
+  int dataset;
+  Kind kind;
+  quint64 expected;
+  quint64 received;
+  quint64 count;
+  QString title;
+
+  QString kindName() const;
+};
+
+/**
+ * @brief The SequenceTracker class
+ *
+ * Verifies the frame counters sent by a device, so that frames lost between
+ * the device & the application can be detected. Datasets are marked as
+ * sequence counters with the optional @c sequenceBits key of the project
+ * file, which is the width (in bits) of the counter, so that the tracker
+ * knows where the counter wraps around.
+ *
+ * Each received value is compared with the expected one (the previous value
+ * plus one, modulo the width of the counter):
+ *
+ * - Values ahead of the expected one (by less than half of the range of the
+ *   counter) are gaps, the skipped values are counted as lost frames.
+ * - The previous value received again is a duplicated frame.
+ * - Other values slightly behind the expected one are reordered frames (which
+ *   were counted as lost when the gap was detected).
+ * - Values far behind the expected one are treated as a restart of the
+ *   counter (e.g. the device was reset), the tracker synchronizes with them.
+ *
+ * The counters are reported to the diagnostics module & the anomalies are
+ * registered as @c SequenceEvent items, so that they can be recorded as
+ * markers. The state of the counters is reset when a device connects.
+ */
+class SequenceTracker
+{
+public:
+  SequenceTracker();
+
+  bool isEmpty() const;
+  void clear();
+  void reset();
+
+  void compile(const Frame &frame);
+  void evaluate(const Frame &frame, const int beginField, const int endField,
+                QVector<SequenceEvent> &events);
+
+private:
+  void evaluate(const Frame &frame, const int first, const int last,
+                const qint64 timestamp, QVector<SequenceEvent> &events);
+
+private:
+  QVector<int> m_fields;
+  QVector<int> m_values;
+  QVector<int> m_groups;
+  QVector<int> m_datasets;
+  QVector<quint64> m_masks;
+
+  QVector<bool> m_started;
+  QVector<quint64> m_expected;
+};
+} // namespace JSON
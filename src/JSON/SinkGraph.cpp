@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QObject>
+#include <QRunnable>
+#include <JSON/SinkGraph.h>
+
+/**
+ * Maximum number of frames waiting to be consumed by a worker pool sink
+ */
+static const int MAX_PENDING_FRAMES = 65536;
+
+namespace JSON
+{
+/**
+ * Task of the graph thread pool that delivers the pending frames of a sink
+ */
+class SinkTask : public QRunnable
+{
+public:
+  explicit SinkTask(const QSharedPointer<SinkGraph::Node> &node)
+    : m_node(node)
+  {
+  }
+
+  void run() override { SinkGraph::drain(m_node); }
+
+private:
+  QSharedPointer<SinkGraph::Node> m_node;
+};
+} // namespace JSON
+
+/**
+ * Constructor function, the thread pool uses one thread by default
+ */
+JSON::SinkGraph::SinkGraph()
+{
+  m_pool.setMaxThreadCount(1);
+}
+
+/**
+ * Waits until the worker pool sinks consume their pending frames
+ */
+JSON::SinkGraph::~SinkGraph()
+{
+  m_pool.waitForDone();
+}
+
+/**
+ * Returns the number of registered sinks
+ */
+int JSON::SinkGraph::sinkCount() const
+{
+  return m_nodes.count();
+}
+
+/**
+ * Returns the maximum number of threads used to run the worker pool sinks
+ */
+int JSON::SinkGraph::maxThreadCount() const
+{
+  return m_pool.maxThreadCount();
+}
+
+/**
+ * Returns the name, the number of pending frames & the number of dropped
+ * frames of each worker pool sink, in the format used by the diagnostics
+ * module.
+ */
+QVariantList JSON::SinkGraph::queues() const
+{
+  QVariantList list;
+  for (const auto &node : m_nodes)
+  {
+    if (node->affinity != Affinity::WorkerPool)
+      continue;
+
+    QMutexLocker locker(&node->mutex);
+    QVariantMap map;
+    map.insert("name", node->sink->sinkName());
+    map.insert("depth", node->pending.count());
+    map.insert("unit", QObject::tr("frames"));
+    map.insert("dropped", node->dropped);
+    list.append(map);
+  }
+
+  return list;
+}
+
+/**
+ * Changes the maximum number of @a threads used to run the worker pool sinks,
+ * each sink is only run by one thread at a time.
+ */
+void JSON::SinkGraph::setMaxThreadCount(const int threads)
+{
+  m_pool.setMaxThreadCount(qMax(1, threads));
+}
+
+/**
+ * Registers the given @a sink, which receives the frames published to the
+ * given @a port in the thread selected by @a affinity. Registering a sink
+ * that already exists changes its port & affinity.
+ */
+void JSON::SinkGraph::addSink(FrameSink *sink, const Port port,
+                              const Affinity affinity)
+{
+  // Invalid sink
+  if (!sink)
+    return;
+
+  // Create the node of the sink
+  removeSink(sink);
+  NodePtr node(new Node);
+  node->sink = sink;
+  node->port = port;
+  node->affinity = affinity;
+  node->dropped = 0;
+  node->scheduled = false;
+  node->removed = false;
+  m_nodes.append(node);
+}
+
+/**
+ * Unregisters the given @a sink, pending frames are discarded & this function
+ * waits until the sink is no longer running in the thread pool.
+ */
+void JSON::SinkGraph::removeSink(FrameSink *sink)
+{
+  for (int i = 0; i < m_nodes.count(); ++i)
+  {
+    auto node = m_nodes.at(i);
+    if (node->sink != sink)
+      continue;
+
+    // Stop delivering frames to the sink
+    m_nodes.remove(i);
+    {
+      QMutexLocker locker(&node->mutex);
+      node->removed = true;
+      node->pending.clear();
+      node->drained.wakeAll();
+    }
+
+    // Wait for the task that may be running the sink
+    if (node->affinity == Affinity::WorkerPool)
+      m_pool.waitForDone();
+
+    return;
+  }
+}
+
+/**
+ * Delivers the given @a frames to every sink connected to the given @a port
+ */
+void JSON::SinkGraph::publish(const Port port,
+                              const QVector<JSON::Frame> &frames)
+{
+  // Nothing to publish
+  if (frames.isEmpty())
+    return;
+
+  // Deliver the frames to each sink of the port, a copy of the node list is
+  // used in case that a sink registers or removes sinks while it runs
+  const auto nodes = m_nodes;
+  for (const auto &node : nodes)
+  {
+    if (node->port != port)
+      continue;
+
+    if (node->affinity == Affinity::MainThread)
+      node->sink->consumeFrames(frames);
+    else
+      enqueue(node, frames);
+  }
+}
+
+/**
+ * Delivers the pending frames of the given @a node until its queue is empty,
+ * this function runs in the thread pool.
+ */
+void JSON::SinkGraph::drain(const NodePtr &node)
+{
+  while (true)
+  {
+    // Take the pending frames
+    QVector<JSON::Frame> frames;
+    {
+      QMutexLocker locker(&node->mutex);
+      if (node->removed || node->pending.isEmpty())
+      {
+        node->scheduled = false;
+        node->drained.wakeAll();
+        return;
+      }
+
+      frames.swap(node->pending);
+      node->drained.wakeAll();
+    }
+
+    // Consume the frames
+    node->sink->consumeFrames(frames);
+  }
+}
+
+/**
+ * Appends the given @a frames to the queue of a worker pool sink & schedules
+ * a task to consume them if none is running.
+ *
+ * If the queue is full, the oldest pending frames of the live consumers are
+ * dropped, while the frames of the recording port wait until the sink
+ * catches up.
+ */
+void JSON::SinkGraph::enqueue(const NodePtr &node,
+                              const QVector<JSON::Frame> &frames)
+{
+  QMutexLocker locker(&node->mutex);
+
+  // Wait until a recording sink consumes its pending frames
+  if (node->port == Port::Frames)
+  {
+    while (!node->removed && !node->pending.isEmpty()
+           && node->pending.count() + frames.count() > MAX_PENDING_FRAMES)
+      node->drained.wait(&node->mutex);
+  }
+
+  // Append the frames, dropping the oldest ones if the queue is full
+  node->pending.append(frames);
+  const int excess = node->pending.count() - MAX_PENDING_FRAMES;
+  if (excess > 0 && node->port == Port::DecimatedFrames)
+  {
+    node->pending.remove(0, excess);
+    node->dropped += excess;
+  }
+
+  // Schedule a task to consume the frames
+  if (!node->scheduled)
+  {
+    node->scheduled = true;
+    m_pool.start(new SinkTask(node));
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QThreadPool>
+#include <QVariantList>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+#include <JSON/Frame.h>
+
+namespace JSON
+{
+/**
+ * @brief The FrameSink class
+ *
+ * Interface of the modules that consume the frames generated by the JSON
+ * generator (dashboard, CSV export, MQTT client, plugins server, etc). A sink
+ * is registered in the @c SinkGraph of the generator & receives the frames
+ * of the port that it is connected to in batches.
+ */
+class FrameSink
+{
+public:
+  virtual ~FrameSink() = default;
+  virtual QString sinkName() const = 0;
+  virtual void consumeFrames(const QVector<JSON::Frame> &frames) = 0;
+};
+
+/**
+ * @brief The SinkGraph class
+ *
+ * Connects the output ports of the JSON generator to the registered
+ * @c FrameSink nodes, so that new consumers do not need to implement their
+ * own buffering or threading.
+ *
+ * The generator publishes each batch of frames to one of the following
+ * ports:
+ * - @c Port::Frames: every generated frame, used by the modules that record
+ *   data. Frames published to this port are never dropped.
+ * - @c Port::DecimatedFrames: the (optionally decimated) frames delivered to
+ *   the live consumers. If a sink falls behind, its oldest pending frames are
+ *   dropped & counted.
+ *
+ * Each sink has a thread affinity. Sinks with @c Affinity::MainThread are
+ * called directly while the batch is published, while sinks with
+ * @c Affinity::WorkerPool have a bounded queue of pending frames that is
+ * drained by a task of the graph thread pool. A sink never runs in two
+ * threads at the same time & always receives the frames in order.
+ *
+ * @note Sinks must be registered, removed & fed from the main thread.
+ */
+class SinkGraph
+{
+public:
+  enum class Port
+  {
+    Frames,
+    DecimatedFrames
+  };
+
+  enum class Affinity
+  {
+    MainThread,
+    WorkerPool
+  };
+
+  SinkGraph();
+  ~SinkGraph();
+
+  int sinkCount() const;
+  int maxThreadCount() const;
+  QVariantList queues() const;
+
+  void setMaxThreadCount(const int threads);
+  void addSink(FrameSink *sink, const Port port,
+               const Affinity affinity = Affinity::MainThread);
+  void removeSink(FrameSink *sink);
+  void publish(const Port port, const QVector<JSON::Frame> &frames);
+
+private:
+  struct Node
+  {
+    FrameSink *sink;
+    Port port;
+    Affinity affinity;
+
+    QMutex mutex;
+    QWaitCondition drained;
+    QVector<JSON::Frame> pending;
+    quint64 dropped;
+    bool scheduled;
+    bool removed;
+  };
+
+  typedef QSharedPointer<Node> NodePtr;
+  static void drain(const NodePtr &node);
+  void enqueue(const NodePtr &node, const QVector<JSON::Frame> &frames);
+
+private:
+  QThreadPool m_pool;
+  QVector<NodePtr> m_nodes;
+
+  friend class SinkTask;
+};
+} // namespace JSON
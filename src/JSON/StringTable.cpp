@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QSet>
+#include <QMutex>
+#include <QMutexLocker>
+#include <JSON/StringTable.h>
+
+/**
+ * Maximum number of strings held by the table before it is flushed
+ */
+static const int MAX_STRINGS = 16384;
+
+/**
+ * Storage & lock of the string table
+ */
+static QMutex TABLE_MUTEX;
+static QSet<QString> TABLE;
+
+/**
+ * Returns the interned instance of the given @a string, registering it in the
+ * table if required.
+ */
+QString JSON::StringTable::intern(const QString &string)
+{
+  // Empty strings do not allocate memory
+  if (string.isEmpty())
+    return string;
+
+  // Return the existing copy of the string
+  QMutexLocker locker(&TABLE_MUTEX);
+  const auto it = TABLE.constFind(string);
+  if (it != TABLE.constEnd())
+    return *it;
+
+  // Flush the table if it is too large
+  if (TABLE.count() >= MAX_STRINGS)
+    TABLE.clear();
+
+  // Register the string
+  TABLE.insert(string);
+  return string;
+}
+
+/**
+ * Returns the number of strings held by the table
+ */
+int JSON::StringTable::count()
+{
+  QMutexLocker locker(&TABLE_MUTEX);
+  return TABLE.count();
+}
+
+/**
+ * Removes every string from the table, strings that are still referenced by
+ * frames remain valid.
+ */
+void JSON::StringTable::clear()
+{
+  QMutexLocker locker(&TABLE_MUTEX);
+  TABLE.clear();
+}
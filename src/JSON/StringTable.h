@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+
+namespace JSON
+{
+/**
+ * @brief The StringTable class
+ *
+ * Project-wide table of the metadata strings of groups & datasets (titles,
+ * units, widget names...).
+ *
+ * Every time a frame schema is read, equal strings are replaced by the same
+ * interned @c QString instance, so that all the frames, groups & datasets
+ * that share the same metadata point to a single copy of each string instead
+ * of holding their own duplicates. Since @c QString is implicitly shared,
+ * copying datasets between vectors only increments reference counters.
+ *
+ * The table is thread-safe & is flushed when it grows too large (e.g. when a
+ * device in automatic mode keeps changing its titles).
+ */
+class StringTable
+{
+public:
+  static QString intern(const QString &string);
+  static int count();
+  static void clear();
+};
+} // namespace JSON
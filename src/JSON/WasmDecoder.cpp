@@ -0,0 +1,551 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <cstring>
+
+#include <QDir>
+#include <QDebug>
+#include <QFile>
+#include <QtEndian>
+#include <QtNumeric>
+#include <QFileInfo>
+#include <QJsonObject>
+
+#include <JSON/WasmDecoder.h>
+
+#ifdef ENABLE_WASM_PARSER
+#  include <wasmtime.h>
+
+//
+// Compiled module, the engine & the module are immutable and can be shared
+// by all the copies of a decoder (and by several threads).
+//
+class JSON::WasmRuntime
+{
+public:
+  WasmRuntime()
+    : engine(Q_NULLPTR)
+    , module(Q_NULLPTR)
+  {
+  }
+
+  ~WasmRuntime()
+  {
+    if (module)
+      wasmtime_module_delete(module);
+    if (engine)
+      wasm_engine_delete(engine);
+  }
+
+  wasm_engine_t *engine;
+  wasmtime_module_t *module;
+};
+
+//
+// Instance of a module, owns the store (and thus the linear memory) of the
+// module. Each decoder creates its own instance, which must only be used by
+// one thread at a time.
+//
+class JSON::WasmInstance
+{
+public:
+  WasmInstance()
+    : store(Q_NULLPTR)
+    , input(0)
+    , inputCapacity(0)
+    , values(0)
+  {
+  }
+
+  ~WasmInstance()
+  {
+    if (store)
+      wasmtime_store_delete(store);
+  }
+
+  wasmtime_store_t *store;
+  wasmtime_instance_t instance;
+  wasmtime_memory_t memory;
+  wasmtime_func_t alloc;
+  wasmtime_func_t parse;
+  quint32 input;
+  quint32 inputCapacity;
+  quint32 values;
+};
+
+/**
+ * Returns the message of the given wasmtime @a error or @a trap & deletes it
+ */
+static QString ERROR_MESSAGE(wasmtime_error_t *error, wasm_trap_t *trap)
+{
+  wasm_byte_vec_t message;
+  if (error)
+  {
+    wasmtime_error_message(error, &message);
+    wasmtime_error_delete(error);
+  }
+
+  else if (trap)
+  {
+    wasm_trap_message(trap, &message);
+    wasm_trap_delete(trap);
+  }
+
+  else
+    return QString();
+
+  const auto text
+      = QString::fromUtf8(message.data, static_cast<int>(message.size));
+  wasm_byte_vec_delete(&message);
+  return text;
+}
+
+/**
+ * Calls the given i32 @a function of the module with the given @a args,
+ * the result is written to @a result.
+ *
+ * @returns @c false if the function trapped or ran out of fuel.
+ */
+static bool CALL(JSON::WasmInstance &wasm, const wasmtime_func_t &function,
+                 const qint32 *args, const int count, const quint64 fuel,
+                 qint32 &result, QString *error = Q_NULLPTR)
+{
+  auto *context = wasmtime_store_context(wasm.store);
+  auto *fuelError = wasmtime_context_set_fuel(context, fuel);
+  if (fuelError)
+  {
+    const auto message = ERROR_MESSAGE(fuelError, Q_NULLPTR);
+    if (error)
+      *error = message;
+
+    return false;
+  }
+
+  wasmtime_val_t params[4];
+  for (int i = 0; i < count; ++i)
+  {
+    params[i].kind = WASMTIME_I32;
+    params[i].of.i32 = args[i];
+  }
+
+  wasmtime_val_t value;
+  wasm_trap_t *trap = Q_NULLPTR;
+  auto *callError = wasmtime_func_call(context, &function, params,
+                                       static_cast<size_t>(count), &value, 1,
+                                       &trap);
+  if (callError || trap)
+  {
+    const auto message = ERROR_MESSAGE(callError, trap);
+    if (error)
+      *error = message;
+
+    return false;
+  }
+
+  if (value.kind != WASMTIME_I32)
+  {
+    if (error)
+      *error = QStringLiteral("The function must return an i32 value");
+
+    return false;
+  }
+
+  result = value.of.i32;
+  return true;
+}
+
+/**
+ * Calls the @c alloc() function of the module & validates that the returned
+ * buffer of @a size bytes lies within the linear memory of the module.
+ */
+static bool ALLOCATE(JSON::WasmInstance &wasm, const quint32 size,
+                     const quint64 fuel, quint32 &offset,
+                     QString *error = Q_NULLPTR)
+{
+  qint32 result;
+  const qint32 args[] = {static_cast<qint32>(size)};
+  if (!CALL(wasm, wasm.alloc, args, 1, fuel, result, error))
+    return false;
+
+  const auto *context = wasmtime_store_context(wasm.store);
+  const auto available = wasmtime_memory_data_size(context, &wasm.memory);
+  offset = static_cast<quint32>(result);
+  if (result <= 0 || quint64(offset) + size > available)
+  {
+    if (error)
+      *error = QStringLiteral("alloc() returned an invalid buffer");
+
+    return false;
+  }
+
+  return true;
+}
+#else
+class JSON::WasmRuntime
+{
+};
+class JSON::WasmInstance
+{
+};
+#endif
+
+/**
+ * Constructor function
+ */
+JSON::WasmDecoder::WasmDecoder()
+  : m_maxValues(JSON_WASM_MAX_VALUES)
+  , m_fuel(JSON_WASM_FUEL)
+{
+}
+
+/**
+ * Copy constructor, the compiled module is shared with @a other but the copy
+ * creates its own instance of the module.
+ */
+JSON::WasmDecoder::WasmDecoder(const WasmDecoder &other)
+  : m_maxValues(other.m_maxValues)
+  , m_fuel(other.m_fuel)
+  , m_modulePath(other.m_modulePath)
+  , m_runtime(other.m_runtime)
+{
+}
+
+/**
+ * Assignment operator, the compiled module is shared with @a other but the
+ * copy creates its own instance of the module.
+ */
+JSON::WasmDecoder &JSON::WasmDecoder::operator=(const WasmDecoder &other)
+{
+  if (this != &other)
+  {
+    m_fuel = other.m_fuel;
+    m_maxValues = other.m_maxValues;
+    m_modulePath = other.m_modulePath;
+    m_runtime = other.m_runtime;
+    m_instance.reset();
+  }
+
+  return *this;
+}
+
+/**
+ * Destructor function
+ */
+JSON::WasmDecoder::~WasmDecoder() {}
+
+/**
+ * Returns @c true if the project does not declare a WebAssembly module
+ */
+bool JSON::WasmDecoder::isEmpty() const
+{
+  return m_modulePath.isEmpty();
+}
+
+/**
+ * Returns @c true if the module has been compiled by @c load()
+ */
+bool JSON::WasmDecoder::isLoaded() const
+{
+  return !m_runtime.isNull();
+}
+
+/**
+ * Returns the absolute path of the WebAssembly module
+ */
+QString JSON::WasmDecoder::modulePath() const
+{
+  return m_modulePath;
+}
+
+/**
+ * Removes the module & the configuration of the decoder
+ */
+void JSON::WasmDecoder::clear()
+{
+  m_modulePath.clear();
+  m_runtime.reset();
+  m_instance.reset();
+  m_fuel = JSON_WASM_FUEL;
+  m_maxValues = JSON_WASM_MAX_VALUES;
+}
+
+/**
+ * Reads the given @a config (see the class description). Relative module
+ * paths are resolved against the directory of the @a projectPath, if given.
+ *
+ * The module file is not read here, see @c load().
+ *
+ * @returns @c false & writes the reason to @a error if the configuration is
+ *          not valid.
+ */
+bool JSON::WasmDecoder::compile(const QJsonValue &config,
+                                const QString &projectPath, QString *error)
+{
+  // Decoder disabled
+  clear();
+  if (config.isUndefined() || config.isNull())
+    return true;
+
+  // Validate the type of the configuration
+  if (!config.isString() && !config.isObject())
+  {
+    if (error)
+      *error = QStringLiteral("The WebAssembly configuration must be an "
+                              "object or a module path");
+
+    return false;
+  }
+
+  // Read the module path
+  const auto object = config.toObject();
+  const auto path = config.isString() ? config.toString()
+                                      : object.value("module").toString();
+  if (path.isEmpty())
+  {
+    if (error)
+      *error = QStringLiteral("No WebAssembly module has been specified");
+
+    return false;
+  }
+
+  // Read the limits
+  const auto maxValues = object.value("maxValues").toInt(JSON_WASM_MAX_VALUES);
+  const auto fuel = object.value("fuel").toDouble(JSON_WASM_FUEL);
+  if (maxValues <= 0 || maxValues > 65536 || fuel < 1)
+  {
+    if (error)
+      *error = QStringLiteral("Invalid WebAssembly limits");
+
+    return false;
+  }
+
+  // Register the configuration
+  m_maxValues = maxValues;
+  m_fuel = static_cast<quint64>(fuel);
+  if (!projectPath.isEmpty() && QFileInfo(path).isRelative())
+    m_modulePath
+        = QFileInfo(projectPath).absoluteDir().absoluteFilePath(path);
+  else
+    m_modulePath = path;
+
+  return true;
+}
+
+/**
+ * Reads & compiles the WebAssembly module.
+ *
+ * @returns @c false & writes the reason to @a error if the module cannot be
+ *          read or compiled, or if the application was built without
+ *          WebAssembly support.
+ */
+bool JSON::WasmDecoder::load(QString *error)
+{
+  // Nothing to load
+  m_runtime.reset();
+  m_instance.reset();
+  if (isEmpty())
+    return true;
+
+#ifdef ENABLE_WASM_PARSER
+  // Read the module
+  QFile file(m_modulePath);
+  if (!file.open(QFile::ReadOnly))
+  {
+    if (error)
+      *error = file.errorString();
+
+    return false;
+  }
+
+  const auto bytes = file.readAll();
+  file.close();
+
+  // Create an engine that meters the execution of the module
+  auto *config = wasm_config_new();
+  wasmtime_config_consume_fuel_set(config, true);
+
+  QSharedPointer<WasmRuntime> runtime(new WasmRuntime);
+  runtime->engine = wasm_engine_new_with_config(config);
+
+  // Compile the module
+  auto *moduleError = wasmtime_module_new(
+      runtime->engine, reinterpret_cast<const uint8_t *>(bytes.constData()),
+      static_cast<size_t>(bytes.size()), &runtime->module);
+  if (moduleError)
+  {
+    const auto message = ERROR_MESSAGE(moduleError, Q_NULLPTR);
+    if (error)
+      *error = message;
+
+    return false;
+  }
+
+  m_runtime = runtime;
+  return true;
+#else
+  if (error)
+    *error = QStringLiteral("This build does not support WebAssembly frame "
+                            "parsers");
+
+  return false;
+#endif
+}
+
+/**
+ * Decodes the given @a frame with the @c parse() function of the module &
+ * writes the returned values to @a values. The module is instantiated on the
+ * first call.
+ *
+ * @returns @c false if the module is not loaded, if the module traps or runs
+ *          out of fuel, or if @c parse() discards the frame.
+ */
+bool JSON::WasmDecoder::decode(const QByteArray &frame,
+                               QVector<double> &values)
+{
+#ifdef ENABLE_WASM_PARSER
+  // Module not loaded
+  if (!m_runtime)
+    return false;
+
+  // Instantiate the module
+  if (!m_instance)
+  {
+    QString error;
+    QSharedPointer<WasmInstance> wasm(new WasmInstance);
+    wasm->store
+        = wasmtime_store_new(m_runtime->engine, Q_NULLPTR, Q_NULLPTR);
+    auto *context = wasmtime_store_context(wasm->store);
+
+    // Create the instance, modules with imports are rejected
+    wasm_trap_t *trap = Q_NULLPTR;
+    auto *instanceError = wasmtime_instance_new(
+        context, m_runtime->module, Q_NULLPTR, 0, &wasm->instance, &trap);
+    if (instanceError || trap)
+    {
+      qWarning() << "Cannot instantiate WebAssembly module:"
+                 << ERROR_MESSAGE(instanceError, trap);
+      m_runtime.reset();
+      return false;
+    }
+
+    // Get the exports of the module
+    wasmtime_extern_t memory, alloc, parse;
+    const bool valid
+        = wasmtime_instance_export_get(context, &wasm->instance, "memory", 6,
+                                       &memory)
+          && memory.kind == WASMTIME_EXTERN_MEMORY
+          && wasmtime_instance_export_get(context, &wasm->instance, "alloc",
+                                          5, &alloc)
+          && alloc.kind == WASMTIME_EXTERN_FUNC
+          && wasmtime_instance_export_get(context, &wasm->instance, "parse",
+                                          5, &parse)
+          && parse.kind == WASMTIME_EXTERN_FUNC;
+    if (!valid)
+    {
+      qWarning() << "The WebAssembly module must export memory, alloc() and "
+                    "parse()";
+      m_runtime.reset();
+      return false;
+    }
+
+    wasm->memory = memory.of.memory;
+    wasm->alloc = alloc.of.func;
+    wasm->parse = parse.of.func;
+
+    // Allocate the value array
+    const auto size = static_cast<quint32>(m_maxValues * sizeof(double));
+    if (!ALLOCATE(*wasm, size, m_fuel, wasm->values, &error))
+    {
+      qWarning() << "Cannot allocate WebAssembly value array:" << error;
+      m_runtime.reset();
+      return false;
+    }
+
+    m_instance = wasm;
+  }
+
+  auto &wasm = *m_instance;
+  const auto length = static_cast<quint32>(frame.size());
+
+  // Grow the input buffer if needed
+  if (length > wasm.inputCapacity)
+  {
+    QString error;
+    const auto capacity = qMax<quint32>(length, 1024);
+    if (!ALLOCATE(wasm, capacity, m_fuel, wasm.input, &error))
+    {
+      qWarning() << "Cannot allocate WebAssembly input buffer:" << error;
+      wasm.inputCapacity = 0;
+      return false;
+    }
+
+    wasm.inputCapacity = capacity;
+  }
+
+  // Copy the frame to the linear memory of the module
+  auto *context = wasmtime_store_context(wasm.store);
+  auto *memory = wasmtime_memory_data(context, &wasm.memory);
+  memcpy(memory + wasm.input, frame.constData(), length);
+
+  // Parse the frame, traps & fuel exhaustion discard the frame
+  qint32 count;
+  const qint32 args[] = {static_cast<qint32>(wasm.input),
+                         static_cast<qint32>(length),
+                         static_cast<qint32>(wasm.values), m_maxValues};
+  if (!CALL(wasm, wasm.parse, args, 4, m_fuel, count) || count < 0)
+    return false;
+
+  // Read the values, memory may have been moved by memory.grow
+  count = qMin(count, m_maxValues);
+  memory = wasmtime_memory_data(context, &wasm.memory);
+  const auto available = wasmtime_memory_data_size(context, &wasm.memory);
+  if (wasm.values + quint64(count) * sizeof(double) > available)
+    return false;
+
+  values.resize(count);
+  const auto *data = memory + wasm.values;
+  for (int i = 0; i < count; ++i)
+  {
+    quint64 bits = qFromLittleEndian<quint64>(data + i * sizeof(double));
+    memcpy(&values[i], &bits, sizeof(double));
+  }
+
+  return true;
+#else
+  (void)frame;
+  (void)values;
+  return false;
+#endif
+}
+
+/**
+ * Returns @c true if the application was built with WebAssembly support
+ */
+bool JSON::WasmDecoder::isSupported()
+{
+#ifdef ENABLE_WASM_PARSER
+  return true;
+#else
+  return false;
+#endif
+}
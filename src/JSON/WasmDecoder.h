@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QJsonValue>
+#include <QSharedPointer>
+
+/**
+ * Default maximum number of values returned by the parse() function of a
+ * WebAssembly frame parser.
+ */
+#define JSON_WASM_MAX_VALUES 256
+
+/**
+ * Default amount of fuel (roughly, WebAssembly instructions) that a single
+ * call to parse() may consume before it is aborted.
+ */
+#define JSON_WASM_FUEL 10000000
+
+namespace JSON
+{
+class WasmRuntime;
+class WasmInstance;
+
+/**
+ * @brief The WasmDecoder class
+ *
+ * Runs a frame parser compiled to WebAssembly, used by projects that need
+ * near-native parsing speed for complex protocols. The module is declared
+ * with the optional @c wasm key of the project, next to the JavaScript
+ * frame parser:
+ *
+ * @code
+ * "wasm": {
+ *   "module": "parser.wasm", // Relative to the project file
+ *   "maxValues": 256,        // Optional, capacity of the value array
+ *   "fuel": 10000000         // Optional, execution budget of each call
+ * }
+ * @endcode
+ *
+ * @c "wasm": "parser.wasm" selects a module with the default settings. The
+ * module must not import anything & must export:
+ *
+ * - @c memory: the linear memory of the module.
+ * - @c alloc(size: i32) -> i32: returns the offset of a buffer of @c size
+ *   bytes, called once for the input buffer (and again if a larger frame is
+ *   received) and once for the value array.
+ * - @c parse(input: i32, length: i32, values: i32, capacity: i32) -> i32:
+ *   decodes the frame copied at @c input & writes up to @c capacity
+ *   little-endian @c f64 values at @c values. Returns the number of values
+ *   written, or a negative number to discard the frame.
+ *
+ * The n-th value feeds the datasets with frame index n + 1, NaN values keep
+ * the last value of their datasets.
+ *
+ * Modules run in the sandbox provided by WebAssembly: they can only access
+ * their own linear memory, and each call to parse() is aborted (& the frame
+ * discarded) if it runs out of fuel or traps. The module file is read &
+ * compiled when the project is loaded by the JSON generator, so a rebuilt
+ * module is picked up by reloading the project.
+ *
+ * WebAssembly modules are executed with the wasmtime runtime, which is only
+ * linked if the application is built with @c CONFIG+=wasm. Otherwise,
+ * projects that declare a module are loaded without it & @c load() reports
+ * the error.
+ */
+class WasmDecoder
+{
+public:
+  WasmDecoder();
+  WasmDecoder(const WasmDecoder &other);
+  WasmDecoder &operator=(const WasmDecoder &other);
+  ~WasmDecoder();
+
+  bool isEmpty() const;
+  bool isLoaded() const;
+  QString modulePath() const;
+
+  void clear();
+  bool compile(const QJsonValue &config, const QString &projectPath,
+               QString *error = Q_NULLPTR);
+  bool load(QString *error = Q_NULLPTR);
+  bool decode(const QByteArray &frame, QVector<double> &values);
+
+  static bool isSupported();
+
+private:
+  int m_maxValues;
+  quint64 m_fuel;
+  QString m_modulePath;
+  QSharedPointer<WasmRuntime> m_runtime;
+  QSharedPointer<WasmInstance> m_instance;
+};
+} // namespace JSON
@@ -21,43 +21,96 @@
  */
 
 #include <QFile>
+#include <QtEndian>
+#include <QDateTime>
+#include <QtNumeric>
+#include <QCborMap>
+#include <QCborArray>
+#include <QJsonArray>
 #include <QFileDialog>
+#include <QJsonDocument>
+#include <QRegularExpression>
+
+#include <cstring>
 
 #include <IO/Manager.h>
+#include <IO/HostCache.h>
 #include <MQTT/Client.h>
+#include <JSON/Generator.h>
 #include <Misc/Utilities.h>
-#include <Misc/TimerEvents.h>
+#include <Plugins/Server.h>
+
+//----------------------------------------------------------------------------------------
+// Client implementation
+//----------------------------------------------------------------------------------------
 
 /**
- * Constructor function
+ * Constructor function, connects the signals that feed frames to the MQTT
+ * worker. The network thread is started by @c start(), so that constructing
+ * the client does not delay the startup of the user interface.
  */
 MQTT::Client::Client()
-  : m_topic("")
+  : m_connected(false)
+  , m_sslEnabled(false)
+  , m_sslProtocol(0)
   , m_lookupActive(false)
-  , m_sentMessages(0)
-  , m_clientMode(MQTTClientMode::ClientPublisher)
-  , m_client(Q_NULLPTR)
+  , m_spooledBytes(0)
+  , m_droppedMessages(0)
+  , m_worker(new ClientWorker())
 {
-  // Configure new client
-  regenerateClient();
+  // Move the worker to the network thread
+  m_thread.setObjectName(QStringLiteral("MQTT::ClientWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+  // clang-format off
+
+    // React to worker events
+    connect(m_worker, &ClientWorker::errorOccurred,
+            this, &MQTT::Client::onError);
+    connect(m_worker, &ClientWorker::connectedChanged,
+            this, &MQTT::Client::onConnectedChanged);
+    connect(m_worker, &ClientWorker::messagesReceived,
+            this, &MQTT::Client::onMessagesReceived);
+    connect(m_worker, &ClientWorker::spoolStatusChanged,
+            this, &MQTT::Client::onSpoolStatusChanged);
+
+    // Raw frames are read by the worker from the frame queue
+    auto io = &IO::Manager::instance();
+    connect(io, &IO::Manager::framesAvailable,
+            m_worker, &ClientWorker::readFrames);
+
+    // Forward parsed frames & reset statistics when the device changes
+    JSON::Generator::instance().sinks().addSink(
+        this, JSON::SinkGraph::Port::DecimatedFrames);
+    connect(&JSON::Generator::instance(), &JSON::Generator::alarmsTriggered,
+            this, &MQTT::Client::onAlarmsTriggered);
+    connect(io, &IO::Manager::connectedChanged,
+            this, &MQTT::Client::resetStatistics);
+
+  // clang-format on
 
-  // Send data periodically & reset statistics when disconnected/connected to a
-  // device
-  auto io = &IO::Manager::instance();
-  auto te = &Misc::TimerEvents::instance();
-  connect(te, &Misc::TimerEvents::timeout1Hz, this, &MQTT::Client::sendData);
-  connect(io, &IO::Manager::frameReceived, this,
-          &MQTT::Client::onFrameReceived);
-  connect(io, &IO::Manager::connectedChanged, this,
-          &MQTT::Client::resetStatistics);
+  // Create the MQTT client once the network thread starts
+  m_config.encodingName = payloadEncodings().at(m_config.encoding);
+  regenerateClient();
+  resetStatistics();
 }
 
 /**
- * Destructor function
+ * Destructor function, publishes pending data & stops the network thread
  */
 MQTT::Client::~Client()
 {
-  delete m_client;
+  // Network thread never started, delete the worker directly
+  if (!m_thread.isRunning())
+  {
+    delete m_worker;
+    return;
+  }
+
+  closeConnection();
+  m_thread.quit();
+  m_thread.wait();
 }
 
 /**
@@ -69,6 +122,23 @@ MQTT::Client &MQTT::Client::instance()
   return singleton;
 }
 
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString MQTT::Client::sinkName() const
+{
+  return QStringLiteral("MQTT::Client");
+}
+
+/**
+ * Publishes the given batch of decimated @a frames, see
+ * @c onParsedFramesReceived()
+ */
+void MQTT::Client::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  onParsedFramesReceived(frames);
+}
+
 /**
  * Returns the quality-of-service option, available values:
  * - 0: at most once
@@ -77,8 +147,7 @@ MQTT::Client &MQTT::Client::instance()
  */
 quint8 MQTT::Client::qos() const
 {
-  Q_ASSERT(m_client);
-  return m_client->willQos();
+  return m_config.qos;
 }
 
 /**
@@ -86,8 +155,7 @@ quint8 MQTT::Client::qos() const
  */
 bool MQTT::Client::retain() const
 {
-  Q_ASSERT(m_client);
-  return m_client->willRetain();
+  return m_config.retain;
 }
 
 /**
@@ -95,8 +163,7 @@ bool MQTT::Client::retain() const
  */
 quint16 MQTT::Client::port() const
 {
-  Q_ASSERT(m_client);
-  return m_client->port();
+  return m_config.port;
 }
 
 /**
@@ -104,7 +171,7 @@ quint16 MQTT::Client::port() const
  */
 QString MQTT::Client::topic() const
 {
-  return m_topic;
+  return m_config.topic;
 }
 
 /**
@@ -122,20 +189,7 @@ int MQTT::Client::sslProtocol() const
  */
 int MQTT::Client::mqttVersion() const
 {
-  Q_ASSERT(m_client);
-
-  switch (m_client->version())
-  {
-    case QMQTT::V3_1_0:
-      return 0;
-      break;
-    case QMQTT::V3_1_1:
-      return 1;
-      break;
-    default:
-      return -1;
-      break;
-  }
+  return m_config.mqttVersion;
 }
 
 /**
@@ -153,7 +207,7 @@ bool MQTT::Client::sslEnabled() const
  */
 int MQTT::Client::clientMode() const
 {
-  return m_clientMode;
+  return m_config.clientMode;
 }
 
 /**
@@ -161,8 +215,7 @@ int MQTT::Client::clientMode() const
  */
 QString MQTT::Client::username() const
 {
-  Q_ASSERT(m_client);
-  return m_client->username();
+  return m_config.username;
 }
 
 /**
@@ -170,8 +223,7 @@ QString MQTT::Client::username() const
  */
 QString MQTT::Client::password() const
 {
-  Q_ASSERT(m_client);
-  return QString::fromUtf8(m_client->password());
+  return m_config.password;
 }
 
 /**
@@ -179,8 +231,105 @@ QString MQTT::Client::password() const
  */
 QString MQTT::Client::host() const
 {
-  Q_ASSERT(m_client);
-  return m_client->hostName();
+  return m_config.host;
+}
+
+/**
+ * Returns the maximum time (in milliseconds) that a frame waits in the batch
+ * before the batch is published.
+ */
+int MQTT::Client::maxLatency() const
+{
+  return m_config.maxLatency;
+}
+
+/**
+ * Returns the maximum size (in bytes) of a batch, or 0 if the size of the
+ * batches is not limited.
+ */
+int MQTT::Client::maxBatchBytes() const
+{
+  return m_config.maxBatchBytes;
+}
+
+/**
+ * Returns the maximum number of frames in a batch, or 0 if the number of
+ * frames is not limited.
+ */
+int MQTT::Client::maxBatchFrames() const
+{
+  return m_config.maxBatchFrames;
+}
+
+/**
+ * Returns @c true if each frame is published in its own message instead of
+ * being accumulated in a batch.
+ */
+bool MQTT::Client::perFramePublishing() const
+{
+  return m_config.perFrame;
+}
+
+/**
+ * Returns the format of the published messages, the list of formats is
+ * obtained with @c payloadEncodings().
+ */
+int MQTT::Client::payloadEncoding() const
+{
+  return m_config.encoding;
+}
+
+/**
+ * Returns the minimum change that a numeric dataset must experience before its
+ * value is published again when each dataset is published in its own topic.
+ */
+double MQTT::Client::deadband() const
+{
+  return m_config.deadband;
+}
+
+/**
+ * Returns @c true if messages are stored on disk while the connection with
+ * the broker is lost.
+ */
+bool MQTT::Client::spoolEnabled() const
+{
+  return m_config.spoolEnabled;
+}
+
+/**
+ * Returns the maximum size of the offline spool in megabytes.
+ */
+int MQTT::Client::spoolLimit() const
+{
+  return m_config.spoolLimit;
+}
+
+/**
+ * Returns the maximum number of spooled messages that are published per
+ * second once the connection with the broker is restored.
+ */
+int MQTT::Client::drainRate() const
+{
+  return m_config.drainRate;
+}
+
+/**
+ * Returns the number of bytes stored in the spool that are pending to be
+ * published, as last reported by the network thread.
+ */
+qint64 MQTT::Client::spooledBytes() const
+{
+  return m_spooledBytes;
+}
+
+/**
+ * Returns the number of messages that were discarded because the spool was
+ * full, as last reported by the network thread.
+ */
+qint64 MQTT::Client::droppedMessages() const
+{
+  return m_droppedMessages;
 }
 
 /**
@@ -188,8 +337,7 @@ QString MQTT::Client::host() const
  */
 quint16 MQTT::Client::keepAlive() const
 {
-  Q_ASSERT(m_client);
-  return m_client->keepAlive();
+  return m_config.keepAlive;
 }
 
 /**
@@ -212,12 +360,12 @@ bool MQTT::Client::isSubscribed() const
 }
 
 /**
- * Returns @c true if the MQTT module is connected to a MQTT broker/server.
+ * Returns @c true if the MQTT module is connected to a MQTT broker/server, as
+ * last reported by the network thread.
  */
 bool MQTT::Client::isConnectedToHost() const
 {
-  Q_ASSERT(m_client);
-  return m_client->isConnectedToHost();
+  return m_connected;
 }
 
 /**
@@ -234,6 +382,21 @@ StringList MQTT::Client::qosLevels() const
   // clang-format on
 }
 
+/**
+ * Returns a list with the available payload encodings.
+ */
+StringList MQTT::Client::payloadEncodings() const
+{
+  // clang-format off
+    return StringList {
+        tr("Raw frames (text)"),
+        tr("Parsed frames (CBOR)"),
+        tr("Parsed frames (packed binary)"),
+        tr("One topic per dataset")
+    };
+  // clang-format on
+}
+
 /**
  * Returns a list with the available client operation modes.
  */
@@ -294,8 +457,36 @@ void MQTT::Client::loadCaFile()
  */
 void MQTT::Client::connectToHost()
 {
-  Q_ASSERT(m_client);
-  m_client->connectToHost();
+  start();
+
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->connectToHost(); });
+}
+
+/**
+ * Publishes the pending batch & disconnects from the MQTT broker, this
+ * function waits until the network thread has finished doing so.
+ */
+void MQTT::Client::closeConnection()
+{
+  if (!m_thread.isRunning())
+    return;
+
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(
+      worker, [=] { worker->shutdown(); }, Qt::BlockingQueuedConnection);
+}
+
+/**
+ * Starts the network thread of the client (if not started already).
+ *
+ * Calls made to the worker before the thread starts are queued & processed
+ * in order once its event loop begins running.
+ */
+void MQTT::Client::start()
+{
+  if (!m_thread.isRunning())
+    m_thread.start();
 }
 
 /**
@@ -315,8 +506,8 @@ void MQTT::Client::toggleConnection()
  */
 void MQTT::Client::disconnectFromHost()
 {
-  Q_ASSERT(m_client);
-  m_client->disconnectFromHost();
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->disconnectFromHost(); });
 }
 
 /**
@@ -324,8 +515,8 @@ void MQTT::Client::disconnectFromHost()
  */
 void MQTT::Client::setQos(const quint8 qos)
 {
-  Q_ASSERT(m_client);
-  m_client->setWillQos(qos);
+  m_config.qos = qos;
+  configureWorker();
   Q_EMIT qosChanged();
 }
 
@@ -344,8 +535,8 @@ void MQTT::Client::lookup(const QString &host)
  */
 void MQTT::Client::setPort(const quint16 port)
 {
-  Q_ASSERT(m_client);
-  m_client->setPort(port);
+  m_config.port = port;
+  configureWorker();
   Q_EMIT portChanged();
 }
 
@@ -354,8 +545,8 @@ void MQTT::Client::setPort(const quint16 port)
  */
 void MQTT::Client::setHost(const QString &host)
 {
-  Q_ASSERT(m_client);
-  m_client->setHostName(host);
+  m_config.host = host;
+  configureWorker();
   Q_EMIT hostChanged();
 }
 
@@ -366,8 +557,8 @@ void MQTT::Client::setHost(const QString &host)
  */
 void MQTT::Client::setRetain(const bool retain)
 {
-  Q_ASSERT(m_client);
-  m_client->setWillRetain(retain);
+  m_config.retain = retain;
+  configureWorker();
   Q_EMIT retainChanged();
 }
 
@@ -378,7 +569,8 @@ void MQTT::Client::setRetain(const bool retain)
  */
 void MQTT::Client::setClientMode(const int mode)
 {
-  m_clientMode = static_cast<MQTTClientMode>(mode);
+  m_config.clientMode = mode;
+  configureWorker();
   Q_EMIT clientModeChanged();
 }
 
@@ -387,7 +579,8 @@ void MQTT::Client::setClientMode(const int mode)
  */
 void MQTT::Client::setTopic(const QString &topic)
 {
-  m_topic = topic;
+  m_config.topic = topic;
+  configureWorker();
   Q_EMIT topicChanged();
 }
 
@@ -483,6 +676,7 @@ void MQTT::Client::setSslProtocol(const int index)
   }
 #endif
 
+  m_sslProtocol = index;
   regenerateClient();
   Q_EMIT sslProtocolChanged();
 }
@@ -502,8 +696,8 @@ void MQTT::Client::setSslEnabled(const bool enabled)
  */
 void MQTT::Client::setUsername(const QString &username)
 {
-  Q_ASSERT(m_client);
-  m_client->setUsername(username);
+  m_config.username = username;
+  configureWorker();
   Q_EMIT usernameChanged();
 }
 
@@ -512,8 +706,8 @@ void MQTT::Client::setUsername(const QString &username)
  */
 void MQTT::Client::setPassword(const QString &password)
 {
-  Q_ASSERT(m_client);
-  m_client->setPassword(password.toUtf8());
+  m_config.password = password;
+  configureWorker();
   Q_EMIT passwordChanged();
 }
 
@@ -524,8 +718,8 @@ void MQTT::Client::setPassword(const QString &password)
  */
 void MQTT::Client::setKeepAlive(const quint16 keepAlive)
 {
-  Q_ASSERT(m_client);
-  m_client->setKeepAlive(keepAlive);
+  m_config.keepAlive = keepAlive;
+  configureWorker();
   Q_EMIT keepAliveChanged();
 }
 
@@ -534,71 +728,186 @@ void MQTT::Client::setKeepAlive(const quint16 keepAlive)
  */
 void MQTT::Client::setMqttVersion(const int versionIndex)
 {
-  Q_ASSERT(m_client);
-
-  switch (versionIndex)
+  if (versionIndex >= 0 && versionIndex < mqttVersions().count())
   {
-    case 0:
-      m_client->setVersion(QMQTT::V3_1_0);
-      break;
-    case 1:
-      m_client->setVersion(QMQTT::V3_1_1);
-      break;
-    default:
-      break;
+    m_config.mqttVersion = versionIndex;
+    configureWorker();
   }
 
   Q_EMIT mqttVersionChanged();
 }
 
 /**
- * Publishes all the received data to the MQTT broker
+ * Changes the maximum time (in @a milliseconds) that a frame waits in the
+ * batch before the batch is published.
  */
-void MQTT::Client::sendData()
+void MQTT::Client::setMaxLatency(const int milliseconds)
 {
-  Q_ASSERT(m_client);
+  const auto latency = qBound(1, milliseconds, 60 * 1000);
+  if (m_config.maxLatency != latency)
+  {
+    m_config.maxLatency = latency;
+    configureWorker();
+    Q_EMIT batchingChanged();
+  }
+}
 
-  // Create data byte array
-  QByteArray data;
-  for (int i = 0; i < m_frames.count(); ++i)
+/**
+ * Changes the maximum size (in @a bytes) of a batch, set to 0 to disable the
+ * size limit.
+ */
+void MQTT::Client::setMaxBatchBytes(const int bytes)
+{
+  const auto limit = qMax(0, bytes);
+  if (m_config.maxBatchBytes != limit)
   {
-    data.append(m_frames.at(i));
-    data.append("\n");
+    m_config.maxBatchBytes = limit;
+    configureWorker();
+    Q_EMIT batchingChanged();
   }
+}
 
-  // Create & send MQTT message
-  if (!data.isEmpty())
+/**
+ * Changes the maximum number of @a frames in a batch, set to 0 to disable the
+ * frame limit.
+ */
+void MQTT::Client::setMaxBatchFrames(const int frames)
+{
+  const auto limit = qMax(0, frames);
+  if (m_config.maxBatchFrames != limit)
+  {
+    m_config.maxBatchFrames = limit;
+    configureWorker();
+    Q_EMIT batchingChanged();
+  }
+}
+
+/**
+ * Enables/disables publishing each frame in its own message, the current
+ * batch is published before the change takes effect.
+ */
+void MQTT::Client::setPerFramePublishing(const bool enabled)
+{
+  if (m_config.perFrame != enabled)
+  {
+    m_config.perFrame = enabled;
+    configureWorker();
+    Q_EMIT batchingChanged();
+  }
+}
+
+/**
+ * Changes the format of the published messages, the current batch is
+ * published before the change takes effect.
+ */
+void MQTT::Client::setPayloadEncoding(const int encoding)
+{
+  if (m_config.encoding != encoding && encoding >= TextPayload
+      && encoding <= DatasetTopics)
   {
-    QMQTT::Message message(m_sentMessages, topic(), data);
-    m_client->publish(message);
-    ++m_sentMessages;
+    m_config.encoding = encoding;
+    m_config.encodingName = payloadEncodings().at(encoding);
+    configureWorker();
+    Q_EMIT payloadEncodingChanged();
   }
+}
 
-  // Clear frame list
-  m_frames.clear();
+/**
+ * Changes the minimum change that a numeric dataset must experience before its
+ * value is published again when each dataset is published in its own topic.
+ */
+void MQTT::Client::setDeadband(const double deadband)
+{
+  const auto value = qMax(0.0, deadband);
+  if (!qFuzzyCompare(m_config.deadband + 1, value + 1))
+  {
+    m_config.deadband = value;
+    configureWorker();
+    Q_EMIT deadbandChanged();
+  }
 }
 
 /**
- * Clears the JSON frames & sets the sent messages to 0
+ * Enables or disables storing messages on disk while the connection with the
+ * broker is lost. The client reconnects automatically while spooling is
+ * enabled.
+ */
+void MQTT::Client::setSpoolEnabled(const bool enabled)
+{
+  if (m_config.spoolEnabled != enabled)
+  {
+    m_config.spoolEnabled = enabled;
+    configureWorker();
+    Q_EMIT spoolChanged();
+  }
+}
+
+/**
+ * Changes the maximum size of the offline spool in @a megabytes, the oldest
+ * messages are discarded when the spool is full.
+ */
+void MQTT::Client::setSpoolLimit(const int megabytes)
+{
+  const auto value = qBound(1, megabytes, 4096);
+  if (m_config.spoolLimit != value)
+  {
+    m_config.spoolLimit = value;
+    configureWorker();
+    Q_EMIT spoolChanged();
+  }
+}
+
+/**
+ * Changes the maximum number of spooled messages that are published per
+ * second once the connection with the broker is restored.
+ */
+void MQTT::Client::setDrainRate(const int messagesPerSecond)
+{
+  const auto value = qBound(1, messagesPerSecond, 10000);
+  if (m_config.drainRate != value)
+  {
+    m_config.drainRate = value;
+    configureWorker();
+    Q_EMIT spoolChanged();
+  }
+}
+
+/**
+ * Notifies the network thread that the device was connected or disconnected,
+ * which discards the current batch & resets the message counter.
  */
 void MQTT::Client::resetStatistics()
 {
-  m_sentMessages = 0;
-  m_frames.clear();
+  auto worker = m_worker;
+  const auto connected = IO::Manager::instance().connected();
+  QMetaObject::invokeMethod(worker,
+                            [=] { worker->setDeviceConnected(connected); });
 }
 
 /**
- * Subscribe/unsubscripe to the set MQTT topic when the connection state is
- * changed.
+ * Sends a copy of the current settings to the network thread
  */
-void MQTT::Client::onConnectedChanged()
+void MQTT::Client::configureWorker()
 {
-  Q_ASSERT(m_client);
+  auto worker = m_worker;
+  const auto config = m_config;
+  QMetaObject::invokeMethod(worker, [=] { worker->configure(config); });
+}
 
-  if (isConnectedToHost())
-    m_client->subscribe(topic());
-  else
-    m_client->unsubscribe(topic());
+/**
+ * Instructs the network thread to create a new MQTT client instance, this
+ * approach is required in order to allow the MQTT module to support both
+ * non-encrypted and TLS connections.
+ */
+void MQTT::Client::regenerateClient()
+{
+  auto worker = m_worker;
+  const auto config = m_config;
+  const auto ssl = m_sslEnabled;
+  const auto sslConfiguration = m_sslConfiguration;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->regenerateClient(config, ssl, sslConfiguration);
+  });
 }
 
 /**
@@ -616,6 +925,7 @@ void MQTT::Client::lookupFinished(const QHostInfo &info)
     auto addresses = info.addresses();
     if (addresses.count() >= 1)
     {
+      IO::HostCache::instance().insert(info.hostName(), addresses);
       setHost(addresses.first().toString());
       return;
     }
@@ -628,7 +938,7 @@ void MQTT::Client::lookupFinished(const QHostInfo &info)
 /**
  * Displays any MQTT-related error with a GUI message-box
  */
-void MQTT::Client::onError(const QMQTT::ClientError error)
+void MQTT::Client::onError(const int error)
 {
   QString str;
 
@@ -734,146 +1044,744 @@ void MQTT::Client::onError(const QMQTT::ClientError error)
 }
 
 /**
- * Registers the given @a frame data to the list of frames that shall be
- * published to the MQTT broker/server
+ * Updates the connection status reported by the network thread
  */
-void MQTT::Client::onFrameReceived(const QByteArray &frame)
+void MQTT::Client::onConnectedChanged(const bool connected)
 {
-  // Ignore if device is not connected
-  if (!IO::Manager::instance().connected())
+  if (m_connected != connected)
+  {
+    m_connected = connected;
+    Q_EMIT connectedChanged();
+  }
+}
+
+/**
+ * Instructs the @c IO::Manager module to process a batch of @a frames
+ * received on the subscribed topic, the raw @a data is shown in the console.
+ */
+void MQTT::Client::onMessagesReceived(const QByteArray &data,
+                                      const QVector<QByteArray> &frames)
+{
+  // Ignore if client mode is not set to suscriber
+  if (clientMode() != ClientSubscriber)
     return;
 
-  // Ignore if mode is not set to publisher
-  else if (clientMode() != ClientPublisher)
+  // Let IO manager process incoming data
+  IO::Manager::instance().processFrames(data, frames);
+}
+
+/**
+ * Forwards the given parsed @a frames to the network thread, which encodes
+ * them with the selected payload encoding.
+ */
+void MQTT::Client::onParsedFramesReceived(const QVector<JSON::Frame> &frames)
+{
+  // Ignore if raw frames are published
+  if (m_config.encoding == TextPayload || frames.isEmpty())
     return;
 
-  // Validate frame & append it to frame list
-  if (!frame.isEmpty())
-    m_frames.append(frame);
+  // Ignore if device is not connected or mode is not set to publisher
+  if (!IO::Manager::instance().connected() || clientMode() != ClientPublisher)
+    return;
+
+  // Let the worker encode & publish the frames
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->registerFrames(frames); });
 }
 
 /**
- * Displays the SSL errors that occur and allows the user to decide if he/she
- * wants to ignore those errors.
+ * Forwards the given alarm @a events to the network thread, which publishes
+ * them on the @c <topic>/alarms topic.
  */
-void MQTT::Client::onSslErrors(const QList<QSslError> &errors)
+void MQTT::Client::onAlarmsTriggered(const QVector<JSON::AlarmEvent> &events)
 {
-  Q_ASSERT(m_client);
+  // Ignore if mode is not set to publisher
+  if (events.isEmpty() || clientMode() != ClientPublisher)
+    return;
 
-  Q_FOREACH (auto error, errors)
-  {
-    auto ret = Misc::Utilities::showMessageBox(
-        tr("MQTT client SSL/TLS error, ignore?"), error.errorString(),
-        qApp->applicationName(), QMessageBox::Ignore | QMessageBox::Abort);
+  // Encode events as a JSON array
+  QJsonArray array;
+  for (const auto &event : events)
+    array.append(event.toJson());
 
-    if (ret == QMessageBox::Abort)
-    {
-      disconnectFromHost();
-      abort();
-    }
+  // Let the worker publish the events
+  auto worker = m_worker;
+  const auto json = QJsonDocument(array).toJson(QJsonDocument::Compact);
+  QMetaObject::invokeMethod(worker, [=] { worker->publishAlarms(json); });
+}
+
+/**
+ * Updates the spool status reported by the network thread
+ */
+void MQTT::Client::onSpoolStatusChanged(const qint64 bytes,
+                                        const qint64 dropped)
+{
+  if (m_spooledBytes != bytes || m_droppedMessages != dropped)
+  {
+    m_spooledBytes = bytes;
+    m_droppedMessages = dropped;
+    Q_EMIT spoolStatusChanged();
   }
+}
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
 
-  m_client->ignoreSslErrors();
+/**
+ * Constructor function, registers the worker as a consumer of the frame queue
+ * of the I/O manager. The MQTT client itself is created by
+ * @c regenerateClient() once the worker runs in the network thread.
+ */
+MQTT::ClientWorker::ClientWorker()
+  : m_frameConsumer(-1)
+  , m_sentMessages(0)
+  , m_deviceConnected(false)
+  , m_batchFrames(0)
+  , m_schemaHash(0)
+  , m_batchTimer(new QTimer(this))
+  , m_sessionActive(false)
+  , m_drainTimer(new QTimer(this))
+  , m_receiveTimer(new QTimer(this))
+  , m_client(Q_NULLPTR)
+{
+  // Register frame consumer
+  auto &queue = IO::Manager::instance().frameQueue();
+  m_frameConsumer = queue.registerConsumer("MQTT::Client");
+
+  // Publish the current batch when the maximum latency expires
+  m_batchTimer->setSingleShot(true);
+  m_batchTimer->setTimerType(Qt::PreciseTimer);
+  connect(m_batchTimer, &QTimer::timeout, this, &MQTT::ClientWorker::sendData);
+
+  // Publish spooled messages in small steps to honor the drain rate
+  m_drainTimer->setInterval(100);
+  connect(m_drainTimer, &QTimer::timeout, this,
+          &MQTT::ClientWorker::drainSpool);
+
+  // Deliver received messages once all pending network events are processed
+  m_receiveTimer->setInterval(0);
+  m_receiveTimer->setSingleShot(true);
+  connect(m_receiveTimer, &QTimer::timeout, this,
+          &MQTT::ClientWorker::flushReceived);
 }
 
 /**
- * Reads the given MQTT @a message and instructs the @c IO::Manager module to
- * process received data directly.
+ * Destructor function, deletes the MQTT client
  */
-void MQTT::Client::onMessageReceived(const QMQTT::Message &message)
+MQTT::ClientWorker::~ClientWorker()
 {
-  // Ignore if client mode is not set to suscriber
-  if (clientMode() != ClientSubscriber)
+  delete m_client;
+}
+
+/**
+ * Publishes the pending batch & disconnects from the MQTT broker
+ */
+void MQTT::ClientWorker::shutdown()
+{
+  if (!m_client)
     return;
 
-  // Get message data
-  auto mtopic = message.topic();
-  auto mpayld = message.payload();
+  sendData();
+  disconnectFromHost();
+}
 
-  // Ignore if topic is not equal to current topic
-  if (topic() != mtopic)
+/**
+ * Reads all the frames that the I/O manager has published since the last call
+ * and registers them to the batch of frames that shall be published, one
+ * frame per line.
+ */
+void MQTT::ClientWorker::readFrames()
+{
+  // Read frames from the queue
+  QVector<QByteArray> frames;
+  auto &queue = IO::Manager::instance().frameQueue();
+  if (queue.popBatch(m_frameConsumer, frames) <= 0)
     return;
 
-  // Add EOL character
-  if (!mpayld.endsWith('\n'))
-    mpayld.append('\n');
+  // Ignore if device is not connected
+  if (!m_deviceConnected)
+    return;
 
-  // Let IO manager process incoming data
-  IO::Manager::instance().processPayload(mpayld);
+  // Ignore if mode is not set to publisher
+  else if (m_config.clientMode != ClientPublisher)
+    return;
+
+  // Ignore if parsed frames are published
+  else if (m_config.encoding != TextPayload)
+    return;
+
+  // Register each frame, one frame per line
+  Q_FOREACH (const auto &frame, frames)
+    registerPayload(frame + '\n');
 }
 
 /**
- * Creates a new MQTT client instance, this approach is required in order to
- * allow the MQTT module to support both non-encrypted and TLS connections.
+ * Tries to establish a TCP connection with the MQTT broker/server.
  */
-void MQTT::Client::regenerateClient()
+void MQTT::ClientWorker::connectToHost()
 {
-  // Init. default MQTT configuration
-  quint8 qos = 0;
-  QString user = "";
-  bool retain = false;
-  QString password = "";
-  quint16 keepAlive = 60;
-  quint16 port = defaultPort();
-  QString host = defaultHost();
-  QMQTT::MQTTVersion version = QMQTT::V3_1_1;
-
-  // There is an existing client, copy its configuration and delete it from
-  // memory
-  if (m_client)
+  Q_ASSERT(m_client);
+  m_sessionActive = true;
+  m_client->connectToHost();
+}
+
+/**
+ * Disconnects from the MQTT broker/server
+ */
+void MQTT::ClientWorker::disconnectFromHost()
+{
+  Q_ASSERT(m_client);
+  m_sessionActive = false;
+  m_drainTimer->stop();
+  m_client->disconnectFromHost();
+}
+
+/**
+ * Clears the current batch & sets the sent messages to 0 when the device is
+ * connected or disconnected.
+ */
+void MQTT::ClientWorker::setDeviceConnected(const bool connected)
+{
+  m_deviceConnected = connected;
+  m_sentMessages = 0;
+  m_batchTimer->stop();
+  m_batch.clear();
+  m_batchFrames = 0;
+  m_datasetTopics.clear();
+}
+
+/**
+ * Applies the given settings to the MQTT client. The current batch is
+ * published before the batching mode or the payload encoding changes.
+ */
+void MQTT::ClientWorker::configure(const ClientConfiguration &config)
+{
+  Q_ASSERT(m_client);
+
+  // Publish the current batch before the format of the messages changes
+  const auto encodingChanged = config.encoding != m_config.encoding;
+  if (encodingChanged || config.perFrame != m_config.perFrame)
+    sendData();
+
+  // Regenerate the schema & topic names with the next frame
+  if (encodingChanged)
   {
-    port = m_client->port();
-    qos = m_client->willQos();
-    user = m_client->username();
-    version = m_client->version();
-    retain = m_client->willRetain();
-    keepAlive = m_client->keepAlive();
-    host = m_client->host().toString();
-    password = QString::fromUtf8(m_client->password());
-
-    disconnect(m_client, &QMQTT::Client::error, Q_NULLPTR, 0);
-    disconnect(m_client, &QMQTT::Client::received, Q_NULLPTR, 0);
-    disconnect(m_client, &QMQTT::Client::connected, Q_NULLPTR, 0);
-    disconnect(m_client, &QMQTT::Client::sslErrors, Q_NULLPTR, 0);
-    disconnect(m_client, &QMQTT::Client::disconnected, Q_NULLPTR, 0);
+    m_schema.clear();
+    m_schemaHash = 0;
+  }
 
+  if (encodingChanged || config.topic != m_config.topic)
+    m_datasetTopics.clear();
+
+  // Apply the new latency to the current batch
+  if (config.maxLatency != m_config.maxLatency && m_batchTimer->isActive())
+    m_batchTimer->start(config.maxLatency);
+
+  // Update settings
+  m_config = config;
+  m_spool.setMaxSize(static_cast<qint64>(config.spoolLimit) * 1024 * 1024);
+
+  // Set MQTT client options
+  m_client->setPort(config.port);
+  m_client->setWillQos(config.qos);
+  m_client->setHostName(config.host);
+  m_client->setUsername(config.username);
+  m_client->setWillRetain(config.retain);
+  m_client->setKeepAlive(config.keepAlive);
+  m_client->setAutoReconnect(config.spoolEnabled);
+  m_client->setPassword(config.password.toUtf8());
+  m_client->setVersion(config.mqttVersion == 0 ? QMQTT::V3_1_0
+                                               : QMQTT::V3_1_1);
+
+  // Update spool status
+  reportSpoolStatus();
+}
+
+/**
+ * Creates a new MQTT client instance with the given settings, this approach
+ * is required in order to allow the MQTT module to support both non-encrypted
+ * and TLS connections.
+ */
+void MQTT::ClientWorker::regenerateClient(
+    const ClientConfiguration &config, const bool ssl,
+    const QSslConfiguration &sslConfiguration)
+{
+  // There is an existing client, delete it from memory
+  if (m_client)
+  {
+    const auto connected = m_client->isConnectedToHost();
+    disconnect(m_client, Q_NULLPTR, this, Q_NULLPTR);
     m_client->disconnectFromHost();
     delete m_client;
+
+    if (connected)
+      Q_EMIT connectedChanged(false);
   }
 
-  // Configure MQTT client depending on SSL/TLS configuration
-  if (sslEnabled())
-    m_client = new QMQTT::Client(host, port, m_sslConfiguration);
+  // Configure MQTT client depending on SSL/TLS configuration, TLS clients
+  // need the host name to verify the certificate of the broker
+  if (ssl)
+    m_client = new QMQTT::Client(config.host, config.port, sslConfiguration);
   else
-    m_client = new QMQTT::Client(QHostAddress(host), port);
+    m_client = new QMQTT::Client(IO::HostCache::instance().address(config.host),
+                                 config.port);
 
-  // Set client ID
+  // Set client ID & options
   m_client->setClientId(qApp->applicationName());
-
-  // Set MQTT client options
-  m_client->setWillQos(qos);
-  m_client->setUsername(user);
-  m_client->setVersion(version);
-  m_client->setWillRetain(retain);
-  m_client->setWillRetain(retain);
-  m_client->setKeepAlive(keepAlive);
-  m_client->setPassword(password.toUtf8());
+  configure(config);
 
   // Connect signals/slots
   // clang-format off
     connect(m_client, &QMQTT::Client::error,
-            this, &MQTT::Client::onError);
+            this, &MQTT::ClientWorker::onError);
     connect(m_client, &QMQTT::Client::sslErrors,
-            this, &MQTT::Client::onSslErrors);
+            this, &MQTT::ClientWorker::onSslErrors);
     connect(m_client, &QMQTT::Client::received,
-            this, &MQTT::Client::onMessageReceived);
+            this, &MQTT::ClientWorker::onMessageReceived);
     connect(m_client, &QMQTT::Client::connected,
-            this, &MQTT::Client::connectedChanged);
-    connect(m_client, &QMQTT::Client::connected,
-            this, &MQTT::Client::onConnectedChanged);
+            this, &MQTT::ClientWorker::onConnected);
     connect(m_client, &QMQTT::Client::disconnected,
-            this, &MQTT::Client::connectedChanged);
-    connect(m_client, &QMQTT::Client::disconnected,
-            this, &MQTT::Client::onConnectedChanged);
+            this, &MQTT::ClientWorker::onDisconnected);
   // clang-format on
 }
+
+/**
+ * Publishes the current batch of frames to the MQTT broker
+ */
+void MQTT::ClientWorker::sendData()
+{
+  m_batchTimer->stop();
+  if (!m_batch.isEmpty())
+    publish(m_config.topic, m_batch);
+
+  m_batch.clear();
+  m_batchFrames = 0;
+}
+
+/**
+ * Publishes the next spooled messages, the number of messages published on
+ * each call is limited so that the configured drain rate is not exceeded.
+ */
+void MQTT::ClientWorker::drainSpool()
+{
+  Q_ASSERT(m_client);
+
+  // Publish the next spooled messages
+  if (m_client->isConnectedToHost())
+  {
+    Spool::Message stored;
+    const auto interval = m_drainTimer->interval();
+    const auto count = qMax(1, m_config.drainRate * interval / 1000);
+    for (int i = 0; i < count && m_spool.takeFirst(stored); ++i)
+    {
+      QMQTT::Message message(m_sentMessages, stored.topic, stored.payload, 0,
+                             stored.retain);
+      m_client->publish(message);
+      ++m_sentMessages;
+    }
+  }
+
+  // Stop draining once all stored messages have been published
+  if (m_spool.isEmpty())
+    m_drainTimer->stop();
+
+  reportSpoolStatus();
+}
+
+/**
+ * Sends the messages received since the last call to the main thread
+ */
+void MQTT::ClientWorker::flushReceived()
+{
+  m_receiveTimer->stop();
+  if (m_receivedData.isEmpty())
+    return;
+
+  Q_EMIT messagesReceived(m_receivedData, m_receivedFrames);
+  m_receivedData.clear();
+  m_receivedFrames.clear();
+}
+
+/**
+ * Subscribes to the MQTT topic when the connection is established & starts
+ * publishing the messages stored in the spool.
+ */
+void MQTT::ClientWorker::onConnected()
+{
+  Q_ASSERT(m_client);
+
+  m_client->subscribe(m_config.topic);
+  if (m_spool.isEmpty())
+    publishSchema();
+  else
+    m_drainTimer->start();
+
+  Q_EMIT connectedChanged(true);
+}
+
+/**
+ * Reports that the connection with the broker was closed or lost
+ */
+void MQTT::ClientWorker::onDisconnected()
+{
+  Q_EMIT connectedChanged(false);
+}
+
+/**
+ * Reports the given MQTT @a error to the main thread
+ */
+void MQTT::ClientWorker::onError(const QMQTT::ClientError error)
+{
+  Q_EMIT errorOccurred(static_cast<int>(error));
+}
+
+/**
+ * Displays the SSL errors that occur and allows the user to decide if he/she
+ * wants to ignore those errors. The message boxes are shown by the main
+ * thread, this function waits until the user has answered all of them.
+ */
+void MQTT::ClientWorker::onSslErrors(const QList<QSslError> &errors)
+{
+  Q_ASSERT(m_client);
+
+  // Ask the user what to do with each error
+  bool ignore = true;
+  QMetaObject::invokeMethod(
+      qApp,
+      [&] {
+        Q_FOREACH (auto error, errors)
+        {
+          auto ret = Misc::Utilities::showMessageBox(
+              tr("MQTT client SSL/TLS error, ignore?"), error.errorString(),
+              qApp->applicationName(),
+              QMessageBox::Ignore | QMessageBox::Abort);
+
+          if (ret == QMessageBox::Abort)
+          {
+            ignore = false;
+            break;
+          }
+        }
+      },
+      Qt::BlockingQueuedConnection);
+
+  // Ignore the errors or abort the connection
+  if (ignore)
+    m_client->ignoreSslErrors();
+  else
+    disconnectFromHost();
+}
+
+/**
+ * Reads the given MQTT @a message and registers the frames that it contains
+ * (one frame per line) if it was received on the subscribed topic.
+ */
+void MQTT::ClientWorker::onMessageReceived(const QMQTT::Message &message)
+{
+  // Ignore if client mode is not set to suscriber
+  if (m_config.clientMode != ClientSubscriber)
+    return;
+
+  // Ignore if topic is not equal to current topic
+  if (m_config.topic != message.topic())
+    return;
+
+  // Add EOL character
+  auto payload = message.payload();
+  if (!payload.endsWith('\n'))
+    payload.append('\n');
+
+  // Split the payload into frames
+  int start = 0;
+  int end = -1;
+  while ((end = payload.indexOf('\n', start)) >= 0)
+  {
+    auto length = end - start;
+    if (length > 0 && payload.at(end - 1) == '\r')
+      --length;
+
+    if (length > 0)
+      m_receivedFrames.append(payload.mid(start, length));
+
+    start = end + 1;
+  }
+
+  // Deliver the frames with the rest of the current burst
+  m_receivedData.append(payload);
+  if (m_receivedFrames.count() >= MQTT_MAX_RECEIVED_FRAMES)
+    flushReceived();
+  else if (!m_receiveTimer->isActive())
+    m_receiveTimer->start();
+}
+
+/**
+ * Encodes the given parsed @a frames with the selected payload encoding &
+ * registers them to the batch of frames that shall be published.
+ */
+void MQTT::ClientWorker::registerFrames(const QVector<JSON::Frame> &frames)
+{
+  // Ignore if raw frames are published
+  if (m_config.encoding == TextPayload || frames.isEmpty())
+    return;
+
+  // Ignore if device is not connected or mode is not set to publisher
+  if (!m_deviceConnected || m_config.clientMode != ClientPublisher)
+    return;
+
+  // Publish the datasets that changed
+  if (m_config.encoding == DatasetTopics)
+  {
+    Q_FOREACH (const auto &frame, frames)
+      publishDatasets(frame);
+
+    return;
+  }
+
+  // Encode frames, publish the schema when the frame structure changes
+  Q_FOREACH (const auto &frame, frames)
+  {
+    if (m_schema.isEmpty() || frame.schemaHash() != m_schemaHash)
+    {
+      sendData();
+
+      auto object = Plugins::Server::schema(frame);
+      object.insert("hash", QString::number(frame.schemaHash(), 16));
+      object.insert("encoding", m_config.encodingName);
+      m_schema = QJsonDocument(object).toJson(QJsonDocument::Compact);
+      m_schemaHash = frame.schemaHash();
+      publishSchema();
+    }
+
+    const auto time = IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp());
+    registerPayload(encodeFrame(frame, time));
+  }
+}
+
+/**
+ * Publishes the given alarm events (a UTF-8 @a json array) on the
+ * @c <topic>/alarms topic.
+ */
+void MQTT::ClientWorker::publishAlarms(const QByteArray &json)
+{
+  if (!m_client || m_config.clientMode != ClientPublisher)
+    return;
+
+  publish(m_config.topic + QStringLiteral("/alarms"), json);
+}
+
+/**
+ * Publishes the description of the current frame structure as a retained
+ * message on the @c <topic>/schema topic.
+ */
+void MQTT::ClientWorker::publishSchema()
+{
+  if (m_schema.isEmpty() || m_config.encoding == TextPayload)
+    return;
+
+  publish(m_config.topic + QStringLiteral("/schema"), m_schema, true);
+}
+
+/**
+ * Sends the number of spooled bytes & dropped messages to the main thread
+ */
+void MQTT::ClientWorker::reportSpoolStatus()
+{
+  const auto dropped = static_cast<qint64>(m_spool.droppedMessages());
+  Q_EMIT spoolStatusChanged(m_spool.size(), dropped);
+}
+
+/**
+ * Publishes the given encoded frame @a payload in its own message if per-frame
+ * publishing is enabled, otherwise, the payload is appended to the current
+ * batch, which is published as soon as it reaches the size or frame limit.
+ */
+void MQTT::ClientWorker::registerPayload(const QByteArray &payload)
+{
+  // Publish each frame in its own message
+  if (m_config.perFrame)
+  {
+    publish(m_config.topic, payload);
+    return;
+  }
+
+  // Publish the current batch if the frame does not fit in it
+  const auto size = payload.size();
+  if (m_config.maxBatchBytes > 0 && m_batchFrames > 0
+      && m_batch.size() + size > m_config.maxBatchBytes)
+    sendData();
+
+  // Start the latency timer with the first frame of the batch
+  if (m_batchFrames == 0)
+  {
+    m_batch.reserve(m_config.maxBatchBytes > 0 ? m_config.maxBatchBytes : size);
+    m_batchTimer->start(m_config.maxLatency);
+  }
+
+  // Register frame
+  m_batch.append(payload);
+  ++m_batchFrames;
+
+  // Publish the batch if it is full
+  const auto maxBytes = m_config.maxBatchBytes;
+  const auto maxFrames = m_config.maxBatchFrames;
+  if ((maxFrames > 0 && m_batchFrames >= maxFrames)
+      || (maxBytes > 0 && m_batch.size() >= maxBytes))
+    sendData();
+}
+
+/**
+ * Encodes the values of the given @a frame, received at the given
+ * @a timestamp, with the selected CBOR or packed payload encoding.
+ */
+QByteArray MQTT::ClientWorker::encodeFrame(const JSON::Frame &frame,
+                                           const qint64 timestamp)
+{
+  // Encode frame as a CBOR map
+  if (m_config.encoding == CborPayload)
+  {
+    QCborArray values;
+    for (int g = 0; g < frame.groupCount(); ++g)
+    {
+      const auto &group = frame.getGroup(g);
+      for (int d = 0; d < group.datasetCount(); ++d)
+      {
+        const auto &dataset = group.getDataset(d);
+        if (dataset.isNumeric())
+          values.append(dataset.numericValue());
+        else
+          values.append(dataset.value());
+      }
+    }
+
+    QCborMap map;
+    map.insert(QStringLiteral("t"), timestamp);
+    map.insert(QStringLiteral("v"), values);
+    return map.toCborValue().toCbor();
+  }
+
+  // Encode frame as a packed little-endian record
+  QByteArray record(12, Qt::Uninitialized);
+  quint32 count = 0;
+  for (int g = 0; g < frame.groupCount(); ++g)
+  {
+    const auto &group = frame.getGroup(g);
+    for (int d = 0; d < group.datasetCount(); ++d)
+    {
+      const auto &dataset = group.getDataset(d);
+      const double value = dataset.isNumeric() ? dataset.numericValue()
+                                               : qQNaN();
+
+      quint64 bits;
+      memcpy(&bits, &value, sizeof(bits));
+      bits = qToLittleEndian(bits);
+      record.append(reinterpret_cast<const char *>(&bits), sizeof(bits));
+      ++count;
+    }
+  }
+
+  qToLittleEndian<qint64>(timestamp, record.data());
+  qToLittleEndian<quint32>(count, record.data() + 8);
+  return record;
+}
+
+/**
+ * Publishes the value of each dataset of the given @a frame that changed since
+ * it was last published to its own retained topic. Numeric values are only
+ * published if they changed by more than the deadband.
+ */
+void MQTT::ClientWorker::publishDatasets(const JSON::Frame &frame)
+{
+  Q_ASSERT(m_client);
+
+  // Generate the topic names when the frame structure changes
+  if (m_datasetTopics.isEmpty() || frame.schemaHash() != m_schemaHash)
+  {
+    m_datasetTopics.clear();
+    m_schemaHash = frame.schemaHash();
+    for (int g = 0; g < frame.groupCount(); ++g)
+    {
+      const auto &group = frame.getGroup(g);
+      auto groupName = group.title();
+      groupName.replace(QRegularExpression("[/+#]"), "_");
+      for (int d = 0; d < group.datasetCount(); ++d)
+      {
+        auto datasetName = group.getDataset(d).title();
+        datasetName.replace(QRegularExpression("[/+#]"), "_");
+        m_datasetTopics.append(QStringLiteral("%1/%2/%3").arg(
+            m_config.topic, groupName, datasetName));
+      }
+    }
+
+    m_published.fill(false, m_datasetTopics.count());
+    m_lastNumbers.fill(0, m_datasetTopics.count());
+    m_lastValues.fill(QString(), m_datasetTopics.count());
+  }
+
+  // Publish the datasets that changed
+  int index = 0;
+  for (int g = 0; g < frame.groupCount(); ++g)
+  {
+    const auto &group = frame.getGroup(g);
+    for (int d = 0; d < group.datasetCount(); ++d, ++index)
+    {
+      // Check if the value changed
+      const auto &dataset = group.getDataset(d);
+      const auto value = dataset.value();
+      if (m_published.at(index))
+      {
+        if (dataset.isNumeric())
+        {
+          const auto delta = dataset.numericValue() - m_lastNumbers.at(index);
+          if (qAbs(delta) <= m_config.deadband)
+            continue;
+        }
+
+        else if (value == m_lastValues.at(index))
+          continue;
+      }
+
+      // Publish the value as a retained message
+      publish(m_datasetTopics.at(index), value.toUtf8(), true);
+
+      // Register the published value
+      m_published[index] = true;
+      m_lastValues[index] = value;
+      m_lastNumbers[index] = dataset.numericValue();
+    }
+  }
+}
+
+/**
+ * Publishes the given @a data in a new MQTT message on the given @a topic.
+ *
+ * If spooling is enabled & the connection with the broker was lost (or older
+ * messages are still waiting to be published), the message is stored in the
+ * spool instead.
+ */
+void MQTT::ClientWorker::publish(const QString &topic,
+                                 const QByteArray &data, const bool retain)
+{
+  Q_ASSERT(m_client);
+
+  // Store the message until it can be published in order
+  const auto connected = m_client->isConnectedToHost();
+  const auto pending = !connected || !m_spool.isEmpty();
+  if (m_config.spoolEnabled && m_sessionActive && pending)
+  {
+    m_spool.append({topic, data, retain});
+    if (!m_drainTimer->isActive())
+      m_drainTimer->start();
+
+    return;
+  }
+
+  // Broker is not reachable, discard the message
+  if (!connected)
+    return;
+
+  // Publish the message
+  QMQTT::Message message(m_sentMessages, topic, data, 0, retain);
+  m_client->publish(message);
+  ++m_sentMessages;
+}
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#include <QTimer>
 #include <QObject>
+#include <QThread>
 #include <QHostInfo>
 #include <QByteArray>
 #include <QHostAddress>
@@ -30,6 +32,16 @@
 
 #include <qmqtt.h>
 #include <DataTypes.h>
+#include <JSON/Frame.h>
+#include <JSON/AlarmEngine.h>
+#include <JSON/SinkGraph.h>
+#include <MQTT/Spool.h>
+
+/**
+ * Maximum number of received frames that are delivered to the I/O manager in
+ * a single batch
+ */
+#define MQTT_MAX_RECEIVED_FRAMES 1024
 
 namespace MQTT
 {
@@ -44,6 +56,69 @@ enum MQTTClientMode
   ClientSubscriber = 1
 };
 
+/**
+ * @brief The MQTTPayloadEncoding enum
+ *
+ * Specifies the format of the messages published by the MQTT client:
+ *
+ * - @c TextPayload: raw frames, one frame per line.
+ * - @c CborPayload: CBOR sequence with one map per parsed frame, containing
+ *   the reception time (@c t, ms since epoch) & an array with the typed
+ *   values of the frame (@c v), ordered by group & dataset.
+ * - @c PackedPayload: one record per parsed frame, each record contains a
+ *   little-endian @c u64 reception time, a @c u32 value count & the values as
+ *   @c f64 (non-numeric values are sent as NaN).
+ * - @c DatasetTopics: the value of each dataset is published as text in its
+ *   own retained message on the @c <topic>/<group>/<dataset> topic, only
+ *   when it changes (numeric values must change by more than the deadband).
+ *
+ * When a CBOR or packed encoding is used, a JSON description of the frame
+ * structure is published as a retained message on the @c <topic>/schema topic
+ * each time that the structure changes.
+ *
+ * Regardless of the encoding, the alarm events raised & cleared by the JSON
+ * generator are published as a JSON array on the @c <topic>/alarms topic.
+ */
+enum MQTTPayloadEncoding
+{
+  TextPayload = 0,
+  CborPayload = 1,
+  PackedPayload = 2,
+  DatasetTopics = 3
+};
+
+/**
+ * @brief The ClientConfiguration struct
+ *
+ * Copy of the settings of the MQTT client, the @c Client class sends it to
+ * the @c ClientWorker each time that a setting is changed.
+ */
+struct ClientConfiguration
+{
+  quint8 qos = 0;
+  bool retain = false;
+  quint16 port = 1883;
+  QString host = QStringLiteral("127.0.0.1");
+  QString topic;
+  QString username;
+  QString password;
+  quint16 keepAlive = 60;
+  int mqttVersion = 1;
+  int clientMode = ClientPublisher;
+  bool perFrame = false;
+  int maxLatency = 1000;
+  int maxBatchBytes = 256 * 1024;
+  int maxBatchFrames = 0;
+  int encoding = TextPayload;
+  QString encodingName;
+  double deadband = 0;
+  bool spoolEnabled = false;
+  int spoolLimit = 64;
+  int drainRate = 100;
+};
+
+class ClientWorker;
+
 /**
  * @brief The Client class
  *
@@ -58,8 +133,27 @@ enum MQTTClientMode
  * almost in real-time in another location, such as the "ground control" centre
  * or by the media team which streams the GCS display on the internet as the
  * mission is developing.
+ *
+ * In publisher mode, frames are accumulated in a batch that is published as
+ * a single message (one frame per line) as soon as any of the following
+ * conditions is met: the oldest frame in the batch has waited for
+ * @c maxLatency() milliseconds, the batch holds @c maxBatchBytes() bytes or
+ * the batch holds @c maxBatchFrames() frames. Alternatively, each frame can
+ * be published in its own message (see @c perFramePublishing()).
+ *
+ * If spooling is enabled, messages that are published while the connection
+ * with the broker is lost are stored in a disk-backed @c Spool. Once the
+ * connection is restored, the stored messages are published in order at no
+ * more than @c drainRate() messages per second, new messages are appended to
+ * the spool until it is empty so that the original order is preserved.
+ *
+ * The MQTT connection, batching, encoding & spooling are handled by a
+ * @c ClientWorker that runs in its own thread, so that TLS encryption &
+ * reconnections never block the user interface. This class only stores the
+ * settings & a snapshot of the connection status, which are safe to read from
+ * QML at any time.
  */
-class Client : public QObject
+class Client : public QObject, public JSON::FrameSink
 {
   // clang-format off
     Q_OBJECT
@@ -111,6 +205,48 @@ class Client : public QObject
                READ sslProtocol
                WRITE setSslProtocol
                NOTIFY sslProtocolChanged)
+    Q_PROPERTY(bool perFramePublishing
+               READ perFramePublishing
+               WRITE setPerFramePublishing
+               NOTIFY batchingChanged)
+    Q_PROPERTY(int maxLatency
+               READ maxLatency
+               WRITE setMaxLatency
+               NOTIFY batchingChanged)
+    Q_PROPERTY(int maxBatchBytes
+               READ maxBatchBytes
+               WRITE setMaxBatchBytes
+               NOTIFY batchingChanged)
+    Q_PROPERTY(int maxBatchFrames
+               READ maxBatchFrames
+               WRITE setMaxBatchFrames
+               NOTIFY batchingChanged)
+    Q_PROPERTY(int payloadEncoding
+               READ payloadEncoding
+               WRITE setPayloadEncoding
+               NOTIFY payloadEncodingChanged)
+    Q_PROPERTY(double deadband
+               READ deadband
+               WRITE setDeadband
+               NOTIFY deadbandChanged)
+    Q_PROPERTY(bool spoolEnabled
+               READ spoolEnabled
+               WRITE setSpoolEnabled
+               NOTIFY spoolChanged)
+    Q_PROPERTY(int spoolLimit
+               READ spoolLimit
+               WRITE setSpoolLimit
+               NOTIFY spoolChanged)
+    Q_PROPERTY(int drainRate
+               READ drainRate
+               WRITE setDrainRate
+               NOTIFY spoolChanged)
+    Q_PROPERTY(qint64 spooledBytes
+               READ spooledBytes
+               NOTIFY spoolStatusChanged)
+    Q_PROPERTY(qint64 droppedMessages
+               READ droppedMessages
+               NOTIFY spoolStatusChanged)
     Q_PROPERTY(bool isConnectedToHost
                READ isConnectedToHost
                NOTIFY connectedChanged)
@@ -123,6 +259,9 @@ class Client : public QObject
     Q_PROPERTY(StringList clientModes
                READ clientModes
                CONSTANT)
+    Q_PROPERTY(StringList payloadEncodings
+               READ payloadEncodings
+               CONSTANT)
     Q_PROPERTY(StringList qosLevels
                READ qosLevels
                CONSTANT)
@@ -146,6 +285,8 @@ Q_SIGNALS:
   void hostChanged();
   void topicChanged();
   void retainChanged();
+  void spoolChanged();
+  void batchingChanged();
   void usernameChanged();
   void passwordChanged();
   void keepAliveChanged();
@@ -156,6 +297,9 @@ Q_SIGNALS:
   void sslProtocolChanged();
   void mqttVersionChanged();
   void lookupActiveChanged();
+  void deadbandChanged();
+  void spoolStatusChanged();
+  void payloadEncodingChanged();
 
 private:
   explicit Client();
@@ -169,6 +313,9 @@ private:
 public:
   static Client &instance();
 
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
   quint8 qos() const;
   bool retain() const;
   quint16 port() const;
@@ -181,11 +328,23 @@ public:
   QString username() const;
   QString password() const;
   quint16 keepAlive() const;
+  int maxLatency() const;
+  int maxBatchBytes() const;
+  int maxBatchFrames() const;
+  bool perFramePublishing() const;
+  int payloadEncoding() const;
+  double deadband() const;
+  bool spoolEnabled() const;
+  int spoolLimit() const;
+  int drainRate() const;
+  qint64 spooledBytes() const;
+  qint64 droppedMessages() const;
   bool lookupActive() const;
   bool isSubscribed() const;
   bool isConnectedToHost() const;
 
   StringList qosLevels() const;
+  StringList payloadEncodings() const;
   StringList clientModes() const;
   StringList mqttVersions() const;
   StringList sslProtocols() const;
@@ -195,8 +354,10 @@ public:
   QString defaultHost() const { return "127.0.0.1"; }
 
 public Q_SLOTS:
+  void start();
   void loadCaFile();
   void connectToHost();
+  void closeConnection();
   void toggleConnection();
   void disconnectFromHost();
   void setQos(const quint8 qos);
@@ -213,30 +374,131 @@ public Q_SLOTS:
   void setPassword(const QString &password);
   void setKeepAlive(const quint16 keepAlive);
   void setMqttVersion(const int versionIndex);
+  void setMaxLatency(const int milliseconds);
+  void setMaxBatchBytes(const int bytes);
+  void setMaxBatchFrames(const int frames);
+  void setPerFramePublishing(const bool enabled);
+  void setPayloadEncoding(const int encoding);
+  void setDeadband(const double deadband);
+  void setSpoolEnabled(const bool enabled);
+  void setSpoolLimit(const int megabytes);
+  void setDrainRate(const int messagesPerSecond);
 
 private Q_SLOTS:
-  void sendData();
   void resetStatistics();
-  void onConnectedChanged();
+  void configureWorker();
+  void regenerateClient();
+  void onError(const int error);
   void lookupFinished(const QHostInfo &info);
+  void onConnectedChanged(const bool connected);
+  void onMessagesReceived(const QByteArray &data,
+                          const QVector<QByteArray> &frames);
+  void onParsedFramesReceived(const QVector<JSON::Frame> &frames);
+  void onAlarmsTriggered(const QVector<JSON::AlarmEvent> &events);
+  void onSpoolStatusChanged(const qint64 bytes, const qint64 dropped);
+
+private:
+  bool m_connected;
+  bool m_sslEnabled;
+  int m_sslProtocol;
+  bool m_lookupActive;
+  QString m_caFilePath;
+  qint64 m_spooledBytes;
+  qint64 m_droppedMessages;
+  ClientConfiguration m_config;
+  QSslConfiguration m_sslConfiguration;
+
+  QThread m_thread;
+  ClientWorker *m_worker;
+};
+
+/**
+ * @brief The ClientWorker class
+ *
+ * Worker object of the @c Client class, runs in its own thread and owns the
+ * @c QMQTT::Client instance, the batch of frames that is being built & the
+ * offline spool. Raw frames are read directly from the frame queue of the
+ * I/O manager, while parsed frames are delivered by the @c Client class.
+ *
+ * Connection changes, errors & received messages are reported through
+ * signals, which are delivered to the main thread through queued connections.
+ *
+ * In subscriber mode, each received payload is split into frames (one frame
+ * per line, as sent by a publisher that uses batches). Messages received in
+ * the same burst are delivered together, so that the main thread processes
+ * them with a single call regardless of the message rate.
+ */
+class ClientWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void errorOccurred(const int error);
+  void connectedChanged(const bool connected);
+  void messagesReceived(const QByteArray &data,
+                        const QVector<QByteArray> &frames);
+  void spoolStatusChanged(const qint64 bytes, const qint64 dropped);
+
+public:
+  ClientWorker();
+  ~ClientWorker();
+
+public Q_SLOTS:
+  void shutdown();
+  void readFrames();
+  void connectToHost();
+  void disconnectFromHost();
+  void setDeviceConnected(const bool connected);
+  void configure(const ClientConfiguration &config);
+  void registerFrames(const QVector<JSON::Frame> &frames);
+  void publishAlarms(const QByteArray &json);
+  void regenerateClient(const ClientConfiguration &config, const bool ssl,
+                        const QSslConfiguration &sslConfiguration);
+
+private Q_SLOTS:
+  void sendData();
+  void drainSpool();
+  void flushReceived();
+  void onConnected();
+  void onDisconnected();
   void onError(const QMQTT::ClientError error);
-  void onFrameReceived(const QByteArray &frame);
   void onSslErrors(const QList<QSslError> &errors);
   void onMessageReceived(const QMQTT::Message &message);
 
 private:
-  void regenerateClient();
+  void publishSchema();
+  void reportSpoolStatus();
+  void publishDatasets(const JSON::Frame &frame);
+  void registerPayload(const QByteArray &payload);
+  void publish(const QString &topic, const QByteArray &data,
+               const bool retain = false);
+  QByteArray encodeFrame(const JSON::Frame &frame, const qint64 timestamp);
 
 private:
-  QString m_topic;
-  bool m_sslEnabled;
-  int m_sslProtocol;
-  bool m_lookupActive;
-  QString m_caFilePath;
+  int m_frameConsumer;
   quint16 m_sentMessages;
-  MQTTClientMode m_clientMode;
-  QVector<QByteArray> m_frames;
-  QPointer<QMQTT::Client> m_client;
-  QSslConfiguration m_sslConfiguration;
+  bool m_deviceConnected;
+  ClientConfiguration m_config;
+
+  int m_batchFrames;
+  QByteArray m_batch;
+  QByteArray m_schema;
+  quint64 m_schemaHash;
+  QTimer *m_batchTimer;
+
+  QVector<bool> m_published;
+  QVector<double> m_lastNumbers;
+  QVector<QString> m_lastValues;
+  QVector<QString> m_datasetTopics;
+
+  Spool m_spool;
+  bool m_sessionActive;
+  QTimer *m_drainTimer;
+
+  QByteArray m_receivedData;
+  QTimer *m_receiveTimer;
+  QVector<QByteArray> m_receivedFrames;
+
+  QMQTT::Client *m_client;
 };
 } // namespace MQTT
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QtEndian>
+#include <QFileInfo>
+#include <QCoreApplication>
+
+#include <algorithm>
+
+#include <MQTT/Spool.h>
+
+/**
+ * Size of the record header (record length, flags & topic length)
+ */
+static constexpr int HEADER_SIZE = 4 + 1 + 2;
+
+/**
+ * Reads the length of the record stored at the current position of the given
+ * @a file. Returns -1 if no complete & valid record is available.
+ */
+static qint64 RECORD_LENGTH(QFile &file)
+{
+  char header[4];
+  const auto available = file.size() - file.pos();
+  if (available < HEADER_SIZE || file.peek(header, 4) != 4)
+    return -1;
+
+  const qint64 length = qFromLittleEndian<quint32>(header);
+  if (length < HEADER_SIZE || length > available)
+    return -1;
+
+  return length;
+}
+
+/**
+ * Returns the number of complete records stored in the given @a file after
+ * the given @a offset.
+ */
+static quint64 COUNT_RECORDS(const QString &path, const qint64 offset)
+{
+  QFile file(path);
+  if (!file.open(QFile::ReadOnly) || !file.seek(offset))
+    return 0;
+
+  quint64 count = 0;
+  qint64 length = 0;
+  while ((length = RECORD_LENGTH(file)) > 0 && file.seek(file.pos() + length))
+    ++count;
+
+  return count;
+}
+
+/**
+ * Constructor function, loads the segments stored in the given @a path. If no
+ * path is specified, the spool is stored in the application's documents
+ * folder.
+ */
+MQTT::Spool::Spool(const QString &path)
+  : m_path(path)
+  , m_size(0)
+  , m_maxSize(64 * 1024 * 1024)
+  , m_readOffset(0)
+  , m_droppedMessages(0)
+{
+  if (m_path.isEmpty())
+    m_path = QString("%1/Documents/%2/MQTT Spool/")
+                 .arg(QDir::homePath(), qApp->applicationName());
+
+  load();
+}
+
+/**
+ * Destructor function, saves the read position so that messages that have
+ * already been published are not published again in the next session.
+ */
+MQTT::Spool::~Spool()
+{
+  saveCursor();
+  closeSegments();
+}
+
+/**
+ * Returns the number of bytes stored in the spool that have not been read.
+ */
+qint64 MQTT::Spool::size() const
+{
+  return m_size;
+}
+
+/**
+ * Returns @c true if there are no messages waiting to be read.
+ */
+bool MQTT::Spool::isEmpty() const
+{
+  return m_size <= 0;
+}
+
+/**
+ * Returns the maximum number of bytes that the spool can hold on disk.
+ */
+qint64 MQTT::Spool::maxSize() const
+{
+  return m_maxSize;
+}
+
+/**
+ * Returns the number of messages that have been discarded because the spool
+ * was full since the spool was created.
+ */
+quint64 MQTT::Spool::droppedMessages() const
+{
+  return m_droppedMessages;
+}
+
+/**
+ * Deletes all the messages & segment files stored in the spool.
+ */
+void MQTT::Spool::clear()
+{
+  closeSegments();
+  Q_FOREACH (const auto id, m_segments)
+    QFile::remove(segmentPath(id));
+
+  QFile::remove(m_path + QStringLiteral("cursor"));
+
+  m_size = 0;
+  m_readOffset = 0;
+  m_segments.clear();
+}
+
+/**
+ * Changes the maximum number of bytes that the spool can hold on disk, the
+ * oldest segments are deleted if the spool is larger than the new limit.
+ */
+void MQTT::Spool::setMaxSize(const qint64 bytes)
+{
+  m_maxSize = qMax<qint64>(MQTT_SPOOL_SEGMENT_SIZE, bytes);
+  while (m_size > m_maxSize && !m_segments.isEmpty())
+    evictOldest();
+}
+
+/**
+ * Reads the oldest message stored in the spool & removes it from the queue.
+ * Returns @c false if there are no messages to read.
+ */
+bool MQTT::Spool::takeFirst(Message &message)
+{
+  while (!m_segments.isEmpty())
+  {
+    // Open the oldest segment
+    if (!m_reader.isOpen())
+    {
+      m_reader.setFileName(segmentPath(m_segments.first()));
+      if (!m_reader.open(QFile::ReadOnly | QFile::Unbuffered)
+          || !m_reader.seek(m_readOffset))
+      {
+        m_reader.close();
+        evictOldest();
+        continue;
+      }
+    }
+
+    // Read the next record of the segment
+    const auto length = RECORD_LENGTH(m_reader);
+    if (length > 0)
+    {
+      const auto record = m_reader.read(length);
+      if (record.length() == length)
+      {
+        const auto data = record.constData();
+        const quint16 topicLength = qFromLittleEndian<quint16>(data + 5);
+        if (HEADER_SIZE + topicLength <= length)
+        {
+          message.retain = data[4] & 0x01;
+          message.topic = QString::fromUtf8(data + HEADER_SIZE, topicLength);
+          message.payload = record.mid(HEADER_SIZE + topicLength);
+
+          m_size -= length;
+          m_readOffset += length;
+          return true;
+        }
+      }
+    }
+
+    // The segment that is being written has no more complete records
+    const bool writing = m_writer.isOpen();
+    if (writing && m_segments.count() == 1)
+      return false;
+
+    // Segment is exhausted or corrupted, delete it & read the next one
+    m_reader.close();
+    QFile::remove(segmentPath(m_segments.takeFirst()));
+
+    m_readOffset = 0;
+    m_size = 0;
+    Q_FOREACH (const auto id, m_segments)
+      m_size += QFileInfo(segmentPath(id)).size();
+
+    saveCursor();
+  }
+
+  return false;
+}
+
+/**
+ * Writes the given @a message at the end of the spool. The oldest segments
+ * are deleted if there is not enough space for the message.
+ *
+ * Returns @c false if the message could not be written.
+ */
+bool MQTT::Spool::append(const Message &message)
+{
+  // Encode the record
+  const auto topic = message.topic.toUtf8();
+  const qint64 length = HEADER_SIZE + topic.length() + message.payload.size();
+  if (topic.length() > 0xFFFF || length > m_maxSize)
+  {
+    ++m_droppedMessages;
+    return false;
+  }
+
+  QByteArray record(HEADER_SIZE, Qt::Uninitialized);
+  qToLittleEndian<quint32>(static_cast<quint32>(length), record.data());
+  record[4] = message.retain ? 0x01 : 0x00;
+  qToLittleEndian<quint16>(static_cast<quint16>(topic.length()),
+                           record.data() + 5);
+  record.append(topic);
+  record.append(message.payload);
+
+  // Make room for the record
+  while (m_size + length > m_maxSize && !m_segments.isEmpty())
+    evictOldest();
+
+  // Start a new segment when the current one is full
+  if (!m_writer.isOpen() || m_writer.size() + length > MQTT_SPOOL_SEGMENT_SIZE)
+  {
+    m_writer.close();
+    QDir().mkpath(m_path);
+
+    const quint32 id = m_segments.isEmpty() ? 0 : m_segments.last() + 1;
+    m_writer.setFileName(segmentPath(id));
+    if (!m_writer.open(QFile::WriteOnly | QFile::Truncate))
+    {
+      ++m_droppedMessages;
+      return false;
+    }
+
+    m_segments.append(id);
+  }
+
+  // Write the record to disk
+  if (m_writer.write(record) != record.size() || !m_writer.flush())
+  {
+    ++m_droppedMessages;
+    return false;
+  }
+
+  m_size += length;
+  return true;
+}
+
+/**
+ * Registers the segments stored in the spool folder & restores the read
+ * position saved by the previous session. New messages are always written to
+ * a new segment, so that a segment left incomplete by an unexpected
+ * termination is never appended to.
+ */
+void MQTT::Spool::load()
+{
+  // Get the segment files, sorted from oldest to newest
+  QDir dir(m_path);
+  const auto files = dir.entryList({"*.spool"}, QDir::Files);
+  Q_FOREACH (const auto &file, files)
+  {
+    bool ok = false;
+    const auto id = file.section('.', 0, 0).toUInt(&ok);
+    if (ok)
+      m_segments.append(id);
+  }
+
+  std::sort(m_segments.begin(), m_segments.end());
+  if (m_segments.isEmpty())
+    return;
+
+  // Restore the read position of the oldest segment
+  QFile cursor(m_path + QStringLiteral("cursor"));
+  if (cursor.open(QFile::ReadOnly))
+  {
+    const auto values = QString::fromUtf8(cursor.readAll()).split(' ');
+    if (values.count() == 2 && values.at(0).toUInt() == m_segments.first())
+      m_readOffset = qMax<qint64>(0, values.at(1).toLongLong());
+  }
+
+  // Calculate the number of bytes that have not been read
+  Q_FOREACH (const auto id, m_segments)
+    m_size += QFileInfo(segmentPath(id)).size();
+
+  m_size = qMax<qint64>(0, m_size - m_readOffset);
+}
+
+/**
+ * Saves the read position of the oldest segment to disk.
+ */
+void MQTT::Spool::saveCursor()
+{
+  if (m_segments.isEmpty())
+  {
+    QFile::remove(m_path + QStringLiteral("cursor"));
+    return;
+  }
+
+  QFile cursor(m_path + QStringLiteral("cursor"));
+  if (cursor.open(QFile::WriteOnly | QFile::Truncate))
+  {
+    const auto id = m_segments.first();
+    cursor.write(QStringLiteral("%1 %2").arg(id).arg(m_readOffset).toUtf8());
+  }
+}
+
+/**
+ * Deletes the oldest segment of the spool, registering the messages that were
+ * stored in it as dropped messages.
+ */
+void MQTT::Spool::evictOldest()
+{
+  // Only the segment that is being written is left, discard everything
+  if (m_segments.count() == 1)
+  {
+    const auto path = segmentPath(m_segments.first());
+    m_droppedMessages += COUNT_RECORDS(path, m_readOffset);
+    clear();
+    return;
+  }
+
+  // Delete the oldest segment
+  m_reader.close();
+  const auto path = segmentPath(m_segments.takeFirst());
+  const auto size = QFileInfo(path).size();
+  m_droppedMessages += COUNT_RECORDS(path, m_readOffset);
+  m_size = qMax<qint64>(0, m_size - (size - m_readOffset));
+  m_readOffset = 0;
+  QFile::remove(path);
+  saveCursor();
+}
+
+/**
+ * Closes the segment files that are being read & written.
+ */
+void MQTT::Spool::closeSegments()
+{
+  m_reader.close();
+  m_writer.close();
+}
+
+/**
+ * Returns the path of the segment file with the given @a id.
+ */
+QString MQTT::Spool::segmentPath(const quint32 id) const
+{
+  return m_path + QStringLiteral("%1.spool").arg(id, 10, 10, QChar('0'));
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * Maximum size of each spool segment file
+ */
+#define MQTT_SPOOL_SEGMENT_SIZE (1024 * 1024)
+
+namespace MQTT
+{
+/**
+ * @brief The Spool class
+ *
+ * Append-only, disk-backed queue used by the MQTT client to store outgoing
+ * messages while the connection with the broker is lost, so that they can be
+ * published once the connection is restored.
+ *
+ * Messages are written to a set of numbered segment files, each segment holds
+ * up to @c MQTT_SPOOL_SEGMENT_SIZE bytes. Segments are deleted once all their
+ * messages have been read, and the oldest segments are evicted when the total
+ * size of the spool exceeds @c maxSize().
+ *
+ * Each record is stored as a little-endian @c u32 record length, a @c u8 flag
+ * set (bit 0 is the retain flag), a little-endian @c u16 topic length, the
+ * UTF-8 topic & the message payload. The read position is saved when the
+ * spool is closed, messages that were read after the last save are published
+ * again if the application terminates unexpectedly.
+ */
+class Spool
+{
+public:
+  struct Message
+  {
+    QString topic;
+    QByteArray payload;
+    bool retain = false;
+  };
+
+  explicit Spool(const QString &path = QString());
+  ~Spool();
+
+  Spool(Spool &&) = delete;
+  Spool(const Spool &) = delete;
+  Spool &operator=(Spool &&) = delete;
+  Spool &operator=(const Spool &) = delete;
+
+  qint64 size() const;
+  bool isEmpty() const;
+  qint64 maxSize() const;
+  quint64 droppedMessages() const;
+
+  void clear();
+  void setMaxSize(const qint64 bytes);
+  bool takeFirst(Message &message);
+  bool append(const Message &message);
+
+private:
+  void load();
+  void saveCursor();
+  void evictOldest();
+  void closeSegments();
+  QString segmentPath(const quint32 id) const;
+
+private:
+  QString m_path;
+  qint64 m_size;
+  qint64 m_maxSize;
+  qint64 m_readOffset;
+  quint64 m_droppedMessages;
+
+  QFile m_reader;
+  QFile m_writer;
+  QVector<quint32> m_segments;
+};
+} // namespace MQTT
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QUrl>
+#include <QFile>
+#include <QDateTime>
+#include <QApplication>
+#include <QDesktopServices>
+
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
+#include <Misc/AlarmLog.h>
+
+/**
+ * Maximum number of events kept in memory for the user interface
+ */
+static const int MAX_EVENTS = 500;
+
+/**
+ * Constructor function, receives the alarm events of the JSON generator
+ */
+Misc::AlarmLog::AlarmLog()
+  : m_activeCount(0)
+{
+  connect(&JSON::Generator::instance(), &JSON::Generator::alarmsTriggered,
+          this, &Misc::AlarmLog::onAlarmsTriggered);
+  connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+          this, &Misc::AlarmLog::clear);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Misc::AlarmLog &Misc::AlarmLog::instance()
+{
+  static AlarmLog singleton;
+  return singleton;
+}
+
+/**
+ * Returns the number of alarms that are currently raised
+ */
+int Misc::AlarmLog::activeCount() const
+{
+  return m_activeCount;
+}
+
+/**
+ * Returns the most recent alarm events, the newest event goes first
+ */
+QStringList Misc::AlarmLog::events() const
+{
+  return m_events;
+}
+
+/**
+ * Returns the directory in which the alarm log files are created
+ */
+QString Misc::AlarmLog::directory() const
+{
+  return QString("%1/Documents/%2/Alarm Logs")
+      .arg(QDir::homePath(), qApp->applicationName());
+}
+
+/**
+ * Removes the events kept in memory, log files are not modified.
+ */
+void Misc::AlarmLog::clear()
+{
+  if (m_events.isEmpty() && m_activeCount == 0)
+    return;
+
+  m_events.clear();
+  m_activeCount = 0;
+  Q_EMIT eventsChanged();
+}
+
+/**
+ * Opens the directory in which the alarm log files are created
+ */
+void Misc::AlarmLog::openDirectory()
+{
+  QDir().mkpath(directory());
+  QDesktopServices::openUrl(QUrl::fromLocalFile(directory()));
+}
+
+/**
+ * Registers the given alarm @a events, updates the number of active alarms
+ * & appends the events to the log file of the current day.
+ */
+void Misc::AlarmLog::onAlarmsTriggered(const QVector<JSON::AlarmEvent> &events)
+{
+  // Format events & update active alarm count
+  QStringList lines;
+  for (const auto &event : events)
+  {
+    lines.append(format(event));
+    m_events.prepend(lines.last());
+    m_activeCount = qMax(0, m_activeCount + (event.active ? 1 : -1));
+  }
+
+  // Limit the number of events kept in memory
+  if (m_events.count() > MAX_EVENTS)
+    m_events.erase(m_events.begin() + MAX_EVENTS, m_events.end());
+
+  // Write events to disk & update UI
+  writeToFile(lines);
+  Q_EMIT eventsChanged();
+}
+
+/**
+ * Appends the given @a lines to the log file of the current day
+ */
+void Misc::AlarmLog::writeToFile(const QStringList &lines)
+{
+  // Create the log directory if required
+  const auto path = directory();
+  if (!QDir().mkpath(path))
+  {
+    qWarning() << "Cannot create alarm log directory" << path;
+    return;
+  }
+
+  // Open the log file of the current day
+  const auto date = QDate::currentDate().toString("yyyy-MM-dd");
+  QFile file(QString("%1/%2.log").arg(path, date));
+  if (!file.open(QFile::WriteOnly | QFile::Append | QFile::Text))
+  {
+    qWarning() << "Cannot open alarm log" << file.fileName();
+    return;
+  }
+
+  // Write events
+  file.write(lines.join('\n').toUtf8());
+  file.write("\n");
+  file.close();
+}
+
+/**
+ * Returns a single line of text that describes the given alarm @a event
+ */
+QString Misc::AlarmLog::format(const JSON::AlarmEvent &event)
+{
+  const auto time = QDateTime::fromMSecsSinceEpoch(
+      IO::FrameQueue::toMSecsSinceEpoch(event.timestamp));
+
+  return QString("%1  %2  %3  %4  value=%5  limit=%6")
+      .arg(time.toString(Qt::ISODateWithMs),
+           event.active ? QStringLiteral("RAISED ")
+                        : QStringLiteral("CLEARED"),
+           event.kindName(), event.title, QString::number(event.value),
+           QString::number(event.limit));
+}
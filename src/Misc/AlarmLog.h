@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QStringList>
+
+#include <JSON/AlarmEngine.h>
+
+namespace Misc
+{
+/**
+ * @brief The AlarmLog class
+ *
+ * Keeps a record of the alarm events raised & cleared by the alarm engine of
+ * the JSON generator. Each event is appended to a daily log file in the
+ * "Alarm Logs" directory, and the most recent events are kept in memory so
+ * that they can be displayed by the user interface.
+ *
+ * Alarm events are rare compared to the rate at which frames are received,
+ * so the log file is opened, written & closed for each batch of events.
+ */
+class AlarmLog : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int activeCount
+               READ activeCount
+               NOTIFY eventsChanged)
+    Q_PROPERTY(QStringList events
+               READ events
+               NOTIFY eventsChanged)
+    Q_PROPERTY(QString directory
+               READ directory
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void eventsChanged();
+
+private:
+  explicit AlarmLog();
+  AlarmLog(AlarmLog &&) = delete;
+  AlarmLog(const AlarmLog &) = delete;
+  AlarmLog &operator=(AlarmLog &&) = delete;
+  AlarmLog &operator=(const AlarmLog &) = delete;
+
+public:
+  static AlarmLog &instance();
+
+  int activeCount() const;
+  QStringList events() const;
+  QString directory() const;
+
+public Q_SLOTS:
+  void clear();
+  void openDirectory();
+
+private Q_SLOTS:
+  void onAlarmsTriggered(const QVector<JSON::AlarmEvent> &events);
+
+private:
+  void writeToFile(const QStringList &lines);
+  static QString format(const JSON::AlarmEvent &event);
+
+private:
+  int m_activeCount;
+  QStringList m_events;
+};
+} // namespace Misc
@@ -0,0 +1,799 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <functional>
+
+#include <QFile>
+#include <QtMath>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+#include <IO/Manager.h>
+#include <IO/Checksum.h>
+#include <IO/FrameQueue.h>
+#include <IO/FrameReader.h>
+#include <IO/DelimiterScanner.h>
+#include <IO/Framers/LengthPrefix.h>
+#include <CSV/Export.h>
+#include <UI/BatchFFT.h>
+#include <UI/Dashboard.h>
+#include <JSON/Generator.h>
+#include <JSON/FieldSplitter.h>
+#include <JSON/NmeaDecoder.h>
+#include <Project/Model.h>
+#include <Project/FrameParser.h>
+#include <Misc/Benchmark.h>
+#include <Misc/Utilities.h>
+#include <Misc/Diagnostics.h>
+#include <Misc/TimerEvents.h>
+
+#ifdef Q_OS_WIN
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#endif
+
+/**
+ * Number of frames generated in advance, the benchmark sends them in a loop
+ */
+static const int FRAME_COUNT = 1000;
+
+/**
+ * Number of datasets placed in each group of the synthetic project
+ */
+static const int GROUP_SIZE = 8;
+
+/**
+ * Maximum number of datasets, binary frames must fit a 16-bit length prefix
+ */
+static const int MAX_DATASETS = 2000;
+
+/**
+ * Time (in milliseconds) used to warm up the pipeline before measuring
+ */
+static const int WARMUP_TIME = 1000;
+
+/**
+ * Maximum number of frames handed to the pipeline in a single timer tick
+ */
+static const quint64 MAX_BATCH = 256;
+
+/**
+ * Maximum number of frames that can be waiting in the pipeline, no more frames
+ * are sent until the pipeline catches up
+ */
+static const quint64 MAX_BACKLOG = 10000;
+
+/**
+ * Minimum time (in nanoseconds) during which each micro-benchmark is run
+ */
+static const qint64 MICRO_BENCHMARK_TIME = 250 * 1000 * 1000;
+
+/**
+ * Prevents the compiler from discarding the results of the micro-benchmarks
+ */
+static volatile quint32 BENCHMARK_SINK = 0;
+
+/**
+ * Returns a project that describes frames with the given number of
+ * @a datasets, the given framing mode & the given @a checksum algorithm name.
+ */
+static QJsonObject PROJECT(const int datasets, const bool binary,
+                           const QString &checksum)
+{
+  // Create datasets, split in groups of GROUP_SIZE datasets
+  QJsonArray groups;
+  for (int i = 0; i < datasets; i += GROUP_SIZE)
+  {
+    QJsonArray array;
+    const int count = qMin(GROUP_SIZE, datasets - i);
+    for (int j = 0; j < count; ++j)
+    {
+      QJsonObject dataset;
+      dataset.insert("led", false);
+      dataset.insert("fft", false);
+      dataset.insert("log", false);
+      dataset.insert("title", QString("Dataset %1").arg(i + j + 1));
+      dataset.insert("units", "");
+      dataset.insert("graph", true);
+      dataset.insert("widget", "");
+      dataset.insert("min", -100);
+      dataset.insert("max", 100);
+      dataset.insert("alarm", 0);
+      dataset.insert("fftSamples", 1024);
+      dataset.insert("index", i + j + 1);
+      dataset.insert("value", "");
+      array.append(dataset);
+    }
+
+    QJsonObject group;
+    group.insert("title", QString("Group %1").arg(groups.count() + 1));
+    group.insert("widget", "");
+    group.insert("datasets", array);
+    groups.append(group);
+  }
+
+  // Create project
+  QJsonObject json;
+  json.insert("title", "Benchmark");
+  json.insert("separator", ",");
+  json.insert("frameStart", "/*");
+  json.insert("frameEnd", "*/");
+  json.insert("frameParser", Project::FrameParser::defaultCode());
+  json.insert("framing", binary ? "length16le" : "delimiters");
+  json.insert("checksum", checksum.isEmpty() ? QStringLiteral("auto")
+                                             : checksum);
+  json.insert("groups", groups);
+  return json;
+}
+
+/**
+ * Returns the comma-separated values of the frame at the given @a index, each
+ * of the @a datasets follows a sine wave with a different frequency.
+ */
+static QByteArray PAYLOAD(const int index, const int datasets,
+                          const int decimals)
+{
+  QByteArray payload;
+  for (int j = 0; j < datasets; ++j)
+  {
+    const double phase = 2 * M_PI * index * (j + 1) / FRAME_COUNT;
+    if (j > 0)
+      payload.append(',');
+
+    payload.append(QByteArray::number(100 * qSin(phase), 'f', decimals));
+  }
+
+  return payload;
+}
+
+/**
+ * Appends the checksum of the given @a payload (if any) & adds the frame
+ * delimiters or the 16-bit length prefix used for @a binary frames.
+ */
+static QByteArray ENCODE_FRAME(const QByteArray &payload,
+                               const IO::ChecksumAlgorithm algorithm,
+                               const bool binary)
+{
+  // Append checksum in big endian byte order
+  QByteArray frame = payload;
+  const int bytes = IO::checksumLength(algorithm);
+  if (bytes > 0)
+  {
+    const auto crc = IO::checksum(algorithm, payload.constData(),
+                                  payload.size());
+    for (int i = bytes - 1; i >= 0; --i)
+      frame.append(static_cast<char>((crc >> (8 * i)) & 0xFF));
+  }
+
+  // Add 16-bit little endian length prefix
+  if (binary)
+  {
+    const int length = frame.size();
+    frame.prepend(static_cast<char>((length >> 8) & 0xFF));
+    frame.prepend(static_cast<char>(length & 0xFF));
+    return frame;
+  }
+
+  // Add frame delimiters
+  return QByteArrayLiteral("/*") + frame + QByteArrayLiteral("*/");
+}
+
+/**
+ * Runs the given @a function repeatedly during at least
+ * @c MICRO_BENCHMARK_TIME, prints the average time spent per processed item
+ * (each call processes @a items items & @a bytes bytes) and returns the
+ * results as a JSON object.
+ */
+static QJsonObject MEASURE(const QString &name, const int items,
+                           const qint64 bytes,
+                           const std::function<void()> &function)
+{
+  // Warm up caches & lazy initializations
+  function();
+
+  // Run the function in batches of increasing size
+  qint64 calls = 0;
+  qint64 batch = 1;
+  QElapsedTimer timer;
+  timer.start();
+  while (timer.nsecsElapsed() < MICRO_BENCHMARK_TIME)
+  {
+    for (qint64 i = 0; i < batch; ++i)
+      function();
+
+    calls += batch;
+    batch = qMin<qint64>(batch * 2, 1024 * 1024);
+  }
+
+  // Calculate results
+  const double elapsed = timer.nsecsElapsed();
+  const double nsPerItem = elapsed / (calls * qMax(1, items));
+  const double throughput = bytes * calls / (elapsed / 1e9) / 1e6;
+
+  // Print results
+  auto line = QString("%1 %2 ns/item").arg(name, -40);
+  line = line.arg(nsPerItem, 12, 'f', 1);
+  if (bytes > 0)
+    line += QString(" %1 MB/s").arg(throughput, 10, 'f', 1);
+
+  qInfo().noquote() << line;
+
+  // Return results
+  QJsonObject result;
+  result.insert("name", name);
+  result.insert("calls", double(calls));
+  result.insert("nsPerItem", nsPerItem);
+  if (bytes > 0)
+    result.insert("throughput", throughput);
+
+  return result;
+}
+
+/**
+ * Constructor function
+ */
+Misc::Benchmark::Benchmark(const BenchmarkOptions &options)
+  : m_stream(-1)
+  , m_next(0)
+  , m_sentFrames(0)
+  , m_parsedFrames(0)
+  , m_startFrames(0)
+  , m_scheduledFrames(0)
+  , m_startCpuTime(0)
+  , m_payloadBytes(0)
+  , m_options(options)
+{
+  m_options.datasets = qBound(1, m_options.datasets, MAX_DATASETS);
+  m_options.duration = qMax(1, m_options.duration);
+  m_options.frameRate = qMax(0, m_options.frameRate);
+}
+
+/**
+ * Loads the synthetic project, generates the frames & starts sending them to
+ * the data pipeline. Returns @c false if the benchmark cannot be started.
+ */
+bool Misc::Benchmark::start()
+{
+  // Print messages to the console
+  Misc::Utilities::setHeadless(true);
+
+  // Load the synthetic project
+  if (!loadProject())
+    return false;
+
+  // Do not write the generated frames to the disk, unless soak testing
+  CSV::Export::instance().setExportEnabled(false);
+  if (m_options.soak.enabled)
+  {
+    m_soak.reset(new SoakMonitor(m_options.soak));
+    if (!m_soak->start())
+      return false;
+  }
+
+  // Disable resampling, every generated frame must reach the dashboard
+  JSON::Generator::instance().setResamplingMode(0);
+
+  // Count the frames that reach the end of the parsing stage
+  connect(&JSON::Generator::instance(), &JSON::Generator::framesChanged, this,
+          [=](const QVector<JSON::Frame> &frames) {
+            m_parsedFrames += frames.count();
+          });
+
+  // Initialize the dashboard & the timers that drive it
+  (void)UI::Dashboard::instance();
+  Misc::TimerEvents::instance().startTimers();
+
+  // Generate the frames & open a virtual device to send them
+  generateFrames();
+  m_stream = IO::Manager::instance().openStream("Benchmark");
+
+  // Print benchmark configuration
+  qInfo().noquote() << QString("Benchmarking %1 %2 frames/s, %3 datasets, "
+                               "%4 bytes per frame, checksum: %5")
+                           .arg(m_options.frameRate > 0
+                                    ? QString::number(m_options.frameRate)
+                                    : QStringLiteral("max."))
+                           .arg(m_options.binary ? "binary" : "text")
+                           .arg(m_options.datasets)
+                           .arg(m_payloadBytes / FRAME_COUNT)
+                           .arg(m_options.checksum.isEmpty()
+                                    ? QStringLiteral("none")
+                                    : m_options.checksum);
+
+  // Start sending frames
+  connect(&m_timer, &QTimer::timeout, this, &Misc::Benchmark::sendFrames);
+  m_timer.setTimerType(Qt::PreciseTimer);
+  m_timer.start(m_options.frameRate > 0 ? 1 : 0);
+  m_clock.start();
+
+  // Start measuring once the pipeline is warmed up
+  QTimer::singleShot(WARMUP_TIME, this, &Misc::Benchmark::beginMeasurement);
+  return true;
+}
+
+/**
+ * Hands the frames that are due (or as many frames as the pipeline is able to
+ * take if no frame rate is set) to the virtual device.
+ */
+void Misc::Benchmark::sendFrames()
+{
+  // Get number of frames that the pipeline can take
+  const auto backlog = m_sentFrames - qMin(m_sentFrames, m_parsedFrames);
+  const auto available = MAX_BACKLOG - qMin(MAX_BACKLOG, backlog);
+
+  // Get number of frames to send, frames that the pipeline cannot take are
+  // skipped so that the frame rate is not exceeded later on
+  quint64 count = MAX_BATCH;
+  if (m_options.frameRate > 0)
+  {
+    const auto elapsed = static_cast<quint64>(m_clock.nsecsElapsed());
+    const auto due = elapsed * m_options.frameRate / 1000000000;
+    count = due - qMin(due, m_scheduledFrames);
+    m_scheduledFrames = qMax(due, m_scheduledFrames);
+  }
+
+  // Concatenate frames
+  count = qMin(count, available);
+  if (count == 0)
+    return;
+
+  QByteArray data;
+  data.reserve(static_cast<int>(count) * (m_frames.first().size() + 8));
+  for (quint64 i = 0; i < count; ++i)
+  {
+    data.append(m_frames.at(m_next));
+    m_next = (m_next + 1) % m_frames.count();
+  }
+
+  // Send frames
+  m_sentFrames += count;
+  IO::Manager::instance().processStreamData(m_stream, data);
+}
+
+/**
+ * Resets the diagnostics counters & registers the initial frame count & CPU
+ * time once the warm-up period is over.
+ */
+void Misc::Benchmark::beginMeasurement()
+{
+  Misc::Diagnostics::instance().reset();
+
+  m_startCpuTime = cpuTime();
+  m_startFrames = m_parsedFrames;
+  m_measurement.start();
+
+  if (m_soak)
+    m_soak->beginSampling();
+
+  QTimer::singleShot(m_options.duration * 1000, this,
+                     &Misc::Benchmark::finish);
+}
+
+/**
+ * Stops sending frames, prints the results of the benchmark (and writes them
+ * to the report file, if any) & quits the application.
+ */
+void Misc::Benchmark::finish()
+{
+  // Stop sending frames
+  m_timer.stop();
+
+  // Calculate results
+  const auto elapsed = qMax<qint64>(1, m_measurement.nsecsElapsed());
+  const auto frames = m_parsedFrames - m_startFrames;
+  const auto cpu = cpuTime() - m_startCpuTime;
+  const auto memory = peakMemory();
+  const double seconds = elapsed / 1e9;
+  const double frameRate = frames / seconds;
+  const double cpuLoad = cpu / (seconds * 1e6) * 100;
+  const double cpuPerFrame = frames > 0 ? double(cpu) / frames : 0;
+
+  // Print results
+  qInfo().noquote() << QString("Parsed frames:  %1 in %2 s")
+                           .arg(frames)
+                           .arg(seconds, 0, 'f', 2);
+  qInfo().noquote() << QString("Frame rate:     %1 frames/s")
+                           .arg(frameRate, 0, 'f', 1);
+  qInfo().noquote() << QString("CPU time:       %1 us/frame (%2 % CPU)")
+                           .arg(cpuPerFrame, 0, 'f', 2)
+                           .arg(cpuLoad, 0, 'f', 1);
+  qInfo().noquote() << QString("Peak memory:    %1 MB")
+                           .arg(memory / (1024.0 * 1024.0), 0, 'f', 1);
+
+  // Evaluate the growth trends of the soak test
+  const bool passed = m_soak ? m_soak->evaluate() : true;
+
+  // Write report file
+  if (!m_options.report.isEmpty())
+  {
+    auto &diagnostics = Misc::Diagnostics::instance();
+    diagnostics.update();
+
+    QJsonObject options;
+    options.insert("frameRate", m_options.frameRate);
+    options.insert("datasets", m_options.datasets);
+    options.insert("frameSize", int(m_payloadBytes / FRAME_COUNT));
+    options.insert("binary", m_options.binary);
+    options.insert("checksum", m_options.checksum);
+    options.insert("duration", m_options.duration);
+
+    QJsonObject results;
+    results.insert("frames", double(frames));
+    results.insert("seconds", seconds);
+    results.insert("frameRate", frameRate);
+    results.insert("cpuPerFrame", cpuPerFrame);
+    results.insert("cpuLoad", cpuLoad);
+    results.insert("peakMemory", double(memory));
+
+    QJsonObject report;
+    report.insert("options", options);
+    report.insert("results", results);
+    report.insert("diagnostics", diagnostics.snapshot());
+    if (m_soak)
+      report.insert("soak", m_soak->report());
+
+    QFile file(m_options.report);
+    if (file.open(QFile::WriteOnly))
+    {
+      file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+      file.close();
+    }
+
+    else
+      qWarning() << "Cannot write benchmark report" << m_options.report;
+  }
+
+  // Release the virtual device & quit
+  IO::Manager::instance().closeStream(m_stream);
+  Misc::TimerEvents::instance().stopTimers();
+  QCoreApplication::exit(passed ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/**
+ * Measures the hot paths of the data pipeline in isolation: checksum
+ * algorithms, frame extraction with different framing & checksum settings,
+ * frame parsing, JSON frame decoding & dashboard plot updates with different
+ * point counts.
+ *
+ * The results are printed to the console and, if a @a report path is given,
+ * written to a JSON file so that results can be compared between builds.
+ */
+bool Misc::Benchmark::runMicroBenchmarks(const QString &report)
+{
+  // Print messages to the console
+  Misc::Utilities::setHeadless(true);
+  qInfo().noquote() << "Delimiter scanner:"
+                    << IO::DelimiterScanner::instructionSet();
+  qInfo().noquote() << "Batched FFT:" << UI::BatchFFT::instructionSet();
+
+  // Initialize parameters
+  QJsonArray results;
+  const int datasets = 16;
+  const auto project = PROJECT(datasets, false, QString());
+
+  // Checksum algorithms over 1 KiB blocks
+  QByteArray block(1024, Qt::Uninitialized);
+  for (int i = 0; i < block.size(); ++i)
+    block[i] = static_cast<char>(i * 31 + 7);
+
+  const QVector<QPair<QString, IO::ChecksumAlgorithm>> checksums
+      = {{"crc8", IO::ChecksumAlgorithm::CRC8},
+         {"crc16", IO::ChecksumAlgorithm::CRC16},
+         {"crc16-modbus", IO::ChecksumAlgorithm::CRC16_MODBUS},
+         {"crc16-ccitt", IO::ChecksumAlgorithm::CRC16_CCITT},
+         {"crc32", IO::ChecksumAlgorithm::CRC32},
+         {"crc32c", IO::ChecksumAlgorithm::CRC32C},
+         {"fletcher16", IO::ChecksumAlgorithm::Fletcher16},
+         {"xor8", IO::ChecksumAlgorithm::XOR8}};
+
+  Q_FOREACH (const auto &checksum, checksums)
+  {
+    const auto algorithm = checksum.second;
+    results.append(MEASURE("checksum/" + checksum.first + " (1 KiB)", 1,
+                           block.size(), [&] {
+                             BENCHMARK_SINK += IO::checksum(
+                                 algorithm, block.constData(), block.size());
+                           }));
+  }
+
+  // Generate streams of frames with different framing & checksum settings
+  QStringList frames;
+  QByteArray text, single, crc16, crc32, legacy, binary;
+  for (int i = 0; i < FRAME_COUNT; ++i)
+  {
+    const auto payload = PAYLOAD(i, datasets, 3);
+    frames.append(QString::fromUtf8(payload));
+    text.append(ENCODE_FRAME(payload, IO::ChecksumAlgorithm::None, false));
+    crc16.append(ENCODE_FRAME(payload, IO::ChecksumAlgorithm::CRC16, false));
+    crc32.append(ENCODE_FRAME(payload, IO::ChecksumAlgorithm::CRC32, false));
+    binary.append(ENCODE_FRAME(payload, IO::ChecksumAlgorithm::CRC32, true));
+    single.append('$' + payload + '\n');
+
+    const auto crc = IO::crc32(payload.constData(), payload.size());
+    legacy.append("/*" + payload + "*/crc32:");
+    for (int j = 3; j >= 0; --j)
+      legacy.append(static_cast<char>((crc >> (8 * j)) & 0xFF));
+  }
+
+  // Frame extraction, every call processes FRAME_COUNT frames
+  IO::FrameQueue queue;
+  auto extraction = [&](const QString &name, IO::FrameReader &reader,
+                        const QByteArray &data) {
+    results.append(MEASURE("framing/" + name, FRAME_COUNT, data.size(), [&] {
+      reader.processData(data, IO::FrameQueue::timestamp());
+    }));
+  };
+
+  IO::FrameReader textReader(&queue);
+  extraction("delimiters", textReader, text);
+
+  IO::FrameReader singleReader(&queue);
+  singleReader.setStartSequence("$");
+  singleReader.setFinishSequence("\n");
+  extraction("single-byte delimiters", singleReader, single);
+
+  IO::FrameReader crc16Reader(&queue);
+  crc16Reader.setChecksumAlgorithm(IO::ChecksumAlgorithm::CRC16);
+  extraction("delimiters + crc16", crc16Reader, crc16);
+
+  IO::FrameReader crc32Reader(&queue);
+  crc32Reader.setChecksumAlgorithm(IO::ChecksumAlgorithm::CRC32);
+  extraction("delimiters + crc32", crc32Reader, crc32);
+
+  IO::FrameReader legacyReader(&queue);
+  extraction("delimiters + crc32 header", legacyReader, legacy);
+
+  IO::FrameReader binaryReader(&queue);
+  binaryReader.setFramer(new IO::Framers::LengthPrefix(2, false));
+  binaryReader.setChecksumAlgorithm(IO::ChecksumAlgorithm::CRC32);
+  extraction("length prefix + crc32", binaryReader, binary);
+
+  // Frame parsing
+  const auto frame = frames.first();
+  const auto bytes = frame.toUtf8();
+  JSON::FieldSplitter splitter;
+  QVector<JSON::FieldSpan> fields;
+  results.append(MEASURE("parser/native split", 1, bytes.size(), [&] {
+    BENCHMARK_SINK += splitter.split(bytes, fields);
+  }));
+
+  JSON::NmeaDecoder nmea;
+  nmea.compile(QJsonValue(true));
+  QVector<double> nmeaValues;
+  const QByteArray sentence("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,"
+                            "545.4,M,46.9,M,,*47\r");
+  results.append(MEASURE("parser/nmea decode", 1, sentence.size(), [&] {
+    BENCHMARK_SINK += nmea.decode(sentence, nmeaValues);
+  }));
+
+  Project::FrameParser parser;
+  parser.load(Project::FrameParser::defaultCode());
+  results.append(MEASURE("parser/parse", 1, bytes.size(), [&] {
+    BENCHMARK_SINK += parser.parse(frame, ",").count();
+  }));
+
+  Project::FrameParser batchParser;
+  batchParser.load("function parse(frame, separator) {\n"
+                   "    return frame.split(separator);\n"
+                   "}\n"
+                   "function parseBatch(frames, separator) {\n"
+                   "    return frames.map(function(frame) {\n"
+                   "        return frame.split(separator);\n"
+                   "    });\n"
+                   "}\n");
+  results.append(MEASURE("parser/parseBatch", FRAME_COUNT, text.size(), [&] {
+    BENCHMARK_SINK += batchParser.parseBatch(frames, ",").count();
+  }));
+
+  // JSON frame decoding
+  results.append(MEASURE("frame/read (new frame)", 1, 0, [&] {
+    JSON::Frame decoded;
+    BENCHMARK_SINK += decoded.read(project);
+  }));
+
+  JSON::Frame jsonFrame;
+  results.append(MEASURE("frame/read (value update)", 1, 0, [&] {
+    BENCHMARK_SINK += jsonFrame.read(project);
+  }));
+
+  // Spectrum of 24 channels of 1024 samples, as a batch & one by one
+  const int fftSize = 1024;
+  const int fftChannels = 24;
+  const int fftBins = fftSize / 2 + 1;
+  UI::BatchFFT fft;
+  QVector<float> fftInput(fftSize * fftChannels);
+  QVector<float> fftRe(fftBins * fftChannels), fftIm(fftBins * fftChannels);
+  for (int i = 0; i < fftInput.count(); ++i)
+    fftInput[i] = static_cast<float>(qSin(i * 0.01) + 0.1 * (i % 7));
+
+  results.append(
+      MEASURE("fft/batch (24 x 1024)", fftChannels, 0, [&] {
+        fft.forward(fftSize, fftChannels, fftInput.constData(), Q_NULLPTR,
+                    fftRe.data(), fftIm.data());
+        BENCHMARK_SINK += static_cast<quint32>(fftRe.at(1));
+      }));
+  results.append(
+      MEASURE("fft/single channel (1024)", 1, 0, [&] {
+        fft.forward(fftSize, 1, fftInput.constData(), Q_NULLPTR,
+                    fftRe.data(), fftIm.data());
+        BENCHMARK_SINK += static_cast<quint32>(fftRe.at(1));
+      }));
+
+  // Dashboard plot updates with large point counts
+  auto &dashboard = UI::Dashboard::instance();
+  const QVector<JSON::Frame> batch(100, jsonFrame);
+  Q_FOREACH (const int points, QVector<int>({1000, 10000, 100000}))
+  {
+    dashboard.setPoints(points);
+    const auto name = QString("dashboard/processFrames (%1 points)");
+    results.append(MEASURE(name.arg(points), batch.count(), 0,
+                           [&] { dashboard.processFrames(batch); }));
+  }
+
+  dashboard.resetData();
+
+  // Write report file
+  if (!report.isEmpty())
+  {
+    QJsonObject json;
+    json.insert("instructionSet", IO::DelimiterScanner::instructionSet());
+    json.insert("fftInstructionSet", UI::BatchFFT::instructionSet());
+    json.insert("microBenchmarks", results);
+
+    QFile file(report);
+    if (!file.open(QFile::WriteOnly))
+    {
+      qWarning() << "Cannot write benchmark report" << report;
+      return false;
+    }
+
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Indented));
+    file.close();
+  }
+
+  return true;
+}
+
+/**
+ * Writes a project file that describes the synthetic frames & loads it with
+ * the project model & the JSON generator, just like a project selected by
+ * the user.
+ */
+bool Misc::Benchmark::loadProject()
+{
+  const auto json = PROJECT(m_options.datasets, m_options.binary,
+                            m_options.checksum);
+
+  // Write project file
+  if (!m_directory.isValid())
+  {
+    qCritical() << "Cannot create temporary benchmark directory";
+    return false;
+  }
+
+  QFile file(m_directory.filePath("Benchmark.json"));
+  if (!file.open(QFile::WriteOnly))
+  {
+    qCritical() << "Cannot write benchmark project" << file.fileName();
+    return false;
+  }
+
+  file.write(QJsonDocument(json).toJson(QJsonDocument::Indented));
+  file.close();
+
+  // Load project, this also configures the framing mode of the I/O manager
+  JSON::Generator::instance().setOperationMode(JSON::Generator::kManual);
+  Project::Model::instance().openJsonFile(file.fileName());
+
+  // Validate checksum algorithm
+  const auto &checksum = m_options.checksum;
+  const auto algorithm = IO::Manager::instance().checksumAlgorithm();
+  if (!checksum.isEmpty() && checksum != "auto"
+      && algorithm == IO::ChecksumAlgorithm::None)
+  {
+    qCritical() << "Unknown checksum algorithm" << checksum;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Generates @c FRAME_COUNT frames in which each dataset follows a sine wave
+ * with a different frequency. The number of decimals of each value is chosen
+ * so that the size of each frame approaches the requested frame size.
+ */
+void Misc::Benchmark::generateFrames()
+{
+  // Get number of decimals of each value
+  int decimals = 3;
+  if (m_options.frameSize > 0)
+    decimals = qBound(0, m_options.frameSize / m_options.datasets - 6, 15);
+
+  // Generate frames
+  m_frames.clear();
+  m_payloadBytes = 0;
+  m_frames.reserve(FRAME_COUNT);
+  const auto algorithm = IO::Manager::instance().checksumAlgorithm();
+  for (int i = 0; i < FRAME_COUNT; ++i)
+  {
+    const auto payload = PAYLOAD(i, m_options.datasets, decimals);
+    m_payloadBytes += payload.size();
+    m_frames.append(ENCODE_FRAME(payload, algorithm, m_options.binary));
+  }
+}
+
+/**
+ * Returns the CPU time (in microseconds) used by all the threads of the
+ * process since it was started.
+ */
+qint64 Misc::Benchmark::cpuTime()
+{
+#ifdef Q_OS_WIN
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    return 0;
+
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  return static_cast<qint64>((k.QuadPart + u.QuadPart) / 10);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  const auto &u = usage.ru_utime;
+  const auto &s = usage.ru_stime;
+  return qint64(u.tv_sec + s.tv_sec) * 1000000 + u.tv_usec + s.tv_usec;
+#endif
+}
+
+/**
+ * Returns the peak resident memory (in bytes) used by the process
+ */
+qint64 Misc::Benchmark::peakMemory()
+{
+#ifdef Q_OS_WIN
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+
+  return static_cast<qint64>(counters.PeakWorkingSetSize);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+#  ifdef Q_OS_MACOS
+  return static_cast<qint64>(usage.ru_maxrss);
+#  else
+  return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#  endif
+#endif
+}
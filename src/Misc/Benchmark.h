@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+#include <QTemporaryDir>
+
+#include <Misc/SoakMonitor.h>
+
+namespace Misc
+{
+/**
+ * @brief Configuration of the benchmark mode
+ *
+ * Describes the synthetic frames generated by the benchmark. A @c frameRate
+ * of zero generates frames as fast as the pipeline is able to process them.
+ * If @c soak is enabled, the benchmark runs as a soak test (see
+ * @c SoakMonitor).
+ */
+struct BenchmarkOptions
+{
+  int frameRate = 2000;
+  int datasets = 16;
+  int frameSize = 0;
+  bool binary = false;
+  QString checksum;
+  int duration = 10;
+  QString report;
+  SoakOptions soak;
+};
+
+/**
+ * @brief The Benchmark class
+ *
+ * Feeds synthetic frames through the real data pipeline (@c IO::Manager,
+ * @c JSON::Generator & @c UI::Dashboard) in-process and reports the sustained
+ * frame rate, the CPU time used per frame & the peak memory usage of the
+ * process.
+ *
+ * The benchmark writes a temporary project file that describes the synthetic
+ * frames (frame delimiters or a 16-bit length prefix for binary frames, and
+ * the selected checksum algorithm) and loads it like a regular project. The
+ * frames are generated in advance, so that the cost of generating data is not
+ * part of the measurements, and are handed to a virtual device opened with
+ * @c IO::Manager::openStream().
+ *
+ * The first second of the benchmark is used to warm up the pipeline and is
+ * not taken into account in the results.
+ *
+ * The class also implements a set of micro-benchmarks that measure the hot
+ * paths of the pipeline (frame extraction, checksums, frame parsing, JSON
+ * frame decoding & dashboard plot updates) in isolation, see
+ * @c runMicroBenchmarks().
+ *
+ * In soak mode, the benchmark also exercises the CSV export, MQTT, plugins
+ * server & dashboard widgets for the whole duration of the run, and fails if
+ * the health of the process degrades over time.
+ */
+class Benchmark : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit Benchmark(const BenchmarkOptions &options);
+
+  bool start();
+  static bool runMicroBenchmarks(const QString &report);
+
+  static qint64 cpuTime();
+  static qint64 peakMemory();
+
+private Q_SLOTS:
+  void sendFrames();
+  void beginMeasurement();
+  void finish();
+
+private:
+  bool loadProject();
+  void generateFrames();
+
+private:
+  int m_stream;
+  int m_next;
+  quint64 m_sentFrames;
+  quint64 m_parsedFrames;
+  quint64 m_startFrames;
+  quint64 m_scheduledFrames;
+  qint64 m_startCpuTime;
+  qint64 m_payloadBytes;
+
+  QTimer m_timer;
+  QTemporaryDir m_directory;
+  QElapsedTimer m_clock;
+  QElapsedTimer m_measurement;
+  BenchmarkOptions m_options;
+  QVector<QByteArray> m_frames;
+  QScopedPointer<SoakMonitor> m_soak;
+};
+} // namespace Misc
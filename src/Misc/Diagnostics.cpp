@@ -0,0 +1,607 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QClipboard>
+#include <QJsonArray>
+#include <QtAlgorithms>
+#include <QJsonDocument>
+#include <QGuiApplication>
+
+#include <IO/Console.h>
+#include <IO/Manager.h>
+#include <IO/CommandScheduler.h>
+#include <CSV/Export.h>
+#include <MQTT/Client.h>
+#include <InfluxDB/Client.h>
+#include <JSON/Generator.h>
+#include <Plugins/Server.h>
+#include <UI/Dashboard.h>
+#include <UI/DashboardWidget.h>
+#include <Misc/Utilities.h>
+#include <Misc/Diagnostics.h>
+#include <Misc/TimerEvents.h>
+
+#if defined(Q_OS_WIN)
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#  include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#  include <QFile>
+#  include <unistd.h>
+#endif
+
+/**
+ * Returns the index of the histogram bucket for a duration of @a nsecs, each
+ * bucket covers a power of two microseconds (bucket 0 holds durations below
+ * one microsecond).
+ */
+static int BUCKET(const quint64 nsecs, const int count)
+{
+  const quint64 usecs = nsecs / 1000;
+  if (usecs == 0)
+    return 0;
+
+  return qMin(count - 1, 64 - static_cast<int>(qCountLeadingZeroBits(usecs)));
+}
+
+/**
+ * Returns the upper bound (in microseconds) of the given histogram @a bucket
+ */
+static double BUCKET_LIMIT(const int bucket)
+{
+  return static_cast<double>(quint64(1) << bucket);
+}
+
+/**
+ * Constructor function, resets all counters & samples the queue depths once
+ * per second.
+ */
+Misc::Diagnostics::Diagnostics()
+{
+  reset();
+  connect(&TimerEvents::instance(), &TimerEvents::timeout1Hz, this,
+          &Misc::Diagnostics::update);
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Misc::Diagnostics &Misc::Diagnostics::instance()
+{
+  static Diagnostics singleton;
+  return singleton;
+}
+
+/**
+ * Returns the statistics of each pipeline stage, as sampled during the last
+ * call to @c update(). Each item is a map with the name of the stage, the
+ * number of measurements, the measurement rate (in Hz), the mean, maximum &
+ * percentile durations (in microseconds) and the histogram buckets.
+ */
+QVariantList Misc::Diagnostics::stages() const
+{
+  return m_stages;
+}
+
+/**
+ * Returns the depth & drop count of each queue of the pipeline, as sampled
+ * during the last call to @c update().
+ */
+QVariantList Misc::Diagnostics::queues() const
+{
+  return m_queues;
+}
+
+/**
+ * Returns the value of each event counter, as sampled during the last call to
+ * @c update().
+ */
+QVariantList Misc::Diagnostics::counters() const
+{
+  return m_counters;
+}
+
+/**
+ * Returns the number of bytes held by each subsystem, as sampled during the
+ * last call to @c updateMemory(). Each item is a map with the name of the
+ * subsystem & the number of bytes.
+ */
+QVariantList Misc::Diagnostics::memory() const
+{
+  return m_memory;
+}
+
+/**
+ * Returns the render cost of the ten most expensive dashboard widgets, as
+ * sampled during the last call to @c update(). Each item is a map with the
+ * title of the widget & the time (in microseconds) spent updating, grabbing
+ * & painting it.
+ */
+QVariantList Misc::Diagnostics::widgets() const
+{
+  return m_widgets;
+}
+
+/**
+ * Returns a JSON object with the stage statistics, queue depths, event
+ * counters, memory usage & widget render costs sampled during the last call to @c update(). This is
+ * the document that is sent to the plugins that subscribe to diagnostics data.
+ */
+QJsonObject Misc::Diagnostics::snapshot() const
+{
+  QJsonObject object;
+  object.insert("stages", QJsonArray::fromVariantList(m_stages));
+  object.insert("queues", QJsonArray::fromVariantList(m_queues));
+  object.insert("counters", QJsonArray::fromVariantList(m_counters));
+  object.insert("memory", QJsonArray::fromVariantList(m_memory));
+  object.insert("widgets", QJsonArray::fromVariantList(m_widgets));
+  return object;
+}
+
+/**
+ * Returns a plain-text table with the memory held by each subsystem, used to
+ * print the memory usage to the console in headless mode.
+ */
+QString Misc::Diagnostics::memoryReport() const
+{
+  QStringList lines;
+  Q_FOREACH (const auto &item, m_memory)
+  {
+    const auto map = item.toMap();
+    const auto bytes = map.value("bytes").toLongLong();
+    lines.append(QString("%1 %2 KB")
+                     .arg(map.value("name").toString() + ":", -32)
+                     .arg(bytes / 1024.0, 12, 'f', 1));
+  }
+
+  return lines.join('\n');
+}
+
+/**
+ * Registers that the given pipeline @a stage took @a nsecs nanoseconds
+ */
+void Misc::Diagnostics::record(const Stage stage, const qint64 nsecs)
+{
+  // Validate arguments
+  const int index = static_cast<int>(stage);
+  if (index < 0 || index >= static_cast<int>(Stage::StageCount))
+    return;
+
+  // Update count, total & histogram
+  auto &histogram = m_histograms[index];
+  const quint64 value = static_cast<quint64>(qMax<qint64>(0, nsecs));
+  histogram.count.fetch_add(1, std::memory_order_relaxed);
+  histogram.total.fetch_add(value, std::memory_order_relaxed);
+  histogram.buckets[BUCKET(value, BucketCount)].fetch_add(
+      1, std::memory_order_relaxed);
+
+  // Update maximum
+  auto maximum = histogram.maximum.load(std::memory_order_relaxed);
+  while (value > maximum
+         && !histogram.maximum.compare_exchange_weak(
+             maximum, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+/**
+ * Increments the given event @a counter by @a value
+ */
+void Misc::Diagnostics::increment(const Counter counter, const quint64 value)
+{
+  const int index = static_cast<int>(counter);
+  if (index >= 0 && index < static_cast<int>(Counter::CounterCount))
+    m_events[index].fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * Registers the time elapsed between the given @a timestamp (obtained with
+ * @c IO::FrameQueue::timestamp()) and the current time for the given
+ * @a stage. Timestamps equal to zero (data not received from a device) are
+ * ignored.
+ */
+void Misc::Diagnostics::recordLatency(const Stage stage, const qint64 timestamp)
+{
+  if (timestamp > 0)
+    record(stage, (IO::FrameQueue::timestamp() - timestamp) * 1000);
+}
+
+/**
+ * Clears all the measurements & counters
+ */
+void Misc::Diagnostics::reset()
+{
+  for (int i = 0; i < static_cast<int>(Stage::StageCount); ++i)
+  {
+    m_lastCounts[i] = 0;
+    m_histograms[i].count = 0;
+    m_histograms[i].total = 0;
+    m_histograms[i].maximum = 0;
+    for (int j = 0; j < BucketCount; ++j)
+      m_histograms[i].buckets[j] = 0;
+  }
+
+  for (int i = 0; i < static_cast<int>(Counter::CounterCount); ++i)
+    m_events[i] = 0;
+
+  m_rateTimer.start();
+}
+
+/**
+ * Samples the stage statistics, queue depths & event counters and notifies
+ * the user interface.
+ */
+void Misc::Diagnostics::update()
+{
+  // Get time elapsed since the last update
+  const auto elapsed = qMax<qint64>(1, m_rateTimer.restart());
+
+  // Sample the statistics of each stage
+  m_stages.clear();
+  for (int i = 0; i < static_cast<int>(Stage::StageCount); ++i)
+  {
+    // Copy the histogram
+    quint64 buckets[BucketCount];
+    const auto &histogram = m_histograms[i];
+    for (int j = 0; j < BucketCount; ++j)
+      buckets[j] = histogram.buckets[j].load(std::memory_order_relaxed);
+
+    // Obtain count & measurement rate
+    const auto count = histogram.count.load(std::memory_order_relaxed);
+    const auto rate = (count - m_lastCounts[i]) * 1000.0 / elapsed;
+    m_lastCounts[i] = count;
+
+    // Obtain durations in microseconds
+    const auto total = histogram.total.load(std::memory_order_relaxed);
+    const auto max = histogram.maximum.load(std::memory_order_relaxed);
+    const auto mean = count > 0 ? total / 1000.0 / count : 0.0;
+
+    // Register stage statistics
+    QVariantList list;
+    for (int j = 0; j < BucketCount; ++j)
+      list.append(buckets[j]);
+
+    QVariantMap map;
+    map.insert("name", stageName(static_cast<Stage>(i)));
+    map.insert("count", count);
+    map.insert("rate", rate);
+    map.insert("mean", mean);
+    map.insert("max", max / 1000.0);
+    map.insert("p50", percentile(buckets, count, 0.50));
+    map.insert("p95", percentile(buckets, count, 0.95));
+    map.insert("p99", percentile(buckets, count, 0.99));
+    map.insert("histogram", list);
+    m_stages.append(map);
+  }
+
+  // Sample the lag of each frame queue consumer
+  m_queues.clear();
+  const auto &queue = IO::Manager::instance().frameQueue();
+  for (int i = 0; i < queue.consumerCount(); ++i)
+  {
+    QVariantMap map;
+    map.insert("name", tr("Frame queue (%1)").arg(queue.consumerName(i)));
+    map.insert("depth", queue.lag(i));
+    map.insert("unit", tr("frames"));
+    map.insert("dropped", queue.dropped(i));
+    m_queues.append(map);
+  }
+
+  // Sample the outbox of the JSON generator, only the frames published to
+  // the live consumers can be dropped
+  auto &generator = JSON::Generator::instance();
+  const auto displayDropped
+      = m_events[static_cast<int>(Counter::DisplayFramesDropped)].load(
+          std::memory_order_relaxed);
+  QVariantMap delivery;
+  delivery.insert("name", tr("Frame delivery"));
+  delivery.insert("depth", generator.queuedFrames());
+  delivery.insert("unit", tr("frames"));
+  delivery.insert("dropped", displayDropped);
+  m_queues.append(delivery);
+
+  // Sample the outgoing queue of the I/O manager
+  const auto &writeQueue = IO::Manager::instance().writeQueue();
+  QVariantMap writes;
+  writes.insert("name", tr("Write queue"));
+  writes.insert("depth", writeQueue.queuedBytes());
+  writes.insert("unit", tr("bytes"));
+  writes.insert("dropped", writeQueue.rejectedBytes());
+  m_queues.append(writes);
+
+  // Sample the responses awaited by the command scheduler
+  const auto &scheduler = IO::CommandScheduler::instance();
+  QVariantMap commands;
+  commands.insert("name", tr("Scheduled commands"));
+  commands.insert("depth", scheduler.pendingResponses());
+  commands.insert("unit", tr("responses"));
+  commands.insert("dropped", scheduler.timeouts());
+  m_queues.append(commands);
+
+  // Sample the queues of the sinks that run in the worker pool
+  m_queues.append(generator.sinks().queues());
+
+  // Sample the CSV export queue, recorded frames are never dropped
+  QVariantMap csv;
+  csv.insert("name", tr("CSV export"));
+  csv.insert("depth", CSV::Export::instance().queuedBytes());
+  csv.insert("unit", tr("bytes"));
+  csv.insert("dropped", 0);
+  m_queues.append(csv);
+
+  // Sample the MQTT spool
+  QVariantMap mqtt;
+  mqtt.insert("name", tr("MQTT spool"));
+  mqtt.insert("depth", MQTT::Client::instance().spooledBytes());
+  mqtt.insert("unit", tr("bytes"));
+  mqtt.insert("dropped", MQTT::Client::instance().droppedMessages());
+  m_queues.append(mqtt);
+
+  // Sample the InfluxDB spool
+  QVariantMap influx;
+  influx.insert("name", tr("InfluxDB spool"));
+  influx.insert("depth", InfluxDB::Client::instance().spooledBytes());
+  influx.insert("unit", tr("bytes"));
+  influx.insert("dropped", InfluxDB::Client::instance().droppedBatches());
+  m_queues.append(influx);
+
+  // Sample the queues of the connected plugins
+  qint64 pluginBytes = 0;
+  quint64 pluginDropped = 0;
+  Q_FOREACH (const auto &client, Plugins::Server::instance().clients())
+  {
+    const auto map = client.toMap();
+    pluginBytes += map.value("queuedBytes").toLongLong();
+    pluginDropped += map.value("dropped").toULongLong();
+  }
+
+  QVariantMap plugins;
+  plugins.insert("name", tr("Plugins"));
+  plugins.insert("depth", pluginBytes);
+  plugins.insert("unit", tr("bytes"));
+  plugins.insert("dropped", pluginDropped);
+  m_queues.append(plugins);
+
+  // Sample the memory held by each subsystem
+  updateMemory();
+
+  // Sample the event counters
+  m_counters.clear();
+  QVariantMap published;
+  published.insert("name", tr("Frames published"));
+  published.insert("value", queue.published());
+  m_counters.append(published);
+  for (int i = 0; i < static_cast<int>(Counter::CounterCount); ++i)
+  {
+    QVariantMap map;
+    map.insert("name", counterName(static_cast<Counter>(i)));
+    map.insert("value", m_events[i].load(std::memory_order_relaxed));
+    m_counters.append(map);
+  }
+
+  // Sample the render cost of the most expensive widgets
+  m_widgets = UI::DashboardWidget::renderCosts().mid(0, 10);
+
+  // Update user interface
+  Q_EMIT updated();
+}
+
+/**
+ * Samples the number of bytes held by the buffers & queues of each subsystem.
+ *
+ * The dashboard & the console are not sampled in headless mode, since they
+ * are not used (and would otherwise be constructed by this function). The
+ * difference between the resident memory of the process & the accounted
+ * memory is reported as a separate item.
+ */
+void Misc::Diagnostics::updateMemory()
+{
+  // Get the memory held by each subsystem
+  QVector<QPair<QString, qint64>> items;
+  if (!Misc::Utilities::headless())
+  {
+    const auto &console = IO::Console::instance();
+    items.append({tr("Console text"), console.lineStore().allocatedBytes()});
+    const auto &dashboard = UI::Dashboard::instance();
+    items.append({tr("Dashboard history"), dashboard.allocatedBytes()});
+  }
+
+  auto &io = IO::Manager::instance();
+  items.append({tr("Frame queue"), io.frameQueue().capacity()});
+  items.append({tr("Write queue"), io.writeQueue().queuedBytes()});
+  items.append({tr("CSV export queue"), CSV::Export::instance().queuedBytes()});
+  items.append({tr("MQTT spool"), MQTT::Client::instance().spooledBytes()});
+  items.append(
+      {tr("InfluxDB spool"), InfluxDB::Client::instance().spooledBytes()});
+
+  // Get the memory held by the send queues & sockets of the plugins
+  qint64 pluginBytes = 0;
+  Q_FOREACH (const auto &client, Plugins::Server::instance().clients())
+    pluginBytes += client.toMap().value("queuedBytes").toLongLong();
+
+  items.append({tr("Plugin sockets"), pluginBytes});
+
+  // Register the memory of each subsystem
+  qint64 accounted = 0;
+  m_memory.clear();
+  for (const auto &item : items)
+  {
+    QVariantMap map;
+    map.insert("name", item.first);
+    map.insert("bytes", item.second);
+    m_memory.append(map);
+    accounted += item.second;
+  }
+
+  // Register the memory that is not held by any of the subsystems
+  const auto resident = residentMemory();
+  if (resident > 0)
+  {
+    QVariantMap other;
+    other.insert("name", tr("Other (QML scene, code & libraries)"));
+    other.insert("bytes", qMax<qint64>(0, resident - accounted));
+    m_memory.append(other);
+
+    QVariantMap total;
+    total.insert("name", tr("Process (resident)"));
+    total.insert("bytes", resident);
+    m_memory.append(total);
+  }
+}
+
+/**
+ * Copies the latest statistics (see @c snapshot()) to the clipboard as an
+ * indented JSON document, so that they can be attached to bug reports.
+ */
+void Misc::Diagnostics::copySnapshot()
+{
+  const QJsonDocument document(snapshot());
+  const auto json = QString::fromUtf8(document.toJson(QJsonDocument::Indented));
+  QGuiApplication::clipboard()->setText(json);
+}
+
+/**
+ * Returns the user-visible name of the given pipeline @a stage
+ */
+QString Misc::Diagnostics::stageName(const Stage stage)
+{
+  switch (stage)
+  {
+    case Stage::Reception:
+      return tr("Reception queue");
+    case Stage::Framing:
+      return tr("Framing");
+    case Stage::Parsing:
+      return tr("Parsing");
+    case Stage::FrameLatency:
+      return tr("Frame latency");
+    case Stage::DashboardUpdate:
+      return tr("Dashboard update");
+    case Stage::Rendering:
+      return tr("Widget rendering");
+    case Stage::DisplayLatency:
+      return tr("Display latency");
+    case Stage::ProbeArrival:
+      return tr("Probe echo arrival");
+    case Stage::ProbeParsing:
+      return tr("Probe echo parsed");
+    case Stage::ProbeRendering:
+      return tr("Probe echo rendered");
+    default:
+      return QString();
+  }
+}
+
+/**
+ * Returns the user-visible name of the given event @a counter
+ */
+QString Misc::Diagnostics::counterName(const Counter counter)
+{
+  switch (counter)
+  {
+    case Counter::InvalidFrames:
+      return tr("Invalid frames");
+    case Counter::BufferOverflows:
+      return tr("Framing buffer overflows");
+    case Counter::CsvWriteStalls:
+      return tr("CSV write stalls");
+    case Counter::DisplayFramesDropped:
+      return tr("Display frames dropped");
+    case Counter::ProbesLost:
+      return tr("Latency probes lost");
+    case Counter::FramesLost:
+      return tr("Frames lost (sequence gaps)");
+    case Counter::FramesDuplicated:
+      return tr("Frames duplicated");
+    case Counter::FramesReordered:
+      return tr("Frames reordered");
+    default:
+      return QString();
+  }
+}
+
+/**
+ * Returns the resident memory (in bytes) of the process, or 0 if it cannot
+ * be obtained on the current platform.
+ */
+qint64 Misc::Diagnostics::residentMemory()
+{
+#if defined(Q_OS_WIN)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+
+  return static_cast<qint64>(counters.WorkingSetSize);
+#elif defined(Q_OS_MACOS)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                reinterpret_cast<task_info_t>(&info), &count)
+      != KERN_SUCCESS)
+    return 0;
+
+  return static_cast<qint64>(info.resident_size);
+#elif defined(Q_OS_LINUX)
+  QFile file(QStringLiteral("/proc/self/statm"));
+  if (!file.open(QFile::ReadOnly))
+    return 0;
+
+  const auto fields = file.readAll().split(' ');
+  if (fields.count() < 2)
+    return 0;
+
+  return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Estimates the duration (in microseconds) below which the given @a fraction
+ * of the @a count measurements stored in the histogram @a buckets fall. The
+ * position inside the bucket is linearly interpolated.
+ */
+double Misc::Diagnostics::percentile(const quint64 *buckets,
+                                     const quint64 count,
+                                     const double fraction)
+{
+  if (count == 0)
+    return 0;
+
+  quint64 accumulated = 0;
+  const double target = fraction * count;
+  for (int i = 0; i < BucketCount; ++i)
+  {
+    if (buckets[i] > 0 && accumulated + buckets[i] >= target)
+    {
+      const double lower = i > 0 ? BUCKET_LIMIT(i - 1) : 0;
+      const double upper = BUCKET_LIMIT(i);
+      const double position = (target - accumulated) / buckets[i];
+      return lower + (upper - lower) * position;
+    }
+
+    accumulated += buckets[i];
+  }
+
+  return BUCKET_LIMIT(BucketCount - 1);
+}
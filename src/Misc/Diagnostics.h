@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <QObject>
+#include <QJsonObject>
+#include <QVariantList>
+#include <QElapsedTimer>
+
+namespace Misc
+{
+/**
+ * @brief The Diagnostics class
+ *
+ * Collects performance counters of the data pipeline, so that users can see
+ * where time goes when sizing hardware or reporting regressions.
+ *
+ * Each stage of the pipeline reports how long it took with @c record(), the
+ * durations are stored in a logarithmic histogram (one bucket per power of two
+ * microseconds) from which the mean, maximum & percentiles are obtained. The
+ * recorded stages are:
+ *
+ * - @c Reception: time between the driver reading data & the frame reader
+ *   starting to process it (i.e. time spent in the queue of the I/O thread).
+ * - @c Framing: time spent extracting frames from each block of data.
+ * - @c Parsing: time spent parsing each batch of frames.
+ * - @c FrameLatency: time between the reception of a frame & the moment in
+ *   which its parsed data is delivered to the rest of the application.
+ * - @c DashboardUpdate: time spent registering each batch of frames in the
+ *   dashboard.
+ * - @c Rendering: time spent updating the dashboard widgets.
+ * - @c DisplayLatency: time between the reception of the latest frame & the
+ *   moment in which the dashboard widgets are updated with it.
+ * - @c ProbeArrival, @c ProbeParsing & @c ProbeRendering: round-trip times
+ *   of the pings echoed by the device, from the moment in which each ping is
+ *   sent until its echo is received, parsed & displayed (see
+ *   @c IO::LatencyProbe).
+ *
+ * Event counters (e.g. invalid frames, or the frames lost, duplicated &
+ * reordered according to the sequence counters of the project, see
+ * @c JSON::SequenceTracker) are reported with @c increment(), and
+ * queue depths & drop counts (frame queue consumers, frame delivery, CSV
+ * export, MQTT & plugins) are sampled once per second. Recording stages
+ * (frame delivery to the recorders & CSV export) never drop frames, they
+ * report the number of times that they had to wait instead.
+ *
+ * The memory held by the buffers & queues of each subsystem (console text,
+ * dashboard history, CSV export, MQTT & InfluxDB spools, plugin sockets, etc.)
+ * is also sampled once per second (see @c memory()). The remainder of the
+ * resident memory of the process (QML scene, code & libraries, allocator
+ * overhead) is reported as a separate item, so that growth can be attributed
+ * to a subsystem or ruled out.
+ *
+ * The render cost of the most expensive dashboard widgets (time spent
+ * updating, grabbing & painting each widget) is also sampled once per second
+ * (see @c widgets()), so that slow widgets can be identified.
+ *
+ * All counters are lock-free atomics, so any thread can report measurements
+ * without interfering with the others.
+ */
+class Diagnostics : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QVariantList stages
+               READ stages
+               NOTIFY updated)
+    Q_PROPERTY(QVariantList queues
+               READ queues
+               NOTIFY updated)
+    Q_PROPERTY(QVariantList counters
+               READ counters
+               NOTIFY updated)
+    Q_PROPERTY(QVariantList memory
+               READ memory
+               NOTIFY updated)
+    Q_PROPERTY(QVariantList widgets
+               READ widgets
+               NOTIFY updated)
+  // clang-format on
+
+Q_SIGNALS:
+  void updated();
+
+private:
+  explicit Diagnostics();
+  Diagnostics(Diagnostics &&) = delete;
+  Diagnostics(const Diagnostics &) = delete;
+  Diagnostics &operator=(Diagnostics &&) = delete;
+  Diagnostics &operator=(const Diagnostics &) = delete;
+
+public:
+  static Diagnostics &instance();
+
+  enum class Stage
+  {
+    Reception,
+    Framing,
+    Parsing,
+    FrameLatency,
+    DashboardUpdate,
+    Rendering,
+    DisplayLatency,
+    ProbeArrival,
+    ProbeParsing,
+    ProbeRendering,
+    StageCount
+  };
+  Q_ENUM(Stage)
+
+  enum class Counter
+  {
+    InvalidFrames,
+    BufferOverflows,
+    CsvWriteStalls,
+    DisplayFramesDropped,
+    ProbesLost,
+    FramesLost,
+    FramesDuplicated,
+    FramesReordered,
+    CounterCount
+  };
+  Q_ENUM(Counter)
+
+  QVariantList stages() const;
+  QVariantList queues() const;
+  QVariantList counters() const;
+  QVariantList memory() const;
+  QVariantList widgets() const;
+  QJsonObject snapshot() const;
+  QString memoryReport() const;
+  static qint64 residentMemory();
+
+  void record(const Stage stage, const qint64 nsecs);
+  void increment(const Counter counter, const quint64 value = 1);
+  void recordLatency(const Stage stage, const qint64 timestamp);
+
+public Q_SLOTS:
+  void reset();
+  void update();
+  void updateMemory();
+  void copySnapshot();
+
+private:
+  enum
+  {
+    BucketCount = 24
+  };
+
+  struct Histogram
+  {
+    std::atomic<quint64> count;
+    std::atomic<quint64> total;
+    std::atomic<quint64> maximum;
+    std::atomic<quint64> buckets[BucketCount];
+  };
+
+  static QString stageName(const Stage stage);
+  static QString counterName(const Counter counter);
+  static double percentile(const quint64 *buckets, const quint64 count,
+                           const double fraction);
+
+private:
+  QElapsedTimer m_rateTimer;
+  QVariantList m_stages;
+  QVariantList m_queues;
+  QVariantList m_counters;
+  QVariantList m_memory;
+  QVariantList m_widgets;
+
+  quint64 m_lastCounts[static_cast<int>(Stage::StageCount)];
+  Histogram m_histograms[static_cast<int>(Stage::StageCount)];
+  std::atomic<quint64> m_events[static_cast<int>(Counter::CounterCount)];
+};
+} // namespace Misc
@@ -24,6 +24,8 @@
 
 #include <CSV/Export.h>
 #include <CSV/Player.h>
+#include <CSV/Reference.h>
+#include <CSV/SessionStore.h>
 
 #include <JSON/Frame.h>
 #include <JSON/Group.h>
@@ -35,34 +37,82 @@
 
 #include <IO/Manager.h>
 #include <IO/Console.h>
+#include <IO/BurstRecorder.h>
+#include <IO/ConsoleLog.h>
+#include <IO/CommandScheduler.h>
+#include <IO/FileTransfer.h>
+#include <IO/LatencyProbe.h>
+#include <IO/RawCapture.h>
 #include <IO/Drivers/Serial.h>
 #include <IO/Drivers/Network.h>
 #include <IO/Drivers/BluetoothLE.h>
+#include <IO/Drivers/Replay.h>
+#include <IO/Drivers/Stream.h>
+#include <IO/Drivers/CANBus.h>
+#include <IO/Drivers/Modbus.h>
+#include <IO/Drivers/USB.h>
+#include <IO/Drivers/Audio.h>
 
+#include <Misc/Tracer.h>
+#include <Misc/AlarmLog.h>
+#include <Misc/Renderer.h>
+#include <Misc/Settings.h>
 #include <Misc/Utilities.h>
 #include <Misc/Translator.h>
+#include <Misc/Diagnostics.h>
 #include <Misc/TimerEvents.h>
 #include <Misc/ThemeManager.h>
 #include <Misc/ModuleManager.h>
 
 #include <MQTT/Client.h>
+#include <InfluxDB/Client.h>
 #include <Plugins/Server.h>
+#include <Plugins/SharedMemory.h>
+#include <Plugins/UdpForwarder.h>
+#include <Plugins/ZmqPublisher.h>
 
+#include <UI/Capture.h>
+#include <UI/PlotItem.h>
+#include <UI/FFTEngine.h>
+#include <UI/GpsTrackItem.h>
+#include <UI/TerminalView.h>
+#include <UI/WaterfallItem.h>
+#include <UI/XYPlotItem.h>
+#include <UI/HeatmapItem.h>
+#include <UI/ValueModel.h>
+#include <UI/WidgetModel.h>
 #include <UI/Dashboard.h>
 #include <UI/DashboardWidget.h>
 #include <UI/Widgets/Terminal.h>
 
+#include <QDir>
+#include <QTimer>
+#include <QFileInfo>
 #include <QQuickWindow>
 #include <QSimpleUpdater.h>
 
+/**
+ * Maximum time (in milliseconds) to wait for the first frame of the main
+ * window before initializing the deferred modules anyway.
+ */
+static constexpr int DEFERRED_INIT_TIMEOUT = 5000;
+
 /**
  * Configures the application font and configures application signals/slots to
  * destroy singleton classes before the application quits.
  */
 Misc::ModuleManager::ModuleManager()
+  : m_startupProfiling(false)
+  , m_deferredModulesLoaded(false)
+  , m_lastStageTime(0)
+  , m_engine(Q_NULLPTR)
 {
+  // Start measuring startup time
+  m_startupTimer.start();
+
   // Init translator
   (void)Misc::Translator::instance();
+  startupStage("Translator");
 
   // Load Roboto fonts from resources
   QFontDatabase::addApplicationFont(":/fonts/Roboto-Bold.ttf");
@@ -80,17 +130,25 @@ Misc::ModuleManager::ModuleManager()
   font.setPointSize(10);
 #endif
   qApp->setFont(font);
-
-  // Stop modules when application is about to quit
-  connect(engine(), SIGNAL(quit()), this, SLOT(onQuit()));
+  startupStage("Fonts");
 }
 
 /**
- * Returns a pointer to the QML application engine
+ * Returns a pointer to the QML application engine, the engine is created the
+ * first time that this function is called.
  */
 QQmlApplicationEngine *Misc::ModuleManager::engine()
 {
-  return &m_engine;
+  if (!m_engine)
+  {
+    // Create engine
+    m_engine = new QQmlApplicationEngine(this);
+
+    // Stop modules when application is about to quit
+    connect(m_engine, SIGNAL(quit()), this, SLOT(onQuit()));
+  }
+
+  return m_engine;
 }
 
 /**
@@ -119,6 +177,13 @@ void Misc::ModuleManager::registerQmlTypes()
 {
   qmlRegisterType<Widgets::Terminal>("SerialStudio", 1, 0, "Terminal");
   qmlRegisterType<UI::DashboardWidget>("SerialStudio", 1, 0, "DashboardWidget");
+  qmlRegisterType<UI::PlotItem>("SerialStudio", 1, 0, "PlotItem");
+  qmlRegisterType<UI::GpsTrackItem>("SerialStudio", 1, 0, "GpsTrackItem");
+  qmlRegisterType<UI::WaterfallItem>("SerialStudio", 1, 0, "WaterfallItem");
+  qmlRegisterType<UI::XYPlotItem>("SerialStudio", 1, 0, "XYPlotItem");
+  qmlRegisterType<UI::HeatmapItem>("SerialStudio", 1, 0, "HeatmapItem");
+  qmlRegisterType<UI::TerminalView>("SerialStudio", 1, 0, "TerminalView");
+  startupStage("QML types");
 }
 
 /**
@@ -139,32 +204,81 @@ bool Misc::ModuleManager::autoUpdaterEnabled()
 }
 
 /**
- * Initializes all the application modules, registers them with the QML engine
+ * Returns @c true if the modules that are not required to show the user
+ * interface have already been initialized.
+ */
+bool Misc::ModuleManager::deferredModulesLoaded() const
+{
+  return m_deferredModulesLoaded;
+}
+
+/**
+ * Enables or disables printing the time spent in each startup stage once the
+ * deferred modules have been initialized.
+ */
+void Misc::ModuleManager::setStartupProfiling(const bool enabled)
+{
+  m_startupProfiling = enabled;
+}
+
+/**
+ * Initializes the application modules, registers them with the QML engine
  * and loads the "main.qml" file as the root QML file.
+ *
+ * The modules used by the QML interface are constructed here, but the ones
+ * that perform expensive work (network threads, servers, update checks...)
+ * only do so after @c initializeDeferredModules() is called.
  */
 void Misc::ModuleManager::initializeQmlInterface()
 {
   // Initialize modules
   auto csvExport = &CSV::Export::instance();
   auto csvPlayer = &CSV::Player::instance();
+  auto csvReference = &CSV::Reference::instance();
+  auto csvSessionStore = &CSV::SessionStore::instance();
   auto ioManager = &IO::Manager::instance();
   auto ioConsole = &IO::Console::instance();
+  auto ioConsoleLog = &IO::ConsoleLog::instance();
+  auto ioRawCapture = &IO::RawCapture::instance();
+  auto ioBurstRecorder = &IO::BurstRecorder::instance();
+  auto ioCommandScheduler = &IO::CommandScheduler::instance();
+  auto ioLatencyProbe = &IO::LatencyProbe::instance();
+  auto ioFileTransfer = &IO::FileTransfer::instance();
   auto mqttClient = &MQTT::Client::instance();
+  auto influxClient = &InfluxDB::Client::instance();
+  auto uiCapture = &UI::Capture::instance();
   auto uiDashboard = &UI::Dashboard::instance();
+  auto uiFFTEngine = &UI::FFTEngine::instance();
+  auto uiValueModel = &UI::ValueModel::instance();
+  auto uiWidgetModel = &UI::WidgetModel::instance();
   auto projectModel = &Project::Model::instance();
   auto ioSerial = &IO::Drivers::Serial::instance();
   auto jsonGenerator = &JSON::Generator::instance();
   auto pluginsBridge = &Plugins::Server::instance();
+  auto pluginsSharedMemory = &Plugins::SharedMemory::instance();
+  auto pluginsUdpForwarder = &Plugins::UdpForwarder::instance();
+  auto pluginsZmqPublisher = &Plugins::ZmqPublisher::instance();
+  auto miscTracer = &Misc::Tracer::instance();
+  auto miscAlarmLog = &Misc::AlarmLog::instance();
+  auto miscRenderer = &Misc::Renderer::instance();
   auto miscUtilities = &Misc::Utilities::instance();
   auto ioNetwork = &IO::Drivers::Network::instance();
   auto miscTranslator = &Misc::Translator::instance();
+  auto miscDiagnostics = &Misc::Diagnostics::instance();
   auto miscTimerEvents = &Misc::TimerEvents::instance();
   auto miscThemeManager = &Misc::ThemeManager::instance();
   auto projectCodeEditor = &Project::CodeEditor::instance();
   auto ioBluetoothLE = &IO::Drivers::BluetoothLE::instance();
+  auto ioReplay = &IO::Drivers::Replay::instance();
+  auto ioStream = &IO::Drivers::Stream::instance();
+  auto ioCANBus = &IO::Drivers::CANBus::instance();
+  auto ioModbus = &IO::Drivers::Modbus::instance();
+  auto ioUSB = &IO::Drivers::USB::instance();
+  auto ioAudio = &IO::Drivers::Audio::instance();
 
   // Initialize third-party modules
   auto updater = QSimpleUpdater::getInstance();
+  startupStage("Core modules");
 
   // Operating system flags
   bool isWin = false;
@@ -192,6 +306,22 @@ void Misc::ModuleManager::initializeQmlInterface()
   const bool qt6 = true;
 #endif
 
+  // Let the timers idle while no data source is active
+  auto updateDataSources = [=] {
+    const bool mqttSubscriber
+        = mqttClient->isConnectedToHost()
+          && mqttClient->clientMode() == MQTT::ClientSubscriber;
+    miscTimerEvents->setDataSourceActive(
+        ioManager->connected() || csvPlayer->isOpen() || mqttSubscriber);
+  };
+  connect(ioManager, &IO::Manager::connectedChanged, this, updateDataSources);
+  connect(csvPlayer, &CSV::Player::openChanged, this, updateDataSources);
+  connect(mqttClient, &MQTT::Client::connectedChanged, this,
+          updateDataSources);
+  connect(mqttClient, &MQTT::Client::clientModeChanged, this,
+          updateDataSources);
+  updateDataSources();
+
   // Start common event timers
   miscTimerEvents->startTimers();
 
@@ -210,18 +340,44 @@ void Misc::ModuleManager::initializeQmlInterface()
   c->setContextProperty("Cpp_IO_Serial", ioSerial);
   c->setContextProperty("Cpp_CSV_Export", csvExport);
   c->setContextProperty("Cpp_CSV_Player", csvPlayer);
+  c->setContextProperty("Cpp_CSV_Reference", csvReference);
+  c->setContextProperty("Cpp_CSV_SessionStore", csvSessionStore);
   c->setContextProperty("Cpp_IO_Console", ioConsole);
+  c->setContextProperty("Cpp_IO_ConsoleLog", ioConsoleLog);
+  c->setContextProperty("Cpp_IO_RawCapture", ioRawCapture);
+  c->setContextProperty("Cpp_IO_BurstRecorder", ioBurstRecorder);
+  c->setContextProperty("Cpp_IO_CommandScheduler", ioCommandScheduler);
+  c->setContextProperty("Cpp_IO_LatencyProbe", ioLatencyProbe);
+  c->setContextProperty("Cpp_IO_FileTransfer", ioFileTransfer);
   c->setContextProperty("Cpp_IO_Manager", ioManager);
   c->setContextProperty("Cpp_IO_Network", ioNetwork);
   c->setContextProperty("Cpp_MQTT_Client", mqttClient);
+  c->setContextProperty("Cpp_InfluxDB_Client", influxClient);
+  c->setContextProperty("Cpp_UI_Capture", uiCapture);
   c->setContextProperty("Cpp_UI_Dashboard", uiDashboard);
+  c->setContextProperty("Cpp_UI_FFTEngine", uiFFTEngine);
+  c->setContextProperty("Cpp_UI_ValueModel", uiValueModel);
+  c->setContextProperty("Cpp_UI_WidgetModel", uiWidgetModel);
   c->setContextProperty("Cpp_Project_Model", projectModel);
   c->setContextProperty("Cpp_JSON_Generator", jsonGenerator);
   c->setContextProperty("Cpp_Plugins_Bridge", pluginsBridge);
+  c->setContextProperty("Cpp_Plugins_SharedMemory", pluginsSharedMemory);
+  c->setContextProperty("Cpp_Plugins_UdpForwarder", pluginsUdpForwarder);
+  c->setContextProperty("Cpp_Plugins_ZmqPublisher", pluginsZmqPublisher);
+  c->setContextProperty("Cpp_Misc_Tracer", miscTracer);
+  c->setContextProperty("Cpp_Misc_AlarmLog", miscAlarmLog);
+  c->setContextProperty("Cpp_Misc_Renderer", miscRenderer);
   c->setContextProperty("Cpp_Misc_Utilities", miscUtilities);
   c->setContextProperty("Cpp_IO_Bluetooth_LE", ioBluetoothLE);
+  c->setContextProperty("Cpp_IO_Replay", ioReplay);
+  c->setContextProperty("Cpp_IO_Stream", ioStream);
+  c->setContextProperty("Cpp_IO_CANBus", ioCANBus);
+  c->setContextProperty("Cpp_IO_Modbus", ioModbus);
+  c->setContextProperty("Cpp_IO_USB", ioUSB);
+  c->setContextProperty("Cpp_IO_Audio", ioAudio);
   c->setContextProperty("Cpp_ThemeManager", miscThemeManager);
   c->setContextProperty("Cpp_Misc_Translator", miscTranslator);
+  c->setContextProperty("Cpp_Misc_Diagnostics", miscDiagnostics);
   c->setContextProperty("Cpp_Misc_TimerEvents", miscTimerEvents);
   c->setContextProperty("Cpp_Project_CodeEditor", projectCodeEditor);
   c->setContextProperty("Cpp_UpdaterEnabled", autoUpdaterEnabled());
@@ -235,8 +391,250 @@ void Misc::ModuleManager::initializeQmlInterface()
   c->setContextProperty("Cpp_AppOrganizationDomain",
                         qApp->organizationDomain());
 
+  // Apply the render options before the main window is created
+  startupStage("Context properties");
+  miscRenderer->configureSceneGraph();
+
   // Load main.qml
   engine()->load(QUrl(QStringLiteral("qrc:/qml/main.qml")));
+  startupStage("QML engine");
+
+  // Initialize deferred modules if the main window is never rendered
+  QTimer::singleShot(DEFERRED_INIT_TIMEOUT, this,
+                     &Misc::ModuleManager::initializeDeferredModules);
+}
+
+/**
+ * Initializes the modules that are not required to render the first frame of
+ * the user interface, this function is called by the main window once it has
+ * been rendered. Calling this function more than once has no effect.
+ *
+ * The time spent in each startup stage is printed to the console if startup
+ * profiling is enabled.
+ */
+void Misc::ModuleManager::initializeDeferredModules()
+{
+  // Modules already initialized
+  if (m_deferredModulesLoaded)
+    return;
+
+  // Register the time at which the first frame was shown
+  startupStage("First frame");
+
+  // Start network threads
+  MQTT::Client::instance().start();
+  startupStage("MQTT client");
+  Plugins::Server::instance().start();
+  startupStage("Plugins server");
+
+  // Configure auto-updater
+  configureUpdater();
+  startupStage("Updater");
+
+  // Print startup profile
+  if (m_startupProfiling)
+  {
+    qInfo() << "Startup profile:";
+    Q_FOREACH (const auto &stage, m_startupProfile)
+      qInfo().noquote() << stage;
+  }
+
+  // Update UI
+  m_startupProfile.clear();
+  m_deferredModulesLoaded = true;
+  Q_EMIT deferredModulesLoadedChanged();
+}
+
+/**
+ * Initializes the modules needed to bridge a device to CSV files, MQTT and
+ * the plugins server without loading the QML interface. Returns @c false if
+ * the given @a options do not describe a valid device.
+ */
+bool Misc::ModuleManager::initializeHeadless(const HeadlessOptions &options)
+{
+  // Validate device configuration
+  if (options.serialPort.isEmpty() && options.tcpHost.isEmpty()
+      && options.udpPort == 0 && options.replayFile.isEmpty()
+      && options.input.isEmpty())
+  {
+    qCritical() << "No device specified for headless mode";
+    return false;
+  }
+
+  // Print messages to the console
+  Misc::Utilities::setHeadless(true);
+  m_headlessOptions = options;
+
+  // Initialize modules
+  auto csvExport = &CSV::Export::instance();
+  auto ioManager = &IO::Manager::instance();
+  auto mqttClient = &MQTT::Client::instance();
+  auto jsonGenerator = &JSON::Generator::instance();
+  auto pluginsServer = &Plugins::Server::instance();
+  auto miscTimerEvents = &Misc::TimerEvents::instance();
+  (void)Misc::AlarmLog::instance();
+  (void)IO::RawCapture::instance();
+  (void)CSV::SessionStore::instance();
+  (void)IO::CommandScheduler::instance();
+  (void)Plugins::SharedMemory::instance();
+  (void)Plugins::UdpForwarder::instance();
+  (void)Plugins::ZmqPublisher::instance();
+
+  // Load project file
+  if (!options.project.isEmpty())
+  {
+    jsonGenerator->setOperationMode(JSON::Generator::kManual);
+    jsonGenerator->loadJsonMap(options.project);
+  }
+
+  // Configure raw capture replay
+  if (!options.replayFile.isEmpty())
+  {
+    auto replay = &IO::Drivers::Replay::instance();
+    ioManager->setSelectedDriver(IO::Manager::SelectedDriver::Replay);
+    replay->setRealTime(!options.replayMaxSpeed);
+    replay->openFile(options.replayFile);
+    if (!replay->configurationOk())
+      return false;
+  }
+
+  // Configure file, pipe, local socket or standard input
+  else if (!options.input.isEmpty())
+  {
+    auto stream = &IO::Drivers::Stream::instance();
+    const auto type = IO::Drivers::Stream::detectSourceType(options.input);
+    ioManager->setSelectedDriver(IO::Manager::SelectedDriver::Stream);
+    stream->setSourceType(type);
+    if (options.input != QStringLiteral("-"))
+      stream->setPath(options.input);
+  }
+
+  // Configure serial port
+  else if (!options.serialPort.isEmpty())
+  {
+    ioManager->setSelectedDriver(IO::Manager::SelectedDriver::Serial);
+    IO::Drivers::Serial::instance().setBaudRate(options.baudRate);
+  }
+
+  // Configure TCP socket
+  else if (!options.tcpHost.isEmpty())
+  {
+    auto network = &IO::Drivers::Network::instance();
+    ioManager->setSelectedDriver(IO::Manager::SelectedDriver::Network);
+    network->setTcpSocket();
+    network->setTcpPort(options.tcpPort);
+    network->setRemoteAddress(options.tcpHost);
+  }
+
+  // Configure UDP socket
+  else
+  {
+    auto network = &IO::Drivers::Network::instance();
+    ioManager->setSelectedDriver(IO::Manager::SelectedDriver::Network);
+    network->setUdpSocket();
+    network->setUdpLocalPort(options.udpPort);
+  }
+
+  // Configure MQTT publisher
+  if (!options.mqttHost.isEmpty())
+  {
+    mqttClient->setClientMode(MQTT::ClientPublisher);
+    mqttClient->setHost(options.mqttHost);
+    mqttClient->setPort(options.mqttPort);
+    if (!options.mqttTopic.isEmpty())
+      mqttClient->setTopic(options.mqttTopic);
+
+    mqttClient->connectToHost();
+  }
+
+  // Enable plugins server
+  if (options.plugins)
+    pluginsServer->setEnabled(true);
+
+  // Print export status
+  if (csvExport->exportEnabled())
+    qInfo() << "Recording received frames to"
+            << QString("%1/Documents/%2/CSV/")
+                   .arg(QDir::homePath(), qApp->applicationName());
+
+  // Print the memory held by each subsystem periodically
+  if (options.memoryReport > 0)
+  {
+    auto timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, [] {
+      auto &diagnostics = Misc::Diagnostics::instance();
+      diagnostics.updateMemory();
+      qInfo().noquote() << diagnostics.memoryReport();
+    });
+    timer->start(options.memoryReport * 1000);
+  }
+
+  // Stop modules when application is about to quit
+  connect(qApp, &QCoreApplication::aboutToQuit, this,
+          &Misc::ModuleManager::onQuit);
+
+  // Replay the capture or read the input once & quit when it ends
+  if (!options.replayFile.isEmpty() || !options.input.isEmpty())
+  {
+    miscTimerEvents->startTimers();
+    ioManager->connectDevice();
+    if (!ioManager->connected())
+      return false;
+
+    connect(ioManager, &IO::Manager::connectedChanged, qApp, [=] {
+      if (!ioManager->connected())
+      {
+        qInfo() << "End of input data";
+        qApp->quit();
+      }
+    });
+
+    return true;
+  }
+
+  // Connect to the device & reconnect automatically if it is lost
+  connect(miscTimerEvents, &Misc::TimerEvents::timeout1Hz, this,
+          &Misc::ModuleManager::connectHeadlessDevice);
+  miscTimerEvents->startTimers();
+  connectHeadlessDevice();
+  return true;
+}
+
+/**
+ * Connects to the device configured for headless mode, this function is
+ * called periodically so that the connection is restored if the device is
+ * disconnected (e.g. a serial device that is unplugged).
+ */
+void Misc::ModuleManager::connectHeadlessDevice()
+{
+  // Already connected
+  auto io = &IO::Manager::instance();
+  if (io->connected())
+    return;
+
+  // Select serial port by name, the first item of the list is a placeholder
+  const auto &options = m_headlessOptions;
+  if (!options.serialPort.isEmpty())
+  {
+    auto serial = &IO::Drivers::Serial::instance();
+    const auto name = QFileInfo(options.serialPort).fileName();
+    const auto ports = serial->portList();
+    for (int i = 1; i < ports.count(); ++i)
+    {
+      if (ports.at(i) == name || ports.at(i).startsWith(name + "  "))
+      {
+        if (serial->portIndex() != i)
+          serial->setPortIndex(i);
+
+        break;
+      }
+    }
+  }
+
+  // Try to connect
+  io->connectDevice();
+  if (io->connected())
+    qInfo() << "Connected to device";
 }
 
 /**
@@ -246,7 +644,31 @@ void Misc::ModuleManager::onQuit()
 {
   CSV::Export::instance().closeFile();
   CSV::Player::instance().closeFile();
+  CSV::Reference::instance().closeFile();
+  CSV::SessionStore::instance().closeDatabase();
+  MQTT::Client::instance().closeConnection();
+  IO::ConsoleLog::instance().closeFile();
+  IO::RawCapture::instance().closeFile();
   IO::Manager::instance().disconnectDriver();
   Misc::TimerEvents::instance().stopTimers();
-  Plugins::Server::instance().removeConnection();
+  Plugins::Server::instance().closeConnections();
+  Misc::SettingsStore::instance().flush();
+}
+
+/**
+ * Registers the time elapsed since the module manager was created & the time
+ * spent since the previous startup stage, these values are printed once the
+ * deferred modules are initialized (if startup profiling is enabled).
+ */
+void Misc::ModuleManager::startupStage(const char *name)
+{
+  if (m_deferredModulesLoaded)
+    return;
+
+  const auto elapsed = m_startupTimer.elapsed();
+  m_startupProfile.append(QStringLiteral("  %1 %2 ms (+%3 ms)")
+                              .arg(QString::fromLatin1(name), -20)
+                              .arg(elapsed, 6)
+                              .arg(elapsed - m_lastStageTime));
+  m_lastStageTime = elapsed;
 }
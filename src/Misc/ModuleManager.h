@@ -23,22 +23,68 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
+#include <QElapsedTimer>
 #include <QQmlApplicationEngine>
 
 #include <DataTypes.h>
 
 namespace Misc
 {
+/**
+ * @brief Configuration of the headless mode
+ *
+ * Describes the project, the device & the optional MQTT broker used when
+ * Serial Studio runs without user interface.
+ */
+struct HeadlessOptions
+{
+  QString project;
+  QString serialPort;
+  qint32 baudRate = 9600;
+  QString tcpHost;
+  quint16 tcpPort = 0;
+  quint16 udpPort = 0;
+  QString mqttHost;
+  quint16 mqttPort = 1883;
+  QString mqttTopic;
+  bool plugins = false;
+  QString replayFile;
+  QString input;
+  bool replayMaxSpeed = false;
+  int memoryReport = 0;
+};
+
 /**
  * @brief The ModuleManager class
  *
  * The @c ModuleManager class is in charge of initializing all the C++ modules
  * that are part of Serial Studio in the correct order.
+ *
+ * In headless mode, only the modules required to read data from a device and
+ * to forward it to CSV files, MQTT & the plugins server are initialized. The
+ * QML engine & the dashboard are never created.
+ *
+ * When the user interface is used, the modules that are not needed to render
+ * the first frame (MQTT network thread, plugins server, auto-updater...) are
+ * initialized by @c initializeDeferredModules() once the main window has been
+ * rendered. The time spent in each startup stage is recorded & printed to the
+ * console if startup profiling is enabled.
  */
 class ModuleManager : public QObject
 {
-  Q_OBJECT
-  Q_PROPERTY(bool autoUpdaterEnabled READ autoUpdaterEnabled CONSTANT)
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool autoUpdaterEnabled
+               READ autoUpdaterEnabled
+               CONSTANT)
+    Q_PROPERTY(bool deferredModulesLoaded
+               READ deferredModulesLoaded
+               NOTIFY deferredModulesLoadedChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void deferredModulesLoadedChanged();
 
 public:
   ModuleManager();
@@ -47,11 +93,29 @@ public:
   bool autoUpdaterEnabled();
   void initializeQmlInterface();
   QQmlApplicationEngine *engine();
+  bool deferredModulesLoaded() const;
+  void setStartupProfiling(const bool enabled);
+  bool initializeHeadless(const HeadlessOptions &options);
 
 public Q_SLOTS:
   void onQuit();
+  void initializeDeferredModules();
+
+private Q_SLOTS:
+  void connectHeadlessDevice();
 
 private:
-  QQmlApplicationEngine m_engine;
+  void startupStage(const char *name);
+
+private:
+  bool m_startupProfiling;
+  bool m_deferredModulesLoaded;
+
+  qint64 m_lastStageTime;
+  QElapsedTimer m_startupTimer;
+  QStringList m_startupProfile;
+
+  QQmlApplicationEngine *m_engine;
+  HeadlessOptions m_headlessOptions;
 };
 } // namespace Misc
@@ -0,0 +1,681 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDebug>
+#include <QQuickWindow>
+#include <QSurfaceFormat>
+#include <QSGRendererInterface>
+
+#include <Misc/Renderer.h>
+#include <Misc/TimerEvents.h>
+#include <Misc/ThreadScheduler.h>
+
+/**
+ * Upper bound (in milliseconds) of each frame time histogram bucket, the last
+ * bucket has no upper bound
+ */
+static const double BUCKET_LIMITS[] = {8, 16, 33, 50, 100, 250};
+
+/**
+ * Frame intervals longer than this (in nanoseconds) are considered idle
+ * periods of the scene graph, which only renders when something changes
+ */
+static const qint64 IDLE_INTERVAL = 1000 * 1000 * 1000;
+
+/**
+ * Returns the values of QSG_RENDER_LOOP that can be selected by the user, the
+ * first one leaves the choice to Qt
+ */
+static QStringList RENDER_LOOPS()
+{
+  return {QStringLiteral("default"), QStringLiteral("threaded"),
+          QStringLiteral("basic")};
+}
+
+/**
+ * Returns the graphics APIs supported by this build of the application, the
+ * first one leaves the choice to Qt
+ */
+static QStringList GRAPHICS_BACKENDS()
+{
+  QStringList list;
+  list.append(QStringLiteral("default"));
+  list.append(QStringLiteral("opengl"));
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#  if defined(Q_OS_WIN)
+  list.append(QStringLiteral("d3d11"));
+#  endif
+#  if defined(Q_OS_MAC)
+  list.append(QStringLiteral("metal"));
+#  elif QT_CONFIG(vulkan)
+  list.append(QStringLiteral("vulkan"));
+#  endif
+#endif
+  list.append(QStringLiteral("software"));
+  return list;
+}
+
+/**
+ * Returns the index of the given @a key in the given @a list, or 0 (the
+ * default option) if the key is not in the list
+ */
+static int INDEX_OF(const QStringList &list, const QString &key)
+{
+  return qMax(0, list.indexOf(key));
+}
+
+/**
+ * Constructor function, reads the scene graph configuration
+ */
+Misc::Renderer::Renderer()
+  : m_fps(0)
+  , m_frameTime(0)
+  , m_syncTime(0)
+  , m_renderTime(0)
+  , m_window(Q_NULLPTR)
+  , m_affinityPending(true)
+  , m_syncStart(0)
+  , m_renderStart(0)
+  , m_lastSwap(0)
+  , m_frames(0)
+  , m_frameNsecs(0)
+  , m_syncNsecs(0)
+  , m_renderNsecs(0)
+{
+  // Read settings
+  m_vsync = m_settings.value("Misc_Renderer_VSync", true).toBool();
+  m_overlayEnabled = m_settings.value("Misc_Renderer_Overlay", false).toBool();
+  m_renderThreadCpu
+      = m_settings.value("Misc_Renderer_RenderThreadCpu", -1).toInt();
+  m_renderLoop = INDEX_OF(
+      RENDER_LOOPS(), m_settings.value("Misc_Renderer_RenderLoop").toString());
+  m_graphicsBackend
+      = INDEX_OF(GRAPHICS_BACKENDS(),
+                 m_settings.value("Misc_Renderer_GraphicsBackend").toString());
+
+  // The stored options are applied by configureSceneGraph()
+  m_appliedVsync = m_vsync;
+  m_appliedRenderLoop = m_renderLoop;
+  m_appliedGraphicsBackend = m_graphicsBackend;
+
+  // Initialize the histogram
+  for (int i = 0; i < BucketCount; ++i)
+  {
+    m_buckets[i] = 0;
+    m_histogram.append(0);
+  }
+
+  // Publish the measurements once per second
+  m_clock.start();
+  m_rateTimer.start();
+  connect(&TimerEvents::instance(), &TimerEvents::timeout1Hz, this,
+          &Misc::Renderer::updateStatistics);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Misc::Renderer &Misc::Renderer::instance()
+{
+  static Renderer singleton;
+  return singleton;
+}
+
+/**
+ * Returns the index of the selected render loop (see @c renderLoops())
+ */
+int Misc::Renderer::renderLoop() const
+{
+  return m_renderLoop;
+}
+
+/**
+ * Returns the index of the selected graphics API (see @c graphicsBackends())
+ */
+int Misc::Renderer::graphicsBackend() const
+{
+  return m_graphicsBackend;
+}
+
+/**
+ * Returns @c true if buffer swaps are synchronized with the refresh rate of
+ * the display
+ */
+bool Misc::Renderer::vsync() const
+{
+  return m_vsync;
+}
+
+/**
+ * Returns the index of the CPU core to which the render thread is pinned, or
+ * -1 if it can run on any core
+ */
+int Misc::Renderer::renderThreadCpu() const
+{
+  return m_renderThreadCpu;
+}
+
+/**
+ * Returns @c true if the selected configuration differs from the one that
+ * the scene graph was created with, i.e. the application must be restarted
+ * to apply it
+ */
+bool Misc::Renderer::restartRequired() const
+{
+  return m_vsync != m_appliedVsync || m_renderLoop != m_appliedRenderLoop
+         || m_graphicsBackend != m_appliedGraphicsBackend;
+}
+
+/**
+ * Returns @c true if the performance overlay is shown & the frames of the
+ * main window are measured
+ */
+bool Misc::Renderer::overlayEnabled() const
+{
+  return m_overlayEnabled;
+}
+
+/**
+ * Returns the name of the graphics API that the scene graph is actually
+ * using, which may differ from the selected one if it is not supported.
+ */
+QString Misc::Renderer::activeBackend() const
+{
+  return m_activeBackend;
+}
+
+/**
+ * Returns the number of frames rendered during the last second
+ */
+double Misc::Renderer::fps() const
+{
+  return m_fps;
+}
+
+/**
+ * Returns the average time (in milliseconds) between two consecutive frames
+ * during the last second, idle periods are excluded
+ */
+double Misc::Renderer::frameTime() const
+{
+  return m_frameTime;
+}
+
+/**
+ * Returns the average time (in milliseconds) spent synchronizing the items
+ * with the scene graph for each frame, which includes uploading textures &
+ * geometry to the GPU
+ */
+double Misc::Renderer::syncTime() const
+{
+  return m_syncTime;
+}
+
+/**
+ * Returns the average time (in milliseconds) spent recording & submitting
+ * the draw calls of each frame
+ */
+double Misc::Renderer::renderTime() const
+{
+  return m_renderTime;
+}
+
+/**
+ * Returns the number of frames of the last second that fall in each bucket
+ * of the frame time histogram (see @c histogramLabels())
+ */
+QVariantList Misc::Renderer::histogram() const
+{
+  return m_histogram;
+}
+
+/**
+ * Returns the names of the render loops that can be selected
+ */
+StringList Misc::Renderer::renderLoops() const
+{
+  StringList list;
+  list.append(tr("Default"));
+  list.append(tr("Threaded"));
+  list.append(tr("Basic (GUI thread)"));
+  return list;
+}
+
+/**
+ * Returns the names of the graphics APIs that can be selected
+ */
+StringList Misc::Renderer::graphicsBackends() const
+{
+  StringList list;
+  Q_FOREACH (const auto &key, GRAPHICS_BACKENDS())
+  {
+    if (key == QStringLiteral("opengl"))
+      list.append(tr("OpenGL"));
+    else if (key == QStringLiteral("d3d11"))
+      list.append(tr("Direct3D 11"));
+    else if (key == QStringLiteral("metal"))
+      list.append(tr("Metal"));
+    else if (key == QStringLiteral("vulkan"))
+      list.append(tr("Vulkan"));
+    else if (key == QStringLiteral("software"))
+      list.append(tr("Software rasterizer"));
+    else
+      list.append(tr("Default"));
+  }
+
+  return list;
+}
+
+/**
+ * Returns the names of the frame time histogram buckets
+ */
+StringList Misc::Renderer::histogramLabels() const
+{
+  StringList list;
+  double previous = 0;
+  for (const auto limit : BUCKET_LIMITS)
+  {
+    if (previous <= 0)
+      list.append(QStringLiteral("< %1 ms").arg(limit));
+    else
+      list.append(QStringLiteral("%1-%2 ms").arg(previous).arg(limit));
+
+    previous = limit;
+  }
+
+  list.append(QStringLiteral("> %1 ms").arg(previous));
+  return list;
+}
+
+/**
+ * Returns the names of the CPU cores to which the render thread (or the I/O
+ * thread) can be pinned, the first option lets the thread run on any core
+ */
+StringList Misc::Renderer::cpuNames() const
+{
+  return ThreadScheduler::cpuNames();
+}
+
+/**
+ * Applies the selected render loop, graphics API & vertical synchronization,
+ * this function must be called before the first window is created.
+ *
+ * Options that the user already set through environment variables are left
+ * untouched, so that the documented Qt variables keep working.
+ */
+void Misc::Renderer::configureSceneGraph()
+{
+  // Select the render loop
+  const auto loop = RENDER_LOOPS().at(m_renderLoop);
+  if (m_renderLoop > 0 && !qEnvironmentVariableIsSet("QSG_RENDER_LOOP"))
+    qputenv("QSG_RENDER_LOOP", loop.toLatin1());
+
+  // Select the graphics API
+  const auto backend = GRAPHICS_BACKENDS().at(m_graphicsBackend);
+  if (!qEnvironmentVariableIsSet("QSG_RHI_BACKEND")
+      && !qEnvironmentVariableIsSet("QT_QUICK_BACKEND"))
+  {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    if (backend == QStringLiteral("opengl"))
+      QQuickWindow::setGraphicsApi(QSGRendererInterface::OpenGL);
+    else if (backend == QStringLiteral("d3d11"))
+      QQuickWindow::setGraphicsApi(QSGRendererInterface::Direct3D11);
+    else if (backend == QStringLiteral("metal"))
+      QQuickWindow::setGraphicsApi(QSGRendererInterface::Metal);
+    else if (backend == QStringLiteral("vulkan"))
+      QQuickWindow::setGraphicsApi(QSGRendererInterface::Vulkan);
+    else if (backend == QStringLiteral("software"))
+      QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+#else
+    if (backend == QStringLiteral("opengl"))
+      QQuickWindow::setSceneGraphBackend(QSGRendererInterface::OpenGL);
+    else if (backend == QStringLiteral("software"))
+      QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+#endif
+  }
+
+  // Configure vertical synchronization
+  auto format = QSurfaceFormat::defaultFormat();
+  format.setSwapInterval(m_vsync ? 1 : 0);
+  QSurfaceFormat::setDefaultFormat(format);
+
+  // Register the applied configuration
+  m_appliedVsync = m_vsync;
+  m_appliedRenderLoop = m_renderLoop;
+  m_appliedGraphicsBackend = m_graphicsBackend;
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Registers the main @a window, whose frames are measured while the overlay
+ * is enabled. This function is called by the QML interface once the main
+ * window is created.
+ */
+void Misc::Renderer::attachWindow(QObject *window)
+{
+  // Detach from the previous window
+  disconnectWindow();
+  if (m_window)
+    disconnect(m_window, Q_NULLPTR, this, Q_NULLPTR);
+
+  // Register the window
+  m_window = qobject_cast<QQuickWindow *>(window);
+  if (!m_window)
+    return;
+
+  // Obtain the graphics API once the scene graph is initialized
+  connect(m_window, &QQuickWindow::sceneGraphInitialized, this,
+          &Misc::Renderer::updateActiveBackend, Qt::QueuedConnection);
+  updateActiveBackend();
+
+  // Pin the render thread before the next frame is synchronized
+  m_affinityPending = true;
+  connect(m_window, &QQuickWindow::beforeSynchronizing, this,
+          &Misc::Renderer::applyRenderThreadCpu, Qt::DirectConnection);
+
+  // Start measuring frames
+  if (m_overlayEnabled)
+    connectWindow();
+}
+
+/**
+ * Enables or disables the vertical synchronization, the change is applied
+ * the next time that the application starts
+ */
+void Misc::Renderer::setVsync(const bool enabled)
+{
+  if (m_vsync != enabled)
+  {
+    m_vsync = enabled;
+    m_settings.setValue("Misc_Renderer_VSync", enabled);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Selects the render @a loop with the given index, the change is applied the
+ * next time that the application starts
+ */
+void Misc::Renderer::setRenderLoop(const int loop)
+{
+  const auto value = qBound(0, loop, RENDER_LOOPS().count() - 1);
+  if (m_renderLoop != value)
+  {
+    m_renderLoop = value;
+    m_settings.setValue("Misc_Renderer_RenderLoop",
+                        RENDER_LOOPS().at(value));
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Selects the graphics API with the given index, the change is applied the
+ * next time that the application starts
+ */
+void Misc::Renderer::setGraphicsBackend(const int backend)
+{
+  const auto value = qBound(0, backend, GRAPHICS_BACKENDS().count() - 1);
+  if (m_graphicsBackend != value)
+  {
+    m_graphicsBackend = value;
+    m_settings.setValue("Misc_Renderer_GraphicsBackend",
+                        GRAPHICS_BACKENDS().at(value));
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Pins the render thread to the given @a cpu core, or lets it run on any core
+ * if @a cpu is negative. The change is applied before the next frame.
+ */
+void Misc::Renderer::setRenderThreadCpu(const int cpu)
+{
+  const auto value = qBound(-1, cpu, ThreadScheduler::cpuCount() - 1);
+  if (m_renderThreadCpu != value)
+  {
+    m_renderThreadCpu = value;
+    m_settings.setValue("Misc_Renderer_RenderThreadCpu", value);
+    m_affinityPending = true;
+
+    if (m_window)
+      m_window->update();
+
+    Q_EMIT renderThreadCpuChanged();
+  }
+}
+
+/**
+ * Shows or hides the performance overlay, frames are only measured while
+ * the overlay is enabled
+ */
+void Misc::Renderer::setOverlayEnabled(const bool enabled)
+{
+  if (m_overlayEnabled != enabled)
+  {
+    m_overlayEnabled = enabled;
+    m_settings.setValue("Misc_Renderer_Overlay", enabled);
+
+    if (enabled)
+      connectWindow();
+    else
+      disconnectWindow();
+
+    Q_EMIT overlayEnabledChanged();
+  }
+}
+
+/**
+ * Publishes the measurements of the last second & resets the counters
+ */
+void Misc::Renderer::updateStatistics()
+{
+  // Nothing is measured
+  if (!m_overlayEnabled)
+    return;
+
+  // Obtain & reset the counters
+  const auto elapsed = m_rateTimer.nsecsElapsed();
+  const auto frames = m_frames.exchange(0);
+  const auto frameNsecs = m_frameNsecs.exchange(0);
+  const auto syncNsecs = m_syncNsecs.exchange(0);
+  const auto renderNsecs = m_renderNsecs.exchange(0);
+  m_rateTimer.restart();
+
+  // Update the histogram
+  quint64 intervals = 0;
+  for (int i = 0; i < BucketCount; ++i)
+  {
+    const auto count = m_buckets[i].exchange(0);
+    m_histogram[i] = count;
+    intervals += count;
+  }
+
+  // Calculate rates & averages
+  m_fps = elapsed > 0 ? frames * 1e9 / elapsed : 0;
+  m_frameTime = intervals > 0 ? frameNsecs / 1e6 / intervals : 0;
+  m_syncTime = frames > 0 ? syncNsecs / 1e6 / frames : 0;
+  m_renderTime = frames > 0 ? renderNsecs / 1e6 / frames : 0;
+
+  // Update user interface
+  Q_EMIT statisticsChanged();
+}
+
+/**
+ * Starts measuring the frames of the main window, the scene graph signals
+ * are handled directly in the render thread
+ */
+void Misc::Renderer::connectWindow()
+{
+  if (!m_window)
+    return;
+
+  disconnectWindow();
+  m_lastSwap = 0;
+
+  // clang-format off
+  connect(m_window, &QQuickWindow::beforeSynchronizing,
+          this, &Misc::Renderer::onBeforeSynchronizing, Qt::DirectConnection);
+  connect(m_window, &QQuickWindow::afterSynchronizing,
+          this, &Misc::Renderer::onAfterSynchronizing, Qt::DirectConnection);
+  connect(m_window, &QQuickWindow::beforeRendering,
+          this, &Misc::Renderer::onBeforeRendering, Qt::DirectConnection);
+  connect(m_window, &QQuickWindow::afterRendering,
+          this, &Misc::Renderer::onAfterRendering, Qt::DirectConnection);
+  connect(m_window, &QQuickWindow::frameSwapped,
+          this, &Misc::Renderer::onFrameSwapped, Qt::DirectConnection);
+  // clang-format on
+}
+
+/**
+ * Stops measuring the frames of the main window
+ */
+void Misc::Renderer::disconnectWindow()
+{
+  if (!m_window)
+    return;
+
+  // clang-format off
+  disconnect(m_window, &QQuickWindow::beforeSynchronizing,
+             this, &Misc::Renderer::onBeforeSynchronizing);
+  disconnect(m_window, &QQuickWindow::afterSynchronizing,
+             this, &Misc::Renderer::onAfterSynchronizing);
+  disconnect(m_window, &QQuickWindow::beforeRendering,
+             this, &Misc::Renderer::onBeforeRendering);
+  disconnect(m_window, &QQuickWindow::afterRendering,
+             this, &Misc::Renderer::onAfterRendering);
+  disconnect(m_window, &QQuickWindow::frameSwapped,
+             this, &Misc::Renderer::onFrameSwapped);
+  // clang-format on
+}
+
+/**
+ * Applies the selected CPU affinity to the render thread, this function is
+ * called by the render thread before synchronizing each frame & does nothing
+ * unless the selected CPU core changed.
+ */
+void Misc::Renderer::applyRenderThreadCpu()
+{
+  if (!m_affinityPending.exchange(false))
+    return;
+
+  if (!ThreadScheduler::setAffinity(m_renderThreadCpu))
+    qWarning() << "Cannot change the CPU affinity of the render thread";
+}
+
+/**
+ * Obtains the name of the graphics API used by the scene graph of the main
+ * window
+ */
+void Misc::Renderer::updateActiveBackend()
+{
+  QString name;
+  auto rif = m_window ? m_window->rendererInterface() : Q_NULLPTR;
+  if (rif)
+  {
+    switch (rif->graphicsApi())
+    {
+      case QSGRendererInterface::Software:
+        name = tr("Software rasterizer");
+        break;
+      case QSGRendererInterface::OpenGL:
+        name = tr("OpenGL");
+        break;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+      case QSGRendererInterface::Direct3D11:
+        name = tr("Direct3D 11");
+        break;
+      case QSGRendererInterface::Vulkan:
+        name = tr("Vulkan");
+        break;
+      case QSGRendererInterface::Metal:
+        name = tr("Metal");
+        break;
+#endif
+      default:
+        name = tr("Unknown");
+        break;
+    }
+  }
+
+  if (m_activeBackend != name)
+  {
+    m_activeBackend = name;
+    Q_EMIT activeBackendChanged();
+  }
+}
+
+/**
+ * Registers the start of the synchronization phase (render thread)
+ */
+void Misc::Renderer::onBeforeSynchronizing()
+{
+  m_syncStart = m_clock.nsecsElapsed();
+}
+
+/**
+ * Registers the duration of the synchronization phase (render thread)
+ */
+void Misc::Renderer::onAfterSynchronizing()
+{
+  m_syncNsecs += m_clock.nsecsElapsed() - m_syncStart;
+}
+
+/**
+ * Registers the start of the rendering phase (render thread)
+ */
+void Misc::Renderer::onBeforeRendering()
+{
+  m_renderStart = m_clock.nsecsElapsed();
+}
+
+/**
+ * Registers the duration of the rendering phase (render thread)
+ */
+void Misc::Renderer::onAfterRendering()
+{
+  m_renderNsecs += m_clock.nsecsElapsed() - m_renderStart;
+}
+
+/**
+ * Registers a rendered frame & the time elapsed since the previous frame in
+ * the histogram (render thread)
+ */
+void Misc::Renderer::onFrameSwapped()
+{
+  // Count the frame
+  ++m_frames;
+  const auto now = m_clock.nsecsElapsed();
+  const auto last = m_lastSwap.exchange(now);
+  const auto interval = now - last;
+  if (last <= 0 || interval > IDLE_INTERVAL)
+    return;
+
+  // Find the bucket of the frame time
+  int bucket = 0;
+  const double msecs = interval / 1e6;
+  while (bucket < BucketCount - 1 && msecs >= BUCKET_LIMITS[bucket])
+    ++bucket;
+
+  // Register the frame time
+  ++m_buckets[bucket];
+  m_frameNsecs += interval;
+}
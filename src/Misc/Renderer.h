@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <QObject>
+#include <QPointer>
+#include <QVariantList>
+#include <QElapsedTimer>
+#include <DataTypes.h>
+#include <Misc/Settings.h>
+
+class QQuickWindow;
+
+namespace Misc
+{
+/**
+ * @brief The Renderer class
+ *
+ * Configures the Qt Quick scene graph before the first window is created &
+ * measures how long the main window takes to render its frames.
+ *
+ * The render loop (threaded or basic), the graphics API used by the scene
+ * graph (OpenGL, Direct3D, Vulkan, Metal or the software rasterizer) & the
+ * vertical synchronization can be selected by the user. The defaults of Qt
+ * perform badly on some virtual machines & remote desktop sessions (e.g. the
+ * threaded loop waiting for a vsync that never comes), so these options are
+ * stored in the settings & applied with @c configureSceneGraph() the next
+ * time that the application starts. Environment variables set by the user
+ * (e.g. @c QSG_RENDER_LOOP) take precedence over the stored options.
+ *
+ * The render thread can also be pinned to a CPU core, so that it does not
+ * compete with the I/O thread (see @c IO::Manager::ioThreadCpu()). With the
+ * basic render loop, the scene graph is rendered by the GUI thread, which is
+ * pinned instead.
+ *
+ * While the performance overlay is enabled, the signals of the scene graph
+ * are used to measure the render rate, the distribution of the frame times
+ * (in a fixed set of histogram buckets), the synchronization time (in which
+ * textures & geometry are uploaded to the GPU) & the rendering time. The
+ * measurements are lock-free atomics, since the scene graph signals are
+ * emitted by the render thread, and are published once per second.
+ */
+class Renderer : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int renderLoop
+               READ renderLoop
+               WRITE setRenderLoop
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int graphicsBackend
+               READ graphicsBackend
+               WRITE setGraphicsBackend
+               NOTIFY configurationChanged)
+    Q_PROPERTY(bool vsync
+               READ vsync
+               WRITE setVsync
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int renderThreadCpu
+               READ renderThreadCpu
+               WRITE setRenderThreadCpu
+               NOTIFY renderThreadCpuChanged)
+    Q_PROPERTY(bool restartRequired
+               READ restartRequired
+               NOTIFY configurationChanged)
+    Q_PROPERTY(bool overlayEnabled
+               READ overlayEnabled
+               WRITE setOverlayEnabled
+               NOTIFY overlayEnabledChanged)
+    Q_PROPERTY(QString activeBackend
+               READ activeBackend
+               NOTIFY activeBackendChanged)
+    Q_PROPERTY(double fps
+               READ fps
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(double frameTime
+               READ frameTime
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(double syncTime
+               READ syncTime
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(double renderTime
+               READ renderTime
+               NOTIFY statisticsChanged)
+    Q_PROPERTY(QVariantList histogram
+               READ histogram
+               NOTIFY statisticsChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void statisticsChanged();
+  void configurationChanged();
+  void activeBackendChanged();
+  void overlayEnabledChanged();
+  void renderThreadCpuChanged();
+
+private:
+  explicit Renderer();
+  Renderer(Renderer &&) = delete;
+  Renderer(const Renderer &) = delete;
+  Renderer &operator=(Renderer &&) = delete;
+  Renderer &operator=(const Renderer &) = delete;
+
+public:
+  static Renderer &instance();
+
+  int renderLoop() const;
+  int graphicsBackend() const;
+  bool vsync() const;
+  int renderThreadCpu() const;
+  bool restartRequired() const;
+  bool overlayEnabled() const;
+  QString activeBackend() const;
+
+  double fps() const;
+  double frameTime() const;
+  double syncTime() const;
+  double renderTime() const;
+  QVariantList histogram() const;
+
+  Q_INVOKABLE StringList renderLoops() const;
+  Q_INVOKABLE StringList graphicsBackends() const;
+  Q_INVOKABLE StringList histogramLabels() const;
+  Q_INVOKABLE StringList cpuNames() const;
+
+  void configureSceneGraph();
+  Q_INVOKABLE void attachWindow(QObject *window);
+
+public Q_SLOTS:
+  void setVsync(const bool enabled);
+  void setRenderLoop(const int loop);
+  void setGraphicsBackend(const int backend);
+  void setOverlayEnabled(const bool enabled);
+  void setRenderThreadCpu(const int cpu);
+
+private Q_SLOTS:
+  void updateStatistics();
+
+private:
+  void connectWindow();
+  void disconnectWindow();
+  void updateActiveBackend();
+  void applyRenderThreadCpu();
+
+  void onBeforeSynchronizing();
+  void onAfterSynchronizing();
+  void onBeforeRendering();
+  void onAfterRendering();
+  void onFrameSwapped();
+
+private:
+  enum
+  {
+    BucketCount = 7
+  };
+
+  bool m_vsync;
+  int m_renderLoop;
+  int m_graphicsBackend;
+  bool m_overlayEnabled;
+  int m_renderThreadCpu;
+
+  bool m_appliedVsync;
+  int m_appliedRenderLoop;
+  int m_appliedGraphicsBackend;
+
+  double m_fps;
+  double m_frameTime;
+  double m_syncTime;
+  double m_renderTime;
+  QVariantList m_histogram;
+
+  QString m_activeBackend;
+  QPointer<QQuickWindow> m_window;
+  QElapsedTimer m_clock;
+  QElapsedTimer m_rateTimer;
+  Misc::Settings m_settings;
+
+  std::atomic<bool> m_affinityPending;
+  std::atomic<qint64> m_syncStart;
+  std::atomic<qint64> m_renderStart;
+  std::atomic<qint64> m_lastSwap;
+  std::atomic<quint64> m_frames;
+  std::atomic<quint64> m_frameNsecs;
+  std::atomic<quint64> m_syncNsecs;
+  std::atomic<quint64> m_renderNsecs;
+  std::atomic<quint64> m_buckets[BucketCount];
+};
+} // namespace Misc
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Misc/Settings.h>
+
+/**
+ * Time (in milliseconds) that the writer waits after the first modification
+ * before writing the pending changes, so that consecutive changes are
+ * written together
+ */
+static const int FLUSH_DELAY = 500;
+
+//----------------------------------------------------------------------------------------
+// Writer implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, configures the flush timer
+ */
+Misc::SettingsWriter::SettingsWriter()
+  : m_timer(this)
+{
+  m_timer.setSingleShot(true);
+  m_timer.setInterval(FLUSH_DELAY);
+  connect(&m_timer, &QTimer::timeout, this, &Misc::SettingsWriter::write);
+}
+
+/**
+ * Starts the flush timer, unless a flush is already scheduled
+ */
+void Misc::SettingsWriter::schedule()
+{
+  if (!m_timer.isActive())
+    m_timer.start();
+}
+
+/**
+ * Writes the pending changes of the store to the platform backend
+ */
+void Misc::SettingsWriter::write()
+{
+  m_timer.stop();
+
+  const auto pending = SettingsStore::instance().takePending();
+  if (pending.isEmpty())
+    return;
+
+  for (auto i = pending.constBegin(); i != pending.constEnd(); ++i)
+    m_settings.setValue(i.key(), i.value());
+
+  m_settings.sync();
+}
+
+//----------------------------------------------------------------------------------------
+// Store implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, loads all the settings into the cache & starts the
+ * writer thread.
+ */
+Misc::SettingsStore::SettingsStore()
+  : m_scheduled(false)
+  , m_writer(Q_NULLPTR)
+{
+  // Load settings
+  QSettings settings;
+  const auto keys = settings.allKeys();
+  for (const auto &key : keys)
+    m_cache.insert(key, settings.value(key));
+
+  // Start the writer thread
+  m_writer = new SettingsWriter();
+  m_thread.setObjectName(QStringLiteral("Misc::SettingsWriter"));
+  m_writer->moveToThread(&m_thread);
+  QObject::connect(&m_thread, &QThread::finished, m_writer,
+                   &QObject::deleteLater);
+  m_thread.start(QThread::LowPriority);
+}
+
+/**
+ * Destructor function, stops the writer thread & writes the pending changes
+ */
+Misc::SettingsStore::~SettingsStore()
+{
+  m_thread.quit();
+  m_thread.wait();
+  flush();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+Misc::SettingsStore &Misc::SettingsStore::instance()
+{
+  static SettingsStore singleton;
+  return singleton;
+}
+
+/**
+ * Returns the cached value of the given @a key, or @a defaultValue if the
+ * setting does not exist
+ */
+QVariant Misc::SettingsStore::value(const QString &key,
+                                    const QVariant &defaultValue) const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_cache.value(key, defaultValue);
+}
+
+/**
+ * Changes the @a value of the given @a key in the cache & schedules a write
+ * to the platform backend. Nothing is written if the value did not change.
+ */
+void Misc::SettingsStore::setValue(const QString &key, const QVariant &value)
+{
+  // Update cache & pending changes
+  {
+    QMutexLocker locker(&m_mutex);
+    auto cached = m_cache.constFind(key);
+    if (cached != m_cache.constEnd() && cached.value() == value)
+      return;
+
+    m_cache.insert(key, value);
+    m_pending.insert(key, value);
+    if (m_scheduled)
+      return;
+
+    m_scheduled = true;
+  }
+
+  // Ask the writer to flush the changes
+  auto writer = m_writer;
+  QMetaObject::invokeMethod(writer, [=] { writer->schedule(); });
+}
+
+/**
+ * Writes the pending changes to the platform backend & waits until the
+ * write is finished.
+ */
+void Misc::SettingsStore::flush()
+{
+  // Write the changes in the writer thread
+  auto writer = m_writer;
+  if (m_thread.isRunning() && QThread::currentThread() != &m_thread)
+  {
+    QMetaObject::invokeMethod(
+        writer, [=] { writer->write(); }, Qt::BlockingQueuedConnection);
+    return;
+  }
+
+  // Writer thread is not running, write the changes directly
+  const auto pending = takePending();
+  if (!pending.isEmpty())
+  {
+    QSettings settings;
+    for (auto i = pending.constBegin(); i != pending.constEnd(); ++i)
+      settings.setValue(i.key(), i.value());
+  }
+}
+
+/**
+ * Returns & clears the changes that have not been written yet
+ */
+QHash<QString, QVariant> Misc::SettingsStore::takePending()
+{
+  QMutexLocker locker(&m_mutex);
+  QHash<QString, QVariant> pending;
+  pending.swap(m_pending);
+  m_scheduled = false;
+  return pending;
+}
+
+//----------------------------------------------------------------------------------------
+// Handle implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+Misc::Settings::Settings()
+  : m_arrayIndex(-1)
+  , m_arraySize(-1)
+  , m_maxIndex(-1)
+  , m_writingArray(false)
+{
+}
+
+/**
+ * Returns the value of the given @a key, or @a defaultValue if the setting
+ * does not exist
+ */
+QVariant Misc::Settings::value(const QString &key,
+                               const QVariant &defaultValue) const
+{
+  return SettingsStore::instance().value(arrayKey(key), defaultValue);
+}
+
+/**
+ * Changes the @a value of the given @a key
+ */
+void Misc::Settings::setValue(const QString &key, const QVariant &value)
+{
+  SettingsStore::instance().setValue(arrayKey(key), value);
+}
+
+/**
+ * Starts reading the array stored with the given @a prefix & returns its
+ * size
+ */
+int Misc::Settings::beginReadArray(const QString &prefix)
+{
+  m_array = prefix;
+  m_arrayIndex = -1;
+  m_writingArray = false;
+  return SettingsStore::instance().value(prefix + "/size", 0).toInt();
+}
+
+/**
+ * Starts writing an array with the given @a prefix. If @a size is -1, the
+ * size is determined by the highest index that is written.
+ */
+void Misc::Settings::beginWriteArray(const QString &prefix, const int size)
+{
+  m_array = prefix;
+  m_arrayIndex = -1;
+  m_arraySize = size;
+  m_maxIndex = -1;
+  m_writingArray = true;
+}
+
+/**
+ * Selects the array element used by @c value() & @c setValue()
+ */
+void Misc::Settings::setArrayIndex(const int index)
+{
+  m_arrayIndex = index;
+  m_maxIndex = qMax(m_maxIndex, index);
+}
+
+/**
+ * Finishes reading or writing the current array
+ */
+void Misc::Settings::endArray()
+{
+  if (m_writingArray)
+  {
+    const int size = m_arraySize >= 0 ? m_arraySize : m_maxIndex + 1;
+    SettingsStore::instance().setValue(m_array + "/size", size);
+  }
+
+  m_array.clear();
+  m_arrayIndex = -1;
+  m_arraySize = -1;
+  m_maxIndex = -1;
+  m_writingArray = false;
+}
+
+/**
+ * Returns the full key of the given @a key, taking the current array element
+ * into account (array indexes are stored starting at 1, like @c QSettings)
+ */
+QString Misc::Settings::arrayKey(const QString &key) const
+{
+  if (m_array.isEmpty() || m_arrayIndex < 0)
+    return key;
+
+  return QStringLiteral("%1/%2/%3").arg(m_array).arg(m_arrayIndex + 1).arg(key);
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+#include <QObject>
+#include <QThread>
+#include <QVariant>
+#include <QSettings>
+
+namespace Misc
+{
+/**
+ * @brief The SettingsWriter class
+ *
+ * Worker object of the @c SettingsStore class, runs in its own thread and
+ * writes the modified settings to the platform backend (e.g. the Windows
+ * registry or the configuration file), so that the user interface never
+ * waits for the backend.
+ */
+class SettingsWriter : public QObject
+{
+  Q_OBJECT
+
+public:
+  SettingsWriter();
+
+public Q_SLOTS:
+  void schedule();
+  void write();
+
+private:
+  QTimer m_timer;
+  QSettings m_settings;
+};
+
+/**
+ * @brief The SettingsStore class
+ *
+ * Central, thread-safe store for the application settings. All the settings
+ * are loaded once into an in-memory cache when the store is created, reads
+ * are served from the cache & writes update the cache immediately.
+ *
+ * Modified values are not written to the platform backend by the caller.
+ * Instead, they are batched & handed to a @c SettingsWriter, which writes
+ * them in a background thread shortly after the first modification. Many
+ * consecutive changes to the same key (e.g. a slider or a plugin scripting
+ * the configuration of a driver) result in a single write. Pending changes
+ * are written synchronously by @c flush(), which is called when the
+ * application quits.
+ *
+ * Modules do not use this class directly, they use a @c Settings object,
+ * which provides the subset of the @c QSettings interface used by the
+ * application.
+ */
+class SettingsStore
+{
+private:
+  explicit SettingsStore();
+  SettingsStore(SettingsStore &&) = delete;
+  SettingsStore(const SettingsStore &) = delete;
+  SettingsStore &operator=(SettingsStore &&) = delete;
+  SettingsStore &operator=(const SettingsStore &) = delete;
+
+  ~SettingsStore();
+
+public:
+  static SettingsStore &instance();
+
+  QVariant value(const QString &key, const QVariant &defaultValue) const;
+  void setValue(const QString &key, const QVariant &value);
+  void flush();
+
+private:
+  QHash<QString, QVariant> takePending();
+
+private:
+  mutable QMutex m_mutex;
+  bool m_scheduled;
+  QHash<QString, QVariant> m_cache;
+  QHash<QString, QVariant> m_pending;
+
+  QThread m_thread;
+  SettingsWriter *m_writer;
+
+  friend class SettingsWriter;
+};
+
+/**
+ * @brief The Settings class
+ *
+ * Lightweight handle to the @c SettingsStore, with the same @c value(),
+ * @c setValue() & array functions as @c QSettings. Arrays use the same keys
+ * as @c QSettings (e.g. @c "Name/1/Key" & @c "Name/size"), so the settings
+ * written by previous versions of the application are preserved. Copies of
+ * the handle share the same store.
+ */
+class Settings
+{
+public:
+  Settings();
+
+  QVariant value(const QString &key,
+                 const QVariant &defaultValue = QVariant()) const;
+  void setValue(const QString &key, const QVariant &value);
+
+  int beginReadArray(const QString &prefix);
+  void beginWriteArray(const QString &prefix, const int size = -1);
+  void setArrayIndex(const int index);
+  void endArray();
+
+private:
+  QString arrayKey(const QString &key) const;
+
+private:
+  QString m_array;
+  int m_arrayIndex;
+  int m_arraySize;
+  int m_maxIndex;
+  bool m_writingArray;
+};
+} // namespace Misc
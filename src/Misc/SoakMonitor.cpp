@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QWidget>
+#include <QtMath>
+#include <QGroupBox>
+#include <QJsonArray>
+#include <QGridLayout>
+#include <QVBoxLayout>
+#include <QHostAddress>
+
+#include <CSV/Export.h>
+#include <MQTT/Client.h>
+#include <Plugins/Server.h>
+#include <UI/Dashboard.h>
+#include <UI/DashboardWidget.h>
+#include <Misc/Diagnostics.h>
+#include <Misc/SoakMonitor.h>
+
+#ifdef Q_OS_WIN
+#  include <windows.h>
+#endif
+
+/**
+ * Constructor function
+ */
+Misc::SoakMonitor::SoakMonitor(const SoakOptions &options)
+  : m_latencyCount(0)
+  , m_latencyTotal(0)
+  , m_options(options)
+{
+  m_options.interval = qMax(1, m_options.interval);
+
+  // clang-format off
+  connect(&m_timer, &QTimer::timeout,
+          this, &Misc::SoakMonitor::sample);
+  connect(&m_plugin, &QTcpSocket::readyRead,
+          this, [=] { (void)m_plugin.readAll(); });
+  connect(&m_plugin, &QTcpSocket::stateChanged,
+          this, [=](QAbstractSocket::SocketState state) {
+    if (state == QAbstractSocket::UnconnectedState)
+      QTimer::singleShot(1000, this, &Misc::SoakMonitor::connectPlugin);
+  });
+  // clang-format on
+}
+
+/**
+ * Destructor function, disconnects the plugin client
+ */
+Misc::SoakMonitor::~SoakMonitor()
+{
+  m_plugin.blockSignals(true);
+  m_plugin.abort();
+}
+
+/**
+ * Enables the consumers that are exercised by the soak test: CSV export,
+ * MQTT publisher, plugins server (with a local client) & dashboard widgets.
+ * Returns @c false if the soak test cannot be started.
+ */
+bool Misc::SoakMonitor::start()
+{
+  // Record the frames to CSV files
+  CSV::Export::instance().setExportEnabled(true);
+
+  // Publish the frames to the MQTT broker
+  if (!m_options.mqttHost.isEmpty())
+  {
+    auto &mqtt = MQTT::Client::instance();
+    mqtt.setClientMode(MQTT::ClientPublisher);
+    mqtt.setHost(m_options.mqttHost);
+    mqtt.setPort(m_options.mqttPort);
+    mqtt.connectToHost();
+  }
+
+  // Enable the plugins server, the client connects once the server listens
+  Plugins::Server::instance().setEnabled(true);
+  QTimer::singleShot(1000, this, &Misc::SoakMonitor::connectPlugin);
+
+  // Render the dashboard widgets every time that the frame structure changes
+  connect(&UI::Dashboard::instance(), &UI::Dashboard::widgetCountChanged, this,
+          &Misc::SoakMonitor::createWidgets);
+
+  // Print soak test configuration
+  qInfo().noquote() << QString("Soak test: sampling every %1 s, limits: "
+                               "%2 MB/h memory, %3 handles/h, %4 %/h latency")
+                           .arg(m_options.interval)
+                           .arg(m_options.maxMemoryGrowth)
+                           .arg(m_options.maxHandleGrowth)
+                           .arg(m_options.maxLatencyGrowth);
+
+  return true;
+}
+
+/**
+ * Starts sampling the health of the process, called once the pipeline has
+ * been warmed up.
+ */
+void Misc::SoakMonitor::beginSampling()
+{
+  m_samples.clear();
+  m_latencyCount = 0;
+  m_latencyTotal = 0;
+
+  m_clock.start();
+  m_timer.start(m_options.interval * 1000);
+  sample();
+}
+
+/**
+ * Fits a line to each sampled series, prints the growth rates & returns
+ * @c false if any of them exceeds the configured limits.
+ */
+bool Misc::SoakMonitor::evaluate()
+{
+  // Take the final sample
+  m_timer.stop();
+  sample();
+
+  // Trends cannot be obtained from a few samples
+  m_results = QJsonObject();
+  if (m_samples.count() < 4)
+  {
+    qWarning() << "Not enough samples to evaluate growth trends, increase "
+                  "the duration of the soak test";
+    m_results.insert("passed", true);
+    return true;
+  }
+
+  // Build the series
+  QVector<double> hours, memory, handles, latency;
+  for (const auto &sample : m_samples)
+  {
+    hours.append(sample.hours);
+    memory.append(sample.memory / (1024.0 * 1024.0));
+    handles.append(sample.handles);
+    latency.append(sample.latency);
+  }
+
+  // Obtain growth rates, latency growth is relative to the mean latency
+  double meanLatency = 0;
+  for (const auto value : latency)
+    meanLatency += value;
+
+  meanLatency = qMax(1.0, meanLatency / latency.count());
+  const auto memoryGrowth = slope(hours, memory);
+  const auto handleGrowth = slope(hours, handles);
+  const auto latencyGrowth = slope(hours, latency) / meanLatency * 100;
+
+  // Compare the frames dropped during each half of the run
+  const auto &first = m_samples.first();
+  const auto &middle = m_samples.at(m_samples.count() / 2);
+  const auto &last = m_samples.last();
+  const auto firstDrops = middle.dropped - first.dropped;
+  const auto secondDrops = last.dropped - middle.dropped;
+
+  // Check the limits
+  QStringList failures;
+  if (memoryGrowth > m_options.maxMemoryGrowth)
+    failures.append(QStringLiteral("memory"));
+  if (handleGrowth > m_options.maxHandleGrowth)
+    failures.append(QStringLiteral("handles"));
+  if (latencyGrowth > m_options.maxLatencyGrowth)
+    failures.append(QStringLiteral("latency"));
+  if (secondDrops > firstDrops)
+    failures.append(QStringLiteral("dropped frames"));
+
+  // Print results
+  qInfo().noquote() << QString("Memory growth:  %1 MB/h")
+                           .arg(memoryGrowth, 0, 'f', 2);
+  qInfo().noquote() << QString("Handle growth:  %1 handles/h")
+                           .arg(handleGrowth, 0, 'f', 2);
+  qInfo().noquote() << QString("Latency growth: %1 %/h (mean %2 us)")
+                           .arg(latencyGrowth, 0, 'f', 1)
+                           .arg(meanLatency, 0, 'f', 1);
+  qInfo().noquote() << QString("Dropped frames: %1 (first half), "
+                               "%2 (second half)")
+                           .arg(firstDrops)
+                           .arg(secondDrops);
+
+  if (failures.isEmpty())
+    qInfo() << "Soak test passed";
+  else
+    qCritical().noquote() << "Soak test failed, growing:"
+                          << failures.join(", ");
+
+  // Register results
+  m_results.insert("memoryGrowth", memoryGrowth);
+  m_results.insert("handleGrowth", handleGrowth);
+  m_results.insert("latencyGrowth", latencyGrowth);
+  m_results.insert("droppedFirstHalf", double(firstDrops));
+  m_results.insert("droppedSecondHalf", double(secondDrops));
+  m_results.insert("failures", QJsonArray::fromStringList(failures));
+  m_results.insert("passed", failures.isEmpty());
+  return failures.isEmpty();
+}
+
+/**
+ * Returns a JSON object with the configuration, the samples & the results of
+ * the soak test, which is added to the benchmark report.
+ */
+QJsonObject Misc::SoakMonitor::report() const
+{
+  QJsonArray samples;
+  for (const auto &sample : m_samples)
+  {
+    QJsonObject object;
+    object.insert("hours", sample.hours);
+    object.insert("memory", double(sample.memory));
+    object.insert("handles", sample.handles);
+    object.insert("latency", sample.latency);
+    object.insert("dropped", double(sample.dropped));
+    samples.append(object);
+  }
+
+  QJsonObject limits;
+  limits.insert("interval", m_options.interval);
+  limits.insert("maxMemoryGrowth", m_options.maxMemoryGrowth);
+  limits.insert("maxHandleGrowth", m_options.maxHandleGrowth);
+  limits.insert("maxLatencyGrowth", m_options.maxLatencyGrowth);
+
+  QJsonObject object;
+  object.insert("options", limits);
+  object.insert("samples", samples);
+  object.insert("results", m_results);
+  return object;
+}
+
+/**
+ * Samples the resident memory, the open handles, the mean latency of the
+ * frames received since the previous sample & the total number of frames
+ * dropped by the queues of the pipeline.
+ */
+void Misc::SoakMonitor::sample()
+{
+  // Get the mean latency of the frames received since the previous sample
+  auto &diagnostics = Misc::Diagnostics::instance();
+  const auto stages = diagnostics.stages();
+  const int stage = static_cast<int>(Diagnostics::Stage::FrameLatency);
+  double latency = m_samples.isEmpty() ? 0 : m_samples.last().latency;
+  if (stage < stages.count())
+  {
+    const auto map = stages.at(stage).toMap();
+    const auto count = map.value("count").toULongLong();
+    const auto total = map.value("mean").toDouble() * count;
+    if (count > m_latencyCount)
+      latency = (total - m_latencyTotal) / (count - m_latencyCount);
+
+    m_latencyCount = count;
+    m_latencyTotal = total;
+  }
+
+  // Get the number of dropped frames
+  quint64 dropped = 0;
+  Q_FOREACH (const auto &queue, diagnostics.queues())
+    dropped += queue.toMap().value("dropped").toULongLong();
+
+  // Register sample
+  Sample sample;
+  sample.hours = m_clock.elapsed() / 3600000.0;
+  sample.memory = Diagnostics::residentMemory();
+  sample.handles = handleCount();
+  sample.latency = latency;
+  sample.dropped = dropped;
+  m_samples.append(sample);
+
+  // Print sample
+  qInfo().noquote() << QString("[%1 h] %2 MB, %3 handles, %4 us latency, "
+                               "%5 frames dropped")
+                           .arg(sample.hours, 0, 'f', 2)
+                           .arg(sample.memory / (1024.0 * 1024.0), 0, 'f', 1)
+                           .arg(sample.handles)
+                           .arg(sample.latency, 0, 'f', 1)
+                           .arg(sample.dropped);
+}
+
+/**
+ * Constructs the QtWidgets implementation of every dashboard widget in a
+ * window of the offscreen platform, so that the widgets are updated & painted
+ * at the render rate, just like in the user interface.
+ */
+void Misc::SoakMonitor::createWidgets()
+{
+  // Delete previous widgets
+  m_dashboard.reset();
+  auto &dashboard = UI::Dashboard::instance();
+  const int count = dashboard.totalWidgetCount();
+  if (count <= 0)
+    return;
+
+  // Create the widgets
+  m_dashboard.reset(new QWidget);
+  auto layout = new QGridLayout(m_dashboard.data());
+  const auto titles = dashboard.widgetTitles();
+  const int columns = qCeil(qSqrt(count));
+  for (int i = 0, cell = 0; i < count; ++i)
+  {
+    auto widget = UI::DashboardWidget::constructWidget(
+        dashboard.widgetType(i), dashboard.relativeIndex(i));
+    if (!widget)
+      continue;
+
+    auto box = new QGroupBox(titles.value(i));
+    auto boxLayout = new QVBoxLayout(box);
+    boxLayout->addWidget(widget);
+    layout->addWidget(box, cell / columns, cell % columns);
+    ++cell;
+  }
+
+  // Show the widgets
+  m_dashboard->resize(1280, 720);
+  m_dashboard->show();
+}
+
+/**
+ * Connects the plugin client to the plugins server, the connection is retried
+ * every second if it fails or if it is lost.
+ */
+void Misc::SoakMonitor::connectPlugin()
+{
+  if (m_plugin.state() == QAbstractSocket::UnconnectedState)
+    m_plugin.connectToHost(QHostAddress::LocalHost, PLUGINS_TCP_PORT);
+}
+
+/**
+ * Returns the number of handles opened by the process (file descriptors on
+ * UNIX systems), or 0 if it cannot be obtained on the current platform.
+ */
+int Misc::SoakMonitor::handleCount()
+{
+#if defined(Q_OS_WIN)
+  DWORD count = 0;
+  if (!GetProcessHandleCount(GetCurrentProcess(), &count))
+    return 0;
+
+  return static_cast<int>(count);
+#elif defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#  if defined(Q_OS_LINUX)
+  const QDir dir(QStringLiteral("/proc/self/fd"));
+#  else
+  const QDir dir(QStringLiteral("/dev/fd"));
+#  endif
+  const auto filters = QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot;
+  return dir.entryList(filters).count();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Returns the slope of the least-squares line fitted to the given points
+ */
+double Misc::SoakMonitor::slope(const QVector<double> &x,
+                                const QVector<double> &y)
+{
+  const int n = qMin(x.count(), y.count());
+  if (n < 2)
+    return 0;
+
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    sx += x.at(i);
+    sy += y.at(i);
+    sxx += x.at(i) * x.at(i);
+    sxy += x.at(i) * y.at(i);
+  }
+
+  const double denominator = n * sxx - sx * sx;
+  if (qFuzzyIsNull(denominator))
+    return 0;
+
+  return (n * sxy - sx * sy) / denominator;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QTcpSocket>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+
+class QWidget;
+
+namespace Misc
+{
+/**
+ * @brief Configuration of the soak test mode
+ *
+ * Growth limits are expressed per hour of run time: resident memory in MB,
+ * open handles in handles & frame latency in percent of the initial latency.
+ */
+struct SoakOptions
+{
+  bool enabled = false;
+  int interval = 60;
+  QString mqttHost;
+  quint16 mqttPort = 1883;
+  double maxMemoryGrowth = 16;
+  double maxHandleGrowth = 4;
+  double maxLatencyGrowth = 50;
+};
+
+/**
+ * @brief The SoakMonitor class
+ *
+ * Runs the consumers of a full deployment next to the synthetic device of the
+ * benchmark & samples the health of the process during long runs, so that
+ * leaks & slowdowns that only appear after hours of operation are detected.
+ *
+ * While the soak test runs, the monitor:
+ * - Renders every dashboard widget in a window of the offscreen platform.
+ * - Records the received frames to CSV files.
+ * - Publishes the frames to an MQTT broker (if one is configured).
+ * - Enables the plugins server & connects a plugin client that reads the
+ *   data sent by the server.
+ *
+ * Every @c SoakOptions::interval seconds, the resident memory, the number of
+ * open handles (file descriptors on UNIX), the mean frame latency & the number
+ * of dropped frames are sampled. When the run finishes, a least-squares line
+ * is fitted to each series & the test fails if any of them grows faster than
+ * the configured limits, or if more frames were dropped during the second half
+ * of the run than during the first one.
+ */
+class SoakMonitor : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit SoakMonitor(const SoakOptions &options);
+  ~SoakMonitor();
+
+  bool start();
+  void beginSampling();
+  bool evaluate();
+  QJsonObject report() const;
+
+private Q_SLOTS:
+  void sample();
+  void createWidgets();
+  void connectPlugin();
+
+private:
+  static int handleCount();
+  static double slope(const QVector<double> &x, const QVector<double> &y);
+
+private:
+  struct Sample
+  {
+    double hours;
+    qint64 memory;
+    int handles;
+    double latency;
+    quint64 dropped;
+  };
+
+  quint64 m_latencyCount;
+  double m_latencyTotal;
+
+  QTimer m_timer;
+  QTcpSocket m_plugin;
+  QElapsedTimer m_clock;
+  QJsonObject m_results;
+  QVector<Sample> m_samples;
+  QScopedPointer<QWidget> m_dashboard;
+
+  SoakOptions m_options;
+};
+} // namespace Misc
@@ -22,6 +22,7 @@
 
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QPalette>
 #include <QProcess>
 #include <QJsonArray>
@@ -230,8 +231,13 @@ void Misc::ThemeManager::loadTheme(const int id)
 }
 
 /**
- * Reads all the available theme files from the application resources
- * folder.
+ * Reads the paths of all the available theme files from the application
+ * resources folder.
+ *
+ * Only the file list is obtained here, the name of each theme is read when
+ * the theme list is first requested (see @c availableThemes()), so that the
+ * startup of the application only needs to parse the selected theme.
+ *
  * @note theme definitions are bundled during the compilatopn process.
  */
 void Misc::ThemeManager::populateThemes()
@@ -242,25 +248,8 @@ void Misc::ThemeManager::populateThemes()
 
   // Scan themes directory & get list of files
   auto themeList = QDir(":/themes").entryList();
-
-  // Open each JSON file & get theme names
   for (int i = 0; i < themeList.count(); ++i)
-  {
-    QFile file(QString(":/themes/%1").arg(themeList.at(i)));
-    if (file.open(QFile::ReadOnly))
-    {
-      auto data = file.readAll();
-      file.close();
-
-      auto document = QJsonDocument::fromJson(data);
-      auto name = document.object().value("name").toString();
-      if (!name.isEmpty())
-      {
-        m_availableThemes.append(name);
-        m_availableThemesPaths.append(file.fileName());
-      }
-    }
-  }
+    m_availableThemesPaths.append(QString(":/themes/%1").arg(themeList.at(i)));
 
   // Update UI
   Q_EMIT availableThemesChanged();
@@ -517,5 +506,28 @@ StringList Misc::ThemeManager::widgetColors() const
 
 StringList Misc::ThemeManager::availableThemes() const
 {
+  // Theme names already read
+  if (m_availableThemes.count() == m_availableThemesPaths.count())
+    return m_availableThemes;
+
+  // Open each JSON file & get theme names, use the file name as fallback
+  m_availableThemes.clear();
+  Q_FOREACH (const auto &path, m_availableThemesPaths)
+  {
+    QString name;
+    QFile file(path);
+    if (file.open(QFile::ReadOnly))
+    {
+      auto document = QJsonDocument::fromJson(file.readAll());
+      name = document.object().value("name").toString();
+      file.close();
+    }
+
+    if (name.isEmpty())
+      name = QFileInfo(path).baseName();
+
+    m_availableThemes.append(name);
+  }
+
   return m_availableThemes;
 }
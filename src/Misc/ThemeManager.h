@@ -24,9 +24,10 @@
 
 #include <QColor>
 #include <QObject>
-#include <QSettings>
 #include <DataTypes.h>
 
+#include <Misc/Settings.h>
+
 namespace Misc
 {
 /**
@@ -285,9 +286,9 @@ private:
   int m_themeId;
   bool m_customWindowDecorations;
 
-  QSettings m_settings;
+  Misc::Settings m_settings;
   bool m_titlebarSeparator;
-  StringList m_availableThemes;
+  mutable StringList m_availableThemes;
   StringList m_availableThemesPaths;
 
   QColor m_base;
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QThread>
+#include <QObject>
+#include <QtGlobal>
+
+#include <Misc/ThreadScheduler.h>
+
+#if defined(Q_OS_WIN)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+/**
+ * Returns the number of logical CPU cores of the computer
+ */
+int Misc::ThreadScheduler::cpuCount()
+{
+  return qMax(1, QThread::idealThreadCount());
+}
+
+/**
+ * Returns the list of options displayed by the user interface to select a CPU
+ * core, the first option ("Any CPU") corresponds to the index -1.
+ */
+StringList Misc::ThreadScheduler::cpuNames()
+{
+  StringList list;
+  list.append(QObject::tr("Any CPU"));
+  for (int i = 0; i < cpuCount(); ++i)
+    list.append(QObject::tr("CPU %1").arg(i));
+
+  return list;
+}
+
+/**
+ * Pins the calling thread to the given @a cpu core, or allows it to run on
+ * any core if @a cpu is negative. Returns @c false if the operating system
+ * rejected the request.
+ */
+bool Misc::ThreadScheduler::setAffinity(const int cpu)
+{
+  // Validate the CPU index
+  const int count = cpuCount();
+  if (cpu >= count)
+    return false;
+
+#if defined(Q_OS_WIN)
+  DWORD_PTR mask = 0;
+  if (cpu < 0)
+  {
+    DWORD_PTR system = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &mask, &system))
+      return false;
+  }
+  else
+    mask = DWORD_PTR(1) << cpu;
+
+  return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(Q_OS_LINUX)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (cpu < 0)
+  {
+    for (int i = 0; i < count; ++i)
+      CPU_SET(i, &set);
+  }
+  else
+    CPU_SET(cpu, &set);
+
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return cpu < 0;
+#endif
+}
+
+/**
+ * Enables or disables real-time scheduling for the calling thread. Returns
+ * @c false if the operating system rejected the request, e.g. because the
+ * process lacks the required privileges.
+ */
+bool Misc::ThreadScheduler::setRealtimePriority(const bool enabled)
+{
+#if defined(Q_OS_WIN)
+  const int priority
+      = enabled ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_NORMAL;
+  return SetThreadPriority(GetCurrentThread(), priority) != 0;
+#else
+  sched_param param;
+  int policy = SCHED_OTHER;
+  param.sched_priority = 0;
+
+  // Use a priority in the middle of the real-time range, so that the kernel
+  // threads that handle the device interrupts still preempt the reader
+  if (enabled)
+  {
+    policy = SCHED_FIFO;
+    const int min = sched_get_priority_min(SCHED_FIFO);
+    const int max = sched_get_priority_max(SCHED_FIFO);
+    param.sched_priority = min + (max - min) / 2;
+  }
+
+  return pthread_setschedparam(pthread_self(), policy, &param) == 0;
+#endif
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <DataTypes.h>
+
+namespace Misc
+{
+/**
+ * @brief The ThreadScheduler class
+ *
+ * Changes the scheduling of the calling thread at the operating system level,
+ * these functions must be called from the thread that should be configured.
+ *
+ * - @c setRealtimePriority() switches the thread to the @c SCHED_FIFO policy
+ *   on Linux & macOS, or to @c THREAD_PRIORITY_TIME_CRITICAL on Windows, so
+ *   that background jobs cannot preempt it. Real-time scheduling requires
+ *   additional privileges on Linux (e.g. @c CAP_SYS_NICE or an @c rtprio
+ *   limit), if they are missing the thread keeps its normal priority.
+ * - @c setAffinity() pins the thread to a single CPU core, or lets it run on
+ *   any core if the given index is negative. macOS does not allow pinning
+ *   threads, so the function always fails there.
+ */
+class ThreadScheduler
+{
+public:
+  static int cpuCount();
+  static StringList cpuNames();
+  static bool setAffinity(const int cpu);
+  static bool setRealtimePriority(const bool enabled);
+};
+} // namespace Misc
@@ -20,9 +20,70 @@
  * THE SOFTWARE.
  */
 
+#include <QScreen>
+#include <QWindow>
 #include <QTimerEvent>
+#include <QGuiApplication>
 #include <Misc/TimerEvents.h>
 
+/**
+ * Lowest frequency (in Hz) that the adaptive mode uses while the application
+ * windows are visible, and the frequency used while they are minimized.
+ */
+static const int MIN_RENDER_FREQUENCY = 5;
+static const int HIDDEN_RENDER_FREQUENCY = 1;
+
+/**
+ * Fraction of time spent updating the UI above which the render frequency is
+ * lowered, and below which it is raised back to the selected rate.
+ */
+static const qreal HIGH_RENDER_LOAD = 0.5;
+static const qreal LOW_RENDER_LOAD = 0.25;
+
+/**
+ * Fraction of render ticks arriving late above which the render frequency is
+ * lowered, and below which it may be raised.
+ */
+static const qreal HIGH_LATE_TICKS = 0.25;
+static const qreal LOW_LATE_TICKS = 0.1;
+
+/**
+ * Returns the interval (in milliseconds) of a timer running at @a rate Hz
+ */
+static int INTERVAL(const int rate)
+{
+  return qMax(1, 1000 / qMax(1, rate));
+}
+
+/**
+ * Constructor function, reads the timer rates selected by the user
+ */
+Misc::TimerEvents::TimerEvents()
+  : m_renderRate(m_settings.value("TimerEvents_RenderRate", 0).toInt())
+  , m_pluginsRate(m_settings.value("TimerEvents_PluginsRate", 1).toInt())
+  , m_csvExportRate(m_settings.value("TimerEvents_CsvExportRate", 10).toInt())
+  , m_renderFrequency(0)
+  , m_adaptiveRendering(
+        m_settings.value("TimerEvents_AdaptiveRendering", false).toBool())
+  , m_idleMode(m_settings.value("TimerEvents_IdleMode", false).toBool())
+  , m_idle(false)
+  , m_running(false)
+  , m_dataSourceActive(true)
+  , m_renderTicks(0)
+  , m_lateRenderTicks(0)
+  , m_renderLoad(0)
+{
+  // Validate rates read from the settings
+  m_renderRate = qMax(0, m_renderRate);
+  m_pluginsRate = qMax(1, m_pluginsRate);
+  m_csvExportRate = qMax(1, m_csvExportRate);
+  m_renderFrequency = targetFrequency();
+
+  // React immediately when the application is hidden or shown again
+  connect(qApp, &QGuiApplication::applicationStateChanged, this,
+          &Misc::TimerEvents::updateRenderFrequency);
+}
+
 /**
  * Returns a pointer to the only instance of the class
  */
@@ -37,9 +98,75 @@ Misc::TimerEvents &Misc::TimerEvents::instance()
  */
 void Misc::TimerEvents::stopTimers()
 {
+  m_running = false;
   m_timer1Hz.stop();
   m_timer10Hz.stop();
   m_timer20Hz.stop();
+  m_renderTimer.stop();
+  m_pluginsTimer.stop();
+  m_csvExportTimer.stop();
+}
+
+/**
+ * Returns the maximum repaint rate selected by the user (in Hz), a value of 0
+ * means that the widgets are repainted at the refresh rate of the display.
+ */
+int Misc::TimerEvents::renderRate() const
+{
+  return m_renderRate;
+}
+
+/**
+ * Returns the rate (in Hz) at which processed frames are sent to the clients
+ * connected to the plugins server.
+ */
+int Misc::TimerEvents::pluginsRate() const
+{
+  return m_pluginsRate;
+}
+
+/**
+ * Returns the rate (in Hz) at which buffered frames are written to the CSV
+ * file.
+ */
+int Misc::TimerEvents::csvExportRate() const
+{
+  return m_csvExportRate;
+}
+
+/**
+ * Returns the effective frequency of the render timer (in Hz), which may be
+ * lower than the selected render rate when adaptive rendering is enabled.
+ */
+int Misc::TimerEvents::renderFrequency() const
+{
+  return m_renderFrequency;
+}
+
+/**
+ * Returns @c true if the render frequency is adjusted automatically depending
+ * on the load of the user interface.
+ */
+bool Misc::TimerEvents::adaptiveRendering() const
+{
+  return m_adaptiveRendering;
+}
+
+/**
+ * Returns @c true if the timers are stopped while no data source is active
+ */
+bool Misc::TimerEvents::idleMode() const
+{
+  return m_idleMode;
+}
+
+/**
+ * Returns @c true if the idle mode is enabled & no data source is active, in
+ * which case only the coarse 1 Hz timer is running.
+ */
+bool Misc::TimerEvents::idle() const
+{
+  return m_idle;
 }
 
 /**
@@ -48,21 +175,303 @@ void Misc::TimerEvents::stopTimers()
 void Misc::TimerEvents::timerEvent(QTimerEvent *event)
 {
   if (event->timerId() == m_timer1Hz.timerId())
+  {
     Q_EMIT timeout1Hz();
+    updateRenderFrequency();
+  }
 
   else if (event->timerId() == m_timer10Hz.timerId())
     Q_EMIT timeout10Hz();
 
   else if (event->timerId() == m_timer20Hz.timerId())
     Q_EMIT timeout20Hz();
+
+  else if (event->timerId() == m_pluginsTimer.timerId())
+    Q_EMIT timeoutPlugins();
+
+  else if (event->timerId() == m_csvExportTimer.timerId())
+    Q_EMIT timeoutCsvExport();
+
+  else if (event->timerId() == m_renderTimer.timerId())
+  {
+    // Count the ticks that arrive late, the event loop is falling behind
+    const auto interval = INTERVAL(m_renderFrequency);
+    if (m_renderTickTimer.isValid())
+    {
+      ++m_renderTicks;
+      if (m_renderTickTimer.elapsed() > interval + interval / 2)
+        ++m_lateRenderTicks;
+    }
+
+    m_renderTickTimer.start();
+    Q_EMIT timeoutRender();
+  }
 }
 
 /**
- * Starts all the timer of the module
+ * Starts all the timer of the module, or only the coarse 1 Hz timer if the
+ * application is idle
  */
 void Misc::TimerEvents::startTimers()
 {
+  m_running = true;
+  if (m_idle)
+  {
+    m_timer1Hz.start(1000, Qt::VeryCoarseTimer, this);
+    return;
+  }
+
   m_timer20Hz.start(50, this);
   m_timer10Hz.start(100, this);
   m_timer1Hz.start(1000, this);
+  m_pluginsTimer.start(INTERVAL(m_pluginsRate), this);
+  m_csvExportTimer.start(INTERVAL(m_csvExportRate), this);
+  startRenderTimer();
+}
+
+/**
+ * Changes the maximum repaint @a rate of the dashboard widgets (in Hz), set
+ * to 0 to repaint the widgets at the refresh rate of the display.
+ */
+void Misc::TimerEvents::setRenderRate(const int rate)
+{
+  const auto value = qMax(0, rate);
+  if (m_renderRate != value)
+  {
+    m_renderRate = value;
+    m_settings.setValue("TimerEvents_RenderRate", value);
+    Q_EMIT renderRateChanged();
+
+    m_renderFrequency = targetFrequency();
+    if (m_renderTimer.isActive())
+      startRenderTimer();
+
+    Q_EMIT renderFrequencyChanged();
+  }
+}
+
+/**
+ * Changes the @a rate (in Hz) at which processed frames are sent to the
+ * clients connected to the plugins server.
+ */
+void Misc::TimerEvents::setPluginsRate(const int rate)
+{
+  const auto value = qMax(1, rate);
+  if (m_pluginsRate != value)
+  {
+    m_pluginsRate = value;
+    m_settings.setValue("TimerEvents_PluginsRate", value);
+
+    if (m_pluginsTimer.isActive())
+      m_pluginsTimer.start(INTERVAL(value), this);
+
+    Q_EMIT pluginsRateChanged();
+  }
+}
+
+/**
+ * Changes the @a rate (in Hz) at which buffered frames are written to the
+ * CSV file.
+ */
+void Misc::TimerEvents::setCsvExportRate(const int rate)
+{
+  const auto value = qMax(1, rate);
+  if (m_csvExportRate != value)
+  {
+    m_csvExportRate = value;
+    m_settings.setValue("TimerEvents_CsvExportRate", value);
+
+    if (m_csvExportTimer.isActive())
+      m_csvExportTimer.start(INTERVAL(value), this);
+
+    Q_EMIT csvExportRateChanged();
+  }
+}
+
+/**
+ * Registers that @a nsecs nanoseconds were spent processing frames or
+ * updating the user interface, this is used by the adaptive mode to decide
+ * if the render frequency should be lowered or raised.
+ */
+void Misc::TimerEvents::reportRenderLoad(const qint64 nsecs)
+{
+  if (m_adaptiveRendering && nsecs > 0)
+    m_renderLoad += nsecs;
+}
+
+/**
+ * Enables or disables the automatic adjustment of the render frequency
+ */
+void Misc::TimerEvents::setAdaptiveRendering(const bool enabled)
+{
+  if (m_adaptiveRendering != enabled)
+  {
+    m_adaptiveRendering = enabled;
+    m_settings.setValue("TimerEvents_AdaptiveRendering", enabled);
+    Q_EMIT adaptiveRenderingChanged();
+
+    updateRenderFrequency();
+  }
+}
+
+/**
+ * Enables or disables the idle mode, in which the timers are stopped while
+ * no data source is active
+ */
+void Misc::TimerEvents::setIdleMode(const bool enabled)
+{
+  if (m_idleMode != enabled)
+  {
+    m_idleMode = enabled;
+    m_settings.setValue("TimerEvents_IdleMode", enabled);
+    Q_EMIT idleModeChanged();
+
+    updateIdleState();
+  }
+}
+
+/**
+ * Registers if a data source (e.g. a connected device or an open CSV file) is
+ * active, the timers are stopped while no data source is active & the idle
+ * mode is enabled. Data sources are considered active until this function is
+ * called, so that modes without a user interface are never idle.
+ */
+void Misc::TimerEvents::setDataSourceActive(const bool active)
+{
+  if (m_dataSourceActive != active)
+  {
+    m_dataSourceActive = active;
+    updateIdleState();
+  }
+}
+
+/**
+ * Evaluates the load measured since the last call & adjusts the frequency of
+ * the render timer accordingly.
+ *
+ * The frequency is halved when more than half of the time is spent updating
+ * the UI (or when the render ticks arrive late), and raised by 25% when the
+ * load is low, up to the rate selected by the user. While the application
+ * windows are minimized, the widgets are only refreshed once per second.
+ */
+void Misc::TimerEvents::updateRenderFrequency()
+{
+  // Calculate load & ratio of late ticks since the last evaluation
+  const auto window = m_loadTimer.isValid() ? m_loadTimer.nsecsElapsed() : 0;
+  const auto load = window > 0 ? qreal(m_renderLoad) / window : 0;
+  const auto late = m_renderTicks > 0
+                        ? qreal(m_lateRenderTicks) / m_renderTicks
+                        : 0;
+
+  // Reset the measurements
+  m_renderLoad = 0;
+  m_renderTicks = 0;
+  m_lateRenderTicks = 0;
+  m_loadTimer.start();
+
+  // Obtain the new render frequency
+  const auto target = targetFrequency();
+  auto frequency = target;
+  if (m_adaptiveRendering)
+  {
+    const auto current = qMax(m_renderFrequency, MIN_RENDER_FREQUENCY);
+    if (windowsMinimized())
+      frequency = HIDDEN_RENDER_FREQUENCY;
+    else if (m_renderFrequency < MIN_RENDER_FREQUENCY)
+      frequency = target;
+    else if (load > HIGH_RENDER_LOAD || late > HIGH_LATE_TICKS)
+      frequency = qMax(MIN_RENDER_FREQUENCY, current / 2);
+    else if (load < LOW_RENDER_LOAD && late < LOW_LATE_TICKS)
+      frequency = qMax(current + 1, current * 5 / 4);
+    else
+      frequency = current;
+
+    frequency = qMin(frequency, target);
+  }
+
+  // Update the render timer
+  if (m_renderFrequency != frequency)
+  {
+    m_renderFrequency = frequency;
+    if (m_renderTimer.isActive())
+      startRenderTimer();
+
+    Q_EMIT renderFrequencyChanged();
+  }
+}
+
+/**
+ * Returns the render frequency (in Hz) selected by the user, or the refresh
+ * rate of the display if the user did not select a specific rate.
+ */
+int Misc::TimerEvents::targetFrequency() const
+{
+  if (m_renderRate > 0)
+    return m_renderRate;
+
+  auto screen = QGuiApplication::primaryScreen();
+  if (screen && screen->refreshRate() >= 1)
+    return qRound(screen->refreshRate());
+
+  return 60;
+}
+
+/**
+ * Returns @c true if the application is hidden or if none of its windows are
+ * visible on the screen (e.g. all of them are minimized).
+ */
+bool Misc::TimerEvents::windowsMinimized() const
+{
+  const auto state = QGuiApplication::applicationState();
+  if (state == Qt::ApplicationHidden || state == Qt::ApplicationSuspended)
+    return true;
+
+  const auto windows = QGuiApplication::topLevelWindows();
+  if (windows.isEmpty())
+    return false;
+
+  for (const auto *window : windows)
+  {
+    const auto visibility = window->visibility();
+    if (visibility != QWindow::Hidden && visibility != QWindow::Minimized)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Enters or leaves the idle state depending on the idle mode & on the state
+ * of the data sources, restarting the timers if they are running. When the
+ * application leaves the idle state, a render tick is emitted immediately so
+ * that the user interface does not wait for the render timer.
+ */
+void Misc::TimerEvents::updateIdleState()
+{
+  // Nothing to do
+  const bool idle = m_idleMode && !m_dataSourceActive;
+  if (m_idle == idle)
+    return;
+
+  // Restart the timers with the new state
+  m_idle = idle;
+  if (m_running)
+  {
+    stopTimers();
+    startTimers();
+  }
+
+  // Notify the user interface
+  Q_EMIT idleChanged();
+  if (!m_idle && m_running)
+    Q_EMIT timeoutRender();
+}
+
+/**
+ * (Re)starts the render timer with the current render frequency
+ */
+void Misc::TimerEvents::startRenderTimer()
+{
+  m_renderTickTimer.invalidate();
+  m_renderTimer.start(INTERVAL(m_renderFrequency), Qt::PreciseTimer, this);
 }
@@ -24,6 +24,9 @@
 
 #include <QObject>
 #include <QBasicTimer>
+#include <QElapsedTimer>
+
+#include <Misc/Settings.h>
 
 namespace Misc
 {
@@ -32,18 +35,76 @@ namespace Misc
  *
  * The @c TimerEvents class implements periodic timers that are used to update
  * the user interface elements at a specific frequency.
+ *
+ * The render timer is used to schedule the repaints of the dashboard widgets,
+ * by default it runs at the refresh rate of the display, but the user can
+ * choose a lower rate to reduce CPU usage.
+ *
+ * The CSV export and plugin timers drive the modules that periodically flush
+ * or send data, their rates can be configured by the user.
+ *
+ * When adaptive rendering is enabled, the render frequency is lowered while
+ * the UI cannot keep up with the incoming data (or while the application
+ * windows are minimized) and raised back to the selected rate when there is
+ * headroom again. Modules report the time they spend updating the UI through
+ * @c reportRenderLoad().
+ *
+ * When the idle mode is enabled & no data source is active (see
+ * @c setDataSourceActive()), all timers except the 1 Hz timer are stopped,
+ * and the 1 Hz timer is switched to a very coarse timer that the operating
+ * system can coalesce with other wakeups. The dashboard is not rendered
+ * while the application is idle. The timers are restarted (and a render tick
+ * is emitted) as soon as a data source becomes active again.
  */
 class TimerEvents : public QObject
 {
-  Q_OBJECT
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int renderRate
+               READ renderRate
+               WRITE setRenderRate
+               NOTIFY renderRateChanged)
+    Q_PROPERTY(int renderFrequency
+               READ renderFrequency
+               NOTIFY renderFrequencyChanged)
+    Q_PROPERTY(int csvExportRate
+               READ csvExportRate
+               WRITE setCsvExportRate
+               NOTIFY csvExportRateChanged)
+    Q_PROPERTY(int pluginsRate
+               READ pluginsRate
+               WRITE setPluginsRate
+               NOTIFY pluginsRateChanged)
+    Q_PROPERTY(bool adaptiveRendering
+               READ adaptiveRendering
+               WRITE setAdaptiveRendering
+               NOTIFY adaptiveRenderingChanged)
+    Q_PROPERTY(bool idleMode
+               READ idleMode
+               WRITE setIdleMode
+               NOTIFY idleModeChanged)
+    Q_PROPERTY(bool idle
+               READ idle
+               NOTIFY idleChanged)
+  // clang-format on
 
 Q_SIGNALS:
   void timeout1Hz();
   void timeout10Hz();
   void timeout20Hz();
+  void timeoutRender();
+  void timeoutPlugins();
+  void timeoutCsvExport();
+  void renderRateChanged();
+  void pluginsRateChanged();
+  void csvExportRateChanged();
+  void renderFrequencyChanged();
+  void adaptiveRenderingChanged();
+  void idleModeChanged();
+  void idleChanged();
 
 private:
-  TimerEvents(){};
+  TimerEvents();
   TimerEvents(TimerEvents &&) = delete;
   TimerEvents(const TimerEvents &) = delete;
   TimerEvents &operator=(TimerEvents &&) = delete;
@@ -52,16 +113,60 @@ private:
 public:
   static TimerEvents &instance();
 
+  int renderRate() const;
+  int pluginsRate() const;
+  int csvExportRate() const;
+  int renderFrequency() const;
+  bool adaptiveRendering() const;
+  bool idleMode() const;
+  bool idle() const;
+
 protected:
   void timerEvent(QTimerEvent *event) override;
 
 public Q_SLOTS:
   void stopTimers();
   void startTimers();
+  void setRenderRate(const int rate);
+  void setPluginsRate(const int rate);
+  void setCsvExportRate(const int rate);
+  void reportRenderLoad(const qint64 nsecs);
+  void setAdaptiveRendering(const bool enabled);
+  void setIdleMode(const bool enabled);
+  void setDataSourceActive(const bool active);
+
+private Q_SLOTS:
+  void updateRenderFrequency();
+
+private:
+  int targetFrequency() const;
+  bool windowsMinimized() const;
+  void startRenderTimer();
+  void updateIdleState();
 
 private:
+  int m_renderRate;
+  int m_pluginsRate;
+  int m_csvExportRate;
+  int m_renderFrequency;
+  bool m_adaptiveRendering;
+  bool m_idleMode;
+  bool m_idle;
+  bool m_running;
+  bool m_dataSourceActive;
+
+  int m_renderTicks;
+  int m_lateRenderTicks;
+  qint64 m_renderLoad;
+  QElapsedTimer m_loadTimer;
+  QElapsedTimer m_renderTickTimer;
+
+  Misc::Settings m_settings;
   QBasicTimer m_timer1Hz;
   QBasicTimer m_timer10Hz;
   QBasicTimer m_timer20Hz;
+  QBasicTimer m_renderTimer;
+  QBasicTimer m_pluginsTimer;
+  QBasicTimer m_csvExportTimer;
 };
 } // namespace Misc
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <chrono>
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QFileDialog>
+#include <QCoreApplication>
+
+#include <Misc/Tracer.h>
+#include <Misc/Utilities.h>
+
+/**
+ * Maximum number of events stored in memory while tracing
+ */
+static const int MAX_TRACE_EVENTS = 2 * 1000 * 1000;
+
+/**
+ * Constructor function
+ */
+Misc::Tracer::Tracer()
+  : m_startTime(0)
+  , m_discarded(0)
+  , m_tracing(false)
+{
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Misc::Tracer &Misc::Tracer::instance()
+{
+  static Tracer singleton;
+  return singleton;
+}
+
+/**
+ * Returns @c true if trace events are being recorded
+ */
+bool Misc::Tracer::tracing() const
+{
+  return m_tracing.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the current value (in nanoseconds) of the monotonic clock used to
+ * timestamp the trace events.
+ */
+qint64 Misc::Tracer::timestamp()
+{
+  using namespace std::chrono;
+  const auto now = steady_clock::now().time_since_epoch();
+  return duration_cast<nanoseconds>(now).count();
+}
+
+/**
+ * Registers an event with the given @a name that started at @a begin and
+ * finished at @a end (see @c timestamp()) in the calling thread.
+ */
+void Misc::Tracer::addEvent(const char *name, const qint64 begin,
+                            const qint64 end)
+{
+  if (!tracing())
+    return;
+
+  QMutexLocker locker(&m_mutex);
+  if (m_events.count() >= MAX_TRACE_EVENTS)
+  {
+    ++m_discarded;
+    return;
+  }
+
+  m_events.append(Event {name, begin, end, threadId()});
+}
+
+/**
+ * Discards previously recorded events & starts recording trace events
+ */
+void Misc::Tracer::startTracing()
+{
+  if (tracing())
+    return;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    m_events.clear();
+    m_discarded = 0;
+    m_startTime = timestamp();
+  }
+
+  m_tracing = true;
+  Q_EMIT tracingChanged();
+}
+
+/**
+ * Stops recording trace events & asks the user where to save the trace file
+ */
+void Misc::Tracer::stopTracing()
+{
+  if (!tracing())
+    return;
+
+  m_tracing = false;
+  Q_EMIT tracingChanged();
+
+  // Get file name
+  auto path = QFileDialog::getSaveFileName(
+      Q_NULLPTR, tr("Save trace"), QDir::homePath(),
+      tr("Chrome trace files") + " (*.json)");
+
+  // Write the trace file
+  if (!path.isEmpty() && save(path))
+    Misc::Utilities::revealFile(path);
+
+  // Release memory
+  QMutexLocker locker(&m_mutex);
+  m_events.clear();
+  m_events.squeeze();
+}
+
+/**
+ * Writes the recorded events to the file at the given @a path, using the
+ * JSON trace event format. Each event is written as a complete ("X") event,
+ * and the name of each thread is written as a metadata ("M") event.
+ */
+bool Misc::Tracer::save(const QString &path)
+{
+  // Open file
+  QFile file(path);
+  if (!file.open(QFile::WriteOnly | QFile::Truncate))
+  {
+    Misc::Utilities::showMessageBox(tr("File save error"), file.errorString());
+    return false;
+  }
+
+  // Get recorded events
+  QMutexLocker locker(&m_mutex);
+  const auto pid = QCoreApplication::applicationPid();
+
+  // Write thread names
+  QByteArray data;
+  data.reserve(1024 * 1024);
+  data.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  for (int i = 0; i < m_threads.count(); ++i)
+  {
+    QString name = m_threads.at(i);
+    name.replace('\\', "\\\\").replace('"', "\\\"");
+    data.append(QStringLiteral("{\"name\":\"thread_name\",\"ph\":\"M\","
+                               "\"pid\":%1,\"tid\":%2,"
+                               "\"args\":{\"name\":\"%3\"}},\n")
+                    .arg(pid)
+                    .arg(i)
+                    .arg(name)
+                    .toUtf8());
+  }
+
+  // Write events, the file is written in chunks to limit memory usage
+  for (int i = 0; i < m_events.count(); ++i)
+  {
+    const auto &event = m_events.at(i);
+    const auto ts = (event.begin - m_startTime) / 1000.0;
+    const auto dur = (event.end - event.begin) / 1000.0;
+    data.append("{\"name\":\"");
+    data.append(event.name);
+    data.append("\",\"cat\":\"pipeline\",\"ph\":\"X\",\"ts\":");
+    data.append(QByteArray::number(ts, 'f', 3));
+    data.append(",\"dur\":");
+    data.append(QByteArray::number(dur, 'f', 3));
+    data.append(",\"pid\":");
+    data.append(QByteArray::number(pid));
+    data.append(",\"tid\":");
+    data.append(QByteArray::number(event.thread));
+    data.append("},\n");
+
+    if (data.size() > 1024 * 1024)
+    {
+      file.write(data);
+      data.clear();
+    }
+  }
+
+  // Write number of discarded events & close the document
+  data.append(QStringLiteral("{\"name\":\"discarded_events\",\"ph\":\"M\","
+                             "\"pid\":%1,\"args\":{\"count\":%2}}\n]}\n")
+                  .arg(pid)
+                  .arg(m_discarded)
+                  .toUtf8());
+  file.write(data);
+
+  // Check for write errors
+  if (file.error() != QFile::NoError)
+  {
+    Misc::Utilities::showMessageBox(tr("File save error"), file.errorString());
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Returns the identifier of the calling thread, threads are numbered in the
+ * order in which they register their first event. This function must be
+ * called with the mutex locked.
+ */
+int Misc::Tracer::threadId()
+{
+  static thread_local int id = -1;
+  if (id < 0)
+  {
+    id = m_threads.count();
+    auto thread = QThread::currentThread();
+    if (thread == qApp->thread())
+      m_threads.append(QStringLiteral("Main thread"));
+    else if (thread && !thread->objectName().isEmpty())
+      m_threads.append(thread->objectName());
+    else
+      m_threads.append(QStringLiteral("Thread %1").arg(id));
+  }
+
+  return id;
+}
+
+/**
+ * Registers the time at which the scope begins, if tracing is enabled
+ */
+Misc::TraceScope::TraceScope(const char *name)
+  : m_name(name)
+  , m_begin(0)
+{
+  if (Tracer::instance().tracing())
+    m_begin = Tracer::timestamp();
+}
+
+/**
+ * Registers the trace event, if tracing was enabled when the scope began
+ */
+Misc::TraceScope::~TraceScope()
+{
+  if (m_begin > 0)
+    Tracer::instance().addEvent(m_name, m_begin, Tracer::timestamp());
+}
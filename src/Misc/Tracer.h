@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <QString>
+
+namespace Misc
+{
+/**
+ * @brief The Tracer class
+ *
+ * Opt-in recorder of timestamped begin/end events of the data pipeline, the
+ * recorded events are saved as a Chrome trace (JSON trace event format), which
+ * can be opened with @c chrome://tracing or with the Perfetto UI to obtain a
+ * timeline of each thread.
+ *
+ * Functions are instrumented with the @c TRACE_SCOPE() macro, which creates a
+ * @c TraceScope object that registers the time at which it is created & the
+ * time at which it goes out of scope. When tracing is disabled, the only cost
+ * of an instrumented scope is reading an atomic flag.
+ *
+ * Events are stored in memory until tracing is stopped, up to
+ * @c MAX_TRACE_EVENTS events (further events are counted, but discarded).
+ *
+ * @note Event names must be string literals (or have static storage), only
+ *       the pointer to the name is stored.
+ */
+class Tracer : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool tracing
+               READ tracing
+               NOTIFY tracingChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void tracingChanged();
+
+private:
+  explicit Tracer();
+  Tracer(Tracer &&) = delete;
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(Tracer &&) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+public:
+  static Tracer &instance();
+
+  bool tracing() const;
+  static qint64 timestamp();
+  void addEvent(const char *name, const qint64 begin, const qint64 end);
+
+public Q_SLOTS:
+  void startTracing();
+  void stopTracing();
+
+private:
+  bool save(const QString &path);
+  int threadId();
+
+private:
+  struct Event
+  {
+    const char *name;
+    qint64 begin;
+    qint64 end;
+    int thread;
+  };
+
+  qint64 m_startTime;
+  quint64 m_discarded;
+  std::atomic<bool> m_tracing;
+
+  QMutex m_mutex;
+  QVector<Event> m_events;
+  QVector<QString> m_threads;
+};
+
+/**
+ * @brief The TraceScope class
+ *
+ * Registers a trace event that spans the lifetime of the object, if tracing is
+ * enabled when the object is created.
+ */
+class TraceScope
+{
+public:
+  explicit TraceScope(const char *name);
+  ~TraceScope();
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *m_name;
+  qint64 m_begin;
+};
+} // namespace Misc
+
+/**
+ * Records a trace event with the given @a name that spans until the end of
+ * the current scope.
+ */
+#define TRACE_SCOPE(name) Misc::TraceScope traceScope(name)
@@ -26,6 +26,7 @@
 #include <QObject>
 #include <QTranslator>
 #include <DataTypes.h>
+#include <Misc/Settings.h>
 
 #ifdef QT_QML_LIB
 #  include <QtQml>
@@ -78,7 +79,7 @@ public Q_SLOTS:
 
 private:
   int m_language;
-  QSettings m_settings;
+  Misc::Settings m_settings;
   QTranslator m_translator;
 };
 } // namespace Misc
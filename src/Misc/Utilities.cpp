@@ -22,6 +22,7 @@
 
 #include <QDir>
 #include <QUrl>
+#include <QDebug>
 #include <QPalette>
 #include <QProcess>
 #include <QFileInfo>
@@ -78,13 +79,45 @@ bool Misc::Utilities::askAutomaticUpdates()
 }
 
 /**
- * Shows a macOS-like message box with the given properties
+ * Set to @c true when the application runs without user interface
+ */
+static bool HEADLESS = false;
+
+/**
+ * Returns @c true if the application runs without user interface
+ */
+bool Misc::Utilities::headless()
+{
+  return HEADLESS;
+}
+
+/**
+ * Enables or disables headless mode, in which message boxes are printed to
+ * the console instead of being displayed.
+ */
+void Misc::Utilities::setHeadless(const bool headless)
+{
+  HEADLESS = headless;
+}
+
+/**
+ * Shows a macOS-like message box with the given properties.
+ *
+ * In headless mode, the message is printed to the console and no button is
+ * returned, so that questions are never answered affirmatively.
  */
 int Misc::Utilities::showMessageBox(const QString &text,
                                     const QString &informativeText,
                                     const QString &windowTitle,
                                     const QMessageBox::StandardButtons &bt)
 {
+  // Print message to the console in headless mode
+  if (headless())
+  {
+    qWarning().noquote() << text << informativeText;
+    return QMessageBox::NoButton;
+  }
+
   // Get app icon
   QPixmap icon;
   if (qApp->devicePixelRatio() >= 2)
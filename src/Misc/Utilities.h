@@ -43,6 +43,8 @@ public:
   // clang-format off
     static Utilities &instance();
     static void rebootApplication();
+    static bool headless();
+    static void setHeadless(const bool headless);
     Q_INVOKABLE bool askAutomaticUpdates();
     static int showMessageBox(const QString &text, 
                               const QString &informativeText = "",
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtNumeric>
+
+#include <IO/FrameQueue.h>
+#include <Plugins/Aggregator.h>
+
+/**
+ * Maximum number of closed windows kept until they are collected, older
+ * windows are discarded if the plugin server stops collecting them.
+ */
+static const int MAX_READY_WINDOWS = 4096;
+
+/**
+ * Constructor function
+ */
+Plugins::Aggregator::Aggregator()
+{
+}
+
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString Plugins::Aggregator::sinkName() const
+{
+  return QStringLiteral("Plugins::Aggregator");
+}
+
+/**
+ * Adds the values of the given @a frames to each active window
+ *
+ * @note This function is called by the worker pool of the sink graph.
+ */
+void Plugins::Aggregator::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  QMutexLocker locker(&m_mutex);
+  if (m_accumulators.isEmpty())
+    return;
+
+  for (const auto &frame : frames)
+  {
+    const auto time = IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp());
+    for (auto &acc : m_accumulators)
+    {
+      // Close the window if the frame belongs to another window or if the
+      // structure of the frames changed
+      auto &window = acc.window;
+      if (window.frames > 0
+          && (time >= window.start + window.length
+              || time < window.start
+              || frame.schemaHash() != window.schemaHash))
+        close(acc);
+
+      // Start a new window
+      if (window.frames == 0)
+        reset(acc, frame, time);
+
+      // Update the aggregates of each dataset
+      int index = 0;
+      for (int g = 0; g < frame.groupCount(); ++g)
+      {
+        const auto &group = frame.getGroup(g);
+        for (int d = 0; d < group.datasetCount(); ++d, ++index)
+        {
+          const auto &dataset = group.getDataset(d);
+          if (index >= acc.sum.count() || !dataset.isNumeric())
+            continue;
+
+          const double value = dataset.numericValue();
+          if (qIsNaN(value))
+            continue;
+
+          if (acc.count[index] == 0)
+          {
+            window.min[index] = value;
+            window.max[index] = value;
+          }
+
+          else
+          {
+            window.min[index] = qMin(window.min[index], value);
+            window.max[index] = qMax(window.max[index], value);
+          }
+
+          acc.sum[index] += value;
+          acc.count[index] += 1;
+          window.last[index] = value;
+        }
+      }
+
+      ++window.frames;
+    }
+  }
+}
+
+/**
+ * Changes the window lengths (in milliseconds) that are computed. Windows
+ * that are already being computed keep their state, windows that are no
+ * longer requested are discarded.
+ */
+void Plugins::Aggregator::setWindows(const QVector<int> &lengths)
+{
+  QMutexLocker locker(&m_mutex);
+
+  // Remove the windows that are no longer requested
+  for (int i = m_accumulators.count() - 1; i >= 0; --i)
+  {
+    if (!lengths.contains(m_accumulators.at(i).window.length))
+      m_accumulators.remove(i);
+  }
+
+  // Add the new windows
+  for (const auto length : lengths)
+  {
+    bool found = false;
+    for (const auto &acc : m_accumulators)
+      found |= acc.window.length == length;
+
+    if (!found)
+    {
+      Accumulator acc;
+      acc.window.length = length;
+      m_accumulators.append(acc);
+    }
+  }
+}
+
+/**
+ * Closes the windows that ended before the given @a now time (ms since
+ * epoch) & returns all the windows closed since the last call.
+ */
+QVector<Plugins::AggregateWindow>
+Plugins::Aggregator::collect(const qint64 now)
+{
+  QMutexLocker locker(&m_mutex);
+  for (auto &acc : m_accumulators)
+  {
+    const auto &window = acc.window;
+    if (window.frames > 0 && now >= window.start + window.length)
+      close(acc);
+  }
+
+  QVector<AggregateWindow> windows;
+  windows.swap(m_ready);
+  return windows;
+}
+
+/**
+ * Starts a new window of the given accumulator @a acc, which contains the
+ * given @a time & has the structure of the given @a frame.
+ */
+void Plugins::Aggregator::reset(Accumulator &acc, const JSON::Frame &frame,
+                                const qint64 time)
+{
+  // Count the datasets of the frame
+  int count = 0;
+  for (int g = 0; g < frame.groupCount(); ++g)
+    count += frame.getGroup(g).datasetCount();
+
+  // Align the window to the wall clock
+  auto &window = acc.window;
+  window.start = time - (time % window.length);
+  window.frames = 0;
+  window.schemaHash = frame.schemaHash();
+
+  // Reset the aggregates
+  window.min.fill(qQNaN(), count);
+  window.max.fill(qQNaN(), count);
+  window.last.fill(qQNaN(), count);
+  window.mean.clear();
+  acc.sum.fill(0, count);
+  acc.count.fill(0, count);
+}
+
+/**
+ * Calculates the mean values of the given accumulator @a acc & moves its
+ * window to the list of closed windows.
+ */
+void Plugins::Aggregator::close(Accumulator &acc)
+{
+  // Calculate the mean value of each dataset
+  auto &window = acc.window;
+  window.mean.fill(qQNaN(), acc.sum.count());
+  for (int i = 0; i < acc.sum.count(); ++i)
+  {
+    if (acc.count.at(i) > 0)
+      window.mean[i] = acc.sum.at(i) / acc.count.at(i);
+  }
+
+  // Register the window
+  if (m_ready.count() >= MAX_READY_WINDOWS)
+    m_ready.removeFirst();
+
+  m_ready.append(window);
+  window.frames = 0;
+}
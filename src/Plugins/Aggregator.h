@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QVector>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+
+namespace Plugins
+{
+/**
+ * Minimum & maximum length (in milliseconds) of an aggregation window
+ */
+#define PLUGINS_MIN_AGGREGATE_WINDOW 10
+#define PLUGINS_MAX_AGGREGATE_WINDOW 3600000
+
+/**
+ * Minimum, maximum, mean & last value of each dataset during a window of
+ * the given @c length (in milliseconds) that started at @c start (ms since
+ * epoch). Datasets without numeric values during the window are NaN.
+ */
+struct AggregateWindow
+{
+  int length = 0;
+  qint64 start = 0;
+  quint32 frames = 0;
+  quint64 schemaHash = 0;
+  QVector<double> min;
+  QVector<double> max;
+  QVector<double> mean;
+  QVector<double> last;
+};
+
+/**
+ * @brief The Aggregator class
+ *
+ * Computes the per-dataset aggregates of the full-rate frame stream for each
+ * window length requested by the plugins, so that all the plugins that
+ * subscribe to the same window share one computation instead of each plugin
+ * re-aggregating the frames.
+ *
+ * Windows are aligned to the wall clock (e.g. a 1000 ms window always starts
+ * at a whole second) and are closed when a frame of the next window arrives,
+ * when the structure of the frames changes, or when @c collect() is called
+ * after the end of the window. Windows without frames are not reported.
+ *
+ * The aggregator is fed by the worker pool of the sink graph & drained by the
+ * plugin server, all functions are thread-safe.
+ */
+class Aggregator : public JSON::FrameSink
+{
+public:
+  Aggregator();
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  void setWindows(const QVector<int> &lengths);
+  QVector<AggregateWindow> collect(const qint64 now);
+
+private:
+  struct Accumulator
+  {
+    AggregateWindow window;
+    QVector<double> sum;
+    QVector<quint32> count;
+  };
+
+  void reset(Accumulator &acc, const JSON::Frame &frame, const qint64 time);
+  void close(Accumulator &acc);
+
+private:
+  mutable QMutex m_mutex;
+  QVector<Accumulator> m_accumulators;
+  QVector<AggregateWindow> m_ready;
+};
+} // namespace Plugins
@@ -20,55 +20,195 @@
  * THE SOFTWARE.
  */
 
+#include <QTimer>
+#include <QtEndian>
+#include <QtNumeric>
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
 
+#include <cstring>
+
 #include <IO/Manager.h>
+#include <CSV/Export.h>
+#include <UI/Dashboard.h>
 #include <JSON/Generator.h>
 #include <Misc/Utilities.h>
+#include <Misc/Diagnostics.h>
 #include <Plugins/Server.h>
+#include <Plugins/WebSocketServer.h>
 #include <Misc/TimerEvents.h>
 
 /**
- * Constructor function
+ * Appends the given @a value to the @a buffer in little-endian order
+ */
+template<typename T>
+static void WRITE_LE(QByteArray &buffer, const T value)
+{
+  const T le = qToLittleEndian(value);
+  buffer.append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+/**
+ * Appends the given double @a value to the @a buffer in little-endian order
+ */
+static void WRITE_DOUBLE(QByteArray &buffer, const double value)
+{
+  quint64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  WRITE_LE<quint64>(buffer, bits);
+}
+
+/**
+ * Appends the type tag & the value of the given @a dataset to the @a buffer
+ */
+static void WRITE_VALUE(QByteArray &buffer, const JSON::Dataset &dataset)
+{
+  if (dataset.isNumeric())
+  {
+    WRITE_LE<quint8>(buffer, 0);
+    WRITE_DOUBLE(buffer, dataset.numericValue());
+  }
+
+  else
+  {
+    const auto text = dataset.value().toUtf8();
+    WRITE_LE<quint8>(buffer, 1);
+    WRITE_LE<quint32>(buffer, static_cast<quint32>(text.size()));
+    buffer.append(text);
+  }
+}
+
+/**
+ * Appends the length & @a type header of a binary protocol message to the
+ * given @a buffer, the length is patched by @c END_MESSAGE().
+ *
+ * Returns the position of the message header in the buffer.
+ */
+static int BEGIN_MESSAGE(QByteArray &buffer,
+                         const Plugins::Server::MessageType type)
+{
+  const int position = buffer.size();
+  WRITE_LE<quint32>(buffer, 0);
+  WRITE_LE<quint8>(buffer, static_cast<quint8>(type));
+  return position;
+}
+
+/**
+ * Writes the length of the message that starts at the given @a position
+ */
+static void END_MESSAGE(QByteArray &buffer, const int position)
+{
+  const auto length = static_cast<quint32>(buffer.size() - position - 4);
+  qToLittleEndian(length, buffer.data() + position);
+}
+
+//----------------------------------------------------------------------------------------
+// Server implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, connects the signals that provide frames & raw data to
+ * the plugins. The network thread is started by @c start(), so that the TCP &
+ * WebSocket servers do not delay the startup of the user interface.
  */
 Plugins::Server::Server()
   : m_enabled(false)
+  , m_webSocketEnabled(false)
+  , m_queueLimit(4)
+  , m_overflowPolicy(DropOldest)
+  , m_worker(new ServerWorker(&m_aggregator))
+  , m_webSocket(new WebSocketServer())
 {
+  // Read queue settings
+  m_queueLimit = m_settings.value("Plugins_QueueLimit", 4).toInt();
+  m_queueLimit = qBound(1, m_queueLimit, 1024);
+  const auto policy = m_settings.value("Plugins_OverflowPolicy", 0).toInt();
+  if (policy >= DropOldest && policy <= Disconnect)
+    m_overflowPolicy = policy;
+
+  m_webSocketEnabled = m_settings.value("Plugins_WebSocket", false).toBool();
+
+  // Move the worker & the WebSocket endpoint to the network thread
+  m_thread.setObjectName(QStringLiteral("Plugins::ServerWorker"));
+  m_worker->moveToThread(&m_thread);
+  m_webSocket->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(&m_thread, &QThread::finished, m_webSocket, &QObject::deleteLater);
+
   // clang-format off
 
-    // Send processed data at 1 Hz
-    connect(&JSON::Generator::instance(), &JSON::Generator::jsonChanged,
-            this, &Plugins::Server::registerFrame);
-    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+    // React to worker events
+    connect(m_worker, &ServerWorker::listenFailed,
+            this, &Plugins::Server::onListenFailed);
+    connect(m_worker, &ServerWorker::writeRequested,
+            this, &Plugins::Server::onWriteRequested);
+    connect(m_worker, &ServerWorker::markerRequested,
+            this, &Plugins::Server::onMarkerRequested);
+    connect(m_worker, &ServerWorker::clientsChanged,
+            this, &Plugins::Server::onClientsChanged);
+    connect(m_webSocket, &WebSocketServer::listenFailed,
+            this, &Plugins::Server::onListenFailed);
+
+    // Send processed data at the rate selected by the user
+    JSON::Generator::instance().sinks().addSink(
+        this, JSON::SinkGraph::Port::DecimatedFrames);
+    connect(&Misc::TimerEvents::instance(),
+            &Misc::TimerEvents::timeoutPlugins,
             this, &Plugins::Server::sendProcessedData);
 
+    // Aggregate the full-rate frames & send the closed windows
+    JSON::Generator::instance().sinks().addSink(
+        &m_aggregator, JSON::SinkGraph::Port::Frames,
+        JSON::SinkGraph::Affinity::WorkerPool);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
+            this, &Plugins::Server::sendAggregates);
+
+    // Send pipeline statistics once per second
+    connect(&Misc::Diagnostics::instance(), &Misc::Diagnostics::updated,
+            this, &Plugins::Server::sendDiagnostics);
+
+    // Send dataset statistics once per second
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+            this, &Plugins::Server::sendStatistics);
+
+    // Send alarm events as soon as they occur
+    connect(&JSON::Generator::instance(), &JSON::Generator::alarmsTriggered,
+            this, &Plugins::Server::sendAlarms);
+
     // Send I/O "raw" data directly
     connect(&IO::Manager::instance(), &IO::Manager::dataReceived,
             this, &Plugins::Server::sendRawData);
 
-    // Configure TCP server
-    connect(&m_server, &QTcpServer::newConnection,
-            this, &Plugins::Server::acceptConnection);
-
   // clang-format on
-
-  // Begin listening on TCP port
-  if (!m_server.listen(QHostAddress::Any, PLUGINS_TCP_PORT))
-  {
-    Misc::Utilities::showMessageBox(tr("Unable to start plugin TCP server"),
-                                    m_server.errorString());
-    m_server.close();
-  }
 }
 
 /**
- * Destructor function
+ * Destructor function, closes all connections & stops the network thread
  */
 Plugins::Server::~Server()
 {
-  m_server.close();
+  // Network thread never started, delete the worker objects directly
+  if (!m_thread.isRunning())
+  {
+    delete m_worker;
+    delete m_webSocket;
+    return;
+  }
+
+  auto worker = m_worker;
+  auto webSocket = m_webSocket;
+  QMetaObject::invokeMethod(
+      worker,
+      [=] {
+        worker->closeConnections();
+        webSocket->setEnabled(false);
+      },
+      Qt::BlockingQueuedConnection);
+
+  m_thread.quit();
+  m_thread.wait();
 }
 
 /**
@@ -80,6 +220,22 @@ Plugins::Server &Plugins::Server::instance()
   return singleton;
 }
 
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString Plugins::Server::sinkName() const
+{
+  return QStringLiteral("Plugins::Server");
+}
+
+/**
+ * Queues the given batch of decimated @a frames, see @c registerFrames()
+ */
+void Plugins::Server::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  registerFrames(frames);
+}
+
 /**
  * Returns @c true if the plugin sub-system is enabled
  */
@@ -89,27 +245,120 @@ bool Plugins::Server::enabled() const
 }
 
 /**
- * Disconnects the socket used for communicating with plugins.
+ * Returns @c true if the WebSocket endpoint for remote dashboards is enabled
  */
-void Plugins::Server::removeConnection()
+bool Plugins::Server::webSocketEnabled() const
 {
-  // Get caller socket
-  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+  return m_webSocketEnabled;
+}
 
-  // Remove socket from registered sockets
-  if (socket)
+/**
+ * Returns the maximum number of megabytes that can be queued for each plugin
+ */
+int Plugins::Server::queueLimit() const
+{
+  return m_queueLimit;
+}
+
+/**
+ * Returns the action taken when the queue of a plugin exceeds the queue limit,
+ * the list of policies is obtained with @c availableOverflowPolicies().
+ */
+int Plugins::Server::overflowPolicy() const
+{
+  return m_overflowPolicy;
+}
+
+/**
+ * Returns the address, protocol, queued bytes & number of dropped messages of
+ * each connected plugin, as reported by the network thread.
+ */
+QVariantList Plugins::Server::clients() const
+{
+  return m_clients;
+}
+
+/**
+ * Returns the list of actions that can be taken when the queue of a plugin
+ * exceeds the queue limit.
+ */
+QStringList Plugins::Server::availableOverflowPolicies() const
+{
+  return QStringList {tr("Drop oldest data"), tr("Drop newest data"),
+                      tr("Downsample"), tr("Disconnect plugin")};
+}
+
+/**
+ * Returns a JSON object that describes the structure of the given @a frame:
+ * its title & the title, widget and datasets (title, units, widget & index)
+ * of each group.
+ */
+QJsonObject Plugins::Server::schema(const JSON::Frame &frame)
+{
+  // Describe each group & dataset of the frame
+  QJsonArray groups;
+  for (int i = 0; i < frame.groupCount(); ++i)
   {
-    for (int i = 0; i < m_sockets.count(); ++i)
+    QJsonArray datasets;
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
     {
-      if (m_sockets.at(i) == socket)
-      {
-        m_sockets.removeAt(i);
-        i = 0;
-      }
+      QJsonObject object;
+      const auto &dataset = group.getDataset(j);
+      object.insert("title", dataset.title());
+      object.insert("units", dataset.units());
+      object.insert("widget", dataset.widget());
+      object.insert("index", dataset.index());
+      datasets.append(object);
     }
 
-    // Delete socket handler
-    socket->deleteLater();
+    QJsonObject object;
+    object.insert("title", group.title());
+    object.insert("widget", group.widget());
+    object.insert("datasets", datasets);
+    groups.append(object);
+  }
+
+  // Create the schema document
+  QJsonObject object;
+  object.insert("title", frame.title());
+  object.insert("groups", groups);
+  return object;
+}
+
+/**
+ * Disconnects all the plugins
+ */
+void Plugins::Server::closeConnections()
+{
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->closeConnections(); });
+}
+
+/**
+ * Starts the network thread, configures the worker & begins listening on the
+ * TCP port (and on the WebSocket port, if enabled). Calling this function
+ * more than once has no effect.
+ */
+void Plugins::Server::start()
+{
+  // Thread already running
+  if (m_thread.isRunning())
+    return;
+
+  // Start network thread
+  m_thread.start();
+
+  // Configure worker & begin listening on TCP port
+  configureWorker();
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->listen(); });
+
+  // Start the WebSocket endpoint
+  if (m_webSocketEnabled)
+  {
+    auto webSocket = m_webSocket;
+    QMetaObject::invokeMethod(webSocket, [=] { webSocket->setEnabled(true); });
   }
 }
 
@@ -118,201 +367,1341 @@ void Plugins::Server::removeConnection()
  */
 void Plugins::Server::setEnabled(const bool enabled)
 {
+  // Ensure that the network thread is running
+  start();
+
   // Change value
   m_enabled = enabled;
   Q_EMIT enabledChanged();
 
-  // If not enabled, remove all connections
-  if (!enabled)
-  {
-    for (int i = 0; i < m_sockets.count(); ++i)
-    {
-      auto socket = m_sockets.at(i);
-
-      if (socket)
-      {
-        socket->abort();
-        socket->deleteLater();
-      }
-    }
+  // Update worker, connections are removed if the system is disabled
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->setEnabled(enabled); });
 
-    m_sockets.clear();
+  // Clear connection list
+  if (!enabled && !m_clients.isEmpty())
+  {
+    m_clients.clear();
+    Q_EMIT clientsChanged();
   }
-
-  // Clear frames array to avoid memory leaks
-  m_frames.clear();
 }
 
 /**
- * Process incoming data and writes it directly to the connected I/O device
+ * Changes the maximum number of @a megabytes that can be queued for each
+ * plugin.
  */
-void Plugins::Server::onDataReceived()
+void Plugins::Server::setQueueLimit(const int megabytes)
 {
-  // Get caller socket
-  auto socket = static_cast<QTcpSocket *>(QObject::sender());
-
-  // Write incoming data to manager
-  if (enabled() && socket)
-    IO::Manager::instance().writeData(socket->readAll());
+  const auto limit = qBound(1, megabytes, 1024);
+  if (m_queueLimit != limit)
+  {
+    m_queueLimit = limit;
+    m_settings.setValue("Plugins_QueueLimit", limit);
+    configureWorker();
+    Q_EMIT queuePolicyChanged();
+  }
 }
 
 /**
- * Configures incoming connection requests
+ * Changes the action taken when the queue of a plugin exceeds the queue limit
  */
-void Plugins::Server::acceptConnection()
+void Plugins::Server::setOverflowPolicy(const int policy)
 {
-  // Get & validate socket
-  auto socket = m_server.nextPendingConnection();
-  if (!socket && enabled())
+  if (m_overflowPolicy != policy && policy >= DropOldest
+      && policy <= Disconnect)
   {
-    Misc::Utilities::showMessageBox(tr("Plugin server"),
-                                    tr("Invalid pending connection"));
-    return;
+    m_overflowPolicy = policy;
+    m_settings.setValue("Plugins_OverflowPolicy", policy);
+    configureWorker();
+    Q_EMIT queuePolicyChanged();
   }
+}
 
-  // Close connection if system is not enabled
-  if (!enabled())
+/**
+ * Enables/disables the WebSocket endpoint for remote dashboards
+ */
+void Plugins::Server::setWebSocketEnabled(const bool enabled)
+{
+  if (m_webSocketEnabled != enabled)
   {
-    if (socket)
-    {
-      socket->close();
-      socket->deleteLater();
-    }
-
-    return;
-  }
-
-  // Connect socket signals/slots
-  connect(socket, &QTcpSocket::readyRead, this,
-          &Plugins::Server::onDataReceived);
-  connect(socket, &QTcpSocket::disconnected, this,
-          &Plugins::Server::removeConnection);
+    m_webSocketEnabled = enabled;
+    m_settings.setValue("Plugins_WebSocket", enabled);
 
-  // React to socket errors
-  // clang-format off
-#if QT_VERSION < QT_VERSION_CHECK(5, 12, 0)
-    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)),
-            this,     SLOT(onErrorOccurred(QAbstractSocket::SocketError)));
-#else
-    connect(socket, &QTcpSocket::errorOccurred,
-            this, &Plugins::Server::onErrorOccurred);
-#endif
-  // clang-format on
+    auto webSocket = m_webSocket;
+    QMetaObject::invokeMethod(webSocket,
+                              [=] { webSocket->setEnabled(enabled); });
 
-  // Add socket to sockets list
-  m_sockets.append(socket);
+    Q_EMIT webSocketEnabledChanged();
+  }
 }
 
 /**
- * Sends an array of frames with the following information:
- * - Frame ID number
- * - RX timestamp
- * - Frame JSON data
+ * Instructs the network thread to send the frames received since the last
+ * call & to report the queue state of each plugin.
  */
 void Plugins::Server::sendProcessedData()
 {
-  // Stop if system is not enabled
   if (!enabled())
     return;
 
-  // Stop if frame list is empty
-  if (m_frames.count() <= 0)
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->sendProcessedData();
+    worker->reportClients();
+  });
+}
+
+/**
+ * Hands the aggregation windows that were closed since the last call over to
+ * the network thread, which sends them to the subscribed plugins.
+ */
+void Plugins::Server::sendAggregates()
+{
+  if (!enabled())
     return;
 
-  // Stop if no sockets are available
-  if (m_sockets.count() < 1)
+  const auto now = QDateTime::currentMSecsSinceEpoch();
+  const auto windows = m_aggregator.collect(now);
+  if (windows.isEmpty())
     return;
 
-  // Create JSON array with frame data
-  QJsonArray array;
-  for (int i = 0; i < m_frames.count(); ++i)
-  {
-    QJsonObject object;
-    auto frame = m_frames.at(i);
-    object.insert("data", frame);
-    array.append(object);
-  }
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->sendAggregates(windows); });
+}
 
-  // Create JSON document with frame arrays
-  if (array.count() > 0)
-  {
-    // Construct QByteArray with data
-    QJsonObject object;
-    object.insert("frames", array);
-    const QJsonDocument document(object);
-    auto json = document.toJson(QJsonDocument::Compact) + "\n";
+/**
+ * Hands the latest pipeline statistics over to the network thread, which
+ * sends them to the binary plugins that subscribed to diagnostics data.
+ */
+void Plugins::Server::sendDiagnostics()
+{
+  if (!enabled())
+    return;
 
-    // Send data to each plugin
-    Q_FOREACH (auto socket, m_sockets)
-    {
-      if (!socket)
-        continue;
+  auto worker = m_worker;
+  const QJsonDocument document(Misc::Diagnostics::instance().snapshot());
+  const auto json = document.toJson(QJsonDocument::Compact);
+  QMetaObject::invokeMethod(worker, [=] { worker->sendDiagnostics(json); });
+}
 
-      if (socket->isWritable())
-        socket->write(json);
-    }
-  }
+/**
+ * Hands the session & windowed statistics of each dataset over to the network
+ * thread, which sends them to the JSON plugins & to the binary plugins that
+ * subscribed to statistics data.
+ */
+void Plugins::Server::sendStatistics()
+{
+  if (!enabled() || m_clients.isEmpty())
+    return;
 
-  // Clear frame list
-  m_frames.clear();
+  const auto &dashboard = UI::Dashboard::instance();
+  if (dashboard.statistics().channels() <= 0)
+    return;
+
+  auto worker = m_worker;
+  const QJsonDocument document(dashboard.statisticsSnapshot());
+  const auto json = document.toJson(QJsonDocument::Compact);
+  QMetaObject::invokeMethod(worker, [=] { worker->sendStatistics(json); });
 }
 
 /**
- * Encodes the given @a data in Base64 and sends it through the TCP socket
- * connected to the localhost.
+ * Hands the given alarm @a events over to the network thread, which sends
+ * them to the JSON plugins & to the binary plugins that did not unsubscribe
+ * from alarm events.
  */
-void Plugins::Server::sendRawData(const QByteArray &data)
+void Plugins::Server::sendAlarms(const QVector<JSON::AlarmEvent> &events)
 {
-  // Stop if system is not enabled
-  if (!enabled())
+  if (!enabled() || m_clients.isEmpty())
     return;
 
-  // Stop if no sockets are available
-  if (m_sockets.count() < 1)
-    return;
+  QJsonArray array;
+  for (const auto &event : events)
+    array.append(event.toJson());
 
-  // Create JSON structure with incoming data encoded in Base-64
-  QJsonObject object;
-  object.insert("data", QString::fromUtf8(data.toBase64()));
+  auto worker = m_worker;
+  const auto json = QJsonDocument(array).toJson(QJsonDocument::Compact);
+  QMetaObject::invokeMethod(worker, [=] { worker->sendAlarms(json); });
+}
+
+/**
+ * Hands the given raw @a data over to the network thread, together with its
+ * reception time (the monotonic @a timestamp registered by the driver,
+ * converted to milliseconds since epoch).
+ */
+void Plugins::Server::sendRawData(const QByteArray &data,
+                                  const qint64 timestamp)
+{
+  if (!enabled())
+    return;
 
-  // Get JSON string in compact format & send it over the TCP socket
-  QJsonDocument document(object);
-  auto json = document.toJson(QJsonDocument::Compact) + "\n";
+  auto worker = m_worker;
+  const auto time = IO::FrameQueue::toMSecsSinceEpoch(timestamp);
+  QMetaObject::invokeMethod(worker, [=] { worker->sendRawData(data, time); });
+}
 
-  // Send data to each plugin
-  Q_FOREACH (auto socket, m_sockets)
-  {
-    if (!socket)
-      continue;
+/**
+ * Notifies the user that the TCP or the WebSocket server could not be started
+ */
+void Plugins::Server::onListenFailed(const QString &error)
+{
+  Misc::Utilities::showMessageBox(tr("Unable to start plugin TCP server"),
+                                  error);
+}
 
-    if (socket->isWritable())
-      socket->write(json);
-  }
+/**
+ * Writes the data sent by a plugin to the connected I/O device, this function
+ * is called in the main thread.
+ */
+void Plugins::Server::onWriteRequested(const QByteArray &data)
+{
+  if (enabled())
+    IO::Manager::instance().writeData(data);
 }
 
 /**
- * Obtains the latest JSON dataframe & appends it to the JSON list, which is
- * later read and sent by the @c sendProcessedData() function.
+ * Adds the event marker sent by a plugin to the current recording, this
+ * function is called in the main thread.
  */
-void Plugins::Server::registerFrame(const QJsonObject &json)
+void Plugins::Server::onMarkerRequested(const QString &label)
 {
   if (enabled())
-    m_frames.append(json);
+    CSV::Export::instance().addMarker(label, CSV::Marker::Plugin);
 }
 
 /**
- * This function is called whenever a socket error occurs, it disconnects the
- * socket from the host and displays the error in a message box.
+ * Updates the queue state of each plugin reported by the network thread
  */
-void Plugins::Server::onErrorOccurred(
-    const QAbstractSocket::SocketError socketError)
+void Plugins::Server::onClientsChanged(const QVariantList &clients)
 {
-  // Get caller socket
-  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+  m_clients = clients;
+  Q_EMIT clientsChanged();
+}
 
-  // Print error
-  if (socket)
-    qDebug() << socket->errorString();
-  else
-    qDebug() << socketError;
+/**
+ * Hands the latest batch of dataframes over to the network thread, which
+ * later converts them to JSON or binary messages in @c sendProcessedData().
+ * The WebSocket endpoint only receives the most recent frame.
+ */
+void Plugins::Server::registerFrames(const QVector<JSON::Frame> &frames)
+{
+  if (frames.isEmpty())
+    return;
+
+  if (enabled())
+  {
+    auto worker = m_worker;
+    QMetaObject::invokeMethod(worker, [=] { worker->registerFrames(frames); });
+  }
+
+  if (webSocketEnabled())
+  {
+    auto webSocket = m_webSocket;
+    const auto frame = frames.last();
+    const auto time = IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp());
+    QMetaObject::invokeMethod(webSocket,
+                              [=] { webSocket->setFrame(frame, time); });
+  }
+}
+
+/**
+ * Sends the current queue limit & overflow policy to the network thread
+ */
+void Plugins::Server::configureWorker()
+{
+  auto worker = m_worker;
+  const auto limit = m_queueLimit;
+  const auto policy = m_overflowPolicy;
+  QMetaObject::invokeMethod(worker,
+                            [=] { worker->setQueuePolicy(limit, policy); });
+}
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, the TCP server is created by @c listen() once the
+ * worker has been moved to the network thread. The window lengths requested
+ * by the plugins are registered in the given @a aggregator.
+ */
+Plugins::ServerWorker::ServerWorker(Aggregator *aggregator)
+  : m_enabled(false)
+  , m_queueLimit(4)
+  , m_overflowPolicy(Server::DropOldest)
+  , m_server(Q_NULLPTR)
+  , m_aggregator(aggregator)
+  , m_schemaHash(0)
+{
+}
+
+/**
+ * Destructor function, stops listening for incoming connections
+ */
+Plugins::ServerWorker::~ServerWorker()
+{
+  if (m_server)
+    m_server->close();
+}
+
+/**
+ * Creates the TCP server & begins listening on @c PLUGINS_TCP_PORT
+ */
+void Plugins::ServerWorker::listen()
+{
+  // Create the server in the network thread
+  if (!m_server)
+  {
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this,
+            &Plugins::ServerWorker::acceptConnection);
+  }
+
+  // Begin listening on TCP port
+  if (!m_server->isListening()
+      && !m_server->listen(QHostAddress::Any, PLUGINS_TCP_PORT))
+  {
+    Q_EMIT listenFailed(m_server->errorString());
+    m_server->close();
+  }
+}
+
+/**
+ * Reports the address, protocol, queued bytes & number of dropped messages of
+ * each connected plugin.
+ */
+void Plugins::ServerWorker::reportClients()
+{
+  QVariantList list;
+  Q_FOREACH (auto socket, m_sockets)
+  {
+    const auto client = m_clients.constFind(socket);
+    if (!socket || client == m_clients.cend())
+      continue;
+
+    QString protocol = tr("Negotiating");
+    if (!client->negotiating)
+      protocol = client->binary ? tr("Binary") : tr("JSON");
+
+    QVariantMap map;
+    map.insert("protocol", protocol);
+    map.insert("dropped", client->dropped);
+    map.insert("queuedBytes", client->queuedBytes + socket->bytesToWrite());
+    map.insert("address", QStringLiteral("%1:%2")
+                              .arg(socket->peerAddress().toString())
+                              .arg(socket->peerPort()));
+    list.append(map);
+  }
+
+  Q_EMIT clientsChanged(list);
+}
+
+
+/**
+ * Disconnects all the plugins
+ */
+void Plugins::ServerWorker::closeConnections()
+{
+  Q_FOREACH (auto socket, m_sockets)
+  {
+    if (socket)
+    {
+      socket->disconnect(this);
+      socket->abort();
+      socket->deleteLater();
+    }
+  }
+
+  m_sockets.clear();
+  m_clients.clear();
+  updateAggregates();
+  reportClients();
+}
+
+/**
+ * Enables/disables the plugin subsystem, all connections are removed when
+ * the subsystem is disabled.
+ */
+void Plugins::ServerWorker::setEnabled(const bool enabled)
+{
+  m_enabled = enabled;
+  if (!enabled)
+    closeConnections();
+
+  // Clear frames array to avoid memory leaks
+  m_frames.clear();
+  m_timestamps.clear();
+}
+
+/**
+ * Changes the maximum number of @a megabytes that can be queued for each
+ * plugin & the action taken when the limit is exceeded.
+ */
+void Plugins::ServerWorker::setQueuePolicy(const int megabytes,
+                                           const int policy)
+{
+  if (m_overflowPolicy != policy)
+  {
+    for (auto client = m_clients.begin(); client != m_clients.end(); ++client)
+      client->downsample = 1;
+  }
+
+  m_queueLimit = megabytes;
+  m_overflowPolicy = policy;
+}
+
+/**
+ * Disconnects the socket used for communicating with plugins.
+ */
+void Plugins::ServerWorker::removeConnection()
+{
+  // Get caller socket
+  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+
+  // Remove socket from registered sockets
+  if (socket)
+  {
+    for (int i = 0; i < m_sockets.count(); ++i)
+    {
+      if (m_sockets.at(i) == socket)
+      {
+        m_sockets.removeAt(i);
+        i = 0;
+      }
+    }
+
+    // Remove protocol & queue state
+    m_clients.remove(socket);
+    updateAggregates();
+    reportClients();
+
+    // Delete socket handler
+    socket->deleteLater();
+  }
+}
+
+/**
+ * Process incoming data and writes it directly to the connected I/O device
+ */
+void Plugins::ServerWorker::onDataReceived()
+{
+  // Get caller socket
+  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+
+  if (!m_enabled || !socket)
+    return;
+
+  // Negotiation finished, write incoming data to manager or process messages
+  auto data = socket->readAll();
+  auto client = m_clients.find(socket);
+  if (client == m_clients.end() || !client->negotiating)
+  {
+    if (client != m_clients.end() && client->binary)
+    {
+      client->input.append(data);
+      readMessages(socket, *client);
+    }
+
+    else
+      Q_EMIT writeRequested(data);
+
+    return;
+  }
+
+  // Compare received data with the binary handshake
+  static const QByteArray handshake(PLUGINS_BINARY_HANDSHAKE);
+  client->handshake.append(data);
+  const auto &received = client->handshake;
+  const int length = qMin(received.size(), handshake.size());
+  const bool match = memcmp(received.constData(), handshake.constData(),
+                            static_cast<size_t>(length))
+                     == 0;
+
+  // Wait for the rest of the handshake
+  if (match && received.size() < handshake.size())
+    return;
+
+  // Process any data that is not part of the handshake
+  const auto remainder = match ? received.mid(handshake.size()) : received;
+  finishNegotiation(socket, match);
+  if (match)
+  {
+    client->input = remainder;
+    readMessages(socket, *client);
+  }
+
+  else if (!remainder.isEmpty())
+    Q_EMIT writeRequested(remainder);
+}
+
+/**
+ * Hands more queued data to the socket of a plugin once the socket has
+ * written (part of) its buffer to the network.
+ */
+void Plugins::ServerWorker::onBytesWritten()
+{
+  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+  auto client = m_clients.find(socket);
+  if (socket && client != m_clients.end())
+    drain(socket, *client);
+}
+
+/**
+ * Configures incoming connection requests
+ */
+void Plugins::ServerWorker::acceptConnection()
+{
+  // Get & validate socket
+  auto socket = m_server->nextPendingConnection();
+  if (!socket && m_enabled)
+  {
+    qWarning() << "Plugin server: invalid pending connection";
+    return;
+  }
+
+  // Close connection if system is not enabled
+  if (!m_enabled)
+  {
+    if (socket)
+    {
+      socket->close();
+      socket->deleteLater();
+    }
+
+    return;
+  }
+
+  // Connect socket signals/slots
+  connect(socket, &QTcpSocket::readyRead, this,
+          &Plugins::ServerWorker::onDataReceived);
+  connect(socket, &QTcpSocket::bytesWritten, this,
+          &Plugins::ServerWorker::onBytesWritten);
+  connect(socket, &QTcpSocket::disconnected, this,
+          &Plugins::ServerWorker::removeConnection);
+
+  // React to socket errors
+  // clang-format off
+#if QT_VERSION < QT_VERSION_CHECK(5, 12, 0)
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)),
+            this,     SLOT(onErrorOccurred(QAbstractSocket::SocketError)));
+#else
+    connect(socket, &QTcpSocket::errorOccurred,
+            this, &Plugins::ServerWorker::onErrorOccurred);
+#endif
+  // clang-format on
+
+  // Add socket to sockets list
+  m_sockets.append(socket);
+  m_clients.insert(socket, Client());
+  reportClients();
+
+  // Fall back to the JSON protocol if the plugin does not send the handshake
+  QTimer::singleShot(PLUGINS_NEGOTIATION_TIMEOUT, socket, [=] {
+    auto client = m_clients.find(socket);
+    if (client == m_clients.end() || !client->negotiating)
+      return;
+
+    const auto data = client->handshake;
+    finishNegotiation(socket, false);
+    if (!data.isEmpty())
+      Q_EMIT writeRequested(data);
+  });
+}
+
+/**
+ * Sends the frames received since the last call to each plugin, encoded with
+ * the protocol that the plugin negotiated.
+ */
+void Plugins::ServerWorker::sendProcessedData()
+{
+  // Stop if system is not enabled
+  if (!m_enabled)
+    return;
+
+  // Stop if frame list is empty
+  if (m_frames.count() <= 0)
+    return;
+
+  // Only encode the frames with the protocols that are in use
+  bool json = false;
+  bool binary = false;
+  for (auto client = m_clients.cbegin(); client != m_clients.cend(); ++client)
+  {
+    if (!client->negotiating)
+    {
+      json |= !client->binary;
+      binary |= client->binary && client->frames && !client->filtered
+                && client->maxRate <= 0;
+    }
+  }
+
+  // Get the schema messages that must be sent before each frame
+  const auto schemas = schemaMessages();
+
+  // Send data to each plugin, frames that carry a schema are never dropped
+  bool schema = false;
+  QByteArray binaryData;
+  if (binary)
+    binaryData = binaryFrames(schemas, Q_NULLPTR, schema);
+  if (json || binary)
+    sendData(json ? jsonFrames() : QByteArray(), binaryData,
+             MessageType::Frames, schema);
+
+  // Encode the subscribed values of each plugin with a subscription
+  Q_FOREACH (auto socket, m_sockets)
+  {
+    auto client = m_clients.find(socket);
+    if (!socket || client == m_clients.end() || client->negotiating
+        || !client->binary || !client->frames
+        || (!client->filtered && client->maxRate <= 0))
+      continue;
+
+    const auto data = binaryFrames(schemas, &(*client), schema);
+    if (!data.isEmpty())
+      enqueue(socket, *client, Message {data, schema});
+  }
+
+  // Clear frame list
+  m_frames.clear();
+  m_timestamps.clear();
+}
+
+/**
+ * Sends the given pipeline statistics (a UTF-8 @a json document) to the binary
+ * plugins that subscribed to diagnostics data.
+ */
+void Plugins::ServerWorker::sendDiagnostics(const QByteArray &json)
+{
+  // Check if any plugin subscribed to diagnostics data
+  bool subscribed = false;
+  for (auto client = m_clients.cbegin(); client != m_clients.cend(); ++client)
+    subscribed |= client->binary && client->diagnostics;
+
+  if (!subscribed)
+    return;
+
+  // Create binary message with the statistics
+  QByteArray binary;
+  binary.reserve(json.size() + 5);
+  const auto msg = BEGIN_MESSAGE(binary, MessageType::Diagnostics);
+  binary.append(json);
+  END_MESSAGE(binary, msg);
+
+  // Send message to the subscribed plugins
+  sendData(QByteArray(), binary, MessageType::Diagnostics);
+}
+
+/**
+ * Sends the given dataset statistics (a UTF-8 @a json array) to the JSON
+ * plugins and to the binary plugins that subscribed to statistics data.
+ */
+void Plugins::ServerWorker::sendStatistics(const QByteArray &json)
+{
+  // Stop if system is not enabled
+  if (!m_enabled)
+    return;
+
+  // Check which protocols are in use
+  bool useJson = false;
+  bool useBinary = false;
+  for (auto client = m_clients.cbegin(); client != m_clients.cend(); ++client)
+  {
+    if (!client->negotiating)
+    {
+      useJson |= !client->binary;
+      useBinary |= client->binary && client->statistics;
+    }
+  }
+
+  // Create JSON document with the statistics array
+  QByteArray document;
+  if (useJson)
+    document = "{\"statistics\":" + json + "}\n";
+
+  // Create binary message with the statistics
+  QByteArray binary;
+  if (useBinary)
+  {
+    binary.reserve(json.size() + 5);
+    const auto msg = BEGIN_MESSAGE(binary, MessageType::Statistics);
+    binary.append(json);
+    END_MESSAGE(binary, msg);
+  }
+
+  // Send data to each plugin
+  if (useJson || useBinary)
+    sendData(document, binary, MessageType::Statistics);
+}
+
+/**
+ * Sends the given alarm events (a UTF-8 @a json array) to the JSON plugins and
+ * to the binary plugins that did not unsubscribe from alarm events. Alarm
+ * messages are never dropped by the queue policy of binary plugins.
+ */
+void Plugins::ServerWorker::sendAlarms(const QByteArray &json)
+{
+  // Stop if system is not enabled
+  if (!m_enabled)
+    return;
+
+  // Check which protocols are in use
+  bool useJson = false;
+  bool useBinary = false;
+  for (auto client = m_clients.cbegin(); client != m_clients.cend(); ++client)
+  {
+    if (!client->negotiating)
+    {
+      useJson |= !client->binary;
+      useBinary |= client->binary && client->alarms;
+    }
+  }
+
+  // Create JSON document with the alarm events
+  QByteArray document;
+  if (useJson)
+    document = "{\"alarms\":" + json + "}\n";
+
+  // Create binary message with the alarm events
+  QByteArray binary;
+  if (useBinary)
+  {
+    binary.reserve(json.size() + 5);
+    const auto msg = BEGIN_MESSAGE(binary, MessageType::Alarm);
+    binary.append(json);
+    END_MESSAGE(binary, msg);
+  }
+
+  // Send data to each plugin
+  if (useJson || useBinary)
+    sendData(document, binary, MessageType::Alarm, true);
+}
+
+/**
+ * Encodes each of the given aggregation @a windows once & queues the message
+ * for every plugin that subscribed to the length of the window. Plugins that
+ * do not receive frames get the schema message first if it changed.
+ */
+void Plugins::ServerWorker::sendAggregates(
+    const QVector<Plugins::AggregateWindow> &windows)
+{
+  // Stop if system is not enabled
+  if (!m_enabled)
+    return;
+
+  for (const auto &window : windows)
+  {
+    // Create binary message with the aggregates of each dataset
+    QByteArray binary;
+    const auto count = window.last.count();
+    binary.reserve(count * 32 + 37);
+    const auto msg = BEGIN_MESSAGE(binary, MessageType::Aggregates);
+    WRITE_LE<quint64>(binary, window.schemaHash);
+    WRITE_LE<qint64>(binary, window.start);
+    WRITE_LE<quint32>(binary, static_cast<quint32>(window.length));
+    WRITE_LE<quint32>(binary, window.frames);
+    WRITE_LE<quint32>(binary, static_cast<quint32>(count));
+    for (int i = 0; i < count; ++i)
+    {
+      WRITE_DOUBLE(binary, window.min.value(i, qQNaN()));
+      WRITE_DOUBLE(binary, window.max.value(i, qQNaN()));
+      WRITE_DOUBLE(binary, window.mean.value(i, qQNaN()));
+      WRITE_DOUBLE(binary, window.last.value(i, qQNaN()));
+    }
+    END_MESSAGE(binary, msg);
+
+    // Queue the message for the subscribed plugins
+    Q_FOREACH (auto socket, m_sockets)
+    {
+      auto client = m_clients.find(socket);
+      if (!socket || client == m_clients.end() || client->negotiating
+          || !client->binary || client->aggregate != window.length)
+        continue;
+
+      if (!client->frames && client->schemaHash != window.schemaHash
+          && m_schemaHash == window.schemaHash && !m_schema.isEmpty())
+      {
+        client->schemaHash = m_schemaHash;
+        enqueue(socket, *client, Message {m_schema, true});
+      }
+
+      enqueue(socket, *client, Message {binary, false});
+    }
+  }
+}
+
+/**
+ * Sends the given @a data, received at the given @a timestamp (ms since
+ * epoch), to each plugin, encoded with the protocol that the plugin negotiated.
+ */
+void Plugins::ServerWorker::sendRawData(const QByteArray &data,
+                                        const qint64 timestamp)
+{
+  // Stop if system is not enabled
+  if (!m_enabled)
+    return;
+
+  // Stop if no sockets are available
+  if (m_sockets.count() < 1)
+    return;
+
+  // Check which protocols are in use
+  bool useJson = false;
+  bool useBinary = false;
+  for (auto client = m_clients.cbegin(); client != m_clients.cend(); ++client)
+  {
+    if (!client->negotiating)
+    {
+      useJson |= !client->binary;
+      useBinary |= client->binary;
+    }
+  }
+
+  // Create JSON structure with incoming data encoded in Base-64
+  QByteArray json;
+  if (useJson)
+  {
+    QJsonObject object;
+    object.insert("data", QString::fromUtf8(data.toBase64()));
+    QJsonDocument document(object);
+    json = document.toJson(QJsonDocument::Compact) + "\n";
+  }
+
+  // Create binary message with the raw data
+  QByteArray binary;
+  if (useBinary)
+  {
+    binary.reserve(data.size() + 13);
+    const auto msg = BEGIN_MESSAGE(binary, MessageType::RawData);
+    WRITE_LE<qint64>(binary, timestamp);
+    binary.append(data);
+    END_MESSAGE(binary, msg);
+  }
+
+  // Send data to each plugin
+  sendData(json, binary, MessageType::RawData);
+}
+
+/**
+ * Appends the given batch of dataframes to the frame list, which is later
+ * converted to JSON or binary messages by the @c sendProcessedData()
+ * function. The reception time of each frame is converted to milliseconds
+ * since epoch.
+ */
+void Plugins::ServerWorker::registerFrames(const QVector<JSON::Frame> &frames)
+{
+  if (m_enabled && !frames.isEmpty())
+  {
+    m_frames.append(frames);
+    m_timestamps.reserve(m_timestamps.count() + frames.count());
+    Q_FOREACH (const auto &frame, frames)
+      m_timestamps.append(IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp()));
+  }
+}
+
+/**
+ * This function is called whenever a socket error occurs, it disconnects the
+ * socket from the host and displays the error in a message box.
+ */
+void Plugins::ServerWorker::onErrorOccurred(
+    const QAbstractSocket::SocketError socketError)
+{
+  // Get caller socket
+  auto socket = static_cast<QTcpSocket *>(QObject::sender());
+
+  // Print error
+  if (socket)
+    qDebug() << socket->errorString();
+  else
+    qDebug() << socketError;
+}
+
+/**
+ * Regenerates the binary schema message if the structure of the given
+ * @a frame is different from the structure of the last frame that was sent.
+ */
+void Plugins::ServerWorker::updateSchema(const JSON::Frame &frame)
+{
+  // Schema did not change
+  if (frame.schemaHash() == m_schemaHash && !m_schema.isEmpty())
+    return;
+
+  // Create the schema document
+  const auto object = Server::schema(frame);
+  const auto json = QJsonDocument(object).toJson(QJsonDocument::Compact);
+
+  // Create the schema message
+  m_schema.clear();
+  m_schemaHash = frame.schemaHash();
+  const auto msg = BEGIN_MESSAGE(m_schema, MessageType::Schema);
+  WRITE_LE<quint64>(m_schema, m_schemaHash);
+  m_schema.append(json);
+  END_MESSAGE(m_schema, msg);
+}
+
+/**
+ * Ends the protocol negotiation of the given @a socket. Plugins that use the
+ * @a binary protocol receive the hello message & the current schema.
+ */
+void Plugins::ServerWorker::finishNegotiation(QTcpSocket *socket,
+                                              const bool binary)
+{
+  // Update client state
+  auto client = m_clients.find(socket);
+  if (client == m_clients.end())
+    return;
+
+  client->binary = binary;
+  client->negotiating = false;
+  client->handshake.clear();
+  client->schemaHash = m_schemaHash;
+
+  // Send hello & schema messages
+  if (binary)
+  {
+    QByteArray data;
+    const auto msg = BEGIN_MESSAGE(data, MessageType::Hello);
+    WRITE_LE<quint16>(data, PLUGINS_BINARY_VERSION);
+    END_MESSAGE(data, msg);
+    data.append(m_schema);
+    enqueue(socket, *client, Message {data, true});
+  }
+
+  // Update user interface
+  reportClients();
+}
+
+/**
+ * Queues the @a json or the @a binary data for each plugin, depending on the
+ * protocol that it negotiated. Plugins that are still negotiating the
+ * protocol do not receive any data.
+ *
+ * Both byte arrays are implicitly shared, so each message is serialized once
+ * and the same buffer is referenced by the queue of every plugin. If the
+ * message is @a critical, it is queued even if the queue limit is exceeded.
+ *
+ * Binary plugins with a subscription do not receive the shared @c Frames
+ * messages (their frames are encoded separately), binary plugins that
+ * unsubscribed from raw data do not receive @c RawData messages, and only the
+ * plugins that subscribed to diagnostics data receive @c Diagnostics
+ * messages. Binary plugins only receive @c Statistics messages if they
+ * subscribed to statistics data, and @c Alarm messages unless they
+ * unsubscribed from alarm events.
+ */
+void Plugins::ServerWorker::sendData(const QByteArray &json,
+                                     const QByteArray &binary,
+                                     const MessageType type,
+                                     const bool critical)
+{
+  Q_FOREACH (auto socket, m_sockets)
+  {
+    if (!socket || !socket->isWritable())
+      continue;
+
+    auto client = m_clients.find(socket);
+    if (client == m_clients.end() || client->negotiating)
+      continue;
+
+    if (client->binary && type == MessageType::RawData && !client->raw)
+      continue;
+
+    if (client->binary && type == MessageType::Frames
+        && (client->filtered || client->maxRate > 0 || !client->frames))
+      continue;
+
+    if (type == MessageType::Diagnostics && !client->diagnostics)
+      continue;
+
+    if (client->binary && type == MessageType::Statistics
+        && !client->statistics)
+      continue;
+
+    if (client->binary && type == MessageType::Alarm && !client->alarms)
+      continue;
+
+    const auto &data = client->binary ? binary : json;
+    if (!data.isEmpty())
+      enqueue(socket, *client, Message {data, critical && client->binary});
+  }
+}
+
+/**
+ * Hands queued messages to the @a socket until its write buffer reaches
+ * @c PLUGINS_SOCKET_WATERMARK bytes, the remaining messages are written once
+ * the socket emits @c bytesWritten().
+ */
+void Plugins::ServerWorker::drain(QTcpSocket *socket, Client &client)
+{
+  // Write queued messages
+  while (!client.queue.isEmpty() && !client.closing
+         && socket->bytesToWrite() < PLUGINS_SOCKET_WATERMARK)
+  {
+    const auto message = client.queue.dequeue();
+    client.queuedBytes -= message.data.size();
+    socket->write(message.data);
+  }
+
+  // Reduce downsampling factor once the plugin catches up
+  const qint64 limit = static_cast<qint64>(m_queueLimit) * 1024 * 1024;
+  if (client.downsample > 1 && client.queuedBytes < limit / 4)
+    client.downsample /= 2;
+}
+
+/**
+ * Adds the given @a message to the queue of the given @a client, applying the
+ * overflow policy if the queue limit is exceeded, and writes as much queued
+ * data as possible to the @a socket.
+ */
+void Plugins::ServerWorker::enqueue(QTcpSocket *socket, Client &client,
+                                    const Message &message)
+{
+  // Plugin is being disconnected
+  if (client.closing)
+    return;
+
+  // Skip messages while the plugin is being downsampled
+  ++client.sequence;
+  if (!message.critical && client.downsample > 1
+      && client.sequence % client.downsample != 0)
+  {
+    ++client.dropped;
+    return;
+  }
+
+  // Apply overflow policy
+  const qint64 size = message.data.size();
+  const qint64 limit = static_cast<qint64>(m_queueLimit) * 1024 * 1024;
+  if (!message.critical && client.queuedBytes + size > limit)
+  {
+    switch (m_overflowPolicy)
+    {
+      case Server::DropOldest:
+        for (int i = 0; i < client.queue.count()
+                        && client.queuedBytes + size > limit;)
+        {
+          if (client.queue.at(i).critical)
+            ++i;
+          else
+          {
+            client.queuedBytes -= client.queue.at(i).data.size();
+            client.queue.removeAt(i);
+            ++client.dropped;
+          }
+        }
+        break;
+      case Server::Downsample:
+        client.downsample = qMin(client.downsample * 2, 1024);
+        ++client.dropped;
+        return;
+      case Server::Disconnect:
+        qWarning() << "Disconnecting plugin" << socket->peerAddress()
+                   << "which exceeded the queue limit";
+        close(socket, client);
+        return;
+      default:
+        ++client.dropped;
+        return;
+    }
+
+    // Message is larger than the queue limit
+    if (client.queuedBytes + size > limit)
+    {
+      ++client.dropped;
+      return;
+    }
+  }
+
+  // Queue the message & write it if possible
+  client.queue.enqueue(message);
+  client.queuedBytes += size;
+  drain(socket, client);
+}
+
+/**
+ * Discards the queue of the given @a client & closes the connection with the
+ * plugin once control returns to the event loop.
+ */
+void Plugins::ServerWorker::close(QTcpSocket *socket, Client &client)
+{
+  client.closing = true;
+  client.input.clear();
+  client.queue.clear();
+  client.queuedBytes = 0;
+  QTimer::singleShot(0, socket, [=] { socket->abort(); });
+}
+
+/**
+ * Processes the complete binary messages received from the given @a client,
+ * incomplete messages are kept until the rest of the data is received.
+ */
+void Plugins::ServerWorker::readMessages(QTcpSocket *socket, Client &client)
+{
+  int offset = 0;
+  const auto &input = client.input;
+  while (!client.closing && input.size() - offset >= 5)
+  {
+    // Validate message length
+    const auto length = qFromLittleEndian<quint32>(input.constData() + offset);
+    if (length < 1 || length > PLUGINS_MAX_MESSAGE_SIZE)
+    {
+      qWarning() << "Invalid message received from plugin"
+                 << socket->peerAddress();
+      close(socket, client);
+      return;
+    }
+
+    // Wait for the rest of the message
+    if (static_cast<quint32>(input.size() - offset - 4) < length)
+      break;
+
+    // Get message type & payload
+    const auto type = static_cast<quint8>(input.at(offset + 4));
+    const auto payload = input.mid(offset + 5, static_cast<int>(length) - 1);
+    offset += 4 + static_cast<int>(length);
+
+    // Process the message
+    if (type == static_cast<quint8>(MessageType::Write))
+      Q_EMIT writeRequested(payload);
+    else if (type == static_cast<quint8>(MessageType::Subscribe))
+      subscribe(client, payload);
+    else if (type == static_cast<quint8>(MessageType::Marker))
+      Q_EMIT markerRequested(QString::fromUtf8(payload));
+  }
+
+  // Remove processed messages
+  client.input.remove(0, offset);
+}
+
+/**
+ * Updates the subscription of the given @a client with the JSON document
+ * contained in the given @a payload.
+ */
+void Plugins::ServerWorker::subscribe(Client &client,
+                                      const QByteArray &payload)
+{
+  // Read the subscription document
+  QJsonParseError error;
+  const auto document = QJsonDocument::fromJson(payload, &error);
+  if (error.error != QJsonParseError::NoError)
+  {
+    qWarning() << "Invalid plugin subscription:" << error.errorString();
+    return;
+  }
+
+  // Read subscribed groups
+  const auto object = document.object();
+  client.groups.clear();
+  Q_FOREACH (const auto &value, object.value("groups").toArray())
+    client.groups.append(value.toInt(-1));
+
+  // Read subscribed datasets
+  client.datasets.clear();
+  Q_FOREACH (const auto &value, object.value("datasets").toArray())
+  {
+    const auto pair = value.toArray();
+    if (pair.count() == 2)
+      client.datasets.append(qMakePair(pair.at(0).toInt(-1),
+                                       pair.at(1).toInt(-1)));
+  }
+
+  // Read rate limit & raw data flag
+  client.lastFrame = 0;
+  client.raw = object.value("raw").toBool(true);
+  client.diagnostics = object.value("diagnostics").toBool(false);
+  client.statistics = object.value("statistics").toBool(false);
+  client.alarms = object.value("alarms").toBool(true);
+  client.maxRate = qMax(0.0, object.value("maxRate").toDouble(0));
+  client.filtered = !client.groups.isEmpty() || !client.datasets.isEmpty();
+
+  // Read aggregation window & frames flag
+  client.frames = object.value("frames").toBool(true);
+  client.aggregate = object.value("aggregate").toInt(0);
+  if (client.aggregate > 0)
+    client.aggregate = qBound(PLUGINS_MIN_AGGREGATE_WINDOW, client.aggregate,
+                              PLUGINS_MAX_AGGREGATE_WINDOW);
+  else
+    client.aggregate = 0;
+
+  updateAggregates();
+}
+
+/**
+ * Registers the window lengths subscribed by the connected plugins in the
+ * aggregator, each distinct length is only computed once.
+ */
+void Plugins::ServerWorker::updateAggregates()
+{
+  QVector<int> lengths;
+  for (auto client = m_clients.cbegin(); client != m_clients.cend(); ++client)
+  {
+    if (client->aggregate > 0 && !lengths.contains(client->aggregate))
+      lengths.append(client->aggregate);
+  }
+
+  if (m_aggregator)
+    m_aggregator->setWindows(lengths);
+}
+
+/**
+ * Returns a newline-terminated JSON document with the data of each registered
+ * frame.
+ */
+QByteArray Plugins::ServerWorker::jsonFrames() const
+{
+  // Create JSON array with frame data
+  QJsonArray array;
+  for (int i = 0; i < m_frames.count(); ++i)
+  {
+    QJsonObject object;
+    object.insert("data", m_frames.at(i).jsonData());
+    array.append(object);
+  }
+
+  // Construct QByteArray with data
+  QJsonObject object;
+  object.insert("frames", array);
+  const QJsonDocument document(object);
+  return document.toJson(QJsonDocument::Compact) + "\n";
+}
+
+/**
+ * Updates the current schema message with the structure of each registered
+ * frame. Returns, for each frame, the schema message that must be sent before
+ * it (or an empty byte array if the schema did not change).
+ */
+QVector<QByteArray> Plugins::ServerWorker::schemaMessages()
+{
+  QVector<QByteArray> schemas(m_frames.count());
+  for (int i = 0; i < m_frames.count(); ++i)
+  {
+    const auto &frame = m_frames.at(i);
+    if (m_schema.isEmpty() || frame.schemaHash() != m_schemaHash)
+    {
+      updateSchema(frame);
+      schemas[i] = m_schema;
+    }
+  }
+
+  return schemas;
+}
+
+/**
+ * Returns the binary messages that contain the values of each registered
+ * frame, preceded by the given @a schemas messages. If a schema message is
+ * included, @a schema is set to @c true.
+ *
+ * If a @a client is given, the frames are decimated to the maximum rate of its
+ * subscription & only the subscribed values are included.
+ */
+QByteArray
+Plugins::ServerWorker::binaryFrames(const QVector<QByteArray> &schemas,
+                                    Client *client, bool &schema)
+{
+  int msg = -1;
+  quint32 count = 0;
+  int countPosition = 0;
+
+  QByteArray data;
+  schema = false;
+  QVector<const JSON::Dataset *> datasets;
+  for (int i = 0; i < m_frames.count(); ++i)
+  {
+    // Finish the current frames message & insert the schema message
+    if (!schemas.value(i).isEmpty())
+    {
+      if (msg >= 0)
+      {
+        qToLittleEndian(count, data.data() + countPosition);
+        END_MESSAGE(data, msg);
+        msg = -1;
+      }
+
+      data.append(schemas.at(i));
+      schema = true;
+    }
+
+    // Decimate frames to the rate requested by the plugin
+    const auto &frame = m_frames.at(i);
+    const auto timestamp = m_timestamps.value(i);
+    if (client && client->maxRate > 0)
+    {
+      const auto interval = 1000 / client->maxRate;
+      if (client->lastFrame > 0 && timestamp - client->lastFrame < interval)
+        continue;
+
+      client->lastFrame = timestamp;
+    }
+
+    // Start a new frames message
+    if (msg < 0)
+    {
+      count = 0;
+      msg = BEGIN_MESSAGE(data, MessageType::Frames);
+      WRITE_LE<quint64>(data, frame.schemaHash());
+      countPosition = data.size();
+      WRITE_LE<quint32>(data, 0);
+    }
+
+    // Get the datasets to send
+    datasets.clear();
+    if (client && client->filtered)
+    {
+      Q_FOREACH (const auto g, client->groups)
+      {
+        if (g < 0 || g >= frame.groupCount())
+          continue;
+
+        const auto &group = frame.getGroup(g);
+        for (int d = 0; d < group.datasetCount(); ++d)
+          datasets.append(&group.getDataset(d));
+      }
+
+      Q_FOREACH (const auto &pair, client->datasets)
+      {
+        const JSON::Dataset *dataset = Q_NULLPTR;
+        if (pair.first >= 0 && pair.first < frame.groupCount())
+        {
+          const auto &group = frame.getGroup(pair.first);
+          if (pair.second >= 0 && pair.second < group.datasetCount())
+            dataset = &group.getDataset(pair.second);
+        }
+
+        datasets.append(dataset);
+      }
+    }
+
+    else
+    {
+      for (int g = 0; g < frame.groupCount(); ++g)
+      {
+        const auto &group = frame.getGroup(g);
+        for (int d = 0; d < group.datasetCount(); ++d)
+          datasets.append(&group.getDataset(d));
+      }
+    }
+
+    // Write reception time, number of values & the value of each dataset,
+    // invalid datasets are sent as NaN
+    WRITE_LE<qint64>(data, timestamp);
+    WRITE_LE<quint32>(data, static_cast<quint32>(datasets.count()));
+    Q_FOREACH (const auto *dataset, datasets)
+    {
+      if (dataset)
+        WRITE_VALUE(data, *dataset);
+      else
+      {
+        WRITE_LE<quint8>(data, 0);
+        WRITE_DOUBLE(data, qQNaN());
+      }
+    }
+
+    ++count;
+  }
+
+  // Finish the last frames message
+  if (msg >= 0)
+  {
+    qToLittleEndian(count, data.data() + countPosition);
+    END_MESSAGE(data, msg);
+  }
+
+  return data;
 }
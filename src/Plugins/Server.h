@@ -22,14 +22,23 @@
 
 #pragma once
 
+#include <QHash>
+#include <QQueue>
 #include <QObject>
+#include <QThread>
+#include <QVariantList>
 #include <QTcpSocket>
 #include <QTcpServer>
 #include <QByteArray>
+#include <QJsonObject>
 #include <QHostAddress>
 
 #include <JSON/Frame.h>
 #include <JSON/Dataset.h>
+#include <JSON/AlarmEngine.h>
+#include <JSON/SinkGraph.h>
+#include <Plugins/Aggregator.h>
+#include <Misc/Settings.h>
 
 /**
  * Default TCP port to use for incoming connections, I choose 7777 because 7 is
@@ -37,8 +46,39 @@
  */
 #define PLUGINS_TCP_PORT 7777
 
+/**
+ * Sequence that a plugin must send right after connecting in order to use the
+ * binary protocol instead of the JSON protocol.
+ */
+#define PLUGINS_BINARY_HANDSHAKE "SSBIN/1\n"
+
+/**
+ * Version of the binary protocol, reported in the hello message
+ */
+#define PLUGINS_BINARY_VERSION 1
+
+/**
+ * Time (in milliseconds) that the server waits for the binary handshake before
+ * falling back to the JSON protocol.
+ */
+#define PLUGINS_NEGOTIATION_TIMEOUT 1000
+
+/**
+ * Maximum number of bytes handed to the socket of a plugin at once, the rest
+ * of the outgoing data waits in the queue of the plugin.
+ */
+#define PLUGINS_SOCKET_WATERMARK (256 * 1024)
+
+/**
+ * Maximum size of a binary message sent by a plugin
+ */
+#define PLUGINS_MAX_MESSAGE_SIZE (16 * 1024 * 1024)
+
 namespace Plugins
 {
+class ServerWorker;
+class WebSocketServer;
+
 /**
  * @brief The Server class
  *
@@ -53,14 +93,80 @@ namespace Plugins
  * A benefit of implementing plugins in this manner is that you can write your
  * Serial Studio companion application in any language and framework that you
  * desire, you do not have to force yourself to use Qt or C/C++.
+ *
+ * Two protocols are supported, and the protocol is negotiated independently
+ * for each client:
+ *
+ * - JSON (default): newline-terminated JSON documents, raw data is sent as a
+ *   Base64 string & processed frames are sent at the rate selected in
+ *   @c Misc::TimerEvents (once per second by default).
+ * - Binary: selected by sending @c PLUGINS_BINARY_HANDSHAKE right after
+ *   connecting. Each message is encoded as a little-endian @c u32 length
+ *   (which counts the type byte & the payload), a @c u8 message type and the
+ *   payload (see @c MessageType). A hello message & the current schema are
+ *   sent right after the handshake, and the schema is sent again whenever the
+ *   frame structure changes.
+ *
+ * JSON plugins send data to the device by writing it on the socket. Binary
+ * plugins use the same message framing in both directions, they send data to
+ * the device with @c Write messages and can reduce the amount of data that
+ * they receive with a @c Subscribe message. Binary plugins can also add
+ * event markers to the current recording with @c Marker messages.
+ *
+ * Each message is serialized once and the same (implicitly shared) buffer is
+ * queued for every plugin. Only @c PLUGINS_SOCKET_WATERMARK bytes are handed
+ * to each socket at a time, the rest waits in a per-plugin queue limited to
+ * @c queueLimit() MiB. When a slow plugin exceeds its limit, the selected
+ * @c OverflowPolicy is applied to that plugin only. Hello & schema messages
+ * are never dropped.
+ *
+ * The TCP server & the sockets of the plugins live in a dedicated network
+ * thread (see @c ServerWorker), so that serializing & writing plugin data
+ * never competes with the user interface. The @c Server object lives in the
+ * main thread, hands frames & raw data over to the worker and writes the data
+ * received from the plugins to the device.
+ *
+ * Binary plugins can also subscribe to aggregated streams (minimum, maximum,
+ * mean & last value of each dataset over a window of the given length). The
+ * aggregates are computed once from the full-rate frame stream by an
+ * @c Aggregator and shared among all the plugins that use the same window.
+ *
+ * Optionally, a WebSocket endpoint for remote dashboards is served from the
+ * same thread (see @c WebSocketServer).
  */
-class Server : public QObject
+class Server : public QObject, public JSON::FrameSink
 {
-  Q_OBJECT
-  Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(bool webSocketEnabled
+               READ webSocketEnabled
+               WRITE setWebSocketEnabled
+               NOTIFY webSocketEnabledChanged)
+    Q_PROPERTY(int queueLimit
+               READ queueLimit
+               WRITE setQueueLimit
+               NOTIFY queuePolicyChanged)
+    Q_PROPERTY(int overflowPolicy
+               READ overflowPolicy
+               WRITE setOverflowPolicy
+               NOTIFY queuePolicyChanged)
+    Q_PROPERTY(QVariantList clients
+               READ clients
+               NOTIFY clientsChanged)
+    Q_PROPERTY(QStringList availableOverflowPolicies
+               READ availableOverflowPolicies
+               CONSTANT)
+  // clang-format on
 
 Q_SIGNALS:
+  void clientsChanged();
   void enabledChanged();
+  void queuePolicyChanged();
+  void webSocketEnabledChanged();
 
 private:
   explicit Server();
@@ -72,25 +178,256 @@ private:
   ~Server();
 
 public:
+  /**
+   * Types of the messages sent with the binary protocol:
+   *
+   * - @c Hello: @c u16 protocol version.
+   * - @c Schema: @c u64 schema hash followed by a UTF-8 JSON document with the
+   *   title of the frame & the title, units and widget of each dataset.
+   * - @c RawData: @c u64 reception time (ms since epoch) & the raw bytes.
+   * - @c Frames: @c u64 schema hash, @c u32 frame count and, for each frame, a
+   *   @c u64 reception time, a @c u32 value count and the values, ordered by
+   *   group & dataset. Each value is a @c u8 type tag followed by a @c f64
+   *   (tag 0) or by a @c u32 length & UTF-8 text (tag 1).
+   * - @c Diagnostics: UTF-8 JSON document with the pipeline statistics (see
+   *   @c Misc::Diagnostics::snapshot()), sent once per second to the plugins
+   *   that subscribed to it.
+   * - @c Statistics: UTF-8 JSON document with the session & windowed
+   *   statistics of each dataset (see @c UI::Dashboard::statisticsSnapshot()),
+   *   sent once per second to the plugins that subscribed to it. JSON plugins
+   *   always receive the same array in the @c statistics key of a separate
+   *   document.
+   * - @c Alarm: UTF-8 JSON array with the alarm events raised or cleared by
+   *   the alarm engine of the JSON generator (see @c JSON::AlarmEvent), sent
+   *   as soon as the events occur. JSON plugins receive the same array in the
+   *   @c alarms key of a separate document.
+   * - @c Aggregates: @c u64 schema hash, @c u64 window start (ms since
+   *   epoch), @c u32 window length (ms), @c u32 number of frames in the
+   *   window, @c u32 value count and, for each dataset of the frame (ordered
+   *   by group & dataset), its minimum, maximum, mean & last value as
+   *   @c f64. Values are NaN if the dataset had no numeric value during the
+   *   window. Sent to the plugins that subscribed to the window length.
+   *
+   * Messages sent by binary plugins:
+   *
+   * - @c Write: raw bytes that are written to the device.
+   * - @c Subscribe: UTF-8 JSON document with the optional @c groups (array of
+   *   group indexes), @c datasets (array of @c [group, dataset] pairs),
+   *   @c maxRate (maximum frames per second), @c raw (boolean, receive raw
+   *   data), @c diagnostics (boolean, receive diagnostics data) &
+   *   @c statistics (boolean, receive dataset statistics), @c alarms
+   *   (boolean, receive alarm events, enabled by default), @c aggregate
+   *   (window length in ms, receive @c Aggregates messages) & @c frames
+   *   (boolean, receive @c Frames messages, enabled by default) keys. If
+   *   groups or datasets are given, @c Frames messages only contain the values
+   *   of the datasets of the subscribed groups followed by the subscribed
+   *   datasets, in the order given by the plugin.
+   * - @c Marker: UTF-8 label of an event marker, which is added to the
+   *   current recording at the time the message is received (see
+   *   @c CSV::MarkerIndex).
+   */
+  enum class MessageType
+  {
+    Hello = 0x00,
+    Schema = 0x01,
+    RawData = 0x02,
+    Frames = 0x03,
+    Diagnostics = 0x04,
+    Statistics = 0x05,
+    Alarm = 0x06,
+    Aggregates = 0x07,
+    Write = 0x10,
+    Subscribe = 0x11,
+    Marker = 0x12
+  };
+  Q_ENUM(MessageType)
+
+  /**
+   * Action taken when the queue of a plugin exceeds the queue limit:
+   *
+   * - @c DropOldest: discard the oldest queued messages.
+   * - @c DropNewest: discard the new message.
+   * - @c Downsample: only queue one of every N messages, N is doubled each
+   *   time that the limit is exceeded & halved once the queue drains.
+   * - @c Disconnect: close the connection with the plugin.
+   */
+  enum OverflowPolicy
+  {
+    DropOldest,
+    DropNewest,
+    Downsample,
+    Disconnect
+  };
+  Q_ENUM(OverflowPolicy)
+
   static Server &instance();
+  static QJsonObject schema(const JSON::Frame &frame);
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
   bool enabled() const;
+  bool webSocketEnabled() const;
+  int queueLimit() const;
+  int overflowPolicy() const;
+  QVariantList clients() const;
+  QStringList availableOverflowPolicies() const;
 
 public Q_SLOTS:
-  void removeConnection();
+  void start();
+  void closeConnections();
+  void setEnabled(const bool enabled);
+  void setQueueLimit(const int megabytes);
+  void setOverflowPolicy(const int policy);
+  void setWebSocketEnabled(const bool enabled);
+
+private Q_SLOTS:
+  void sendDiagnostics();
+  void sendStatistics();
+  void sendAlarms(const QVector<JSON::AlarmEvent> &events);
+  void sendAggregates();
+  void sendProcessedData();
+  void sendRawData(const QByteArray &data, const qint64 timestamp);
+  void onListenFailed(const QString &error);
+  void onWriteRequested(const QByteArray &data);
+  void onMarkerRequested(const QString &label);
+  void onClientsChanged(const QVariantList &clients);
+  void registerFrames(const QVector<JSON::Frame> &frames);
+
+private:
+  void configureWorker();
+
+private:
+  bool m_enabled;
+  bool m_webSocketEnabled;
+  int m_queueLimit;
+  int m_overflowPolicy;
+
+  Aggregator m_aggregator;
+  QThread m_thread;
+  Misc::Settings m_settings;
+  QVariantList m_clients;
+  ServerWorker *m_worker;
+  WebSocketServer *m_webSocket;
+};
+
+/**
+ * @brief The ServerWorker class
+ *
+ * Worker object of the @c Server class, runs in its own thread and owns the
+ * TCP server & the sockets of the connected plugins. It negotiates the
+ * protocol of each plugin, serializes frames & raw data, manages the outgoing
+ * queue of each plugin and processes the data sent by the plugins.
+ *
+ * Data that must be written to the device is not written directly, instead it
+ * is emitted with @c writeRequested(), which is delivered to the main thread
+ * through a queued connection.
+ */
+class ServerWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void listenFailed(const QString &error);
+  void writeRequested(const QByteArray &data);
+  void markerRequested(const QString &label);
+  void clientsChanged(const QVariantList &clients);
+
+public:
+  explicit ServerWorker(Aggregator *aggregator);
+  ~ServerWorker();
+
+public Q_SLOTS:
+  void listen();
+  void reportClients();
+  void closeConnections();
+  void sendProcessedData();
   void setEnabled(const bool enabled);
+  void sendDiagnostics(const QByteArray &json);
+  void sendStatistics(const QByteArray &json);
+  void sendAlarms(const QByteArray &json);
+  void sendAggregates(const QVector<Plugins::AggregateWindow> &windows);
+  void setQueuePolicy(const int megabytes, const int policy);
+  void sendRawData(const QByteArray &data, const qint64 timestamp);
+  void registerFrames(const QVector<JSON::Frame> &frames);
 
 private Q_SLOTS:
   void onDataReceived();
+  void onBytesWritten();
+  void removeConnection();
   void acceptConnection();
-  void sendProcessedData();
-  void sendRawData(const QByteArray &data);
-  void registerFrame(const QJsonObject &json);
   void onErrorOccurred(const QAbstractSocket::SocketError socketError);
 
 private:
+  typedef Server::MessageType MessageType;
+
+  void updateSchema(const JSON::Frame &frame);
+  void finishNegotiation(QTcpSocket *socket, const bool binary);
+  void sendData(const QByteArray &json, const QByteArray &binary,
+                const MessageType type, const bool critical = false);
+
+  QByteArray jsonFrames() const;
+  QVector<QByteArray> schemaMessages();
+
+private:
+  /**
+   * Outgoing message, critical messages are never dropped
+   */
+  struct Message
+  {
+    QByteArray data;
+    bool critical;
+  };
+
+  /**
+   * Protocol & queue state of a connected plugin
+   */
+  struct Client
+  {
+    bool raw = true;
+    bool binary = false;
+    bool closing = false;
+    bool filtered = false;
+    bool diagnostics = false;
+    bool statistics = false;
+    bool alarms = true;
+    bool frames = true;
+    int aggregate = 0;
+    quint64 schemaHash = 0;
+    bool negotiating = true;
+    int downsample = 1;
+    double maxRate = 0;
+    qint64 lastFrame = 0;
+    quint64 sequence = 0;
+    quint64 dropped = 0;
+    qint64 queuedBytes = 0;
+    QByteArray input;
+    QByteArray handshake;
+    QQueue<Message> queue;
+    QVector<int> groups;
+    QVector<QPair<int, int>> datasets;
+  };
+
+  QByteArray binaryFrames(const QVector<QByteArray> &schemas, Client *client,
+                          bool &schema);
+
+  void close(QTcpSocket *socket, Client &client);
+  void drain(QTcpSocket *socket, Client &client);
+  void readMessages(QTcpSocket *socket, Client &client);
+  void subscribe(Client &client, const QByteArray &payload);
+  void updateAggregates();
+  void enqueue(QTcpSocket *socket, Client &client, const Message &message);
+
   bool m_enabled;
-  QTcpServer m_server;
-  QVector<QJsonObject> m_frames;
+  int m_queueLimit;
+  int m_overflowPolicy;
+  QTcpServer *m_server;
+  Aggregator *m_aggregator;
+  QByteArray m_schema;
+  quint64 m_schemaHash;
+  QVector<qint64> m_timestamps;
+  QVector<JSON::Frame> m_frames;
   QVector<QTcpSocket *> m_sockets;
+  QHash<QTcpSocket *, Client> m_clients;
 };
 } // namespace Plugins
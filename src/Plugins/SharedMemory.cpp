@@ -0,0 +1,532 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <QDebug>
+#include <QtEndian>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+#if defined(Q_OS_WIN)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
+#include <Plugins/Server.h>
+#include <Plugins/SharedMemory.h>
+
+/**
+ * Layout of the segment header, see the documentation of the class
+ */
+static const quint32 HEADER_SIZE = 4096;
+static const quint32 SCHEMA_CAPACITY = 64 * 1024;
+static const quint32 DATA_OFFSET = HEADER_SIZE + SCHEMA_CAPACITY;
+static const int OFFSET_VERSION = 8;
+static const int OFFSET_SCHEMA_OFFSET = 12;
+static const int OFFSET_SCHEMA_CAPACITY = 16;
+static const int OFFSET_DATA_OFFSET = 20;
+static const int OFFSET_DATA_CAPACITY = 24;
+static const int OFFSET_WRITER_PID = 32;
+static const int OFFSET_RESERVED = 64;
+static const int OFFSET_COMMITTED = 72;
+static const int OFFSET_SEQUENCE = 80;
+static const int OFFSET_SCHEMA_VERSION = 128;
+static const int OFFSET_SCHEMA_SIZE = 132;
+static const int OFFSET_SCHEMA_HASH = 136;
+
+/**
+ * Size of the header of each record & value count of padding records
+ */
+static const int RECORD_HEADER_SIZE = 32;
+static const quint32 PADDING_RECORD = 0xFFFFFFFF;
+
+/**
+ * Writes the given @a value at the given @a offset of the @a memory block in
+ * little-endian order
+ */
+template<typename T>
+static void STORE_LE(char *memory, const int offset, const T value)
+{
+  qToLittleEndian(value, memory + offset);
+}
+
+/**
+ * Returns the atomic 64-bit counter stored at the given @a offset of the
+ * segment header. Counters are naturally aligned & only modified by the
+ * writer, readers load them with acquire semantics.
+ */
+static std::atomic<quint64> *COUNTER64(char *memory, const int offset)
+{
+  return reinterpret_cast<std::atomic<quint64> *>(memory + offset);
+}
+
+/**
+ * Returns the atomic 32-bit counter stored at the given @a offset of the
+ * segment header
+ */
+static std::atomic<quint32> *COUNTER32(char *memory, const int offset)
+{
+  return reinterpret_cast<std::atomic<quint32> *>(memory + offset);
+}
+
+/**
+ * Appends the given @a value to the @a buffer in little-endian order
+ */
+template<typename T>
+static void APPEND_LE(QByteArray &buffer, const T value)
+{
+  const T le = qToLittleEndian(value);
+  buffer.append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+/**
+ * Constructor function, reads the settings, creates the segment if enabled &
+ * registers the module in the sink graph of the JSON generator.
+ */
+Plugins::SharedMemory::SharedMemory()
+  : m_memory(Q_NULLPTR)
+  , m_handle(Q_NULLPTR)
+  , m_segmentSize(0)
+  , m_capacity(0)
+  , m_position(0)
+  , m_sequence(0)
+  , m_schemaHash(0)
+  , m_dropped(0)
+{
+  // Read settings
+  m_enabled = m_settings.value("Plugins_SharedMemory", false).toBool();
+  m_ringSize = m_settings.value("Plugins_SharedMemorySize", 16).toInt();
+  m_ringSize = qBound(1, m_ringSize, 1024);
+
+  // Create the segment
+  if (m_enabled)
+    open();
+
+  // Frames are copied to the ring in the worker pool of the sink graph
+  JSON::Generator::instance().sinks().addSink(
+      this, JSON::SinkGraph::Port::Frames,
+      JSON::SinkGraph::Affinity::WorkerPool);
+}
+
+/**
+ * Destructor function, removes the shared memory segment
+ */
+Plugins::SharedMemory::~SharedMemory()
+{
+  QMutexLocker locker(&m_mutex);
+  close();
+}
+
+/**
+ * Returns a pointer to the only instance of this class
+ */
+Plugins::SharedMemory &Plugins::SharedMemory::instance()
+{
+  static SharedMemory singleton;
+  return singleton;
+}
+
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString Plugins::SharedMemory::sinkName() const
+{
+  return QStringLiteral("Plugins::SharedMemory");
+}
+
+/**
+ * Copies the given @a frames to the ring buffer of the segment
+ *
+ * @note This function is called by the worker pool of the sink graph.
+ */
+void Plugins::SharedMemory::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  QMutexLocker locker(&m_mutex);
+  if (!m_memory)
+    return;
+
+  for (const auto &frame : frames)
+  {
+    writeSchema(frame);
+    writeFrame(frame);
+  }
+}
+
+/**
+ * Returns @c true if frames are published to the shared memory segment
+ */
+bool Plugins::SharedMemory::enabled() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_enabled;
+}
+
+/**
+ * Returns the capacity of the data ring in MiB
+ */
+int Plugins::SharedMemory::ringSize() const
+{
+  return m_ringSize;
+}
+
+/**
+ * Returns the description of the last error that occurred while creating the
+ * segment, or an empty string
+ */
+QString Plugins::SharedMemory::lastError() const
+{
+  return m_lastError;
+}
+
+/**
+ * Returns the platform-specific name that readers use to open the segment
+ */
+QString Plugins::SharedMemory::segmentName() const
+{
+#if defined(Q_OS_WIN)
+  return QStringLiteral("Local\\SerialStudioFrames");
+#else
+  return QStringLiteral(PLUGINS_SHM_NAME);
+#endif
+}
+
+/**
+ * Returns the number of frames that were too large to fit in the ring
+ */
+quint64 Plugins::SharedMemory::droppedFrames() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_dropped;
+}
+
+/**
+ * Returns the sequence number of the last frame published to the ring
+ */
+quint64 Plugins::SharedMemory::publishedFrames() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_sequence;
+}
+
+/**
+ * Enables or disables the shared memory transport, the segment is created
+ * when enabled & removed when disabled.
+ */
+void Plugins::SharedMemory::setEnabled(const bool enabled)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_enabled == enabled)
+      return;
+
+    m_enabled = enabled;
+    if (enabled)
+      open();
+    else
+      close();
+  }
+
+  m_settings.setValue("Plugins_SharedMemory", enabled);
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Changes the capacity of the data ring to the given number of
+ * @a megabytes, the segment is re-created if it is open.
+ */
+void Plugins::SharedMemory::setRingSize(const int megabytes)
+{
+  const auto value = qBound(1, megabytes, 1024);
+  if (m_ringSize == value)
+    return;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    m_ringSize = value;
+    if (m_memory)
+    {
+      close();
+      open();
+    }
+  }
+
+  m_settings.setValue("Plugins_SharedMemorySize", value);
+  Q_EMIT ringSizeChanged();
+}
+
+/**
+ * Creates & maps the shared memory segment and initializes its header.
+ *
+ * @note The caller must hold the mutex.
+ */
+bool Plugins::SharedMemory::open()
+{
+  // Calculate segment size
+  m_capacity = static_cast<quint64>(m_ringSize) * 1024 * 1024;
+  m_segmentSize = static_cast<qint64>(DATA_OFFSET + m_capacity);
+
+  // Create the file mapping
+#if defined(Q_OS_WIN)
+  const auto name = segmentName().toStdWString();
+  const auto size = static_cast<quint64>(m_segmentSize);
+  auto handle = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL,
+                                   PAGE_READWRITE, DWORD(size >> 32),
+                                   DWORD(size & 0xFFFFFFFF), name.c_str());
+  if (!handle)
+  {
+    setLastError(tr("Cannot create the shared memory segment (error %1)")
+                     .arg(GetLastError()));
+    return false;
+  }
+
+  auto memory = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+  if (!memory)
+  {
+    setLastError(tr("Cannot map the shared memory segment (error %1)")
+                     .arg(GetLastError()));
+    CloseHandle(handle);
+    return false;
+  }
+
+  m_handle = handle;
+  m_memory = static_cast<char *>(memory);
+
+  // Create the POSIX shared memory object
+#else
+  const int fd = shm_open(PLUGINS_SHM_NAME, O_CREAT | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    setLastError(tr("Cannot create the shared memory segment: %1")
+                     .arg(QString::fromLocal8Bit(strerror(errno))));
+    return false;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(m_segmentSize)) != 0)
+  {
+    setLastError(tr("Cannot resize the shared memory segment: %1")
+                     .arg(QString::fromLocal8Bit(strerror(errno))));
+    ::close(fd);
+    shm_unlink(PLUGINS_SHM_NAME);
+    return false;
+  }
+
+  auto memory = mmap(Q_NULLPTR, static_cast<size_t>(m_segmentSize),
+                     PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED)
+  {
+    setLastError(tr("Cannot map the shared memory segment: %1")
+                     .arg(QString::fromLocal8Bit(strerror(errno))));
+    shm_unlink(PLUGINS_SHM_NAME);
+    return false;
+  }
+
+  m_memory = static_cast<char *>(memory);
+#endif
+
+  // Initialize the header, the magic is written last so that readers never
+  // see a partially initialized segment
+  memset(m_memory, 0, HEADER_SIZE);
+  STORE_LE<quint32>(m_memory, OFFSET_VERSION, PLUGINS_SHM_VERSION);
+  STORE_LE<quint32>(m_memory, OFFSET_SCHEMA_OFFSET, HEADER_SIZE);
+  STORE_LE<quint32>(m_memory, OFFSET_SCHEMA_CAPACITY, SCHEMA_CAPACITY);
+  STORE_LE<quint32>(m_memory, OFFSET_DATA_OFFSET, DATA_OFFSET);
+  STORE_LE<quint64>(m_memory, OFFSET_DATA_CAPACITY, m_capacity);
+  STORE_LE<quint64>(m_memory, OFFSET_WRITER_PID,
+                    static_cast<quint64>(qApp->applicationPid()));
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(m_memory, "SSFRAMES", 8);
+
+  // Reset the state of the writer
+  m_position = 0;
+  m_sequence = 0;
+  m_schemaHash = 0;
+  m_dropped = 0;
+  setLastError(QString());
+  return true;
+}
+
+/**
+ * Unmaps & removes the shared memory segment, readers that still have the
+ * segment mapped keep their copy until they unmap it.
+ *
+ * @note The caller must hold the mutex.
+ */
+void Plugins::SharedMemory::close()
+{
+  if (!m_memory)
+    return;
+
+  // Invalidate the magic, so that readers know the writer has gone
+  memset(m_memory, 0, 8);
+
+  // Unmap the segment
+#if defined(Q_OS_WIN)
+  UnmapViewOfFile(m_memory);
+  CloseHandle(static_cast<HANDLE>(m_handle));
+#else
+  munmap(m_memory, static_cast<size_t>(m_segmentSize));
+  shm_unlink(PLUGINS_SHM_NAME);
+#endif
+
+  // Reset state
+  m_memory = Q_NULLPTR;
+  m_handle = Q_NULLPTR;
+  m_segmentSize = 0;
+  m_capacity = 0;
+}
+
+/**
+ * Updates the last error & notifies the user interface from the main thread
+ */
+void Plugins::SharedMemory::setLastError(const QString &error)
+{
+  if (m_lastError == error)
+    return;
+
+  m_lastError = error;
+  if (!error.isEmpty())
+    qWarning() << "Plugins::SharedMemory:" << error;
+
+  QMetaObject::invokeMethod(this, "lastErrorChanged", Qt::QueuedConnection);
+}
+
+/**
+ * Publishes the schema of the given @a frame if its structure changed. The
+ * schema version is odd while the schema area is being modified.
+ *
+ * @note The caller must hold the mutex.
+ */
+void Plugins::SharedMemory::writeSchema(const JSON::Frame &frame)
+{
+  // Schema did not change
+  if (frame.schemaHash() == m_schemaHash && m_sequence > 0)
+    return;
+
+  // Create the schema document
+  m_schemaHash = frame.schemaHash();
+  auto json = QJsonDocument(Server::schema(frame))
+                  .toJson(QJsonDocument::Compact);
+  if (json.size() > static_cast<int>(SCHEMA_CAPACITY))
+    json.clear();
+
+  // Write the schema between two increments of the version
+  auto version = COUNTER32(m_memory, OFFSET_SCHEMA_VERSION);
+  version->fetch_add(1, std::memory_order_acq_rel);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(m_memory + HEADER_SIZE, json.constData(), json.size());
+  STORE_LE<quint32>(m_memory, OFFSET_SCHEMA_SIZE, quint32(json.size()));
+  STORE_LE<quint64>(m_memory, OFFSET_SCHEMA_HASH, m_schemaHash);
+  version->fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * Encodes the given @a frame & appends it to the data ring, wrapping around
+ * with a padding record if it does not fit before the end of the ring.
+ *
+ * @note The caller must hold the mutex.
+ */
+void Plugins::SharedMemory::writeFrame(const JSON::Frame &frame)
+{
+  // Encode the values of the frame
+  m_record.clear();
+  quint32 count = 0;
+  for (int g = 0; g < frame.groupCount(); ++g)
+  {
+    const auto &group = frame.getGroup(g);
+    for (int d = 0; d < group.datasetCount(); ++d, ++count)
+    {
+      const auto &dataset = group.getDataset(d);
+      if (dataset.isNumeric())
+      {
+        quint64 bits;
+        const double value = dataset.numericValue();
+        memcpy(&bits, &value, sizeof(bits));
+        APPEND_LE<quint8>(m_record, 0);
+        APPEND_LE<quint64>(m_record, bits);
+      }
+
+      else
+      {
+        const auto text = dataset.value().toUtf8();
+        APPEND_LE<quint8>(m_record, 1);
+        APPEND_LE<quint32>(m_record, static_cast<quint32>(text.size()));
+        m_record.append(text);
+      }
+    }
+  }
+
+  // Frames larger than a quarter of the ring are not published
+  const auto size = (RECORD_HEADER_SIZE + quint64(m_record.size()) + 7) & ~7ULL;
+  if (size > m_capacity / 4)
+  {
+    ++m_dropped;
+    return;
+  }
+
+  // Reserve space for a padding record if the frame does not fit before the
+  // end of the ring, the reserved position tells readers what is overwritten
+  auto reserved = COUNTER64(m_memory, OFFSET_RESERVED);
+  auto committed = COUNTER64(m_memory, OFFSET_COMMITTED);
+  char *ring = m_memory + DATA_OFFSET;
+  auto offset = m_position % m_capacity;
+  if (offset + size > m_capacity)
+  {
+    const auto padding = m_capacity - offset;
+    reserved->store(m_position + padding, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    STORE_LE<quint32>(ring, int(offset), quint32(padding));
+    STORE_LE<quint32>(ring, int(offset) + 4, PADDING_RECORD);
+    m_position += padding;
+    offset = 0;
+  }
+
+  // Reserve space for the record
+  reserved->store(m_position + size, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  // Write the record
+  char *record = ring + offset;
+  const auto time = IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp());
+  STORE_LE<quint32>(record, 0, quint32(size));
+  STORE_LE<quint32>(record, 4, count);
+  STORE_LE<quint64>(record, 8, m_sequence + 1);
+  STORE_LE<qint64>(record, 16, time);
+  STORE_LE<quint64>(record, 24, frame.schemaHash());
+  memcpy(record + RECORD_HEADER_SIZE, m_record.constData(), m_record.size());
+
+  // Publish the record
+  m_position += size;
+  ++m_sequence;
+  committed->store(m_position, std::memory_order_release);
+  COUNTER64(m_memory, OFFSET_SEQUENCE)
+      ->store(m_sequence, std::memory_order_release);
+}
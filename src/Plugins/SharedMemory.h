@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QByteArray>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <Misc/Settings.h>
+
+/**
+ * Name of the shared memory segment, on Windows the segment is created in
+ * the session namespace as "Local\SerialStudioFrames".
+ */
+#define PLUGINS_SHM_NAME "/serial-studio-frames"
+
+/**
+ * Version of the shared memory layout, stored in the segment header
+ */
+#define PLUGINS_SHM_VERSION 1
+
+namespace Plugins
+{
+/**
+ * @brief The SharedMemory class
+ *
+ * Publishes every frame generated by the JSON generator to a ring buffer in a
+ * shared memory segment (POSIX shared memory or a Windows file mapping), so
+ * that local plugins can read the frame stream at memory speed, without the
+ * TCP & JSON costs of the plugin server and without any system call per
+ * frame.
+ *
+ * All integers are little-endian. The segment starts with a 4 KiB header:
+ *
+ * - @c 0: 8-byte magic @c "SSFRAMES".
+ * - @c 8: @c u32 layout version (see @c PLUGINS_SHM_VERSION).
+ * - @c 12: @c u32 offset of the schema area.
+ * - @c 16: @c u32 capacity of the schema area.
+ * - @c 20: @c u32 offset of the data ring.
+ * - @c 24: @c u64 capacity of the data ring.
+ * - @c 32: @c u64 process ID of the writer.
+ * - @c 64: atomic @c u64 reserved position (total bytes reserved).
+ * - @c 72: atomic @c u64 committed position (total bytes published).
+ * - @c 80: atomic @c u64 sequence number of the last published frame.
+ * - @c 128: atomic @c u32 schema version, odd while the schema is updated.
+ * - @c 132: @c u32 size of the schema document.
+ * - @c 136: @c u64 schema hash.
+ *
+ * The schema area holds the same UTF-8 JSON document that the binary plugin
+ * protocol sends in @c Schema messages (see @c Server::schema()). Readers copy
+ * it & discard the copy if the schema version is odd or changed meanwhile.
+ *
+ * The data ring holds a sequence of records aligned to 8 bytes, the position
+ * of a record in the ring is its absolute position modulo the capacity:
+ *
+ * - @c u32 record size, including the header & the padding.
+ * - @c u32 value count, @c 0xFFFFFFFF marks a padding record that fills the
+ *   end of the ring & must be skipped.
+ * - @c u64 frame sequence number, incremented by one for each frame.
+ * - @c u64 reception time (ms since epoch).
+ * - @c u64 schema hash.
+ * - The values, encoded as in the @c Frames messages of the binary plugin
+ *   protocol: a @c u8 type tag followed by a @c f64 (tag 0) or by a @c u32
+ *   length & UTF-8 text (tag 1).
+ *
+ * The writer never waits for the readers. Before a record is written, the
+ * reserved position is advanced past it; when the record is complete, the
+ * committed position & the sequence number are updated. A reader keeps its
+ * own position, reads the records between its position & the committed
+ * position, and after copying each record checks that the reserved position
+ * is still within one capacity of the start of the record. Otherwise the
+ * record was overwritten & the reader must resynchronize to the committed
+ * position. Gaps in the sequence numbers tell the reader how many frames it
+ * missed.
+ */
+class SharedMemory : public QObject, public JSON::FrameSink
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int ringSize
+               READ ringSize
+               WRITE setRingSize
+               NOTIFY ringSizeChanged)
+    Q_PROPERTY(QString segmentName
+               READ segmentName
+               CONSTANT)
+    Q_PROPERTY(QString lastError
+               READ lastError
+               NOTIFY lastErrorChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void ringSizeChanged();
+  void lastErrorChanged();
+
+private:
+  explicit SharedMemory();
+  SharedMemory(SharedMemory &&) = delete;
+  SharedMemory(const SharedMemory &) = delete;
+  SharedMemory &operator=(SharedMemory &&) = delete;
+  SharedMemory &operator=(const SharedMemory &) = delete;
+
+  ~SharedMemory();
+
+public:
+  static SharedMemory &instance();
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  bool enabled() const;
+  int ringSize() const;
+  QString lastError() const;
+  QString segmentName() const;
+  quint64 droppedFrames() const;
+  quint64 publishedFrames() const;
+
+public Q_SLOTS:
+  void setEnabled(const bool enabled);
+  void setRingSize(const int megabytes);
+
+private:
+  bool open();
+  void close();
+  void setLastError(const QString &error);
+  void writeSchema(const JSON::Frame &frame);
+  void writeFrame(const JSON::Frame &frame);
+
+private:
+  bool m_enabled;
+  int m_ringSize;
+  QString m_lastError;
+
+  char *m_memory;
+  void *m_handle;
+  qint64 m_segmentSize;
+  quint64 m_capacity;
+
+  quint64 m_position;
+  quint64 m_sequence;
+  quint64 m_schemaHash;
+  quint64 m_dropped;
+  QByteArray m_record;
+
+  mutable QMutex m_mutex;
+  Misc::Settings m_settings;
+};
+} // namespace Plugins
@@ -0,0 +1,563 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <algorithm>
+
+#include <QtEndian>
+
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
+#include <Plugins/UdpForwarder.h>
+
+/**
+ * Appends the given @a value to the @a buffer in little-endian order
+ */
+template<typename T>
+static void WRITE_LE(QByteArray &buffer, const T value)
+{
+  const T le = qToLittleEndian(value);
+  buffer.append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+/**
+ * Appends the index, the type tag & the value of the given @a dataset to the
+ * @a buffer.
+ */
+static void WRITE_VALUE(QByteArray &buffer, const JSON::Dataset &dataset)
+{
+  WRITE_LE<quint32>(buffer, static_cast<quint32>(dataset.index()));
+  if (dataset.isNumeric())
+  {
+    quint64 bits;
+    const double value = dataset.numericValue();
+    memcpy(&bits, &value, sizeof(bits));
+    WRITE_LE<quint8>(buffer, 0);
+    WRITE_LE<quint64>(buffer, bits);
+  }
+
+  else
+  {
+    const auto text = dataset.value().toUtf8();
+    WRITE_LE<quint8>(buffer, 1);
+    WRITE_LE<quint32>(buffer, static_cast<quint32>(text.size()));
+    buffer.append(text);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// Forwarder
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, reads the settings, starts the network thread &
+ * registers the module in the sink graph of the JSON generator.
+ */
+Plugins::UdpForwarder::UdpForwarder()
+  : m_worker(new UdpWorker())
+{
+  // Read settings
+  m_enabled = m_settings.value("Plugins_UdpForwarder", false).toBool();
+  m_datasets = m_settings.value("Plugins_UdpDatasets", "").toString();
+  m_destinations
+      = m_settings.value("Plugins_UdpDestinations", "127.0.0.1:9000")
+            .toString();
+
+  const auto format = m_settings.value("Plugins_UdpFormat", 0).toInt();
+  const auto mode = m_settings.value("Plugins_UdpMode", 0).toInt();
+  m_format = format == 1 ? Format::CSV : Format::Binary;
+  m_mode = mode == 1 ? Mode::PerBatch : Mode::PerFrame;
+  setDatasets(m_datasets);
+
+  // Move the worker to the network thread
+  m_thread.setObjectName(QStringLiteral("Plugins::UdpWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(m_worker, &UdpWorker::sendFailed, this,
+          &Plugins::UdpForwarder::onSendFailed);
+  m_thread.start();
+
+  // Records are encoded in the worker pool of the sink graph
+  JSON::Generator::instance().sinks().addSink(
+      this, JSON::SinkGraph::Port::Frames,
+      JSON::SinkGraph::Affinity::WorkerPool);
+
+  // Resolve the destinations
+  configureWorker();
+}
+
+/**
+ * Destructor function, closes the socket & stops the network thread
+ */
+Plugins::UdpForwarder::~UdpForwarder()
+{
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(
+      worker, [=] { worker->closeSocket(); }, Qt::BlockingQueuedConnection);
+
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Plugins::UdpForwarder &Plugins::UdpForwarder::instance()
+{
+  static UdpForwarder singleton;
+  return singleton;
+}
+
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString Plugins::UdpForwarder::sinkName() const
+{
+  return QStringLiteral("Plugins::UdpForwarder");
+}
+
+/**
+ * Encodes one record per frame & hands the resulting datagrams over to the
+ * network thread.
+ *
+ * @note This function is called by the worker pool of the sink graph.
+ */
+void Plugins::UdpForwarder::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  // Get configuration
+  Mode mode;
+  {
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled)
+      return;
+
+    mode = m_mode;
+  }
+
+  // Encode the records
+  QByteArray record;
+  QByteArray datagram;
+  QVector<QByteArray> datagrams;
+  for (const auto &frame : frames)
+  {
+    record.clear();
+    encode(record, frame);
+    if (record.isEmpty())
+      continue;
+
+    // Send each record in its own datagram
+    if (mode == Mode::PerFrame)
+    {
+      datagrams.append(record);
+      continue;
+    }
+
+    // Pack records until the datagram is full
+    if (!datagram.isEmpty()
+        && datagram.size() + record.size() > PLUGINS_UDP_MAX_DATAGRAM)
+    {
+      datagrams.append(datagram);
+      datagram.clear();
+    }
+
+    datagram.append(record);
+  }
+
+  // Flush the last datagram of the batch
+  if (!datagram.isEmpty())
+    datagrams.append(datagram);
+
+  // Hand the datagrams over to the network thread
+  if (!datagrams.isEmpty())
+  {
+    auto worker = m_worker;
+    QMetaObject::invokeMethod(worker, [=] { worker->send(datagrams); });
+  }
+}
+
+/**
+ * Returns @c true if frames are forwarded to the UDP destinations
+ */
+bool Plugins::UdpForwarder::enabled() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_enabled;
+}
+
+/**
+ * Returns the index of the encoding of the records (see @c Format)
+ */
+int Plugins::UdpForwarder::format() const
+{
+  QMutexLocker locker(&m_mutex);
+  return static_cast<int>(m_format);
+}
+
+/**
+ * Returns the index of the datagram mode (see @c Mode)
+ */
+int Plugins::UdpForwarder::mode() const
+{
+  QMutexLocker locker(&m_mutex);
+  return static_cast<int>(m_mode);
+}
+
+/**
+ * Returns the last error reported by the network thread
+ */
+QString Plugins::UdpForwarder::lastError() const
+{
+  return m_lastError;
+}
+
+/**
+ * Returns the comma-separated indexes of the forwarded datasets, an empty
+ * string means that all datasets are forwarded.
+ */
+QString Plugins::UdpForwarder::datasets() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_datasets;
+}
+
+/**
+ * Returns the comma-separated list of @c host:port destinations
+ */
+QString Plugins::UdpForwarder::destinations() const
+{
+  return m_destinations;
+}
+
+/**
+ * Returns the list of available datagram modes
+ */
+QStringList Plugins::UdpForwarder::availableModes() const
+{
+  return QStringList {tr("One datagram per frame"),
+                      tr("One datagram per batch")};
+}
+
+/**
+ * Returns the list of available record encodings
+ */
+QStringList Plugins::UdpForwarder::availableFormats() const
+{
+  return QStringList {tr("Binary"), tr("CSV")};
+}
+
+/**
+ * Enables or disables forwarding frames to the UDP destinations
+ */
+void Plugins::UdpForwarder::setEnabled(const bool enabled)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_enabled == enabled)
+      return;
+
+    m_enabled = enabled;
+  }
+
+  m_settings.setValue("Plugins_UdpForwarder", enabled);
+  configureWorker();
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Changes the encoding of the records (see @c Format)
+ */
+void Plugins::UdpForwarder::setFormat(const int format)
+{
+  if (format < 0 || format > static_cast<int>(Format::CSV))
+    return;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_format == static_cast<Format>(format))
+      return;
+
+    m_format = static_cast<Format>(format);
+  }
+
+  m_settings.setValue("Plugins_UdpFormat", format);
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the datagram mode (see @c Mode)
+ */
+void Plugins::UdpForwarder::setMode(const int mode)
+{
+  if (mode < 0 || mode > static_cast<int>(Mode::PerBatch))
+    return;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_mode == static_cast<Mode>(mode))
+      return;
+
+    m_mode = static_cast<Mode>(mode);
+  }
+
+  m_settings.setValue("Plugins_UdpMode", mode);
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the forwarded datasets, given as comma-separated dataset indexes.
+ * Ranges such as @c "4-7" are accepted, and an empty string forwards all the
+ * datasets of each frame.
+ */
+void Plugins::UdpForwarder::setDatasets(const QString &datasets)
+{
+  // Parse the selection
+  QVector<int> selection;
+  const auto items = datasets.split(',', Qt::SkipEmptyParts);
+  for (const auto &item : items)
+  {
+    const auto range = item.split('-');
+    const auto first = range.first().trimmed().toInt();
+    const auto last = range.count() == 2 ? range.last().trimmed().toInt()
+                                         : first;
+    for (int i = first; i <= last && i >= 0; ++i)
+    {
+      if (!selection.contains(i))
+        selection.append(i);
+    }
+  }
+
+  std::sort(selection.begin(), selection.end());
+
+  // Update the selection
+  {
+    QMutexLocker locker(&m_mutex);
+    const bool changed = m_datasets != datasets;
+    m_datasets = datasets;
+    m_selection = selection;
+    if (!changed)
+      return;
+  }
+
+  m_settings.setValue("Plugins_UdpDatasets", datasets);
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the comma-separated list of @c host:port destinations, multicast
+ * & broadcast addresses are supported.
+ */
+void Plugins::UdpForwarder::setDestinations(const QString &destinations)
+{
+  if (m_destinations != destinations)
+  {
+    m_destinations = destinations;
+    m_settings.setValue("Plugins_UdpDestinations", destinations);
+    configureWorker();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Applies the current destinations to the network thread
+ */
+void Plugins::UdpForwarder::configureWorker()
+{
+  // Clear the last error
+  if (!m_lastError.isEmpty())
+  {
+    m_lastError.clear();
+    Q_EMIT lastErrorChanged();
+  }
+
+  // Update the worker
+  auto worker = m_worker;
+  const auto destinations = m_enabled ? m_destinations : QString();
+  QMetaObject::invokeMethod(worker,
+                            [=] { worker->setDestinations(destinations); });
+}
+
+/**
+ * Registers the given @a error reported by the network thread
+ */
+void Plugins::UdpForwarder::onSendFailed(const QString &error)
+{
+  if (m_lastError != error)
+  {
+    m_lastError = error;
+    Q_EMIT lastErrorChanged();
+  }
+}
+
+/**
+ * Appends the record of the given @a frame to the @a buffer, nothing is
+ * appended if the frame contains none of the selected datasets.
+ */
+void Plugins::UdpForwarder::encode(QByteArray &buffer,
+                                   const JSON::Frame &frame) const
+{
+  // Get configuration
+  Format format;
+  QVector<int> selection;
+  {
+    QMutexLocker locker(&m_mutex);
+    format = m_format;
+    selection = m_selection;
+  }
+
+  // Collect the selected datasets, in the order of the frame
+  QVector<const JSON::Dataset *> datasets;
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      if (selection.isEmpty()
+          || std::binary_search(selection.cbegin(), selection.cend(),
+                                dataset.index()))
+        datasets.append(&dataset);
+    }
+  }
+
+  if (datasets.isEmpty())
+    return;
+
+  // Encode the record
+  const auto time = IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp());
+  if (format == Format::Binary)
+  {
+    WRITE_LE<quint64>(buffer, static_cast<quint64>(time));
+    WRITE_LE<quint32>(buffer, static_cast<quint32>(datasets.count()));
+    for (const auto *dataset : datasets)
+      WRITE_VALUE(buffer, *dataset);
+  }
+
+  else
+  {
+    buffer.append(QByteArray::number(time));
+    for (const auto *dataset : datasets)
+    {
+      buffer.append(',');
+      buffer.append(dataset->value().toUtf8());
+    }
+
+    buffer.append('\n');
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// Network worker
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+Plugins::UdpWorker::UdpWorker()
+  : m_socket(Q_NULLPTR)
+{
+}
+
+/**
+ * Destructor function
+ */
+Plugins::UdpWorker::~UdpWorker()
+{
+  closeSocket();
+}
+
+/**
+ * Closes the UDP socket & forgets the destinations
+ */
+void Plugins::UdpWorker::closeSocket()
+{
+  m_destinations.clear();
+  delete m_socket;
+  m_socket = Q_NULLPTR;
+}
+
+/**
+ * Parses the given comma-separated list of @c host:port @a destinations,
+ * the socket is closed if the list is empty.
+ */
+void Plugins::UdpWorker::setDestinations(const QString &destinations)
+{
+  // Parse the destinations
+  QStringList invalid;
+  m_destinations.clear();
+  const auto items = destinations.split(',', Qt::SkipEmptyParts);
+  for (const auto &item : items)
+  {
+    const auto address = item.trimmed();
+    const auto separator = address.lastIndexOf(':');
+    const auto port = separator > 0 ? address.mid(separator + 1).toUInt() : 0;
+
+    Destination destination;
+    destination.host = QHostAddress(address.left(separator));
+    destination.port = static_cast<quint16>(port);
+    if (destination.host.isNull() || port == 0 || port > 65535)
+      invalid.append(address);
+    else
+      m_destinations.append(destination);
+  }
+
+  // Report invalid destinations
+  if (!invalid.isEmpty())
+    Q_EMIT sendFailed(tr("Invalid UDP destination: %1")
+                          .arg(invalid.join(QStringLiteral(", "))));
+
+  // Open or close the socket
+  if (m_destinations.isEmpty())
+  {
+    delete m_socket;
+    m_socket = Q_NULLPTR;
+  }
+
+  else if (!m_socket)
+  {
+    m_socket = new QUdpSocket(this);
+    m_socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+  }
+}
+
+/**
+ * Sends the given @a datagrams to every destination
+ */
+void Plugins::UdpWorker::send(const QVector<QByteArray> &datagrams)
+{
+  if (!m_socket)
+    return;
+
+  for (const auto &destination : m_destinations)
+  {
+    for (const auto &datagram : datagrams)
+    {
+      if (m_socket->writeDatagram(datagram, destination.host,
+                                  destination.port)
+          < 0)
+      {
+        Q_EMIT sendFailed(m_socket->errorString());
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QByteArray>
+#include <QUdpSocket>
+#include <QStringList>
+#include <QHostAddress>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <Misc/Settings.h>
+
+/**
+ * Maximum size of a datagram built in batch mode, chosen to avoid IP
+ * fragmentation on Ethernet links. A single record larger than this limit
+ * is sent in its own datagram.
+ */
+#define PLUGINS_UDP_MAX_DATAGRAM 1472
+
+namespace Plugins
+{
+class UdpWorker;
+
+/**
+ * @brief The UdpForwarder class
+ *
+ * Forwards the values of the selected datasets of every frame to one or
+ * more UDP destinations (unicast, broadcast or multicast), so that legacy
+ * tools that listen on UDP can receive parsed data without a bridge
+ * process.
+ *
+ * Destinations are given as a comma-separated list of @c host:port pairs,
+ * and datasets are selected by their index (an empty selection forwards all
+ * the datasets of the frame). Each frame is encoded as one record, using the
+ * values that the frame parser already converted & cached in each dataset:
+ *
+ * - @c Binary: a @c u64 reception time (ms since epoch), a @c u32 value
+ *   count & for each value, the @c u32 index of the dataset followed by a
+ *   @c u8 type tag and a @c f64 (tag 0) or a @c u32 length & UTF-8 text
+ *   (tag 1). All integers are little-endian.
+ * - @c CSV: a line with the reception time (ms since epoch) & the values of
+ *   the selected datasets, separated by commas & terminated by @c "\n".
+ *
+ * In @c PerFrame mode each record is sent in its own datagram, in
+ * @c PerBatch mode the records of each batch handed over by the sink graph
+ * are packed into datagrams of up to @c PLUGINS_UDP_MAX_DATAGRAM bytes.
+ *
+ * Records are encoded once in the worker pool of the sink graph & the same
+ * datagrams are sent to every destination from a dedicated network thread
+ * (see @c UdpWorker).
+ */
+class UdpForwarder : public QObject, public JSON::FrameSink
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(int format
+               READ format
+               WRITE setFormat
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int mode
+               READ mode
+               WRITE setMode
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString destinations
+               READ destinations
+               WRITE setDestinations
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString datasets
+               READ datasets
+               WRITE setDatasets
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString lastError
+               READ lastError
+               NOTIFY lastErrorChanged)
+    Q_PROPERTY(QStringList availableFormats
+               READ availableFormats
+               CONSTANT)
+    Q_PROPERTY(QStringList availableModes
+               READ availableModes
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void lastErrorChanged();
+  void configurationChanged();
+
+private:
+  explicit UdpForwarder();
+  UdpForwarder(UdpForwarder &&) = delete;
+  UdpForwarder(const UdpForwarder &) = delete;
+  UdpForwarder &operator=(UdpForwarder &&) = delete;
+  UdpForwarder &operator=(const UdpForwarder &) = delete;
+
+  ~UdpForwarder();
+
+public:
+  enum class Format
+  {
+    Binary,
+    CSV
+  };
+  Q_ENUM(Format)
+
+  enum class Mode
+  {
+    PerFrame,
+    PerBatch
+  };
+  Q_ENUM(Mode)
+
+  static UdpForwarder &instance();
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  bool enabled() const;
+  int format() const;
+  int mode() const;
+  QString lastError() const;
+  QString datasets() const;
+  QString destinations() const;
+  QStringList availableModes() const;
+  QStringList availableFormats() const;
+
+public Q_SLOTS:
+  void setEnabled(const bool enabled);
+  void setFormat(const int format);
+  void setMode(const int mode);
+  void setDatasets(const QString &datasets);
+  void setDestinations(const QString &destinations);
+
+private Q_SLOTS:
+  void configureWorker();
+  void onSendFailed(const QString &error);
+
+private:
+  void encode(QByteArray &buffer, const JSON::Frame &frame) const;
+
+private:
+  bool m_enabled;
+  Mode m_mode;
+  Format m_format;
+  QString m_lastError;
+  QString m_datasets;
+  QString m_destinations;
+  QVector<int> m_selection;
+
+  QThread m_thread;
+  UdpWorker *m_worker;
+  mutable QMutex m_mutex;
+  Misc::Settings m_settings;
+};
+
+/**
+ * @brief The UdpWorker class
+ *
+ * Worker object of the @c UdpForwarder class, runs in its own thread & owns
+ * the UDP socket used to send the datagrams to every destination.
+ */
+class UdpWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void sendFailed(const QString &error);
+
+public:
+  explicit UdpWorker();
+  ~UdpWorker();
+
+public Q_SLOTS:
+  void closeSocket();
+  void setDestinations(const QString &destinations);
+  void send(const QVector<QByteArray> &datagrams);
+
+private:
+  struct Destination
+  {
+    QHostAddress host;
+    quint16 port;
+  };
+
+  QUdpSocket *m_socket;
+  QVector<Destination> m_destinations;
+};
+} // namespace Plugins
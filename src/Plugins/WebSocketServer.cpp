@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QHostAddress>
+
+#include <Plugins/Server.h>
+#include <Plugins/WebSocketServer.h>
+
+/**
+ * Constructor function, the WebSocket server is created by @c setEnabled()
+ * once the object has been moved to the network thread.
+ */
+Plugins::WebSocketServer::WebSocketServer()
+  : m_frameTime(-1)
+  , m_timer(Q_NULLPTR)
+  , m_server(Q_NULLPTR)
+{
+}
+
+/**
+ * Destructor function, closes all connections
+ */
+Plugins::WebSocketServer::~WebSocketServer()
+{
+  setEnabled(false);
+}
+
+/**
+ * Starts or stops listening for WebSocket connections on
+ * @c PLUGINS_WEBSOCKET_PORT.
+ */
+void Plugins::WebSocketServer::setEnabled(const bool enabled)
+{
+  // Stop server & remove all connections
+  if (!enabled)
+  {
+    auto clients = m_clients.keys();
+    m_clients.clear();
+    Q_FOREACH (auto socket, clients)
+    {
+      socket->disconnect(this);
+      socket->abort();
+      socket->deleteLater();
+    }
+
+    if (m_timer)
+      m_timer->stop();
+
+    if (m_server)
+      m_server->close();
+
+    m_schema.clear();
+    m_frame.clear();
+    m_frameTime = -1;
+    return;
+  }
+
+  // Create server & update timer in the network thread
+  if (!m_server)
+  {
+    m_server = new QWebSocketServer(QStringLiteral("Serial Studio"),
+                                    QWebSocketServer::NonSecureMode, this);
+    connect(m_server, &QWebSocketServer::newConnection, this,
+            &Plugins::WebSocketServer::acceptConnection);
+
+    m_timer = new QTimer(this);
+    m_timer->setInterval(1000 / PLUGINS_WEBSOCKET_MAX_RATE);
+    connect(m_timer, &QTimer::timeout, this,
+            &Plugins::WebSocketServer::update);
+
+    m_clock.start();
+  }
+
+  // Begin listening
+  if (!m_server->isListening())
+  {
+    if (m_server->listen(QHostAddress::Any, PLUGINS_WEBSOCKET_PORT))
+      m_timer->start();
+    else
+    {
+      Q_EMIT listenFailed(m_server->errorString());
+      m_server->close();
+    }
+  }
+}
+
+/**
+ * Registers the latest @a frame, received at the given @a timestamp (ms since
+ * epoch). Only the most recent frame is sent to the clients.
+ */
+void Plugins::WebSocketServer::setFrame(const JSON::Frame &frame,
+                                        const qint64 timestamp)
+{
+  // Regenerate schema message if the structure of the frame changed
+  if (m_schema.isEmpty() || frame.schemaHash() != m_frame.schemaHash())
+  {
+    QJsonObject object;
+    object.insert("type", "schema");
+    object.insert("schema", Server::schema(frame));
+    object.insert("hash", QString::number(frame.schemaHash(), 16));
+    m_schema = QString::fromUtf8(
+        QJsonDocument(object).toJson(QJsonDocument::Compact));
+  }
+
+  // Update frame
+  m_frame = frame;
+  m_frameTime = timestamp;
+}
+
+/**
+ * Sends the values that changed since the last update to each client whose
+ * update interval has expired.
+ *
+ * Clients that received the same frame in their last update obtain the same
+ * delta, so it is only serialized once for all of them.
+ */
+void Plugins::WebSocketServer::update()
+{
+  // Nothing to send
+  if (m_clients.isEmpty() || m_frameTime < 0 || !m_frame.isValid())
+    return;
+
+  // Get the current value of each dataset, ordered by group & dataset
+  QVector<const JSON::Dataset *> datasets;
+  for (int g = 0; g < m_frame.groupCount(); ++g)
+  {
+    const auto &group = m_frame.getGroup(g);
+    for (int d = 0; d < group.datasetCount(); ++d)
+      datasets.append(&group.getDataset(d));
+  }
+
+  QStringList values;
+  values.reserve(datasets.count());
+  Q_FOREACH (const auto *dataset, datasets)
+    values.append(dataset->value());
+
+  // Send updates
+  QHash<qint64, QString> deltas;
+  const auto now = m_clock.elapsed();
+  const auto hash = m_frame.schemaHash();
+  for (auto it = m_clients.begin(); it != m_clients.end(); ++it)
+  {
+    // Client is up to date or its update interval did not expire
+    auto &client = it.value();
+    if (client.frameTime == m_frameTime)
+      continue;
+    if (client.lastUpdate >= 0
+        && now - client.lastUpdate < 1000 / client.maxRate)
+      continue;
+
+    // Send schema if the structure of the frame changed
+    auto socket = it.key();
+    if (client.schemaHash != hash || client.values.isEmpty())
+    {
+      socket->sendTextMessage(m_schema);
+      client.schemaHash = hash;
+      client.values.clear();
+      client.frameTime = -1;
+    }
+
+    // Build the delta against the last values sent to the client
+    if (!deltas.contains(client.frameTime))
+    {
+      QJsonObject changes;
+      for (int i = 0; i < values.count(); ++i)
+      {
+        if (i < client.values.count() && client.values.at(i) == values.at(i))
+          continue;
+
+        const auto *dataset = datasets.at(i);
+        if (dataset->isNumeric())
+          changes.insert(QString::number(i), dataset->numericValue());
+        else
+          changes.insert(QString::number(i), values.at(i));
+      }
+
+      QString message;
+      if (!changes.isEmpty())
+      {
+        QJsonObject object;
+        object.insert("type", "delta");
+        object.insert("values", changes);
+        object.insert("time", static_cast<double>(m_frameTime));
+        message = QString::fromUtf8(
+            QJsonDocument(object).toJson(QJsonDocument::Compact));
+      }
+
+      deltas.insert(client.frameTime, message);
+    }
+
+    // Send the delta
+    const auto &message = deltas[client.frameTime];
+    if (!message.isEmpty())
+      socket->sendTextMessage(message);
+
+    // Update client state
+    client.values = values;
+    client.lastUpdate = now;
+    client.frameTime = m_frameTime;
+  }
+}
+
+/**
+ * Removes the state of a client that closed its connection
+ */
+void Plugins::WebSocketServer::removeConnection()
+{
+  auto socket = static_cast<QWebSocket *>(QObject::sender());
+  if (socket)
+  {
+    m_clients.remove(socket);
+    socket->deleteLater();
+  }
+}
+
+/**
+ * Registers incoming WebSocket connections, the schema & the current values
+ * are sent in the next update.
+ */
+void Plugins::WebSocketServer::acceptConnection()
+{
+  while (m_server->hasPendingConnections())
+  {
+    auto socket = m_server->nextPendingConnection();
+    if (!socket)
+      continue;
+
+    socket->setParent(this);
+    connect(socket, &QWebSocket::disconnected, this,
+            &Plugins::WebSocketServer::removeConnection);
+    connect(socket, &QWebSocket::textMessageReceived, this,
+            &Plugins::WebSocketServer::onTextMessageReceived);
+
+    m_clients.insert(socket, Client());
+  }
+}
+
+/**
+ * Processes the configuration messages sent by a client, currently only the
+ * @c maxRate option is supported.
+ */
+void Plugins::WebSocketServer::onTextMessageReceived(const QString &message)
+{
+  auto socket = static_cast<QWebSocket *>(QObject::sender());
+  auto client = m_clients.find(socket);
+  if (!socket || client == m_clients.end())
+    return;
+
+  const auto document = QJsonDocument::fromJson(message.toUtf8());
+  const auto object = document.object();
+  if (object.contains("maxRate"))
+  {
+    const auto rate = object.value("maxRate").toDouble();
+    if (rate > 0)
+      client->maxRate = qMin<double>(rate, PLUGINS_WEBSOCKET_MAX_RATE);
+  }
+}
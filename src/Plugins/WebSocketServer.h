@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QTimer>
+#include <QObject>
+#include <QWebSocket>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QWebSocketServer>
+
+#include <JSON/Frame.h>
+
+/**
+ * TCP port used by the WebSocket endpoint, right next to the plugins port
+ */
+#define PLUGINS_WEBSOCKET_PORT 7778
+
+/**
+ * Maximum rate (in Hz) at which updates are sent to each WebSocket client
+ */
+#define PLUGINS_WEBSOCKET_MAX_RATE 20
+
+/**
+ * Update rate (in Hz) used for WebSocket clients that do not request a rate
+ */
+#define PLUGINS_WEBSOCKET_DEFAULT_RATE 10
+
+namespace Plugins
+{
+/**
+ * @brief The WebSocketServer class
+ *
+ * Optional WebSocket endpoint that allows remote dashboards (e.g. a web page
+ * opened on a tablet) to display live data without installing Serial Studio.
+ *
+ * All messages are JSON text messages. Right after connecting (and whenever
+ * the frame structure changes), the client receives a schema message:
+ *
+ *   {"type":"schema","hash":"...","schema":{...}}
+ *
+ * where @c schema is the object returned by @c Server::schema(). After that,
+ * the client only receives the values that changed since the last update that
+ * it received, indexed by their position in the schema (groups first, then
+ * datasets):
+ *
+ *   {"type":"delta","time":1650000000000,"values":{"0":12.5,"3":"OK"}}
+ *
+ * Updates are sent at @c PLUGINS_WEBSOCKET_DEFAULT_RATE Hz, clients can
+ * select a different rate (up to @c PLUGINS_WEBSOCKET_MAX_RATE Hz) by sending
+ * @c {"maxRate":5}.
+ *
+ * The object is owned by the @c Server class and lives in its network thread.
+ */
+class WebSocketServer : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void listenFailed(const QString &error);
+
+public:
+  WebSocketServer();
+  ~WebSocketServer();
+
+public Q_SLOTS:
+  void setEnabled(const bool enabled);
+  void setFrame(const JSON::Frame &frame, const qint64 timestamp);
+
+private Q_SLOTS:
+  void update();
+  void removeConnection();
+  void acceptConnection();
+  void onTextMessageReceived(const QString &message);
+
+private:
+  /**
+   * Update state of a connected client
+   */
+  struct Client
+  {
+    double maxRate = PLUGINS_WEBSOCKET_DEFAULT_RATE;
+    qint64 lastUpdate = -1;
+    qint64 frameTime = -1;
+    quint64 schemaHash = 0;
+    QStringList values;
+  };
+
+private:
+  JSON::Frame m_frame;
+  qint64 m_frameTime;
+  QString m_schema;
+  QTimer *m_timer;
+  QElapsedTimer m_clock;
+  QWebSocketServer *m_server;
+  QHash<QWebSocket *, Client> m_clients;
+};
+} // namespace Plugins
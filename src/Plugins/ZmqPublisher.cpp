@@ -0,0 +1,805 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QtEndian>
+
+#include <IO/Manager.h>
+#include <IO/FrameQueue.h>
+#include <JSON/Generator.h>
+#include <Plugins/ZmqPublisher.h>
+
+/**
+ * Size of the ZMTP greeting & maximum size of a frame sent by a subscriber
+ */
+static const int GREETING_SIZE = 64;
+static const qint64 MAX_INPUT_FRAME = 64 * 1024;
+
+/**
+ * Flags of the ZMTP frame header
+ */
+static const quint8 FLAG_MORE = 0x01;
+static const quint8 FLAG_LONG = 0x02;
+static const quint8 FLAG_COMMAND = 0x04;
+
+/**
+ * Maximum length of the group of a RADIO message
+ */
+static const int MAX_GROUP_LENGTH = 255;
+
+/**
+ * Appends the given @a value to the @a buffer in little-endian order
+ */
+template<typename T>
+static void WRITE_LE(QByteArray &buffer, const T value)
+{
+  const T le = qToLittleEndian(value);
+  buffer.append(reinterpret_cast<const char *>(&le), sizeof(T));
+}
+
+/**
+ * Appends the type tag & the value of the given @a dataset to the @a buffer
+ */
+static void WRITE_VALUE(QByteArray &buffer, const JSON::Dataset &dataset)
+{
+  if (dataset.isNumeric())
+  {
+    quint64 bits;
+    const double value = dataset.numericValue();
+    memcpy(&bits, &value, sizeof(bits));
+    WRITE_LE<quint8>(buffer, 0);
+    WRITE_LE<quint64>(buffer, bits);
+  }
+
+  else
+  {
+    const auto text = dataset.value().toUtf8();
+    WRITE_LE<quint8>(buffer, 1);
+    WRITE_LE<quint32>(buffer, static_cast<quint32>(text.size()));
+    buffer.append(text);
+  }
+}
+
+/**
+ * Appends a ZMTP frame with the given @a data & @a flags to the @a buffer,
+ * the long size format is selected automatically.
+ */
+static void WRITE_FRAME(QByteArray &buffer, const QByteArray &data,
+                        quint8 flags)
+{
+  const quint64 size = data.size();
+  if (size > 255)
+  {
+    flags |= FLAG_LONG;
+    buffer.append(static_cast<char>(flags));
+    const quint64 be = qToBigEndian(size);
+    buffer.append(reinterpret_cast<const char *>(&be), sizeof(be));
+  }
+
+  else
+  {
+    buffer.append(static_cast<char>(flags));
+    buffer.append(static_cast<char>(size));
+  }
+
+  buffer.append(data);
+}
+
+/**
+ * Returns the ZMTP 3.1 greeting of the publisher (NULL mechanism, client
+ * role)
+ */
+static QByteArray GREETING()
+{
+  QByteArray greeting(GREETING_SIZE, '\0');
+  greeting[0] = static_cast<char>(0xFF);
+  greeting[9] = static_cast<char>(0x7F);
+  greeting[10] = 3;
+  greeting[11] = 1;
+  memcpy(greeting.data() + 12, "NULL", 4);
+  return greeting;
+}
+
+/**
+ * Returns the READY command that identifies the endpoint as a PUB socket
+ */
+static QByteArray READY_COMMAND()
+{
+  QByteArray body;
+  body.append(static_cast<char>(5));
+  body.append("READY");
+  body.append(static_cast<char>(11));
+  body.append("Socket-Type");
+  body.append(QByteArray("\x00\x00\x00\x03", 4));
+  body.append("PUB");
+
+  QByteArray command;
+  WRITE_FRAME(command, body, FLAG_COMMAND);
+  return command;
+}
+
+/**
+ * Returns @c true if the given @a topic matches one of the @a prefixes
+ */
+static bool MATCHES(const QVector<QByteArray> &prefixes,
+                    const QByteArray &topic)
+{
+  for (const auto &prefix : prefixes)
+  {
+    if (topic.startsWith(prefix))
+      return true;
+  }
+
+  return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Publisher
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, reads the settings, starts the network thread &
+ * registers the module in the sink graph of the JSON generator.
+ */
+Plugins::ZmqPublisher::ZmqPublisher()
+  : m_subscribers(0)
+  , m_worker(new ZmqWorker())
+{
+  // Read settings
+  m_enabled = m_settings.value("Plugins_ZeroMQ", false).toBool();
+  m_rawData = m_settings.value("Plugins_ZeroMQRaw", false).toBool();
+  m_radioEnabled = m_settings.value("Plugins_ZeroMQRadio", false).toBool();
+  m_topicPrefix
+      = m_settings.value("Plugins_ZeroMQPrefix", "serial-studio/").toString();
+  m_radioAddress = m_settings
+                       .value("Plugins_ZeroMQRadioAddress",
+                              QStringLiteral("239.0.0.1:%1")
+                                  .arg(PLUGINS_ZMQ_RADIO_PORT))
+                       .toString();
+
+  // Move the worker to the network thread
+  m_thread.setObjectName(QStringLiteral("Plugins::ZmqWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  connect(m_worker, &ZmqWorker::listenFailed, this,
+          &Plugins::ZmqPublisher::onListenFailed);
+  connect(m_worker, &ZmqWorker::subscribersChanged, this,
+          &Plugins::ZmqPublisher::onSubscribersChanged);
+  m_thread.start();
+
+  // Frames are encoded in the worker pool of the sink graph
+  JSON::Generator::instance().sinks().addSink(
+      this, JSON::SinkGraph::Port::Frames,
+      JSON::SinkGraph::Affinity::WorkerPool);
+
+  // Publish raw data as soon as it is received
+  connect(&IO::Manager::instance(), &IO::Manager::dataReceived, this,
+          &Plugins::ZmqPublisher::publishRawData);
+
+  // Open the endpoints
+  configureWorker();
+}
+
+/**
+ * Destructor function, closes all connections & stops the network thread
+ */
+Plugins::ZmqPublisher::~ZmqPublisher()
+{
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(
+      worker, [=] { worker->closeConnections(); },
+      Qt::BlockingQueuedConnection);
+
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns a pointer to the only instance of the class
+ */
+Plugins::ZmqPublisher &Plugins::ZmqPublisher::instance()
+{
+  static ZmqPublisher singleton;
+  return singleton;
+}
+
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString Plugins::ZmqPublisher::sinkName() const
+{
+  return QStringLiteral("Plugins::ZmqPublisher");
+}
+
+/**
+ * Encodes one message per group of the given @a frames & publishes the
+ * complete batch at once.
+ *
+ * @note This function is called by the worker pool of the sink graph.
+ */
+void Plugins::ZmqPublisher::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  // Get configuration
+  QByteArray prefix;
+  {
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled && !m_radioEnabled)
+      return;
+
+    prefix = m_topicPrefix.toUtf8();
+  }
+
+  // Encode the messages
+  QVector<ZmqMessage> messages;
+  for (const auto &frame : frames)
+  {
+    const auto time = IO::FrameQueue::toMSecsSinceEpoch(frame.timestamp());
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const auto &group = frame.getGroup(i);
+
+      ZmqMessage message;
+      message.topic = prefix + group.title().toUtf8();
+      WRITE_LE<quint64>(message.body, static_cast<quint64>(time));
+      WRITE_LE<quint32>(message.body,
+                        static_cast<quint32>(group.datasetCount()));
+      for (int j = 0; j < group.datasetCount(); ++j)
+        WRITE_VALUE(message.body, group.getDataset(j));
+
+      messages.append(message);
+    }
+  }
+
+  // Hand the batch over to the network thread
+  if (!messages.isEmpty())
+    publish(messages);
+}
+
+/**
+ * Returns @c true if the PUB endpoint is enabled
+ */
+bool Plugins::ZmqPublisher::enabled() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_enabled;
+}
+
+/**
+ * Returns @c true if raw data is published in addition to the frames
+ */
+bool Plugins::ZmqPublisher::rawData() const
+{
+  return m_rawData;
+}
+
+/**
+ * Returns @c true if messages are also sent as RADIO datagrams
+ */
+bool Plugins::ZmqPublisher::radioEnabled() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_radioEnabled;
+}
+
+/**
+ * Returns the number of subscribers connected to the PUB endpoint
+ */
+int Plugins::ZmqPublisher::subscribers() const
+{
+  return m_subscribers;
+}
+
+/**
+ * Returns the last error reported by the network thread
+ */
+QString Plugins::ZmqPublisher::lastError() const
+{
+  return m_lastError;
+}
+
+/**
+ * Returns the prefix of the topic of every published message
+ */
+QString Plugins::ZmqPublisher::topicPrefix() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_topicPrefix;
+}
+
+/**
+ * Returns the UDP address (@c host:port) to which RADIO datagrams are sent
+ */
+QString Plugins::ZmqPublisher::radioAddress() const
+{
+  return m_radioAddress;
+}
+
+/**
+ * Enables or disables the PUB endpoint
+ */
+void Plugins::ZmqPublisher::setEnabled(const bool enabled)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_enabled == enabled)
+      return;
+
+    m_enabled = enabled;
+  }
+
+  m_settings.setValue("Plugins_ZeroMQ", enabled);
+  configureWorker();
+  Q_EMIT enabledChanged();
+}
+
+/**
+ * Enables or disables publishing the raw data received from the device
+ */
+void Plugins::ZmqPublisher::setRawData(const bool enabled)
+{
+  if (m_rawData != enabled)
+  {
+    m_rawData = enabled;
+    m_settings.setValue("Plugins_ZeroMQRaw", enabled);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Enables or disables sending the published messages as RADIO datagrams
+ */
+void Plugins::ZmqPublisher::setRadioEnabled(const bool enabled)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_radioEnabled == enabled)
+      return;
+
+    m_radioEnabled = enabled;
+  }
+
+  m_settings.setValue("Plugins_ZeroMQRadio", enabled);
+  configureWorker();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the prefix of the topic of every published message
+ */
+void Plugins::ZmqPublisher::setTopicPrefix(const QString &prefix)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    if (m_topicPrefix == prefix)
+      return;
+
+    m_topicPrefix = prefix;
+  }
+
+  m_settings.setValue("Plugins_ZeroMQPrefix", prefix);
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Changes the UDP address (@c host:port) to which RADIO datagrams are sent,
+ * multicast addresses are supported.
+ */
+void Plugins::ZmqPublisher::setRadioAddress(const QString &address)
+{
+  if (m_radioAddress != address)
+  {
+    m_radioAddress = address;
+    m_settings.setValue("Plugins_ZeroMQRadioAddress", address);
+    configureWorker();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Applies the current configuration to the endpoints of the network thread
+ */
+void Plugins::ZmqPublisher::configureWorker()
+{
+  // Clear the last error
+  if (!m_lastError.isEmpty())
+  {
+    m_lastError.clear();
+    Q_EMIT lastErrorChanged();
+  }
+
+  // Update the worker
+  auto worker = m_worker;
+  const auto enabled = m_enabled;
+  const auto radio = m_radioEnabled;
+  const auto address = m_radioAddress;
+  QMetaObject::invokeMethod(worker, [=] {
+    worker->setEnabled(enabled);
+    worker->setRadio(radio, address);
+  });
+}
+
+/**
+ * Registers the given @a error reported by the network thread
+ */
+void Plugins::ZmqPublisher::onListenFailed(const QString &error)
+{
+  m_lastError = error;
+  Q_EMIT lastErrorChanged();
+}
+
+/**
+ * Updates the number of connected subscribers
+ */
+void Plugins::ZmqPublisher::onSubscribersChanged(const int count)
+{
+  m_subscribers = count;
+  Q_EMIT subscribersChanged();
+}
+
+/**
+ * Publishes the raw @a data received from the device
+ */
+void Plugins::ZmqPublisher::publishRawData(const QByteArray &data,
+                                           const qint64 timestamp)
+{
+  if (!m_rawData || (!enabled() && !radioEnabled()))
+    return;
+
+  ZmqMessage message;
+  message.topic = topicPrefix().toUtf8() + "raw";
+  message.body.reserve(data.size() + 8);
+  WRITE_LE<quint64>(message.body, static_cast<quint64>(
+                                      IO::FrameQueue::toMSecsSinceEpoch(
+                                          timestamp)));
+  message.body.append(data);
+  publish({message});
+}
+
+/**
+ * Hands the given @a messages over to the network thread
+ */
+void Plugins::ZmqPublisher::publish(const QVector<ZmqMessage> &messages)
+{
+  auto worker = m_worker;
+  QMetaObject::invokeMethod(worker, [=] { worker->publish(messages); });
+}
+
+//----------------------------------------------------------------------------------------
+// Network worker
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+Plugins::ZmqWorker::ZmqWorker()
+  : m_server(Q_NULLPTR)
+  , m_radio(Q_NULLPTR)
+  , m_radioPort(PLUGINS_ZMQ_RADIO_PORT)
+{
+}
+
+/**
+ * Destructor function
+ */
+Plugins::ZmqWorker::~ZmqWorker()
+{
+  closeConnections();
+}
+
+/**
+ * Closes the connections with all the subscribers & the endpoints
+ */
+void Plugins::ZmqWorker::closeConnections()
+{
+  setEnabled(false);
+  setRadio(false, QString());
+}
+
+/**
+ * Opens or closes the PUB endpoint
+ */
+void Plugins::ZmqWorker::setEnabled(const bool enabled)
+{
+  // Start listening for subscribers
+  if (enabled && !m_server)
+  {
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this,
+            &Plugins::ZmqWorker::acceptConnection);
+
+    if (!m_server->listen(QHostAddress::Any, PLUGINS_ZMQ_PORT))
+    {
+      Q_EMIT listenFailed(m_server->errorString());
+      delete m_server;
+      m_server = Q_NULLPTR;
+    }
+  }
+
+  // Close all connections
+  else if (!enabled && m_server)
+  {
+    const auto sockets = m_subscribers.keys();
+    for (auto *socket : sockets)
+      close(socket);
+
+    m_server->close();
+    delete m_server;
+    m_server = Q_NULLPTR;
+    Q_EMIT subscribersChanged(0);
+  }
+}
+
+/**
+ * Opens or closes the RADIO endpoint, which sends datagrams to the given
+ * @a address (@c host:port).
+ */
+void Plugins::ZmqWorker::setRadio(const bool enabled, const QString &address)
+{
+  // Close the socket
+  if (!enabled)
+  {
+    delete m_radio;
+    m_radio = Q_NULLPTR;
+    return;
+  }
+
+  // Parse the address
+  const auto separator = address.lastIndexOf(':');
+  const auto host = separator > 0 ? address.left(separator) : address;
+  const auto port = separator > 0 ? address.mid(separator + 1).toUInt() : 0;
+  m_radioHost = QHostAddress(host.trimmed());
+  m_radioPort = port > 0 && port <= 65535 ? static_cast<quint16>(port)
+                                          : PLUGINS_ZMQ_RADIO_PORT;
+  if (m_radioHost.isNull())
+  {
+    Q_EMIT listenFailed(tr("Invalid RADIO address: %1").arg(address));
+    delete m_radio;
+    m_radio = Q_NULLPTR;
+    return;
+  }
+
+  // Create the socket
+  if (!m_radio)
+    m_radio = new QUdpSocket(this);
+}
+
+/**
+ * Writes the given @a messages to every subscriber with a matching
+ * subscription & sends them as RADIO datagrams if enabled.
+ */
+void Plugins::ZmqWorker::publish(const QVector<Plugins::ZmqMessage> &messages)
+{
+  // Send the messages to each subscriber with a single write
+  for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it)
+  {
+    auto *socket = it.key();
+    auto &subscriber = it.value();
+    if (!subscriber.ready || subscriber.topics.isEmpty())
+      continue;
+
+    QByteArray buffer;
+    const auto pending = socket->bytesToWrite();
+    for (const auto &message : messages)
+    {
+      if (!MATCHES(subscriber.topics, message.topic))
+        continue;
+
+      if (pending + buffer.size() > PLUGINS_ZMQ_HWM)
+        break;
+
+      WRITE_FRAME(buffer, message.topic, FLAG_MORE);
+      WRITE_FRAME(buffer, message.body, 0);
+    }
+
+    if (!buffer.isEmpty())
+      socket->write(buffer);
+  }
+
+  // Send RADIO datagrams, the group is limited to 255 bytes
+  if (m_radio)
+  {
+    for (const auto &message : messages)
+    {
+      const auto group = message.topic.left(MAX_GROUP_LENGTH);
+
+      QByteArray datagram;
+      datagram.reserve(group.size() + message.body.size() + 1);
+      datagram.append(static_cast<char>(group.size()));
+      datagram.append(group);
+      datagram.append(message.body);
+      m_radio->writeDatagram(datagram, m_radioHost, m_radioPort);
+    }
+  }
+}
+
+/**
+ * Processes the data sent by a subscriber (greeting, handshake &
+ * subscriptions)
+ */
+void Plugins::ZmqWorker::onDataReceived()
+{
+  auto *socket = qobject_cast<QTcpSocket *>(sender());
+  if (!socket || !m_subscribers.contains(socket))
+    return;
+
+  auto &subscriber = m_subscribers[socket];
+  subscriber.input.append(socket->readAll());
+  readFrames(socket, subscriber);
+}
+
+/**
+ * Removes a subscriber when its socket is disconnected
+ */
+void Plugins::ZmqWorker::removeConnection()
+{
+  auto *socket = qobject_cast<QTcpSocket *>(sender());
+  if (socket && m_subscribers.contains(socket))
+    close(socket);
+}
+
+/**
+ * Accepts incoming connections & sends the ZMTP greeting
+ */
+void Plugins::ZmqWorker::acceptConnection()
+{
+  while (m_server && m_server->hasPendingConnections())
+  {
+    auto *socket = m_server->nextPendingConnection();
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(socket, &QTcpSocket::readyRead, this,
+            &Plugins::ZmqWorker::onDataReceived);
+    connect(socket, &QTcpSocket::disconnected, this,
+            &Plugins::ZmqWorker::removeConnection);
+
+    m_subscribers.insert(socket, Subscriber());
+    socket->write(GREETING());
+  }
+
+  Q_EMIT subscribersChanged(m_subscribers.count());
+}
+
+/**
+ * Closes the connection with the given subscriber
+ */
+void Plugins::ZmqWorker::close(QTcpSocket *socket)
+{
+  m_subscribers.remove(socket);
+  socket->disconnect(this);
+  socket->abort();
+  socket->deleteLater();
+
+  Q_EMIT subscribersChanged(m_subscribers.count());
+}
+
+/**
+ * Reads the greeting & the complete frames stored in the input buffer of
+ * the given @a subscriber.
+ */
+void Plugins::ZmqWorker::readFrames(QTcpSocket *socket, Subscriber &subscriber)
+{
+  auto &input = subscriber.input;
+
+  // Validate the greeting & send the READY command
+  if (!subscriber.greeting)
+  {
+    if (input.size() < GREETING_SIZE)
+      return;
+
+    const bool valid = static_cast<quint8>(input.at(0)) == 0xFF
+                       && static_cast<quint8>(input.at(9)) == 0x7F
+                       && input.at(10) >= 3
+                       && memcmp(input.constData() + 12, "NULL", 4) == 0;
+    if (!valid)
+    {
+      close(socket);
+      return;
+    }
+
+    input.remove(0, GREETING_SIZE);
+    subscriber.greeting = true;
+    socket->write(READY_COMMAND());
+  }
+
+  // Read complete frames
+  while (input.size() >= 2)
+  {
+    // Read the frame header
+    const auto flags = static_cast<quint8>(input.at(0));
+    const int header = flags & FLAG_LONG ? 9 : 2;
+    if (input.size() < header)
+      return;
+
+    quint64 size = static_cast<quint8>(input.at(1));
+    if (flags & FLAG_LONG)
+      size = qFromBigEndian<quint64>(input.constData() + 1);
+
+    // Subscribers only send small frames
+    if (size > static_cast<quint64>(MAX_INPUT_FRAME))
+    {
+      close(socket);
+      return;
+    }
+
+    // Wait for the rest of the frame
+    if (input.size() < header + static_cast<int>(size))
+      return;
+
+    const auto body = input.mid(header, static_cast<int>(size));
+    input.remove(0, header + static_cast<int>(size));
+
+    // ZMTP 3.0 subscriptions are messages starting with 0x01 or 0x00
+    if (flags & FLAG_COMMAND)
+    {
+      processCommand(socket, subscriber, body);
+      if (!m_subscribers.contains(socket))
+        return;
+    }
+
+    else if (!body.isEmpty() && (body.at(0) == 0 || body.at(0) == 1))
+      subscribe(subscriber, body.mid(1), body.at(0) == 1);
+  }
+}
+
+/**
+ * Processes a ZMTP command sent by the given @a subscriber
+ */
+void Plugins::ZmqWorker::processCommand(QTcpSocket *socket,
+                                        Subscriber &subscriber,
+                                        const QByteArray &body)
+{
+  // Read the command name
+  if (body.isEmpty())
+    return;
+
+  const int length = static_cast<quint8>(body.at(0));
+  const auto name = body.mid(1, length);
+  const auto data = body.mid(1 + length);
+
+  // Handshake finished
+  if (name == "READY")
+    subscriber.ready = true;
+
+  // ZMTP 3.1 subscriptions
+  else if (name == "SUBSCRIBE")
+    subscribe(subscriber, data, true);
+  else if (name == "CANCEL")
+    subscribe(subscriber, data, false);
+
+  // Peer rejected the connection
+  else if (name == "ERROR")
+    close(socket);
+}
+
+/**
+ * Adds or removes the given @a topic prefix from the subscriptions of the
+ * given @a subscriber, an empty prefix subscribes to all the messages.
+ */
+void Plugins::ZmqWorker::subscribe(Subscriber &subscriber,
+                                   const QByteArray &topic,
+                                   const bool subscribe)
+{
+  if (subscribe)
+    subscriber.topics.append(topic);
+  else
+    subscriber.topics.removeOne(topic);
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QByteArray>
+#include <QTcpSocket>
+#include <QTcpServer>
+#include <QUdpSocket>
+#include <QHostAddress>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <Misc/Settings.h>
+
+/**
+ * Default TCP port of the ZeroMQ PUB endpoint
+ */
+#define PLUGINS_ZMQ_PORT 5556
+
+/**
+ * Default UDP port of the ZeroMQ RADIO endpoint
+ */
+#define PLUGINS_ZMQ_RADIO_PORT 5557
+
+/**
+ * Maximum number of bytes waiting in the socket of a subscriber, new
+ * messages are dropped for that subscriber while the limit is exceeded
+ * (equivalent to the high-water mark of a ZeroMQ PUB socket).
+ */
+#define PLUGINS_ZMQ_HWM (4 * 1024 * 1024)
+
+namespace Plugins
+{
+class ZmqWorker;
+
+/**
+ * Message published by the ZeroMQ endpoints, the topic is the first frame
+ * of the message (or the group of RADIO messages) & the body is the second.
+ */
+struct ZmqMessage
+{
+  QByteArray topic;
+  QByteArray body;
+};
+
+/**
+ * @brief The ZmqPublisher class
+ *
+ * Publishes frames & raw data to ZeroMQ subscribers on the LAN, without a
+ * broker & without linking against libzmq. The endpoint implements the
+ * ZMTP 3.1 wire protocol (NULL security mechanism) of a @c PUB socket on
+ * TCP port @c PLUGINS_ZMQ_PORT, so any @c SUB or @c XSUB socket can connect
+ * to it with @c tcp://host:5556. Optionally, the same messages are sent as
+ * @c RADIO datagrams to a UDP address, for @c DISH sockets joined to the
+ * groups of the messages.
+ *
+ * Two kinds of messages are published, both as two-part messages made of a
+ * topic frame & a body frame. All integers are little-endian:
+ *
+ * - Frames: one message per group of each frame, the topic is the topic
+ *   prefix followed by the title of the group. The body contains a @c u64
+ *   reception time (ms since epoch), a @c u32 value count & the values of
+ *   the datasets of the group, each one encoded as in the binary plugin
+ *   protocol: a @c u8 type tag followed by a @c f64 (tag 0) or by a @c u32
+ *   length & UTF-8 text (tag 1).
+ * - Raw data: the topic is the topic prefix followed by @c "raw", the body
+ *   contains a @c u64 reception time (ms since epoch) & the received bytes.
+ *
+ * Subscriptions are filtered by the publisher, as ZeroMQ does: only the
+ * messages whose topic starts with one of the subscribed prefixes are sent
+ * to each subscriber. Messages are encoded once per batch of frames handed
+ * over by the sink graph, and all the messages of a batch are written to
+ * each subscriber with a single socket write.
+ *
+ * The sockets live in a dedicated network thread (see @c ZmqWorker), frames
+ * are encoded in the worker pool of the sink graph.
+ */
+class ZmqPublisher : public QObject, public JSON::FrameSink
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(bool enabled
+               READ enabled
+               WRITE setEnabled
+               NOTIFY enabledChanged)
+    Q_PROPERTY(bool rawData
+               READ rawData
+               WRITE setRawData
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString topicPrefix
+               READ topicPrefix
+               WRITE setTopicPrefix
+               NOTIFY configurationChanged)
+    Q_PROPERTY(bool radioEnabled
+               READ radioEnabled
+               WRITE setRadioEnabled
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QString radioAddress
+               READ radioAddress
+               WRITE setRadioAddress
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int subscribers
+               READ subscribers
+               NOTIFY subscribersChanged)
+    Q_PROPERTY(QString lastError
+               READ lastError
+               NOTIFY lastErrorChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void enabledChanged();
+  void lastErrorChanged();
+  void subscribersChanged();
+  void configurationChanged();
+
+private:
+  explicit ZmqPublisher();
+  ZmqPublisher(ZmqPublisher &&) = delete;
+  ZmqPublisher(const ZmqPublisher &) = delete;
+  ZmqPublisher &operator=(ZmqPublisher &&) = delete;
+  ZmqPublisher &operator=(const ZmqPublisher &) = delete;
+
+  ~ZmqPublisher();
+
+public:
+  static ZmqPublisher &instance();
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  bool enabled() const;
+  bool rawData() const;
+  bool radioEnabled() const;
+  int subscribers() const;
+  QString lastError() const;
+  QString topicPrefix() const;
+  QString radioAddress() const;
+
+public Q_SLOTS:
+  void setEnabled(const bool enabled);
+  void setRawData(const bool enabled);
+  void setRadioEnabled(const bool enabled);
+  void setTopicPrefix(const QString &prefix);
+  void setRadioAddress(const QString &address);
+
+private Q_SLOTS:
+  void configureWorker();
+  void onListenFailed(const QString &error);
+  void onSubscribersChanged(const int count);
+  void publishRawData(const QByteArray &data, const qint64 timestamp);
+
+private:
+  void publish(const QVector<ZmqMessage> &messages);
+
+private:
+  bool m_enabled;
+  bool m_rawData;
+  bool m_radioEnabled;
+  int m_subscribers;
+  QString m_lastError;
+  QString m_topicPrefix;
+  QString m_radioAddress;
+
+  QThread m_thread;
+  ZmqWorker *m_worker;
+  mutable QMutex m_mutex;
+  Misc::Settings m_settings;
+};
+
+/**
+ * @brief The ZmqWorker class
+ *
+ * Worker object of the @c ZmqPublisher class, runs in its own thread & owns
+ * the TCP server, the sockets of the subscribers and the UDP socket used for
+ * RADIO messages. It performs the ZMTP handshake with each subscriber,
+ * tracks its subscriptions & writes the published messages.
+ */
+class ZmqWorker : public QObject
+{
+  Q_OBJECT
+
+Q_SIGNALS:
+  void listenFailed(const QString &error);
+  void subscribersChanged(const int count);
+
+public:
+  explicit ZmqWorker();
+  ~ZmqWorker();
+
+public Q_SLOTS:
+  void closeConnections();
+  void setEnabled(const bool enabled);
+  void setRadio(const bool enabled, const QString &address);
+  void publish(const QVector<Plugins::ZmqMessage> &messages);
+
+private Q_SLOTS:
+  void onDataReceived();
+  void removeConnection();
+  void acceptConnection();
+
+private:
+  struct Subscriber
+  {
+    bool greeting = false;
+    bool ready = false;
+    QByteArray input;
+    QVector<QByteArray> topics;
+  };
+
+  void close(QTcpSocket *socket);
+  void readFrames(QTcpSocket *socket, Subscriber &subscriber);
+  void processCommand(QTcpSocket *socket, Subscriber &subscriber,
+                      const QByteArray &body);
+  void subscribe(Subscriber &subscriber, const QByteArray &topic,
+                 const bool subscribe);
+
+private:
+  QTcpServer *m_server;
+  QUdpSocket *m_radio;
+  quint16 m_radioPort;
+  QHostAddress m_radioHost;
+  QHash<QTcpSocket *, Subscriber> m_subscribers;
+};
+} // namespace Plugins
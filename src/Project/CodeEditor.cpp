@@ -24,12 +24,25 @@
 #include "Model.h"
 
 #include <QFile>
-#include <QJSEngine>
+#include <QFileInfo>
 #include <QFileDialog>
+#include <QJsonObject>
+#include <Misc/Tracer.h>
 #include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
 #include <Misc/ThemeManager.h>
+#include <JSON/WasmDecoder.h>
+#include <Project/ParserWatchdog.h>
+
+/**
+ * Number of frame parser scripts that are kept loaded in their own JavaScript
+ * engine, so that switching back to a recently used project does not evaluate
+ * its script again.
+ */
+static const int MAX_CACHED_PARSERS = 4;
 
 Project::CodeEditor::CodeEditor()
+  : m_parser(new FrameParser())
 {
   // Setup syntax highlighter
   m_highlighter = new QSourceHighlite::QSourceHighliter(m_textEdit.document());
@@ -51,7 +64,29 @@ Project::CodeEditor::CodeEditor()
   auto acCopy = m_toolbar.addAction(QIcon(":/icons/copy.svg"), tr("Copy"));
   auto acPaste = m_toolbar.addAction(QIcon(":/icons/paste.svg"), tr("Paste"));
   m_toolbar.addSeparator();
+  auto acWasm = m_toolbar.addAction(QIcon(":/icons/code.svg"),
+                                    tr("WebAssembly"));
+  acWasm->setToolTip(tr("Parse frames with a WebAssembly module instead of "
+                        "the parse() function"));
   auto acHelp = m_toolbar.addAction(QIcon(":/icons/help.svg"), tr("Help"));
+  m_toolbar.addSeparator();
+
+  // Setup execution time budget & statistics widgets
+  m_budget.setRange(0, 10000);
+  m_budget.setSingleStep(10);
+  m_budget.setSuffix(tr(" ms"));
+  m_budget.setPrefix(tr("Budget: "));
+  m_budget.setSpecialValueText(tr("No budget"));
+  m_budget.setToolTip(tr("Maximum execution time of the parse() function per "
+                         "frame, slower frames are skipped"));
+  m_budget.setValue(m_settings.value("FrameParser_Budget",
+                                     ParserWatchdog::instance().budget())
+                        .toInt());
+  m_toolbar.addWidget(&m_budget);
+  m_toolbar.addSeparator();
+  m_toolbar.addWidget(&m_statistics);
+  setBudget(m_budget.value());
+  updateStatistics();
 
   // Connect action signals/slots
   connect(acUndo, &QAction::triggered, &m_textEdit, &QPlainTextEdit::undo);
@@ -67,6 +102,12 @@ Project::CodeEditor::CodeEditor()
           &Project::CodeEditor::onSaveClicked);
   connect(acHelp, &QAction::triggered, this,
           &Project::CodeEditor::onHelpClicked);
+  connect(acWasm, &QAction::triggered, this,
+          &Project::CodeEditor::onWasmClicked);
+  connect(&m_budget, QOverload<int>::of(&QSpinBox::valueChanged), this,
+          &Project::CodeEditor::setBudget);
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz, this,
+          &Project::CodeEditor::updateStatistics);
 
   // Set widget palette
   QPalette palette;
@@ -109,41 +150,64 @@ Project::CodeEditor &Project::CodeEditor::instance()
   return instance;
 }
 
-QString Project::CodeEditor::defaultCode() const
+/**
+ * Returns @c true if the loaded frame parser is equivalent to the default
+ * frame parser (which only splits the frame with the separator sequence). In
+ * that case, the JSON generator splits frames natively instead of calling the
+ * JavaScript engine.
+ */
+bool Project::CodeEditor::nativeSplit() const
 {
-  QString code;
-  QFile file(":/scripts/frame-parser.js");
-  if (file.open(QFile::ReadOnly))
-  {
-    code = QString::fromUtf8(file.readAll());
-    file.close();
-  }
+  return m_parser->nativeSplit();
+}
+
+/**
+ * Returns @c true if the loaded frame parser declares the optional
+ * @c parseBatch() function, which parses several frames in a single call.
+ */
+bool Project::CodeEditor::batchParsing() const
+{
+  return m_parser->batchParsing();
+}
 
-  return code;
+/**
+ * Returns the code of the frame parser that is currently loaded, this allows
+ * other modules to load the same script in their own frame parser instances.
+ */
+QString Project::CodeEditor::frameParserCode() const
+{
+  return m_loadedScript;
+}
+
+QString Project::CodeEditor::defaultCode() const
+{
+  return FrameParser::defaultCode();
 }
 
 QStringList Project::CodeEditor::parse(const QString &frame,
                                        const QString &separator)
 {
-  // Construct function arguments
-  QJSValueList args;
-  args << frame << separator;
+  TRACE_SCOPE("Project::CodeEditor::parse");
 
-  // Evaluate frame parsing function
-  auto out = m_parseFunction.call(args).toVariant().toList();
+  return m_parser->parse(frame, separator);
+}
 
-  // Convert output to QStringList
-  QStringList list;
-  for (auto i = 0; i < out.count(); ++i)
-    list.append(out.at(i).toString());
+/**
+ * Parses all the given @a frames with a single call to the @c parseBatch()
+ * function of the frame parser (if declared by the script).
+ */
+QVector<QStringList> Project::CodeEditor::parseBatch(const QStringList &frames,
+                                                     const QString &separator)
+{
+  TRACE_SCOPE("Project::CodeEditor::parseBatch");
 
-  // Return fields list
-  return list;
+  return m_parser->parseBatch(frames, separator);
 }
 
 void Project::CodeEditor::displayWindow()
 {
   showNormal();
+  updateStatistics();
 }
 
 void Project::CodeEditor::onNewClicked()
@@ -195,6 +259,60 @@ void Project::CodeEditor::onOpenClicked()
   }
 }
 
+/**
+ * Lets the user select the WebAssembly module that parses the frames of the
+ * project (see @c JSON::WasmDecoder), or go back to the JavaScript parser if
+ * a module is already selected.
+ */
+void Project::CodeEditor::onWasmClicked()
+{
+  auto &model = Model::instance();
+
+  // Module selected, ask the user if the JavaScript parser should be used
+  const auto current = model.wasm();
+  if (!current.isUndefined() && !current.isNull())
+  {
+    auto ret = Misc::Utilities::showMessageBox(
+        tr("This project uses a WebAssembly frame parser"),
+        tr("Do you want to select another module? Choose \"No\" to parse "
+           "frames with the JavaScript parse() function again."),
+        qAppName(), QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+    if (ret == QMessageBox::Cancel)
+      return;
+
+    if (ret == QMessageBox::No)
+    {
+      model.setWasm(QJsonValue());
+      return;
+    }
+  }
+
+  // Warn the user if the runtime is not available
+  if (!JSON::WasmDecoder::isSupported())
+    Misc::Utilities::showMessageBox(
+        tr("WebAssembly is not supported by this build"),
+        tr("The module will be saved in the project, but frames will only be "
+           "parsed by builds with WebAssembly support."));
+
+  // Get file from system
+  const auto projectDir = QFileInfo(model.jsonFilePath()).absolutePath();
+  const auto path = QFileDialog::getOpenFileName(
+      Q_NULLPTR, tr("Select WebAssembly module"),
+      model.jsonFilePath().isEmpty() ? QDir::homePath() : projectDir,
+      "*.wasm");
+  if (path.isEmpty())
+    return;
+
+  // Store the module path relative to the project file
+  QJsonObject config;
+  if (model.jsonFilePath().isEmpty())
+    config.insert("module", path);
+  else
+    config.insert("module", QDir(projectDir).relativeFilePath(path));
+
+  model.setWasm(config);
+}
+
 void Project::CodeEditor::onSaveClicked()
 {
   if (save(false))
@@ -203,6 +321,31 @@ void Project::CodeEditor::onSaveClicked()
 
 void Project::CodeEditor::onHelpClicked() {}
 
+/**
+ * Displays the parsing time statistics collected by the frame parser watchdog
+ */
+void Project::CodeEditor::updateStatistics()
+{
+  if (!isVisible())
+    return;
+
+  const auto stats = ParserWatchdog::instance().statistics();
+  m_statistics.setText(tr("Average: %1 ms | Max: %2 ms | Skipped: %3 frames")
+                           .arg(stats.averageTime / 1e6, 0, 'f', 3)
+                           .arg(stats.maxTime / 1e6, 0, 'f', 3)
+                           .arg(stats.skipped));
+}
+
+/**
+ * Changes the execution time budget of the frame parser per frame, frames that
+ * take longer to parse are skipped.
+ */
+void Project::CodeEditor::setBudget(const int milliseconds)
+{
+  ParserWatchdog::instance().setBudget(milliseconds);
+  m_settings.setValue("FrameParser_Budget", milliseconds);
+}
+
 bool Project::CodeEditor::save(const bool silent)
 {
   // Update text edit
@@ -229,13 +372,26 @@ bool Project::CodeEditor::save(const bool silent)
 
 bool Project::CodeEditor::loadScript(const QString &script)
 {
-  // Check if there are no general JS errors
-  QStringList errors;
-  m_engine.evaluate(script, "", 1, &errors);
+  // Script was loaded recently (e.g. the user switches between the projects
+  // of several device variants), reuse its JavaScript engine
+  const auto cached = m_parserScripts.indexOf(script);
+  if (cached >= 0)
+  {
+    m_parser = m_parsers.at(cached);
+    m_parsers.move(cached, 0);
+    m_parserScripts.move(cached, 0);
+    m_loadedScript = script;
+    Q_EMIT parserChanged();
+    return true;
+  }
+
+  // Evaluate & validate the script in a new engine, the active parser is only
+  // replaced if the script is valid
+  QSharedPointer<FrameParser> parser(new FrameParser());
+  const auto status = parser->load(script);
 
   // Check if parse() function exists
-  auto fun = m_engine.globalObject().property("parse");
-  if (fun.isNull() || !fun.isCallable())
+  if (status == FrameParser::LoadStatus::MissingFunction)
   {
     Misc::Utilities::showMessageBox(
         tr("Frame parser error!"),
@@ -243,24 +399,31 @@ bool Project::CodeEditor::loadScript(const QString &script)
     return false;
   }
 
-  // Try to run parse() function
-  QJSValueList args = {"", ","};
-  auto ret = fun.call(args);
-
   // Error on engine evaluation
-  if (!errors.isEmpty())
+  else if (status == FrameParser::LoadStatus::SyntaxError)
   {
     Misc::Utilities::showMessageBox(
         tr("Frame parser syntax error!"),
-        tr("Error on line %1.").arg(errors.first()));
+        tr("Error on line %1.").arg(parser->syntaxError()));
+    return false;
+  }
+
+  // Script did not finish within the execution time budget
+  else if (status == FrameParser::LoadStatus::Timeout)
+  {
+    Misc::Utilities::showMessageBox(
+        tr("Frame parser timeout!"),
+        tr("The script did not finish within the execution time budget "
+           "(%1 ms), check it for endless loops.")
+            .arg(ParserWatchdog::instance().budget()));
     return false;
   }
 
   // Error on function execution
-  else if (ret.isError())
+  else if (status == FrameParser::LoadStatus::ExecutionError)
   {
     QString errorStr;
-    switch (ret.errorType())
+    switch (parser->executionError())
     {
       case QJSValue::GenericError:
         errorStr = tr("Generic error");
@@ -293,8 +456,18 @@ bool Project::CodeEditor::loadScript(const QString &script)
     return false;
   }
 
-  // We have reached this point without any errors, set function caller
-  m_parseFunction = fun;
+  // We have reached this point without any errors, keep the engine warm
+  m_parser = parser;
+  m_parsers.prepend(parser);
+  m_parserScripts.prepend(script);
+  while (m_parsers.count() > MAX_CACHED_PARSERS)
+  {
+    m_parsers.removeLast();
+    m_parserScripts.removeLast();
+  }
+
+  m_loadedScript = script;
+  Q_EMIT parserChanged();
   return true;
 }
 
@@ -334,7 +507,14 @@ void Project::CodeEditor::readCode()
 {
   m_textEdit.setPlainText(Model::instance().frameParserCode());
   m_textEdit.document()->setModified(false);
-  loadScript(m_textEdit.toPlainText());
+
+  // Script already loaded (e.g. the same project was opened again), avoid
+  // evaluating it again
+  const auto script = m_textEdit.toPlainText();
+  if (!m_loadedScript.isEmpty() && script == m_loadedScript)
+    return;
+
+  loadScript(script);
 }
 
 void Project::CodeEditor::writeChanges()
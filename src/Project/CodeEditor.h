@@ -22,18 +22,22 @@
 
 #pragma once
 
+#include <QLabel>
 #include <QObject>
+#include <QVector>
+#include <QSharedPointer>
 #include <QDialog>
+#include <QSpinBox>
 #include <QToolBar>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QPlainTextEdit>
 
-#include <QJSValue>
-#include <QJSEngine>
+#include <Project/FrameParser.h>
 
 #include <QSourceHighlite/qsourcehighliter.h>
+#include <Misc/Settings.h>
 
 namespace Project
 {
@@ -41,6 +45,9 @@ class CodeEditor : public QDialog
 {
   Q_OBJECT
 
+Q_SIGNALS:
+  void parserChanged();
+
 private:
   explicit CodeEditor();
   ~CodeEditor();
@@ -51,8 +58,13 @@ private:
 
 public:
   static CodeEditor &instance();
+  bool nativeSplit() const;
+  bool batchParsing() const;
+  QString frameParserCode() const;
   QString defaultCode() const;
   QStringList parse(const QString &frame, const QString &separator);
+  QVector<QStringList> parseBatch(const QStringList &frames,
+                                  const QString &separator);
 
 public Q_SLOTS:
   void displayWindow();
@@ -62,6 +74,9 @@ private Q_SLOTS:
   void onOpenClicked();
   void onSaveClicked();
   void onHelpClicked();
+  void onWasmClicked();
+  void updateStatistics();
+  void setBudget(const int milliseconds);
 
 private:
   bool checkModified();
@@ -74,9 +89,14 @@ private slots:
   void writeChanges();
 
 private:
-  QJSEngine m_engine;
+  QLabel m_statistics;
+  QSpinBox m_budget;
   QToolBar m_toolbar;
-  QJSValue m_parseFunction;
+  Misc::Settings m_settings;
+  QSharedPointer<FrameParser> m_parser;
+  QList<QSharedPointer<FrameParser>> m_parsers;
+  QStringList m_parserScripts;
+  QString m_loadedScript;
   QPlainTextEdit m_textEdit;
   QSourceHighlite::QSourceHighliter *m_highlighter;
 };
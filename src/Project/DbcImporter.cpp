@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QRegularExpression>
+#include <Project/DbcImporter.h>
+
+/**
+ * Mask of the identifier bits of a DBC message ID, extended frames are
+ * flagged by the most significant bit.
+ */
+static const quint32 CAN_ID_MASK = 0x1FFFFFFF;
+
+/**
+ * Reads the messages & signals of the DBC file at the given @a path. If the
+ * file cannot be read or contains no messages, a description of the problem
+ * is written to @a error & @c false is returned.
+ */
+bool Project::DbcImporter::read(const QString &path, QString *error)
+{
+  // Reset messages
+  m_messages.clear();
+
+  // Open the file
+  QFile file(path);
+  if (!file.open(QFile::ReadOnly | QFile::Text))
+  {
+    if (error)
+      *error = file.errorString();
+
+    return false;
+  }
+
+  // clang-format off
+  static const QRegularExpression message(
+      QStringLiteral("^BO_\\s+(\\d+)\\s+(\\w+)\\s*:"));
+  static const QRegularExpression signal(
+      QStringLiteral("^SG_\\s+(\\w+)\\s*(\\w*)\\s*:\\s*(\\d+)\\|(\\d+)@([01])"
+                     "([+-])\\s*\\(([^,]+),([^)]+)\\)\\s*\\[([^|]*)\\|([^\\]]*)"
+                     "\\]\\s*\"([^\"]*)\""));
+  static const QRegularExpression valueType(
+      QStringLiteral("^SIG_VALTYPE_\\s+(\\d+)\\s+(\\w+)\\s*:?\\s*([12])"));
+  // clang-format on
+
+  // Parse the file line by line
+  while (!file.atEnd())
+  {
+    const auto line = QString::fromUtf8(file.readLine()).trimmed();
+
+    // New message
+    auto match = message.match(line);
+    if (match.hasMatch())
+    {
+      Message m;
+      m.id = match.captured(1).toUInt() & CAN_ID_MASK;
+      m.name = match.captured(2);
+      m_messages.append(m);
+      continue;
+    }
+
+    // Signal of the last message, multiplexed signals are skipped
+    match = signal.match(line);
+    if (match.hasMatch() && !m_messages.isEmpty())
+    {
+      const auto mux = match.captured(2);
+      if (mux.startsWith('m'))
+        continue;
+
+      Signal s;
+      s.name = match.captured(1);
+      s.startBit = match.captured(3).toInt();
+      s.length = match.captured(4).toInt();
+      s.bigEndian = match.captured(5) == QStringLiteral("0");
+      s.isSigned = match.captured(6) == QStringLiteral("-");
+      s.floatType = 0;
+      s.factor = match.captured(7).trimmed().toDouble();
+      s.offset = match.captured(8).trimmed().toDouble();
+      s.minimum = match.captured(9).trimmed().toDouble();
+      s.maximum = match.captured(10).trimmed().toDouble();
+      s.units = match.captured(11);
+      m_messages.last().signalList.append(s);
+      continue;
+    }
+
+    // Floating point signal types (1 = float32, 2 = float64)
+    match = valueType.match(line);
+    if (match.hasMatch())
+    {
+      const auto id = match.captured(1).toUInt() & CAN_ID_MASK;
+      for (auto &m : m_messages)
+      {
+        if (m.id != id)
+          continue;
+
+        for (auto &s : m.signalList)
+        {
+          if (s.name == match.captured(2))
+            s.floatType = match.captured(3).toInt();
+        }
+      }
+    }
+  }
+
+  // Remove messages without signals (e.g. VECTOR__INDEPENDENT_SIG_MSG)
+  for (int i = m_messages.count() - 1; i >= 0; --i)
+  {
+    if (m_messages.at(i).signalList.isEmpty())
+      m_messages.removeAt(i);
+  }
+
+  // Validate file
+  if (m_messages.isEmpty())
+  {
+    if (error)
+      *error = QStringLiteral("No CAN messages found");
+
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Returns the messages read from the last DBC file
+ */
+const QVector<Project::DbcImporter::Message> &
+Project::DbcImporter::messages() const
+{
+  return m_messages;
+}
+
+/**
+ * Converts the given @a signal of the given @a message to a field of a routed
+ * binary layout. An empty object is returned (and @a error is set) if the
+ * signal cannot be represented with a 64-bit bitfield.
+ */
+QJsonObject Project::DbcImporter::layoutField(const Message &message,
+                                              const Signal &signal,
+                                              QString *error)
+{
+  // Get location of the signal within the 64-bit word that starts at the
+  // byte that contains the start bit. The start bit of Intel signals is their
+  // least significant bit, the start bit of Motorola signals is their most
+  // significant bit.
+  const int byte = signal.startBit / 8;
+  const int bit = signal.startBit % 8;
+  int bitOffset = bit;
+  if (signal.bigEndian)
+    bitOffset = 56 + bit - signal.length + 1;
+
+  // Validate signal, floats are read as whole values & must be byte aligned
+  const bool isFloat = signal.floatType != 0;
+  const int floatBits = signal.floatType == 1 ? 32 : 64;
+  const int floatBit = signal.bigEndian ? 7 : 0;
+  if (signal.length <= 0 || bitOffset < 0 || bitOffset + signal.length > 64
+      || (isFloat && (signal.length != floatBits || bit != floatBit)))
+  {
+    if (error)
+      *error = QStringLiteral("Unsupported layout for signal \"%1\"")
+                   .arg(signal.name);
+
+    return QJsonObject();
+  }
+
+  // Get the field type
+  QString type = signal.isSigned ? "int64" : "uint64";
+  if (isFloat)
+    type = signal.floatType == 1 ? "float32" : "float64";
+
+  // Create the field
+  QJsonObject field;
+  field.insert("type", type);
+  field.insert("offset", byte);
+  field.insert("canId", static_cast<double>(message.id));
+  field.insert("endianness", signal.bigEndian ? "big" : "little");
+  field.insert("scale", signal.factor);
+  field.insert("bias", signal.offset);
+  if (!isFloat)
+  {
+    field.insert("bitOffset", bitOffset);
+    field.insert("bitCount", signal.length);
+  }
+
+  return field;
+}
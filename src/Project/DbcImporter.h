@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+namespace Project
+{
+/**
+ * @brief The DbcImporter class
+ *
+ * Minimal reader for CAN database (DBC) files, it extracts the messages
+ * (@c BO_ lines), their signals (@c SG_ lines) & the floating point signal
+ * types (@c SIG_VALTYPE_ lines), which is all the information needed to
+ * decode CAN frames.
+ *
+ * Each signal is converted to a field of a routed binary layout (see
+ * @c JSON::BinaryDecoder): the signal is read from the 64-bit word that
+ * starts at the byte that contains its start bit, and extracted with a
+ * bitfield. Intel (little-endian) & Motorola (big-endian) signals are
+ * supported, multiplexed signals are not and are skipped.
+ */
+class DbcImporter
+{
+public:
+  struct Signal
+  {
+    QString name;
+    QString units;
+    int startBit;
+    int length;
+    bool bigEndian;
+    bool isSigned;
+    int floatType;
+    double factor;
+    double offset;
+    double minimum;
+    double maximum;
+  };
+
+  struct Message
+  {
+    quint32 id;
+    QString name;
+    QVector<Signal> signalList;
+  };
+
+  bool read(const QString &path, QString *error = Q_NULLPTR);
+  const QVector<Message> &messages() const;
+
+  static QJsonObject layoutField(const Message &message, const Signal &signal,
+                                 QString *error = Q_NULLPTR);
+
+private:
+  QVector<Message> m_messages;
+};
+} // namespace Project
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <Project/FrameParser.h>
+
+/**
+ * Removes comments & whitespace from the given JavaScript @a code, this is
+ * used to check if two scripts are equivalent.
+ */
+static QString CANONICAL_CODE(const QString &code)
+{
+  static const QRegularExpression blockComments(
+      "/\\*.*?\\*/", QRegularExpression::DotMatchesEverythingOption);
+  static const QRegularExpression lineComments("//[^\\n]*");
+  static const QRegularExpression whitespace("\\s+");
+
+  auto canonical = code;
+  canonical.remove(blockComments);
+  canonical.remove(lineComments);
+  canonical.remove(whitespace);
+  return canonical;
+}
+
+/**
+ * Converts the given JavaScript array @a value to a list of strings, reading
+ * each element directly instead of converting the array to a @c QVariant.
+ */
+static QStringList TO_STRING_LIST(const QJSValue &value)
+{
+  QStringList list;
+  if (!value.isArray())
+    return list;
+
+  const auto length = value.property("length").toUInt();
+  list.reserve(static_cast<int>(length));
+  for (quint32 i = 0; i < length; ++i)
+    list.append(value.property(i).toString());
+
+  return list;
+}
+
+/**
+ * Constructor function, registers the JavaScript engine with the watchdog
+ */
+Project::FrameParser::FrameParser()
+  : m_nativeSplit(false)
+  , m_executionError(QJSValue::NoError)
+{
+  m_watch = ParserWatchdog::instance().watch(&m_engine);
+}
+
+/**
+ * Destructor function, unregisters the JavaScript engine from the watchdog
+ */
+Project::FrameParser::~FrameParser()
+{
+  ParserWatchdog::instance().release(m_watch);
+}
+
+/**
+ * Returns @c true if the loaded frame parser is equivalent to the default
+ * frame parser (which only splits the frame with the separator sequence). In
+ * that case, frames can be split natively instead of calling the JavaScript
+ * engine.
+ */
+bool Project::FrameParser::nativeSplit() const
+{
+  return m_nativeSplit;
+}
+
+/**
+ * Returns @c true if the loaded frame parser declares the optional
+ * @c parseBatch() function, which parses several frames in a single call.
+ */
+bool Project::FrameParser::batchParsing() const
+{
+  return m_parseBatchFunction.isCallable();
+}
+
+/**
+ * Returns the line at which the last syntax error was detected by @c load()
+ */
+QString Project::FrameParser::syntaxError() const
+{
+  return m_syntaxError;
+}
+
+/**
+ * Returns the type of the last error thrown by the @c parse() function when
+ * it was tested by @c load().
+ */
+QJSValue::ErrorType Project::FrameParser::executionError() const
+{
+  return m_executionError;
+}
+
+/**
+ * Returns the code of the default frame parser
+ */
+QString Project::FrameParser::defaultCode()
+{
+  QString code;
+  QFile file(":/scripts/frame-parser.js");
+  if (file.open(QFile::ReadOnly))
+  {
+    code = QString::fromUtf8(file.readAll());
+    file.close();
+  }
+
+  return code;
+}
+
+/**
+ * Evaluates the given @a script and validates its @c parse() function. The
+ * previously loaded functions are kept if the script is not valid.
+ */
+Project::FrameParser::LoadStatus
+Project::FrameParser::load(const QString &script)
+{
+  // Remove functions declared by previous scripts
+  m_engine.globalObject().deleteProperty("parse");
+  m_engine.globalObject().deleteProperty("parseBatch");
+
+  // Check if there are no general JS errors
+  QStringList errors;
+  auto &watchdog = ParserWatchdog::instance();
+  watchdog.arm(m_watch, 1);
+  m_engine.evaluate(script, "", 1, &errors);
+  if (watchdog.disarm(m_watch))
+    return LoadStatus::Timeout;
+
+  // Check if parse() function exists
+  auto fun = m_engine.globalObject().property("parse");
+  if (fun.isNull() || !fun.isCallable())
+    return LoadStatus::MissingFunction;
+
+  // Try to run parse() function
+  QJSValueList args = {"", ","};
+  watchdog.arm(m_watch, 1);
+  auto ret = fun.call(args);
+  const auto interrupted = watchdog.disarm(m_watch);
+
+  // Error on engine evaluation
+  if (!errors.isEmpty())
+  {
+    m_syntaxError = errors.first();
+    return LoadStatus::SyntaxError;
+  }
+
+  // Function did not return within the execution time budget
+  else if (interrupted)
+    return LoadStatus::Timeout;
+
+  // Error on function execution
+  else if (ret.isError())
+  {
+    m_executionError = ret.errorType();
+    return LoadStatus::ExecutionError;
+  }
+
+  // We have reached this point without any errors, set function caller
+  m_parseFunction = fun;
+
+  // Register the optional batch parsing function
+  auto batchFun = m_engine.globalObject().property("parseBatch");
+  if (batchFun.isCallable())
+    m_parseBatchFunction = batchFun;
+  else
+    m_parseBatchFunction = QJSValue();
+
+  // Check if the script can be replaced by the native frame splitter
+  static const auto defaultScript = CANONICAL_CODE(defaultCode());
+  m_nativeSplit = (CANONICAL_CODE(script) == defaultScript);
+  return LoadStatus::Ok;
+}
+
+/**
+ * Returns the fields of the given @a frame, obtained with the @c parse()
+ * function of the frame parser.
+ */
+QStringList Project::FrameParser::parse(const QString &frame,
+                                        const QString &separator)
+{
+  // Construct function arguments
+  QJSValueList args;
+  args << frame << separator;
+
+  // Evaluate frame parsing function & return fields list
+  bool interrupted;
+  auto ret = call(m_parseFunction, args, 1, &interrupted);
+  if (interrupted)
+    return QStringList();
+
+  return TO_STRING_LIST(ret);
+}
+
+/**
+ * Parses all the given @a frames with a single call to the @c parseBatch()
+ * function of the frame parser, which receives an array of frames and returns
+ * an array with the fields of each frame. This amortizes the cost of entering
+ * the JavaScript engine when many frames are received at once.
+ *
+ * If the script does not declare a @c parseBatch() function, or if its output
+ * is not valid, each frame is parsed with the @c parse() function. If the call
+ * exceeds the execution time budget, all the frames of the batch are skipped.
+ */
+QVector<QStringList> Project::FrameParser::parseBatch(const QStringList &frames,
+                                                      const QString &separator)
+{
+  QVector<QStringList> output;
+  output.reserve(frames.count());
+
+  // Call parseBatch() with an array of frames
+  if (batchParsing())
+  {
+    auto array = m_engine.newArray(static_cast<quint32>(frames.count()));
+    for (int i = 0; i < frames.count(); ++i)
+      array.setProperty(static_cast<quint32>(i), frames.at(i));
+
+    bool interrupted;
+    QJSValueList args;
+    args << array << separator;
+    auto ret = call(m_parseBatchFunction, args, frames.count(), &interrupted);
+
+    // Script was interrupted, skip all the frames
+    if (interrupted)
+    {
+      output.resize(frames.count());
+      return output;
+    }
+
+    // Read the fields of each frame
+    if (!ret.isError() && ret.isArray()
+        && ret.property("length").toInt() == frames.count())
+    {
+      for (int i = 0; i < frames.count(); ++i)
+        output.append(TO_STRING_LIST(ret.property(static_cast<quint32>(i))));
+
+      return output;
+    }
+  }
+
+  // Parse frames one by one
+  for (int i = 0; i < frames.count(); ++i)
+    output.append(parse(frames.at(i), separator));
+
+  return output;
+}
+
+/**
+ * Calls the given script @a function with the given @a args under the
+ * supervision of the watchdog, which interrupts the call if it exceeds the
+ * execution time budget for the given number of @a frames.
+ *
+ * The time spent in the call is registered in the watchdog statistics, and
+ * @a interrupted is set to @c true if the call was interrupted.
+ */
+QJSValue Project::FrameParser::call(const QJSValue &function,
+                                    const QJSValueList &args, const int frames,
+                                    bool *interrupted)
+{
+  auto &watchdog = ParserWatchdog::instance();
+
+  QElapsedTimer timer;
+  timer.start();
+  watchdog.arm(m_watch, frames);
+  auto ret = function.call(args);
+  *interrupted = watchdog.disarm(m_watch);
+  watchdog.record(timer.nsecsElapsed(), frames, *interrupted);
+
+  return ret;
+}
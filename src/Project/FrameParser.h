@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QJSValue>
+#include <QJSEngine>
+#include <QStringList>
+
+#include <Project/ParserWatchdog.h>
+
+namespace Project
+{
+/**
+ * @brief The FrameParser class
+ *
+ * Runs the JavaScript frame parser of a project. The class owns its own
+ * @c QJSEngine, so independent instances can be used from different threads
+ * (each instance must only be used from the thread in which it was created).
+ *
+ * A frame parser script must declare a @c parse(frame, separator) function,
+ * which returns an array with the fields of the given frame. Optionally, the
+ * script may declare a @c parseBatch(frames, separator) function, which
+ * receives an array of frames and returns an array with the fields of each
+ * frame.
+ *
+ * Script calls are monitored by the @c ParserWatchdog, calls that exceed the
+ * execution time budget are interrupted & the frames are skipped (an empty
+ * list of fields is returned for them).
+ */
+class FrameParser
+{
+public:
+  enum class LoadStatus
+  {
+    Ok,
+    SyntaxError,
+    ExecutionError,
+    MissingFunction,
+    Timeout
+  };
+
+  FrameParser();
+  ~FrameParser();
+
+  bool nativeSplit() const;
+  bool batchParsing() const;
+  QString syntaxError() const;
+  QJSValue::ErrorType executionError() const;
+
+  static QString defaultCode();
+
+  LoadStatus load(const QString &script);
+  QStringList parse(const QString &frame, const QString &separator);
+  QVector<QStringList> parseBatch(const QStringList &frames,
+                                  const QString &separator);
+
+private:
+  QJSValue call(const QJSValue &function, const QJSValueList &args,
+                const int frames, bool *interrupted);
+
+private:
+  bool m_nativeSplit;
+  QString m_syntaxError;
+  QJSValue::ErrorType m_executionError;
+
+  QJSEngine m_engine;
+  ParserWatchdog::Watch *m_watch;
+  QJSValue m_parseFunction;
+  QJSValue m_parseBatchFunction;
+};
+} // namespace Project
@@ -29,11 +29,22 @@
 #include <QFileDialog>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <algorithm>
 
 #include <AppInfo.h>
 #include <IO/Manager.h>
+#include <IO/ModbusScheduler.h>
 #include <JSON/Generator.h>
+#include <JSON/AlarmEngine.h>
+#include <JSON/Decimator.h>
+#include <JSON/Calibration.h>
+#include <JSON/FrameRouter.h>
+#include <JSON/BinaryDecoder.h>
+#include <JSON/NmeaDecoder.h>
+#include <JSON/WasmDecoder.h>
+#include <JSON/ProjectCache.h>
 #include <Misc/Utilities.h>
+#include <Project/DbcImporter.h>
 
 //
 // For invalid group returns, avoids crashes while creating a new project & the
@@ -41,6 +52,53 @@
 //
 static JSON::Group EMPTY_GROUP;
 
+//
+// Identifiers used to store the framing mode in the JSON project file, the
+// order matches the IO::Manager::FramingMode enum
+//
+static const char *FRAMING_MODES[]
+    = {"delimiters", "length8", "length16be", "length16le",
+       "length32be", "length32le", "cobs",       "slip"};
+static const int FRAMING_MODE_COUNT
+    = sizeof(FRAMING_MODES) / sizeof(FRAMING_MODES[0]);
+
+//
+// Identifiers used to store the compression mode in the JSON project file,
+// the order matches the IO::Manager::Compression enum
+//
+static const char *COMPRESSION_MODES[]
+    = {"none",       "lz4-u16le",        "lz4-u32le",
+       "heatshrink", "heatshrink-u16le", "heatshrink-u32le"};
+static const int COMPRESSION_MODE_COUNT
+    = sizeof(COMPRESSION_MODES) / sizeof(COMPRESSION_MODES[0]);
+
+//
+// Identifiers used to store the checksum algorithm in the JSON project file,
+// the order matches the IO::ChecksumAlgorithm enum
+//
+static const char *CHECKSUM_ALGORITHMS[]
+    = {"auto",  "crc8",   "crc16",      "crc16-modbus", "crc16-ccitt",
+       "crc32", "crc32c", "fletcher16", "xor8"};
+static const int CHECKSUM_ALGORITHM_COUNT
+    = sizeof(CHECKSUM_ALGORITHMS) / sizeof(CHECKSUM_ALGORITHMS[0]);
+
+//
+// Identifiers used to store the checksum placement & encoding in the JSON
+// project file, the order matches the IO::ChecksumPlacement and
+// IO::ChecksumEncoding enums
+//
+static const char *CHECKSUM_PLACEMENTS[] = {"before", "after"};
+static const char *CHECKSUM_ENCODINGS[] = {"raw", "hex"};
+static const int CHECKSUM_PLACEMENT_COUNT
+    = sizeof(CHECKSUM_PLACEMENTS) / sizeof(CHECKSUM_PLACEMENTS[0]);
+static const int CHECKSUM_ENCODING_COUNT
+    = sizeof(CHECKSUM_ENCODINGS) / sizeof(CHECKSUM_ENCODINGS[0]);
+
+//
+// Maximum number of rows & columns of the matrix displayed by a heatmap group
+//
+static const int MAX_MATRIX_SIZE = 256;
+
 //----------------------------------------------------------------------------------------
 // Constructor/deconstructor & singleton
 //----------------------------------------------------------------------------------------
@@ -57,8 +115,20 @@ Project::Model::Model()
   , m_frameParserCode("")
   , m_frameEndSequence("")
   , m_frameStartSequence("")
+  , m_framingMode(0)
+  , m_compression(0)
+  , m_heatshrinkWindow(8)
+  , m_heatshrinkLookahead(4)
+  , m_checksumAlgorithm(0)
+  , m_checksumPlacement(0)
+  , m_checksumEncoding(0)
+  , m_decimation(1)
   , m_modified(false)
   , m_filePath("")
+  , m_editDepth(0)
+  , m_pendingGroupCount(false)
+  , m_pendingGroupOrder(false)
+  , m_pendingDataset(-1, -1)
 {
   // clang-format off
 
@@ -75,8 +145,28 @@ Project::Model::Model()
             this, &Project::Model::onModelChanged);
     connect(this, &Project::Model::groupOrderChanged,
             this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::framingModeChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::compressionChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::checksumAlgorithmChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::checksumPlacementChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::checksumEncodingChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::decimationChanged,
+            this, &Project::Model::onModelChanged);
     connect(this, &Project::Model::frameParserCodeChanged,
             this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::binaryLayoutChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::frameRoutingChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::nmeaChanged,
+            this, &Project::Model::onModelChanged);
+    connect(this, &Project::Model::wasmChanged,
+            this, &Project::Model::onModelChanged);
     connect(this, &Project::Model::frameEndSequenceChanged,
             this, &Project::Model::onModelChanged);
     connect(this, &Project::Model::frameStartSequenceChanged,
@@ -110,17 +200,64 @@ Project::Model &Project::Model::instance()
 StringList Project::Model::availableGroupLevelWidgets()
 {
   return StringList{tr("Dataset widgets"), tr("Accelerometer"), tr("Gyroscope"),
-                    tr("GPS"), tr("Multiple data plot")};
+                    tr("GPS"), tr("Multiple data plot"), tr("Statistics"),
+                    tr("XY plot"), tr("Heatmap")};
 }
 
 /**
  * Returns a list with the available dataset-level widgets. This list is used by
- * the user interface to allow the user to build gauge, bar & compass widgets
- * directly from the UI.
+ * the user interface to allow the user to build gauge, bar, compass, waterfall
+ * & histogram widgets directly from the UI.
  */
 StringList Project::Model::availableDatasetLevelWidgets()
 {
-  return StringList{tr("None"), tr("Gauge"), tr("Bar/level"), tr("Compass")};
+  return StringList{tr("None"),    tr("Gauge"),     tr("Bar/level"),
+                    tr("Compass"), tr("Waterfall"), tr("Histogram")};
+}
+
+/**
+ * Returns a list with the available frame detection methods. This list is
+ * used by the user interface to allow the user to select binary framing
+ * protocols (e.g. COBS or SLIP) directly from the UI.
+ */
+StringList Project::Model::availableFramingModes()
+{
+  return IO::Manager::instance().availableFramingModes();
+}
+
+/**
+ * Returns a list with the available compression modes, used by devices that
+ * compress their data before sending it (e.g. LZ4 or heatshrink).
+ */
+StringList Project::Model::availableCompressionModes()
+{
+  return IO::Manager::instance().availableCompressionModes();
+}
+
+/**
+ * Returns a list with the available checksum algorithms that can be appended
+ * to each frame.
+ */
+StringList Project::Model::availableChecksumAlgorithms()
+{
+  return IO::Manager::instance().availableChecksumAlgorithms();
+}
+
+/**
+ * Returns a list with the available locations of the checksum relative to
+ * the finish sequence of each frame.
+ */
+StringList Project::Model::availableChecksumPlacements()
+{
+  return IO::Manager::instance().availableChecksumPlacements();
+}
+
+/**
+ * Returns a list with the available checksum encodings.
+ */
+StringList Project::Model::availableChecksumEncodings()
+{
+  return IO::Manager::instance().availableChecksumEncodings();
 }
 
 /**
@@ -172,6 +309,67 @@ QString Project::Model::frameStartSequence() const
   return m_frameStartSequence;
 }
 
+/**
+ * Returns the frame detection method for the current project, the value
+ * corresponds to the @c IO::Manager::FramingMode enum.
+ */
+int Project::Model::framingMode() const
+{
+  return m_framingMode;
+}
+
+/**
+ * Returns the compression mode for the current project, the value corresponds
+ * to the @c IO::Manager::Compression enum.
+ */
+int Project::Model::compression() const
+{
+  return m_compression;
+}
+
+/**
+ * Returns the size (in bits) of the heatshrink back-reference window.
+ */
+int Project::Model::heatshrinkWindow() const
+{
+  return m_heatshrinkWindow;
+}
+
+/**
+ * Returns the size (in bits) of the heatshrink lookahead buffer.
+ */
+int Project::Model::heatshrinkLookahead() const
+{
+  return m_heatshrinkLookahead;
+}
+
+/**
+ * Returns the checksum algorithm for the current project, the value
+ * corresponds to the @c IO::ChecksumAlgorithm enum.
+ */
+int Project::Model::checksumAlgorithm() const
+{
+  return m_checksumAlgorithm;
+}
+
+/**
+ * Returns the location of the checksum for the current project, the value
+ * corresponds to the @c IO::ChecksumPlacement enum.
+ */
+int Project::Model::checksumPlacement() const
+{
+  return m_checksumPlacement;
+}
+
+/**
+ * Returns the encoding of the checksum for the current project, the value
+ * corresponds to the @c IO::ChecksumEncoding enum.
+ */
+int Project::Model::checksumEncoding() const
+{
+  return m_checksumEncoding;
+}
+
 /**
  * Returns @c true if the user modified the current project. This is
  * used to know if Serial Studio shall prompt the user to save his/her
@@ -324,6 +522,28 @@ bool Project::Model::saveJsonFile()
   json.insert("frameEnd", frameEndSequence());
   json.insert("frameParser", frameParserCode());
   json.insert("frameStart", frameStartSequence());
+  json.insert("framing", FRAMING_MODES[framingMode()]);
+  json.insert("checksum", CHECKSUM_ALGORITHMS[checksumAlgorithm()]);
+  if (compression() > 0)
+  {
+    json.insert("compression", COMPRESSION_MODES[compression()]);
+    json.insert("heatshrinkWindow", heatshrinkWindow());
+    json.insert("heatshrinkLookahead", heatshrinkLookahead());
+  }
+  if (checksumPlacement() > 0)
+    json.insert("checksumPlacement", CHECKSUM_PLACEMENTS[checksumPlacement()]);
+  if (checksumEncoding() > 0)
+    json.insert("checksumEncoding", CHECKSUM_ENCODINGS[checksumEncoding()]);
+  if (!m_binaryLayout.isEmpty())
+    json.insert("binaryLayout", m_binaryLayout);
+  if (m_decimation > 1)
+    json.insert("decimation", m_decimation);
+  if (!m_frameRouting.isEmpty())
+    json.insert("frameRouting", m_frameRouting);
+  if (!m_nmea.isUndefined() && !m_nmea.isNull())
+    json.insert("nmea", m_nmea);
+  if (!m_wasm.isUndefined() && !m_wasm.isNull())
+    json.insert("wasm", m_wasm);
 
   // Create group array
   QJsonArray groups;
@@ -333,6 +553,10 @@ bool Project::Model::saveJsonFile()
     QJsonObject group;
     group.insert("title", groupTitle(i));
     group.insert("widget", groupWidget(i));
+    if (!groupFrameId(i).isEmpty())
+      group.insert("frameId", groupFrameId(i));
+    if (groupColumns(i) > 0)
+      group.insert("columns", groupColumns(i));
 
     // Create dataset array
     QJsonArray datasets;
@@ -354,6 +578,34 @@ bool Project::Model::saveJsonFile()
       dataset.insert("index", datasetIndex(i, j));
       dataset.insert("value", "");
 
+      // Add plot history length (if not the dashboard default)
+      const auto points = datasetPoints(i, j).toInt();
+      if (points > 0)
+        dataset.insert("points", points);
+
+      // Add sequence counter width (if the dataset is a frame counter)
+      const auto sequenceBits = datasetSequenceBits(i, j).toInt();
+      if (sequenceBits > 0)
+        dataset.insert("sequenceBits", sequenceBits);
+
+      // Add calibration, expression, alarm rules, decimation & Modbus
+      // register (if any)
+      const auto calibration = datasetCalibration(i, j);
+      const auto expression = datasetExpression(i, j);
+      const auto alarmRules = datasetAlarmRules(i, j);
+      const auto decimation = datasetDecimation(i, j);
+      const auto modbus = datasetModbus(i, j);
+      if (!calibration.isEmpty())
+        dataset.insert("calibration", calibration);
+      if (!expression.isEmpty())
+        dataset.insert("expression", expression);
+      if (!alarmRules.isEmpty())
+        dataset.insert("alarmRules", alarmRules);
+      if (!decimation.isEmpty())
+        dataset.insert("decimation", decimation);
+      if (!modbus.isEmpty())
+        dataset.insert("modbus", modbus);
+
       // Add dataset to array
       datasets.append(dataset);
     }
@@ -413,6 +665,44 @@ QString Project::Model::frameParserCode() const
   return m_frameParserCode;
 }
 
+/**
+ * Returns the declarative binary layout of the project (see
+ * @c JSON::BinaryDecoder), which is empty if frames are parsed as text.
+ */
+QJsonArray Project::Model::binaryLayout() const
+{
+  return m_binaryLayout;
+}
+
+/**
+ * Returns the configuration used to route multiplexed frame types to their
+ * groups (see @c JSON::FrameRouter), which is empty if frames are not routed.
+ */
+QJsonObject Project::Model::frameRouting() const
+{
+  return m_frameRouting;
+}
+
+/**
+ * Returns the configuration of the WebAssembly frame parser (see
+ * @c JSON::WasmDecoder), which is undefined if frames are parsed by the
+ * JavaScript frame parser.
+ */
+QJsonValue Project::Model::wasm() const
+{
+  return m_wasm;
+}
+
+/**
+ * Returns the configuration of the native NMEA 0183 decoder (see
+ * @c JSON::NmeaDecoder), which is undefined if sentences are not decoded
+ * natively.
+ */
+QJsonValue Project::Model::nmea() const
+{
+  return m_nmea;
+}
+
 /**
  * Returns the title of the given @a group.
  */
@@ -429,6 +719,14 @@ QString Project::Model::groupWidget(const int group) const
   return getGroup(group).widget();
 }
 
+/**
+ * Returns the identifier of the frame type that feeds the given @a group.
+ */
+QString Project::Model::groupFrameId(const int group) const
+{
+  return getGroup(group).frameId();
+}
+
 /**
  * Returns the widget ID of the given @a group. The widget ID is a number
  * that represents a group-level widget. The ID depends on the widget type
@@ -451,9 +749,43 @@ int Project::Model::groupWidgetIndex(const int group) const
   if (widget == "multiplot")
     return 4;
 
+  if (widget == "stats")
+    return 5;
+
+  if (widget == "xy")
+    return 6;
+
+  if (widget == "heatmap")
+    return 7;
+
   return 0;
 }
 
+/**
+ * Returns the number of rows of the matrix displayed by the given heatmap
+ * @a group, or 0 if the group is not a heatmap.
+ */
+int Project::Model::groupRows(const int group) const
+{
+  const auto columns = groupColumns(group);
+  if (columns <= 0)
+    return 0;
+
+  return datasetCount(group) / columns;
+}
+
+/**
+ * Returns the number of columns of the matrix displayed by the given heatmap
+ * @a group, or 0 if the group is not a heatmap.
+ */
+int Project::Model::groupColumns(const int group) const
+{
+  if (groupWidget(group) != "heatmap")
+    return 0;
+
+  return getGroup(group).columns();
+}
+
 /**
  * Returns the position in the frame that holds the value for the given
  * @a dataset (which is contained by the specified @a group).
@@ -566,6 +898,10 @@ int Project::Model::datasetWidgetIndex(const int group, const int dataset) const
     return 2;
   if (widget == "compass")
     return 3;
+  if (widget == "waterfall")
+    return 4;
+  if (widget == "histogram")
+    return 5;
 
   return 0;
 }
@@ -608,6 +944,31 @@ QString Project::Model::datasetFFTSamples(const int group,
   return QString::number(getDataset(group, dataset).fftSamples());
 }
 
+/**
+ * Returns the number of samples kept in the plot history of the specified
+ * dataset, zero means that the number of points of the dashboard is used.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetPoints(const int group, const int dataset) const
+{
+  return QString::number(getDataset(group, dataset).points());
+}
+
+/**
+ * Returns the width (in bits) of the frame counter carried by the specified
+ * dataset, zero means that the dataset is not a sequence counter.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetSequenceBits(const int group,
+                                            const int dataset) const
+{
+  return QString::number(getDataset(group, dataset).sequenceBits());
+}
+
 /**
  * Returns the widget alarm value of the specified dataset.
  * This option is used by the bar & gauge widgets.
@@ -626,6 +987,100 @@ QString Project::Model::datasetWidgetAlarm(const int group,
   return QString::number(set.alarm());
 }
 
+/**
+ * Returns the calibration of the specified dataset, which is empty if the
+ * dataset values are not converted to engineering units.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QJsonObject Project::Model::datasetCalibration(const int group,
+                                               const int dataset) const
+{
+  return getDataset(group, dataset).calibration();
+}
+
+/**
+ * Returns the expression used to compute the value of the specified dataset
+ * from other datasets, which is empty for datasets fed by the received data.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetExpression(const int group,
+                                          const int dataset) const
+{
+  return getDataset(group, dataset).expression();
+}
+
+/**
+ * Returns the number of generated frames that are merged into each frame
+ * published to the dashboard, MQTT & plugins (see @c JSON::Decimator).
+ */
+int Project::Model::decimation() const
+{
+  return m_decimation;
+}
+
+/**
+ * Returns the decimation policy of the specified dataset (see
+ * @c JSON::Decimator), which is empty for the default policy.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QString Project::Model::datasetDecimation(const int group,
+                                          const int dataset) const
+{
+  return getDataset(group, dataset).decimation();
+}
+
+/**
+ * Returns the Modbus register polled for the specified dataset (see
+ * @c IO::ModbusScheduler), which is empty if the dataset is not polled.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QJsonObject Project::Model::datasetModbus(const int group,
+                                          const int dataset) const
+{
+  return getDataset(group, dataset).modbus();
+}
+
+/**
+ * Returns the alarm rules of the specified dataset (see
+ * @c JSON::AlarmEngine), which are empty if no alarms are defined.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+QJsonObject Project::Model::datasetAlarmRules(const int group,
+                                              const int dataset) const
+{
+  return getDataset(group, dataset).alarmRules();
+}
+
+/**
+ * Returns the location of every dataset that reads its value from the given
+ * @a frameIndex, this is used to detect duplicated frame indexes without
+ * iterating over the whole project.
+ */
+QList<Project::DatasetSlot>
+Project::Model::datasetsForIndex(const int frameIndex) const
+{
+  return m_fieldIndex.values(frameIndex);
+}
+
+/**
+ * Returns the location of every dataset with the given @a title.
+ */
+QList<Project::DatasetSlot>
+Project::Model::datasetsWithTitle(const QString &title) const
+{
+  return m_titleIndex.values(title);
+}
+
 //----------------------------------------------------------------------------------------
 // Public slots
 //----------------------------------------------------------------------------------------
@@ -637,11 +1092,24 @@ void Project::Model::newJsonFile()
 {
   // Clear groups list
   m_groups.clear();
+  rebuildIndex();
 
   // Reset project properties
   setTitle("");
+  setFramingMode(0);
+  setCompression(0);
+  setHeatshrinkWindow(8);
+  setHeatshrinkLookahead(4);
+  setChecksumAlgorithm(0);
+  setChecksumPlacement(0);
+  setChecksumEncoding(0);
   setSeparator("");
   setFrameParserCode("");
+  setBinaryLayout(QJsonArray());
+  setFrameRouting(QJsonObject());
+  setNmea(QJsonValue());
+  setWasm(QJsonValue());
+  setDecimation(1);
   setFrameEndSequence("");
   setFrameStartSequence("");
 
@@ -678,20 +1146,15 @@ void Project::Model::openJsonFile()
 /**
  * Opens the JSON document at the given @a path & generates the appropiate C++
  * model that represents the JSON document.
+ *
+ * The document is obtained from the @c JSON::ProjectCache, which is shared
+ * with the JSON generator, so that the file is only parsed once.
  */
 void Project::Model::openJsonFile(const QString &path)
 {
-  // Open file
-  QFile file(path);
-  QJsonDocument document;
-  if (file.open(QFile::ReadOnly))
-  {
-    document = QJsonDocument::fromJson(file.readAll());
-    file.close();
-  }
-
-  // Validate JSON document
-  if (document.isEmpty())
+  // Compile the project or obtain the cached version
+  auto project = JSON::ProjectCache::instance().load(path);
+  if (!project || project->json.isEmpty())
     return;
 
   // Let the generator use the given JSON file
@@ -706,14 +1169,85 @@ void Project::Model::openJsonFile(const QString &path)
   Q_EMIT jsonFileChanged();
 
   // Read data from JSON document
-  auto json = document.object();
+  const auto &json = project->json;
   setTitle(json.value("title").toString());
   setSeparator(json.value("separator").toString());
   setFrameEndSequence(json.value("frameEnd").toString());
   setFrameParserCode(json.value("frameParser").toString());
   setFrameStartSequence(json.value("frameStart").toString());
+  if (!setBinaryLayout(json.value("binaryLayout").toArray()))
+    setBinaryLayout(QJsonArray());
+  setDecimation(json.value("decimation").toInt(1));
+  if (!setFrameRouting(json.value("frameRouting").toObject()))
+    setFrameRouting(QJsonObject());
+  if (!setNmea(json.value("nmea")))
+    setNmea(QJsonValue());
+  if (!setWasm(json.value("wasm")))
+    setWasm(QJsonValue());
+
+  // Read framing mode
+  auto framing = json.value("framing").toString();
+  for (int i = 0; i < FRAMING_MODE_COUNT; ++i)
+  {
+    if (framing == FRAMING_MODES[i])
+    {
+      setFramingMode(i);
+      break;
+    }
+  }
+
+  // Read compression mode
+  setCompression(0);
+  auto compressionId = json.value("compression").toString();
+  for (int i = 0; i < COMPRESSION_MODE_COUNT; ++i)
+  {
+    if (compressionId == COMPRESSION_MODES[i])
+      setCompression(i);
+  }
+
+  setHeatshrinkWindow(json.value("heatshrinkWindow").toInt(8));
+  setHeatshrinkLookahead(json.value("heatshrinkLookahead").toInt(4));
+
+  // Read checksum algorithm
+  auto checksum = json.value("checksum").toString();
+  for (int i = 0; i < CHECKSUM_ALGORITHM_COUNT; ++i)
+  {
+    if (checksum == CHECKSUM_ALGORITHMS[i])
+    {
+      setChecksumAlgorithm(i);
+      break;
+    }
+  }
+
+  // Read checksum placement & encoding
+  setChecksumPlacement(0);
+  setChecksumEncoding(0);
+  auto placement = json.value("checksumPlacement").toString();
+  for (int i = 0; i < CHECKSUM_PLACEMENT_COUNT; ++i)
+  {
+    if (placement == CHECKSUM_PLACEMENTS[i])
+      setChecksumPlacement(i);
+  }
+
+  auto encoding = json.value("checksumEncoding").toString();
+  for (int i = 0; i < CHECKSUM_ENCODING_COUNT; ++i)
+  {
+    if (encoding == CHECKSUM_ENCODINGS[i])
+      setChecksumEncoding(i);
+  }
 
   // Modify IO manager settings
+  IO::Manager::instance().setChecksumAlgorithm(
+      static_cast<IO::ChecksumAlgorithm>(checksumAlgorithm()));
+  IO::Manager::instance().setChecksumPlacement(
+      static_cast<IO::ChecksumPlacement>(checksumPlacement()));
+  IO::Manager::instance().setChecksumEncoding(
+      static_cast<IO::ChecksumEncoding>(checksumEncoding()));
+  IO::Manager::instance().setFramingMode(
+      static_cast<IO::Manager::FramingMode>(framingMode()));
+  IO::Manager::instance().setCompression(
+      static_cast<IO::Manager::Compression>(compression()), heatshrinkWindow(),
+      heatshrinkLookahead());
   IO::Manager::instance().setSeparatorSequence(separator());
   IO::Manager::instance().setFinishSequence(frameEndSequence());
   IO::Manager::instance().setStartSequence(frameStartSequence());
@@ -721,49 +1255,14 @@ void Project::Model::openJsonFile(const QString &path)
   // Set JSON::Generator operation mode to manual
   JSON::Generator::instance().setOperationMode(JSON::Generator::kManual);
 
-  // Read groups from JSON document
-  auto groups = json.value("groups").toArray();
+  // Read groups from JSON document (see readGroup())
+  const auto groups = json.value("groups").toArray();
+  m_groups.reserve(groups.count());
   for (int g = 0; g < groups.count(); ++g)
-  {
-    // Get JSON group data
-    auto group = groups.at(g).toObject();
-
-    // Register group with C++ model
-    addGroup();
-    setGroupTitle(g, group.value("title").toString());
-    setGroupWidgetData(g, group.value("widget").toString());
+    m_groups.append(readGroup(groups.at(g).toObject()));
 
-    // Get JSON group datasets
-    auto datasets = group.value("datasets").toArray();
-    for (int d = 0; d < datasets.count(); ++d)
-    {
-      // Get dataset JSON data
-      auto dataset = datasets.at(d).toObject();
-
-      // Register dataset with C++ model
-      addDataset(g);
-      setDatasetLED(g, d, dataset.value("led").toBool());
-      setDatasetFftPlot(g, d, dataset.value("fft").toBool());
-      setDatasetLogPlot(g, d, dataset.value("log").toBool());
-      setDatasetGraph(g, d, dataset.value("graph").toBool());
-      setDatasetTitle(g, d, dataset.value("title").toString());
-      setDatasetUnits(g, d, dataset.value("units").toString());
-      setDatasetWidgetData(g, d, dataset.value("widget").toString());
-
-      // Get max/min texts
-      auto min = dataset.value("min").toDouble();
-      auto max = dataset.value("max").toDouble();
-      auto index = dataset.value("index").toInt();
-      auto alarm = dataset.value("alarm").toDouble();
-      auto fftSamples = dataset.value("fftSamples").toInt();
-      setDatasetIndex(g, d, index);
-      setDatasetWidgetMin(g, d, QString::number(min));
-      setDatasetWidgetMax(g, d, QString::number(max));
-      setDatasetWidgetAlarm(g, d, QString::number(alarm));
-      ;
-      setDatasetFFTSamples(g, d, QString::number(fftSamples));
-    }
-  }
+  // Build dataset lookup tables
+  rebuildIndex();
 
   // Update UI
   Q_EMIT groupCountChanged();
@@ -773,23 +1272,208 @@ void Project::Model::openJsonFile(const QString &path)
 }
 
 /**
- * Changes the title of the JSON project file.
+ * Prompts the user to select a CAN database (DBC) file & creates a new
+ * project with a group for each message & a dataset for each signal.
+ *
+ * The signals are decoded with a routed binary layout, so that the frames
+ * received by the CAN bus driver are decoded natively without a frame
+ * parser script.
  */
-void Project::Model::setTitle(const QString &title)
+void Project::Model::importDbcFile()
 {
-  if (title != m_title)
+  // Save current changes
+  if (!askSave())
+    return;
+
+  // clang-format off
+    auto path = QFileDialog::getOpenFileName(Q_NULLPTR,
+                                             tr("Select DBC file"),
+                                             jsonProjectsPath(),
+                                             "*.dbc");
+  // clang-format on
+
+  // Invalid path, abort
+  if (path.isEmpty())
+    return;
+
+  // Read the DBC file
+  QString error;
+  DbcImporter importer;
+  if (!importer.read(path, &error))
   {
-    m_title = title;
-    Q_EMIT titleChanged();
+    Misc::Utilities::showMessageBox(tr("Cannot import DBC file"), error);
+    return;
   }
-}
 
-/**
- * Changes the data separator sequence of the JSON project file.
- */
-void Project::Model::setSeparator(const QString &separator)
-{
-  if (separator != m_separator)
+  // Create a new project
+  newJsonFile();
+  setTitle(QFileInfo(path).baseName());
+
+  // Register a group for each message & a dataset for each signal, the editor
+  // is only updated once all the signals have been imported
+  beginEdit();
+  int index = 0;
+  QStringList skipped;
+  QJsonArray layout;
+  for (const auto &message : importer.messages())
+  {
+    const int group = m_groups.count();
+    for (const auto &signal : message.signalList)
+    {
+      // Convert the signal to a binary layout field
+      const auto field = DbcImporter::layoutField(message, signal, &error);
+      if (field.isEmpty())
+      {
+        skipped.append(signal.name);
+        continue;
+      }
+
+      // Create the group when its first valid signal is found
+      if (m_groups.count() == group)
+      {
+        addGroup();
+        setGroupTitle(group, message.name);
+      }
+
+      // Create the dataset
+      const int dataset = datasetCount(group);
+      addDataset(group);
+      setDatasetIndex(group, dataset, ++index);
+      setDatasetTitle(group, dataset, signal.name);
+      setDatasetUnits(group, dataset, signal.units);
+      setDatasetGraph(group, dataset, true);
+      if (signal.minimum < signal.maximum)
+      {
+        setDatasetWidgetMin(group, dataset, QString::number(signal.minimum));
+        setDatasetWidgetMax(group, dataset, QString::number(signal.maximum));
+      }
+
+      layout.append(field);
+    }
+  }
+
+  // Register the binary layout
+  endEdit();
+  setBinaryLayout(layout);
+  setModified(true);
+
+  // Notify the user about the signals that could not be imported
+  if (!skipped.isEmpty())
+    Misc::Utilities::showMessageBox(
+        tr("Some signals were not imported"),
+        tr("The following signals use an unsupported layout: %1")
+            .arg(skipped.join(", ")));
+}
+
+/**
+ * Changes the title of the JSON project file.
+ */
+void Project::Model::setTitle(const QString &title)
+{
+  if (title != m_title)
+  {
+    m_title = title;
+    Q_EMIT titleChanged();
+  }
+}
+
+/**
+ * Changes the frame detection method of the JSON project file.
+ */
+void Project::Model::setFramingMode(const int mode)
+{
+  if (mode != m_framingMode && mode >= 0 && mode < FRAMING_MODE_COUNT)
+  {
+    m_framingMode = mode;
+    Q_EMIT framingModeChanged();
+  }
+}
+
+/**
+ * Changes the compression mode of the JSON project file.
+ */
+void Project::Model::setCompression(const int mode)
+{
+  if (mode != m_compression && mode >= 0 && mode < COMPRESSION_MODE_COUNT)
+  {
+    m_compression = mode;
+    Q_EMIT compressionChanged();
+  }
+}
+
+/**
+ * Changes the size (in bits) of the heatshrink back-reference window, the
+ * lookahead size is adjusted to remain smaller than the window size.
+ */
+void Project::Model::setHeatshrinkWindow(const int bits)
+{
+  const auto window = qBound(4, bits, 15);
+  if (window != m_heatshrinkWindow)
+  {
+    m_heatshrinkWindow = window;
+    m_heatshrinkLookahead = qMin(m_heatshrinkLookahead, window - 1);
+    Q_EMIT compressionChanged();
+  }
+}
+
+/**
+ * Changes the size (in bits) of the heatshrink lookahead buffer.
+ */
+void Project::Model::setHeatshrinkLookahead(const int bits)
+{
+  const auto lookahead = qBound(3, bits, m_heatshrinkWindow - 1);
+  if (lookahead != m_heatshrinkLookahead)
+  {
+    m_heatshrinkLookahead = lookahead;
+    Q_EMIT compressionChanged();
+  }
+}
+
+/**
+ * Changes the checksum algorithm of the JSON project file.
+ */
+void Project::Model::setChecksumAlgorithm(const int algorithm)
+{
+  if (algorithm != m_checksumAlgorithm && algorithm >= 0
+      && algorithm < CHECKSUM_ALGORITHM_COUNT)
+  {
+    m_checksumAlgorithm = algorithm;
+    Q_EMIT checksumAlgorithmChanged();
+  }
+}
+
+/**
+ * Changes the location of the checksum relative to the finish sequence.
+ */
+void Project::Model::setChecksumPlacement(const int placement)
+{
+  if (placement != m_checksumPlacement && placement >= 0
+      && placement < CHECKSUM_PLACEMENT_COUNT)
+  {
+    m_checksumPlacement = placement;
+    Q_EMIT checksumPlacementChanged();
+  }
+}
+
+/**
+ * Changes the encoding of the checksum (raw bytes or ASCII hexadecimal).
+ */
+void Project::Model::setChecksumEncoding(const int encoding)
+{
+  if (encoding != m_checksumEncoding && encoding >= 0
+      && encoding < CHECKSUM_ENCODING_COUNT)
+  {
+    m_checksumEncoding = encoding;
+    Q_EMIT checksumEncodingChanged();
+  }
+}
+
+/**
+ * Changes the data separator sequence of the JSON project file.
+ */
+void Project::Model::setSeparator(const QString &separator)
+{
+  if (separator != m_separator)
   {
     m_separator = separator;
     Q_EMIT separatorChanged();
@@ -815,6 +1499,136 @@ void Project::Model::setFrameParserCode(const QString &code)
   }
 }
 
+/**
+ * Changes the number of generated frames that are merged into each frame
+ * published to the live consumers, invalid factors are rejected & the user
+ * is notified.
+ */
+void Project::Model::setDecimation(const int factor)
+{
+  // Validate the factor
+  QString error;
+  if (!JSON::Decimator::validate(factor, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid decimation factor"), error);
+    return;
+  }
+
+  // Update internal model
+  const auto value = qMax(1, factor);
+  if (m_decimation != value)
+  {
+    m_decimation = value;
+    Q_EMIT decimationChanged();
+  }
+}
+
+/**
+ * Updates the binary layout used to decode incoming frames natively. The
+ * layout is only applied if it can be compiled by @c JSON::BinaryDecoder,
+ * otherwise the user is notified & @c false is returned.
+ */
+bool Project::Model::setBinaryLayout(const QJsonArray &layout)
+{
+  // Validate the layout
+  QString error;
+  JSON::BinaryDecoder decoder;
+  if (!decoder.compile(layout, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid binary layout"), error);
+    return false;
+  }
+
+  // Update internal model
+  if (layout != m_binaryLayout)
+  {
+    m_binaryLayout = layout;
+    Q_EMIT binaryLayoutChanged();
+  }
+
+  return true;
+}
+
+/**
+ * Updates the configuration used to route multiplexed frame types to their
+ * groups. The configuration is only applied if it is valid (see
+ * @c JSON::FrameRouter), otherwise the user is notified & @c false is
+ * returned.
+ */
+bool Project::Model::setFrameRouting(const QJsonObject &routing)
+{
+  // Validate the configuration
+  QString error;
+  if (!JSON::FrameRouter::validate(routing, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid frame routing"), error);
+    return false;
+  }
+
+  // Update internal model
+  if (routing != m_frameRouting)
+  {
+    m_frameRouting = routing;
+    Q_EMIT frameRoutingChanged();
+  }
+
+  return true;
+}
+
+/**
+ * Updates the configuration of the native NMEA 0183 decoder. The
+ * configuration is only applied if it is valid (see @c JSON::NmeaDecoder),
+ * otherwise the user is notified & @c false is returned.
+ */
+bool Project::Model::setNmea(const QJsonValue &config)
+{
+  // Validate the configuration
+  QString error;
+  JSON::NmeaDecoder decoder;
+  if (!decoder.compile(config, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid NMEA configuration"), error);
+    return false;
+  }
+
+  // Update internal model
+  if (config != m_nmea)
+  {
+    m_nmea = config;
+    Q_EMIT nmeaChanged();
+  }
+
+  return true;
+}
+
+/**
+ * Updates the configuration of the WebAssembly frame parser. The
+ * configuration is only applied if it is valid (see @c JSON::WasmDecoder),
+ * otherwise the user is notified & @c false is returned. The module itself
+ * is read when the project is loaded by the JSON generator.
+ */
+bool Project::Model::setWasm(const QJsonValue &config)
+{
+  // Validate the configuration
+  QString error;
+  JSON::WasmDecoder decoder;
+  if (!decoder.compile(config, m_filePath, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid WebAssembly configuration"),
+                                    error);
+    return false;
+  }
+
+  // Update internal model
+  if (config != m_wasm)
+  {
+    m_wasm = config;
+    Q_EMIT wasmChanged();
+  }
+
+  return true;
+}
+
 /**
  * Changes the frame end sequence of the JSON project file.
  */
@@ -847,7 +1661,7 @@ void Project::Model::addGroup()
   m_groups.append(JSON::Group());
   setGroupTitle(m_groups.count() - 1, tr("New Group"));
 
-  Q_EMIT groupCountChanged();
+  notifyGroupCountChanged();
 }
 
 /**
@@ -864,7 +1678,8 @@ void Project::Model::deleteGroup(const int group)
   if (ret == QMessageBox::Yes)
   {
     m_groups.removeAt(group);
-    Q_EMIT groupCountChanged();
+    rebuildIndex();
+    notifyGroupCountChanged();
   }
 }
 
@@ -876,7 +1691,8 @@ void Project::Model::moveGroupUp(const int group)
   if (group > 0)
   {
     m_groups.move(group, group - 1);
-    Q_EMIT groupOrderChanged();
+    rebuildIndex();
+    notifyGroupOrderChanged();
   }
 }
 
@@ -888,7 +1704,8 @@ void Project::Model::moveGroupDown(const int group)
   if (group < groupCount() - 1)
   {
     m_groups.move(group, group + 1);
-    Q_EMIT groupOrderChanged();
+    rebuildIndex();
+    notifyGroupOrderChanged();
   }
 }
 
@@ -902,9 +1719,10 @@ bool Project::Model::setGroupWidget(const int group, const int widgetId)
   auto grp = getGroup(group);
 
   // Warn user if group contains existing datasets
-  if (!(grp.m_datasets.isEmpty()) && widgetId != 4)
+  if (!(grp.m_datasets.isEmpty()) && widgetId != 4 && widgetId != 5)
   {
-    if (widgetId == 0 && grp.widget() == "multiplot")
+    if (widgetId == 0
+        && (grp.widget() == "multiplot" || grp.widget() == "stats"))
       grp.m_widget = "";
 
     else
@@ -1026,11 +1844,52 @@ bool Project::Model::setGroupWidget(const int group, const int widgetId)
   else if (widgetId == 4)
     grp.m_widget = "multiplot";
 
+  // Statistics widget
+  else if (widgetId == 5)
+    grp.m_widget = "stats";
+
+  // XY plot widget
+  else if (widgetId == 6)
+  {
+    // Set widget title
+    grp.m_widget = "xy";
+    grp.m_title = tr("XY plot");
+
+    // Create datasets
+    JSON::Dataset x, y;
+
+    // Set dataset indexes
+    x.m_index = nextDatasetIndex();
+    y.m_index = nextDatasetIndex() + 1;
+
+    // Set dataset properties
+    x.m_widget = "x";
+    y.m_widget = "y";
+    x.m_title = tr("X");
+    y.m_title = tr("Y");
+
+    // Add datasets to group
+    grp.m_datasets.append(x);
+    grp.m_datasets.append(y);
+  }
+
+  // Heatmap widget
+  else if (widgetId == 7)
+  {
+    // Set widget title
+    grp.m_widget = "heatmap";
+    grp.m_title = tr("Heatmap");
+
+    // Create an 8x8 matrix of datasets
+    buildMatrix(grp, 8, 8, nextDatasetIndex());
+  }
+
   // Replace previous group with new group
   m_groups.replace(group, grp);
+  rebuildIndex();
 
   // Update UI
-  Q_EMIT groupChanged(group);
+  notifyGroupChanged(group);
   return true;
 }
 
@@ -1039,15 +1898,67 @@ bool Project::Model::setGroupWidget(const int group, const int widgetId)
  */
 void Project::Model::setGroupTitle(const int group, const QString &title)
 {
-  // Get group
-  auto grp = getGroup(group);
+  // Validate group index
+  if (group < 0 || group >= m_groups.count())
+    return;
 
-  // Change group values & update groups vector
-  grp.m_title = title;
-  m_groups.replace(group, grp);
+  // Change group values
+  m_groups[group].m_title = title;
+
+  // Update UI
+  notifyGroupChanged(group);
+}
+
+/**
+ * Changes the identifier of the frame type that feeds the given @a group,
+ * an empty identifier means that the group is not fed by routed frames.
+ */
+void Project::Model::setGroupFrameId(const int group, const QString &id)
+{
+  // Validate group index
+  if (group < 0 || group >= m_groups.count())
+    return;
+
+  // Change group values
+  m_groups[group].m_frameId = id.trimmed();
 
   // Update UI
-  Q_EMIT groupChanged(group);
+  notifyGroupChanged(group);
+}
+
+/**
+ * Changes the size of the matrix displayed by the given heatmap @a group.
+ *
+ * The datasets of the group are replaced by @a rows × @a columns datasets
+ * that read consecutive fields of the frame, starting at @a frameIndex. The
+ * range (min/max) of the first dataset is kept for the new datasets.
+ */
+void Project::Model::setGroupMatrix(const int group, const int rows,
+                                    const int columns, const int frameIndex)
+{
+  // Validate group index
+  if (group < 0 || group >= m_groups.count())
+    return;
+
+  // Only heatmap groups are arranged in a matrix
+  auto &grp = m_groups[group];
+  if (grp.m_widget != "heatmap")
+    return;
+
+  // Skip if the matrix did not change
+  const int r = qBound(1, rows, MAX_MATRIX_SIZE);
+  const int c = qBound(1, columns, MAX_MATRIX_SIZE);
+  const int index = qMax(1, frameIndex);
+  if (grp.m_columns == c && grp.m_datasets.count() == r * c
+      && grp.m_datasets.first().m_index == index)
+    return;
+
+  // Re-create datasets
+  buildMatrix(grp, r, c, index);
+  rebuildIndex();
+
+  // Update UI
+  notifyGroupChanged(group);
 }
 
 /**
@@ -1055,15 +1966,15 @@ void Project::Model::setGroupTitle(const int group, const QString &title)
  */
 void Project::Model::setGroupWidgetData(const int group, const QString &widget)
 {
-  // Get group
-  auto grp = getGroup(group);
+  // Validate group index
+  if (group < 0 || group >= m_groups.count())
+    return;
 
-  // Change group values & update groups vector
-  grp.m_widget = widget;
-  m_groups.replace(group, grp);
+  // Change group values
+  m_groups[group].m_widget = widget;
 
   // Update UI
-  Q_EMIT groupChanged(group);
+  notifyGroupChanged(group);
 }
 
 /**
@@ -1073,19 +1984,95 @@ void Project::Model::setGroupWidgetData(const int group, const QString &widget)
  */
 void Project::Model::addDataset(const int group)
 {
-  // Get group
-  auto grp = getGroup(group);
+  // Validate group index
+  if (group < 0 || group >= m_groups.count())
+    return;
 
-  // Change group values & update groups vector
-  grp.m_datasets.append(JSON::Dataset());
-  m_groups.replace(group, grp);
+  // Register the new dataset with the group & the lookup tables
+  const int dataset = m_groups[group].m_datasets.count();
+  m_groups[group].m_datasets.append(JSON::Dataset());
+  m_fieldIndex.insert(0, DatasetSlot(group, dataset));
+  m_titleIndex.insert(QString(), DatasetSlot(group, dataset));
 
   // Set dataset title & index
-  setDatasetIndex(group, grp.m_datasets.count() - 1, nextDatasetIndex());
-  setDatasetTitle(group, grp.m_datasets.count() - 1, tr("New dataset"));
+  setDatasetIndex(group, dataset, nextDatasetIndex());
+  setDatasetTitle(group, dataset, tr("New dataset"));
+
+  // Update UI
+  notifyGroupChanged(group);
+}
+
+/**
+ * Adds @a count new datasets to the given @a group, each one reading the next
+ * unused frame index. The editor is only updated once.
+ */
+void Project::Model::addDatasets(const int group, const int count)
+{
+  // Validate arguments
+  if (group < 0 || group >= m_groups.count() || count <= 0)
+    return;
+
+  // Register the datasets
+  beginEdit();
+  m_groups[group].m_datasets.reserve(datasetCount(group) + count);
+  for (int i = 0; i < count; ++i)
+    addDataset(group);
+
+  // Update UI
+  endEdit();
+}
+
+/**
+ * Appends the groups (and their datasets) described by the given JSON
+ * @a groups array, which uses the same format as the "groups" array of a
+ * project file. The lookup tables are rebuilt & the editor is updated once.
+ *
+ * @returns the number of imported groups
+ */
+int Project::Model::importGroups(const QJsonArray &groups)
+{
+  // Nothing to import
+  if (groups.isEmpty())
+    return 0;
+
+  // Register the groups
+  m_groups.reserve(m_groups.count() + groups.count());
+  for (int g = 0; g < groups.count(); ++g)
+    m_groups.append(readGroup(groups.at(g).toObject()));
+
+  // Build dataset lookup tables & update UI
+  rebuildIndex();
+  notifyGroupCountChanged();
+  return groups.count();
+}
+
+/**
+ * Appends the datasets described by the given JSON @a datasets array (which
+ * uses the same format as the "datasets" array of a project group) to the
+ * given @a group. The editor is only updated once.
+ *
+ * @returns the number of imported datasets
+ */
+int Project::Model::importDatasets(const int group, const QJsonArray &datasets)
+{
+  // Validate arguments
+  if (group < 0 || group >= m_groups.count() || datasets.isEmpty())
+    return 0;
+
+  // Register the datasets & their lookup table entries
+  auto &list = m_groups[group].m_datasets;
+  list.reserve(list.count() + datasets.count());
+  for (int d = 0; d < datasets.count(); ++d)
+  {
+    const DatasetSlot slot(group, list.count());
+    list.append(readDataset(datasets.at(d).toObject()));
+    m_fieldIndex.insert(list.last().m_index, slot);
+    m_titleIndex.insert(list.last().m_title, slot);
+  }
 
   // Update UI
-  Q_EMIT groupChanged(group);
+  notifyGroupChanged(group);
+  return datasets.count();
 }
 
 /**
@@ -1103,10 +2090,12 @@ void Project::Model::deleteDataset(const int group, const int dataset)
 
   if (ret == QMessageBox::Yes)
   {
-    auto grp = getGroup(group);
-    grp.m_datasets.removeAt(dataset);
-    m_groups.replace(group, grp);
-    Q_EMIT groupChanged(group);
+    if (!editableDataset(group, dataset))
+      return;
+
+    m_groups[group].m_datasets.removeAt(dataset);
+    rebuildIndex();
+    notifyGroupChanged(group);
   }
 }
 
@@ -1119,19 +2108,21 @@ void Project::Model::deleteDataset(const int group, const int dataset)
 void Project::Model::setDatasetTitle(const int group, const int dataset,
                                      const QString &title)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_title != title)
+  // Update dataset
+  if (set->m_title != title)
   {
-    set.m_title = title;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    const DatasetSlot slot(group, dataset);
+    m_titleIndex.remove(set->m_title, slot);
+    m_titleIndex.insert(title, slot);
+    set->m_title = title;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1144,19 +2135,18 @@ void Project::Model::setDatasetTitle(const int group, const int dataset,
 void Project::Model::setDatasetUnits(const int group, const int dataset,
                                      const QString &units)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_units != units)
+  // Update dataset
+  if (set->m_units != units)
   {
-    set.m_units = units;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_units = units;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1169,19 +2159,21 @@ void Project::Model::setDatasetUnits(const int group, const int dataset,
 void Project::Model::setDatasetIndex(const int group, const int dataset,
                                      const int frameIndex)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_index != frameIndex)
+  // Update dataset
+  if (set->m_index != frameIndex)
   {
-    set.m_index = frameIndex;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    const DatasetSlot slot(group, dataset);
+    m_fieldIndex.remove(set->m_index, slot);
+    m_fieldIndex.insert(frameIndex, slot);
+    set->m_index = frameIndex;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1194,19 +2186,18 @@ void Project::Model::setDatasetIndex(const int group, const int dataset,
 void Project::Model::setDatasetLED(const int group, const int dataset,
                                    const bool generateLED)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_led != generateLED)
+  // Update dataset
+  if (set->m_led != generateLED)
   {
-    set.m_led = generateLED;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_led = generateLED;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1219,19 +2210,18 @@ void Project::Model::setDatasetLED(const int group, const int dataset,
 void Project::Model::setDatasetGraph(const int group, const int dataset,
                                      const bool generateGraph)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_graph != generateGraph)
+  // Update dataset
+  if (set->m_graph != generateGraph)
   {
-    set.m_graph = generateGraph;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_graph = generateGraph;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1244,19 +2234,18 @@ void Project::Model::setDatasetGraph(const int group, const int dataset,
 void Project::Model::setDatasetFftPlot(const int group, const int dataset,
                                        const bool generateFft)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_fft != generateFft)
+  // Update dataset
+  if (set->m_fft != generateFft)
   {
-    set.m_fft = generateFft;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_fft = generateFft;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1269,19 +2258,18 @@ void Project::Model::setDatasetFftPlot(const int group, const int dataset,
 void Project::Model::setDatasetLogPlot(const int group, const int dataset,
                                        const bool generateLog)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_log != generateLog)
+  // Update dataset
+  if (set->m_log != generateLog)
   {
-    set.m_log = generateLog;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_log = generateLog;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1296,9 +2284,10 @@ void Project::Model::setDatasetLogPlot(const int group, const int dataset,
 void Project::Model::setDatasetWidget(const int group, const int dataset,
                                       const int widgetId)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
   // Get widget string
   QString widget;
@@ -1307,21 +2296,24 @@ void Project::Model::setDatasetWidget(const int group, const int dataset,
   else if (widgetId == 2)
     widget = "bar";
   else if (widgetId == 3)
-  {
     widget = "compass";
-    set.m_min = 0;
-    set.m_max = 360;
-  }
+  else if (widgetId == 4)
+    widget = "waterfall";
+  else if (widgetId == 5)
+    widget = "histogram";
 
-  // Update dataset & group
-  if (set.m_widget != widget)
+  // Update dataset, compass widgets always use a 0-360 range
+  if (set->m_widget != widget)
   {
-    set.m_widget = widget;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_widget = widget;
+    if (widgetId == 3)
+    {
+      set->m_min = 0;
+      set->m_max = 360;
+    }
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1336,19 +2328,18 @@ void Project::Model::setDatasetWidget(const int group, const int dataset,
 void Project::Model::setDatasetWidgetMin(const int group, const int dataset,
                                          const QString &minimum)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_min != minimum.toDouble())
+  // Update dataset
+  if (set->m_min != minimum.toDouble())
   {
-    set.m_min = minimum.toDouble();
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_min = minimum.toDouble();
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1363,19 +2354,18 @@ void Project::Model::setDatasetWidgetMin(const int group, const int dataset,
 void Project::Model::setDatasetWidgetMax(const int group, const int dataset,
                                          const QString &maximum)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_max != maximum.toDouble())
+  // Update dataset
+  if (set->m_max != maximum.toDouble())
   {
-    set.m_max = maximum.toDouble();
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_max = maximum.toDouble();
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1388,19 +2378,18 @@ void Project::Model::setDatasetWidgetMax(const int group, const int dataset,
 void Project::Model::setDatasetWidgetData(const int group, const int dataset,
                                           const QString &widget)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_widget != widget)
+  // Update dataset
+  if (set->m_widget != widget)
   {
-    set.m_widget = widget;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_widget = widget;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1415,19 +2404,18 @@ void Project::Model::setDatasetWidgetData(const int group, const int dataset,
 void Project::Model::setDatasetWidgetAlarm(const int group, const int dataset,
                                            const QString &alarm)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
-  // Update dataset & group
-  if (set.m_alarm != alarm.toDouble())
+  // Update dataset
+  if (set->m_alarm != alarm.toDouble())
   {
-    set.m_alarm = alarm.toDouble();
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_alarm = alarm.toDouble();
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1440,24 +2428,252 @@ void Project::Model::setDatasetWidgetAlarm(const int group, const int dataset,
 void Project::Model::setDatasetFFTSamples(const int group, const int dataset,
                                           const QString &samples)
 {
-  // Get dataset & group
-  auto grp = getGroup(group);
-  auto set = getDataset(group, dataset);
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
 
   // Validate FFT samples
   auto sample = samples.toInt();
   if (sample < 128)
     sample = 128;
 
-  // Update dataset & group
-  if (set.m_fftSamples != sample)
+  // Update dataset
+  if (set->m_fftSamples != sample)
   {
-    set.m_fftSamples = sample;
-    grp.m_datasets.replace(dataset, set);
-    m_groups.replace(group, grp);
+    set->m_fftSamples = sample;
 
     // Update UI
-    Q_EMIT datasetChanged(group, dataset);
+    notifyDatasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the number of @a points kept in the plot history of the given
+ * @a dataset, zero (or an empty string) uses the number of points selected
+ * in the dashboard.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetPoints(const int group, const int dataset,
+                                      const QString &points)
+{
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
+
+  // Validate number of points
+  const auto value = qBound(0, points.toInt(), 1000 * 1000);
+
+  // Update dataset
+  if (set->m_points != value)
+  {
+    set->m_points = value;
+
+    // Update UI
+    notifyDatasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Marks the given @a dataset as a frame counter with the given width (in
+ * @a bits), which is used to detect lost, duplicated & reordered frames. Zero
+ * (or an empty string) means that the dataset is not a sequence counter.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetSequenceBits(const int group,
+                                            const int dataset,
+                                            const QString &bits)
+{
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
+
+  // Validate counter width
+  const auto value = qBound(0, bits.toInt(), 64);
+
+  // Update dataset
+  if (set->m_sequenceBits != value)
+  {
+    set->m_sequenceBits = value;
+
+    // Update UI
+    notifyDatasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the @a calibration used to convert the raw values of the given
+ * @a dataset to engineering units (see @c JSON::Calibration). Invalid
+ * calibrations are rejected & the user is notified.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetCalibration(const int group, const int dataset,
+                                           const QJsonObject &calibration)
+{
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
+
+  // Validate calibration
+  QString error;
+  if (!JSON::Calibration::validate(calibration, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid calibration"), error);
+    return;
+  }
+
+  // Update dataset
+  if (set->m_calibration != calibration)
+  {
+    set->m_calibration = calibration;
+
+    // Update UI
+    notifyDatasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Changes the @a expression used to compute the value of the given
+ * @a dataset from the values of other datasets (see @c JSON::Expression).
+ * Dataset references are resolved when the project is loaded by the JSON
+ * generator.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetExpression(const int group, const int dataset,
+                                          const QString &expression)
+{
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
+
+  // Update dataset
+  const auto text = expression.trimmed();
+  if (set->m_expression != text)
+  {
+    set->m_expression = text;
+
+    // Update UI
+    notifyDatasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the alarm @a rules of the given @a dataset (high & low limits, rate
+ * of change, hysteresis & debounce time). Rules are compiled by the JSON
+ * generator when the project is loaded, invalid rules are rejected & the user
+ * is notified.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetAlarmRules(const int group, const int dataset,
+                                          const QJsonObject &rules)
+{
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
+
+  // Validate alarm rules
+  QString error;
+  if (!JSON::AlarmEngine::validate(rules, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid alarm rules"), error);
+    return;
+  }
+
+  // Update dataset
+  if (set->m_alarmRules != rules)
+  {
+    set->m_alarmRules = rules;
+
+    // Update UI
+    notifyDatasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the decimation @a policy of the given @a dataset, which selects the
+ * value published for the dataset when frames are decimated (last, mean, min
+ * or max). Unknown policies are rejected & the user is notified.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetDecimation(const int group, const int dataset,
+                                          const QString &policy)
+{
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
+
+  // Validate policy
+  QString error;
+  auto name = policy.trimmed().toLower();
+  if (!JSON::Decimator::validate(name, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid decimation policy"), error);
+    return;
+  }
+
+  // The default policy is not stored in the project
+  if (name == QStringLiteral("last"))
+    name.clear();
+
+  // Update dataset
+  if (set->m_decimation != name)
+  {
+    set->m_decimation = name;
+
+    // Update UI
+    notifyDatasetChanged(group, dataset);
+  }
+}
+
+/**
+ * Updates the Modbus register @a mapping of the given @a dataset, which is
+ * polled by the Modbus driver to obtain the value of the dataset. Invalid
+ * mappings are rejected & the user is notified.
+ *
+ * @param group   index of the group in which the dataset belongs
+ * @param dataset index of the dataset
+ */
+void Project::Model::setDatasetModbus(const int group, const int dataset,
+                                      const QJsonObject &mapping)
+{
+  // Get dataset
+  auto set = editableDataset(group, dataset);
+  if (!set)
+    return;
+
+  // Validate mapping
+  QString error;
+  if (!IO::ModbusScheduler::validate(mapping, &error))
+  {
+    Misc::Utilities::showMessageBox(tr("Invalid Modbus register"), error);
+    return;
+  }
+
+  // Update dataset
+  if (set->m_modbus != mapping)
+  {
+    set->m_modbus = mapping;
+
+    // Update UI
+    notifyDatasetChanged(group, dataset);
   }
 }
 
@@ -1482,6 +2698,58 @@ void Project::Model::onJsonLoaded()
     openJsonFile(JSON::Generator::instance().jsonMapFilepath());
 }
 
+/**
+ * Starts an edit transaction. Until the matching call to @c endEdit(), the
+ * group & dataset change signals are not emitted, so that editing many
+ * datasets (e.g. from a script or an importer) does not rebuild the project
+ * editor after every change. Transactions can be nested.
+ */
+void Project::Model::beginEdit()
+{
+  ++m_editDepth;
+}
+
+/**
+ * Finishes an edit transaction & emits a single consolidated update for all
+ * the changes made since the outermost @c beginEdit() call. If groups were
+ * added or removed, only @c groupCountChanged() is emitted, since it already
+ * causes the editor to rebuild all its views.
+ */
+void Project::Model::endEdit()
+{
+  // Transaction not open or nested
+  if (m_editDepth <= 0 || --m_editDepth > 0)
+    return;
+
+  // Take the pending changes
+  const auto groupCount = m_pendingGroupCount;
+  const auto groupOrder = m_pendingGroupOrder;
+  const auto dataset = m_pendingDataset;
+  auto groups = m_pendingGroups.values();
+  m_pendingGroupCount = false;
+  m_pendingGroupOrder = false;
+  m_pendingDataset = DatasetSlot(-1, -1);
+  m_pendingGroups.clear();
+
+  // Structure changed, rebuild everything
+  if (groupCount)
+  {
+    Q_EMIT groupCountChanged();
+    return;
+  }
+
+  // Notify the changes of each group
+  if (groupOrder)
+    Q_EMIT groupOrderChanged();
+
+  std::sort(groups.begin(), groups.end());
+  for (const auto group : groups)
+    Q_EMIT groupChanged(group);
+
+  if (dataset.first >= 0)
+    Q_EMIT datasetChanged(dataset.first, dataset.second);
+}
+
 /**
  * Sets the modified flag to @c true when the user adds/removes/moves
  * one of the groups contained in the JSON project.
@@ -1524,16 +2792,182 @@ void Project::Model::onDatasetChanged(const int group, const int dataset)
  */
 int Project::Model::nextDatasetIndex()
 {
-  int maxIndex = 1;
-  for (int i = 0; i < groupCount(); ++i)
+  if (m_fieldIndex.isEmpty())
+    return 1;
+
+  return qMax(1, m_fieldIndex.lastKey() + 1);
+}
+
+/**
+ * Replaces the datasets of the given heatmap @a group with a matrix of
+ * @a rows × @a columns datasets, which read consecutive frame fields starting
+ * at @a frameIndex. The range of the previous first dataset is preserved.
+ */
+void Project::Model::buildMatrix(JSON::Group &group, const int rows,
+                                 const int columns, const int frameIndex)
+{
+  // Keep the range of the matrix
+  JSON::Dataset cell;
+  if (!group.m_datasets.isEmpty())
   {
-    for (int j = 0; j < datasetCount(i); ++j)
+    cell.m_min = group.m_datasets.first().m_min;
+    cell.m_max = group.m_datasets.first().m_max;
+  }
+
+  // Create one dataset per cell, in row-major order
+  group.m_columns = columns;
+  group.m_datasets.clear();
+  group.m_datasets.reserve(rows * columns);
+  for (int r = 0; r < rows; ++r)
+  {
+    for (int c = 0; c < columns; ++c)
     {
-      auto dataset = getDataset(i, j);
-      if (dataset.m_index >= maxIndex)
-        maxIndex = dataset.m_index + 1;
+      cell.m_index = frameIndex + r * columns + c;
+      cell.m_title = tr("Cell %1,%2").arg(r + 1).arg(c + 1);
+      group.m_datasets.append(cell);
     }
   }
+}
+
+/**
+ * Rebuilds the frame index & title lookup tables from scratch.
+ *
+ * This function must be called whenever datasets are added, removed or
+ * moved to another position, since the lookup tables store the location
+ * of each dataset in the model.
+ */
+void Project::Model::rebuildIndex()
+{
+  m_fieldIndex.clear();
+  m_titleIndex.clear();
+
+  for (int i = 0; i < m_groups.count(); ++i)
+  {
+    const auto &datasets = m_groups.at(i).m_datasets;
+    for (int j = 0; j < datasets.count(); ++j)
+    {
+      const DatasetSlot slot(i, j);
+      m_fieldIndex.insert(datasets.at(j).m_index, slot);
+      m_titleIndex.insert(datasets.at(j).m_title, slot);
+    }
+  }
+}
+
+/**
+ * Emits @c groupCountChanged(), or defers it until the current edit
+ * transaction is finished.
+ */
+void Project::Model::notifyGroupCountChanged()
+{
+  if (m_editDepth > 0)
+    m_pendingGroupCount = true;
+  else
+    Q_EMIT groupCountChanged();
+}
+
+/**
+ * Emits @c groupOrderChanged(), or defers it until the current edit
+ * transaction is finished.
+ */
+void Project::Model::notifyGroupOrderChanged()
+{
+  if (m_editDepth > 0)
+    m_pendingGroupOrder = true;
+  else
+    Q_EMIT groupOrderChanged();
+}
+
+/**
+ * Emits @c groupChanged() for the given @a group, or defers it until the
+ * current edit transaction is finished.
+ */
+void Project::Model::notifyGroupChanged(const int group)
+{
+  if (m_editDepth > 0)
+    m_pendingGroups.insert(group);
+  else
+    Q_EMIT groupChanged(group);
+}
 
-  return maxIndex;
+/**
+ * Emits @c datasetChanged() for the given @a dataset, or defers it until the
+ * current edit transaction is finished (only one signal is emitted for all
+ * the datasets modified in the transaction).
+ */
+void Project::Model::notifyDatasetChanged(const int group, const int dataset)
+{
+  if (m_editDepth > 0)
+    m_pendingDataset = DatasetSlot(group, dataset);
+  else
+    Q_EMIT datasetChanged(group, dataset);
 }
+
+/**
+ * Builds a group (and its datasets) from the given JSON @a object. The group
+ * is built directly instead of using the setter functions, so that no UI
+ * signals are emitted for every property of every dataset.
+ */
+JSON::Group Project::Model::readGroup(const QJsonObject &object) const
+{
+  // Create group
+  JSON::Group group;
+  group.m_title = object.value("title").toString();
+  group.m_widget = object.value("widget").toString();
+  group.m_frameId = object.value("frameId").toString();
+  group.m_columns = qMax(0, object.value("columns").toInt());
+
+  // Register group datasets
+  const auto datasets = object.value("datasets").toArray();
+  group.m_datasets.reserve(datasets.count());
+  for (int d = 0; d < datasets.count(); ++d)
+    group.m_datasets.append(readDataset(datasets.at(d).toObject()));
+
+  return group;
+}
+
+/**
+ * Builds a dataset from the given JSON @a object.
+ */
+JSON::Dataset Project::Model::readDataset(const QJsonObject &object) const
+{
+  JSON::Dataset dataset;
+  dataset.m_led = object.value("led").toBool();
+  dataset.m_fft = object.value("fft").toBool();
+  dataset.m_log = object.value("log").toBool();
+  dataset.m_graph = object.value("graph").toBool();
+  dataset.m_title = object.value("title").toString();
+  dataset.m_units = object.value("units").toString();
+  dataset.m_widget = object.value("widget").toString();
+  dataset.m_min = object.value("min").toDouble();
+  dataset.m_max = object.value("max").toDouble();
+  dataset.m_index = object.value("index").toInt();
+  dataset.m_alarm = object.value("alarm").toDouble();
+  dataset.m_fftSamples = qMax(128, object.value("fftSamples").toInt());
+  dataset.m_points = qMax(0, object.value("points").toInt());
+  dataset.m_sequenceBits
+      = qBound(0, object.value("sequenceBits").toInt(), 64);
+  dataset.m_calibration = object.value("calibration").toObject();
+  dataset.m_expression = object.value("expression").toString();
+  dataset.m_alarmRules = object.value("alarmRules").toObject();
+  dataset.m_decimation = object.value("decimation").toString();
+  dataset.m_modbus = object.value("modbus").toObject();
+  return dataset;
+}
+
+/**
+ * Returns a pointer to the given @a dataset of the given @a group, which can
+ * be modified in place, or @c Q_NULLPTR if any of the indexes is invalid.
+ */
+JSON::Dataset *Project::Model::editableDataset(const int group,
+                                               const int dataset)
+{
+  if (group < 0 || group >= m_groups.count())
+    return Q_NULLPTR;
+
+  auto &datasets = m_groups[group].m_datasets;
+  if (dataset < 0 || dataset >= datasets.count())
+    return Q_NULLPTR;
+
+  return &datasets[dataset];
+}
+
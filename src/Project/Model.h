@@ -22,13 +22,25 @@
 
 #pragma once
 
+#include <QPair>
 #include <QObject>
+#include <QJsonValue>
+#include <QJsonArray>
+#include <QMultiMap>
+#include <QSet>
+#include <QMultiHash>
 #include <DataTypes.h>
 #include <JSON/Group.h>
 #include <JSON/Dataset.h>
 
 namespace Project
 {
+/**
+ * Location of a dataset in the project model, expressed as a pair of
+ * (group index, dataset index).
+ */
+typedef QPair<int, int> DatasetSlot;
+
 /**
  * @brief The Model class
  *
@@ -64,6 +76,38 @@ class Model : public QObject
                READ frameStartSequence
                WRITE setFrameStartSequence
                NOTIFY frameStartSequenceChanged)
+    Q_PROPERTY(int framingMode
+               READ framingMode
+               WRITE setFramingMode
+               NOTIFY framingModeChanged)
+    Q_PROPERTY(int compression
+               READ compression
+               WRITE setCompression
+               NOTIFY compressionChanged)
+    Q_PROPERTY(int heatshrinkWindow
+               READ heatshrinkWindow
+               WRITE setHeatshrinkWindow
+               NOTIFY compressionChanged)
+    Q_PROPERTY(int heatshrinkLookahead
+               READ heatshrinkLookahead
+               WRITE setHeatshrinkLookahead
+               NOTIFY compressionChanged)
+    Q_PROPERTY(int checksumAlgorithm
+               READ checksumAlgorithm
+               WRITE setChecksumAlgorithm
+               NOTIFY checksumAlgorithmChanged)
+    Q_PROPERTY(int checksumPlacement
+               READ checksumPlacement
+               WRITE setChecksumPlacement
+               NOTIFY checksumPlacementChanged)
+    Q_PROPERTY(int checksumEncoding
+               READ checksumEncoding
+               WRITE setChecksumEncoding
+               NOTIFY checksumEncodingChanged)
+    Q_PROPERTY(int decimation
+               READ decimation
+               WRITE setDecimation
+               NOTIFY decimationChanged)
     Q_PROPERTY(QString jsonFilePath
                READ jsonFilePath
                NOTIFY jsonFileChanged)
@@ -79,7 +123,17 @@ Q_SIGNALS:
   void separatorChanged();
   void groupCountChanged();
   void groupOrderChanged();
+  void framingModeChanged();
+  void compressionChanged();
+  void checksumAlgorithmChanged();
+  void checksumPlacementChanged();
+  void checksumEncodingChanged();
+  void decimationChanged();
   void frameParserCodeChanged();
+  void binaryLayoutChanged();
+  void frameRoutingChanged();
+  void nmeaChanged();
+  void wasmChanged();
   void frameEndSequenceChanged();
   void frameStartSequenceChanged();
   void groupChanged(const int group);
@@ -97,6 +151,11 @@ public:
 
   Q_INVOKABLE StringList availableGroupLevelWidgets();
   Q_INVOKABLE StringList availableDatasetLevelWidgets();
+  Q_INVOKABLE StringList availableFramingModes();
+  Q_INVOKABLE StringList availableCompressionModes();
+  Q_INVOKABLE StringList availableChecksumAlgorithms();
+  Q_INVOKABLE StringList availableChecksumPlacements();
+  Q_INVOKABLE StringList availableChecksumEncodings();
 
   QString jsonProjectsPath() const;
 
@@ -105,6 +164,14 @@ public:
   QString frameEndSequence() const;
   QString frameStartSequence() const;
 
+  int framingMode() const;
+  int compression() const;
+  int heatshrinkWindow() const;
+  int heatshrinkLookahead() const;
+  int checksumAlgorithm() const;
+  int checksumPlacement() const;
+  int checksumEncoding() const;
+  int decimation() const;
   bool modified() const;
   int groupCount() const;
   QString jsonFilePath() const;
@@ -119,9 +186,16 @@ public:
                                               const int index) const;
 
   Q_INVOKABLE QString frameParserCode() const;
+  QJsonArray binaryLayout() const;
+  QJsonObject frameRouting() const;
+  QJsonValue nmea() const;
+  QJsonValue wasm() const;
   Q_INVOKABLE QString groupTitle(const int group) const;
   Q_INVOKABLE QString groupWidget(const int group) const;
+  Q_INVOKABLE QString groupFrameId(const int group) const;
   Q_INVOKABLE int groupWidgetIndex(const int group) const;
+  Q_INVOKABLE int groupRows(const int group) const;
+  Q_INVOKABLE int groupColumns(const int group) const;
   Q_INVOKABLE int datasetIndex(const int group, const int dataset) const;
   Q_INVOKABLE bool datasetLED(const int group, const int dataset) const;
   Q_INVOKABLE bool datasetGraph(const int group, const int dataset) const;
@@ -137,19 +211,51 @@ public:
                                        const int dataset) const;
   Q_INVOKABLE QString datasetFFTSamples(const int group,
                                         const int dataset) const;
+  Q_INVOKABLE QString datasetPoints(const int group, const int dataset) const;
+  Q_INVOKABLE QString datasetSequenceBits(const int group,
+                                          const int dataset) const;
   Q_INVOKABLE QString datasetWidgetAlarm(const int group,
                                          const int dataset) const;
+  Q_INVOKABLE QJsonObject datasetCalibration(const int group,
+                                             const int dataset) const;
+  Q_INVOKABLE QString datasetExpression(const int group,
+                                        const int dataset) const;
+  Q_INVOKABLE QJsonObject datasetAlarmRules(const int group,
+                                            const int dataset) const;
+  Q_INVOKABLE QString datasetDecimation(const int group,
+                                        const int dataset) const;
+  Q_INVOKABLE QJsonObject datasetModbus(const int group,
+                                        const int dataset) const;
 
   Q_INVOKABLE bool setGroupWidget(const int group, const int widgetId);
 
+  Q_INVOKABLE void beginEdit();
+  Q_INVOKABLE void endEdit();
+
+  QList<DatasetSlot> datasetsForIndex(const int frameIndex) const;
+  QList<DatasetSlot> datasetsWithTitle(const QString &title) const;
+
 public Q_SLOTS:
   void newJsonFile();
   void openJsonFile();
   void openJsonFile(const QString &path);
+  void importDbcFile();
 
   void setTitle(const QString &title);
+  void setFramingMode(const int mode);
+  void setCompression(const int mode);
+  void setHeatshrinkWindow(const int bits);
+  void setHeatshrinkLookahead(const int bits);
+  void setChecksumAlgorithm(const int algorithm);
+  void setChecksumPlacement(const int placement);
+  void setChecksumEncoding(const int encoding);
+  void setDecimation(const int factor);
   void setSeparator(const QString &separator);
   void setFrameParserCode(const QString &code);
+  bool setBinaryLayout(const QJsonArray &layout);
+  bool setFrameRouting(const QJsonObject &routing);
+  bool setNmea(const QJsonValue &config);
+  bool setWasm(const QJsonValue &config);
   void setFrameEndSequence(const QString &sequence);
   void setFrameStartSequence(const QString &sequence);
 
@@ -159,8 +265,14 @@ public Q_SLOTS:
   void moveGroupDown(const int group);
   void setGroupTitle(const int group, const QString &title);
   void setGroupWidgetData(const int group, const QString &widget);
+  void setGroupFrameId(const int group, const QString &id);
+  void setGroupMatrix(const int group, const int rows, const int columns,
+                      const int frameIndex);
 
   void addDataset(const int group);
+  void addDatasets(const int group, const int count);
+  int importGroups(const QJsonArray &groups);
+  int importDatasets(const int group, const QJsonArray &datasets);
   void deleteDataset(const int group, const int dataset);
   void setDatasetWidget(const int group, const int dataset, const int widgetId);
   void setDatasetTitle(const int group, const int dataset,
@@ -187,6 +299,20 @@ public Q_SLOTS:
                              const QString &alarm);
   void setDatasetFFTSamples(const int group, const int dataset,
                             const QString &samples);
+  void setDatasetPoints(const int group, const int dataset,
+                        const QString &points);
+  void setDatasetSequenceBits(const int group, const int dataset,
+                              const QString &bits);
+  void setDatasetCalibration(const int group, const int dataset,
+                             const QJsonObject &calibration);
+  void setDatasetExpression(const int group, const int dataset,
+                            const QString &expression);
+  void setDatasetAlarmRules(const int group, const int dataset,
+                            const QJsonObject &rules);
+  void setDatasetDecimation(const int group, const int dataset,
+                            const QString &policy);
+  void setDatasetModbus(const int group, const int dataset,
+                        const QJsonObject &mapping);
 
 private Q_SLOTS:
   void onJsonLoaded();
@@ -197,17 +323,47 @@ private Q_SLOTS:
 
 private:
   int nextDatasetIndex();
+  void rebuildIndex();
+  void notifyGroupCountChanged();
+  void notifyGroupOrderChanged();
+  void notifyGroupChanged(const int group);
+  void notifyDatasetChanged(const int group, const int dataset);
+  JSON::Group readGroup(const QJsonObject &object) const;
+  JSON::Dataset readDataset(const QJsonObject &object) const;
+  void buildMatrix(JSON::Group &group, const int rows, const int columns,
+                   const int frameIndex);
+  JSON::Dataset *editableDataset(const int group, const int dataset);
 
 private:
   QString m_title;
   QString m_separator;
   QString m_frameParserCode;
+  QJsonArray m_binaryLayout;
+  QJsonObject m_frameRouting;
+  QJsonValue m_nmea;
+  QJsonValue m_wasm;
   QString m_frameEndSequence;
   QString m_frameStartSequence;
 
+  int m_framingMode;
+  int m_compression;
+  int m_heatshrinkWindow;
+  int m_heatshrinkLookahead;
+  int m_checksumAlgorithm;
+  int m_checksumPlacement;
+  int m_checksumEncoding;
+  int m_decimation;
   bool m_modified;
   QString m_filePath;
 
+  int m_editDepth;
+  bool m_pendingGroupCount;
+  bool m_pendingGroupOrder;
+  QSet<int> m_pendingGroups;
+  DatasetSlot m_pendingDataset;
+
   QVector<JSON::Group> m_groups;
+  QMultiMap<int, DatasetSlot> m_fieldIndex;
+  QMultiHash<QString, DatasetSlot> m_titleIndex;
 };
 } // namespace Project
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QMutexLocker>
+#include <Project/ParserWatchdog.h>
+
+/**
+ * Interval in milliseconds at which the deadlines are checked while a script
+ * is being executed.
+ */
+static const int WATCHDOG_INTERVAL = 5;
+
+/**
+ * Default execution time budget per frame, in milliseconds
+ */
+static const int DEFAULT_BUDGET = 50;
+
+/**
+ * Constructor function, the watchdog thread is started when the first frame
+ * parser is registered.
+ */
+Project::ParserWatchdog::ParserWatchdog()
+  : m_budget(DEFAULT_BUDGET)
+  , m_sleeping(0)
+  , m_frames(0)
+  , m_skipped(0)
+  , m_totalTime(0)
+  , m_maxTime(0)
+{
+  m_clock.start();
+  setObjectName(QStringLiteral("Project::ParserWatchdog"));
+}
+
+/**
+ * Destructor function, stops the watchdog thread
+ */
+Project::ParserWatchdog::~ParserWatchdog()
+{
+  requestInterruption();
+  {
+    QMutexLocker locker(&m_mutex);
+    m_condition.wakeAll();
+  }
+
+  wait();
+  qDeleteAll(m_watches);
+}
+
+/**
+ * Returns the only instance of this class
+ */
+Project::ParserWatchdog &Project::ParserWatchdog::instance()
+{
+  static ParserWatchdog instance;
+  return instance;
+}
+
+/**
+ * Returns the execution time budget per frame in milliseconds, a value of 0
+ * means that scripts are never interrupted.
+ */
+int Project::ParserWatchdog::budget() const
+{
+  return m_budget.loadRelaxed();
+}
+
+/**
+ * Returns the parsing time statistics collected since the last call to
+ * @c resetStatistics().
+ */
+Project::ParserWatchdog::Statistics Project::ParserWatchdog::statistics() const
+{
+  Statistics stats;
+  stats.frames = m_frames.loadRelaxed();
+  stats.skipped = m_skipped.loadRelaxed();
+  stats.maxTime = m_maxTime.loadRelaxed();
+  stats.averageTime = 0;
+  if (stats.frames > 0)
+    stats.averageTime = m_totalTime.loadRelaxed()
+                        / static_cast<qint64>(stats.frames);
+
+  return stats;
+}
+
+/**
+ * Changes the execution time budget per frame, scripts that run for longer
+ * than the budget are interrupted & the frame is skipped. Set
+ * @a milliseconds to 0 to disable the watchdog.
+ */
+void Project::ParserWatchdog::setBudget(const int milliseconds)
+{
+  m_budget.storeRelaxed(qMax(0, milliseconds));
+}
+
+/**
+ * Clears the parsing time statistics
+ */
+void Project::ParserWatchdog::resetStatistics()
+{
+  m_frames.storeRelaxed(0);
+  m_skipped.storeRelaxed(0);
+  m_totalTime.storeRelaxed(0);
+  m_maxTime.storeRelaxed(0);
+}
+
+/**
+ * Registers the given JavaScript @a engine with the watchdog & returns the
+ * watch that must be armed before calling the frame parser script.
+ */
+Project::ParserWatchdog::Watch *
+Project::ParserWatchdog::watch(QJSEngine *engine)
+{
+  auto watch = new Watch;
+  watch->engine = engine;
+  watch->deadline.storeRelaxed(0);
+
+  QMutexLocker locker(&m_mutex);
+  m_watches.append(watch);
+  if (!isRunning())
+    start(QThread::HighPriority);
+
+  return watch;
+}
+
+/**
+ * Unregisters & deletes the given @a watch, must be called before the
+ * JavaScript engine that it monitors is destroyed.
+ */
+void Project::ParserWatchdog::release(Watch *watch)
+{
+  if (!watch)
+    return;
+
+  {
+    QMutexLocker locker(&m_mutex);
+    m_watches.removeAll(watch);
+  }
+
+  delete watch;
+}
+
+/**
+ * Starts the countdown of the given @a watch, the budget is multiplied by
+ * the number of @a frames that are parsed by the script call.
+ */
+void Project::ParserWatchdog::arm(Watch *watch, const int frames)
+{
+  // Watchdog disabled
+  const qint64 budget = m_budget.loadRelaxed();
+  if (!watch || budget <= 0)
+    return;
+
+  // Set deadline (it must never be 0, which means that the watch is idle)
+  const auto deadline = m_clock.elapsed() + budget * qMax(1, frames) + 1;
+  watch->deadline.fetchAndStoreOrdered(deadline);
+
+  // Wake up the watchdog thread if needed
+  if (m_sleeping.loadAcquire())
+  {
+    QMutexLocker locker(&m_mutex);
+    m_condition.wakeAll();
+  }
+}
+
+/**
+ * Stops the countdown of the given @a watch. Returns @c true if the script
+ * was interrupted by the watchdog, in which case the engine is reset so that
+ * it can run the next frame.
+ */
+bool Project::ParserWatchdog::disarm(Watch *watch)
+{
+  if (!watch || watch->deadline.fetchAndStoreOrdered(0) != -1)
+    return false;
+
+  QMutexLocker locker(&watch->mutex);
+  watch->engine->setInterrupted(false);
+  return true;
+}
+
+/**
+ * Registers a script call that took @a nsecs nanoseconds to parse the given
+ * number of @a frames, the @a skipped flag indicates that the call was
+ * interrupted.
+ */
+void Project::ParserWatchdog::record(const qint64 nsecs, const int frames,
+                                     const bool skipped)
+{
+  const int count = qMax(1, frames);
+  const qint64 time = nsecs / count;
+
+  m_frames.fetchAndAddRelaxed(static_cast<quint64>(count));
+  m_totalTime.fetchAndAddRelaxed(nsecs);
+  if (skipped)
+    m_skipped.fetchAndAddRelaxed(static_cast<quint64>(count));
+
+  qint64 max = m_maxTime.loadRelaxed();
+  while (time > max && !m_maxTime.testAndSetRelaxed(max, time, max))
+    continue;
+}
+
+/**
+ * Checks the deadlines of the registered watches periodically, the thread
+ * sleeps until a watch is armed if no script is being executed.
+ */
+void Project::ParserWatchdog::run()
+{
+  QMutexLocker locker(&m_mutex);
+  while (!isInterruptionRequested())
+  {
+    // No script is running, wait until a watch is armed
+    if (!checkDeadlines())
+    {
+      m_sleeping.fetchAndStoreOrdered(1);
+      if (!checkDeadlines() && !isInterruptionRequested())
+        m_condition.wait(&m_mutex);
+
+      m_sleeping.fetchAndStoreOrdered(0);
+      continue;
+    }
+
+    // Check the deadlines again after a short delay
+    m_condition.wait(&m_mutex, WATCHDOG_INTERVAL);
+  }
+}
+
+/**
+ * Interrupts the engines of the watches whose deadline has expired. Returns
+ * @c true if at least one watch is still armed.
+ *
+ * @note this function must be called with the watch list mutex locked.
+ */
+bool Project::ParserWatchdog::checkDeadlines()
+{
+  bool armed = false;
+  const auto now = m_clock.elapsed();
+  for (int i = 0; i < m_watches.count(); ++i)
+  {
+    // Watch is idle or has already been interrupted
+    auto watch = m_watches.at(i);
+    const auto deadline = watch->deadline.loadAcquire();
+    if (deadline <= 0)
+      continue;
+
+    // Deadline has not expired yet
+    armed = true;
+    if (now < deadline)
+      continue;
+
+    // Interrupt the engine, unless the script call finished in the meantime
+    QMutexLocker watchLocker(&watch->mutex);
+    if (watch->deadline.testAndSetOrdered(deadline, -1))
+      watch->engine->setInterrupted(true);
+  }
+
+  return armed;
+}
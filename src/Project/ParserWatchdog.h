@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QAtomicInt>
+#include <QJSEngine>
+#include <QElapsedTimer>
+#include <QWaitCondition>
+
+namespace Project
+{
+/**
+ * @brief The ParserWatchdog class
+ *
+ * Enforces an execution time budget on the JavaScript frame parsers. Each
+ * @c FrameParser registers its engine with the watchdog, and arms the watch
+ * before calling the script. If the call is still running once the budget
+ * expires, the watchdog interrupts the engine with
+ * @c QJSEngine::setInterrupted(), so that a slow (or endless) script can no
+ * longer block the thread that is processing the incoming frames.
+ *
+ * Arming and disarming a watch only updates an atomic deadline, the watchdog
+ * thread checks the deadlines periodically and sleeps while no script is
+ * being executed.
+ *
+ * The watchdog also collects the parsing time statistics of all the frame
+ * parsers, which are displayed by the code editor.
+ */
+class ParserWatchdog : public QThread
+{
+public:
+  /**
+   * Watch registered by each frame parser instance
+   */
+  struct Watch
+  {
+    QMutex mutex;
+    QJSEngine *engine;
+    QAtomicInteger<qint64> deadline;
+  };
+
+  /**
+   * Parsing time statistics, times are expressed in nanoseconds per frame
+   */
+  struct Statistics
+  {
+    quint64 frames;
+    quint64 skipped;
+    qint64 averageTime;
+    qint64 maxTime;
+  };
+
+private:
+  explicit ParserWatchdog();
+  ~ParserWatchdog();
+  ParserWatchdog(ParserWatchdog &&) = delete;
+  ParserWatchdog(const ParserWatchdog &) = delete;
+  ParserWatchdog &operator=(ParserWatchdog &&) = delete;
+  ParserWatchdog &operator=(const ParserWatchdog &) = delete;
+
+public:
+  static ParserWatchdog &instance();
+
+  int budget() const;
+  Statistics statistics() const;
+
+  void setBudget(const int milliseconds);
+  void resetStatistics();
+
+  Watch *watch(QJSEngine *engine);
+  void release(Watch *watch);
+
+  void arm(Watch *watch, const int frames);
+  bool disarm(Watch *watch);
+  void record(const qint64 nsecs, const int frames, const bool skipped);
+
+protected:
+  void run() override;
+
+private:
+  bool checkDeadlines();
+
+private:
+  QMutex m_mutex;
+  QWaitCondition m_condition;
+  QVector<Watch *> m_watches;
+
+  QAtomicInt m_budget;
+  QAtomicInt m_sleeping;
+  QElapsedTimer m_clock;
+
+  QAtomicInteger<quint64> m_frames;
+  QAtomicInteger<quint64> m_skipped;
+  QAtomicInteger<qint64> m_totalTime;
+  QAtomicInteger<qint64> m_maxTime;
+};
+} // namespace Project
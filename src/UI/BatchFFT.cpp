@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <QtMath>
+#include <UI/BatchFFT.h>
+
+#if defined(__AVX__)
+#  define FFT_AVX
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)                                     \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define FFT_SSE
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define FFT_NEON
+#  include <arm_neon.h>
+#endif
+
+/**
+ * Number of lanes processed by each SIMD instruction, the number of lanes of
+ * a batch is rounded up to a multiple of this value.
+ */
+#if defined(FFT_AVX)
+static const int LANE_WIDTH = 8;
+#else
+static const int LANE_WIDTH = 4;
+#endif
+
+/**
+ * Largest transform size supported by the class
+ */
+static const int MAX_SIZE = 1 << 20;
+
+/**
+ * Applies a radix-2 butterfly with the twiddle factor (@a wr, @a wi) to the
+ * given number of @a lanes of the elements @a a and @a b:
+ *
+ *   t = w * b
+ *   b = a - t
+ *   a = a + t
+ */
+static inline void BUTTERFLY(float *ar, float *ai, float *br, float *bi,
+                             const float wr, const float wi, const int lanes)
+{
+#if defined(FFT_AVX)
+  const __m256 vwr = _mm256_set1_ps(wr);
+  const __m256 vwi = _mm256_set1_ps(wi);
+  for (int l = 0; l < lanes; l += 8)
+  {
+    const __m256 xr = _mm256_loadu_ps(br + l);
+    const __m256 xi = _mm256_loadu_ps(bi + l);
+    const __m256 yr = _mm256_loadu_ps(ar + l);
+    const __m256 yi = _mm256_loadu_ps(ai + l);
+    const __m256 tr
+        = _mm256_sub_ps(_mm256_mul_ps(vwr, xr), _mm256_mul_ps(vwi, xi));
+    const __m256 ti
+        = _mm256_add_ps(_mm256_mul_ps(vwr, xi), _mm256_mul_ps(vwi, xr));
+    _mm256_storeu_ps(br + l, _mm256_sub_ps(yr, tr));
+    _mm256_storeu_ps(bi + l, _mm256_sub_ps(yi, ti));
+    _mm256_storeu_ps(ar + l, _mm256_add_ps(yr, tr));
+    _mm256_storeu_ps(ai + l, _mm256_add_ps(yi, ti));
+  }
+#elif defined(FFT_SSE)
+  const __m128 vwr = _mm_set1_ps(wr);
+  const __m128 vwi = _mm_set1_ps(wi);
+  for (int l = 0; l < lanes; l += 4)
+  {
+    const __m128 xr = _mm_loadu_ps(br + l);
+    const __m128 xi = _mm_loadu_ps(bi + l);
+    const __m128 yr = _mm_loadu_ps(ar + l);
+    const __m128 yi = _mm_loadu_ps(ai + l);
+    const __m128 tr = _mm_sub_ps(_mm_mul_ps(vwr, xr), _mm_mul_ps(vwi, xi));
+    const __m128 ti = _mm_add_ps(_mm_mul_ps(vwr, xi), _mm_mul_ps(vwi, xr));
+    _mm_storeu_ps(br + l, _mm_sub_ps(yr, tr));
+    _mm_storeu_ps(bi + l, _mm_sub_ps(yi, ti));
+    _mm_storeu_ps(ar + l, _mm_add_ps(yr, tr));
+    _mm_storeu_ps(ai + l, _mm_add_ps(yi, ti));
+  }
+#elif defined(FFT_NEON)
+  const float32x4_t vwr = vdupq_n_f32(wr);
+  const float32x4_t vwi = vdupq_n_f32(wi);
+  for (int l = 0; l < lanes; l += 4)
+  {
+    const float32x4_t xr = vld1q_f32(br + l);
+    const float32x4_t xi = vld1q_f32(bi + l);
+    const float32x4_t yr = vld1q_f32(ar + l);
+    const float32x4_t yi = vld1q_f32(ai + l);
+    const float32x4_t tr = vsubq_f32(vmulq_f32(vwr, xr), vmulq_f32(vwi, xi));
+    const float32x4_t ti = vaddq_f32(vmulq_f32(vwr, xi), vmulq_f32(vwi, xr));
+    vst1q_f32(br + l, vsubq_f32(yr, tr));
+    vst1q_f32(bi + l, vsubq_f32(yi, ti));
+    vst1q_f32(ar + l, vaddq_f32(yr, tr));
+    vst1q_f32(ai + l, vaddq_f32(yi, ti));
+  }
+#else
+  for (int l = 0; l < lanes; ++l)
+  {
+    const float tr = wr * br[l] - wi * bi[l];
+    const float ti = wr * bi[l] + wi * br[l];
+    br[l] = ar[l] - tr;
+    bi[l] = ai[l] - ti;
+    ar[l] += tr;
+    ai[l] += ti;
+  }
+#endif
+}
+
+/**
+ * Constructor function
+ */
+UI::BatchFFT::BatchFFT() {}
+
+/**
+ * Returns @c true if the given @a size is a supported transform size (a
+ * power of two between 2 & 2^20).
+ */
+bool UI::BatchFFT::isValidSize(const int size)
+{
+  return size >= 2 && size <= MAX_SIZE && (size & (size - 1)) == 0;
+}
+
+/**
+ * Returns the name of the instruction set used by the butterflies, this is
+ * useful for diagnostics and benchmarks.
+ */
+const char *UI::BatchFFT::instructionSet()
+{
+#if defined(FFT_AVX)
+  return "AVX";
+#elif defined(FFT_SSE)
+  return "SSE2";
+#elif defined(FFT_NEON)
+  return "NEON";
+#else
+  return "Scalar";
+#endif
+}
+
+/**
+ * Calculates the spectrum of the given number of real-valued @a channels.
+ *
+ * The @a input holds the @a size samples of each channel, one channel after
+ * the other. If @a window is not null, the samples are multiplied by the
+ * @a size coefficients of the window before the transform.
+ *
+ * The real & imaginary parts of the first @a size / 2 + 1 bins of each
+ * channel are written to @a re & @a im, one channel after the other.
+ *
+ * @returns @c false if the size of the transform is not supported.
+ */
+bool UI::BatchFFT::forward(const int size, const int channels,
+                           const float *input, const float *window,
+                           float *re, float *im)
+{
+  // Validate arguments
+  if (!isValidSize(size) || channels <= 0)
+    return false;
+
+  // Get the tables of the transform & round the lanes up to the SIMD width
+  const auto &tables = plan(size);
+  const int pairs = (channels + 1) / 2;
+  const int lanes = (pairs + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH;
+
+  // Clear the work buffers, so that padding lanes are zero
+  m_re.fill(0, size * lanes);
+  m_im.fill(0, size * lanes);
+  auto *workRe = m_re.data();
+  auto *workIm = m_im.data();
+
+  // Copy the windowed samples in bit-reversed order, even channels are the
+  // real part of their lane & odd channels the imaginary part
+  const auto *reversed = tables.reversed.constData();
+  for (int c = 0; c < channels; ++c)
+  {
+    const int lane = c / 2;
+    const auto *samples = input + c * size;
+    auto *work = (c % 2 == 0) ? workRe : workIm;
+    for (int i = 0; i < size; ++i)
+    {
+      const float w = window ? window[i] : 1;
+      work[reversed[i] * lanes + lane] = samples[i] * w;
+    }
+  }
+
+  // Apply the butterflies of each stage to all the lanes at once
+  const auto *twiddleRe = tables.twiddleRe.constData();
+  const auto *twiddleIm = tables.twiddleIm.constData();
+  for (int length = 2; length <= size; length <<= 1)
+  {
+    const int half = length / 2;
+    const int step = size / length;
+    for (int start = 0; start < size; start += length)
+    {
+      for (int k = 0; k < half; ++k)
+      {
+        const int a = (start + k) * lanes;
+        const int b = (start + k + half) * lanes;
+        BUTTERFLY(workRe + a, workIm + a, workRe + b, workIm + b,
+                  twiddleRe[k * step], twiddleIm[k * step], lanes);
+      }
+    }
+  }
+
+  // Separate the spectra of the two channels of each lane, using the
+  // symmetry of the spectrum of a real signal: X[n - k] = conj(X[k])
+  const int bins = size / 2 + 1;
+  for (int c = 0; c < channels; c += 2)
+  {
+    const int lane = c / 2;
+    const bool pair = c + 1 < channels;
+    for (int k = 0; k < bins; ++k)
+    {
+      const int n = (size - k) & (size - 1);
+      const float zr = workRe[k * lanes + lane];
+      const float zi = workIm[k * lanes + lane];
+      const float nr = workRe[n * lanes + lane];
+      const float ni = workIm[n * lanes + lane];
+
+      re[c * bins + k] = 0.5f * (zr + nr);
+      im[c * bins + k] = 0.5f * (zi - ni);
+      if (pair)
+      {
+        re[(c + 1) * bins + k] = 0.5f * (zi + ni);
+        im[(c + 1) * bins + k] = 0.5f * (nr - zr);
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns the bit-reversal & twiddle tables of the transform of the given
+ * @a size, the tables are calculated the first time that a size is used.
+ */
+const UI::BatchFFT::Plan &UI::BatchFFT::plan(const int size)
+{
+  // Tables already calculated
+  auto it = m_plans.constFind(size);
+  if (it != m_plans.constEnd())
+    return it.value();
+
+  // Calculate bit-reversed indexes
+  Plan tables;
+  int bits = 0;
+  while ((1 << bits) < size)
+    ++bits;
+
+  tables.reversed.resize(size);
+  for (int i = 0; i < size; ++i)
+  {
+    int reversed = 0;
+    for (int b = 0; b < bits; ++b)
+      reversed |= ((i >> b) & 1) << (bits - 1 - b);
+
+    tables.reversed[i] = reversed;
+  }
+
+  // Calculate twiddle factors, w[k] = exp(-2 * pi * i * k / size)
+  tables.twiddleRe.resize(size / 2);
+  tables.twiddleIm.resize(size / 2);
+  for (int k = 0; k < size / 2; ++k)
+  {
+    const double angle = -2 * M_PI * k / size;
+    tables.twiddleRe[k] = static_cast<float>(qCos(angle));
+    tables.twiddleIm[k] = static_cast<float>(qSin(angle));
+  }
+
+  return m_plans.insert(size, tables).value();
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QVector>
+
+namespace UI
+{
+/**
+ * @brief The BatchFFT class
+ *
+ * Computes the spectrum of many real-valued channels of the same size in a
+ * single pass, used by the @c FFTEngine to transform the blocks of all the
+ * FFT & waterfall widgets that are ready at the same time.
+ *
+ * Channels are packed in pairs into complex lanes (the first channel of a
+ * pair is the real part & the second one the imaginary part), so a single
+ * complex transform yields the spectra of two real channels. The lanes are
+ * interleaved in memory (sample-major), so every butterfly of the radix-2
+ * transform is applied to all the lanes with SIMD instructions (AVX, SSE or
+ * NEON, depending on the target) instead of running one scalar transform per
+ * channel.
+ *
+ * The bit-reversal & twiddle tables of each transform size are calculated
+ * once & shared by every channel of that size, and the work buffers are kept
+ * between calls, so no memory is allocated unless the number of channels or
+ * the size of the transform grows.
+ *
+ * @note The class is not thread-safe, each thread must use its own instance.
+ */
+class BatchFFT
+{
+public:
+  BatchFFT();
+
+  static bool isValidSize(const int size);
+  static const char *instructionSet();
+
+  bool forward(const int size, const int channels, const float *input,
+               const float *window, float *re, float *im);
+
+private:
+  struct Plan
+  {
+    QVector<int> reversed;
+    QVector<float> twiddleRe;
+    QVector<float> twiddleIm;
+  };
+
+  const Plan &plan(const int size);
+
+private:
+  QHash<int, Plan> m_plans;
+  QVector<float> m_re;
+  QVector<float> m_im;
+};
+} // namespace UI
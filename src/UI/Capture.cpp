@@ -0,0 +1,666 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <QtNumeric>
+
+#include <UI/Capture.h>
+#include <JSON/Generator.h>
+
+/**
+ * Constructor function, reads the trigger configuration & receives every
+ * frame generated by the JSON generator.
+ */
+UI::Capture::Capture()
+  : m_state(Stopped)
+  , m_frozen(false)
+  , m_autoTriggered(false)
+  , m_remaining(0)
+  , m_previous(qQNaN())
+  , m_samples(0)
+  , m_armedAt(0)
+  , m_schemaHash(0)
+  , m_captureCount(0)
+  , m_head(0)
+  , m_size(0)
+  , m_channels(0)
+  , m_triggerIndex(0)
+  , m_capturedLength(0)
+{
+  // Read settings
+  m_mode = m_settings.value("UI_Capture_Mode", Auto).toInt();
+  m_condition = m_settings.value("UI_Capture_Condition", RisingEdge).toInt();
+  m_level = m_settings.value("UI_Capture_Level", 0).toDouble();
+  m_upperLevel = m_settings.value("UI_Capture_UpperLevel", 1).toDouble();
+  m_length = m_settings.value("UI_Capture_Length", 1000).toInt();
+  m_preTrigger = m_settings.value("UI_Capture_PreTrigger", 20).toInt();
+  m_source = 0;
+
+  // Validate settings
+  m_mode = qBound(0, m_mode, static_cast<int>(Single));
+  m_condition = qBound(0, m_condition, static_cast<int>(LeaveWindow));
+  m_length = qBound(2, m_length, 1000000);
+  m_preTrigger = qBound(0, m_preTrigger, 100);
+
+  // clang-format off
+  connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
+          this, &UI::Capture::reset);
+  // clang-format on
+
+  // Receive every generated frame, so that no trigger is missed
+  JSON::Generator::instance().sinks().addSink(this,
+                                              JSON::SinkGraph::Port::Frames);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+UI::Capture &UI::Capture::instance()
+{
+  static Capture singleton;
+  return singleton;
+}
+
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString UI::Capture::sinkName() const
+{
+  return QStringLiteral("UI::Capture");
+}
+
+/**
+ * Looks for the trigger condition in the given batch of @a frames, see
+ * @c processFrames()
+ */
+void UI::Capture::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  processFrames(frames);
+}
+
+/**
+ * Returns the trigger mode (see @c Mode)
+ */
+int UI::Capture::mode() const
+{
+  return m_mode;
+}
+
+/**
+ * Returns the trigger condition (see @c Condition)
+ */
+int UI::Capture::condition() const
+{
+  return m_condition;
+}
+
+/**
+ * Returns the index of the dataset that is checked by the trigger, within the
+ * list returned by @c availableSources()
+ */
+int UI::Capture::source() const
+{
+  return m_source;
+}
+
+/**
+ * Returns the trigger level, which is the lower limit of the window when a
+ * window condition is used
+ */
+double UI::Capture::level() const
+{
+  return m_level;
+}
+
+/**
+ * Returns the upper limit of the window used by the window conditions
+ */
+double UI::Capture::upperLevel() const
+{
+  return m_upperLevel;
+}
+
+/**
+ * Returns the number of frames of each captured window
+ */
+int UI::Capture::length() const
+{
+  return m_length;
+}
+
+/**
+ * Returns the percentage of the captured window that is made of frames
+ * received before the trigger fired
+ */
+int UI::Capture::preTrigger() const
+{
+  return m_preTrigger;
+}
+
+/**
+ * Returns the current state of the trigger (see @c State)
+ */
+int UI::Capture::state() const
+{
+  return m_state;
+}
+
+/**
+ * Returns @c true if the captured window is frozen for inspection
+ */
+bool UI::Capture::frozen() const
+{
+  return m_frozen;
+}
+
+/**
+ * Returns @c true if the latest capture was forced by the auto mode, instead
+ * of being started by the trigger condition
+ */
+bool UI::Capture::autoTriggered() const
+{
+  return m_autoTriggered;
+}
+
+/**
+ * Returns the index of the trigger frame within the captured window
+ */
+int UI::Capture::triggerIndex() const
+{
+  return m_triggerIndex;
+}
+
+/**
+ * Returns the number of frames of the captured window, which is zero if
+ * nothing has been captured yet
+ */
+int UI::Capture::capturedLength() const
+{
+  return m_capturedLength;
+}
+
+/**
+ * Returns the number of windows captured since the project was loaded
+ */
+quint64 UI::Capture::captureCount() const
+{
+  return m_captureCount;
+}
+
+/**
+ * Returns the titles of the datasets that can be used as trigger source
+ */
+QStringList UI::Capture::availableSources() const
+{
+  return m_sourceTitles;
+}
+
+/**
+ * Returns the names of the available trigger modes
+ */
+QStringList UI::Capture::availableModes() const
+{
+  return QStringList{tr("Auto"), tr("Normal"), tr("Single")};
+}
+
+/**
+ * Returns the names of the available trigger conditions
+ */
+QStringList UI::Capture::availableConditions() const
+{
+  return QStringList{tr("Rising edge"),  tr("Falling edge"),
+                     tr("Either edge"),  tr("Above level"),
+                     tr("Below level"),  tr("Entering window"),
+                     tr("Leaving window")};
+}
+
+/**
+ * Returns the reception time of each frame of the captured window, in
+ * milliseconds relative to the trigger frame
+ */
+QVector<qreal> UI::Capture::capturedTimes() const
+{
+  QVector<qreal> times(m_capturedLength);
+  if (m_capturedLength <= 0)
+    return times;
+
+  const auto origin = m_capturedTimes.at(m_triggerIndex);
+  for (int i = 0; i < m_capturedLength; ++i)
+    times[i] = (m_capturedTimes.at(i) - origin) / 1000.0;
+
+  return times;
+}
+
+/**
+ * Returns the values of the given @a source dataset (see
+ * @c availableSources()) in the captured window
+ */
+QVector<qreal> UI::Capture::capturedValues(const int source) const
+{
+  QVector<qreal> values;
+  if (source < 0 || source >= m_sourceIndexes.count())
+    return values;
+
+  values.resize(m_capturedLength);
+  const auto column = m_sourceIndexes.at(source);
+  for (int i = 0; i < m_capturedLength; ++i)
+    values[i] = m_captured.at(i * m_channels + column);
+
+  return values;
+}
+
+/**
+ * Starts waiting for the trigger, the captured window is unfrozen & the
+ * pre-trigger ring is cleared.
+ */
+void UI::Capture::arm()
+{
+  m_head = 0;
+  m_size = 0;
+  m_frozen = false;
+  m_previous = qQNaN();
+  m_state = Waiting;
+  Q_EMIT stateChanged();
+}
+
+/**
+ * Stops the capture, the captured window is kept
+ */
+void UI::Capture::stop()
+{
+  if (m_state != Stopped)
+  {
+    m_state = Stopped;
+    Q_EMIT stateChanged();
+  }
+}
+
+/**
+ * Changes the trigger @a mode (see @c Mode)
+ */
+void UI::Capture::setMode(const int mode)
+{
+  const auto value = qBound(0, mode, static_cast<int>(Single));
+  if (m_mode != value)
+  {
+    m_mode = value;
+    m_settings.setValue("UI_Capture_Mode", value);
+    rearm();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the trigger @a condition (see @c Condition)
+ */
+void UI::Capture::setCondition(const int condition)
+{
+  const auto value = qBound(0, condition, static_cast<int>(LeaveWindow));
+  if (m_condition != value)
+  {
+    m_condition = value;
+    m_settings.setValue("UI_Capture_Condition", value);
+    rearm();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the dataset that is checked by the trigger
+ */
+void UI::Capture::setSource(const int source)
+{
+  const auto value = qBound(0, source, qMax(0, m_sourceIndexes.count() - 1));
+  if (m_source != value)
+  {
+    m_source = value;
+    m_previous = qQNaN();
+    rearm();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the trigger @a level
+ */
+void UI::Capture::setLevel(const double level)
+{
+  if (!qFuzzyCompare(m_level, level) && qIsFinite(level))
+  {
+    m_level = level;
+    m_settings.setValue("UI_Capture_Level", level);
+    rearm();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the upper limit of the window used by the window conditions
+ */
+void UI::Capture::setUpperLevel(const double level)
+{
+  if (!qFuzzyCompare(m_upperLevel, level) && qIsFinite(level))
+  {
+    m_upperLevel = level;
+    m_settings.setValue("UI_Capture_UpperLevel", level);
+    rearm();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the number of frames of each captured window, the pre-trigger ring
+ * is cleared.
+ */
+void UI::Capture::setLength(const int length)
+{
+  const auto value = qBound(2, length, 1000000);
+  if (m_length != value)
+  {
+    m_length = value;
+    m_settings.setValue("UI_Capture_Length", value);
+    resizeRing();
+    rearm();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the percentage of the captured window that is made of frames
+ * received before the trigger fired
+ */
+void UI::Capture::setPreTrigger(const int percent)
+{
+  const auto value = qBound(0, percent, 100);
+  if (m_preTrigger != value)
+  {
+    m_preTrigger = value;
+    m_settings.setValue("UI_Capture_PreTrigger", value);
+    rearm();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Freezes or unfreezes the captured window. The trigger is re-armed when the
+ * window is unfrozen (unless the capture is stopped).
+ */
+void UI::Capture::setFrozen(const bool frozen)
+{
+  if (m_frozen != frozen)
+  {
+    m_frozen = frozen;
+    if (!m_frozen && m_state != Stopped)
+      m_state = Waiting;
+
+    Q_EMIT stateChanged();
+  }
+}
+
+/**
+ * Removes the recorded & captured data, called when a new project is loaded
+ */
+void UI::Capture::reset()
+{
+  m_schemaHash = 0;
+  m_channels = 0;
+  m_sourceTitles.clear();
+  m_sourceIndexes.clear();
+  m_captureCount = 0;
+  resizeRing();
+  rearm();
+
+  Q_EMIT captured();
+  Q_EMIT sourcesChanged();
+}
+
+/**
+ * Records the given @a frames to the pre-trigger ring & checks the trigger
+ * condition for each one of them.
+ */
+void UI::Capture::processFrames(const QVector<JSON::Frame> &frames)
+{
+  const auto state = m_state;
+  const auto captures = m_captureCount;
+  for (const auto &frame : frames)
+  {
+    // Update trigger sources when the frame structure changes
+    if (frame.schemaHash() != m_schemaHash
+        || frame.values().count() != m_channels)
+      updateSources(frame);
+
+    // Nothing to do
+    if (m_state == Stopped || m_sourceIndexes.isEmpty())
+      continue;
+
+    // Record frame & obtain the value of the trigger source
+    record(frame);
+    const double previous = m_previous;
+    const double value = frame.values().at(m_sourceIndexes.at(m_source));
+    m_previous = value;
+
+    // Do not check the trigger while the captured window is inspected
+    if (m_frozen)
+      continue;
+
+    // Count the post-trigger frames
+    if (m_state == Triggered)
+      --m_remaining;
+
+    // Arm the trigger once the pre-trigger part of the window is recorded
+    if (m_state == Waiting && m_size >= preTriggerLength())
+    {
+      m_state = Armed;
+      m_armedAt = m_samples;
+    }
+
+    // Check the trigger condition, force a capture in auto mode
+    if (m_state == Armed)
+    {
+      const bool fired = triggers(previous, value);
+      const bool forced = m_mode == Auto && m_samples - m_armedAt >= m_length;
+      if (fired || forced)
+      {
+        m_state = Triggered;
+        m_autoTriggered = !fired;
+        m_remaining = m_length - preTriggerLength() - 1;
+      }
+    }
+
+    // Copy the window once the post-trigger frames are received
+    if (m_state == Triggered && m_remaining <= 0)
+      finishCapture();
+  }
+
+  // Update user interface
+  if (captures != m_captureCount)
+    Q_EMIT captured();
+  if (state != m_state)
+    Q_EMIT stateChanged();
+}
+
+/**
+ * Returns the number of frames of the captured window that are received
+ * before the trigger frame
+ */
+int UI::Capture::preTriggerLength() const
+{
+  return qBound(0, m_length * m_preTrigger / 100, m_length - 1);
+}
+
+/**
+ * Restarts the wait for the trigger after the configuration changes, unless
+ * the capture is stopped or frozen
+ */
+void UI::Capture::rearm()
+{
+  if (m_state != Stopped && !m_frozen && m_state != Waiting)
+  {
+    m_state = Waiting;
+    Q_EMIT stateChanged();
+  }
+}
+
+/**
+ * Allocates the pre-trigger ring for the current window length & channel
+ * count, recorded & captured frames are discarded.
+ */
+void UI::Capture::resizeRing()
+{
+  m_head = 0;
+  m_size = 0;
+  m_previous = qQNaN();
+  m_ring.fill(0, m_length * m_channels);
+  m_times.fill(0, m_length);
+
+  m_triggerIndex = 0;
+  m_capturedLength = 0;
+  m_captured.clear();
+  m_capturedTimes.clear();
+}
+
+/**
+ * Copies the recorded window to the captured buffer, ordered from the oldest
+ * frame to the newest one, and re-arms the trigger unless the single mode is
+ * used.
+ */
+void UI::Capture::finishCapture()
+{
+  // Copy the window, the ring is full at this point
+  m_captured.resize(m_size * m_channels);
+  m_capturedTimes.resize(m_size);
+  for (int i = 0; i < m_size; ++i)
+  {
+    const int row = (m_head + i) % m_length;
+    const auto begin = m_ring.constBegin() + row * m_channels;
+    std::copy(begin, begin + m_channels, m_captured.begin() + i * m_channels);
+    m_capturedTimes[i] = m_times.at(row);
+  }
+
+  // Register capture
+  ++m_captureCount;
+  m_capturedLength = m_size;
+  m_triggerIndex = qMin(m_size - 1, preTriggerLength());
+
+  // Stop or wait for the next trigger
+  m_state = m_mode == Single ? Stopped : Waiting;
+}
+
+/**
+ * Rebuilds the list of trigger sources from the datasets of the given
+ * @a frame, the selected source is kept if a dataset with the same title
+ * exists in the new frame.
+ */
+void UI::Capture::updateSources(const JSON::Frame &frame)
+{
+  // Keep the title of the selected source
+  QString selected;
+  if (m_source >= 0 && m_source < m_sourceTitles.count())
+    selected = m_sourceTitles.at(m_source);
+
+  // Register each dataset of the frame
+  m_sourceTitles.clear();
+  m_sourceIndexes.clear();
+  for (int i = 0; i < frame.groupCount(); ++i)
+  {
+    const auto &group = frame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      m_sourceIndexes.append(frame.valueIndex(i, j));
+      m_sourceTitles.append(QStringLiteral("%1 / %2").arg(
+          group.title(), group.getDataset(j).title()));
+    }
+  }
+
+  // Restore selected source
+  m_source = qMax(0, m_sourceTitles.indexOf(selected));
+
+  // Resize the ring for the new frame structure
+  m_schemaHash = frame.schemaHash();
+  m_channels = frame.values().count();
+  resizeRing();
+
+  // Update user interface
+  Q_EMIT captured();
+  Q_EMIT sourcesChanged();
+  Q_EMIT configurationChanged();
+}
+
+/**
+ * Appends the values of the given @a frame to the pre-trigger ring, the
+ * oldest frame is overwritten when the ring is full.
+ */
+void UI::Capture::record(const JSON::Frame &frame)
+{
+  const auto &values = frame.values();
+  const int row = (m_head + m_size) % m_length;
+  std::copy(values.constBegin(), values.constEnd(),
+            m_ring.begin() + row * m_channels);
+  m_times[row] = frame.timestamp();
+
+  if (m_size < m_length)
+    ++m_size;
+  else
+    m_head = (m_head + 1) % m_length;
+
+  ++m_samples;
+}
+
+/**
+ * Returns @c true if the trigger condition holds for the given @a value of
+ * the source dataset, @a previous being the value of the previous frame.
+ * Edge & window crossings are only detected when both values are numbers.
+ */
+bool UI::Capture::triggers(const double previous, const double value) const
+{
+  // Values that are not numbers never trigger
+  if (!qIsFinite(value))
+    return false;
+
+  // Check level conditions
+  const bool before = qIsFinite(previous);
+  const double lower = qMin(m_level, m_upperLevel);
+  const double upper = qMax(m_level, m_upperLevel);
+  switch (m_condition)
+  {
+    case RisingEdge:
+      return before && previous < m_level && value >= m_level;
+    case FallingEdge:
+      return before && previous > m_level && value <= m_level;
+    case EitherEdge:
+      return before
+             && ((previous < m_level && value >= m_level)
+                 || (previous > m_level && value <= m_level));
+    case AboveLevel:
+      return value > m_level;
+    case BelowLevel:
+      return value < m_level;
+    case EnterWindow:
+      return before && (previous < lower || previous > upper)
+             && value >= lower && value <= upper;
+    case LeaveWindow:
+      return before && previous >= lower && previous <= upper
+             && (value < lower || value > upper);
+  }
+
+  return false;
+}
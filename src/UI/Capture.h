@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QPair>
+#include <QObject>
+#include <QVector>
+#include <QStringList>
+
+#include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <Misc/Settings.h>
+
+namespace UI
+{
+/**
+ * @brief The Capture class
+ *
+ * Oscilloscope-style triggered capture of the received frames. The values of
+ * every frame are recorded in a ring buffer of @c length() frames, and the
+ * configured trigger condition is checked against the selected source dataset
+ * for every frame delivered by the JSON generator, so triggers are never
+ * missed when the user interface is slow (the dashboard refresh rate has no
+ * effect on the capture).
+ *
+ * Once the trigger fires, the capture waits until the post-trigger part of the
+ * window has been received and copies the whole window (including the
+ * @c preTrigger() percentage of frames received before the trigger) to the
+ * captured buffer, which the user interface can inspect while new frames keep
+ * arriving.
+ *
+ * Trigger modes:
+ * - @c Auto: the capture is re-armed after each capture; if the trigger does
+ *   not fire within one window, a capture is forced.
+ * - @c Normal: the capture is re-armed after each capture.
+ * - @c Single: the capture stops after the first capture.
+ *
+ * While the capture is frozen, the captured window is kept and the trigger is
+ * not checked (frames are still recorded to the pre-trigger ring).
+ */
+class Capture : public QObject, public JSON::FrameSink
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int mode
+               READ mode
+               WRITE setMode
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int condition
+               READ condition
+               WRITE setCondition
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int source
+               READ source
+               WRITE setSource
+               NOTIFY configurationChanged)
+    Q_PROPERTY(double level
+               READ level
+               WRITE setLevel
+               NOTIFY configurationChanged)
+    Q_PROPERTY(double upperLevel
+               READ upperLevel
+               WRITE setUpperLevel
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int length
+               READ length
+               WRITE setLength
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int preTrigger
+               READ preTrigger
+               WRITE setPreTrigger
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int state
+               READ state
+               NOTIFY stateChanged)
+    Q_PROPERTY(bool frozen
+               READ frozen
+               WRITE setFrozen
+               NOTIFY stateChanged)
+    Q_PROPERTY(bool autoTriggered
+               READ autoTriggered
+               NOTIFY captured)
+    Q_PROPERTY(int triggerIndex
+               READ triggerIndex
+               NOTIFY captured)
+    Q_PROPERTY(int capturedLength
+               READ capturedLength
+               NOTIFY captured)
+    Q_PROPERTY(quint64 captureCount
+               READ captureCount
+               NOTIFY captured)
+    Q_PROPERTY(QStringList availableSources
+               READ availableSources
+               NOTIFY sourcesChanged)
+    Q_PROPERTY(QStringList availableModes
+               READ availableModes
+               CONSTANT)
+    Q_PROPERTY(QStringList availableConditions
+               READ availableConditions
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void captured();
+  void stateChanged();
+  void sourcesChanged();
+  void configurationChanged();
+
+private:
+  explicit Capture();
+  Capture(Capture &&) = delete;
+  Capture(const Capture &) = delete;
+  Capture &operator=(Capture &&) = delete;
+  Capture &operator=(const Capture &) = delete;
+
+public:
+  enum Mode
+  {
+    Auto,
+    Normal,
+    Single
+  };
+  Q_ENUM(Mode)
+
+  enum Condition
+  {
+    RisingEdge,
+    FallingEdge,
+    EitherEdge,
+    AboveLevel,
+    BelowLevel,
+    EnterWindow,
+    LeaveWindow
+  };
+  Q_ENUM(Condition)
+
+  enum State
+  {
+    Stopped,
+    Waiting,
+    Armed,
+    Triggered
+  };
+  Q_ENUM(State)
+
+  static Capture &instance();
+
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
+  int mode() const;
+  int condition() const;
+  int source() const;
+  double level() const;
+  double upperLevel() const;
+  int length() const;
+  int preTrigger() const;
+
+  int state() const;
+  bool frozen() const;
+  bool autoTriggered() const;
+  int triggerIndex() const;
+  int capturedLength() const;
+  quint64 captureCount() const;
+
+  QStringList availableSources() const;
+  QStringList availableModes() const;
+  QStringList availableConditions() const;
+
+  Q_INVOKABLE QVector<qreal> capturedTimes() const;
+  Q_INVOKABLE QVector<qreal> capturedValues(const int source) const;
+
+public Q_SLOTS:
+  void arm();
+  void stop();
+  void setMode(const int mode);
+  void setCondition(const int condition);
+  void setSource(const int source);
+  void setLevel(const double level);
+  void setUpperLevel(const double level);
+  void setLength(const int length);
+  void setPreTrigger(const int percent);
+  void setFrozen(const bool frozen);
+
+private Q_SLOTS:
+  void reset();
+  void processFrames(const QVector<JSON::Frame> &frames);
+
+private:
+  int preTriggerLength() const;
+  void rearm();
+  void resizeRing();
+  void finishCapture();
+  void updateSources(const JSON::Frame &frame);
+  void record(const JSON::Frame &frame);
+  bool triggers(const double previous, const double value) const;
+
+private:
+  int m_mode;
+  int m_condition;
+  int m_source;
+  double m_level;
+  double m_upperLevel;
+  int m_length;
+  int m_preTrigger;
+
+  int m_state;
+  bool m_frozen;
+  bool m_autoTriggered;
+  int m_remaining;
+  double m_previous;
+  quint64 m_samples;
+  quint64 m_armedAt;
+  quint64 m_schemaHash;
+  quint64 m_captureCount;
+
+  int m_head;
+  int m_size;
+  int m_channels;
+  QVector<double> m_ring;
+  QVector<qint64> m_times;
+
+  int m_triggerIndex;
+  int m_capturedLength;
+  QVector<double> m_captured;
+  QVector<qint64> m_capturedTimes;
+
+  QStringList m_sourceTitles;
+  QVector<int> m_sourceIndexes;
+  Misc::Settings m_settings;
+};
+} // namespace UI
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <UI/Colormap.h>
+
+/**
+ * Returns the colormap used by the waterfall widgets, from black (lowest
+ * amplitude) to white (peak amplitude).
+ */
+const QVector<QRgb> &UI::Colormap::spectrum()
+{
+  static const QVector<QRgb> colors = interpolate(
+      {QColor(0, 0, 0), QColor(32, 12, 96), QColor(120, 28, 110),
+       QColor(210, 50, 60), QColor(250, 140, 20), QColor(252, 230, 80),
+       QColor(255, 255, 255)});
+
+  return colors;
+}
+
+/**
+ * Returns the colormap used by the heatmap widgets, from dark blue (minimum
+ * value) to dark red (maximum value).
+ */
+const QVector<QRgb> &UI::Colormap::thermal()
+{
+  static const QVector<QRgb> colors = interpolate(
+      {QColor(20, 20, 120), QColor(30, 90, 220), QColor(40, 200, 230),
+       QColor(90, 220, 100), QColor(250, 220, 50), QColor(240, 110, 30),
+       QColor(150, 10, 20)});
+
+  return colors;
+}
+
+/**
+ * Returns a table with 256 colors interpolated linearly between the given
+ * gradient @a stops, which are equally spaced.
+ */
+QVector<QRgb> UI::Colormap::interpolate(const QVector<QColor> &stops)
+{
+  QVector<QRgb> colors(256);
+  const int segments = stops.count() - 1;
+  for (int i = 0; i < colors.count(); ++i)
+  {
+    const qreal x = i * segments / 255.0;
+    const int s = qMin(static_cast<int>(x), segments - 1);
+    const qreal t = x - s;
+    const auto &a = stops.at(s);
+    const auto &b = stops.at(s + 1);
+    colors[i] = qRgb(qRound(a.red() + (b.red() - a.red()) * t),
+                     qRound(a.green() + (b.green() - a.green()) * t),
+                     qRound(a.blue() + (b.blue() - a.blue()) * t));
+  }
+
+  return colors;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QColor>
+#include <QVector>
+
+namespace UI
+{
+/**
+ * @brief The Colormap class
+ *
+ * Tables of 256 colors used by the scene graph widgets to represent values
+ * with colors, the value of each pixel is converted to an index of the table
+ * so that no color interpolation is done while drawing.
+ *
+ * - @c spectrum() goes from black to white through purple, red & yellow, and
+ *   is used to represent the amplitudes of the waterfall widgets.
+ * - @c thermal() goes from dark blue to dark red through cyan, green &
+ *   yellow, and is used to represent the values of the heatmap widgets.
+ */
+class Colormap
+{
+public:
+  static const QVector<QRgb> &spectrum();
+  static const QVector<QRgb> &thermal();
+
+private:
+  static QVector<QRgb> interpolate(const QVector<QColor> &stops);
+};
+} // namespace UI
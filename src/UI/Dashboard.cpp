@@ -20,13 +20,47 @@
  * THE SOFTWARE.
  */
 
+#include <QHash>
+#include <QtMath>
+#include <QJsonObject>
+#include <QElapsedTimer>
 #include <IO/Manager.h>
 #include <IO/Console.h>
 #include <CSV/Player.h>
+#include <CSV/Reference.h>
 #include <UI/Dashboard.h>
 #include <JSON/Generator.h>
+#include <Misc/Tracer.h>
+#include <Misc/Diagnostics.h>
 #include <Misc/TimerEvents.h>
 
+/**
+ * Number of bins of each histogram widget
+ */
+static constexpr int HISTOGRAM_BINS = 64;
+
+/**
+ * Minimum & maximum number of points retained by each XY plot
+ */
+static constexpr int MIN_XY_POINTS = 1000;
+static constexpr int MAX_XY_POINTS = 1000000;
+
+/**
+ * Returns a JSON object with the given statistics @a summary, values that are
+ * not available (e.g. the mean of a dataset without samples) are null.
+ */
+static QJsonObject SUMMARY(const UI::Statistics::Summary &summary)
+{
+  QJsonObject object;
+  object.insert("count", static_cast<double>(summary.count));
+  object.insert("min", summary.count ? summary.min : QJsonValue());
+  object.insert("max", summary.count ? summary.max : QJsonValue());
+  object.insert("mean", summary.count ? summary.mean : QJsonValue());
+  object.insert("stddev", summary.count ? summary.stddev : QJsonValue());
+  object.insert("rms", summary.count ? summary.rms : QJsonValue());
+  return object;
+}
+
 //----------------------------------------------------------------------------------------
 // Constructor/deconstructor & singleton
 //----------------------------------------------------------------------------------------
@@ -37,17 +71,59 @@
 UI::Dashboard::Dashboard()
   : m_points(100)
   , m_precision(2)
+  , m_timeWindow(0)
+  , m_xyPoints(100000)
+  , m_frameTimestamp(0)
+  , m_viewPaused(false)
+  , m_viewChanged(false)
+  , m_viewOffset(0)
+  , m_pauseTime(0)
+  , m_statistics(100)
+  , m_revision(0)
+  , m_referenceRow(0)
+  , m_referenceOrigin(-1)
+  , m_updateRequired(false)
+  , m_nativeRendering(false)
+  , m_parallelRendering(false)
+  , m_openGLRendering(false)
+  , m_renderCostOverlay(false)
+  , m_renderingSuspended(false)
+  , m_schemaHash(0)
 {
+  // Read settings
+  m_nativeRendering
+      = m_settings.value("UI_Dashboard_NativeRendering", false).toBool();
+  m_parallelRendering
+      = m_settings.value("UI_Dashboard_ParallelRendering", false).toBool();
+  m_openGLRendering
+      = m_settings.value("UI_Dashboard_OpenGLRendering", false).toBool();
+  m_renderCostOverlay
+      = m_settings.value("UI_Dashboard_RenderCostOverlay", false).toBool();
+  m_timeWindow = m_settings.value("UI_Dashboard_TimeWindow", 0).toInt();
+  m_xyPoints = qBound(MIN_XY_POINTS,
+                      m_settings.value("UI_Dashboard_XYPoints", 100000).toInt(),
+                      MAX_XY_POINTS);
+
   // clang-format off
     connect(&CSV::Player::instance(), &CSV::Player::openChanged,
             this, &UI::Dashboard::resetData);
+    connect(&CSV::Reference::instance(), &CSV::Reference::openChanged,
+            this, &UI::Dashboard::resetReference);
+    connect(&CSV::Reference::instance(), &CSV::Reference::restarted,
+            this, &UI::Dashboard::resetReference);
     connect(&IO::Manager::instance(), &IO::Manager::connectedChanged,
             this, &UI::Dashboard::resetData);
-    connect(&JSON::Generator::instance(), &JSON::Generator::jsonChanged,
-            this, &UI::Dashboard::processLatestJSON);
     connect(&JSON::Generator::instance(), &JSON::Generator::jsonFileMapChanged,
-            this, &UI::Dashboard::resetData);
+            this, &UI::Dashboard::onProjectChanged);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeoutRender,
+            this, &UI::Dashboard::updateWidgets);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz,
+            this, [=] { if (m_viewPaused) Q_EMIT viewChanged(); });
   // clang-format on
+
+  // Receive the frames delivered to the live consumers
+  JSON::Generator::instance().sinks().addSink(
+      this, JSON::SinkGraph::Port::DecimatedFrames);
 }
 
 /**
@@ -59,6 +135,22 @@ UI::Dashboard &UI::Dashboard::instance()
   return singleton;
 }
 
+/**
+ * Returns the name of the module in the diagnostics of the sink graph
+ */
+QString UI::Dashboard::sinkName() const
+{
+  return QStringLiteral("UI::Dashboard");
+}
+
+/**
+ * Registers the given batch of decimated @a frames, see @c processFrames()
+ */
+void UI::Dashboard::consumeFrames(const QVector<JSON::Frame> &frames)
+{
+  processFrames(frames);
+}
+
 //----------------------------------------------------------------------------------------
 // Group/Dataset access functions
 //----------------------------------------------------------------------------------------
@@ -69,19 +161,141 @@ QFont UI::Dashboard::monoFont() const
 }
 
 // clang-format off
-const JSON::Group &UI::Dashboard::getLED(const int index) const           { return m_ledWidgets.at(index);           }
-const JSON::Group &UI::Dashboard::getGPS(const int index) const           { return m_gpsWidgets.at(index);           }
-const JSON::Dataset &UI::Dashboard::getBar(const int index) const         { return m_barWidgets.at(index);           }
-const JSON::Dataset &UI::Dashboard::getFFT(const int index) const         { return m_fftWidgets.at(index);           }
-const JSON::Dataset &UI::Dashboard::getPlot(const int index) const        { return m_plotWidgets.at(index);          }
-const JSON::Group &UI::Dashboard::getGroups(const int index) const        { return m_groupWidgets.at(index);         }
-const JSON::Dataset &UI::Dashboard::getGauge(const int index) const       { return m_gaugeWidgets.at(index);         }
-const JSON::Group &UI::Dashboard::getGyroscope(const int index) const     { return m_gyroscopeWidgets.at(index);     }
-const JSON::Dataset &UI::Dashboard::getCompass(const int index) const     { return m_compassWidgets.at(index);       }
-const JSON::Group &UI::Dashboard::getMultiplot(const int index) const     { return m_multiPlotWidgets.at(index);     }
-const JSON::Group &UI::Dashboard::getAccelerometer(const int index) const { return m_accelerometerWidgets.at(index); }
+const JSON::Group &UI::Dashboard::getLED(const int index) const           { return m_ledWidgets.at(index);                                    }
+const JSON::Group &UI::Dashboard::getGPS(const int index) const           { return m_currentFrame.getGroup(m_gpsWidgets.at(index));           }
+const JSON::Dataset &UI::Dashboard::getBar(const int index) const         { return getDataset(m_barWidgets.at(index));                        }
+const JSON::Dataset &UI::Dashboard::getFFT(const int index) const         { return getDataset(m_fftWidgets.at(index));                        }
+const JSON::Dataset &UI::Dashboard::getPlot(const int index) const        { return getDataset(m_plotWidgets.at(index));                       }
+const JSON::Group &UI::Dashboard::getGroups(const int index) const        { return m_currentFrame.getGroup(m_groupWidgets.at(index));         }
+const JSON::Dataset &UI::Dashboard::getGauge(const int index) const       { return getDataset(m_gaugeWidgets.at(index));                      }
+const JSON::Group &UI::Dashboard::getGyroscope(const int index) const     { return m_currentFrame.getGroup(m_gyroscopeWidgets.at(index));     }
+const JSON::Dataset &UI::Dashboard::getCompass(const int index) const     { return getDataset(m_compassWidgets.at(index));                    }
+const JSON::Group &UI::Dashboard::getMultiplot(const int index) const     { return m_currentFrame.getGroup(m_multiPlotWidgets.at(index));     }
+const JSON::Group &UI::Dashboard::getXYPlot(const int index) const        { return m_currentFrame.getGroup(m_xyPlotWidgets.at(index));        }
+const JSON::Group &UI::Dashboard::getHeatmap(const int index) const       { return m_currentFrame.getGroup(m_heatmapWidgets.at(index));       }
+const JSON::Group &UI::Dashboard::getAccelerometer(const int index) const { return m_currentFrame.getGroup(m_accelerometerWidgets.at(index)); }
+const JSON::Dataset &UI::Dashboard::getWaterfall(const int index) const   { return getDataset(m_waterfallWidgets.at(index));                  }
+const JSON::Group &UI::Dashboard::getStatistics(const int index) const    { return m_currentFrame.getGroup(m_statisticsWidgets.at(index));    }
+const JSON::Dataset &UI::Dashboard::getHistogram(const int index) const   { return getDataset(m_histogramWidgets.at(index));                  }
 // clang-format on
 
+/**
+ * Returns the index of the entry of @c plotHistory() that stores the values of
+ * the plot located at the given @a index, or -1 if the plot does not exist.
+ */
+int UI::Dashboard::plotHistoryIndex(const int index) const
+{
+  if (index < 0 || index >= m_plotHistoryIndexes.count())
+    return -1;
+
+  return m_plotHistoryIndexes.at(index);
+}
+
+/**
+ * Returns the index of the entry of @c plotHistory() that stores the values of
+ * the given @a dataset of the multiplot located at the given @a index, or -1
+ * if the multiplot or the dataset do not exist.
+ *
+ * Accelerometer & gyroscope groups are displayed as multiplots too, so every
+ * dataset has a single history, no matter how many widgets display it.
+ */
+int UI::Dashboard::multiPlotHistoryIndex(const int index,
+                                         const int dataset) const
+{
+  if (index < 0 || index >= m_multiPlotHistoryIndexes.count())
+    return -1;
+
+  const auto &indexes = m_multiPlotHistoryIndexes.at(index);
+  if (dataset < 0 || dataset >= indexes.count())
+    return -1;
+
+  return indexes.at(dataset);
+}
+
+/**
+ * Returns the position of the first value of the group displayed by the group
+ * widget at the given @a index in the value array of the current frame (see
+ * @c JSON::Frame::values()), or -1 if the index is invalid.
+ */
+int UI::Dashboard::groupValueIndex(const int index) const
+{
+  if (index < 0 || index >= m_groupWidgets.count())
+    return -1;
+
+  return m_currentFrame.valueIndex(m_groupWidgets.at(index), 0);
+}
+
+/**
+ * Returns the position of the first value of the group displayed by the
+ * statistics widget at the given @a index in the value array of the current
+ * frame, or -1 if the index is invalid.
+ */
+int UI::Dashboard::statisticsValueIndex(const int index) const
+{
+  if (index < 0 || index >= m_statisticsWidgets.count())
+    return -1;
+
+  return m_currentFrame.valueIndex(m_statisticsWidgets.at(index), 0);
+}
+
+/**
+ * Returns the position of the first cell of the matrix displayed by the
+ * heatmap widget at the given @a index in the value array of the current
+ * frame, or -1 if the index is invalid. The rest of the cells follow it.
+ */
+int UI::Dashboard::heatmapValueIndex(const int index) const
+{
+  if (index < 0 || index >= m_heatmapWidgets.count())
+    return -1;
+
+  return m_currentFrame.valueIndex(m_heatmapWidgets.at(index), 0);
+}
+
+/**
+ * Returns the session & windowed statistics of the given @a dataset (contained
+ * by the given @a group) of the current frame. Each statistics object
+ * contains the @c count, @c min, @c max, @c mean, @c stddev & @c rms keys.
+ */
+QVariantMap UI::Dashboard::datasetStatistics(const int group,
+                                             const int dataset) const
+{
+  const int index = m_currentFrame.valueIndex(group, dataset);
+  if (index < 0)
+    return QVariantMap();
+
+  QVariantMap map;
+  map.insert("session", SUMMARY(m_statistics.session(index)).toVariantMap());
+  map.insert("window", SUMMARY(m_statistics.windowed(index)).toVariantMap());
+  return map;
+}
+
+/**
+ * Returns a JSON array with the title, the location & the session and
+ * windowed statistics of every dataset of the current frame. This is sent to
+ * the plugins once per second.
+ */
+QJsonArray UI::Dashboard::statisticsSnapshot() const
+{
+  QJsonArray array;
+  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
+  {
+    const auto &group = m_currentFrame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const int index = m_currentFrame.valueIndex(i, j);
+      QJsonObject object;
+      object.insert("group", i);
+      object.insert("dataset", j);
+      object.insert("title", group.getDataset(j).title());
+      object.insert("session", SUMMARY(m_statistics.session(index)));
+      object.insert("window", SUMMARY(m_statistics.windowed(index)));
+      array.append(object);
+    }
+  }
+
+  return array;
+}
+
 //----------------------------------------------------------------------------------------
 // Misc member access functions
 //----------------------------------------------------------------------------------------
@@ -103,7 +317,8 @@ bool UI::Dashboard::available()
 }
 
 /**
- * Returns the number of points displayed by the graphs
+ * Returns the number of points displayed by the graphs, datasets can keep a
+ * different number of samples (see @c JSON::Dataset::points())
  */
 int UI::Dashboard::points() const
 {
@@ -118,6 +333,163 @@ int UI::Dashboard::precision() const
   return m_precision;
 }
 
+/**
+ * Returns the number of seconds displayed by the plots, 0 means that the plots
+ * display the latest @c points() samples against the sample index.
+ */
+int UI::Dashboard::timeWindow() const
+{
+  return m_timeWindow;
+}
+
+/**
+ * Returns the number of points retained & displayed by each XY plot
+ */
+int UI::Dashboard::xyPoints() const
+{
+  return m_xyPoints;
+}
+
+/**
+ * Returns @c true if the user paused the dashboard view. While the view is
+ * paused, the frames are still received, recorded & appended to the plot
+ * history, but the widgets keep displaying the frame at which the view was
+ * paused, and the plots display the history that precedes @c viewEndTime().
+ */
+bool UI::Dashboard::viewPaused() const
+{
+  return m_viewPaused;
+}
+
+/**
+ * Returns the number of seconds between the moment in which the view was
+ * paused & the end of the period displayed by the plots
+ */
+double UI::Dashboard::viewOffset() const
+{
+  return m_viewOffset;
+}
+
+/**
+ * Returns the number of seconds of data stored by the plot history before the
+ * moment in which the view was paused (or before the latest frame, if the
+ * view is live), which is the maximum value of @c viewOffset().
+ */
+double UI::Dashboard::viewHistory() const
+{
+  // Get the time of the oldest sample of the plot history
+  qint64 first = 0;
+  for (int i = 0; i < m_plotHistory.count(); ++i)
+  {
+    const auto time = m_plotHistory.at(i).firstTime();
+    if (time > 0 && (first <= 0 || time < first))
+      first = time;
+  }
+
+  // Get the time elapsed until the view was paused
+  const auto last = m_viewPaused ? m_pauseTime : m_frameTimestamp;
+  if (first <= 0 || last <= first)
+    return 0;
+
+  return (last - first) / 1e6;
+}
+
+/**
+ * Returns the time (in microseconds, see @c IO::FrameQueue::timestamp()) of
+ * the newest sample displayed by the plots, or 0 if the view is live.
+ */
+qint64 UI::Dashboard::viewEndTime() const
+{
+  if (!m_viewPaused)
+    return 0;
+
+  return qMax<qint64>(1, m_pauseTime - qint64(m_viewOffset * 1e6));
+}
+
+/**
+ * Returns the time (in microseconds, see @c IO::FrameQueue::timestamp()) at
+ * which the latest frame processed by the dashboard was received.
+ */
+qint64 UI::Dashboard::frameTimestamp() const
+{
+  return m_frameTimestamp;
+}
+
+/**
+ * Returns @c true if the plots are drawn directly by the Qt Quick scene graph
+ * (see @c UI::PlotItem) instead of rendering the QtWidgets-based plots.
+ */
+bool UI::Dashboard::nativeRendering() const
+{
+  return m_nativeRendering;
+}
+
+/**
+ * Returns @c true if the widgets that support it are rendered into images by
+ * a pool of worker threads, instead of being rendered one after the other by
+ * the GUI thread (see @c UI::DeclarativeWidget).
+ */
+bool UI::Dashboard::parallelRendering() const
+{
+  return m_parallelRendering;
+}
+
+/**
+ * Returns @c true if the plot widgets are painted directly into OpenGL
+ * framebuffers that are displayed by the scene graph, instead of being
+ * rasterized into images that are uploaded as textures. This option only
+ * applies when the scene graph uses the OpenGL backend.
+ */
+bool UI::Dashboard::openGLRendering() const
+{
+  return m_openGLRendering;
+}
+
+/**
+ * Returns @c true if each widget displays the time spent updating, grabbing
+ * & painting it on top of its contents (see @c UI::DashboardWidget).
+ */
+bool UI::Dashboard::renderCostOverlay() const
+{
+  return m_renderCostOverlay;
+}
+
+/**
+ * Returns @c true if the widgets are not being redrawn, received frames are
+ * still appended to the plot data (see @c setRenderingSuspended()).
+ */
+bool UI::Dashboard::renderingSuspended() const
+{
+  return m_renderingSuspended;
+}
+
+/**
+ * Returns the number of bytes allocated by the data retained by the dashboard:
+ * the plot histories (including the reference recording), the FFT & waterfall
+ * buffers, the histograms, the XY point clouds, the GPS tracks & the
+ * statistics accumulators.
+ */
+qint64 UI::Dashboard::allocatedBytes() const
+{
+  qint64 bytes = qint64(m_xData.capacity()) * sizeof(double);
+  for (const auto &history : m_plotHistory)
+    bytes += history.allocatedBytes();
+  for (const auto &history : m_referenceHistory)
+    bytes += history.allocatedBytes();
+  for (const auto &buffer : m_fftPlotValues)
+    bytes += buffer.allocatedBytes();
+  for (const auto &buffer : m_waterfallValues)
+    bytes += buffer.allocatedBytes();
+  for (const auto &histogram : m_histograms)
+    bytes += histogram.allocatedBytes();
+  for (const auto &cloud : m_pointClouds)
+    bytes += cloud.allocatedBytes();
+  for (const auto &track : m_gpsTracks)
+    bytes += track.allocatedBytes();
+
+  return bytes + m_statistics.allocatedBytes();
+}
+
 /**
  * Returns @c true if the current JSON frame is valid and ready-to-use by the
  * QML interface.
@@ -153,8 +525,13 @@ int UI::Dashboard::totalWidgetCount() const
             gaugeCount() +
             groupCount() +
             compassCount() +
+            histogramCount() +
             multiPlotCount() +
+            xyPlotCount() +
+            heatmapCount() +
             gyroscopeCount() +
+            waterfallCount() +
+            statisticsCount() +
             accelerometerCount();
   // clang-format on
 
@@ -172,7 +549,12 @@ int UI::Dashboard::groupCount() const         { return m_groupWidgets.count();
 int UI::Dashboard::compassCount() const       { return m_compassWidgets.count();       }
 int UI::Dashboard::gyroscopeCount() const     { return m_gyroscopeWidgets.count();     }
 int UI::Dashboard::multiPlotCount() const     { return m_multiPlotWidgets.count();     }
+int UI::Dashboard::xyPlotCount() const        { return m_xyPlotWidgets.count();        }
+int UI::Dashboard::heatmapCount() const       { return m_heatmapWidgets.count();       }
 int UI::Dashboard::accelerometerCount() const { return m_accelerometerWidgets.count(); }
+int UI::Dashboard::waterfallCount() const     { return m_waterfallWidgets.count();     }
+int UI::Dashboard::statisticsCount() const    { return m_statisticsWidgets.count();    }
+int UI::Dashboard::histogramCount() const     { return m_histogramWidgets.count();     }
 // clang-format on
 
 //----------------------------------------------------------------------------------------
@@ -194,14 +576,19 @@ StringList UI::Dashboard::widgetTitles()
   // clang-format off
     return groupTitles() +
             multiPlotTitles() +
+            xyPlotTitles() +
+            heatmapTitles() +
             ledTitles() +
             fftTitles() +
+            waterfallTitles() +
             plotTitles() +
             barTitles() +
             gaugeTitles() +
             compassTitles() +
+            histogramTitles() +
             gyroscopeTitles() +
             accelerometerTitles() +
+            statisticsTitles() +
             gpsTitles();
   // clang-format on
 }
@@ -242,8 +629,18 @@ int UI::Dashboard::relativeIndex(const int globalIndex) const
   if (index < multiPlotCount())
     return index;
 
-  // Check if we should return LED widget
+  // Check if we should return XY plot widget
   index -= multiPlotCount();
+  if (index < xyPlotCount())
+    return index;
+
+  // Check if we should return heatmap widget
+  index -= xyPlotCount();
+  if (index < heatmapCount())
+    return index;
+
+  // Check if we should return LED widget
+  index -= heatmapCount();
   if (index < ledCount())
     return index;
 
@@ -252,8 +649,13 @@ int UI::Dashboard::relativeIndex(const int globalIndex) const
   if (index < fftCount())
     return index;
 
-  // Check if we should return plot widget
+  // Check if we should return waterfall widget
   index -= fftCount();
+  if (index < waterfallCount())
+    return index;
+
+  // Check if we should return plot widget
+  index -= waterfallCount();
   if (index < plotCount())
     return index;
 
@@ -272,8 +674,13 @@ int UI::Dashboard::relativeIndex(const int globalIndex) const
   if (index < compassCount())
     return index;
 
-  // Check if we should return gyro widget
+  // Check if we should return histogram widget
   index -= compassCount();
+  if (index < histogramCount())
+    return index;
+
+  // Check if we should return gyro widget
+  index -= histogramCount();
   if (index < gyroscopeCount())
     return index;
 
@@ -282,8 +689,13 @@ int UI::Dashboard::relativeIndex(const int globalIndex) const
   if (index < accelerometerCount())
     return index;
 
-  // Check if we should return map widget
+  // Check if we should return statistics widget
   index -= accelerometerCount();
+  if (index < statisticsCount())
+    return index;
+
+  // Check if we should return map widget
+  index -= statisticsCount();
   if (index < gpsCount())
     return index;
 
@@ -321,9 +733,18 @@ bool UI::Dashboard::widgetVisible(const int globalIndex) const
     case WidgetType::MultiPlot:
       visible = multiPlotVisible(index);
       break;
+    case WidgetType::XYPlot:
+      visible = xyPlotVisible(index);
+      break;
+    case WidgetType::Heatmap:
+      visible = heatmapVisible(index);
+      break;
     case WidgetType::FFT:
       visible = fftVisible(index);
       break;
+    case WidgetType::Waterfall:
+      visible = waterfallVisible(index);
+      break;
     case WidgetType::Plot:
       visible = plotVisible(index);
       break;
@@ -336,12 +757,18 @@ bool UI::Dashboard::widgetVisible(const int globalIndex) const
     case WidgetType::Compass:
       visible = compassVisible(index);
       break;
+    case WidgetType::Histogram:
+      visible = histogramVisible(index);
+      break;
     case WidgetType::Gyroscope:
       visible = gyroscopeVisible(index);
       break;
     case WidgetType::Accelerometer:
       visible = accelerometerVisible(index);
       break;
+    case WidgetType::Statistics:
+      visible = statisticsVisible(index);
+      break;
     case WidgetType::GPS:
       visible = gpsVisible(index);
       break;
@@ -383,9 +810,18 @@ QString UI::Dashboard::widgetIcon(const int globalIndex) const
     case WidgetType::MultiPlot:
       return "qrc:/icons/multiplot.svg";
       break;
+    case WidgetType::XYPlot:
+      return "qrc:/icons/xy.svg";
+      break;
+    case WidgetType::Heatmap:
+      return "qrc:/icons/heatmap.svg";
+      break;
     case WidgetType::FFT:
       return "qrc:/icons/fft.svg";
       break;
+    case WidgetType::Waterfall:
+      return "qrc:/icons/waterfall.svg";
+      break;
     case WidgetType::Plot:
       return "qrc:/icons/plot.svg";
       break;
@@ -398,12 +834,18 @@ QString UI::Dashboard::widgetIcon(const int globalIndex) const
     case WidgetType::Compass:
       return "qrc:/icons/compass.svg";
       break;
+    case WidgetType::Histogram:
+      return "qrc:/icons/histogram.svg";
+      break;
     case WidgetType::Gyroscope:
       return "qrc:/icons/gyro.svg";
       break;
     case WidgetType::Accelerometer:
       return "qrc:/icons/accelerometer.svg";
       break;
+    case WidgetType::Statistics:
+      return "qrc:/icons/graphs.svg";
+      break;
     case WidgetType::GPS:
       return "qrc:/icons/gps.svg";
       break;
@@ -423,13 +865,18 @@ QString UI::Dashboard::widgetIcon(const int globalIndex) const
  * - @c WidgetType::Unknown
  * - @c WidgetType::Group
  * - @c WidgetType::MultiPlot
+ * - @c WidgetType::XYPlot
+ * - @c WidgetType::Heatmap
  * - @c WidgetType::FFT
+ * - @c WidgetType::Waterfall
  * - @c WidgetType::Plot
  * - @c WidgetType::Bar
  * - @c WidgetType::Gauge
  * - @c WidgetType::Compass
+ * - @c WidgetType::Histogram
  * - @c WidgetType::Gyroscope
  * - @c WidgetType::Accelerometer
+ * - @c WidgetType::Statistics
  * - @c WidgetType::GPS
  * - @c WidgetType::LED
  *
@@ -467,8 +914,18 @@ UI::Dashboard::WidgetType UI::Dashboard::widgetType(const int globalIndex) const
   if (index < multiPlotCount())
     return WidgetType::MultiPlot;
 
-  // Check if we should return LED widget
+  // Check if we should return XY plot widget
   index -= multiPlotCount();
+  if (index < xyPlotCount())
+    return WidgetType::XYPlot;
+
+  // Check if we should return heatmap widget
+  index -= xyPlotCount();
+  if (index < heatmapCount())
+    return WidgetType::Heatmap;
+
+  // Check if we should return LED widget
+  index -= heatmapCount();
   if (index < ledCount())
     return WidgetType::LED;
 
@@ -477,8 +934,13 @@ UI::Dashboard::WidgetType UI::Dashboard::widgetType(const int globalIndex) const
   if (index < fftCount())
     return WidgetType::FFT;
 
-  // Check if we should return plot widget
+  // Check if we should return waterfall widget
   index -= fftCount();
+  if (index < waterfallCount())
+    return WidgetType::Waterfall;
+
+  // Check if we should return plot widget
+  index -= waterfallCount();
   if (index < plotCount())
     return WidgetType::Plot;
 
@@ -497,8 +959,13 @@ UI::Dashboard::WidgetType UI::Dashboard::widgetType(const int globalIndex) const
   if (index < compassCount())
     return WidgetType::Compass;
 
-  // Check if we should return gyro widget
+  // Check if we should return histogram widget
   index -= compassCount();
+  if (index < histogramCount())
+    return WidgetType::Histogram;
+
+  // Check if we should return gyro widget
+  index -= histogramCount();
   if (index < gyroscopeCount())
     return WidgetType::Gyroscope;
 
@@ -507,8 +974,13 @@ UI::Dashboard::WidgetType UI::Dashboard::widgetType(const int globalIndex) const
   if (index < accelerometerCount())
     return WidgetType::Accelerometer;
 
-  // Check if we should return map widget
+  // Check if we should return statistics widget
   index -= accelerometerCount();
+  if (index < statisticsCount())
+    return WidgetType::Statistics;
+
+  // Check if we should return map widget
+  index -= statisticsCount();
   if (index < gpsCount())
     return WidgetType::GPS;
 
@@ -531,7 +1003,12 @@ bool UI::Dashboard::gaugeVisible(const int index) const         { return getVisi
 bool UI::Dashboard::compassVisible(const int index) const       { return getVisibility(m_compassVisibility, index);       }
 bool UI::Dashboard::gyroscopeVisible(const int index) const     { return getVisibility(m_gyroscopeVisibility, index);     }
 bool UI::Dashboard::multiPlotVisible(const int index) const     { return getVisibility(m_multiPlotVisibility, index);     }
+bool UI::Dashboard::xyPlotVisible(const int index) const        { return getVisibility(m_xyPlotVisibility, index);        }
+bool UI::Dashboard::heatmapVisible(const int index) const       { return getVisibility(m_heatmapVisibility, index);       }
 bool UI::Dashboard::accelerometerVisible(const int index) const { return getVisibility(m_accelerometerVisibility, index); }
+bool UI::Dashboard::waterfallVisible(const int index) const     { return getVisibility(m_waterfallVisibility, index);     }
+bool UI::Dashboard::statisticsVisible(const int index) const    { return getVisibility(m_statisticsVisibility, index);    }
+bool UI::Dashboard::histogramVisible(const int index) const     { return getVisibility(m_histogramVisibility, index);     }
 // clang-format on
 
 //----------------------------------------------------------------------------------------
@@ -549,7 +1026,12 @@ StringList UI::Dashboard::gaugeTitles()         { return datasetTitles(m_gaugeWi
 StringList UI::Dashboard::compassTitles()       { return datasetTitles(m_compassWidgets);     }
 StringList UI::Dashboard::gyroscopeTitles()     { return groupTitles(m_gyroscopeWidgets);     }
 StringList UI::Dashboard::multiPlotTitles()     { return groupTitles(m_multiPlotWidgets);     }
+StringList UI::Dashboard::xyPlotTitles()        { return groupTitles(m_xyPlotWidgets);        }
+StringList UI::Dashboard::heatmapTitles()       { return groupTitles(m_heatmapWidgets);       }
 StringList UI::Dashboard::accelerometerTitles() { return groupTitles(m_accelerometerWidgets); }
+StringList UI::Dashboard::waterfallTitles()     { return datasetTitles(m_waterfallWidgets);   }
+StringList UI::Dashboard::statisticsTitles()    { return groupTitles(m_statisticsWidgets);    }
+StringList UI::Dashboard::histogramTitles()     { return datasetTitles(m_histogramWidgets);   }
 // clang-format on
 
 //----------------------------------------------------------------------------------------
@@ -563,9 +1045,25 @@ void UI::Dashboard::setPoints(const int points)
     // Update number of points
     m_points = points;
 
-    // Clear values
-    m_fftPlotValues.clear();
-    m_linearPlotValues.clear();
+    // Resize the plot histories, the latest samples & the long-term history
+    // are kept. Datasets with their own number of points, FFT & waterfall
+    // buffers (which depend on the FFT size) are not affected.
+    for (int i = 0; i < m_plotHistory.count(); ++i)
+    {
+      if (getDataset(m_historyDatasets.at(i)).points() <= 0)
+        m_plotHistory[i].setPoints(points, 0.0001);
+    }
+    for (int i = 0; i < m_referenceHistory.count(); ++i)
+    {
+      if (m_referenceColumns.value(i, -1) >= 0
+          && getDataset(m_historyDatasets.at(i)).points() <= 0)
+        m_referenceHistory[i].setPoints(points, 0.0001);
+    }
+
+    // Statistics & histograms are computed over the same window as the plots
+    m_statistics.setWindow(points);
+    for (int i = 0; i < m_histograms.count(); ++i)
+      m_histograms[i].setWindow(points);
 
     // Regenerate x-axis values
     m_xData.resize(points);
@@ -581,73 +1079,271 @@ void UI::Dashboard::setPrecision(const int precision)
 {
   if (m_precision != precision)
   {
+    // Displayed text changes for every numeric value
     m_precision = precision;
+    m_displayedValues.clear();
+    m_updateRequired = true;
     Q_EMIT precisionChanged();
   }
 }
 
-//----------------------------------------------------------------------------------------
-// Visibility-related slots
-//----------------------------------------------------------------------------------------
-
-// clang-format off
-void UI::Dashboard::setBarVisible(const int i, const bool v)           { setVisibility(m_barVisibility, i, v);           }
-void UI::Dashboard::setFFTVisible(const int i, const bool v)           { setVisibility(m_fftVisibility, i, v);           }
-void UI::Dashboard::setGpsVisible(const int i, const bool v)           { setVisibility(m_gpsVisibility, i, v);           }
-void UI::Dashboard::setLedVisible(const int i, const bool v)           { setVisibility(m_ledVisibility, i, v);           }
-void UI::Dashboard::setPlotVisible(const int i, const bool v)          { setVisibility(m_plotVisibility, i, v);          }
-void UI::Dashboard::setGroupVisible(const int i, const bool v)         { setVisibility(m_groupVisibility, i, v);         }
-void UI::Dashboard::setGaugeVisible(const int i, const bool v)         { setVisibility(m_gaugeVisibility, i, v);         }
-void UI::Dashboard::setCompassVisible(const int i, const bool v)       { setVisibility(m_compassVisibility, i, v);       }
-void UI::Dashboard::setGyroscopeVisible(const int i, const bool v)     { setVisibility(m_gyroscopeVisibility, i, v);     }
-void UI::Dashboard::setMultiplotVisible(const int i, const bool v)     { setVisibility(m_multiPlotVisibility, i, v);     }
-void UI::Dashboard::setAccelerometerVisible(const int i, const bool v) { setVisibility(m_accelerometerVisibility, i, v); }
-// clang-format on
+/**
+ * Changes the number of @a seconds displayed by the plots, which use the time
+ * at which each frame was received as X-axis. Set to 0 to plot the latest
+ * @c points() samples against the sample index.
+ */
+void UI::Dashboard::setTimeWindow(const int seconds)
+{
+  const auto value = qMax(0, seconds);
+  if (m_timeWindow != value)
+  {
+    m_timeWindow = value;
+    m_settings.setValue("UI_Dashboard_TimeWindow", value);
+    Q_EMIT timeWindowChanged();
+  }
+}
 
-//----------------------------------------------------------------------------------------
-// Frame data handling slots
-//----------------------------------------------------------------------------------------
+/**
+ * Changes the number of @a points retained by each XY plot, between a
+ * thousand and a million points. The current point clouds are discarded.
+ */
+void UI::Dashboard::setXYPoints(const int points)
+{
+  const auto value = qBound(MIN_XY_POINTS, points, MAX_XY_POINTS);
+  if (m_xyPoints != value)
+  {
+    m_xyPoints = value;
+    m_pointClouds.clear();
+    m_settings.setValue("UI_Dashboard_XYPoints", value);
+    Q_EMIT xyPointsChanged();
+  }
+}
 
 /**
- * Removes all available data from the UI when the device is disconnected or the
- * CSV file is closed.
+ * Pauses or resumes the dashboard view, the frames are still processed in the
+ * background while the view is paused. Resuming the view snaps the widgets
+ * back to the latest frame.
  */
-void UI::Dashboard::resetData()
+void UI::Dashboard::setViewPaused(const bool paused)
 {
-  // Make latest frame invalid
-  m_currentFrame.read(QJsonObject{});
+  if (m_viewPaused == paused)
+    return;
 
-  // Clear plot data
-  m_fftPlotValues.clear();
-  m_linearPlotValues.clear();
+  // Keep a snapshot of the displayed frame
+  m_viewOffset = 0;
+  m_viewPaused = paused;
+  if (paused)
+  {
+    m_viewChanged = true;
+    m_pausedFrame = m_currentFrame;
+    m_pauseTime = m_frameTimestamp;
+  }
 
-  // Clear widget data
-  m_barWidgets.clear();
-  m_fftWidgets.clear();
-  m_gpsWidgets.clear();
-  m_ledWidgets.clear();
-  m_plotWidgets.clear();
-  m_gaugeWidgets.clear();
-  m_groupWidgets.clear();
-  m_compassWidgets.clear();
-  m_gyroscopeWidgets.clear();
-  m_multiPlotWidgets.clear();
-  m_accelerometerWidgets.clear();
+  // Go back to live data
+  else
+  {
+    m_pauseTime = 0;
+    m_viewChanged = false;
+    m_updateRequired = true;
+    m_pausedFrame = JSON::Frame();
+  }
 
-  // Clear widget visibility data
-  m_barVisibility.clear();
-  m_fftVisibility.clear();
-  m_gpsVisibility.clear();
-  m_ledVisibility.clear();
-  m_plotVisibility.clear();
-  m_gaugeVisibility.clear();
-  m_groupVisibility.clear();
-  m_compassVisibility.clear();
-  m_gyroscopeVisibility.clear();
+  Q_EMIT viewChanged();
+}
+
+/**
+ * Displays the plot history that precedes the moment in which the view was
+ * paused by the given number of @a seconds, the view is paused if needed.
+ */
+void UI::Dashboard::setViewOffset(const double seconds)
+{
+  // Pause the view
+  if (!m_viewPaused)
+    setViewPaused(true);
+
+  // Update the displayed period
+  const auto offset = qBound(0.0, seconds, viewHistory());
+  if (!qFuzzyCompare(offset + 1, m_viewOffset + 1))
+  {
+    m_viewOffset = offset;
+    m_viewChanged = true;
+    Q_EMIT viewChanged();
+  }
+}
+
+/**
+ * Enables or disables drawing the plots directly with the Qt Quick scene
+ * graph. When disabled, the QtWidgets-based plots are used.
+ */
+void UI::Dashboard::setNativeRendering(const bool enabled)
+{
+  if (m_nativeRendering != enabled)
+  {
+    m_nativeRendering = enabled;
+    m_settings.setValue("UI_Dashboard_NativeRendering", enabled);
+    Q_EMIT nativeRenderingChanged();
+  }
+}
+
+/**
+ * Enables or disables rendering the widgets that support it with a pool of
+ * worker threads. When disabled, all widgets are rendered by the GUI thread.
+ */
+void UI::Dashboard::setParallelRendering(const bool enabled)
+{
+  if (m_parallelRendering != enabled)
+  {
+    m_parallelRendering = enabled;
+    m_settings.setValue("UI_Dashboard_ParallelRendering", enabled);
+    Q_EMIT parallelRenderingChanged();
+  }
+}
+
+/**
+ * Enables or disables painting the plot widgets with the OpenGL paint engine
+ * of Qt, the widgets are redrawn with the new method on the next frame.
+ */
+void UI::Dashboard::setOpenGLRendering(const bool enabled)
+{
+  if (m_openGLRendering != enabled)
+  {
+    m_openGLRendering = enabled;
+    m_settings.setValue("UI_Dashboard_OpenGLRendering", enabled);
+    Q_EMIT openGLRenderingChanged();
+  }
+}
+
+/**
+ * Shows or hides the render cost of each widget on top of its contents.
+ */
+void UI::Dashboard::setRenderCostOverlay(const bool enabled)
+{
+  if (m_renderCostOverlay != enabled)
+  {
+    m_renderCostOverlay = enabled;
+    m_settings.setValue("UI_Dashboard_RenderCostOverlay", enabled);
+    Q_EMIT renderCostOverlayChanged();
+  }
+}
+
+/**
+ * Suspends or resumes redrawing the widgets, e.g. while a large amount of
+ * recorded frames is being processed. Frames are still appended to the plot
+ * data while rendering is suspended, and the widgets are redrawn during the
+ * next tick of the render timer after rendering is resumed.
+ */
+void UI::Dashboard::setRenderingSuspended(const bool suspended)
+{
+  m_renderingSuspended = suspended;
+}
+
+//----------------------------------------------------------------------------------------
+// Visibility-related slots
+//----------------------------------------------------------------------------------------
+
+// clang-format off
+void UI::Dashboard::setBarVisible(const int i, const bool v)           { setVisibility(m_barVisibility, i, v);           }
+void UI::Dashboard::setFFTVisible(const int i, const bool v)           { setVisibility(m_fftVisibility, i, v);           }
+void UI::Dashboard::setGpsVisible(const int i, const bool v)           { setVisibility(m_gpsVisibility, i, v);           }
+void UI::Dashboard::setLedVisible(const int i, const bool v)           { setVisibility(m_ledVisibility, i, v);           }
+void UI::Dashboard::setPlotVisible(const int i, const bool v)          { setVisibility(m_plotVisibility, i, v);          }
+void UI::Dashboard::setGroupVisible(const int i, const bool v)         { setVisibility(m_groupVisibility, i, v);         }
+void UI::Dashboard::setGaugeVisible(const int i, const bool v)         { setVisibility(m_gaugeVisibility, i, v);         }
+void UI::Dashboard::setCompassVisible(const int i, const bool v)       { setVisibility(m_compassVisibility, i, v);       }
+void UI::Dashboard::setGyroscopeVisible(const int i, const bool v)     { setVisibility(m_gyroscopeVisibility, i, v);     }
+void UI::Dashboard::setMultiplotVisible(const int i, const bool v)     { setVisibility(m_multiPlotVisibility, i, v);     }
+void UI::Dashboard::setXYPlotVisible(const int i, const bool v)        { setVisibility(m_xyPlotVisibility, i, v);        }
+void UI::Dashboard::setHeatmapVisible(const int i, const bool v)       { setVisibility(m_heatmapVisibility, i, v);       }
+void UI::Dashboard::setAccelerometerVisible(const int i, const bool v) { setVisibility(m_accelerometerVisibility, i, v); }
+void UI::Dashboard::setWaterfallVisible(const int i, const bool v)     { setVisibility(m_waterfallVisibility, i, v);     }
+void UI::Dashboard::setStatisticsVisible(const int i, const bool v)    { setVisibility(m_statisticsVisibility, i, v);    }
+void UI::Dashboard::setHistogramVisible(const int i, const bool v)     { setVisibility(m_histogramVisibility, i, v);     }
+// clang-format on
+
+/**
+ * Resets the session & windowed statistics of every dataset
+ */
+void UI::Dashboard::resetStatistics()
+{
+  m_statistics.clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Frame data handling slots
+//----------------------------------------------------------------------------------------
+
+/**
+ * Removes all available data from the UI when the device is disconnected or the
+ * CSV file is closed.
+ */
+void UI::Dashboard::resetData()
+{
+  // Make latest frame invalid
+  m_schemaHash = 0;
+  m_latestFrame = JSON::Frame();
+  m_currentFrame.read(QJsonObject{});
+
+  // Clear plot data
+  m_fftPlotValues.clear();
+  m_gpsTracks.clear();
+  m_waterfallValues.clear();
+  m_histograms.clear();
+  m_pointClouds.clear();
+  m_plotHistory.clear();
+  m_historyDatasets.clear();
+  m_plotHistoryIndexes.clear();
+  m_multiPlotHistoryIndexes.clear();
+  m_statistics.setChannels(0);
+  resetReference();
+
+  // Go back to live data
+  setViewPaused(false);
+
+  // Clear change tracking data
+  m_displayedText.clear();
+  m_valueRevisions.clear();
+  m_groupRevisions.clear();
+  m_displayedValues.clear();
+
+  // Clear widget data
+  m_barWidgets.clear();
+  m_fftWidgets.clear();
+  m_gpsWidgets.clear();
+  m_ledWidgets.clear();
+  m_ledDatasets.clear();
+  m_plotWidgets.clear();
+  m_gaugeWidgets.clear();
+  m_groupWidgets.clear();
+  m_compassWidgets.clear();
+  m_gyroscopeWidgets.clear();
+  m_multiPlotWidgets.clear();
+  m_xyPlotWidgets.clear();
+  m_heatmapWidgets.clear();
+  m_waterfallWidgets.clear();
+  m_accelerometerWidgets.clear();
+  m_statisticsWidgets.clear();
+  m_histogramWidgets.clear();
+
+  // Clear widget visibility data
+  m_barVisibility.clear();
+  m_fftVisibility.clear();
+  m_gpsVisibility.clear();
+  m_ledVisibility.clear();
+  m_plotVisibility.clear();
+  m_gaugeVisibility.clear();
+  m_groupVisibility.clear();
+  m_compassVisibility.clear();
+  m_gyroscopeVisibility.clear();
   m_multiPlotVisibility.clear();
+  m_xyPlotVisibility.clear();
+  m_heatmapVisibility.clear();
+  m_waterfallVisibility.clear();
   m_accelerometerVisibility.clear();
+  m_statisticsVisibility.clear();
+  m_histogramVisibility.clear();
 
   // Update UI
+  m_updateRequired = false;
   Q_EMIT updated();
   Q_EMIT dataReset();
   Q_EMIT titleChanged();
@@ -655,90 +1351,300 @@ void UI::Dashboard::resetData()
   Q_EMIT widgetVisibilityChanged();
 }
 
+/**
+ * Called when a project file is loaded. If the frames of the new project have
+ * the same structure as the frames displayed by the dashboard (e.g. a device
+ * variant that only uses a different frame parser or framing), the widgets &
+ * their data are kept. Otherwise, the dashboard is reset.
+ */
+void UI::Dashboard::onProjectChanged()
+{
+  const auto hash = JSON::Generator::instance().schemaHash();
+  if (m_schemaHash != 0 && hash == m_schemaHash)
+    return;
+
+  resetData();
+}
+
 /**
  * Regenerates the data displayed on the dashboard plots
  */
 void UI::Dashboard::updatePlots()
 {
-  // Initialize arrays that contain pointers to the
-  // datasets that need to be plotted.
-  QVector<JSON::Dataset> fftDatasets;
-  QVector<JSON::Dataset> linearDatasets;
+  // Check if we need to update dataset points
+  if (m_plotHistory.count() != m_historyDatasets.count())
+  {
+    m_plotHistory.clear();
 
-  // Create list with datasets that need to be graphed
-  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
+    for (int i = 0; i < m_historyDatasets.count(); ++i)
+      m_plotHistory.append(PlotHistory(historyPoints(i), 0.0001));
+  }
+
+  // Check if we need to update FFT dataset points
+  if (m_fftPlotValues.count() != m_fftWidgets.count())
   {
-    auto group = m_currentFrame.groups().at(i);
-    for (int j = 0; j < group.datasetCount(); ++j)
+    m_fftPlotValues.clear();
+
+    for (int i = 0; i < m_fftWidgets.count(); ++i)
+      m_fftPlotValues.append(PlotBuffer(getFFT(i).fftSamples(), 0));
+  }
+
+  // Check if we need to update waterfall dataset points
+  if (m_waterfallValues.count() != m_waterfallWidgets.count())
+  {
+    m_waterfallValues.clear();
+
+    for (int i = 0; i < m_waterfallWidgets.count(); ++i)
+      m_waterfallValues.append(PlotBuffer(getWaterfall(i).fftSamples(), 0));
+  }
+
+  // Check if we need to create the XY point clouds
+  if (m_pointClouds.count() != m_xyPlotWidgets.count())
+  {
+    m_pointClouds.clear();
+
+    for (int i = 0; i < m_xyPlotWidgets.count(); ++i)
+      m_pointClouds.append(PointCloud(m_xyPoints));
+  }
+
+  // Check if we need to create the histograms, the bins of datasets without a
+  // valid min/max range adapt to the received values
+  if (m_histograms.count() != m_histogramWidgets.count())
+  {
+    m_histograms.clear();
+
+    for (int i = 0; i < m_histogramWidgets.count(); ++i)
     {
-      auto dataset = group.getDataset(j);
-      if (dataset.fft())
-        fftDatasets.append(dataset);
-      if (dataset.graph())
-        linearDatasets.append(dataset);
+      const auto &dataset = getHistogram(i);
+      m_histograms.append(Histogram(HISTOGRAM_BINS, points()));
+      m_histograms.last().setRange(dataset.min(), dataset.max());
     }
   }
 
-  // Check if we need to update dataset points
-  if (m_linearPlotValues.count() != linearDatasets.count())
+  // Get reception time of the frame, frames that were not received from a
+  // device (e.g. frames replayed from a CSV file) use the current time
+  m_frameTimestamp = m_currentFrame.timestamp();
+  if (m_frameTimestamp <= 0)
+    m_frameTimestamp = IO::FrameQueue::timestamp();
+
+  // Append latest values to linear plot data
+  const auto &values = m_currentFrame.values();
+  for (int i = 0; i < m_historyDatasets.count(); ++i)
+  {
+    const auto &index = m_historyDatasets.at(i);
+    m_plotHistory[i].append(
+        values.at(m_currentFrame.valueIndex(index.first, index.second)),
+        m_frameTimestamp);
+  }
+
+  // Append latest values to FFT plot data
+  for (int i = 0; i < m_fftWidgets.count(); ++i)
+  {
+    const auto &index = m_fftWidgets.at(i);
+    m_fftPlotValues[i].append(
+        values.at(m_currentFrame.valueIndex(index.first, index.second)));
+  }
+
+  // Append latest values to waterfall data
+  for (int i = 0; i < m_waterfallWidgets.count(); ++i)
   {
-    m_linearPlotValues.clear();
+    const auto &index = m_waterfallWidgets.at(i);
+    m_waterfallValues[i].append(
+        values.at(m_currentFrame.valueIndex(index.first, index.second)));
+  }
 
-    for (int i = 0; i < linearDatasets.count(); ++i)
+  // Append latest values to the XY point clouds
+  for (int i = 0; i < m_xyPlotWidgets.count(); ++i)
+  {
+    const int group = m_xyPlotWidgets.at(i);
+    if (m_currentFrame.getGroup(group).datasetCount() >= 2)
     {
-      m_linearPlotValues.append(PlotData());
-      m_linearPlotValues.last().resize(points());
-
-      // clang-format off
-            std::fill(m_linearPlotValues.last().begin(),
-                      m_linearPlotValues.last().end(),
-                      0.0001);
-      // clang-format on
+      m_pointClouds[i].append(values.at(m_currentFrame.valueIndex(group, 0)),
+                              values.at(m_currentFrame.valueIndex(group, 1)));
     }
   }
 
-  // Check if we need to update FFT dataset points
-  if (m_fftPlotValues.count() != fftDatasets.count())
+  // Register latest values in the histograms
+  for (int i = 0; i < m_histogramWidgets.count(); ++i)
   {
-    m_fftPlotValues.clear();
+    const auto &index = m_histogramWidgets.at(i);
+    m_histograms[i].append(
+        values.at(m_currentFrame.valueIndex(index.first, index.second)));
+  }
+}
+
+/**
+ * Discards the values read from the reference recording, the first row of the
+ * recording is aligned with the next frame (see @c updateReference()).
+ */
+void UI::Dashboard::resetReference()
+{
+  m_referenceRow = 0;
+  m_referenceOrigin = -1;
+  m_referenceColumns.clear();
+  m_referenceHistory.clear();
+}
+
+/**
+ * Appends the rows of the reference recording (see @c CSV::Reference) that
+ * are due at the reception time of the latest frame to the reference history,
+ * which is displayed as a set of "ghost" curves by the plot widgets.
+ *
+ * The time of each row is given by the time elapsed since the first row of
+ * the recording, counting from the frame that was received when the
+ * reference was (re)started. Rows are decoded directly from the memory-mapped
+ * recording, only the columns of the plotted datasets are read.
+ */
+void UI::Dashboard::updateReference()
+{
+  // Reference not open
+  auto reference = &CSV::Reference::instance();
+  if (!reference->isOpen() || reference->rowCount() <= 0)
+    return;
 
-    for (int i = 0; i < fftDatasets.count(); ++i)
+  // Match the plotted datasets with the columns of the recording, datasets
+  // that are not part of the recording get an empty history
+  if (m_referenceHistory.count() != m_historyDatasets.count())
+  {
+    m_referenceHistory.clear();
+    m_referenceColumns = reference->columns(m_currentFrame, m_historyDatasets);
+    for (int i = 0; i < m_referenceColumns.count(); ++i)
     {
-      m_fftPlotValues.append(PlotData());
-      m_fftPlotValues.last().resize(fftDatasets[i].fftSamples());
-
-      // clang-format off
-            std::fill(m_fftPlotValues.last().begin(),
-                      m_fftPlotValues.last().end(),
-                      0);
-      // clang-format on
+      const bool found = m_referenceColumns.at(i) >= 0;
+      m_referenceHistory.append(
+          PlotHistory(found ? historyPoints(i) : 0, 0.0001));
     }
   }
 
-  // Append latest values to linear plot data
-  for (int i = 0; i < linearDatasets.count(); ++i)
+  // Align the first row of the recording with the latest frame
+  if (m_referenceOrigin < 0)
   {
-    auto data = m_linearPlotValues[i].data();
-    auto count = m_linearPlotValues[i].count();
-    memmove(data, data + 1, count * sizeof(double));
-    m_linearPlotValues[i][count - 1] = linearDatasets[i].value().toDouble();
+    m_referenceRow = 0;
+    m_referenceOrigin = m_frameTimestamp;
   }
 
-  // Append latest values to FFT plot data
-  for (int i = 0; i < fftDatasets.count(); ++i)
+  // Append the rows that are due
+  const auto first = reference->timestamp(0);
+  while (m_referenceRow < reference->rowCount())
+  {
+    const auto elapsed = reference->timestamp(m_referenceRow) - first;
+    const auto time = m_referenceOrigin + qMax<qint64>(0, elapsed) * 1000;
+    if (time > m_frameTimestamp)
+      break;
+
+    for (int i = 0; i < m_referenceColumns.count(); ++i)
+    {
+      const int column = m_referenceColumns.at(i);
+      if (column >= 0)
+        m_referenceHistory[i].append(reference->value(m_referenceRow, column),
+                                     time);
+    }
+
+    ++m_referenceRow;
+  }
+}
+
+/**
+ * Appends the position reported by each GPS group of the current frame to the
+ * track displayed by its GPS widget.
+ */
+void UI::Dashboard::updateGpsTracks()
+{
+  // Check if we need to regenerate the tracks
+  if (m_gpsTracks.count() != m_gpsWidgets.count())
+  {
+    m_gpsTracks.clear();
+    m_gpsTracks.resize(m_gpsWidgets.count());
+  }
+
+  // Register the latest position of each GPS group
+  for (int i = 0; i < m_gpsWidgets.count(); ++i)
+  {
+    double latitude = qQNaN();
+    double longitude = qQNaN();
+    const auto &group = getGPS(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      const auto &dataset = group.getDataset(j);
+      if (dataset.widget() == "lat")
+        latitude = dataset.numericValue();
+      else if (dataset.widget() == "lon")
+        longitude = dataset.numericValue();
+    }
+
+    // Receivers report a null position until they obtain a fix
+    if (latitude != 0 || longitude != 0)
+      m_gpsTracks[i].append(latitude, longitude);
+  }
+}
+
+/**
+ * Notifies the dashboard widgets that new data is available, this function is
+ * called by the render timer, so that the widgets are repainted at most once
+ * per render tick regardless of the rate at which frames are received.
+ *
+ * The time spent updating the widgets is reported to the render timer, which
+ * lowers its frequency if adaptive rendering is enabled & the UI cannot keep
+ * up with it.
+ */
+void UI::Dashboard::updateWidgets()
+{
+  TRACE_SCOPE("UI::Dashboard::updateWidgets");
+
+  // View paused, only redraw the widgets when the user scrubs the history
+  if (m_viewPaused)
+  {
+    if (m_viewChanged && !m_renderingSuspended)
+    {
+      m_viewChanged = false;
+      Q_EMIT updated();
+    }
+
+    return;
+  }
+
+  // Display the latest frame generated so far, which may be more recent than
+  // the last batch of frames delivered to the dashboard
+  auto &snapshot = JSON::Generator::instance().snapshot();
+  if (snapshot.read(m_latestFrame))
+    m_updateRequired = true;
+
+  if (m_updateRequired && !m_renderingSuspended)
   {
-    auto data = m_fftPlotValues[i].data();
-    auto count = m_fftPlotValues[i].count();
-    memmove(data, data + 1, count * sizeof(double));
-    m_fftPlotValues[i][count - 1] = fftDatasets[i].value().toDouble();
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_latestFrame.isValid() && m_latestFrame.schemaHash() == m_schemaHash)
+      m_currentFrame = m_latestFrame;
+
+    m_updateRequired = false;
+    updateLEDWidgets();
+    updateRevisions();
+    Q_EMIT updated();
+
+    const auto nsecs = timer.nsecsElapsed();
+    auto &diagnostics = Misc::Diagnostics::instance();
+    diagnostics.record(Misc::Diagnostics::Stage::Rendering, nsecs);
+    diagnostics.recordLatency(Misc::Diagnostics::Stage::DisplayLatency,
+                              m_currentFrame.timestamp());
+    Misc::TimerEvents::instance().reportRenderLoad(nsecs);
   }
 }
 
 /**
- * Regenerates the data displayed on the dashboard widgets
+ * Appends the values of every frame in the given batch to the plot data &
+ * regenerates the data displayed on the dashboard widgets once, using the
+ * latest frame of the batch. The widgets are repainted during the next tick
+ * of the render timer.
  */
-void UI::Dashboard::processLatestJSON(const QJsonObject &json)
+void UI::Dashboard::processFrames(const QVector<JSON::Frame> &frames)
 {
+  TRACE_SCOPE("UI::Dashboard::processFrames");
+
+  // Measure the time spent processing the frames
+  QElapsedTimer timer;
+  timer.start();
+
   // Save widget count
   const int barC = barCount();
   const int fftC = fftCount();
@@ -750,56 +1656,76 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
   const int compassC = compassCount();
   const int gyroscopeC = gyroscopeCount();
   const int multiPlotC = multiPlotCount();
+  const int xyPlotC = xyPlotCount();
+  const int heatmapC = heatmapCount();
+  const int waterfallC = waterfallCount();
+  const int statisticsC = statisticsCount();
+  const int histogramC = histogramCount();
   const int accelerometerC = accelerometerCount();
 
   // Save previous title
   auto pTitle = title();
 
-  // Try to read latest frame for widget updating
-  if (!m_currentFrame.read(json))
-    return;
+  // Read each frame & regenerate plot data, the widget index lists are only
+  // rebuilt when the structure of the frame changes
+  bool schemaChanged = false;
+  for (int i = 0; i < frames.count(); ++i)
+  {
+    m_currentFrame = frames.at(i);
+    if (m_currentFrame.schemaHash() != m_schemaHash)
+    {
+      updateWidgetIndexes();
+      schemaChanged = true;
+    }
 
-  // Regenerate plot data
-  updatePlots();
+    updatePlots();
+    updateGpsTracks();
+    m_statistics.append(m_currentFrame.values());
+  }
 
-  // Update widget vectors
-  m_fftWidgets = getFFTWidgets();
-  m_ledWidgets = getLEDWidgets();
-  m_plotWidgets = getPlotWidgets();
-  m_groupWidgets = getWidgetGroups("");
-  m_gpsWidgets = getWidgetGroups("map");
-  m_barWidgets = getWidgetDatasets("bar");
-  m_gaugeWidgets = getWidgetDatasets("gauge");
-  m_gyroscopeWidgets = getWidgetGroups("gyro");
-  m_compassWidgets = getWidgetDatasets("compass");
-  m_multiPlotWidgets = getWidgetGroups("multiplot");
-  m_accelerometerWidgets = getWidgetGroups("accelerometer");
+  // Keep displaying the frame at which the view was paused, the structure of
+  // the frame changed, so the paused frame can no longer be displayed
+  if (m_viewPaused)
+  {
+    if (schemaChanged)
+      setViewPaused(false);
+    else
+      m_currentFrame = m_pausedFrame;
+  }
 
-  // Add accelerometer widgets to multiplot
-  for (int i = 0; i < m_accelerometerWidgets.count(); ++i)
-    m_multiPlotWidgets.append(m_accelerometerWidgets.at(i));
+  // Latest frame is not valid, abort widget updating
+  if (!m_currentFrame.isValid())
+    return;
 
-  // Add gyroscope widgets to multiplot
-  for (int i = 0; i < m_gyroscopeWidgets.count(); ++i)
-    m_multiPlotWidgets.append(m_gyroscopeWidgets.at(i));
+  // Append the reference values that are due
+  updateReference();
 
-  // Check if we need to update title
-  if (pTitle != title())
+  // Check if we need to update title, frames with the same schema hash have
+  // the same title & widget counts, so only the values need to be updated
+  if (schemaChanged && pTitle != title())
     Q_EMIT titleChanged();
 
   // Check if we need to regenerate widgets
   bool regenerateWidgets = false;
-  regenerateWidgets |= (barC != barCount());
-  regenerateWidgets |= (fftC != fftCount());
-  regenerateWidgets |= (gpsC != gpsCount());
-  regenerateWidgets |= (ledC != ledCount());
-  regenerateWidgets |= (plotC != plotCount());
-  regenerateWidgets |= (gaugeC != gaugeCount());
-  regenerateWidgets |= (groupC != groupCount());
-  regenerateWidgets |= (compassC != compassCount());
-  regenerateWidgets |= (gyroscopeC != gyroscopeCount());
-  regenerateWidgets |= (multiPlotC != multiPlotCount());
-  regenerateWidgets |= (accelerometerC != accelerometerCount());
+  if (schemaChanged)
+  {
+    regenerateWidgets |= (barC != barCount());
+    regenerateWidgets |= (fftC != fftCount());
+    regenerateWidgets |= (gpsC != gpsCount());
+    regenerateWidgets |= (ledC != ledCount());
+    regenerateWidgets |= (plotC != plotCount());
+    regenerateWidgets |= (gaugeC != gaugeCount());
+    regenerateWidgets |= (groupC != groupCount());
+    regenerateWidgets |= (compassC != compassCount());
+    regenerateWidgets |= (gyroscopeC != gyroscopeCount());
+    regenerateWidgets |= (multiPlotC != multiPlotCount());
+    regenerateWidgets |= (xyPlotC != xyPlotCount());
+    regenerateWidgets |= (heatmapC != heatmapCount());
+    regenerateWidgets |= (waterfallC != waterfallCount());
+    regenerateWidgets |= (statisticsC != statisticsCount());
+    regenerateWidgets |= (histogramC != histogramCount());
+    regenerateWidgets |= (accelerometerC != accelerometerCount());
+  }
 
   // Regenerate widget visiblity models
   if (regenerateWidgets)
@@ -814,6 +1740,11 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
     m_compassVisibility.resize(compassCount());
     m_gyroscopeVisibility.resize(gyroscopeCount());
     m_multiPlotVisibility.resize(multiPlotCount());
+    m_xyPlotVisibility.resize(xyPlotCount());
+    m_heatmapVisibility.resize(heatmapCount());
+    m_waterfallVisibility.resize(waterfallCount());
+    m_statisticsVisibility.resize(statisticsCount());
+    m_histogramVisibility.resize(histogramCount());
     m_accelerometerVisibility.resize(accelerometerCount());
     std::fill(m_barVisibility.begin(), m_barVisibility.end(), 1);
     std::fill(m_fftVisibility.begin(), m_fftVisibility.end(), 1);
@@ -825,6 +1756,11 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
     std::fill(m_compassVisibility.begin(), m_compassVisibility.end(), 1);
     std::fill(m_gyroscopeVisibility.begin(), m_gyroscopeVisibility.end(), 1);
     std::fill(m_multiPlotVisibility.begin(), m_multiPlotVisibility.end(), 1);
+    std::fill(m_xyPlotVisibility.begin(), m_xyPlotVisibility.end(), 1);
+    std::fill(m_heatmapVisibility.begin(), m_heatmapVisibility.end(), 1);
+    std::fill(m_waterfallVisibility.begin(), m_waterfallVisibility.end(), 1);
+    std::fill(m_statisticsVisibility.begin(), m_statisticsVisibility.end(), 1);
+    std::fill(m_histogramVisibility.begin(), m_histogramVisibility.end(), 1);
     std::fill(m_accelerometerVisibility.begin(),
               m_accelerometerVisibility.end(), 1);
 
@@ -832,8 +1768,12 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
     Q_EMIT widgetVisibilityChanged();
   }
 
-  // Update UI;
-  Q_EMIT updated();
+  // Schedule UI update & report processing time
+  m_updateRequired = true;
+  const auto nsecs = timer.nsecsElapsed();
+  Misc::TimerEvents::instance().reportRenderLoad(nsecs);
+  Misc::Diagnostics::instance().record(
+      Misc::Diagnostics::Stage::DashboardUpdate, nsecs);
 }
 
 //----------------------------------------------------------------------------------------
@@ -841,55 +1781,369 @@ void UI::Dashboard::processLatestJSON(const QJsonObject &json)
 //----------------------------------------------------------------------------------------
 
 /**
- * Returns a group with all the datasets that need to be shown in the LED status
- * panel.
+ * Regenerates the index lists that map each widget to the group or dataset of
+ * the current frame that it displays. This function is only called when the
+ * structure of the received frames changes, so that the frame does not need to
+ * be walked (and its groups & datasets copied) for every update.
+ */
+void UI::Dashboard::updateWidgetIndexes()
+{
+  // Save schema of the current frame
+  m_schemaHash = m_currentFrame.schemaHash();
+
+  // Update widget index lists
+  m_fftWidgets = getFFTWidgets();
+  m_ledDatasets = getLEDDatasets();
+  m_plotWidgets = getPlotWidgets();
+  m_groupWidgets = getWidgetGroups("");
+  m_gpsWidgets = getWidgetGroups("map");
+  m_barWidgets = getWidgetDatasets("bar");
+  m_gaugeWidgets = getWidgetDatasets("gauge");
+  m_gyroscopeWidgets = getWidgetGroups("gyro");
+  m_compassWidgets = getWidgetDatasets("compass");
+  m_waterfallWidgets = getWidgetDatasets("waterfall");
+  m_histogramWidgets = getWidgetDatasets("histogram");
+  m_multiPlotWidgets = getWidgetGroups("multiplot");
+  m_xyPlotWidgets = getWidgetGroups("xy");
+  m_heatmapWidgets = getWidgetGroups("heatmap");
+  m_statisticsWidgets = getWidgetGroups("stats");
+  m_accelerometerWidgets = getWidgetGroups("accelerometer");
+
+  // Frame structure changed, reset the statistics, histograms & point clouds
+  m_histograms.clear();
+  m_pointClouds.clear();
+  m_statistics.setChannels(m_currentFrame.values().count());
+
+  // Add accelerometer widgets to multiplot
+  for (int i = 0; i < m_accelerometerWidgets.count(); ++i)
+    m_multiPlotWidgets.append(m_accelerometerWidgets.at(i));
+
+  // Add gyroscope widgets to multiplot
+  for (int i = 0; i < m_gyroscopeWidgets.count(); ++i)
+    m_multiPlotWidgets.append(m_gyroscopeWidgets.at(i));
+
+  // Map the plots & multiplots to the plot history
+  updateHistoryIndexes();
+
+  // Generate the group displayed by the LED status panel
+  m_ledWidgets.clear();
+  if (m_ledDatasets.count() > 0)
+  {
+    JSON::Group group;
+    group.m_title = tr("Status Panel");
+    for (int i = 0; i < m_ledDatasets.count(); ++i)
+    {
+      const auto &index = m_ledDatasets.at(i);
+      auto dataset = getDataset(index);
+      dataset.setTitle(dataset.title() + " ("
+                       + m_currentFrame.getGroup(index.first).title() + ")");
+      group.m_datasets.append(dataset);
+    }
+
+    m_ledWidgets.append(group);
+  }
+}
+
+/**
+ * Regenerates the list of datasets that have a plot history & maps each plot
+ * and each multiplot curve to its history. Datasets displayed by several
+ * widgets (e.g. a plot and a multiplot, or an accelerometer) are only stored
+ * once, widgets that need normalized values do so when drawing.
+ */
+void UI::Dashboard::updateHistoryIndexes()
+{
+  // Reset index lists
+  const auto previous = m_historyDatasets;
+  m_historyDatasets.clear();
+  m_plotHistoryIndexes.clear();
+  m_multiPlotHistoryIndexes.clear();
+
+  // Returns the history index of a dataset, registering it if needed
+  QHash<DatasetIndex, int> indexes;
+  auto historyIndex = [&](const DatasetIndex &dataset) {
+    auto it = indexes.constFind(dataset);
+    if (it != indexes.constEnd())
+      return it.value();
+
+    const int index = m_historyDatasets.count();
+    m_historyDatasets.append(dataset);
+    indexes.insert(dataset, index);
+    return index;
+  };
+
+  // Register plot datasets
+  for (int i = 0; i < m_plotWidgets.count(); ++i)
+    m_plotHistoryIndexes.append(historyIndex(m_plotWidgets.at(i)));
+
+  // Register multiplot, accelerometer & gyroscope datasets
+  for (int i = 0; i < m_multiPlotWidgets.count(); ++i)
+  {
+    QVector<int> curves;
+    const int group = m_multiPlotWidgets.at(i);
+    const int count = m_currentFrame.getGroup(group).datasetCount();
+    for (int j = 0; j < count; ++j)
+      curves.append(historyIndex(qMakePair(group, j)));
+
+    m_multiPlotHistoryIndexes.append(curves);
+  }
+
+  // Plotted datasets changed, discard the history
+  if (previous != m_historyDatasets)
+  {
+    m_plotHistory.clear();
+    resetReference();
+  }
+
+  // Apply changes to the number of points of each dataset
+  else
+  {
+    for (int i = 0; i < m_plotHistory.count(); ++i)
+    {
+      const int points = historyPoints(i);
+      if (m_plotHistory.at(i).recent().size() != points)
+        m_plotHistory[i].setPoints(points, 0.0001);
+    }
+  }
+}
+
+/**
+ * Returns the number of full resolution samples kept in the plot history
+ * with the given @a index: the number of points of its dataset, or the
+ * number of points selected by the user if the dataset does not set one.
+ *
+ * Only the datasets that need a long history allocate it, instead of every
+ * plotted dataset using the largest number of points.
+ */
+int UI::Dashboard::historyPoints(const int index) const
+{
+  const int points = getDataset(m_historyDatasets.at(index)).points();
+  return points > 0 ? points : m_points;
+}
+
+/**
+ * Compares the values of the current frame with the values displayed during
+ * the previous update & registers a new revision for the datasets whose
+ * displayed value changed (see @c revision()).
  *
- * @note We return a vector with a single group item because we want to display
- * a title on the window without breaking the current software architecture.
+ * Numeric values are compared after rounding them to the number of decimal
+ * places selected by the user, so noise below the display precision does not
+ * cause the widgets to be updated. Other values are compared as text.
  */
-QVector<JSON::Group> UI::Dashboard::getLEDWidgets()
+void UI::Dashboard::updateRevisions()
 {
-  QVector<JSON::Dataset> widgets;
-  Q_FOREACH (auto group, m_currentFrame.groups())
+  // Register a new revision
+  ++m_revision;
+
+  // Frame structure or display precision changed, every value is new
+  const auto &values = m_currentFrame.values();
+  const bool reset = m_displayedValues.count() != values.count()
+                     || m_groupRevisions.count() != m_currentFrame.groupCount();
+  if (reset)
+  {
+    m_displayedText.fill(QString(), values.count());
+    m_valueRevisions.fill(m_revision, values.count());
+    m_groupRevisions.fill(m_revision, m_currentFrame.groupCount());
+    m_displayedValues.fill(qQNaN(), values.count());
+  }
+
+  // Compare the displayed representation of each value, at least two decimal
+  // places are used so that LEDs never miss a transition around their 0.1
+  // threshold when the user selects a low display precision
+  const double scale = qPow(10, qMax(2, m_precision));
+  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
   {
-    Q_FOREACH (auto dataset, group.datasets())
+    const auto &group = m_currentFrame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
     {
-      if (dataset.led())
+      bool changed = reset;
+      const auto &dataset = group.getDataset(j);
+      const int index = m_currentFrame.valueIndex(i, j);
+      if (dataset.isNumeric())
       {
-        dataset.setTitle(dataset.title() + " (" + group.title() + ")");
-        widgets.append(dataset);
+        const double value = std::floor(values.at(index) * scale + 0.5);
+        if (value != m_displayedValues.at(index))
+        {
+          changed = true;
+          m_displayedValues[index] = value;
+        }
+      }
+
+      else if (dataset.value() != m_displayedText.at(index))
+      {
+        changed = true;
+        m_displayedText[index] = dataset.value();
+      }
+
+      if (changed)
+      {
+        m_valueRevisions[index] = m_revision;
+        m_groupRevisions[i] = m_revision;
       }
     }
   }
+}
+
+/**
+ * Returns the revision in which the displayed value of the dataset located at
+ * the given @a index last changed.
+ */
+quint64 UI::Dashboard::datasetRevision(const DatasetIndex &index) const
+{
+  const int i = m_currentFrame.valueIndex(index.first, index.second);
+  if (i < 0 || i >= m_valueRevisions.count())
+    return m_revision;
+
+  return m_valueRevisions.at(i);
+}
 
-  QVector<JSON::Group> groups;
-  if (widgets.count() > 0)
+/**
+ * Returns the revision in which the displayed value of the given @a dataset
+ * of the given @a group of the current frame last changed.
+ */
+quint64 UI::Dashboard::valueRevision(const int group, const int dataset) const
+{
+  return datasetRevision(DatasetIndex(group, dataset));
+}
+
+/**
+ * Returns the revision registered during the last update of the widgets, the
+ * datasets whose value revision matches it changed during that update.
+ */
+quint64 UI::Dashboard::currentRevision() const
+{
+  return m_revision;
+}
+
+/**
+ * Returns the revision in which the displayed values of the widget of the
+ * given @a type & @a index last changed. For group widgets, a @a dataset can
+ * be specified to obtain the revision of a single dataset of the group.
+ *
+ * Widgets store the revision that they displayed & skip text updates and
+ * repaints while it does not change, so dashboards that mostly display
+ * constant values are (almost) free to update. Plots always change, so the
+ * latest revision is returned for them.
+ */
+quint64 UI::Dashboard::revision(const WidgetType type, const int index,
+                                const int dataset) const
+{
+  // Get the frame group displayed by group widgets
+  int group = -1;
+  switch (type)
   {
-    JSON::Group group;
-    group.m_title = tr("Status Panel");
-    group.m_datasets = widgets;
-    groups.append(group);
+    case WidgetType::Group:
+      group = m_groupWidgets.value(index, -1);
+      break;
+    case WidgetType::Gyroscope:
+      group = m_gyroscopeWidgets.value(index, -1);
+      break;
+    case WidgetType::Accelerometer:
+      group = m_accelerometerWidgets.value(index, -1);
+      break;
+    case WidgetType::Statistics:
+      group = m_statisticsWidgets.value(index, -1);
+      break;
+    case WidgetType::GPS:
+      group = m_gpsWidgets.value(index, -1);
+      break;
+    case WidgetType::Bar:
+      if (index >= 0 && index < m_barWidgets.count())
+        return datasetRevision(m_barWidgets.at(index));
+      return m_revision;
+    case WidgetType::Gauge:
+      if (index >= 0 && index < m_gaugeWidgets.count())
+        return datasetRevision(m_gaugeWidgets.at(index));
+      return m_revision;
+    case WidgetType::Compass:
+      if (index >= 0 && index < m_compassWidgets.count())
+        return datasetRevision(m_compassWidgets.at(index));
+      return m_revision;
+    case WidgetType::LED:
+      if (dataset >= 0 && dataset < m_ledDatasets.count())
+        return datasetRevision(m_ledDatasets.at(dataset));
+      else
+      {
+        quint64 revision = 0;
+        for (int i = 0; i < m_ledDatasets.count(); ++i)
+          revision = qMax(revision, datasetRevision(m_ledDatasets.at(i)));
+
+        return m_ledDatasets.isEmpty() ? m_revision : revision;
+      }
+    default:
+      return m_revision;
   }
 
-  return groups;
+  // Invalid group index
+  if (group < 0 || group >= m_groupRevisions.count())
+    return m_revision;
+
+  // Return revision of the whole group, or of one of its datasets
+  if (dataset < 0)
+    return m_groupRevisions.at(group);
+
+  return datasetRevision(qMakePair(group, dataset));
 }
 
 /**
- * Returns a vector with all the datasets that need to be shown in the FFT
+ * Copies the current values of the LED datasets to the group displayed by the
+ * LED status panel.
+ */
+void UI::Dashboard::updateLEDWidgets()
+{
+  if (m_ledWidgets.isEmpty())
+    return;
+
+  auto &datasets = m_ledWidgets.first().m_datasets;
+  for (int i = 0; i < m_ledDatasets.count(); ++i)
+    datasets[i].setValue(getDataset(m_ledDatasets.at(i)).value());
+}
+
+/**
+ * Returns the dataset of the current frame located at the given @a index.
+ */
+const JSON::Dataset &UI::Dashboard::getDataset(const DatasetIndex &index) const
+{
+  return m_currentFrame.getGroup(index.first).getDataset(index.second);
+}
+
+/**
+ * Returns the indexes of all the datasets that need to be shown in the LED
+ * status panel.
+ *
+ * @note The LED status panel is displayed as a single group because we want to
+ * display a title on the window without breaking the current software
+ * architecture.
+ */
+QVector<UI::Dashboard::DatasetIndex> UI::Dashboard::getLEDDatasets()
+{
+  QVector<DatasetIndex> widgets;
+  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
+  {
+    const auto &group = m_currentFrame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      if (group.getDataset(j).led())
+        widgets.append(qMakePair(i, j));
+    }
+  }
+
+  return widgets;
+}
+
+/**
+ * Returns the indexes of all the datasets that need to be shown in the FFT
  * widgets.
  */
-QVector<JSON::Dataset> UI::Dashboard::getFFTWidgets()
+QVector<UI::Dashboard::DatasetIndex> UI::Dashboard::getFFTWidgets()
 {
-  QVector<JSON::Dataset> widgets;
-  Q_FOREACH (auto group, m_currentFrame.groups())
+  QVector<DatasetIndex> widgets;
+  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
   {
-    Q_FOREACH (auto dataset, group.datasets())
+    const auto &group = m_currentFrame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
     {
-      if (dataset.fft())
-      {
-        dataset.setTitle(dataset.title() + " (" + group.title() + ")");
-        widgets.append(dataset);
-      }
+      if (group.getDataset(j).fft())
+        widgets.append(qMakePair(i, j));
     }
   }
 
@@ -897,20 +2151,18 @@ QVector<JSON::Dataset> UI::Dashboard::getFFTWidgets()
 }
 
 /**
- * Returns a vector with all the datasets that need to be plotted.
+ * Returns the indexes of all the datasets that need to be plotted.
  */
-QVector<JSON::Dataset> UI::Dashboard::getPlotWidgets()
+QVector<UI::Dashboard::DatasetIndex> UI::Dashboard::getPlotWidgets()
 {
-  QVector<JSON::Dataset> widgets;
-  Q_FOREACH (auto group, m_currentFrame.groups())
+  QVector<DatasetIndex> widgets;
+  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
   {
-    Q_FOREACH (auto dataset, group.datasets())
+    const auto &group = m_currentFrame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
     {
-      if (dataset.graph())
-      {
-        dataset.setTitle(dataset.title() + " (" + group.title() + ")");
-        widgets.append(dataset);
-      }
+      if (group.getDataset(j).graph())
+        widgets.append(qMakePair(i, j));
     }
   }
 
@@ -918,39 +2170,38 @@ QVector<JSON::Dataset> UI::Dashboard::getPlotWidgets()
 }
 
 /**
- * Returns a vector with all the groups that implement the widget with the
+ * Returns the indexes of all the groups that implement the widget with the
  * specied
  * @a handle.
  */
-QVector<JSON::Group> UI::Dashboard::getWidgetGroups(const QString &handle)
+QVector<int> UI::Dashboard::getWidgetGroups(const QString &handle)
 {
-  QVector<JSON::Group> widgets;
-  Q_FOREACH (auto group, m_currentFrame.groups())
+  QVector<int> widgets;
+  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
   {
-    if (group.widget() == handle)
-      widgets.append(group);
+    if (m_currentFrame.getGroup(i).widget() == handle)
+      widgets.append(i);
   }
 
   return widgets;
 }
 
 /**
- * Returns a vector with all the datasets that implement a widget with the
+ * Returns the indexes of all the datasets that implement a widget with the
  * specified
  * @a handle.
  */
-QVector<JSON::Dataset> UI::Dashboard::getWidgetDatasets(const QString &handle)
+QVector<UI::Dashboard::DatasetIndex>
+UI::Dashboard::getWidgetDatasets(const QString &handle)
 {
-  QVector<JSON::Dataset> widgets;
-  Q_FOREACH (auto group, m_currentFrame.groups())
+  QVector<DatasetIndex> widgets;
+  for (int i = 0; i < m_currentFrame.groupCount(); ++i)
   {
-    Q_FOREACH (auto dataset, group.datasets())
+    const auto &group = m_currentFrame.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
     {
-      if (dataset.widget() == handle)
-      {
-        dataset.setTitle(dataset.title() + " (" + group.title() + ")");
-        widgets.append(dataset);
-      }
+      if (group.getDataset(j).widget() == handle)
+        widgets.append(qMakePair(i, j));
     }
   }
 
@@ -958,13 +2209,31 @@ QVector<JSON::Dataset> UI::Dashboard::getWidgetDatasets(const QString &handle)
 }
 
 /**
- * Returns the titles of the datasets contained in the specified @a vector.
+ * Returns the titles of the datasets located at the indexes contained in the
+ * specified @a vector, followed by the title of their group.
+ */
+StringList UI::Dashboard::datasetTitles(const QVector<DatasetIndex> &vector)
+{
+  StringList list;
+  for (int i = 0; i < vector.count(); ++i)
+  {
+    const auto &index = vector.at(i);
+    list.append(getDataset(index).title() + " ("
+                + m_currentFrame.getGroup(index.first).title() + ")");
+  }
+
+  return list;
+}
+
+/**
+ * Returns the titles of the groups located at the indexes contained in the
+ * specified @a vector.
  */
-StringList UI::Dashboard::datasetTitles(const QVector<JSON::Dataset> &vector)
+StringList UI::Dashboard::groupTitles(const QVector<int> &vector)
 {
   StringList list;
-  Q_FOREACH (auto set, vector)
-    list.append(set.title());
+  for (int i = 0; i < vector.count(); ++i)
+    list.append(m_currentFrame.getGroup(vector.at(i)).title());
 
   return list;
 }
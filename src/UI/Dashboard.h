@@ -24,11 +24,28 @@
 
 #include <QFont>
 #include <QObject>
+#include <QJsonArray>
+#include <QVariantMap>
 #include <DataTypes.h>
 #include <JSON/Frame.h>
+#include <JSON/SinkGraph.h>
+#include <UI/GpsTrack.h>
+#include <UI/PlotBuffer.h>
+#include <UI/PlotHistory.h>
+#include <UI/Histogram.h>
+#include <UI/PointCloud.h>
+#include <UI/Statistics.h>
+#include <Misc/Settings.h>
+
+namespace Misc
+{
+class Benchmark;
+}
 
 namespace UI
 {
+class DashboardExporter;
+
 /**
  * @brief The Dashboard class
  *
@@ -51,12 +68,12 @@ namespace UI
  * - @c Dashboard::getWidgetGroups()
  * - @c Dashboard::getDatasetWidget()
  * - @c Dashboard::getWidgetDatasets()
- * - @c Dashboard::processLatestJSON()
+ * - @c Dashboard::processFrames()
  *
  * The rest of the functions of this class rely on the procedures above in order
  * to implement common functionality features for each widget type.
  */
-class Dashboard : public QObject
+class Dashboard : public QObject, public JSON::FrameSink
 {
   // clang-format off
     Q_OBJECT
@@ -70,10 +87,45 @@ class Dashboard : public QObject
                READ points
                WRITE setPoints
                NOTIFY pointsChanged)
+    Q_PROPERTY(int timeWindow
+               READ timeWindow
+               WRITE setTimeWindow
+               NOTIFY timeWindowChanged)
+    Q_PROPERTY(int xyPoints
+               READ xyPoints
+               WRITE setXYPoints
+               NOTIFY xyPointsChanged)
+    Q_PROPERTY(bool viewPaused
+               READ viewPaused
+               WRITE setViewPaused
+               NOTIFY viewChanged)
+    Q_PROPERTY(double viewOffset
+               READ viewOffset
+               WRITE setViewOffset
+               NOTIFY viewChanged)
+    Q_PROPERTY(double viewHistory
+               READ viewHistory
+               NOTIFY viewChanged)
     Q_PROPERTY(int precision
                READ precision
                WRITE setPrecision
                NOTIFY precisionChanged)
+    Q_PROPERTY(bool nativeRendering
+               READ nativeRendering
+               WRITE setNativeRendering
+               NOTIFY nativeRenderingChanged)
+    Q_PROPERTY(bool parallelRendering
+               READ parallelRendering
+               WRITE setParallelRendering
+               NOTIFY parallelRenderingChanged)
+    Q_PROPERTY(bool openGLRendering
+               READ openGLRendering
+               WRITE setOpenGLRendering
+               NOTIFY openGLRenderingChanged)
+    Q_PROPERTY(bool renderCostOverlay
+               READ renderCostOverlay
+               WRITE setRenderCostOverlay
+               NOTIFY renderCostOverlayChanged)
     Q_PROPERTY(int totalWidgetCount
                READ totalWidgetCount
                NOTIFY widgetCountChanged)
@@ -89,6 +141,9 @@ class Dashboard : public QObject
     Q_PROPERTY(int fftCount
                READ fftCount
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(int waterfallCount
+               READ waterfallCount
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(int plotCount
                READ plotCount
                NOTIFY widgetCountChanged)
@@ -101,15 +156,27 @@ class Dashboard : public QObject
     Q_PROPERTY(int compassCount
                READ compassCount
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(int histogramCount
+               READ histogramCount
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(int gyroscopeCount
                READ gyroscopeCount
                NOTIFY widgetCountChanged)
     Q_PROPERTY(int multiPlotCount
                READ multiPlotCount
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(int xyPlotCount
+               READ xyPlotCount
+               NOTIFY widgetCountChanged)
+    Q_PROPERTY(int heatmapCount
+               READ heatmapCount
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(int accelerometerCount
                READ accelerometerCount
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(int statisticsCount
+               READ statisticsCount
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(StringList gpsTitles
                READ gpsTitles
                NOTIFY widgetCountChanged)
@@ -122,6 +189,9 @@ class Dashboard : public QObject
     Q_PROPERTY(StringList fftTitles
                READ fftTitles
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(StringList waterfallTitles
+               READ waterfallTitles
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(StringList plotTitles
                READ plotTitles
                NOTIFY widgetCountChanged)
@@ -134,15 +204,27 @@ class Dashboard : public QObject
     Q_PROPERTY(StringList compassTitles
                READ compassTitles
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(StringList histogramTitles
+               READ histogramTitles
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(StringList gyroscopeTitles
                READ gyroscopeTitles
                NOTIFY widgetCountChanged)
     Q_PROPERTY(StringList multiPlotTitles
                READ multiPlotTitles
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(StringList xyPlotTitles
+               READ xyPlotTitles
+               NOTIFY widgetCountChanged)
+    Q_PROPERTY(StringList heatmapTitles
+               READ heatmapTitles
+               NOTIFY widgetCountChanged)
     Q_PROPERTY(StringList accelerometerTitles
                READ accelerometerTitles
                NOTIFY widgetCountChanged)
+    Q_PROPERTY(StringList statisticsTitles
+               READ statisticsTitles
+               NOTIFY widgetCountChanged)
   // clang-format on
 
 Q_SIGNALS:
@@ -151,7 +233,14 @@ Q_SIGNALS:
   void titleChanged();
   void pointsChanged();
   void precisionChanged();
+  void timeWindowChanged();
+  void xyPointsChanged();
+  void viewChanged();
   void widgetCountChanged();
+  void nativeRenderingChanged();
+  void parallelRenderingChanged();
+  void openGLRenderingChanged();
+  void renderCostOverlayChanged();
   void widgetVisibilityChanged();
 
 private:
@@ -166,13 +255,18 @@ public:
   {
     Group,
     MultiPlot,
+    XYPlot,
+    Heatmap,
     FFT,
+    Waterfall,
     Plot,
     Bar,
     Gauge,
     Compass,
+    Histogram,
     Gyroscope,
     Accelerometer,
+    Statistics,
     GPS,
     LED,
     Unknown
@@ -181,6 +275,9 @@ public:
 
   static Dashboard &instance();
 
+  QString sinkName() const override;
+  void consumeFrames(const QVector<JSON::Frame> &frames) override;
+
   QFont monoFont() const;
   const JSON::Group &getLED(const int index) const;
   const JSON::Group &getGPS(const int index) const;
@@ -192,12 +289,40 @@ public:
   const JSON::Group &getGyroscope(const int index) const;
   const JSON::Dataset &getCompass(const int index) const;
   const JSON::Group &getMultiplot(const int index) const;
+  const JSON::Group &getXYPlot(const int index) const;
+  const JSON::Group &getHeatmap(const int index) const;
   const JSON::Group &getAccelerometer(const int index) const;
+  const JSON::Dataset &getWaterfall(const int index) const;
+  const JSON::Group &getStatistics(const int index) const;
+  const JSON::Dataset &getHistogram(const int index) const;
+
+  int plotHistoryIndex(const int index) const;
+  int multiPlotHistoryIndex(const int index, const int dataset) const;
+  int groupValueIndex(const int index) const;
+  int statisticsValueIndex(const int index) const;
+  int heatmapValueIndex(const int index) const;
+  quint64 revision(const WidgetType type, const int index,
+                   const int dataset = -1) const;
+  quint64 valueRevision(const int group, const int dataset) const;
+  quint64 currentRevision() const;
 
   QString title();
   bool available();
   int points() const;
   int precision() const;
+  int timeWindow() const;
+  int xyPoints() const;
+  bool viewPaused() const;
+  double viewOffset() const;
+  double viewHistory() const;
+  qint64 viewEndTime() const;
+  qint64 frameTimestamp() const;
+  bool nativeRendering() const;
+  bool parallelRendering() const;
+  bool openGLRendering() const;
+  bool renderCostOverlay() const;
+  bool renderingSuspended() const;
+  qint64 allocatedBytes() const;
 
   int totalWidgetCount() const;
   int gpsCount() const;
@@ -210,7 +335,12 @@ public:
   int compassCount() const;
   int gyroscopeCount() const;
   int multiPlotCount() const;
+  int xyPlotCount() const;
+  int heatmapCount() const;
   int accelerometerCount() const;
+  int waterfallCount() const;
+  int statisticsCount() const;
+  int histogramCount() const;
 
   Q_INVOKABLE bool frameValid() const;
   Q_INVOKABLE StringList widgetTitles();
@@ -229,7 +359,15 @@ public:
   Q_INVOKABLE bool compassVisible(const int index) const;
   Q_INVOKABLE bool gyroscopeVisible(const int index) const;
   Q_INVOKABLE bool multiPlotVisible(const int index) const;
+  Q_INVOKABLE bool xyPlotVisible(const int index) const;
+  Q_INVOKABLE bool heatmapVisible(const int index) const;
   Q_INVOKABLE bool accelerometerVisible(const int index) const;
+  Q_INVOKABLE bool waterfallVisible(const int index) const;
+  Q_INVOKABLE bool statisticsVisible(const int index) const;
+  Q_INVOKABLE bool histogramVisible(const int index) const;
+
+  Q_INVOKABLE QVariantMap datasetStatistics(const int group,
+                                            const int dataset) const;
 
   StringList barTitles();
   StringList fftTitles();
@@ -241,16 +379,38 @@ public:
   StringList compassTitles();
   StringList gyroscopeTitles();
   StringList multiPlotTitles();
+  StringList xyPlotTitles();
+  StringList heatmapTitles();
   StringList accelerometerTitles();
+  StringList waterfallTitles();
+  StringList statisticsTitles();
+  StringList histogramTitles();
 
   const PlotData &xPlotValues() { return m_xData; }
   const JSON::Frame &currentFrame() { return m_currentFrame; }
-  const QVector<PlotData> &fftPlotValues() { return m_fftPlotValues; }
-  const QVector<PlotData> &linearPlotValues() { return m_linearPlotValues; }
+  const QVector<PlotBuffer> &fftPlotValues() { return m_fftPlotValues; }
+  const QVector<PlotHistory> &plotHistory() { return m_plotHistory; }
+  const QVector<PlotHistory> &referenceHistory() { return m_referenceHistory; }
+  const QVector<PlotBuffer> &waterfallValues() { return m_waterfallValues; }
+  const QVector<Histogram> &histograms() { return m_histograms; }
+  const QVector<PointCloud> &pointClouds() { return m_pointClouds; }
+  const QVector<GpsTrack> &gpsTracks() { return m_gpsTracks; }
+  const Statistics &statistics() const { return m_statistics; }
+
+  QJsonArray statisticsSnapshot() const;
 
 public Q_SLOTS:
   void setPoints(const int points);
   void setPrecision(const int precision);
+  void setTimeWindow(const int seconds);
+  void setXYPoints(const int points);
+  void setViewPaused(const bool paused);
+  void setViewOffset(const double seconds);
+  void setNativeRendering(const bool enabled);
+  void setParallelRendering(const bool enabled);
+  void setOpenGLRendering(const bool enabled);
+  void setRenderCostOverlay(const bool enabled);
+  void setRenderingSuspended(const bool suspended);
   void setBarVisible(const int index, const bool visible);
   void setFFTVisible(const int index, const bool visible);
   void setGpsVisible(const int index, const bool visible);
@@ -261,22 +421,46 @@ public Q_SLOTS:
   void setCompassVisible(const int index, const bool visible);
   void setGyroscopeVisible(const int index, const bool visible);
   void setMultiplotVisible(const int index, const bool visible);
+  void setXYPlotVisible(const int index, const bool visible);
+  void setHeatmapVisible(const int index, const bool visible);
   void setAccelerometerVisible(const int index, const bool visible);
+  void setWaterfallVisible(const int index, const bool visible);
+  void setStatisticsVisible(const int index, const bool visible);
+  void setHistogramVisible(const int index, const bool visible);
+  void resetStatistics();
 
 private Q_SLOTS:
   void resetData();
+  void onProjectChanged();
   void updatePlots();
-  void processLatestJSON(const QJsonObject &json);
+  void resetReference();
+  void updateWidgets();
+  void processFrames(const QVector<JSON::Frame> &frames);
 
 private:
-  QVector<JSON::Group> getLEDWidgets();
-  QVector<JSON::Dataset> getFFTWidgets();
-  QVector<JSON::Dataset> getPlotWidgets();
-  QVector<JSON::Group> getWidgetGroups(const QString &handle);
-  QVector<JSON::Dataset> getWidgetDatasets(const QString &handle);
+  friend class Misc::Benchmark;
+  friend class UI::DashboardExporter;
+  typedef QPair<int, int> DatasetIndex;
+
+  void updateWidgetIndexes();
+  void updateHistoryIndexes();
+  int historyPoints(const int index) const;
+  void updateRevisions();
+  void updateGpsTracks();
+  void updateReference();
+  void updateLEDWidgets();
+  quint64 datasetRevision(const DatasetIndex &index) const;
+  const JSON::Dataset &getDataset(const DatasetIndex &index) const;
 
+  QVector<DatasetIndex> getLEDDatasets();
+  QVector<DatasetIndex> getFFTWidgets();
+  QVector<DatasetIndex> getPlotWidgets();
+  QVector<int> getWidgetGroups(const QString &handle);
+  QVector<DatasetIndex> getWidgetDatasets(const QString &handle);
+
+  StringList groupTitles(const QVector<int> &vector);
   StringList groupTitles(const QVector<JSON::Group> &vector);
-  StringList datasetTitles(const QVector<JSON::Dataset> &vector);
+  StringList datasetTitles(const QVector<DatasetIndex> &vector);
 
   bool getVisibility(const QVector<bool> &vector, const int index) const;
   void setVisibility(QVector<bool> &vector, const int index,
@@ -285,10 +469,44 @@ private:
 private:
   int m_points;
   int m_precision;
+  int m_timeWindow;
+  int m_xyPoints;
+  qint64 m_frameTimestamp;
+  bool m_viewPaused;
+  bool m_viewChanged;
+  double m_viewOffset;
+  qint64 m_pauseTime;
+  JSON::Frame m_pausedFrame;
+  bool m_updateRequired;
+  bool m_nativeRendering;
+  bool m_parallelRendering;
+  bool m_openGLRendering;
+  bool m_renderCostOverlay;
+  bool m_renderingSuspended;
+  Misc::Settings m_settings;
   PlotData m_xData;
-  QVector<PlotData> m_fftPlotValues;
-  QVector<PlotData> m_linearPlotValues;
-  QVector<QVector<PlotData>> m_multiplotValues;
+  QVector<PlotBuffer> m_fftPlotValues;
+  QVector<PlotHistory> m_plotHistory;
+  QVector<PlotHistory> m_referenceHistory;
+  QVector<PlotBuffer> m_waterfallValues;
+  QVector<Histogram> m_histograms;
+  QVector<PointCloud> m_pointClouds;
+  QVector<GpsTrack> m_gpsTracks;
+  Statistics m_statistics;
+
+  quint64 m_revision;
+  QVector<double> m_displayedValues;
+  QVector<QString> m_displayedText;
+  QVector<quint64> m_valueRevisions;
+  QVector<quint64> m_groupRevisions;
+
+  QVector<int> m_plotHistoryIndexes;
+  QVector<DatasetIndex> m_historyDatasets;
+  QVector<QVector<int>> m_multiPlotHistoryIndexes;
+
+  int m_referenceRow;
+  qint64 m_referenceOrigin;
+  QVector<int> m_referenceColumns;
 
   QVector<bool> m_barVisibility;
   QVector<bool> m_fftVisibility;
@@ -300,21 +518,35 @@ private:
   QVector<bool> m_compassVisibility;
   QVector<bool> m_gyroscopeVisibility;
   QVector<bool> m_multiPlotVisibility;
+  QVector<bool> m_xyPlotVisibility;
+  QVector<bool> m_heatmapVisibility;
   QVector<bool> m_accelerometerVisibility;
+  QVector<bool> m_waterfallVisibility;
+  QVector<bool> m_statisticsVisibility;
+  QVector<bool> m_histogramVisibility;
+
+  QVector<DatasetIndex> m_barWidgets;
+  QVector<DatasetIndex> m_fftWidgets;
+  QVector<DatasetIndex> m_ledDatasets;
+  QVector<DatasetIndex> m_plotWidgets;
+  QVector<DatasetIndex> m_gaugeWidgets;
+  QVector<DatasetIndex> m_compassWidgets;
+  QVector<DatasetIndex> m_waterfallWidgets;
+  QVector<DatasetIndex> m_histogramWidgets;
 
-  QVector<JSON::Dataset> m_barWidgets;
-  QVector<JSON::Dataset> m_fftWidgets;
-  QVector<JSON::Dataset> m_plotWidgets;
-  QVector<JSON::Dataset> m_gaugeWidgets;
-  QVector<JSON::Dataset> m_compassWidgets;
+  QVector<int> m_gpsWidgets;
+  QVector<int> m_groupWidgets;
+  QVector<int> m_multiPlotWidgets;
+  QVector<int> m_xyPlotWidgets;
+  QVector<int> m_heatmapWidgets;
+  QVector<int> m_gyroscopeWidgets;
+  QVector<int> m_accelerometerWidgets;
+  QVector<int> m_statisticsWidgets;
 
   QVector<JSON::Group> m_ledWidgets;
-  QVector<JSON::Group> m_gpsWidgets;
-  QVector<JSON::Group> m_groupWidgets;
-  QVector<JSON::Group> m_multiPlotWidgets;
-  QVector<JSON::Group> m_gyroscopeWidgets;
-  QVector<JSON::Group> m_accelerometerWidgets;
 
+  quint64 m_schemaHash;
+  JSON::Frame m_latestFrame;
   JSON::Frame m_currentFrame;
 };
 } // namespace UI
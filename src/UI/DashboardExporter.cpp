@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QHash>
+#include <QImage>
+#include <QtMath>
+#include <QWidget>
+#include <QFileInfo>
+#include <QGroupBox>
+#include <QGridLayout>
+#include <QVBoxLayout>
+#include <QCoreApplication>
+
+#include <JSON/Generator.h>
+#include <Misc/Utilities.h>
+#include <UI/Dashboard.h>
+#include <UI/DashboardWidget.h>
+#include <UI/DashboardExporter.h>
+
+/**
+ * Constructor function
+ */
+UI::DashboardExporter::DashboardExporter(const DashboardExportOptions &options)
+  : m_row(0)
+  , m_frame(0)
+  , m_progress(-1)
+  , m_startTime(0)
+  , m_options(options)
+{
+  // Video encoders require even image sizes
+  m_options.frameRate = qBound(1, m_options.frameRate, 240);
+  m_options.width = qMax(2, m_options.width) & ~1;
+  m_options.height = qMax(2, m_options.height) & ~1;
+
+  // clang-format off
+  connect(&m_csv, &CSV::CsvReader::indexed,
+          this, &UI::DashboardExporter::begin);
+  connect(&m_timer, &QTimer::timeout,
+          this, &UI::DashboardExporter::renderFrame);
+  // clang-format on
+}
+
+/**
+ * Destructor function, stops the encoder process (if running)
+ */
+UI::DashboardExporter::~DashboardExporter()
+{
+  if (m_encoder.state() != QProcess::NotRunning)
+  {
+    m_encoder.kill();
+    m_encoder.waitForFinished();
+  }
+}
+
+/**
+ * Loads the project, opens the recording & the outputs of the export. The
+ * frames are rendered once the recording is ready to be read (CSV files are
+ * indexed in the background first). Returns @c false if the export cannot
+ * be started.
+ */
+bool UI::DashboardExporter::start()
+{
+  // Print messages to the console
+  Misc::Utilities::setHeadless(true);
+
+  // Validate options
+  if (m_options.recording.isEmpty() || m_options.project.isEmpty())
+  {
+    qCritical() << "A recording & a project file are required to render "
+                   "the dashboard";
+    return false;
+  }
+
+  if (m_options.outputPath.isEmpty() && m_options.videoFile.isEmpty())
+  {
+    qCritical() << "No output directory or video file specified";
+    return false;
+  }
+
+  // Load the project & build the frame used as template for every row
+  auto &generator = JSON::Generator::instance();
+  generator.setOperationMode(JSON::Generator::kManual);
+  generator.loadJsonMap(m_options.project);
+  if (!m_template.read(generator.json()) || !m_template.isValid())
+  {
+    qCritical() << "Cannot load project file" << m_options.project;
+    return false;
+  }
+
+  // Create the image sequence directory
+  if (!m_options.outputPath.isEmpty() && !QDir().mkpath(m_options.outputPath))
+  {
+    qCritical() << "Cannot create output directory" << m_options.outputPath;
+    return false;
+  }
+
+  // Start the video encoder
+  if (!m_options.videoFile.isEmpty() && !openEncoder())
+    return false;
+
+  // Open binary recordings directly
+  const auto path = m_options.recording;
+  if (QFileInfo(path).suffix().toLower() == "ssrec")
+  {
+    if (!m_binary.open(path))
+    {
+      qCritical() << "Cannot read binary recording" << path;
+      return false;
+    }
+
+    QTimer::singleShot(0, this, &UI::DashboardExporter::begin);
+    return true;
+  }
+
+  // Index the rows of CSV files in the background
+  if (!m_csv.open(path))
+  {
+    qCritical() << "Cannot read CSV file" << path;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Matches the datasets of the project with the columns of the recording &
+ * starts rendering the frames.
+ *
+ * Columns are matched by title, the n-th dataset of the project with a given
+ * title is matched with the n-th column of the recording with the same title
+ * (see @c CSV::Reference::columns()).
+ */
+void UI::DashboardExporter::begin()
+{
+  // Nothing to render
+  if (rowCount() <= 0)
+  {
+    qCritical() << "The recording does not contain any frames";
+    finish(false);
+    return;
+  }
+
+  // Get the position of each title in the recording
+  const auto names = titles();
+  QHash<QString, QVector<int>> positions;
+  for (int i = 0; i < names.count(); ++i)
+    positions[names.at(i)].append(i);
+
+  // Match each dataset with a column of the recording
+  int matched = 0;
+  QHash<QString, int> seen;
+  m_columns.clear();
+  for (int i = 0; i < m_template.groupCount(); ++i)
+  {
+    const auto &group = m_template.getGroup(i);
+    for (int j = 0; j < group.datasetCount(); ++j)
+    {
+      int column = -1;
+      const auto title = group.getDataset(j).title();
+      const auto &list = positions.value(title);
+      const auto occurrence = seen[title]++;
+      if (!list.isEmpty())
+      {
+        column = list.at(qMin(occurrence, list.count() - 1));
+        ++matched;
+      }
+
+      m_columns.append(column);
+    }
+  }
+
+  // None of the datasets are part of the recording
+  if (matched == 0)
+  {
+    qCritical() << "The recording does not match the project file";
+    finish(false);
+    return;
+  }
+
+  // Print export configuration
+  const auto duration = (rowTime(rowCount() - 1) - rowTime(0)) / 1000.0;
+  qInfo().noquote() << QString("Rendering %1 frames (%2 s of data) at %3 "
+                               "frames/s, %4x%5 pixels")
+                           .arg(rowCount())
+                           .arg(duration, 0, 'f', 1)
+                           .arg(m_options.frameRate)
+                           .arg(m_options.width)
+                           .arg(m_options.height);
+
+  // Start rendering
+  m_row = 0;
+  m_frame = 0;
+  m_startTime = rowTime(0);
+  m_clock.start();
+  m_timer.start(0);
+}
+
+/**
+ * Hands all the rows of the recording that are due at the time of the next
+ * video frame to the dashboard, refreshes the widgets & writes the resulting
+ * image to the outputs.
+ */
+void UI::DashboardExporter::renderFrame()
+{
+  // Get the recording time of the video frame
+  auto &dashboard = UI::Dashboard::instance();
+  const auto time = m_startTime + qint64(m_frame) * 1000 / m_options.frameRate;
+
+  // Convert the rows that are due to frames
+  QVector<JSON::Frame> batch;
+  while (m_row < rowCount() && rowTime(m_row) <= time)
+  {
+    int index = 0;
+    auto frame = m_template;
+    const auto values = rowValues(m_row);
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const int count = frame.getGroup(i).datasetCount();
+      for (int j = 0; j < count; ++j, ++index)
+      {
+        const auto column = m_columns.at(index);
+        if (column >= 0 && column < values.count())
+          frame.setDatasetValue(i, j, values.at(column));
+      }
+    }
+
+    frame.setTimestamp(rowTime(m_row) * 1000);
+    batch.append(frame);
+    ++m_row;
+  }
+
+  // Update the dashboard data & construct the widgets with the first frame
+  if (!batch.isEmpty())
+  {
+    dashboard.processFrames(batch);
+    if (!m_container)
+      createWidgets();
+  }
+
+  // Refresh the widgets & grab the image
+  if (m_container)
+  {
+    dashboard.updateWidgets();
+    for (auto *widget : m_widgets)
+      widget->repaint();
+
+    const auto image = m_container->grab().toImage();
+    if (!writeImage(image.convertToFormat(QImage::Format_RGB32)))
+    {
+      finish(false);
+      return;
+    }
+  }
+
+  // Print progress every 10 %
+  ++m_frame;
+  const int progress = m_row * 10 / rowCount();
+  if (progress != m_progress)
+  {
+    m_progress = progress;
+    qInfo().noquote() << QString("%1 % (%2 images)")
+                             .arg(progress * 10)
+                             .arg(m_frame);
+  }
+
+  // All the rows have been rendered
+  if (m_row >= rowCount())
+    finish(true);
+}
+
+/**
+ * Stops rendering frames, waits for the video encoder to write the file,
+ * prints a summary & quits the application.
+ */
+void UI::DashboardExporter::finish(const bool success)
+{
+  // Stop rendering
+  m_timer.stop();
+  bool ok = success;
+
+  // Wait for the encoder to process the remaining images
+  if (m_encoder.state() != QProcess::NotRunning)
+  {
+    m_encoder.closeWriteChannel();
+    m_encoder.waitForFinished(-1);
+    if (m_encoder.exitStatus() != QProcess::NormalExit
+        || m_encoder.exitCode() != 0)
+    {
+      qCritical().noquote() << m_encoder.readAllStandardError();
+      qCritical() << "Video encoder failed";
+      ok = false;
+    }
+  }
+
+  // Print summary
+  if (ok)
+  {
+    const auto seconds = qMax<qint64>(1, m_clock.elapsed()) / 1000.0;
+    const auto duration = m_frame / double(m_options.frameRate);
+    qInfo().noquote() << QString("Rendered %1 images in %2 s (%3x real time)")
+                             .arg(m_frame)
+                             .arg(seconds, 0, 'f', 2)
+                             .arg(duration / seconds, 0, 'f', 1);
+  }
+
+  // Quit the application
+  QCoreApplication::exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/**
+ * Starts the video encoder process, which reads raw images from its standard
+ * input & writes the video file.
+ */
+bool UI::DashboardExporter::openEncoder()
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+  const auto format = QStringLiteral("bgra");
+#else
+  const auto format = QStringLiteral("argb");
+#endif
+
+  // clang-format off
+  const auto size = QString("%1x%2").arg(m_options.width)
+                                    .arg(m_options.height);
+  const QStringList arguments = {
+    "-y", "-loglevel", "error",
+    "-f", "rawvideo", "-pix_fmt", format, "-s", size,
+    "-r", QString::number(m_options.frameRate), "-i", "-",
+    "-pix_fmt", "yuv420p", m_options.videoFile
+  };
+  // clang-format on
+
+  m_encoder.start(m_options.encoder, arguments);
+  if (!m_encoder.waitForStarted())
+  {
+    qCritical() << "Cannot start video encoder" << m_options.encoder;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Constructs the QtWidgets implementation of every dashboard widget that can
+ * be drawn without QML & lays them out in a grid with the size of the video.
+ */
+void UI::DashboardExporter::createWidgets()
+{
+  // Get widget count
+  auto &dashboard = UI::Dashboard::instance();
+  const int count = dashboard.totalWidgetCount();
+  if (count <= 0)
+    return;
+
+  // Create the container, which is never displayed on the screen
+  m_container.reset(new QWidget);
+  m_container->setAttribute(Qt::WA_DontShowOnScreen);
+  m_container->setFixedSize(m_options.width, m_options.height);
+
+  // Create the widgets
+  auto layout = new QGridLayout(m_container.data());
+  const auto titleList = dashboard.widgetTitles();
+  const int columns = qCeil(qSqrt(count));
+  for (int i = 0; i < count; ++i)
+  {
+    auto widget = UI::DashboardWidget::constructWidget(
+        dashboard.widgetType(i), dashboard.relativeIndex(i));
+    if (!widget)
+      continue;
+
+    auto box = new QGroupBox(titleList.value(i));
+    auto boxLayout = new QVBoxLayout(box);
+    boxLayout->addWidget(widget);
+
+    const int cell = m_widgets.count();
+    layout->addWidget(box, cell / columns, cell % columns);
+    m_widgets.append(widget);
+  }
+
+  // Lay out the widgets
+  m_container->show();
+  for (auto *widget : m_widgets)
+    widget->markDirty();
+}
+
+/**
+ * Saves the given @a image to the image sequence directory & sends it to the
+ * video encoder. Returns @c false if the image cannot be written.
+ */
+bool UI::DashboardExporter::writeImage(const QImage &image)
+{
+  // Save the image sequence
+  if (!m_options.outputPath.isEmpty())
+  {
+    const auto name = QString("frame_%1.png").arg(m_frame, 6, 10, QChar('0'));
+    const auto path = QDir(m_options.outputPath).filePath(name);
+    if (!image.save(path, "PNG"))
+    {
+      qCritical() << "Cannot write image" << path;
+      return false;
+    }
+  }
+
+  // Send the raw pixels to the video encoder, waiting for the encoder to read
+  // them so that the images are not accumulated in memory
+  if (m_encoder.state() == QProcess::Running)
+  {
+    const auto bytes = qint64(image.bytesPerLine()) * image.height();
+    m_encoder.write(reinterpret_cast<const char *>(image.constBits()), bytes);
+    while (m_encoder.bytesToWrite() > 0)
+    {
+      if (!m_encoder.waitForBytesWritten(-1))
+      {
+        qCritical() << "Video encoder stopped unexpectedly";
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns the number of data rows of the recording
+ */
+int UI::DashboardExporter::rowCount() const
+{
+  if (m_binary.isOpen())
+    return m_binary.rowCount();
+
+  if (m_csv.isOpen())
+    return qMax(0, m_csv.rowCount() - 1);
+
+  return 0;
+}
+
+/**
+ * Returns the titles of the value columns of the recording
+ */
+QStringList UI::DashboardExporter::titles()
+{
+  if (m_binary.isOpen())
+    return m_binary.titles();
+
+  if (m_csv.isOpen() && m_csv.rowCount() > 0)
+  {
+    auto list = m_csv.row(0);
+    if (!list.isEmpty())
+      list.removeFirst();
+
+    return list;
+  }
+
+  return QStringList();
+}
+
+/**
+ * Returns the reception time (in milliseconds) of the given data @a row
+ */
+qint64 UI::DashboardExporter::rowTime(const int row) const
+{
+  if (m_binary.isOpen())
+    return m_binary.timestamp(row);
+
+  return m_csv.timestamp(row + 1);
+}
+
+/**
+ * Returns the values stored at the given data @a row (the reception date/time
+ * column is not included)
+ */
+QStringList UI::DashboardExporter::rowValues(const int row)
+{
+  if (m_binary.isOpen())
+    return m_binary.values(row);
+
+  auto list = m_csv.row(row + 1);
+  if (!list.isEmpty())
+    list.removeFirst();
+
+  return list;
+}
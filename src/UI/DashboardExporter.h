@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QVector>
+#include <QObject>
+#include <QProcess>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+
+#include <JSON/Frame.h>
+#include <CSV/CsvReader.h>
+#include <CSV/BinaryReader.h>
+
+class QImage;
+class QWidget;
+
+namespace Widgets
+{
+class DashboardWidgetBase;
+}
+
+namespace UI
+{
+struct DashboardExportOptions
+{
+  QString project;
+  QString recording;
+  QString outputPath;
+  QString videoFile;
+  QString encoder = QStringLiteral("ffmpeg");
+  int frameRate = 30;
+  int width = 1280;
+  int height = 720;
+};
+
+/**
+ * @brief The DashboardExporter class
+ *
+ * Renders the dashboard of a recording (a CSV file or a binary @c *.ssrec
+ * recording) at a fixed frame rate into a PNG image sequence and/or a video
+ * file, without displaying any window.
+ *
+ * The rows of the recording are not sent through the I/O manager: they are
+ * converted to frames with the structure of the given project file & handed to
+ * @c UI::Dashboard::processFrames() directly, in the same batches that a
+ * real-time replay would deliver between two video frames. The dashboard
+ * widgets are then refreshed & grabbed into an image. Since no step waits for
+ * the playback clock, the export runs as fast as the widgets can be drawn.
+ *
+ * Videos are encoded by an external encoder process (FFmpeg by default), which
+ * receives the raw pixels of each image through its standard input.
+ */
+class DashboardExporter : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit DashboardExporter(const DashboardExportOptions &options);
+  ~DashboardExporter();
+
+  bool start();
+
+private Q_SLOTS:
+  void begin();
+  void renderFrame();
+  void finish(const bool success);
+
+private:
+  bool openEncoder();
+  void createWidgets();
+  bool writeImage(const QImage &image);
+
+  int rowCount() const;
+  QStringList titles();
+  qint64 rowTime(const int row) const;
+  QStringList rowValues(const int row);
+
+private:
+  int m_row;
+  int m_frame;
+  int m_progress;
+  qint64 m_startTime;
+
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+  QProcess m_encoder;
+  JSON::Frame m_template;
+  QVector<int> m_columns;
+
+  CSV::CsvReader m_csv;
+  CSV::BinaryReader m_binary;
+
+  QScopedPointer<QWidget> m_container;
+  QVector<Widgets::DashboardWidgetBase *> m_widgets;
+
+  DashboardExportOptions m_options;
+};
+} // namespace UI
@@ -20,6 +20,11 @@
  * THE SOFTWARE.
  */
 
+#include <QTimer>
+#include <QPointer>
+#include <QElapsedTimer>
+
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 #include <UI/DashboardWidget.h>
 
@@ -31,24 +36,59 @@
 #include <UI/Widgets/FFTPlot.h>
 #include <UI/Widgets/LEDPanel.h>
 #include <UI/Widgets/DataGroup.h>
+#include <UI/Widgets/Histogram.h>
 #include <UI/Widgets/Gyroscope.h>
 #include <UI/Widgets/MultiPlot.h>
+#include <UI/Widgets/Statistics.h>
 #include <UI/Widgets/Accelerometer.h>
 
+/**
+ * Maximum time spent constructing widgets in each event loop iteration
+ */
+static const int CREATION_BUDGET_MS = 10;
+
+/**
+ * Widgets waiting to be constructed by @c processCreationQueue()
+ */
+static QVector<QPointer<UI::DashboardWidget>> CREATION_QUEUE;
+
+/**
+ * Existing dashboard widgets, used to report the render cost of each widget
+ */
+static QVector<UI::DashboardWidget *> INSTANCES;
+
 /**
  * Constructor function
  */
 UI::DashboardWidget::DashboardWidget(QQuickItem *parent)
   : DeclarativeWidget(parent)
   , m_index(-1)
+  , m_relativeIndex(-1)
+  , m_refreshRate(0)
   , m_isGpsMap(false)
+  , m_isNativePlot(false)
   , m_widgetVisible(false)
   , m_isExternalWindow(false)
+  , m_widgetType(UI::Dashboard::WidgetType::Unknown)
+  , m_creationPending(false)
+  , m_dbWidget(Q_NULLPTR)
 {
   // clang-format off
     connect(&UI::Dashboard::instance(), &UI::Dashboard::widgetVisibilityChanged,
             this, &UI::DashboardWidget::updateWidgetVisible);
+    connect(&UI::Dashboard::instance(), &UI::Dashboard::nativeRenderingChanged,
+            this, &UI::DashboardWidget::reloadWidget);
   // clang-format on
+
+  // Refresh the render cost overlay once per second
+  connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout1Hz, this,
+          [=] {
+            if (UI::Dashboard::instance().renderCostOverlay())
+              Q_EMIT renderCostChanged();
+          });
+
+  // Register the widget
+  INSTANCES.append(this);
 }
 
 /**
@@ -56,6 +96,7 @@ UI::DashboardWidget::DashboardWidget(QQuickItem *parent)
  */
 UI::DashboardWidget::~DashboardWidget()
 {
+  INSTANCES.removeAll(this);
   if (m_dbWidget)
     m_dbWidget->deleteLater();
 }
@@ -86,6 +127,15 @@ bool UI::DashboardWidget::widgetVisible() const
   return m_widgetVisible;
 }
 
+/**
+ * Returns the maximum refresh rate (in Hz) of the widget, a value of zero
+ * means that the widget is refreshed with every render tick.
+ */
+int UI::DashboardWidget::refreshRate() const
+{
+  return m_refreshRate;
+}
+
 /**
  * Returns the path of the SVG icon to use with this widget
  */
@@ -154,6 +204,50 @@ bool UI::DashboardWidget::isGpsMap() const
   return m_isGpsMap;
 }
 
+/**
+ * Returns @c true if the widget displays a multiplot group
+ */
+bool UI::DashboardWidget::isMultiPlot() const
+{
+  return widgetType() == UI::Dashboard::WidgetType::MultiPlot;
+}
+
+/**
+ * Returns @c true if the widget is a plot or a multiplot that must be drawn by
+ * the QML interface with a @c UI::PlotItem instead of a QtWidgets-based plot.
+ */
+bool UI::DashboardWidget::isNativePlot() const
+{
+  return m_isNativePlot;
+}
+
+/**
+ * Returns @c true if the widget is a waterfall, which is always drawn by the
+ * QML interface with a @c UI::WaterfallItem.
+ */
+bool UI::DashboardWidget::isWaterfall() const
+{
+  return widgetType() == UI::Dashboard::WidgetType::Waterfall;
+}
+
+/**
+ * Returns @c true if the widget is an XY plot, which is always drawn by the
+ * QML interface with a @c UI::XYPlotItem.
+ */
+bool UI::DashboardWidget::isXYPlot() const
+{
+  return widgetType() == UI::Dashboard::WidgetType::XYPlot;
+}
+
+/**
+ * Returns @c true if the widget is a heatmap, which is always drawn by the
+ * QML interface with a @c UI::HeatmapItem.
+ */
+bool UI::DashboardWidget::isHeatmap() const
+{
+  return widgetType() == UI::Dashboard::WidgetType::Heatmap;
+}
+
 /**
  * Returns the current GPS altitude indicated by the GPS "parser" widget,
  * this function only returns an useful value if @c isGpsMap() is @c true.
@@ -190,11 +284,71 @@ qreal UI::DashboardWidget::gpsLongitude() const
   return 0;
 }
 
+/**
+ * Returns a short text with the average time spent updating, grabbing &
+ * painting the widget, which is displayed on top of the widget when the
+ * render cost overlay is enabled.
+ */
+QString UI::DashboardWidget::renderCost() const
+{
+  const qreal update = m_dbWidget ? m_dbWidget->updateCost() : 0;
+  return tr("Update %1 ms · Grab %2 ms · Paint %3 ms")
+      .arg(update / 1000, 0, 'f', 2)
+      .arg(grabCost() / 1000, 0, 'f', 2)
+      .arg(paintCost() / 1000, 0, 'f', 2);
+}
+
+/**
+ * Returns the render cost of every existing widget, sorted from the most to
+ * the least expensive. Each item is a map with the title of the widget & the
+ * average time (in microseconds) spent updating, grabbing & painting it.
+ */
+QVariantList UI::DashboardWidget::renderCosts()
+{
+  // Obtain the costs of each widget
+  QVector<QVariantMap> costs;
+  for (const auto *widget : INSTANCES)
+  {
+    if (!widget->m_dbWidget)
+      continue;
+
+    const qreal update = widget->m_dbWidget->updateCost();
+    const qreal total = update + widget->grabCost() + widget->paintCost();
+
+    QVariantMap map;
+    map.insert("name", widget->widgetTitle());
+    map.insert("update", update);
+    map.insert("grab", widget->grabCost());
+    map.insert("paint", widget->paintCost());
+    map.insert("total", total);
+    costs.append(map);
+  }
+
+  // Sort the widgets by their total cost
+  std::sort(costs.begin(), costs.end(),
+            [](const QVariantMap &a, const QVariantMap &b) {
+              return a.value("total").toDouble() > b.value("total").toDouble();
+            });
+
+  // Construct the list
+  QVariantList list;
+  for (const auto &map : costs)
+    list.append(map);
+
+  return list;
+}
+
 /**
  * Changes the visibility & enabled status of the widget
  */
 void UI::DashboardWidget::setVisible(const bool visible)
 {
+  if (isExternalWindow() && m_widgetVisible != visible)
+  {
+    m_widgetVisible = visible;
+    Q_EMIT widgetVisibleChanged();
+  }
+
   if (m_dbWidget)
   {
     m_dbWidget->setEnabled(visible);
@@ -203,14 +357,52 @@ void UI::DashboardWidget::setVisible(const bool visible)
 }
 
 /**
- * Selects & configures the appropiate widget for the given @a index
+ * Limits the refresh rate of the widget to the given frequency (in Hz), this
+ * is used by secondary dashboard windows to reduce the CPU load of widgets
+ * that do not need to follow the primary dashboard. Set @a hz to zero to
+ * refresh the widget with every render tick.
+ */
+void UI::DashboardWidget::setRefreshRate(const int hz)
+{
+  const auto rate = qMax(0, hz);
+  if (m_refreshRate != rate)
+  {
+    m_refreshRate = rate;
+    if (m_dbWidget)
+      m_dbWidget->setRefreshRate(rate);
+
+    Q_EMIT refreshRateChanged();
+  }
+}
+
+/**
+ * Selects & configures the appropiate widget for the given @a index.
+ *
+ * If the widget only moved to another global index (e.g. because widgets of
+ * another type were added to the dashboard), the current widget is kept.
+ *
+ * Otherwise, the widget is not constructed immediately, instead, it is added
+ * to a queue that constructs the pending widgets during the next iterations
+ * of the event loop (see @c processCreationQueue()).
  */
 void UI::DashboardWidget::setWidgetIndex(const int index)
 {
-  if (index < UI::Dashboard::instance().totalWidgetCount() && index >= 0)
+  auto dash = &UI::Dashboard::instance();
+  if (index < dash->totalWidgetCount() && index >= 0)
   {
+    // Same widget at another global index, keep the current widget
+    if (m_index >= 0 && m_widgetType == dash->widgetType(index)
+        && m_relativeIndex == dash->relativeIndex(index))
+    {
+      m_index = index;
+      Q_EMIT widgetIndexChanged();
+      return;
+    }
+
     // Update widget index
     m_index = index;
+    m_widgetType = widgetType();
+    m_relativeIndex = relativeIndex();
 
     // Delete previous widget
     if (m_dbWidget)
@@ -219,67 +411,150 @@ void UI::DashboardWidget::setWidgetIndex(const int index)
       m_dbWidget = nullptr;
     }
 
-    // Initialize the GPS indicator flag to false by default
-    m_isGpsMap = false;
+    // Set widget flags, the GPS data is only available once the widget exists
+    const auto type = widgetType();
+    m_isGpsMap = type == UI::Dashboard::WidgetType::GPS;
+    m_isNativePlot = UI::Dashboard::instance().nativeRendering()
+                     && (type == UI::Dashboard::WidgetType::Plot
+                         || type == UI::Dashboard::WidgetType::MultiPlot);
 
-    // Construct new widget
-    switch (widgetType())
+    // Plots are drawn by the QML interface with the scene graph
+    if (!m_isNativePlot && !isWaterfall() && !isXYPlot() && !isHeatmap()
+        && !m_creationPending)
     {
-      case UI::Dashboard::WidgetType::Group:
-        m_dbWidget = new Widgets::DataGroup(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::MultiPlot:
-        m_dbWidget = new Widgets::MultiPlot(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::FFT:
-        m_dbWidget = new Widgets::FFTPlot(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::Plot:
-        m_dbWidget = new Widgets::Plot(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::Bar:
-        m_dbWidget = new Widgets::Bar(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::Gauge:
-        m_dbWidget = new Widgets::Gauge(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::Compass:
-        m_dbWidget = new Widgets::Compass(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::Gyroscope:
-        m_dbWidget = new Widgets::Gyroscope(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::Accelerometer:
-        m_dbWidget = new Widgets::Accelerometer(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::GPS:
-        m_isGpsMap = true;
-        m_dbWidget = new Widgets::GPS(relativeIndex());
-        break;
-      case UI::Dashboard::WidgetType::LED:
-        m_dbWidget = new Widgets::LEDPanel(relativeIndex());
-        break;
-      default:
-        break;
+      m_creationPending = true;
+      CREATION_QUEUE.append(this);
+      if (CREATION_QUEUE.count() == 1)
+        QTimer::singleShot(0, &UI::DashboardWidget::processCreationQueue);
     }
 
-    // Configure widget
-    if (m_dbWidget)
-    {
-      setWidget(m_dbWidget);
-      updateWidgetVisible();
-      connect(m_dbWidget, &Widgets::DashboardWidgetBase::updated, this, [=]() {
-        if (!isGpsMap())
-          update();
-        else
-          Q_EMIT gpsDataChanged();
-      });
+    // Update user interface
+    Q_EMIT widgetIndexChanged();
+  }
+}
 
-      Q_EMIT widgetIndexChanged();
-    }
+/**
+ * Constructs the widget that displays the data of the widget index selected
+ * with @c setWidgetIndex().
+ */
+void UI::DashboardWidget::createWidget()
+{
+  TRACE_SCOPE("UI::DashboardWidget::createWidget");
+
+  // Widget no longer required or already constructed
+  m_creationPending = false;
+  if (m_dbWidget || m_isNativePlot || isWaterfall() || isXYPlot()
+      || isHeatmap() || m_index < 0)
+    return;
+
+  // Construct new widget
+  m_dbWidget = constructWidget(m_widgetType, m_relativeIndex);
+
+  // Configure widget
+  if (m_dbWidget)
+  {
+    setWidget(m_dbWidget);
+    updateWidgetVisible();
+    m_dbWidget->setRefreshRate(m_refreshRate);
+    if (isExternalWindow())
+      m_dbWidget->setEnabled(m_widgetVisible);
+
+    connect(m_dbWidget, &Widgets::DashboardWidgetBase::updated, this, [=]() {
+      if (!isGpsMap())
+        update();
+      else
+        Q_EMIT gpsDataChanged();
+    });
+
+    m_dbWidget->markDirty();
+    Q_EMIT widgetIndexChanged();
   }
 }
 
+/**
+ * Constructs the QtWidgets implementation of the given widget @a type, which
+ * displays the data of the widget at the given @a relativeIndex.
+ *
+ * Returns @c nullptr for the widgets that are drawn exclusively from QML or
+ * by the scene graph (waterfalls, XY plots & heatmaps) & for unknown widget
+ * types. This function is also used to render the dashboard without a user
+ * interface, see @c UI::DashboardExporter.
+ */
+Widgets::DashboardWidgetBase *
+UI::DashboardWidget::constructWidget(const UI::Dashboard::WidgetType type,
+                                     const int relativeIndex)
+{
+  switch (type)
+  {
+    case UI::Dashboard::WidgetType::Group:
+      return new Widgets::DataGroup(relativeIndex);
+    case UI::Dashboard::WidgetType::MultiPlot:
+      return new Widgets::MultiPlot(relativeIndex);
+    case UI::Dashboard::WidgetType::FFT:
+      return new Widgets::FFTPlot(relativeIndex);
+    case UI::Dashboard::WidgetType::Plot:
+      return new Widgets::Plot(relativeIndex);
+    case UI::Dashboard::WidgetType::Bar:
+      return new Widgets::Bar(relativeIndex);
+    case UI::Dashboard::WidgetType::Gauge:
+      return new Widgets::Gauge(relativeIndex);
+    case UI::Dashboard::WidgetType::Compass:
+      return new Widgets::Compass(relativeIndex);
+    case UI::Dashboard::WidgetType::Histogram:
+      return new Widgets::Histogram(relativeIndex);
+    case UI::Dashboard::WidgetType::Gyroscope:
+      return new Widgets::Gyroscope(relativeIndex);
+    case UI::Dashboard::WidgetType::Accelerometer:
+      return new Widgets::Accelerometer(relativeIndex);
+    case UI::Dashboard::WidgetType::Statistics:
+      return new Widgets::Statistics(relativeIndex);
+    case UI::Dashboard::WidgetType::GPS:
+      return new Widgets::GPS(relativeIndex);
+    case UI::Dashboard::WidgetType::LED:
+      return new Widgets::LEDPanel(relativeIndex);
+    default:
+      break;
+  }
+
+  return nullptr;
+}
+
+/**
+ * Constructs the pending widgets of the creation queue until the time budget
+ * of this event loop iteration is spent, the remaining widgets are constructed
+ * in the following iterations.
+ *
+ * This way, the interface (and the first frame) is displayed while widgets
+ * are still being constructed, even for dashboards with hundreds of widgets.
+ */
+void UI::DashboardWidget::processCreationQueue()
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  while (!CREATION_QUEUE.isEmpty() && timer.elapsed() < CREATION_BUDGET_MS)
+  {
+    auto widget = CREATION_QUEUE.takeFirst();
+    if (!widget.isNull())
+      widget->createWidget();
+  }
+
+  if (!CREATION_QUEUE.isEmpty())
+    QTimer::singleShot(0, &UI::DashboardWidget::processCreationQueue);
+}
+
+/**
+ * Deletes the current widget & constructs it again, used when a setting that
+ * changes the kind of widget used to display the data (e.g. native plots) is
+ * modified.
+ */
+void UI::DashboardWidget::reloadWidget()
+{
+  const int index = m_index;
+  m_index = -1;
+  setWidgetIndex(index);
+}
+
 /**
  * Changes the widget visibility controller source.
  *
@@ -295,6 +570,24 @@ void UI::DashboardWidget::setIsExternalWindow(const bool isWindow)
   Q_EMIT isExternalWindowChanged();
 }
 
+/**
+ * Returns @c true if the loaded widget can be painted by a worker thread
+ */
+bool UI::DashboardWidget::supportsOffscreenRendering() const
+{
+  return m_dbWidget && m_dbWidget->supportsOffscreenRendering();
+}
+
+/**
+ * Paints the loaded widget with the given @a painter, this function is called
+ * from a worker thread while the GUI thread waits for it to finish.
+ */
+void UI::DashboardWidget::renderOffscreen(QPainter *painter)
+{
+  if (m_dbWidget)
+    m_dbWidget->renderOffscreen(painter);
+}
+
 /**
  * Updates the visibility status of the current widget (this function is called
  * automatically by the UI::Dashboard class via signals/slots).
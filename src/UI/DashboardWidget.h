@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <UI/Dashboard.h>
 #include <Misc/TimerEvents.h>
 #include <UI/DeclarativeWidget.h>
@@ -35,10 +36,37 @@ namespace Widgets
  * @c UI::DashboardWidget to know when it should trigger a re-paint request to
  * the scene render thread.
  *
- * The widget also contains a @c requestUpdate() function, which is called by
+ * Widgets are not refreshed for every frame received by the dashboard,
+ * instead, the widget is marked as dirty when new data arrives and the
+ * @c refreshRequested() signal is emitted at most once per tick of the render
+ * timer (which runs at the display refresh rate or at the rate selected by the
+ * user). Widgets connect their data-displaying functions to this signal, while
+ * functions that accumulate data (e.g. plot history) remain connected to the
+ * dashboard, so that input rate and render cost are decoupled.
+ *
+ * Disabled (hidden) widgets are never refreshed, the dirty flag is kept until
+ * the widget is enabled again, at which point the widget is refreshed with
+ * the history retained by the dashboard. This way, expensive derived work
+ * (such as FFTs or curve decimation) is only done for visible widgets.
+ *
+ * The refresh rate of a widget can be capped below the rate of the render
+ * timer (see @c setRefreshRate()), e.g. for widgets displayed in secondary
+ * dashboard windows, in that case the widget is only refreshed on the render
+ * ticks in which the refresh interval has elapsed.
+ *
+ * The widget also contains a @c requestRepaint() function, which is called by
  * the widgets that inherit this class when they finish updating the displayed
- * data. This function is used to schedule a re-paint at a controlled frequency,
- * which is limited at 20 Hz.
+ * data, the re-paint is then executed in the same render tick.
+ *
+ * The time spent by the widget updating the displayed data (i.e. handling the
+ * @c refreshRequested() signal) is averaged in @c updateCost(), which is
+ * reported in microseconds.
+ *
+ * Widgets that are able to paint themselves with a plain @c QPainter, without
+ * relying on paint events (e.g. Qwt plots, through a @c QwtPlotRenderer), may
+ * re-implement @c supportsOffscreenRendering() and @c renderOffscreen(), so
+ * that they can be rendered by a worker thread when parallel rendering is
+ * enabled.
  */
 class DashboardWidgetBase : public QWidget
 {
@@ -46,18 +74,34 @@ class DashboardWidgetBase : public QWidget
 
 Q_SIGNALS:
   void updated();
+  void refreshRequested();
 
 public:
   DashboardWidgetBase()
+    : m_dirty(false)
+    , m_repaint(false)
+    , m_refreshInterval(0)
+    , m_updateCost(0)
   {
     // clang-format off
-        connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout20Hz,
+        connect(&UI::Dashboard::instance(), &UI::Dashboard::updated,
+                this, &Widgets::DashboardWidgetBase::markDirty);
+        connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeoutRender,
                 this, &Widgets::DashboardWidgetBase::repaint);
     // clang-format on
   }
 
   void repaint()
   {
+    if (m_dirty && isEnabled() && refreshDue())
+    {
+      m_dirty = false;
+      m_lastRefresh.start();
+      Q_EMIT refreshRequested();
+      m_updateCost = UI::DeclarativeWidget::averageCost(
+          m_updateCost, m_lastRefresh.nsecsElapsed());
+    }
+
     if (m_repaint)
     {
       m_repaint = false;
@@ -65,10 +109,46 @@ public:
     }
   }
 
+  qreal updateCost() const { return m_updateCost; }
+
+  void markDirty() { m_dirty = true; }
   void requestRepaint() { m_repaint = true; }
 
+  int refreshRate() const
+  {
+    return m_refreshInterval > 0 ? 1000 / m_refreshInterval : 0;
+  }
+
+  void setRefreshRate(const int hz)
+  {
+    m_refreshInterval = hz > 0 ? qMax(1, 1000 / hz) : 0;
+  }
+
+  virtual bool supportsOffscreenRendering() const { return false; }
+  virtual void renderOffscreen(QPainter *painter) { Q_UNUSED(painter); }
+
+protected:
+  void changeEvent(QEvent *event) override
+  {
+    if (event->type() == QEvent::EnabledChange && isEnabled())
+      m_dirty = true;
+
+    QWidget::changeEvent(event);
+  }
+
 private:
+  bool refreshDue() const
+  {
+    return m_refreshInterval <= 0 || !m_lastRefresh.isValid()
+           || m_lastRefresh.elapsed() >= m_refreshInterval;
+  }
+
+private:
+  bool m_dirty;
   bool m_repaint;
+  int m_refreshInterval;
+  qreal m_updateCost;
+  QElapsedTimer m_lastRefresh;
 };
 } // namespace Widgets
 
@@ -96,6 +176,11 @@ namespace UI
  *      assets/qml/Dashboard/WidgetDelegate.qml
  *      assets/qml/Dashboard/WidgetLoader.qml
  *      assets/qml/Dashboard/WidgetGrid.qml
+ *
+ * The time spent updating, grabbing & painting each widget is exposed through
+ * @c renderCost() (displayed as an overlay when enabled in the dashboard) and
+ * @c renderCosts(), which lists the cost of every existing widget for the
+ * diagnostics window.
  */
 class DashboardWidget : public DeclarativeWidget
 {
@@ -122,9 +207,31 @@ class DashboardWidget : public DeclarativeWidget
                READ widgetVisible
                WRITE setVisible
                NOTIFY widgetVisibleChanged)
+    Q_PROPERTY(int refreshRate
+               READ refreshRate
+               WRITE setRefreshRate
+               NOTIFY refreshRateChanged)
     Q_PROPERTY(bool isGpsMap
                READ isGpsMap
                NOTIFY widgetIndexChanged)
+    Q_PROPERTY(bool isNativePlot
+               READ isNativePlot
+               NOTIFY widgetIndexChanged)
+    Q_PROPERTY(bool isMultiPlot
+               READ isMultiPlot
+               NOTIFY widgetIndexChanged)
+    Q_PROPERTY(bool isWaterfall
+               READ isWaterfall
+               NOTIFY widgetIndexChanged)
+    Q_PROPERTY(bool isXYPlot
+               READ isXYPlot
+               NOTIFY widgetIndexChanged)
+    Q_PROPERTY(bool isHeatmap
+               READ isHeatmap
+               NOTIFY widgetIndexChanged)
+    Q_PROPERTY(QString renderCost
+               READ renderCost
+               NOTIFY renderCostChanged)
     Q_PROPERTY(qreal gpsAltitude
                READ gpsAltitude
                NOTIFY gpsDataChanged)
@@ -138,8 +245,10 @@ class DashboardWidget : public DeclarativeWidget
 
 Q_SIGNALS:
   void gpsDataChanged();
+  void renderCostChanged();
   void widgetIndexChanged();
   void widgetVisibleChanged();
+  void refreshRateChanged();
   void isExternalWindowChanged();
 
 public:
@@ -149,29 +258,56 @@ public:
   int widgetIndex() const;
   int relativeIndex() const;
   bool widgetVisible() const;
+  int refreshRate() const;
   QString widgetIcon() const;
   QString widgetTitle() const;
   bool isExternalWindow() const;
   UI::Dashboard::WidgetType widgetType() const;
 
   bool isGpsMap() const;
+  bool isMultiPlot() const;
+  bool isNativePlot() const;
+  bool isWaterfall() const;
+  bool isXYPlot() const;
+  bool isHeatmap() const;
   qreal gpsAltitude() const;
   qreal gpsLatitude() const;
   qreal gpsLongitude() const;
+  QString renderCost() const;
+
+  static QVariantList renderCosts();
+  static Widgets::DashboardWidgetBase *
+  constructWidget(const UI::Dashboard::WidgetType type,
+                  const int relativeIndex);
 
 public Q_SLOTS:
   void setVisible(const bool visible);
+  void setRefreshRate(const int hz);
   void setWidgetIndex(const int index);
   void setIsExternalWindow(const bool isWindow);
 
+protected:
+  bool supportsOffscreenRendering() const override;
+  void renderOffscreen(QPainter *painter) override;
+
 private Q_SLOTS:
+  void createWidget();
+  void reloadWidget();
   void updateWidgetVisible();
 
+private:
+  static void processCreationQueue();
+
 private:
   int m_index;
+  int m_relativeIndex;
+  int m_refreshRate;
   bool m_isGpsMap;
+  bool m_isNativePlot;
   bool m_widgetVisible;
   bool m_isExternalWindow;
+  UI::Dashboard::WidgetType m_widgetType;
+  bool m_creationPending;
   Widgets::DashboardWidgetBase *m_dbWidget;
 };
 } // namespace UI
@@ -20,9 +20,55 @@
  * THE SOFTWARE.
  */
 
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QQuickWindow>
+#include <QtConcurrent>
+#include <QOpenGLPaintDevice>
+#include <QSGSimpleTextureNode>
+#include <QSGRendererInterface>
+#include <QOpenGLFramebufferObject>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#  include <QtQuick/qsgtexture_platform.h>
+#endif
+
+#include <Misc/Tracer.h>
+#include <UI/Dashboard.h>
 #include <Misc/ThemeManager.h>
 #include <UI/DeclarativeWidget.h>
 
+/**
+ * Items waiting to be rendered by the thread pool in the current render tick
+ */
+static QVector<QPointer<UI::DeclarativeWidget>> RENDER_QUEUE;
+
+/**
+ * Texture node that displays the framebuffer in which a widget is painted
+ * with OpenGL. The framebuffers are owned by the node, so that they are
+ * deleted by the render thread with the OpenGL context of the scene graph.
+ */
+class FramebufferNode : public QSGSimpleTextureNode
+{
+public:
+  FramebufferNode()
+    : target(Q_NULLPTR)
+    , resolve(Q_NULLPTR)
+  {
+    setOwnsTexture(true);
+    setFiltering(QSGTexture::Linear);
+  }
+
+  ~FramebufferNode()
+  {
+    delete target;
+    delete resolve;
+  }
+
+  QOpenGLFramebufferObject *target;
+  QOpenGLFramebufferObject *resolve;
+};
+
 /**
  * Creates a subclass of @c QWidget that allows us to call the given
  * protected/private
@@ -45,23 +91,28 @@
  * automatically resize the contained widget to the QML item's size.
  */
 UI::DeclarativeWidget::DeclarativeWidget(QQuickItem *parent)
-  : QQuickPaintedItem(parent)
+  : QQuickItem(parent)
+  , m_queued(false)
+  , m_textureDirty(false)
+  , m_useFramebuffer(false)
+  , m_framebufferDirty(false)
+  , m_grabCost(0)
+  , m_paintCost(0)
+  , m_fillColor(Misc::ThemeManager::instance().base())
 {
-  setMipmap(true);
   setAntialiasing(true);
-  setOpaquePainting(true);
   setAcceptTouchEvents(true);
   setFlag(ItemHasContents, true);
   setFlag(ItemIsFocusScope, true);
   setFlag(ItemAcceptsInputMethod, true);
   setAcceptedMouseButtons(Qt::AllButtons);
-  setFillColor(Misc::ThemeManager::instance().base());
 
   // clang-format off
-    connect(this, &QQuickPaintedItem::widthChanged,
+    connect(this, &QQuickItem::widthChanged,
             this, &UI::DeclarativeWidget::resizeWidget);
-    connect(this, &QQuickPaintedItem::heightChanged,
+    connect(this, &QQuickItem::heightChanged,
             this, &UI::DeclarativeWidget::resizeWidget);
+    connect(this, &QQuickItem::visibleChanged, [=](){update();});
     connect(this, &UI::DeclarativeWidget::widgetChanged, [=](){update();});
   // clang-format on
 }
@@ -75,27 +126,283 @@ QWidget *UI::DeclarativeWidget::widget()
 }
 
 /**
- * Grabs an image/pixmap of the contained widget. The pixmap is later
- * used to render the widget in the QML interface without causing signal/slot
+ * Returns the average time (in microseconds) spent rendering the contained
+ * widget into the image that is uploaded to the scene graph.
+ */
+qreal UI::DeclarativeWidget::grabCost() const
+{
+  return m_grabCost;
+}
+
+/**
+ * Returns the average time (in microseconds) spent by the render thread
+ * uploading the image of the widget, or painting the widget into its
+ * framebuffer when OpenGL rendering is used.
+ */
+qreal UI::DeclarativeWidget::paintCost() const
+{
+  return m_paintCost;
+}
+
+/**
+ * Adds a measurement of @a nsecs nanoseconds to the exponential moving
+ * @a average (in microseconds) & returns the new average, the first
+ * measurement is taken as-is.
+ */
+qreal UI::DeclarativeWidget::averageCost(const qreal average,
+                                         const qint64 nsecs)
+{
+  const qreal usecs = nsecs / 1000.0;
+  if (average <= 0)
+    return usecs;
+
+  return average + (usecs - average) * 0.1;
+}
+
+/**
+ * Renders the contained widget into an image, which is later uploaded to the
+ * scene graph in @c updatePaintNode() without causing signal/slot
  * interferences with the scenegraph render thread.
+ *
+ * The whole widget is always rendered, the @a rect parameter is only kept for
+ * compatibility with the previous painted-item implementation.
  */
 void UI::DeclarativeWidget::update(const QRect &rect)
 {
-  if (widget())
+  TRACE_SCOPE("UI::DeclarativeWidget::update");
+
+  Q_UNUSED(rect);
+
+  if (widget() && isVisible())
+  {
+    m_useFramebuffer = supportsOffscreenRendering() && framebufferAvailable();
+    if (m_useFramebuffer)
+    {
+      m_grabCost = 0;
+      m_framebufferDirty = true;
+      QQuickItem::update();
+      return;
+    }
+
+    if (supportsOffscreenRendering()
+        && UI::Dashboard::instance().parallelRendering())
+    {
+      queueRender();
+      return;
+    }
+
+    renderWidget();
+    QQuickItem::update();
+  }
+}
+
+/**
+ * Uploads the latest image of the widget as a texture & displays it over the
+ * whole area of the item. The texture is only re-created when the widget was
+ * rendered again since the last call to this function.
+ */
+QSGNode *UI::DeclarativeWidget::updatePaintNode(QSGNode *node,
+                                                UpdatePaintNodeData *data)
+{
+  Q_UNUSED(data);
+
+  // Paint the widget directly into a framebuffer
+  if (m_useFramebuffer && window())
+    return updateFramebufferNode(node);
+
+  // Nothing to display
+  if (m_image.isNull() || !window())
+  {
+    delete node;
+    return Q_NULLPTR;
+  }
+
+  // Discard the node that displayed the framebuffer of the widget
+  if (dynamic_cast<FramebufferNode *>(node))
+  {
+    delete node;
+    node = Q_NULLPTR;
+  }
+
+  // Create texture node
+  auto textureNode = static_cast<QSGSimpleTextureNode *>(node);
+  if (!textureNode)
+  {
+    m_textureDirty = true;
+    textureNode = new QSGSimpleTextureNode;
+    textureNode->setOwnsTexture(true);
+    textureNode->setFiltering(QSGTexture::Linear);
+  }
+
+  // Upload latest image of the widget, the previous texture is deleted by
+  // the node
+  if (m_textureDirty)
+  {
+    QElapsedTimer timer;
+    timer.start();
+    m_textureDirty = false;
+    textureNode->setTexture(window()->createTextureFromImage(m_image));
+    m_paintCost = averageCost(m_paintCost, timer.nsecsElapsed());
+  }
+
+  // Update geometry
+  textureNode->setRect(boundingRect());
+  return textureNode;
+}
+
+/**
+ * Returns @c true if the user enabled OpenGL rendering and the scene graph of
+ * the window that contains the item uses the OpenGL backend.
+ */
+bool UI::DeclarativeWidget::framebufferAvailable() const
+{
+  if (!UI::Dashboard::instance().openGLRendering() || !window())
+    return false;
+
+  auto rif = window()->rendererInterface();
+  return rif && rif->graphicsApi() == QSGRendererInterface::OpenGL;
+}
+
+/**
+ * Paints the widget into the framebuffer of the given @a node (creating it
+ * if needed) & displays its texture over the whole area of the item. This
+ * function is called by the render thread with the OpenGL context of the
+ * scene graph bound, while the GUI thread is blocked.
+ */
+QSGNode *UI::DeclarativeWidget::updateFramebufferNode(QSGNode *node)
+{
+  // Get size of the framebuffer in device pixels
+  const qreal ratio = window()->effectiveDevicePixelRatio();
+  const QSize size = m_widget ? m_widget->size() * ratio : QSize();
+  if (size.isEmpty())
+  {
+    delete node;
+    return Q_NULLPTR;
+  }
+
+  // Replace the node that displayed the image of the widget
+  auto fbNode = dynamic_cast<FramebufferNode *>(node);
+  if (!fbNode)
   {
-    m_pixmap = m_widget->grab();
-    QQuickPaintedItem::update(rect);
+    delete node;
+    fbNode = new FramebufferNode;
   }
+
+  // Re-allocate the framebuffers if the size of the widget changed, the
+  // widget is painted into a multisampled framebuffer (if supported) &
+  // resolved into the framebuffer that is displayed by the scene graph
+  if (!fbNode->resolve || fbNode->resolve->size() != size)
+  {
+    delete fbNode->target;
+    delete fbNode->resolve;
+    fbNode->target = Q_NULLPTR;
+
+    if (QOpenGLFramebufferObject::hasOpenGLFramebufferMultisample()
+        && QOpenGLFramebufferObject::hasOpenGLFramebufferBlit())
+    {
+      QOpenGLFramebufferObjectFormat format;
+      format.setSamples(4);
+      format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+      fbNode->target = new QOpenGLFramebufferObject(size, format);
+    }
+
+    fbNode->resolve = new QOpenGLFramebufferObject(
+        size, QOpenGLFramebufferObject::CombinedDepthStencil);
+
+    // Wrap the texture of the framebuffer, the node deletes the previous one
+    const auto id = fbNode->resolve->texture();
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    fbNode->setTexture(QNativeInterface::QSGOpenGLTexture::fromNative(
+        id, window(), size, QQuickWindow::TextureHasAlphaChannel));
+#else
+    fbNode->setTexture(window()->createTextureFromId(
+        id, size, QQuickWindow::TextureHasAlphaChannel));
+#endif
+
+    m_framebufferDirty = true;
+  }
+
+  // Paint the latest state of the widget
+  if (m_framebufferDirty)
+  {
+    m_framebufferDirty = false;
+    paintFramebuffer(fbNode->target, fbNode->resolve, ratio);
+  }
+
+  // Update geometry
+  fbNode->setRect(boundingRect());
+  return fbNode;
 }
 
 /**
- * Displays the pixmap generated in the @c update() function in the QML
- * interface through the given @a painter pointer.
+ * Paints the widget with the OpenGL paint engine into the @a target
+ * framebuffer & copies the result to the @a resolve framebuffer. If @a target
+ * is @c nullptr, the widget is painted directly into @a resolve.
  */
-void UI::DeclarativeWidget::paint(QPainter *painter)
+void UI::DeclarativeWidget::paintFramebuffer(QOpenGLFramebufferObject *target,
+                                             QOpenGLFramebufferObject *resolve,
+                                             const qreal ratio)
 {
-  if (painter)
-    painter->drawPixmap(0, 0, m_pixmap);
+  TRACE_SCOPE("UI::DeclarativeWidget::paintFramebuffer");
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Let the scene graph know that we are issuing OpenGL commands
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  window()->beginExternalCommands();
+#endif
+
+  // Paint the widget
+  auto fbo = target ? target : resolve;
+  fbo->bind();
+  {
+    QOpenGLPaintDevice device(fbo->size());
+    device.setPaintFlipped(true);
+    device.setDevicePixelRatio(ratio);
+
+    QPainter painter(&device);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(QRectF(QPointF(0, 0), QSizeF(fbo->size()) / ratio),
+                     m_fillColor);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    renderOffscreen(&painter);
+  }
+  fbo->release();
+
+  // Resolve the multisampled framebuffer
+  if (target)
+    QOpenGLFramebufferObject::blitFramebuffer(resolve, target);
+
+  // Restore the state of the scene graph
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  window()->endExternalCommands();
+#else
+  window()->resetOpenGLState();
+#endif
+
+  // Register the time spent painting the widget
+  m_paintCost = averageCost(m_paintCost, timer.nsecsElapsed());
+}
+
+/**
+ * Returns @c true if the contained widget can be painted by
+ * @c renderOffscreen() from a worker thread. The default implementation
+ * returns @c false, so the widget is always rendered by the GUI thread.
+ */
+bool UI::DeclarativeWidget::supportsOffscreenRendering() const
+{
+  return false;
+}
+
+/**
+ * Paints the contained widget with the given @a painter, this function may be
+ * called from a worker thread while the GUI thread waits for it to finish.
+ * The default implementation does nothing.
+ */
+void UI::DeclarativeWidget::renderOffscreen(QPainter *painter)
+{
+  Q_UNUSED(painter);
 }
 
 /**
@@ -211,7 +518,117 @@ void UI::DeclarativeWidget::dropEvent(QDropEvent *event)
 }
 
 /**
- * Resizes the widget to fit inside the QML painted item.
+ * Renders the contained widget into the image that is uploaded to the scene
+ * graph, the image is only re-allocated when the size of the widget (or the
+ * pixel ratio of the window) changes.
+ *
+ * Widgets that support offscreen rendering are painted with
+ * @c renderOffscreen(), which allows them to skip the parts of the widget
+ * that did not change since the previous frame.
+ */
+void UI::DeclarativeWidget::renderWidget()
+{
+  QElapsedTimer timer;
+  timer.start();
+  if (prepareImage())
+  {
+    if (supportsOffscreenRendering())
+    {
+      QPainter painter(&m_image);
+      renderOffscreen(&painter);
+    }
+    else
+      m_widget->render(&m_image);
+
+    m_textureDirty = true;
+    m_grabCost = averageCost(m_grabCost, timer.nsecsElapsed());
+  }
+}
+
+/**
+ * Re-allocates the image of the widget if its size (or the pixel ratio of the
+ * window) changed, and fills it with the background color. Returns @c false
+ * if the widget has no area to render.
+ */
+bool UI::DeclarativeWidget::prepareImage()
+{
+  // Get size of the image in device pixels
+  const qreal ratio = window() ? window()->effectiveDevicePixelRatio() : 1;
+  const QSize size = m_widget->size() * ratio;
+  if (size.isEmpty())
+    return false;
+
+  // Re-allocate image if needed
+  if (m_image.size() != size)
+    m_image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+
+  // Clear image
+  m_image.setDevicePixelRatio(ratio);
+  m_image.fill(m_fillColor);
+  return true;
+}
+
+/**
+ * Adds the item to the queue of items rendered by the thread pool, the queue
+ * is processed once all the widgets have handled the current render tick.
+ */
+void UI::DeclarativeWidget::queueRender()
+{
+  if (m_queued)
+    return;
+
+  m_queued = true;
+  if (RENDER_QUEUE.isEmpty())
+    QMetaObject::invokeMethod(QCoreApplication::instance(), &renderQueue,
+                              Qt::QueuedConnection);
+
+  RENDER_QUEUE.append(this);
+}
+
+/**
+ * Renders the images of all the queued items with the global thread pool &
+ * schedules the upload of the images to the scene graph. The images are
+ * allocated by the GUI thread, and the GUI thread waits for the workers to
+ * finish, so no widget is modified while it is being painted.
+ */
+void UI::DeclarativeWidget::renderQueue()
+{
+  TRACE_SCOPE("UI::DeclarativeWidget::renderQueue");
+
+  // Get the items that are still able to render their widget
+  QVector<UI::DeclarativeWidget *> items;
+  for (int i = 0; i < RENDER_QUEUE.count(); ++i)
+  {
+    auto item = RENDER_QUEUE.at(i).data();
+    if (item && item->m_widget && item->prepareImage())
+      items.append(item);
+
+    if (item)
+      item->m_queued = false;
+  }
+
+  // Paint the images concurrently
+  RENDER_QUEUE.clear();
+  QtConcurrent::blockingMap(items, [](UI::DeclarativeWidget *item) {
+    QElapsedTimer timer;
+    timer.start();
+    {
+      QPainter painter(&item->m_image);
+      item->renderOffscreen(&painter);
+    }
+    item->m_grabCost = averageCost(item->m_grabCost, timer.nsecsElapsed());
+  });
+
+  // Upload the images to the scene graph
+  for (int i = 0; i < items.count(); ++i)
+  {
+    items[i]->m_textureDirty = true;
+    items[i]->QQuickItem::update();
+  }
+}
+
+/**
+ * Resizes the widget to fit inside the QML item.
  */
 void UI::DeclarativeWidget::resizeWidget()
 {
@@ -23,13 +23,45 @@
 #pragma once
 
 #include <QEvent>
-#include <QWidget>
+#include <QImage>
 #include <QPainter>
-#include <QQuickPaintedItem>
+#include <QWidget>
+#include <QPointer>
+#include <QQuickItem>
+
+class QOpenGLFramebufferObject;
 
 namespace UI
 {
-class DeclarativeWidget : public QQuickPaintedItem
+/**
+ * @brief The DeclarativeWidget class
+ *
+ * Displays a @c QWidget in the QML interface. The widget is rendered into a
+ * reusable image whenever it changes, and the image is uploaded as a texture
+ * to the Qt Quick scene graph (instead of grabbing a new pixmap and painting
+ * it again through a @c QQuickPaintedItem). Items that are not visible do not
+ * render their widget at all.
+ *
+ * Subclasses whose widget can paint itself with a plain @c QPainter (without
+ * receiving paint events) may implement @c renderOffscreen(). When parallel
+ * rendering is enabled, the items updated during a render tick are queued
+ * and their images are painted concurrently by the global thread pool, while
+ * the GUI thread waits for them. The GUI thread is blocked during that time,
+ * so the widgets are not modified while they are being painted.
+ *
+ * When OpenGL rendering is enabled and the scene graph uses OpenGL, these
+ * widgets are instead painted by the render thread (during the sync phase,
+ * while the GUI thread is blocked) with the OpenGL paint engine into a
+ * framebuffer object, whose texture is displayed directly by the scene graph
+ * without copying the pixels back to the CPU.
+ *
+ * The time spent grabbing the widget into its image (@c grabCost()) and
+ * uploading or painting it for the scene graph (@c paintCost()) is measured
+ * on every frame, both values are exponential moving averages in
+ * microseconds. With the framebuffer path, the widget is painted by the
+ * render thread, so all of its cost is reported as paint cost.
+ */
+class DeclarativeWidget : public QQuickItem
 {
   Q_OBJECT
   Q_PROPERTY(QWidget *widget READ widget WRITE setWidget NOTIFY widgetChanged)
@@ -43,7 +75,9 @@ public:
   QWidget *widget();
   void update(const QRect &rect = QRect());
 
-  virtual void paint(QPainter *painter) override;
+  qreal grabCost() const;
+  qreal paintCost() const;
+  static qreal averageCost(const qreal average, const qint64 nsecs);
 
   virtual void keyPressEvent(QKeyEvent *event) override;
   virtual void keyReleaseEvent(QKeyEvent *event) override;
@@ -64,11 +98,31 @@ public Q_SLOTS:
   void resizeWidget();
   void setWidget(QWidget *widget);
 
+protected:
+  virtual bool supportsOffscreenRendering() const;
+  virtual void renderOffscreen(QPainter *painter);
+  QSGNode *updatePaintNode(QSGNode *node, UpdatePaintNodeData *data) override;
+
 private:
-  void execEvent(void *function, void *event);
+  bool framebufferAvailable() const;
+  QSGNode *updateFramebufferNode(QSGNode *node);
+  void paintFramebuffer(QOpenGLFramebufferObject *target,
+                        QOpenGLFramebufferObject *resolve, const qreal ratio);
+
+  void renderWidget();
+  bool prepareImage();
+  void queueRender();
+  static void renderQueue();
 
 private:
-  QPixmap m_pixmap;
+  bool m_queued;
+  bool m_textureDirty;
+  bool m_useFramebuffer;
+  bool m_framebufferDirty;
+  qreal m_grabCost;
+  qreal m_paintCost;
+  QImage m_image;
+  QColor m_fillColor;
   QPointer<QWidget> m_widget;
 };
 } // namespace UI
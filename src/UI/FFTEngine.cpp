@@ -0,0 +1,520 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstring>
+
+#include <QtMath>
+#include <UI/Dashboard.h>
+#include <UI/FFTEngine.h>
+
+//----------------------------------------------------------------------------------------
+// Worker implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+UI::FFTWorker::FFTWorker()
+  : m_windowType(-1)
+  , m_generation(0)
+{
+}
+
+/**
+ * Discards the averaged spectra of all channels, blocks submitted with a
+ * generation number different from the given @a generation are ignored.
+ */
+void UI::FFTWorker::reset(const quint64 generation)
+{
+  m_generation = generation;
+  m_averages.clear();
+}
+
+/**
+ * Calculates the amplitude spectrum of the given @a blocks of samples (one
+ * per channel listed in @a indexes), applying the given @a window function &
+ * averaging the result with the previous spectra of each channel. The
+ * spectra are handed to the engine at once.
+ *
+ * The number of samples of each block must be a power of two, blocks of the
+ * same size are transformed together.
+ */
+void UI::FFTWorker::process(const quint64 generation,
+                            const QVector<int> &indexes,
+                            const QVector<QVector<float>> &blocks,
+                            const int window, const int averaging)
+{
+  // Batch submitted before the engine was reconfigured
+  if (generation != m_generation || indexes.count() != blocks.count())
+    return;
+
+  // Group the blocks by transform size
+  QHash<int, QVector<int>> groups;
+  for (int i = 0; i < blocks.count(); ++i)
+  {
+    if (indexes.at(i) >= 0 && BatchFFT::isValidSize(blocks.at(i).count()))
+      groups[blocks.at(i).count()].append(i);
+  }
+
+  // Get spectrum history of the channels
+  int maxIndex = -1;
+  for (const auto index : indexes)
+    maxIndex = qMax(maxIndex, index);
+  if (m_averages.count() <= maxIndex)
+    m_averages.resize(maxIndex + 1);
+
+  // Transform all the channels of each size at once
+  QVector<int> results;
+  QVector<QVector<float>> spectra;
+  for (auto it = groups.cbegin(); it != groups.cend(); ++it)
+  {
+    const int size = it.key();
+    const auto &members = it.value();
+    const int count = members.count();
+
+    // Copy the blocks of the group into a contiguous buffer
+    m_input.resize(size * count);
+    for (int c = 0; c < count; ++c)
+      memcpy(m_input.data() + c * size, blocks.at(members.at(c)).constData(),
+             size * sizeof(float));
+
+    // Execute FFT
+    const int half = size / 2;
+    const int bins = half + 1;
+    const auto &table = windowTable(size, window);
+    m_re.resize(bins * count);
+    m_im.resize(bins * count);
+    m_fft.forward(size, count, m_input.constData(),
+                  table.coefficients.constData(), m_re.data(), m_im.data());
+
+    // Obtain amplitudes of each channel
+    const float scale = 2.0f / (size * table.gain);
+    for (int c = 0; c < count; ++c)
+    {
+      // Reset averages if the FFT size changed
+      const int index = indexes.at(members.at(c));
+      auto &spectrum = m_averages[index];
+      const bool restart = spectrum.count() != bins;
+      if (restart)
+        spectrum.resize(bins);
+
+      const auto *re = m_re.constData() + c * bins;
+      const auto *im = m_im.constData() + c * bins;
+      for (int i = 0; i < bins; ++i)
+      {
+        auto amplitude = qSqrt(re[i] * re[i] + im[i] * im[i]) * scale;
+        if (i == 0 || i == half)
+          amplitude *= 0.5f;
+
+        if (restart || averaging <= 1)
+          spectrum[i] = amplitude;
+        else
+          spectrum[i] += (amplitude - spectrum.at(i)) / averaging;
+      }
+
+      results.append(index);
+      spectra.append(spectrum);
+    }
+  }
+
+  // Publish spectra
+  auto engine = &FFTEngine::instance();
+  QMetaObject::invokeMethod(engine, [=] {
+    engine->onSpectraReady(generation, results, spectra);
+  });
+}
+
+/**
+ * Returns the table of coefficients of the given @a window function for
+ * transforms of the given @a size, together with its coherent gain (used to
+ * normalize the amplitude of the spectrum). Tables are calculated once per
+ * size & discarded when the window function changes.
+ */
+const UI::FFTWorker::WindowTable &UI::FFTWorker::windowTable(const int size,
+                                                             const int window)
+{
+  // Discard the tables of the previous window function
+  if (m_windowType != window)
+  {
+    m_windows.clear();
+    m_windowType = window;
+  }
+
+  // Table already calculated
+  auto it = m_windows.constFind(size);
+  if (it != m_windows.constEnd())
+    return it.value();
+
+  // Calculate coefficients
+  double sum = 0;
+  WindowTable table;
+  table.coefficients.resize(size);
+  const double n = qMax(1, size - 1);
+  for (int i = 0; i < size; ++i)
+  {
+    double w;
+    const double x = 2 * M_PI * i / n;
+    switch (window)
+    {
+      case FFTEngine::Hann:
+        w = 0.5 - 0.5 * qCos(x);
+        break;
+      case FFTEngine::Hamming:
+        w = 0.54 - 0.46 * qCos(x);
+        break;
+      case FFTEngine::Blackman:
+        w = 0.42 - 0.5 * qCos(x) + 0.08 * qCos(2 * x);
+        break;
+      default:
+        w = 1;
+        break;
+    }
+
+    sum += w;
+    table.coefficients[i] = static_cast<float>(w);
+  }
+
+  table.gain = sum > 0 ? static_cast<float>(sum / size) : 1;
+  return m_windows.insert(size, table).value();
+}
+
+//----------------------------------------------------------------------------------------
+// Engine implementation
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function, starts the worker thread & connects the signals of
+ * the dashboard.
+ */
+UI::FFTEngine::FFTEngine()
+  : m_fftCount(0)
+  , m_generation(0)
+  , m_worker(new FFTWorker())
+{
+  // Read settings
+  m_window = m_settings.value("UI_FFTEngine_Window", Hann).toInt();
+  m_overlap = m_settings.value("UI_FFTEngine_Overlap", 50).toInt();
+  m_averaging = m_settings.value("UI_FFTEngine_Averaging", 1).toInt();
+
+  // Start worker thread
+  m_thread.setObjectName(QStringLiteral("UI::FFTWorker"));
+  m_worker->moveToThread(&m_thread);
+  connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+  m_thread.start();
+
+  // clang-format off
+    auto dash = &UI::Dashboard::instance();
+    connect(dash, &UI::Dashboard::updated,
+            this, &UI::FFTEngine::processData);
+    connect(dash, &UI::Dashboard::widgetCountChanged,
+            this, &UI::FFTEngine::configure);
+  // clang-format on
+}
+
+/**
+ * Destructor function, stops the worker thread
+ */
+UI::FFTEngine::~FFTEngine()
+{
+  m_thread.quit();
+  m_thread.wait();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+UI::FFTEngine &UI::FFTEngine::instance()
+{
+  static FFTEngine singleton;
+  return singleton;
+}
+
+/**
+ * Returns the window function applied to the samples before the FFT
+ */
+int UI::FFTEngine::window() const
+{
+  return m_window;
+}
+
+/**
+ * Returns the overlap between consecutive FFT blocks (in percent), the engine
+ * runs a new transform every time that (100 - overlap)% of the block has been
+ * replaced with new samples.
+ */
+int UI::FFTEngine::overlap() const
+{
+  return m_overlap;
+}
+
+/**
+ * Returns the number of spectra that are averaged together (with an
+ * exponential moving average), a value of 1 disables averaging.
+ */
+int UI::FFTEngine::averaging() const
+{
+  return m_averaging;
+}
+
+/**
+ * Returns the names of the window functions supported by the engine
+ */
+QStringList UI::FFTEngine::availableWindows() const
+{
+  return QStringList{tr("Rectangular"), tr("Hann"), tr("Hamming"),
+                     tr("Blackman")};
+}
+
+/**
+ * Returns the number of samples used by the transform of the given @a channel
+ */
+int UI::FFTEngine::size(const int channel) const
+{
+  if (channel >= 0 && channel < m_sizes.count())
+    return m_sizes.at(channel);
+
+  return 0;
+}
+
+/**
+ * Returns the channel that corresponds to the waterfall widget with the given
+ * @a index, the channel of an FFT plot is the index of the plot itself.
+ */
+int UI::FFTEngine::waterfallChannel(const int index) const
+{
+  return m_fftCount + index;
+}
+
+/**
+ * Returns the latest amplitude spectrum of the given @a channel, the spectrum
+ * has @c size() / 2 + 1 bins, or none if no transform has been calculated yet.
+ */
+const QVector<float> &UI::FFTEngine::spectrum(const int channel) const
+{
+  static QVector<float> empty;
+  if (channel >= 0 && channel < m_spectra.count())
+    return m_spectra.at(channel);
+
+  return empty;
+}
+
+/**
+ * Returns the largest transform size supported by the FFT calculator for the
+ * given number of @a samples (a power of two between 8 & 16384).
+ */
+int UI::FFTEngine::transformSize(const int samples)
+{
+  int size = 8;
+  const int limit = qMin(samples, 16384);
+  while (size * 2 <= limit)
+    size *= 2;
+
+  return size;
+}
+
+/**
+ * Changes the window function applied to the samples before the FFT
+ */
+void UI::FFTEngine::setWindow(const int window)
+{
+  const auto value = qBound(0, window, static_cast<int>(Blackman));
+  if (m_window != value)
+  {
+    m_window = value;
+    m_settings.setValue("UI_FFTEngine_Window", value);
+    configure();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the overlap between consecutive FFT blocks (in percent)
+ */
+void UI::FFTEngine::setOverlap(const int overlap)
+{
+  const auto value = qBound(0, overlap, 99);
+  if (m_overlap != value)
+  {
+    m_overlap = value;
+    m_settings.setValue("UI_FFTEngine_Overlap", value);
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Changes the number of spectra that are averaged together
+ */
+void UI::FFTEngine::setAveraging(const int averaging)
+{
+  const auto value = qMax(1, averaging);
+  if (m_averaging != value)
+  {
+    m_averaging = value;
+    m_settings.setValue("UI_FFTEngine_Averaging", value);
+    configure();
+    Q_EMIT configurationChanged();
+  }
+}
+
+/**
+ * Obtains the transform size of each FFT & waterfall widget, and discards the
+ * spectra and the pending blocks calculated with the previous configuration.
+ */
+void UI::FFTEngine::configure()
+{
+  // Invalidate blocks that are being processed
+  ++m_generation;
+  auto worker = m_worker;
+  auto generation = m_generation;
+  QMetaObject::invokeMethod(worker, [=] { worker->reset(generation); });
+
+  // Obtain transform sizes
+  auto dash = &UI::Dashboard::instance();
+  m_fftCount = dash->fftCount();
+  m_sizes.resize(m_fftCount + dash->waterfallCount());
+  for (int i = 0; i < m_fftCount; ++i)
+    m_sizes[i] = transformSize(dash->getFFT(i).fftSamples());
+  for (int i = m_fftCount; i < m_sizes.count(); ++i)
+    m_sizes[i] = transformSize(dash->getWaterfall(i - m_fftCount).fftSamples());
+
+  // Reset channel state
+  m_busy.fill(false, m_sizes.count());
+  m_sequences.fill(0, m_sizes.count());
+  m_spectra.clear();
+  m_spectra.resize(m_sizes.count());
+}
+
+/**
+ * Submits a new block of samples to the worker for each channel that received
+ * at least a hop worth of new samples since its last transform.
+ */
+void UI::FFTEngine::processData()
+{
+  // Check that the channels match the dashboard widgets
+  auto dash = &UI::Dashboard::instance();
+  if (dash->fftCount() != m_fftCount
+      || dash->fftCount() + dash->waterfallCount() != m_sizes.count())
+    configure();
+
+  // Check each channel
+  QVector<int> indexes;
+  QVector<QVector<float>> blocks;
+  for (int i = 0; i < m_sizes.count(); ++i)
+  {
+    // Previous block is still being processed
+    if (m_busy.at(i))
+      continue;
+
+    // History not available yet
+    const auto buffer = history(i);
+    if (!buffer)
+      continue;
+
+    // History was reset, start counting samples again
+    const auto &history = *buffer;
+    const auto sequence = history.sequence();
+    if (sequence < m_sequences.at(i))
+      m_sequences[i] = 0;
+
+    // Check if we have received enough new samples
+    const int size = m_sizes.at(i);
+    const auto hop = static_cast<quint64>(
+        qMax(1, size * (100 - m_overlap) / 100));
+    if (sequence - m_sequences.at(i) < hop)
+      continue;
+
+    // Copy the latest samples, padding with zeros if required
+    QVector<float> samples(size, 0);
+    const int available = qMin(size, history.size());
+    const int offset = history.size() - available;
+    const int start = size - available;
+    for (int j = 0; j < available; ++j)
+      samples[start + j] = static_cast<float>(history.at(offset + j));
+
+    // Add block to the batch
+    m_busy[i] = true;
+    m_sequences[i] = sequence;
+    indexes.append(i);
+    blocks.append(samples);
+  }
+
+  // Submit all the blocks to the worker at once
+  if (!indexes.isEmpty())
+  {
+    auto worker = m_worker;
+    auto window = m_window;
+    auto averaging = m_averaging;
+    auto generation = m_generation;
+    QMetaObject::invokeMethod(worker, [=] {
+      worker->process(generation, indexes, blocks, window, averaging);
+    });
+  }
+}
+
+/**
+ * Returns the sample history of the given @a channel, or @c nullptr if the
+ * dashboard has not created it yet.
+ */
+const UI::PlotBuffer *UI::FFTEngine::history(const int channel) const
+{
+  auto dash = &UI::Dashboard::instance();
+  if (channel < m_fftCount)
+  {
+    const auto &values = dash->fftPlotValues();
+    if (channel < values.count())
+      return &values.at(channel);
+  }
+
+  else
+  {
+    const auto &values = dash->waterfallValues();
+    if (channel - m_fftCount < values.count())
+      return &values.at(channel - m_fftCount);
+  }
+
+  return Q_NULLPTR;
+}
+
+/**
+ * Stores the @a spectra calculated by the worker for the channels with the
+ * given @a indexes & notifies the widgets.
+ */
+void UI::FFTEngine::onSpectraReady(const quint64 generation,
+                                   const QVector<int> &indexes,
+                                   const QVector<QVector<float>> &spectra)
+{
+  // Spectra calculated with a previous configuration
+  if (generation != m_generation)
+    return;
+
+  // Update spectra
+  for (int i = 0; i < indexes.count(); ++i)
+  {
+    const int index = indexes.at(i);
+    if (index < 0 || index >= m_spectra.count())
+      continue;
+
+    m_busy[index] = false;
+    m_spectra[index] = spectra.at(i);
+    Q_EMIT spectrumUpdated(index);
+  }
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QThread>
+#include <QObject>
+#include <QVector>
+#include <QStringList>
+
+#include <UI/BatchFFT.h>
+#include <Misc/Settings.h>
+
+namespace UI
+{
+class PlotBuffer;
+
+/**
+ * @brief The FFTWorker class
+ *
+ * Worker object of the @c FFTEngine, runs in its own thread and computes the
+ * amplitude spectrum of the sample blocks submitted by the engine.
+ *
+ * Each batch contains the blocks of every channel that was ready when the
+ * engine checked the dashboard. Blocks of the same size are transformed
+ * together by a @c BatchFFT, and the resulting spectra are handed back to the
+ * engine at once.
+ *
+ * The transformer, the window tables & the intermediate buffers are kept
+ * between calls, so no memory is allocated or recalculated unless the sizes
+ * of the FFTs or the window function change.
+ */
+class FFTWorker : public QObject
+{
+  Q_OBJECT
+
+public:
+  FFTWorker();
+
+public Q_SLOTS:
+  void reset(const quint64 generation);
+  void process(const quint64 generation, const QVector<int> &indexes,
+               const QVector<QVector<float>> &blocks, const int window,
+               const int averaging);
+
+private:
+  struct WindowTable
+  {
+    float gain;
+    QVector<float> coefficients;
+  };
+
+  const WindowTable &windowTable(const int size, const int window);
+
+private:
+  int m_windowType;
+  quint64 m_generation;
+
+  BatchFFT m_fft;
+  QVector<float> m_re;
+  QVector<float> m_im;
+  QVector<float> m_input;
+  QHash<int, WindowTable> m_windows;
+  QVector<QVector<float>> m_averages;
+};
+
+/**
+ * @brief The FFTEngine class
+ *
+ * Computes the spectrum of the datasets displayed by the FFT widgets in a
+ * background thread.
+ *
+ * Instead of running a transform for every frame, the engine waits until
+ * enough new samples have been appended to the FFT history of the dashboard
+ * (the hop size, obtained from the overlap between consecutive blocks) before
+ * submitting a new block to the worker. If the worker is still busy with the
+ * previous block of a channel, the block is not submitted and the channel is
+ * checked again when new data arrives. All the blocks that are ready at the
+ * same time are submitted to the worker as a single batch, so channels with
+ * the same transform size share a single multi-channel transform.
+ *
+ * The latest spectrum of each channel is published with the
+ * @c spectrumUpdated() signal, the widgets only need to draw it.
+ *
+ * Channels are numbered in the same order as the dashboard widgets: first the
+ * FFT plots, followed by the waterfall widgets (see @c waterfallChannel()).
+ */
+class FFTEngine : public QObject
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int window
+               READ window
+               WRITE setWindow
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int overlap
+               READ overlap
+               WRITE setOverlap
+               NOTIFY configurationChanged)
+    Q_PROPERTY(int averaging
+               READ averaging
+               WRITE setAveraging
+               NOTIFY configurationChanged)
+    Q_PROPERTY(QStringList availableWindows
+               READ availableWindows
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void configurationChanged();
+  void spectrumUpdated(const int index);
+
+private:
+  explicit FFTEngine();
+  ~FFTEngine();
+  FFTEngine(FFTEngine &&) = delete;
+  FFTEngine(const FFTEngine &) = delete;
+  FFTEngine &operator=(FFTEngine &&) = delete;
+  FFTEngine &operator=(const FFTEngine &) = delete;
+
+public:
+  enum Window
+  {
+    Rectangular,
+    Hann,
+    Hamming,
+    Blackman
+  };
+  Q_ENUM(Window)
+
+  static FFTEngine &instance();
+
+  int window() const;
+  int overlap() const;
+  int averaging() const;
+  QStringList availableWindows() const;
+
+  int size(const int channel) const;
+  int waterfallChannel(const int index) const;
+  const QVector<float> &spectrum(const int channel) const;
+
+  static int transformSize(const int samples);
+
+public Q_SLOTS:
+  void setWindow(const int window);
+  void setOverlap(const int overlap);
+  void setAveraging(const int averaging);
+
+private Q_SLOTS:
+  void configure();
+  void processData();
+
+private:
+  const PlotBuffer *history(const int channel) const;
+  void onSpectraReady(const quint64 generation, const QVector<int> &indexes,
+                      const QVector<QVector<float>> &spectra);
+
+private:
+  int m_window;
+  int m_overlap;
+  int m_averaging;
+  int m_fftCount;
+  quint64 m_generation;
+
+  QVector<int> m_sizes;
+  QVector<bool> m_busy;
+  QVector<quint64> m_sequences;
+  QVector<QVector<float>> m_spectra;
+
+  QThread m_thread;
+  FFTWorker *m_worker;
+  Misc::Settings m_settings;
+
+  friend class FFTWorker;
+};
+} // namespace UI
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+#include <QPair>
+#include <UI/GpsTrack.h>
+
+/**
+ * Length of the equator in meters
+ */
+static const double EARTH_CIRCUMFERENCE = 40075016.686;
+
+/**
+ * Maximum latitude that can be represented with the Web Mercator projection
+ */
+static const double MAX_LATITUDE = 85.05112878;
+
+/**
+ * Maximum number of positions compared with the simplification window
+ */
+static const int WINDOW_LIMIT = 256;
+
+/**
+ * Constructor function, configures the maximum number of retained points &
+ * the simplification @a tolerance (in meters).
+ */
+UI::GpsTrack::GpsTrack(const int capacity, const double tolerance)
+  : m_capacity(qMax(16, capacity))
+  , m_scale(EARTH_CIRCUMFERENCE)
+  , m_tolerance(qMax(0.0, tolerance))
+  , m_revision(0)
+{
+}
+
+/**
+ * Returns the number of points that compose the track, including the latest
+ * reported position.
+ */
+int UI::GpsTrack::size() const
+{
+  return m_points.count() + (m_window.isEmpty() ? 0 : 1);
+}
+
+/**
+ * Returns @c true if no position has been registered
+ */
+bool UI::GpsTrack::isEmpty() const
+{
+  return m_points.isEmpty();
+}
+
+/**
+ * Returns the maximum number of points retained by the track
+ */
+int UI::GpsTrack::capacity() const
+{
+  return m_capacity;
+}
+
+/**
+ * Returns the maximum deviation (in meters) between the simplified track &
+ * the reported positions.
+ */
+double UI::GpsTrack::tolerance() const
+{
+  return m_tolerance;
+}
+
+/**
+ * Returns a number that changes every time that the track is modified, used
+ * by the views to know when they need to upload the track again.
+ */
+quint64 UI::GpsTrack::revision() const
+{
+  return m_revision;
+}
+
+/**
+ * Returns the number of bytes allocated by the points of the track
+ */
+qint64 UI::GpsTrack::allocatedBytes() const
+{
+  const auto points = m_points.capacity() + m_window.capacity();
+  return qint64(points) * sizeof(QPointF);
+}
+
+/**
+ * Returns the normalized Web Mercator coordinates of the point at the given
+ * @a index, the last point being the latest reported position.
+ */
+QPointF UI::GpsTrack::at(const int index) const
+{
+  if (index < m_points.count())
+    return m_points.at(index);
+
+  return m_latest;
+}
+
+/**
+ * Converts the given @a latitude & @a longitude (in degrees) to normalized
+ * Web Mercator coordinates, (0, 0) being the north-western corner of the map
+ * and (1, 1) the south-eastern corner.
+ */
+QPointF UI::GpsTrack::project(const double latitude, const double longitude)
+{
+  const double lat = qBound(-MAX_LATITUDE, latitude, MAX_LATITUDE);
+  const double sine = qSin(qDegreesToRadians(lat));
+  const double x = (longitude + 180.0) / 360.0;
+  const double y = 0.5 - qLn((1 + sine) / (1 - sine)) / (4 * M_PI);
+  return QPointF(x, y);
+}
+
+/**
+ * Removes all the points of the track
+ */
+void UI::GpsTrack::clear()
+{
+  m_points.clear();
+  m_window.clear();
+  m_latest = QPointF();
+  ++m_revision;
+}
+
+/**
+ * Registers a new position reported by the GPS & updates the simplified track.
+ */
+void UI::GpsTrack::append(const double latitude, const double longitude)
+{
+  // Invalid position
+  if (!qIsFinite(latitude) || !qIsFinite(longitude))
+    return;
+
+  // Update meters per normalized unit at the current latitude
+  const auto point = project(latitude, longitude);
+  const double lat = qBound(-MAX_LATITUDE, latitude, MAX_LATITUDE);
+  m_scale = EARTH_CIRCUMFERENCE * qCos(qDegreesToRadians(lat));
+
+  // First position, retain it directly
+  if (m_points.isEmpty())
+  {
+    commit(point);
+    m_latest = point;
+    return;
+  }
+
+  // Position is too close to the latest position, discard it
+  const auto delta = point - m_latest;
+  const double distance = qSqrt(QPointF::dotProduct(delta, delta)) * m_scale;
+  if (distance < m_tolerance)
+    return;
+
+  // Check if the window can still be approximated by a straight line
+  bool deviates = m_window.count() >= WINDOW_LIMIT;
+  const auto anchor = m_points.last();
+  for (int i = 0; i < m_window.count() && !deviates; ++i)
+    deviates = deviation(m_window.at(i), anchor, point) > m_tolerance;
+
+  // Retain the previous position & start a new window
+  if (deviates)
+  {
+    commit(m_latest);
+    m_window.clear();
+  }
+
+  // Register the position
+  m_latest = point;
+  m_window.append(point);
+  ++m_revision;
+}
+
+/**
+ * Retains the given @a point & compacts the track if it is full
+ */
+void UI::GpsTrack::commit(const QPointF &point)
+{
+  m_points.append(point);
+  if (m_points.count() >= m_capacity)
+    compact();
+
+  ++m_revision;
+}
+
+/**
+ * Simplifies the retained points with the Douglas-Peucker algorithm, the
+ * tolerance is doubled until at least a quarter of the capacity is freed.
+ * If the track is still full (e.g. noisy data), the oldest half of the track
+ * is discarded.
+ */
+void UI::GpsTrack::compact()
+{
+  // Simplify the track with increasing tolerances
+  QVector<bool> keep;
+  double tolerance = qMax(1.0, m_tolerance);
+  const int target = m_capacity * 3 / 4;
+  for (int i = 0; i < 8; ++i)
+  {
+    tolerance *= 2;
+    simplify(tolerance, keep);
+    if (keep.count(true) <= target)
+      break;
+  }
+
+  // Remove discarded points
+  int count = 0;
+  for (int i = 0; i < m_points.count(); ++i)
+  {
+    if (keep.at(i))
+      m_points[count++] = m_points.at(i);
+  }
+
+  m_points.resize(count);
+
+  // Track is still full, discard the oldest points
+  if (m_points.count() > target)
+    m_points.remove(0, m_points.count() - m_capacity / 2);
+}
+
+/**
+ * Runs the Douglas-Peucker algorithm over the retained points with the given
+ * @a tolerance (in meters), the points that shall be kept are marked in the
+ * @a keep vector.
+ *
+ * An explicit stack is used instead of recursion, so that the stack depth
+ * does not depend on the shape of the track.
+ */
+void UI::GpsTrack::simplify(const double tolerance, QVector<bool> &keep) const
+{
+  // Initialize parameters
+  const int count = m_points.count();
+  keep.fill(false, count);
+  if (count < 3)
+  {
+    keep.fill(true, count);
+    return;
+  }
+
+  // End points are always kept
+  keep[0] = true;
+  keep[count - 1] = true;
+
+  // Process each segment
+  QVector<QPair<int, int>> stack;
+  stack.append(qMakePair(0, count - 1));
+  while (!stack.isEmpty())
+  {
+    const auto segment = stack.takeLast();
+    const auto &a = m_points.at(segment.first);
+    const auto &b = m_points.at(segment.second);
+
+    // Find the point with the largest deviation from the segment
+    int index = -1;
+    double max = tolerance;
+    for (int i = segment.first + 1; i < segment.second; ++i)
+    {
+      const double d = deviation(m_points.at(i), a, b);
+      if (d > max)
+      {
+        max = d;
+        index = i;
+      }
+    }
+
+    // Keep the point & process both halves of the segment
+    if (index > 0)
+    {
+      keep[index] = true;
+      stack.append(qMakePair(segment.first, index));
+      stack.append(qMakePair(index, segment.second));
+    }
+  }
+}
+
+/**
+ * Returns the distance (in meters) between the given @a point & the segment
+ * that goes from @a a to @a b.
+ */
+double UI::GpsTrack::deviation(const QPointF &point, const QPointF &a,
+                               const QPointF &b) const
+{
+  // Get projection of the point over the segment
+  const auto ab = b - a;
+  const auto ap = point - a;
+  const double length = QPointF::dotProduct(ab, ab);
+  double t = 0;
+  if (length > 0)
+    t = qBound(0.0, QPointF::dotProduct(ap, ab) / length, 1.0);
+
+  // Calculate distance between the point & its projection
+  const auto delta = ap - ab * t;
+  return qSqrt(QPointF::dotProduct(delta, delta)) * m_scale;
+}
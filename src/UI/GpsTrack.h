@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+namespace UI
+{
+/**
+ * @brief The GpsTrack class
+ *
+ * Bounded history of the positions reported by a GPS widget, simplified
+ * incrementally as new positions arrive.
+ *
+ * Positions are stored as normalized Web Mercator coordinates (both axes in
+ * the [0, 1] range, see @c project()), which is the projection used by map
+ * tiles, so that the track can be drawn by converting each point to pixels
+ * with a single multiplication & offset.
+ *
+ * The track is simplified with an opening-window algorithm: positions after
+ * the last retained point are kept in a window, and a new point is only
+ * retained when a position of the window deviates more than the tolerance
+ * from the straight line between the last retained point & the latest
+ * position. Positions closer than the tolerance to the latest position are
+ * discarded directly. Straight paths & stops therefore cost a single point.
+ *
+ * When the track reaches its capacity, the retained points are simplified
+ * again with the Douglas-Peucker algorithm & twice the tolerance, so older
+ * sections of the track lose detail instead of being discarded.
+ */
+class GpsTrack
+{
+public:
+  explicit GpsTrack(const int capacity = 16384, const double tolerance = 2);
+
+  int size() const;
+  bool isEmpty() const;
+  int capacity() const;
+  double tolerance() const;
+  quint64 revision() const;
+  qint64 allocatedBytes() const;
+  QPointF at(const int index) const;
+
+  static QPointF project(const double latitude, const double longitude);
+
+  void clear();
+  void append(const double latitude, const double longitude);
+
+private:
+  void commit(const QPointF &point);
+  void compact();
+  void simplify(const double tolerance, QVector<bool> &keep) const;
+  double deviation(const QPointF &point, const QPointF &a,
+                   const QPointF &b) const;
+
+private:
+  int m_capacity;
+  double m_scale;
+  double m_tolerance;
+  quint64 m_revision;
+
+  QPointF m_latest;
+  QVector<QPointF> m_points;
+  QVector<QPointF> m_window;
+};
+} // namespace UI
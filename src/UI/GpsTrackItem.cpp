@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QtMath>
+#include <QStandardPaths>
+#include <QSGGeometryNode>
+#include <QSGFlatColorMaterial>
+
+#include <UI/Dashboard.h>
+#include <UI/GpsTrackItem.h>
+#include <Misc/Tracer.h>
+
+/**
+ * Constructor function, configures item flags & connects the signals of the
+ * dashboard to update the track.
+ */
+UI::GpsTrackItem::GpsTrackItem(QQuickItem *parent)
+  : QQuickItem(parent)
+  , m_index(-1)
+  , m_points(0)
+  , m_color(QColor(255, 0, 0))
+  , m_worldSize(256)
+  , m_centerLatitude(0)
+  , m_centerLongitude(0)
+  , m_revision(0)
+{
+  setFlag(ItemHasContents, true);
+
+  // clang-format off
+    auto dash = &UI::Dashboard::instance();
+    connect(dash, &UI::Dashboard::updated,
+            this, &UI::GpsTrackItem::updateData);
+    connect(dash, &UI::Dashboard::widgetCountChanged,
+            this, &UI::GpsTrackItem::updateData);
+  // clang-format on
+}
+
+/**
+ * Returns the index of the GPS widget whose track is displayed by the item
+ */
+int UI::GpsTrackItem::index() const
+{
+  return m_index;
+}
+
+/**
+ * Returns the number of points that compose the displayed track
+ */
+int UI::GpsTrackItem::points() const
+{
+  return m_points;
+}
+
+/**
+ * Returns the color used to draw the track
+ */
+QColor UI::GpsTrackItem::color() const
+{
+  return m_color;
+}
+
+/**
+ * Returns the width (in pixels) of the whole map at the current zoom level
+ */
+qreal UI::GpsTrackItem::worldSize() const
+{
+  return m_worldSize;
+}
+
+/**
+ * Returns the latitude displayed at the center of the item
+ */
+qreal UI::GpsTrackItem::centerLatitude() const
+{
+  return m_centerLatitude;
+}
+
+/**
+ * Returns the longitude displayed at the center of the item
+ */
+qreal UI::GpsTrackItem::centerLongitude() const
+{
+  return m_centerLongitude;
+}
+
+/**
+ * Returns the directory in which the map plugin stores the downloaded tiles,
+ * so that tiles are only downloaded once and maps load without network.
+ */
+QString UI::GpsTrackItem::tileCachePath()
+{
+  static QString path;
+  if (path.isEmpty())
+  {
+    const auto base
+        = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    path = QDir(base).filePath(QStringLiteral("MapTiles"));
+    QDir().mkpath(path);
+  }
+
+  return path;
+}
+
+/**
+ * Changes the @a index of the GPS widget whose track is displayed
+ */
+void UI::GpsTrackItem::setIndex(const int index)
+{
+  if (m_index != index)
+  {
+    m_index = index;
+    m_revision = 0;
+    updateData();
+    Q_EMIT indexChanged();
+  }
+}
+
+/**
+ * Changes the @a color used to draw the track
+ */
+void UI::GpsTrackItem::setColor(const QColor &color)
+{
+  if (m_color != color)
+  {
+    m_color = color;
+    update();
+    Q_EMIT colorChanged();
+  }
+}
+
+/**
+ * Changes the width (in pixels) of the whole map at the current zoom level
+ */
+void UI::GpsTrackItem::setWorldSize(const qreal worldSize)
+{
+  if (!qFuzzyCompare(m_worldSize, worldSize) && worldSize > 0)
+  {
+    m_worldSize = worldSize;
+    update();
+    Q_EMIT viewChanged();
+  }
+}
+
+/**
+ * Changes the latitude displayed at the center of the item
+ */
+void UI::GpsTrackItem::setCenterLatitude(const qreal latitude)
+{
+  if (!qFuzzyCompare(m_centerLatitude, latitude))
+  {
+    m_centerLatitude = latitude;
+    update();
+    Q_EMIT viewChanged();
+  }
+}
+
+/**
+ * Changes the longitude displayed at the center of the item
+ */
+void UI::GpsTrackItem::setCenterLongitude(const qreal longitude)
+{
+  if (!qFuzzyCompare(m_centerLongitude, longitude))
+  {
+    m_centerLongitude = longitude;
+    update();
+    Q_EMIT viewChanged();
+  }
+}
+
+/**
+ * Generates the vertices of the track by projecting each point of the track
+ * relative to the center of the map.
+ */
+QSGNode *UI::GpsTrackItem::updatePaintNode(QSGNode *node,
+                                           UpdatePaintNodeData *data)
+{
+  TRACE_SCOPE("UI::GpsTrackItem::updatePaintNode");
+  Q_UNUSED(data);
+
+  // Create geometry node
+  auto child = static_cast<QSGGeometryNode *>(node);
+  if (!child)
+  {
+    auto geometry
+        = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+    geometry->setLineWidth(3);
+    geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+
+    child = new QSGGeometryNode;
+    child->setGeometry(geometry);
+    child->setMaterial(new QSGFlatColorMaterial);
+    child->setFlag(QSGNode::OwnsGeometry);
+    child->setFlag(QSGNode::OwnsMaterial);
+  }
+
+  // Get track
+  const UI::GpsTrack *track = Q_NULLPTR;
+  const auto &tracks = UI::Dashboard::instance().gpsTracks();
+  if (m_index >= 0 && m_index < tracks.count())
+    track = &tracks.at(m_index);
+
+  // Get projection parameters
+  const auto center = GpsTrack::project(m_centerLatitude, m_centerLongitude);
+  const double cx = width() / 2 - center.x() * m_worldSize;
+  const double cy = height() / 2 - center.y() * m_worldSize;
+
+  // Generate vertices
+  const int count = track ? track->size() : 0;
+  auto geometry = child->geometry();
+  geometry->allocate(count);
+  auto vertices = geometry->vertexDataAsPoint2D();
+  for (int i = 0; i < count; ++i)
+  {
+    const auto point = track->at(i);
+    vertices[i].set(cx + point.x() * m_worldSize,
+                    cy + point.y() * m_worldSize);
+  }
+
+  // Update color
+  auto material = static_cast<QSGFlatColorMaterial *>(child->material());
+  material->setColor(m_color);
+  child->markDirty(QSGNode::DirtyGeometry | QSGNode::DirtyMaterial);
+
+  return child;
+}
+
+/**
+ * Schedules a redraw if the track has been modified since the last update
+ */
+void UI::GpsTrackItem::updateData()
+{
+  // Get track
+  const auto &tracks = UI::Dashboard::instance().gpsTracks();
+  if (m_index < 0 || m_index >= tracks.count())
+  {
+    if (m_points != 0)
+    {
+      m_points = 0;
+      update();
+      Q_EMIT pointsChanged();
+    }
+
+    return;
+  }
+
+  // Track did not change
+  const auto &track = tracks.at(m_index);
+  if (track.revision() == m_revision && track.size() == m_points)
+    return;
+
+  // Redraw the track
+  m_revision = track.revision();
+  update();
+
+  // Update number of points
+  if (m_points != track.size())
+  {
+    m_points = track.size();
+    Q_EMIT pointsChanged();
+  }
+}
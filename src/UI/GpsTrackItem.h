@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QColor>
+#include <QQuickItem>
+
+namespace UI
+{
+/**
+ * @brief The GpsTrackItem class
+ *
+ * Qt Quick item that draws the track of a GPS widget (see @c UI::GpsTrack)
+ * over a map as a single line strip node of the scene graph.
+ *
+ * The item uses the same Web Mercator projection as the map tiles. The map
+ * center & the size of the whole world in pixels at the current zoom level
+ * are bound from QML, so the track follows the map when the user pans or
+ * zooms it. The vertex buffer is only regenerated when the track or the view
+ * changes.
+ *
+ * The item also provides the directory in which the map tiles are cached
+ * between runs (see @c tileCachePath()).
+ */
+class GpsTrackItem : public QQuickItem
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int index
+               READ index
+               WRITE setIndex
+               NOTIFY indexChanged)
+    Q_PROPERTY(qreal centerLatitude
+               READ centerLatitude
+               WRITE setCenterLatitude
+               NOTIFY viewChanged)
+    Q_PROPERTY(qreal centerLongitude
+               READ centerLongitude
+               WRITE setCenterLongitude
+               NOTIFY viewChanged)
+    Q_PROPERTY(qreal worldSize
+               READ worldSize
+               WRITE setWorldSize
+               NOTIFY viewChanged)
+    Q_PROPERTY(QColor color
+               READ color
+               WRITE setColor
+               NOTIFY colorChanged)
+    Q_PROPERTY(int points
+               READ points
+               NOTIFY pointsChanged)
+    Q_PROPERTY(QString tileCachePath
+               READ tileCachePath
+               CONSTANT)
+  // clang-format on
+
+Q_SIGNALS:
+  void viewChanged();
+  void colorChanged();
+  void indexChanged();
+  void pointsChanged();
+
+public:
+  GpsTrackItem(QQuickItem *parent = 0);
+
+  int index() const;
+  int points() const;
+  QColor color() const;
+  qreal worldSize() const;
+  qreal centerLatitude() const;
+  qreal centerLongitude() const;
+
+  static QString tileCachePath();
+
+public Q_SLOTS:
+  void setIndex(const int index);
+  void setColor(const QColor &color);
+  void setWorldSize(const qreal worldSize);
+  void setCenterLatitude(const qreal latitude);
+  void setCenterLongitude(const qreal longitude);
+
+protected:
+  QSGNode *updatePaintNode(QSGNode *node, UpdatePaintNodeData *data) override;
+
+private Q_SLOTS:
+  void updateData();
+
+private:
+  int m_index;
+  int m_points;
+  QColor m_color;
+  qreal m_worldSize;
+  qreal m_centerLatitude;
+  qreal m_centerLongitude;
+  quint64 m_revision;
+};
+} // namespace UI
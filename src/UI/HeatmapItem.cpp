@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+#include <QQuickWindow>
+#include <QSGSimpleTextureNode>
+
+#include <UI/Colormap.h>
+#include <UI/Dashboard.h>
+#include <UI/HeatmapItem.h>
+
+/**
+ * Constructor function, configures item flags & connects the signals of the
+ * dashboard to update the matrix.
+ */
+UI::HeatmapItem::HeatmapItem(QQuickItem *parent)
+  : QQuickItem(parent)
+  , m_index(-1)
+  , m_rows(0)
+  , m_columns(0)
+  , m_autoscale(true)
+  , m_textureDirty(false)
+  , m_minValue(0)
+  , m_maxValue(1)
+{
+  setFlag(ItemHasContents, true);
+
+  // clang-format off
+    auto dash = &UI::Dashboard::instance();
+    connect(dash, &UI::Dashboard::updated,
+            this, &UI::HeatmapItem::updateData);
+    connect(dash, &UI::Dashboard::widgetCountChanged,
+            this, &UI::HeatmapItem::configure);
+    connect(this, &UI::HeatmapItem::visibleChanged,
+            this, &UI::HeatmapItem::update);
+    connect(this, &UI::HeatmapItem::smoothChanged,
+            this, &UI::HeatmapItem::update);
+  // clang-format on
+}
+
+/**
+ * Returns the index of the heatmap widget displayed by the item
+ */
+int UI::HeatmapItem::index() const
+{
+  return m_index;
+}
+
+/**
+ * Returns the number of rows of the displayed matrix
+ */
+int UI::HeatmapItem::rows() const
+{
+  return m_rows;
+}
+
+/**
+ * Returns the number of columns of the displayed matrix
+ */
+int UI::HeatmapItem::columns() const
+{
+  return m_columns;
+}
+
+/**
+ * Returns the value represented by the first color of the colormap
+ */
+qreal UI::HeatmapItem::minValue() const
+{
+  return m_minValue;
+}
+
+/**
+ * Returns the value represented by the last color of the colormap
+ */
+qreal UI::HeatmapItem::maxValue() const
+{
+  return m_maxValue;
+}
+
+/**
+ * Changes the index of the heatmap widget displayed by the item
+ */
+void UI::HeatmapItem::setIndex(const int index)
+{
+  if (m_index != index)
+  {
+    m_index = index;
+    configure();
+  }
+}
+
+/**
+ * Draws the matrix as a single textured quad, the texture is only re-uploaded
+ * if new values have been written since the last frame. Cells are drawn with
+ * sharp edges unless the item is smooth.
+ */
+QSGNode *UI::HeatmapItem::updatePaintNode(QSGNode *node,
+                                          UpdatePaintNodeData *data)
+{
+  Q_UNUSED(data);
+
+  // Nothing to draw
+  if (m_image.isNull() || width() <= 0 || height() <= 0 || !window())
+  {
+    delete node;
+    return Q_NULLPTR;
+  }
+
+  // Create node
+  auto heatmap = static_cast<QSGSimpleTextureNode *>(node);
+  if (!heatmap)
+  {
+    heatmap = new QSGSimpleTextureNode;
+    heatmap->setOwnsTexture(true);
+  }
+
+  // Upload image to the GPU, the previous texture is deleted by the node
+  if (m_textureDirty || !heatmap->texture())
+  {
+    heatmap->setTexture(window()->createTextureFromImage(m_image));
+    m_textureDirty = false;
+  }
+
+  // Stretch the matrix over the item
+  heatmap->setRect(boundingRect());
+  heatmap->setFiltering(smooth() ? QSGTexture::Linear : QSGTexture::Nearest);
+  return heatmap;
+}
+
+/**
+ * Allocates the image of the matrix for the current group & reads the range
+ * of the colormap, the values are autoscaled unless the first dataset of the
+ * group has a valid min/max range.
+ */
+void UI::HeatmapItem::configure()
+{
+  // Reset parameters
+  m_rows = 0;
+  m_columns = 0;
+  m_autoscale = true;
+  m_image = QImage();
+
+  // Get the size of the matrix, groups without a column count are squared
+  if (validIndex())
+  {
+    const auto &group = UI::Dashboard::instance().getHeatmap(m_index);
+    const int cells = group.datasetCount();
+    m_columns = group.columns();
+    if (m_columns <= 0)
+      m_columns = qCeil(qSqrt(cells));
+
+    if (cells > 0 && m_columns > 0)
+    {
+      m_columns = qMin(m_columns, cells);
+      m_rows = (cells + m_columns - 1) / m_columns;
+      m_image = QImage(m_columns, m_rows, QImage::Format_RGB32);
+      m_image.fill(UI::Colormap::thermal().first());
+
+      const auto &first = group.getDataset(0);
+      if (first.max() > first.min())
+      {
+        m_autoscale = false;
+        m_minValue = first.min();
+        m_maxValue = first.max();
+      }
+    }
+  }
+
+  // Update user interface
+  m_textureDirty = true;
+  Q_EMIT indexChanged();
+  Q_EMIT rangeChanged();
+  update();
+}
+
+/**
+ * Converts the current values of the matrix to colors, hidden items are not
+ * updated.
+ */
+void UI::HeatmapItem::updateData()
+{
+  // Item not visible or invalid
+  auto dash = &UI::Dashboard::instance();
+  if (!isVisible() || !validIndex() || m_image.isNull())
+    return;
+
+  // Get the values of the matrix from the value table of the frame
+  const auto &values = dash->currentFrame().values();
+  const int offset = dash->heatmapValueIndex(m_index);
+  const int cells = qMin(dash->getHeatmap(m_index).datasetCount(),
+                         m_rows * m_columns);
+  if (offset < 0 || offset + cells > values.count())
+    return;
+
+  // Update the range of the colormap with the current values
+  const double *data = values.constData() + offset;
+  if (m_autoscale)
+  {
+    bool valid = false;
+    double min = 0, max = 0;
+    for (int i = 0; i < cells; ++i)
+    {
+      const double v = data[i];
+      if (!qIsFinite(v))
+        continue;
+
+      min = valid ? qMin(min, v) : v;
+      max = valid ? qMax(max, v) : v;
+      valid = true;
+    }
+
+    if (valid)
+    {
+      m_minValue = min;
+      m_maxValue = max > min ? max : min + 1;
+    }
+  }
+
+  // Convert each value to a pixel, invalid values use the lowest color
+  const auto &colors = UI::Colormap::thermal();
+  const double scale = 255 / (m_maxValue - m_minValue);
+  for (int r = 0; r < m_rows; ++r)
+  {
+    auto line = reinterpret_cast<QRgb *>(m_image.scanLine(r));
+    for (int c = 0; c < m_columns; ++c)
+    {
+      int color = 0;
+      const int i = r * m_columns + c;
+      if (i < cells && qIsFinite(data[i]))
+      {
+        const double t = (data[i] - m_minValue) * scale + 0.5;
+        color = static_cast<int>(qBound(0.0, t, 255.0));
+      }
+
+      line[c] = colors.at(color);
+    }
+  }
+
+  // Upload the image in the next frame
+  m_textureDirty = true;
+  Q_EMIT rangeChanged();
+  update();
+}
+
+/**
+ * Returns @c true if the index of the item corresponds to a heatmap widget
+ */
+bool UI::HeatmapItem::validIndex() const
+{
+  return m_index >= 0 && m_index < UI::Dashboard::instance().heatmapCount();
+}
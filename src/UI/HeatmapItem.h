@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QQuickItem>
+
+namespace UI
+{
+/**
+ * @brief The HeatmapItem class
+ *
+ * Qt Quick item that draws the values of a heatmap group (e.g. the cells of a
+ * tactile or thermal sensor array) as a matrix of colored cells with the
+ * scene graph.
+ *
+ * The datasets of a group are stored contiguously in the value table of the
+ * frame (see @c JSON::Frame::values()), so each update reads the matrix in a
+ * single pass, converts every value to a pixel with the thermal colormap &
+ * uploads the whole matrix as one texture, at most once per frame. The
+ * texture is drawn with a single textured quad, so the cost of drawing the
+ * widget does not depend on the number of cells.
+ *
+ * Values are mapped to colors using the range (min/max) of the first dataset
+ * of the group, or the range of the current values if it is not set.
+ */
+class HeatmapItem : public QQuickItem
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int index
+               READ index
+               WRITE setIndex
+               NOTIFY indexChanged)
+    Q_PROPERTY(int rows
+               READ rows
+               NOTIFY indexChanged)
+    Q_PROPERTY(int columns
+               READ columns
+               NOTIFY indexChanged)
+    Q_PROPERTY(qreal minValue
+               READ minValue
+               NOTIFY rangeChanged)
+    Q_PROPERTY(qreal maxValue
+               READ maxValue
+               NOTIFY rangeChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void indexChanged();
+  void rangeChanged();
+
+public:
+  HeatmapItem(QQuickItem *parent = 0);
+
+  int index() const;
+  int rows() const;
+  int columns() const;
+  qreal minValue() const;
+  qreal maxValue() const;
+
+public Q_SLOTS:
+  void setIndex(const int index);
+
+protected:
+  QSGNode *updatePaintNode(QSGNode *node, UpdatePaintNodeData *data) override;
+
+private Q_SLOTS:
+  void configure();
+  void updateData();
+
+private:
+  bool validIndex() const;
+
+private:
+  int m_index;
+  int m_rows;
+  int m_columns;
+  bool m_autoscale;
+  bool m_textureDirty;
+  qreal m_minValue;
+  qreal m_maxValue;
+  QImage m_image;
+};
+} // namespace UI
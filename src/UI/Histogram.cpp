@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <cmath>
+#include <algorithm>
+
+#include <QtMath>
+#include <UI/Histogram.h>
+
+/**
+ * Width of the bins of an adaptive histogram after registering its first
+ * sample, relative to the magnitude of the sample.
+ */
+static constexpr double INITIAL_BIN_WIDTH = 1e-9;
+
+/**
+ * Constructor function, sets the number of bins & the number of samples of
+ * the sliding window. The histogram is adaptive until a range is set.
+ */
+UI::Histogram::Histogram(const int bins, const int window)
+  : m_head(0)
+  , m_size(0)
+  , m_window(qMax(1, window))
+  , m_sinceRefit(0)
+  , m_adaptive(true)
+  , m_width(0)
+  , m_lower(0)
+  , m_revision(0)
+{
+  // An even number of bins is required to merge bin pairs
+  m_counts.resize(qMax(2, bins + (bins % 2)));
+  m_counts.fill(0);
+  m_ring.resize(m_window);
+}
+
+/**
+ * Returns the number of bins of the histogram
+ */
+int UI::Histogram::bins() const
+{
+  return m_counts.count();
+}
+
+/**
+ * Returns the number of samples that are currently counted by the histogram
+ */
+int UI::Histogram::count() const
+{
+  return m_size;
+}
+
+/**
+ * Returns the maximum number of samples counted by the histogram
+ */
+int UI::Histogram::window() const
+{
+  return m_window;
+}
+
+/**
+ * Returns the number of samples of the fullest bin, used to scale the
+ * vertical axis of the histogram widget.
+ */
+int UI::Histogram::peak() const
+{
+  int peak = 0;
+  for (const auto count : m_counts)
+    peak = qMax(peak, count);
+
+  return peak;
+}
+
+/**
+ * Returns @c true if the range of the bins follows the registered samples
+ */
+bool UI::Histogram::adaptive() const
+{
+  return m_adaptive;
+}
+
+/**
+ * Returns the width of each bin, or 0 if an adaptive histogram did not
+ * register any sample yet.
+ */
+double UI::Histogram::binWidth() const
+{
+  return m_width;
+}
+
+/**
+ * Returns the lower edge of the first bin
+ */
+double UI::Histogram::lowerBound() const
+{
+  return m_lower;
+}
+
+/**
+ * Returns the upper edge of the last bin
+ */
+double UI::Histogram::upperBound() const
+{
+  return m_lower + m_width * bins();
+}
+
+/**
+ * Returns a number that changes every time that the histogram is modified,
+ * used by the widgets to skip repaints when no new samples arrived.
+ */
+quint64 UI::Histogram::revision() const
+{
+  return m_revision;
+}
+
+/**
+ * Returns the number of bytes allocated by the bins & the sample ring
+ */
+qint64 UI::Histogram::allocatedBytes() const
+{
+  return qint64(m_counts.capacity()) * sizeof(int)
+         + qint64(m_ring.capacity()) * sizeof(double);
+}
+
+/**
+ * Returns the number of samples of each bin, ordered from the lower to the
+ * upper bound of the histogram.
+ */
+const QVector<int> &UI::Histogram::counts() const
+{
+  return m_counts;
+}
+
+/**
+ * Discards all the registered samples, adaptive histograms are centered again
+ * on the next sample.
+ */
+void UI::Histogram::clear()
+{
+  m_head = 0;
+  m_size = 0;
+  m_sinceRefit = 0;
+  m_counts.fill(0);
+  if (m_adaptive)
+  {
+    m_width = 0;
+    m_lower = 0;
+  }
+
+  ++m_revision;
+}
+
+/**
+ * Registers the given @a value, evicting the oldest sample of the window if
+ * the ring is full.
+ */
+void UI::Histogram::append(const double value)
+{
+  // Ignore invalid samples
+  if (!qIsFinite(value))
+    return;
+
+  // Evict the oldest sample
+  int slot = (m_head + m_size) % m_window;
+  if (m_size == m_window)
+  {
+    auto &count = m_counts[binIndex(m_ring.at(m_head))];
+    if (count > 0)
+      --count;
+
+    slot = m_head;
+    m_head = (m_head + 1) % m_window;
+    --m_size;
+  }
+
+  // Center the bins on the first sample, or extend them to fit the sample
+  if (m_adaptive)
+  {
+    if (m_width <= 0)
+    {
+      m_width = qMax(1.0, qAbs(value)) * INITIAL_BIN_WIDTH;
+      m_lower = value - m_width * bins() / 2;
+    }
+
+    else if (value < m_lower || value >= upperBound())
+      grow(value);
+  }
+
+  // Register the sample
+  m_ring[slot] = value;
+  ++m_counts[binIndex(value)];
+  ++m_size;
+  ++m_revision;
+
+  // Fit the bins to the samples of the window once per window
+  if (m_adaptive && ++m_sinceRefit >= m_window)
+    refit();
+}
+
+/**
+ * Changes the number of samples of the sliding window, the latest samples
+ * that fit in the new window are kept & counted again.
+ */
+void UI::Histogram::setWindow(const int samples)
+{
+  const int window = qMax(1, samples);
+  if (m_window == window)
+    return;
+
+  // Copy the latest samples (as many as fit in the new window)
+  const int kept = qMin(m_size, window);
+  QVector<double> latest(kept);
+  for (int i = 0; i < kept; ++i)
+    latest[i] = m_ring.at((m_head + m_size - kept + i) % m_window);
+
+  // Resize the ring & count the copied samples again
+  m_window = window;
+  m_ring.resize(window);
+  m_ring.squeeze();
+  clear();
+  for (const auto value : latest)
+    append(value);
+}
+
+/**
+ * Fixes the range of the bins to the given @a minimum & @a maximum values,
+ * if the range is empty (e.g. both values are zero), the histogram becomes
+ * adaptive. The samples of the window are counted again with the new bins.
+ */
+void UI::Histogram::setRange(const double minimum, const double maximum)
+{
+  m_adaptive = !(minimum < maximum);
+  if (m_adaptive)
+  {
+    m_width = 0;
+    m_lower = 0;
+    refit();
+  }
+
+  else
+  {
+    m_lower = minimum;
+    m_width = (maximum - minimum) / bins();
+    recount();
+  }
+}
+
+/**
+ * Fits the bins of an adaptive histogram to the samples of the window if they
+ * only occupy a quarter of the bins. The samples are centered on the bins,
+ * leaving room for the window to drift before the range has to grow again.
+ */
+void UI::Histogram::refit()
+{
+  m_sinceRefit = 0;
+
+  // Do nothing if the samples are spread over enough bins
+  if (m_width > 0)
+  {
+    int first = -1;
+    int last = -1;
+    for (int i = 0; i < bins(); ++i)
+    {
+      if (m_counts.at(i) > 0)
+      {
+        last = i;
+        if (first < 0)
+          first = i;
+      }
+    }
+
+    if (first < 0 || (last - first + 1) * 4 > bins())
+      return;
+  }
+
+  // No samples to fit
+  if (m_size == 0)
+    return;
+
+  // Get the range of the samples of the window
+  double min = m_ring.at(m_head);
+  double max = min;
+  for (int i = 1; i < m_size; ++i)
+  {
+    const double value = m_ring.at((m_head + i) % m_window);
+    min = qMin(min, value);
+    max = qMax(max, value);
+  }
+
+  // Center the samples on the bins with twice their range
+  const double span = max - min;
+  const double center = min + span / 2;
+  const double minimum = qMax(1.0, qAbs(center)) * INITIAL_BIN_WIDTH;
+  m_width = qMax(2 * span / bins(), minimum);
+  m_lower = center - m_width * bins() / 2;
+  recount();
+}
+
+/**
+ * Counts the samples of the window again, used when the bins change in a way
+ * that does not preserve their edges.
+ */
+void UI::Histogram::recount()
+{
+  m_counts.fill(0);
+  for (int i = 0; i < m_size; ++i)
+    ++m_counts[binIndex(m_ring.at((m_head + i) % m_window))];
+
+  ++m_revision;
+}
+
+/**
+ * Doubles the range of an adaptive histogram towards the given @a value until
+ * the value fits in the bins. Each step merges the adjacent bin pairs into the
+ * half of the bins opposite to the direction of growth, so the new bin edges
+ * are a subset of the previous ones.
+ */
+void UI::Histogram::grow(const double value)
+{
+  const int half = bins() / 2;
+  while (value < m_lower || value >= upperBound())
+  {
+    // Extend towards the lower values, merged bins go to the upper half
+    if (value < m_lower)
+    {
+      for (int i = bins() - 1; i >= half; --i)
+      {
+        const int j = 2 * (i - half);
+        m_counts[i] = m_counts.at(j) + m_counts.at(j + 1);
+      }
+
+      std::fill(m_counts.begin(), m_counts.begin() + half, 0);
+      m_lower -= m_width * bins();
+    }
+
+    // Extend towards the upper values, merged bins go to the lower half
+    else
+    {
+      for (int i = 0; i < half; ++i)
+        m_counts[i] = m_counts.at(2 * i) + m_counts.at(2 * i + 1);
+
+      std::fill(m_counts.begin() + half, m_counts.end(), 0);
+    }
+
+    m_width *= 2;
+  }
+}
+
+/**
+ * Returns the bin that counts the given @a value, values outside of the range
+ * of the histogram are assigned to the first or the last bin.
+ */
+int UI::Histogram::binIndex(const double value) const
+{
+  if (m_width <= 0)
+    return 0;
+
+  const double bin = std::floor((value - m_lower) / m_width);
+  return static_cast<int>(qBound(0.0, bin, double(bins() - 1)));
+}
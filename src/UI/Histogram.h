@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QVector>
+
+namespace UI
+{
+/**
+ * @brief The Histogram class
+ *
+ * Distribution of the latest samples of a dataset, binned incrementally as
+ * the samples arrive instead of being recomputed from the plot history every
+ * time the widget is repainted.
+ *
+ * The samples are kept in a ring with @c window() slots. Appending a sample to
+ * a full ring evicts the oldest sample & decrements its bin, so registering a
+ * sample costs O(1) & reading the distribution costs O(bins), regardless of
+ * the window size.
+ *
+ * The range of the bins is either fixed (see @c setRange()) or adaptive:
+ *
+ * - An adaptive histogram starts with narrow bins centered on the first
+ *   sample. When a sample falls outside of the range, the range is doubled
+ *   towards the sample by merging adjacent bin pairs, which keeps the bin
+ *   edges aligned, so evicted samples always land on the bin that counted
+ *   them.
+ * - Once per window, if the samples only occupy a quarter of the bins (e.g.
+ *   after a spike left the window), the bins are fitted to the samples of the
+ *   ring again. This costs O(window) once every @c window() samples, which
+ *   keeps the amortized cost of each sample constant.
+ *
+ * Samples that are not finite numbers are ignored. Samples outside of a fixed
+ * range are counted by the first or the last bin.
+ */
+class Histogram
+{
+public:
+  explicit Histogram(const int bins = 64, const int window = 100);
+
+  int bins() const;
+  int count() const;
+  int window() const;
+  int peak() const;
+  bool adaptive() const;
+  double binWidth() const;
+  double lowerBound() const;
+  double upperBound() const;
+  quint64 revision() const;
+  qint64 allocatedBytes() const;
+  const QVector<int> &counts() const;
+
+  void clear();
+  void append(const double value);
+  void setWindow(const int samples);
+  void setRange(const double minimum, const double maximum);
+
+private:
+  void refit();
+  void recount();
+  void grow(const double value);
+  int binIndex(const double value) const;
+
+private:
+  int m_head;
+  int m_size;
+  int m_window;
+  int m_sinceRefit;
+  bool m_adaptive;
+  double m_width;
+  double m_lower;
+  quint64 m_revision;
+
+  QVector<int> m_counts;
+  QVector<double> m_ring;
+};
+} // namespace UI
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <UI/PlotBuffer.h>
+
+/**
+ * Constructor function, creates a buffer with @a size samples initialized to
+ * the given @a value.
+ */
+UI::PlotBuffer::PlotBuffer(const int size, const double value)
+  : m_head(0)
+  , m_sequence(0)
+{
+  resize(size, value);
+}
+
+/**
+ * Returns the number of samples stored in the buffer
+ */
+int UI::PlotBuffer::size() const
+{
+  return m_data.size();
+}
+
+/**
+ * Returns @c true if the buffer cannot hold any sample
+ */
+bool UI::PlotBuffer::isEmpty() const
+{
+  return m_data.isEmpty();
+}
+
+/**
+ * Returns the smallest sample stored in the buffer, or 0 if the buffer is
+ * empty.
+ */
+double UI::PlotBuffer::min() const
+{
+  if (m_min.empty())
+    return 0;
+
+  return m_min.front().value;
+}
+
+/**
+ * Returns the largest sample stored in the buffer, or 0 if the buffer is
+ * empty.
+ */
+double UI::PlotBuffer::max() const
+{
+  if (m_max.empty())
+    return 0;
+
+  return m_max.front().value;
+}
+
+/**
+ * Returns the latest sample appended to the buffer
+ *
+ * @warning the buffer must not be empty
+ */
+double UI::PlotBuffer::last() const
+{
+  return at(m_data.size() - 1);
+}
+
+/**
+ * Returns the sample located at the given logical @a index, where index 0 is
+ * the oldest sample of the buffer.
+ *
+ * @warning no bounds checking is performed, @a index must be smaller than
+ *          @c size().
+ */
+double UI::PlotBuffer::at(const int index) const
+{
+  auto position = m_head + index;
+  if (position >= m_data.size())
+    position -= m_data.size();
+
+  return m_data.at(position);
+}
+
+/**
+ * Returns the number of samples written to the buffer (including the values
+ * written by @c fill() or @c resize(), which reset this counter). Consumers use
+ * this value to know how many new samples have been appended since they last
+ * read the buffer.
+ */
+quint64 UI::PlotBuffer::sequence() const
+{
+  return m_sequence;
+}
+
+/**
+ * Returns the number of bytes allocated by the samples of the buffer & by the
+ * queues used to track the minimum & maximum values.
+ */
+qint64 UI::PlotBuffer::allocatedBytes() const
+{
+  const auto extremes = m_min.size() + m_max.size();
+  return qint64(m_data.capacity()) * sizeof(double)
+         + qint64(extremes) * sizeof(Extreme);
+}
+
+/**
+ * Appends the given @a value to the buffer, replacing the oldest sample.
+ */
+void UI::PlotBuffer::append(const double value)
+{
+  if (m_data.isEmpty())
+    return;
+
+  // Replace oldest sample
+  m_data[m_head] = value;
+  if (++m_head >= m_data.size())
+    m_head = 0;
+
+  // Remove evicted sample from the extreme queues
+  const auto sequence = m_sequence++;
+  const auto oldest = m_sequence - static_cast<quint64>(m_data.size());
+  while (!m_min.empty() && m_min.front().sequence < oldest)
+    m_min.pop_front();
+  while (!m_max.empty() && m_max.front().sequence < oldest)
+    m_max.pop_front();
+
+  // Remove samples that can no longer be the minimum or the maximum
+  while (!m_min.empty() && m_min.back().value >= value)
+    m_min.pop_back();
+  while (!m_max.empty() && m_max.back().value <= value)
+    m_max.pop_back();
+
+  // Register new sample
+  m_min.push_back({sequence, value});
+  m_max.push_back({sequence, value});
+}
+
+/**
+ * Sets every sample of the buffer to the given @a value
+ */
+void UI::PlotBuffer::fill(const double value)
+{
+  m_head = 0;
+  m_data.fill(value);
+  resetExtremes(value);
+}
+
+/**
+ * Changes the number of samples stored in the buffer. The latest samples are
+ * preserved (as many as fit in the new size), and the older positions of a
+ * grown buffer are set to the given @a value.
+ */
+void UI::PlotBuffer::resize(const int size, const double value)
+{
+  // Copy the latest samples to the end of the new buffer
+  const int count = qMax(0, size);
+  const int kept = qMin<int>(count, m_data.size());
+  QVector<double> data(count, value);
+  for (int i = 0; i < kept; ++i)
+    data[count - kept + i] = at(m_data.size() - kept + i);
+
+  // Replace the buffer, the oldest sample is at the start of the new buffer
+  m_head = 0;
+  m_data.swap(data);
+
+  // Rebuild the extreme queues from the samples of the new buffer
+  m_min.clear();
+  m_max.clear();
+  m_sequence = 0;
+  for (int i = 0; i < m_data.size(); ++i)
+  {
+    const auto sample = m_data.at(i);
+    while (!m_min.empty() && m_min.back().value >= sample)
+      m_min.pop_back();
+    while (!m_max.empty() && m_max.back().value <= sample)
+      m_max.pop_back();
+
+    m_min.push_back({m_sequence, sample});
+    m_max.push_back({m_sequence, sample});
+    ++m_sequence;
+  }
+}
+
+/**
+ * Resets the extreme queues after every sample of the buffer has been set to
+ * the given @a value, a single entry (the latest sample) represents them all.
+ */
+void UI::PlotBuffer::resetExtremes(const double value)
+{
+  m_min.clear();
+  m_max.clear();
+  m_sequence = static_cast<quint64>(m_data.size());
+  if (m_data.isEmpty())
+    return;
+
+  m_min.push_back({m_sequence - 1, value});
+  m_max.push_back({m_sequence - 1, value});
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <deque>
+#include <QVector>
+
+namespace UI
+{
+/**
+ * @brief The PlotBuffer class
+ *
+ * Fixed-size circular buffer that stores the history of a plotted dataset.
+ *
+ * The buffer is always full: appending a sample overwrites the oldest one, so
+ * adding a new value to the history is an O(1) operation, regardless of the
+ * number of points displayed by the plots.
+ *
+ * Samples are accessed in logical order, index 0 being the oldest sample and
+ * index @c size() - 1 being the latest sample.
+ *
+ * The minimum & maximum values of the buffer are tracked with two monotonic
+ * queues that are updated when a sample is appended or evicted, so widgets can
+ * autoscale in amortized O(1) time per sample instead of scanning the history.
+ */
+class PlotBuffer
+{
+public:
+  explicit PlotBuffer(const int size = 0, const double value = 0);
+
+  int size() const;
+  bool isEmpty() const;
+  double min() const;
+  double max() const;
+  double last() const;
+  double at(const int index) const;
+  quint64 sequence() const;
+  qint64 allocatedBytes() const;
+
+  void append(const double value);
+  void fill(const double value);
+  void resize(const int size, const double value = 0);
+
+private:
+  void resetExtremes(const double value);
+
+private:
+  struct Extreme
+  {
+    quint64 sequence;
+    double value;
+  };
+
+  int m_head;
+  quint64 m_sequence;
+  QVector<double> m_data;
+  std::deque<Extreme> m_min;
+  std::deque<Extreme> m_max;
+};
+} // namespace UI
@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <UI/PlotHistory.h>
+
+/**
+ * Number of levels of the history pyramid
+ */
+static const int LEVEL_COUNT = 8;
+
+/**
+ * Number of buckets (or samples) of a level summarized by each bucket of the
+ * next level
+ */
+static const int LEVEL_FACTOR = 4;
+
+/**
+ * Maximum number of buckets stored by each level
+ */
+static const int LEVEL_CAPACITY = 2048;
+
+/**
+ * Constructor function, creates a history that keeps the latest @a points
+ * samples at full resolution, initialized to the given @a value.
+ */
+UI::PlotHistory::PlotHistory(const int points, const double value)
+  : m_timeHead(0)
+  , m_count(0)
+  , m_recent(points, value)
+  , m_times(qMax(0, points), 0)
+  , m_levels(LEVEL_COUNT)
+{
+}
+
+/**
+ * Returns the number of samples appended to the history since it was created
+ * or cleared.
+ */
+quint64 UI::PlotHistory::count() const
+{
+  return m_count;
+}
+
+/**
+ * Returns the time at which the oldest sample that is still summarized by the
+ * history was received, or 0 if the history is empty. Coarser levels cover
+ * longer periods of time, so the oldest bucket of the coarsest level that
+ * holds data is the oldest one.
+ */
+qint64 UI::PlotHistory::firstTime() const
+{
+  for (int i = LEVEL_COUNT - 1; i >= 0; --i)
+  {
+    if (levelSize(i) > 0)
+      return bucket(i, 0).time;
+  }
+
+  const auto stored = qMin<quint64>(m_recent.size(), m_count);
+  const int valid = m_recent.size() - static_cast<int>(stored);
+  if (stored > 0 && valid < m_times.count())
+    return time(valid);
+
+  return 0;
+}
+
+/**
+ * Returns the time at which the latest sample was received, or 0 if the
+ * history is empty.
+ */
+qint64 UI::PlotHistory::lastTime() const
+{
+  if (m_times.isEmpty())
+    return 0;
+
+  return time(m_times.count() - 1);
+}
+
+/**
+ * Returns the buffer that stores the latest samples at full resolution
+ */
+const UI::PlotBuffer &UI::PlotHistory::recent() const
+{
+  return m_recent;
+}
+
+/**
+ * Returns the time at which the full resolution sample located at the given
+ * logical @a index was received. Samples that were never written (e.g. after
+ * the number of points grows) have a timestamp of 0.
+ *
+ * @warning no bounds checking is performed, @a index must be smaller than
+ *          @c recent().size().
+ */
+qint64 UI::PlotHistory::time(const int index) const
+{
+  auto position = m_timeHead + index;
+  if (position >= m_times.count())
+    position -= m_times.count();
+
+  return m_times.at(position);
+}
+
+/**
+ * Returns the logical index of the oldest full resolution sample received at
+ * or after the given @a time, or @c recent().size() if there is none.
+ */
+int UI::PlotHistory::lowerBound(const qint64 time) const
+{
+  int low = 0;
+  int high = m_times.count();
+  while (low < high)
+  {
+    const int middle = low + (high - low) / 2;
+    if (this->time(middle) < time)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  return low;
+}
+
+/**
+ * Returns the number of bytes currently allocated by the history, including
+ * the full resolution buffer, the sample timestamps & the filled buckets of
+ * each level.
+ */
+qint64 UI::PlotHistory::allocatedBytes() const
+{
+  auto bytes = m_recent.allocatedBytes();
+  bytes += qint64(m_times.capacity()) * sizeof(qint64);
+  for (const auto &level : m_levels)
+    bytes += qint64(level.buckets.capacity()) * sizeof(Bucket);
+
+  return bytes;
+}
+
+/**
+ * Returns the number of levels of the history pyramid
+ */
+int UI::PlotHistory::levelCount()
+{
+  return LEVEL_COUNT;
+}
+
+/**
+ * Returns the maximum number of bytes used by the buckets of a history, the
+ * full resolution buffer is not included.
+ */
+qint64 UI::PlotHistory::memoryUsage()
+{
+  return qint64(LEVEL_COUNT) * LEVEL_CAPACITY * sizeof(Bucket);
+}
+
+/**
+ * Returns the number of samples summarized by each bucket of the given
+ * @a level.
+ */
+quint64 UI::PlotHistory::levelSpan(const int level)
+{
+  quint64 span = LEVEL_FACTOR;
+  for (int i = 0; i < level; ++i)
+    span *= LEVEL_FACTOR;
+
+  return span;
+}
+
+/**
+ * Returns the finest level that is able to display the latest @a samples
+ * samples, or -1 if the full resolution buffer holds enough samples. If no
+ * level covers that many samples, the coarsest level is returned.
+ */
+int UI::PlotHistory::level(const quint64 samples) const
+{
+  if (samples <= static_cast<quint64>(m_recent.size()))
+    return -1;
+
+  for (int i = 0; i < LEVEL_COUNT; ++i)
+  {
+    if (levelSpan(i) * LEVEL_CAPACITY >= samples)
+      return i;
+  }
+
+  return LEVEL_COUNT - 1;
+}
+
+/**
+ * Returns the number of buckets stored in the given @a level
+ */
+int UI::PlotHistory::levelSize(const int level) const
+{
+  if (level < 0 || level >= m_levels.count())
+    return 0;
+
+  return m_levels.at(level).buckets.count();
+}
+
+/**
+ * Returns the bucket located at the given logical @a index of the given
+ * @a level, where index 0 is the oldest bucket of the level.
+ *
+ * @warning no bounds checking is performed, @a index must be smaller than
+ *          @c levelSize().
+ */
+const UI::PlotHistory::Bucket &UI::PlotHistory::bucket(const int level,
+                                                       const int index) const
+{
+  const auto &l = m_levels.at(level);
+  auto position = l.head + index;
+  if (position >= l.buckets.count())
+    position -= l.buckets.count();
+
+  return l.buckets.at(position);
+}
+
+/**
+ * Returns the logical index of the oldest bucket of the given @a level that
+ * starts at or after the given @a time, or @c levelSize() if there is none.
+ */
+int UI::PlotHistory::lowerBound(const int level, const qint64 time) const
+{
+  int low = 0;
+  int high = levelSize(level);
+  while (low < high)
+  {
+    const int middle = low + (high - low) / 2;
+    if (bucket(level, middle).time < time)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  return low;
+}
+
+/**
+ * Changes the number of samples kept at full resolution. The latest samples
+ * (and their reception times) are preserved, the older positions of a grown
+ * buffer are set to the given @a value. The coarser levels are not modified,
+ * so the long-term history survives changes of the number of plot points.
+ */
+void UI::PlotHistory::setPoints(const int points, const double value)
+{
+  // Keep the reception times of the latest samples
+  const int count = qMax(0, points);
+  const int kept = qMin<int>(count, m_times.count());
+  QVector<qint64> times(count, 0);
+  for (int i = 0; i < kept; ++i)
+    times[count - kept + i] = time(m_times.count() - kept + i);
+
+  // Resize buffers, the latest samples are preserved
+  m_timeHead = 0;
+  m_times.swap(times);
+  m_recent.resize(points, value);
+}
+
+/**
+ * Removes all the data of the history, the number of full resolution samples
+ * is not modified.
+ */
+void UI::PlotHistory::clear()
+{
+  m_count = 0;
+  m_timeHead = 0;
+  m_recent.fill(0);
+  m_times.fill(0);
+  m_levels.fill(Level(), LEVEL_COUNT);
+}
+
+/**
+ * Appends the given @a value, received at the given @a time, to the full
+ * resolution buffer & feeds it to the history pyramid. A bucket is completed
+ * every @c LEVEL_FACTOR samples, which is then fed to the next level, so the
+ * amortized cost per sample is O(1).
+ */
+void UI::PlotHistory::append(const double value, const qint64 time)
+{
+  // Register sample & reception time
+  ++m_count;
+  m_recent.append(value);
+  if (!m_times.isEmpty())
+  {
+    m_times[m_timeHead] = time;
+    if (++m_timeHead >= m_times.count())
+      m_timeHead = 0;
+  }
+
+  // Feed the sample to the history pyramid
+  Bucket input = {value, value, value, time};
+  for (int i = 0; i < LEVEL_COUNT; ++i)
+  {
+    // Merge the input with the partial bucket of the level
+    auto &level = m_levels[i];
+    if (level.pending == 0)
+    {
+      level.partial = input;
+      level.sum = input.mean;
+    }
+
+    else
+    {
+      level.partial.min = qMin(level.partial.min, input.min);
+      level.partial.max = qMax(level.partial.max, input.max);
+      level.sum += input.mean;
+    }
+
+    // Bucket not complete yet, next levels are not affected
+    if (++level.pending < LEVEL_FACTOR)
+      break;
+
+    // Store the complete bucket & feed it to the next level
+    level.pending = 0;
+    level.partial.mean = level.sum / LEVEL_FACTOR;
+    input = level.partial;
+    push(i, input);
+  }
+}
+
+/**
+ * Appends the given @a bucket to the given @a level, replacing the oldest
+ * bucket once the level is full.
+ */
+void UI::PlotHistory::push(const int level, const Bucket &bucket)
+{
+  auto &l = m_levels[level];
+  if (l.buckets.count() < LEVEL_CAPACITY)
+  {
+    l.buckets.append(bucket);
+    return;
+  }
+
+  l.buckets[l.head] = bucket;
+  if (++l.head >= l.buckets.count())
+    l.head = 0;
+}
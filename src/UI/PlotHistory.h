@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <UI/PlotBuffer.h>
+
+namespace UI
+{
+/**
+ * @brief The PlotHistory class
+ *
+ * Multi-resolution history of a plotted dataset. The most recent samples are
+ * kept at full resolution in a @c PlotBuffer (sized with the number of points
+ * selected by the user), while older data is kept in a pyramid of levels of
+ * increasing coarseness:
+ *
+ * - Each bucket of level 0 summarizes @c LEVEL_FACTOR samples.
+ * - Each bucket of level N summarizes @c LEVEL_FACTOR buckets of level N - 1.
+ *
+ * For each bucket, the minimum, the maximum & the mean of the summarized
+ * samples are stored, so that plots can draw a min/max envelope of hours of
+ * data without reading (or storing) every sample.
+ *
+ * Each sample is stored with the time at which its frame was received (in
+ * microseconds, see @c IO::FrameQueue::timestamp()), and each bucket with the
+ * time of its oldest sample. Timestamps never decrease, so the samples or the
+ * buckets of a time window are located with a binary search (see
+ * @c lowerBound()).
+ *
+ * Every level is a ring of at most @c LEVEL_CAPACITY buckets, so the memory
+ * used by the history of a dataset is fixed (see @c memoryUsage()), no matter
+ * how long the application runs. Coarser levels cover longer periods of time,
+ * the oldest buckets of each level are overwritten as new data arrives.
+ *
+ * Bucket indexes are logical, index 0 being the oldest bucket of the level.
+ */
+class PlotHistory
+{
+public:
+  struct Bucket
+  {
+    double min;
+    double max;
+    double mean;
+    qint64 time;
+  };
+
+  explicit PlotHistory(const int points = 0, const double value = 0);
+
+  quint64 count() const;
+  qint64 firstTime() const;
+  qint64 lastTime() const;
+  const PlotBuffer &recent() const;
+  qint64 time(const int index) const;
+  int lowerBound(const qint64 time) const;
+  qint64 allocatedBytes() const;
+
+  static int levelCount();
+  static qint64 memoryUsage();
+  static quint64 levelSpan(const int level);
+
+  int level(const quint64 samples) const;
+  int levelSize(const int level) const;
+  const Bucket &bucket(const int level, const int index) const;
+  int lowerBound(const int level, const qint64 time) const;
+
+  void setPoints(const int points, const double value = 0);
+
+  void clear();
+  void append(const double value, const qint64 time = 0);
+
+private:
+  void push(const int level, const Bucket &bucket);
+
+private:
+  struct Level
+  {
+    int head = 0;
+    int pending = 0;
+    double sum = 0;
+    Bucket partial = {0, 0, 0, 0};
+    QVector<Bucket> buckets;
+  };
+
+  int m_timeHead;
+  quint64 m_count;
+  PlotBuffer m_recent;
+  QVector<qint64> m_times;
+  QVector<Level> m_levels;
+};
+} // namespace UI
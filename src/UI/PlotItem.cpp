@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+#include <QSGGeometryNode>
+#include <QSGFlatColorMaterial>
+
+#include <UI/PlotItem.h>
+#include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
+#include <Misc/ThemeManager.h>
+
+/**
+ * Constructor function, configures item flags & connects the signals of the
+ * dashboard to update the plot data.
+ */
+UI::PlotItem::PlotItem(QQuickItem *parent)
+  : QQuickItem(parent)
+  , m_index(-1)
+  , m_logScale(false)
+  , m_multiPlot(false)
+  , m_autoscale(true)
+  , m_normalize(false)
+  , m_minValue(0)
+  , m_maxValue(1)
+{
+  setFlag(ItemHasContents, true);
+
+  // clang-format off
+    auto dash = &UI::Dashboard::instance();
+    connect(dash, &UI::Dashboard::updated,
+            this, &UI::PlotItem::updateData);
+    connect(dash, &UI::Dashboard::pointsChanged,
+            this, &UI::PlotItem::redraw);
+    connect(dash, &UI::Dashboard::widgetCountChanged,
+            this, &UI::PlotItem::configure);
+    connect(this, &UI::PlotItem::visibleChanged,
+            this, &UI::PlotItem::redraw);
+  // clang-format on
+}
+
+/**
+ * Returns the index of the plot (or multiplot) displayed by the item
+ */
+int UI::PlotItem::index() const
+{
+  return m_index;
+}
+
+/**
+ * Returns @c true if the item displays a multiplot group instead of a single
+ * plotted dataset.
+ */
+bool UI::PlotItem::multiPlot() const
+{
+  return m_multiPlot;
+}
+
+/**
+ * Returns @c true if the vertical axis uses a logarithmic scale
+ */
+bool UI::PlotItem::logScale() const
+{
+  return m_logScale;
+}
+
+/**
+ * Returns the value displayed at the bottom of the plot
+ */
+qreal UI::PlotItem::minValue() const
+{
+  return m_minValue;
+}
+
+/**
+ * Returns the value displayed at the top of the plot
+ */
+qreal UI::PlotItem::maxValue() const
+{
+  return m_maxValue;
+}
+
+/**
+ * Changes the @a index of the plot (or multiplot) displayed by the item
+ */
+void UI::PlotItem::setIndex(const int index)
+{
+  if (m_index != index)
+  {
+    m_index = index;
+    configure();
+  }
+}
+
+/**
+ * Selects whether the item displays a multiplot group or a single dataset
+ */
+void UI::PlotItem::setMultiPlot(const bool multiPlot)
+{
+  if (m_multiPlot != multiPlot)
+  {
+    m_multiPlot = multiPlot;
+    configure();
+  }
+}
+
+/**
+ * Generates one line strip node per curve and updates the vertex buffers with
+ * the latest plot history. The vertices are generated directly from the ring
+ * buffers, in chronological order.
+ */
+QSGNode *UI::PlotItem::updatePaintNode(QSGNode *node, UpdatePaintNodeData *data)
+{
+  Q_UNUSED(data);
+
+  // Create root node
+  auto root = node;
+  if (!root)
+    root = new QSGNode;
+
+  // Remove unused curve nodes
+  const int curves = curveCount();
+  while (root->childCount() > curves)
+  {
+    auto child = root->lastChild();
+    root->removeChildNode(child);
+    delete child;
+  }
+
+  // Create missing curve nodes
+  while (root->childCount() < curves)
+  {
+    auto geometry
+        = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+    geometry->setLineWidth(2);
+    geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+
+    auto child = new QSGGeometryNode;
+    child->setGeometry(geometry);
+    child->setMaterial(new QSGFlatColorMaterial);
+    child->setFlag(QSGNode::OwnsGeometry);
+    child->setFlag(QSGNode::OwnsMaterial);
+    root->appendChildNode(child);
+  }
+
+  // Get scale parameters
+  const double w = width();
+  const double h = height();
+  const double min = mapValue(m_minValue);
+  const double range = qMax(mapValue(m_maxValue) - min, 1e-12);
+
+  // Update vertex buffers
+  for (int i = 0; i < curves; ++i)
+  {
+    auto child = static_cast<QSGGeometryNode *>(root->childAtIndex(i));
+    auto geometry = child->geometry();
+    auto material = static_cast<QSGFlatColorMaterial *>(child->material());
+
+    // Allocate vertices
+    const auto history = buffer(i);
+    const int count = history ? history->size() : 0;
+    geometry->allocate(count);
+
+    // Generate vertices
+    auto vertices = geometry->vertexDataAsPoint2D();
+    const double dx = count > 1 ? w / (count - 1) : 0;
+    for (int j = 0; j < count; ++j)
+    {
+      const double value = curveValue(i, history->at(j));
+      const double y = (mapValue(value) - min) / range;
+      vertices[j].set(j * dx, h - qBound(0.0, y, 1.0) * h);
+    }
+
+    // Update curve color
+    if (m_colors.count() > i)
+      material->setColor(m_colors.at(i));
+
+    child->markDirty(QSGNode::DirtyGeometry | QSGNode::DirtyMaterial);
+  }
+
+  return root;
+}
+
+/**
+ * Reads the scaling options & colors of the displayed datasets, and the
+ * normalization ranges of multiplot curves.
+ */
+void UI::PlotItem::configure()
+{
+  // Reset parameters
+  m_colors.clear();
+  m_scales.clear();
+  m_offsets.clear();
+  m_logScale = false;
+  m_autoscale = true;
+  m_normalize = false;
+
+  // Get curve colors
+  auto dash = &UI::Dashboard::instance();
+  auto colors = Misc::ThemeManager::instance().widgetColors();
+  if (validIndex() && !colors.isEmpty())
+  {
+    // Single plot, use the range of the dataset if available
+    if (!m_multiPlot)
+    {
+      const auto &dataset = dash->getPlot(m_index);
+      m_logScale = dataset.log();
+      m_colors.append(QColor(colors.at(m_index % colors.count())));
+      if (dataset.max() > dataset.min())
+      {
+        m_autoscale = false;
+        m_minValue = dataset.min();
+        m_maxValue = dataset.max();
+      }
+    }
+
+    // Multiplot, normalize the curves if all datasets have a valid range
+    else
+    {
+      const auto &group = dash->getMultiplot(m_index);
+      m_normalize = group.datasetCount() > 0;
+      for (int i = 0; i < group.datasetCount(); ++i)
+      {
+        const auto &dataset = group.getDataset(i);
+        const bool valid = dataset.max() > dataset.min();
+        m_normalize &= valid;
+        m_colors.append(QColor(colors.at(i % colors.count())));
+        m_offsets.append(valid ? dataset.min() : 0);
+        m_scales.append(valid ? 1 / (dataset.max() - dataset.min()) : 1);
+      }
+
+      if (m_normalize)
+      {
+        m_autoscale = false;
+        m_minValue = 0;
+        m_maxValue = 1;
+      }
+    }
+  }
+
+  // Update user interface
+  Q_EMIT indexChanged();
+  updateRange();
+  update();
+}
+
+/**
+ * Redraws the item with the latest values of the plot history, which is
+ * recorded by the dashboard for every frame.
+ */
+void UI::PlotItem::updateData()
+{
+  TRACE_SCOPE("UI::PlotItem::updateData");
+
+  // Invalid index, abort update
+  if (!validIndex())
+    return;
+
+  // Redraw item
+  redraw();
+}
+
+/**
+ * Updates the range & schedules a repaint of the item, nothing is done while
+ * the item is hidden (the history is still recorded, so the curves are
+ * brought up to date as soon as the item becomes visible again).
+ */
+void UI::PlotItem::redraw()
+{
+  if (isVisible())
+  {
+    updateRange();
+    update();
+  }
+}
+
+/**
+ * Returns the number of curves displayed by the item
+ */
+int UI::PlotItem::curveCount() const
+{
+  if (!validIndex())
+    return 0;
+
+  if (m_multiPlot)
+    return m_offsets.count();
+
+  return 1;
+}
+
+/**
+ * Returns @c true if the current index refers to an existing plot/multiplot
+ */
+bool UI::PlotItem::validIndex() const
+{
+  auto dash = &UI::Dashboard::instance();
+  if (m_multiPlot)
+    return m_index >= 0 && m_index < dash->multiPlotCount();
+
+  return m_index >= 0 && m_index < dash->plotCount();
+}
+
+/**
+ * Updates the vertical range of the plot with the running extremes of the
+ * plot history when autoscale is enabled.
+ */
+void UI::PlotItem::updateRange()
+{
+  if (!m_autoscale)
+    return;
+
+  // Get extremes of all curves
+  bool valid = false;
+  double min = 0;
+  double max = 0;
+  for (int i = 0; i < curveCount(); ++i)
+  {
+    const auto history = buffer(i);
+    if (!history || history->isEmpty())
+      continue;
+
+    const double hmin = curveValue(i, history->min());
+    const double hmax = curveValue(i, history->max());
+    min = valid ? qMin(min, hmin) : hmin;
+    max = valid ? qMax(max, hmax) : hmax;
+    valid = true;
+  }
+
+  // Add some margin to the range
+  if (!valid)
+  {
+    min = -1;
+    max = 1;
+  }
+  else if (qFuzzyCompare(min, max))
+  {
+    min -= 1;
+    max += 1;
+  }
+  else
+  {
+    const double margin = (max - min) * 0.1;
+    min -= margin;
+    max += margin;
+  }
+
+  // Update range
+  if (!qFuzzyCompare(min, m_minValue) || !qFuzzyCompare(max, m_maxValue))
+  {
+    m_minValue = min;
+    m_maxValue = max;
+    Q_EMIT rangeChanged();
+  }
+}
+
+/**
+ * Maps the given @a value to the vertical axis scale
+ */
+double UI::PlotItem::mapValue(const double value) const
+{
+  if (m_logScale)
+    return log10(qMax(value, 1e-12));
+
+  return value;
+}
+
+/**
+ * Maps the given @a value of the given @a curve to its normalization range,
+ * values of single plots & of datasets without a valid range are returned
+ * as-is.
+ */
+double UI::PlotItem::curveValue(const int curve, const double value) const
+{
+  if (curve < 0 || curve >= m_offsets.count())
+    return value;
+
+  return (value - m_offsets.at(curve)) * m_scales.at(curve);
+}
+
+/**
+ * Returns the plot history of the given @a curve, which is shared with the
+ * other widgets that display the same dataset.
+ */
+const UI::PlotBuffer *UI::PlotItem::buffer(const int curve) const
+{
+  auto dash = &UI::Dashboard::instance();
+  int index = -1;
+  if (m_multiPlot)
+    index = dash->multiPlotHistoryIndex(m_index, curve);
+  else
+    index = dash->plotHistoryIndex(m_index);
+
+  const auto &history = dash->plotHistory();
+  if (index >= 0 && index < history.count())
+    return &history.at(index).recent();
+
+  return Q_NULLPTR;
+}
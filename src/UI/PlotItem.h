@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QColor>
+#include <QVector>
+#include <QQuickItem>
+#include <UI/PlotBuffer.h>
+
+namespace UI
+{
+/**
+ * @brief The PlotItem class
+ *
+ * Qt Quick item that draws a plot (or a multiplot) directly with the scene
+ * graph. The history of each curve is uploaded as a vertex buffer and drawn
+ * as a line strip by the GPU, no QtWidgets or raster painting is involved.
+ *
+ * The item supports the same scaling modes of the QtWidgets-based plots:
+ * - Fixed range, when the dataset defines valid minimum & maximum values
+ * - Logarithmic scale, when the dataset requests it
+ * - Autoscale, using the running extremes of the plot history
+ *
+ * The current vertical range is exposed to QML (@c minValue & @c maxValue) so
+ * that the axis labels can be drawn by the QML interface.
+ */
+class PlotItem : public QQuickItem
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int index
+               READ index
+               WRITE setIndex
+               NOTIFY indexChanged)
+    Q_PROPERTY(bool multiPlot
+               READ multiPlot
+               WRITE setMultiPlot
+               NOTIFY indexChanged)
+    Q_PROPERTY(bool logScale
+               READ logScale
+               NOTIFY indexChanged)
+    Q_PROPERTY(qreal minValue
+               READ minValue
+               NOTIFY rangeChanged)
+    Q_PROPERTY(qreal maxValue
+               READ maxValue
+               NOTIFY rangeChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void indexChanged();
+  void rangeChanged();
+
+public:
+  PlotItem(QQuickItem *parent = 0);
+
+  int index() const;
+  bool multiPlot() const;
+  bool logScale() const;
+  qreal minValue() const;
+  qreal maxValue() const;
+
+public Q_SLOTS:
+  void setIndex(const int index);
+  void setMultiPlot(const bool multiPlot);
+
+protected:
+  QSGNode *updatePaintNode(QSGNode *node, UpdatePaintNodeData *data) override;
+
+private Q_SLOTS:
+  void redraw();
+  void configure();
+  void updateData();
+
+private:
+  int curveCount() const;
+  bool validIndex() const;
+  void updateRange();
+  double mapValue(const double value) const;
+  double curveValue(const int curve, const double value) const;
+  const PlotBuffer *buffer(const int curve) const;
+
+private:
+  int m_index;
+  bool m_logScale;
+  bool m_multiPlot;
+  bool m_autoscale;
+  bool m_normalize;
+  qreal m_minValue;
+  qreal m_maxValue;
+  QVector<QColor> m_colors;
+  QVector<double> m_scales;
+  QVector<double> m_offsets;
+};
+} // namespace UI
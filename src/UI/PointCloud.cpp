@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <QtMath>
+#include <UI/PointCloud.h>
+
+/**
+ * Constructor function, creates an empty cloud that retains up to
+ * @a capacity points.
+ */
+UI::PointCloud::PointCloud(const int capacity)
+  : m_count(0)
+  , m_sequence(0)
+  , m_x(qMax(0, capacity))
+  , m_y(qMax(0, capacity))
+{
+}
+
+/**
+ * Returns the number of points stored in the cloud
+ */
+int UI::PointCloud::count() const
+{
+  return m_count;
+}
+
+/**
+ * Returns the maximum number of points stored in the cloud
+ */
+int UI::PointCloud::capacity() const
+{
+  return m_x.size();
+}
+
+/**
+ * Returns the number of points appended since the cloud was created or
+ * cleared, the point with sequence number @c n is stored at
+ * @c n % capacity() in the ring of a consumer that mirrors the cloud.
+ */
+quint64 UI::PointCloud::sequence() const
+{
+  return m_sequence;
+}
+
+/**
+ * Returns the number of bytes allocated by the coordinate rings
+ */
+qint64 UI::PointCloud::allocatedBytes() const
+{
+  return m_x.allocatedBytes() + m_y.allocatedBytes();
+}
+
+/**
+ * Returns the smallest X coordinate of the stored points
+ */
+double UI::PointCloud::minX() const
+{
+  return m_x.min();
+}
+
+/**
+ * Returns the largest X coordinate of the stored points
+ */
+double UI::PointCloud::maxX() const
+{
+  return m_x.max();
+}
+
+/**
+ * Returns the smallest Y coordinate of the stored points
+ */
+double UI::PointCloud::minY() const
+{
+  return m_y.min();
+}
+
+/**
+ * Returns the largest Y coordinate of the stored points
+ */
+double UI::PointCloud::maxY() const
+{
+  return m_y.max();
+}
+
+/**
+ * Returns the point located at the given logical @a index, where index 0 is
+ * the oldest point of the cloud.
+ *
+ * @warning no bounds checking is performed, @a index must be smaller than
+ *          @c count().
+ */
+QPointF UI::PointCloud::at(const int index) const
+{
+  const int position = m_x.size() - m_count + index;
+  return QPointF(m_x.at(position), m_y.at(position));
+}
+
+/**
+ * Removes all the points of the cloud
+ */
+void UI::PointCloud::clear()
+{
+  m_count = 0;
+  m_sequence = 0;
+  m_x.fill(0);
+  m_y.fill(0);
+}
+
+/**
+ * Changes the maximum number of points stored in the cloud, the stored points
+ * are discarded.
+ */
+void UI::PointCloud::setCapacity(const int capacity)
+{
+  m_x.resize(qMax(0, capacity));
+  m_y.resize(qMax(0, capacity));
+  clear();
+}
+
+/**
+ * Appends the point (@a x, @a y) to the cloud, replacing the oldest point if
+ * the cloud is full. Points with a coordinate that is not a finite number are
+ * ignored.
+ */
+void UI::PointCloud::append(const double x, const double y)
+{
+  if (m_x.isEmpty() || !qIsFinite(x) || !qIsFinite(y))
+    return;
+
+  // The rings are always full, set the unused slots to the first point so
+  // they do not affect the bounding box of the cloud
+  if (m_count == 0)
+  {
+    m_x.fill(x);
+    m_y.fill(y);
+  }
+
+  m_x.append(x);
+  m_y.append(y);
+  m_count = qMin(m_count + 1, m_x.size());
+  ++m_sequence;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QPointF>
+#include <UI/PlotBuffer.h>
+
+namespace UI
+{
+/**
+ * @brief The PointCloud class
+ *
+ * Fixed-capacity history of (x, y) pairs displayed by the XY plot widgets.
+ *
+ * The coordinates are stored in two @c PlotBuffer rings, so appending a point
+ * is an O(1) operation & the bounding box of the cloud (used to autoscale the
+ * plot) is tracked in amortized O(1) time, even for clouds with millions of
+ * points.
+ *
+ * Unlike a @c PlotBuffer, the cloud starts empty: @c count() grows with each
+ * point until the capacity is reached, and the oldest points are evicted from
+ * then on. Consumers use @c sequence() to copy only the points that were
+ * appended since their last read.
+ */
+class PointCloud
+{
+public:
+  explicit PointCloud(const int capacity = 0);
+
+  int count() const;
+  int capacity() const;
+  quint64 sequence() const;
+  qint64 allocatedBytes() const;
+
+  double minX() const;
+  double maxX() const;
+  double minY() const;
+  double maxY() const;
+  QPointF at(const int index) const;
+
+  void clear();
+  void setCapacity(const int capacity);
+  void append(const double x, const double y);
+
+private:
+  int m_count;
+  quint64 m_sequence;
+  PlotBuffer m_x;
+  PlotBuffer m_y;
+};
+} // namespace UI
@@ -0,0 +1,592 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include <QFile>
+#include <QImage>
+#include <QtMath>
+#include <QWidget>
+#include <QGroupBox>
+#include <QJsonObject>
+#include <QGridLayout>
+#include <QMetaEnum>
+#include <QVBoxLayout>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+#include <JSON/Generator.h>
+#include <Misc/Benchmark.h>
+#include <Misc/Utilities.h>
+#include <Misc/TimerEvents.h>
+#include <Project/FrameParser.h>
+#include <UI/DashboardWidget.h>
+#include <UI/RenderBenchmark.h>
+
+/**
+ * Widget types measured by the benchmark, in the order in which they are run
+ */
+static const UI::Dashboard::WidgetType WIDGET_TYPES[] = {
+    UI::Dashboard::WidgetType::Group,
+    UI::Dashboard::WidgetType::MultiPlot,
+    UI::Dashboard::WidgetType::Plot,
+    UI::Dashboard::WidgetType::FFT,
+    UI::Dashboard::WidgetType::Bar,
+    UI::Dashboard::WidgetType::Gauge,
+    UI::Dashboard::WidgetType::Compass,
+    UI::Dashboard::WidgetType::Histogram,
+    UI::Dashboard::WidgetType::Gyroscope,
+    UI::Dashboard::WidgetType::Accelerometer,
+    UI::Dashboard::WidgetType::Statistics,
+    UI::Dashboard::WidgetType::GPS,
+    UI::Dashboard::WidgetType::LED,
+};
+
+/**
+ * Number of widget types measured by the benchmark
+ */
+static const int WIDGET_TYPE_COUNT
+    = sizeof(WIDGET_TYPES) / sizeof(WIDGET_TYPES[0]);
+
+/**
+ * Maximum number of widgets of each type
+ */
+static const int MAX_WIDGETS = 256;
+
+/**
+ * Time (in milliseconds) used to warm up the widgets before measuring
+ */
+static const int WARMUP_TIME = 1000;
+
+/**
+ * Returns the name of the given widget @a type
+ */
+static QString TYPE_NAME(const UI::Dashboard::WidgetType type)
+{
+  const auto metaEnum = QMetaEnum::fromType<UI::Dashboard::WidgetType>();
+  return QString::fromLatin1(metaEnum.valueToKey(static_cast<int>(type)));
+}
+
+/**
+ * Returns a dataset with the given frame @a index & the given @a widget, the
+ * dataset is plotted if @a graph is set, displayed in an FFT plot if @a fft
+ * is set & in the LED panel if @a led is set.
+ */
+static QJsonObject DATASET(const int index, const QString &widget,
+                           const bool graph = false, const bool fft = false,
+                           const bool led = false)
+{
+  QJsonObject dataset;
+  dataset.insert("led", led);
+  dataset.insert("fft", fft);
+  dataset.insert("log", false);
+  dataset.insert("title", QString("Dataset %1").arg(index));
+  dataset.insert("units", "");
+  dataset.insert("graph", graph);
+  dataset.insert("widget", widget);
+  dataset.insert("min", -100);
+  dataset.insert("max", 100);
+  dataset.insert("alarm", 0);
+  dataset.insert("fftSamples", 1024);
+  dataset.insert("index", index);
+  dataset.insert("value", "");
+  return dataset;
+}
+
+/**
+ * Returns a project with @a count widgets of the given @a type. Group widgets
+ * are generated with one group per widget, dataset widgets are placed in a
+ * single group.
+ */
+static QJsonObject PROJECT(const UI::Dashboard::WidgetType type,
+                           const int count)
+{
+  using WidgetType = UI::Dashboard::WidgetType;
+
+  // Select the widget of each group & the widgets of its datasets
+  QString groupWidget;
+  QStringList datasetWidgets;
+  switch (type)
+  {
+    case WidgetType::Group:
+      datasetWidgets = {"", "", "", ""};
+      break;
+    case WidgetType::MultiPlot:
+      groupWidget = "multiplot";
+      datasetWidgets = {"", "", "", ""};
+      break;
+    case WidgetType::Statistics:
+      groupWidget = "stats";
+      datasetWidgets = {"", "", "", ""};
+      break;
+    case WidgetType::Accelerometer:
+      groupWidget = "accelerometer";
+      datasetWidgets = {"x", "y", "z"};
+      break;
+    case WidgetType::Gyroscope:
+      groupWidget = "gyro";
+      datasetWidgets = {"roll", "pitch", "yaw"};
+      break;
+    case WidgetType::GPS:
+      groupWidget = "map";
+      datasetWidgets = {"lat", "lon", "alt"};
+      break;
+    default:
+      break;
+  }
+
+  // Create one group per widget
+  int index = 1;
+  QJsonArray groups;
+  if (!datasetWidgets.isEmpty())
+  {
+    for (int i = 0; i < count; ++i)
+    {
+      QJsonArray datasets;
+      for (const auto &widget : datasetWidgets)
+        datasets.append(DATASET(index++, widget));
+
+      QJsonObject group;
+      group.insert("title", QString("Group %1").arg(i + 1));
+      group.insert("widget", groupWidget);
+      group.insert("datasets", datasets);
+      groups.append(group);
+    }
+  }
+
+  // Create one dataset per widget
+  else
+  {
+    QJsonArray datasets;
+    for (int i = 0; i < count; ++i, ++index)
+    {
+      switch (type)
+      {
+        case WidgetType::Plot:
+          datasets.append(DATASET(index, "", true));
+          break;
+        case WidgetType::FFT:
+          datasets.append(DATASET(index, "", false, true));
+          break;
+        case WidgetType::LED:
+          datasets.append(DATASET(index, "", false, false, true));
+          break;
+        case WidgetType::Bar:
+          datasets.append(DATASET(index, "bar"));
+          break;
+        case WidgetType::Gauge:
+          datasets.append(DATASET(index, "gauge"));
+          break;
+        case WidgetType::Compass:
+          datasets.append(DATASET(index, "compass"));
+          break;
+        case WidgetType::Histogram:
+          datasets.append(DATASET(index, "histogram"));
+          break;
+        default:
+          break;
+      }
+    }
+
+    QJsonObject group;
+    group.insert("title", QStringLiteral("Datasets"));
+    group.insert("widget", "");
+    group.insert("datasets", datasets);
+    groups.append(group);
+  }
+
+  // Create project
+  QJsonObject json;
+  json.insert("title", QString("%1 Benchmark").arg(TYPE_NAME(type)));
+  json.insert("separator", ",");
+  json.insert("frameStart", "/*");
+  json.insert("frameEnd", "*/");
+  json.insert("frameParser", Project::FrameParser::defaultCode());
+  json.insert("groups", groups);
+  return json;
+}
+
+/**
+ * Returns the given @a percentile of the sorted list of @a times, converted
+ * from nanoseconds to milliseconds.
+ */
+static double PERCENTILE(const QVector<qint64> &times, const double percentile)
+{
+  if (times.isEmpty())
+    return 0;
+
+  const int index = qBound(0, qCeil(times.count() * percentile) - 1,
+                           times.count() - 1);
+  return times.at(index) / 1e6;
+}
+
+/**
+ * Constructor function
+ */
+UI::RenderBenchmark::RenderBenchmark(const RenderBenchmarkOptions &options)
+  : m_type(-1)
+  , m_sentFrames(0)
+  , m_startCpuTime(0)
+  , m_measuring(false)
+  , m_options(options)
+{
+  m_options.widgets = qBound(1, m_options.widgets, MAX_WIDGETS);
+  m_options.inputRate = qMax(1, m_options.inputRate);
+  m_options.frameRate = qBound(1, m_options.frameRate, 1000);
+  m_options.duration = qMax(2, m_options.duration);
+  m_options.width = qMax(64, m_options.width);
+  m_options.height = qMax(64, m_options.height);
+
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this,
+          &UI::RenderBenchmark::renderFrame);
+}
+
+/**
+ * Prints the benchmark configuration & starts measuring the first widget
+ * type. Returns @c false if the benchmark cannot be started.
+ */
+bool UI::RenderBenchmark::start()
+{
+  // Print messages to the console
+  Misc::Utilities::setHeadless(true);
+
+  // The project files are written to a temporary directory
+  if (!m_directory.isValid())
+  {
+    qCritical() << "Cannot create temporary benchmark directory";
+    return false;
+  }
+
+  // Widgets are only refreshed by the benchmark
+  Misc::TimerEvents::instance().stopTimers();
+  JSON::Generator::instance().setOperationMode(JSON::Generator::kManual);
+
+  // Print benchmark configuration
+  qInfo().noquote() << QString("Rendering %1 widgets of each type at %2 "
+                               "frames/s, %3 input frames/s, %4x%5 pixels")
+                           .arg(m_options.widgets)
+                           .arg(m_options.frameRate)
+                           .arg(m_options.inputRate)
+                           .arg(m_options.width)
+                           .arg(m_options.height);
+  qInfo().noquote() << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+                           .arg("Widget", -14)
+                           .arg("Count", 6)
+                           .arg("Mean ms", 9)
+                           .arg("P50 ms", 9)
+                           .arg("P95 ms", 9)
+                           .arg("Max ms", 9)
+                           .arg("FPS", 7)
+                           .arg("CPU %", 7);
+
+  QTimer::singleShot(0, this, &UI::RenderBenchmark::nextType);
+  return true;
+}
+
+/**
+ * Loads the project of the next widget type, constructs its widgets & starts
+ * driving them. The benchmark finishes once all widget types are measured.
+ */
+void UI::RenderBenchmark::nextType()
+{
+  // Release the widgets of the previous type
+  m_widgets.clear();
+  m_container.reset();
+  UI::Dashboard::instance().resetData();
+
+  // All widget types have been measured
+  if (++m_type >= WIDGET_TYPE_COUNT)
+  {
+    finish();
+    return;
+  }
+
+  // Load the project & construct the widgets with the first frame
+  const auto name = TYPE_NAME(WIDGET_TYPES[m_type]);
+  m_sentFrames = 0;
+  m_frameTimes.clear();
+  if (!loadProject())
+  {
+    qWarning() << "Cannot load the project of the" << name << "widgets";
+    QTimer::singleShot(0, this, &UI::RenderBenchmark::nextType);
+    return;
+  }
+
+  sendFrames(1);
+  createWidgets();
+  if (m_widgets.isEmpty())
+  {
+    qWarning() << "No" << name << "widgets were constructed";
+    QTimer::singleShot(0, this, &UI::RenderBenchmark::nextType);
+    return;
+  }
+
+  // Start rendering
+  m_measuring = false;
+  m_clock.start();
+  m_timer.start(1000 / m_options.frameRate);
+}
+
+/**
+ * Hands the frames that are due according to the input rate to the
+ * dashboard, then refreshes & paints the widgets. Only the time spent
+ * refreshing & painting the widgets is registered as frame time.
+ */
+void UI::RenderBenchmark::renderFrame()
+{
+  // Start measuring once the warm-up time has elapsed
+  const auto elapsed = m_clock.elapsed();
+  if (!m_measuring && elapsed >= WARMUP_TIME)
+  {
+    m_measuring = true;
+    m_frameTimes.clear();
+    m_measurement.start();
+    m_startCpuTime = Misc::Benchmark::cpuTime();
+  }
+
+  // Send the input frames that are due
+  const auto due = quint64(elapsed) * m_options.inputRate / 1000;
+  if (due > m_sentFrames)
+    sendFrames(static_cast<int>(due - m_sentFrames));
+
+  // Refresh & paint the widgets
+  QElapsedTimer timer;
+  timer.start();
+  UI::Dashboard::instance().updateWidgets();
+  for (auto *widget : m_widgets)
+    widget->repaint();
+
+  QImage image(m_container->size(), QImage::Format_RGB32);
+  m_container->render(&image);
+  if (m_measuring)
+    m_frameTimes.append(timer.nsecsElapsed());
+
+  // Measurement finished
+  if (elapsed >= WARMUP_TIME + m_options.duration * 1000)
+    finishType();
+}
+
+/**
+ * Prints & registers the results of the current widget type, and moves on to
+ * the next widget type.
+ */
+void UI::RenderBenchmark::finishType()
+{
+  // Stop rendering
+  m_timer.stop();
+
+  // Calculate results
+  const auto cpu = Misc::Benchmark::cpuTime() - m_startCpuTime;
+  const double seconds = qMax<qint64>(1, m_measurement.nsecsElapsed()) / 1e9;
+  const double cpuLoad = cpu / (seconds * 1e6) * 100;
+  const double frameRate = m_frameTimes.count() / seconds;
+
+  qint64 total = 0;
+  auto sorted = m_frameTimes;
+  std::sort(sorted.begin(), sorted.end());
+  for (const auto time : sorted)
+    total += time;
+
+  const double mean = sorted.isEmpty() ? 0 : total / 1e6 / sorted.count();
+  const double p50 = PERCENTILE(sorted, 0.5);
+  const double p95 = PERCENTILE(sorted, 0.95);
+  const double max = PERCENTILE(sorted, 1);
+
+  // Print results
+  const auto name = TYPE_NAME(WIDGET_TYPES[m_type]);
+  qInfo().noquote() << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+                           .arg(name, -14)
+                           .arg(m_widgets.count(), 6)
+                           .arg(mean, 9, 'f', 2)
+                           .arg(p50, 9, 'f', 2)
+                           .arg(p95, 9, 'f', 2)
+                           .arg(max, 9, 'f', 2)
+                           .arg(frameRate, 7, 'f', 1)
+                           .arg(cpuLoad, 7, 'f', 1);
+
+  // Register results
+  QJsonObject result;
+  result.insert("widget", name);
+  result.insert("widgets", m_widgets.count());
+  result.insert("frames", m_frameTimes.count());
+  result.insert("inputFrames", double(m_sentFrames));
+  result.insert("meanFrameTime", mean);
+  result.insert("medianFrameTime", p50);
+  result.insert("p95FrameTime", p95);
+  result.insert("maxFrameTime", max);
+  result.insert("frameRate", frameRate);
+  result.insert("cpuLoad", cpuLoad);
+  m_results.append(result);
+
+  // Measure the next widget type
+  QTimer::singleShot(0, this, &UI::RenderBenchmark::nextType);
+}
+
+/**
+ * Prints the peak memory usage, writes the report file (if required) & quits
+ * the application.
+ */
+void UI::RenderBenchmark::finish()
+{
+  // Print peak memory usage
+  const auto memory = Misc::Benchmark::peakMemory();
+  qInfo().noquote() << QString("Peak memory: %1 MB")
+                           .arg(memory / (1024.0 * 1024.0), 0, 'f', 1);
+
+  // Write report file
+  bool ok = true;
+  if (!m_options.report.isEmpty())
+  {
+    QJsonObject options;
+    options.insert("widgets", m_options.widgets);
+    options.insert("inputRate", m_options.inputRate);
+    options.insert("frameRate", m_options.frameRate);
+    options.insert("duration", m_options.duration);
+    options.insert("width", m_options.width);
+    options.insert("height", m_options.height);
+
+    QJsonObject report;
+    report.insert("options", options);
+    report.insert("results", m_results);
+    report.insert("peakMemory", double(memory));
+
+    QFile file(m_options.report);
+    if (file.open(QFile::WriteOnly))
+    {
+      file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+      file.close();
+    }
+
+    else
+    {
+      qWarning() << "Cannot write benchmark report" << m_options.report;
+      ok = false;
+    }
+  }
+
+  // Quit the application
+  QCoreApplication::exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/**
+ * Writes the project of the current widget type & loads it with the JSON
+ * generator, the loaded project is used as template for the input frames.
+ */
+bool UI::RenderBenchmark::loadProject()
+{
+  // Write project file
+  const auto type = WIDGET_TYPES[m_type];
+  QFile file(m_directory.filePath(QString("%1.json").arg(TYPE_NAME(type))));
+  if (!file.open(QFile::WriteOnly))
+    return false;
+
+  const auto json = PROJECT(type, m_options.widgets);
+  file.write(QJsonDocument(json).toJson(QJsonDocument::Indented));
+  file.close();
+
+  // Load project & build the frame template
+  auto &generator = JSON::Generator::instance();
+  generator.loadJsonMap(file.fileName());
+  return m_template.read(generator.json()) && m_template.isValid();
+}
+
+/**
+ * Constructs the widgets of the current widget type in a container with the
+ * size of the rendered images, other widgets of the dashboard (e.g. the data
+ * groups that contain the datasets) are not constructed.
+ */
+void UI::RenderBenchmark::createWidgets()
+{
+  // Create the container, which is never displayed on the screen
+  m_container.reset(new QWidget);
+  m_container->setAttribute(Qt::WA_DontShowOnScreen);
+  m_container->setFixedSize(m_options.width, m_options.height);
+
+  // Count the widgets of the current type
+  auto &dashboard = UI::Dashboard::instance();
+  const auto type = WIDGET_TYPES[m_type];
+  const int count = dashboard.totalWidgetCount();
+  int widgets = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    if (dashboard.widgetType(i) == type)
+      ++widgets;
+  }
+
+  // Create the widgets
+  auto layout = new QGridLayout(m_container.data());
+  const auto titleList = dashboard.widgetTitles();
+  const int columns = qMax(1, qCeil(qSqrt(widgets)));
+  for (int i = 0; i < count; ++i)
+  {
+    if (dashboard.widgetType(i) != type)
+      continue;
+
+    auto widget = UI::DashboardWidget::constructWidget(
+        type, dashboard.relativeIndex(i));
+    if (!widget)
+      continue;
+
+    auto box = new QGroupBox(titleList.value(i));
+    auto boxLayout = new QVBoxLayout(box);
+    boxLayout->addWidget(widget);
+
+    const int cell = m_widgets.count();
+    layout->addWidget(box, cell / columns, cell % columns);
+    m_widgets.append(widget);
+  }
+
+  // Lay out the widgets
+  m_container->show();
+  for (auto *widget : m_widgets)
+    widget->markDirty();
+}
+
+/**
+ * Hands @a count synthetic frames to the dashboard in a single batch, each
+ * dataset follows a sine wave with a different frequency.
+ */
+void UI::RenderBenchmark::sendFrames(const int count)
+{
+  QVector<JSON::Frame> batch;
+  batch.reserve(count);
+  for (int k = 0; k < count; ++k, ++m_sentFrames)
+  {
+    int index = 0;
+    auto frame = m_template;
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const int datasets = frame.getGroup(i).datasetCount();
+      for (int j = 0; j < datasets; ++j, ++index)
+      {
+        const double phase = 2 * M_PI * m_sentFrames * (index % 16 + 1) / 1000;
+        frame.setDatasetValue(i, j, 50 * qSin(phase));
+      }
+    }
+
+    frame.setTimestamp(qint64(m_sentFrames) * 1000000 / m_options.inputRate);
+    batch.append(frame);
+  }
+
+  UI::Dashboard::instance().processFrames(batch);
+}
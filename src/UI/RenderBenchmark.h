@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QTimer>
+#include <QVector>
+#include <QObject>
+#include <QJsonArray>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <JSON/Frame.h>
+#include <UI/Dashboard.h>
+
+class QWidget;
+
+namespace Widgets
+{
+class DashboardWidgetBase;
+}
+
+namespace UI
+{
+struct RenderBenchmarkOptions
+{
+  int widgets = 4;
+  int inputRate = 2000;
+  int frameRate = 60;
+  int duration = 10;
+  int width = 1280;
+  int height = 720;
+  QString report;
+};
+
+/**
+ * @brief The RenderBenchmark class
+ *
+ * Measures the cost of drawing the dashboard, which the data pipeline
+ * benchmark (see @c Misc::Benchmark) does not capture.
+ *
+ * Each widget type is measured separately: a synthetic project with the
+ * requested number of widgets of the type is generated & loaded, and the
+ * widgets are constructed in a container that is never displayed on the
+ * screen (like in @c UI::DashboardExporter). Synthetic frames are handed to
+ * @c UI::Dashboard::processFrames() at the input rate, while the widgets are
+ * refreshed & repainted at the rendering frame rate.
+ *
+ * For each widget type, the benchmark reports the time spent drawing each
+ * dashboard frame (mean, median, 95th percentile & maximum), the frame rate
+ * that was achieved & the CPU load of the process. The first second of each
+ * run is used to warm up the widgets and is not taken into account.
+ *
+ * Widgets that are drawn exclusively by the scene graph (waterfalls, XY plots
+ * & heatmaps) have no offscreen implementation & are not measured.
+ */
+class RenderBenchmark : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit RenderBenchmark(const RenderBenchmarkOptions &options);
+
+  bool start();
+
+private Q_SLOTS:
+  void nextType();
+  void renderFrame();
+
+private:
+  void finish();
+  void finishType();
+  bool loadProject();
+  void createWidgets();
+  void sendFrames(const int count);
+
+private:
+  int m_type;
+  quint64 m_sentFrames;
+  qint64 m_startCpuTime;
+  bool m_measuring;
+
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+  QElapsedTimer m_measurement;
+  QTemporaryDir m_directory;
+  JSON::Frame m_template;
+  QJsonArray m_results;
+  QVector<qint64> m_frameTimes;
+
+  QScopedPointer<QWidget> m_container;
+  QVector<Widgets::DashboardWidgetBase *> m_widgets;
+
+  RenderBenchmarkOptions m_options;
+};
+} // namespace UI
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+#include <QtNumeric>
+#include <UI/Statistics.h>
+
+/**
+ * Removes the sample that left the window from the front of a monotonic
+ * queue & appends the given @a sample to the back of the queue, after
+ * removing the samples that can no longer be the minimum (or the maximum) of
+ * the window.
+ *
+ * @param head    position of the front of the queue of the channel
+ * @param size    number of samples stored in the queue of the channel
+ * @param samples queue storage of the channel (@a window slots)
+ * @param ring    windowed values of the channel, indexed by sample % window
+ * @param minimum @c true to keep the minimum, @c false to keep the maximum
+ */
+static inline void UPDATE_QUEUE(int &head, int &size, quint64 *samples,
+                                const double *ring, const int window,
+                                const quint64 sample, const bool valid,
+                                const bool minimum)
+{
+  // Drop the sample that left the window
+  if (size > 0 && samples[head] + window <= sample)
+  {
+    head = (head + 1) % window;
+    --size;
+  }
+
+  // Invalid samples are not registered
+  if (!valid)
+    return;
+
+  // Drop the samples that are dominated by the new sample
+  const double value = ring[sample % window];
+  while (size > 0)
+  {
+    const auto back = samples[(head + size - 1) % window];
+    const double last = ring[back % window];
+    if (minimum ? last < value : last > value)
+      break;
+
+    --size;
+  }
+
+  // Append the new sample
+  samples[(head + size) % window] = sample;
+  ++size;
+}
+
+/**
+ * Constructor function, sets the number of samples of the sliding window
+ */
+UI::Statistics::Statistics(const int window)
+  : m_window(qMax(1, window))
+  , m_channels(0)
+  , m_samples(0)
+{
+}
+
+/**
+ * Returns the number of samples of the sliding window
+ */
+int UI::Statistics::window() const
+{
+  return m_window;
+}
+
+/**
+ * Returns the number of channels (values per frame) that are tracked
+ */
+int UI::Statistics::channels() const
+{
+  return m_channels;
+}
+
+/**
+ * Returns the number of bytes allocated by the accumulators of each channel
+ * & by the rings that store the samples of the moving window.
+ */
+qint64 UI::Statistics::allocatedBytes() const
+{
+  qint64 doubles = m_mean.capacity() + m_m2.capacity() + m_min.capacity()
+                   + m_max.capacity() + m_ring.capacity()
+                   + m_windowMean.capacity() + m_windowM2.capacity();
+
+  qint64 bytes = doubles * sizeof(double);
+  bytes += qint64(m_count.capacity()) * sizeof(quint64);
+  bytes += qint64(m_windowCount.capacity()) * sizeof(int);
+  bytes += qint64(m_minQueue.samples.capacity()) * sizeof(quint64);
+  bytes += qint64(m_maxQueue.samples.capacity()) * sizeof(quint64);
+  return bytes;
+}
+
+/**
+ * Returns the statistics of the given @a channel since the session started
+ * (or since the statistics were cleared).
+ */
+UI::Statistics::Summary UI::Statistics::session(const int channel) const
+{
+  if (channel < 0 || channel >= m_channels)
+    return summary(0, 0, 0, 0, 0);
+
+  return summary(m_count[channel], m_min[channel], m_max[channel],
+                 m_mean[channel], m_m2[channel]);
+}
+
+/**
+ * Returns the statistics of the latest @c window() samples of the given
+ * @a channel.
+ */
+UI::Statistics::Summary UI::Statistics::windowed(const int channel) const
+{
+  if (channel < 0 || channel >= m_channels)
+    return summary(0, 0, 0, 0, 0);
+
+  // Get the front of the minimum & maximum queues
+  const int base = channel * m_window;
+  const double *ring = m_ring.constData() + base;
+  double min = qQNaN();
+  double max = qQNaN();
+  if (m_minQueue.size[channel] > 0)
+  {
+    const auto sample = m_minQueue.samples[base + m_minQueue.head[channel]];
+    min = ring[sample % m_window];
+  }
+  if (m_maxQueue.size[channel] > 0)
+  {
+    const auto sample = m_maxQueue.samples[base + m_maxQueue.head[channel]];
+    max = ring[sample % m_window];
+  }
+
+  return summary(m_windowCount[channel], min, max, m_windowMean[channel],
+                 m_windowM2[channel]);
+}
+
+/**
+ * Resets the session & windowed statistics of every channel
+ */
+void UI::Statistics::clear()
+{
+  m_count.fill(0, m_channels);
+  m_mean.fill(0, m_channels);
+  m_m2.fill(0, m_channels);
+  m_min.fill(qQNaN(), m_channels);
+  m_max.fill(qQNaN(), m_channels);
+
+  clearWindow();
+}
+
+/**
+ * Changes the number of samples of the sliding window. The windowed
+ * statistics are recomputed from the latest samples that fit in the new
+ * window, the session statistics are kept.
+ */
+void UI::Statistics::setWindow(const int samples)
+{
+  const int window = qMax(1, samples);
+  if (m_window == window)
+    return;
+
+  // Copy the latest samples of the window (as many as fit in the new one)
+  const int stored = static_cast<int>(qMin<quint64>(m_samples, m_window));
+  const int kept = qMin(stored, window);
+  QVector<QVector<double>> latest(kept, QVector<double>(m_channels));
+  for (int i = 0; i < kept; ++i)
+  {
+    const auto sample = m_samples - kept + i;
+    const int slot = static_cast<int>(sample % m_window);
+    for (int c = 0; c < m_channels; ++c)
+      latest[i][c] = m_ring.at(c * m_window + slot);
+  }
+
+  // Resize the window & register the copied samples again, the session
+  // statistics already include them
+  const auto count = m_count;
+  const auto mean = m_mean;
+  const auto m2 = m_m2;
+  const auto min = m_min;
+  const auto max = m_max;
+
+  m_window = window;
+  clearWindow();
+  for (const auto &values : latest)
+    append(values);
+
+  m_count = count;
+  m_mean = mean;
+  m_m2 = m2;
+  m_min = min;
+  m_max = max;
+}
+
+/**
+ * Changes the number of tracked channels & resets all statistics
+ */
+void UI::Statistics::setChannels(const int channels)
+{
+  m_channels = qMax(0, channels);
+  clear();
+}
+
+/**
+ * Registers one sample for each channel. If the number of @a values is
+ * different from the number of tracked channels, the channel count is
+ * changed (and the statistics are reset) first.
+ */
+void UI::Statistics::append(const QVector<double> &values)
+{
+  // Frame structure changed
+  if (values.count() != m_channels)
+    setChannels(values.count());
+
+  // Get position of the new sample in the window
+  const int window = m_window;
+  const quint64 sample = m_samples;
+  const int slot = static_cast<int>(sample % window);
+  const bool full = sample >= static_cast<quint64>(window);
+
+  // Update the statistics of each channel
+  const double *data = values.constData();
+  for (int c = 0; c < m_channels; ++c)
+  {
+    const double x = data[c];
+    const bool valid = qIsFinite(x);
+
+    // Update session statistics
+    if (valid)
+    {
+      const auto n = ++m_count[c];
+      const double delta = x - m_mean[c];
+      m_mean[c] += delta / n;
+      m_m2[c] += delta * (x - m_mean[c]);
+      m_min[c] = n > 1 ? qMin(m_min[c], x) : x;
+      m_max[c] = n > 1 ? qMax(m_max[c], x) : x;
+    }
+
+    // Remove the oldest sample from the window
+    double *ring = m_ring.data() + c * window;
+    auto &count = m_windowCount[c];
+    auto &mean = m_windowMean[c];
+    auto &m2 = m_windowM2[c];
+    if (full && qIsFinite(ring[slot]))
+    {
+      const double old = ring[slot];
+      if (count <= 1)
+      {
+        count = 0;
+        mean = 0;
+        m2 = 0;
+      }
+
+      else
+      {
+        const double previous = mean - (old - mean) / (count - 1);
+        m2 = qMax(0.0, m2 - (old - mean) * (old - previous));
+        mean = previous;
+        --count;
+      }
+    }
+
+    // Add the new sample to the window
+    ring[slot] = x;
+    if (valid)
+    {
+      ++count;
+      const double delta = x - mean;
+      mean += delta / count;
+      m2 += delta * (x - mean);
+    }
+
+    // Update the windowed minimum & maximum
+    const int base = c * window;
+    UPDATE_QUEUE(m_minQueue.head[c], m_minQueue.size[c],
+                 m_minQueue.samples.data() + base, ring, window, sample, valid,
+                 true);
+    UPDATE_QUEUE(m_maxQueue.head[c], m_maxQueue.size[c],
+                 m_maxQueue.samples.data() + base, ring, window, sample, valid,
+                 false);
+  }
+
+  // Advance the window
+  ++m_samples;
+}
+
+/**
+ * Resets the windowed statistics of every channel
+ */
+void UI::Statistics::clearWindow()
+{
+  m_samples = 0;
+  m_ring.fill(qQNaN(), m_channels * m_window);
+  m_windowCount.fill(0, m_channels);
+  m_windowMean.fill(0, m_channels);
+  m_windowM2.fill(0, m_channels);
+
+  Queue *queues[] = {&m_minQueue, &m_maxQueue};
+  for (auto queue : queues)
+  {
+    queue->head.fill(0, m_channels);
+    queue->size.fill(0, m_channels);
+    queue->samples.fill(0, m_channels * m_window);
+  }
+}
+
+/**
+ * Builds a summary from the given sample @a count, extremes, @a mean & sum of
+ * squared differences from the mean (@a m2). The standard deviation is the
+ * sample standard deviation, the RMS value is obtained from the mean square
+ * (@a m2 / @a count + @a mean²).
+ */
+UI::Statistics::Summary UI::Statistics::summary(const quint64 count,
+                                                const double min,
+                                                const double max,
+                                                const double mean,
+                                                const double m2)
+{
+  Summary summary;
+  summary.count = count;
+  if (count == 0)
+  {
+    summary.min = qQNaN();
+    summary.max = qQNaN();
+    summary.mean = qQNaN();
+    summary.stddev = qQNaN();
+    summary.rms = qQNaN();
+    return summary;
+  }
+
+  summary.min = min;
+  summary.max = max;
+  summary.mean = mean;
+  summary.stddev = count > 1 ? qSqrt(m2 / (count - 1)) : 0;
+  summary.rms = qSqrt(mean * mean + m2 / count);
+  return summary;
+}
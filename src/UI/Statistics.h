@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+
+namespace UI
+{
+/**
+ * @brief The Statistics class
+ *
+ * Computes the minimum, maximum, mean, standard deviation & RMS value of each
+ * element (channel) of the numeric value array of the received frames, both
+ * over the whole session & over a sliding window of the latest samples.
+ *
+ * Every statistic is updated incrementally with each frame, the cost of
+ * registering a sample is O(1) regardless of the window size:
+ *
+ * - The mean & the sum of squared differences are updated with Welford's
+ *   algorithm, samples that leave the sliding window are removed by applying
+ *   the same update in reverse.
+ * - Windowed samples are kept in a ring with @c window() slots per channel.
+ * - The windowed minimum & maximum are the front of a monotonic queue of the
+ *   windowed samples (amortized O(1) per sample).
+ *
+ * The RMS value is derived from the mean & the variance, so no running sum of
+ * squares (which loses precision over long sessions) is kept.
+ *
+ * Samples that are not a number are ignored. The state of each channel is
+ * stored in flat arrays, which are traversed sequentially for each frame.
+ */
+class Statistics
+{
+public:
+  struct Summary
+  {
+    quint64 count;
+    double min;
+    double max;
+    double mean;
+    double stddev;
+    double rms;
+  };
+
+  explicit Statistics(const int window = 100);
+
+  int window() const;
+  int channels() const;
+  qint64 allocatedBytes() const;
+  Summary session(const int channel) const;
+  Summary windowed(const int channel) const;
+
+  void clear();
+  void setWindow(const int samples);
+  void setChannels(const int channels);
+  void append(const QVector<double> &values);
+
+private:
+  void clearWindow();
+  static Summary summary(const quint64 count, const double min,
+                         const double max, const double mean,
+                         const double m2);
+
+private:
+  struct Queue
+  {
+    QVector<int> head;
+    QVector<int> size;
+    QVector<quint64> samples;
+  };
+
+  int m_window;
+  int m_channels;
+  quint64 m_samples;
+
+  QVector<quint64> m_count;
+  QVector<double> m_mean;
+  QVector<double> m_m2;
+  QVector<double> m_min;
+  QVector<double> m_max;
+
+  QVector<double> m_ring;
+  QVector<int> m_windowCount;
+  QVector<double> m_windowMean;
+  QVector<double> m_windowM2;
+
+  Queue m_minQueue;
+  Queue m_maxQueue;
+};
+} // namespace UI
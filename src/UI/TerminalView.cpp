@@ -0,0 +1,870 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <climits>
+
+#include <QtMath>
+#include <QPainter>
+#include <QKeyEvent>
+#include <QClipboard>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QFontMetricsF>
+#include <QFontDatabase>
+#include <QGuiApplication>
+
+#include <IO/Console.h>
+#include <UI/TerminalView.h>
+#include <Misc/TimerEvents.h>
+#include <Misc/ThemeManager.h>
+
+/**
+ * Space between the border of the item and the text (in pixels)
+ */
+static const int PADDING = 4;
+
+/**
+ * Number of lines scrolled by each step of the mouse wheel
+ */
+static const int WHEEL_LINES = 3;
+
+/**
+ * Returns the console history
+ */
+static const IO::LineStore &STORE()
+{
+  return IO::Console::instance().lineStore();
+}
+
+/**
+ * Returns the position of the given mouse @a event in item coordinates
+ */
+static QPointF EVENT_POSITION(const QMouseEvent *event)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  return event->position();
+#else
+  return event->localPos();
+#endif
+}
+
+/**
+ * Removes VT-100/ANSI escape sequences from the given @a text
+ */
+static QString STRIP_ESCAPE_CODES(const QString &text)
+{
+  // Nothing to remove
+  const QChar escape(0x1b);
+  if (!text.contains(escape))
+    return text;
+
+  // Copy every character that is not part of an escape sequence
+  QString result;
+  const int length = text.length();
+  result.reserve(length);
+  for (int i = 0; i < length; ++i)
+  {
+    // Regular character
+    if (text.at(i) != escape)
+    {
+      result.append(text.at(i));
+      continue;
+    }
+
+    // Control sequence, skip parameters until the final byte
+    if (i + 1 < length && text.at(i + 1) == QLatin1Char('['))
+    {
+      i += 2;
+      while (i < length
+             && (text.at(i).unicode() < 0x40 || text.at(i).unicode() > 0x7e))
+        ++i;
+    }
+
+    // Two-character escape sequence
+    else
+      ++i;
+  }
+
+  return result;
+}
+
+/**
+ * Constructor function
+ */
+UI::TerminalView::TerminalView(QQuickItem *parent)
+  : QQuickPaintedItem(parent)
+  , m_dirty(true)
+  , m_selecting(false)
+  , m_autoscroll(true)
+  , m_emulateVt100(false)
+  , m_widgetEnabled(true)
+  , m_searchFound(false)
+  , m_firstLine(0)
+  , m_ascent(0)
+  , m_charWidth(0)
+  , m_lineHeight(0)
+{
+  // Configure item
+  setOpaquePainting(true);
+  setAcceptedMouseButtons(Qt::LeftButton);
+
+  // Use the system monospace font by default
+  m_font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+  updateMetrics();
+
+  // Process console changes at the render rate
+  // clang-format off
+    connect(&IO::Console::instance(), &IO::Console::dataReceived,
+            this, &UI::TerminalView::onConsoleChanged);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeoutRender,
+            this, &UI::TerminalView::processChanges);
+    connect(&Misc::ThemeManager::instance(), &Misc::ThemeManager::themeChanged,
+            this, [=] { update(); });
+  // clang-format on
+
+  // Update the visible lines when the item is resized or shown
+  connect(this, &QQuickItem::heightChanged, this,
+          &UI::TerminalView::onConsoleChanged);
+  connect(this, &QQuickItem::visibleChanged, this,
+          &UI::TerminalView::onConsoleChanged);
+}
+
+/**
+ * Returns the font used to draw the text
+ */
+QFont UI::TerminalView::font() const
+{
+  return m_font;
+}
+
+/**
+ * Returns @c true if the view shall scroll automatically to the bottom when
+ * new text is received.
+ */
+bool UI::TerminalView::autoscroll() const
+{
+  return m_autoscroll;
+}
+
+/**
+ * Returns @c true if VT-100/ANSI escape sequences are removed from the
+ * displayed text.
+ */
+bool UI::TerminalView::vt100emulation() const
+{
+  return m_emulateVt100;
+}
+
+/**
+ * Returns @c true if the view reacts to changes in the console history, the
+ * dashboard disables the view when the console is hidden.
+ */
+bool UI::TerminalView::widgetEnabled() const
+{
+  return m_widgetEnabled;
+}
+
+/**
+ * Returns the text that is displayed when the console history is empty
+ */
+QString UI::TerminalView::placeholderText() const
+{
+  return m_placeholderText;
+}
+
+/**
+ * Returns the index of the first visible line, relative to the oldest line
+ * stored in the console history.
+ */
+int UI::TerminalView::firstLine() const
+{
+  return static_cast<int>(m_firstLine - STORE().firstLine());
+}
+
+/**
+ * Returns the number of lines stored in the console history, including the
+ * line that is still being received.
+ */
+int UI::TerminalView::lineCount() const
+{
+  if (STORE().isEmpty())
+    return 0;
+
+  return static_cast<int>(STORE().lineCount() + 1);
+}
+
+/**
+ * Returns the number of lines that fit completely in the item
+ */
+int UI::TerminalView::visibleLines() const
+{
+  if (m_lineHeight <= 0)
+    return 0;
+
+  return qMax(0, qFloor((height() - 2 * PADDING) / m_lineHeight));
+}
+
+/**
+ * Returns @c true if the console history is empty
+ */
+bool UI::TerminalView::empty() const
+{
+  return STORE().isEmpty();
+}
+
+/**
+ * Returns @c true if the user has selected any text
+ */
+bool UI::TerminalView::copyAvailable() const
+{
+  return hasSelection();
+}
+
+/**
+ * Returns the selected text, lines are separated with @c \n
+ */
+QString UI::TerminalView::selectedText() const
+{
+  // Nothing selected
+  if (!hasSelection())
+    return QString();
+
+  // Get selection range
+  Cursor start, end;
+  selectionBounds(&start, &end);
+
+  // Join the selected part of each line
+  QString text;
+  for (auto line = start.line; line <= end.line; ++line)
+  {
+    const auto str = displayLine(line);
+    const int from = (line == start.line) ? start.column : 0;
+    const int to = (line == end.line) ? end.column : str.length();
+    text.append(str.mid(from, to - from));
+
+    if (line != end.line)
+      text.append(QLatin1Char('\n'));
+  }
+
+  return text;
+}
+
+/**
+ * Returns @c true if the search text was found in the console history
+ */
+bool UI::TerminalView::searchFound() const
+{
+  return m_searchFound;
+}
+
+/**
+ * Returns the text that is searched with @c findNext() & @c findPrevious(),
+ * the search is not case sensitive.
+ */
+QString UI::TerminalView::searchText() const
+{
+  return m_searchText;
+}
+
+/**
+ * Draws the lines that fit in the item, starting at the first visible line
+ */
+void UI::TerminalView::paint(QPainter *painter)
+{
+  // Draw background
+  auto theme = &Misc::ThemeManager::instance();
+  painter->fillRect(boundingRect(), theme->consoleBase());
+  painter->setFont(m_font);
+
+  // Show placeholder text if there is nothing to display
+  if (empty())
+  {
+    const auto rect
+        = boundingRect().adjusted(PADDING, PADDING, -PADDING, -PADDING);
+    painter->setPen(theme->consolePlaceholderText());
+    painter->drawText(rect, Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap,
+                      m_placeholderText);
+    return;
+  }
+
+  // Get selection range
+  Cursor start, end;
+  const bool selection = hasSelection();
+  if (selection)
+    selectionBounds(&start, &end);
+
+  // Get number of rows & columns that are (at least partially) visible
+  const auto last = lastLine();
+  const int rows = visibleLines() + 1;
+  const int columns = qCeil(width() / qMax<qreal>(1, m_charWidth)) + 1;
+
+  // Draw each visible line
+  for (int row = 0; row < rows && m_firstLine + row <= last; ++row)
+  {
+    const auto line = m_firstLine + row;
+    const auto text = displayLine(line).left(columns);
+    const qreal y = PADDING + row * m_lineHeight;
+
+    // Highlight the matches of the search text
+    if (!m_searchText.isEmpty())
+    {
+      auto color = theme->consoleHighlight();
+      color.setAlpha(96);
+      const int length = m_searchText.length();
+      auto i = text.indexOf(m_searchText, 0, Qt::CaseInsensitive);
+      while (i >= 0)
+      {
+        painter->fillRect(QRectF(PADDING + i * m_charWidth, y,
+                                 length * m_charWidth, m_lineHeight),
+                          color);
+        i = text.indexOf(m_searchText, i + length, Qt::CaseInsensitive);
+      }
+    }
+
+    // Draw the text of the line
+    painter->setPen(theme->consoleText());
+    painter->drawText(QPointF(PADDING, y + m_ascent), text);
+
+    // Line is not selected
+    if (!selection || line < start.line || line > end.line)
+      continue;
+
+    // Get selected columns (including the line break of inner lines)
+    const int from = (line == start.line) ? start.column : 0;
+    const int to = (line == end.line) ? end.column : text.length() + 1;
+    if (to <= from || from > columns)
+      continue;
+
+    // Draw the selected text over the highlight color
+    const QRectF rect(PADDING + from * m_charWidth, y,
+                      (to - from) * m_charWidth, m_lineHeight);
+    painter->fillRect(rect, theme->consoleHighlight());
+    painter->setPen(theme->consoleHighlightedText());
+    painter->drawText(QPointF(rect.left(), y + m_ascent),
+                      text.mid(from, to - from));
+  }
+}
+
+/**
+ * Copies the selected text to the clipboard
+ */
+void UI::TerminalView::copy()
+{
+  if (hasSelection())
+    QGuiApplication::clipboard()->setText(selectedText());
+}
+
+/**
+ * Clears the selection and resets the view, the console history itself is
+ * cleared through @c IO::Console::clear().
+ */
+void UI::TerminalView::clear()
+{
+  m_match = Cursor();
+  if (m_searchFound)
+  {
+    m_searchFound = false;
+    Q_EMIT searchFoundChanged();
+  }
+
+  clearSelection();
+  onConsoleChanged();
+}
+
+/**
+ * Selects the next match of the search text, wrapping around to the start of
+ * the history if needed
+ */
+void UI::TerminalView::findNext()
+{
+  search(false, false);
+}
+
+/**
+ * Selects the previous match of the search text, wrapping around to the end
+ * of the history if needed
+ */
+void UI::TerminalView::findPrevious()
+{
+  search(true, false);
+}
+
+/**
+ * Selects the complete console history
+ */
+void UI::TerminalView::selectAll()
+{
+  if (empty())
+    return;
+
+  m_selecting = false;
+  m_anchor.line = STORE().firstLine();
+  m_anchor.column = 0;
+  m_cursor.line = lastLine();
+  m_cursor.column = displayLine(m_cursor.line).length();
+
+  update();
+  Q_EMIT selectionChanged();
+}
+
+/**
+ * Removes the text selection
+ */
+void UI::TerminalView::clearSelection()
+{
+  m_selecting = false;
+  m_anchor = Cursor();
+  m_cursor = Cursor();
+
+  update();
+  Q_EMIT selectionChanged();
+}
+
+/**
+ * Scrolls the view so that the last line is visible
+ */
+void UI::TerminalView::scrollToBottom()
+{
+  setFirstLine(lineCount());
+}
+
+/**
+ * Scrolls the view so that the given @a line (relative to the oldest stored
+ * line) is the first visible line. Only the scroll position is changed, the
+ * cost of this operation does not depend on the size of the history.
+ */
+void UI::TerminalView::setFirstLine(const int line)
+{
+  const int max = qMax(0, lineCount() - visibleLines());
+  const auto first = STORE().firstLine() + qBound(0, line, max);
+  if (first != m_firstLine)
+  {
+    m_firstLine = first;
+    update();
+
+    Q_EMIT linesChanged();
+  }
+}
+
+/**
+ * Changes the font used to draw the text. The view assumes that the font is
+ * monospaced to map mouse positions to columns.
+ */
+void UI::TerminalView::setFont(const QFont &font)
+{
+  m_font = font;
+  updateMetrics();
+
+  Q_EMIT fontChanged();
+}
+
+/**
+ * Enables/disables automatic scrolling to the last line when new text is
+ * received.
+ */
+void UI::TerminalView::setAutoscroll(const bool enabled)
+{
+  // Change internal variables
+  m_autoscroll = enabled;
+  if (enabled)
+    scrollToBottom();
+
+  // Update console configuration
+  IO::Console::instance().setAutoscroll(enabled);
+  Q_EMIT autoscrollChanged();
+}
+
+/**
+ * Enables/disables processing of console changes, changes received while the
+ * view is disabled are processed when it is enabled again.
+ */
+void UI::TerminalView::setWidgetEnabled(const bool enabled)
+{
+  m_widgetEnabled = enabled;
+  onConsoleChanged();
+
+  Q_EMIT widgetEnabledChanged();
+}
+
+/**
+ * Enables/disables removal of VT-100/ANSI escape sequences from the displayed
+ * text.
+ */
+void UI::TerminalView::setVt100Emulation(const bool enabled)
+{
+  m_emulateVt100 = enabled;
+  update();
+
+  Q_EMIT vt100EmulationChanged();
+}
+
+/**
+ * Changes the text that is displayed when the console history is empty
+ */
+void UI::TerminalView::setPlaceholderText(const QString &text)
+{
+  m_placeholderText = text;
+  update();
+
+  Q_EMIT placeholderTextChanged();
+}
+
+/**
+ * Changes the search text & selects its first match, starting at the current
+ * match so that the selection grows as the user types.
+ */
+void UI::TerminalView::setSearchText(const QString &text)
+{
+  if (m_searchText != text)
+  {
+    m_searchText = text;
+    Q_EMIT searchTextChanged();
+
+    search(false, true);
+  }
+}
+
+/**
+ * Handles keyboard shortcuts for copying, selecting & scrolling
+ */
+void UI::TerminalView::keyPressEvent(QKeyEvent *event)
+{
+  if (event->matches(QKeySequence::Copy))
+    copy();
+  else if (event->matches(QKeySequence::SelectAll))
+    selectAll();
+  else if (event->key() == Qt::Key_PageUp)
+    setFirstLine(firstLine() - visibleLines());
+  else if (event->key() == Qt::Key_PageDown)
+    setFirstLine(firstLine() + visibleLines());
+  else if (event->key() == Qt::Key_Home)
+    setFirstLine(0);
+  else if (event->key() == Qt::Key_End)
+    scrollToBottom();
+  else
+  {
+    event->ignore();
+    return;
+  }
+
+  event->accept();
+}
+
+/**
+ * Scrolls the view with the mouse wheel
+ */
+void UI::TerminalView::wheelEvent(QWheelEvent *event)
+{
+  // Get number of lines to scroll (at least one for small deltas)
+  const int delta = event->angleDelta().y();
+  int lines = delta * WHEEL_LINES / 120;
+  if (lines == 0 && delta != 0)
+    lines = delta > 0 ? 1 : -1;
+
+  // Scroll the view
+  setFirstLine(firstLine() - lines);
+  event->accept();
+}
+
+/**
+ * Extends the selection while the user drags the mouse, the view is scrolled
+ * when the mouse is above or below the item.
+ */
+void UI::TerminalView::mouseMoveEvent(QMouseEvent *event)
+{
+  // User is not selecting text
+  if (!m_selecting)
+  {
+    event->ignore();
+    return;
+  }
+
+  // Scroll the view if needed
+  const auto pos = EVENT_POSITION(event);
+  if (pos.y() < 0)
+    setFirstLine(firstLine() - 1);
+  else if (pos.y() > height())
+    setFirstLine(firstLine() + 1);
+
+  // Update selection
+  m_cursor = cursorAt(pos);
+  update();
+
+  Q_EMIT selectionChanged();
+  event->accept();
+}
+
+/**
+ * Starts a new selection at the mouse position
+ */
+void UI::TerminalView::mousePressEvent(QMouseEvent *event)
+{
+  forceActiveFocus();
+
+  m_selecting = true;
+  m_anchor = cursorAt(EVENT_POSITION(event));
+  m_cursor = m_anchor;
+  update();
+
+  Q_EMIT selectionChanged();
+  event->accept();
+}
+
+/**
+ * Finishes the current selection, pending changes (e.g. autoscroll) are
+ * processed in the next render tick.
+ */
+void UI::TerminalView::mouseReleaseEvent(QMouseEvent *event)
+{
+  m_selecting = false;
+  onConsoleChanged();
+  event->accept();
+}
+
+/**
+ * Selects the line under the mouse
+ */
+void UI::TerminalView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+  m_selecting = false;
+  m_anchor = cursorAt(EVENT_POSITION(event));
+  m_anchor.column = 0;
+  m_cursor.line = m_anchor.line;
+  m_cursor.column = displayLine(m_cursor.line).length();
+  update();
+
+  Q_EMIT selectionChanged();
+  event->accept();
+}
+
+/**
+ * Applies the changes of the console history since the last call: the scroll
+ * position is kept inside the stored history (or moved to the bottom if
+ * autoscroll is enabled) and the item is repainted.
+ *
+ * Nothing is done while the view is hidden or disabled, the changes are
+ * processed once it becomes visible again.
+ */
+void UI::TerminalView::processChanges()
+{
+  // Nothing to do, or the view is not visible
+  if (!m_dirty || !m_widgetEnabled || !isVisible())
+    return;
+
+  // Reset selection if the history was cleared
+  m_dirty = false;
+  const auto &store = STORE();
+  if (hasSelection()
+      && (store.isEmpty() || qMax(m_anchor.line, m_cursor.line) > lastLine()))
+  {
+    m_selecting = false;
+    m_anchor = Cursor();
+    m_cursor = Cursor();
+    Q_EMIT selectionChanged();
+  }
+
+  // Keep the first visible line inside the stored history
+  const auto bottom = qMax(store.firstLine(), lastLine() + 1 - visibleLines());
+  if (m_autoscroll && !m_selecting)
+    m_firstLine = bottom;
+  else
+    m_firstLine = qBound(store.firstLine(), m_firstLine, bottom);
+
+  // Update user interface
+  update();
+  Q_EMIT linesChanged();
+}
+
+/**
+ * Calculates the size of each character cell for the current font
+ */
+void UI::TerminalView::updateMetrics()
+{
+  const QFontMetricsF metrics(m_font);
+  m_ascent = metrics.ascent();
+  m_lineHeight = metrics.lineSpacing();
+  m_charWidth = metrics.horizontalAdvance(QLatin1Char('M'));
+
+  onConsoleChanged();
+  update();
+}
+
+/**
+ * Marks the view as outdated, the changes are processed in the next render
+ * tick to avoid doing any work for every received chunk of data. While the
+ * application is idle there are no render ticks, so the changes (e.g. after
+ * clearing the console) are processed immediately.
+ */
+void UI::TerminalView::onConsoleChanged()
+{
+  m_dirty = true;
+  if (Misc::TimerEvents::instance().idle())
+    processChanges();
+}
+
+/**
+ * Returns the absolute index of the last line of the console history
+ */
+qint64 UI::TerminalView::lastLine() const
+{
+  return STORE().firstLine() + STORE().lineCount();
+}
+
+/**
+ * Returns @c true if the selection contains at least one character
+ */
+bool UI::TerminalView::hasSelection() const
+{
+  return m_anchor.line != m_cursor.line || m_anchor.column != m_cursor.column;
+}
+
+/**
+ * Searches for the search text in the given direction, starting at the
+ * current match (or at the visible lines if there is no match). If
+ * @a inclusive is set, the current match itself can be selected again.
+ *
+ * The match is selected & the view is scrolled so that it is visible,
+ * autoscroll is disabled so that new data does not move the view away.
+ */
+void UI::TerminalView::search(const bool backward, const bool inclusive)
+{
+  bool found = false;
+  const auto &store = STORE();
+  if (!m_searchText.isEmpty() && !empty())
+  {
+    // Start at the current match, or at the visible lines
+    qint64 line = m_firstLine;
+    int column = 0;
+    if (m_searchFound && m_match.line >= store.firstLine())
+    {
+      line = m_match.line;
+      column = m_match.column + ((backward || inclusive) ? 0 : 1);
+    }
+    else if (backward)
+    {
+      line = qMin(lastLine(), m_firstLine + visibleLines());
+      column = INT_MAX;
+    }
+
+    // Search, wrapping around the ends of the history
+    found = store.find(m_searchText, &line, &column, backward);
+    if (!found)
+    {
+      line = backward ? lastLine() : store.firstLine();
+      column = backward ? INT_MAX : 0;
+      found = store.find(m_searchText, &line, &column, backward);
+    }
+
+    // Select the match
+    if (found)
+    {
+      m_match.line = line;
+      m_match.column = column;
+      m_selecting = false;
+      m_anchor.line = line;
+      m_anchor.column = displayColumn(line, column);
+      m_cursor.line = line;
+      m_cursor.column = displayColumn(line, column + m_searchText.length());
+      Q_EMIT selectionChanged();
+
+      // Scroll to the match
+      if (m_autoscroll)
+        setAutoscroll(false);
+      if (line < m_firstLine || line >= m_firstLine + visibleLines())
+        setFirstLine(static_cast<int>(line - store.firstLine())
+                     - visibleLines() / 2);
+    }
+  }
+
+  // Update search status
+  if (m_searchFound != found)
+  {
+    m_searchFound = found;
+    Q_EMIT searchFoundChanged();
+  }
+
+  update();
+}
+
+/**
+ * Converts the given @a column of the stored text of the given absolute
+ * @a line to the column in which it is displayed.
+ */
+int UI::TerminalView::displayColumn(const qint64 line, const int column) const
+{
+  const auto text = STORE().line(line - STORE().firstLine()).left(column);
+  if (m_emulateVt100)
+    return STRIP_ESCAPE_CODES(text).length();
+
+  return text.length();
+}
+
+/**
+ * Returns the text of the given absolute @a line, as it is displayed
+ */
+QString UI::TerminalView::displayLine(const qint64 line) const
+{
+  const auto text = STORE().line(line - STORE().firstLine());
+  if (m_emulateVt100)
+    return STRIP_ESCAPE_CODES(text);
+
+  return text;
+}
+
+/**
+ * Returns the line & column under the given @a point (in item coordinates)
+ */
+UI::TerminalView::Cursor UI::TerminalView::cursorAt(const QPointF &point) const
+{
+  Cursor cursor;
+  if (m_lineHeight <= 0 || m_charWidth <= 0)
+    return cursor;
+
+  const auto row = qFloor((point.y() - PADDING) / m_lineHeight);
+  cursor.line = qBound(STORE().firstLine(), m_firstLine + row, lastLine());
+
+  const auto column = qRound((point.x() - PADDING) / m_charWidth);
+  const auto length = static_cast<int>(displayLine(cursor.line).length());
+  cursor.column = qBound(0, column, length);
+  return cursor;
+}
+
+/**
+ * Obtains the @a start & @a end of the selection in document order, lines
+ * that have been evicted from the history are excluded.
+ */
+void UI::TerminalView::selectionBounds(Cursor *start, Cursor *end) const
+{
+  // Sort the anchor & the cursor
+  const bool sameLine = m_anchor.line == m_cursor.line;
+  const bool forward = m_anchor.line < m_cursor.line
+                       || (sameLine && m_anchor.column <= m_cursor.column);
+  *start = forward ? m_anchor : m_cursor;
+  *end = forward ? m_cursor : m_anchor;
+
+  // Skip evicted lines
+  if (start->line < STORE().firstLine())
+  {
+    start->line = STORE().firstLine();
+    start->column = 0;
+  }
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QFont>
+#include <QQuickPaintedItem>
+
+namespace UI
+{
+/**
+ * @brief The TerminalView class
+ *
+ * Virtualized view of the console history. Instead of copying the received
+ * text into a text document, the item reads the lines that fit in its area
+ * directly from the bounded line store of the @c IO::Console and paints them
+ * with a monospaced font.
+ *
+ * The scroll position is the absolute index of the first visible line, so
+ * scrolling is a constant time operation and the cost of a repaint only
+ * depends on the size of the item, not on the size of the history. Text
+ * selections are tracked as (line, column) pairs, which keeps them valid while
+ * new text is appended.
+ *
+ * Changes in the console are coalesced and processed at most once per render
+ * timer tick, and only while the item is visible.
+ *
+ * The history can be searched with @c findNext() & @c findPrevious(), which
+ * use the trigram index of the line store (see @c IO::LineStore::find()), so
+ * jumping to a match does not depend on the size of the history either. The
+ * current match is selected & the other matches of the visible lines are
+ * highlighted.
+ */
+class TerminalView : public QQuickPaintedItem
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(QFont font
+               READ font
+               WRITE setFont
+               NOTIFY fontChanged)
+    Q_PROPERTY(bool autoscroll
+               READ autoscroll
+               WRITE setAutoscroll
+               NOTIFY autoscrollChanged)
+    Q_PROPERTY(bool vt100emulation
+               READ vt100emulation
+               WRITE setVt100Emulation
+               NOTIFY vt100EmulationChanged)
+    Q_PROPERTY(bool widgetEnabled
+               READ widgetEnabled
+               WRITE setWidgetEnabled
+               NOTIFY widgetEnabledChanged)
+    Q_PROPERTY(QString placeholderText
+               READ placeholderText
+               WRITE setPlaceholderText
+               NOTIFY placeholderTextChanged)
+    Q_PROPERTY(int firstLine
+               READ firstLine
+               WRITE setFirstLine
+               NOTIFY linesChanged)
+    Q_PROPERTY(int lineCount
+               READ lineCount
+               NOTIFY linesChanged)
+    Q_PROPERTY(int visibleLines
+               READ visibleLines
+               NOTIFY linesChanged)
+    Q_PROPERTY(bool empty
+               READ empty
+               NOTIFY linesChanged)
+    Q_PROPERTY(bool copyAvailable
+               READ copyAvailable
+               NOTIFY selectionChanged)
+    Q_PROPERTY(QString searchText
+               READ searchText
+               WRITE setSearchText
+               NOTIFY searchTextChanged)
+    Q_PROPERTY(bool searchFound
+               READ searchFound
+               NOTIFY searchFoundChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void fontChanged();
+  void linesChanged();
+  void selectionChanged();
+  void searchTextChanged();
+  void searchFoundChanged();
+  void autoscrollChanged();
+  void widgetEnabledChanged();
+  void vt100EmulationChanged();
+  void placeholderTextChanged();
+
+public:
+  TerminalView(QQuickItem *parent = 0);
+
+  QFont font() const;
+  bool autoscroll() const;
+  bool vt100emulation() const;
+  bool widgetEnabled() const;
+  QString placeholderText() const;
+
+  int firstLine() const;
+  int lineCount() const;
+  int visibleLines() const;
+
+  bool empty() const;
+  bool copyAvailable() const;
+  QString selectedText() const;
+
+  bool searchFound() const;
+  QString searchText() const;
+
+  void paint(QPainter *painter) override;
+
+public Q_SLOTS:
+  void copy();
+  void clear();
+  void findNext();
+  void findPrevious();
+  void selectAll();
+  void clearSelection();
+  void scrollToBottom();
+  void setFirstLine(const int line);
+  void setFont(const QFont &font);
+  void setAutoscroll(const bool enabled);
+  void setWidgetEnabled(const bool enabled);
+  void setVt100Emulation(const bool enabled);
+  void setPlaceholderText(const QString &text);
+  void setSearchText(const QString &text);
+
+protected:
+  void keyPressEvent(QKeyEvent *event) override;
+  void wheelEvent(QWheelEvent *event) override;
+  void mouseMoveEvent(QMouseEvent *event) override;
+  void mousePressEvent(QMouseEvent *event) override;
+  void mouseReleaseEvent(QMouseEvent *event) override;
+  void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private Q_SLOTS:
+  void processChanges();
+  void updateMetrics();
+  void onConsoleChanged();
+
+private:
+  /**
+   * Position in the console history, the line is an absolute line index
+   * (see @c IO::LineStore::firstLine()).
+   */
+  struct Cursor
+  {
+    qint64 line = 0;
+    int column = 0;
+  };
+
+  qint64 lastLine() const;
+  bool hasSelection() const;
+  void search(const bool backward, const bool inclusive);
+  int displayColumn(const qint64 line, const int column) const;
+  QString displayLine(const qint64 line) const;
+  Cursor cursorAt(const QPointF &point) const;
+  void selectionBounds(Cursor *start, Cursor *end) const;
+
+private:
+  bool m_dirty;
+  bool m_selecting;
+  bool m_autoscroll;
+  bool m_emulateVt100;
+  bool m_widgetEnabled;
+  bool m_searchFound;
+
+  qint64 m_firstLine;
+  Cursor m_anchor;
+  Cursor m_cursor;
+  Cursor m_match;
+
+  QFont m_font;
+  qreal m_ascent;
+  qreal m_charWidth;
+  qreal m_lineHeight;
+  QString m_searchText;
+  QString m_placeholderText;
+};
+} // namespace UI
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Misc/Tracer.h>
+#include <UI/Dashboard.h>
+#include <UI/ValueModel.h>
+
+/**
+ * Constructor function, updates the model when the dashboard widgets are
+ * updated & removes every row when the dashboard data is reset.
+ */
+UI::ValueModel::ValueModel()
+  : m_revision(0)
+  , m_schemaHash(0)
+{
+  auto dash = &UI::Dashboard::instance();
+  connect(dash, &UI::Dashboard::updated, this, &UI::ValueModel::updateValues);
+  connect(dash, &UI::Dashboard::dataReset, this, &UI::ValueModel::clear);
+}
+
+/**
+ * Returns the only instance of the class
+ */
+UI::ValueModel &UI::ValueModel::instance()
+{
+  static ValueModel singleton;
+  return singleton;
+}
+
+/**
+ * Returns the number of datasets of the frame displayed by the dashboard
+ */
+int UI::ValueModel::rowCount(const QModelIndex &parent) const
+{
+  if (parent.isValid())
+    return 0;
+
+  return m_rows.count();
+}
+
+/**
+ * Returns the group title, title, units, displayed value, numeric value or
+ * frame index of the dataset at the given model @a index, depending on the
+ * given @a role. Numeric values are displayed with the precision selected
+ * by the user.
+ */
+QVariant UI::ValueModel::data(const QModelIndex &index, int role) const
+{
+  if (!index.isValid() || index.row() >= m_rows.count())
+    return QVariant();
+
+  const auto &row = m_rows.at(index.row());
+  const auto &frame = UI::Dashboard::instance().currentFrame();
+  if (row.group >= frame.groupCount())
+    return QVariant();
+
+  const auto &group = frame.getGroup(row.group);
+  if (row.dataset >= group.datasetCount())
+    return QVariant();
+
+  const auto &dataset = group.getDataset(row.dataset);
+  switch (role)
+  {
+    case GroupRole:
+      return group.title();
+    case TitleRole:
+      return dataset.title();
+    case UnitsRole:
+      return dataset.units();
+    case Qt::DisplayRole:
+    case ValueRole:
+      if (dataset.isNumeric())
+        return QString::number(dataset.numericValue(), 'f',
+                               UI::Dashboard::instance().precision());
+      return dataset.value();
+    case NumericValueRole:
+      return dataset.numericValue();
+    case DatasetIndexRole:
+      return dataset.index();
+    default:
+      return QVariant();
+  }
+}
+
+/**
+ * Returns the names of the roles used by the QML delegates
+ */
+QHash<int, QByteArray> UI::ValueModel::roleNames() const
+{
+  QHash<int, QByteArray> names;
+  names.insert(GroupRole, "group");
+  names.insert(TitleRole, "title");
+  names.insert(UnitsRole, "units");
+  names.insert(ValueRole, "value");
+  names.insert(NumericValueRole, "numericValue");
+  names.insert(DatasetIndexRole, "datasetIndex");
+  return names;
+}
+
+/**
+ * Returns the row of the dataset with the given frame index (as defined in
+ * the project file), or -1 if the dataset is not displayed.
+ */
+int UI::ValueModel::find(const int datasetIndex) const
+{
+  const auto &frame = UI::Dashboard::instance().currentFrame();
+  for (int i = 0; i < m_rows.count(); ++i)
+  {
+    const auto &row = m_rows.at(i);
+    if (row.group < frame.groupCount()
+        && row.dataset < frame.getGroup(row.group).datasetCount()
+        && frame.getGroup(row.group).getDataset(row.dataset).index()
+               == datasetIndex)
+      return i;
+  }
+
+  return -1;
+}
+
+/**
+ * Removes every row of the model
+ */
+void UI::ValueModel::clear()
+{
+  if (m_rows.isEmpty())
+    return;
+
+  beginResetModel();
+  m_rows.clear();
+  m_revision = 0;
+  m_schemaHash = 0;
+  endResetModel();
+}
+
+/**
+ * Notifies the view about the datasets whose displayed value changed during
+ * the last update of the dashboard, consecutive rows are notified with a
+ * single @c dataChanged() signal.
+ *
+ * If the structure of the displayed frame changed, the rows are rebuilt &
+ * the view is reset instead.
+ */
+void UI::ValueModel::updateValues()
+{
+  TRACE_SCOPE("UI::ValueModel::updateValues");
+
+  // Nothing new since the last update (e.g. the view is paused)
+  auto dash = &UI::Dashboard::instance();
+  const auto revision = dash->currentRevision();
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
+  // Frame structure changed, rebuild the rows
+  const auto &frame = dash->currentFrame();
+  if (frame.schemaHash() != m_schemaHash)
+  {
+    beginResetModel();
+    m_rows.clear();
+    m_schemaHash = frame.schemaHash();
+    for (int i = 0; i < frame.groupCount(); ++i)
+    {
+      const auto &group = frame.getGroup(i);
+      for (int j = 0; j < group.datasetCount(); ++j)
+        m_rows.append(Row{i, j});
+    }
+
+    endResetModel();
+    return;
+  }
+
+  // Notify each range of rows whose displayed value changed
+  int first = -1;
+  const QList<int> roles = {Qt::DisplayRole, ValueRole, NumericValueRole};
+  for (int i = 0; i <= m_rows.count(); ++i)
+  {
+    bool changed = false;
+    if (i < m_rows.count())
+    {
+      const auto &row = m_rows.at(i);
+      changed = dash->valueRevision(row.group, row.dataset) == revision;
+    }
+
+    if (changed && first < 0)
+      first = i;
+
+    else if (!changed && first >= 0)
+    {
+      Q_EMIT dataChanged(index(first), index(i - 1), roles);
+      first = -1;
+    }
+  }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QAbstractListModel>
+
+namespace UI
+{
+/**
+ * @brief The ValueModel class
+ *
+ * List model with one row for each dataset of the frame displayed by the
+ * dashboard, used by QML elements that display the current value of a
+ * dataset.
+ *
+ * Instead of re-evaluating every binding whenever the dashboard emits its
+ * @c updated() signal, the model compares the value revision of each row with
+ * the revision registered by the dashboard during the last update (see
+ * @c UI::Dashboard::valueRevision()) and emits a single @c dataChanged()
+ * signal for each range of consecutive rows whose displayed value changed.
+ * Therefore, the bindings re-evaluated during each render tick are
+ * proportional to the number of values that changed, instead of the total
+ * number of bound elements.
+ *
+ * The rows are only rebuilt when the structure of the displayed frame changes.
+ */
+class ValueModel : public QAbstractListModel
+{
+  Q_OBJECT
+
+private:
+  explicit ValueModel();
+  ValueModel(ValueModel &&) = delete;
+  ValueModel(const ValueModel &) = delete;
+  ValueModel &operator=(ValueModel &&) = delete;
+  ValueModel &operator=(const ValueModel &) = delete;
+
+public:
+  enum Roles
+  {
+    GroupRole = Qt::UserRole + 1,
+    TitleRole,
+    UnitsRole,
+    ValueRole,
+    NumericValueRole,
+    DatasetIndexRole
+  };
+
+  static ValueModel &instance();
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  Q_INVOKABLE int find(const int datasetIndex) const;
+
+private Q_SLOTS:
+  void clear();
+  void updateValues();
+
+private:
+  struct Row
+  {
+    int group;
+    int dataset;
+  };
+
+  quint64 m_revision;
+  quint64 m_schemaHash;
+  QVector<Row> m_rows;
+};
+} // namespace UI
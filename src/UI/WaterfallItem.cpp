@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGTextureMaterial>
+
+#include <UI/Colormap.h>
+#include <UI/Dashboard.h>
+#include <UI/FFTEngine.h>
+#include <UI/WaterfallItem.h>
+
+/**
+ * Maximum width of the waterfall texture (in pixels)
+ */
+static const int MAX_COLUMNS = 1024;
+
+/**
+ * Geometry node that draws the waterfall image as two textured quads, the
+ * node owns the texture created from the image.
+ */
+class WaterfallNode : public QSGGeometryNode
+{
+public:
+  WaterfallNode()
+    : m_texture(Q_NULLPTR)
+    , m_geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 12)
+  {
+    m_geometry.setDrawingMode(QSGGeometry::DrawTriangles);
+    setGeometry(&m_geometry);
+    setMaterial(&m_material);
+  }
+
+  ~WaterfallNode() { delete m_texture; }
+
+  QSGTexture *texture() const { return m_texture; }
+
+  void setTexture(QSGTexture *texture)
+  {
+    delete m_texture;
+    m_texture = texture;
+    m_material.setTexture(texture);
+    markDirty(QSGNode::DirtyMaterial);
+  }
+
+private:
+  QSGTexture *m_texture;
+  QSGGeometry m_geometry;
+  QSGOpaqueTextureMaterial m_material;
+};
+
+/**
+ * Constructor function, configures item flags & connects the signals of the
+ * dashboard and the FFT engine.
+ */
+UI::WaterfallItem::WaterfallItem(QQuickItem *parent)
+  : QQuickItem(parent)
+  , m_index(-1)
+  , m_rows(256)
+  , m_bins(0)
+  , m_head(0)
+  , m_range(80)
+  , m_peak(0)
+  , m_textureDirty(false)
+{
+  setFlag(ItemHasContents, true);
+
+  // clang-format off
+    connect(&UI::Dashboard::instance(), &UI::Dashboard::widgetCountChanged,
+            this, &UI::WaterfallItem::configure);
+    connect(&UI::FFTEngine::instance(), &UI::FFTEngine::spectrumUpdated,
+            this, &UI::WaterfallItem::onSpectrumUpdated);
+    connect(this, &UI::WaterfallItem::visibleChanged,
+            this, &UI::WaterfallItem::update);
+  // clang-format on
+}
+
+/**
+ * Returns the index of the waterfall widget displayed by the item
+ */
+int UI::WaterfallItem::index() const
+{
+  return m_index;
+}
+
+/**
+ * Returns the number of spectra displayed by the item
+ */
+int UI::WaterfallItem::rows() const
+{
+  return m_rows;
+}
+
+/**
+ * Returns the number of frequency bins displayed by the item
+ */
+int UI::WaterfallItem::bins() const
+{
+  return m_bins;
+}
+
+/**
+ * Returns the range of amplitudes (in dB below the peak amplitude) that are
+ * represented with the colormap, lower amplitudes are drawn in black.
+ */
+qreal UI::WaterfallItem::dynamicRange() const
+{
+  return m_range;
+}
+
+/**
+ * Changes the index of the waterfall widget displayed by the item
+ */
+void UI::WaterfallItem::setIndex(const int index)
+{
+  if (m_index != index)
+  {
+    m_index = index;
+    configure();
+  }
+}
+
+/**
+ * Changes the number of spectra displayed by the item, the history is cleared
+ */
+void UI::WaterfallItem::setRows(const int rows)
+{
+  const auto value = qMax(2, rows);
+  if (m_rows != value)
+  {
+    m_rows = value;
+    configure();
+  }
+}
+
+/**
+ * Changes the dynamic range of the colormap (in dB), the new range is applied
+ * to the spectra received from now on.
+ */
+void UI::WaterfallItem::setDynamicRange(const qreal range)
+{
+  const auto value = qMax<qreal>(1, range);
+  if (!qFuzzyCompare(m_range, value))
+  {
+    m_range = value;
+    Q_EMIT dynamicRangeChanged();
+  }
+}
+
+/**
+ * Draws the waterfall image, the texture is only re-uploaded if new spectra
+ * have been written since the last frame.
+ */
+QSGNode *UI::WaterfallItem::updatePaintNode(QSGNode *node,
+                                            UpdatePaintNodeData *data)
+{
+  Q_UNUSED(data);
+
+  // Nothing to draw
+  if (m_image.isNull() || width() <= 0 || height() <= 0 || !window())
+  {
+    delete node;
+    return Q_NULLPTR;
+  }
+
+  // Create node
+  auto waterfall = static_cast<WaterfallNode *>(node);
+  if (!waterfall)
+    waterfall = new WaterfallNode;
+
+  // Upload image to the GPU
+  if (m_textureDirty || !waterfall->texture())
+  {
+    waterfall->setTexture(window()->createTextureFromImage(m_image));
+    m_textureDirty = false;
+  }
+
+  // Get texture coordinates of the newest row
+  const auto rect = waterfall->texture()->normalizedTextureSubRect();
+  const qreal head = static_cast<qreal>(m_head) / m_rows;
+  const qreal v = rect.top() + rect.height() * head;
+
+  // Top quad displays the rows from the newest row to the end of the image,
+  // bottom quad displays the rows from the start of the image to the newest
+  const qreal w = width();
+  const qreal split = height() * (1 - head);
+  const qreal l = rect.left();
+  const qreal r = rect.right();
+  auto vertices = waterfall->geometry()->vertexDataAsTexturedPoint2D();
+  vertices[0].set(0, 0, l, v);
+  vertices[1].set(w, 0, r, v);
+  vertices[2].set(0, split, l, rect.bottom());
+  vertices[3].set(w, 0, r, v);
+  vertices[4].set(w, split, r, rect.bottom());
+  vertices[5].set(0, split, l, rect.bottom());
+  vertices[6].set(0, split, l, rect.top());
+  vertices[7].set(w, split, r, rect.top());
+  vertices[8].set(0, height(), l, v);
+  vertices[9].set(w, split, r, rect.top());
+  vertices[10].set(w, height(), r, v);
+  vertices[11].set(0, height(), l, v);
+  waterfall->markDirty(QSGNode::DirtyGeometry);
+
+  return waterfall;
+}
+
+/**
+ * Allocates the waterfall image for the current dataset & clears the history
+ */
+void UI::WaterfallItem::configure()
+{
+  // Reset parameters
+  m_bins = 0;
+  m_head = 0;
+  m_peak = 0;
+  m_image = QImage();
+
+  // Allocate one column per frequency bin (up to the maximum texture width)
+  if (validIndex())
+  {
+    auto dash = &UI::Dashboard::instance();
+    const auto samples = dash->getWaterfall(m_index).fftSamples();
+    m_bins = UI::FFTEngine::transformSize(samples) / 2;
+    m_image = QImage(qMin(m_bins, MAX_COLUMNS), m_rows, QImage::Format_RGB32);
+    m_image.fill(UI::Colormap::spectrum().first());
+  }
+
+  // Update user interface
+  m_textureDirty = true;
+  Q_EMIT indexChanged();
+  update();
+}
+
+/**
+ * Writes the latest spectrum of the displayed dataset to the history when it
+ * is published by the FFT engine.
+ */
+void UI::WaterfallItem::onSpectrumUpdated(const int channel)
+{
+  // Spectrum does not belong to this item
+  auto engine = &UI::FFTEngine::instance();
+  if (!validIndex() || engine->waterfallChannel(m_index) != channel)
+    return;
+
+  // Write row, the history is kept while the item is hidden but the texture
+  // is only uploaded for visible items
+  writeRow(engine->spectrum(channel));
+  if (isVisible())
+    update();
+}
+
+/**
+ * Returns @c true if the index of the item corresponds to a waterfall widget
+ */
+bool UI::WaterfallItem::validIndex() const
+{
+  return m_index >= 0 && m_index < UI::Dashboard::instance().waterfallCount();
+}
+
+/**
+ * Converts the given @a spectrum to colors and writes it over the oldest row
+ * of the history image.
+ */
+void UI::WaterfallItem::writeRow(const QVector<float> &spectrum)
+{
+  // Validate image & spectrum (the Nyquist bin is not displayed)
+  const int columns = m_image.width();
+  if (m_image.isNull() || columns <= 0 || spectrum.count() <= m_bins)
+    return;
+
+  // Update peak amplitude
+  const int group = m_bins / columns;
+  for (int i = 0; i < m_bins; ++i)
+    m_peak = qMax(m_peak, spectrum.at(i));
+
+  // Move head to the oldest row
+  m_head = (m_head + m_rows - 1) % m_rows;
+
+  // Convert the amplitude of each group of bins to a color
+  const auto &colors = UI::Colormap::spectrum();
+  auto line = reinterpret_cast<QRgb *>(m_image.scanLine(m_head));
+  const float floor = static_cast<float>(qPow(10, -m_range / 20));
+  for (int c = 0; c < columns; ++c)
+  {
+    float amplitude = 0;
+    for (int i = c * group; i < (c + 1) * group; ++i)
+      amplitude = qMax(amplitude, spectrum.at(i));
+
+    qreal t = 0;
+    if (m_peak > 0)
+    {
+      const float ratio = qMax(amplitude / m_peak, floor);
+      t = 1 + 20 * std::log10(ratio) / m_range;
+    }
+
+    line[c] = colors.at(qBound(0, qRound(t * 255), 255));
+  }
+
+  // Upload the image in the next frame
+  m_textureDirty = true;
+}
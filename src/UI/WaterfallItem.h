@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QVector>
+#include <QQuickItem>
+
+namespace UI
+{
+/**
+ * @brief The WaterfallItem class
+ *
+ * Qt Quick item that draws a spectrogram (waterfall) of a dataset with the
+ * scene graph, using the spectra calculated by the @c FFTEngine.
+ *
+ * The history is stored in an image that is used as a ring of rows: every new
+ * spectrum is converted to colors and written over the oldest row, and the
+ * item is drawn as two textured quads whose texture coordinates start at the
+ * newest row. Scrolling the waterfall therefore never moves any pixel data,
+ * the cost of an update is a single row plus the texture upload, which is
+ * done at most once per frame by the render thread.
+ *
+ * Spectra with more bins than the maximum texture width are reduced by
+ * keeping the peak amplitude of each group of bins. Amplitudes are mapped to
+ * colors on a logarithmic (dB) scale relative to the largest amplitude
+ * received so far, covering the given dynamic range.
+ */
+class WaterfallItem : public QQuickItem
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int index
+               READ index
+               WRITE setIndex
+               NOTIFY indexChanged)
+    Q_PROPERTY(int rows
+               READ rows
+               WRITE setRows
+               NOTIFY indexChanged)
+    Q_PROPERTY(int bins
+               READ bins
+               NOTIFY indexChanged)
+    Q_PROPERTY(qreal dynamicRange
+               READ dynamicRange
+               WRITE setDynamicRange
+               NOTIFY dynamicRangeChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void indexChanged();
+  void dynamicRangeChanged();
+
+public:
+  WaterfallItem(QQuickItem *parent = 0);
+
+  int index() const;
+  int rows() const;
+  int bins() const;
+  qreal dynamicRange() const;
+
+public Q_SLOTS:
+  void setIndex(const int index);
+  void setRows(const int rows);
+  void setDynamicRange(const qreal range);
+
+protected:
+  QSGNode *updatePaintNode(QSGNode *node, UpdatePaintNodeData *data) override;
+
+private Q_SLOTS:
+  void configure();
+  void onSpectrumUpdated(const int channel);
+
+private:
+  bool validIndex() const;
+  void writeRow(const QVector<float> &spectrum);
+
+private:
+  int m_index;
+  int m_rows;
+  int m_bins;
+  int m_head;
+  qreal m_range;
+  float m_peak;
+  bool m_textureDirty;
+  QImage m_image;
+};
+} // namespace UI
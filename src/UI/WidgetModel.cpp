@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Misc/Tracer.h>
+#include <UI/WidgetModel.h>
+
+/**
+ * Constructor function, updates the model when the widgets of the dashboard
+ * change.
+ */
+UI::WidgetModel::WidgetModel()
+{
+  connect(&UI::Dashboard::instance(), &UI::Dashboard::widgetCountChanged, this,
+          &UI::WidgetModel::updateModel);
+
+  updateModel();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+UI::WidgetModel &UI::WidgetModel::instance()
+{
+  static WidgetModel singleton;
+  return singleton;
+}
+
+/**
+ * Returns the number of widgets displayed by the dashboard
+ */
+int UI::WidgetModel::rowCount(const QModelIndex &parent) const
+{
+  if (parent.isValid())
+    return 0;
+
+  return m_entries.count();
+}
+
+/**
+ * Returns the global index, the title or the type of the widget at the given
+ * model @a index, depending on the given @a role.
+ */
+QVariant UI::WidgetModel::data(const QModelIndex &index, int role) const
+{
+  if (!index.isValid() || index.row() >= m_entries.count())
+    return QVariant();
+
+  const auto &entry = m_entries.at(index.row());
+  switch (role)
+  {
+    case WidgetIndexRole:
+      return index.row();
+    case Qt::DisplayRole:
+    case WidgetTitleRole:
+      return entry.title;
+    case WidgetTypeRole:
+      return static_cast<int>(entry.type);
+    default:
+      return QVariant();
+  }
+}
+
+/**
+ * Returns the names of the roles used by the QML delegates
+ */
+QHash<int, QByteArray> UI::WidgetModel::roleNames() const
+{
+  QHash<int, QByteArray> names;
+  names.insert(WidgetIndexRole, "widgetIndex");
+  names.insert(WidgetTitleRole, "widgetTitle");
+  names.insert(WidgetTypeRole, "widgetType");
+  return names;
+}
+
+/**
+ * Compares the current widget list of the dashboard with the rows of the
+ * model & notifies the view about the rows that were removed, inserted or
+ * moved to another global index.
+ *
+ * Widgets are ordered by type, so changes are usually localized: rows that
+ * match at the beginning & at the end of both lists are kept, and only the
+ * rows in between are removed & inserted.
+ */
+void UI::WidgetModel::updateModel()
+{
+  TRACE_SCOPE("UI::WidgetModel::updateModel");
+
+  // Obtain the new widget list
+  auto dash = &UI::Dashboard::instance();
+  const auto titles = dash->widgetTitles();
+  const int count = dash->totalWidgetCount();
+  QVector<Entry> entries;
+  entries.reserve(count);
+  for (int i = 0; i < count; ++i)
+  {
+    Entry entry;
+    entry.type = dash->widgetType(i);
+    entry.title = i < titles.count() ? titles.at(i) : QString();
+    entries.append(entry);
+  }
+
+  // Find the rows that did not change at the beginning of the list
+  int prefix = 0;
+  const int limit = qMin(m_entries.count(), entries.count());
+  while (prefix < limit && m_entries.at(prefix) == entries.at(prefix))
+    ++prefix;
+
+  // Find the rows that did not change at the end of the list
+  int suffix = 0;
+  while (suffix < limit - prefix
+         && m_entries.at(m_entries.count() - 1 - suffix)
+                == entries.at(entries.count() - 1 - suffix))
+    ++suffix;
+
+  // Nothing changed
+  const int removed = m_entries.count() - prefix - suffix;
+  const int inserted = entries.count() - prefix - suffix;
+  if (removed == 0 && inserted == 0)
+    return;
+
+  // Remove the rows that are no longer used
+  if (removed > 0)
+  {
+    beginRemoveRows(QModelIndex(), prefix, prefix + removed - 1);
+    m_entries.remove(prefix, removed);
+    endRemoveRows();
+  }
+
+  // Insert the new rows
+  if (inserted > 0)
+  {
+    beginInsertRows(QModelIndex(), prefix, prefix + inserted - 1);
+    for (int i = 0; i < inserted; ++i)
+      m_entries.insert(prefix + i, entries.at(prefix + i));
+    endInsertRows();
+  }
+
+  // The global index of the rows at the end of the list changed
+  if (suffix > 0 && removed != inserted)
+  {
+    const int first = prefix + inserted;
+    Q_EMIT dataChanged(index(first), index(first + suffix - 1),
+                       {WidgetIndexRole});
+  }
+}
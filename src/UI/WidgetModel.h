@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QAbstractListModel>
+
+#include <UI/Dashboard.h>
+
+namespace UI
+{
+/**
+ * @brief The WidgetModel class
+ *
+ * List model with one row for each widget of the dashboard, used by the QML
+ * interface to instantiate the widget delegates.
+ *
+ * When the number of widgets changes, the previous & the new widget lists are
+ * compared and only the rows that were removed or added are notified to the
+ * view. Widgets that remain in the dashboard keep their delegates, if their
+ * global index changed, the view is notified with a @c dataChanged() signal
+ * and the @c UI::DashboardWidget re-uses the existing widget as long as its
+ * type & relative index did not change. Therefore, the cost of a schema
+ * change is proportional to the number of widgets that changed, instead of
+ * the total number of widgets.
+ */
+class WidgetModel : public QAbstractListModel
+{
+  Q_OBJECT
+
+private:
+  explicit WidgetModel();
+  WidgetModel(WidgetModel &&) = delete;
+  WidgetModel(const WidgetModel &) = delete;
+  WidgetModel &operator=(WidgetModel &&) = delete;
+  WidgetModel &operator=(const WidgetModel &) = delete;
+
+public:
+  enum Roles
+  {
+    WidgetIndexRole = Qt::UserRole + 1,
+    WidgetTitleRole,
+    WidgetTypeRole
+  };
+
+  static WidgetModel &instance();
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+private Q_SLOTS:
+  void updateModel();
+
+private:
+  struct Entry
+  {
+    QString title;
+    UI::Dashboard::WidgetType type;
+    bool operator==(const Entry &other) const
+    {
+      return type == other.type && title == other.title;
+    }
+  };
+
+  QVector<Entry> m_entries;
+};
+} // namespace UI
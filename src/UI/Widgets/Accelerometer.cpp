@@ -24,6 +24,7 @@
 #include <QResizeEvent>
 
 #include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 #include <UI/Widgets/Accelerometer.h>
 
@@ -32,6 +33,7 @@
  */
 Widgets::Accelerometer::Accelerometer(const int index)
   : m_index(index)
+  , m_revision(0)
 {
   // Get pointers to Serial Studio modules
   auto dash = &UI::Dashboard::instance();
@@ -58,18 +60,11 @@ Widgets::Accelerometer::Accelerometer(const int index)
   m_gauge.setScale(0, 12);
   m_gauge.setScaleArc(90, 360);
 
-  // Set gauge palette
-  QPalette palette;
-  palette.setColor(QPalette::WindowText, theme->base());
-  palette.setColor(QPalette::Text, theme->widgetIndicator());
-  m_gauge.setPalette(palette);
-
   // Set widget pointer
   setWidget(&m_gauge);
 
   // React to dashboard events
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
 }
 
 /**
@@ -81,6 +76,8 @@ Widgets::Accelerometer::Accelerometer(const int index)
  */
 void Widgets::Accelerometer::updateData()
 {
+  TRACE_SCOPE("Widgets::Accelerometer::updateData");
+
   // Widget disabled
   if (!isEnabled())
     return;
@@ -90,8 +87,16 @@ void Widgets::Accelerometer::updateData()
   if (m_index < 0 || m_index >= dash->accelerometerCount())
     return;
 
+  // Displayed value did not change, skip update
+  const auto type = UI::Dashboard::WidgetType::Accelerometer;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
   // Get accelerometer group & validate it
-  auto accelerometer = dash->getAccelerometer(m_index);
+  const auto &accelerometer = dash->getAccelerometer(m_index);
   if (accelerometer.datasetCount() != 3)
     return;
 
@@ -103,13 +108,13 @@ void Widgets::Accelerometer::updateData()
   // Extract x, y, z from accelerometer group
   for (int i = 0; i < 3; ++i)
   {
-    auto dataset = accelerometer.getDataset(i);
+    const auto &dataset = accelerometer.getDataset(i);
     if (dataset.widget() == "x")
-      x = dataset.value().toDouble();
+      x = dataset.numericValue();
     if (dataset.widget() == "y")
-      y = dataset.value().toDouble();
+      y = dataset.numericValue();
     if (dataset.widget() == "z")
-      z = dataset.value().toDouble();
+      z = dataset.numericValue();
   }
 
   // Divide accelerations by gravitational constant
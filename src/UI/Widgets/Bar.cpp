@@ -24,6 +24,7 @@
 
 #include <UI/Dashboard.h>
 #include <UI/Widgets/Bar.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 
 /**
@@ -31,6 +32,7 @@
  */
 Widgets::Bar::Bar(const int index)
   : m_index(index)
+  , m_revision(0)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
@@ -76,8 +78,7 @@ Widgets::Bar::Bar(const int index)
   // React to dashboard events
   connect(this, SIGNAL(resized()), this, SLOT(onResized()),
           Qt::QueuedConnection);
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
 }
 
 /**
@@ -89,6 +90,8 @@ Widgets::Bar::Bar(const int index)
  */
 void Widgets::Bar::updateData()
 {
+  TRACE_SCOPE("Widgets::Bar::updateData");
+
   // Widget not enabled, do nothing
   if (!isEnabled())
     return;
@@ -98,9 +101,17 @@ void Widgets::Bar::updateData()
   if (m_index < 0 || m_index >= dash->barCount())
     return;
 
+  // Displayed value did not change, skip update
+  const auto type = UI::Dashboard::WidgetType::Bar;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
   // Update bar level
-  auto dataset = dash->getBar(m_index);
-  auto value = dataset.value().toDouble();
+  const auto &dataset = dash->getBar(m_index);
+  auto value = dataset.numericValue();
   m_thermo.setValue(value);
   setValue(QString("%1 %2").arg(
       QString::number(value, 'f', UI::Dashboard::instance().precision()),
@@ -40,6 +40,7 @@ private Q_SLOTS:
 
 private:
   int m_index;
+  quint64 m_revision;
   QwtThermo m_thermo;
 };
 } // namespace Widgets
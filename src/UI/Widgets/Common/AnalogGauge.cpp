@@ -27,6 +27,9 @@
 #include <Misc/ThemeManager.h>
 #include <UI/Widgets/Common/AnalogGauge.h>
 
+/**
+ * Constructor function, configures the gauge & its palette
+ */
 Widgets::AnalogGauge::AnalogGauge(QWidget *parent)
   : QwtDial(parent)
 {
@@ -36,7 +39,29 @@ Widgets::AnalogGauge::AnalogGauge(QWidget *parent)
   // Do not reset gauge if we reach maximum value
   setWrapping(false);
 
+  // Only redraw the needle when the value changes
+  setMode(QwtDial::RotateNeedle);
+
   // Set gauge origin & min/max angles
   setOrigin(135);
   setScaleArc(0, 270);
+
+  // Set gauge palette & update it when the theme changes
+  applyTheme();
+  connect(&Misc::ThemeManager::instance(), &Misc::ThemeManager::themeChanged,
+          this, [=]() { applyTheme(); });
+}
+
+/**
+ * Updates the palette of the gauge with the colors of the current theme, which
+ * also invalidates the pixmap cache of the dial.
+ */
+void Widgets::AnalogGauge::applyTheme()
+{
+  auto theme = &Misc::ThemeManager::instance();
+
+  QPalette palette;
+  palette.setColor(QPalette::WindowText, theme->base());
+  palette.setColor(QPalette::Text, theme->widgetIndicator());
+  setPalette(palette);
 }
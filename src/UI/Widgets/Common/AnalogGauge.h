@@ -27,9 +27,23 @@
 
 namespace Widgets
 {
+/**
+ * @brief The AnalogGauge class
+ *
+ * Dial used by the gauge & accelerometer widgets. The gauge works in
+ * @c QwtDial::RotateNeedle mode, in which the frame, the scale, the ticks &
+ * the labels are painted once into a pixmap cache by @c QwtDial and only the
+ * needle is drawn when the value changes.
+ *
+ * The cache is invalidated by @c QwtDial when the gauge is resized or when its
+ * palette changes, the palette is updated when the theme changes.
+ */
 class AnalogGauge : public QwtDial
 {
 public:
   AnalogGauge(QWidget *parent = Q_NULLPTR);
+
+private:
+  void applyTheme();
 };
 } // namespace Widgets
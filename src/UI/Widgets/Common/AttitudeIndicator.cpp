@@ -27,6 +27,7 @@
 #include <QwtDialNeedle>
 #include <QwtRoundScaleDraw>
 
+#include <Misc/ThemeManager.h>
 #include <UI/Widgets/Common/AttitudeIndicator.h>
 
 namespace Widgets
@@ -69,6 +70,7 @@ protected:
 AttitudeIndicator::AttitudeIndicator(QWidget *parent)
   : QwtDial(parent)
   , m_gradient(0)
+  , m_backgroundKey(0)
 {
   QwtRoundScaleDraw *scaleDraw = new QwtRoundScaleDraw();
   scaleDraw->enableComponent(QwtAbstractScaleDraw::Backbone, false);
@@ -84,8 +86,9 @@ AttitudeIndicator::AttitudeIndicator(QWidget *parent)
   setScaleStepSize(30.0);
   setScale(0.0, 360.0);
 
-  const QColor color = palette().color(QPalette::Text);
-  setNeedle(new Needle(color));
+  applyTheme();
+  connect(&Misc::ThemeManager::instance(), &Misc::ThemeManager::themeChanged,
+          this, [=]() { applyTheme(); });
 }
 
 double AttitudeIndicator::angle() const
@@ -114,6 +117,71 @@ void AttitudeIndicator::setGradient(const double &gradient)
   }
 }
 
+void AttitudeIndicator::applyTheme()
+{
+  auto theme = &Misc::ThemeManager::instance();
+
+  QPalette palette;
+  palette.setColor(QPalette::WindowText, theme->base());
+  palette.setColor(QPalette::Text, theme->widgetIndicator());
+  setPalette(palette);
+  setNeedle(new Needle(theme->widgetIndicator()));
+}
+
+void AttitudeIndicator::drawContents(QPainter *painter) const
+{
+  // Get size of the background in device pixels
+  const QRectF rect = boundingRect();
+  const qreal ratio = devicePixelRatioF();
+  const QSize size = (rect.size() * ratio).toSize();
+  if (size.isEmpty())
+    return;
+
+  // Regenerate the background if the size or the palette changed
+  const qint64 key = palette().cacheKey();
+  if (m_background.size() != size || m_backgroundKey != key)
+  {
+    m_backgroundKey = key;
+    m_background = QPixmap(size);
+    m_background.setDevicePixelRatio(ratio);
+    m_background.fill(Qt::transparent);
+
+    QPainter p(&m_background);
+    p.setPen(Qt::NoPen);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.translate(-rect.topLeft());
+    if (testAttribute(Qt::WA_NoSystemBackground)
+        || palette().brush(QPalette::Base) != palette().brush(QPalette::Window))
+    {
+      p.setBrush(palette().brush(QPalette::Base));
+      p.drawEllipse(rect);
+    }
+
+    if (palette().brush(QPalette::WindowText)
+        != palette().brush(QPalette::Base))
+    {
+      p.setBrush(palette().brush(QPalette::WindowText));
+      p.drawEllipse(scaleInnerRect());
+    }
+  }
+
+  // Draw the cached background
+  painter->drawPixmap(rect.topLeft(), m_background);
+
+  // Draw the scale & the horizon, which depend on the current value
+  const QRectF insideScaleRect = scaleInnerRect();
+  const QPointF center = insideScaleRect.center();
+  const double radius = 0.5 * insideScaleRect.width();
+
+  painter->save();
+  drawScale(painter, center, radius);
+  painter->restore();
+
+  painter->save();
+  drawScaleContents(painter, center, radius);
+  painter->restore();
+}
+
 void AttitudeIndicator::drawScale(QPainter *painter, const QPointF &center,
                                   double radius) const
 {
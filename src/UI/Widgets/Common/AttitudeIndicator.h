@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <QPixmap>
 #include <QwtDial>
 #include <QwtDialNeedle>
 
@@ -32,6 +33,19 @@
 
 namespace Widgets
 {
+/**
+ * @brief The AttitudeIndicator class
+ *
+ * Dial used by the gyroscope widget. The indicator works in
+ * @c QwtDial::RotateScale mode, in which @c QwtDial only caches the frame &
+ * the needle, while the contents of the dial are painted again for every
+ * value change.
+ *
+ * The background of the dial does not depend on the value, so it is painted
+ * once into a pixmap, which is regenerated when the dial is resized or when
+ * its palette (i.e. the theme) changes. Only the horizon & the rotated scale
+ * are drawn when the value changes.
+ */
 class AttitudeIndicator : public QwtDial
 {
 public:
@@ -45,12 +59,18 @@ public Q_SLOTS:
   void setGradient(const double &gradient);
 
 protected:
+  void drawContents(QPainter *painter) const QWT_OVERRIDE;
   void drawScale(QPainter *painter, const QPointF &center,
                  double radius) const QWT_OVERRIDE;
   void drawScaleContents(QPainter *painter, const QPointF &center,
                          double radius) const QWT_OVERRIDE;
 
+private:
+  void applyTheme();
+
 private:
   double m_gradient;
+  mutable qint64 m_backgroundKey;
+  mutable QPixmap m_background;
 };
 } // namespace Widgets
@@ -0,0 +1,652 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <UI/Widgets/Common/PlotSeries.h>
+
+/**
+ * Point of a series read by @c ENVELOPE(), samples have the same minimum &
+ * maximum value.
+ */
+struct EnvelopePoint
+{
+  double x;
+  double min;
+  double max;
+};
+
+/**
+ * Splits the points located in the [@a from, @a to) range in (at most)
+ * @a columns buckets & appends the minimum & maximum of each bucket to the
+ * given @a points vector, in chronological order. The points are obtained
+ * with the given @a reader function, the vertical range of the envelope is
+ * written to @a low and @a high.
+ */
+template<typename Reader>
+static void ENVELOPE(QVector<QPointF> &points, const int from, const int to,
+                     const int columns, Reader reader, double &low,
+                     double &high)
+{
+  // Initialize parameters
+  points.resize(0);
+  const int count = to - from;
+  if (count <= 0)
+    return;
+
+  // Get the number of points of each bucket
+  const int buckets = columns > 0 ? qMin(columns, count) : count;
+  const double ratio = static_cast<double>(count) / buckets;
+  points.reserve(buckets * 2);
+  low = reader(from).min;
+  high = reader(from).max;
+
+  // Obtain the minimum & maximum points of each bucket
+  for (int bucket = 0; bucket < buckets; ++bucket)
+  {
+    const int begin = from + static_cast<int>(bucket * ratio);
+    const int end = qMin(to, from + static_cast<int>((bucket + 1) * ratio));
+    if (begin >= end)
+      continue;
+
+    auto min = reader(begin);
+    auto max = min;
+    for (int i = begin + 1; i < end; ++i)
+    {
+      const auto point = reader(i);
+      if (point.min < min.min)
+        min = point;
+      if (point.max > max.max)
+        max = point;
+    }
+
+    // Add both points in chronological order
+    if (min.x == max.x && min.min == max.max)
+      points.append(QPointF(min.x, min.min));
+    else if (min.x <= max.x)
+    {
+      points.append(QPointF(min.x, min.min));
+      points.append(QPointF(max.x, max.max));
+    }
+    else
+    {
+      points.append(QPointF(max.x, max.max));
+      points.append(QPointF(min.x, min.min));
+    }
+
+    // Update the vertical range of the envelope
+    low = qMin(low, min.min);
+    high = qMax(high, max.max);
+  }
+}
+
+/**
+ * Constructor function, configures the series to read the buffer located at
+ * the given @a index of the given @a buffers vector.
+ */
+Widgets::PlotSeries::PlotSeries(const QVector<UI::PlotBuffer> *buffers,
+                                const int index)
+  : m_index(index)
+  , m_columns(0)
+  , m_span(0)
+  , m_timeWindow(0)
+  , m_endTime(0)
+  , m_offset(0)
+  , m_scale(1)
+  , m_decimated(false)
+  , m_originIndex(-1)
+  , m_buffers(buffers)
+  , m_history(Q_NULLPTR)
+  , m_origin(Q_NULLPTR)
+{
+}
+
+/**
+ * Constructor function, configures the series to read the history located at
+ * the given @a index of the given @a history vector.
+ */
+Widgets::PlotSeries::PlotSeries(const QVector<UI::PlotHistory> *history,
+                                const int index)
+  : m_index(index)
+  , m_columns(0)
+  , m_span(0)
+  , m_timeWindow(0)
+  , m_endTime(0)
+  , m_offset(0)
+  , m_scale(1)
+  , m_decimated(false)
+  , m_originIndex(-1)
+  , m_buffers(Q_NULLPTR)
+  , m_history(history)
+  , m_origin(Q_NULLPTR)
+{
+}
+
+/**
+ * Returns the number of samples handed to the curve, which is the number of
+ * samples of the buffer, or the number of points of the envelope if the series
+ * is decimated.
+ */
+int Widgets::PlotSeries::size() const
+{
+  if (m_decimated)
+    return m_points.count();
+
+  return bufferSize();
+}
+
+/**
+ * Returns the sample at the given index @a i
+ */
+QPointF Widgets::PlotSeries::sample(int i) const
+{
+  if (m_decimated)
+    return m_points.at(i);
+
+  return QPointF(i, normalize(buffer()->at(i)));
+}
+
+/**
+ * Returns the bounding rectangle of the samples. Qwt queries the rectangle
+ * several times per replot (autoscaling, clipping, legend...), so it is only
+ * calculated once by @c update() and cached until the next update.
+ *
+ * If the series has not been updated yet, the rectangle of the full
+ * resolution buffer is calculated & cached.
+ */
+QRectF Widgets::PlotSeries::boundingRect() const
+{
+  if (cachedBoundingRect.width() < 0.0)
+    cachedBoundingRect = bufferRect();
+
+  return cachedBoundingRect;
+}
+
+/**
+ * Returns the number of pixel columns used to decimate the series, 0 disables
+ * decimation.
+ */
+int Widgets::PlotSeries::columns() const
+{
+  return m_columns;
+}
+
+/**
+ * Returns the number of samples displayed by the series, 0 means that only the
+ * full resolution buffer is displayed.
+ */
+quint64 Widgets::PlotSeries::span() const
+{
+  return m_span;
+}
+
+/**
+ * Returns the period of time (in microseconds) displayed by the series, 0 means
+ * that the samples are displayed against the sample index.
+ */
+qint64 Widgets::PlotSeries::timeWindow() const
+{
+  return m_timeWindow;
+}
+
+/**
+ * Returns the time (in microseconds) of the newest sample that can be
+ * displayed by the series, 0 means that the latest samples are displayed.
+ */
+qint64 Widgets::PlotSeries::endTime() const
+{
+  return m_endTime;
+}
+
+/**
+ * Returns @c true if the curve is drawing the min/max envelope of the buffer
+ * instead of the buffer itself.
+ */
+bool Widgets::PlotSeries::decimated() const
+{
+  return m_decimated;
+}
+
+/**
+ * Regenerates the min/max envelope of the buffer if it holds more than two
+ * samples per pixel column, otherwise the buffer is handed to the curve as-is.
+ *
+ * If the requested span exceeds the full resolution buffer & the history holds
+ * more samples than the buffer, the envelope is generated from the history.
+ *
+ * If a time window is set, the envelope of the samples received during the
+ * time window is generated instead (see @c updateTimeWindow()).
+ */
+void Widgets::PlotSeries::update()
+{
+  // Display the long-term history
+  if (m_history && m_index >= 0 && m_index < m_history->count())
+  {
+    const auto &history = m_history->at(m_index);
+    if (m_timeWindow > 0)
+    {
+      updateTimeWindow(history);
+      return;
+    }
+
+    if (m_endTime > 0)
+    {
+      updateScrubbed(history);
+      return;
+    }
+
+    const auto recent = static_cast<quint64>(history.recent().size());
+    const int level = history.level(m_span);
+    if (level >= 0 && history.count() > recent)
+    {
+      updateHistory(history, level);
+      return;
+    }
+  }
+
+  // Check if decimation is needed
+  const int count = bufferSize();
+  cachedBoundingRect = bufferRect();
+  m_decimated = m_columns > 0 && count > m_columns * 2;
+  if (!m_decimated)
+  {
+    m_points.clear();
+    return;
+  }
+
+  // Generate the envelope of the full resolution buffer
+  updateEnvelope(*buffer(), count);
+}
+
+/**
+ * Changes the number of pixel @a columns used to decimate the series,
+ * typically the width of the plot canvas. Set to 0 to disable decimation.
+ */
+void Widgets::PlotSeries::setColumns(const int columns)
+{
+  m_columns = qMax(0, columns);
+}
+
+/**
+ * Changes the number of samples displayed by the series, only series that read
+ * a @c UI::PlotHistory can display more samples than the full resolution
+ * buffer. Set to 0 to display the full resolution buffer.
+ */
+void Widgets::PlotSeries::setSpan(const quint64 span)
+{
+  m_span = span;
+}
+
+/**
+ * Changes the period of time (in @a usecs) displayed by the series, which uses
+ * the time at which each sample was received as X-axis value. Only series that
+ * read a @c UI::PlotHistory support time windows. Set to 0 to display the
+ * samples against the sample index.
+ */
+void Widgets::PlotSeries::setTimeWindow(const qint64 usecs)
+{
+  m_timeWindow = qMax<qint64>(0, usecs);
+}
+
+/**
+ * Only displays the samples received at or before the given time (in
+ * @a usecs, see @c IO::FrameQueue::timestamp()). The series displays the same
+ * number of samples (or the same time window) as usual, but ending at the
+ * given time instead of the latest sample. Only series that read a
+ * @c UI::PlotHistory can be scrubbed. Set to 0 to display the latest samples.
+ */
+void Widgets::PlotSeries::setEndTime(const qint64 usecs)
+{
+  m_endTime = qMax<qint64>(0, usecs);
+}
+
+/**
+ * Uses the latest sample of the history located at the given @a index of the
+ * given @a history vector as the X-axis origin of the time window, instead of
+ * the latest sample of the history displayed by the series. Pass
+ * @c Q_NULLPTR to use the displayed history.
+ */
+void Widgets::PlotSeries::setTimeOrigin(
+    const QVector<UI::PlotHistory> *history, const int index)
+{
+  m_origin = history;
+  m_originIndex = index;
+}
+
+/**
+ * Maps the given [@a min, @a max] range of the samples to [0, 1] when they
+ * are handed to the curve, the stored samples are not modified. This allows
+ * several widgets to share the same history, even if only some of them
+ * display normalized values. Passing an invalid range disables normalization.
+ */
+void Widgets::PlotSeries::setNormalization(const double min, const double max)
+{
+  if (max > min)
+  {
+    m_offset = min;
+    m_scale = 1.0 / (max - min);
+  }
+
+  else
+  {
+    m_offset = 0;
+    m_scale = 1;
+  }
+}
+
+/**
+ * Returns the given @a value, mapped to the normalization range of the
+ * series (see @c setNormalization()).
+ */
+double Widgets::PlotSeries::normalize(const double value) const
+{
+  return (value - m_offset) * m_scale;
+}
+
+/**
+ * Returns the number of samples of the buffer, or 0 if the buffer does not
+ * exist (yet).
+ */
+int Widgets::PlotSeries::bufferSize() const
+{
+  const auto b = buffer();
+  if (!b)
+    return 0;
+
+  return b->size();
+}
+
+/**
+ * Returns the bounding rectangle of the full resolution buffer, the vertical
+ * range is given by the running minimum & maximum of the buffer (which are
+ * also part of the min/max envelope), so the samples do not need to be
+ * scanned.
+ */
+QRectF Widgets::PlotSeries::bufferRect() const
+{
+  const int count = bufferSize();
+  if (count <= 0)
+    return QRectF(1.0, 1.0, -2.0, -2.0);
+
+  const auto b = buffer();
+  const double min = normalize(b->min());
+  const double max = normalize(b->max());
+  return QRectF(0, min, count - 1, max - min);
+}
+
+/**
+ * Returns the full resolution buffer read by the series, or @c Q_NULLPTR if
+ * the buffer does not exist (yet).
+ */
+const UI::PlotBuffer *Widgets::PlotSeries::buffer() const
+{
+  if (m_index < 0)
+    return Q_NULLPTR;
+
+  if (m_buffers && m_index < m_buffers->count())
+    return &m_buffers->at(m_index);
+
+  if (m_history && m_index < m_history->count())
+    return &m_history->at(m_index).recent();
+
+  return Q_NULLPTR;
+}
+
+/**
+ * Generates the min/max envelope of the latest @a count samples of the given
+ * @a buffer, with one bucket per pixel column.
+ */
+void Widgets::PlotSeries::updateEnvelope(const UI::PlotBuffer &buffer,
+                                         const int count)
+{
+  double low, high;
+  auto reader = [&](const int i) {
+    const double value = normalize(buffer.at(i));
+    return EnvelopePoint{double(i), value, value};
+  };
+
+  ENVELOPE(m_points, 0, count, m_columns, reader, low, high);
+}
+
+/**
+ * Generates the min/max envelope of the latest samples of the given
+ * @a history from the buckets of the given @a level. The X-axis value of each
+ * point is the position of its bucket (in samples) relative to the beginning
+ * of the displayed span.
+ */
+void Widgets::PlotSeries::updateHistory(const UI::PlotHistory &history,
+                                        const int level)
+{
+  // Get the span & the buckets stored by the level
+  const auto count = history.count();
+  const auto window = qMin(m_span, count);
+  const auto span = UI::PlotHistory::levelSpan(level);
+  const int size = history.levelSize(level);
+  const auto first = count / span - static_cast<quint64>(size);
+  const auto start = count - window;
+
+  // Skip the buckets that are older than the displayed span
+  int from = 0;
+  if (first * span < start)
+    from = static_cast<int>(
+        qMin<quint64>(size, (start + span - 1) / span - first));
+
+  // Generate the envelope of the buckets
+  double low = 0, high = 0;
+  auto reader = [&](const int i) {
+    const auto &bucket = history.bucket(level, i);
+    const double x = double((first + i) * span) - start;
+    return EnvelopePoint{x, normalize(bucket.min), normalize(bucket.max)};
+  };
+  ENVELOPE(m_points, from, size, m_columns, reader, low, high);
+
+  // Update the bounding rectangle of the series
+  m_decimated = true;
+  const double width = window > 0 ? window - 1 : 0;
+  cachedBoundingRect = QRectF(0, low, width, high - low);
+}
+
+/**
+ * Generates the min/max envelope of the samples of the given @a history that
+ * were received during the time window. The X-axis value of each point is the
+ * time (in seconds) elapsed since the latest sample was received.
+ *
+ * The full resolution samples are used if they cover the whole time window,
+ * otherwise the envelope is generated from the finest level that does. In both
+ * cases, the first sample of the window is located with a binary search.
+ */
+void Widgets::PlotSeries::updateTimeWindow(const UI::PlotHistory &history)
+{
+  // Get the time window
+  auto newest = history.lastTime();
+  if (m_origin && m_originIndex >= 0 && m_originIndex < m_origin->count())
+    newest = m_origin->at(m_originIndex).lastTime();
+  if (m_endTime > 0)
+    newest = m_endTime;
+
+  const auto start = newest - m_timeWindow;
+
+  // Get the full resolution samples that were written
+  const auto &recent = history.recent();
+  const int size = recent.size();
+  const auto count = qMin<quint64>(size, history.count());
+  const int valid = size - static_cast<int>(count);
+
+  // Find the finest level that covers the time window
+  int level = -1;
+  if (history.count() > count && (valid >= size || history.time(valid) > start))
+  {
+    for (int i = 0; i < UI::PlotHistory::levelCount(); ++i)
+    {
+      if (history.levelSize(i) <= 0)
+        break;
+
+      level = i;
+      if (history.bucket(i, 0).time <= start)
+        break;
+    }
+  }
+
+  // Generate the envelope of the full resolution samples
+  double low = 0, high = 0;
+  if (level < 0)
+  {
+    auto reader = [&](const int i) {
+      const double x = (history.time(i) - newest) / 1e6;
+      const double value = normalize(recent.at(i));
+      return EnvelopePoint{x, value, value};
+    };
+
+    const int from = qMax(valid, history.lowerBound(start));
+    const int to = m_endTime > 0 ? history.lowerBound(newest + 1) : size;
+    ENVELOPE(m_points, from, to, m_columns, reader, low, high);
+  }
+
+  // Generate the envelope of the buckets of the level
+  else
+  {
+    auto reader = [&](const int i) {
+      const auto &bucket = history.bucket(level, i);
+      const double x = (bucket.time - newest) / 1e6;
+      return EnvelopePoint{x, normalize(bucket.min), normalize(bucket.max)};
+    };
+
+    const int from = history.lowerBound(level, start);
+    int buckets = history.levelSize(level);
+    if (m_endTime > 0)
+      buckets = history.lowerBound(level, newest + 1);
+
+    ENVELOPE(m_points, from, buckets, m_columns, reader, low, high);
+  }
+
+  // Update the bounding rectangle of the series
+  m_decimated = true;
+  const double seconds = m_timeWindow / 1e6;
+  cachedBoundingRect = QRectF(-seconds, low, seconds, high - low);
+}
+
+/**
+ * Generates the min/max envelope of the samples of the given @a history that
+ * precede the end time of the series (see @c setEndTime()), using the sample
+ * index as X-axis value.
+ *
+ * Samples are located by their absolute position (the number of samples that
+ * were appended to the history before them): the position of the last sample
+ * received before the end time is obtained with a binary search, then the
+ * displayed span ending at that position is read from the full resolution
+ * buffer (if it still holds it) or from the finest level that does.
+ */
+void Widgets::PlotSeries::updateScrubbed(const UI::PlotHistory &history)
+{
+  // Get the full resolution samples that were written
+  const auto &recent = history.recent();
+  const int size = recent.size();
+  const auto count = history.count();
+  const auto stored = qMin<quint64>(size, count);
+  const int valid = size - static_cast<int>(stored);
+  const auto oldest = count - stored;
+  const auto window = qMax<quint64>(m_span, static_cast<quint64>(size));
+
+  // Find the position of the last sample received before the end time
+  quint64 end = 0;
+  if (valid < size && history.time(valid) <= m_endTime)
+    end = oldest + (history.lowerBound(m_endTime + 1) - valid);
+  else
+  {
+    for (int i = 0; i < UI::PlotHistory::levelCount(); ++i)
+    {
+      const int buckets = history.levelSize(i);
+      if (buckets <= 0)
+        break;
+
+      if (history.bucket(i, 0).time <= m_endTime)
+      {
+        const auto span = UI::PlotHistory::levelSpan(i);
+        const auto first = count / span - static_cast<quint64>(buckets);
+        end = (first + history.lowerBound(i, m_endTime + 1)) * span;
+        break;
+      }
+    }
+  }
+
+  // Get the displayed span
+  double low = 0, high = 0;
+  const auto start = end > window ? end - window : 0;
+  m_decimated = true;
+  cachedBoundingRect = QRectF(0, 0, window > 0 ? window - 1 : 0, 0);
+
+  // Read the full resolution samples
+  if (start >= oldest && end > oldest)
+  {
+    auto reader = [&](const int i) {
+      const double x = double(oldest + (i - valid) - start);
+      const double value = normalize(recent.at(i));
+      return EnvelopePoint{x, value, value};
+    };
+
+    const int from = valid + static_cast<int>(start - oldest);
+    const int to = valid + static_cast<int>(end - oldest);
+    ENVELOPE(m_points, from, to, m_columns, reader, low, high);
+    cachedBoundingRect.setTop(low);
+    cachedBoundingRect.setBottom(high);
+    return;
+  }
+
+  // Find the finest level that covers the displayed span
+  int level = -1;
+  for (int i = 0; i < UI::PlotHistory::levelCount(); ++i)
+  {
+    const int buckets = history.levelSize(i);
+    if (buckets <= 0)
+      break;
+
+    level = i;
+    const auto span = UI::PlotHistory::levelSpan(i);
+    if ((count / span - static_cast<quint64>(buckets)) * span <= start)
+      break;
+  }
+
+  // No samples before the end time
+  m_points.clear();
+  if (level < 0)
+    return;
+
+  // Read the buckets of the level
+  const auto span = UI::PlotHistory::levelSpan(level);
+  const int buckets = history.levelSize(level);
+  const auto first = count / span - static_cast<quint64>(buckets);
+  auto reader = [&](const int i) {
+    const auto &bucket = history.bucket(level, i);
+    const double x = double((first + i) * span) - double(start);
+    return EnvelopePoint{x, normalize(bucket.min), normalize(bucket.max)};
+  };
+
+  auto index = [&](const quint64 position) {
+    const auto bucket = (position + span - 1) / span;
+    if (bucket <= first)
+      return 0;
+
+    return static_cast<int>(qMin<quint64>(buckets, bucket - first));
+  };
+
+  ENVELOPE(m_points, index(start), index(end), m_columns, reader, low, high);
+  cachedBoundingRect.setTop(low);
+  cachedBoundingRect.setBottom(high);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QwtSeriesData>
+#include <UI/PlotBuffer.h>
+#include <UI/PlotHistory.h>
+
+namespace Widgets
+{
+/**
+ * @brief The PlotSeries class
+ *
+ * Adapter that exposes one of the @c UI::PlotBuffer objects of a vector to a
+ * Qwt curve, samples are read from the ring in logical order, using the sample
+ * index as X-axis value.
+ *
+ * The buffer is looked up by index each time that the curve reads the data,
+ * this allows the owner of the vector to regenerate its buffers (e.g. when the
+ * number of points changes) without invalidating the series.
+ *
+ * When the buffer holds many more samples than the plot can display, the
+ * series is decimated with a min/max envelope: the samples are split in one
+ * bucket per pixel column and only the minimum and maximum sample of each
+ * bucket are handed to the curve. This keeps peaks & glitches visible while
+ * drawing at most two points per column. Call @c update() before replotting
+ * to regenerate the decimated samples.
+ *
+ * Samples are never copied into the curve: the series is a read-only view
+ * over the buffers owned by the dashboard (or the widget), and its bounding
+ * rectangle is cached between updates.
+ *
+ * Series created from a vector of @c UI::PlotHistory objects can display more
+ * samples than the full resolution buffer holds (see @c setSpan()), in that
+ * case the envelope is generated from the buckets of the history level that
+ * covers the requested span. These series can also display the samples
+ * received during a period of time (see @c setTimeWindow()), using the time
+ * at which each sample was received as X-axis value.
+ *
+ * By default, the X-axis origin of a time window is the latest sample of the
+ * history. Series that are drawn on top of another one (e.g. the "ghost"
+ * curves of a reference recording) can use the latest sample of a different
+ * history as origin (see @c setTimeOrigin()), so that both are aligned.
+ *
+ * Finally, series created from a history can display the samples that were
+ * received before a given time (see @c setEndTime()), which allows the user
+ * to look back at older data while new samples are still being appended.
+ */
+class PlotSeries : public QwtSeriesData<QPointF>
+{
+public:
+  PlotSeries(const QVector<UI::PlotBuffer> *buffers, const int index);
+  PlotSeries(const QVector<UI::PlotHistory> *history, const int index);
+
+  int size() const override;
+  QPointF sample(int i) const override;
+  QRectF boundingRect() const override;
+
+  int columns() const;
+  quint64 span() const;
+  qint64 timeWindow() const;
+  qint64 endTime() const;
+  bool decimated() const;
+
+  void update();
+  void setColumns(const int columns);
+  void setSpan(const quint64 span);
+  void setTimeWindow(const qint64 usecs);
+  void setEndTime(const qint64 usecs);
+  void setTimeOrigin(const QVector<UI::PlotHistory> *history,
+                     const int index);
+  void setNormalization(const double min, const double max);
+
+private:
+  int bufferSize() const;
+  double normalize(const double value) const;
+  QRectF bufferRect() const;
+  const UI::PlotBuffer *buffer() const;
+  void updateEnvelope(const UI::PlotBuffer &buffer, const int count);
+  void updateHistory(const UI::PlotHistory &history, const int level);
+  void updateTimeWindow(const UI::PlotHistory &history);
+  void updateScrubbed(const UI::PlotHistory &history);
+
+private:
+  int m_index;
+  int m_columns;
+  quint64 m_span;
+  qint64 m_timeWindow;
+  qint64 m_endTime;
+  double m_offset;
+  double m_scale;
+  bool m_decimated;
+  int m_originIndex;
+  QVector<QPointF> m_points;
+  const QVector<UI::PlotBuffer> *m_buffers;
+  const QVector<UI::PlotHistory> *m_history;
+  const QVector<UI::PlotHistory> *m_origin;
+};
+} // namespace Widgets
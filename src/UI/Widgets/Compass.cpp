@@ -33,10 +33,10 @@
  */
 Widgets::Compass::Compass(const int index)
   : m_index(index)
+  , m_revision(0)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
-  auto theme = &Misc::ThemeManager::instance();
 
   // Invalid index, abort initialization
   if (m_index < 0 || m_index >= dash->compassCount())
@@ -58,17 +58,20 @@ Widgets::Compass::Compass(const int index)
   m_compass.setNeedle(
       new QwtCompassMagnetNeedle(QwtCompassMagnetNeedle::ThinStyle));
 
-  // Set compass palette
-  QPalette palette;
-  palette.setColor(QPalette::WindowText, theme->base());
-  palette.setColor(QPalette::Text, theme->widgetIndicator());
-  m_compass.setPalette(palette);
+  // Set compass palette, the compass only redraws its needle when the value
+  // changes, the rest of the dial is cached until the palette changes
+  applyTheme();
 
   // Set widget pointer
   setWidget(&m_compass);
 
-  // React to dashboard events
-  connect(dash, SIGNAL(updated()), this, SLOT(update()), Qt::QueuedConnection);
+  // React to dashboard & theme events
+  // clang-format off
+    connect(this, SIGNAL(refreshRequested()),
+            this, SLOT(update()));
+    connect(&Misc::ThemeManager::instance(), SIGNAL(themeChanged()),
+            this, SLOT(applyTheme()));
+  // clang-format on
 }
 
 /**
@@ -89,9 +92,17 @@ void Widgets::Compass::update()
   if (m_index < 0 || m_index >= dash->compassCount())
     return;
 
+  // Displayed value did not change, skip update
+  const auto type = UI::Dashboard::WidgetType::Compass;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
   // Get dataset value & set text format
-  auto dataset = dash->getCompass(m_index);
-  auto value = dataset.value().toDouble();
+  const auto &dataset = dash->getCompass(m_index);
+  auto value = dataset.numericValue();
   auto text = QString("%1°").arg(
       QString::number(value, 'f', UI::Dashboard::instance().precision()));
 
@@ -108,3 +119,17 @@ void Widgets::Compass::update()
   // Repaint the widget
   requestRepaint();
 }
+
+/**
+ * Updates the palette of the compass with the colors of the current theme,
+ * which also invalidates the pixmap cache of the dial.
+ */
+void Widgets::Compass::applyTheme()
+{
+  auto theme = &Misc::ThemeManager::instance();
+
+  QPalette palette;
+  palette.setColor(QPalette::WindowText, theme->base());
+  palette.setColor(QPalette::Text, theme->widgetIndicator());
+  m_compass.setPalette(palette);
+}
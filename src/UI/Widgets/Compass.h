@@ -36,9 +36,11 @@ public:
 
 private Q_SLOTS:
   void update();
+  void applyTheme();
 
 private:
   int m_index;
+  quint64 m_revision;
   QwtCompass m_compass;
 };
 } // namespace Widgets
@@ -20,30 +20,41 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
+
+#include <QKeyEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
 #include <QResizeEvent>
-#include <QRegularExpression>
 
 #include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 #include <UI/Widgets/DataGroup.h>
 
-#define DG_EXEC_EVENT(pointer, function, event)                                \
-  if (pointer)                                                                 \
-  {                                                                            \
-    class PwnedWidget : public QScrollArea                                     \
-    {                                                                          \
-    public:                                                                    \
-      using QScrollArea::function;                                             \
-    };                                                                         \
-    static_cast<PwnedWidget *>(pointer)->function(event);                      \
-    requestRepaint();                                                          \
-  }
+/**
+ * Groups with more datasets than this value display the sort/filter header
+ */
+static const int HEADER_THRESHOLD = 16;
+
+/**
+ * Number of rows scrolled by each step of the mouse wheel
+ */
+static const int WHEEL_ROWS = 3;
 
 /**
  * Generates the user interface elements & layout
  */
 Widgets::DataGroup::DataGroup(const int index)
   : m_index(index)
+  , m_revision(0)
+  , m_sortOrder(SortOrder::Index)
+  , m_header(Q_NULLPTR)
+  , m_scrollBar(Q_NULLPTR)
+  , m_dataContainer(Q_NULLPTR)
+  , m_mainLayout(Q_NULLPTR)
+  , m_listLayout(Q_NULLPTR)
+  , m_gridLayout(Q_NULLPTR)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
@@ -54,14 +65,20 @@ Widgets::DataGroup::DataGroup(const int index)
     return;
 
   // Get group reference
-  auto group = dash->getGroups(m_index);
+  const auto &group = dash->getGroups(m_index);
 
-  // Generate widget stylesheets
-  auto titleQSS = QSS("color:%1", theme->widgetTextPrimary());
-  auto unitsQSS = QSS("color:%1", theme->widgetTextSecondary());
-  auto valueQSS = QSS("color:%1", theme->widgetForegroundPrimary());
-  auto iconsQSS
-      = QSS("color:%1; font-weight:600;", theme->widgetTextSecondary());
+  // Cache the static properties of the datasets
+  m_datasetTitles.reserve(group.datasetCount());
+  m_datasetUnits.reserve(group.datasetCount());
+  for (int i = 0; i < group.datasetCount(); ++i)
+  {
+    const auto &dataset = group.getDataset(i);
+    m_datasetTitles.append(dataset.title());
+    if (dataset.units().isEmpty())
+      m_datasetUnits.append(QString());
+    else
+      m_datasetUnits.append(QString("[%1]").arg(dataset.units()));
+  }
 
   // Set window palette
   QPalette windowPalette;
@@ -69,92 +86,54 @@ Widgets::DataGroup::DataGroup(const int index)
   windowPalette.setColor(QPalette::Window, theme->widgetWindowBackground());
   setPalette(windowPalette);
 
-  // Configure scroll area container
-  m_dataContainer = new QWidget(this);
-
   // Make the value label larger
-  auto valueFont = dash->monoFont();
-  valueFont.setPixelSize(dash->monoFont().pixelSize() * 1.3);
-
-  // Configure grid layout
-  m_units.reserve(group.datasetCount());
-  m_icons.reserve(group.datasetCount());
-  m_titles.reserve(group.datasetCount());
-  m_values.reserve(group.datasetCount());
+  m_font = dash->monoFont();
+  m_iconFont = dash->monoFont();
+  m_valueFont = dash->monoFont();
+  m_valueFont.setPixelSize(dash->monoFont().pixelSize() * 1.3);
+
+  // Configure the header
+  m_header = new QLabel(this);
+  m_header->setFont(m_font);
+  m_header->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+  m_header->setStyleSheet(QSS("color:%1", theme->widgetTextSecondary()));
+  m_header->setVisible(group.datasetCount() > HEADER_THRESHOLD);
+
+  // Configure the container of the visible rows
+  m_dataContainer = new QWidget(this);
   m_gridLayout = new QGridLayout(m_dataContainer);
-  for (int dataset = 0; dataset < group.datasetCount(); ++dataset)
-  {
-    // Create labels
-    m_units.append(new QLabel(m_dataContainer));
-    m_icons.append(new QLabel(m_dataContainer));
-    m_titles.append(new ElidedLabel(m_dataContainer));
-    m_values.append(new ElidedLabel(m_dataContainer));
-
-    // Get pointers to labels
-    auto dicon = m_icons.last();
-    auto units = m_units.last();
-    auto title = m_titles.last();
-    auto value = m_values.last();
-
-    // Set elide modes for title & value fields
-    title->setType(Qt::ElideRight);
-    value->setType(Qt::ElideRight);
-
-    // Set label alignments
-    units->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-    value->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
-    title->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
-    dicon->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-
-    // Set label styles & fonts
-    value->setFont(valueFont);
-    title->setFont(dash->monoFont());
-    units->setFont(dash->monoFont());
-    title->setStyleSheet(titleQSS);
-    value->setStyleSheet(valueQSS);
-    units->setStyleSheet(unitsQSS);
-    dicon->setStyleSheet(iconsQSS);
-
-    // Set label initial data
-    auto set = group.getDataset(dataset);
-    title->setText(set.title());
-    if (!set.units().isEmpty())
-      units->setText(QString("[%1]").arg(set.units()));
-
-    // Set icon text
-    dicon->setText("⤑");
-
-    // Add labels to grid layout
-    m_gridLayout->addWidget(title, dataset, 0);
-    m_gridLayout->addWidget(dicon, dataset, 1);
-    m_gridLayout->addWidget(value, dataset, 2);
-    m_gridLayout->addWidget(units, dataset, 3);
-  }
-
-  // Load layout into container widget
   m_gridLayout->setColumnStretch(0, 2);
   m_gridLayout->setColumnStretch(1, 1);
   m_gridLayout->setColumnStretch(2, 2);
   m_gridLayout->setColumnStretch(3, 0);
   m_dataContainer->setLayout(m_gridLayout);
 
-  // Configure scroll area
-  m_scrollArea = new QScrollArea(this);
-  m_scrollArea->setWidgetResizable(true);
-  m_scrollArea->setWidget(m_dataContainer);
-  m_scrollArea->setFrameShape(QFrame::NoFrame);
-  m_scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-  m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+  // Configure the scroll bar
+  m_scrollBar = new QScrollBar(Qt::Vertical, this);
+  m_scrollBar->setVisible(false);
+
+  // Configure list layout
+  m_listLayout = new QHBoxLayout();
+  m_listLayout->setContentsMargins(0, 0, 0, 0);
+  m_listLayout->addWidget(m_dataContainer, 1);
+  m_listLayout->addWidget(m_scrollBar);
 
   // Configure main layout
   m_mainLayout = new QVBoxLayout(this);
-  m_mainLayout->addWidget(m_scrollArea);
+  m_mainLayout->addWidget(m_header);
+  m_mainLayout->addLayout(m_listLayout, 1);
   m_mainLayout->setContentsMargins(0, 0, 0, 0);
   setLayout(m_mainLayout);
 
+  // Let the widget receive keyboard input for the filter
+  setFocusPolicy(Qt::StrongFocus);
+
+  // Show datasets in their original order
+  updateOrder();
+
   // React to dashboard events
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
+  connect(m_scrollBar, SIGNAL(valueChanged(int)), this, SLOT(updateRows()));
 }
 
 /**
@@ -174,8 +153,11 @@ Widgets::DataGroup::~DataGroup()
   Q_FOREACH (auto units, m_units)
     delete units;
 
+  delete m_header;
+  delete m_scrollBar;
   delete m_gridLayout;
-  delete m_scrollArea;
+  delete m_dataContainer;
+  delete m_listLayout;
   delete m_mainLayout;
 }
 
@@ -188,6 +170,8 @@ Widgets::DataGroup::~DataGroup()
  */
 void Widgets::DataGroup::updateData()
 {
+  TRACE_SCOPE("Widgets::DataGroup::updateData");
+
   // Widget not enabled, do nothing
   if (!isEnabled())
     return;
@@ -197,26 +181,93 @@ void Widgets::DataGroup::updateData()
   if (m_index < 0 || m_index >= dash->groupCount())
     return;
 
-  // Get group reference
-  auto group = dash->getGroups(m_index);
+  // No displayed value changed, skip update
+  const auto type = UI::Dashboard::WidgetType::Group;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
 
-  // Regular expresion handler
-  const QRegularExpression regex("^[+-]?(\\d*\\.)?\\d+$");
+  m_revision = revision;
 
-  // Update labels
-  for (int i = 0; i < group.datasetCount(); ++i)
+  // Values changed, the position of the datasets may change too
+  if (m_sortOrder == SortOrder::ValueAscending
+      || m_sortOrder == SortOrder::ValueDescending)
+    updateOrder();
+
+  // Update the visible rows
+  else
+    updateRows();
+}
+
+/**
+ * Assigns the datasets at the current scroll position to the visible rows &
+ * updates the value of the rows whose displayed value changed.
+ */
+void Widgets::DataGroup::updateRows()
+{
+  // Invalid index, abort update
+  auto dash = &UI::Dashboard::instance();
+  if (m_index < 0 || m_index >= dash->groupCount())
+    return;
+
+  // Get group reference
+  const auto &group = dash->getGroups(m_index);
+  if (group.datasetCount() != m_datasetTitles.count())
+    return;
+
+  // Update rows
+  const auto type = UI::Dashboard::WidgetType::Group;
+  const int first = m_scrollBar->value();
+  for (int row = 0; row < m_rowDatasets.count(); ++row)
   {
+    // Get dataset shown by the row
+    int dataset = -1;
+    if (first + row < m_order.count())
+      dataset = m_order.at(first + row);
+
+    // Row now shows another dataset, update static texts
+    if (m_rowDatasets.at(row) != dataset)
+    {
+      m_rowRevisions[row] = 0;
+      m_rowDatasets[row] = dataset;
+      if (dataset >= 0)
+      {
+        m_icons.at(row)->setText("⤑");
+        m_units.at(row)->setText(m_datasetUnits.at(dataset));
+        m_titles.at(row)->setText(m_datasetTitles.at(dataset));
+      }
+
+      else
+      {
+        m_icons.at(row)->clear();
+        m_units.at(row)->clear();
+        m_titles.at(row)->setText(QString());
+        m_values.at(row)->setText(QString());
+      }
+    }
+
+    // No dataset shown by the row
+    if (dataset < 0)
+      continue;
+
+    // Skip datasets whose displayed value did not change
+    const auto revision = dash->revision(type, m_index, dataset);
+    if (revision == m_rowRevisions.at(row))
+      continue;
+
+    m_rowRevisions[row] = revision;
+
     // Get dataset value
-    auto value = group.getDataset(i).value();
+    const auto &object = group.getDataset(dataset);
+    auto value = object.value();
 
     // Check if value is a number, if so make sure that
     // we always show a fixed number of decimal places
-    if (regex.match(value).hasMatch())
-      value = QString::number(value.toDouble(), 'f', dash->precision());
+    if (object.isNumeric())
+      value = QString::number(object.numericValue(), 'f', dash->precision());
 
     // Update label
-    if (m_values.count() > i)
-      m_values.at(i)->setText(value + " ");
+    m_values.at(row)->setText(value + " ");
   }
 
   // Repaint widget
@@ -224,50 +275,336 @@ void Widgets::DataGroup::updateData()
 }
 
 /**
- * Changes the size of the labels when the widget is resized
+ * Obtains the datasets that match the filter text & sorts them according to
+ * the selected sort order, then updates the scroll bar & the visible rows.
+ */
+void Widgets::DataGroup::updateOrder()
+{
+  // Apply filter
+  m_order.clear();
+  m_order.reserve(m_datasetTitles.count());
+  for (int i = 0; i < m_datasetTitles.count(); ++i)
+  {
+    if (m_filter.isEmpty()
+        || m_datasetTitles.at(i).contains(m_filter, Qt::CaseInsensitive))
+      m_order.append(i);
+  }
+
+  // Sort by title
+  if (m_sortOrder == SortOrder::Title)
+  {
+    std::stable_sort(m_order.begin(), m_order.end(), [=](int a, int b) {
+      return m_datasetTitles.at(a).compare(m_datasetTitles.at(b),
+                                           Qt::CaseInsensitive)
+             < 0;
+    });
+  }
+
+  // Sort by value
+  else if (m_sortOrder != SortOrder::Index)
+  {
+    auto dash = &UI::Dashboard::instance();
+    const auto &values = dash->currentFrame().values();
+    const int offset = dash->groupValueIndex(m_index);
+    if (offset >= 0 && offset + m_datasetTitles.count() <= values.count())
+    {
+      const double *data = values.constData() + offset;
+      if (m_sortOrder == SortOrder::ValueAscending)
+        std::stable_sort(m_order.begin(), m_order.end(),
+                         [=](int a, int b) { return data[a] < data[b]; });
+      else
+        std::stable_sort(m_order.begin(), m_order.end(),
+                         [=](int a, int b) { return data[a] > data[b]; });
+    }
+  }
+
+  // Update scroll bar range
+  const int rows = m_rowDatasets.count();
+  m_scrollBar->setPageStep(qMax(1, rows));
+  m_scrollBar->setRange(0, qMax(0, m_order.count() - rows));
+  m_scrollBar->setVisible(m_order.count() > rows);
+
+  // Update user interface
+  updateHeader();
+  updateRows();
+}
+
+/**
+ * Displays the sort order, the filter text & the number of datasets that
+ * match the filter in the header of the widget.
+ */
+void Widgets::DataGroup::updateHeader()
+{
+  // Header not used by small groups
+  if (!m_header || m_header->isHidden())
+    return;
+
+  // Get sort order name
+  QString order;
+  switch (m_sortOrder)
+  {
+    case SortOrder::Index:
+      order = tr("Index");
+      break;
+    case SortOrder::Title:
+      order = tr("Title");
+      break;
+    case SortOrder::ValueAscending:
+      order = tr("Value ↑");
+      break;
+    case SortOrder::ValueDescending:
+      order = tr("Value ↓");
+      break;
+  }
+
+  // Get filter text
+  QString filter = tr("type to filter");
+  if (!m_filter.isEmpty())
+    filter = tr("filter: %1").arg(m_filter);
+
+  // Update header text
+  m_header->setText(QString(" ⇅ %1  |  %2  |  %3/%4")
+                        .arg(order, filter)
+                        .arg(m_order.count())
+                        .arg(m_datasetTitles.count()));
+}
+
+/**
+ * Creates or deletes labels so that the widget displays the given number of
+ * rows, labels are only created for the rows that fit in the widget.
+ */
+void Widgets::DataGroup::setRowCount(const int count)
+{
+  // Nothing to do
+  if (count == m_rowDatasets.count())
+    return;
+
+  // Generate widget stylesheets
+  auto theme = &Misc::ThemeManager::instance();
+  auto titleQSS = QSS("color:%1", theme->widgetTextPrimary());
+  auto unitsQSS = QSS("color:%1", theme->widgetTextSecondary());
+  auto valueQSS = QSS("color:%1", theme->widgetForegroundPrimary());
+  auto iconsQSS
+      = QSS("color:%1; font-weight:600;", theme->widgetTextSecondary());
+
+  // Remove stretch from the previous last row
+  m_gridLayout->setRowStretch(m_rowDatasets.count(), 0);
+
+  // Delete rows that do not fit anymore
+  while (m_rowDatasets.count() > count)
+  {
+    delete m_icons.takeLast();
+    delete m_units.takeLast();
+    delete m_titles.takeLast();
+    delete m_values.takeLast();
+    m_rowDatasets.removeLast();
+    m_rowRevisions.removeLast();
+  }
+
+  // Create new rows
+  while (m_rowDatasets.count() < count)
+  {
+    // Create labels
+    auto units = new QLabel(m_dataContainer);
+    auto dicon = new QLabel(m_dataContainer);
+    auto title = new ElidedLabel(m_dataContainer);
+    auto value = new ElidedLabel(m_dataContainer);
+
+    // Set elide modes for title & value fields
+    title->setType(Qt::ElideRight);
+    value->setType(Qt::ElideRight);
+
+    // Set label alignments
+    units->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+    value->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    title->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    dicon->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
+
+    // Set label styles & fonts
+    value->setFont(m_valueFont);
+    title->setFont(m_font);
+    units->setFont(m_font);
+    dicon->setFont(m_iconFont);
+    title->setStyleSheet(titleQSS);
+    value->setStyleSheet(valueQSS);
+    units->setStyleSheet(unitsQSS);
+    dicon->setStyleSheet(iconsQSS);
+
+    // Add labels to grid layout
+    const int row = m_rowDatasets.count();
+    m_gridLayout->addWidget(title, row, 0);
+    m_gridLayout->addWidget(dicon, row, 1);
+    m_gridLayout->addWidget(value, row, 2);
+    m_gridLayout->addWidget(units, row, 3);
+
+    // Register row, the dataset is assigned by updateRows()
+    m_units.append(units);
+    m_icons.append(dicon);
+    m_titles.append(title);
+    m_values.append(value);
+    m_rowDatasets.append(-1);
+    m_rowRevisions.append(0);
+  }
+
+  // Keep the rows at the top of the widget
+  m_gridLayout->setRowStretch(count, 1);
+
+  // Update scroll bar range & row contents
+  updateOrder();
+}
+
+/**
+ * Changes the size of the labels when the widget is resized & calculates the
+ * number of rows that fit in the widget.
  */
 void Widgets::DataGroup::resizeEvent(QResizeEvent *event)
 {
+  // Calculate font sizes
   auto width = event->size().width();
-  QFont font = UI::Dashboard::instance().monoFont();
-  QFont icon = font;
-  QFont valueFont = font;
-  icon.setPixelSize(qMax(8, width / 16));
-  font.setPixelSize(qMax(8, width / 24));
-  valueFont.setPixelSize(font.pixelSize() * 1.3);
-
+  m_font = UI::Dashboard::instance().monoFont();
+  m_iconFont = m_font;
+  m_valueFont = m_font;
+  m_iconFont.setPixelSize(qMax(8, width / 16));
+  m_font.setPixelSize(qMax(8, width / 24));
+  m_valueFont.setPixelSize(m_font.pixelSize() * 1.3);
+
+  // Update fonts of existing rows
   for (int i = 0; i < m_titles.count(); ++i)
   {
-    m_units.at(i)->setFont(font);
-    m_icons.at(i)->setFont(icon);
-    m_titles.at(i)->setFont(font);
-    m_values.at(i)->setFont(valueFont);
+    m_units.at(i)->setFont(m_font);
+    m_icons.at(i)->setFont(m_iconFont);
+    m_titles.at(i)->setFont(m_font);
+    m_values.at(i)->setFont(m_valueFont);
+  }
+
+  // Calculate available height for the rows
+  int height = event->size().height();
+  if (m_header && !m_header->isHidden())
+  {
+    m_header->setFont(m_font);
+    height -= m_header->sizeHint().height() + m_mainLayout->spacing();
+  }
+
+  // Calculate the number of rows that fit in the widget
+  if (m_gridLayout)
+  {
+    const auto margins = m_gridLayout->contentsMargins();
+    height -= margins.top() + margins.bottom();
+    const int spacing = qMax(0, m_gridLayout->verticalSpacing());
+    const int rowHeight = QFontMetrics(m_valueFont).height() + spacing;
+    const int rows = qMax(1, (height + spacing) / qMax(1, rowHeight));
+    setRowCount(qMin(rows, m_datasetTitles.count()));
   }
 
   event->accept();
 }
 
+/**
+ * Scrolls the list when the user rotates the mouse wheel
+ */
 void Widgets::DataGroup::wheelEvent(QWheelEvent *event)
 {
-  DG_EXEC_EVENT(m_scrollArea, wheelEvent, event);
+  if (m_scrollBar)
+  {
+    const int steps = event->angleDelta().y() / 120;
+    m_scrollBar->setValue(m_scrollBar->value() - steps * WHEEL_ROWS);
+    event->accept();
+  }
 }
 
-void Widgets::DataGroup::mouseMoveEvent(QMouseEvent *event)
+/**
+ * Scrolls the list with the navigation keys & edits the filter text with the
+ * remaining keys (backspace removes a character, escape clears the filter).
+ */
+void Widgets::DataGroup::keyPressEvent(QKeyEvent *event)
 {
-  DG_EXEC_EVENT(m_scrollArea, mouseMoveEvent, event);
+  // Widget not initialized
+  if (!m_scrollBar)
+    return;
+
+  // Scroll the list
+  const int page = m_scrollBar->pageStep();
+  switch (event->key())
+  {
+    case Qt::Key_Up:
+      m_scrollBar->setValue(m_scrollBar->value() - 1);
+      return;
+    case Qt::Key_Down:
+      m_scrollBar->setValue(m_scrollBar->value() + 1);
+      return;
+    case Qt::Key_PageUp:
+      m_scrollBar->setValue(m_scrollBar->value() - page);
+      return;
+    case Qt::Key_PageDown:
+      m_scrollBar->setValue(m_scrollBar->value() + page);
+      return;
+    case Qt::Key_Home:
+      m_scrollBar->setValue(m_scrollBar->minimum());
+      return;
+    case Qt::Key_End:
+      m_scrollBar->setValue(m_scrollBar->maximum());
+      return;
+    default:
+      break;
+  }
+
+  // Filter is only available for large groups
+  if (m_header->isHidden())
+    return;
+
+  // Edit the filter text
+  const auto filter = m_filter;
+  if (event->key() == Qt::Key_Escape)
+    m_filter.clear();
+  else if (event->key() == Qt::Key_Backspace)
+    m_filter.chop(1);
+  else if (!event->text().isEmpty() && event->text().at(0).isPrint())
+    m_filter.append(event->text());
+
+  // Filter changed, show the matching datasets from the top of the list
+  if (filter != m_filter)
+  {
+    m_scrollBar->setValue(0);
+    updateOrder();
+  }
 }
 
+/**
+ * Changes the sort order when the user clicks on the header of the widget
+ */
 void Widgets::DataGroup::mousePressEvent(QMouseEvent *event)
 {
-  DG_EXEC_EVENT(m_scrollArea, mousePressEvent, event);
-}
+  // Header not used by small groups
+  if (!m_header || m_header->isHidden())
+    return;
 
-void Widgets::DataGroup::mouseReleaseEvent(QMouseEvent *event)
-{
-  DG_EXEC_EVENT(m_scrollArea, mouseReleaseEvent, event);
-}
+  // Get click position
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  const auto pos = event->position().toPoint();
+#else
+  const auto pos = event->pos();
+#endif
 
-void Widgets::DataGroup::mouseDoubleClickEvent(QMouseEvent *event)
-{
-  DG_EXEC_EVENT(m_scrollArea, mouseDoubleClickEvent, event);
+  // Select the next sort order
+  if (m_header->geometry().contains(pos))
+  {
+    switch (m_sortOrder)
+    {
+      case SortOrder::Index:
+        m_sortOrder = SortOrder::Title;
+        break;
+      case SortOrder::Title:
+        m_sortOrder = SortOrder::ValueAscending;
+        break;
+      case SortOrder::ValueAscending:
+        m_sortOrder = SortOrder::ValueDescending;
+        break;
+      case SortOrder::ValueDescending:
+        m_sortOrder = SortOrder::Index;
+        break;
+    }
+
+    updateOrder();
+    event->accept();
+  }
 }
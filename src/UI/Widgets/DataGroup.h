@@ -22,45 +22,89 @@
 
 #pragma once
 
+#include <QLabel>
+#include <QScrollBar>
 #include <QGridLayout>
+#include <QHBoxLayout>
 #include <QVBoxLayout>
-#include <QScrollArea>
 
 #include <UI/DashboardWidget.h>
 #include <UI/Widgets/Common/ElidedLabel.h>
 
 namespace Widgets
 {
+/**
+ * @brief The DataGroup class
+ *
+ * Displays the title, value & units of each dataset of a group as a list.
+ *
+ * The list is virtualized: only the rows that fit in the widget are created,
+ * and they are re-assigned to other datasets when the user scrolls, sorts or
+ * filters the list. Therefore, the cost of updating the widget depends on its
+ * size and not on the number of datasets contained by the group.
+ *
+ * Large groups display a header with the sort order (click on it to change
+ * the order) and the filter text, which is typed while the widget has focus.
+ * Sorting by value is done on the numeric value array of the frame.
+ */
 class DataGroup : public DashboardWidgetBase
 {
   Q_OBJECT
 
 public:
+  enum class SortOrder
+  {
+    Index,
+    Title,
+    ValueAscending,
+    ValueDescending
+  };
+
   DataGroup(const int index = -1);
   ~DataGroup();
 
 private Q_SLOTS:
   void updateData();
+  void updateRows();
+  void updateOrder();
+  void updateHeader();
 
 protected:
   void resizeEvent(QResizeEvent *event);
   void wheelEvent(QWheelEvent *event);
-  void mouseMoveEvent(QMouseEvent *event);
+  void keyPressEvent(QKeyEvent *event);
   void mousePressEvent(QMouseEvent *event);
-  void mouseReleaseEvent(QMouseEvent *event);
-  void mouseDoubleClickEvent(QMouseEvent *event);
+
+private:
+  void setRowCount(const int count);
 
 private:
   int m_index;
+  quint64 m_revision;
+  SortOrder m_sortOrder;
+
+  QString m_filter;
+  QStringList m_datasetTitles;
+  QStringList m_datasetUnits;
+  QVector<int> m_order;
+
+  QVector<int> m_rowDatasets;
+  QVector<quint64> m_rowRevisions;
+
+  QFont m_font;
+  QFont m_iconFont;
+  QFont m_valueFont;
 
   QVector<QLabel *> m_icons;
   QVector<QLabel *> m_units;
   QVector<ElidedLabel *> m_titles;
   QVector<ElidedLabel *> m_values;
 
+  QLabel *m_header;
+  QScrollBar *m_scrollBar;
   QWidget *m_dataContainer;
   QVBoxLayout *m_mainLayout;
+  QHBoxLayout *m_listLayout;
   QGridLayout *m_gridLayout;
-  QScrollArea *m_scrollArea;
 };
 } // namespace Widgets
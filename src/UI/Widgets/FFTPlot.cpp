@@ -19,8 +19,10 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
  * THE SOFTWARE.
  */
-
+#include <QwtPlotRenderer>
 #include <UI/Dashboard.h>
+#include <UI/FFTEngine.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 #include <UI/Widgets/FFTPlot.h>
 
@@ -28,17 +30,13 @@
  * Constructor function, configures widget style & signal/slot connections.
  */
 Widgets::FFTPlot::FFTPlot(const int index)
-  : m_size(0)
-  , m_index(index)
+  : m_index(index)
+  , m_updated(false)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
   auto theme = &Misc::ThemeManager::instance();
 
-  // Initialize pointers to NULL
-  m_fft = Q_NULLPTR;
-  m_samples = Q_NULLPTR;
-
   // Invalid index, abort initialization
   if (m_index < 0 || m_index >= dash->fftCount())
     return;
@@ -86,89 +84,76 @@ Widgets::FFTPlot::FFTPlot(const int index)
   // Set curve color & plot style
   m_curve.setPen(QColor(color), 2, Qt::SolidLine);
 
-  // Get dataset max freq. & calculate fft size
-  auto dataset = UI::Dashboard::instance().getFFT(m_index);
-  int size = qMax(8, dataset.fftSamples());
+  // Set x-scale to the frequency bins of the spectrum & autoscale y-axis
+  const auto samples = dash->getFFT(m_index).fftSamples();
+  const auto size = UI::FFTEngine::transformSize(samples);
+  m_plot.setAxisScale(QwtPlot::xBottom, 0, size / 2);
+  m_plot.setAxisAutoScale(QwtPlot::yLeft, true);
 
-  // Ensure that FFT size is valid
-  while (m_transformer.setSize(size) != QFourierTransformer::FixedSize)
-    --size;
-
-  // Set FFT size
-  m_size = size;
+  // Set axis titles
+  m_plot.setAxisTitle(QwtPlot::xBottom, tr("Frequency bin"));
+  auto title = UI::Dashboard::instance().fftTitles().at(m_index);
+  m_plot.setAxisTitle(QwtPlot::yLeft, tr("FFT of %1").arg(title));
 
-  // Initialize samples & FFT arrays
-  m_fft = (float *)calloc(m_size, sizeof(float));
-  m_samples = (float *)calloc(m_size, sizeof(float));
+  // Draw latest spectrum (if any) & replot
+  m_updated = true;
+  updateData();
 
-  // Clear Y-axis data
-  PlotData xData;
-  PlotData yData;
-  xData.reserve(m_size);
-  yData.reserve(m_size);
-  for (int i = 0; i < m_size; ++i)
-  {
-    yData.append(0);
-    xData.append(i);
-  }
+  // React to dashboard events
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
+  connect(&UI::FFTEngine::instance(), SIGNAL(spectrumUpdated(int)), this,
+          SLOT(onSpectrumUpdated(int)));
+}
 
-  // Set y-scale from -1 to 1
-  m_plot.setAxisScale(QwtPlot::yLeft, -1, 1);
+/**
+ * Draws the latest spectrum calculated by the FFT engine, the transform itself
+ * is calculated in a background thread.
+ */
+void Widgets::FFTPlot::updateData()
+{
+  TRACE_SCOPE("Widgets::FFTPlot::updateData");
 
-  // Set axis titles
-  m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
-  m_plot.setAxisTitle(QwtPlot::yLeft, tr("FFT of %1").arg(dataset.title()));
+  // Spectrum did not change since the last update
+  if (!m_updated)
+    return;
 
-  // Set curve data & replot
-  m_curve.setSamples(xData, yData);
+  // Replot
+  const auto &spectrum = UI::FFTEngine::instance().spectrum(m_index);
+  m_curve.setSamples(spectrum.constData(), spectrum.count());
   m_plot.replot();
 
-  // React to dashboard events
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  // Repaint widget
+  m_updated = false;
+  requestRepaint();
 }
 
 /**
- * Destructor function
+ * Marks the widget as dirty when the spectrum displayed by the widget is
+ * updated by the FFT engine.
  */
-Widgets::FFTPlot::~FFTPlot()
+void Widgets::FFTPlot::onSpectrumUpdated(const int index)
 {
-  free(m_fft);
-  free(m_samples);
-  m_fft = Q_NULLPTR;
-  m_samples = Q_NULLPTR;
+  if (index == m_index)
+  {
+    m_updated = true;
+    markDirty();
+  }
 }
 
 /**
- * Checks if the widget is enabled, if so, the widget shall be updated
- * to display the latest data frame.
- *
- * If the widget is disabled (e.g. the user hides it, or the external
- * window is hidden), then the new data shall be saved to the plot
- * vector, but the widget shall not be redrawn.
+ * Returns @c true, the plot is painted with a @c QwtPlotRenderer, which does
+ * not depend on paint events, so it can be rendered by a worker thread.
  */
-void Widgets::FFTPlot::updateData()
+bool Widgets::FFTPlot::supportsOffscreenRendering() const
 {
-  // Verify that FFT sample arrays are valid
-  if (!m_samples || !m_fft)
-    return;
+  return true;
+}
 
-  // Replot
-  auto plotData = UI::Dashboard::instance().fftPlotValues();
-  if (plotData.count() > m_index)
-  {
-    // Copy data to samples array
-    auto data = plotData.at(m_index);
-    for (int i = 0; i < m_size; ++i)
-      m_samples[i] = static_cast<float>(data[i]);
-
-    // Execute FFT
-    m_transformer.forwardTransform(m_samples, m_fft);
-    m_transformer.rescale(m_fft);
-    m_curve.setSamples(m_fft, m_size);
-    m_plot.replot();
-
-    // Repaint widget
-    requestRepaint();
-  }
+/**
+ * Paints the plot with the given @a painter (see @c UI::DeclarativeWidget)
+ */
+void Widgets::FFTPlot::renderOffscreen(QPainter *painter)
+{
+  QwtPlotRenderer renderer;
+  renderer.render(&m_plot, painter, m_plot.geometry());
 }
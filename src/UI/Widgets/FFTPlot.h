@@ -29,7 +29,6 @@
 #include <QwtScaleEngine>
 
 #include <UI/DashboardWidget.h>
-#include <qfouriertransformer.h>
 
 namespace Widgets
 {
@@ -39,20 +38,19 @@ class FFTPlot : public DashboardWidgetBase
 
 public:
   FFTPlot(const int index = -1);
-  ~FFTPlot();
+
+  bool supportsOffscreenRendering() const override;
+  void renderOffscreen(QPainter *painter) override;
 
 private Q_SLOTS:
   void updateData();
+  void onSpectrumUpdated(const int index);
 
 private:
-  float *m_fft;
-  float *m_samples;
-
-  int m_size;
   int m_index;
+  bool m_updated;
   QwtPlot m_plot;
   QwtPlotCurve m_curve;
   QVBoxLayout m_layout;
-  QFourierTransformer m_transformer;
 };
 } // namespace Widgets
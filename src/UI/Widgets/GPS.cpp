@@ -22,6 +22,7 @@
 
 #include <UI/Dashboard.h>
 #include <UI/Widgets/GPS.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 
 /**
@@ -29,6 +30,7 @@
  */
 Widgets::GPS::GPS(const int index)
   : m_index(index)
+  , m_revision(0)
   , m_altitude(0)
   , m_latitude(0)
   , m_longitude(0)
@@ -48,8 +50,7 @@ Widgets::GPS::GPS(const int index)
   setPalette(windowPalette);
 
   // React to Qt signals
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
 }
 
 /**
@@ -85,6 +86,8 @@ qreal Widgets::GPS::longitude() const
  */
 void Widgets::GPS::updateData()
 {
+  TRACE_SCOPE("Widgets::GPS::updateData");
+
   // Widget not enabled, do nothing
   if (!isEnabled())
     return;
@@ -94,21 +97,29 @@ void Widgets::GPS::updateData()
   if (m_index < 0 || m_index >= dash->gpsCount())
     return;
 
+  // Position did not change, skip update
+  const auto type = UI::Dashboard::WidgetType::GPS;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
   // Get group reference
-  auto group = dash->getGPS(m_index);
+  const auto &group = dash->getGPS(m_index);
 
   // Get latitiude/longitude from datasets
   m_altitude = 0, m_latitude = 0;
   m_longitude = 0;
   for (int i = 0; i < group.datasetCount(); ++i)
   {
-    auto dataset = group.getDataset(i);
+    const auto &dataset = group.getDataset(i);
     if (dataset.widget() == "lat")
-      m_latitude = dataset.value().toDouble();
+      m_latitude = dataset.numericValue();
     else if (dataset.widget() == "lon")
-      m_longitude = dataset.value().toDouble();
+      m_longitude = dataset.numericValue();
     else if (dataset.widget() == "alt")
-      m_altitude = dataset.value().toDouble();
+      m_altitude = dataset.numericValue();
   }
 
   // Update the QML user interface with the new data
@@ -42,6 +42,7 @@ private Q_SLOTS:
 
 private:
   int m_index;
+  quint64 m_revision;
   qreal m_altitude;
   qreal m_latitude;
   qreal m_longitude;
@@ -22,6 +22,7 @@
 
 #include <UI/Dashboard.h>
 #include <UI/Widgets/Gauge.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 
 /**
@@ -29,6 +30,7 @@
  */
 Widgets::Gauge::Gauge(const int index)
   : m_index(index)
+  , m_revision(0)
 {
   // Get pointers to Serial Studio modules
   auto dash = &UI::Dashboard::instance();
@@ -57,18 +59,11 @@ Widgets::Gauge::Gauge(const int index)
   auto dataset = dash->getGauge(m_index);
   m_gauge.setScale(dataset.min(), dataset.max());
 
-  // Set gauge palette
-  QPalette palette;
-  palette.setColor(QPalette::WindowText, theme->base());
-  palette.setColor(QPalette::Text, theme->widgetIndicator());
-  m_gauge.setPalette(palette);
-
   // Set widget pointer
   setWidget(&m_gauge);
 
   // React to dashboard events
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
 }
 
 /**
@@ -80,6 +75,8 @@ Widgets::Gauge::Gauge(const int index)
  */
 void Widgets::Gauge::updateData()
 {
+  TRACE_SCOPE("Widgets::Gauge::updateData");
+
   // Widget not enabled, do nothing
   if (!isEnabled())
     return;
@@ -89,11 +86,19 @@ void Widgets::Gauge::updateData()
   if (m_index < 0 || m_index >= dash->gaugeCount())
     return;
 
+  // Displayed value did not change, skip update
+  const auto type = UI::Dashboard::WidgetType::Gauge;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
   // Update gauge value
-  auto dataset = dash->getGauge(m_index);
-  m_gauge.setValue(dataset.value().toDouble());
+  const auto &dataset = dash->getGauge(m_index);
+  m_gauge.setValue(dataset.numericValue());
   setValue(QString("%1 %2").arg(
-      QString::number(dataset.value().toDouble(), 'f', dash->precision()),
+      QString::number(dataset.numericValue(), 'f', dash->precision()),
       dataset.units()));
 
   // Repaint widget
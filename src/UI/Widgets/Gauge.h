@@ -39,6 +39,7 @@ private Q_SLOTS:
 
 private:
   int m_index;
+  quint64 m_revision;
   AnalogGauge m_gauge;
 };
 } // namespace Widgets
@@ -23,8 +23,8 @@
 #include <QResizeEvent>
 
 #include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
 #include <Misc/TimerEvents.h>
-#include <Misc/ThemeManager.h>
 #include <UI/Widgets/Gyroscope.h>
 
 /**
@@ -32,22 +32,16 @@
  */
 Widgets::Gyroscope::Gyroscope(const int index)
   : m_index(index)
+  , m_revision(0)
   , m_displayNum(0)
 {
   // Get pointers to Serial Studio modules
   auto dash = &UI::Dashboard::instance();
-  auto theme = &Misc::ThemeManager::instance();
 
   // Invalid index, abort initialization
   if (m_index < 0 || m_index >= dash->gyroscopeCount())
     return;
 
-  // Set gauge palette
-  QPalette palette;
-  palette.setColor(QPalette::WindowText, theme->base());
-  palette.setColor(QPalette::Text, theme->widgetIndicator());
-  m_gauge.setPalette(palette);
-
   // Set widget pointer
   setWidget(&m_gauge);
 
@@ -58,8 +52,7 @@ Widgets::Gyroscope::Gyroscope(const int index)
   // clang-format on
 
   // React to dashboard events
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
 }
 
 /**
@@ -71,6 +64,8 @@ Widgets::Gyroscope::Gyroscope(const int index)
  */
 void Widgets::Gyroscope::updateData()
 {
+  TRACE_SCOPE("Widgets::Gyroscope::updateData");
+
   if (!isEnabled())
     return;
 
@@ -79,8 +74,16 @@ void Widgets::Gyroscope::updateData()
   if (m_index < 0 || m_index >= dash->gyroscopeCount())
     return;
 
+  // Displayed value did not change, skip update
+  const auto type = UI::Dashboard::WidgetType::Gyroscope;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
   // Get group reference & validate dataset count
-  auto group = dash->getGyroscope(m_index);
+  const auto &group = dash->getGyroscope(m_index);
   if (group.datasetCount() != 3)
     return;
 
@@ -92,13 +95,13 @@ void Widgets::Gyroscope::updateData()
   // Extract pitch, roll & yaw from group datasets
   for (int i = 0; i < 3; ++i)
   {
-    auto dataset = group.getDataset(i);
+    const auto &dataset = group.getDataset(i);
     if (dataset.widget() == "pitch")
-      p = dataset.value().toDouble();
+      p = dataset.numericValue();
     if (dataset.widget() == "roll")
-      r = dataset.value().toDouble();
+      r = dataset.numericValue();
     if (dataset.widget() == "yaw")
-      y = dataset.value().toDouble();
+      y = dataset.numericValue();
   }
 
   // Construct strings from pitch, roll & yaw
@@ -40,6 +40,7 @@ private Q_SLOTS:
 
 private:
   int m_index;
+  quint64 m_revision;
   int m_displayNum;
   QString m_yaw;
   QString m_roll;
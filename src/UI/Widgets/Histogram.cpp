@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QwtPlotRenderer>
+
+#include <QwtPlotRenderer>
+#include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
+#include <Misc/ThemeManager.h>
+#include <UI/Widgets/Histogram.h>
+
+/**
+ * Constructor function, configures widget style & signal/slot connections.
+ */
+Widgets::Histogram::Histogram(const int index)
+  : m_index(index)
+  , m_revision(0)
+{
+  // Get pointers to serial studio modules
+  auto dash = &UI::Dashboard::instance();
+  auto theme = &Misc::ThemeManager::instance();
+
+  // Invalid index, abort initialization
+  if (m_index < 0 || m_index >= dash->histogramCount())
+    return;
+
+  // Set window palette
+  QPalette palette;
+  palette.setColor(QPalette::Base, theme->widgetWindowBackground());
+  palette.setColor(QPalette::Window, theme->widgetWindowBackground());
+  setPalette(palette);
+
+  // Set plot palette
+  palette.setColor(QPalette::Base, theme->base());
+  palette.setColor(QPalette::Highlight, QColor(255, 0, 0));
+  palette.setColor(QPalette::Text, theme->widgetIndicator());
+  palette.setColor(QPalette::Dark, theme->widgetIndicator());
+  palette.setColor(QPalette::Light, theme->widgetIndicator());
+  palette.setColor(QPalette::ButtonText, theme->widgetIndicator());
+  palette.setColor(QPalette::WindowText, theme->widgetIndicator());
+  m_plot.setPalette(palette);
+  m_plot.setCanvasBackground(theme->base());
+  m_plot.setFrameStyle(QFrame::Plain);
+
+  // Configure layout
+  m_layout.addWidget(&m_plot);
+  m_layout.setContentsMargins(24, 24, 24, 24);
+  setLayout(&m_layout);
+
+  // Get histogram color
+  QString color;
+  const StringList colors = theme->widgetColors();
+  if (colors.count() > m_index)
+    color = colors.at(m_index);
+  else
+    color = colors.at(colors.count() % m_index);
+
+  // Configure histogram style
+  QColor fill(color);
+  fill.setAlpha(160);
+  m_histogram.setPen(QColor(color), 1);
+  m_histogram.setBrush(fill);
+  m_histogram.setStyle(QwtPlotHistogram::Columns);
+  m_histogram.attach(&m_plot);
+
+  // Autoscale both axes, the range of adaptive histograms changes over time
+  m_plot.setAxisAutoScale(QwtPlot::xBottom, true);
+  m_plot.setAxisAutoScale(QwtPlot::yLeft, true);
+
+  // Set axis titles
+  const auto &dataset = dash->getHistogram(m_index);
+  auto title = dataset.title();
+  if (!dataset.units().isEmpty())
+    title = QStringLiteral("%1 (%2)").arg(title, dataset.units());
+
+  m_plot.setAxisTitle(QwtPlot::xBottom, title);
+  m_plot.setAxisTitle(QwtPlot::yLeft, tr("Samples"));
+  m_plot.replot();
+  m_plot.show();
+
+  // React to dashboard events
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
+}
+
+/**
+ * Copies the bins of the histogram computed by the dashboard to the plot if
+ * new samples were registered since the last update.
+ */
+void Widgets::Histogram::updateData()
+{
+  TRACE_SCOPE("Widgets::Histogram::updateData");
+
+  // Widget not enabled, do nothing
+  if (!isEnabled())
+    return;
+
+  // Invalid index, abort update
+  auto dash = &UI::Dashboard::instance();
+  if (m_index < 0 || m_index >= dash->histograms().count())
+    return;
+
+  // Histogram did not change since the last update
+  const auto &histogram = dash->histograms().at(m_index);
+  if (histogram.revision() == m_revision)
+    return;
+
+  m_revision = histogram.revision();
+
+  // Update the bins
+  const auto &counts = histogram.counts();
+  const auto lower = histogram.lowerBound();
+  const auto width = histogram.binWidth();
+  m_samples.resize(counts.count());
+  for (int i = 0; i < counts.count(); ++i)
+  {
+    const double min = lower + width * i;
+    m_samples[i] = QwtIntervalSample(counts.at(i), min, min + width);
+  }
+
+  // Replot
+  m_histogram.setSamples(m_samples);
+  m_plot.replot();
+
+  // Repaint widget
+  requestRepaint();
+}
+
+/**
+ * Returns @c true, the plot is painted with a @c QwtPlotRenderer, which does
+ * not depend on paint events, so it can be rendered by a worker thread.
+ */
+bool Widgets::Histogram::supportsOffscreenRendering() const
+{
+  return true;
+}
+
+/**
+ * Paints the plot with the given @a painter (see @c UI::DeclarativeWidget)
+ */
+void Widgets::Histogram::renderOffscreen(QPainter *painter)
+{
+  QwtPlotRenderer renderer;
+  renderer.render(&m_plot, painter, m_plot.geometry());
+}
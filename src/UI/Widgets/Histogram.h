@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QWidget>
+#include <QwtPlot>
+#include <QVBoxLayout>
+#include <QwtPlotHistogram>
+
+#include <UI/DashboardWidget.h>
+
+namespace Widgets
+{
+/**
+ * @brief The Histogram class
+ *
+ * Displays the distribution of the latest values of a dataset. The bins are
+ * updated by the dashboard as frames arrive (see @c UI::Histogram), the
+ * widget only copies the bin counts when they change, which costs O(bins)
+ * per repaint regardless of the number of points.
+ */
+class Histogram : public DashboardWidgetBase
+{
+  Q_OBJECT
+
+public:
+  Histogram(const int index = -1);
+
+  bool supportsOffscreenRendering() const override;
+  void renderOffscreen(QPainter *painter) override;
+
+private Q_SLOTS:
+  void updateData();
+
+private:
+  int m_index;
+  quint64 m_revision;
+  QwtPlot m_plot;
+  QVBoxLayout m_layout;
+  QwtPlotHistogram m_histogram;
+  QVector<QwtIntervalSample> m_samples;
+};
+} // namespace Widgets
@@ -23,6 +23,7 @@
 #include <QResizeEvent>
 
 #include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 #include <UI/Widgets/LEDPanel.h>
 
@@ -31,6 +32,7 @@
  */
 Widgets::LEDPanel::LEDPanel(const int index)
   : m_index(index)
+  , m_revision(0)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
@@ -120,8 +122,7 @@ Widgets::LEDPanel::LEDPanel(const int index)
   setLayout(m_mainLayout);
 
   // React to dashboard events
-  connect(dash, SIGNAL(updated()), this, SLOT(updateData()),
-          Qt::QueuedConnection);
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
 }
 
 /**
@@ -149,6 +150,8 @@ Widgets::LEDPanel::~LEDPanel()
  */
 void Widgets::LEDPanel::updateData()
 {
+  TRACE_SCOPE("Widgets::LEDPanel::updateData");
+
   // Widget not enabled, do nothing
   if (!isEnabled())
     return;
@@ -158,8 +161,16 @@ void Widgets::LEDPanel::updateData()
   if (m_index < 0 || m_index >= dash->ledCount())
     return;
 
+  // Displayed value did not change, skip update
+  const auto type = UI::Dashboard::WidgetType::LED;
+  const auto revision = dash->revision(type, m_index);
+  if (revision == m_revision)
+    return;
+
+  m_revision = revision;
+
   // Get group pointer
-  auto group = dash->getLED(m_index);
+  const auto &group = dash->getLED(m_index);
 
   // Update labels
   for (int i = 0; i < group.datasetCount(); ++i)
@@ -169,7 +180,7 @@ void Widgets::LEDPanel::updateData()
       break;
 
     // Get dataset value (we compare with 0.1 for low voltages)
-    auto value = group.getDataset(i).value().toDouble();
+    auto value = group.getDataset(i).numericValue();
     if (qAbs(value) < 0.10)
       m_leds.at(i)->off();
     else
@@ -48,6 +48,7 @@ protected:
 
 private:
   int m_index;
+  quint64 m_revision;
 
   QVector<KLed *> m_leds;
   QVector<QLabel *> m_titles;
@@ -20,10 +20,14 @@
  * THE SOFTWARE.
  */
 
+#include <QwtPlotRenderer>
 #include <CSV/Player.h>
+#include <CSV/Reference.h>
 #include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
 #include <UI/Widgets/MultiPlot.h>
+#include <UI/Widgets/Common/PlotSeries.h>
 
 /**
  * Constructor function, configures widget style & signal/slot connections.
@@ -93,14 +97,24 @@ Widgets::MultiPlot::MultiPlot(const int index)
     curve->setPen(QColor(color), 2, Qt::SolidLine);
     curve->attach(&m_plot);
 
-    // Register curve
+    // Create the ghost curve of the reference recording
+    QColor ghost(color);
+    ghost.setAlpha(110);
+    auto reference = new QwtPlotCurve(title);
+    reference->setPen(ghost, 2, Qt::DashLine);
+    reference->setItemAttribute(QwtPlotItem::Legend, false);
+    reference->setZ(curve->z() - 1);
+    reference->setVisible(false);
+    reference->attach(&m_plot);
+
+    // Register curves
     m_curves.append(curve);
+    m_references.append(reference);
   }
 
   // Add plot legend to display curve names
   m_legend.setFrameStyle(QFrame::Plain);
   m_plot.setAxisTitle(QwtPlot::yLeft, group.title());
-  m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
   m_plot.insertLegend(&m_legend, QwtPlot::BottomLegend);
 
   // Normalize data curves
@@ -114,79 +128,64 @@ Widgets::MultiPlot::MultiPlot(const int index)
 
   // React to dashboard events
   // clang-format off
-    connect(dash, SIGNAL(updated()),
-            this, SLOT(updateData()),
-            Qt::QueuedConnection);
+    connect(this, SIGNAL(refreshRequested()),
+            this, SLOT(updateData()));
     connect(dash, SIGNAL(pointsChanged()),
             this, SLOT(updateRange()),
             Qt::QueuedConnection);
+    connect(dash, SIGNAL(timeWindowChanged()),
+            this, SLOT(updateRange()),
+            Qt::QueuedConnection);
   // clang-format on
 }
 
 /**
- * Checks if the widget is enabled, if so, the widget shall be updated
- * to display the latest data frame.
+ * Checks if the widget is enabled, if so, the widget shall be redrawn to
+ * display the latest data, this function is called at most once per tick of
+ * the render timer.
  *
  * If the widget is disabled (e.g. the user hides it, or the external
- * window is hidden), then the new data shall be saved to the plot
- * vectors, but the widget shall not be redrawn.
+ * window is hidden), the dashboard keeps recording the plot history, but
+ * the widget shall not be redrawn.
  */
 void Widgets::MultiPlot::updateData()
 {
-  // Invalid index, abort update
-  auto dash = &UI::Dashboard::instance();
-  if (m_index < 0 || m_index >= dash->multiPlotCount())
-    return;
+  TRACE_SCOPE("Widgets::MultiPlot::updateData");
 
-  // Get group
-  auto group = dash->getMultiplot(m_index);
-
-  // Plot each dataset
-  for (int i = 0; i < group.datasetCount(); ++i)
+  // Plot widget again
+  if (isEnabled())
   {
-    // Check vector size
-    if (m_yData.count() < i)
-      break;
-
-    // Get dataset
-    auto dataset = group.getDataset(i);
-
-    // Add point to plot data
-    auto data = m_yData[i].data();
-    auto count = m_yData[i].count();
-    memmove(data, data + 1, count * sizeof(double));
-
-    // Normalize dataset value
-    if (dataset.max() > dataset.min())
+    // Decimate the plot history to the width of the plot, displaying the
+    // period selected by the user if the dashboard view is paused
+    const auto end = UI::Dashboard::instance().viewEndTime();
+    for (int i = 0; i < m_series.count(); ++i)
     {
-      auto vmin = dataset.min();
-      auto vmax = dataset.max();
-      auto v = dataset.value().toDouble();
-      m_yData[i][count - 1] = (v - vmin) / (vmax - vmin);
+      m_series.at(i)->setEndTime(end);
+      m_series.at(i)->setColumns(m_plot.canvas()->width());
+      m_series.at(i)->update();
     }
 
-    // Plot dataset value directly
-    else
-      m_yData[i][count - 1] = dataset.value().toDouble();
+    // Update the ghost curves of the reference recording
+    const bool reference = CSV::Reference::instance().isOpen();
+    for (int i = 0; i < m_references.count(); ++i)
+      m_references.at(i)->setVisible(reference);
 
-    // Widget not enabled, do not redraw
-    if (!isEnabled())
-      continue;
-
-    // Plot new data
-    m_curves.at(i)->setSamples(m_yData[i]);
-  }
+    for (int i = 0; reference && i < m_referenceSeries.count(); ++i)
+    {
+      m_referenceSeries.at(i)->setEndTime(end);
+      m_referenceSeries.at(i)->setColumns(m_plot.canvas()->width());
+      m_referenceSeries.at(i)->update();
+    }
 
-  // Plot widget again
-  if (isEnabled())
-  {
     m_plot.replot();
     requestRepaint();
   }
 }
 
 /**
- * Updates the number of horizontal divisions of the plot
+ * Updates the number of horizontal divisions of the plot, and configures the
+ * X-axis to display either the sample index or the time window selected by
+ * the user.
  */
 void Widgets::MultiPlot::updateRange()
 {
@@ -195,21 +194,66 @@ void Widgets::MultiPlot::updateRange()
   if (m_index < 0 || m_index >= dash->multiPlotCount())
     return;
 
-  // Set number of points
-  m_yData.clear();
-  auto group = UI::Dashboard::instance().getMultiplot(m_index);
+  // Create curves from the plot history of the dashboard, datasets with a
+  // valid range are normalized when drawn. Each curve takes ownership of its
+  // series.
+  m_series.clear();
+  m_referenceSeries.clear();
+  const auto window = dash->timeWindow();
+  const auto &group = dash->getMultiplot(m_index);
   for (int i = 0; i < group.datasetCount(); ++i)
   {
-    m_yData.append(PlotData());
-    m_yData.last().resize(dash->points());
-    std::fill(m_yData.last().begin(), m_yData.last().end(), 0.0001);
+    if (m_curves.count() > i)
+    {
+      const auto &dataset = group.getDataset(i);
+      const auto index = dash->multiPlotHistoryIndex(m_index, i);
+      auto series = new PlotSeries(&dash->plotHistory(), index);
+      series->setNormalization(dataset.min(), dataset.max());
+      series->setTimeWindow(window * 1000000LL);
+      m_curves.at(i)->setData(series);
+      m_series.append(series);
+
+      // Read the values of the reference recording
+      auto ghost = new PlotSeries(&dash->referenceHistory(), index);
+      ghost->setNormalization(dataset.min(), dataset.max());
+      ghost->setTimeOrigin(&dash->plotHistory(), index);
+      ghost->setTimeWindow(window * 1000000LL);
+      m_references.at(i)->setData(ghost);
+      m_referenceSeries.append(ghost);
+    }
   }
 
-  // Create curve from data
-  for (int i = 0; i < group.datasetCount(); ++i)
-    if (m_curves.count() > i)
-      m_curves.at(i)->setSamples(dash->xPlotValues(), m_yData[i]);
+  // Configure the X-axis
+  if (window > 0)
+  {
+    m_plot.setAxisScale(QwtPlot::xBottom, -window, 0);
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Time (s)"));
+  }
+  else
+  {
+    m_plot.setAxisAutoScale(QwtPlot::xBottom);
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
+  }
 
   // Repaint widget
   requestRepaint();
 }
+
+/**
+ * Returns @c true, the plot is painted with a @c QwtPlotRenderer, which does
+ * not depend on paint events, so it can be rendered by a worker thread.
+ */
+bool Widgets::MultiPlot::supportsOffscreenRendering() const
+{
+  return true;
+}
+
+/**
+ * Paints the plot and its legend with the given @a painter (see
+ * @c UI::DeclarativeWidget)
+ */
+void Widgets::MultiPlot::renderOffscreen(QPainter *painter)
+{
+  QwtPlotRenderer renderer;
+  renderer.render(&m_plot, painter, m_plot.geometry());
+}
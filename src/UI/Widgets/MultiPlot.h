@@ -34,6 +34,7 @@
 
 namespace Widgets
 {
+class PlotSeries;
 class MultiPlot : public DashboardWidgetBase
 {
   Q_OBJECT
@@ -41,6 +42,9 @@ class MultiPlot : public DashboardWidgetBase
 public:
   MultiPlot(const int index = -1);
 
+  bool supportsOffscreenRendering() const override;
+  void renderOffscreen(QPainter *painter) override;
+
 private Q_SLOTS:
   void updateData();
   void updateRange();
@@ -51,6 +55,8 @@ private:
   QwtLegend m_legend;
   QVBoxLayout m_layout;
   QVector<QwtPlotCurve *> m_curves;
-  QVector<PlotData> m_yData;
+  QVector<PlotSeries *> m_series;
+  QVector<QwtPlotCurve *> m_references;
+  QVector<PlotSeries *> m_referenceSeries;
 };
 } // namespace Widgets
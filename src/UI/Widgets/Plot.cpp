@@ -20,10 +20,45 @@
  * THE SOFTWARE.
  */
 
+#include <QwtPlotRenderer>
+#include <QWheelEvent>
 #include <CSV/Player.h>
+#include <CSV/Reference.h>
 #include <UI/Dashboard.h>
 #include <UI/Widgets/Plot.h>
+#include <Misc/Tracer.h>
 #include <Misc/ThemeManager.h>
+#include <UI/Widgets/Common/PlotSeries.h>
+
+/**
+ * Plot renderer that remembers the canvas rectangle & the scale maps that it
+ * used to draw the plot, so that the curves can be drawn again over a cached
+ * image of the axes, grid & canvas background.
+ */
+class CanvasRenderer : public QwtPlotRenderer
+{
+public:
+  CanvasRenderer(QRectF *canvasRect, QwtScaleMap *maps)
+    : m_canvasRect(canvasRect)
+    , m_maps(maps)
+  {
+  }
+
+  void renderCanvas(const QwtPlot *plot, QPainter *painter,
+                    const QRectF &canvasRect,
+                    const QwtScaleMap *maps) const override
+  {
+    *m_canvasRect = canvasRect;
+    for (int axis = 0; axis < QwtAxis::AxisPositions; ++axis)
+      m_maps[axis] = maps[axis];
+
+    QwtPlotRenderer::renderCanvas(plot, painter, canvasRect, maps);
+  }
+
+private:
+  QRectF *m_canvasRect;
+  QwtScaleMap *m_maps;
+};
 
 /**
  * Constructor function, configures widget style & signal/slot connections.
@@ -33,6 +68,10 @@ Widgets::Plot::Plot(const int index)
   , m_min(INT_MAX)
   , m_max(INT_MIN)
   , m_autoscale(true)
+  , m_span(0)
+  , m_series(Q_NULLPTR)
+  , m_referenceSeries(Q_NULLPTR)
+  , m_backgroundDirty(true)
 {
   // Get pointers to serial studio modules
   auto dash = &UI::Dashboard::instance();
@@ -71,6 +110,7 @@ Widgets::Plot::Plot(const int index)
 
   // Create curve from data
   updateRange();
+  m_reference.attach(&m_plot);
   m_curve.attach(&m_plot);
   m_plot.replot();
   m_plot.show();
@@ -92,6 +132,13 @@ Widgets::Plot::Plot(const int index)
   // Set curve color & plot style
   m_curve.setPen(QColor(color), 2, Qt::SolidLine);
 
+  // Draw the values of the reference recording as a translucent ghost curve
+  QColor ghost(color);
+  ghost.setAlpha(110);
+  m_reference.setPen(ghost, 2, Qt::DashLine);
+  m_reference.setZ(m_curve.z() - 1);
+  m_reference.setVisible(false);
+
   // Update graph scale
   auto dataset = UI::Dashboard::instance().getPlot(m_index);
   auto max = dataset.max();
@@ -112,17 +159,20 @@ Widgets::Plot::Plot(const int index)
   // clang-format on
 
   // Set axis titles
-  m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
-  m_plot.setAxisTitle(QwtPlot::yLeft, dataset.title());
+  m_plot.setAxisTitle(QwtPlot::yLeft,
+                      UI::Dashboard::instance().plotTitles().at(m_index));
+  m_backgroundDirty = true;
 
   // React to dashboard events
   // clang-format off
-    connect(dash, SIGNAL(updated()),
-            this, SLOT(updateData()),
-            Qt::QueuedConnection);
+    connect(this, SIGNAL(refreshRequested()),
+            this, SLOT(updateData()));
     connect(dash, SIGNAL(pointsChanged()),
             this, SLOT(updateRange()),
             Qt::QueuedConnection);
+    connect(dash, SIGNAL(timeWindowChanged()),
+            this, SLOT(updateRange()),
+            Qt::QueuedConnection);
   // clang-format on
 }
 
@@ -136,33 +186,51 @@ Widgets::Plot::Plot(const int index)
  */
 void Widgets::Plot::updateData()
 {
+  TRACE_SCOPE("Widgets::Plot::updateData");
+
   // Widget not enabled, do not redraw
   if (!isEnabled())
     return;
 
   // Get new data
-  auto plotData = UI::Dashboard::instance().linearPlotValues();
-  if (plotData.count() > m_index)
+  if (m_series)
   {
+    // Decimate the plot history to the width of the plot, displaying the
+    // period selected by the user if the dashboard view is paused
+    const auto end = UI::Dashboard::instance().viewEndTime();
+    m_series->setEndTime(end);
+    m_series->setColumns(m_plot.canvas()->width());
+    m_series->update();
+
+    // Update the ghost curve of the reference recording
+    const bool reference = CSV::Reference::instance().isOpen();
+    m_reference.setVisible(reference);
+    if (reference && m_referenceSeries)
+    {
+      m_referenceSeries->setEndTime(end);
+      m_referenceSeries->setColumns(m_plot.canvas()->width());
+      m_referenceSeries->update();
+    }
+
     // Check if we need to update graph scale
     if (m_autoscale)
     {
-      // Scan new values to see if chart should be updated
+      // Check the extremes of the series to see if chart should be updated
       bool changed = false;
-      for (int i = 0; i < plotData.at(m_index).count(); ++i)
+      auto rect = m_series->boundingRect();
+      if (reference && m_referenceSeries && m_referenceSeries->size() > 0)
+        rect |= m_referenceSeries->boundingRect();
+
+      if (rect.bottom() > m_max)
       {
-        auto v = plotData.at(m_index).at(i);
-        if (v > m_max)
-        {
-          m_max = v + 1;
-          changed = true;
-        }
+        m_max = rect.bottom() + 1;
+        changed = true;
+      }
 
-        if (v < m_min)
-        {
-          m_min = v - 1;
-          changed = true;
-        }
+      if (rect.top() < m_min)
+      {
+        m_min = rect.top() - 1;
+        changed = true;
       }
 
       // Update graph scale
@@ -203,7 +271,6 @@ void Widgets::Plot::updateData()
     }
 
     // Replot graph
-    m_curve.setSamples(plotData.at(m_index));
     m_plot.replot();
 
     // Repaint widget
@@ -212,23 +279,220 @@ void Widgets::Plot::updateData()
 }
 
 /**
- * Updates the number of horizontal divisions of the plot
+ * Updates the number of horizontal divisions of the plot, and configures the
+ * X-axis to display either the sample index or the time window selected by
+ * the user.
  */
 void Widgets::Plot::updateRange()
 {
   // Get pointer to dashboard manager
   auto dash = &UI::Dashboard::instance();
 
-  // Clear Y-axis data
-  PlotData tempYData;
-  tempYData.reserve(dash->points());
-  for (int i = 0; i < dash->points(); ++i)
-    tempYData.append(0);
+  // Read samples from the plot history of the dashboard, the curve takes
+  // ownership of the series
+  const auto window = dash->timeWindow();
+  const auto index = dash->plotHistoryIndex(m_index);
+  m_series = new PlotSeries(&dash->plotHistory(), index);
+  m_series->setTimeWindow(window * 1000000LL);
+  m_series->setSpan(m_span);
+  m_curve.setData(m_series);
+
+  // Read the values of the reference recording, aligned with the live data
+  m_referenceSeries = new PlotSeries(&dash->referenceHistory(), index);
+  m_referenceSeries->setTimeOrigin(&dash->plotHistory(), index);
+  m_referenceSeries->setTimeWindow(window * 1000000LL);
+  m_referenceSeries->setSpan(m_span);
+  m_reference.setData(m_referenceSeries);
+
+  // Configure the X-axis
+  if (window > 0)
+  {
+    m_plot.setAxisScale(QwtPlot::xBottom, -window, 0);
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Time (s)"));
+  }
+  else
+  {
+    m_plot.setAxisAutoScale(QwtPlot::xBottom);
+    m_plot.setAxisTitle(QwtPlot::xBottom, tr("Samples"));
+  }
+
+  // Axis titles changed, render the axes again
+  m_backgroundDirty = true;
 
-  // Redraw graph
-  m_curve.setSamples(dash->xPlotValues(), tempYData);
+  // Redraw the plot
   m_plot.replot();
 
   // Repaint widget
   requestRepaint();
 }
+
+/**
+ * Zooms the plot in or out over the long-term plot history, each step of the
+ * mouse wheel doubles (or halves) the number of displayed samples. The plot
+ * never displays less samples than the number of points of its dataset, or
+ * more samples than the ones received since the project was loaded.
+ *
+ * Zooming is disabled while the plot displays a time window.
+ */
+void Widgets::Plot::wheelEvent(QWheelEvent *event)
+{
+  // Get plot history
+  auto dash = &UI::Dashboard::instance();
+  const auto &history = dash->plotHistory();
+  const auto index = dash->plotHistoryIndex(m_index);
+  if (!m_series || index < 0 || index >= history.count())
+    return;
+
+  // Time window selected, the user must change it to zoom
+  if (m_series->timeWindow() > 0)
+    return;
+
+  // Calculate new span
+  const auto points = static_cast<quint64>(history.at(index).recent().size());
+  const auto limit = qMax(points, history.at(index).count());
+  auto span = qMax(m_span, points);
+  if (event->angleDelta().y() > 0)
+    span /= 2;
+  else if (event->angleDelta().y() < 0)
+    span *= 2;
+
+  // Update series & redraw the plot
+  span = qBound(points, span, limit);
+  m_span = span > points ? span : 0;
+  m_series->setSpan(m_span);
+  if (m_referenceSeries)
+    m_referenceSeries->setSpan(m_span);
+
+  event->accept();
+  updateData();
+}
+
+/**
+ * Restores the default zoom level (the number of points selected by the user)
+ */
+void Widgets::Plot::mouseDoubleClickEvent(QMouseEvent *event)
+{
+  m_span = 0;
+  if (m_series)
+    m_series->setSpan(0);
+  if (m_referenceSeries)
+    m_referenceSeries->setSpan(0);
+
+  event->accept();
+  updateData();
+}
+
+/**
+ * Returns @c true, the plot is painted with a @c QwtPlotRenderer, which does
+ * not depend on paint events, so it can be rendered by a worker thread.
+ */
+bool Widgets::Plot::supportsOffscreenRendering() const
+{
+  return true;
+}
+
+/**
+ * Paints the plot with the given @a painter (see @c UI::DeclarativeWidget).
+ *
+ * The axes, titles & canvas background only change when the scale of the plot
+ * changes, so they are rendered once into a cached image. Every other frame
+ * only draws the cached image and the curves over it.
+ */
+void Widgets::Plot::renderOffscreen(QPainter *painter)
+{
+  // Get pixel ratio of the target image
+  qreal ratio = 1;
+  if (painter->device())
+    ratio = painter->device()->devicePixelRatioF();
+
+  // Render the static layer of the plot again if needed
+  if (!backgroundValid(ratio))
+    renderBackground(ratio);
+
+  // Draw the cached axes & canvas background
+  const QPoint origin = m_plot.geometry().topLeft();
+  painter->drawImage(origin, m_background);
+
+  // Get the area of the canvas inside its frame
+  double frameWidth = 0;
+  const QVariant fw = m_plot.canvas()->property("frameWidth");
+  if (fw.canConvert<double>())
+    frameWidth = fw.value<double>();
+
+  // Draw the curves over the canvas
+  painter->save();
+  painter->translate(origin);
+  painter->setClipRect(m_canvasRect.adjusted(frameWidth, frameWidth,
+                                             -frameWidth, -frameWidth));
+  for (QwtPlotCurve *curve : {&m_reference, &m_curve})
+  {
+    if (!curve->isVisible())
+      continue;
+
+    painter->save();
+    painter->setRenderHint(
+        QPainter::Antialiasing,
+        curve->testRenderHint(QwtPlotItem::RenderAntialiased));
+    curve->draw(painter, m_maps[curve->xAxis()], m_maps[curve->yAxis()],
+                m_canvasRect);
+    painter->restore();
+  }
+  painter->restore();
+}
+
+/**
+ * Returns @c true if the cached image of the axes & canvas background can be
+ * used to render the current frame, that is, if the size of the plot, the
+ * pixel @a ratio & the scale divisions of both axes did not change since it
+ * was rendered.
+ */
+bool Widgets::Plot::backgroundValid(const qreal ratio) const
+{
+  if (m_backgroundDirty || m_background.isNull())
+    return false;
+
+  if (m_background.size() != m_plot.size() * ratio)
+    return false;
+
+  if (m_xScale != m_plot.axisScaleDiv(QwtPlot::xBottom))
+    return false;
+
+  if (m_yScale != m_plot.axisScaleDiv(QwtPlot::yLeft))
+    return false;
+
+  return true;
+}
+
+/**
+ * Renders the plot without its curves into the cached background image,
+ * using the given pixel @a ratio.
+ */
+void Widgets::Plot::renderBackground(const qreal ratio)
+{
+  // Allocate the image in device pixels
+  m_background = QImage(m_plot.size() * ratio,
+                        QImage::Format_ARGB32_Premultiplied);
+  m_background.setDevicePixelRatio(ratio);
+  m_background.fill(Qt::transparent);
+
+  // Hide the curves while rendering the static layer
+  const bool curveVisible = m_curve.isVisible();
+  const bool referenceVisible = m_reference.isVisible();
+  m_curve.setVisible(false);
+  m_reference.setVisible(false);
+
+  // Render the axes & canvas, storing the canvas geometry & scale maps
+  QPainter background(&m_background);
+  CanvasRenderer renderer(&m_canvasRect, m_maps);
+  renderer.render(&m_plot, &background, QRectF(QPointF(0, 0), m_plot.size()));
+  background.end();
+
+  // Restore the curves
+  m_curve.setVisible(curveVisible);
+  m_reference.setVisible(referenceVisible);
+
+  // Remember the scale that was used to render the image
+  m_xScale = m_plot.axisScaleDiv(QwtPlot::xBottom);
+  m_yScale = m_plot.axisScaleDiv(QwtPlot::yLeft);
+  m_backgroundDirty = false;
+}
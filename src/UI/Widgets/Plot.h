@@ -22,8 +22,12 @@
 
 #pragma once
 
+#include <QImage>
+#include <QwtAxis>
 #include <QwtPlot>
 #include <QWidget>
+#include <QwtScaleDiv>
+#include <QwtScaleMap>
 #include <QVBoxLayout>
 #include <QwtPlotCurve>
 #include <QwtScaleEngine>
@@ -31,6 +35,7 @@
 
 namespace Widgets
 {
+class PlotSeries;
 class Plot : public DashboardWidgetBase
 {
   Q_OBJECT
@@ -38,18 +43,40 @@ class Plot : public DashboardWidgetBase
 public:
   Plot(const int index = -1);
 
+  bool supportsOffscreenRendering() const override;
+  void renderOffscreen(QPainter *painter) override;
+
+protected:
+  void wheelEvent(QWheelEvent *event) override;
+  void mouseDoubleClickEvent(QMouseEvent *event) override;
+
 private Q_SLOTS:
   void updateData();
   void updateRange();
 
+private:
+  bool backgroundValid(const qreal ratio) const;
+  void renderBackground(const qreal ratio);
+
 private:
   int m_index;
   double m_min;
   double m_max;
   bool m_autoscale;
+  quint64 m_span;
 
   QwtPlot m_plot;
   QwtPlotCurve m_curve;
+  QwtPlotCurve m_reference;
   QVBoxLayout m_layout;
+  PlotSeries *m_series;
+  PlotSeries *m_referenceSeries;
+
+  QImage m_background;
+  QRectF m_canvasRect;
+  QwtScaleDiv m_xScale;
+  QwtScaleDiv m_yScale;
+  bool m_backgroundDirty;
+  QwtScaleMap m_maps[QwtAxis::AxisPositions];
 };
 } // namespace Widgets
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtNumeric>
+#include <QMouseEvent>
+#include <QResizeEvent>
+
+#include <UI/Dashboard.h>
+#include <Misc/Tracer.h>
+#include <Misc/ThemeManager.h>
+#include <UI/Widgets/Statistics.h>
+
+/**
+ * Number of statistics displayed for each dataset
+ */
+static const int COLUMN_COUNT = 5;
+
+/**
+ * Generates the user interface elements & layout
+ */
+Widgets::Statistics::Statistics(const int index)
+  : m_index(index)
+  , m_session(false)
+  , m_header(Q_NULLPTR)
+  , m_dataContainer(Q_NULLPTR)
+  , m_mainLayout(Q_NULLPTR)
+  , m_gridLayout(Q_NULLPTR)
+{
+  // Get pointers to serial studio modules
+  auto dash = &UI::Dashboard::instance();
+  auto theme = &Misc::ThemeManager::instance();
+
+  // Invalid index, abort initialization
+  if (m_index < 0 || m_index >= dash->statisticsCount())
+    return;
+
+  // Set window palette
+  QPalette windowPalette;
+  windowPalette.setColor(QPalette::Base, theme->widgetWindowBackground());
+  windowPalette.setColor(QPalette::Window, theme->widgetWindowBackground());
+  setPalette(windowPalette);
+
+  // Generate widget stylesheets
+  const auto font = dash->monoFont();
+  auto titleQSS = QSS("color:%1", theme->widgetTextPrimary());
+  auto valueQSS = QSS("color:%1", theme->widgetForegroundPrimary());
+  auto headerQSS = QSS("color:%1", theme->widgetTextSecondary());
+
+  // Configure the header
+  m_header = new QLabel(this);
+  m_header->setFont(font);
+  m_header->setStyleSheet(headerQSS);
+  m_header->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+
+  // Configure the table
+  m_dataContainer = new QWidget(this);
+  m_gridLayout = new QGridLayout(m_dataContainer);
+  m_gridLayout->setColumnStretch(0, 2);
+  m_dataContainer->setLayout(m_gridLayout);
+
+  // Create the column titles
+  const QStringList columns
+      = {tr("Min"), tr("Max"), tr("Mean"), tr("σ"), tr("RMS")};
+  for (int i = 0; i < COLUMN_COUNT; ++i)
+  {
+    auto label = new QLabel(columns.at(i), m_dataContainer);
+    label->setFont(font);
+    label->setStyleSheet(headerQSS);
+    label->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    m_gridLayout->setColumnStretch(i + 1, 1);
+    m_gridLayout->addWidget(label, 0, i + 1);
+    m_columns.append(label);
+  }
+
+  // Create a row for each dataset
+  const auto &group = dash->getStatistics(m_index);
+  const int offset = dash->statisticsValueIndex(m_index);
+  for (int i = 0; i < group.datasetCount(); ++i)
+  {
+    // Create the title label
+    const auto &dataset = group.getDataset(i);
+    auto title = new ElidedLabel(m_dataContainer);
+    title->setFont(font);
+    title->setStyleSheet(titleQSS);
+    title->setType(Qt::ElideRight);
+    title->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+    if (dataset.units().isEmpty())
+      title->setText(dataset.title());
+    else
+      title->setText(QString("%1 [%2]").arg(dataset.title(), dataset.units()));
+
+    m_gridLayout->addWidget(title, i + 1, 0);
+
+    // Create the value labels
+    QVector<QLabel *> values;
+    for (int j = 0; j < COLUMN_COUNT; ++j)
+    {
+      auto value = new QLabel(m_dataContainer);
+      value->setFont(font);
+      value->setStyleSheet(valueQSS);
+      value->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+      m_gridLayout->addWidget(value, i + 1, j + 1);
+      values.append(value);
+    }
+
+    // Register row
+    m_titles.append(title);
+    m_values.append(values);
+    m_valueIndexes.append(offset + i);
+  }
+
+  // Keep the rows at the top of the widget
+  m_gridLayout->setRowStretch(group.datasetCount() + 1, 1);
+
+  // Configure main layout
+  m_mainLayout = new QVBoxLayout(this);
+  m_mainLayout->addWidget(m_header);
+  m_mainLayout->addWidget(m_dataContainer, 1);
+  m_mainLayout->setContentsMargins(0, 0, 0, 0);
+  setLayout(m_mainLayout);
+
+  // Show the statistics of the sliding window by default
+  updateHeader();
+
+  // React to dashboard events
+  connect(this, SIGNAL(refreshRequested()), this, SLOT(updateData()));
+  connect(dash, SIGNAL(pointsChanged()), this, SLOT(updateHeader()));
+}
+
+/**
+ * Frees the memory allocated for each label of the table
+ */
+Widgets::Statistics::~Statistics()
+{
+  Q_FOREACH (auto row, m_values)
+    qDeleteAll(row);
+
+  qDeleteAll(m_titles);
+  qDeleteAll(m_columns);
+
+  delete m_header;
+  delete m_gridLayout;
+  delete m_dataContainer;
+  delete m_mainLayout;
+}
+
+/**
+ * Checks if the widget is enabled, if so, the statistics of each dataset are
+ * read from the dashboard & displayed with the precision selected by the
+ * user. Labels whose text does not change are not modified.
+ */
+void Widgets::Statistics::updateData()
+{
+  TRACE_SCOPE("Widgets::Statistics::updateData");
+
+  // Widget not enabled, do nothing
+  if (!isEnabled())
+    return;
+
+  // Invalid index, abort update
+  auto dash = &UI::Dashboard::instance();
+  if (m_index < 0 || m_index >= dash->statisticsCount())
+    return;
+
+  // Update the row of each dataset
+  const auto &statistics = dash->statistics();
+  for (int i = 0; i < m_valueIndexes.count(); ++i)
+  {
+    const int index = m_valueIndexes.at(i);
+    const auto summary = m_session ? statistics.session(index)
+                                   : statistics.windowed(index);
+
+    const double values[COLUMN_COUNT] = {summary.min, summary.max,
+                                         summary.mean, summary.stddev,
+                                         summary.rms};
+    for (int j = 0; j < COLUMN_COUNT; ++j)
+    {
+      if (qIsNaN(values[j]))
+        m_values[i][j]->setText("--.--");
+      else
+        m_values[i][j]->setText(
+            QString::number(values[j], 'f', dash->precision()));
+    }
+  }
+
+  // Repaint widget
+  requestRepaint();
+}
+
+/**
+ * Displays the period over which the statistics are computed
+ */
+void Widgets::Statistics::updateHeader()
+{
+  if (!m_header)
+    return;
+
+  if (m_session)
+    m_header->setText(tr(" ⇄ Session statistics"));
+  else
+    m_header->setText(tr(" ⇄ Last %1 samples")
+                          .arg(UI::Dashboard::instance().points()));
+
+  markDirty();
+}
+
+/**
+ * Changes the size of the labels when the widget is resized
+ */
+void Widgets::Statistics::resizeEvent(QResizeEvent *event)
+{
+  // Calculate font size
+  auto font = UI::Dashboard::instance().monoFont();
+  font.setPixelSize(qMax(8, event->size().width() / 40));
+
+  // Update fonts of the labels
+  if (m_header)
+    m_header->setFont(font);
+
+  Q_FOREACH (auto label, m_columns)
+    label->setFont(font);
+
+  for (int i = 0; i < m_titles.count(); ++i)
+  {
+    m_titles.at(i)->setFont(font);
+    Q_FOREACH (auto label, m_values.at(i))
+      label->setFont(font);
+  }
+
+  event->accept();
+}
+
+/**
+ * Switches between the windowed & the session statistics
+ */
+void Widgets::Statistics::mousePressEvent(QMouseEvent *event)
+{
+  if (event->button() == Qt::LeftButton)
+  {
+    m_session = !m_session;
+    updateHeader();
+    updateData();
+    event->accept();
+  }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <QLabel>
+#include <QGridLayout>
+#include <QVBoxLayout>
+
+#include <UI/DashboardWidget.h>
+#include <UI/Widgets/Common/ElidedLabel.h>
+
+namespace Widgets
+{
+/**
+ * @brief The Statistics class
+ *
+ * Displays the minimum, maximum, mean, standard deviation & RMS value of each
+ * dataset of a group as a table. The statistics are computed by the
+ * dashboard (see @c UI::Statistics), the widget only reads them.
+ *
+ * Clicking on the widget switches between the statistics of the sliding
+ * window (the number of points selected by the user) & the statistics of the
+ * whole session.
+ */
+class Statistics : public DashboardWidgetBase
+{
+  Q_OBJECT
+
+public:
+  Statistics(const int index = -1);
+  ~Statistics();
+
+private Q_SLOTS:
+  void updateData();
+  void updateHeader();
+
+protected:
+  void resizeEvent(QResizeEvent *event);
+  void mousePressEvent(QMouseEvent *event);
+
+private:
+  int m_index;
+  bool m_session;
+  QVector<int> m_valueIndexes;
+
+  QLabel *m_header;
+  QVector<QLabel *> m_columns;
+  QVector<ElidedLabel *> m_titles;
+  QVector<QVector<QLabel *>> m_values;
+
+  QWidget *m_dataContainer;
+  QVBoxLayout *m_mainLayout;
+  QGridLayout *m_gridLayout;
+};
+} // namespace Widgets
@@ -42,10 +42,10 @@ Widgets::Terminal::Terminal(QQuickItem *parent)
   , m_textChanged(false)
   , m_emulateVt100(false)
   , m_copyAvailable(false)
+  , m_maxUpdateRate(30)
 {
-  // Set widget & configure VT-100 emulator
+  // Set widget
   setWidget(&m_textEdit);
-  m_escapeCodeHandler.setTextEdit(&m_textEdit);
 
   // Setup default options
   setScrollbarWidth(14);
@@ -66,12 +66,19 @@ Widgets::Terminal::Terminal(QQuickItem *parent)
 #endif
   m_textEdit.setPalette(palette);
 
+  // Show the text that is already stored in the console history
+  const auto history = IO::Console::instance().text();
+  if (!history.isEmpty())
+    insertText(history);
+
   // Connect signals/slots
   // clang-format off
     connect(&IO::Console::instance(), &IO::Console::stringReceived,
             this, &Widgets::Terminal::insertText);
     connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeout10Hz,
             this, &Widgets::Terminal::repaint);
+    connect(&Misc::TimerEvents::instance(), &Misc::TimerEvents::timeoutRender,
+            this, &Widgets::Terminal::flushText);
   // clang-format on
 
   // React to widget events
@@ -194,6 +201,15 @@ bool Widgets::Terminal::undoRedoEnabled() const
   return m_textEdit.isUndoRedoEnabled();
 }
 
+/**
+ * Returns the maximum number of times per second that received text is
+ * inserted into the document.
+ */
+int Widgets::Terminal::maxUpdateRate() const
+{
+  return m_maxUpdateRate;
+}
+
 /**
  * This property holds the limit for blocks in the document.
  *
@@ -241,6 +257,8 @@ void Widgets::Terminal::copy()
  */
 void Widgets::Terminal::clear()
 {
+  m_pendingText.clear();
+  m_ansiParser.reset();
   m_textEdit.clear();
   updateScrollbarVisibility();
   requestRepaint(true);
@@ -301,6 +319,14 @@ void Widgets::Terminal::setFont(const QFont &font)
  */
 void Widgets::Terminal::append(const QString &text)
 {
+  // Insert queued text first to keep the order of the document
+  if (!m_pendingText.isEmpty())
+  {
+    const auto pending = m_pendingText;
+    m_pendingText.clear();
+    addText(pending, vt100emulation());
+  }
+
   m_textEdit.appendPlainText(text);
   updateScrollbarVisibility();
 
@@ -318,6 +344,7 @@ void Widgets::Terminal::append(const QString &text)
  */
 void Widgets::Terminal::setText(const QString &text)
 {
+  m_pendingText.clear();
   m_textEdit.setPlainText(text);
   updateScrollbarVisibility();
 
@@ -385,12 +412,15 @@ void Widgets::Terminal::setAutoscroll(const bool enabled)
 }
 
 /**
- * Inserts the given @a text directly, no additional line breaks added.
+ * Queues the given @a text to be inserted, no additional line breaks added.
+ *
+ * The text is not inserted immediately, all the text received between two
+ * frames is added to the document with a single edit by @c flushText().
  */
 void Widgets::Terminal::insertText(const QString &text)
 {
   if (widgetEnabled())
-    addText(text, vt100emulation());
+    m_pendingText.append(text);
 }
 
 /**
@@ -431,9 +461,21 @@ void Widgets::Terminal::setCenterOnScroll(const bool enabled)
 void Widgets::Terminal::setVt100Emulation(const bool enabled)
 {
   m_emulateVt100 = enabled;
+  m_ansiParser.reset();
   Q_EMIT vt100EmulationChanged();
 }
 
+/**
+ * Changes the maximum number of times per second that received text is
+ * inserted into the document, the document is never updated more than once
+ * per rendered frame.
+ */
+void Widgets::Terminal::setMaxUpdateRate(const int rate)
+{
+  m_maxUpdateRate = qBound(1, rate, 240);
+  Q_EMIT maxUpdateRateChanged();
+}
+
 /**
  * Enables/disables undo/redo history support.
  */
@@ -518,6 +560,29 @@ void Widgets::Terminal::repaint()
   }
 }
 
+/**
+ * Inserts the text received since the last update into the document with a
+ * single edit. This function is called by the render timer, and does nothing
+ * if the last update happened less than 1/@c maxUpdateRate() seconds ago.
+ */
+void Widgets::Terminal::flushText()
+{
+  // Nothing to insert
+  if (m_pendingText.isEmpty())
+    return;
+
+  // Limit the update rate
+  const auto interval = 1000 / m_maxUpdateRate;
+  if (m_updateTimer.isValid() && m_updateTimer.elapsed() < interval)
+    return;
+
+  // Insert the queued text
+  m_updateTimer.restart();
+  const auto text = m_pendingText;
+  m_pendingText.clear();
+  addText(text, vt100emulation());
+}
+
 /**
  * Hides or shows the scrollbar
  */
@@ -551,11 +616,6 @@ void Widgets::Terminal::setCopyAvailable(const bool yes)
  */
 void Widgets::Terminal::addText(const QString &text, const bool enableVt100)
 {
-  // Get text to insert
-  QString textToInsert = text;
-  if (enableVt100)
-    textToInsert = vt100Processing(text);
-
   // Clear terminal scrollback after 10000 lines
   if (m_textEdit.blockCount() >= 10000)
     m_textEdit.clear();
@@ -564,7 +624,10 @@ void Widgets::Terminal::addText(const QString &text, const bool enableVt100)
   QTextCursor cursor(m_textEdit.document());
   cursor.beginEditBlock();
   cursor.movePosition(QTextCursor::End);
-  cursor.insertText(textToInsert);
+  if (enableVt100)
+    m_ansiParser.process(text, cursor);
+  else
+    cursor.insertText(text, QTextCharFormat());
   cursor.endEditBlock();
 
   // Autoscroll to bottom (if needed)
@@ -586,368 +649,265 @@ void Widgets::Terminal::requestRepaint(const bool textChanged)
   m_textChanged = textChanged;
 }
 
+//----------------------------------------------------------------------------------------
+// VT-100 / ANSI escape sequence parser
+//----------------------------------------------------------------------------------------
+
 /**
- * Processes the given @a data to remove the escape sequences from the text
- * using code from Qt Creator output terminal. Check the next code block for
- * more info.
+ * Returns one of the eight standard ANSI colors, the @a bright flag selects
+ * the high-intensity variant of the color.
  */
-QString Widgets::Terminal::vt100Processing(const QString &data)
+static QColor ANSI_COLOR(const int code, const bool bright = false)
 {
-  auto formattedText = m_escapeCodeHandler.parseText(FormattedText(data));
-  const QString cleanLine = std::accumulate(
-      formattedText.begin(), formattedText.end(), QString(),
-      [](const FormattedText &t1, const FormattedText &t2) -> QString {
-        return t1.text + t2.text;
-      });
-  m_escapeCodeHandler.endFormatScope();
+  if (bright && code == 0)
+    return QColor(85, 85, 85);
 
-  return cleanLine;
+  const int value = bright ? 255 : 170;
+  const int red = code & 1 ? value : 0;
+  const int green = code & 2 ? value : 0;
+  const int blue = code & 4 ? value : 0;
+  return QColor(red, green, blue);
 }
 
-//--------------------------------------------------------------------------------------------------
-// VT-100 / ANSI terminal hacks
-// https://code.qt.io/cgit/qt-creator/qt-creator.git/tree/src/libs/utils/ansiescapecodehandler.cpp
-//---------------------------------------------------------º----------------------------------------
+/**
+ * Returns the color at the given @a index of the 256-color palette
+ */
+static QColor INDEXED_COLOR(const int index)
+{
+  // Standard & high-intensity ANSI colors
+  if (index < 8)
+    return ANSI_COLOR(index);
+  if (index < 16)
+    return ANSI_COLOR(index - 8, true);
+
+  // 6x6x6 RGB cube
+  if (index < 232)
+  {
+    const int o = index - 16;
+    return QColor((o / 36) * 51, ((o / 6) % 6) * 51, (o % 6) * 51);
+  }
 
-#define QTC_ASSERT(cond, action)                                               \
-  if (Q_LIKELY(cond))                                                          \
-  {                                                                            \
-  }                                                                            \
-  else                                                                         \
-  {                                                                            \
-    action;                                                                    \
-  }                                                                            \
-  do                                                                           \
-  {                                                                            \
-  } while (0)
+  // Greyscale gradient
+  const int grey = qMin(255, (index - 232) * 11);
+  return QColor(grey, grey, grey);
+}
 
-static QColor ansiColor(uint code)
+/**
+ * Constructor function
+ */
+Widgets::AnsiParser::AnsiParser()
+  : m_state(State::Ground)
+  , m_parameter(-1)
 {
-  QTC_ASSERT(code < 8, return QColor());
-
-  const int red = code & 1 ? 170 : 0;
-  const int green = code & 2 ? 170 : 0;
-  const int blue = code & 4 ? 170 : 0;
-  return QColor(red, green, blue);
 }
 
-QVector<Widgets::FormattedText>
-Widgets::AnsiEscapeCodeHandler::parseText(const FormattedText &input)
+/**
+ * Discards any partially received escape sequence & restores the default
+ * text format.
+ */
+void Widgets::AnsiParser::reset()
 {
-  enum AnsiEscapeCodes
-  {
-    ResetFormat = 0,
-    BoldText = 1,
-    TextColorStart = 30,
-    TextColorEnd = 37,
-    RgbTextColor = 38,
-    DefaultTextColor = 39,
-    BackgroundColorStart = 40,
-    BackgroundColorEnd = 47,
-    RgbBackgroundColor = 48,
-    DefaultBackgroundColor = 49
-  };
-
-  const QString escape = "\x1b[";
-  const QChar semicolon = ';';
-  const QChar colorTerminator = 'm';
-  const QChar eraseToEol = 'K';
-
-  QVector<FormattedText> outputData;
-  QTextCharFormat charFormat
-      = m_previousFormatClosed ? input.format : m_previousFormat;
-  QString strippedText;
-  if (m_pendingText.isEmpty())
-    strippedText = input.text;
+  m_parameter = -1;
+  m_state = State::Ground;
+  m_parameters.clear();
+  m_format = QTextCharFormat();
+}
 
-  else
+/**
+ * Parses the given @a data and writes the resulting text at the position of
+ * the given @a cursor, escape sequences that are not complete at the end of
+ * the chunk are finished with the following calls.
+ */
+void Widgets::AnsiParser::process(const QString &data, QTextCursor &cursor)
+{
+  // Fast path, no escape sequences in the chunk
+  if (m_state == State::Ground && !data.contains(QChar(0x1b)))
   {
-    strippedText = m_pendingText.append(input.text);
-    m_pendingText.clear();
+    cursor.insertText(data, m_format);
+    return;
   }
 
-  while (!strippedText.isEmpty())
+  // Run the state machine
+  int run = 0;
+  const int length = data.length();
+  const QChar *chars = data.constData();
+  for (int i = 0; i < length; ++i)
   {
-    QTC_ASSERT(m_pendingText.isEmpty(), break);
-    if (m_waitingForTerminator)
-    {
-      // We ignore all escape codes taking string arguments.
-      QString terminator = "\x1b\\";
-      int terminatorPos = strippedText.indexOf(terminator);
-      if (terminatorPos == -1 && !m_alternateTerminator.isEmpty())
-      {
-        terminator = m_alternateTerminator;
-        terminatorPos = strippedText.indexOf(terminator);
-      }
-      if (terminatorPos == -1)
-      {
-        m_pendingText = strippedText;
-        break;
-      }
-      m_waitingForTerminator = false;
-      m_alternateTerminator.clear();
-      strippedText.remove(0, terminatorPos + terminator.length());
-      if (strippedText.isEmpty())
-        break;
-    }
-    const int escapePos = strippedText.indexOf(escape.at(0));
-    if (escapePos < 0)
+    const ushort c = chars[i].unicode();
+    switch (m_state)
     {
-      outputData << FormattedText(strippedText, charFormat);
-      break;
-    }
-    else if (escapePos != 0)
-    {
-      outputData << FormattedText(strippedText.left(escapePos), charFormat);
-      strippedText.remove(0, escapePos);
-    }
-    QTC_ASSERT(strippedText.at(0) == escape.at(0), break);
+      // Printable text, write the current run before each escape sequence
+      case State::Ground:
+        if (c == 0x1b)
+        {
+          if (i > run)
+            cursor.insertText(QString(chars + run, i - run), m_format);
 
-    while (!strippedText.isEmpty() && escape.at(0) == strippedText.at(0))
-    {
-      if (escape.startsWith(strippedText))
-      {
-        // control secquence is not complete
-        m_pendingText += strippedText;
-        strippedText.clear();
-        break;
-      }
-      if (!strippedText.startsWith(escape))
-      {
-        switch (strippedText.at(1).toLatin1())
+          m_state = State::Escape;
+        }
+        continue;
+
+      // Escape character received, select the sequence type
+      case State::Escape:
+        if (c == '[')
         {
-          case '\\': // Unexpected terminator sequence.
-            Q_FALLTHROUGH();
-          case 'N':
-          case 'O': // Ignore unsupported single-character sequences.
-            strippedText.remove(0, 2);
-            break;
-          case ']':
-            m_alternateTerminator = QChar(7);
-            Q_FALLTHROUGH();
-          case 'P':
-          case 'X':
-          case '^':
-          case '_':
-            strippedText.remove(0, 2);
-            m_waitingForTerminator = true;
-            break;
-          default:
-            // not a control sequence
-            m_pendingText.clear();
-            outputData << FormattedText(strippedText.left(1), charFormat);
-            strippedText.remove(0, 1);
-            continue;
+          m_parameter = -1;
+          m_parameters.clear();
+          m_state = State::Csi;
         }
+        else if (c == ']' || c == 'P' || c == 'X' || c == '^' || c == '_')
+          m_state = State::String;
+        else
+          m_state = State::Ground;
         break;
-      }
-
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-      m_pendingText += strippedText.midRef(0, escape.length());
-#else
-      m_pendingText
-          += QStringView{strippedText}.mid(0, escape.length()).toString();
-#endif
-
-      strippedText.remove(0, escape.length());
-
-      // Get stripped text in uppercase
-      auto upperCase = strippedText.toUpper();
-
-      // Clear line
-      if (upperCase.contains("2K"))
-      {
-        textEdit->setFocus();
-        auto storedCursor = textEdit->textCursor();
-        textEdit->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
-        textEdit->moveCursor(QTextCursor::StartOfLine, QTextCursor::MoveAnchor);
-        textEdit->moveCursor(QTextCursor::End, QTextCursor::KeepAnchor);
-        textEdit->textCursor().removeSelectedText();
-        textEdit->textCursor().deletePreviousChar();
-        textEdit->setTextCursor(storedCursor);
-        return outputData;
-      }
-
-      // Clear screen
-      if (upperCase.contains("2J"))
-      {
-        textEdit->clear();
-        return QVector<FormattedText>();
-      }
 
-      // \e[K is not supported. Just strip it.
-      if (strippedText.startsWith(eraseToEol))
-      {
-        m_pendingText.clear();
-        strippedText.remove(0, 1);
-        continue;
-      }
-      // get the number
-      QString strNumber;
-      StringList numbers;
-      while (!strippedText.isEmpty())
-      {
-        if (strippedText.at(0).isDigit())
+      // Control sequence, collect numeric parameters until the final byte
+      case State::Csi:
+        if (c >= '0' && c <= '9')
+          m_parameter = qMin(9999, qMax(0, m_parameter) * 10 + (c - '0'));
+        else if (c == ';')
         {
-          strNumber += strippedText.at(0);
+          m_parameters.append(m_parameter);
+          m_parameter = -1;
         }
-        else
+        else if (c >= 0x40 && c <= 0x7e)
         {
-          if (!strNumber.isEmpty())
-            numbers << strNumber;
-          if (strNumber.isEmpty() || strippedText.at(0) != semicolon)
-            break;
-          strNumber.clear();
+          if (m_parameter >= 0 || !m_parameters.isEmpty())
+            m_parameters.append(m_parameter);
+
+          executeCsi(c, cursor);
+          m_state = State::Ground;
         }
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        m_pendingText += strippedText.midRef(0, 1);
-#else
-        m_pendingText += QStringView{strippedText}.mid(0, 1).toString();
-#endif
-        strippedText.remove(0, 1);
-      }
-      if (strippedText.isEmpty())
         break;
 
-      // remove terminating char
-      if (!strippedText.startsWith(colorTerminator))
-      {
-        m_pendingText.clear();
-        strippedText.remove(0, 1);
+      // String command, skip everything until BEL or ESC backslash
+      case State::String:
+        if (c == 0x07)
+          m_state = State::Ground;
+        else if (c == 0x1b)
+          m_state = State::StringEscape;
         break;
-      }
-      // got consistent control sequence, ok to clear pending text
-      m_pendingText.clear();
-      strippedText.remove(0, 1);
+      case State::StringEscape:
+        m_state = c == '\\' ? State::Ground : State::String;
+        break;
+    }
+
+    // Printable text starts after the last byte of the sequence
+    run = i + 1;
+  }
+
+  // Write the remaining text
+  if (m_state == State::Ground && run < length)
+    cursor.insertText(QString(chars + run, length - run), m_format);
+}
+
+/**
+ * Executes the control sequence identified by the given final byte
+ * (@a command) with the parameters collected by the parser.
+ */
+void Widgets::AnsiParser::executeCsi(const ushort command, QTextCursor &cursor)
+{
+  const int mode = m_parameters.isEmpty() ? 0 : qMax(0, m_parameters.first());
+  switch (command)
+  {
+    // Select graphic rendition
+    case 'm':
+      applySgr();
+      break;
 
-      if (numbers.isEmpty())
+    // Erase in line, text is always written at the end of the document
+    case 'K':
+      if (mode == 1 || mode == 2)
       {
-        charFormat = input.format;
-        endFormatScope();
+        cursor.movePosition(QTextCursor::StartOfBlock, QTextCursor::KeepAnchor);
+        cursor.removeSelectedText();
       }
+      break;
 
-      for (int i = 0; i < numbers.size(); ++i)
+    // Erase in display
+    case 'J':
+      if (mode == 2 || mode == 3)
       {
-        const uint code = numbers.at(i).toUInt();
-
-        if (code >= TextColorStart && code <= TextColorEnd)
-        {
-          charFormat.setForeground(ansiColor(code - TextColorStart));
-          setFormatScope(charFormat);
-        }
-        else if (code >= BackgroundColorStart && code <= BackgroundColorEnd)
-        {
-          charFormat.setBackground(ansiColor(code - BackgroundColorStart));
-          setFormatScope(charFormat);
-        }
-        else
-        {
-          switch (code)
-          {
-            case ResetFormat:
-              charFormat = input.format;
-              endFormatScope();
-              break;
-            case BoldText:
-              charFormat.setFontWeight(QFont::Bold);
-              setFormatScope(charFormat);
-              break;
-            case DefaultTextColor:
-              charFormat.setForeground(input.format.foreground());
-              setFormatScope(charFormat);
-              break;
-            case DefaultBackgroundColor:
-              charFormat.setBackground(input.format.background());
-              setFormatScope(charFormat);
-              break;
-            case RgbTextColor:
-            case RgbBackgroundColor:
-              // See http://en.wikipedia.org/wiki/ANSI_escape_code#Colors
-              if (++i >= numbers.size())
-                break;
-              switch (numbers.at(i).toInt())
-              {
-                case 2:
-                  // RGB set with format: 38;2;<r>;<g>;<b>
-                  if ((i + 3) < numbers.size())
-                  {
-                    (code == RgbTextColor)
-                        ? charFormat.setForeground(
-                              QColor(numbers.at(i + 1).toInt(),
-                                     numbers.at(i + 2).toInt(),
-                                     numbers.at(i + 3).toInt()))
-                        : charFormat.setBackground(
-                              QColor(numbers.at(i + 1).toInt(),
-                                     numbers.at(i + 2).toInt(),
-                                     numbers.at(i + 3).toInt()));
-                    setFormatScope(charFormat);
-                  }
-                  i += 3;
-                  break;
-                case 5:
-                  // 256 color mode with format: 38;5;<i>
-                  uint index = numbers.at(i + 1).toUInt();
-
-                  QColor color;
-                  if (index < 8)
-                  {
-                    // The first 8 colors are standard low-intensity
-                    // ANSI colors.
-                    color = ansiColor(index);
-                  }
-                  else if (index < 16)
-                  {
-                    // The next 8 colors are standard high-intensity
-                    // ANSI colors.
-                    color = ansiColor(index - 8).lighter(150);
-                  }
-                  else if (index < 232)
-                  {
-                    // The next 216 colors are a 6x6x6 RGB cube.
-                    uint o = index - 16;
-                    color = QColor((o / 36) * 51, ((o / 6) % 6) * 51,
-                                   (o % 6) * 51);
-                  }
-                  else
-                  {
-                    // The last 24 colors are a greyscale gradient.
-                    int grey = int((index - 232) * 11);
-                    color = QColor(grey, grey, grey);
-                  }
-
-                  if (code == RgbTextColor)
-                    charFormat.setForeground(color);
-                  else
-                    charFormat.setBackground(color);
-
-                  setFormatScope(charFormat);
-                  ++i;
-                  break;
-              }
-              break;
-            default:
-              break;
-          }
-        }
+        cursor.select(QTextCursor::Document);
+        cursor.removeSelectedText();
       }
-    }
+      break;
+
+    // Cursor movement & other sequences are not supported
+    default:
+      break;
   }
-  return outputData;
 }
 
-void Widgets::AnsiEscapeCodeHandler::setTextEdit(QPlainTextEdit *widget)
+/**
+ * Updates the current text format with the parameters of a SGR (select
+ * graphic rendition) sequence.
+ */
+void Widgets::AnsiParser::applySgr()
 {
-  textEdit = widget;
-}
+  // No parameters, reset format
+  if (m_parameters.isEmpty())
+  {
+    m_format = QTextCharFormat();
+    return;
+  }
 
-void Widgets::AnsiEscapeCodeHandler::endFormatScope()
-{
-  m_previousFormatClosed = true;
-}
+  // Apply each attribute
+  const int count = m_parameters.count();
+  for (int i = 0; i < count; ++i)
+  {
+    const int code = qMax(0, m_parameters.at(i));
+    if (code == 0)
+      m_format = QTextCharFormat();
+    else if (code == 1)
+      m_format.setFontWeight(QFont::Bold);
+    else if (code == 22)
+      m_format.setFontWeight(QFont::Normal);
+    else if (code == 3)
+      m_format.setFontItalic(true);
+    else if (code == 23)
+      m_format.setFontItalic(false);
+    else if (code == 4)
+      m_format.setFontUnderline(true);
+    else if (code == 24)
+      m_format.setFontUnderline(false);
+    else if (code >= 30 && code <= 37)
+      m_format.setForeground(ANSI_COLOR(code - 30));
+    else if (code >= 90 && code <= 97)
+      m_format.setForeground(ANSI_COLOR(code - 90, true));
+    else if (code == 39)
+      m_format.clearForeground();
+    else if (code >= 40 && code <= 47)
+      m_format.setBackground(ANSI_COLOR(code - 40));
+    else if (code >= 100 && code <= 107)
+      m_format.setBackground(ANSI_COLOR(code - 100, true));
+    else if (code == 49)
+      m_format.clearBackground();
+
+    // Extended colors: 38;5;<index> or 38;2;<r>;<g>;<b>
+    else if ((code == 38 || code == 48) && i + 1 < count)
+    {
+      QColor color;
+      const int type = m_parameters.at(i + 1);
+      if (type == 5 && i + 2 < count)
+      {
+        color = INDEXED_COLOR(qBound(0, m_parameters.at(i + 2), 255));
+        i += 2;
+      }
+      else if (type == 2 && i + 4 < count)
+      {
+        color = QColor(qBound(0, m_parameters.at(i + 2), 255),
+                       qBound(0, m_parameters.at(i + 3), 255),
+                       qBound(0, m_parameters.at(i + 4), 255));
+        i += 4;
+      }
+      else
+        break;
 
-void Widgets::AnsiEscapeCodeHandler::setFormatScope(
-    const QTextCharFormat &charFormat)
-{
-  m_previousFormat = charFormat;
-  m_previousFormatClosed = false;
+      if (code == 38)
+        m_format.setForeground(color);
+      else
+        m_format.setBackground(color);
+    }
+  }
 }
@@ -22,43 +22,55 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QTextCursor>
 #include <QPlainTextEdit>
 #include <UI/DeclarativeWidget.h>
 
 namespace Widgets
 {
-class FormattedText
+/**
+ * @brief The AnsiParser class
+ *
+ * Incremental VT-100/ANSI escape sequence parser used by the terminal widget.
+ *
+ * The parser is a byte-level state machine that keeps its state between
+ * calls, so escape sequences split across several data chunks are handled
+ * without buffering the text that surrounds them. Printable text is written
+ * to the document as style runs (one insertion per run of characters that
+ * share the same format), and chunks that contain no escape character are
+ * inserted with a single call.
+ *
+ * Supported sequences are SGR colors/attributes (including the 256-color and
+ * RGB extensions), erase in line (@c K) and erase in display (@c J), all the
+ * other control sequences and string commands (OSC, DCS, etc.) are skipped.
+ */
+class AnsiParser
 {
 public:
-  FormattedText() = default;
-  FormattedText(const FormattedText &other) = default;
-  FormattedText(const QString &txt,
-                const QTextCharFormat &fmt = QTextCharFormat())
-    : text(txt)
-    , format(fmt)
-  {
-  }
-
-  QString text;
-  QTextCharFormat format;
-};
+  AnsiParser();
 
-class AnsiEscapeCodeHandler
-{
-public:
-  QVector<FormattedText> parseText(const FormattedText &input);
-  void setTextEdit(QPlainTextEdit *widget);
-  void endFormatScope();
+  void reset();
+  void process(const QString &data, QTextCursor &cursor);
 
 private:
-  void setFormatScope(const QTextCharFormat &charFormat);
+  void applySgr();
+  void executeCsi(const ushort command, QTextCursor &cursor);
 
-  QString m_pendingText;
-  QPlainTextEdit *textEdit;
-  QString m_alternateTerminator;
-  QTextCharFormat m_previousFormat;
-  bool m_previousFormatClosed = true;
-  bool m_waitingForTerminator = false;
+private:
+  enum class State
+  {
+    Ground,
+    Escape,
+    Csi,
+    String,
+    StringEscape
+  };
+
+  State m_state;
+  int m_parameter;
+  QVector<int> m_parameters;
+  QTextCharFormat m_format;
 };
 
 class Terminal : public UI::DeclarativeWidget
@@ -123,6 +135,10 @@ class Terminal : public UI::DeclarativeWidget
                READ vt100emulation
                WRITE setVt100Emulation
                NOTIFY vt100EmulationChanged)
+    Q_PROPERTY(int maxUpdateRate
+               READ maxUpdateRate
+               WRITE setMaxUpdateRate
+               NOTIFY maxUpdateRateChanged)
   // clang-format on
 
 Q_SIGNALS:
@@ -138,6 +154,7 @@ Q_SIGNALS:
   void centerOnScrollChanged();
   void vt100EmulationChanged();
   void placeholderTextChanged();
+  void maxUpdateRateChanged();
   void undoRedoEnabledChanged();
   void maximumBlockCountChanged();
 
@@ -158,6 +175,7 @@ public:
   bool centerOnScroll() const;
   bool vt100emulation() const;
   bool undoRedoEnabled() const;
+  int maxUpdateRate() const;
   int maximumBlockCount() const;
   QString placeholderText() const;
   QTextDocument *document() const;
@@ -179,6 +197,7 @@ public Q_SLOTS:
   void setWidgetEnabled(const bool enabled);
   void setCenterOnScroll(const bool enabled);
   void setVt100Emulation(const bool enabled);
+  void setMaxUpdateRate(const int rate);
   void setUndoRedoEnabled(const bool enabled);
   void setPlaceholderText(const QString &text);
   void scrollToBottom(const bool repaint = false);
@@ -186,12 +205,12 @@ public Q_SLOTS:
 
 private Q_SLOTS:
   void repaint();
+  void flushText();
   void updateScrollbarVisibility();
   void setCopyAvailable(const bool yes);
   void addText(const QString &text, const bool enableVt100);
 
 private:
-  QString vt100Processing(const QString &data);
   void requestRepaint(const bool textChanged = false);
 
 private:
@@ -201,7 +220,11 @@ private:
   bool m_emulateVt100;
   bool m_copyAvailable;
 
+  int m_maxUpdateRate;
+  QString m_pendingText;
+  QElapsedTimer m_updateTimer;
+
   QPlainTextEdit m_textEdit;
-  AnsiEscapeCodeHandler m_escapeCodeHandler;
+  AnsiParser m_ansiParser;
 };
 } // namespace Widgets
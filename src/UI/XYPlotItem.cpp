@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <QtMath>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <QSGFlatColorMaterial>
+
+#include <UI/Dashboard.h>
+#include <UI/XYPlotItem.h>
+#include <Misc/ThemeManager.h>
+
+/**
+ * Number of vertex buffers in which the point cloud is divided, each buffer
+ * is uploaded to the GPU only when it receives new points.
+ */
+static const int CHUNKS = 16;
+
+/**
+ * Opacity of the oldest chunk when persistence is enabled
+ */
+static const float MIN_OPACITY = 0.15f;
+
+/**
+ * Root node of the XY plot, maps the data coordinates of the chunks to the
+ * coordinates of the item & owns one point geometry node per chunk.
+ */
+class XYPlotNode : public QSGTransformNode
+{
+public:
+  XYPlotNode(const int capacity)
+    : m_capacity(capacity)
+    , m_chunkSize((capacity + CHUNKS - 1) / CHUNKS)
+  {
+    for (int i = 0; i < CHUNKS; ++i)
+    {
+      auto geometry
+          = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+      geometry->setDrawingMode(QSGGeometry::DrawPoints);
+      geometry->setVertexDataPattern(QSGGeometry::StaticPattern);
+
+      auto child = new QSGGeometryNode;
+      child->setGeometry(geometry);
+      child->setMaterial(new QSGFlatColorMaterial);
+      child->setFlag(QSGNode::OwnsGeometry);
+      child->setFlag(QSGNode::OwnsMaterial);
+      appendChildNode(child);
+    }
+  }
+
+  int capacity() const { return m_capacity; }
+  int chunkSize() const { return m_chunkSize; }
+
+  QSGGeometryNode *chunk(const int index) const
+  {
+    return static_cast<QSGGeometryNode *>(childAtIndex(index));
+  }
+
+  /**
+   * Returns the vertices of the given chunk, the chunk is allocated on its
+   * first use with every vertex set to @a point, so the slots that have not
+   * been written yet are drawn over an existing point.
+   */
+  QSGGeometry::Point2D *vertices(const int index, const QPointF &point)
+  {
+    auto geometry = chunk(index)->geometry();
+    if (geometry->vertexCount() == 0)
+    {
+      const int size = qMin(m_chunkSize, m_capacity - index * m_chunkSize);
+      geometry->allocate(size);
+
+      auto data = geometry->vertexDataAsPoint2D();
+      for (int i = 0; i < size; ++i)
+        data[i].set(point.x(), point.y());
+    }
+
+    return geometry->vertexDataAsPoint2D();
+  }
+
+private:
+  int m_capacity;
+  int m_chunkSize;
+};
+
+/**
+ * Constructor function, configures item flags & connects the signals of the
+ * dashboard to update the point cloud.
+ */
+UI::XYPlotItem::XYPlotItem(QQuickItem *parent)
+  : QQuickItem(parent)
+  , m_index(-1)
+  , m_count(0)
+  , m_reset(true)
+  , m_autoscale(true)
+  , m_persistence(true)
+  , m_sequence(0)
+  , m_minX(0)
+  , m_maxX(1)
+  , m_minY(0)
+  , m_maxY(1)
+{
+  setFlag(ItemHasContents, true);
+
+  // clang-format off
+    auto dash = &UI::Dashboard::instance();
+    connect(dash, &UI::Dashboard::updated,
+            this, &UI::XYPlotItem::updateData);
+    connect(dash, &UI::Dashboard::xyPointsChanged,
+            this, &UI::XYPlotItem::configure);
+    connect(dash, &UI::Dashboard::widgetCountChanged,
+            this, &UI::XYPlotItem::configure);
+    connect(this, &UI::XYPlotItem::visibleChanged,
+            this, &UI::XYPlotItem::update);
+  // clang-format on
+}
+
+/**
+ * Returns the index of the XY plot widget displayed by the item
+ */
+int UI::XYPlotItem::index() const
+{
+  return m_index;
+}
+
+/**
+ * Returns the number of points displayed by the item
+ */
+int UI::XYPlotItem::count() const
+{
+  return m_count;
+}
+
+/**
+ * Returns @c true if older points are drawn with less opacity than the
+ * latest points.
+ */
+bool UI::XYPlotItem::persistence() const
+{
+  return m_persistence;
+}
+
+/**
+ * Returns the value displayed at the left edge of the plot
+ */
+qreal UI::XYPlotItem::minX() const
+{
+  return m_minX;
+}
+
+/**
+ * Returns the value displayed at the right edge of the plot
+ */
+qreal UI::XYPlotItem::maxX() const
+{
+  return m_maxX;
+}
+
+/**
+ * Returns the value displayed at the bottom of the plot
+ */
+qreal UI::XYPlotItem::minY() const
+{
+  return m_minY;
+}
+
+/**
+ * Returns the value displayed at the top of the plot
+ */
+qreal UI::XYPlotItem::maxY() const
+{
+  return m_maxY;
+}
+
+/**
+ * Changes the index of the XY plot widget displayed by the item
+ */
+void UI::XYPlotItem::setIndex(const int index)
+{
+  if (m_index != index)
+  {
+    m_index = index;
+    configure();
+  }
+}
+
+/**
+ * Enables or disables the fading of the older points of the cloud
+ */
+void UI::XYPlotItem::setPersistence(const bool enabled)
+{
+  if (m_persistence != enabled)
+  {
+    m_persistence = enabled;
+    Q_EMIT persistenceChanged();
+    update();
+  }
+}
+
+/**
+ * Copies the points appended to the cloud since the last frame to the vertex
+ * buffers, updates the opacity of each chunk & maps the data coordinates to
+ * the item with the transform matrix.
+ */
+QSGNode *UI::XYPlotItem::updatePaintNode(QSGNode *node,
+                                         UpdatePaintNodeData *data)
+{
+  Q_UNUSED(data);
+
+  // Nothing to draw
+  auto dash = &UI::Dashboard::instance();
+  if (!validIndex() || m_index >= dash->pointClouds().count() || width() <= 0
+      || height() <= 0)
+  {
+    delete node;
+    m_sequence = 0;
+    return Q_NULLPTR;
+  }
+
+  // Rebuild the vertex buffers if the cloud was cleared or resized
+  const auto &cloud = dash->pointClouds().at(m_index);
+  auto root = static_cast<XYPlotNode *>(node);
+  if (root
+      && (m_reset || root->capacity() != cloud.capacity()
+          || cloud.sequence() < m_sequence))
+  {
+    delete root;
+    root = Q_NULLPTR;
+  }
+
+  // Create root node
+  if (!root)
+  {
+    if (cloud.capacity() <= 0)
+      return Q_NULLPTR;
+
+    root = new XYPlotNode(cloud.capacity());
+    m_sequence = 0;
+    m_reset = false;
+  }
+
+  // Only the points that are still in the cloud can be copied
+  const int size = root->chunkSize();
+  const quint64 last = cloud.sequence();
+  const quint64 stored = static_cast<quint64>(cloud.count());
+  const quint64 first = qMax(m_sequence, last - qMin(last, stored));
+
+  // Write each new point over the vertex of the point that it evicted
+  bool dirty[CHUNKS] = {};
+  for (quint64 n = first; n < last; ++n)
+  {
+    const auto point = cloud.at(static_cast<int>(stored - (last - n)));
+    const int slot = static_cast<int>(n % root->capacity());
+    const int chunk = slot / size;
+    root->vertices(chunk, point)[slot - chunk * size].set(point.x(), point.y());
+    dirty[chunk] = true;
+  }
+
+  m_sequence = last;
+
+  // Fade the chunks with their age, the newest chunk is fully opaque
+  int head = 0;
+  if (last > 0)
+    head = static_cast<int>((last - 1) % root->capacity()) / size;
+
+  for (int i = 0; i < CHUNKS; ++i)
+  {
+    auto child = root->chunk(i);
+    auto material = static_cast<QSGFlatColorMaterial *>(child->material());
+
+    QColor color = m_color;
+    if (m_persistence)
+    {
+      const int age = (head - i + CHUNKS) % CHUNKS;
+      color.setAlphaF(1 - (1 - MIN_OPACITY) * age / (CHUNKS - 1));
+    }
+
+    QSGNode::DirtyState state;
+    if (dirty[i])
+      state |= QSGNode::DirtyGeometry;
+    if (material->color() != color)
+    {
+      material->setColor(color);
+      state |= QSGNode::DirtyMaterial;
+    }
+
+    if (state)
+      child->markDirty(state);
+  }
+
+  // Map the data coordinates to the item
+  const qreal rx = qMax(m_maxX - m_minX, 1e-12);
+  const qreal ry = qMax(m_maxY - m_minY, 1e-12);
+  QMatrix4x4 matrix;
+  matrix.translate(0, height());
+  matrix.scale(width() / rx, -height() / ry);
+  matrix.translate(-m_minX, -m_minY);
+  root->setMatrix(matrix);
+
+  return root;
+}
+
+/**
+ * Reads the color & the ranges of the datasets of the displayed group, the
+ * plot is autoscaled unless both datasets have a valid min/max range.
+ */
+void UI::XYPlotItem::configure()
+{
+  // Reset parameters
+  m_count = 0;
+  m_reset = true;
+  m_autoscale = true;
+
+  // Get the point color & the ranges of the datasets
+  if (validIndex())
+  {
+    auto dash = &UI::Dashboard::instance();
+    auto colors = Misc::ThemeManager::instance().widgetColors();
+    if (!colors.isEmpty())
+      m_color = QColor(colors.at(m_index % colors.count()));
+
+    const auto &group = dash->getXYPlot(m_index);
+    if (group.datasetCount() >= 2)
+    {
+      const auto &x = group.getDataset(0);
+      const auto &y = group.getDataset(1);
+      if (x.max() > x.min() && y.max() > y.min())
+      {
+        m_autoscale = false;
+        m_minX = x.min();
+        m_maxX = x.max();
+        m_minY = y.min();
+        m_maxY = y.max();
+      }
+    }
+  }
+
+  // Update user interface
+  Q_EMIT indexChanged();
+  Q_EMIT rangeChanged();
+  update();
+}
+
+/**
+ * Updates the range of the plot with the bounding box of the point cloud &
+ * schedules a new frame, hidden items are not updated.
+ */
+void UI::XYPlotItem::updateData()
+{
+  // Item not visible or invalid
+  auto dash = &UI::Dashboard::instance();
+  if (!isVisible() || !validIndex()
+      || m_index >= dash->pointClouds().count())
+    return;
+
+  // Get the range of the cloud, leaving a small margin around the points
+  const auto &cloud = dash->pointClouds().at(m_index);
+  if (m_autoscale && cloud.count() > 0)
+  {
+    const qreal dx = cloud.maxX() - cloud.minX();
+    const qreal dy = cloud.maxY() - cloud.minY();
+    const qreal mx = dx > 0 ? dx * 0.05 : 1;
+    const qreal my = dy > 0 ? dy * 0.05 : 1;
+    m_minX = cloud.minX() - mx;
+    m_maxX = cloud.maxX() + mx;
+    m_minY = cloud.minY() - my;
+    m_maxY = cloud.maxY() + my;
+  }
+
+  // Update user interface
+  m_count = cloud.count();
+  Q_EMIT rangeChanged();
+  update();
+}
+
+/**
+ * Returns @c true if the index of the item corresponds to an XY plot widget
+ */
+bool UI::XYPlotItem::validIndex() const
+{
+  return m_index >= 0 && m_index < UI::Dashboard::instance().xyPlotCount();
+}
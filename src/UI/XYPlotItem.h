@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020-2023 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QColor>
+#include <QQuickItem>
+
+namespace UI
+{
+/**
+ * @brief The XYPlotItem class
+ *
+ * Qt Quick item that draws the point cloud of an XY plot widget (the first
+ * dataset of the group against the second one) with the scene graph, used for
+ * IQ constellations, Lissajous figures & phase plots.
+ *
+ * The points are stored in vertex buffers in data coordinates, and mapped to
+ * the item with a transform node, so autoscaling the plot only changes a
+ * matrix. The vertices mirror the ring of the @c UI::PointCloud and are split
+ * in a fixed number of chunks:
+ *
+ * - Each new point is written once, over the vertex of the point that it
+ *   evicts from the ring.
+ * - Only the chunks that received new points are uploaded to the GPU, so the
+ *   cost of a frame depends on the number of new points instead of the size
+ *   of the cloud (up to a million points).
+ * - With persistence enabled, older chunks are drawn with less opacity,
+ *   which fades the trail of the cloud like an analog oscilloscope.
+ */
+class XYPlotItem : public QQuickItem
+{
+  // clang-format off
+    Q_OBJECT
+    Q_PROPERTY(int index
+               READ index
+               WRITE setIndex
+               NOTIFY indexChanged)
+    Q_PROPERTY(bool persistence
+               READ persistence
+               WRITE setPersistence
+               NOTIFY persistenceChanged)
+    Q_PROPERTY(int count
+               READ count
+               NOTIFY rangeChanged)
+    Q_PROPERTY(qreal minX
+               READ minX
+               NOTIFY rangeChanged)
+    Q_PROPERTY(qreal maxX
+               READ maxX
+               NOTIFY rangeChanged)
+    Q_PROPERTY(qreal minY
+               READ minY
+               NOTIFY rangeChanged)
+    Q_PROPERTY(qreal maxY
+               READ maxY
+               NOTIFY rangeChanged)
+  // clang-format on
+
+Q_SIGNALS:
+  void indexChanged();
+  void rangeChanged();
+  void persistenceChanged();
+
+public:
+  XYPlotItem(QQuickItem *parent = 0);
+
+  int index() const;
+  int count() const;
+  bool persistence() const;
+  qreal minX() const;
+  qreal maxX() const;
+  qreal minY() const;
+  qreal maxY() const;
+
+public Q_SLOTS:
+  void setIndex(const int index);
+  void setPersistence(const bool enabled);
+
+protected:
+  QSGNode *updatePaintNode(QSGNode *node, UpdatePaintNodeData *data) override;
+
+private Q_SLOTS:
+  void configure();
+  void updateData();
+
+private:
+  bool validIndex() const;
+
+private:
+  int m_index;
+  int m_count;
+  bool m_reset;
+  bool m_autoscale;
+  bool m_persistence;
+  quint64 m_sequence;
+
+  qreal m_minX;
+  qreal m_maxX;
+  qreal m_minY;
+  qreal m_maxY;
+  QColor m_color;
+};
+} // namespace UI
@@ -20,19 +20,30 @@
  * THE SOFTWARE.
  */
 
+#include <csignal>
+
 #include <QtQml>
 #include <QSysInfo>
+#include <QCommandLineParser>
 #include <QQuickStyle>
 #include <QApplication>
 #include <QStyleFactory>
 
 #include <AppInfo.h>
 #include <JSON/Frame.h>
+#include <CSV/Converter.h>
+#include <Misc/Benchmark.h>
 #include <Misc/Utilities.h>
 #include <Misc/ModuleManager.h>
+#include <UI/RenderBenchmark.h>
+#include <UI/DashboardExporter.h>
 
 #ifdef Q_OS_WIN
 #  include <windows.h>
+#else
+#  include <unistd.h>
+#  include <sys/socket.h>
+#  include <QSocketNotifier>
 #endif
 
 /**
@@ -53,6 +64,96 @@ static void cliResetSettings()
   qDebug() << APP_NAME << "settings cleared!";
 }
 
+#ifdef Q_OS_WIN
+/**
+ * Quits the application when the console is closed or the user presses
+ * Ctrl+C, so that recordings are closed properly in headless mode. The
+ * handler runs in a thread created by the system, so the request is queued
+ * to the event loop of the application.
+ */
+static BOOL WINAPI cliHandleConsoleEvent(DWORD type)
+{
+  switch (type)
+  {
+    case CTRL_C_EVENT:
+    case CTRL_BREAK_EVENT:
+    case CTRL_CLOSE_EVENT:
+    case CTRL_SHUTDOWN_EVENT:
+      QMetaObject::invokeMethod(qApp, &QCoreApplication::quit,
+                                Qt::QueuedConnection);
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+#else
+/**
+ * Socket pair used to notify the event loop about SIGINT & SIGTERM, the
+ * signal handler writes to the first socket & the application reads from the
+ * second one.
+ */
+static int SIGNAL_SOCKETS[2] = {-1, -1};
+
+/**
+ * Notifies the event loop that the process received SIGINT or SIGTERM, only
+ * async-signal-safe functions can be called here, so a byte is written to
+ * the signal socket & the application quits when it is read.
+ */
+static void cliHandleSignal(int signal)
+{
+  const char byte = static_cast<char>(signal);
+  const auto written = ::write(SIGNAL_SOCKETS[0], &byte, sizeof(byte));
+  (void)written;
+}
+#endif
+
+/**
+ * Quits the application when the process receives SIGINT or SIGTERM (or a
+ * console control event on Windows), so that recordings are closed properly
+ * in headless mode.
+ */
+static void cliInstallSignalHandlers()
+{
+#ifdef Q_OS_WIN
+  SetConsoleCtrlHandler(cliHandleConsoleEvent, TRUE);
+#else
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, SIGNAL_SOCKETS) != 0)
+  {
+    qWarning() << "Cannot create signal socket pair";
+    return;
+  }
+
+  auto notifier = new QSocketNotifier(SIGNAL_SOCKETS[1], QSocketNotifier::Read,
+                                      qApp);
+  QObject::connect(notifier, &QSocketNotifier::activated, qApp, [=] {
+    char byte;
+    const auto read = ::read(SIGNAL_SOCKETS[1], &byte, sizeof(byte));
+    (void)read;
+    QCoreApplication::quit();
+  });
+
+  std::signal(SIGINT, cliHandleSignal);
+  std::signal(SIGTERM, cliHandleSignal);
+#endif
+}
+
+/**
+ * Splits an option value with the "host:port" format, returns @c false if the
+ * value is invalid.
+ */
+static bool cliParseAddress(const QString &value, QString &host,
+                            quint16 &port)
+{
+  const int separator = value.lastIndexOf(':');
+  if (separator <= 0)
+    return false;
+
+  bool ok;
+  host = value.left(separator);
+  port = value.mid(separator + 1).toUShort(&ok);
+  return ok && port > 0;
+}
+
 /**
  * @brief Entry-point function of the application
  *
@@ -87,9 +188,37 @@ int main(int argc, char **argv)
   auto policy = Qt::HighDpiScaleFactorRoundingPolicy::PassThrough;
   QApplication::setHighDpiScaleFactorRoundingPolicy(policy);
 
-  // Init. application
+  // Headless, benchmark, render & conversion modes do not need a display
+  // server
+  bool render = false;
+  bool convert = false;
+  bool headless = false;
+  bool benchmark = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (qstrcmp(argv[i], "--headless") == 0)
+      headless = true;
+    else if (qstrcmp(argv[i], "--render") == 0)
+      render = true;
+    else if (qstrcmp(argv[i], "--convert") == 0)
+      convert = true;
+    else if (qstrcmp(argv[i], "--benchmark") == 0
+             || qstrcmp(argv[i], "--micro-benchmark") == 0
+             || qstrcmp(argv[i], "--render-benchmark") == 0
+             || qstrcmp(argv[i], "--soak") == 0)
+      benchmark = true;
+  }
+
+  if (headless || benchmark || render || convert)
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  // Init. application, the benchmark uses its own settings so that results
+  // are reproducible & the user configuration is not modified
   QApplication app(argc, argv);
-  app.setApplicationName(APP_NAME);
+  if (benchmark)
+    app.setApplicationName(QStringLiteral(APP_NAME) + " Benchmark");
+  else
+    app.setApplicationName(APP_NAME);
   app.setApplicationVersion(APP_VERSION);
   app.setOrganizationName(APP_DEVELOPER);
   app.setOrganizationDomain(APP_SUPPORT_URL);
@@ -98,32 +227,304 @@ int main(int argc, char **argv)
   app.setStyle(QStyleFactory::create("Fusion"));
   QQuickStyle::setStyle("Fusion");
 
-  // Read arguments
-  QString arguments;
-  if (app.arguments().count() >= 2)
-    arguments = app.arguments().at(1);
+  // Register command line options
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  QCommandLineOption version({"v", "version"}, "Show application version");
+  QCommandLineOption reset({"r", "reset"}, "Reset application settings");
+  QCommandLineOption headlessMode(
+      "headless", "Run without user interface, bridging the device to CSV "
+                  "files, MQTT and the plugins server");
+  QCommandLineOption project("project", "Load the given project file",
+                             "file");
+  QCommandLineOption serial("serial", "Connect to the given serial port",
+                            "port");
+  QCommandLineOption baud("baud", "Serial port baud rate", "rate", "9600");
+  QCommandLineOption tcp("tcp", "Connect to the given TCP server",
+                         "host:port");
+  QCommandLineOption udp("udp", "Listen on the given UDP port", "port");
+  QCommandLineOption mqtt("mqtt", "Publish data to the given MQTT broker",
+                          "host:port");
+  QCommandLineOption topic("mqtt-topic", "MQTT topic", "topic");
+  QCommandLineOption plugins("plugins", "Enable the plugins TCP server");
+  QCommandLineOption input(
+      "input", "Read data from the given file, named pipe or local socket, "
+               "use - to read the standard input", "path");
+  QCommandLineOption replay("replay", "Replay the given raw capture file",
+                            "file");
+  QCommandLineOption replayMaxSpeed(
+      "replay-max-speed", "Replay the raw capture as fast as possible");
+  QCommandLineOption benchmarkMode(
+      "benchmark", "Run the data pipeline with synthetic frames and report "
+                   "the sustained frame rate, CPU and memory usage");
+  QCommandLineOption microBenchmark(
+      "micro-benchmark", "Measure the framing, checksum, parsing and "
+                         "dashboard hot paths in isolation");
+  QCommandLineOption renderBenchmark(
+      "render-benchmark", "Drive every dashboard widget type offscreen and "
+                          "report the frame times and CPU usage per type");
+  QCommandLineOption benchWidgets("bench-widgets",
+                                  "Number of widgets of each type in the "
+                                  "rendering benchmark", "count", "4");
+  QCommandLineOption benchRate("bench-rate",
+                               "Benchmark frame rate, 0 for maximum rate",
+                               "fps", "2000");
+  QCommandLineOption benchDatasets("bench-datasets",
+                                   "Number of datasets per benchmark frame",
+                                   "count", "16");
+  QCommandLineOption benchFrameSize(
+      "bench-frame-size", "Approximate size of each benchmark frame", "bytes");
+  QCommandLineOption benchBinary(
+      "bench-binary", "Send length-prefixed binary frames instead of text");
+  QCommandLineOption benchChecksum(
+      "bench-checksum", "Checksum appended to each benchmark frame "
+                        "(crc8, crc16, crc32, xor8...)", "algorithm");
+  QCommandLineOption benchDuration("bench-duration",
+                                   "Benchmark duration in seconds", "seconds",
+                                   "10");
+  QCommandLineOption benchReport("bench-report",
+                                 "Write benchmark results to a JSON file",
+                                 "file");
+  QCommandLineOption soakMode(
+      "soak", "Run the benchmark as a soak test that exercises the dashboard, "
+              "CSV export, MQTT & plugins and fails if the memory, handles, "
+              "latency or dropped frames grow over time");
+  QCommandLineOption soakInterval("soak-interval",
+                                  "Soak test sampling interval in seconds",
+                                  "seconds", "60");
+  QCommandLineOption soakMqtt("soak-mqtt",
+                              "Publish the soak test frames to an MQTT broker",
+                              "host:port");
+  QCommandLineOption soakMaxMemory(
+      "soak-max-memory-growth", "Maximum memory growth in MB per hour", "MB",
+      "16");
+  QCommandLineOption soakMaxHandles("soak-max-handle-growth",
+                                    "Maximum handle growth per hour",
+                                    "handles", "4");
+  QCommandLineOption soakMaxLatency(
+      "soak-max-latency-growth",
+      "Maximum frame latency growth in percent per hour", "percent", "50");
+  QCommandLineOption renderMode(
+      "render", "Render the dashboard of the given recording (requires "
+                "--project) to an image sequence or a video file", "file");
+  QCommandLineOption renderOutput(
+      "render-output", "Write the rendered images to the given directory",
+      "path");
+  QCommandLineOption renderVideo("render-video",
+                                 "Encode the rendered images to a video file",
+                                 "file");
+  QCommandLineOption renderRate("render-fps", "Rendering frame rate", "fps",
+                                "30");
+  QCommandLineOption renderSize("render-size", "Size of the rendered images",
+                                "WxH", "1280x720");
+  QCommandLineOption renderEncoder(
+      "render-encoder", "FFmpeg executable used to encode videos", "path",
+      "ffmpeg");
+  QCommandLineOption convertMode(
+      "convert", "Convert the given recordings to another format, raw "
+                 "captures are re-processed with the parser of --project");
+  QCommandLineOption convertFormat(
+      "convert-format", "Output format of the conversion (csv, csv.gz, ssrec "
+                        "or arrows)", "format", "csv");
+  QCommandLineOption convertOutput(
+      "convert-output", "Write the converted files to the given directory",
+      "path");
+  QCommandLineOption convertJobs(
+      "convert-jobs", "Number of files converted in parallel, 0 for one per "
+                      "core", "count", "0");
+  QCommandLineOption memoryReport(
+      "memory-report", "Print the memory held by each subsystem every "
+                       "given number of seconds (headless mode)", "seconds");
+  QCommandLineOption startupProfile(
+      "startup-profile", "Print the time spent in each startup stage");
+  parser.addOptions({version, reset, headlessMode, project, serial, baud,
+                     tcp, udp, mqtt, topic, plugins, input, replay,
+                     replayMaxSpeed, benchmarkMode, microBenchmark,
+                     renderBenchmark, benchWidgets, benchRate, benchDatasets,
+                     benchFrameSize, benchBinary, benchChecksum, benchDuration,
+                     benchReport, soakMode, soakInterval, soakMqtt,
+                     soakMaxMemory, soakMaxHandles, soakMaxLatency, renderMode,
+                     renderOutput, renderVideo, renderRate, renderSize,
+                     renderEncoder, convertMode, convertFormat, convertOutput,
+                     convertJobs, memoryReport, startupProfile});
+  parser.addPositionalArgument("files", "Recordings to convert (--convert)",
+                               "[files...]");
+  parser.process(app);
 
-  // There are some CLI arguments, read them
-  if (!arguments.isEmpty() && arguments.startsWith("-"))
+  // Show version
+  if (parser.isSet(version))
   {
-    if (arguments == "-v" || arguments == "--version")
+    cliShowVersion();
+    return EXIT_SUCCESS;
+  }
+
+  // Reset settings
+  if (parser.isSet(reset))
+  {
+    cliResetSettings();
+    return EXIT_SUCCESS;
+  }
+
+  // Create module manager
+  Misc::ModuleManager moduleManager;
+  moduleManager.setStartupProfiling(parser.isSet(startupProfile));
+
+  // Run the micro-benchmarks
+  if (parser.isSet(microBenchmark))
+  {
+    if (!Misc::Benchmark::runMicroBenchmarks(parser.value(benchReport)))
+      return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+  }
+
+  // Run the dashboard rendering benchmark
+  if (parser.isSet(renderBenchmark))
+  {
+    UI::RenderBenchmarkOptions options;
+    options.widgets = parser.value(benchWidgets).toInt();
+    options.inputRate = parser.value(benchRate).toInt();
+    options.duration = parser.value(benchDuration).toInt();
+    options.report = parser.value(benchReport);
+    if (parser.isSet(renderRate))
+      options.frameRate = parser.value(renderRate).toInt();
+
+    // Parse image size
+    const auto size = parser.value(renderSize).split('x');
+    if (size.count() == 2)
     {
-      cliShowVersion();
-      return EXIT_SUCCESS;
+      options.width = size.at(0).toInt();
+      options.height = size.at(1).toInt();
     }
 
-    else if (arguments == "-r" || arguments == "--reset")
+    UI::RenderBenchmark bench(options);
+    if (!bench.start())
+      return EXIT_FAILURE;
+
+    return app.exec();
+  }
+
+  // Run the data pipeline benchmark
+  if (benchmark)
+  {
+    Misc::BenchmarkOptions options;
+    options.frameRate = parser.value(benchRate).toInt();
+    options.datasets = parser.value(benchDatasets).toInt();
+    options.frameSize = parser.value(benchFrameSize).toInt();
+    options.binary = parser.isSet(benchBinary);
+    options.checksum = parser.value(benchChecksum);
+    options.duration = parser.value(benchDuration).toInt();
+    options.report = parser.value(benchReport);
+
+    // Configure the soak test
+    options.soak.enabled = parser.isSet(soakMode);
+    options.soak.interval = parser.value(soakInterval).toInt();
+    options.soak.maxMemoryGrowth = parser.value(soakMaxMemory).toDouble();
+    options.soak.maxHandleGrowth = parser.value(soakMaxHandles).toDouble();
+    options.soak.maxLatencyGrowth = parser.value(soakMaxLatency).toDouble();
+    if (parser.isSet(soakMqtt)
+        && !cliParseAddress(parser.value(soakMqtt), options.soak.mqttHost,
+                            options.soak.mqttPort))
     {
-      cliResetSettings();
-      return EXIT_SUCCESS;
+      qCritical() << "Invalid MQTT broker address" << parser.value(soakMqtt);
+      return EXIT_FAILURE;
     }
+
+    Misc::Benchmark bench(options);
+    if (!bench.start())
+      return EXIT_FAILURE;
+
+    return app.exec();
   }
 
-  // Create module manager
-  Misc::ModuleManager moduleManager;
-  moduleManager.configureUpdater();
+  // Render the dashboard of a recording without user interface
+  if (render)
+  {
+    UI::DashboardExportOptions options;
+    options.project = parser.value(project);
+    options.recording = parser.value(renderMode);
+    options.outputPath = parser.value(renderOutput);
+    options.videoFile = parser.value(renderVideo);
+    options.encoder = parser.value(renderEncoder);
+    options.frameRate = parser.value(renderRate).toInt();
+
+    // Parse image size
+    const auto size = parser.value(renderSize).split('x');
+    if (size.count() == 2)
+    {
+      options.width = size.at(0).toInt();
+      options.height = size.at(1).toInt();
+    }
+
+    UI::DashboardExporter exporter(options);
+    if (!exporter.start())
+      return EXIT_FAILURE;
+
+    return app.exec();
+  }
+
+  // Convert recordings without user interface
+  if (convert)
+  {
+    CSV::ConverterOptions options;
+    options.inputs = parser.positionalArguments();
+    options.project = parser.value(project);
+    options.outputPath = parser.value(convertOutput);
+    options.format = parser.value(convertFormat);
+    options.jobs = parser.value(convertJobs).toInt();
+
+    CSV::Converter converter(options);
+    if (!converter.start())
+      return EXIT_FAILURE;
+
+    return app.exec();
+  }
+
+  // Initialize modules without user interface
+  if (headless)
+  {
+    Misc::HeadlessOptions options;
+    options.project = parser.value(project);
+    options.serialPort = parser.value(serial);
+    options.baudRate = parser.value(baud).toInt();
+    options.mqttTopic = parser.value(topic);
+    options.plugins = parser.isSet(plugins);
+    options.udpPort = parser.value(udp).toUShort();
+    options.input = parser.value(input);
+    options.replayFile = parser.value(replay);
+    options.replayMaxSpeed = parser.isSet(replayMaxSpeed);
+    options.memoryReport = parser.value(memoryReport).toInt();
+
+    // Parse network addresses
+    if (parser.isSet(tcp)
+        && !cliParseAddress(parser.value(tcp), options.tcpHost,
+                            options.tcpPort))
+    {
+      qCritical() << "Invalid TCP address" << parser.value(tcp);
+      return EXIT_FAILURE;
+    }
+
+    if (parser.isSet(mqtt)
+        && !cliParseAddress(parser.value(mqtt), options.mqttHost,
+                            options.mqttPort))
+    {
+      qCritical() << "Invalid MQTT broker address" << parser.value(mqtt);
+      return EXIT_FAILURE;
+    }
+
+    // Initialize modules
+    if (!moduleManager.initializeHeadless(options))
+      return EXIT_FAILURE;
+
+    // Quit cleanly when the process is terminated
+    cliInstallSignalHandlers();
+
+    // Enter application event loop
+    return app.exec();
+  }
 
-  // Initialize QML interface
+  // Initialize QML interface, the auto-updater & the network modules are
+  // configured once the main window is shown
   moduleManager.registerQmlTypes();
   moduleManager.initializeQmlInterface();
   if (moduleManager.engine()->rootObjects().isEmpty())